@@ -46,6 +46,7 @@
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
 #include <utility>
 
@@ -484,12 +485,152 @@ getCheckOptions(const ClangTidyOptions &Options,
   return Factory.getCheckOptions();
 }
 
+namespace {
+class ActionFactory : public FrontendActionFactory {
+public:
+  ActionFactory(ClangTidyContext &Context,
+                IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
+      : ConsumerFactory(Context, BaseFS) {}
+  FrontendAction *create() override { return new Action(&ConsumerFactory); }
+
+  bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
+                     FileManager *Files,
+                     std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+                     DiagnosticConsumer *DiagConsumer) override {
+    // Explicitly set ProgramAction to RunAnalysis to make the preprocessor
+    // define __clang_analyzer__ macro. The frontend analyzer action will not
+    // be called here.
+    Invocation->getFrontendOpts().ProgramAction = frontend::RunAnalysis;
+    return FrontendActionFactory::runInvocation(
+        Invocation, Files, PCHContainerOps, DiagConsumer);
+  }
+
+private:
+  class Action : public ASTFrontendAction {
+  public:
+    Action(ClangTidyASTConsumerFactory *Factory) : Factory(Factory) {}
+    std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &Compiler,
+                                                   StringRef File) override {
+      return Factory->CreateASTConsumer(Compiler, File);
+    }
+
+  private:
+    ClangTidyASTConsumerFactory *Factory;
+  };
+
+  ClangTidyASTConsumerFactory ConsumerFactory;
+};
+
+/// Splits the checks enabled by \p Options into at most \p Count groups and
+/// returns the \c Checks glob of each. The first group also keeps the static
+/// analyzer checks and the compiler diagnostics, which can't be split.
+std::vector<std::string>
+partitionChecks(const ClangTidyOptions &Options, unsigned Count,
+                bool AllowEnablingAnalyzerAlphaCheckers) {
+  std::vector<std::vector<std::string>> Groups(Count);
+  unsigned Next = 0;
+  for (std::string &Name :
+       getCheckNames(Options, AllowEnablingAnalyzerAlphaCheckers)) {
+    if (StringRef(Name).startswith("clang-analyzer-"))
+      continue;
+    Groups[Next].push_back(std::move(Name));
+    Next = (Next + 1) % Count;
+  }
+
+  std::vector<std::string> Globs = {Options.Checks.getValueOr("")};
+  for (unsigned I = 1; I < Count && !Groups[I].empty(); ++I) {
+    std::string Glob = "-*";
+    for (const std::string &Name : Groups[I]) {
+      Globs.front() += ",-" + Name;
+      Glob += "," + Name;
+    }
+    Globs.push_back(std::move(Glob));
+  }
+  return Globs;
+}
+
+// Needed to locate the resource directory, as ClangTool does.
+int StaticSymbol;
+} // namespace
+
+/// Runs \p CommandLine once for each glob in \p CheckGlobs, concurrently, and
+/// adds the results to \p DiagConsumer. The current directory must already be
+/// the one of the compile command. Returns false if any of the runs failed.
+///
+/// Each run parses the file on its own: an AST and its SourceManager have
+/// caches that are not safe to share between threads.
+static bool
+runCheckGroups(ClangTidyContext &Context,
+               ClangTidyDiagnosticConsumer &DiagConsumer,
+               const CommandLineArguments &CommandLine, StringRef File,
+               ArrayRef<std::string> CheckGlobs,
+               llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS) {
+  struct Group {
+    std::vector<ClangTidyError> Errors;
+    ClangTidyStats Stats;
+    bool Succeeded = false;
+  };
+  std::vector<Group> Groups(CheckGlobs.size());
+  ClangTidyOptions FileOptions = Context.getOptionsForFile(File);
+  auto PCHContainerOps = std::make_shared<PCHContainerOperations>();
+
+  auto RunGroup = [&](size_t I) {
+    ClangTidyOptions Options = FileOptions;
+    Options.Checks = CheckGlobs[I];
+    ClangTidyContext GroupContext(
+        llvm::make_unique<DefaultOptionsProvider>(Context.getGlobalOptions(),
+                                                  Options),
+        Context.canEnableAnalyzerAlphaCheckers());
+    // Incompatible fixes are removed once all the groups are merged.
+    ClangTidyDiagnosticConsumer GroupConsumer(GroupContext, nullptr,
+                                              /*RemoveIncompatibleErrors=*/
+                                              false);
+    DiagnosticsEngine DE(new DiagnosticIDs(), new DiagnosticOptions(),
+                         &GroupConsumer, /*ShouldOwnClient=*/false);
+    GroupContext.setDiagnosticsEngine(&DE);
+
+    // Module expansion adds overlays to the file system, so each group gets
+    // its own.
+    llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> GroupFS(
+        new llvm::vfs::OverlayFileSystem(BaseFS));
+    FileManager Files(FileSystemOptions(), GroupFS);
+    ActionFactory Factory(GroupContext, GroupFS);
+    // Only the first group reports compiler warnings.
+    CommandLineArguments GroupCommandLine = CommandLine;
+    if (I > 0)
+      GroupCommandLine.push_back("-w");
+    ToolInvocation Invocation(std::move(GroupCommandLine), &Factory, &Files,
+                              PCHContainerOps);
+    Invocation.setDiagnosticConsumer(&GroupConsumer);
+    Groups[I].Succeeded = Invocation.run();
+    Groups[I].Errors = GroupConsumer.take();
+    Groups[I].Stats = GroupContext.getStats();
+  };
+
+  if (Groups.size() == 1) {
+    RunGroup(0);
+  } else {
+    llvm::ThreadPool Pool(Groups.size());
+    for (size_t I = 0; I < Groups.size(); ++I)
+      Pool.async(RunGroup, I);
+    Pool.wait();
+  }
+
+  bool Succeeded = true;
+  for (Group &G : Groups) {
+    DiagConsumer.addErrors(std::move(G.Errors), G.Stats);
+    Succeeded &= G.Succeeded;
+  }
+  return Succeeded;
+}
+
 std::vector<ClangTidyError>
 runClangTidy(clang::tidy::ClangTidyContext &Context,
              const CompilationDatabase &Compilations,
              ArrayRef<std::string> InputFiles,
              llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
-             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
+             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile,
+             unsigned CheckGroups) {
   ClangTool Tool(Compilations, InputFiles,
                  std::make_shared<PCHContainerOperations>(), BaseFS);
 
@@ -522,43 +663,59 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   Context.setDiagnosticsEngine(&DE);
   Tool.setDiagnosticConsumer(&DiagConsumer);
 
-  class ActionFactory : public FrontendActionFactory {
-  public:
-    ActionFactory(ClangTidyContext &Context,
-                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
-        : ConsumerFactory(Context, BaseFS) {}
-    FrontendAction *create() override { return new Action(&ConsumerFactory); }
-
-    bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
-                       FileManager *Files,
-                       std::shared_ptr<PCHContainerOperations> PCHContainerOps,
-                       DiagnosticConsumer *DiagConsumer) override {
-      // Explicitly set ProgramAction to RunAnalysis to make the preprocessor
-      // define __clang_analyzer__ macro. The frontend analyzer action will not
-      // be called here.
-      Invocation->getFrontendOpts().ProgramAction = frontend::RunAnalysis;
-      return FrontendActionFactory::runInvocation(
-          Invocation, Files, PCHContainerOps, DiagConsumer);
-    }
-
-  private:
-    class Action : public ASTFrontendAction {
-    public:
-      Action(ClangTidyASTConsumerFactory *Factory) : Factory(Factory) {}
-      std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &Compiler,
-                                                     StringRef File) override {
-        return Factory->CreateASTConsumer(Compiler, File);
-      }
-
-    private:
-      ClangTidyASTConsumerFactory *Factory;
-    };
-
-    ClangTidyASTConsumerFactory ConsumerFactory;
-  };
+  // Profiles are collected per context, so they require a single group.
+  if (CheckGroups <= 1 || EnableCheckProfile) {
+    ActionFactory Factory(Context, BaseFS);
+    Tool.run(&Factory);
+    return DiagConsumer.take();
+  }
 
-  ActionFactory Factory(Context, BaseFS);
-  Tool.run(&Factory);
+  // The same steps as ClangTool::run(), except that each compile command runs
+  // once per group of checks.
+  ArgumentsAdjuster Adjuster = combineAdjusters(
+      combineAdjusters(getClangStripOutputAdjuster(),
+                       getClangSyntaxOnlyAdjuster()),
+      combineAdjusters(getClangStripDependencyFileAdjuster(),
+                       combineAdjusters(PerFileExtraArgumentsInserter,
+                                        getStripPluginsAdjuster())));
+  llvm::ErrorOr<std::string> InitialWorkingDir =
+      BaseFS->getCurrentWorkingDirectory();
+  for (const std::string &InputFile : InputFiles) {
+    auto File = getAbsolutePath(*BaseFS, InputFile);
+    if (!File) {
+      llvm::errs() << "Skipping " << InputFile
+                   << ". Error while getting an absolute path: "
+                   << llvm::toString(File.takeError()) << "\n";
+      continue;
+    }
+    std::vector<CompileCommand> Commands =
+        Compilations.getCompileCommands(*File);
+    if (Commands.empty()) {
+      llvm::errs() << "Skipping " << *File << ". Compile command not found.\n";
+      continue;
+    }
+    std::vector<std::string> CheckGlobs =
+        partitionChecks(Context.getOptionsForFile(*File), CheckGroups,
+                        Context.canEnableAnalyzerAlphaCheckers());
+    for (const CompileCommand &Command : Commands) {
+      if (BaseFS->setCurrentWorkingDirectory(Command.Directory))
+        llvm::report_fatal_error("Cannot chdir into \"" +
+                                 Twine(Command.Directory) + "\"!");
+      CommandLineArguments CommandLine =
+          Adjuster(Command.CommandLine, Command.Filename);
+      if (llvm::none_of(CommandLine, [](StringRef Arg) {
+            return Arg.startswith("-resource-dir");
+          }))
+        CommandLine.push_back(
+            "-resource-dir=" +
+            CompilerInvocation::GetResourcesPath("clang_tool", &StaticSymbol));
+      if (!runCheckGroups(Context, DiagConsumer, CommandLine, *File,
+                          CheckGlobs, BaseFS))
+        llvm::errs() << "Error while processing " << *File << ".\n";
+    }
+  }
+  if (InitialWorkingDir)
+    BaseFS->setCurrentWorkingDirectory(*InitialWorkingDir);
   return DiagConsumer.take();
 }
 
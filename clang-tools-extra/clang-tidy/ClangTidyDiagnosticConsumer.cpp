@@ -24,6 +24,7 @@
 #include "clang/Tooling/Core/Diagnostic.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
+#include <iterator>
 #include <tuple>
 #include <vector>
 using namespace clang;
@@ -754,8 +755,21 @@ struct EqualClangTidyError {
 };
 } // end anonymous namespace
 
+void ClangTidyDiagnosticConsumer::addErrors(
+    std::vector<ClangTidyError> NewErrors, const ClangTidyStats &NewStats) {
+  std::move(NewErrors.begin(), NewErrors.end(),
+            std::back_inserter(AddedErrors));
+  Context.Stats.ErrorsDisplayed += NewStats.ErrorsDisplayed;
+  Context.Stats.ErrorsIgnoredCheckFilter += NewStats.ErrorsIgnoredCheckFilter;
+  Context.Stats.ErrorsIgnoredNOLINT += NewStats.ErrorsIgnoredNOLINT;
+  Context.Stats.ErrorsIgnoredNonUserCode += NewStats.ErrorsIgnoredNonUserCode;
+  Context.Stats.ErrorsIgnoredLineFilter += NewStats.ErrorsIgnoredLineFilter;
+}
+
 std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
   finalizeLastError();
+  std::move(AddedErrors.begin(), AddedErrors.end(), std::back_inserter(Errors));
+  AddedErrors.clear();
 
   std::sort(Errors.begin(), Errors.end(), LessClangTidyError());
   Errors.erase(std::unique(Errors.begin(), Errors.end(), EqualClangTidyError()),
@@ -263,6 +263,12 @@ public:
   // Retrieve the diagnostics that were captured.
   std::vector<ClangTidyError> take();
 
+  /// \brief Adds the diagnostics and statistics collected by another consumer,
+  /// e.g. one that ran a different group of checks on the same translation
+  /// unit. \c take() sorts and deduplicates them together with the rest.
+  void addErrors(std::vector<ClangTidyError> NewErrors,
+                 const ClangTidyStats &NewStats);
+
 private:
   void finalizeLastError();
   void removeIncompatibleErrors();
@@ -282,6 +288,8 @@ private:
   DiagnosticsEngine *ExternalDiagEngine;
   bool RemoveIncompatibleErrors;
   std::vector<ClangTidyError> Errors;
+  // Errors from addErrors(), which are already finalized.
+  std::vector<ClangTidyError> AddedErrors;
   std::unique_ptr<llvm::Regex> HeaderFilter;
   bool LastErrorRelatesToUserCode;
   bool LastErrorPassesLineFilter;
@@ -158,6 +158,12 @@ llvm::Optional<SymbolID> getSymbolID(const Decl *D) {
   return SymbolID(USR);
 }
 
+llvm::Optional<SymbolID> getSymbolID(const Decl *D, index::USRCache &USRs) {
+  if (auto USR = USRs.getUSRForDecl(D))
+    return SymbolID(*USR);
+  return None;
+}
+
 llvm::Optional<SymbolID> getSymbolID(const IdentifierInfo &II,
                                      const MacroInfo *MI,
                                      const SourceManager &SM) {
@@ -21,6 +21,9 @@
 namespace clang {
 class SourceManager;
 class Decl;
+namespace index {
+class USRCache;
+} // namespace index
 
 namespace clangd {
 
@@ -56,6 +59,10 @@ std::string printTemplateSpecializationArgs(const NamedDecl &ND);
 /// Gets the symbol ID for a declaration, if possible.
 llvm::Optional<SymbolID> getSymbolID(const Decl *D);
 
+/// Gets the symbol ID for a declaration, if possible, only generating its USR
+/// once per \p USRs.
+llvm::Optional<SymbolID> getSymbolID(const Decl *D, index::USRCache &USRs);
+
 /// Gets the symbol ID for a macro, if possible.
 /// Currently, this is an encoded USR of the macro, which incorporates macro
 /// locations (e.g. file name, offset in file).
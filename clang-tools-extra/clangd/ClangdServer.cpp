@@ -119,7 +119,7 @@ ClangdServer::ClangdServer(const GlobalCompilationDatabase &CDB,
           CDB, Opts.AsyncThreadsCount, Opts.StorePreamblesInMemory,
           llvm::make_unique<UpdateIndexCallbacks>(
               DynamicIdx.get(), DiagConsumer, Opts.SemanticHighlighting),
-          Opts.UpdateDebounce, Opts.RetentionPolicy) {
+          Opts.UpdateDebounce, Opts.RetentionPolicy, Opts.SharePreambles) {
   // Adds an index to the stack, at higher priority than existing indexes.
   auto AddIndex = [&](SymbolIndex *Idx) {
     if (this->Index != nullptr) {
@@ -211,7 +211,11 @@ void ClangdServer::codeComplete(PathRef File, Position Pos,
         CodeCompleteOpts, SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr);
     {
       clang::clangd::trace::Span Tracer("Completion results callback");
-      CB(std::move(Result));
+      // Scoring stops early when cancelled, so the results may be partial.
+      if (isCancelled())
+        CB(llvm::make_error<CancelledError>());
+      else
+        CB(std::move(Result));
     }
     if (SpecFuzzyFind && SpecFuzzyFind->NewReq.hasValue()) {
       std::lock_guard<std::mutex> Lock(CachedCompletionFuzzyFindRequestMutex);
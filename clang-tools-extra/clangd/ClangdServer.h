@@ -90,6 +90,10 @@ public:
     /// Cached preambles are potentially large. If false, store them on disk.
     bool StorePreamblesInMemory = true;
 
+    /// If true, files whose preamble regions and compile commands are the same
+    /// up to the file name share a single preamble.
+    bool SharePreambles = false;
+
     /// If true, ClangdServer builds a dynamic in-memory index for symbols in
     /// opened files and uses the index to augment code completion results.
     bool BuildDynamicSymbolIndex = false;
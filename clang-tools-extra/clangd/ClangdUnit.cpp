@@ -41,6 +41,8 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <memory>
@@ -562,12 +564,49 @@ ParsedAST::ParsedAST(std::shared_ptr<const PreambleData> Preamble,
   assert(this->Action);
 }
 
+std::string
+SharedPreambleStore::getKey(PathRef FileName, llvm::StringRef PreambleBytes,
+                            const tooling::CompileCommand &Command) {
+  // The file name appears in the command line; erase it so that the commands
+  // of files in the same directory compare equal. Unlike
+  // compileCommandsAreEqual, we don't check the Filename.
+  llvm::SmallString<256> Key;
+  llvm::raw_svector_ostream OS(Key);
+  OS << Command.Directory << '\0';
+  for (const std::string &Arg : Command.CommandLine)
+    OS << (Arg == Command.Filename || Arg == FileName ? "<file>" : Arg)
+       << '\0';
+  OS << PreambleBytes;
+  FileDigest Digest = digest(Key);
+  return llvm::toHex(llvm::StringRef(
+      reinterpret_cast<const char *>(Digest.data()), Digest.size()));
+}
+
+std::shared_ptr<const PreambleData>
+SharedPreambleStore::get(llvm::StringRef Key) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto It = Preambles.find(Key);
+  if (It == Preambles.end())
+    return nullptr;
+  std::shared_ptr<const PreambleData> Preamble = It->second.lock();
+  if (!Preamble)
+    Preambles.erase(It);
+  return Preamble;
+}
+
+void SharedPreambleStore::put(llvm::StringRef Key,
+                              std::shared_ptr<const PreambleData> Preamble) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Preambles[Key] = Preamble;
+}
+
 std::shared_ptr<const PreambleData>
 buildPreamble(PathRef FileName, CompilerInvocation &CI,
               std::shared_ptr<const PreambleData> OldPreamble,
               const tooling::CompileCommand &OldCompileCommand,
               const ParseInputs &Inputs, bool StoreInMemory,
-              PreambleParsedCallback PreambleCallback) {
+              PreambleParsedCallback PreambleCallback,
+              SharedPreambleStore *SharedPreambles) {
   // Note that we don't need to copy the input contents, preamble can live
   // without those.
   auto ContentsBuffer = llvm::MemoryBuffer::getMemBuffer(Inputs.Contents);
@@ -581,6 +620,20 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
     vlog("Reusing preamble for file {0}", llvm::Twine(FileName));
     return OldPreamble;
   }
+
+  std::string SharedKey;
+  if (SharedPreambles) {
+    SharedKey = SharedPreambleStore::getKey(
+        FileName, llvm::StringRef(Inputs.Contents).take_front(Bounds.Size),
+        Inputs.CompileCommand);
+    auto Shared = SharedPreambles->get(SharedKey);
+    if (Shared && Shared != OldPreamble &&
+        Shared->Preamble.CanReuse(CI, ContentsBuffer.get(), Bounds,
+                                  Inputs.FS.get())) {
+      vlog("Reusing shared preamble for file {0}", llvm::Twine(FileName));
+      return Shared;
+    }
+  }
   vlog("Preamble for file {0} cannot be reused. Attempting to rebuild it.",
        FileName);
 
@@ -618,28 +671,141 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
   // When building the AST for the main file, we do want the function
   // bodies.
   CI.getFrontendOpts().SkipFunctionBodies = false;
+  SPAN_ATTACH(Tracer, "sharedFileBytesSaved",
+              static_cast<int64_t>(
+                  SharedFileContents::getGlobal().getBytesSaved()));
 
   if (BuiltPreamble) {
     vlog("Built preamble of size {0} for file {1}", BuiltPreamble->getSize(),
          FileName);
     std::vector<Diag> Diags = PreambleDiagnostics.take();
-    return std::make_shared<PreambleData>(
+    auto Result = std::make_shared<PreambleData>(
         std::move(*BuiltPreamble), std::move(Diags),
         SerializedDeclsCollector.takeIncludes(),
         SerializedDeclsCollector.takeMainFileMacros(), std::move(StatCache),
         SerializedDeclsCollector.takeCanonicalIncludes());
+    if (SharedPreambles)
+      SharedPreambles->put(SharedKey, Result);
+    return Result;
   } else {
     elog("Could not build a preamble for file {0}", FileName);
     return nullptr;
   }
 }
 
+PreamblePatch PreamblePatch::create(PathRef FileName,
+                                    const ParseInputs &Modified,
+                                    const PreambleData &Baseline,
+                                    const CompilerInvocation &CI) {
+  trace::Span Tracer("CreatePreamblePatch");
+  SPAN_ATTACH(Tracer, "File", FileName);
+  const LangOptions &LangOpts = *CI.getLangOpts();
+  auto ContentsBuffer = llvm::MemoryBuffer::getMemBuffer(Modified.Contents);
+  auto Bounds = ComputePreambleBounds(LangOpts, ContentsBuffer.get(), 0);
+  llvm::StringRef Region =
+      llvm::StringRef(Modified.Contents).take_front(Bounds.Size);
+
+  llvm::StringSet<> BaselineIncludes;
+  for (const Inclusion &Inc : Baseline.Includes.MainFileIncludes)
+    BaselineIncludes.insert(Inc.Written);
+  llvm::StringSet<> BaselineMacros;
+  for (const std::string &Name : Baseline.MainFileMacros)
+    BaselineMacros.insert(Name);
+
+  PreamblePatch Patch;
+  llvm::raw_string_ostream OS(Patch.PatchContents);
+  std::string EscapedFileName;
+  for (char C : FileName) {
+    if (C == '\\' || C == '"')
+      EscapedFileName.push_back('\\');
+    EscapedFileName.push_back(C);
+  }
+
+  // Look for the directives the baseline lacks. Only the directives are
+  // lexed, the preamble region is otherwise skipped by the parser.
+  Lexer L(SourceLocation(), LangOpts, Region.begin(), Region.begin(),
+          Region.end());
+  Token Tok;
+  L.LexFromRawLexer(Tok);
+  while (Tok.isNot(tok::eof)) {
+    if (!Tok.is(tok::hash) || !Tok.isAtStartOfLine()) {
+      L.LexFromRawLexer(Tok);
+      continue;
+    }
+    unsigned HashOffset = Tok.getLocation().getRawEncoding();
+    L.LexFromRawLexer(Tok);
+    llvm::StringRef Directive =
+        Tok.is(tok::raw_identifier) && !Tok.isAtStartOfLine()
+            ? Tok.getRawIdentifier()
+            : "";
+    llvm::StringRef Name;
+    if (Directive == "include" || Directive == "import" ||
+        Directive == "include_next") {
+      unsigned NameOffset =
+          Tok.getLocation().getRawEncoding() + Tok.getLength();
+      llvm::StringRef Rest = Region.substr(NameOffset).ltrim(" \t");
+      // Compare the spelling of the header name with Inclusion::Written.
+      char Close = Rest.startswith("<") ? '>' : '"';
+      size_t End = Rest.find(Close, 1);
+      Name = End == llvm::StringRef::npos
+                 ? Rest.take_until([](char C) { return C == '\n'; }).rtrim()
+                 : Rest.take_front(End + 1);
+      if (BaselineIncludes.count(Name))
+        Name = "";
+    } else if (Directive == "define") {
+      L.LexFromRawLexer(Tok);
+      if (Tok.is(tok::raw_identifier) &&
+          !BaselineMacros.count(Tok.getRawIdentifier()))
+        Name = Tok.getRawIdentifier();
+    }
+    // Skip to the end of the directive.
+    while (!Tok.is(tok::eof) && !Tok.isAtStartOfLine())
+      L.LexFromRawLexer(Tok);
+    if (Name.empty())
+      continue;
+    unsigned EndOffset = Tok.is(tok::eof)
+                             ? Region.size()
+                             : Tok.getLocation().getRawEncoding();
+    llvm::StringRef Text = Region.slice(HashOffset, EndOffset).rtrim();
+    // Make the injected directive appear at its location in the file.
+    unsigned Line = Region.take_front(HashOffset).count('\n') + 1;
+    OS << "#line " << Line << " \"" << EscapedFileName << "\"\n"
+       << Text << '\n';
+  }
+  OS.flush();
+
+  if (!Patch.PatchContents.empty()) {
+    // Quoted includes are looked up relative to the including file, so the
+    // patch must appear to live next to the file.
+    llvm::SmallString<128> PatchPath(llvm::sys::path::parent_path(FileName));
+    llvm::sys::path::append(PatchPath, "__preamble_patch__.h");
+    Patch.PatchFileName = PatchPath.str();
+  }
+  SPAN_ATTACH(Tracer, "PatchSize",
+              static_cast<int64_t>(Patch.PatchContents.size()));
+  return Patch;
+}
+
+void PreamblePatch::apply(CompilerInvocation &CI) const {
+  if (empty())
+    return;
+  auto &PPOpts = CI.getPreprocessorOpts();
+  PPOpts.addRemappedFile(
+      PatchFileName,
+      llvm::MemoryBuffer::getMemBufferCopy(PatchContents, PatchFileName)
+          .release());
+  PPOpts.Includes.push_back(PatchFileName);
+}
+
 llvm::Optional<ParsedAST>
 buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
          const ParseInputs &Inputs,
-         std::shared_ptr<const PreambleData> Preamble) {
+         std::shared_ptr<const PreambleData> Preamble,
+         const PreamblePatch *Patch) {
   trace::Span Tracer("BuildAST");
   SPAN_ATTACH(Tracer, "File", FileName);
+  if (Patch)
+    Patch->apply(*Invocation);
 
   auto VFS = Inputs.FS;
   if (Preamble && Preamble->StatCache)
@@ -25,7 +25,9 @@
 #include "clang/Tooling/CompilationDatabase.h"
 #include "clang/Tooling/Core/Replacement.h"
 #include "clang/Tooling/Syntax/Tokens.h"
+#include "llvm/ADT/StringMap.h"
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -156,26 +158,85 @@ using PreambleParsedCallback =
     std::function<void(ASTContext &, std::shared_ptr<clang::Preprocessor>,
                        const CanonicalIncludes &)>;
 
+/// A store of the preambles in use, keyed by the contents of their preamble
+/// region and their compile command with the file name erased. This lets
+/// files that start with the same include block and are compiled with the
+/// same flags, e.g. sibling test files, share a single preamble.
+///
+/// Only weak references are stored: a preamble stays in the store while some
+/// file uses it, both when it is kept in memory and when it is on disk.
+/// This class is thread-safe.
+class SharedPreambleStore {
+public:
+  /// Returns the key of the preamble described by \p PreambleBytes and
+  /// \p Command, which is the compile command of \p FileName.
+  static std::string getKey(PathRef FileName, llvm::StringRef PreambleBytes,
+                            const tooling::CompileCommand &Command);
+
+  /// Returns the preamble stored for \p Key, or null if there is none.
+  std::shared_ptr<const PreambleData> get(llvm::StringRef Key);
+  /// Stores \p Preamble for \p Key, replacing any preamble stored before.
+  void put(llvm::StringRef Key, std::shared_ptr<const PreambleData> Preamble);
+
+private:
+  std::mutex Mutex;
+  llvm::StringMap<std::weak_ptr<const PreambleData>> Preambles;
+};
+
 /// Rebuild the preamble for the new inputs unless the old one can be reused.
 /// If \p OldPreamble can be reused, it is returned unchanged.
-/// If \p OldPreamble is null, always builds the preamble.
+/// Otherwise, if \p SharedPreambles is set and holds a preamble built for
+/// another file that can be reused, that preamble is returned; preambles that
+/// are built are added to \p SharedPreambles.
+/// If \p OldPreamble is null, always builds or shares the preamble.
 /// If \p PreambleCallback is set, it will be run on top of the AST while
-/// building the preamble. Note that if the old preamble was reused, no AST is
-/// built and, therefore, the callback will not be executed.
+/// building the preamble. Note that if the old or a shared preamble was
+/// reused, no AST is built and, therefore, the callback will not be executed.
 std::shared_ptr<const PreambleData>
 buildPreamble(PathRef FileName, CompilerInvocation &CI,
               std::shared_ptr<const PreambleData> OldPreamble,
               const tooling::CompileCommand &OldCompileCommand,
               const ParseInputs &Inputs, bool StoreInMemory,
-              PreambleParsedCallback PreambleCallback);
+              PreambleParsedCallback PreambleCallback,
+              SharedPreambleStore *SharedPreambles = nullptr);
+
+/// Describes the #include and #define directives in the preamble region of a
+/// file that a stale preamble of the file lacks. Applying the patch to a
+/// compile that uses the stale preamble injects those directives textually, so
+/// that the file can be served while its preamble is rebuilt.
+/// Directives are injected unconditionally, and directives removed from the
+/// preamble region are not undone.
+class PreamblePatch {
+public:
+  /// Returns the patch for parsing \p Modified, the inputs of \p FileName,
+  /// with \p Baseline, a preamble built for an older version of the file.
+  static PreamblePatch create(PathRef FileName, const ParseInputs &Modified,
+                              const PreambleData &Baseline,
+                              const CompilerInvocation &CI);
+
+  /// Adds the patch to the implicit includes of \p CI, which must already be
+  /// set up to use the baseline preamble. Has no effect on an empty patch.
+  void apply(CompilerInvocation &CI) const;
+
+  /// Whether the preamble region contains no new directives.
+  bool empty() const { return PatchContents.empty(); }
+
+  /// The contents of the implicitly included patch file, for testing.
+  llvm::StringRef text() const { return PatchContents; }
+
+private:
+  std::string PatchFileName;
+  std::string PatchContents;
+};
 
 /// Build an AST from provided user inputs. This function does not check if
 /// preamble can be reused, as this function expects that \p Preamble is the
-/// result of calling buildPreamble.
+/// result of calling buildPreamble, or a stale preamble patched by \p Patch.
 llvm::Optional<ParsedAST>
 buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
          const ParseInputs &Inputs,
-         std::shared_ptr<const PreambleData> Preamble);
+         std::shared_ptr<const PreambleData> Preamble,
+         const PreamblePatch *Patch = nullptr);
 
 /// Get the beginning SourceLocation at a specified \p Pos.
 /// May be invalid if Pos is, or if there's no identifier.
@@ -20,6 +20,7 @@
 #include "CodeComplete.h"
 #include "AST.h"
 #include "ClangdUnit.h"
+#include "Cancellation.h"
 #include "CodeCompletionStrings.h"
 #include "Compiler.h"
 #include "Diagnostics.h"
@@ -32,6 +33,7 @@
 #include "Quality.h"
 #include "SourceCode.h"
 #include "TUScheduler.h"
+#include "Threading.h"
 #include "Trace.h"
 #include "URI.h"
 #include "index/Index.h"
@@ -1082,6 +1084,11 @@ bool semaCodeComplete(std::unique_ptr<CodeCompleteConsumer> Consumer,
   PreambleBounds PreambleRegion =
       ComputePreambleBounds(*CI->getLangOpts(), ContentsBuffer.get(), 0);
   bool CompletingInPreamble = PreambleRegion.Size > Input.Offset;
+  // A stale preamble lacks the directives added since it was built, inject
+  // them so that their declarations can be completed.
+  if (Input.Preamble && !CompletingInPreamble)
+    PreamblePatch::create(Input.FileName, ParseInput, *Input.Preamble, *CI)
+        .apply(*CI);
   // NOTE: we must call BeginSourceFile after prepareCompilerInstance. Otherwise
   // the remapped buffers do not get freed.
   IgnoreDiagnostics DummyDiagsConsumer;
@@ -1197,6 +1204,9 @@ FuzzyFindRequest speculativeFuzzyFindRequestForCompletion(
 //     This score is combined with the result quality score for the final score.
 //   - TopN determines the results with the best score.
 class CodeCompleteFlow {
+  // Number of candidates scored between checks for cancellation and deadline.
+  static constexpr size_t ScoringCheckInterval = 64;
+
   PathRef FileName;
   IncludeStructure Includes;           // Complete once the compiler runs.
   SpeculativeFuzzyFind *SpecFuzzyFind; // Can be nullptr.
@@ -1227,6 +1237,8 @@ class CodeCompleteFlow {
   /// Initialized right before sema run. This is only set if `SpecFuzzyFind` is
   /// set and contains a cached request.
   llvm::Optional<FuzzyFindRequest> SpecReq;
+  /// Scoring stops at this deadline, derived from Opts.LatencyBudget.
+  Deadline ScoringDeadline = Deadline::infinity();
 
 public:
   // A CodeCompleteFlow object is only useful for calling run() exactly once.
@@ -1234,7 +1246,11 @@ public:
                    SpeculativeFuzzyFind *SpecFuzzyFind,
                    const CodeCompleteOptions &Opts)
       : FileName(FileName), Includes(Includes), SpecFuzzyFind(SpecFuzzyFind),
-        Opts(Opts) {}
+        Opts(Opts) {
+    if (Opts.LatencyBudget)
+      ScoringDeadline =
+          Deadline(std::chrono::steady_clock::now() + *Opts.LatencyBudget);
+  }
 
   CodeCompleteResult run(const SemaCompleteInput &SemaCCInput) && {
     trace::Span Tracer("CodeCompleteFlow");
@@ -1378,8 +1394,9 @@ public:
 
     SymbolSlab IndexResults = Opts.Index ? queryIndex() : SymbolSlab();
 
-    CodeCompleteResult Output = toCodeCompleteResult(mergeResults(
-        /*SemaResults=*/{}, IndexResults, IdentifierResults));
+    CodeCompleteResult Output = toCodeCompleteResult(
+        mergeResults(/*SemaResults=*/{}, /*SemaResultIDs=*/{}, IndexResults,
+                     IdentifierResults));
     Output.RanParser = false;
     logResults(Output, Tracer);
     return Output;
@@ -1437,13 +1454,29 @@ private:
     //        explicitly request symbols corresponding to Sema results.
     //        We can use their signals even if the index can't suggest them.
     // We must copy index results to preserve them, but there are at most Limit.
-    auto IndexResults = (Opts.Index && allowIndex(Recorder->CCContext))
-                            ? queryIndex()
-                            : SymbolSlab();
+    // The index is queried on another thread, while we compute the SymbolIDs
+    // of the Sema results (which needs USRs and is not cheap) to merge them
+    // with the index results.
+    std::future<SymbolSlab> IndexQuery;
+    if (Opts.Index && allowIndex(Recorder->CCContext))
+      IndexQuery = runAsync<SymbolSlab>([this] { return queryIndex(); });
+    std::vector<llvm::Optional<SymbolID>> SemaResultIDs;
+    {
+      trace::Span Tracer("Sema result IDs");
+      const auto &SM = Recorder->CCSema->getSourceManager();
+      SemaResultIDs.reserve(Recorder->Results.size());
+      for (const auto &SemaResult : Recorder->Results)
+        SemaResultIDs.push_back(getSymbolID(SemaResult, SM));
+    }
+    SymbolSlab IndexResults;
+    if (IndexQuery.valid()) {
+      trace::Span Tracer("Wait index results");
+      IndexResults = IndexQuery.get();
+    }
     trace::Span Tracer("Populate CodeCompleteResult");
     // Merge Sema and Index results, score them, and pick the winners.
-    auto Top =
-        mergeResults(Recorder->Results, IndexResults, /*Identifiers*/ {});
+    auto Top = mergeResults(Recorder->Results, SemaResultIDs, IndexResults,
+                            /*Identifiers*/ {});
     return toCodeCompleteResult(Top);
   }
 
@@ -1502,12 +1535,14 @@ private:
   }
 
   // Merges Sema and Index results where possible, to form CompletionCandidates.
+  // \p SemaResultIDs are the SymbolIDs of \p SemaResults.
   // \p Identifiers is raw idenfiers that can also be completion condidates.
   // Identifiers are not merged with results from index or sema.
   // Groups overloads if desired, to form CompletionCandidate::Bundles. The
   // bundles are scored and top results are returned, best to worst.
   std::vector<ScoredBundle>
   mergeResults(const std::vector<CodeCompletionResult> &SemaResults,
+               llvm::ArrayRef<llvm::Optional<SymbolID>> SemaResultIDs,
                const SymbolSlab &IndexResults,
                const std::vector<RawIdentifier> &IdentifierResults) {
     trace::Span Tracer("Merge and score results");
@@ -1541,9 +1576,8 @@ private:
     };
     llvm::DenseSet<const Symbol *> UsedIndexResults;
     auto CorrespondingIndexResult =
-        [&](const CodeCompletionResult &SemaResult) -> const Symbol * {
-      if (auto SymID =
-              getSymbolID(SemaResult, Recorder->CCSema->getSourceManager())) {
+        [&](const llvm::Optional<SymbolID> &SymID) -> const Symbol * {
+      if (SymID) {
         auto I = IndexResults.find(*SymID);
         if (I != IndexResults.end()) {
           UsedIndexResults.insert(&*I);
@@ -1553,8 +1587,10 @@ private:
       return nullptr;
     };
     // Emit all Sema results, merging them with Index results if possible.
-    for (auto &SemaResult : SemaResults)
-      AddToBundles(&SemaResult, CorrespondingIndexResult(SemaResult), nullptr);
+    assert(SemaResults.size() == SemaResultIDs.size());
+    for (size_t I = 0; I < SemaResults.size(); ++I)
+      AddToBundles(&SemaResults[I], CorrespondingIndexResult(SemaResultIDs[I]),
+                   nullptr);
     // Now emit any Index-only results.
     for (const auto &IndexResult : IndexResults) {
       if (UsedIndexResults.count(&IndexResult))
@@ -1567,8 +1603,25 @@ private:
     // We only keep the best N results at any time, in "native" format.
     TopN<ScoredBundle, ScoredBundleGreater> Top(
         Opts.Limit == 0 ? std::numeric_limits<size_t>::max() : Opts.Limit);
-    for (auto &Bundle : Bundles)
-      addCandidate(Top, std::move(Bundle));
+    for (size_t I = 0; I < Bundles.size(); ++I) {
+      // Stop scoring if the results are no longer wanted, or are wanted now.
+      // Checking the context and the clock has a cost, so do it periodically.
+      if (I % ScoringCheckInterval == 0 && I != 0) {
+        if (isCancelled()) {
+          SPAN_ATTACH(Tracer, "cancelled", true);
+          break;
+        }
+        if (ScoringDeadline.expired()) {
+          vlog("Code complete: latency budget exhausted after scoring {0} of "
+               "{1} candidates",
+               I, Bundles.size());
+          SPAN_ATTACH(Tracer, "scored_before_deadline", int64_t(I));
+          Incomplete = true;
+          break;
+        }
+      }
+      addCandidate(Top, std::move(Bundles[I]));
+    }
     return std::move(Top).items();
   }
 
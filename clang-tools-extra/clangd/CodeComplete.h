@@ -31,6 +31,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
+#include <chrono>
 #include <future>
 
 namespace clang {
@@ -96,6 +97,12 @@ struct CodeCompleteOptions {
   /// this should be effective for a number of code completions.
   bool SpeculativeIndexRequest = false;
 
+  /// If set, candidates stop being scored once this much time has passed since
+  /// completion started, and the best ones scored so far are returned as an
+  /// incomplete result. This bounds the latency of completions with many
+  /// candidates, at the cost of ranking quality.
+  llvm::Optional<std::chrono::milliseconds> LatencyBudget;
+
   // Populated internally by clangd, do not set.
   /// If `Index` is set, it is used to augment the code completion
   /// results.
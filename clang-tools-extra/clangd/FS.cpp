@@ -9,6 +9,7 @@
 #include "FS.h"
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/None.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
@@ -111,6 +112,144 @@ PreambleFileStatusCache::getConsumingFS(
   return llvm::IntrusiveRefCntPtr<CacheVFS>(new CacheVFS(std::move(FS), *this));
 }
 
+namespace {
+/// A buffer referring to contents owned by a SharedFileContents store.
+class SharedMemoryBuffer : public llvm::MemoryBuffer {
+public:
+  SharedMemoryBuffer(std::shared_ptr<const llvm::MemoryBuffer> Contents,
+                     std::string Name)
+      : Contents(std::move(Contents)), Name(std::move(Name)) {
+    init(this->Contents->getBufferStart(), this->Contents->getBufferEnd(),
+         /*RequiresNullTerminator=*/true);
+  }
+
+  llvm::StringRef getBufferIdentifier() const override { return Name; }
+
+  BufferKind getBufferKind() const override {
+    return Contents->getBufferKind();
+  }
+
+private:
+  std::shared_ptr<const llvm::MemoryBuffer> Contents;
+  std::string Name;
+};
+} // namespace
+
+llvm::ErrorOr<std::shared_ptr<const llvm::MemoryBuffer>>
+SharedFileContents::getOrLoad(
+    const llvm::vfs::Status &S,
+    llvm::function_ref<llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>()>
+        Load) {
+  Key K(S.getUniqueID(), S.getLastModificationTime(), S.getSize());
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = Contents.find(K);
+    if (It != Contents.end())
+      if (auto Existing = It->second.lock())
+        return Existing;
+  }
+
+  // Read the file without holding the lock. If another thread read it in the
+  // meantime, use its copy and drop ours.
+  auto Buffer = Load();
+  if (!Buffer)
+    return Buffer.getError();
+  std::shared_ptr<const llvm::MemoryBuffer> Loaded = std::move(*Buffer);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  std::weak_ptr<const llvm::MemoryBuffer> &Entry = Contents[K];
+  if (auto Existing = Entry.lock())
+    return Existing;
+  Entry = Loaded;
+  if (Contents.size() >= NextSweepSize) {
+    for (auto It = Contents.begin(); It != Contents.end();)
+      It = It->second.expired() ? Contents.erase(It) : std::next(It);
+    NextSweepSize = std::max<size_t>(1024, 2 * Contents.size());
+  }
+  return Loaded;
+}
+
+size_t SharedFileContents::getBytesSaved() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  size_t Saved = 0;
+  for (const auto &Entry : Contents) {
+    auto Buffer = Entry.second.lock();
+    if (!Buffer)
+      continue;
+    // Each buffer handed out holds a reference, besides the one taken here.
+    long Users = Buffer.use_count() - 1;
+    if (Users > 1)
+      Saved += (Users - 1) * Buffer->getBufferSize();
+  }
+  return Saved;
+}
+
+SharedFileContents &SharedFileContents::getGlobal() {
+  static SharedFileContents *Global = new SharedFileContents();
+  return *Global;
+}
+
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>
+SharedFileContents::getSharingFS(
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS) {
+  class SharingFile : public llvm::vfs::File {
+  public:
+    SharingFile(std::unique_ptr<llvm::vfs::File> Wrapped,
+                SharedFileContents &Store)
+        : Wrapped(std::move(Wrapped)), Store(Store) {}
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
+    getBuffer(const llvm::Twine &Name, int64_t FileSize,
+              bool RequiresNullTerminator, bool IsVolatile) override {
+      auto S = Wrapped->status();
+      if (IsVolatile || !S || !S->isRegularFile())
+        return Wrapped->getBuffer(Name, FileSize, RequiresNullTerminator,
+                                  IsVolatile);
+      // Shared contents always have a null terminator, so that they can be
+      // handed out whether one is required or not.
+      auto Contents = Store.getOrLoad(*S, [&] {
+        return Wrapped->getBuffer(Name, FileSize,
+                                  /*RequiresNullTerminator=*/true,
+                                  /*IsVolatile=*/false);
+      });
+      if (!Contents)
+        return Contents.getError();
+      return llvm::make_unique<SharedMemoryBuffer>(std::move(*Contents),
+                                                   Name.str());
+    }
+
+    llvm::ErrorOr<llvm::vfs::Status> status() override {
+      return Wrapped->status();
+    }
+    llvm::ErrorOr<std::string> getName() override { return Wrapped->getName(); }
+    std::error_code close() override { return Wrapped->close(); }
+
+  private:
+    std::unique_ptr<llvm::vfs::File> Wrapped;
+    SharedFileContents &Store;
+  };
+
+  class SharingFS : public llvm::vfs::ProxyFileSystem {
+  public:
+    SharingFS(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS,
+              SharedFileContents &Store)
+        : ProxyFileSystem(std::move(FS)), Store(Store) {}
+
+    llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+    openFileForRead(const llvm::Twine &Path) override {
+      auto File = getUnderlyingFS().openFileForRead(Path);
+      if (!File || !*File)
+        return File;
+      return std::unique_ptr<llvm::vfs::File>(
+          new SharingFile(std::move(*File), Store));
+    }
+
+  private:
+    SharedFileContents &Store;
+  };
+  return llvm::IntrusiveRefCntPtr<SharingFS>(
+      new SharingFS(std::move(FS), *this));
+}
+
 Path removeDots(PathRef File) {
   llvm::SmallString<128> CanonPath(File);
   llvm::sys::path::remove_dots(CanonPath, /*remove_dot_dot=*/true);
@@ -12,7 +12,12 @@
 #include "Path.h"
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 namespace clang {
 namespace clangd {
@@ -66,6 +71,48 @@ private:
   llvm::StringMap<llvm::vfs::Status> StatCache;
 };
 
+/// Shares the contents of files read through its VFSs, so that all ASTs and
+/// preambles reading an unchanged header use one buffer (memory-mapped for
+/// large files) instead of each holding a copy of its own.
+///
+/// Contents are keyed by file identity, modification time and size, and are
+/// released once no buffer handed out for them is alive.
+///
+/// This class is thread-safe.
+class SharedFileContents {
+public:
+  /// Returns a VFS that reads file contents through this store. Files read as
+  /// volatile bypass the store, as their contents may change unnoticed.
+  ///
+  /// Note that the returned VFS should not outlive the store.
+  IntrusiveRefCntPtr<llvm::vfs::FileSystem>
+  getSharingFS(IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS);
+
+  /// Returns the number of bytes that the live buffers handed out would take
+  /// up on top of the shared contents if each of them had its own copy.
+  size_t getBytesSaved() const;
+
+  /// The store shared by the whole process, used by RealFileSystemProvider.
+  static SharedFileContents &getGlobal();
+
+private:
+  using Key =
+      std::tuple<llvm::sys::fs::UniqueID, llvm::sys::TimePoint<>, uint64_t>;
+
+  /// Returns the contents of the file with status \p S, calling \p Load to
+  /// read them if they are not in the store yet.
+  llvm::ErrorOr<std::shared_ptr<const llvm::MemoryBuffer>>
+  getOrLoad(const llvm::vfs::Status &S,
+            llvm::function_ref<
+                llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>()>
+                Load);
+
+  mutable std::mutex Mutex;
+  std::map<Key, std::weak_ptr<const llvm::MemoryBuffer>> Contents;
+  /// Expired entries are removed when the map grows to this size.
+  size_t NextSweepSize = 1024;
+};
+
 /// Returns a version of \p File that doesn't contain dots and dot dots.
 /// e.g /a/b/../c -> /a/c
 ///     /a/b/./c -> /a/b/c
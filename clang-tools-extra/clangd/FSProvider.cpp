@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "FSProvider.h"
+#include "FS.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
@@ -74,11 +75,14 @@ clang::clangd::RealFileSystemProvider::getFileSystem() const {
 // FIXME: Try to use a similar approach in Sema instead of relying on
 //        propagation of the 'isVolatile' flag through all layers.
 #ifdef _WIN32
-  return new VolatileFileSystem(
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = new VolatileFileSystem(
       llvm::vfs::createPhysicalFileSystem().release());
 #else
-  return llvm::vfs::createPhysicalFileSystem().release();
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS =
+      llvm::vfs::createPhysicalFileSystem().release();
 #endif
+  // Share the contents of headers between all the ASTs and preambles.
+  return SharedFileContents::getGlobal().getSharingFS(std::move(FS));
 }
 } // namespace clangd
 } // namespace clang
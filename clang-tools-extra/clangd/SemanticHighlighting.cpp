@@ -12,6 +12,8 @@
 #include "SourceCode.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/RecursiveASTVisitor.h"
+#include <algorithm>
+#include <limits>
 
 namespace clang {
 namespace clangd {
@@ -260,16 +262,68 @@ void write16be(uint16_t I, llvm::raw_ostream &OS) {
   llvm::support::endian::write16be(Buf.data(), I);
   OS.write(Buf.data(), Buf.size());
 }
+
+// Encodes the tokens of a line in the format of the LSP proposal.
+std::string encodeLine(llvm::ArrayRef<HighlightingToken> Tokens) {
+  llvm::SmallVector<char, 128> LineByteTokens;
+  llvm::raw_svector_ostream OS(LineByteTokens);
+  for (const auto &Token : Tokens) {
+    // Writes the token to LineByteTokens in the byte format specified by the
+    // LSP proposal. Described below.
+    // |<---- 4 bytes ---->|<-- 2 bytes -->|<--- 2 bytes -->|
+    // |    character      |  length       |    index       |
+
+    write32be(Token.R.start.character, OS);
+    write16be(Token.R.end.character - Token.R.start.character, OS);
+    write16be(static_cast<int>(Token.Kind), OS);
+  }
+  return encodeBase64(LineByteTokens);
+}
 } // namespace
 
 bool operator==(const HighlightingToken &Lhs, const HighlightingToken &Rhs) {
   return Lhs.Kind == Rhs.Kind && Lhs.R == Rhs.R;
 }
 
+bool operator==(const LineHighlightings &Lhs, const LineHighlightings &Rhs) {
+  return Lhs.Line == Rhs.Line && Lhs.Tokens == Rhs.Tokens;
+}
+
 std::vector<HighlightingToken> getSemanticHighlightings(ParsedAST &AST) {
   return HighlightingTokenCollector(AST).collectTokens();
 }
 
+std::vector<LineHighlightings>
+diffHighlightings(llvm::ArrayRef<HighlightingToken> New,
+                  llvm::ArrayRef<HighlightingToken> Old) {
+  // FIXME: Tokens might be multiple lines long (block comments), in this case
+  // they should be diffed on each of their lines.
+  auto LineOf = [](llvm::ArrayRef<HighlightingToken> Tokens) {
+    return Tokens.empty() ? std::numeric_limits<int>::max()
+                          : Tokens.front().R.start.line;
+  };
+  // Removes the tokens of \p Line from the front of \p Tokens, and returns
+  // them.
+  auto TakeLine = [](llvm::ArrayRef<HighlightingToken> &Tokens, int Line) {
+    auto End = llvm::find_if(Tokens, [&](const HighlightingToken &Token) {
+      return Token.R.start.line != Line;
+    });
+    auto LineTokens = Tokens.take_front(End - Tokens.begin());
+    Tokens = Tokens.drop_front(LineTokens.size());
+    return LineTokens;
+  };
+
+  std::vector<LineHighlightings> Diff;
+  while (!New.empty() || !Old.empty()) {
+    int Line = std::min(LineOf(New), LineOf(Old));
+    auto NewTokens = TakeLine(New, Line);
+    auto OldTokens = TakeLine(Old, Line);
+    if (NewTokens != OldTokens)
+      Diff.push_back({Line, NewTokens});
+  }
+  return Diff;
+}
+
 std::vector<SemanticHighlightingInformation>
 toSemanticHighlightingInformation(llvm::ArrayRef<HighlightingToken> Tokens) {
   if (Tokens.size() == 0)
@@ -283,26 +337,21 @@ toSemanticHighlightingInformation(llvm::ArrayRef<HighlightingToken> Tokens) {
 
   std::vector<SemanticHighlightingInformation> Lines;
   Lines.reserve(TokenLines.size());
-  for (const auto &Line : TokenLines) {
-    llvm::SmallVector<char, 128> LineByteTokens;
-    llvm::raw_svector_ostream OS(LineByteTokens);
-    for (const auto &Token : Line.second) {
-      // Writes the token to LineByteTokens in the byte format specified by the
-      // LSP proposal. Described below.
-      // |<---- 4 bytes ---->|<-- 2 bytes -->|<--- 2 bytes -->|
-      // |    character      |  length       |    index       |
-
-      write32be(Token.R.start.character, OS);
-      write16be(Token.R.end.character - Token.R.start.character, OS);
-      write16be(static_cast<int>(Token.Kind), OS);
-    }
-
-    Lines.push_back({Line.first, encodeBase64(LineByteTokens)});
-  }
+  for (const auto &Line : TokenLines)
+    Lines.push_back({Line.first, encodeLine(Line.second)});
 
   return Lines;
 }
 
+std::vector<SemanticHighlightingInformation>
+toSemanticHighlightingInformation(llvm::ArrayRef<LineHighlightings> Lines) {
+  std::vector<SemanticHighlightingInformation> Result;
+  Result.reserve(Lines.size());
+  for (const auto &Line : Lines)
+    Result.push_back({Line.Line, encodeLine(Line.Tokens)});
+  return Result;
+}
+
 llvm::StringRef toTextMateScope(HighlightingKind Kind) {
   // FIXME: Add scopes for C and Objective C.
   switch (Kind) {
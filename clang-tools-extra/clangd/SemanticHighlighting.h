@@ -45,6 +45,15 @@ struct HighlightingToken {
 
 bool operator==(const HighlightingToken &Lhs, const HighlightingToken &Rhs);
 
+// The highlightings of a single line.
+struct LineHighlightings {
+  int Line;
+  // Points into the highlightings the line was computed from.
+  llvm::ArrayRef<HighlightingToken> Tokens;
+};
+
+bool operator==(const LineHighlightings &Lhs, const LineHighlightings &Rhs);
+
 // Returns all HighlightingTokens from an AST. Only generates highlights for the
 // main AST.
 std::vector<HighlightingToken> getSemanticHighlightings(ParsedAST &AST);
@@ -53,9 +62,25 @@ std::vector<HighlightingToken> getSemanticHighlightings(ParsedAST &AST);
 /// (https://manual.macromates.com/en/language_grammars).
 llvm::StringRef toTextMateScope(HighlightingKind Kind);
 
+// Returns the lines whose highlightings differ between \p Old, the
+// highlightings last sent to the client, and \p New:
+//  - lines with the same tokens in both are omitted.
+//  - lines with tokens in New are returned with these tokens.
+//  - lines with tokens only in Old are returned without tokens, so that the
+//    client clears them.
+// REQUIRED: Old and New are sorted, as getSemanticHighlightings() returns
+// them.
+std::vector<LineHighlightings>
+diffHighlightings(llvm::ArrayRef<HighlightingToken> New,
+                  llvm::ArrayRef<HighlightingToken> Old);
+
 // Convert to LSP's semantic highlighting information.
 std::vector<SemanticHighlightingInformation>
 toSemanticHighlightingInformation(llvm::ArrayRef<HighlightingToken> Tokens);
+// Converts lines of highlightings, e.g. a diff, to LSP's semantic
+// highlighting information. Lines without tokens are sent empty.
+std::vector<SemanticHighlightingInformation>
+toSemanticHighlightingInformation(llvm::ArrayRef<LineHighlightings> Lines);
 
 } // namespace clangd
 } // namespace clang
@@ -44,6 +44,7 @@
 #include "TUScheduler.h"
 #include "Cancellation.h"
 #include "Compiler.h"
+#include "FS.h"
 #include "GlobalCompilationDatabase.h"
 #include "Logger.h"
 #include "Trace.h"
@@ -76,40 +77,69 @@ llvm::Optional<llvm::StringRef> TUScheduler::getFileBeingProcessedInContext() {
 }
 
 /// An LRU cache of idle ASTs.
-/// Because we want to limit the overall number of these we retain, the cache
-/// owns ASTs (and may evict them) while their workers are idle.
+/// Because we want to limit the overall number and size of these we retain,
+/// the cache owns ASTs (and may evict them) while their workers are idle.
 /// Workers borrow ASTs when active, and return them when done.
 class TUScheduler::ASTCache {
 public:
   using Key = const ASTWorker *;
 
-  ASTCache(unsigned MaxRetainedASTs) : MaxRetainedASTs(MaxRetainedASTs) {}
+  ASTCache(const ASTRetentionPolicy &Policy)
+      : MaxRetainedASTs(Policy.MaxRetainedASTs),
+        MaxRetainedBytes(Policy.MaxRetainedBytes) {}
 
   /// Returns result of getUsedBytes() for the AST cached by \p K.
   /// If no AST is cached, 0 is returned.
   std::size_t getUsedBytes(Key K) {
     std::lock_guard<std::mutex> Lock(Mut);
     auto It = findByKey(K);
-    if (It == LRU.end() || !It->second)
+    if (It == LRU.end())
       return 0;
-    return It->second->getUsedBytes();
+    return It->Bytes;
   }
 
-  /// Store the value in the pool, possibly removing the last used AST.
+  /// Returns the total size of the cached ASTs.
+  std::size_t getRetainedBytes() {
+    std::lock_guard<std::mutex> Lock(Mut);
+    return RetainedBytes;
+  }
+
+  /// Store the value in the pool, possibly removing the least recently used
+  /// ASTs to stay within the retention policy.
   /// The value should not be in the pool when this function is called.
   void put(Key K, std::unique_ptr<ParsedAST> V) {
-    std::unique_lock<std::mutex> Lock(Mut);
-    assert(findByKey(K) == LRU.end());
-
-    LRU.insert(LRU.begin(), {K, std::move(V)});
-    if (LRU.size() <= MaxRetainedASTs)
+    // An idle AST does not change, so measure it once, outside the lock.
+    std::size_t Bytes = V ? V->getUsedBytes() : 0;
+    std::vector<std::unique_ptr<ParsedAST>> ForCleanup;
+    std::size_t BytesAfterEviction;
+    {
+      std::lock_guard<std::mutex> Lock(Mut);
+      assert(findByKey(K) == LRU.end());
+
+      LRU.insert(LRU.begin(), {K, std::move(V), Bytes});
+      RetainedBytes += Bytes;
+      // Remove the last elements while we're past the limits, but always keep
+      // the AST we just stored.
+      while (LRU.size() > 1 &&
+             (LRU.size() > MaxRetainedASTs ||
+              (MaxRetainedBytes && RetainedBytes > MaxRetainedBytes))) {
+        RetainedBytes -= LRU.back().Bytes;
+        ForCleanup.push_back(std::move(LRU.back().AST));
+        LRU.pop_back();
+      }
+      BytesAfterEviction = RetainedBytes;
+    }
+    if (ForCleanup.empty())
       return;
-    // We're past the limit, remove the last element.
-    std::unique_ptr<ParsedAST> ForCleanup = std::move(LRU.back().second);
-    LRU.pop_back();
-    // Run the expensive destructor outside the lock.
-    Lock.unlock();
-    ForCleanup.reset();
+    trace::Span Tracer("EvictIdleASTs");
+    SPAN_ATTACH(Tracer, "evicted", static_cast<int64_t>(ForCleanup.size()));
+    SPAN_ATTACH(Tracer, "retainedBytes",
+                static_cast<int64_t>(BytesAfterEviction));
+    SPAN_ATTACH(Tracer, "sharedFileBytesSaved",
+                static_cast<int64_t>(
+                    SharedFileContents::getGlobal().getBytesSaved()));
+    // Run the expensive destructors outside the lock.
+    ForCleanup.clear();
   }
 
   /// Returns the cached value for \p K, or llvm::None if the value is not in
@@ -120,7 +150,8 @@ public:
     auto Existing = findByKey(K);
     if (Existing == LRU.end())
       return None;
-    std::unique_ptr<ParsedAST> V = std::move(Existing->second);
+    std::unique_ptr<ParsedAST> V = std::move(Existing->AST);
+    RetainedBytes -= Existing->Bytes;
     LRU.erase(Existing);
     // GCC 4.8 fails to compile `return V;`, as it tries to call the copy
     // constructor of unique_ptr, so we call the move ctor explicitly to avoid
@@ -129,17 +160,25 @@ public:
   }
 
 private:
-  using KVPair = std::pair<Key, std::unique_ptr<ParsedAST>>;
+  struct Entry {
+    Key K;
+    std::unique_ptr<ParsedAST> AST;
+    /// The result of AST->getUsedBytes() when the AST was stored.
+    std::size_t Bytes;
+  };
 
-  std::vector<KVPair>::iterator findByKey(Key K) {
-    return llvm::find_if(LRU, [K](const KVPair &P) { return P.first == K; });
+  std::vector<Entry>::iterator findByKey(Key K) {
+    return llvm::find_if(LRU, [K](const Entry &E) { return E.K == K; });
   }
 
   std::mutex Mut;
   unsigned MaxRetainedASTs;
+  std::size_t MaxRetainedBytes;
+  /// The sum of the sizes of the ASTs in LRU.
+  std::size_t RetainedBytes = 0; /* GUARDED_BY(Mut) */
   /// Items sorted in LRU order, i.e. first item is the most recently accessed
   /// one.
-  std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
+  std::vector<Entry> LRU; /* GUARDED_BY(Mut) */
 };
 
 namespace {
@@ -158,9 +197,10 @@ class ASTWorkerHandle;
 class ASTWorker {
   friend class ASTWorkerHandle;
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
-            TUScheduler::ASTCache &LRUCache, Semaphore &Barrier, bool RunSync,
-            steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
-            ParsingCallbacks &Callbacks);
+            TUScheduler::ASTCache &LRUCache,
+            SharedPreambleStore *SharedPreambles, Semaphore &Barrier,
+            bool RunSync, steady_clock::duration UpdateDebounce,
+            bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
 
 public:
   /// Create a new ASTWorker and return a handle to it.
@@ -168,11 +208,13 @@ public:
   /// is null, all requests will be processed on the calling thread
   /// synchronously instead. \p Barrier is acquired when processing each
   /// request, it is used to limit the number of actively running threads.
+  /// If \p SharedPreambles is set, preambles are shared with other workers.
   static ASTWorkerHandle
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
-         TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
-         Semaphore &Barrier, steady_clock::duration UpdateDebounce,
-         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
+         TUScheduler::ASTCache &IdleASTs, SharedPreambleStore *SharedPreambles,
+         AsyncTaskRunner *Tasks, Semaphore &Barrier,
+         steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
+         ParsingCallbacks &Callbacks);
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics);
@@ -212,6 +254,12 @@ private:
   /// Updates the TUStatus and emits it. Only called in the worker thread.
   void emitTUStatus(TUAction FAction,
                     const TUStatus::BuildDetails *Detail = nullptr);
+  /// If the preamble region of \p Inputs has directives that the stale
+  /// \p Preamble lacks, publishes the diagnostics of an AST built with the
+  /// stale preamble and a patch, before the preamble is rebuilt.
+  void publishWithPatchedPreamble(const ParseInputs &Inputs,
+                                  const CompilerInvocation &Invocation,
+                                  std::shared_ptr<const PreambleData> Preamble);
 
   /// Determines the next action to perform.
   /// All actions that should never run are discarded.
@@ -235,6 +283,8 @@ private:
 
   /// Handles retention of ASTs.
   TUScheduler::ASTCache &IdleASTs;
+  /// Preambles shared with other workers, or null.
+  SharedPreambleStore *SharedPreambles;
   const bool RunSync;
   /// Time to wait after an update to see whether another update obsoletes it.
   const steady_clock::duration UpdateDebounce;
@@ -320,12 +370,13 @@ private:
 
 ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
-                  TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
+                  TUScheduler::ASTCache &IdleASTs,
+                  SharedPreambleStore *SharedPreambles, AsyncTaskRunner *Tasks,
                   Semaphore &Barrier, steady_clock::duration UpdateDebounce,
                   bool StorePreamblesInMemory, ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks,
-                    UpdateDebounce, StorePreamblesInMemory, Callbacks));
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, SharedPreambles, Barrier, /*RunSync=*/!Tasks,
+      UpdateDebounce, StorePreamblesInMemory, Callbacks));
   if (Tasks)
     Tasks->runAsync("worker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -334,10 +385,12 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 }
 
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
-                     TUScheduler::ASTCache &LRUCache, Semaphore &Barrier,
+                     TUScheduler::ASTCache &LRUCache,
+                     SharedPreambleStore *SharedPreambles, Semaphore &Barrier,
                      bool RunSync, steady_clock::duration UpdateDebounce,
                      bool StorePreamblesInMemory, ParsingCallbacks &Callbacks)
-    : IdleASTs(LRUCache), RunSync(RunSync), UpdateDebounce(UpdateDebounce),
+    : IdleASTs(LRUCache), SharedPreambles(SharedPreambles), RunSync(RunSync),
+      UpdateDebounce(UpdateDebounce),
       FileName(FileName), CDB(CDB),
       StorePreambleInMemory(StorePreamblesInMemory),
       Callbacks(Callbacks), Status{TUAction(TUAction::Idle, ""),
@@ -410,13 +463,17 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
 
     std::shared_ptr<const PreambleData> OldPreamble =
         getPossiblyStalePreamble();
+    if (OldPreamble && WantDiags != WantDiagnostics::No &&
+        Inputs.CompileCommand == OldCommand)
+      publishWithPatchedPreamble(Inputs, *Invocation, OldPreamble);
     std::shared_ptr<const PreambleData> NewPreamble = buildPreamble(
         FileName, *Invocation, OldPreamble, OldCommand, Inputs,
         StorePreambleInMemory,
         [this](ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
                const CanonicalIncludes &CanonIncludes) {
           Callbacks.onPreambleAST(FileName, Ctx, std::move(PP), CanonIncludes);
-        });
+        },
+        SharedPreambles);
 
     bool CanReuseAST = InputsAreTheSame && (OldPreamble == NewPreamble);
     {
@@ -592,6 +649,34 @@ std::size_t ASTWorker::getUsedBytes() const {
   return Result;
 }
 
+void ASTWorker::publishWithPatchedPreamble(
+    const ParseInputs &Inputs, const CompilerInvocation &Invocation,
+    std::shared_ptr<const PreambleData> Preamble) {
+  PreamblePatch Patch =
+      PreamblePatch::create(FileName, Inputs, *Preamble, Invocation);
+  // Without new directives, the preamble is either reused or rebuilt for
+  // changes a patch cannot express.
+  if (Patch.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> Lock(PublishMu);
+    if (!CanPublishResults)
+      return;
+  }
+  llvm::Optional<ParsedAST> AST =
+      buildAST(FileName, llvm::make_unique<CompilerInvocation>(Invocation),
+               Inputs, std::move(Preamble), &Patch);
+  if (!AST)
+    return;
+  trace::Span Span("Running patched main AST callback");
+  Callbacks.onMainAST(FileName, *AST,
+                      [&](llvm::function_ref<void()> Publish) {
+                        std::lock_guard<std::mutex> Lock(PublishMu);
+                        if (CanPublishResults)
+                          Publish();
+                      });
+}
+
 bool ASTWorker::isASTCached() const { return IdleASTs.getUsedBytes(this) != 0; }
 
 void ASTWorker::stop() {
@@ -828,12 +913,15 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                          bool StorePreamblesInMemory,
                          std::unique_ptr<ParsingCallbacks> Callbacks,
                          std::chrono::steady_clock::duration UpdateDebounce,
-                         ASTRetentionPolicy RetentionPolicy)
+                         ASTRetentionPolicy RetentionPolicy,
+                         bool SharePreambles)
     : CDB(CDB), StorePreamblesInMemory(StorePreamblesInMemory),
       Callbacks(Callbacks ? move(Callbacks)
                           : llvm::make_unique<ParsingCallbacks>()),
       Barrier(AsyncThreadsCount),
-      IdleASTs(llvm::make_unique<ASTCache>(RetentionPolicy.MaxRetainedASTs)),
+      IdleASTs(llvm::make_unique<ASTCache>(RetentionPolicy)),
+      SharedPreambles(SharePreambles ? llvm::make_unique<SharedPreambleStore>()
+                                     : nullptr),
       UpdateDebounce(UpdateDebounce) {
   if (0 < AsyncThreadsCount) {
     PreambleTasks.emplace();
@@ -869,7 +957,7 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
   if (!FD) {
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker = ASTWorker::create(
-        File, CDB, *IdleASTs,
+        File, CDB, *IdleASTs, SharedPreambles.get(),
         WorkerThreads ? WorkerThreads.getPointer() : nullptr, Barrier,
         UpdateDebounce, StorePreamblesInMemory, *Callbacks);
     FD = std::unique_ptr<FileData>(
@@ -996,6 +1084,10 @@ TUScheduler::getUsedBytesPerFile() const {
   return Result;
 }
 
+std::size_t TUScheduler::getRetainedASTBytes() const {
+  return IdleASTs->getRetainedBytes();
+}
+
 std::vector<Path> TUScheduler::getFilesWithCachedAST() const {
   std::vector<Path> Result;
   for (auto &&PathAndFile : Files) {
@@ -55,6 +55,11 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum total size in bytes, as reported by ParsedAST::getUsedBytes(), of
+  /// the ASTs retained in memory when there are no pending requests for them.
+  /// The most recently used AST is retained even if it exceeds the budget.
+  /// Zero means no limit.
+  std::size_t MaxRetainedBytes = 0;
 };
 
 struct TUAction {
@@ -142,13 +147,17 @@ public:
               bool StorePreamblesInMemory,
               std::unique_ptr<ParsingCallbacks> ASTCallbacks,
               std::chrono::steady_clock::duration UpdateDebounce,
-              ASTRetentionPolicy RetentionPolicy);
+              ASTRetentionPolicy RetentionPolicy, bool SharePreambles = false);
   ~TUScheduler();
 
   /// Returns estimated memory usage for each of the currently open files.
   /// The order of results is unspecified.
   std::vector<std::pair<Path, std::size_t>> getUsedBytesPerFile() const;
 
+  /// Returns the total estimated memory usage of the idle ASTs retained by the
+  /// ASTRetentionPolicy.
+  std::size_t getRetainedASTBytes() const;
+
   /// Returns a list of files with ASTs currently stored in memory. This method
   /// is not very reliable and is only used for test. E.g., the results will not
   /// contain files that currently run something over their AST.
@@ -243,6 +252,8 @@ private:
   Semaphore Barrier;
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
+  /// Preambles shared between files, null if SharePreambles was not set.
+  std::unique_ptr<SharedPreambleStore> SharedPreambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
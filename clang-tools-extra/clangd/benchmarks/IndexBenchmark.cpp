@@ -8,6 +8,8 @@
 
 #include "../index/Serialization.h"
 #include "../index/dex/Dex.h"
+#include "../index/dex/Iterator.h"
+#include "../index/dex/PostingList.h"
 #include "benchmark/benchmark.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -83,6 +85,26 @@ static void DexQueries(benchmark::State &State) {
 }
 BENCHMARK(DexQueries);
 
+// Intersects a dense posting list with a sparse one, which is dominated by
+// skipping over the blocks of the dense list.
+static void DexPostingListIntersection(benchmark::State &State) {
+  std::vector<dex::DocID> Dense, Sparse;
+  for (dex::DocID I = 0; I < 1000000; ++I)
+    Dense.push_back(2 * I + I % 2);
+  for (dex::DocID I = 0; I < 10000; ++I)
+    Sparse.push_back(197 * I);
+  const dex::PostingList DenseList(Dense), SparseList(Sparse);
+  const dex::Corpus C(3000000);
+  for (auto _ : State) {
+    auto It = C.intersect(DenseList.iterator(), SparseList.iterator());
+    size_t Matches = 0;
+    for (; !It->reachedEnd(); It->advance())
+      ++Matches;
+    benchmark::DoNotOptimize(Matches);
+  }
+}
+BENCHMARK(DexPostingListIntersection);
+
 } // namespace
 } // namespace clangd
 } // namespace clang
@@ -148,6 +148,7 @@ BackgroundIndex::BackgroundIndex(
       CDB(CDB), BackgroundContext(std::move(BackgroundContext)),
       Rebuilder(this, &IndexedSymbols, ThreadPoolSize),
       IndexStorageFactory(std::move(IndexStorageFactory)),
+      ShardLoadingThreads(ThreadPoolSize),
       CommandsChanged(
           CDB.watch([&](const std::vector<std::string> &ChangedFiles) {
             enqueue(ChangedFiles);
@@ -455,8 +456,8 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
 
   Rebuilder.startLoading();
   // Load shards for all of the mainfiles.
-  const std::vector<LoadedShard> Result =
-      loadIndexShards(MainFiles, IndexStorageFactory, CDB);
+  const std::vector<LoadedShard> Result = loadIndexShards(
+      MainFiles, IndexStorageFactory, CDB, ShardLoadingThreads);
   size_t LoadedShards = 0;
   {
     // Update in-memory state.
@@ -175,6 +175,8 @@ private:
   std::mutex ShardVersionsMu;
 
   BackgroundIndexStorage::Factory IndexStorageFactory;
+  // Shards are loaded on this many threads.
+  size_t ShardLoadingThreads;
   // Tries to load shards for the MainFiles and their dependencies.
   std::vector<tooling::CompileCommand>
   loadProject(std::vector<std::string> MainFiles);
@@ -10,12 +10,14 @@
 #include "GlobalCompilationDatabase.h"
 #include "Logger.h"
 #include "Path.h"
+#include "Threading.h"
 #include "index/Background.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Path.h"
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -38,52 +40,77 @@ llvm::Optional<Path> uriToAbsolutePath(llvm::StringRef URI, PathRef HintPath) {
 /// inverse dependency mapping.
 class BackgroundIndexLoader {
 public:
-  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory)
-      : IndexStorageFactory(IndexStorageFactory) {}
-  /// Load the shards for \p MainFile and all of its dependencies.
-  void load(PathRef MainFile);
+  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory,
+                        unsigned Threads)
+      : IndexStorageFactory(IndexStorageFactory), Threads(Threads) {}
+  /// Load the shards for \p MainFiles and all of their dependencies.
+  void load(llvm::ArrayRef<Path> MainFiles);
 
   /// Consumes the loader and returns all shards.
   std::vector<LoadedShard> takeResult() &&;
 
 private:
-  /// Returns the Shard for \p StartSourceFile from cache or loads it from \p
-  /// Storage. Also returns paths for dependencies of \p StartSourceFile if it
-  /// wasn't cached yet.
-  std::pair<const LoadedShard &, std::vector<Path>>
-  loadShard(PathRef StartSourceFile, PathRef DependentTU);
+  /// Reads the shard of each of \p SourceFiles from storage, on up to Threads
+  /// threads. Shards are independent, and reading and parsing them dominates
+  /// the loading time.
+  std::vector<std::unique_ptr<IndexFileIn>>
+  readShards(llvm::ArrayRef<PathRef> SourceFiles);
+
+  /// Records the shard \p Shard of \p SourceFile and returns the paths of its
+  /// dependencies.
+  std::vector<Path> addShard(PathRef SourceFile, PathRef DependentTU,
+                             std::unique_ptr<IndexFileIn> Shard);
 
   /// Cache for Storage lookups.
   llvm::StringMap<LoadedShard> LoadedShards;
 
   BackgroundIndexStorage::Factory &IndexStorageFactory;
+  unsigned Threads;
 };
 
-std::pair<const LoadedShard &, std::vector<Path>>
-BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
-  auto It = LoadedShards.try_emplace(StartSourceFile);
-  LoadedShard &LS = It.first->getValue();
-  std::vector<Path> Edges = {};
-  // Return the cached shard.
-  if (!It.second)
-    return {LS, Edges};
+std::vector<std::unique_ptr<IndexFileIn>>
+BackgroundIndexLoader::readShards(llvm::ArrayRef<PathRef> SourceFiles) {
+  std::vector<std::unique_ptr<IndexFileIn>> Shards(SourceFiles.size());
+  std::atomic<size_t> Next(0);
+  auto Read = [&] {
+    for (size_t I = Next++; I < SourceFiles.size(); I = Next++) {
+      BackgroundIndexStorage *Storage = IndexStorageFactory(SourceFiles[I]);
+      Shards[I] = Storage->loadShard(SourceFiles[I]);
+    }
+  };
+  {
+    AsyncTaskRunner Readers;
+    size_t NumReaders = std::min<size_t>(Threads, SourceFiles.size());
+    for (size_t I = 1; I < NumReaders; ++I)
+      Readers.runAsync("shard-loader-" + llvm::Twine(I),
+                       [&Read, Ctx = Context::current().clone()]() mutable {
+                         WithContext WithCtx(std::move(Ctx));
+                         Read();
+                       });
+    Read();
+  }
+  return Shards;
+}
 
-  LS.AbsolutePath = StartSourceFile.str();
+std::vector<Path>
+BackgroundIndexLoader::addShard(PathRef SourceFile, PathRef DependentTU,
+                                std::unique_ptr<IndexFileIn> Shard) {
+  LoadedShard &LS = LoadedShards[SourceFile];
+  std::vector<Path> Edges = {};
+  LS.AbsolutePath = SourceFile.str();
   LS.DependentTU = DependentTU;
-  BackgroundIndexStorage *Storage = IndexStorageFactory(LS.AbsolutePath);
-  auto Shard = Storage->loadShard(StartSourceFile);
   if (!Shard || !Shard->Sources) {
-    vlog("Failed to load shard: {0}", StartSourceFile);
-    return {LS, Edges};
+    vlog("Failed to load shard: {0}", SourceFile);
+    return Edges;
   }
 
   LS.Shard = std::move(Shard);
   for (const auto &It : *LS.Shard->Sources) {
-    auto AbsPath = uriToAbsolutePath(It.getKey(), StartSourceFile);
+    auto AbsPath = uriToAbsolutePath(It.getKey(), SourceFile);
     if (!AbsPath)
       continue;
     // A shard contains only edges for non main-file sources.
-    if (*AbsPath != StartSourceFile) {
+    if (*AbsPath != SourceFile) {
       Edges.push_back(*AbsPath);
       continue;
     }
@@ -95,26 +122,36 @@ BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
     LS.HadErrors = IGN.Flags & IncludeGraphNode::SourceFlag::HadErrors;
   }
   assert(LS.Digest != FileDigest{{0}} && "Digest is empty?");
-  return {LS, Edges};
+  return Edges;
 }
 
-void BackgroundIndexLoader::load(PathRef MainFile) {
-  llvm::StringSet<> InQueue;
-  // Following containers points to strings inside InQueue.
-  std::queue<PathRef> ToVisit;
-  InQueue.insert(MainFile);
-  ToVisit.push(MainFile);
+void BackgroundIndexLoader::load(llvm::ArrayRef<Path> MainFiles) {
+  // The dependency graph is traversed breadth-first, a level at a time, so
+  // that the shards of a level can be read in parallel. A shard is attributed
+  // to the first TU that reaches it.
+  llvm::StringMap<PathRef> DependentTUs;
+  // Following containers points to strings inside DependentTUs.
+  std::vector<PathRef> ToVisit;
+  for (PathRef MainFile : MainFiles) {
+    assert(llvm::sys::path::is_absolute(MainFile));
+    auto It = DependentTUs.try_emplace(MainFile, MainFile);
+    if (It.second)
+      ToVisit.push_back(It.first->getKey());
+  }
 
   while (!ToVisit.empty()) {
-    PathRef SourceFile = ToVisit.front();
-    ToVisit.pop();
-
-    auto ShardAndEdges = loadShard(SourceFile, MainFile);
-    for (PathRef Edge : ShardAndEdges.second) {
-      auto It = InQueue.insert(Edge);
-      if (It.second)
-        ToVisit.push(It.first->getKey());
+    std::vector<std::unique_ptr<IndexFileIn>> Shards = readShards(ToVisit);
+    std::vector<PathRef> NextLevel;
+    for (size_t I = 0; I < ToVisit.size(); ++I) {
+      PathRef DependentTU = DependentTUs.lookup(ToVisit[I]);
+      for (Path &Edge :
+           addShard(ToVisit[I], DependentTU, std::move(Shards[I]))) {
+        auto It = DependentTUs.try_emplace(Edge, DependentTU);
+        if (It.second)
+          NextLevel.push_back(It.first->getKey());
+      }
     }
+    ToVisit = std::move(NextLevel);
   }
 }
 
@@ -130,12 +167,9 @@ std::vector<LoadedShard> BackgroundIndexLoader::takeResult() && {
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB) {
-  BackgroundIndexLoader Loader(IndexStorageFactory);
-  for (llvm::StringRef MainFile : MainFiles) {
-    assert(llvm::sys::path::is_absolute(MainFile));
-    Loader.load(MainFile);
-  }
+                const GlobalCompilationDatabase &CDB, unsigned Threads) {
+  BackgroundIndexLoader Loader(IndexStorageFactory, Threads);
+  Loader.load(MainFiles);
   return std::move(Loader).takeResult();
 }
 
@@ -42,11 +42,12 @@ struct LoadedShard {
   std::unique_ptr<IndexFileIn> Shard;
 };
 
-/// Loads all shards for the TU \p MainFile from \p Storage.
+/// Loads all shards for the TUs \p MainFiles from \p Storage. Shards are read
+/// on up to \p Threads threads.
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB);
+                const GlobalCompilationDatabase &CDB, unsigned Threads = 1);
 
 } // namespace clangd
 } // namespace clang
@@ -20,6 +20,7 @@
 #include "index/FileIndex.h"
 #include "index/IndexAction.h"
 #include "index/MemIndex.h"
+#include "index/Merge.h"
 #include "index/Ref.h"
 #include "index/Relation.h"
 #include "index/Serialization.h"
@@ -48,6 +49,54 @@
 
 namespace clang {
 namespace clangd {
+namespace {
+
+// Serves an index that is shared with the BackgroundIndexRebuilder.
+class SharedIndex : public SymbolIndex {
+public:
+  SharedIndex(std::shared_ptr<SymbolIndex> Index) : Index(std::move(Index)) {}
+
+  bool
+  fuzzyFind(const FuzzyFindRequest &Req,
+            llvm::function_ref<void(const Symbol &)> Callback) const override {
+    return Index->fuzzyFind(Req, Callback);
+  }
+  void
+  lookup(const LookupRequest &Req,
+         llvm::function_ref<void(const Symbol &)> Callback) const override {
+    Index->lookup(Req, Callback);
+  }
+  void refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override {
+    Index->refs(Req, Callback);
+  }
+  void relations(const RelationsRequest &Req,
+                 llvm::function_ref<void(const SymbolID &, const Symbol &)>
+                     Callback) const override {
+    Index->relations(Req, Callback);
+  }
+  size_t estimateMemoryUsage() const override {
+    return Index->estimateMemoryUsage();
+  }
+
+private:
+  std::shared_ptr<SymbolIndex> Index;
+};
+
+// Serves the index of the files changed since a full build over it.
+class IncrementalIndex : public MergedIndex {
+public:
+  IncrementalIndex(std::unique_ptr<SymbolIndex> Changed,
+                   std::shared_ptr<SymbolIndex> Full)
+      : MergedIndex(Changed.get(), Full.get()), Changed(std::move(Changed)),
+        Full(std::move(Full)) {}
+
+private:
+  std::unique_ptr<SymbolIndex> Changed;
+  std::shared_ptr<SymbolIndex> Full;
+};
+
+} // namespace
 
 bool BackgroundIndexRebuilder::enoughTUsToRebuild() const {
   if (!ActiveVersion)                         // never built
@@ -105,26 +154,48 @@ void BackgroundIndexRebuilder::shutdown() {
 void BackgroundIndexRebuilder::maybeRebuild(const char *Reason,
                                             std::function<bool()> Check) {
   unsigned BuildVersion = 0;
+  // The full index to build incrementally over, if any.
+  std::shared_ptr<SymbolIndex> Base;
   {
     std::lock_guard<std::mutex> Lock(Mu);
     if (!ShouldStop && Check()) {
+      // The changed files are relative to the last full build started, so a
+      // running build might be a full one that we don't have yet.
+      if (FullIndex && ActiveVersion == StartedVersion &&
+          Source->numChangedFiles() * 100 <
+              Source->numFiles() * ChangedFilesPercentForFullRebuild)
+        Base = FullIndex;
       BuildVersion = ++StartedVersion;
       IndexedTUsAtLastRebuild = IndexedTUs;
     }
   }
   if (BuildVersion) {
     std::unique_ptr<SymbolIndex> NewIndex;
+    std::shared_ptr<SymbolIndex> NewFullIndex;
     {
-      vlog("BackgroundIndex: building version {0} {1}", BuildVersion, Reason);
+      vlog("BackgroundIndex: building version {0} {1}{2}", BuildVersion,
+           Reason, Base ? " incrementally" : "");
       trace::Span Tracer("RebuildBackgroundIndex");
       SPAN_ATTACH(Tracer, "reason", Reason);
-      NewIndex = Source->buildIndex(IndexType::Heavy, DuplicateHandling::Merge);
+      SPAN_ATTACH(Tracer, "incremental", bool(Base));
+      if (Base) {
+        NewIndex = llvm::make_unique<IncrementalIndex>(
+            Source->buildChangedIndex(IndexType::Heavy,
+                                      DuplicateHandling::Merge),
+            std::move(Base));
+      } else {
+        NewFullIndex =
+            Source->buildIndex(IndexType::Heavy, DuplicateHandling::Merge);
+        NewIndex = llvm::make_unique<SharedIndex>(NewFullIndex);
+      }
     }
     {
       std::lock_guard<std::mutex> Lock(Mu);
       // Guard against rebuild finishing in the wrong order.
       if (BuildVersion > ActiveVersion) {
         ActiveVersion = BuildVersion;
+        if (NewFullIndex)
+          FullIndex = std::move(NewFullIndex);
         vlog("BackgroundIndex: serving version {0} ({1} bytes)", BuildVersion,
              NewIndex->estimateMemoryUsage());
         Target->reset(std::move(NewIndex));
@@ -40,6 +40,11 @@ namespace clangd {
 //
 // The index is rebuilt every time the queue goes idle, if it's stale.
 //
+// Rebuilds are incremental while few files changed since the last full build:
+// only the changed files are indexed, and served over the last full index.
+// Symbols removed from these files are still served until the next full
+// build, as are the reference counts of the full build.
+//
 // All methods are threadsafe. They're called after FileSymbols is updated
 // etc. Without external locking, the rebuilt index may include more updates
 // than intended, which is fine.
@@ -73,6 +78,8 @@ public:
   // Thresholds for rebuilding as TUs get indexed.
   const unsigned TUsBeforeFirstBuild; // Typically one per worker thread.
   const unsigned TUsBeforeRebuild = 100;
+  // Rebuilds are full once this percentage of the files changed.
+  const unsigned ChangedFilesPercentForFullRebuild = 20;
 
 private:
   // Run Check under the lock, and rebuild if it returns true.
@@ -91,6 +98,8 @@ private:
   // Are we loading shards? May be multiple concurrent sessions.
   unsigned Loading = 0;
   unsigned LoadedShards; // In the current loading session.
+  // The last full index, which incremental rebuilds are served over.
+  std::shared_ptr<SymbolIndex> FullIndex;
 
   SwapIndex *Target;
   FileSymbols *Source;
@@ -96,6 +96,7 @@ void FileSymbols::update(PathRef Path, std::unique_ptr<SymbolSlab> Symbols,
                          std::unique_ptr<RelationSlab> Relations,
                          bool CountReferences) {
   std::lock_guard<std::mutex> Lock(Mutex);
+  ChangedFiles.insert(Path);
   if (!Symbols)
     FileToSymbols.erase(Path);
   else
@@ -116,21 +117,54 @@ void FileSymbols::update(PathRef Path, std::unique_ptr<SymbolSlab> Symbols,
 
 std::unique_ptr<SymbolIndex>
 FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle) {
+  return build(Type, DuplicateHandle, /*OnlyChanged=*/false);
+}
+
+std::unique_ptr<SymbolIndex>
+FileSymbols::buildChangedIndex(IndexType Type,
+                               DuplicateHandling DuplicateHandle) {
+  return build(Type, DuplicateHandle, /*OnlyChanged=*/true);
+}
+
+size_t FileSymbols::numFiles() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return FileToSymbols.size();
+}
+
+size_t FileSymbols::numChangedFiles() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return ChangedFiles.size();
+}
+
+std::unique_ptr<SymbolIndex>
+FileSymbols::build(IndexType Type, DuplicateHandling DuplicateHandle,
+                   bool OnlyChanged) {
   std::vector<std::shared_ptr<SymbolSlab>> SymbolSlabs;
   std::vector<std::shared_ptr<RefSlab>> RefSlabs;
   std::vector<std::shared_ptr<RelationSlab>> RelationSlabs;
   std::vector<RefSlab *> MainFileRefs;
   {
     std::lock_guard<std::mutex> Lock(Mutex);
+    auto Included = [&](llvm::StringRef File) {
+      return !OnlyChanged || ChangedFiles.count(File);
+    };
     for (const auto &FileAndSymbols : FileToSymbols)
-      SymbolSlabs.push_back(FileAndSymbols.second);
+      if (Included(FileAndSymbols.first()))
+        SymbolSlabs.push_back(FileAndSymbols.second);
     for (const auto &FileAndRefs : FileToRefs) {
+      if (!Included(FileAndRefs.first()))
+        continue;
       RefSlabs.push_back(FileAndRefs.second.Slab);
-      if (FileAndRefs.second.CountReferences)
+      // Counting references again in a changed index would double them once
+      // it is merged with the full index.
+      if (FileAndRefs.second.CountReferences && !OnlyChanged)
         MainFileRefs.push_back(RefSlabs.back().get());
     }
     for (const auto &FileAndRelations : FileToRelations)
-      RelationSlabs.push_back(FileAndRelations.second);
+      if (Included(FileAndRelations.first()))
+        RelationSlabs.push_back(FileAndRelations.second);
+    if (!OnlyChanged)
+      ChangedFiles.clear();
   }
   std::vector<const Symbol *> AllSymbols;
   std::vector<Symbol> SymsStorage;
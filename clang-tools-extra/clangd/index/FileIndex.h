@@ -22,6 +22,7 @@
 #include "index/CanonicalIncludes.h"
 #include "index/Symbol.h"
 #include "clang/Lex/Preprocessor.h"
+#include "llvm/ADT/StringSet.h"
 #include <memory>
 
 namespace clang {
@@ -73,7 +74,23 @@ public:
   buildIndex(IndexType,
              DuplicateHandling DuplicateHandle = DuplicateHandling::PickOne);
 
+  /// Like buildIndex(), but only indexes the files updated since the last
+  /// buildIndex(), and doesn't count references. The result is meant to be
+  /// layered over the index built by the last buildIndex(), which still has
+  /// the symbols removed from these files since.
+  std::unique_ptr<SymbolIndex>
+  buildChangedIndex(IndexType, DuplicateHandling DuplicateHandle =
+                                   DuplicateHandling::PickOne);
+
+  /// Returns the number of files with symbols.
+  size_t numFiles() const;
+  /// Returns the number of files updated since the last buildIndex().
+  size_t numChangedFiles() const;
+
 private:
+  std::unique_ptr<SymbolIndex> build(IndexType, DuplicateHandling,
+                                     bool OnlyChanged);
+
   struct RefSlabAndCountReferences {
     std::shared_ptr<RefSlab> Slab;
     bool CountReferences = false;
@@ -86,6 +103,8 @@ private:
   llvm::StringMap<RefSlabAndCountReferences> FileToRefs;
   /// Stores the latest relation snapshots for all active files.
   llvm::StringMap<std::shared_ptr<RelationSlab>> FileToRelations;
+  /// Files updated since the last buildIndex().
+  llvm::StringSet<> ChangedFiles;
 };
 
 /// This manages symbols from files and an in-memory index on all symbols.
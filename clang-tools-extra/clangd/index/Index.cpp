@@ -57,6 +57,86 @@ llvm::json::Value toJSON(const FuzzyFindRequest &Request) {
   };
 }
 
+static llvm::json::Value toJSON(const llvm::DenseSet<SymbolID> &IDs) {
+  llvm::json::Array Result;
+  for (const SymbolID &ID : IDs)
+    Result.push_back(ID.str());
+  return std::move(Result);
+}
+
+static bool fromJSON(const llvm::json::Value &Parameters,
+                     llvm::DenseSet<SymbolID> &IDs) {
+  std::vector<std::string> Strings;
+  if (!fromJSON(Parameters, Strings))
+    return false;
+  for (const std::string &S : Strings) {
+    auto ID = SymbolID::fromStr(S);
+    if (!ID) {
+      llvm::consumeError(ID.takeError());
+      return false;
+    }
+    IDs.insert(*ID);
+  }
+  return true;
+}
+
+// Maps the optional "Limit" of a request, which is absent when unset.
+static bool mapLimit(llvm::json::ObjectMapper &O,
+                     llvm::Optional<uint32_t> &Limit) {
+  int64_t Value;
+  if (!O.map("Limit", Value))
+    return true;
+  if (Value < 0 || Value > std::numeric_limits<uint32_t>::max())
+    return false;
+  Limit = Value;
+  return true;
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, LookupRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  return O && O.map("IDs", Request.IDs);
+}
+
+llvm::json::Value toJSON(const LookupRequest &Request) {
+  return llvm::json::Object{{"IDs", toJSON(Request.IDs)}};
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, RefsRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  int64_t Filter;
+  if (!O || !O.map("IDs", Request.IDs) || !O.map("Filter", Filter) ||
+      !mapLimit(O, Request.Limit))
+    return false;
+  Request.Filter = static_cast<RefKind>(Filter) & RefKind::All;
+  return true;
+}
+
+llvm::json::Value toJSON(const RefsRequest &Request) {
+  return llvm::json::Object{
+      {"IDs", toJSON(Request.IDs)},
+      {"Filter", static_cast<int64_t>(Request.Filter)},
+      {"Limit", Request.Limit},
+  };
+}
+
+bool fromJSON(const llvm::json::Value &Parameters, RelationsRequest &Request) {
+  llvm::json::ObjectMapper O(Parameters);
+  int64_t Predicate;
+  if (!O || !O.map("Subjects", Request.Subjects) ||
+      !O.map("Predicate", Predicate) || !mapLimit(O, Request.Limit))
+    return false;
+  Request.Predicate = static_cast<index::SymbolRole>(Predicate);
+  return true;
+}
+
+llvm::json::Value toJSON(const RelationsRequest &Request) {
+  return llvm::json::Object{
+      {"Subjects", toJSON(Request.Subjects)},
+      {"Predicate", static_cast<int64_t>(Request.Predicate)},
+      {"Limit", Request.Limit},
+  };
+}
+
 bool SwapIndex::fuzzyFind(const FuzzyFindRequest &R,
                           llvm::function_ref<void(const Symbol &)> CB) const {
   return snapshot()->fuzzyFind(R, CB);
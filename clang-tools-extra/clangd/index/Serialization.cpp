@@ -14,6 +14,7 @@
 #include "SymbolOrigin.h"
 #include "Trace.h"
 #include "dex/Dex.h"
+#include "dex/MappedDex.h"
 #include "clang/Tooling/CompilationDatabase.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Compression.h"
@@ -670,6 +671,9 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &OS, const IndexFileOut &O) {
   case IndexFileFormat::YAML:
     writeYAML(O, OS);
     break;
+  case IndexFileFormat::Mapped:
+    dex::writeMappedDex(O.Symbols, O.Refs, O.Relations, OS);
+    break;
   }
   return OS;
 }
@@ -677,6 +681,11 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &OS, const IndexFileOut &O) {
 llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef Data) {
   if (Data.startswith("RIFF")) {
     return readRIFF(Data);
+  } else if (dex::MappedDex::isMappedIndex(Data)) {
+    auto Index = dex::MappedDex::create(Data);
+    if (!Index)
+      return Index.takeError();
+    return (*Index)->decode();
   } else if (auto YAMLContents = readYAML(Data)) {
     return std::move(*YAMLContents);
   } else {
@@ -688,12 +697,27 @@ llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef Data) {
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
                                        bool UseDex) {
   trace::Span OverallTracer("LoadIndex");
-  auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename);
+  // No null terminator is needed, which allows the file to be mapped even if
+  // its size is a multiple of the page size.
+  auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename, /*FileSize=*/-1,
+                                            /*RequiresNullTerminator=*/false);
   if (!Buffer) {
     llvm::errs() << "Can't open " << SymbolFilename << "\n";
     return nullptr;
   }
 
+  if (UseDex && dex::MappedDex::isMappedIndex(Buffer->get()->getBuffer())) {
+    auto Index = dex::MappedDex::create(std::move(*Buffer));
+    if (!Index) {
+      llvm::errs() << "Bad Index: " << llvm::toString(Index.takeError())
+                   << "\n";
+      return nullptr;
+    }
+    vlog("Loaded mapped Dex from {0} with estimated memory usage {1} bytes",
+         SymbolFilename, (*Index)->estimateMemoryUsage());
+    return std::move(*Index);
+  }
+
   SymbolSlab Symbols;
   RefSlab Refs;
   RelationSlab Relations;
@@ -36,6 +36,7 @@ namespace clangd {
 enum class IndexFileFormat {
   RIFF, // Versioned binary format, suitable for production use.
   YAML, // Human-readable format, suitable for experiments and debugging.
+  Mapped, // Dex index queried in place from a mapped file, for large indexes.
 };
 
 // Holds the contents of an index file that was read.
@@ -48,7 +49,7 @@ struct IndexFileIn {
   // This contains only the Directory and CommandLine.
   llvm::Optional<tooling::CompileCommand> Cmd;
 };
-// Parse an index file. The input must be a RIFF or YAML file.
+// Parse an index file. The input must be a RIFF, YAML or mapped file.
 llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef);
 
 // Specifies the contents of an index file to be written.
@@ -58,7 +59,8 @@ struct IndexFileOut {
   const RelationSlab *Relations = nullptr;
   // Keys are URIs of the source files.
   const IncludeGraph *Sources = nullptr;
-  // TODO: Support serializing Dex posting lists.
+  // Only the Mapped format stores Dex posting lists, and it ignores Sources
+  // and Cmd.
   IndexFileFormat Format = IndexFileFormat::RIFF;
   const tooling::CompileCommand *Cmd = nullptr;
 
@@ -80,6 +82,8 @@ std::string toYAML(const Relation &);
 
 // Build an in-memory static index from an index file.
 // The size should be relatively small, so data can be managed in memory.
+// A mapped index file is instead memory-mapped and queried in place, if UseDex
+// is true.
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef Filename,
                                        bool UseDex = true);
 
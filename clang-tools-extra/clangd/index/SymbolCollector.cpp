@@ -203,6 +203,7 @@ SymbolCollector::SymbolCollector(Options Opts) : Opts(std::move(Opts)) {}
 
 void SymbolCollector::initialize(ASTContext &Ctx) {
   ASTCtx = &Ctx;
+  USRs.clear();
   CompletionAllocator = std::make_shared<GlobalCodeCompletionAllocator>();
   CompletionTUInfo =
       llvm::make_unique<CodeCompletionTUInfo>(CompletionAllocator);
@@ -295,7 +296,7 @@ bool SymbolCollector::handleDeclOccurence(
       SM.getFileID(SpellingLoc) == SM.getMainFileID())
     ReferencedDecls.insert(ND);
 
-  auto ID = getSymbolID(ND);
+  auto ID = getSymbolID(ND, USRs);
   if (!ID)
     return true;
 
@@ -442,7 +443,7 @@ void SymbolCollector::processRelations(
 
     const Decl *Object = R.RelatedSymbol;
 
-    auto ObjectID = getSymbolID(Object);
+    auto ObjectID = getSymbolID(Object, USRs);
     if (!ObjectID)
       continue;
 
@@ -479,7 +480,7 @@ void SymbolCollector::finish() {
     }
   };
   for (const NamedDecl *ND : ReferencedDecls) {
-    if (auto ID = getSymbolID(ND)) {
+    if (auto ID = getSymbolID(ND, USRs)) {
       IncRef(*ID);
     }
   }
@@ -535,7 +536,7 @@ void SymbolCollector::finish() {
   // Populate Refs slab from DeclRefs.
   if (auto MainFileURI = GetURI(SM.getMainFileID())) {
     for (const auto &It : DeclRefs) {
-      if (auto ID = getSymbolID(It.first)) {
+      if (auto ID = getSymbolID(It.first, USRs)) {
         for (const auto &LocAndRole : It.second) {
           auto FileID = SM.getFileID(LocAndRole.first);
           // FIXME: use the result to filter out references.
@@ -39,6 +39,66 @@ namespace {
 const Token RestrictedForCodeCompletion =
     Token(Token::Kind::Sentinel, "Restricted For Code Completion");
 
+using IteratorFactory =
+    llvm::function_ref<std::unique_ptr<Iterator>(const Token &)>;
+
+// Constructs BOOST iterators for Path Proximities.
+std::unique_ptr<Iterator>
+createFileProximityIterator(llvm::ArrayRef<std::string> ProximityPaths,
+                            const Corpus &Corpus,
+                            IteratorFactory GetIterator) {
+  std::vector<std::unique_ptr<Iterator>> BoostingIterators;
+  // Deduplicate parent URIs extracted from the ProximityPaths.
+  llvm::StringSet<> ParentURIs;
+  llvm::StringMap<SourceParams> Sources;
+  for (const auto &Path : ProximityPaths) {
+    Sources[Path] = SourceParams();
+    auto PathURI = URI::create(Path);
+    const auto PathProximityURIs = generateProximityURIs(PathURI.toString());
+    for (const auto &ProximityURI : PathProximityURIs)
+      ParentURIs.insert(ProximityURI);
+  }
+  // Use SymbolRelevanceSignals for symbol relevance evaluation: use defaults
+  // for all parameters except for Proximity Path distance signal.
+  SymbolRelevanceSignals PathProximitySignals;
+  // DistanceCalculator will find the shortest distance from ProximityPaths to
+  // any URI extracted from the ProximityPaths.
+  URIDistance DistanceCalculator(Sources);
+  PathProximitySignals.FileProximityMatch = &DistanceCalculator;
+  // Try to build BOOST iterator for each Proximity Path provided by
+  // ProximityPaths. Boosting factor should depend on the distance to the
+  // Proximity Path: the closer processed path is, the higher boosting factor.
+  for (const auto &ParentURI : ParentURIs.keys()) {
+    // FIXME(kbobyrev): Append LIMIT on top of every BOOST iterator.
+    auto It = GetIterator(Token(Token::Kind::ProximityURI, ParentURI));
+    if (It->kind() != Iterator::Kind::False) {
+      PathProximitySignals.SymbolURI = ParentURI;
+      BoostingIterators.push_back(
+          Corpus.boost(std::move(It), PathProximitySignals.evaluate()));
+    }
+  }
+  BoostingIterators.push_back(Corpus.all());
+  return Corpus.unionOf(std::move(BoostingIterators));
+}
+
+// Constructs BOOST iterators for preferred types.
+std::unique_ptr<Iterator>
+createTypeBoostingIterator(llvm::ArrayRef<std::string> Types,
+                           const Corpus &Corpus,
+                           IteratorFactory GetIterator) {
+  std::vector<std::unique_ptr<Iterator>> BoostingIterators;
+  SymbolRelevanceSignals PreferredTypeSignals;
+  PreferredTypeSignals.TypeMatchesPreferred = true;
+  auto Boost = PreferredTypeSignals.evaluate();
+  for (const auto &T : Types)
+    BoostingIterators.push_back(
+        Corpus.boost(GetIterator(Token(Token::Kind::Type, T)), Boost));
+  BoostingIterators.push_back(Corpus.all());
+  return Corpus.unionOf(std::move(BoostingIterators));
+}
+
+} // namespace
+
 // Returns the tokens which are given symbol's characteristics. Currently, the
 // generated tokens only contain fuzzy matching trigrams and symbol's scope,
 // but in the future this will also return path proximity tokens and other
@@ -62,8 +122,6 @@ std::vector<Token> generateSearchTokens(const Symbol &Sym) {
   return Result;
 }
 
-} // namespace
-
 void Dex::buildIndex() {
   this->Corpus = dex::Corpus(Symbols.size());
   std::vector<std::pair<float, const Symbol *>> ScoredSymbols(Symbols.size());
@@ -106,62 +164,23 @@ std::unique_ptr<Iterator> Dex::iterator(const Token &Tok) const {
                                    : It->second.iterator(&It->first);
 }
 
-// Constructs BOOST iterators for Path Proximities.
-std::unique_ptr<Iterator> Dex::createFileProximityIterator(
-    llvm::ArrayRef<std::string> ProximityPaths) const {
-  std::vector<std::unique_ptr<Iterator>> BoostingIterators;
-  // Deduplicate parent URIs extracted from the ProximityPaths.
-  llvm::StringSet<> ParentURIs;
-  llvm::StringMap<SourceParams> Sources;
-  for (const auto &Path : ProximityPaths) {
-    Sources[Path] = SourceParams();
-    auto PathURI = URI::create(Path);
-    const auto PathProximityURIs = generateProximityURIs(PathURI.toString());
-    for (const auto &ProximityURI : PathProximityURIs)
-      ParentURIs.insert(ProximityURI);
-  }
-  // Use SymbolRelevanceSignals for symbol relevance evaluation: use defaults
-  // for all parameters except for Proximity Path distance signal.
-  SymbolRelevanceSignals PathProximitySignals;
-  // DistanceCalculator will find the shortest distance from ProximityPaths to
-  // any URI extracted from the ProximityPaths.
-  URIDistance DistanceCalculator(Sources);
-  PathProximitySignals.FileProximityMatch = &DistanceCalculator;
-  // Try to build BOOST iterator for each Proximity Path provided by
-  // ProximityPaths. Boosting factor should depend on the distance to the
-  // Proximity Path: the closer processed path is, the higher boosting factor.
-  for (const auto &ParentURI : ParentURIs.keys()) {
-    // FIXME(kbobyrev): Append LIMIT on top of every BOOST iterator.
-    auto It = iterator(Token(Token::Kind::ProximityURI, ParentURI));
-    if (It->kind() != Iterator::Kind::False) {
-      PathProximitySignals.SymbolURI = ParentURI;
-      BoostingIterators.push_back(
-          Corpus.boost(std::move(It), PathProximitySignals.evaluate()));
-    }
-  }
-  BoostingIterators.push_back(Corpus.all());
-  return Corpus.unionOf(std::move(BoostingIterators));
-}
-
-// Constructs BOOST iterators for preferred types.
-std::unique_ptr<Iterator>
-Dex::createTypeBoostingIterator(llvm::ArrayRef<std::string> Types) const {
-  std::vector<std::unique_ptr<Iterator>> BoostingIterators;
-  SymbolRelevanceSignals PreferredTypeSignals;
-  PreferredTypeSignals.TypeMatchesPreferred = true;
-  auto Boost = PreferredTypeSignals.evaluate();
-  for (const auto &T : Types)
-    BoostingIterators.push_back(
-        Corpus.boost(iterator(Token(Token::Kind::Type, T)), Boost));
-  BoostingIterators.push_back(Corpus.all());
-  return Corpus.unionOf(std::move(BoostingIterators));
+bool Dex::fuzzyFind(const FuzzyFindRequest &Req,
+                    llvm::function_ref<void(const Symbol &)> Callback) const {
+  return fuzzyFindDocs(
+      Req, Corpus, [&](const Token &Tok) { return iterator(Tok); },
+      [&](DocID Doc) { return llvm::StringRef(Symbols[Doc]->Name); },
+      [&](DocID Doc) { return SymbolQuality[Doc]; },
+      [&](DocID Doc) { Callback(*Symbols[Doc]); });
 }
 
 /// Constructs iterators over tokens extracted from the query and exhausts it
 /// while applying Callback to each symbol in the order of decreasing quality
 /// of the matched symbols.
-bool Dex::fuzzyFind(const FuzzyFindRequest &Req,
-                    llvm::function_ref<void(const Symbol &)> Callback) const {
+bool fuzzyFindDocs(const FuzzyFindRequest &Req, const Corpus &Corpus,
+                   IteratorFactory GetIterator,
+                   llvm::function_ref<llvm::StringRef(DocID)> Name,
+                   llvm::function_ref<float(DocID)> Quality,
+                   llvm::function_ref<void(DocID)> Callback) {
   assert(!StringRef(Req.Query).contains("::") &&
          "There must be no :: in query.");
   trace::Span Tracer("Dex fuzzyFind");
@@ -177,25 +196,27 @@ bool Dex::fuzzyFind(const FuzzyFindRequest &Req,
   // trigrams.
   std::vector<std::unique_ptr<Iterator>> TrigramIterators;
   for (const auto &Trigram : TrigramTokens)
-    TrigramIterators.push_back(iterator(Trigram));
+    TrigramIterators.push_back(GetIterator(Trigram));
   Criteria.push_back(Corpus.intersect(move(TrigramIterators)));
 
   // Generate scope tokens for search query.
   std::vector<std::unique_ptr<Iterator>> ScopeIterators;
   for (const auto &Scope : Req.Scopes)
-    ScopeIterators.push_back(iterator(Token(Token::Kind::Scope, Scope)));
+    ScopeIterators.push_back(GetIterator(Token(Token::Kind::Scope, Scope)));
   if (Req.AnyScope)
     ScopeIterators.push_back(
         Corpus.boost(Corpus.all(), ScopeIterators.empty() ? 1.0 : 0.2));
   Criteria.push_back(Corpus.unionOf(move(ScopeIterators)));
 
   // Add proximity paths boosting (all symbols, some boosted).
-  Criteria.push_back(createFileProximityIterator(Req.ProximityPaths));
+  Criteria.push_back(
+      createFileProximityIterator(Req.ProximityPaths, Corpus, GetIterator));
   // Add boosting for preferred types.
-  Criteria.push_back(createTypeBoostingIterator(Req.PreferredTypes));
+  Criteria.push_back(
+      createTypeBoostingIterator(Req.PreferredTypes, Corpus, GetIterator));
 
   if (Req.RestrictForCodeCompletion)
-    Criteria.push_back(iterator(RestrictedForCodeCompletion));
+    Criteria.push_back(GetIterator(RestrictedForCodeCompletion));
 
   // Use TRUE iterator if both trigrams and scopes from the query are not
   // present in the symbol index.
@@ -218,14 +239,13 @@ bool Dex::fuzzyFind(const FuzzyFindRequest &Req,
       Req.Limit ? *Req.Limit : std::numeric_limits<size_t>::max(), Compare);
   for (const auto &IDAndScore : IDAndScores) {
     const DocID SymbolDocID = IDAndScore.first;
-    const auto *Sym = Symbols[SymbolDocID];
-    const llvm::Optional<float> Score = Filter.match(Sym->Name);
+    const llvm::Optional<float> Score = Filter.match(Name(SymbolDocID));
     if (!Score)
       continue;
     // Combine Fuzzy Matching score, precomputed symbol quality and boosting
     // score for a cumulative final symbol score.
     const float FinalScore =
-        (*Score) * SymbolQuality[SymbolDocID] * IDAndScore.second;
+        (*Score) * Quality(SymbolDocID) * IDAndScore.second;
     // If Top.push(...) returns true, it means that it had to pop an item. In
     // this case, it is possible to retrieve more symbols.
     if (Top.push({SymbolDocID, FinalScore}))
@@ -235,7 +255,7 @@ bool Dex::fuzzyFind(const FuzzyFindRequest &Req,
   // Apply callback to the top Req.Limit items in the descending
   // order of cumulative score.
   for (const auto &Item : std::move(Top).items())
-    Callback(*Symbols[Item.first]);
+    Callback(Item.first);
   return More;
 }
 
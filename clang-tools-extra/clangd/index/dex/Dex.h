@@ -33,11 +33,8 @@ namespace clangd {
 namespace dex {
 
 /// In-memory Dex trigram-based index implementation.
-// FIXME(kbobyrev): Introduce serialization and deserialization of the symbol
-// index so that it can be loaded from the disk. Since static index is not
-// changed frequently, it's safe to assume that it has to be built only once
-// (when the clangd process starts). Therefore, it can be easier to store built
-// index on disk and then load it if available.
+// MappedDex is the equivalent index for a static index built ahead of time: it
+// is queried from the disk without being built when clangd starts.
 class Dex : public SymbolIndex {
 public:
   // All data must outlive this index.
@@ -87,10 +84,6 @@ public:
 private:
   void buildIndex();
   std::unique_ptr<Iterator> iterator(const Token &Tok) const;
-  std::unique_ptr<Iterator>
-  createFileProximityIterator(llvm::ArrayRef<std::string> ProximityPaths) const;
-  std::unique_ptr<Iterator>
-  createTypeBoostingIterator(llvm::ArrayRef<std::string> Types) const;
 
   /// Stores symbols sorted in the descending order of symbol quality..
   std::vector<const Symbol *> Symbols;
@@ -113,6 +106,24 @@ private:
   size_t BackingDataSize = 0;
 };
 
+/// Returns the search tokens of a symbol: the keys of the posting lists which
+/// contain it.
+std::vector<Token> generateSearchTokens(const Symbol &Sym);
+
+/// Runs the Dex query for \p Req over the documents of \p Corpus, sorted by
+/// descending quality. \p GetIterator returns the posting list of a token,
+/// \p Name and \p Quality describe a document. \p Callback is called for the
+/// best matches, in the order of decreasing score. Returns true if there may be
+/// more results than were returned.
+///
+/// This is shared by the Dex implementations so that they rank identically.
+bool fuzzyFindDocs(
+    const FuzzyFindRequest &Req, const Corpus &Corpus,
+    llvm::function_ref<std::unique_ptr<Iterator>(const Token &)> Iterator,
+    llvm::function_ref<llvm::StringRef(DocID)> Name,
+    llvm::function_ref<float(DocID)> Quality,
+    llvm::function_ref<void(DocID)> Callback);
+
 /// Returns Search Token for a number of parent directories of given Path.
 /// Should be used within the index build process.
 ///
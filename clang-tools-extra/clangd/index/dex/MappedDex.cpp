@@ -0,0 +1,624 @@
+//===--- MappedDex.cpp - Dex index queried from a mapped file ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "MappedDex.h"
+#include "Dex.h"
+#include "Trace.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+
+namespace clang {
+namespace clangd {
+namespace dex {
+namespace {
+
+llvm::Error makeError(const llvm::Twine &Msg) {
+  return llvm::make_error<llvm::StringError>(Msg,
+                                             llvm::inconvertibleErrorCode());
+}
+
+constexpr static char Magic[] = {'C', 'd', 'M', 'x'};
+constexpr static uint32_t Version = 1;
+
+enum Section {
+  StringsSection,
+  SymbolsSection,
+  LookupSection,
+  HeadersSection,
+  TokensSection,
+  PostingsSection,
+  RefIndexSection,
+  RefsSection,
+  RelationsSection,
+  NumSections,
+};
+
+// Magic, version and number of sections, then offset and size of each section.
+constexpr static size_t HeaderSize = 12 + 8 * NumSections;
+
+// Word offsets of the fields of a symbol record.
+enum SymbolField {
+  SymbolIDField = 0,   // SymbolID::RawSize bytes.
+  SymbolInfoField = 2, // Kind, language, flags and origin bytes.
+  NameField,
+  ScopeField,
+  TemplateArgsField,
+  SignatureField,
+  SnippetField,
+  DocumentationField,
+  ReturnTypeField,
+  TypeField,
+  DefinitionField, // FileURI, start and end.
+  DeclarationField = DefinitionField + 3,
+  ReferencesField = DeclarationField + 3,
+  HeadersBeginField,
+  HeadersCountField,
+  QualityField,
+  SymbolWords,
+};
+
+constexpr static size_t LookupRecordSize = SymbolID::RawSize + 4;
+constexpr static size_t HeaderRecordSize = 8;
+constexpr static size_t TokenRecordSize = 16;
+constexpr static size_t RefIndexRecordSize = SymbolID::RawSize + 8;
+constexpr static size_t RefRecordSize = 16;
+constexpr static size_t RelationRecordSize = 2 * SymbolID::RawSize + 4;
+
+// Sizes of the records of each section.
+constexpr static size_t RecordSizes[NumSections] = {
+    1,
+    4 * SymbolWords,
+    LookupRecordSize,
+    HeaderRecordSize,
+    TokenRecordSize,
+    4,
+    RefIndexRecordSize,
+    RefRecordSize,
+    RelationRecordSize,
+};
+
+uint32_t word(const char *Record, unsigned Index) {
+  return llvm::support::endian::read32le(Record + 4 * Index);
+}
+
+void write32(uint32_t I, llvm::raw_ostream &OS) {
+  char Buf[4];
+  llvm::support::endian::write32le(Buf, I);
+  OS.write(Buf, sizeof(Buf));
+}
+
+SymbolID readID(const char *Record) {
+  return SymbolID::fromRaw(llvm::StringRef(Record, SymbolID::RawSize));
+}
+
+// Positions are packed like in SymbolLocation.
+uint32_t packPosition(const SymbolLocation::Position &P) {
+  return P.line() << 12 | P.column();
+}
+
+SymbolLocation::Position unpackPosition(uint32_t Packed) {
+  SymbolLocation::Position P;
+  P.setLine(Packed >> 12);
+  P.setColumn(Packed & SymbolLocation::Position::MaxColumn);
+  return P;
+}
+
+// Returns the index of the first of the fixed-size Records whose key, a prefix
+// of the record, is not less than Key.
+size_t lowerBound(llvm::StringRef Records, size_t RecordSize,
+                  llvm::StringRef Key) {
+  size_t Lo = 0, Hi = Records.size() / RecordSize;
+  while (Lo < Hi) {
+    size_t Mid = Lo + (Hi - Lo) / 2;
+    if (Records.substr(Mid * RecordSize, Key.size()) < Key)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  return Lo;
+}
+
+// Iterates over a posting list in the mapped file.
+class MappedPostingIterator : public Iterator {
+public:
+  MappedPostingIterator(const char *IDs, size_t Size, const Token &Tok)
+      : IDs(IDs), Size(Size), Tok(Tok) {}
+
+  bool reachedEnd() const override { return Index == Size; }
+
+  void advance() override {
+    assert(!reachedEnd() && "Posting iterator can't advance() at the end.");
+    ++Index;
+  }
+
+  void advanceTo(DocID ID) override {
+    assert(!reachedEnd() && "Posting iterator can't advance() at the end.");
+    if (at(Index) >= ID)
+      return;
+    // Targets are usually close, so gallop to a bound before bisecting.
+    // Invariant: at(Lo) < ID, and Hi == Size or at(Hi) >= ID.
+    size_t Lo = Index, Hi = Index + 1, Step = 1;
+    while (Hi < Size && at(Hi) < ID) {
+      Lo = Hi;
+      Step *= 2;
+      Hi = Lo + Step;
+    }
+    Hi = std::min(Hi, Size);
+    while (Lo + 1 < Hi) {
+      size_t Mid = Lo + (Hi - Lo) / 2;
+      if (at(Mid) < ID)
+        Lo = Mid;
+      else
+        Hi = Mid;
+    }
+    Index = Hi;
+  }
+
+  DocID peek() const override {
+    assert(!reachedEnd() && "Posting iterator can't peek() at the end.");
+    return at(Index);
+  }
+
+  float consume() override {
+    assert(!reachedEnd() && "Posting iterator can't consume() at the end.");
+    return 1;
+  }
+
+  size_t estimateSize() const override { return Size; }
+
+private:
+  llvm::raw_ostream &dump(llvm::raw_ostream &OS) const override {
+    return OS << Tok;
+  }
+
+  DocID at(size_t I) const {
+    return llvm::support::endian::read32le(IDs + 4 * I);
+  }
+
+  const char *IDs;
+  size_t Size;
+  size_t Index = 0;
+  Token Tok;
+};
+
+// Strings are stored once and referred to by offset.
+class StringTableOut {
+public:
+  // Offset 0 is the empty string.
+  StringTableOut() : Data(1, '\0') {}
+
+  uint32_t index(llvm::StringRef S) {
+    if (S.empty())
+      return 0;
+    auto R = Offsets.try_emplace(S, Data.size());
+    if (R.second) {
+      Data.append(S.begin(), S.end());
+      Data.push_back('\0');
+    }
+    return R.first->second;
+  }
+
+  std::string &data() { return Data; }
+
+private:
+  std::string Data;
+  llvm::StringMap<uint32_t> Offsets;
+};
+
+void writeLocation(const SymbolLocation &Loc, StringTableOut &Strings,
+                   llvm::raw_ostream &OS) {
+  write32(Strings.index(Loc.FileURI), OS);
+  write32(packPosition(Loc.Start), OS);
+  write32(packPosition(Loc.End), OS);
+}
+
+} // namespace
+
+bool MappedDex::isMappedIndex(llvm::StringRef Data) {
+  return Data.startswith(llvm::StringRef(Magic, sizeof(Magic)));
+}
+
+llvm::Expected<std::unique_ptr<MappedDex>>
+MappedDex::create(llvm::StringRef Data) {
+  if (!isMappedIndex(Data) || Data.size() < HeaderSize)
+    return makeError("Not a mapped index file");
+  if (word(Data.data(), 1) != Version)
+    return makeError("Wrong mapped index version");
+  if (word(Data.data(), 2) != NumSections)
+    return makeError("Wrong number of mapped index sections");
+  llvm::StringRef Sections[NumSections];
+  for (unsigned S = 0; S < NumSections; ++S) {
+    uint32_t Offset = word(Data.data(), 3 + 2 * S);
+    uint32_t Size = word(Data.data(), 4 + 2 * S);
+    if (Offset % 4 || Offset > Data.size() || Size > Data.size() - Offset ||
+        Size % RecordSizes[S])
+      return makeError("Malformed mapped index section");
+    Sections[S] = Data.substr(Offset, Size);
+  }
+  // string() relies on the strings being NUL-terminated.
+  if (!Sections[StringsSection].endswith(llvm::StringRef("\0", 1)))
+    return makeError("Malformed mapped index string table");
+  return std::unique_ptr<MappedDex>(new MappedDex(Sections));
+}
+
+llvm::Expected<std::unique_ptr<MappedDex>>
+MappedDex::create(std::unique_ptr<llvm::MemoryBuffer> Buffer) {
+  auto Index = create(Buffer->getBuffer());
+  if (Index)
+    (*Index)->Buffer = std::move(Buffer);
+  return Index;
+}
+
+MappedDex::MappedDex(llvm::ArrayRef<llvm::StringRef> Sections)
+    : Strings(Sections[StringsSection]), Symbols(Sections[SymbolsSection]),
+      Lookup(Sections[LookupSection]), Headers(Sections[HeadersSection]),
+      Tokens(Sections[TokensSection]), Postings(Sections[PostingsSection]),
+      RefIndex(Sections[RefIndexSection]), Refs(Sections[RefsSection]),
+      Relations(Sections[RelationsSection]),
+      NumSymbols(Symbols.size() / RecordSizes[SymbolsSection]),
+      Corpus(NumSymbols) {}
+
+llvm::StringRef MappedDex::string(uint32_t Offset) const {
+  if (Offset >= Strings.size())
+    return "";
+  return Strings.data() + Offset;
+}
+
+const char *MappedDex::symbolRecord(DocID Doc) const {
+  return Doc < NumSymbols ? Symbols.data() + Doc * RecordSizes[SymbolsSection]
+                          : nullptr;
+}
+
+SymbolLocation MappedDex::location(const char *Record) const {
+  SymbolLocation Loc;
+  Loc.FileURI = string(word(Record, 0)).data();
+  Loc.Start = unpackPosition(word(Record, 1));
+  Loc.End = unpackPosition(word(Record, 2));
+  return Loc;
+}
+
+// The strings of the symbol point into the mapped file.
+Symbol MappedDex::symbol(const char *R) const {
+  Symbol Sym;
+  Sym.ID = readID(R);
+  const char *Info = R + 4 * SymbolInfoField;
+  Sym.SymInfo.Kind = static_cast<index::SymbolKind>(Info[0]);
+  Sym.SymInfo.Lang = static_cast<index::SymbolLanguage>(Info[1]);
+  Sym.Flags = static_cast<Symbol::SymbolFlag>(Info[2]);
+  Sym.Origin = static_cast<SymbolOrigin>(Info[3]);
+  Sym.Name = string(word(R, NameField));
+  Sym.Scope = string(word(R, ScopeField));
+  Sym.TemplateSpecializationArgs = string(word(R, TemplateArgsField));
+  Sym.Signature = string(word(R, SignatureField));
+  Sym.CompletionSnippetSuffix = string(word(R, SnippetField));
+  Sym.Documentation = string(word(R, DocumentationField));
+  Sym.ReturnType = string(word(R, ReturnTypeField));
+  Sym.Type = string(word(R, TypeField));
+  Sym.Definition = location(R + 4 * DefinitionField);
+  Sym.CanonicalDeclaration = location(R + 4 * DeclarationField);
+  Sym.References = word(R, ReferencesField);
+  size_t NumHeaders = Headers.size() / HeaderRecordSize;
+  size_t Begin = std::min<size_t>(word(R, HeadersBeginField), NumHeaders);
+  size_t End =
+      std::min<size_t>(Begin + word(R, HeadersCountField), NumHeaders);
+  for (size_t I = Begin; I < End; ++I) {
+    const char *Header = Headers.data() + I * HeaderRecordSize;
+    Sym.IncludeHeaders.emplace_back(string(word(Header, 0)), word(Header, 1));
+  }
+  return Sym;
+}
+
+llvm::StringRef MappedDex::name(DocID Doc) const {
+  const char *R = symbolRecord(Doc);
+  return R ? string(word(R, NameField)) : "";
+}
+
+float MappedDex::quality(DocID Doc) const {
+  const char *R = symbolRecord(Doc);
+  return R ? llvm::BitsToFloat(word(R, QualityField)) : 0;
+}
+
+std::unique_ptr<Iterator> MappedDex::iterator(const Token &Tok) const {
+  auto Key = std::make_pair(static_cast<uint32_t>(Tok.kind()), Tok.data());
+  auto KeyOf = [&](size_t I) {
+    const char *R = Tokens.data() + I * TokenRecordSize;
+    return std::make_pair(word(R, 0), string(word(R, 1)));
+  };
+  size_t NumTokens = Tokens.size() / TokenRecordSize;
+  size_t Lo = 0, Hi = NumTokens;
+  while (Lo < Hi) {
+    size_t Mid = Lo + (Hi - Lo) / 2;
+    if (KeyOf(Mid) < Key)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  if (Lo == NumTokens || KeyOf(Lo) != Key)
+    return Corpus.none();
+  const char *R = Tokens.data() + Lo * TokenRecordSize;
+  size_t Begin = word(R, 2), Size = word(R, 3);
+  size_t NumPostings = Postings.size() / 4;
+  if (Begin > NumPostings || Size > NumPostings - Begin)
+    return Corpus.none();
+  return llvm::make_unique<MappedPostingIterator>(Postings.data() + 4 * Begin,
+                                                  Size, Tok);
+}
+
+DocID MappedDex::find(const SymbolID &ID) const {
+  size_t I = lowerBound(Lookup, LookupRecordSize, ID.raw());
+  if (I == Lookup.size() / LookupRecordSize)
+    return NumSymbols;
+  const char *R = Lookup.data() + I * LookupRecordSize;
+  if (readID(R) != ID)
+    return NumSymbols;
+  return word(R + SymbolID::RawSize, 0);
+}
+
+Ref MappedDex::ref(const char *Record) const {
+  Ref R;
+  R.Location = location(Record);
+  R.Kind = static_cast<RefKind>(word(Record, 3));
+  return R;
+}
+
+llvm::ArrayRef<char> MappedDex::refsOf(size_t IndexRecord) const {
+  const char *R = RefIndex.data() + IndexRecord * RefIndexRecordSize;
+  size_t NumRefs = Refs.size() / RefRecordSize;
+  size_t Begin = std::min<size_t>(word(R + SymbolID::RawSize, 0), NumRefs);
+  size_t End =
+      std::min<size_t>(Begin + word(R + SymbolID::RawSize, 1), NumRefs);
+  return llvm::makeArrayRef(Refs.data() + Begin * RefRecordSize,
+                            (End - Begin) * RefRecordSize);
+}
+
+bool MappedDex::fuzzyFind(
+    const FuzzyFindRequest &Req,
+    llvm::function_ref<void(const Symbol &)> Callback) const {
+  return fuzzyFindDocs(
+      Req, Corpus, [&](const Token &Tok) { return iterator(Tok); },
+      [&](DocID Doc) { return name(Doc); },
+      [&](DocID Doc) { return quality(Doc); },
+      [&](DocID Doc) {
+        if (const char *R = symbolRecord(Doc))
+          Callback(symbol(R));
+      });
+}
+
+void MappedDex::lookup(
+    const LookupRequest &Req,
+    llvm::function_ref<void(const Symbol &)> Callback) const {
+  trace::Span Tracer("MappedDex lookup");
+  for (const auto &ID : Req.IDs)
+    if (const char *R = symbolRecord(find(ID)))
+      Callback(symbol(R));
+}
+
+void MappedDex::refs(const RefsRequest &Req,
+                     llvm::function_ref<void(const Ref &)> Callback) const {
+  trace::Span Tracer("MappedDex refs");
+  uint32_t Remaining =
+      Req.Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+  for (const auto &ID : Req.IDs) {
+    size_t I = lowerBound(RefIndex, RefIndexRecordSize, ID.raw());
+    if (I == RefIndex.size() / RefIndexRecordSize ||
+        readID(RefIndex.data() + I * RefIndexRecordSize) != ID)
+      continue;
+    llvm::ArrayRef<char> Records = refsOf(I);
+    for (size_t J = 0; J < Records.size(); J += RefRecordSize) {
+      Ref R = ref(Records.data() + J);
+      if (Remaining > 0 && static_cast<int>(Req.Filter & R.Kind)) {
+        --Remaining;
+        Callback(R);
+      }
+    }
+  }
+}
+
+void MappedDex::relations(
+    const RelationsRequest &Req,
+    llvm::function_ref<void(const SymbolID &, const Symbol &)> Callback) const {
+  trace::Span Tracer("MappedDex relations");
+  uint32_t Remaining =
+      Req.Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+  uint32_t Predicate =
+      static_cast<uint32_t>(symbolRoleToRelationKind(Req.Predicate));
+  size_t NumRelations = Relations.size() / RelationRecordSize;
+  for (const SymbolID &Subject : Req.Subjects) {
+    LookupRequest LookupReq;
+    for (size_t I = lowerBound(Relations, RelationRecordSize, Subject.raw());
+         I < NumRelations; ++I) {
+      const char *R = Relations.data() + I * RelationRecordSize;
+      if (readID(R) != Subject)
+        break;
+      if (word(R + 2 * SymbolID::RawSize, 0) == Predicate && Remaining > 0) {
+        --Remaining;
+        LookupReq.IDs.insert(readID(R + SymbolID::RawSize));
+      }
+    }
+    lookup(LookupReq, [&](const Symbol &Object) { Callback(Subject, Object); });
+  }
+}
+
+size_t MappedDex::estimateMemoryUsage() const {
+  size_t Bytes = sizeof(*this);
+  if (Buffer &&
+      Buffer->getBufferKind() == llvm::MemoryBuffer::MemoryBuffer_Malloc)
+    Bytes += Buffer->getBufferSize();
+  return Bytes;
+}
+
+IndexFileIn MappedDex::decode() const {
+  SymbolSlab::Builder SymbolsBuilder;
+  for (DocID Doc = 0; Doc < NumSymbols; ++Doc)
+    SymbolsBuilder.insert(symbol(symbolRecord(Doc)));
+  RefSlab::Builder RefsBuilder;
+  for (size_t I = 0; I < RefIndex.size() / RefIndexRecordSize; ++I) {
+    SymbolID ID = readID(RefIndex.data() + I * RefIndexRecordSize);
+    llvm::ArrayRef<char> Records = refsOf(I);
+    for (size_t J = 0; J < Records.size(); J += RefRecordSize)
+      RefsBuilder.insert(ID, ref(Records.data() + J));
+  }
+  RelationSlab::Builder RelationsBuilder;
+  for (size_t I = 0; I < Relations.size() / RelationRecordSize; ++I) {
+    const char *R = Relations.data() + I * RelationRecordSize;
+    RelationsBuilder.insert(
+        {readID(R),
+         relationKindToSymbolRole(
+             static_cast<RelationKind>(word(R + 2 * SymbolID::RawSize, 0))),
+         readID(R + SymbolID::RawSize)});
+  }
+  IndexFileIn Result;
+  Result.Symbols = std::move(SymbolsBuilder).build();
+  Result.Refs = std::move(RefsBuilder).build();
+  Result.Relations = std::move(RelationsBuilder).build();
+  return Result;
+}
+
+void writeMappedDex(const SymbolSlab *Symbols, const RefSlab *Refs,
+                    const RelationSlab *Relations, llvm::raw_ostream &OS) {
+  StringTableOut Strings;
+  std::string Sections[NumSections];
+
+  // Symbols are ranked by quality like in Dex, so DocIDs are the same.
+  std::vector<std::pair<float, const Symbol *>> Ranked;
+  if (Symbols)
+    for (const Symbol &Sym : *Symbols)
+      Ranked.emplace_back(quality(Sym), &Sym);
+  llvm::sort(Ranked, [](const std::pair<float, const Symbol *> &L,
+                        const std::pair<float, const Symbol *> &R) {
+    if (L.first != R.first)
+      return L.first > R.first;
+    return L.second->ID < R.second->ID;
+  });
+
+  std::vector<std::pair<SymbolID, DocID>> IDs;
+  llvm::DenseMap<Token, std::vector<DocID>> InvertedIndex;
+  {
+    llvm::raw_string_ostream SymbolsOS(Sections[SymbolsSection]);
+    llvm::raw_string_ostream HeadersOS(Sections[HeadersSection]);
+    uint32_t NumHeaders = 0;
+    for (DocID Doc = 0; Doc < Ranked.size(); ++Doc) {
+      const Symbol &Sym = *Ranked[Doc].second;
+      IDs.emplace_back(Sym.ID, Doc);
+      for (const auto &Tok : generateSearchTokens(Sym))
+        InvertedIndex[Tok].push_back(Doc);
+
+      SymbolsOS << Sym.ID.raw();
+      SymbolsOS.write(static_cast<uint8_t>(Sym.SymInfo.Kind));
+      SymbolsOS.write(static_cast<uint8_t>(Sym.SymInfo.Lang));
+      SymbolsOS.write(static_cast<uint8_t>(Sym.Flags));
+      SymbolsOS.write(static_cast<uint8_t>(Sym.Origin));
+      for (llvm::StringRef S :
+           {Sym.Name, Sym.Scope, Sym.TemplateSpecializationArgs, Sym.Signature,
+            Sym.CompletionSnippetSuffix, Sym.Documentation, Sym.ReturnType,
+            Sym.Type})
+        write32(Strings.index(S), SymbolsOS);
+      writeLocation(Sym.Definition, Strings, SymbolsOS);
+      writeLocation(Sym.CanonicalDeclaration, Strings, SymbolsOS);
+      write32(Sym.References, SymbolsOS);
+      write32(NumHeaders, SymbolsOS);
+      write32(Sym.IncludeHeaders.size(), SymbolsOS);
+      write32(llvm::FloatToBits(Ranked[Doc].first), SymbolsOS);
+      for (const auto &Include : Sym.IncludeHeaders) {
+        write32(Strings.index(Include.IncludeHeader), HeadersOS);
+        write32(Include.References, HeadersOS);
+        ++NumHeaders;
+      }
+    }
+  }
+
+  {
+    llvm::sort(IDs);
+    llvm::raw_string_ostream LookupOS(Sections[LookupSection]);
+    for (const auto &Entry : IDs) {
+      LookupOS << Entry.first.raw();
+      write32(Entry.second, LookupOS);
+    }
+  }
+
+  {
+    // Tokens are sorted by kind and data, like MappedDex::iterator() expects.
+    using TokenKey = std::pair<uint32_t, llvm::StringRef>;
+    using TokenEntry = std::pair<TokenKey, const std::vector<DocID> *>;
+    std::vector<TokenEntry> SortedTokens;
+    for (const auto &Entry : InvertedIndex)
+      SortedTokens.push_back(
+          {{static_cast<uint32_t>(Entry.first.kind()), Entry.first.data()},
+           &Entry.second});
+    llvm::sort(SortedTokens, [](const TokenEntry &L, const TokenEntry &R) {
+      return L.first < R.first;
+    });
+    llvm::raw_string_ostream TokensOS(Sections[TokensSection]);
+    llvm::raw_string_ostream PostingsOS(Sections[PostingsSection]);
+    uint32_t NumPostings = 0;
+    for (const auto &Entry : SortedTokens) {
+      write32(Entry.first.first, TokensOS);
+      write32(Strings.index(Entry.first.second), TokensOS);
+      write32(NumPostings, TokensOS);
+      write32(Entry.second->size(), TokensOS);
+      for (DocID Doc : *Entry.second)
+        write32(Doc, PostingsOS);
+      NumPostings += Entry.second->size();
+    }
+  }
+
+  if (Refs) {
+    std::vector<RefSlab::value_type> SortedRefs(Refs->begin(), Refs->end());
+    llvm::sort(SortedRefs, [](const RefSlab::value_type &L,
+                              const RefSlab::value_type &R) {
+      return L.first < R.first;
+    });
+    llvm::raw_string_ostream RefIndexOS(Sections[RefIndexSection]);
+    llvm::raw_string_ostream RefsOS(Sections[RefsSection]);
+    uint32_t NumRefs = 0;
+    for (const auto &Entry : SortedRefs) {
+      RefIndexOS << Entry.first.raw();
+      write32(NumRefs, RefIndexOS);
+      write32(Entry.second.size(), RefIndexOS);
+      for (const Ref &R : Entry.second) {
+        writeLocation(R.Location, Strings, RefsOS);
+        write32(static_cast<uint32_t>(R.Kind), RefsOS);
+      }
+      NumRefs += Entry.second.size();
+    }
+  }
+
+  if (Relations) {
+    std::vector<Relation> SortedRelations(Relations->begin(), Relations->end());
+    llvm::sort(SortedRelations);
+    llvm::raw_string_ostream RelationsOS(Sections[RelationsSection]);
+    for (const Relation &R : SortedRelations) {
+      RelationsOS << R.Subject.raw() << R.Object.raw();
+      write32(static_cast<uint32_t>(symbolRoleToRelationKind(R.Predicate)),
+              RelationsOS);
+    }
+  }
+
+  Sections[StringsSection] = std::move(Strings.data());
+
+  OS.write(Magic, sizeof(Magic));
+  write32(Version, OS);
+  write32(NumSections, OS);
+  size_t Offset = HeaderSize;
+  for (const std::string &S : Sections) {
+    write32(Offset, OS);
+    write32(S.size(), OS);
+    Offset += llvm::alignTo(S.size(), 4);
+  }
+  for (const std::string &S : Sections) {
+    OS << S;
+    OS.write_zeros(llvm::alignTo(S.size(), 4) - S.size());
+  }
+}
+
+} // namespace dex
+} // namespace clangd
+} // namespace clang
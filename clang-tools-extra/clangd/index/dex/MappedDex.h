@@ -0,0 +1,122 @@
+//===--- MappedDex.h - Dex index queried from a mapped file -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// MappedDex is a Dex index whose symbols, refs, relations and posting lists
+/// are stored in a file that is memory-mapped and queried in place, instead of
+/// being parsed and indexed at startup. Loading it only validates the header,
+/// and the pages of the file are shared by all processes using the index.
+///
+/// The file starts with a header: the magic "CdMx", the format version, the
+/// number of sections and then the offset and size of each section. Sections
+/// are 4-byte aligned and consist of 32-bit little-endian words:
+///   - strings: NUL-terminated strings, referred to by their offset. Offset 0
+///     is the empty string.
+///   - symbols: fixed-size symbol records, in the descending order of quality.
+///     The position of a symbol is its DocID.
+///   - lookup: (SymbolID, DocID) records sorted by SymbolID.
+///   - headers: (header, references) records of the include headers.
+///   - tokens: (kind, data, first posting, posting count) records sorted by
+///     kind and data.
+///   - postings: the DocIDs of the posting lists, in increasing order.
+///   - ref index: (SymbolID, first ref, ref count) records sorted by SymbolID.
+///   - refs: fixed-size ref records.
+///   - relations: (subject, object, predicate) records in SPO order.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_DEX_MAPPEDDEX_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_DEX_MAPPEDDEX_H
+
+#include "Iterator.h"
+#include "Token.h"
+#include "index/Index.h"
+#include "index/Serialization.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace clang {
+namespace clangd {
+namespace dex {
+
+/// Dex index queried in place from a file written by writeMappedDex().
+class MappedDex : public SymbolIndex {
+public:
+  /// Returns true if \p Data starts with the magic of a mapped index.
+  static bool isMappedIndex(llvm::StringRef Data);
+
+  /// Creates an index over \p Data, which must outlive the index.
+  static llvm::Expected<std::unique_ptr<MappedDex>>
+  create(llvm::StringRef Data);
+  /// Creates an index over the contents of \p Buffer, which the index owns.
+  /// \p Buffer should be memory-mapped so that its pages can be shared.
+  static llvm::Expected<std::unique_ptr<MappedDex>>
+  create(std::unique_ptr<llvm::MemoryBuffer> Buffer);
+
+  bool
+  fuzzyFind(const FuzzyFindRequest &Req,
+            llvm::function_ref<void(const Symbol &)> Callback) const override;
+
+  void lookup(const LookupRequest &Req,
+              llvm::function_ref<void(const Symbol &)> Callback) const override;
+
+  void refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override;
+
+  void relations(const RelationsRequest &Req,
+                 llvm::function_ref<void(const SymbolID &, const Symbol &)>
+                     Callback) const override;
+
+  /// Mapped pages are shared and can be evicted by the kernel, so they are
+  /// not counted. A file that was read into memory is.
+  size_t estimateMemoryUsage() const override;
+
+  /// Decodes the whole index into slabs.
+  IndexFileIn decode() const;
+
+private:
+  explicit MappedDex(llvm::ArrayRef<llvm::StringRef> Sections);
+
+  llvm::StringRef string(uint32_t Offset) const;
+  SymbolLocation location(const char *Record) const;
+  /// Returns the record of the symbol \p Doc, or null if there is none.
+  const char *symbolRecord(DocID Doc) const;
+  Symbol symbol(const char *Record) const;
+  llvm::StringRef name(DocID Doc) const;
+  float quality(DocID Doc) const;
+  std::unique_ptr<Iterator> iterator(const Token &Tok) const;
+  /// Returns the DocID of the symbol \p ID, or the number of symbols if there
+  /// is no such symbol.
+  DocID find(const SymbolID &ID) const;
+  Ref ref(const char *Record) const;
+  /// Returns the ref records of the ref index record \p IndexRecord.
+  llvm::ArrayRef<char> refsOf(size_t IndexRecord) const;
+
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+  llvm::StringRef Strings;
+  llvm::StringRef Symbols;
+  llvm::StringRef Lookup;
+  llvm::StringRef Headers;
+  llvm::StringRef Tokens;
+  llvm::StringRef Postings;
+  llvm::StringRef RefIndex;
+  llvm::StringRef Refs;
+  llvm::StringRef Relations;
+  DocID NumSymbols;
+  dex::Corpus Corpus;
+};
+
+/// Writes the given data as a mapped index file. Any of the slabs may be null.
+void writeMappedDex(const SymbolSlab *Symbols, const RefSlab *Refs,
+                    const RelationSlab *Relations, llvm::raw_ostream &OS);
+
+} // namespace dex
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_DEX_MAPPEDDEX_H
@@ -12,52 +12,69 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <array>
 
 namespace clang {
 namespace clangd {
 namespace dex {
 namespace {
 
-/// Implements iterator of PostingList chunks. This requires iterating over two
-/// levels: the first level iterator iterates over the chunks and decompresses
-/// them on-the-fly when the contents of chunk are to be seen.
-class ChunkIterator : public Iterator {
+/// Implements iterator of PostingList blocks. This requires iterating over two
+/// levels: the first level iterator skips over the blocks using their last
+/// DocIDs and decompresses them on-the-fly when the contents of block are to be
+/// seen.
+class BlockIterator : public Iterator {
 public:
-  explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
-      : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
-    if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
-    }
+  explicit BlockIterator(const Token *Tok, llvm::ArrayRef<Block> Blocks,
+                         llvm::ArrayRef<uint32_t> Words, size_t Size)
+      : Tok(Tok), Blocks(Blocks), Words(Words), Size(Size),
+        CurrentBlock(Blocks.begin()) {
+    if (!Blocks.empty())
+      decompressCurrentBlock();
   }
 
-  bool reachedEnd() const override { return CurrentChunk == Chunks.end(); }
+  bool reachedEnd() const override { return CurrentBlock == Blocks.end(); }
 
   /// Advances cursor to the next item.
   void advance() override {
     assert(!reachedEnd() &&
            "Posting List iterator can't advance() at the end.");
-    ++CurrentID;
-    normalizeCursor();
+    if (++CurrentID != CurrentBlock->Count)
+      return;
+    // Advance to next block if current one is exhausted.
+    if (++CurrentBlock != Blocks.end())
+      decompressCurrentBlock();
   }
 
-  /// Applies binary search to advance cursor to the next item with DocID
-  /// equal or higher than the given one.
+  /// Skips the blocks that end before the given DocID, then advances cursor to
+  /// the next item with DocID equal or higher than the given one.
   void advanceTo(DocID ID) override {
     assert(!reachedEnd() &&
            "Posting List iterator can't advance() at the end.");
     if (ID <= peek())
       return;
-    advanceToChunk(ID);
-    // Try to find ID within current chunk.
-    CurrentID = std::partition_point(CurrentID, DecompressedChunk.end(),
-                                     [&](const DocID D) { return D < ID; });
-    normalizeCursor();
+    if (CurrentBlock->Last < ID) {
+      CurrentBlock =
+          std::partition_point(CurrentBlock + 1, Blocks.end(),
+                               [&](const Block &B) { return B.Last < ID; });
+      if (CurrentBlock == Blocks.end()) // Reached the end of PostingList.
+        return;
+      decompressCurrentBlock();
+    }
+    // The block ends with a DocID >= ID, so ID's position is within it. Count
+    // the smaller DocIDs instead of searching for it: the loop has no
+    // data-dependent branches, so it is vectorized and beats a binary search
+    // on blocks this small.
+    unsigned Smaller = 0;
+    for (unsigned I = CurrentID, E = CurrentBlock->Count; I != E; ++I)
+      Smaller += Decompressed[I] < ID;
+    CurrentID += Smaller;
   }
 
   DocID peek() const override {
     assert(!reachedEnd() && "Posting List iterator can't peek() at the end.");
-    return *CurrentID;
+    return Decompressed[CurrentID];
   }
 
   float consume() override {
@@ -66,9 +83,7 @@ public:
     return 1;
   }
 
-  size_t estimateSize() const override {
-    return Chunks.size() * ApproxEntriesPerChunk;
-  }
+  size_t estimateSize() const override { return Size; }
 
 private:
   llvm::raw_ostream &dump(llvm::raw_ostream &OS) const override {
@@ -76,151 +91,116 @@ private:
       return OS << *Tok;
     OS << '[';
     const char *Sep = "";
-    for (const Chunk &C : Chunks)
-      for (const DocID Doc : C.decompress()) {
+    std::array<DocID, Block::Size> IDs;
+    for (const Block &B : Blocks) {
+      B.decompress(Words, IDs.data());
+      for (const DocID Doc : llvm::makeArrayRef(IDs.data(), B.Count)) {
         OS << Sep << Doc;
         Sep = " ";
       }
+    }
     return OS << ']';
   }
 
-  /// If the cursor is at the end of a chunk, place it at the start of the next
-  /// chunk.
-  void normalizeCursor() {
-    // Invariant is already established if examined chunk is not exhausted.
-    if (CurrentID != std::end(DecompressedChunk))
-      return;
-    // Advance to next chunk if current one is exhausted.
-    ++CurrentChunk;
-    if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
-      return;
-    DecompressedChunk = CurrentChunk->decompress();
-    CurrentID = DecompressedChunk.begin();
-  }
-
-  /// Advances CurrentChunk to the chunk which might contain ID.
-  void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
-    }
+  void decompressCurrentBlock() {
+    CurrentBlock->decompress(Words, Decompressed.data());
+    CurrentID = 0;
   }
 
   const Token *Tok;
-  llvm::ArrayRef<Chunk> Chunks;
-  /// Iterator over chunks.
-  /// If CurrentChunk is valid, then DecompressedChunk is
-  /// CurrentChunk->decompress() and CurrentID is a valid (non-end) iterator
-  /// into it.
-  decltype(Chunks)::const_iterator CurrentChunk;
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> DecompressedChunk;
-  /// Iterator over DecompressedChunk.
-  decltype(DecompressedChunk)::iterator CurrentID;
-
-  static constexpr size_t ApproxEntriesPerChunk = 15;
+  llvm::ArrayRef<Block> Blocks;
+  llvm::ArrayRef<uint32_t> Words;
+  size_t Size;
+  /// Iterator over blocks.
+  /// If CurrentBlock is valid, then Decompressed holds its DocIDs and
+  /// CurrentID is a valid index into them.
+  decltype(Blocks)::const_iterator CurrentBlock;
+  std::array<DocID, Block::Size> Decompressed;
+  /// Index of the current DocID in Decompressed.
+  unsigned CurrentID = 0;
 };
 
-static constexpr size_t BitsPerEncodingByte = 7;
-
-/// Writes a variable length DocID into the buffer and updates the buffer size.
-/// If it doesn't fit, returns false and doesn't write to the buffer.
-bool encodeVByte(DocID Delta, llvm::MutableArrayRef<uint8_t> &Payload) {
-  assert(Delta != 0 && "0 is not a valid PostingList delta.");
-  // Calculate number of bytes Delta encoding would take by examining the
-  // meaningful bits.
-  unsigned Width = 1 + llvm::findLastSet(Delta) / BitsPerEncodingByte;
-  if (Width > Payload.size())
-    return false;
-
-  do {
-    uint8_t Encoding = Delta & 0x7f;
-    Delta >>= 7;
-    Payload.front() = Delta ? Encoding | 0x80 : Encoding;
-    Payload = Payload.drop_front();
-  } while (Delta != 0);
-  return true;
-}
-
-/// Use Variable-length Byte (VByte) delta encoding to compress sorted list of
-/// DocIDs. The compression stores deltas (differences) between subsequent
-/// DocIDs and encodes these deltas utilizing the least possible number of
-/// bytes.
+/// Splits the sorted list of DocIDs into blocks and packs the deltas between
+/// subsequent DocIDs of each block using the least possible number of bits
+/// for the largest delta of the block.
 ///
-/// Each encoding byte consists of two parts: the first bit (continuation bit)
-/// indicates whether this is the last byte (0 if this byte is the last) of
-/// current encoding and seven bytes a piece of DocID (payload). DocID contains
-/// 32 bits and therefore it takes up to 5 bytes to encode it (4 full 7-bit
-/// payloads and one 4-bit payload), but in practice it is expected that gaps
-/// (deltas) between subsequent DocIDs are not large enough to require 5 bytes.
-/// In very dense posting lists (with average gaps less than 128) this
-/// representation would be 4 times more efficient than raw DocID array.
+/// A delta D is stored as D - 1, since DocIDs are unique. Dense posting
+/// lists therefore take a few bits per DocID, and runs of consecutive DocIDs
+/// only take the 16 bytes of their Block.
 ///
-/// PostingList encoding example:
+/// PostingList encoding example (one block):
 ///
-/// DocIDs    42            47        7000
-/// gaps                    5         6958
-/// Encoding  (raw number)  00000101  10110110 00101110
-std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
+/// DocIDs    42   43   47   50
+/// stored         0    3    2     (BitWidth = 2)
+/// Words     0b10'11'00
+void encodeStream(llvm::ArrayRef<DocID> Documents, std::vector<Block> &Blocks,
+                  std::vector<uint32_t> &Words) {
   assert(!Documents.empty() && "Can't encode empty sequence.");
-  std::vector<Chunk> Result;
-  Result.emplace_back();
-  DocID Last = Result.back().Head = Documents.front();
-  llvm::MutableArrayRef<uint8_t> RemainingPayload = Result.back().Payload;
-  for (DocID Doc : Documents.drop_front()) {
-    if (!encodeVByte(Doc - Last, RemainingPayload)) { // didn't fit, flush chunk
-      Result.emplace_back();
-      Result.back().Head = Doc;
-      RemainingPayload = Result.back().Payload;
+  for (size_t Begin = 0; Begin < Documents.size(); Begin += Block::Size) {
+    llvm::ArrayRef<DocID> IDs = Documents.slice(
+        Begin, std::min(Block::Size, Documents.size() - Begin));
+    Block B;
+    B.Head = IDs.front();
+    B.Last = IDs.back();
+    B.Offset = Words.size();
+    B.Count = IDs.size();
+    DocID MaxStored = 0;
+    for (size_t I = 1; I < IDs.size(); ++I) {
+      assert(IDs[I] > IDs[I - 1] && "DocIDs should be sorted and unique.");
+      MaxStored = std::max(MaxStored, IDs[I] - IDs[I - 1] - 1);
     }
-    Last = Doc;
-  }
-  return std::vector<Chunk>(Result); // no move, shrink-to-fit
-}
-
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return None.
-llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return None;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
-    // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
+    B.BitWidth = MaxStored ? llvm::findLastSet(MaxStored) + 1 : 0;
+    Blocks.push_back(B);
+    if (!B.BitWidth)
+      continue;
+
+    uint64_t Buffer = 0;
+    unsigned BufferedBits = 0;
+    for (size_t I = 1; I < IDs.size(); ++I) {
+      Buffer |= uint64_t(IDs[I] - IDs[I - 1] - 1) << BufferedBits;
+      BufferedBits += B.BitWidth;
+      if (BufferedBits >= 32) {
+        Words.push_back(static_cast<uint32_t>(Buffer));
+        Buffer >>= 32;
+        BufferedBits -= 32;
+      }
+    }
+    if (BufferedBits)
+      Words.push_back(static_cast<uint32_t>(Buffer));
   }
-  return Result;
+  Words.push_back(0);
+  // Shrink to fit.
+  Blocks = std::vector<Block>(Blocks);
+  Words = std::vector<uint32_t>(Words);
 }
 
 } // namespace
 
-llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
-      break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
+void Block::decompress(llvm::ArrayRef<uint32_t> Words, DocID *Out) const {
+  Out[0] = Head;
+  if (BitWidth == 0) {
+    for (unsigned I = 1; I < Count; ++I)
+      Out[I] = Head + I;
+    return;
+  }
+  const uint32_t *Packed = Words.data() + Offset;
+  const uint64_t Mask = (uint64_t(1) << BitWidth) - 1;
+  DocID Current = Head;
+  for (unsigned I = 1, Bit = 0; I < Count; ++I, Bit += BitWidth) {
+    // A delta spans at most two words; Words ends with a padding word.
+    uint64_t Pair = Packed[Bit / 32] | uint64_t(Packed[Bit / 32 + 1]) << 32;
+    Current += ((Pair >> (Bit % 32)) & Mask) + 1;
+    Out[I] = Current;
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
-    : Chunks(encodeStream(Documents)) {}
+    : Size(Documents.size()) {
+  encodeStream(Documents, Blocks, Words);
+}
 
 std::unique_ptr<Iterator> PostingList::iterator(const Token *Tok) const {
-  return llvm::make_unique<ChunkIterator>(Tok, Chunks);
+  return llvm::make_unique<BlockIterator>(Tok, Blocks, Words, Size);
 }
 
 } // namespace dex
@@ -13,10 +13,11 @@
 /// traversed in order using an iterator and are values for inverted index,
 /// which maps search tokens to corresponding posting lists.
 ///
-/// In order to decrease size of Index in-memory representation, Variable Byte
-/// Encoding (VByte) is used for PostingLists compression. An overview of VByte
-/// algorithm can be found in "Introduction to Information Retrieval" book:
-/// https://nlp.stanford.edu/IR-book/html/htmledition/variable-byte-codes-1.html
+/// In order to decrease size of Index in-memory representation, PostingLists
+/// are split into blocks of DocIDs whose deltas are bit-packed with the width
+/// of the largest delta in the block (binary packing). An overview of such
+/// codes can be found in "Decoding billions of integers per second through
+/// vectorization" by Lemire and Boytsov: https://arxiv.org/abs/1209.2137
 ///
 //===----------------------------------------------------------------------===//
 
@@ -36,40 +37,59 @@ class Token;
 
 /// NOTE: This is an implementation detail.
 ///
-/// Chunk is a fixed-width piece of PostingList which contains the first DocID
-/// in uncompressed format (Head) and delta-encoded Payload. It can be
-/// decompressed upon request.
-struct Chunk {
-  /// Keep sizeof(Chunk) == 32.
-  static constexpr size_t PayloadSize = 32 - sizeof(DocID);
+/// Block is a piece of PostingList which contains up to Block::Size DocIDs:
+/// the first one in uncompressed format (Head) and the deltas between the
+/// following ones, bit-packed into the words of the PostingList. The last
+/// DocID is kept as a skip pointer, so that blocks can be skipped without
+/// being decompressed.
+struct Block {
+  /// The maximum number of DocIDs in a Block.
+  static constexpr size_t Size = 128;
 
-  llvm::SmallVector<DocID, PayloadSize + 1> decompress() const;
+  /// Decompresses the DocIDs of the block into \p Out, reading the packed
+  /// deltas from \p Words.
+  void decompress(llvm::ArrayRef<uint32_t> Words, DocID *Out) const;
 
-  /// The first element of decompressed Chunk.
+  /// The first DocID of the block.
   DocID Head;
-  /// VByte-encoded deltas.
-  std::array<uint8_t, PayloadSize> Payload;
+  /// The last DocID of the block.
+  DocID Last;
+  /// The index of the first word of the packed deltas.
+  uint32_t Offset;
+  /// The number of DocIDs in the block, at most Size.
+  uint8_t Count;
+  /// The number of bits of each packed delta. A delta D is stored as D - 1,
+  /// so the deltas of consecutive DocIDs take no bits at all.
+  uint8_t BitWidth;
 };
-static_assert(sizeof(Chunk) == 32, "Chunk should take 32 bytes of memory.");
+static_assert(sizeof(Block) == 16, "Block should take 16 bytes of memory.");
 
 /// PostingList is the storage of DocIDs which can be inserted to the Query
 /// Tree as a leaf by constructing Iterator over the PostingList object. DocIDs
-/// are stored in underlying chunks. Compression saves memory at a small cost
+/// are stored in underlying blocks. Compression saves memory at a small cost
 /// in access time, which is still fast enough in practice.
 class PostingList {
 public:
   explicit PostingList(llvm::ArrayRef<DocID> Documents);
 
   /// Constructs DocumentIterator over given posting list. DocumentIterator will
-  /// go through the chunks and decompress them on-the-fly when necessary.
+  /// skip the blocks and decompress them on-the-fly when necessary.
   /// If given, Tok is only used for the string representation.
   std::unique_ptr<Iterator> iterator(const Token *Tok = nullptr) const;
 
   /// Returns in-memory size of external storage.
-  size_t bytes() const { return Chunks.capacity() * sizeof(Chunk); }
+  size_t bytes() const {
+    return Blocks.capacity() * sizeof(Block) +
+           Words.capacity() * sizeof(uint32_t);
+  }
 
 private:
-  const std::vector<Chunk> Chunks;
+  std::vector<Block> Blocks;
+  /// The packed deltas of all blocks, followed by a zero word so that
+  /// decompression can always read two words at a time.
+  std::vector<uint32_t> Words;
+  /// The number of DocIDs in the list.
+  size_t Size;
 };
 
 } // namespace dex
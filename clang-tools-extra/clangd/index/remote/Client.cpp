@@ -0,0 +1,173 @@
+//===--- Client.cpp - Index served by a remote server -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Client.h"
+#include "Logger.h"
+#include "Socket.h"
+#include "Trace.h"
+#include "index/Serialization.h"
+#include "llvm/Support/FormatVariadic.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+// After failing to connect, queries return no results for this long instead
+// of trying to connect again.
+constexpr std::chrono::seconds ConnectRetryDelay(5);
+
+class IndexClient : public SymbolIndex {
+public:
+  explicit IndexClient(ConnectFunction Connect)
+      : Connect(std::move(Connect)) {}
+
+  bool
+  fuzzyFind(const FuzzyFindRequest &Req,
+            llvm::function_ref<void(const Symbol &)> Callback) const override {
+    return call("fuzzyFind", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Symbols)
+        for (const Symbol &S : *Results.Symbols)
+          Callback(S);
+    });
+  }
+
+  void
+  lookup(const LookupRequest &Req,
+         llvm::function_ref<void(const Symbol &)> Callback) const override {
+    call("lookup", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Symbols)
+        for (const Symbol &S : *Results.Symbols)
+          Callback(S);
+    });
+  }
+
+  void refs(const RefsRequest &Req,
+            llvm::function_ref<void(const Ref &)> Callback) const override {
+    call("refs", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (Results.Refs)
+        for (const auto &SymbolRefs : *Results.Refs)
+          for (const Ref &R : SymbolRefs.second)
+            Callback(R);
+    });
+  }
+
+  void relations(const RelationsRequest &Req,
+                 llvm::function_ref<void(const SymbolID &, const Symbol &)>
+                     Callback) const override {
+    call("relations", toJSON(Req), [&](const IndexFileIn &Results) {
+      if (!Results.Relations || !Results.Symbols)
+        return;
+      for (const Relation &R : *Results.Relations) {
+        auto Object = Results.Symbols->find(R.Object);
+        if (Object != Results.Symbols->end())
+          Callback(R.Subject, *Object);
+      }
+    });
+  }
+
+  // The symbols are on the server.
+  size_t estimateMemoryUsage() const override { return 0; }
+
+private:
+  // Sends a request and calls \p OnResults with each batch of results.
+  // Returns whether there may be more results.
+  bool call(llvm::StringRef Method, llvm::json::Value Params,
+            llvm::function_ref<void(const IndexFileIn &)> OnResults) const {
+    trace::Span Tracer("RemoteIndex." + Method);
+    llvm::json::Value Message = llvm::json::Object{
+        {"method", Method},
+        {"params", std::move(Params)},
+    };
+    std::string Request = llvm::formatv("{0}", Message).str();
+    // An idle connection may have been closed by the server since it was
+    // last used. Retry such failures once with a new connection.
+    for (bool Retry = true;; Retry = false) {
+      bool Reused;
+      std::unique_ptr<Stream> Conn = takeConnection(Reused);
+      if (!Conn)
+        return false;
+      bool GotResults = false;
+      if (writeFrame(*Conn, FrameKind::Request, Request)) {
+        while (auto F = readFrame(*Conn)) {
+          if (F->Kind == FrameKind::End) {
+            releaseConnection(std::move(Conn));
+            bool More = F->Payload == "1";
+            SPAN_ATTACH(Tracer, "more", More);
+            return More;
+          }
+          if (F->Kind != FrameKind::Results)
+            break;
+          auto Results = readIndexFile(F->Payload);
+          if (!Results) {
+            elog("Remote index: invalid results: {0}", Results.takeError());
+            break;
+          }
+          GotResults = true;
+          OnResults(*Results);
+        }
+      }
+      if (!Retry || !Reused || GotResults) {
+        elog("Remote index: {0} request failed", Method);
+        return false;
+      }
+    }
+  }
+
+  // Returns an idle connection or a new one, or null if connecting failed.
+  std::unique_ptr<Stream> takeConnection(bool &Reused) const {
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      if (!Idle.empty()) {
+        std::unique_ptr<Stream> Conn = std::move(Idle.back());
+        Idle.pop_back();
+        Reused = true;
+        return Conn;
+      }
+      if (std::chrono::steady_clock::now() < NextConnectAttempt)
+        return nullptr;
+    }
+    Reused = false;
+    auto Conn = Connect();
+    if (Conn)
+      return std::move(*Conn);
+    elog("Remote index: {0}", Conn.takeError());
+    std::lock_guard<std::mutex> Lock(Mu);
+    NextConnectAttempt = std::chrono::steady_clock::now() + ConnectRetryDelay;
+    return nullptr;
+  }
+
+  void releaseConnection(std::unique_ptr<Stream> Conn) const {
+    std::lock_guard<std::mutex> Lock(Mu);
+    Idle.push_back(std::move(Conn));
+  }
+
+  ConnectFunction Connect;
+  mutable std::mutex Mu;
+  mutable std::vector<std::unique_ptr<Stream>> Idle; // GUARDED_BY(Mu)
+  mutable std::chrono::steady_clock::time_point
+      NextConnectAttempt; // GUARDED_BY(Mu)
+};
+
+} // namespace
+
+std::unique_ptr<SymbolIndex> getClient(llvm::StringRef Address) {
+  std::string AddressStr = Address;
+  return getClient([AddressStr] { return connectTo(AddressStr); });
+}
+
+std::unique_ptr<SymbolIndex> getClient(ConnectFunction Connect) {
+  return llvm::make_unique<IndexClient>(std::move(Connect));
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,42 @@
+//===--- Client.h - Index served by a remote server -------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CLIENT_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CLIENT_H
+
+#include "Marshalling.h"
+#include "index/Index.h"
+#include "llvm/Support/Error.h"
+#include <functional>
+#include <memory>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+/// Opens a new connection to the server.
+using ConnectFunction =
+    std::function<llvm::Expected<std::unique_ptr<Stream>>()>;
+
+/// Returns an index which forwards the queries to the clangd-index-server
+/// listening on \p Address ("host:port").
+///
+/// The index keeps idle connections open and opens a new one whenever all are
+/// busy, so concurrent queries don't wait for each other. Queries that fail
+/// are logged and return no results. The index holds no symbols, so it uses
+/// almost no memory; its results are typically merged with a local dynamic
+/// index by MergedIndex.
+std::unique_ptr<SymbolIndex> getClient(llvm::StringRef Address);
+/// As above, with the connections opened by \p Connect.
+std::unique_ptr<SymbolIndex> getClient(ConnectFunction Connect);
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_CLIENT_H
@@ -0,0 +1,57 @@
+//===--- Marshalling.cpp - Wire format of the remote index ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Marshalling.h"
+#include "Logger.h"
+#include "llvm/Support/Endian.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+bool writeFrame(Stream &S, FrameKind Kind, llvm::StringRef Payload) {
+  assert(Payload.size() <= MaxFrameSize && "frame too large");
+  char Header[5];
+  Header[0] = static_cast<char>(Kind);
+  llvm::support::endian::write32le(Header + 1, Payload.size());
+  // Send the frame at once, so that small frames use a single packet.
+  std::string Data(Header, sizeof(Header));
+  Data += Payload;
+  return S.write(Data);
+}
+
+llvm::Optional<Frame> readFrame(Stream &S) {
+  char Header[5];
+  if (!S.read(Header, sizeof(Header)))
+    return llvm::None;
+  Frame F;
+  F.Kind = static_cast<FrameKind>(Header[0]);
+  switch (F.Kind) {
+  case FrameKind::Request:
+  case FrameKind::Results:
+  case FrameKind::End:
+    break;
+  default:
+    elog("Remote index: unknown frame kind {0}",
+         unsigned(static_cast<uint8_t>(Header[0])));
+    return llvm::None;
+  }
+  uint32_t Size = llvm::support::endian::read32le(Header + 1);
+  if (Size > MaxFrameSize) {
+    elog("Remote index: frame of {0} bytes is too large", Size);
+    return llvm::None;
+  }
+  F.Payload.resize(Size);
+  if (Size && !S.read(&F.Payload[0], Size))
+    return llvm::None;
+  return std::move(F);
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,74 @@
+//===--- Marshalling.h - Wire format of the remote index --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// The remote index client and server exchange frames over a byte stream.
+/// A frame is a kind byte, the payload size as a 32-bit little-endian integer
+/// and the payload.
+///
+/// The client sends a Request frame with a JSON object {"method", "params"},
+/// where the method is one of "fuzzyFind", "lookup", "refs" and "relations"
+/// and the params are the JSON form of the request. The server streams the
+/// results back in batches, as Results frames holding RIFF index files, and
+/// finishes with an End frame. Requests on a connection are answered in order.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_MARSHALLING_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_MARSHALLING_H
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <string>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+/// A reliable bidirectional byte stream, such as a TCP connection.
+class Stream {
+public:
+  virtual ~Stream() = default;
+
+  /// Reads exactly \p Size bytes. Returns false at the end of the stream or on
+  /// error.
+  virtual bool read(char *Buffer, size_t Size) = 0;
+  /// Writes all of \p Data. Returns false on error.
+  virtual bool write(llvm::StringRef Data) = 0;
+};
+
+enum class FrameKind : uint8_t {
+  /// A JSON object with the method and the params of a request.
+  Request = 'Q',
+  /// A RIFF index file with a batch of results.
+  Results = 'R',
+  /// The end of the results: "1" if there may be more results than were
+  /// returned (see SymbolIndex::fuzzyFind), else "0".
+  End = 'E',
+};
+
+struct Frame {
+  FrameKind Kind;
+  std::string Payload;
+};
+
+/// Frames larger than this are rejected, to bound the memory used by a peer.
+constexpr uint32_t MaxFrameSize = 1 << 28;
+
+/// Writes a frame to \p S. Returns false on error.
+bool writeFrame(Stream &S, FrameKind Kind, llvm::StringRef Payload);
+/// Reads the next frame from \p S. Returns None at the end of the stream or
+/// on error.
+llvm::Optional<Frame> readFrame(Stream &S);
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_MARSHALLING_H
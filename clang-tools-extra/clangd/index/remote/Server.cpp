@@ -0,0 +1,182 @@
+//===--- Server.cpp - Serves an index to remote clients ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Server.h"
+#include "Logger.h"
+#include "Trace.h"
+#include "index/Serialization.h"
+#include "llvm/Support/raw_ostream.h"
+#include <limits>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+// Results are sent in batches of this many symbols, refs or relations.
+constexpr size_t BatchSize = 256;
+
+// Buffers the results of a request and sends them in batches.
+class ResultWriter {
+public:
+  explicit ResultWriter(Stream &Conn) : Conn(Conn) { reset(); }
+
+  void add(const Symbol &S) {
+    Symbols->insert(S);
+    added();
+  }
+
+  void add(const SymbolID &ID, const Ref &R) {
+    Refs->insert(ID, R);
+    added();
+  }
+
+  void add(const Relation &R, const Symbol &Object) {
+    Relations->insert(R);
+    Symbols->insert(Object);
+    added();
+  }
+
+  // Sends the pending results and the end of the results.
+  bool finish(bool More) {
+    flush();
+    return OK && writeFrame(Conn, FrameKind::End, More ? "1" : "0");
+  }
+
+private:
+  void added() {
+    if (++Pending == BatchSize)
+      flush();
+  }
+
+  void flush() {
+    if (!Pending)
+      return;
+    SymbolSlab SymbolBatch = std::move(*Symbols).build();
+    RefSlab RefBatch = std::move(*Refs).build();
+    RelationSlab RelationBatch = std::move(*Relations).build();
+    reset();
+    // Keep consuming the results of a query whose client went away.
+    if (!OK)
+      return;
+    IndexFileOut Out;
+    Out.Symbols = &SymbolBatch;
+    Out.Refs = &RefBatch;
+    Out.Relations = &RelationBatch;
+    std::string Payload;
+    llvm::raw_string_ostream OS(Payload);
+    OS << Out;
+    OK = writeFrame(Conn, FrameKind::Results, OS.str());
+  }
+
+  void reset() {
+    Symbols.emplace();
+    Refs.emplace();
+    Relations.emplace();
+    Pending = 0;
+  }
+
+  Stream &Conn;
+  bool OK = true;
+  size_t Pending;
+  llvm::Optional<SymbolSlab::Builder> Symbols;
+  llvm::Optional<RefSlab::Builder> Refs;
+  llvm::Optional<RelationSlab::Builder> Relations;
+};
+
+template <typename RequestT>
+llvm::Optional<RequestT> parseRequest(llvm::StringRef Method,
+                                      const llvm::json::Value &Params) {
+  RequestT Req;
+  if (fromJSON(Params, Req))
+    return std::move(Req);
+  elog("Remote index: invalid {0} request: {1}", Method, Params);
+  return llvm::None;
+}
+
+// Answers one request. Returns false if the connection should be closed.
+bool handle(const SymbolIndex &Index, llvm::StringRef Payload, Stream &Conn) {
+  auto Request = llvm::json::parse(Payload);
+  if (!Request) {
+    elog("Remote index: invalid request: {0}", Request.takeError());
+    return false;
+  }
+  const llvm::json::Object *O = Request->getAsObject();
+  llvm::Optional<llvm::StringRef> Method =
+      O ? O->getString("method") : llvm::None;
+  const llvm::json::Value *Params = O ? O->get("params") : nullptr;
+  if (!Method || !Params) {
+    elog("Remote index: request without method or params: {0}", *Request);
+    return false;
+  }
+
+  trace::Span Tracer(*Method);
+  ResultWriter Results(Conn);
+  bool More = false;
+  if (*Method == "fuzzyFind") {
+    auto Req = parseRequest<FuzzyFindRequest>(*Method, *Params);
+    if (!Req)
+      return false;
+    More = Index.fuzzyFind(*Req, [&](const Symbol &S) { Results.add(S); });
+  } else if (*Method == "lookup") {
+    auto Req = parseRequest<LookupRequest>(*Method, *Params);
+    if (!Req)
+      return false;
+    Index.lookup(*Req, [&](const Symbol &S) { Results.add(S); });
+  } else if (*Method == "refs") {
+    auto Req = parseRequest<RefsRequest>(*Method, *Params);
+    if (!Req)
+      return false;
+    uint32_t Remaining =
+        Req->Limit.getValueOr(std::numeric_limits<uint32_t>::max());
+    // Query the symbols one at a time, to know which symbol each ref is of.
+    for (const SymbolID &ID : Req->IDs) {
+      if (!Remaining)
+        break;
+      RefsRequest One;
+      One.IDs.insert(ID);
+      One.Filter = Req->Filter;
+      if (Req->Limit)
+        One.Limit = Remaining;
+      Index.refs(One, [&](const Ref &R) {
+        Results.add(ID, R);
+        if (Remaining)
+          --Remaining;
+      });
+    }
+  } else if (*Method == "relations") {
+    auto Req = parseRequest<RelationsRequest>(*Method, *Params);
+    if (!Req)
+      return false;
+    Index.relations(*Req, [&](const SymbolID &Subject, const Symbol &Object) {
+      Results.add(Relation{Subject, Req->Predicate, Object.ID}, Object);
+    });
+  } else {
+    elog("Remote index: unknown method {0}", *Method);
+    return false;
+  }
+  SPAN_ATTACH(Tracer, "more", More);
+  return Results.finish(More);
+}
+
+} // namespace
+
+void serve(const SymbolIndex &Index, Stream &Conn) {
+  while (auto F = readFrame(Conn)) {
+    if (F->Kind != FrameKind::Request) {
+      elog("Remote index: expected a request frame");
+      return;
+    }
+    if (!handle(Index, F->Payload, Conn))
+      return;
+  }
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
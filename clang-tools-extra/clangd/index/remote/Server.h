@@ -0,0 +1,28 @@
+//===--- Server.h - Serves an index to remote clients -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_SERVER_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_SERVER_H
+
+#include "Marshalling.h"
+#include "index/Index.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+/// Answers the requests read from \p Conn by querying \p Index, until the end
+/// of the stream or an error. Results are streamed back in batches as they
+/// are found, so the client can start using them before the query finishes.
+void serve(const SymbolIndex &Index, Stream &Conn);
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_SERVER_H
@@ -0,0 +1,200 @@
+//===--- Socket.cpp - TCP streams for the remote index ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Socket.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FormatVariadic.h"
+#ifdef LLVM_ON_UNIX
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+#include <tuple>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+llvm::Error makeError(const llvm::Twine &Message) {
+  return llvm::make_error<llvm::StringError>(Message,
+                                             llvm::inconvertibleErrorCode());
+}
+
+#ifdef LLVM_ON_UNIX
+
+llvm::Error errnoError(llvm::StringRef Operation) {
+  return makeError(Operation + ": " + std::strerror(errno));
+}
+
+class SocketStream : public Stream {
+public:
+  explicit SocketStream(int FD) : FD(FD) {}
+  ~SocketStream() override { ::close(FD); }
+
+  bool read(char *Buffer, size_t Size) override {
+    while (Size) {
+      ssize_t N = ::recv(FD, Buffer, Size, 0);
+      if (N < 0 && errno == EINTR)
+        continue;
+      if (N <= 0)
+        return false;
+      Buffer += N;
+      Size -= N;
+    }
+    return true;
+  }
+
+  bool write(llvm::StringRef Data) override {
+#ifdef MSG_NOSIGNAL
+    // A peer that went away must not kill the process with SIGPIPE.
+    const int Flags = MSG_NOSIGNAL;
+#else
+    const int Flags = 0;
+#endif
+    while (!Data.empty()) {
+      ssize_t N = ::send(FD, Data.data(), Data.size(), Flags);
+      if (N < 0 && errno == EINTR)
+        continue;
+      if (N <= 0)
+        return false;
+      Data = Data.drop_front(N);
+    }
+    return true;
+  }
+
+private:
+  int FD;
+};
+
+std::unique_ptr<Stream> makeStream(int FD) {
+  int One = 1;
+  // Requests and results are small, so send them without delay.
+  ::setsockopt(FD, IPPROTO_TCP, TCP_NODELAY, &One, sizeof(One));
+#ifdef SO_NOSIGPIPE
+  ::setsockopt(FD, SOL_SOCKET, SO_NOSIGPIPE, &One, sizeof(One));
+#endif
+  return llvm::make_unique<SocketStream>(FD);
+}
+
+// Resolves a "host:port" address and calls \p Callback with each of its
+// socket addresses until it returns a valid socket.
+llvm::Expected<int>
+forEachAddress(llvm::StringRef Address, bool Passive,
+               llvm::function_ref<int(const addrinfo &)> Callback) {
+  llvm::StringRef Host, Port;
+  std::tie(Host, Port) = Address.rsplit(':');
+  if (Port.empty())
+    return makeError(
+        llvm::formatv("Invalid address '{0}', expected host:port", Address)
+            .str());
+  // Allow IPv6 literals such as [::1]:1234.
+  if (Host.startswith("[") && Host.endswith("]"))
+    Host = Host.drop_front().drop_back();
+  addrinfo Hints = {};
+  Hints.ai_family = AF_UNSPEC;
+  Hints.ai_socktype = SOCK_STREAM;
+  if (Passive)
+    Hints.ai_flags = AI_PASSIVE;
+  std::string HostStr = Host, PortStr = Port;
+  addrinfo *Addresses;
+  if (int Err = ::getaddrinfo(HostStr.empty() ? nullptr : HostStr.c_str(),
+                              PortStr.c_str(), &Hints, &Addresses))
+    return makeError(llvm::formatv("Failed to resolve '{0}': {1}", Address,
+                                   ::gai_strerror(Err))
+                         .str());
+  int FD = -1;
+  for (addrinfo *A = Addresses; A && FD < 0; A = A->ai_next)
+    FD = Callback(*A);
+  ::freeaddrinfo(Addresses);
+  return FD;
+}
+
+#endif
+
+} // namespace
+
+#ifdef LLVM_ON_UNIX
+
+llvm::Expected<std::unique_ptr<Stream>> connectTo(llvm::StringRef Address) {
+  auto FD = forEachAddress(Address, /*Passive=*/false, [](const addrinfo &A) {
+    int FD = ::socket(A.ai_family, A.ai_socktype, A.ai_protocol);
+    if (FD >= 0 && ::connect(FD, A.ai_addr, A.ai_addrlen) != 0) {
+      ::close(FD);
+      FD = -1;
+    }
+    return FD;
+  });
+  if (!FD)
+    return FD.takeError();
+  if (*FD < 0)
+    return errnoError(llvm::formatv("Failed to connect to {0}", Address).str());
+  return makeStream(*FD);
+}
+
+llvm::Expected<std::unique_ptr<Listener>>
+Listener::listen(llvm::StringRef Address) {
+  auto FD = forEachAddress(Address, /*Passive=*/true, [](const addrinfo &A) {
+    int FD = ::socket(A.ai_family, A.ai_socktype, A.ai_protocol);
+    if (FD < 0)
+      return FD;
+    int One = 1;
+    ::setsockopt(FD, SOL_SOCKET, SO_REUSEADDR, &One, sizeof(One));
+    if (::bind(FD, A.ai_addr, A.ai_addrlen) != 0 || ::listen(FD, 128) != 0) {
+      ::close(FD);
+      FD = -1;
+    }
+    return FD;
+  });
+  if (!FD)
+    return FD.takeError();
+  if (*FD < 0)
+    return errnoError(llvm::formatv("Failed to listen on {0}", Address).str());
+  return std::unique_ptr<Listener>(new Listener(*FD));
+}
+
+Listener::~Listener() { ::close(FD); }
+
+llvm::Expected<std::unique_ptr<Stream>> Listener::accept() {
+  while (true) {
+    int Conn = ::accept(FD, nullptr, nullptr);
+    if (Conn >= 0)
+      return makeStream(Conn);
+    if (errno != EINTR)
+      return errnoError("Failed to accept a connection");
+  }
+}
+
+#else
+
+llvm::Expected<std::unique_ptr<Stream>> connectTo(llvm::StringRef Address) {
+  return makeError("The remote index is only supported on POSIX systems");
+}
+
+llvm::Expected<std::unique_ptr<Listener>>
+Listener::listen(llvm::StringRef Address) {
+  return makeError("The remote index is only supported on POSIX systems");
+}
+
+Listener::~Listener() {}
+
+llvm::Expected<std::unique_ptr<Stream>> Listener::accept() {
+  return makeError("The remote index is only supported on POSIX systems");
+}
+
+#endif
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,51 @@
+//===--- Socket.h - TCP streams for the remote index ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// TCP connections carrying the remote index protocol. Addresses have the
+/// form "host:port". Only POSIX sockets are supported; elsewhere connecting
+/// and listening fail.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_SOCKET_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_SOCKET_H
+
+#include "Marshalling.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+/// Connects to the server listening on \p Address.
+llvm::Expected<std::unique_ptr<Stream>> connectTo(llvm::StringRef Address);
+
+/// A socket accepting the connections of remote index clients.
+class Listener {
+public:
+  /// Listens on \p Address. An empty host listens on all interfaces.
+  static llvm::Expected<std::unique_ptr<Listener>>
+  listen(llvm::StringRef Address);
+  ~Listener();
+
+  /// Waits for the next connection.
+  llvm::Expected<std::unique_ptr<Stream>> accept();
+
+private:
+  explicit Listener(int FD) : FD(FD) {}
+
+  int FD;
+};
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_SOCKET_H
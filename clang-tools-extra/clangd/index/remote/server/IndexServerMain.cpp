@@ -0,0 +1,78 @@
+//===--- IndexServerMain.cpp - Serves an index to remote clangds -*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// clangd-index-server loads an index built by clangd-indexer and answers the
+// queries of the clangds started with --remote-index-address.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Threading.h"
+#include "index/Serialization.h"
+#include "index/remote/Server.h"
+#include "index/remote/Socket.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace clang {
+namespace clangd {
+namespace {
+
+static llvm::cl::opt<std::string> IndexPath(llvm::cl::desc("<INDEX FILE>"),
+                                            llvm::cl::Positional,
+                                            llvm::cl::Required);
+
+static llvm::cl::opt<std::string>
+    ListenAddress("listen-address",
+                  llvm::cl::desc("Address to listen on, as host:port. An "
+                                 "empty host listens on all interfaces"),
+                  llvm::cl::init(":50051"));
+
+} // namespace
+} // namespace clangd
+} // namespace clang
+
+int main(int argc, const char **argv) {
+  using namespace clang::clangd;
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+
+  const char *Overview = R"(
+  Serves an index built by clangd-indexer to remote clangd instances.
+
+  $ clangd-index-server --listen-address=:50051 clangd.dex
+  $ clangd --remote-index-address=server:50051
+  )";
+  llvm::cl::ParseCommandLineOptions(argc, argv, Overview);
+
+  std::unique_ptr<SymbolIndex> Index = loadIndex(IndexPath);
+  if (!Index) {
+    llvm::errs() << "Failed to load the index from " << IndexPath << "\n";
+    return 1;
+  }
+  auto Server = remote::Listener::listen(ListenAddress);
+  if (!Server) {
+    llvm::errs() << llvm::toString(Server.takeError()) << "\n";
+    return 1;
+  }
+  llvm::errs() << "Serving " << IndexPath << " on " << ListenAddress << "\n";
+
+  // Each connection is served by its own thread, so that slow queries don't
+  // delay the others.
+  AsyncTaskRunner Connections;
+  while (true) {
+    auto Conn = (*Server)->accept();
+    if (!Conn) {
+      llvm::errs() << llvm::toString(Conn.takeError()) << "\n";
+      continue;
+    }
+    Connections.runAsync("remote-index-connection",
+                         [&Index, Conn = std::move(*Conn)] {
+                           remote::serve(*Index, *Conn);
+                         });
+  }
+}
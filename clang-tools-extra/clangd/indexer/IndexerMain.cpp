@@ -32,7 +32,9 @@ static llvm::cl::opt<IndexFileFormat>
            llvm::cl::values(clEnumValN(IndexFileFormat::YAML, "yaml",
                                        "human-readable YAML format"),
                             clEnumValN(IndexFileFormat::RIFF, "binary",
-                                       "binary RIFF format")),
+                                       "binary RIFF format"),
+                            clEnumValN(IndexFileFormat::Mapped, "mapped",
+                                       "memory-mappable Dex format")),
            llvm::cl::init(IndexFileFormat::RIFF));
 
 class IndexActionFactory : public tooling::FrontendActionFactory {
@@ -15,6 +15,7 @@
 #include "Transport.h"
 #include "index/Background.h"
 #include "index/Serialization.h"
+#include "index/remote/Client.h"
 #include "clang/Basic/Version.h"
 #include "clang/Format/Format.h"
 #include "llvm/ADT/Optional.h"
@@ -47,6 +48,18 @@ static llvm::cl::opt<unsigned>
                        llvm::cl::desc("Number of async workers used by clangd"),
                        llvm::cl::init(getDefaultAsyncThreadsCount()));
 
+static llvm::cl::opt<unsigned> RetainedASTMemory(
+    "retained-ast-memory",
+    llvm::cl::desc("Maximum memory in MiB used by the ASTs of files that are "
+                   "not being processed. 0 means no limit"),
+    llvm::cl::init(0), llvm::cl::Hidden);
+
+static llvm::cl::opt<bool> SharePreambles(
+    "share-preambles",
+    llvm::cl::desc("Share one preamble between files that start with the same "
+                   "#include block and use the same compile flags"),
+    llvm::cl::init(true), llvm::cl::Hidden);
+
 // FIXME: also support "plain" style where signatures are always omitted.
 enum CompletionStyleFlag { Detailed, Bundled };
 static llvm::cl::opt<CompletionStyleFlag> CompletionStyle(
@@ -117,6 +130,12 @@ static llvm::cl::opt<int> LimitResults(
                    "0 means no limit (default=100)"),
     llvm::cl::init(100));
 
+static llvm::cl::opt<unsigned> CompletionLatencyBudget(
+    "completion-latency-budget",
+    llvm::cl::desc("Return the best completions scored within this many "
+                   "milliseconds as an incomplete list. 0 means no budget"),
+    llvm::cl::init(0), llvm::cl::Hidden);
+
 static llvm::cl::opt<bool>
     Sync("sync", llvm::cl::desc("Parse on main thread. If set, -j is ignored"),
          llvm::cl::init(false), llvm::cl::Hidden);
@@ -183,6 +202,13 @@ static llvm::cl::opt<Path> IndexFile(
         "eventually. Don't rely on it"),
     llvm::cl::init(""), llvm::cl::Hidden);
 
+static llvm::cl::opt<std::string> RemoteIndexAddress(
+    "remote-index-address",
+    llvm::cl::desc(
+        "Address (host:port) of a clangd-index-server to query instead of "
+        "loading --index-file. The static index then lives on the server"),
+    llvm::cl::init(""), llvm::cl::Hidden);
+
 static llvm::cl::opt<bool> EnableBackgroundIndex(
     "background-index",
     llvm::cl::desc(
@@ -463,7 +489,9 @@ int main(int argc, char *argv[]) {
   Opts.BackgroundIndex = EnableBackgroundIndex;
   std::unique_ptr<SymbolIndex> StaticIdx;
   std::future<void> AsyncIndexLoad; // Block exit while loading the index.
-  if (EnableIndex && !IndexFile.empty()) {
+  if (EnableIndex && !RemoteIndexAddress.empty()) {
+    StaticIdx = remote::getClient(RemoteIndexAddress);
+  } else if (EnableIndex && !IndexFile.empty()) {
     // Load the index asynchronously. Meanwhile SwapIndex returns no results.
     SwapIndex *Placeholder;
     StaticIdx.reset(Placeholder = new SwapIndex(llvm::make_unique<MemIndex>()));
@@ -476,6 +504,9 @@ int main(int argc, char *argv[]) {
   }
   Opts.StaticIndex = StaticIdx.get();
   Opts.AsyncThreadsCount = WorkerThreadsCount;
+  Opts.SharePreambles = SharePreambles;
+  Opts.RetentionPolicy.MaxRetainedBytes =
+      static_cast<std::size_t>(RetainedASTMemory) << 20;
 
   clangd::CodeCompleteOptions CCOpts;
   CCOpts.IncludeIneligibleResults = IncludeIneligibleResults;
@@ -492,6 +523,8 @@ int main(int argc, char *argv[]) {
   CCOpts.EnableFunctionArgSnippets = EnableFunctionArgSnippets;
   CCOpts.AllScopes = AllScopesCompletion;
   CCOpts.RunParser = CodeCompletionParse;
+  if (CompletionLatencyBudget)
+    CCOpts.LatencyBudget = std::chrono::milliseconds(CompletionLatencyBudget);
 
   RealFileSystemProvider FSProvider;
   // Initialize and run ClangdLSPServer.
@@ -646,6 +646,36 @@ TEST_F(BackgroundIndexRebuilderTest, LoadingShards) {
   EXPECT_TRUE(checkRebuild([&] { Rebuilder.doneLoading(); }));
 }
 
+TEST_F(BackgroundIndexRebuilderTest, IncrementalRebuild) {
+  // Files that don't change, so that few files change between rebuilds.
+  Symbol Unchanged;
+  Unchanged.ID = SymbolID("unchanged");
+  Unchanged.Name = "unchanged";
+  for (unsigned I = 0; I < 10; ++I) {
+    SymbolSlab::Builder SB;
+    SB.insert(Unchanged);
+    Source.update("unchanged" + std::to_string(I),
+                  llvm::make_unique<SymbolSlab>(std::move(SB).build()),
+                  nullptr, nullptr, false);
+  }
+  Rebuilder.startLoading();
+  Rebuilder.loadedShard(10);
+  EXPECT_TRUE(checkRebuild([&] { Rebuilder.doneLoading(); }));
+  EXPECT_EQ(Source.numChangedFiles(), 0u);
+
+  // Only the changed file is reindexed, over the full index.
+  EXPECT_TRUE(checkRebuild([&] {
+    Rebuilder.indexedTU();
+    Rebuilder.idle();
+  }));
+  EXPECT_EQ(Source.numChangedFiles(), 1u);
+  LookupRequest Req;
+  Req.IDs.insert(Unchanged.ID);
+  unsigned Found = 0;
+  Target.lookup(Req, [&](const Symbol &) { ++Found; });
+  EXPECT_EQ(Found, 1u);
+}
+
 TEST(BackgroundQueueTest, Priority) {
   // Create high and low priority tasks.
   // Once a bunch of high priority tasks have run, the queue is stopped.
@@ -9,6 +9,7 @@
 #include "Annotations.h"
 #include "ClangdUnit.h"
 #include "SourceCode.h"
+#include "TestFS.h"
 #include "TestTU.h"
 #include "clang/Basic/TokenKinds.h"
 #include "clang/Tooling/Syntax/Tokens.h"
@@ -155,6 +156,49 @@ TEST(ClangdUnitTest, NoCrashOnTokensWithTidyCheck) {
   EXPECT_EQ(T.expandedTokens().drop_back().back().text(SM), "}");
 }
 
+TEST(ClangdUnitTest, PreamblePatch) {
+  std::string FileName = testPath("foo.cpp");
+  llvm::StringMap<std::string> Files;
+  Files[testPath("a.h")] = "int a();";
+  Files[testPath("b.h")] = "int b();";
+
+  ParseInputs Inputs;
+  Inputs.CompileCommand.Filename = FileName;
+  Inputs.CompileCommand.CommandLine = {"clang", FileName};
+  Inputs.CompileCommand.Directory = testRoot();
+  Inputs.FS = buildTestFS(Files);
+  Inputs.Contents = R"cpp(
+    #include "a.h"
+    int x = a();
+  )cpp";
+  auto CI = buildCompilerInvocation(Inputs);
+  ASSERT_TRUE(CI);
+  auto Baseline = buildPreamble(FileName, *CI, /*OldPreamble=*/nullptr,
+                                Inputs.CompileCommand, Inputs,
+                                /*StoreInMemory=*/true,
+                                /*PreambleCallback=*/nullptr);
+  ASSERT_TRUE(Baseline);
+
+  Inputs.Contents = R"cpp(
+    #include "a.h"
+    #include "b.h" // new
+    #define VALUE 1
+    int x = a() + b() + VALUE;
+  )cpp";
+  CI = buildCompilerInvocation(Inputs);
+  ASSERT_TRUE(CI);
+  PreamblePatch Patch = PreamblePatch::create(FileName, Inputs, *Baseline, *CI);
+  EXPECT_THAT(Patch.text().str(), ::testing::HasSubstr("#include \"b.h\""));
+  EXPECT_THAT(Patch.text().str(), ::testing::HasSubstr("#define VALUE 1"));
+  EXPECT_THAT(Patch.text().str(),
+              ::testing::Not(::testing::HasSubstr("a.h")));
+
+  // The stale preamble and the patch provide all the declarations.
+  auto AST = buildAST(FileName, std::move(CI), Inputs, Baseline, &Patch);
+  ASSERT_TRUE(AST);
+  EXPECT_THAT(AST->getDiagnostics(), ::testing::IsEmpty());
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
@@ -186,6 +186,23 @@ int main() { ClassWithMembers().^ }
   EXPECT_THAT(Results.Completions, ElementsAre(Named("AAA"), Named("BBB")));
 }
 
+TEST(CompletionTest, LatencyBudget) {
+  std::vector<Symbol> Symbols;
+  for (int I = 0; I < 200; ++I)
+    Symbols.push_back(var("v" + std::to_string(I)));
+  clangd::CodeCompleteOptions Opts;
+  Opts.Limit = 0;
+  auto Results = completionsNoCompile("int x = v^", Symbols, Opts);
+  EXPECT_FALSE(Results.HasMore);
+  EXPECT_EQ(Results.Completions.size(), 200u);
+
+  // With an exhausted budget, only the first candidates are scored.
+  Opts.LatencyBudget = std::chrono::milliseconds(0);
+  Results = completionsNoCompile("int x = v^", Symbols, Opts);
+  EXPECT_TRUE(Results.HasMore);
+  EXPECT_LT(Results.Completions.size(), 200u);
+}
+
 TEST(CompletionTest, Filter) {
   std::string Body = R"cpp(
     #define MotorCar
@@ -14,6 +14,7 @@
 #include "index/SymbolID.h"
 #include "index/dex/Dex.h"
 #include "index/dex/Iterator.h"
+#include "index/dex/MappedDex.h"
 #include "index/dex/Token.h"
 #include "index/dex/Trigram.h"
 #include "llvm/Support/ScopedPrinter.h"
@@ -25,8 +26,10 @@
 
 using ::testing::AnyOf;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
+using ::testing::UnorderedElementsAreArray;
 
 namespace clang {
 namespace clangd {
@@ -68,6 +71,34 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DocumentIteratorAcrossBlocks) {
+  // Runs of consecutive DocIDs, small gaps and gaps that need all 32 bits.
+  std::vector<DocID> IDs;
+  for (DocID I = 0; I < 300; ++I)
+    IDs.push_back(I);
+  for (DocID I = 0; I < 300; ++I)
+    IDs.push_back(1000 + 3 * I);
+  IDs.push_back(0xfffffffe);
+  const PostingList L(IDs);
+
+  auto DocIterator = L.iterator();
+  EXPECT_THAT(consumeIDs(*DocIterator), ElementsAreArray(IDs));
+
+  DocIterator = L.iterator();
+  DocIterator->advanceTo(127);
+  EXPECT_EQ(DocIterator->peek(), 127U);
+  DocIterator->advance();
+  EXPECT_EQ(DocIterator->peek(), 128U);
+  DocIterator->advanceTo(500);
+  EXPECT_EQ(DocIterator->peek(), 1000U);
+  DocIterator->advanceTo(1500);
+  EXPECT_EQ(DocIterator->peek(), 1501U);
+  DocIterator->advanceTo(5000);
+  EXPECT_EQ(DocIterator->peek(), 0xfffffffeU);
+  DocIterator->advance();
+  EXPECT_TRUE(DocIterator->reachedEnd());
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
@@ -721,6 +752,67 @@ TEST(DexTests, Relations) {
   EXPECT_THAT(Results, UnorderedElementsAre(Child1.ID, Child2.ID));
 }
 
+TEST(MappedDexTest, MatchesDex) {
+  SymbolSlab Symbols =
+      generateSymbols({"ns::ABC", "ns::BCD", "::ABC", "ns::nested::ABC",
+                       "other::ABC", "other::A", "Parent", "Child"});
+  SymbolID Parent("Parent"), Child("Child"), ABC("ns::ABC");
+  RefSlab::Builder Refs;
+  Ref R;
+  R.Kind = RefKind::Reference;
+  R.Location.FileURI = "unittest:///abc.cc";
+  R.Location.Start.setLine(3);
+  R.Location.End.setColumn(7);
+  Refs.insert(ABC, R);
+  RelationSlab::Builder Relations;
+  Relations.insert({Parent, index::SymbolRole::RelationBaseOf, Child});
+
+  RefSlab RefsSlab = std::move(Refs).build();
+  RelationSlab RelationsSlab = std::move(Relations).build();
+  std::string Data;
+  {
+    llvm::raw_string_ostream OS(Data);
+    writeMappedDex(&Symbols, &RefsSlab, &RelationsSlab, OS);
+  }
+  auto Mapped = MappedDex::create(Data);
+  ASSERT_TRUE(bool(Mapped)) << Mapped.takeError();
+  auto Reference = Dex::build(std::move(Symbols), RefSlab(), RelationSlab());
+
+  FuzzyFindRequest Req;
+  Req.AnyScope = true;
+  for (const char *Query : {"", "A", "ABC", "bc", "nothing"}) {
+    Req.Query = Query;
+    EXPECT_THAT(match(**Mapped, Req),
+                UnorderedElementsAreArray(match(*Reference, Req)))
+        << Query;
+  }
+  Req.Query = "ABC";
+  Req.AnyScope = false;
+  Req.Scopes = {"ns::", "other::"};
+  EXPECT_THAT(match(**Mapped, Req),
+              UnorderedElementsAre("ns::ABC", "other::ABC"));
+
+  EXPECT_THAT(lookup(**Mapped, {ABC, SymbolID("ns::nonono")}),
+              UnorderedElementsAre("ns::ABC"));
+
+  RefsRequest RefsReq;
+  RefsReq.IDs.insert(ABC);
+  std::vector<Ref> FoundRefs;
+  (*Mapped)->refs(RefsReq,
+                  [&](const Ref &Found) { FoundRefs.push_back(Found); });
+  EXPECT_THAT(FoundRefs, ElementsAre(R));
+
+  RelationsRequest RelationsReq;
+  RelationsReq.Subjects.insert(Parent);
+  RelationsReq.Predicate = index::SymbolRole::RelationBaseOf;
+  std::vector<SymbolID> Objects;
+  (*Mapped)->relations(RelationsReq,
+                       [&](const SymbolID &, const Symbol &Object) {
+                         Objects.push_back(Object.ID);
+                       });
+  EXPECT_THAT(Objects, ElementsAre(Child));
+}
+
 TEST(DexTest, PreferredTypesBoosting) {
   auto Sym1 = symbol("t1");
   Sym1.Type = "T1";
@@ -53,6 +53,43 @@ TEST(FSTests, PreambleStatusCache) {
   EXPECT_EQ(CachedDotDot->getUniqueID(), S.getUniqueID());
 }
 
+TEST(FSTests, SharedFileContents) {
+  llvm::StringMap<std::string> Files;
+  Files["x.h"] = "int x;";
+  Files["y.h"] = "int y;";
+  auto FS = buildTestFS(Files);
+
+  SharedFileContents Store;
+  auto SharingFS = Store.getSharingFS(FS);
+  auto ReadX = [&] { return SharingFS->getBufferForFile(testPath("x.h")); };
+
+  auto X1 = ReadX();
+  ASSERT_TRUE(X1);
+  EXPECT_EQ((*X1)->getBuffer(), "int x;");
+  EXPECT_EQ(Store.getBytesSaved(), 0u);
+
+  // A second read of an unchanged file shares the contents of the first.
+  auto X2 = ReadX();
+  ASSERT_TRUE(X2);
+  EXPECT_EQ((*X2)->getBuffer(), "int x;");
+  EXPECT_EQ((*X2)->getBufferIdentifier(), testPath("x.h"));
+  EXPECT_EQ(Store.getBytesSaved(), 6u);
+
+  auto Y = SharingFS->getBufferForFile(testPath("y.h"));
+  ASSERT_TRUE(Y);
+  EXPECT_EQ((*Y)->getBuffer(), "int y;");
+  EXPECT_EQ(Store.getBytesSaved(), 6u);
+
+  X1->reset();
+  EXPECT_EQ(Store.getBytesSaved(), 0u);
+
+  // Volatile reads don't go through the store.
+  auto Volatile = SharingFS->getBufferForFile(testPath("x.h"), -1, true,
+                                              /*IsVolatile=*/true);
+  ASSERT_TRUE(Volatile);
+  EXPECT_EQ(Store.getBytesSaved(), 0u);
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
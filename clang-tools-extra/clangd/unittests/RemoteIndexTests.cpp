@@ -0,0 +1,207 @@
+//===-- RemoteIndexTests.cpp - Remote index client and server tests -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TestIndex.h"
+#include "Threading.h"
+#include "index/MemIndex.h"
+#include "index/remote/Client.h"
+#include "index/remote/Server.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+// One direction of an in-memory connection.
+class Pipe {
+public:
+  bool write(llvm::StringRef Data) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    if (Closed)
+      return false;
+    Buffer += Data;
+    CV.notify_all();
+    return true;
+  }
+
+  bool read(char *Out, size_t Size) {
+    std::unique_lock<std::mutex> Lock(Mu);
+    CV.wait(Lock, [&] { return Closed || Buffer.size() >= Size; });
+    if (Buffer.size() < Size)
+      return false;
+    std::memcpy(Out, Buffer.data(), Size);
+    Buffer.erase(0, Size);
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    Closed = true;
+    CV.notify_all();
+  }
+
+private:
+  std::mutex Mu;
+  std::condition_variable CV;
+  std::string Buffer;
+  bool Closed = false;
+};
+
+class PipeStream : public Stream {
+public:
+  PipeStream(std::shared_ptr<Pipe> In, std::shared_ptr<Pipe> Out)
+      : In(std::move(In)), Out(std::move(Out)) {}
+  ~PipeStream() override {
+    In->close();
+    Out->close();
+  }
+
+  bool read(char *Buffer, size_t Size) override {
+    return In->read(Buffer, Size);
+  }
+  bool write(llvm::StringRef Data) override { return Out->write(Data); }
+
+private:
+  std::shared_ptr<Pipe> In, Out;
+};
+
+// Serves an index over in-memory connections, each on its own thread.
+class Loopback {
+public:
+  explicit Loopback(const SymbolIndex &Index) : Index(Index) {}
+
+  llvm::Expected<std::unique_ptr<Stream>> connect() {
+    auto Up = std::make_shared<Pipe>(), Down = std::make_shared<Pipe>();
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      Pipes.push_back(Up);
+      Pipes.push_back(Down);
+    }
+    ++Connections;
+    Servers.runAsync("server",
+                     [this, Conn = llvm::make_unique<PipeStream>(Up, Down)] {
+                       serve(Index, *Conn);
+                     });
+    return llvm::make_unique<PipeStream>(Down, Up);
+  }
+
+  // Drops all connections, as a restarting server would.
+  void disconnect() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    for (const auto &P : Pipes)
+      P->close();
+  }
+
+  std::atomic<int> Connections = {0};
+
+private:
+  const SymbolIndex &Index;
+  std::mutex Mu;
+  std::vector<std::shared_ptr<Pipe>> Pipes;
+  AsyncTaskRunner Servers;
+};
+
+std::unique_ptr<SymbolIndex> testIndex() {
+  SymbolSlab::Builder Symbols;
+  for (const Symbol &S : generateNumSymbols(0, 1000))
+    Symbols.insert(S);
+  for (const char *Name : {"ns::ABC", "ns::BCD", "Parent", "Child"})
+    Symbols.insert(symbol(Name));
+  RefSlab::Builder Refs;
+  Ref R;
+  R.Kind = RefKind::Reference;
+  R.Location.FileURI = "unittest:///abc.cc";
+  R.Location.Start.setLine(3);
+  Refs.insert(SymbolID("ns::ABC"), R);
+  RelationSlab::Builder Relations;
+  Relations.insert({SymbolID("Parent"), index::SymbolRole::RelationBaseOf,
+                    SymbolID("Child")});
+  return MemIndex::build(std::move(Symbols).build(), std::move(Refs).build(),
+                         std::move(Relations).build());
+}
+
+TEST(RemoteIndexTest, Queries) {
+  auto Index = testIndex();
+  Loopback Server(*Index);
+  auto Client = getClient([&] { return Server.connect(); });
+
+  FuzzyFindRequest Req;
+  Req.Query = "B";
+  Req.Scopes = {"ns::"};
+  EXPECT_THAT(match(*Client, Req), UnorderedElementsAre("ns::ABC", "ns::BCD"));
+  Req.Limit = 1;
+  bool Incomplete;
+  EXPECT_EQ(match(*Client, Req, &Incomplete).size(), 1u);
+  EXPECT_TRUE(Incomplete);
+  // Results larger than a batch are streamed in several batches.
+  Req = FuzzyFindRequest();
+  Req.AnyScope = true;
+  EXPECT_EQ(match(*Client, Req, &Incomplete).size(), 1005u);
+  EXPECT_FALSE(Incomplete);
+
+  EXPECT_THAT(lookup(*Client, {SymbolID("ns::ABC"), SymbolID("nonono")}),
+              ElementsAre("ns::ABC"));
+
+  RefsRequest RefsReq;
+  RefsReq.IDs.insert(SymbolID("ns::ABC"));
+  std::vector<std::string> Files;
+  Client->refs(RefsReq,
+               [&](const Ref &R) { Files.push_back(R.Location.FileURI); });
+  EXPECT_THAT(Files, ElementsAre("unittest:///abc.cc"));
+
+  RelationsRequest RelationsReq;
+  RelationsReq.Subjects.insert(SymbolID("Parent"));
+  RelationsReq.Predicate = index::SymbolRole::RelationBaseOf;
+  std::vector<std::string> Objects;
+  Client->relations(RelationsReq, [&](const SymbolID &, const Symbol &S) {
+    Objects.push_back(S.Name);
+  });
+  EXPECT_THAT(Objects, ElementsAre("Child"));
+
+  // Sequential queries share a connection.
+  EXPECT_EQ(Server.Connections.load(), 1);
+}
+
+TEST(RemoteIndexTest, Reconnects) {
+  auto Index = testIndex();
+  Loopback Server(*Index);
+  auto Client = getClient([&] { return Server.connect(); });
+
+  EXPECT_THAT(lookup(*Client, SymbolID("ns::ABC")), ElementsAre("ns::ABC"));
+  Server.disconnect();
+  EXPECT_THAT(lookup(*Client, SymbolID("ns::ABC")), ElementsAre("ns::ABC"));
+  EXPECT_EQ(Server.Connections.load(), 2);
+}
+
+TEST(RemoteIndexTest, Unreachable) {
+  int Attempts = 0;
+  auto Client = getClient([&]() -> llvm::Expected<std::unique_ptr<Stream>> {
+    ++Attempts;
+    return llvm::make_error<llvm::StringError>(
+        "unreachable", llvm::inconvertibleErrorCode());
+  });
+  EXPECT_THAT(lookup(*Client, SymbolID("ns::ABC")), IsEmpty());
+  // Queries don't wait for the connection to be retried.
+  EXPECT_THAT(lookup(*Client, SymbolID("ns::ABC")), IsEmpty());
+  EXPECT_EQ(Attempts, 1);
+}
+
+} // namespace
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -266,6 +266,41 @@ TEST(SemanticHighlighting, toSemanticHighlightingInformation) {
   EXPECT_EQ(ActualResults, ExpectedResults);
 }
 
+TEST(SemanticHighlighting, DiffHighlightings) {
+  auto Token = [](int Line, int Character, HighlightingKind Kind) {
+    HighlightingToken T;
+    T.Kind = Kind;
+    T.R.start.line = T.R.end.line = Line;
+    T.R.start.character = Character;
+    T.R.end.character = Character + 3;
+    return T;
+  };
+  std::vector<HighlightingToken> Old{
+      Token(0, 0, HighlightingKind::Class),
+      Token(1, 0, HighlightingKind::Variable),
+      Token(1, 4, HighlightingKind::Function),
+      Token(3, 0, HighlightingKind::Variable)};
+  std::vector<HighlightingToken> New{
+      Token(0, 0, HighlightingKind::Class),
+      Token(1, 0, HighlightingKind::Variable),
+      Token(1, 4, HighlightingKind::Field),
+      Token(2, 2, HighlightingKind::Enum)};
+
+  // Line 0 is unchanged, line 1 changed, line 2 is new and line 3 is cleared.
+  llvm::ArrayRef<HighlightingToken> NewTokens = New;
+  std::vector<LineHighlightings> Expected{{1, NewTokens.slice(1, 2)},
+                                          {2, NewTokens.slice(3, 1)},
+                                          {3, {}}};
+  EXPECT_EQ(diffHighlightings(New, Old), Expected);
+  EXPECT_THAT(diffHighlightings(New, New), testing::IsEmpty());
+
+  std::vector<SemanticHighlightingInformation> Lines =
+      toSemanticHighlightingInformation(Expected);
+  ASSERT_EQ(Lines.size(), 3u);
+  EXPECT_EQ(Lines[2].Line, 3);
+  EXPECT_EQ(Lines[2].Tokens, "");
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
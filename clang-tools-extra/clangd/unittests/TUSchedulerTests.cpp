@@ -498,6 +498,44 @@ TEST_F(TUSchedulerTests, EvictedAST) {
               UnorderedElementsAre(Foo, AnyOf(Bar, Baz)));
 }
 
+TEST_F(TUSchedulerTests, EvictedASTByMemory) {
+  ASTRetentionPolicy Policy;
+  Policy.MaxRetainedASTs = 10;
+  // Smaller than any AST, so that only the most recently used one is kept.
+  Policy.MaxRetainedBytes = 1;
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/1, /*StorePreambleInMemory=*/true,
+                /*ASTCallbacks=*/nullptr,
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                Policy);
+
+  llvm::StringLiteral SourceContents = R"cpp(
+    int* a;
+    double* b = a;
+  )cpp";
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+
+  updateWithCallback(S, Foo, SourceContents, WantDiagnostics::Yes, [] {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  ASSERT_THAT(S.getFilesWithCachedAST(), ElementsAre(Foo));
+  std::size_t FooBytes = S.getRetainedASTBytes();
+  EXPECT_GT(FooBytes, 0u);
+
+  updateWithCallback(S, Bar, SourceContents, WantDiagnostics::Yes, [] {});
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), ElementsAre(Bar));
+
+  // The retained bytes are those of the AST for bar.cpp alone.
+  std::size_t BarBytes = 0;
+  for (const auto &PathAndBytes : S.getUsedBytesPerFile())
+    if (PathAndBytes.first == Bar)
+      BarBytes = PathAndBytes.second;
+  EXPECT_GT(S.getRetainedASTBytes(), 0u);
+  EXPECT_LE(S.getRetainedASTBytes(), BarBytes);
+}
+
 TEST_F(TUSchedulerTests, EmptyPreamble) {
   TUScheduler S(CDB,
                 /*AsyncThreadsCount=*/4, /*StorePreambleInMemory=*/true,
@@ -541,6 +579,58 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       });
 }
 
+TEST_F(TUSchedulerTests, SharedPreamble) {
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/4, /*StorePreambleInMemory=*/true,
+                /*ASTCallbacks=*/nullptr,
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                ASTRetentionPolicy(), /*SharePreambles=*/true);
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+  auto Baz = testPath("baz.cpp");
+  auto Header = testPath("foo.h");
+
+  Files[Header] = "void foo();";
+  Timestamps[Header] = time_t(0);
+  auto SameIncludes = R"cpp(
+    #include "foo.h"
+    int main() {}
+  )cpp";
+  auto SameIncludesOtherBody = R"cpp(
+    #include "foo.h"
+    int bar() { return 0; }
+  )cpp";
+  auto OtherIncludes = R"cpp(
+    #include "foo.h"
+    #define BAZ
+    int main() {}
+  )cpp";
+
+  auto GetPreamble = [&](PathRef File) {
+    const PreambleData *Result = nullptr;
+    S.runWithPreamble("getPreamble", File, TUScheduler::Consistent,
+                      [&](Expected<InputsAndPreamble> IP) {
+                        Result = cantFail(std::move(IP)).Preamble;
+                      });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    return Result;
+  };
+
+  S.update(Foo, getInputs(Foo, SameIncludes), WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  S.update(Bar, getInputs(Bar, SameIncludesOtherBody), WantDiagnostics::Auto);
+  S.update(Baz, getInputs(Baz, OtherIncludes), WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+
+  const PreambleData *FooPreamble = GetPreamble(Foo);
+  ASSERT_TRUE(FooPreamble);
+  // bar.cpp starts with the same includes, so it reuses the preamble.
+  EXPECT_EQ(FooPreamble, GetPreamble(Bar));
+  // baz.cpp does not.
+  EXPECT_NE(FooPreamble, GetPreamble(Baz));
+}
+
 TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   // Testing strategy: we update the file and schedule a few preamble reads at
   // the same time. All reads should get the same non-null preamble.
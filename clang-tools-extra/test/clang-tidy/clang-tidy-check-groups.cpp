@@ -0,0 +1,15 @@
+// RUN: clang-tidy -check-groups=3 -checks='-*,google-explicit-constructor,modernize-use-nullptr,clang-diagnostic-unused-variable' %s -- -Wunused-variable 2>&1 | FileCheck -implicit-check-not='{{warning:|error:}}' %s
+
+class A {
+  A(int) {}
+  // CHECK: :[[@LINE-1]]:3: warning: single-argument constructors must be marked explicit
+};
+
+void f() {
+  int *p = 0;
+  // CHECK: :[[@LINE-1]]:8: warning: unused variable 'p' [clang-diagnostic-unused-variable]
+  // CHECK: :[[@LINE-2]]:12: warning: use nullptr [modernize-use-nullptr]
+  int *q = 0; // NOLINT
+}
+
+// CHECK: Suppressed 2 warnings (2 NOLINT).
@@ -181,6 +181,7 @@ public:
   };
   struct NoLValuePath {};
   struct UninitArray {};
+  struct PackedIntArray {};
   struct UninitStruct {};
 
   friend class ASTReader;
@@ -207,7 +208,14 @@ private:
   struct Arr {
     APValue *Elts;
     unsigned NumElts, ArrSize;
+    /// If the array is packed, the values of its elements, each stored in
+    /// host byte order in PackedEltBytes bytes, and Elts is null.
+    char *Packed;
+    uint8_t PackedBitWidth;
+    uint8_t PackedEltBytes;
+    bool PackedIsUnsigned;
     Arr(unsigned NumElts, unsigned ArrSize);
+    Arr(unsigned ArrSize, unsigned BitWidth, bool IsUnsigned);
     ~Arr();
   };
   struct StructData {
@@ -272,6 +280,12 @@ public:
   APValue(UninitArray, unsigned InitElts, unsigned Size) : Kind(None) {
     MakeArray(InitElts, Size);
   }
+  /// Create a packed array of \p Size integers of width \p BitWidth, all of
+  /// which are zero.
+  APValue(PackedIntArray, unsigned Size, unsigned BitWidth, bool IsUnsigned)
+      : Kind(None) {
+    MakePackedArray(Size, BitWidth, IsUnsigned);
+  }
   APValue(UninitStruct, unsigned B, unsigned M) : Kind(None) {
     MakeStruct(B, M);
   }
@@ -423,6 +437,8 @@ public:
   APValue &getArrayInitializedElt(unsigned I) {
     assert(isArray() && "Invalid accessor");
     assert(I < getArrayInitializedElts() && "Index out of range");
+    if (isPackedArray())
+      unpackArray();
     return ((Arr*)(char*)Data.buffer)->Elts[I];
   }
   const APValue &getArrayInitializedElt(unsigned I) const {
@@ -434,6 +450,7 @@ public:
   APValue &getArrayFiller() {
     assert(isArray() && "Invalid accessor");
     assert(hasArrayFiller() && "No array filler");
+    assert(!isPackedArray() && "packed arrays have no filler");
     return ((Arr*)(char*)Data.buffer)->Elts[getArrayInitializedElts()];
   }
   const APValue &getArrayFiller() const {
@@ -448,6 +465,40 @@ public:
     return ((const Arr*)(const void *)Data.buffer)->ArrSize;
   }
 
+  /// Whether this is an array of integers of the same width and signedness,
+  /// stored compactly rather than as one APValue per element. All of the
+  /// elements of a packed array are initialized.
+  ///
+  /// Accessing an element of a packed array as an APValue, through
+  /// getArrayInitializedElt, converts it to the general representation.
+  bool isPackedArray() const {
+    return isArray() && ((const Arr*)(const void *)Data.buffer)->Packed;
+  }
+  unsigned getPackedArrayBitWidth() const {
+    assert(isPackedArray() && "Invalid accessor");
+    return ((const Arr*)(const void *)Data.buffer)->PackedBitWidth;
+  }
+  bool isPackedArrayUnsigned() const {
+    assert(isPackedArray() && "Invalid accessor");
+    return ((const Arr*)(const void *)Data.buffer)->PackedIsUnsigned;
+  }
+  /// The number of bytes used to store each element of a packed array: 1, 2,
+  /// 4 or 8.
+  unsigned getPackedArrayEltBytes() const {
+    assert(isPackedArray() && "Invalid accessor");
+    return ((const Arr*)(const void *)Data.buffer)->PackedEltBytes;
+  }
+  /// The elements of a packed array, in host byte order.
+  StringRef getPackedArrayData() const {
+    assert(isPackedArray() && "Invalid accessor");
+    return StringRef(((const Arr*)(const void *)Data.buffer)->Packed,
+                     size_t(getArraySize()) * getPackedArrayEltBytes());
+  }
+  APSInt getPackedArrayElt(unsigned I) const;
+  /// Set an element of a packed array to \p Value, which must have the width
+  /// and signedness of its elements.
+  void setPackedArrayElt(unsigned I, const APSInt &Value);
+
   unsigned getStructNumBases() const {
     assert(isStruct() && "Invalid accessor");
     return ((const StructData*)(const char*)Data.buffer)->NumBases;
@@ -585,6 +636,9 @@ private:
   }
   void MakeLValue();
   void MakeArray(unsigned InitElts, unsigned Size);
+  void MakePackedArray(unsigned Size, unsigned BitWidth, bool IsUnsigned);
+  /// Convert a packed array to the general representation.
+  void unpackArray();
   void MakeStruct(unsigned B, unsigned M) {
     assert(isAbsent() && "Bad state change");
     new ((void*)(char*)Data.buffer) StructData(B, M);
@@ -90,7 +90,9 @@ class BlockExpr;
 class BuiltinTemplateDecl;
 class CharUnits;
 class ConceptDecl;
+class ConstexprCallCache;
 class CXXABI;
+class CXXBaseLookupCache;
 class CXXConstructorDecl;
 class CXXMethodDecl;
 class CXXRecordDecl;
@@ -140,6 +142,12 @@ class FullComment;
 
 } // namespace comments
 
+namespace interp {
+
+class Context;
+
+} // namespace interp
+
 struct TypeInfo {
   uint64_t Width = 0;
   unsigned Align = 0;
@@ -229,6 +237,18 @@ private:
                                      ASTContext&>
     SubstTemplateTemplateParmPacks;
 
+  /// A uniqued list of canonical template arguments. The
+  /// TemplateArgumentList itself is allocated right after the node.
+  struct UniquedTemplateArgumentList : llvm::FoldingSetNode {
+    /// The profile of the arguments, as computed by
+    /// TemplateArgumentList::Profile.
+    llvm::FoldingSetNodeIDRef ArgsProfile;
+
+    void Profile(llvm::FoldingSetNodeID &ID) const;
+  };
+  mutable llvm::FoldingSet<UniquedTemplateArgumentList>
+    UniquedTemplateArgumentLists;
+
   /// The set of nested name specifiers.
   ///
   /// This set is managed by the NestedNameSpecifier class.
@@ -2258,6 +2278,21 @@ public:
 
   VTableContextBase *getVTableContext();
 
+  /// Retrieve the context of the bytecode interpreter used for constant
+  /// evaluation with -fexperimental-new-constant-interpreter.
+  interp::Context &getInterpContext();
+
+  /// Retrieve the cache of the results of constexpr function calls.
+  ConstexprCallCache &getConstexprCallCache();
+
+  /// Retrieve the cache of the results of member name lookups into the base
+  /// classes of classes.
+  CXXBaseLookupCache &getBaseLookupCache();
+
+  /// Note that a member named \p Name was declared in or removed from a
+  /// class, which may change the results of cached base class lookups.
+  void invalidateBaseLookups(DeclarationName Name);
+
   /// If \p T is null pointer, assume the target in ASTContext.
   MangleContext *createMangleContext(const TargetInfo *T = nullptr);
 
@@ -2440,6 +2475,19 @@ public:
   TemplateArgument getCanonicalTemplateArgument(const TemplateArgument &Arg)
     const;
 
+  /// Retrieve a template argument list holding a copy of \p Args.
+  ///
+  /// If all of the arguments are canonical, the list is uniqued: identical
+  /// lists of canonical arguments share one immutable allocation, which can
+  /// be compared by pointer and whose profile is computed only once.
+  /// Otherwise, this is equivalent to TemplateArgumentList::CreateCopy.
+  TemplateArgumentList *
+  getUniquedTemplateArgumentList(ArrayRef<TemplateArgument> Args) const;
+
+  /// Add the profile of the uniqued template argument list \p List to \p ID.
+  void profileUniquedTemplateArgumentList(llvm::FoldingSetNodeID &ID,
+                                          const TemplateArgumentList *List) const;
+
   /// Type Query functions.  If the type is an instance of the specified class,
   /// return the Type pointer for the underlying maximally pretty type.  This
   /// is a member of ASTContext because this may need to do some amount of
@@ -3004,6 +3052,16 @@ private:
 
   std::unique_ptr<VTableContextBase> VTContext;
 
+  /// The context of the bytecode interpreter for constant evaluation,
+  /// created on first use.
+  std::unique_ptr<interp::Context> InterpContext;
+
+  /// The results of constexpr function calls, created on first use.
+  std::unique_ptr<ConstexprCallCache> ConstexprCalls;
+
+  /// The results of base class member lookups, created on first use.
+  std::unique_ptr<CXXBaseLookupCache> BaseLookups;
+
   void ReleaseDeclContextMaps();
 
 public:
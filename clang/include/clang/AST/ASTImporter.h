@@ -272,6 +272,12 @@ class TypeSourceInfo;
     /// (which we have already complained about).
     NonEquivalentDeclSet NonEquivalentDecls;
 
+    /// (from, to) pairs of complete record and enum definitions that are known
+    /// to be structurally equivalent. Unlike in minimal import, definitions
+    /// don't change once they are complete, so the result can be reused by
+    /// the later imports which find the same candidate.
+    llvm::DenseSet<std::pair<Decl *, Decl *>> EquivalentDefinitions;
+
     using FoundDeclsTy = SmallVector<NamedDecl *, 2>;
     FoundDeclsTy findDeclsInToCtx(DeclContext *DC, DeclarationName Name);
 
@@ -188,6 +188,11 @@ public:
       : FindAmbiguities(FindAmbiguities), RecordPaths(RecordPaths),
         DetectVirtual(DetectVirtual) {}
 
+  /// Copy the results of a search. The scratch path and the array of found
+  /// declarations are not copied.
+  CXXBasePaths(const CXXBasePaths &Other);
+  CXXBasePaths &operator=(const CXXBasePaths &) = delete;
+
   paths_iterator begin() { return Paths.begin(); }
   paths_iterator end()   { return Paths.end(); }
   const_paths_iterator begin() const { return Paths.begin(); }
@@ -372,6 +377,40 @@ class CXXFinalOverriderMap
 class CXXIndirectPrimaryBaseSet
   : public llvm::SmallSet<const CXXRecordDecl*, 32> {};
 
+/// A cache of the results of looking up member names in the base classes
+/// of classes, keyed by the derived class, the name, and the kind of lookup.
+///
+/// Declaring or removing a member of any class drops all of the entries for
+/// its name, since that can change the result of looking up the name in
+/// classes derived from it.
+class CXXBaseLookupCache {
+public:
+  /// Retrieve the paths found by looking up \p Name in the bases of \p RD,
+  /// or null if they are not cached. A lookup that found nothing has no
+  /// paths.
+  const CXXBasePaths *find(const CXXRecordDecl *RD, DeclarationName Name,
+                           unsigned Kind);
+
+  /// Record the paths found by looking up \p Name in the bases of \p RD.
+  void insert(const CXXRecordDecl *RD, DeclarationName Name, unsigned Kind,
+              const CXXBasePaths &Paths);
+
+  /// Drop the cached lookups of \p Name.
+  void invalidate(DeclarationName Name);
+
+  void PrintStats() const;
+
+private:
+  using RecordAndKind = std::pair<const CXXRecordDecl *, unsigned>;
+  llvm::DenseMap<DeclarationName,
+                 llvm::DenseMap<RecordAndKind, std::unique_ptr<CXXBasePaths>>>
+      Entries;
+
+  unsigned NumLookups = 0;
+  unsigned NumHits = 0;
+  unsigned NumInvalidated = 0;
+};
+
 } // namespace clang
 
 #endif // LLVM_CLANG_AST_CXXINHERITANCE_H
@@ -24,6 +24,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include <algorithm>
 #include <cassert>
+#include <memory>
 
 namespace clang {
 
@@ -245,6 +246,12 @@ private:
   friend class DeclContext;
 
   llvm::PointerIntPair<StoredDeclsMap*, 1> Previous;
+
+  /// For each lexical context whose declarations have been added to this map
+  /// by walking them, the last declaration that was walked. Rebuilding the
+  /// map then only needs to walk the declarations added since. Only
+  /// allocated once a large context has been walked.
+  std::unique_ptr<llvm::DenseMap<const DeclContext *, Decl *>> LastWalkedDecls;
 };
 
 class DependentStoredDeclsMap : public StoredDeclsMap {
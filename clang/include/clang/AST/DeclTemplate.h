@@ -295,11 +295,15 @@ class TemplateArgumentList final
   /// argument list.
   unsigned NumArguments;
 
+  /// Whether this list was uniqued by the ASTContext.
+  bool Uniqued = false;
+
   // Constructs an instance with an internal Argument list, containing
   // a copy of the Args array. (Called by CreateCopy)
   TemplateArgumentList(ArrayRef<TemplateArgument> Args);
 
 public:
+  friend class ASTContext;
   friend TrailingObjects;
 
   TemplateArgumentList(const TemplateArgumentList &) = delete;
@@ -350,6 +354,19 @@ public:
 
   /// Retrieve a pointer to the template argument list.
   const TemplateArgument *data() const { return Arguments; }
+
+  /// Whether this list is shared by all identical lists of canonical
+  /// arguments; see ASTContext::getUniquedTemplateArgumentList.
+  bool isUniqued() const { return Uniqued; }
+
+  /// Profile the arguments of this list as their number followed by each of
+  /// them. The profile of a uniqued list is only computed once.
+  void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &Context) const;
+
+  /// Compute a hash of the given template arguments that is stable across
+  /// translation units, for use as a key when looking up specializations
+  /// stored in an AST file.
+  static unsigned ComputeODRHash(ArrayRef<TemplateArgument> Args);
 };
 
 void *allocateDefaultArgStorageChain(const ASTContext &C);
@@ -654,7 +671,7 @@ public:
   }
 
   void Profile(llvm::FoldingSetNodeID &ID) {
-    Profile(ID, TemplateArguments->asArray(), getFunction()->getASTContext());
+    TemplateArguments->Profile(ID, getFunction()->getASTContext());
   }
 
   static void
@@ -858,6 +875,10 @@ protected:
 
   void loadLazySpecializationsImpl() const;
 
+  /// Load only those lazy specializations whose template arguments might
+  /// match \p Args.
+  void loadLazySpecializationsImpl(ArrayRef<TemplateArgument> Args) const;
+
   template <class EntryType, typename... ProfileArguments>
   typename SpecEntryTraits<EntryType>::DeclType*
   findSpecializationImpl(llvm::FoldingSetVector<EntryType> &Specs,
@@ -867,6 +888,24 @@ protected:
   void addSpecializationImpl(llvm::FoldingSetVector<EntryType> &Specs,
                              EntryType *Entry, void *InsertPos);
 
+  /// A specialization known only by its external declaration ID, along with
+  /// the ODR hash of its template arguments.
+  struct LazySpecializationInfo {
+    uint32_t DeclID = ~0U;
+    unsigned ODRHash = ~0U;
+
+    LazySpecializationInfo() = default;
+    LazySpecializationInfo(uint32_t ID, unsigned Hash = ~0U)
+        : DeclID(ID), ODRHash(Hash) {}
+
+    bool operator<(const LazySpecializationInfo &Other) const {
+      return DeclID < Other.DeclID;
+    }
+    bool operator==(const LazySpecializationInfo &Other) const {
+      return DeclID == Other.DeclID;
+    }
+  };
+
   struct CommonBase {
     CommonBase() : InstantiatedFromMember(nullptr, false) {}
 
@@ -881,9 +920,11 @@ protected:
     /// If non-null, points to an array of specializations (including
     /// partial specializations) known only by their external declaration IDs.
     ///
-    /// The first value in the array is the number of specializations/partial
-    /// specializations that follow.
-    uint32_t *LazySpecializations = nullptr;
+    /// The DeclID of the first value in the array is the number of
+    /// specializations/partial specializations that follow. Each entry also
+    /// carries the ODR hash of its template arguments, so that looking up a
+    /// single specialization need not deserialize all of them.
+    LazySpecializationInfo *LazySpecializations = nullptr;
   };
 
   /// Pointer to the common data shared by all declarations of this
@@ -2140,7 +2181,7 @@ public:
   SourceRange getSourceRange() const override LLVM_READONLY;
 
   void Profile(llvm::FoldingSetNodeID &ID) const {
-    Profile(ID, TemplateArgs->asArray(), getASTContext());
+    TemplateArgs->Profile(ID, getASTContext());
   }
 
   static void
@@ -3003,7 +3044,7 @@ public:
   }
 
   void Profile(llvm::FoldingSetNodeID &ID) const {
-    Profile(ID, TemplateArgs->asArray(), getASTContext());
+    TemplateArgs->Profile(ID, getASTContext());
   }
 
   static void Profile(llvm::FoldingSetNodeID &ID,
@@ -56,6 +56,7 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/iterator.h"
@@ -282,6 +283,14 @@ public:
   virtual bool dynMatches(const ast_type_traits::DynTypedNode &DynNode,
                           ASTMatchFinder *Finder,
                           BoundNodesTreeBuilder *Builder) const = 0;
+
+  /// Returns the names, as computed by \c getNodeName(), that a node must
+  /// have one of to be matched, or \c None if nodes with any name can match.
+  ///
+  /// Lets \c MatchFinder skip the matcher on nodes with other names.
+  virtual llvm::Optional<std::vector<std::string>> getRequiredNames() const {
+    return llvm::None;
+  }
 };
 
 /// Generic interface for matchers on an AST node of type T.
@@ -403,6 +412,13 @@ public:
   ///   binding. Otherwise, returns an empty \c Optional<>.
   llvm::Optional<DynTypedMatcher> tryBind(StringRef ID) const;
 
+  /// Returns the names that a node must have one of to be matched, or \c None
+  /// if nodes with any name can match. See
+  /// \c DynMatcherInterface::getRequiredNames().
+  llvm::Optional<std::vector<std::string>> getRequiredNames() const {
+    return Implementation->getRequiredNames();
+  }
+
   /// Returns a unique \p ID for the matcher.
   ///
   /// Casting a Matcher<T> to Matcher<U> creates a matcher that has the
@@ -707,6 +723,8 @@ class HasNameMatcher : public SingleNodeMatcherInterface<NamedDecl> {
 
   bool matchesNode(const NamedDecl &Node) const override;
 
+  llvm::Optional<std::vector<std::string>> getRequiredNames() const override;
+
  private:
   /// Unqualified match routine.
   ///
@@ -733,6 +751,10 @@ class HasNameMatcher : public SingleNodeMatcherInterface<NamedDecl> {
   const std::vector<std::string> Names;
 };
 
+/// Returns the unqualified name of \p Node that \c HasNameMatcher compares
+/// against the end of its patterns, using \p Scratch as storage if needed.
+StringRef getNodeName(const NamedDecl &Node, llvm::SmallString<128> &Scratch);
+
 /// Trampoline function to use VariadicFunction<> to construct a
 ///        HasNameMatcher.
 Matcher<NamedDecl> hasAnyNameFunc(ArrayRef<const StringRef *> NameRefs);
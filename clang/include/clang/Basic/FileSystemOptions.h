@@ -24,6 +24,10 @@ public:
   /// If set, paths are resolved as if the working directory was
   /// set to the value of WorkingDir.
   std::string WorkingDir;
+
+  /// If set, the file manager reads each directory that it looks up entries
+  /// in once, and answers the lookups of missing entries from the listing.
+  bool CacheDirectoryListings = false;
 };
 
 } // end namespace clang
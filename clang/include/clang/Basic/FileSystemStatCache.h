@@ -17,6 +17,7 @@
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/VirtualFileSystem.h"
@@ -83,6 +84,46 @@ public:
                           llvm::vfs::FileSystem &FS) override;
 };
 
+/// A stat cache that reads the contents of each directory it is asked about
+/// once, and uses the listing to answer the queries for entries that don't
+/// exist without going to the file system.
+///
+/// Header search probes every include path for each #include, so most of
+/// the stat calls it makes fail. With a long list of include paths, reading
+/// each directory once is much cheaper than these failed calls.
+///
+/// Queries for entries that do exist still go to the file system. The
+/// listing is only trusted to prove that an entry is missing, which assumes
+/// that the contents of the directories don't change during the compilation,
+/// and that the file system lists every entry it can stat.
+class DirectoryListingStatCache : public FileSystemStatCache {
+public:
+  std::error_code getStat(StringRef Path, llvm::vfs::Status &Status,
+                          bool isFile,
+                          std::unique_ptr<llvm::vfs::File> *F,
+                          llvm::vfs::FileSystem &FS) override;
+
+private:
+  struct DirectoryListing {
+    /// Whether the listing can be used to prove that an entry is missing.
+    bool IsComplete = false;
+    /// Whether the directory itself doesn't exist.
+    bool IsMissing = false;
+    /// The names of the entries in the directory, lowercased so that the
+    /// listing is also conservative on case-insensitive file systems.
+    llvm::StringSet<> Names;
+  };
+
+  /// Returns false if \p Path is known not to exist.
+  bool mayExist(StringRef Path, llvm::vfs::FileSystem &FS);
+
+  /// Returns the listing of \p Dir, reading it if it wasn't read yet, or
+  /// null if the directory can't be listed.
+  const DirectoryListing *getListing(StringRef Dir, llvm::vfs::FileSystem &FS);
+
+  llvm::StringMap<DirectoryListing, llvm::BumpPtrAllocator> Listings;
+};
+
 } // namespace clang
 
 #endif // LLVM_CLANG_BASIC_FILESYSTEMSTATCACHE_H
@@ -640,6 +640,22 @@ class SourceManager : public RefCountedBase<SourceManager> {
   /// expansion.
   SmallVector<SrcMgr::SLocEntry, 0> LocalSLocEntryTable;
 
+  /// The offsets of the entries of LocalSLocEntryTable.
+  ///
+  /// getFileIDLocal searches this dense copy instead of the entries themselves,
+  /// so that each probe touches fewer cache lines.
+  SmallVector<unsigned, 0> LocalSLocEntryOffsets;
+
+  /// The offset of the first entry of each block of LocalSLocIndexBlockSize
+  /// consecutive entries of LocalSLocEntryTable.
+  ///
+  /// This is the first level of the index searched by getFileIDLocal. It is
+  /// small enough to stay in cache, and narrows the search of
+  /// LocalSLocEntryOffsets down to a single block.
+  SmallVector<unsigned, 0> LocalSLocIndexBlocks;
+
+  static const unsigned LocalSLocIndexBlockSize = 64;
+
   /// The table of SLocEntries that are loaded from other modules.
   ///
   /// Negative FileIDs are indexes into this table. To get from ID to an index,
@@ -676,6 +692,13 @@ class SourceManager : public RefCountedBase<SourceManager> {
   /// is very common to look up many tokens from the same file.
   mutable FileID LastFileIDLookup;
 
+  /// A one-entry cache of the last macro expansion found by getFileIDSlow.
+  ///
+  /// Expansions are not recorded in LastFileIDLookup, so that looking up a
+  /// macro location does not lose the locality of a file, but decoding a
+  /// location usually looks up the same expansion several times.
+  mutable FileID LastExpansionIDLookup;
+
   /// Holds information for \#line directives.
   ///
   /// This is referenced by indices from SLocEntryTable.
@@ -1798,6 +1821,14 @@ private:
   const SrcMgr::ContentCache *
   createMemBufferContentCache(const llvm::MemoryBuffer *Buf, bool DoNotFree);
 
+  /// Append \p Entry to LocalSLocEntryTable and to its lookup index.
+  void addLocalSLocEntry(const SrcMgr::SLocEntry &Entry) {
+    if (LocalSLocEntryTable.size() % LocalSLocIndexBlockSize == 0)
+      LocalSLocIndexBlocks.push_back(Entry.getOffset());
+    LocalSLocEntryOffsets.push_back(Entry.getOffset());
+    LocalSLocEntryTable.push_back(Entry);
+  }
+
   FileID getFileIDSlow(unsigned SLocOffset) const;
   FileID getFileIDLocal(unsigned SLocOffset) const;
   FileID getFileIDLoaded(unsigned SLocOffset) const;
@@ -17,6 +17,7 @@
 #include "clang/AST/ASTImporterSharedState.h"
 #include "clang/Basic/LLVM.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Error.h"
@@ -89,6 +90,35 @@ parseCrossTUIndex(StringRef IndexPath, StringRef CrossTUDir);
 
 std::string createCrossTUIndexString(const llvm::StringMap<std::string> &Index);
 
+/// The effects of a function defined in another translation unit, which a
+/// client can apply at a call site instead of importing the definition.
+struct CallSummary {
+  /// Whether the function may write memory other than its own local
+  /// variables, or call other functions.
+  bool MayHaveSideEffects = true;
+  /// The integer constant the function returns on every path, if there is
+  /// one.
+  llvm::Optional<int64_t> ReturnValue;
+};
+
+/// Compute the summary of the definition \p FD.
+CallSummary computeCallSummary(const FunctionDecl *FD);
+
+/// This function parses a file with the summaries of the functions defined
+///        in other translation units.
+///
+/// The file format is the following:
+/// each line consists of an USR, whether the function may have side effects
+/// (0 or 1) and the integer it always returns or '-', separated by spaces.
+///
+/// \return Returns a map where the USR is the key and the summary is the value
+///         or an error.
+llvm::Expected<llvm::StringMap<CallSummary>>
+parseCallSummaries(StringRef SummaryPath);
+
+std::string
+createCallSummaryString(const llvm::StringMap<CallSummary> &Summaries);
+
 // Returns true if the variable or any field of a record variable is const.
 bool containsConst(const VarDecl *VD, const ASTContext &ACtx);
 
@@ -156,6 +186,17 @@ public:
   llvm::Expected<const FunctionDecl *> importDefinition(const FunctionDecl *FD);
   llvm::Expected<const VarDecl *> importDefinition(const VarDecl *VD);
 
+  /// This function looks up the summary of a function that has no definition
+  ///        in the current translation unit.
+  ///
+  /// The summary is looked up in the summary file called \p SummaryName in
+  /// the \p CrossTUDir directory, which is only read once.
+  ///
+  /// \return Returns the summary or an error if there is none.
+  llvm::Expected<CallSummary> getCallSummary(const FunctionDecl *FD,
+                                             StringRef CrossTUDir,
+                                             StringRef SummaryName);
+
   /// Get a name to identify a named decl.
   static std::string getLookupName(const NamedDecl *ND);
 
@@ -179,6 +220,7 @@ private:
   llvm::StringMap<std::unique_ptr<clang::ASTUnit>> FileASTUnitMap;
   llvm::StringMap<clang::ASTUnit *> NameASTUnitMap;
   llvm::StringMap<std::string> NameFileMap;
+  llvm::Optional<llvm::StringMap<CallSummary>> NameSummaryMap;
   llvm::DenseMap<TranslationUnitDecl *, std::unique_ptr<ASTImporter>>
       ASTUnitImporterMap;
   CompilerInstance &CI;
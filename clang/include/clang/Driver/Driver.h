@@ -231,6 +231,12 @@ public:
   /// or when using the -gen-reproducer driver flag.
   unsigned GenReproducer : 1;
 
+  /// Callback to the cc1 tools of this executable, taking the full command
+  /// line (starting with the executable and -cc1). If set, cc1 jobs are run
+  /// in-process instead of spawning a new process for each of them.
+  typedef int (*CC1ToolFunc)(SmallVectorImpl<const char *> &ArgV);
+  CC1ToolFunc CC1Main = nullptr;
+
 private:
   /// Certain options suppress the 'no input files' warning.
   unsigned SuppressMissingInputWarning : 1;
@@ -451,6 +451,13 @@ public:
   /// Filename to write statistics to.
   std::string StatsFile;
 
+  /// The minimum time, in microseconds, of the semantic analysis work
+  /// reported by -Rsema-cost.
+  unsigned SemaCostThreshold = 0;
+
+  /// Filename to record the work reported by -Rsema-cost to.
+  std::string SemaCostRecordFile;
+
 public:
   FrontendOptions()
       : DisableFree(false), RelocatablePCH(false), ShowHelp(false),
@@ -10,7 +10,10 @@
 #define LLVM_CLANG_INDEX_USRGENERATION_H
 
 #include "clang/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
 
 namespace clang {
 class ASTContext;
@@ -31,6 +34,28 @@ static inline StringRef getUSRSpacePrefix() {
 /// \returns true if the results should be ignored, false otherwise.
 bool generateUSRForDecl(const Decl *D, SmallVectorImpl<char> &Buf);
 
+/// Remembers the USRs generated for the declarations of an AST, for clients
+/// which need the USRs of the same declarations over and over.
+///
+/// USRs are cached per declaration rather than per canonical declaration: the
+/// USR of an entity with internal linkage depends on the location of the
+/// declaration it is generated from. The cache must not outlive the AST, and
+/// declarations should be complete (e.g. an anonymous struct should have its
+/// typedef name for linkage) when their USR is first requested.
+class USRCache {
+public:
+  /// Returns the USR of \p D, as generateUSRForDecl() would, or None if the
+  /// results should be ignored. The returned string lives as long as the cache.
+  llvm::Optional<StringRef> getUSRForDecl(const Decl *D);
+
+  void clear();
+
+private:
+  llvm::BumpPtrAllocator Alloc;
+  /// Empty for declarations whose USR should be ignored.
+  llvm::DenseMap<const Decl *, StringRef> USRs;
+};
+
 /// Generate a USR fragment for an Objective-C class.
 void generateUSRForObjCClass(StringRef Cls, raw_ostream &OS,
                              StringRef ExtSymbolDefinedIn = "",
@@ -0,0 +1,81 @@
+//===--- HeaderGuardCache.h - Include guards across runs --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the HeaderGuardCache interface.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LEX_HEADERGUARDCACHE_H
+#define LLVM_CLANG_LEX_HEADERGUARDCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <string>
+
+namespace clang {
+
+class FileEntry;
+
+/// A record of the headers that are fully wrapped in an include guard, which
+/// persists between compiler invocations.
+///
+/// The multiple-include optimization only learns the controlling macro of a
+/// header after lexing it once. This cache remembers what earlier
+/// compilations learned, so that a header whose controlling macro is already
+/// defined can be skipped before it is ever read.
+///
+/// Each entry maps the real path of a header to its controlling macro, along
+/// with the size and modification time of the file it was computed for. An
+/// entry is ignored once the file no longer matches, the same way the input
+/// files of AST files are validated.
+class HeaderGuardCache {
+public:
+  /// Read the cache from \p Path. A missing or malformed cache file yields
+  /// an empty cache.
+  explicit HeaderGuardCache(StringRef Path);
+
+  /// Returns the controlling macro that was recorded for \p File, or an
+  /// empty string if there is none or the file changed since.
+  StringRef getControllingMacro(const FileEntry *File) const;
+
+  /// Record that \p File is fully guarded by \p Macro.
+  void setControllingMacro(const FileEntry *File, StringRef Macro);
+
+  /// Write the entries that were recorded by this compilation back to the
+  /// cache file, merging them with the entries that other compilations wrote
+  /// in the meantime.
+  ///
+  /// \returns true if an error occurred.
+  bool write();
+
+private:
+  struct Entry {
+    uint64_t Size = 0;
+    int64_t ModTime = 0;
+    std::string Macro;
+    /// Whether this entry was recorded by this compilation.
+    bool IsNew = false;
+  };
+
+  static void read(StringRef Path, llvm::StringMap<Entry> &Entries);
+
+  /// The path of the cache file.
+  std::string Path;
+
+  /// The entries, keyed by the real path of the header.
+  llvm::StringMap<Entry> Entries;
+
+  /// Whether any entry was recorded by this compilation.
+  bool HasNewEntries = false;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_LEX_HEADERGUARDCACHE_H
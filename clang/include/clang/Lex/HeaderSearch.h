@@ -16,6 +16,7 @@
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Lex/DirectoryLookup.h"
+#include "clang/Lex/HeaderGuardCache.h"
 #include "clang/Lex/HeaderMap.h"
 #include "clang/Lex/ModuleMap.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -250,9 +251,15 @@ class HeaderSearch {
   /// Entity used to look up stored header file information.
   ExternalHeaderFileInfoSource *ExternalSource = nullptr;
 
+  /// The include guards that were recorded by earlier compilations, loaded
+  /// on first use if a cache file was specified.
+  std::unique_ptr<HeaderGuardCache> GuardCache;
+  bool GuardCacheLoaded = false;
+
   // Various statistics we track for performance analysis.
   unsigned NumIncluded = 0;
   unsigned NumMultiIncludeFileOptzn = 0;
+  unsigned NumGuardCacheOptzn = 0;
   unsigned NumFrameworkLookups = 0;
   unsigned NumSubFrameworkLookups = 0;
 
@@ -466,9 +473,15 @@ public:
   /// This is used by the multiple-include optimization to eliminate
   /// no-op \#includes.
   void SetFileControllingMacro(const FileEntry *File,
-                               const IdentifierInfo *ControllingMacro) {
-    getFileInfo(File).ControllingMacro = ControllingMacro;
-  }
+                               const IdentifierInfo *ControllingMacro);
+
+  /// Retrieve the include guards recorded by earlier compilations, or null
+  /// if no header guard cache was specified.
+  HeaderGuardCache *getHeaderGuardCache();
+
+  /// Write the include guards found by this compilation to the header guard
+  /// cache, if one was specified.
+  void writeHeaderGuardCache();
 
   /// Return true if this is the first time encountering this header.
   bool FirstTimeLexingFile(const FileEntry *File) {
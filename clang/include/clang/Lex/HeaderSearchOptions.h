@@ -113,6 +113,10 @@ public:
   /// The directory used for a user build.
   std::string ModuleUserBuildPath;
 
+  /// The file that records the include guards of headers between
+  /// compilations, see \c HeaderGuardCache.
+  std::string HeaderGuardCachePath;
+
   /// The mapping of module names to prebuilt module files.
   std::map<std::string, std::string> PrebuiltModuleFiles;
 
@@ -202,6 +206,17 @@ public:
 
   unsigned ModulesHashContent : 1;
 
+  /// Whether implicitly built module files are named after a hash of the
+  /// contents of their module map and headers instead of the location of
+  /// the module map. Module files found under such a name are not
+  /// revalidated against their input files.
+  unsigned ModulesContentAddressedCache : 1;
+
+  /// Whether module map files are only indexed when they are loaded, with
+  /// each top-level module declaration parsed the first time a module of
+  /// that name, or a header it names, is looked up.
+  unsigned LazyModuleMapParsing : 1;
+
   HeaderSearchOptions(StringRef _Sysroot = "/")
       : Sysroot(_Sysroot), ModuleFormat("raw"), DisableModuleHash(false),
         ImplicitModuleMaps(false), ModuleMapFileHomeIsCwd(false),
@@ -209,7 +224,8 @@ public:
         UseStandardCXXIncludes(true), UseLibcxx(false), Verbose(false),
         ModulesValidateOncePerBuildSession(false),
         ModulesValidateSystemHeaders(false), UseDebugInfo(false),
-        ModulesValidateDiagnosticOptions(true), ModulesHashContent(false) {}
+        ModulesValidateDiagnosticOptions(true), ModulesHashContent(false),
+        ModulesContentAddressedCache(false), LazyModuleMapParsing(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
@@ -31,6 +31,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace clang {
 
@@ -274,6 +275,60 @@ private:
   /// map.
   llvm::DenseMap<const FileEntry *, bool> ParsedModuleMap;
 
+  /// A top-level module declaration which was indexed when its module map
+  /// file was loaded, but is only parsed once it is needed.
+  struct LazyModuleDecl {
+    const FileEntry *ModuleMapFile;
+    const DirectoryEntry *Directory;
+    FileID ID;
+
+    /// The first component of the module name, for declarations which aren't
+    /// parsed eagerly.
+    std::string Name;
+
+    /// The offset of the declaration within the module map file.
+    unsigned Offset;
+
+    /// The module declaration scope the module map file was loaded in.
+    unsigned ScopeID;
+
+    bool IsSystem;
+    bool Parsed;
+  };
+
+  /// The lazily parsed module declarations, in the order they were indexed.
+  mutable std::vector<LazyModuleDecl> LazyModuleDecls;
+
+  /// Map from top-level module names to the lazy declarations of those
+  /// modules.
+  mutable llvm::StringMap<SmallVector<unsigned, 1>> LazyModuleDeclsByName;
+
+  /// Map from header file names to the lazy declarations naming them.
+  mutable llvm::StringMap<SmallVector<unsigned, 1>> LazyModuleDeclsByHeader;
+
+  /// The lazy declarations with an umbrella header or directory, which can
+  /// cover any header.
+  mutable SmallVector<unsigned, 4> LazyUmbrellaModuleDecls;
+
+  /// Index the top-level module declarations of the given module map file
+  /// for lazy parsing.
+  ///
+  /// \returns false if the file could not be indexed and must be parsed
+  /// in full, otherwise true and \p HadError tells whether an error occurred.
+  bool parseModuleMapFileLazily(const FileEntry *File, bool IsSystem,
+                                const DirectoryEntry *Dir, FileID ID,
+                                bool &HadError);
+
+  /// Parse the given lazy module declarations, skipping those that have
+  /// already been parsed.
+  ///
+  /// \returns true if an error occurred, false otherwise.
+  bool parseLazyModuleDecls(ArrayRef<unsigned> Indices) const;
+
+  /// Parse all lazy declarations of the top-level module with the given
+  /// name, in order.
+  void parseLazyModuleDecls(StringRef Name) const;
+
   /// Resolve the given export declaration into an actual export
   /// declaration.
   ///
@@ -445,6 +500,10 @@ public:
   /// Resolve all lazy header directives for the specified module.
   void resolveHeaderDirectives(Module *Mod) const;
 
+  /// Parse all module declarations that were deferred by lazy module map
+  /// parsing, so that every module in the loaded module map files is known.
+  void resolveLazyModuleDecls() const;
+
   /// Reports errors if a module must not include a specific file.
   ///
   /// \param RequestingModule The module including a file.
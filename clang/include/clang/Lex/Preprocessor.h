@@ -28,6 +28,7 @@
 #include "clang/Lex/ModuleLoader.h"
 #include "clang/Lex/ModuleMap.h"
 #include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/PreprocessorExcludedConditionalDirectiveSkipMapping.h"
 #include "clang/Lex/Token.h"
 #include "clang/Lex/TokenLexer.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -476,6 +477,11 @@ private:
     State ConditionalStackState = Off;
   } PreambleConditionalStack;
 
+  /// The skipped range mappings that let the preprocessor jump over excluded
+  /// conditional directive blocks without lexing them, or null.
+  ExcludedPreprocessorDirectiveSkipMapping
+      *ExcludedConditionalDirectiveSkipMappings;
+
   /// The current top of the stack that we're lexing from if
   /// not expanding a macro and we are lexing directly from source code.
   ///
@@ -1011,6 +1017,8 @@ public:
     return isMacroDefined(&Identifiers.get(Id));
   }
   bool isMacroDefined(const IdentifierInfo *II) {
+    if (II->isOutOfDate())
+      updateOutOfDateIdentifier(const_cast<IdentifierInfo&>(*II));
     return II->hasMacroDefinition() &&
            (!getLangOpts().Modules || (bool)getMacroDefinition(II));
   }
@@ -1032,6 +1040,8 @@ public:
   }
 
   MacroDefinition getMacroDefinition(const IdentifierInfo *II) {
+    if (II->isOutOfDate())
+      updateOutOfDateIdentifier(const_cast<IdentifierInfo&>(*II));
     if (!II->hasMacroDefinition())
       return {};
 
@@ -1046,6 +1056,8 @@ public:
 
   MacroDefinition getMacroDefinitionAtLoc(const IdentifierInfo *II,
                                           SourceLocation Loc) {
+    if (II->isOutOfDate())
+      updateOutOfDateIdentifier(const_cast<IdentifierInfo&>(*II));
     if (!II->hadMacroDefinition())
       return {};
 
@@ -1062,6 +1074,8 @@ public:
   /// Given an identifier, return its latest non-imported MacroDirective
   /// if it is \#define'd and not \#undef'd, or null if it isn't \#define'd.
   MacroDirective *getLocalMacroDirective(const IdentifierInfo *II) const {
+    if (II->isOutOfDate())
+      updateOutOfDateIdentifier(const_cast<IdentifierInfo&>(*II));
     if (!II->hasMacroDefinition())
       return nullptr;
 
@@ -1077,6 +1091,8 @@ public:
   }
 
   MacroInfo *getMacroInfo(const IdentifierInfo *II) {
+    if (II->isOutOfDate())
+      updateOutOfDateIdentifier(const_cast<IdentifierInfo&>(*II));
     if (!II->hasMacroDefinition())
       return nullptr;
     if (auto MD = getMacroDefinition(II))
@@ -2062,6 +2078,14 @@ private:
                                     bool FoundNonSkipPortion, bool FoundElse,
                                     SourceLocation ElseLoc = SourceLocation());
 
+  /// Compute the number of bytes that the current lexer can skip over
+  /// to reach the directive that ends the excluded conditional block whose
+  /// directive starts at \p HashLoc.
+  ///
+  /// \returns None when the block has no entry in the skipped range mappings.
+  Optional<unsigned>
+  getSkippedRangeForExcludedConditionalBlock(SourceLocation HashLoc);
+
   /// Information about the result for evaluating an expression for a
   /// preprocessor directive.
   struct DirectiveEvalResult {
@@ -13,6 +13,7 @@
 #define LLVM_CLANG_SEMA_EXTERNALSEMASOURCE_H
 
 #include "clang/AST/ExternalASTSource.h"
+#include "clang/AST/TemplateBase.h"
 #include "clang/AST/Type.h"
 #include "clang/Sema/TypoCorrection.h"
 #include "clang/Sema/Weak.h"
@@ -46,6 +47,14 @@ struct ExternalVTableUse {
   bool DefinitionRequired;
 };
 
+/// A constraint satisfaction check, identified by the entity owning the
+/// constraints and the non-dependent template arguments they were checked
+/// against, which the \c ExternalSemaSource knows to be satisfied.
+struct ExternalSatisfiedConstraint {
+  NamedDecl *ConstraintOwner;
+  SmallVector<TemplateArgument, 4> TemplateArgs;
+};
+
 /// An abstract interface that should be implemented by
 /// external AST sources that also provide information for semantic
 /// analysis.
@@ -135,6 +144,16 @@ public:
   /// introduce the same declarations repeatedly.
   virtual void ReadExtVectorDecls(SmallVectorImpl<TypedefNameDecl *> &Decls) {}
 
+  /// Read the set of constraint satisfaction checks that the external Sema
+  /// source found to be satisfied.
+  ///
+  /// The external source should append its own satisfied constraints to the
+  /// given vector. Note that this routine may be invoked multiple times; the
+  /// external source should take care not to introduce the same constraints
+  /// repeatedly.
+  virtual void ReadSatisfiedConstraints(
+                 SmallVectorImpl<ExternalSatisfiedConstraint> &Constraints) {}
+
   /// Read the set of potentially unused typedefs known to the source.
   ///
   /// The external source should append its own potentially unused local
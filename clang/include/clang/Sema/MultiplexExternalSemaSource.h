@@ -274,6 +274,16 @@ public:
   /// introduce the same declarations repeatedly.
   void ReadExtVectorDecls(SmallVectorImpl<TypedefNameDecl*> &Decls) override;
 
+  /// Read the set of constraint satisfaction checks that the external Sema
+  /// source found to be satisfied.
+  ///
+  /// The external source should append its own satisfied constraints to the
+  /// given vector. Note that this routine may be invoked multiple times; the
+  /// external source should take care not to introduce the same constraints
+  /// repeatedly.
+  void ReadSatisfiedConstraints(
+      SmallVectorImpl<ExternalSatisfiedConstraint> &Constraints) override;
+
   /// Read the set of potentially unused typedefs known to the source.
   ///
   /// The external source should append its own potentially unused local
@@ -787,6 +787,11 @@ class Sema;
     /// True if the candidate was found using ADL.
     CallExpr::ADLCallKind IsADLCandidate : 1;
 
+    /// True if this is a function template candidate that was rejected before
+    /// template argument deduction was performed; its DeductionFailure is
+    /// only computed when the candidate is diagnosed.
+    bool DeductionDeferred : 1;
+
     /// FailureKind - The reason why this candidate is not viable.
     /// Actually an OverloadFailureKind.
     unsigned char FailureKind;
@@ -842,7 +847,8 @@ class Sema;
 
   private:
     friend class OverloadCandidateSet;
-    OverloadCandidate() : IsADLCandidate(CallExpr::NotADL) {}
+    OverloadCandidate()
+        : IsADLCandidate(CallExpr::NotADL), DeductionDeferred(false) {}
   };
 
   /// OverloadCandidateSet - A set of overload candidates, used in C++
@@ -875,8 +881,9 @@ class Sema;
     SmallVector<OverloadCandidate, 16> Candidates;
     llvm::SmallPtrSet<Decl *, 16> Functions;
 
-    // Allocator for ConversionSequenceLists. We store the first few of these
-    // inline to avoid allocation for small sets.
+    // Allocator for ConversionSequenceLists and for the details of failed
+    // template argument deductions. We store the first few conversion
+    // sequences inline to avoid allocation for small sets.
     llvm::BumpPtrAllocator SlabAllocator;
 
     SourceLocation Loc;
@@ -928,6 +935,10 @@ class Sema;
     SourceLocation getLocation() const { return Loc; }
     CandidateSetKind getKind() const { return Kind; }
 
+    /// Retrieve the allocator for data that lives as long as the candidates
+    /// in this set. It is released when the set is cleared or destroyed.
+    llvm::BumpPtrAllocator &getAllocator() { return SlabAllocator; }
+
     /// Determine when this overload candidate will be new to the
     /// overload set.
     bool isNewCandidate(Decl *F) {
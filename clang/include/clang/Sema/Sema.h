@@ -167,6 +167,7 @@ namespace clang {
   class PseudoDestructorTypeStorage;
   class PseudoObjectExpr;
   class QualType;
+  class SemaCostRemarks;
   class StandardConversionSequence;
   class Stmt;
   class StringLiteral;
@@ -1150,6 +1151,18 @@ public:
   /// attribute.
   mutable llvm::DenseMap<const EnumDecl*, llvm::APInt> FlagBitsCache;
 
+  /// The parameters of a function template from which template argument
+  /// deduction can only succeed for an argument of class type, paired with the
+  /// class template the argument type (or one of its bases) must specialize.
+  typedef SmallVector<std::pair<unsigned, ClassTemplateDecl *>, 2>
+      TemplateIdParamList;
+
+  /// A cache of the template-id parameters of function templates, used to
+  /// reject function template overload candidates without performing template
+  /// argument deduction.
+  llvm::DenseMap<const FunctionTemplateDecl *, TemplateIdParamList>
+      TemplateIdParamCache;
+
   /// The kind of translation unit we are processing.
   ///
   /// When we're processing a complete translation unit, Sema will perform
@@ -1164,6 +1177,37 @@ public:
   /// The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// The number of atomic constraints whose satisfaction was evaluated.
+  unsigned NumAtomicConstraintsEvaluated;
+
+  /// The number of atomic constraints that did not need to be evaluated
+  /// because of a short-circuiting conjunction or disjunction.
+  unsigned NumAtomicConstraintsSkipped;
+
+  /// The number of constraint satisfaction checks answered by
+  /// SatisfactionCache.
+  unsigned NumSatisfactionCacheHits;
+
+  /// The number of standard library concept checks decided directly from
+  /// their template arguments, without substitution.
+  unsigned NumStandardConceptsDecidedDirectly;
+
+  /// The number of requires-expression requirements whose substitution was
+  /// answered by RequirementSubstitutionCache.
+  unsigned NumRequirementSubstitutionCacheHits;
+
+  /// The number of function template overload candidates that were rejected
+  /// without performing template argument deduction.
+  unsigned NumTemplateCandidatesRejectedEarly;
+
+  /// The number of instantiated function declarations whose trailing
+  /// requires-clause was kept unsubstituted, to be checked only on use.
+  unsigned NumDeferredTrailingRequiresClauses;
+
+  /// The number of constraint checks of instantiated member functions of
+  /// class templates, which substitute into their deferred constraints.
+  unsigned NumMemberConstraintChecks;
+
   typedef llvm::DenseMap<ParmVarDecl *, llvm::TinyPtrVector<ParmVarDecl *>>
     UnparsedDefaultArgInstantiationsMap;
 
@@ -5963,15 +6007,50 @@ public:
   /// caused the problem.
   bool CheckConstraintExpression(Expr *CE, Expr **Culprit = nullptr);
 
+  /// \brief A requirement of a requires-expression after substitution,
+  /// identified by the original requirement and the template arguments it
+  /// references.
+  class SubstitutedRequirement : public llvm::FastFoldingSetNode {
+    Requirement *Req;
+
+  public:
+    SubstitutedRequirement(const llvm::FoldingSetNodeID &ID,
+                           Requirement *Req)
+        : FastFoldingSetNode(ID), Req(Req) {}
+
+    Requirement *getRequirement() const { return Req; }
+  };
+
+  /// \brief Caches the non-dependent results of substituting into
+  /// requirements of requires-expressions, so that the same requirement is
+  /// not substituted again for another owner with the same arguments.
+  llvm::FoldingSet<SubstitutedRequirement> RequirementSubstitutionCache;
+
 private:
   /// \brief Caches pairs of template-like decls whose associated constraints
   /// were checked for subsumption and whether or not the first's constraints
   /// did in fact subsume the second's.
   llvm::DenseMap<std::pair<NamedDecl *, NamedDecl *>, bool> SubsumptionCache;
 
+  /// \brief Caches the normalized associated constraints of declarations
+  /// (concepts or constrained declarations). If an error occurred while
+  /// normalizing the associated constraints of the template or concept,
+  /// nullptr will be cached here.
+  llvm::DenseMap<NamedDecl *, NormalizedConstraint *> NormalizationCache;
+
+  /// \brief Caches the disjunctive and conjunctive normal forms of normalized
+  /// constraints held in NormalizationCache, so that subsumption checks
+  /// involving the same constraints do not convert them over and over again.
+  llvm::DenseMap<const NormalizedConstraint *, std::unique_ptr<NormalForm>>
+      DNFCache, CNFCache;
+
   llvm::ContextualFoldingSet<ConstraintSatisfaction, const ASTContext &>
       SatisfactionCache;
 
+  /// \brief Add the constraint satisfaction checks the external source knows
+  /// to be satisfied to SatisfactionCache.
+  void LoadExternalSatisfiedConstraints();
+
 public:
   /// \brief Returns whether the given declaration's associated constraints are
   /// more constrained than another declaration's according to the partial
@@ -6014,12 +6093,15 @@ public:
   /// \param Satisfaction if true is returned, will contain details of the
   /// satisfaction, with enough information to diagnose an unsatisfied
   /// expression.
+  /// \param Probe whether only the verdict is needed, in which case no
+  /// details are recorded in \p Satisfaction and it cannot be diagnosed.
   /// \returns true if an error occurred and satisfaction could not be checked,
   /// false otherwise.
   bool CheckConstraintSatisfaction(NamedDecl *ConstraintOwner,
       NamedDecl *Template, ArrayRef<const Expr *> ConstraintExprs,
       const MultiLevelTemplateArgumentList &TemplateArgs,
-      SourceRange TemplateIDRange, ConstraintSatisfaction &Satisfaction);
+      SourceRange TemplateIDRange, ConstraintSatisfaction &Satisfaction,
+      bool Probe = false);
 
   bool CheckConstraintSatisfaction(NestedRequirement *Req,
       const Expr *ConstraintExpr,
@@ -6061,10 +6143,31 @@ public:
   /// VarTemplatePartialSpecializationDecl).
   ///
   /// \returns The NormalizedConstraint representing the associated constraints
-  /// of the given template, or an empty optional if an error occured.
-  llvm::Optional<NormalizedConstraint>
+  /// of the given template, or nullptr if an error occured. The result is
+  /// cached and allocated in the ASTContext.
+  const NormalizedConstraint *
   getNormalizedAssociatedConstraints(NamedDecl *Template);
 
+  /// \brief Get the normal form [temp.constr.normal] of the given associated
+  /// constraints of \p ConstrainedDecl (a concept or a constrained
+  /// declaration), normalizing them only the first time they are requested.
+  ///
+  /// \returns The cached NormalizedConstraint, or nullptr if an error occured
+  /// during normalization.
+  const NormalizedConstraint *
+  getNormalizedAssociatedConstraints(NamedDecl *ConstrainedDecl,
+      ArrayRef<const Expr *> AssociatedConstraints);
+
+  /// \brief Get the disjunctive normal form of a normalized constraint
+  /// obtained from getNormalizedAssociatedConstraints, computing it only the
+  /// first time it is requested.
+  const NormalForm &getDisjunctiveNormalForm(const NormalizedConstraint *N);
+
+  /// \brief Get the conjunctive normal form of a normalized constraint
+  /// obtained from getNormalizedAssociatedConstraints, computing it only the
+  /// first time it is requested.
+  const NormalForm &getConjunctiveNormalForm(const NormalizedConstraint *N);
+
   /// \brief Emit diagnostics explaining why a constraint expression was deemed
   /// unsatisfied.
   /// \param First whether this is the first time an unsatisfied constraint is
@@ -7876,6 +7979,10 @@ public:
   std::vector<std::unique_ptr<TemplateInstantiationCallback>>
       TemplateInstCallbacks;
 
+  /// The template instantiation callback that reports expensive semantic
+  /// analysis work for -Rsema-cost, if any. Owned by TemplateInstCallbacks.
+  SemaCostRemarks *CostRemarks = nullptr;
+
   /// The current index into pack expansion arguments that will be
   /// used for substitution of parameter packs.
   ///
@@ -8475,8 +8582,11 @@ public:
 
   void InstantiateExceptionSpec(SourceLocation PointOfInstantiation,
                                 FunctionDecl *Function);
+  /// Check the associated constraints of the given function declaration. If
+  /// \p Probe is true, only the verdict is needed and the unsatisfied
+  /// constraints will not be diagnosed from \p Satisfaction.
   bool CheckFunctionConstraints(FunctionDecl *Decl,
-      ConstraintSatisfaction &Satisfaction);
+      ConstraintSatisfaction &Satisfaction, bool Probe = false);
   FunctionDecl *InstantiateFunctionDeclaration(FunctionTemplateDecl *FTD,
                                                const TemplateArgumentList *Args,
                                                SourceLocation Loc);
@@ -11595,8 +11705,13 @@ public:
   }
 };
 
+/// Convert from Sema's representation of template deduction information
+/// to the form used in overload-candidate information. Any storage this
+/// needs is taken from \p Allocator, which should be owned by the candidate
+/// set the result is stored in, so that it is released along with it.
 DeductionFailureInfo
-MakeDeductionFailureInfo(ASTContext &Context, Sema::TemplateDeductionResult TDK,
+MakeDeductionFailureInfo(llvm::BumpPtrAllocator &Allocator,
+                         Sema::TemplateDeductionResult TDK,
                          sema::TemplateDeductionInfo &Info);
 
 /// Contains a late templated function.
@@ -16,6 +16,7 @@
 #ifndef LLVM_CLANG_SEMA_SEMACONCEPTS_H
 #define LLVM_CLANG_SEMA_SEMACONCEPTS_H
 #include "clang/AST/ASTConcept.h"
+#include "clang/AST/ASTContext.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/Basic/SourceLocation.h"
@@ -34,7 +35,8 @@ class ConstraintSatisfaction : public llvm::FoldingSetNode {
   // The template-like entity that 'owns' the constraint checked here (can be a
   // constrained entity or a concept).
   NamedDecl *ConstraintOwner = nullptr;
-  llvm::SmallVector<TemplateArgument, 4> TemplateArgs;
+  /// The template arguments, uniqued by the ASTContext where possible.
+  const TemplateArgumentList *TemplateArgs = nullptr;
 
 public:
 
@@ -42,13 +44,24 @@ public:
 
   ConstraintSatisfaction(ConstraintSatisfaction &Other);
 
-  ConstraintSatisfaction(NamedDecl *ConstraintOwner,
+  ConstraintSatisfaction(const ASTContext &C, NamedDecl *ConstraintOwner,
                          ArrayRef<TemplateArgument> TemplateArgs) :
-      ConstraintOwner(ConstraintOwner), TemplateArgs(TemplateArgs.begin(),
-                                                     TemplateArgs.end()) { }
+      ConstraintOwner(ConstraintOwner),
+      TemplateArgs(C.getUniquedTemplateArgumentList(TemplateArgs)) { }
 
   bool IsSatisfied = false;
 
+  /// \brief Whether this satisfaction was checked only to obtain a verdict
+  /// ("probe" mode), in which case Details were not recorded. An unsatisfied
+  /// probe result must be checked again before it can be diagnosed.
+  bool IsProbe = false;
+
+  NamedDecl *getConstraintOwner() const { return ConstraintOwner; }
+
+  ArrayRef<TemplateArgument> getTemplateArgs() const {
+    return TemplateArgs ? TemplateArgs->asArray() : None;
+  }
+
   /// \brief Pairs of unsatisfied atomic constraint expressions along with the
   /// substituted constraint expr, if the template arguments could be
   /// substituted into them, or a diagnostic if substitution resulted in an
@@ -56,7 +69,8 @@ public:
   llvm::SmallVector<UnsatisfiedConstraintRecord, 4> Details;
 
   void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C) {
-    Profile(ID, C, ConstraintOwner, TemplateArgs);
+    ID.AddPointer(ConstraintOwner->getCanonicalDecl());
+    TemplateArgs->Profile(ID, C);
   }
 
   static void Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C,
@@ -165,6 +179,11 @@ struct NormalizedConstraint {
       const MultiLevelTemplateArgumentList &ParameterMapping);
 };
 
+/// \brief A normalized constraint in disjunctive or conjunctive normal form -
+/// a list of clauses, each a list of atomic constraints.
+using NormalForm =
+    llvm::SmallVector<llvm::SmallVector<AtomicConstraint *, 2>, 4>;
+
 /// \brief A static requirement that can be used in a requires-expression to
 /// check properties of types and expression.
 class Requirement {
@@ -0,0 +1,101 @@
+//===--- SemaCostRemarks.h - Remarks for expensive Sema work ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines SemaCostRemarks, which reports the template
+// instantiations, constraint satisfaction checks and overload resolutions
+// that take longer than a threshold.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SEMA_SEMACOSTREMARKS_H
+#define LLVM_CLANG_SEMA_SEMACOSTREMARKS_H
+
+#include "clang/AST/DeclarationName.h"
+#include "clang/Basic/LLVM.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Sema/TemplateInstCallback.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include <chrono>
+#include <memory>
+
+namespace llvm {
+class ToolOutputFile;
+namespace remarks {
+struct Serializer;
+} // namespace remarks
+} // namespace llvm
+
+namespace clang {
+
+/// Reports semantic analysis work that takes at least a threshold time, as
+/// -Rsema-cost remarks and, if a record file is given, as YAML remarks that
+/// can be aggregated across compilations.
+///
+/// Times are inclusive: the time of an instantiation includes the time of the
+/// instantiations and overload resolutions it triggers.
+class SemaCostRemarks : public TemplateInstantiationCallback {
+public:
+  /// The kinds of reported work, in the order of remark_sema_cost.
+  enum WorkKind {
+    WK_Instantiation,
+    WK_Deduction,
+    WK_ConstraintsCheck,
+    WK_OverloadResolution
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  /// Measures the overload resolution for a call to a function or operator,
+  /// from its construction to its destruction.
+  class OverloadResolutionScope {
+  public:
+    OverloadResolutionScope(Sema &S, SourceLocation Loc, DeclarationName Name);
+    ~OverloadResolutionScope();
+
+  private:
+    Sema &S;
+    SourceLocation Loc;
+    DeclarationName Name;
+    Clock::time_point Start;
+  };
+
+  /// \param ThresholdMicros The minimum time of the reported work.
+  /// \param EmitRemarks Whether to emit -Rsema-cost remarks.
+  /// \param RecordFile If not null, the file to serialize the reports to.
+  SemaCostRemarks(unsigned ThresholdMicros, bool EmitRemarks,
+                  std::unique_ptr<llvm::ToolOutputFile> RecordFile);
+  ~SemaCostRemarks() override;
+
+  void initialize(const Sema &S) override {}
+  void finalize(const Sema &S) override;
+  void atTemplateBegin(const Sema &S,
+                       const Sema::CodeSynthesisContext &Inst) override;
+  void atTemplateEnd(const Sema &S,
+                     const Sema::CodeSynthesisContext &Inst) override;
+
+  /// Report the work of kind \p Kind at \p Loc that began at \p Start, if it
+  /// took at least the threshold time. \p PrintEntity prints the entity the
+  /// work was done for.
+  void report(const Sema &S, WorkKind Kind, SourceLocation Loc,
+              llvm::function_ref<void(raw_ostream &)> PrintEntity,
+              Clock::time_point Start);
+
+private:
+  unsigned ThresholdMicros;
+  bool EmitRemarks;
+  std::unique_ptr<llvm::ToolOutputFile> RecordFile;
+  std::unique_ptr<llvm::remarks::Serializer> Serializer;
+
+  /// The start times of the active code synthesis contexts.
+  SmallVector<Clock::time_point, 16> Starts;
+};
+
+} // namespace clang
+
+#endif
@@ -24,6 +24,7 @@
 #include "clang/Basic/SourceLocation.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Allocator.h"
 #include <cassert>
 #include <cstddef>
 #include <utility>
@@ -310,6 +311,9 @@ class TemplateSpecCandidateSet {
   SmallVector<TemplateSpecCandidate, 16> Candidates;
   SourceLocation Loc;
 
+  // Allocator for the details of failed template argument deductions.
+  llvm::BumpPtrAllocator Allocator;
+
   // Stores whether we're taking the address of these candidates. This helps us
   // produce better error messages when dealing with the pass_object_size
   // attribute on parameters.
@@ -327,6 +331,10 @@ public:
 
   SourceLocation getLocation() const { return Loc; }
 
+  /// Retrieve the allocator for data that lives as long as the candidates
+  /// in this set. It is released when the set is cleared or destroyed.
+  llvm::BumpPtrAllocator &getAllocator() { return Allocator; }
+
   /// Clear out all of the candidates.
   /// TODO: This may be unnecessary.
   void clear();
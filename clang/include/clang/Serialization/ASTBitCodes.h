@@ -647,7 +647,11 @@ namespace serialization {
       PP_CONDITIONAL_STACK = 62,
 
       /// A table of skipped ranges within the preprocessing record.
-      PPD_SKIPPED_RANGES = 63
+      PPD_SKIPPED_RANGES = 63,
+
+      /// Record code for the constraint satisfaction checks that were found
+      /// to be satisfied for non-dependent template arguments.
+      SATISFIED_CONSTRAINTS = 64
     };
 
     /// Record types used within a source manager block.
@@ -743,6 +743,19 @@ private:
   /// IDs have not yet been deserialized to the global IDs of those macros.
   PendingMacroIDsMap PendingMacroIDs;
 
+  /// Macro histories from precompiled headers whose resolution has been
+  /// deferred until the preprocessor first asks about the identifier.
+  ///
+  /// Identifiers in this map are marked out of date, so the preprocessor
+  /// calls updateOutOfDateIdentifier() before consulting their macro state.
+  /// Macros that are never looked at are then never deserialized.
+  llvm::DenseMap<IdentifierInfo *, SmallVector<PendingMacroInfo, 2>>
+      LazyMacroHistories;
+
+  /// Whether macro histories must be resolved as soon as they are read,
+  /// because the preprocessor has enumerated all of the macros.
+  bool ResolveAllMacroHistories = false;
+
   using GlobalPreprocessedEntityMapType =
       ContinuousRangeMap<unsigned, ModuleFile *, 4>;
 
@@ -897,6 +910,11 @@ private:
   // A list of late parsed template function data.
   SmallVector<uint64_t, 1> LateParsedTemplates;
 
+  /// The SATISFIED_CONSTRAINTS records of each module file that have not yet
+  /// been handed to Sema. Their template arguments are only deserialized
+  /// when Sema first looks up a constraint satisfaction.
+  SmallVector<std::pair<ModuleFile *, RecordData>, 1> SatisfiedConstraints;
+
 public:
   struct ImportedSubmodule {
     serialization::SubmoduleID ID;
@@ -970,6 +988,12 @@ private:
   /// The total number of macros stored in the chain.
   unsigned TotalNumMacros = 0;
 
+  /// The number of macro histories whose resolution was deferred.
+  unsigned NumLazyMacroHistories = 0;
+
+  /// The number of deferred macro histories that were later resolved.
+  unsigned NumLazyMacroHistoriesResolved = 0;
+
   /// The number of lookups into identifier tables.
   unsigned NumIdentifierLookups = 0;
 
@@ -2006,6 +2030,9 @@ public:
 
   void ReadExtVectorDecls(SmallVectorImpl<TypedefNameDecl *> &Decls) override;
 
+  void ReadSatisfiedConstraints(
+      SmallVectorImpl<ExternalSatisfiedConstraint> &Constraints) override;
+
   void ReadUnusedLocalTypedefNameCandidates(
       llvm::SmallSetVector<const TypedefNameDecl *, 4> &Decls) override;
 
@@ -2060,6 +2087,11 @@ public:
 
   void resolvePendingMacro(IdentifierInfo *II, const PendingMacroInfo &PMInfo);
 
+  /// Resolve the deferred macro history of the given identifier, if any.
+  ///
+  /// \returns true if the identifier had a deferred macro history.
+  bool resolveLazyMacroHistory(IdentifierInfo &II);
+
   /// Retrieve the macro with the given ID.
   MacroInfo *getMacro(serialization::MacroID ID);
 
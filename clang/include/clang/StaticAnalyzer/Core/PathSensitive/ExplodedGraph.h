@@ -290,6 +290,10 @@ protected:
   /// A list of recently allocated nodes that can potentially be recycled.
   NodeVector ChangedNodes;
 
+  /// The number of nodes at the front of ChangedNodes that are carried over
+  /// from the previous reclamation, because they had no successor yet then.
+  unsigned NumCarriedOverNodes = 0;
+
   /// A list of nodes that can be reused.
   NodeVector FreeNodes;
 
@@ -748,6 +748,11 @@ private:
   void conservativeEvalCall(const CallEvent &Call, NodeBuilder &Bldr,
                             ExplodedNode *Pred, ProgramStateRef State);
 
+  /// Evaluate a call to a function defined in another translation unit by
+  /// applying its CTU summary. Returns false if there is no summary.
+  bool evalCallWithCTUSummary(const CallEvent &Call, NodeBuilder &Bldr,
+                              ExplodedNode *Pred, ProgramStateRef State);
+
   /// Either inline or process the call conservatively (or both), based
   /// on DynamicDispatchBifurcation data.
   void BifurcateCall(const MemRegion *BifurReg,
@@ -16,6 +16,8 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramState.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramStateTrait.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/SimpleConstraintManager.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
 
 namespace clang {
 
@@ -45,68 +47,88 @@ public:
   }
 };
 
-class RangeTrait : public llvm::ImutContainerInfo<Range> {
-public:
-  // When comparing if one Range is less than another, we should compare
-  // the actual APSInt values instead of their pointers.  This keeps the order
-  // consistent (instead of comparing by pointer values) and can potentially
-  // be used to speed up some of the operations in RangeSet.
-  static inline bool isLess(key_type_ref lhs, key_type_ref rhs) {
-    return *lhs.first < *rhs.first ||
-           (!(*rhs.first < *lhs.first) && *lhs.second < *rhs.second);
-  }
-};
-
 /// RangeSet contains a set of ranges. If the set is empty, then
 ///  there the value of a symbol is overly constrained and there are no
 ///  possible values for that symbol.
+///
+/// The ranges are kept sorted and pairwise disjoint in an array owned by the
+/// RangeSet::Factory. The factory uniques these arrays, so that equal sets
+/// share their storage and can be copied, compared and profiled by pointer.
 class RangeSet {
-  typedef llvm::ImmutableSet<Range, RangeTrait> PrimRangeSet;
-  PrimRangeSet ranges; // no need to make const, since it is an
-                       // ImmutableSet - this allows default operator=
-                       // to work.
+  /// The uniqued array of ranges of a non-empty set.
+  class Storage : public llvm::FoldingSetNode {
+    const Range *Begin;
+    unsigned Size;
+
+  public:
+    Storage(const Range *Begin, unsigned Size) : Begin(Begin), Size(Size) {}
+
+    ArrayRef<Range> getRanges() const { return {Begin, Size}; }
+
+    void Profile(llvm::FoldingSetNodeID &ID) const {
+      Profile(ID, getRanges());
+    }
+    static void Profile(llvm::FoldingSetNodeID &ID, ArrayRef<Range> Ranges) {
+      for (const Range &R : Ranges)
+        R.Profile(ID);
+    }
+  };
+
+  /// The ranges of the set, or null if the set is empty.
+  const Storage *Ranges;
+
+  RangeSet(const Storage *S) : Ranges(S) {}
+
 public:
-  typedef PrimRangeSet::Factory Factory;
-  typedef PrimRangeSet::iterator iterator;
+  /// Creates and uniques the storage of range sets.
+  class Factory {
+    llvm::BumpPtrAllocator Arena;
+    llvm::FoldingSet<Storage> Cache;
+
+  public:
+    RangeSet getEmptySet() { return RangeSet(nullptr); }
 
-  RangeSet(PrimRangeSet RS) : ranges(RS) {}
+    /// Returns the set of \p Ranges, which must be sorted and pairwise
+    /// disjoint.
+    RangeSet getRangeSet(ArrayRef<Range> Ranges);
+  };
+
+  typedef const Range *iterator;
 
   /// Create a new set with all ranges of this set and RS.
   /// Possible intersections are not checked here.
-  RangeSet addRange(Factory &F, const RangeSet &RS) {
-    PrimRangeSet Ranges(RS.ranges);
-    for (const auto &range : ranges)
-      Ranges = F.add(Ranges, range);
-    return RangeSet(Ranges);
-  }
+  RangeSet addRange(Factory &F, const RangeSet &RS) const;
 
-  iterator begin() const { return ranges.begin(); }
-  iterator end() const { return ranges.end(); }
+  iterator begin() const {
+    return Ranges ? Ranges->getRanges().begin() : nullptr;
+  }
+  iterator end() const { return Ranges ? Ranges->getRanges().end() : nullptr; }
 
-  bool isEmpty() const { return ranges.isEmpty(); }
+  bool isEmpty() const { return !Ranges; }
 
   /// Construct a new RangeSet representing '{ [from, to] }'.
   RangeSet(Factory &F, const llvm::APSInt &from, const llvm::APSInt &to)
-      : ranges(F.add(F.getEmptySet(), Range(from, to))) {}
+      : RangeSet(F.getRangeSet(Range(from, to))) {}
 
   /// Profile - Generates a hash profile of this RangeSet for use
   ///  by FoldingSet.
-  void Profile(llvm::FoldingSetNodeID &ID) const { ranges.Profile(ID); }
+  void Profile(llvm::FoldingSetNodeID &ID) const { ID.AddPointer(Ranges); }
 
   /// getConcreteValue - If a symbol is contrained to equal a specific integer
   ///  constant then this method returns that value.  Otherwise, it returns
   ///  NULL.
   const llvm::APSInt *getConcreteValue() const {
-    return ranges.isSingleton() ? ranges.begin()->getConcreteValue() : nullptr;
+    return end() - begin() == 1 ? begin()->getConcreteValue() : nullptr;
   }
 
 private:
-  void IntersectInRange(BasicValueFactory &BV, Factory &F,
-                        const llvm::APSInt &Lower, const llvm::APSInt &Upper,
-                        PrimRangeSet &newRanges, PrimRangeSet::iterator &i,
-                        PrimRangeSet::iterator &e) const;
+  void IntersectInRange(BasicValueFactory &BV, const llvm::APSInt &Lower,
+                        const llvm::APSInt &Upper,
+                        SmallVectorImpl<Range> &newRanges, iterator &i,
+                        iterator &e) const;
 
   const llvm::APSInt &getMinValue() const;
+  const llvm::APSInt &getMaxValue() const;
 
   bool pin(llvm::APSInt &Lower, llvm::APSInt &Upper) const;
 
@@ -120,7 +142,7 @@ public:
   void print(raw_ostream &os) const;
 
   bool operator==(const RangeSet &other) const {
-    return ranges == other.ranges;
+    return Ranges == other.Ranges;
   }
 };
 
@@ -0,0 +1,79 @@
+//===- DependencyScanningService.h - clang-scan-deps service ===-*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_SERVICE_H
+#define LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_SERVICE_H
+
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+
+namespace clang {
+namespace tooling {
+namespace dependencies {
+
+/// The mode in which the dependency scanner will operate to find the
+/// dependencies.
+enum class ScanningMode {
+  /// This mode is used to compute the dependencies by running the preprocessor
+  /// over the unmodified source files.
+  CanonicalPreprocessing,
+
+  /// This mode is used to compute the dependencies by running the preprocessor
+  /// over the source files that have been minimized to contents that might
+  /// affect the dependencies.
+  MinimizedSourcePreprocessing
+};
+
+/// The format that is output by the dependency scanner.
+enum class ScanningOutputFormat {
+  /// This outputs the dependency graph for standard make based build systems
+  /// using the Makefile format that's produced by -MD.
+  Make,
+
+  /// This outputs one JSON object per translation unit on its own line, so
+  /// that a client can consume the dependencies of each translation unit as
+  /// soon as they were computed.
+  JSON,
+
+  /// This outputs one JSON object per translation unit on its own line, like
+  /// the JSON format, and adds the Clang modules that the translation unit
+  /// needs. Every module is described with its name, context hash, module
+  /// map, direct module dependencies, file dependencies and the arguments
+  /// that build it explicitly. A module is described again for every
+  /// translation unit that needs it; the name and the context hash identify
+  /// it, so that a build system can build each module once.
+  Full,
+};
+
+/// The dependency scanning service contains the shared state that is used by
+/// the individual dependency scanning workers.
+class DependencyScanningService {
+public:
+  DependencyScanningService(
+      ScanningMode Mode,
+      ScanningOutputFormat Format = ScanningOutputFormat::Make);
+
+  ScanningMode getMode() const { return Mode; }
+
+  ScanningOutputFormat getFormat() const { return Format; }
+
+  DependencyScanningFilesystemSharedCache &getSharedCache() {
+    return SharedCache;
+  }
+
+private:
+  const ScanningMode Mode;
+  const ScanningOutputFormat Format;
+  /// The global file system cache.
+  DependencyScanningFilesystemSharedCache SharedCache;
+};
+
+} // end namespace dependencies
+} // end namespace tooling
+} // end namespace clang
+
+#endif // LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_SERVICE_H
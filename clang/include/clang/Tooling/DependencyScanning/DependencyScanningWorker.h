@@ -13,6 +13,7 @@
 #include "clang/Basic/LLVM.h"
 #include "clang/Frontend/PCHContainerOperations.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningService.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include <string>
@@ -29,11 +30,11 @@ namespace dependencies {
 /// using the regular processing run.
 class DependencyScanningWorker {
 public:
-  DependencyScanningWorker();
+  DependencyScanningWorker(DependencyScanningService &Service);
 
-  /// Print out the dependency information into a string using the dependency
-  /// file format that is specified in the options (-MD is the default) and
-  /// return it.
+  /// Print out the dependency information into a string using the output
+  /// format of the service and return it. The Make format uses the dependency
+  /// file format that is specified in the options (-MD is the default).
   ///
   /// \returns A \c StringError with the diagnostic output if clang errors
   /// occurred, dependency file contents otherwise.
@@ -44,11 +45,20 @@ public:
 private:
   IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts;
   std::shared_ptr<PCHContainerOperations> PCHContainerOps;
+  ScanningOutputFormat Format;
 
-  /// The file system that is used by each worker when scanning for
+  /// The real file system that is used by each worker when scanning for
   /// dependencies. This filesystem persists accross multiple compiler
   /// invocations.
-  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> WorkerFS;
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> RealFS;
+  /// The file system that is used by the worker when scanning with minimized
+  /// sources. It caches the file system queries in the service's shared
+  /// cache, and is null when the sources are preprocessed as they are.
+  llvm::IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS;
+  /// The skipped range mappings of the minimized buffers that were opened
+  /// through \c DepFS, which the preprocessor uses to jump over excluded
+  /// conditional blocks.
+  std::unique_ptr<ExcludedPreprocessorDirectiveSkipMapping> PPSkipMappings;
 };
 
 } // end namespace dependencies
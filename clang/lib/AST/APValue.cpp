@@ -204,8 +204,27 @@ struct APValue::MemberPointerData : MemberPointerBase {
 
 APValue::Arr::Arr(unsigned NumElts, unsigned Size) :
   Elts(new APValue[NumElts + (NumElts != Size ? 1 : 0)]),
-  NumElts(NumElts), ArrSize(Size) {}
-APValue::Arr::~Arr() { delete [] Elts; }
+  NumElts(NumElts), ArrSize(Size), Packed(nullptr), PackedBitWidth(0),
+  PackedEltBytes(0), PackedIsUnsigned(false) {}
+
+/// The number of bytes used to store an element of a packed array.
+static unsigned getPackedEltBytes(unsigned BitWidth) {
+  assert(BitWidth && BitWidth <= 64 && "cannot pack integers of this width");
+  return BitWidth <= 8 ? 1 : BitWidth <= 16 ? 2 : BitWidth <= 32 ? 4 : 8;
+}
+
+APValue::Arr::Arr(unsigned Size, unsigned BitWidth, bool IsUnsigned) :
+  Elts(nullptr), NumElts(Size), ArrSize(Size), PackedBitWidth(BitWidth),
+  PackedEltBytes(getPackedEltBytes(BitWidth)), PackedIsUnsigned(IsUnsigned) {
+  // Always allocate at least one byte, since a null pointer means that the
+  // array is not packed.
+  Packed = new char[std::max<size_t>(size_t(Size) * PackedEltBytes, 1)]();
+}
+
+APValue::Arr::~Arr() {
+  delete [] Elts;
+  delete [] Packed;
+}
 
 APValue::StructData::StructData(unsigned NumBases, unsigned NumFields) :
   Elts(new APValue[NumBases+NumFields]),
@@ -261,6 +280,14 @@ APValue::APValue(const APValue &RHS) : Kind(None) {
                 RHS.isNullPointer());
     break;
   case Array:
+    if (RHS.isPackedArray()) {
+      MakePackedArray(RHS.getArraySize(), RHS.getPackedArrayBitWidth(),
+                      RHS.isPackedArrayUnsigned());
+      StringRef Packed = RHS.getPackedArrayData();
+      memcpy(((Arr *)(char *)Data.buffer)->Packed, Packed.data(),
+             Packed.size());
+      break;
+    }
     MakeArray(RHS.getArrayInitializedElts(), RHS.getArraySize());
     for (unsigned I = 0, N = RHS.getArrayInitializedElts(); I != N; ++I)
       getArrayInitializedElt(I) = RHS.getArrayInitializedElt(I);
@@ -414,6 +441,13 @@ void APValue::dump(raw_ostream &OS) const {
     return;
   case Array:
     OS << "Array: ";
+    if (isPackedArray()) {
+      for (unsigned I = 0, N = getArraySize(); I != N; ++I) {
+        APValue(getPackedArrayElt(I)).dump(OS);
+        if (I != N - 1) OS << ", ";
+      }
+      return;
+    }
     for (unsigned I = 0, N = getArrayInitializedElts(); I != N; ++I) {
       getArrayInitializedElt(I).dump(OS);
       if (I != getArraySize() - 1) OS << ", ";
@@ -609,8 +643,15 @@ void APValue::printPretty(raw_ostream &Out, const ASTContext &Ctx,
     const ArrayType *AT = Ctx.getAsArrayType(Ty);
     QualType ElemTy = AT->getElementType();
     Out << '{';
+    // Print the elements of a packed array without unpacking it.
+    auto printElt = [&](unsigned I) {
+      if (isPackedArray())
+        APValue(getPackedArrayElt(I)).printPretty(Out, Ctx, ElemTy);
+      else
+        getArrayInitializedElt(I).printPretty(Out, Ctx, ElemTy);
+    };
     if (unsigned N = getArrayInitializedElts()) {
-      getArrayInitializedElt(0).printPretty(Out, Ctx, ElemTy);
+      printElt(0);
       for (unsigned I = 1; I != N; ++I) {
         Out << ", ";
         if (I == 10) {
@@ -618,7 +659,7 @@ void APValue::printPretty(raw_ostream &Out, const ASTContext &Ctx,
           Out << "...";
           break;
         }
-        getArrayInitializedElt(I).printPretty(Out, Ctx, ElemTy);
+        printElt(I);
       }
     }
     Out << '}';
@@ -803,6 +844,53 @@ void APValue::MakeArray(unsigned InitElts, unsigned Size) {
   Kind = Array;
 }
 
+void APValue::MakePackedArray(unsigned Size, unsigned BitWidth,
+                              bool IsUnsigned) {
+  assert(isAbsent() && "Bad state change");
+  new ((void*)(char*)Data.buffer) Arr(Size, BitWidth, IsUnsigned);
+  Kind = Array;
+}
+
+APSInt APValue::getPackedArrayElt(unsigned I) const {
+  assert(I < getArraySize() && "Index out of range");
+  unsigned Bytes = getPackedArrayEltBytes();
+  const char *P = getPackedArrayData().data() + I * Bytes;
+  uint64_t Value;
+  switch (Bytes) {
+  case 1: { uint8_t V; memcpy(&V, P, 1); Value = V; break; }
+  case 2: { uint16_t V; memcpy(&V, P, 2); Value = V; break; }
+  case 4: { uint32_t V; memcpy(&V, P, 4); Value = V; break; }
+  default: memcpy(&Value, P, 8); break;
+  }
+  return APSInt(llvm::APInt(getPackedArrayBitWidth(), Value),
+                isPackedArrayUnsigned());
+}
+
+void APValue::setPackedArrayElt(unsigned I, const APSInt &Value) {
+  assert(I < getArraySize() && "Index out of range");
+  assert(Value.getBitWidth() == getPackedArrayBitWidth() &&
+         Value.isUnsigned() == isPackedArrayUnsigned() &&
+         "value does not match the elements of the packed array");
+  unsigned Bytes = getPackedArrayEltBytes();
+  char *P = ((Arr *)(char *)Data.buffer)->Packed + I * Bytes;
+  uint64_t V = Value.getZExtValue();
+  switch (Bytes) {
+  case 1: { uint8_t B = V; memcpy(P, &B, 1); break; }
+  case 2: { uint16_t B = V; memcpy(P, &B, 2); break; }
+  case 4: { uint32_t B = V; memcpy(P, &B, 4); break; }
+  default: memcpy(P, &V, 8); break;
+  }
+}
+
+void APValue::unpackArray() {
+  assert(isPackedArray() && "array is not packed");
+  unsigned Size = getArraySize();
+  APValue Unpacked(UninitArray(), Size, Size);
+  for (unsigned I = 0; I != Size; ++I)
+    Unpacked.getArrayInitializedElt(I) = APValue(getPackedArrayElt(I));
+  swap(Unpacked);
+}
+
 void APValue::MakeMemberPointer(const ValueDecl *Member, bool IsDerivedMember,
                                 ArrayRef<const CXXRecordDecl*> Path) {
   assert(isAbsent() && "Bad state change");
@@ -12,12 +12,15 @@
 
 #include "clang/AST/ASTContext.h"
 #include "CXXABI.h"
+#include "ConstexprCallCache.h"
+#include "Interp/Context.h"
 #include "clang/AST/APValue.h"
 #include "clang/AST/ASTConcept.h"
 #include "clang/AST/ASTMutationListener.h"
 #include "clang/AST/ASTTypeTraits.h"
 #include "clang/AST/Attr.h"
 #include "clang/AST/AttrIterator.h"
+#include "clang/AST/CXXInheritance.h"
 #include "clang/AST/CharUnits.h"
 #include "clang/AST/Comment.h"
 #include "clang/AST/Decl.h"
@@ -1065,6 +1068,12 @@ void ASTContext::PrintStats() const {
                << NumImplicitDestructors
                << " implicit destructors created\n";
 
+  if (ConstexprCalls)
+    ConstexprCalls->PrintStats();
+
+  if (BaseLookups)
+    BaseLookups->PrintStats();
+
   if (ExternalSource) {
     llvm::errs() << "\n";
     ExternalSource->PrintStats();
@@ -5502,6 +5511,93 @@ ASTContext::getCanonicalTemplateArgument(const TemplateArgument &Arg) const {
   llvm_unreachable("Unhandled template argument kind");
 }
 
+/// Determine whether \p Arg is its own canonical template argument.
+static bool isCanonicalTemplateArgument(const ASTContext &Ctx,
+                                        const TemplateArgument &Arg) {
+  switch (Arg.getKind()) {
+  case TemplateArgument::Null:
+  case TemplateArgument::Expression:
+    return false;
+
+  case TemplateArgument::Declaration:
+    return Arg.getAsDecl() == Arg.getAsDecl()->getCanonicalDecl() &&
+           Arg.getParamTypeForDecl().isCanonical();
+
+  case TemplateArgument::NullPtr:
+    return Arg.getNullPtrType().isCanonical();
+
+  case TemplateArgument::Template:
+  case TemplateArgument::TemplateExpansion: {
+    TemplateName Name = Arg.getAsTemplateOrTemplatePattern();
+    return Ctx.getCanonicalTemplateName(Name).getAsVoidPointer() ==
+           Name.getAsVoidPointer();
+  }
+
+  case TemplateArgument::Integral:
+    return Arg.getIntegralType().isCanonical();
+
+  case TemplateArgument::Type:
+    return Arg.getAsType().isCanonical();
+
+  case TemplateArgument::Pack:
+    return llvm::all_of(Arg.pack_elements(), [&](const TemplateArgument &A) {
+      return isCanonicalTemplateArgument(Ctx, A);
+    });
+  }
+  llvm_unreachable("Unhandled template argument kind");
+}
+
+void ASTContext::UniquedTemplateArgumentList::Profile(
+    llvm::FoldingSetNodeID &ID) const {
+  for (unsigned I = 0, N = ArgsProfile.getSize(); I != N; ++I)
+    ID.AddInteger(ArgsProfile.getData()[I]);
+}
+
+TemplateArgumentList *ASTContext::getUniquedTemplateArgumentList(
+    ArrayRef<TemplateArgument> Args) const {
+  for (const TemplateArgument &Arg : Args)
+    if (!isCanonicalTemplateArgument(*this, Arg))
+      return TemplateArgumentList::CreateCopy(
+          const_cast<ASTContext &>(*this), Args);
+
+  TemplateArgumentList OnStack(TemplateArgumentList::OnStack, Args);
+  llvm::FoldingSetNodeID ID;
+  OnStack.Profile(ID, *this);
+
+  void *InsertPos = nullptr;
+  if (auto *Node =
+          UniquedTemplateArgumentLists.FindNodeOrInsertPos(ID, InsertPos)) {
+    auto *List = reinterpret_cast<TemplateArgumentList *>(Node + 1);
+    // The profile of a declaration argument does not include the type of
+    // the parameter, so lists with the same profile can still differ.
+    if (std::equal(Args.begin(), Args.end(), List->asArray().begin(),
+                   List->asArray().end(),
+                   [](const TemplateArgument &A, const TemplateArgument &B) {
+                     return A.structurallyEquals(B);
+                   }))
+      return List;
+    return TemplateArgumentList::CreateCopy(const_cast<ASTContext &>(*this),
+                                            Args);
+  }
+
+  void *Mem = Allocate(
+      sizeof(UniquedTemplateArgumentList) +
+          TemplateArgumentList::totalSizeToAlloc<TemplateArgument>(Args.size()),
+      alignof(UniquedTemplateArgumentList));
+  auto *Node = new (Mem) UniquedTemplateArgumentList();
+  Node->ArgsProfile = ID.Intern(BumpAlloc);
+  auto *List = new (Node + 1) TemplateArgumentList(Args);
+  List->Uniqued = true;
+  UniquedTemplateArgumentLists.InsertNode(Node, InsertPos);
+  return List;
+}
+
+void ASTContext::profileUniquedTemplateArgumentList(
+    llvm::FoldingSetNodeID &ID, const TemplateArgumentList *List) const {
+  assert(List->isUniqued() && "template argument list is not uniqued");
+  reinterpret_cast<const UniquedTemplateArgumentList *>(List)[-1].Profile(ID);
+}
+
 NestedNameSpecifier *
 ASTContext::getCanonicalNestedNameSpecifier(NestedNameSpecifier *NNS) const {
   if (!NNS)
@@ -10158,6 +10254,30 @@ VTableContextBase *ASTContext::getVTableContext() {
   return VTContext.get();
 }
 
+interp::Context &ASTContext::getInterpContext() {
+  if (!InterpContext)
+    InterpContext.reset(new interp::Context(*this));
+  return *InterpContext;
+}
+
+ConstexprCallCache &ASTContext::getConstexprCallCache() {
+  if (!ConstexprCalls)
+    ConstexprCalls.reset(
+        new ConstexprCallCache(getLangOpts().ConstexprCacheLimit));
+  return *ConstexprCalls;
+}
+
+CXXBaseLookupCache &ASTContext::getBaseLookupCache() {
+  if (!BaseLookups)
+    BaseLookups.reset(new CXXBaseLookupCache());
+  return *BaseLookups;
+}
+
+void ASTContext::invalidateBaseLookups(DeclarationName Name) {
+  if (BaseLookups)
+    BaseLookups->invalidate(Name);
+}
+
 MangleContext *ASTContext::createMangleContext(const TargetInfo *T) {
   if (!T)
     T = Target;
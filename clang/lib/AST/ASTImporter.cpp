@@ -60,6 +60,7 @@
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -70,6 +71,18 @@
 #include <type_traits>
 #include <utility>
 
+#define DEBUG_TYPE "ast-importer"
+
+STATISTIC(NumImportedDecls, "Number of declarations imported");
+STATISTIC(NumImportedTypes, "Number of types imported");
+STATISTIC(NumImportedStmts, "Number of statements imported");
+STATISTIC(NumDefinitionEquivalenceChecks,
+          "Number of structural equivalence checks of record and enum "
+          "definitions");
+STATISTIC(NumCachedDefinitionEquivalences,
+          "Number of structural equivalence checks of record and enum "
+          "definitions answered from the cache");
+
 namespace clang {
 
   using llvm::make_error;
@@ -1974,6 +1987,15 @@ getStructuralEquivalenceKind(const ASTImporter &Importer) {
                                     : StructuralEquivalenceKind::Default;
 }
 
+/// Whether the equivalence of \p From and \p To may be taken from, or stored in
+/// ASTImporter::EquivalentDefinitions.
+static bool isCacheableEquivalence(const ASTImporter &Importer,
+                                   const TagDecl *From, const TagDecl *To) {
+  return !Importer.isMinimalImport() && From->isCompleteDefinition() &&
+         !From->isBeingDefined() && To->isCompleteDefinition() &&
+         !To->isBeingDefined();
+}
+
 bool ASTNodeImporter::IsStructuralMatch(Decl *From, Decl *To, bool Complain) {
   StructuralEquivalenceContext Ctx(
       Importer.getFromContext(), Importer.getToContext(),
@@ -1993,12 +2015,25 @@ bool ASTNodeImporter::IsStructuralMatch(RecordDecl *FromRecord,
       ToRecord = ToOriginRecord;
   }
 
+  bool Cacheable = isCacheableEquivalence(Importer, FromRecord, ToRecord);
+  if (Cacheable) {
+    ++NumDefinitionEquivalenceChecks;
+    if (Importer.EquivalentDefinitions.count({FromRecord, ToRecord})) {
+      ++NumCachedDefinitionEquivalences;
+      return true;
+    }
+  }
+
   StructuralEquivalenceContext Ctx(Importer.getFromContext(),
                                    ToRecord->getASTContext(),
                                    Importer.getNonEquivalentDecls(),
                                    getStructuralEquivalenceKind(Importer),
                                    false, Complain);
-  return Ctx.IsEquivalent(FromRecord, ToRecord);
+  if (!Ctx.IsEquivalent(FromRecord, ToRecord))
+    return false;
+  if (Cacheable)
+    Importer.EquivalentDefinitions.insert({FromRecord, ToRecord});
+  return true;
 }
 
 bool ASTNodeImporter::IsStructuralMatch(VarDecl *FromVar, VarDecl *ToVar,
@@ -2017,10 +2052,23 @@ bool ASTNodeImporter::IsStructuralMatch(EnumDecl *FromEnum, EnumDecl *ToEnum) {
     if (auto *ToOriginEnum = dyn_cast<EnumDecl>(ToOrigin))
         ToEnum = ToOriginEnum;
 
+  bool Cacheable = isCacheableEquivalence(Importer, FromEnum, ToEnum);
+  if (Cacheable) {
+    ++NumDefinitionEquivalenceChecks;
+    if (Importer.EquivalentDefinitions.count({FromEnum, ToEnum})) {
+      ++NumCachedDefinitionEquivalences;
+      return true;
+    }
+  }
+
   StructuralEquivalenceContext Ctx(
       Importer.getFromContext(), Importer.getToContext(),
       Importer.getNonEquivalentDecls(), getStructuralEquivalenceKind(Importer));
-  return Ctx.IsEquivalent(FromEnum, ToEnum);
+  if (!Ctx.IsEquivalent(FromEnum, ToEnum))
+    return false;
+  if (Cacheable)
+    Importer.EquivalentDefinitions.insert({FromEnum, ToEnum});
+  return true;
 }
 
 bool ASTNodeImporter::IsStructuralMatch(FunctionTemplateDecl *From,
@@ -7883,6 +7931,7 @@ Expected<QualType> ASTImporter::Import(QualType FromT) {
 
   // Record the imported type.
   ImportedTypes[FromTy] = (*ToTOrErr).getTypePtr();
+  ++NumImportedTypes;
 
   return ToContext.getQualifiedType(*ToTOrErr, FromT.getLocalQualifiers());
 }
@@ -8034,6 +8083,7 @@ Expected<Decl *> ASTImporter::Import(Decl *FromD) {
     assert(Err);
     return make_error<ImportError>(*Err);
   }
+  ++NumImportedDecls;
 
   // We could import from the current TU without error.  But previously we
   // already had imported a Decl as `ToD` from another TU (with another
@@ -8151,6 +8201,7 @@ Expected<Stmt *> ASTImporter::Import(Stmt *FromS) {
 
   // Record the imported statement object.
   ImportedStmts[FromS] = *ToSOrErr;
+  ++NumImportedStmts;
   return ToSOrErr;
 }
 
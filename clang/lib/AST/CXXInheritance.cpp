@@ -26,6 +26,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <utility>
 #include <cassert>
@@ -77,6 +78,14 @@ void CXXBasePaths::clear() {
 
 /// Swaps the contents of this CXXBasePaths structure with the
 /// contents of Other.
+CXXBasePaths::CXXBasePaths(const CXXBasePaths &Other)
+    : Origin(Other.Origin), Paths(Other.Paths),
+      ClassSubobjects(Other.ClassSubobjects),
+      VisitedDependentRecords(Other.VisitedDependentRecords),
+      DetectedVirtual(Other.DetectedVirtual),
+      FindAmbiguities(Other.FindAmbiguities), RecordPaths(Other.RecordPaths),
+      DetectVirtual(Other.DetectVirtual) {}
+
 void CXXBasePaths::swap(CXXBasePaths &Other) {
   std::swap(Origin, Other.Origin);
   Paths.swap(Other.Paths);
@@ -808,3 +817,44 @@ CXXRecordDecl::getIndirectPrimaryBases(CXXIndirectPrimaryBaseSet& Bases) const {
       AddIndirectPrimaryBases(BaseDecl, Context, Bases);
   }
 }
+
+const CXXBasePaths *CXXBaseLookupCache::find(const CXXRecordDecl *RD,
+                                             DeclarationName Name,
+                                             unsigned Kind) {
+  ++NumLookups;
+  auto ForName = Entries.find(Name);
+  if (ForName == Entries.end())
+    return nullptr;
+  auto Known = ForName->second.find({RD, Kind});
+  if (Known == ForName->second.end())
+    return nullptr;
+  ++NumHits;
+  return Known->second.get();
+}
+
+void CXXBaseLookupCache::insert(const CXXRecordDecl *RD, DeclarationName Name,
+                                unsigned Kind, const CXXBasePaths &Paths) {
+  std::unique_ptr<CXXBasePaths> &Entry = Entries[Name][{RD, Kind}];
+  Entry = llvm::make_unique<CXXBasePaths>(Paths);
+}
+
+void CXXBaseLookupCache::invalidate(DeclarationName Name) {
+  auto ForName = Entries.find(Name);
+  if (ForName == Entries.end())
+    return;
+  NumInvalidated += ForName->second.size();
+  Entries.erase(ForName);
+}
+
+void CXXBaseLookupCache::PrintStats() const {
+  llvm::errs() << "\n*** Base Class Lookup Cache Stats:\n";
+  unsigned NumEntries = 0;
+  for (const auto &ForName : Entries)
+    NumEntries += ForName.second.size();
+  llvm::errs() << "  " << NumEntries << " lookups cached for "
+               << Entries.size() << " names\n";
+  llvm::errs() << "  " << NumHits << "/" << NumLookups
+               << " lookups found in the cache\n";
+  llvm::errs() << "  " << NumInvalidated
+               << " cached lookups dropped by member declarations\n";
+}
@@ -0,0 +1,242 @@
+//===--- ConstexprCallCache.cpp - Memoized constexpr calls ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the cache of the results of constexpr function calls.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ConstexprCallCache.h"
+#include "clang/AST/Decl.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+ConstexprCallCache::~ConstexprCallCache() {
+  // The entries live in the allocator, but their results may own memory.
+  for (auto I = Entries.begin(), E = Entries.end(); I != E;) {
+    Entry &Ent = *I++;
+    Ent.~Entry();
+  }
+}
+
+void ConstexprCallCache::Entry::Profile(llvm::FoldingSetNodeID &ID) const {
+  for (unsigned I = 0, N = Key.getSize(); I != N; ++I)
+    ID.AddInteger(Key.getData()[I]);
+}
+
+bool ConstexprCallCache::isCacheableValue(const APValue &V) {
+  switch (V.getKind()) {
+  case APValue::None:
+  case APValue::Indeterminate:
+  case APValue::Int:
+  case APValue::Float:
+  case APValue::FixedPoint:
+  case APValue::ComplexInt:
+  case APValue::ComplexFloat:
+    return true;
+
+  case APValue::LValue:
+  case APValue::MemberPointer:
+  case APValue::AddrLabelDiff:
+    return false;
+
+  case APValue::Vector:
+    for (unsigned I = 0, N = V.getVectorLength(); I != N; ++I)
+      if (!isCacheableValue(V.getVectorElt(I)))
+        return false;
+    return true;
+
+  case APValue::Array:
+    if (V.isPackedArray())
+      return true;
+    for (unsigned I = 0, N = V.getArrayInitializedElts(); I != N; ++I)
+      if (!isCacheableValue(V.getArrayInitializedElt(I)))
+        return false;
+    return !V.hasArrayFiller() || isCacheableValue(V.getArrayFiller());
+
+  case APValue::Struct:
+    for (unsigned I = 0, N = V.getStructNumBases(); I != N; ++I)
+      if (!isCacheableValue(V.getStructBase(I)))
+        return false;
+    for (unsigned I = 0, N = V.getStructNumFields(); I != N; ++I)
+      if (!isCacheableValue(V.getStructField(I)))
+        return false;
+    return true;
+
+  case APValue::Union:
+    return !V.getUnionField() || isCacheableValue(V.getUnionValue());
+  }
+  llvm_unreachable("unknown APValue kind");
+}
+
+static void profileValue(llvm::FoldingSetNodeID &ID, const APValue &V) {
+  ID.AddInteger(V.getKind());
+  switch (V.getKind()) {
+  case APValue::None:
+  case APValue::Indeterminate:
+    return;
+
+  case APValue::Int:
+    V.getInt().Profile(ID);
+    return;
+
+  case APValue::Float:
+    V.getFloat().Profile(ID);
+    return;
+
+  case APValue::FixedPoint: {
+    const APFixedPoint &FP = V.getFixedPoint();
+    ID.AddInteger(FP.getScale());
+    ID.AddBoolean(FP.getSemantics().hasUnsignedPadding());
+    FP.getValue().Profile(ID);
+    return;
+  }
+
+  case APValue::ComplexInt:
+    V.getComplexIntReal().Profile(ID);
+    V.getComplexIntImag().Profile(ID);
+    return;
+
+  case APValue::ComplexFloat:
+    V.getComplexFloatReal().Profile(ID);
+    V.getComplexFloatImag().Profile(ID);
+    return;
+
+  case APValue::Vector:
+    ID.AddInteger(V.getVectorLength());
+    for (unsigned I = 0, N = V.getVectorLength(); I != N; ++I)
+      profileValue(ID, V.getVectorElt(I));
+    return;
+
+  case APValue::Array:
+    ID.AddInteger(V.getArraySize());
+    ID.AddBoolean(V.isPackedArray());
+    if (V.isPackedArray()) {
+      ID.AddInteger(V.getPackedArrayBitWidth());
+      ID.AddBoolean(V.isPackedArrayUnsigned());
+      ID.AddString(V.getPackedArrayData());
+      return;
+    }
+    ID.AddInteger(V.getArrayInitializedElts());
+    for (unsigned I = 0, N = V.getArrayInitializedElts(); I != N; ++I)
+      profileValue(ID, V.getArrayInitializedElt(I));
+    if (V.hasArrayFiller())
+      profileValue(ID, V.getArrayFiller());
+    return;
+
+  case APValue::Struct:
+    ID.AddInteger(V.getStructNumBases());
+    ID.AddInteger(V.getStructNumFields());
+    for (unsigned I = 0, N = V.getStructNumBases(); I != N; ++I)
+      profileValue(ID, V.getStructBase(I));
+    for (unsigned I = 0, N = V.getStructNumFields(); I != N; ++I)
+      profileValue(ID, V.getStructField(I));
+    return;
+
+  case APValue::Union:
+    ID.AddPointer(V.getUnionField());
+    if (V.getUnionField())
+      profileValue(ID, V.getUnionValue());
+    return;
+
+  case APValue::LValue:
+  case APValue::MemberPointer:
+  case APValue::AddrLabelDiff:
+    break;
+  }
+  llvm_unreachable("profiling a value that cannot be cached");
+}
+
+/// Estimate the number of bytes of memory used by \p V.
+static size_t getValueSize(const APValue &V) {
+  size_t Size = sizeof(APValue);
+  switch (V.getKind()) {
+  case APValue::Int:
+    return Size + V.getInt().getNumWords() * sizeof(uint64_t);
+  case APValue::ComplexInt:
+    return Size + 2 * V.getComplexIntReal().getNumWords() * sizeof(uint64_t);
+  case APValue::Vector:
+    for (unsigned I = 0, N = V.getVectorLength(); I != N; ++I)
+      Size += getValueSize(V.getVectorElt(I));
+    return Size;
+  case APValue::Array:
+    if (V.isPackedArray())
+      return Size + V.getPackedArrayData().size();
+    for (unsigned I = 0, N = V.getArrayInitializedElts(); I != N; ++I)
+      Size += getValueSize(V.getArrayInitializedElt(I));
+    if (V.hasArrayFiller())
+      Size += getValueSize(V.getArrayFiller());
+    return Size;
+  case APValue::Struct:
+    for (unsigned I = 0, N = V.getStructNumBases(); I != N; ++I)
+      Size += getValueSize(V.getStructBase(I));
+    for (unsigned I = 0, N = V.getStructNumFields(); I != N; ++I)
+      Size += getValueSize(V.getStructField(I));
+    return Size;
+  case APValue::Union:
+    if (V.getUnionField())
+      Size += getValueSize(V.getUnionValue());
+    return Size;
+  default:
+    return Size;
+  }
+}
+
+void ConstexprCallCache::profileCall(llvm::FoldingSetNodeID &ID,
+                                     const FunctionDecl *FD, unsigned Context,
+                                     ArrayRef<APValue> Args) {
+  ID.AddPointer(FD->getCanonicalDecl());
+  ID.AddInteger(Context);
+  ID.AddInteger(Args.size());
+  for (const APValue &Arg : Args)
+    profileValue(ID, Arg);
+}
+
+const ConstexprCallCache::Entry *
+ConstexprCallCache::lookup(const llvm::FoldingSetNodeID &ID) {
+  ++NumLookups;
+  void *InsertPos;
+  const Entry *Found = Entries.FindNodeOrInsertPos(ID, InsertPos);
+  if (Found)
+    ++NumHits;
+  return Found;
+}
+
+void ConstexprCallCache::insert(const llvm::FoldingSetNodeID &ID,
+                                const APValue &Result, unsigned Steps,
+                                unsigned Depth) {
+  void *InsertPos;
+  if (Entries.FindNodeOrInsertPos(ID, InsertPos))
+    return;
+
+  size_t Size = sizeof(Entry) + getValueSize(Result);
+  if (MemoryUsed + Size > MemoryLimit) {
+    ++NumRejected;
+    return;
+  }
+
+  llvm::FoldingSetNodeIDRef Key = ID.Intern(Allocator);
+  MemoryUsed += Size + Key.getSize() * sizeof(unsigned);
+
+  Entry *E = new (Allocator) Entry();
+  E->Key = Key;
+  E->Result = Result;
+  E->Steps = Steps;
+  E->Depth = Depth;
+  Entries.InsertNode(E, InsertPos);
+}
+
+void ConstexprCallCache::PrintStats() const {
+  llvm::errs() << "\n*** Constexpr Call Cache Stats:\n";
+  llvm::errs() << "  " << Entries.size() << " calls cached, using about "
+               << MemoryUsed << " of " << MemoryLimit << " bytes\n";
+  llvm::errs() << "  " << NumHits << "/" << NumLookups
+               << " lookups found a cached call\n";
+  llvm::errs() << "  " << NumRejected
+               << " calls not cached because of the memory limit\n";
+}
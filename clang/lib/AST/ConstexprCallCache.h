@@ -0,0 +1,91 @@
+//===--- ConstexprCallCache.h - Memoized constexpr calls --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the cache of the results of constexpr function calls,
+// which lets the constant evaluator reuse the result of a call instead of
+// evaluating an identical call again.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_AST_CONSTEXPRCALLCACHE_H
+#define LLVM_CLANG_LIB_AST_CONSTEXPRCALLCACHE_H
+
+#include "clang/AST/APValue.h"
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
+#include <cstddef>
+
+namespace clang {
+
+class FunctionDecl;
+
+/// A per-translation-unit cache of the results of constexpr function calls.
+///
+/// Only calls whose arguments and result are self-contained values (holding
+/// no pointers, references or member pointers) are cached, so the result of
+/// a call depends only on the callee and the argument values. The constant
+/// evaluator is responsible for only caching calls that did not access any
+/// object whose lifetime began outside of the call.
+class ConstexprCallCache {
+public:
+  /// A cached call.
+  struct Entry : llvm::FoldingSetNode {
+    /// The profile of the callee, the evaluation context, and the arguments.
+    llvm::FoldingSetNodeIDRef Key;
+    APValue Result;
+    /// The number of evaluation steps the call took.
+    unsigned Steps;
+    /// The call stack depth the call reached, relative to its caller.
+    unsigned Depth;
+
+    void Profile(llvm::FoldingSetNodeID &ID) const;
+  };
+
+  explicit ConstexprCallCache(size_t MemoryLimit) : MemoryLimit(MemoryLimit) {}
+  ConstexprCallCache(const ConstexprCallCache &) = delete;
+  ConstexprCallCache &operator=(const ConstexprCallCache &) = delete;
+  ~ConstexprCallCache();
+
+  /// Whether \p V is a value that can be used as an argument or a result of
+  /// a cached call.
+  static bool isCacheableValue(const APValue &V);
+
+  /// Compute the key of a call to \p FD with arguments \p Args, each of which
+  /// must be cacheable. \p Context distinguishes evaluation contexts in which
+  /// the same call might not produce the same result.
+  static void profileCall(llvm::FoldingSetNodeID &ID, const FunctionDecl *FD,
+                          unsigned Context, ArrayRef<APValue> Args);
+
+  /// Look up the result of the call with key \p ID.
+  const Entry *lookup(const llvm::FoldingSetNodeID &ID);
+
+  /// Record the result of the call with key \p ID, unless that would exceed
+  /// the memory limit of the cache.
+  void insert(const llvm::FoldingSetNodeID &ID, const APValue &Result,
+              unsigned Steps, unsigned Depth);
+
+  void PrintStats() const;
+
+private:
+  llvm::FoldingSet<Entry> Entries;
+  llvm::BumpPtrAllocator Allocator;
+
+  /// The approximate number of bytes used by the cached entries.
+  size_t MemoryUsed = 0;
+  size_t MemoryLimit;
+
+  unsigned NumLookups = 0;
+  unsigned NumHits = 0;
+  /// The number of results not cached because of the memory limit.
+  unsigned NumRejected = 0;
+};
+
+} // namespace clang
+
+#endif
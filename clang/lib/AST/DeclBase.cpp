@@ -160,6 +160,14 @@ const char *DeclContext::getDeclKindName() const {
   llvm_unreachable("Declaration context not in DeclNodes.inc!");
 }
 
+/// The number of times the declarations of a context were walked to build
+/// its lookup table.
+static unsigned NumLookupTableBuilds = 0;
+/// The number of those walks that resumed after the declarations walked by
+/// an earlier build.
+static unsigned NumIncrementalLookupTableBuilds = 0;
+static unsigned NumLookupTableDeclsWalked = 0;
+
 bool Decl::StatisticsEnabled = false;
 void Decl::EnableStatistics() {
   StatisticsEnabled = true;
@@ -187,6 +195,10 @@ void Decl::PrintStats() {
 #include "clang/AST/DeclNodes.inc"
 
   llvm::errs() << "Total bytes = " << totalBytes << "\n";
+
+  llvm::errs() << "  " << NumLookupTableBuilds << " lookup table builds, "
+               << NumIncrementalLookupTableBuilds << " of them incremental, "
+               << "walking " << NumLookupTableDeclsWalked << " decls\n";
 }
 
 void Decl::add(Kind k) {
@@ -1311,6 +1323,10 @@ DeclContext::LoadLexicalDeclsFromExternalStorage() const {
   FirstDecl = ExternalFirst;
   if (!LastDecl)
     LastDecl = ExternalLast;
+
+  // The new declarations precede any that were walked to build a lookup
+  // table, so the next build must walk all of them again.
+  updateLastWalkedDecl(nullptr, nullptr);
   return true;
 }
 
@@ -1401,6 +1417,30 @@ bool DeclContext::containsDeclAndLoad(Decl *D) const {
   return containsDecl(D);
 }
 
+/// Update the lookup tables that record \p Old as the last declaration walked
+/// in this context to record \p New instead. If \p Old is null, update them
+/// regardless of the declaration they record. A null \p New makes the next
+/// build of the lookup table walk all of the declarations of this context.
+void DeclContext::updateLastWalkedDecl(Decl *Old, Decl *New) const {
+  // Declarations of transparent contexts and inline namespaces are also
+  // walked to build the lookup tables of the enclosing contexts.
+  for (const DeclContext *Ctx = this; Ctx; Ctx = Ctx->getParent()) {
+    StoredDeclsMap *Map = Ctx->getPrimaryContext()->LookupPtr;
+    if (Map && Map->LastWalkedDecls) {
+      auto Known = Map->LastWalkedDecls->find(this);
+      if (Known != Map->LastWalkedDecls->end() &&
+          (!Old || Known->second == Old)) {
+        if (New)
+          Known->second = New;
+        else
+          Map->LastWalkedDecls->erase(Known);
+      }
+    }
+    if (!Ctx->isTransparentContext() && !Ctx->isInlineNamespace())
+      break;
+  }
+}
+
 /// shouldBeHidden - Determine whether a declaration which was declared
 /// within its semantic context should be invisible to qualified name lookup.
 static bool shouldBeHidden(NamedDecl *D) {
@@ -1440,6 +1480,7 @@ void DeclContext::removeDecl(Decl *D) {
          "decl is not in decls list");
 
   // Remove D from the decl chain.  This is O(n) but hopefully rare.
+  Decl *Prev = nullptr;
   if (D == FirstDecl) {
     if (D == LastDecl)
       FirstDecl = LastDecl = nullptr;
@@ -1451,6 +1492,7 @@ void DeclContext::removeDecl(Decl *D) {
       if (I->NextInContextAndBits.getPointer() == D) {
         I->NextInContextAndBits.setPointer(D->NextInContextAndBits.getPointer());
         if (D == LastDecl) LastDecl = I;
+        Prev = I;
         break;
       }
     }
@@ -1459,6 +1501,10 @@ void DeclContext::removeDecl(Decl *D) {
   // Mark that D is no longer in the decl chain.
   D->NextInContextAndBits.setPointer(nullptr);
 
+  // Lookup tables that would resume walking after D resume after the
+  // declaration preceding it instead.
+  updateLastWalkedDecl(D, Prev);
+
   // Remove D from the lookup table if necessary.
   if (isa<NamedDecl>(D)) {
     auto *ND = cast<NamedDecl>(D);
@@ -1472,6 +1518,9 @@ void DeclContext::removeDecl(Decl *D) {
     if (!ND->getDeclName())
       return;
 
+    if (isRecord())
+      getParentASTContext().invalidateBaseLookups(ND->getDeclName());
+
     auto *DC = D->getDeclContext();
     do {
       StoredDeclsMap *Map = DC->getPrimaryContext()->LookupPtr;
@@ -1573,7 +1622,25 @@ StoredDeclsMap *DeclContext::buildLookup() {
 /// DeclContext, a DeclContext linked to it, or a transparent context
 /// nested within it.
 void DeclContext::buildLookupImpl(DeclContext *DCtx, bool Internal) {
-  for (auto *D : DCtx->noload_decls()) {
+  ++NumLookupTableBuilds;
+
+  // If we have walked the declarations of DCtx before, only walk the ones
+  // added since.
+  Decl *First = DCtx->FirstDecl;
+  if (LookupPtr && LookupPtr->LastWalkedDecls) {
+    auto Known = LookupPtr->LastWalkedDecls->find(DCtx);
+    if (Known != LookupPtr->LastWalkedDecls->end()) {
+      First = Known->second->getNextDeclInContext();
+      ++NumIncrementalLookupTableBuilds;
+    }
+  }
+
+  Decl *Last = nullptr;
+  unsigned NumWalked = 0;
+  for (Decl *D = First; D; D = D->getNextDeclInContext()) {
+    Last = D;
+    ++NumWalked;
+
     // Insert this declaration into the lookup structure, but only if
     // it's semantically within its decl context. Any other decls which
     // should be found in this context are added eagerly.
@@ -1596,6 +1663,20 @@ void DeclContext::buildLookupImpl(DeclContext *DCtx, bool Internal) {
       if (InnerCtx->isTransparentContext() || InnerCtx->isInlineNamespace())
         buildLookupImpl(InnerCtx, Internal);
   }
+  NumLookupTableDeclsWalked += NumWalked;
+
+  // Remember where we stopped, so that rebuilding the lookup table of a
+  // large context does not walk all of its declarations again. Walking a
+  // small context is cheap enough without this.
+  if (!Last || !LookupPtr)
+    return;
+  if (!LookupPtr->LastWalkedDecls) {
+    if (NumWalked < 64)
+      return;
+    LookupPtr->LastWalkedDecls =
+        llvm::make_unique<llvm::DenseMap<const DeclContext *, Decl *>>();
+  }
+  (*LookupPtr->LastWalkedDecls)[DCtx] = Last;
 }
 
 NamedDecl *const DeclContextLookupResult::SingleElementDummyList = nullptr;
@@ -1866,6 +1947,10 @@ void DeclContext::makeDeclVisibleInContextImpl(NamedDecl *D, bool Internal) {
           Map->find(D->getDeclName()) == Map->end())
         Source->FindExternalVisibleDeclsByName(this, D->getDeclName());
 
+  // Looking up this name in the bases of derived classes may now find it.
+  if (isRecord())
+    getParentASTContext().invalidateBaseLookups(D->getDeclName());
+
   // Insert this declaration into the map.
   StoredDeclsList &DeclNameEntries = (*Map)[D->getDeclName()];
 
@@ -17,6 +17,7 @@
 #include "clang/AST/DeclarationName.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/ExternalASTSource.h"
+#include "clang/AST/ODRHash.h"
 #include "clang/AST/TemplateBase.h"
 #include "clang/AST/TemplateName.h"
 #include "clang/AST/Type.h"
@@ -268,13 +269,34 @@ void RedeclarableTemplateDecl::loadLazySpecializationsImpl() const {
   CommonBase *CommonBasePtr = getMostRecentDecl()->getCommonPtr();
   if (CommonBasePtr->LazySpecializations) {
     ASTContext &Context = getASTContext();
-    uint32_t *Specs = CommonBasePtr->LazySpecializations;
+    LazySpecializationInfo *Specs = CommonBasePtr->LazySpecializations;
     CommonBasePtr->LazySpecializations = nullptr;
-    for (uint32_t I = 0, N = *Specs++; I != N; ++I)
-      (void)Context.getExternalSource()->GetExternalDecl(Specs[I]);
+    for (uint32_t I = 0, N = Specs[0].DeclID; I != N; ++I)
+      (void)Context.getExternalSource()->GetExternalDecl(Specs[I + 1].DeclID);
   }
 }
 
+void RedeclarableTemplateDecl::loadLazySpecializationsImpl(
+    ArrayRef<TemplateArgument> Args) const {
+  CommonBase *CommonBasePtr = getMostRecentDecl()->getCommonPtr();
+  if (!CommonBasePtr->LazySpecializations)
+    return;
+
+  // Collect the candidates first; deserializing them might add further lazy
+  // specializations and reallocate the array. Entries without a hash are
+  // always candidates.
+  unsigned Hash = TemplateArgumentList::ComputeODRHash(Args);
+  LazySpecializationInfo *Specs = CommonBasePtr->LazySpecializations;
+  SmallVector<uint32_t, 4> IDs;
+  for (uint32_t I = 0, N = Specs[0].DeclID; I != N; ++I)
+    if (Specs[I + 1].ODRHash == Hash || Specs[I + 1].ODRHash == ~0U)
+      IDs.push_back(Specs[I + 1].DeclID);
+
+  ASTContext &Context = getASTContext();
+  for (uint32_t ID : IDs)
+    (void)Context.getExternalSource()->GetExternalDecl(ID);
+}
+
 template<class EntryType, typename... ProfileArguments>
 typename RedeclarableTemplateDecl::SpecEntryTraits<EntryType>::DeclType *
 RedeclarableTemplateDecl::findSpecializationImpl(
@@ -356,7 +378,9 @@ FunctionTemplateDecl::getSpecializations() const {
 FunctionDecl *
 FunctionTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                          void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), InsertPos, Args);
+  loadLazySpecializationsImpl(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, InsertPos,
+                                Args);
 }
 
 void FunctionTemplateDecl::addSpecialization(
@@ -462,7 +486,9 @@ ClassTemplateDecl::newCommon(ASTContext &C) const {
 ClassTemplateSpecializationDecl *
 ClassTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                       void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), InsertPos, Args);
+  loadLazySpecializationsImpl(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, InsertPos,
+                                Args);
 }
 
 void ClassTemplateDecl::AddSpecialization(ClassTemplateSpecializationDecl *D,
@@ -801,6 +827,24 @@ TemplateArgumentList::CreateCopy(ASTContext &Context,
   return new (Mem) TemplateArgumentList(Args);
 }
 
+void TemplateArgumentList::Profile(llvm::FoldingSetNodeID &ID,
+                                   const ASTContext &Context) const {
+  if (Uniqued) {
+    Context.profileUniquedTemplateArgumentList(ID, this);
+    return;
+  }
+  ID.AddInteger(size());
+  for (const TemplateArgument &Arg : asArray())
+    Arg.Profile(ID, Context);
+}
+
+unsigned TemplateArgumentList::ComputeODRHash(ArrayRef<TemplateArgument> Args) {
+  ODRHash Hasher;
+  for (const TemplateArgument &TA : Args)
+    Hasher.AddTemplateArgument(TA);
+  return Hasher.CalculateHash();
+}
+
 FunctionTemplateSpecializationInfo *FunctionTemplateSpecializationInfo::Create(
     ASTContext &C, FunctionDecl *FD, FunctionTemplateDecl *Template,
     TemplateSpecializationKind TSK, const TemplateArgumentList *TemplateArgs,
@@ -831,7 +875,7 @@ ClassTemplateSpecializationDecl(ASTContext &Context, Kind DK, TagKind TK,
     : CXXRecordDecl(DK, TK, Context, DC, StartLoc, IdLoc,
                     SpecializedTemplate->getIdentifier(), PrevDecl),
     SpecializedTemplate(SpecializedTemplate),
-    TemplateArgs(TemplateArgumentList::CreateCopy(Context, Args)),
+    TemplateArgs(Context.getUniquedTemplateArgumentList(Args)),
     SpecializationKind(TSK_Undeclared) {
 }
 
@@ -1118,7 +1162,9 @@ VarTemplateDecl::newCommon(ASTContext &C) const {
 VarTemplateSpecializationDecl *
 VarTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                     void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), InsertPos, Args);
+  loadLazySpecializationsImpl(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, InsertPos,
+                                Args);
 }
 
 void VarTemplateDecl::AddSpecialization(VarTemplateSpecializationDecl *D,
@@ -1181,7 +1227,7 @@ VarTemplateSpecializationDecl::VarTemplateSpecializationDecl(
     : VarDecl(DK, Context, DC, StartLoc, IdLoc,
               SpecializedTemplate->getIdentifier(), T, TInfo, S),
       SpecializedTemplate(SpecializedTemplate),
-      TemplateArgs(TemplateArgumentList::CreateCopy(Context, Args)),
+      TemplateArgs(Context.getUniquedTemplateArgumentList(Args)),
       SpecializationKind(TSK_Undeclared), IsCompleteDefinition(false) {}
 
 VarTemplateSpecializationDecl::VarTemplateSpecializationDecl(Kind DK,
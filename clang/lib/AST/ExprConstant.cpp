@@ -32,6 +32,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "ConstexprCallCache.h"
+#include "Interp/Context.h"
 #include "clang/AST/APValue.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ASTDiagnostic.h"
@@ -778,6 +780,19 @@ namespace {
     /// depth at which we can mutate state, otherwise 0.
     unsigned SpeculativeEvaluationDepth = 0;
 
+    /// The outermost call stack depth of a mutable object that has been
+    /// accessed, or ~0U if there is none. Objects that are not local to any
+    /// call but whose lifetime began within the evaluation are at depth 0.
+    /// Used to determine whether the result of a call can be memoized.
+    unsigned OutermostMutableAccessDepth = ~0U;
+
+    /// The deepest call stack depth at which a call has been made.
+    unsigned MaxCallStackDepth = 0;
+
+    /// The number of problems that have been diagnosed, including those for
+    /// which no diagnostic was produced because none was requested.
+    unsigned NumDiagnosedProblems = 0;
+
     /// The current array initialization index, if we're performing array
     /// initialization.
     uint64_t ArrayInitIndex = -1;
@@ -874,8 +889,10 @@ namespace {
         FFDiag(Loc, diag::note_constexpr_call_limit_exceeded);
         return false;
       }
-      if (CallStackDepth <= getLangOpts().ConstexprCallDepth)
+      if (CallStackDepth <= getLangOpts().ConstexprCallDepth) {
+        MaxCallStackDepth = std::max(MaxCallStackDepth, CallStackDepth);
         return true;
+      }
       FFDiag(Loc, diag::note_constexpr_depth_limit_exceeded)
         << getLangOpts().ConstexprCallDepth;
       return false;
@@ -971,12 +988,14 @@ namespace {
     FFDiag(SourceLocation Loc,
           diag::kind DiagId = diag::note_invalid_subexpr_in_const_expr,
           unsigned ExtraNotes = 0) {
+      ++NumDiagnosedProblems;
       return Diag(Loc, DiagId, ExtraNotes, false);
     }
 
     OptionalDiagnostic FFDiag(const Expr *E, diag::kind DiagId
                               = diag::note_invalid_subexpr_in_const_expr,
                             unsigned ExtraNotes = 0) {
+      ++NumDiagnosedProblems;
       if (EvalStatus.Diag)
         return Diag(E->getExprLoc(), DiagId, ExtraNotes, /*IsCCEDiag*/false);
       HasActiveDiagnostic = false;
@@ -991,6 +1010,7 @@ namespace {
     OptionalDiagnostic CCEDiag(SourceLocation Loc, diag::kind DiagId
                                  = diag::note_invalid_subexpr_in_const_expr,
                                unsigned ExtraNotes = 0) {
+      ++NumDiagnosedProblems;
       // Don't override a previous diagnostic. Don't bother collecting
       // diagnostics if we're evaluating for overflow.
       if (!EvalStatus.Diag || !EvalStatus.Diag->empty()) {
@@ -2821,10 +2841,23 @@ static void expandStringLiteral(EvalInfo &Info, const StringLiteral *S,
   assert(CharType->isIntegerType() && "unexpected character type");
 
   unsigned Elts = CAT->getSize().getZExtValue();
-  Result = APValue(APValue::UninitArray(),
-                   std::min(S->getLength(), Elts), Elts);
   APSInt Value(S->getCharByteWidth() * Info.Ctx.getCharWidth(),
                CharType->isUnsignedIntegerType());
+
+  // Store the characters compactly; the elements of string literals are
+  // rarely accessed individually as APValues.
+  if (!CharType.isVolatileQualified() && Value.getBitWidth() <= 64) {
+    Result = APValue(APValue::PackedIntArray(), Elts, Value.getBitWidth(),
+                     Value.isUnsigned());
+    for (unsigned I = 0, N = std::min(S->getLength(), Elts); I != N; ++I) {
+      Value = S->getCodeUnit(I);
+      Result.setPackedArrayElt(I, Value);
+    }
+    return;
+  }
+
+  Result = APValue(APValue::UninitArray(),
+                   std::min(S->getLength(), Elts), Elts);
   if (Result.hasArrayFiller())
     Result.getArrayFiller() = APValue(Value);
   for (unsigned I = 0, N = Result.getArrayInitializedElts(); I != N; ++I) {
@@ -2833,6 +2866,43 @@ static void expandStringLiteral(EvalInfo &Info, const StringLiteral *S,
   }
 }
 
+/// Expand an array whose elements are all integers of the same type into a
+/// packed array, if that takes no more memory than storing \p NewElts
+/// elements as APValues would.
+///
+/// \returns false if the array was not packed.
+static bool expandArrayPacked(APValue &Array, unsigned NewElts) {
+  const APValue &Filler = Array.getArrayFiller();
+  if (!Filler.isInt() || Filler.getInt().getBitWidth() > 64)
+    return false;
+  unsigned BitWidth = Filler.getInt().getBitWidth();
+  bool IsUnsigned = Filler.getInt().isUnsigned();
+
+  unsigned Size = Array.getArraySize();
+  uint64_t PackedBytes =
+      uint64_t(Size) * llvm::PowerOf2Ceil((BitWidth + 7) / 8);
+  if (PackedBytes > uint64_t(NewElts) * sizeof(APValue))
+    return false;
+
+  unsigned OldElts = Array.getArrayInitializedElts();
+  for (unsigned I = 0; I != OldElts; ++I) {
+    const APValue &Elt = Array.getArrayInitializedElt(I);
+    if (!Elt.isInt() || Elt.getInt().getBitWidth() != BitWidth ||
+        Elt.getInt().isUnsigned() != IsUnsigned)
+      return false;
+  }
+
+  APValue NewValue(APValue::PackedIntArray(), Size, BitWidth, IsUnsigned);
+  for (unsigned I = 0; I != OldElts; ++I)
+    NewValue.setPackedArrayElt(I, Array.getArrayInitializedElt(I).getInt());
+  // The elements of a packed array start out as zero.
+  if (Filler.getInt() != 0)
+    for (unsigned I = OldElts; I != Size; ++I)
+      NewValue.setPackedArrayElt(I, Filler.getInt());
+  Array.swap(NewValue);
+  return true;
+}
+
 // Expand an array so that it has more than Index filled elements.
 static void expandArray(APValue &Array, unsigned Index) {
   unsigned Size = Array.getArraySize();
@@ -2843,6 +2913,11 @@ static void expandArray(APValue &Array, unsigned Index) {
   unsigned NewElts = std::max(Index+1, OldElts * 2);
   NewElts = std::min(Size, std::max(NewElts, 8u));
 
+  // Arrays of integers are expanded to packed arrays, which store each
+  // element in a few bytes rather than in an APValue.
+  if (expandArrayPacked(Array, NewElts))
+    return;
+
   // Copy the data across.
   APValue NewValue(APValue::UninitArray(), NewElts, Size);
   for (unsigned I = 0; I != OldElts; ++I)
@@ -3099,6 +3174,24 @@ findSubobject(EvalInfo &Info, const Expr *E, const CompleteObject &Obj,
 
       ObjType = CAT->getElementType();
 
+      // Access an element of a packed array through a temporary, storing it
+      // back if it was modified.
+      if (O->isPackedArray() && I == N - 1 &&
+          !ObjType.isVolatileQualified()) {
+        APValue Elt(O->getPackedArrayElt(Index));
+        if (!handler.found(Elt, ObjType))
+          return false;
+        if (isModification(handler.AccessKind)) {
+          if (Elt.isInt() &&
+              Elt.getInt().getBitWidth() == O->getPackedArrayBitWidth() &&
+              Elt.getInt().isUnsigned() == O->isPackedArrayUnsigned())
+            O->setPackedArrayElt(Index, Elt.getInt());
+          else
+            O->getArrayInitializedElt(Index) = std::move(Elt);
+        }
+        return true;
+      }
+
       if (O->getArrayInitializedElts() > Index)
         O = &O->getArrayInitializedElt(Index);
       else if (handler.AccessKind != AK_Read) {
@@ -3391,6 +3484,7 @@ static CompleteObject findCompleteObject(EvalInfo &Info, const Expr *E,
         // OK, we can read and modify an object if we're in the process of
         // evaluating its initializer, because its lifetime began in this
         // evaluation.
+        Info.OutermostMutableAccessDepth = 0;
       } else if (isModification(AK)) {
         // All the remaining cases do not permit modification of the object.
         Info.FFDiag(E, diag::note_constexpr_modify_global);
@@ -3483,6 +3577,7 @@ static CompleteObject findCompleteObject(EvalInfo &Info, const Expr *E,
 
         BaseVal = Info.Ctx.getMaterializedTemporaryValue(MTE, false);
         assert(BaseVal && "got reference to unevaluated temporary");
+        Info.OutermostMutableAccessDepth = 0;
       } else {
         if (!IsAccess)
           return CompleteObject(LVal.getLValueBase(), nullptr, BaseType);
@@ -3501,6 +3596,10 @@ static CompleteObject findCompleteObject(EvalInfo &Info, const Expr *E,
     }
   }
 
+  if (Frame)
+    Info.OutermostMutableAccessDepth =
+        std::min(Info.OutermostMutableAccessDepth, Depth);
+
   // In C++14, we can't safely access any mutable state when we might be
   // evaluating after an unmodeled side effect.
   //
@@ -5136,18 +5235,28 @@ static bool EvaluateArgs(ArrayRef<const Expr *> Args, ArgVector &ArgValues,
   return Success;
 }
 
-/// Evaluate a function call.
-static bool HandleFunctionCall(SourceLocation CallLoc,
-                               const FunctionDecl *Callee, const LValue *This,
-                               ArrayRef<const Expr*> Args, const Stmt *Body,
-                               EvalInfo &Info, APValue &Result,
-                               const LValue *ResultSlot) {
-  ArgVector ArgValues(Args.size());
-  if (!EvaluateArgs(Args, ArgValues, Info, Callee))
-    return false;
-
-  if (!Info.CheckCallLimit(CallLoc))
-    return false;
+/// Evaluate the body of a function for a call whose arguments have been
+/// evaluated.
+static bool EvaluateFunctionBody(SourceLocation CallLoc,
+                                 const FunctionDecl *Callee,
+                                 const LValue *This,
+                                 ArrayRef<const Expr*> Args,
+                                 ArgVector &ArgValues, const Stmt *Body,
+                                 EvalInfo &Info, APValue &Result,
+                                 const LValue *ResultSlot) {
+  // Try the bytecode interpreter first. It consumes evaluation steps exactly
+  // as the evaluation below would, and gives up without diagnosing anything
+  // if it cannot evaluate the call.
+  if (Info.getLangOpts().EnableNewConstInterp && !This &&
+      !Info.checkingPotentialConstantExpression()) {
+    unsigned StepsLeft = Info.StepsLeft;
+    if (Info.Ctx.getInterpContext().evaluateCall(
+            Callee, ArgValues, Info.CallStackDepth, StepsLeft,
+            Info.MaxCallStackDepth, Result)) {
+      Info.StepsLeft = StepsLeft;
+      return true;
+    }
+  }
 
   CallStackFrame Frame(Info, CallLoc, Callee, This, ArgValues.data());
 
@@ -5199,6 +5308,100 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   return ESR == ESR_Returned;
 }
 
+/// Determine whether calls made in the current evaluation can be memoized,
+/// and if so, compute the part of their key that identifies the kind of
+/// evaluation.
+static bool getMemoizationContext(EvalInfo &Info, unsigned &Context) {
+  if (!Info.getLangOpts().ConstexprCacheLimit ||
+      Info.SpeculativeEvaluationDepth ||
+      Info.EvalStatus.HasSideEffects || Info.EvalStatus.HasUndefinedBehavior)
+    return false;
+
+  switch (Info.EvalMode) {
+  case EvalInfo::EM_ConstantExpression:
+  case EvalInfo::EM_ConstantExpressionUnevaluated:
+  case EvalInfo::EM_ConstantFold:
+  case EvalInfo::EM_IgnoreSideEffects:
+    // The result of a call can depend on the evaluation mode and on whether
+    // the call is in a constant context, but nothing else the call does not
+    // access.
+    Context = Info.EvalMode * 2 + Info.InConstantContext;
+    return true;
+
+  case EvalInfo::EM_PotentialConstantExpression:
+  case EvalInfo::EM_PotentialConstantExpressionUnevaluated:
+  case EvalInfo::EM_EvaluateForOverflow:
+    // These evaluations diagnose problems themselves, or do not produce
+    // complete results.
+    return false;
+  }
+  llvm_unreachable("Missed EvalMode case");
+}
+
+/// Evaluate a function call.
+static bool HandleFunctionCall(SourceLocation CallLoc,
+                               const FunctionDecl *Callee, const LValue *This,
+                               ArrayRef<const Expr*> Args, const Stmt *Body,
+                               EvalInfo &Info, APValue &Result,
+                               const LValue *ResultSlot) {
+  ArgVector ArgValues(Args.size());
+  if (!EvaluateArgs(Args, ArgValues, Info, Callee))
+    return false;
+
+  if (!Info.CheckCallLimit(CallLoc))
+    return false;
+
+  // Calls to functions other than non-static member functions, whose
+  // arguments do not refer to any object, are memoized.
+  unsigned Context;
+  if (This || !getMemoizationContext(Info, Context) ||
+      !llvm::all_of(ArgValues, ConstexprCallCache::isCacheableValue))
+    return EvaluateFunctionBody(CallLoc, Callee, This, Args, ArgValues, Body,
+                                Info, Result, ResultSlot);
+
+  ConstexprCallCache &Cache = Info.Ctx.getConstexprCallCache();
+  llvm::FoldingSetNodeID ID;
+  ConstexprCallCache::profileCall(ID, Callee, Context, ArgValues);
+  if (const ConstexprCallCache::Entry *Cached = Cache.lookup(ID)) {
+    // Charge the call's steps and depth again, so that the limits behave as
+    // if the call were evaluated. If they would be exceeded, evaluate the
+    // call to produce the diagnostic.
+    unsigned Depth = Info.CallStackDepth + Cached->Depth;
+    if (Cached->Steps <= Info.StepsLeft &&
+        Depth <= Info.getLangOpts().ConstexprCallDepth) {
+      Info.StepsLeft -= Cached->Steps;
+      Info.MaxCallStackDepth = std::max(Info.MaxCallStackDepth, Depth);
+      Result = Cached->Result;
+      return true;
+    }
+  }
+
+  unsigned OldAccessDepth = Info.OutermostMutableAccessDepth;
+  unsigned OldMaxDepth = Info.MaxCallStackDepth;
+  unsigned OldNumProblems = Info.NumDiagnosedProblems;
+  unsigned OldStepsLeft = Info.StepsLeft;
+  Info.OutermostMutableAccessDepth = ~0U;
+  Info.MaxCallStackDepth = Info.CallStackDepth;
+
+  bool Success = EvaluateFunctionBody(CallLoc, Callee, This, Args, ArgValues,
+                                      Body, Info, Result, ResultSlot);
+
+  // The result can be reused if the call only accessed objects local to it,
+  // and neither noted any problem nor depended on the evaluation mode.
+  if (Success && Info.NumDiagnosedProblems == OldNumProblems &&
+      Info.OutermostMutableAccessDepth > Info.CallStackDepth &&
+      !Info.EvalStatus.HasSideEffects &&
+      !Info.EvalStatus.HasUndefinedBehavior &&
+      ConstexprCallCache::isCacheableValue(Result))
+    Cache.insert(ID, Result, OldStepsLeft - Info.StepsLeft,
+                 Info.MaxCallStackDepth - Info.CallStackDepth);
+
+  Info.OutermostMutableAccessDepth =
+      std::min(OldAccessDepth, Info.OutermostMutableAccessDepth);
+  Info.MaxCallStackDepth = std::max(OldMaxDepth, Info.MaxCallStackDepth);
+  return Success;
+}
+
 /// Evaluate a constructor call.
 static bool HandleConstructorCall(const Expr *E, const LValue &This,
                                   APValue *ArgValues,
@@ -0,0 +1,139 @@
+//===--- ByteCode.h - Bytecode for the constant interpreter -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Defines the instructions executed by the constant interpreter and the
+// compiled form of a function.
+//
+// Every value handled by the interpreter is an integer of at most 64 bits. A
+// value is kept in a uint64_t, sign-extended if its type is signed and
+// zero-extended otherwise. Instructions that depend on the type of their
+// operands carry its width and signedness.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_AST_INTERP_BYTECODE_H
+#define LLVM_CLANG_LIB_AST_INTERP_BYTECODE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/MathExtras.h"
+#include <cstdint>
+#include <vector>
+
+namespace clang {
+class FunctionDecl;
+
+namespace interp {
+
+enum class Opcode : uint8_t {
+  /// Push the constant \c Arg.
+  Const,
+  /// Push the value of local slot \c Arg. Fails if it is uninitialized.
+  Load,
+  /// Pop a value and store it in local slot \c Arg.
+  Store,
+  /// Mark local slot \c Arg as uninitialized.
+  Kill,
+  /// Discard the value on top of the stack.
+  Pop,
+  /// Consume one evaluation step. Fails if there are none left.
+  Step,
+  /// Jump to instruction \c Arg.
+  Jmp,
+  /// Pop a value and jump to instruction \c Arg if it is zero.
+  Jf,
+  /// Pop a value and jump to instruction \c Arg if it is not zero.
+  Jt,
+
+  // Unary operations.
+  Neg,
+  Not,
+  LNot,
+  /// Convert the value on top of the stack to the instruction's type.
+  Cast,
+
+  // Binary operations. Shifts use \c Arg to record whether their right
+  // operand is signed.
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Rem,
+  Shl,
+  Shr,
+  And,
+  Or,
+  Xor,
+  LT,
+  LE,
+  GT,
+  GE,
+  EQ,
+  NE,
+
+  /// Call callee \c Arg of the current function. Its arguments are on top of
+  /// the stack, the last one topmost.
+  Call,
+  /// Pop the return value and return from the current function.
+  Ret,
+  /// Fail: control flowed off the end of a function.
+  NoReturn,
+};
+
+struct Instr {
+  Opcode Op;
+  /// The width of the type the instruction operates on.
+  uint8_t Width;
+  /// Whether the type the instruction operates on is signed.
+  bool Signed;
+  uint64_t Arg;
+};
+
+/// Convert the low \p Width bits of \p Value to the representation of a
+/// value of a type of that width and signedness.
+inline uint64_t normalize(uint64_t Value, unsigned Width, bool Signed) {
+  if (Width == 64)
+    return Value;
+  if (Signed)
+    return static_cast<uint64_t>(llvm::SignExtend64(Value, Width));
+  return Value & llvm::maskTrailingOnes<uint64_t>(Width);
+}
+
+/// The bytecode of a function, compiled once and executed for each call.
+class Function {
+public:
+  explicit Function(const FunctionDecl *FD) : FD(FD) {}
+
+  const FunctionDecl *getDecl() const { return FD; }
+
+  /// Whether the function could be compiled. Calls to functions that could
+  /// not be compiled cannot be interpreted.
+  bool isValid() const { return Valid; }
+
+  ArrayRef<Instr> getCode() const { return Code; }
+  unsigned getNumParams() const { return NumParams; }
+  unsigned getNumSlots() const { return NumSlots; }
+  const Function *getCallee(unsigned I) const { return Callees[I]; }
+
+private:
+  friend class Compiler;
+
+  const FunctionDecl *FD;
+  bool Valid = false;
+  std::vector<Instr> Code;
+  /// The functions called by this one, referenced by \c Opcode::Call.
+  std::vector<const Function *> Callees;
+  unsigned NumParams = 0;
+  /// The number of local slots, the parameters being the first ones.
+  unsigned NumSlots = 0;
+};
+
+} // namespace interp
+} // namespace clang
+
+#endif
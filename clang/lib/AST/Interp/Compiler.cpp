@@ -0,0 +1,568 @@
+//===--- Compiler.cpp - Bytecode compiler for the constant interpreter ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Compiler.h"
+#include "Context.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/StmtCXX.h"
+#include "llvm/ADT/Optional.h"
+
+using namespace clang;
+using namespace clang::interp;
+
+Compiler::Compiler(Context &Ctx, Function &F)
+    : Ctx(Ctx), AST(Ctx.getASTContext()), F(F) {}
+
+bool Compiler::compileFunction(const FunctionDecl *Def, const Stmt *Body) {
+  if (Def->isVariadic() || !Ctx.isSupportedType(Def->getReturnType()))
+    return false;
+
+  for (const ParmVarDecl *PD : Def->parameters()) {
+    unsigned Slot;
+    if (!declareLocal(PD, Slot))
+      return false;
+  }
+  F.NumParams = Def->getNumParams();
+
+  if (!compileStmt(Body))
+    return false;
+  emit(Opcode::NoReturn);
+
+  F.Valid = true;
+  return true;
+}
+
+bool Compiler::declareLocal(const VarDecl *VD, unsigned &Slot) {
+  if (!VD->hasLocalStorage() || !Ctx.isSupportedType(VD->getType()))
+    return false;
+  Slot = F.NumSlots++;
+  Locals[VD] = Slot;
+  return true;
+}
+
+void Compiler::emit(Opcode Op, QualType T, uint64_t Arg) {
+  Instr I = {Op, 0, false, Arg};
+  if (!T.isNull()) {
+    I.Width = AST.getIntWidth(T);
+    I.Signed = T->isSignedIntegerOrEnumerationType();
+  }
+  F.Code.push_back(I);
+}
+
+void Compiler::emitConst(QualType T, uint64_t Value) {
+  emit(Opcode::Const, T,
+       normalize(Value, AST.getIntWidth(T),
+                 T->isSignedIntegerOrEnumerationType()));
+}
+
+void Compiler::emitConversion(QualType From, QualType To) {
+  // Conversions to bool test against zero rather than truncate.
+  if (To->isBooleanType()) {
+    emitConst(From, 0);
+    emit(Opcode::NE, From);
+    return;
+  }
+  emit(Opcode::Cast, To);
+}
+
+size_t Compiler::emitJump(Opcode Op) {
+  emit(Op);
+  return here() - 1;
+}
+
+void Compiler::patch(size_t Jump, size_t Target) {
+  F.Code[Jump].Arg = Target;
+}
+
+bool Compiler::compileLoopBody(const Stmt *Body, Loop &L) {
+  Loops.push_back(&L);
+  bool Compiled = compileStmt(Body);
+  Loops.pop_back();
+  return Compiled;
+}
+
+void Compiler::patchLoop(const Loop &L, size_t ContinueTarget,
+                         size_t BreakTarget) {
+  for (size_t Jump : L.Continues)
+    patch(Jump, ContinueTarget);
+  for (size_t Jump : L.Breaks)
+    patch(Jump, BreakTarget);
+}
+
+bool Compiler::compileStmt(const Stmt *S) {
+  emit(Opcode::Step);
+
+  switch (S->getStmtClass()) {
+  default:
+    if (const Expr *E = dyn_cast<Expr>(S))
+      return compileDiscarded(E);
+    return false;
+
+  case Stmt::NullStmtClass:
+    return true;
+
+  case Stmt::CompoundStmtClass:
+    for (const Stmt *Child : cast<CompoundStmt>(S)->body())
+      if (!compileStmt(Child))
+        return false;
+    return true;
+
+  case Stmt::DeclStmtClass:
+    for (const Decl *D : cast<DeclStmt>(S)->decls()) {
+      const VarDecl *VD = dyn_cast<VarDecl>(D);
+      if (!VD)
+        continue;
+      unsigned Slot;
+      if (!declareLocal(VD, Slot))
+        return false;
+      if (const Expr *Init = VD->getInit()) {
+        if (!compileExpr(Init))
+          return false;
+        emit(Opcode::Store, QualType(), Slot);
+      } else {
+        emit(Opcode::Kill, QualType(), Slot);
+      }
+    }
+    return true;
+
+  case Stmt::ReturnStmtClass: {
+    const Expr *RetExpr = cast<ReturnStmt>(S)->getRetValue();
+    if (!RetExpr || !compileExpr(RetExpr))
+      return false;
+    emit(Opcode::Ret);
+    return true;
+  }
+
+  case Stmt::IfStmtClass: {
+    const IfStmt *IS = cast<IfStmt>(S);
+    if (IS->getConditionVariable())
+      return false;
+    if (const Stmt *Init = IS->getInit())
+      if (!compileStmt(Init))
+        return false;
+    if (!compileExpr(IS->getCond()))
+      return false;
+    size_t ToElse = emitJump(Opcode::Jf);
+    if (!compileStmt(IS->getThen()))
+      return false;
+    if (const Stmt *Else = IS->getElse()) {
+      size_t ToEnd = emitJump(Opcode::Jmp);
+      patch(ToElse, here());
+      if (!compileStmt(Else))
+        return false;
+      patch(ToEnd, here());
+    } else {
+      patch(ToElse, here());
+    }
+    return true;
+  }
+
+  case Stmt::WhileStmtClass: {
+    const WhileStmt *WS = cast<WhileStmt>(S);
+    if (WS->getConditionVariable())
+      return false;
+    size_t Start = here();
+    if (!compileExpr(WS->getCond()))
+      return false;
+    size_t ToEnd = emitJump(Opcode::Jf);
+    Loop L;
+    if (!compileLoopBody(WS->getBody(), L))
+      return false;
+    patch(emitJump(Opcode::Jmp), Start);
+    patch(ToEnd, here());
+    patchLoop(L, Start, here());
+    return true;
+  }
+
+  case Stmt::DoStmtClass: {
+    const DoStmt *DS = cast<DoStmt>(S);
+    size_t Start = here();
+    Loop L;
+    if (!compileLoopBody(DS->getBody(), L))
+      return false;
+    size_t Cond = here();
+    if (!compileExpr(DS->getCond()))
+      return false;
+    patch(emitJump(Opcode::Jt), Start);
+    patchLoop(L, Cond, here());
+    return true;
+  }
+
+  case Stmt::ForStmtClass: {
+    const ForStmt *FS = cast<ForStmt>(S);
+    if (FS->getConditionVariable())
+      return false;
+    if (const Stmt *Init = FS->getInit())
+      if (!compileStmt(Init))
+        return false;
+    size_t Start = here();
+    Optional<size_t> ToEnd;
+    if (const Expr *Cond = FS->getCond()) {
+      if (!compileExpr(Cond))
+        return false;
+      ToEnd = emitJump(Opcode::Jf);
+    }
+    Loop L;
+    if (!compileLoopBody(FS->getBody(), L))
+      return false;
+    size_t Inc = here();
+    if (FS->getInc() && !compileDiscarded(FS->getInc()))
+      return false;
+    patch(emitJump(Opcode::Jmp), Start);
+    if (ToEnd)
+      patch(*ToEnd, here());
+    patchLoop(L, Inc, here());
+    return true;
+  }
+
+  case Stmt::BreakStmtClass:
+    // 'break' out of a switch is not supported, and neither are switches.
+    if (Loops.empty())
+      return false;
+    Loops.back()->Breaks.push_back(emitJump(Opcode::Jmp));
+    return true;
+
+  case Stmt::ContinueStmtClass:
+    if (Loops.empty())
+      return false;
+    Loops.back()->Continues.push_back(emitJump(Opcode::Jmp));
+    return true;
+  }
+}
+
+bool Compiler::compileDiscarded(const Expr *E) {
+  E = E->IgnoreParens();
+  if (const auto *CE = dyn_cast<CastExpr>(E))
+    if (CE->getCastKind() == CK_ToVoid)
+      return compileDiscarded(CE->getSubExpr());
+
+  if (E->isGLValue()) {
+    unsigned Slot;
+    return compileLValue(E, Slot);
+  }
+
+  if (!compileExpr(E))
+    return false;
+  emit(Opcode::Pop);
+  return true;
+}
+
+bool Compiler::compileLValue(const Expr *E, unsigned &Slot) {
+  E = E->IgnoreParens();
+
+  if (const auto *DRE = dyn_cast<DeclRefExpr>(E)) {
+    const auto *VD = dyn_cast<VarDecl>(DRE->getDecl());
+    auto It = VD ? Locals.find(VD) : Locals.end();
+    if (It == Locals.end())
+      return false;
+    Slot = It->second;
+    return true;
+  }
+
+  if (const auto *CE = dyn_cast<ImplicitCastExpr>(E)) {
+    if (CE->getCastKind() != CK_NoOp)
+      return false;
+    return compileLValue(CE->getSubExpr(), Slot);
+  }
+
+  if (const auto *UO = dyn_cast<UnaryOperator>(E)) {
+    if (!UO->isPrefix() || !UO->isIncrementDecrementOp())
+      return false;
+    if (!compileLValue(UO->getSubExpr(), Slot))
+      return false;
+    return compileIncDec(UO, Slot);
+  }
+
+  if (const auto *CAO = dyn_cast<CompoundAssignOperator>(E)) {
+    if (!compileLValue(CAO->getLHS(), Slot))
+      return false;
+    return compileCompoundAssign(CAO, Slot);
+  }
+
+  if (const auto *BO = dyn_cast<BinaryOperator>(E)) {
+    switch (BO->getOpcode()) {
+    case BO_Assign:
+      if (!compileLValue(BO->getLHS(), Slot) || !compileExpr(BO->getRHS()))
+        return false;
+      emit(Opcode::Store, QualType(), Slot);
+      return true;
+    case BO_Comma:
+      return compileDiscarded(BO->getLHS()) &&
+             compileLValue(BO->getRHS(), Slot);
+    default:
+      return false;
+    }
+  }
+
+  return false;
+}
+
+bool Compiler::compileIncDec(const UnaryOperator *E, unsigned Slot) {
+  QualType T = E->getSubExpr()->getType();
+  if (T->isBooleanType())
+    return false;
+
+  // A postfix operation leaves the old value on the stack.
+  if (E->isPostfix())
+    emit(Opcode::Load, QualType(), Slot);
+  emit(Opcode::Load, QualType(), Slot);
+  emitConst(T, 1);
+  Opcode Op = E->isIncrementOp() ? Opcode::Add : Opcode::Sub;
+  if (E->canOverflow()) {
+    emit(Op, T);
+  } else {
+    // The operation is performed in a promoted type and converted back, so
+    // it wraps around rather than overflows.
+    emit(Op, AST.UnsignedLongLongTy);
+    emit(Opcode::Cast, T);
+  }
+  emit(Opcode::Store, QualType(), Slot);
+  return true;
+}
+
+/// Map an arithmetic or comparison operator to its instruction.
+static bool getBinaryOpcode(BinaryOperatorKind BO, Opcode &Op) {
+  switch (BO) {
+  case BO_Mul: Op = Opcode::Mul; return true;
+  case BO_Div: Op = Opcode::Div; return true;
+  case BO_Rem: Op = Opcode::Rem; return true;
+  case BO_Add: Op = Opcode::Add; return true;
+  case BO_Sub: Op = Opcode::Sub; return true;
+  case BO_Shl: Op = Opcode::Shl; return true;
+  case BO_Shr: Op = Opcode::Shr; return true;
+  case BO_LT:  Op = Opcode::LT;  return true;
+  case BO_GT:  Op = Opcode::GT;  return true;
+  case BO_LE:  Op = Opcode::LE;  return true;
+  case BO_GE:  Op = Opcode::GE;  return true;
+  case BO_EQ:  Op = Opcode::EQ;  return true;
+  case BO_NE:  Op = Opcode::NE;  return true;
+  case BO_And: Op = Opcode::And; return true;
+  case BO_Xor: Op = Opcode::Xor; return true;
+  case BO_Or:  Op = Opcode::Or;  return true;
+  default:
+    return false;
+  }
+}
+
+bool Compiler::compileCompoundAssign(const CompoundAssignOperator *E,
+                                     unsigned Slot) {
+  QualType LHSTy = E->getLHS()->getType();
+  QualType ComputationTy = E->getComputationLHSType();
+  Opcode Op;
+  if (!getBinaryOpcode(BinaryOperator::getOpForCompoundAssignment(
+                           E->getOpcode()),
+                       Op) ||
+      !Ctx.isSupportedType(ComputationTy) ||
+      !Ctx.isSupportedType(E->getComputationResultType()))
+    return false;
+
+  emit(Opcode::Load, QualType(), Slot);
+  emit(Opcode::Cast, ComputationTy);
+  if (!compileExpr(E->getRHS()))
+    return false;
+  emit(Op, ComputationTy,
+       E->getRHS()->getType()->isSignedIntegerOrEnumerationType());
+  emitConversion(E->getComputationResultType(), LHSTy);
+  emit(Opcode::Store, QualType(), Slot);
+  return true;
+}
+
+bool Compiler::compileExpr(const Expr *E) {
+  if (!E->isRValue() || !Ctx.isSupportedType(E->getType()))
+    return false;
+  QualType T = E->getType();
+
+  switch (E->getStmtClass()) {
+  default:
+    return false;
+
+  case Stmt::ParenExprClass:
+    return compileExpr(cast<ParenExpr>(E)->getSubExpr());
+
+  case Stmt::ConstantExprClass:
+    return compileExpr(cast<ConstantExpr>(E)->getSubExpr());
+
+  case Stmt::SubstNonTypeTemplateParmExprClass:
+    return compileExpr(
+        cast<SubstNonTypeTemplateParmExpr>(E)->getReplacement());
+
+  case Stmt::CXXDefaultArgExprClass:
+    return compileExpr(cast<CXXDefaultArgExpr>(E)->getExpr());
+
+  case Stmt::IntegerLiteralClass:
+    emitConst(T, cast<IntegerLiteral>(E)->getValue().getZExtValue());
+    return true;
+
+  case Stmt::CharacterLiteralClass:
+    emitConst(T, cast<CharacterLiteral>(E)->getValue());
+    return true;
+
+  case Stmt::CXXBoolLiteralExprClass:
+    emitConst(T, cast<CXXBoolLiteralExpr>(E)->getValue());
+    return true;
+
+  case Stmt::CXXScalarValueInitExprClass:
+  case Stmt::ImplicitValueInitExprClass:
+    emitConst(T, 0);
+    return true;
+
+  case Stmt::InitListExprClass: {
+    const InitListExpr *ILE = cast<InitListExpr>(E);
+    if (ILE->getNumInits() == 0) {
+      emitConst(T, 0);
+      return true;
+    }
+    return ILE->getNumInits() == 1 && compileExpr(ILE->getInit(0));
+  }
+
+  case Stmt::DeclRefExprClass: {
+    const auto *ECD =
+        dyn_cast<EnumConstantDecl>(cast<DeclRefExpr>(E)->getDecl());
+    if (!ECD)
+      return false;
+    emitConst(T, ECD->getInitVal().getExtValue());
+    return true;
+  }
+
+  case Stmt::ImplicitCastExprClass:
+  case Stmt::CStyleCastExprClass:
+  case Stmt::CXXFunctionalCastExprClass:
+  case Stmt::CXXStaticCastExprClass: {
+    const CastExpr *CE = cast<CastExpr>(E);
+    const Expr *SubExpr = CE->getSubExpr();
+    switch (CE->getCastKind()) {
+    case CK_LValueToRValue: {
+      unsigned Slot;
+      if (SubExpr->getType().isVolatileQualified() ||
+          !compileLValue(SubExpr, Slot))
+        return false;
+      emit(Opcode::Load, QualType(), Slot);
+      return true;
+    }
+    case CK_NoOp:
+      return compileExpr(SubExpr);
+    case CK_IntegralCast:
+    case CK_IntegralToBoolean:
+      if (!compileExpr(SubExpr))
+        return false;
+      emitConversion(SubExpr->getType(), T);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  case Stmt::UnaryOperatorClass: {
+    const UnaryOperator *UO = cast<UnaryOperator>(E);
+    switch (UO->getOpcode()) {
+    case UO_PostInc:
+    case UO_PostDec: {
+      unsigned Slot;
+      return compileLValue(UO->getSubExpr(), Slot) && compileIncDec(UO, Slot);
+    }
+    case UO_Plus:
+    case UO_Extension:
+      return compileExpr(UO->getSubExpr());
+    case UO_Minus:
+      if (!compileExpr(UO->getSubExpr()))
+        return false;
+      emit(Opcode::Neg, T);
+      return true;
+    case UO_Not:
+      if (!compileExpr(UO->getSubExpr()))
+        return false;
+      emit(Opcode::Not, T);
+      return true;
+    case UO_LNot:
+      if (!compileExpr(UO->getSubExpr()))
+        return false;
+      emit(Opcode::LNot, T);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  case Stmt::BinaryOperatorClass: {
+    const BinaryOperator *BO = cast<BinaryOperator>(E);
+    switch (BO->getOpcode()) {
+    case BO_Comma:
+      return compileDiscarded(BO->getLHS()) && compileExpr(BO->getRHS());
+
+    case BO_LAnd:
+    case BO_LOr: {
+      bool IsAnd = BO->getOpcode() == BO_LAnd;
+      if (!compileExpr(BO->getLHS()))
+        return false;
+      size_t ToShortCircuit = emitJump(IsAnd ? Opcode::Jf : Opcode::Jt);
+      if (!compileExpr(BO->getRHS()))
+        return false;
+      size_t ToEnd = emitJump(Opcode::Jmp);
+      patch(ToShortCircuit, here());
+      emitConst(T, IsAnd ? 0 : 1);
+      patch(ToEnd, here());
+      return true;
+    }
+
+    default: {
+      Opcode Op;
+      QualType LHSTy = BO->getLHS()->getType();
+      if (!getBinaryOpcode(BO->getOpcode(), Op) ||
+          !Ctx.isSupportedType(LHSTy))
+        return false;
+      if (!compileExpr(BO->getLHS()) || !compileExpr(BO->getRHS()))
+        return false;
+      // For shifts, also record the signedness of the shift amount.
+      emit(Op, LHSTy,
+           BO->getRHS()->getType()->isSignedIntegerOrEnumerationType());
+      return true;
+    }
+    }
+  }
+
+  case Stmt::ConditionalOperatorClass: {
+    const ConditionalOperator *CO = cast<ConditionalOperator>(E);
+    if (!compileExpr(CO->getCond()))
+      return false;
+    size_t ToFalse = emitJump(Opcode::Jf);
+    if (!compileExpr(CO->getTrueExpr()))
+      return false;
+    size_t ToEnd = emitJump(Opcode::Jmp);
+    patch(ToFalse, here());
+    if (!compileExpr(CO->getFalseExpr()))
+      return false;
+    patch(ToEnd, here());
+    return true;
+  }
+
+  case Stmt::CallExprClass:
+  case Stmt::CXXOperatorCallExprClass: {
+    const CallExpr *CE = cast<CallExpr>(E);
+    const FunctionDecl *Callee = CE->getDirectCallee();
+    if (!Callee || Callee->getBuiltinID() ||
+        CE->getNumArgs() != Callee->getNumParams())
+      return false;
+    if (const auto *MD = dyn_cast<CXXMethodDecl>(Callee))
+      if (!MD->isStatic())
+        return false;
+
+    const Function *CalleeFunc = Ctx.getFunction(Callee);
+    if (!CalleeFunc)
+      return false;
+    for (const Expr *Arg : CE->arguments())
+      if (!compileExpr(Arg))
+        return false;
+    F.Callees.push_back(CalleeFunc);
+    emit(Opcode::Call, QualType(), F.Callees.size() - 1);
+    return true;
+  }
+  }
+}
@@ -0,0 +1,91 @@
+//===--- Compiler.h - Bytecode compiler for the constant interpreter ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Defines the compiler that translates the body of a constexpr function to
+// the bytecode run by the constant interpreter.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_AST_INTERP_COMPILER_H
+#define LLVM_CLANG_LIB_AST_INTERP_COMPILER_H
+
+#include "ByteCode.h"
+#include "clang/AST/Type.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace clang {
+class ASTContext;
+class CompoundAssignOperator;
+class Expr;
+class Stmt;
+class UnaryOperator;
+class VarDecl;
+
+namespace interp {
+class Context;
+
+class Compiler {
+public:
+  Compiler(Context &Ctx, Function &F);
+
+  /// Compile \p Body, the body of the definition \p Def, into the function.
+  ///
+  /// \returns false if the function uses a construct the interpreter does
+  /// not support, in which case the function is left invalid.
+  bool compileFunction(const FunctionDecl *Def, const Stmt *Body);
+
+private:
+  /// The jumps out of a loop that is being compiled.
+  struct Loop {
+    SmallVector<size_t, 2> Breaks;
+    SmallVector<size_t, 2> Continues;
+  };
+
+  /// Compile a statement; every statement consumes one evaluation step, as
+  /// it does in the tree-walking evaluator.
+  bool compileStmt(const Stmt *S);
+  /// Compile an expression whose value is pushed on the stack.
+  bool compileExpr(const Expr *E);
+  /// Compile an expression that is only evaluated for its side effects.
+  bool compileDiscarded(const Expr *E);
+  /// Compile a glvalue expression that designates a local in \p Slot.
+  bool compileLValue(const Expr *E, unsigned &Slot);
+
+  bool compileIncDec(const UnaryOperator *E, unsigned Slot);
+  bool compileCompoundAssign(const CompoundAssignOperator *E, unsigned Slot);
+  /// Compile the body of a loop, recording its \c break and \c continue
+  /// jumps in \p L.
+  bool compileLoopBody(const Stmt *Body, Loop &L);
+  /// Point the jumps recorded in \p L at their targets.
+  void patchLoop(const Loop &L, size_t ContinueTarget, size_t BreakTarget);
+
+  /// Allocate a slot for \p VD.
+  bool declareLocal(const VarDecl *VD, unsigned &Slot);
+
+  void emit(Opcode Op, QualType T = QualType(), uint64_t Arg = 0);
+  void emitConst(QualType T, uint64_t Value);
+  /// Emit an integral conversion of the value on top of the stack.
+  void emitConversion(QualType From, QualType To);
+  /// Emit a jump whose target is filled in by \c patch.
+  size_t emitJump(Opcode Op);
+  void patch(size_t Jump, size_t Target);
+  size_t here() const { return F.Code.size(); }
+
+  Context &Ctx;
+  ASTContext &AST;
+  Function &F;
+  llvm::DenseMap<const VarDecl *, unsigned> Locals;
+  /// The loops enclosing the statement being compiled, innermost last.
+  SmallVector<Loop *, 4> Loops;
+};
+
+} // namespace interp
+} // namespace clang
+
+#endif
@@ -0,0 +1,81 @@
+//===--- Context.cpp - Context for the constant interpreter ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Context.h"
+#include "ByteCode.h"
+#include "Compiler.h"
+#include "Interp.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "llvm/ADT/SmallVector.h"
+
+using namespace clang;
+using namespace clang::interp;
+
+Context::Context(ASTContext &Ctx) : Ctx(Ctx) {}
+
+Context::~Context() {}
+
+bool Context::isSupportedType(QualType T) const {
+  if (T.isVolatileQualified() || T->isIncompleteType() ||
+      !T->isIntegralOrEnumerationType())
+    return false;
+  return Ctx.getIntWidth(T) <= 64;
+}
+
+const Function *Context::getFunction(const FunctionDecl *FD) {
+  const FunctionDecl *Def = nullptr;
+  const Stmt *Body = FD->getBody(Def);
+  if (!Body || !Def->isConstexpr() || Def->isInvalidDecl() ||
+      FD->isInvalidDecl())
+    return nullptr;
+
+  auto Known = Functions.find(Def);
+  if (Known != Functions.end())
+    return Known->second.get();
+
+  // Register the function before compiling it, so that recursive calls refer
+  // to it. Compiling may add further functions to the map.
+  Function *F = new Function(Def);
+  Functions[Def].reset(F);
+  Compiler(*this, *F).compileFunction(Def, Body);
+  return F;
+}
+
+bool Context::evaluateCall(const FunctionDecl *FD, ArrayRef<APValue> Args,
+                           unsigned Depth, unsigned &StepsLeft,
+                           unsigned &MaxDepth, APValue &Result) {
+  const Function *F = getFunction(FD);
+  if (!F || !F->isValid() || Args.size() != F->getNumParams())
+    return false;
+
+  SmallVector<uint64_t, 8> ArgValues;
+  for (const APValue &Arg : Args) {
+    if (!Arg.isInt())
+      return false;
+    const APSInt &Value = Arg.getInt();
+    ArgValues.push_back(Value.isSigned()
+                            ? static_cast<uint64_t>(Value.getSExtValue())
+                            : Value.getZExtValue());
+  }
+
+  unsigned Steps = StepsLeft;
+  unsigned ReachedDepth = MaxDepth;
+  uint64_t Value;
+  if (!interpret(Ctx.getLangOpts(), *F, ArgValues, Depth, Steps, ReachedDepth,
+                 Value))
+    return false;
+  StepsLeft = Steps;
+  MaxDepth = ReachedDepth;
+
+  QualType RetTy = FD->getReturnType();
+  unsigned Width = Ctx.getIntWidth(RetTy);
+  bool Signed = RetTy->isSignedIntegerOrEnumerationType();
+  Result = APValue(APSInt(APInt(Width, Value, Signed), !Signed));
+  return true;
+}
@@ -0,0 +1,76 @@
+//===--- Context.h - Context for the constant interpreter -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Defines the entry point of the bytecode interpreter for constant
+// evaluation, enabled by -fexperimental-new-constant-interpreter.
+//
+// Function bodies are compiled to bytecode the first time they are called and
+// the bytecode is kept for the lifetime of the ASTContext. The interpreter
+// only supports a subset of the language: integer locals and parameters,
+// arithmetic, control flow and calls between such functions. It never
+// diagnoses anything; when it encounters an unsupported construct or an
+// evaluation that is not a constant expression, it gives up and the caller
+// evaluates the call with the tree-walking evaluator instead.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_AST_INTERP_CONTEXT_H
+#define LLVM_CLANG_LIB_AST_INTERP_CONTEXT_H
+
+#include "clang/AST/APValue.h"
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include <memory>
+
+namespace clang {
+class ASTContext;
+class FunctionDecl;
+class QualType;
+
+namespace interp {
+class Function;
+
+class Context {
+public:
+  Context(ASTContext &Ctx);
+  ~Context();
+
+  /// Evaluate a call to \p FD with the given arguments.
+  ///
+  /// \param Depth The depth of the call stack at the point of the call.
+  /// \param StepsLeft The number of evaluation steps left. On success, it is
+  /// reduced by the steps the call used, exactly as the tree-walking
+  /// evaluator would have.
+  /// \param MaxDepth Raised to the deepest call stack depth the call reaches,
+  /// counting nested calls as the tree-walking evaluator would.
+  ///
+  /// \returns true if the call was evaluated and \p Result holds its value,
+  /// false if it must be evaluated by other means.
+  bool evaluateCall(const FunctionDecl *FD, ArrayRef<APValue> Args,
+                    unsigned Depth, unsigned &StepsLeft, unsigned &MaxDepth,
+                    APValue &Result);
+
+  ASTContext &getASTContext() const { return Ctx; }
+
+  /// Whether values of type \p T can be handled by the interpreter.
+  bool isSupportedType(QualType T) const;
+
+  /// Retrieve the compiled form of \p FD, compiling it if needed.
+  ///
+  /// \returns null if \p FD has no constexpr definition.
+  const Function *getFunction(const FunctionDecl *FD);
+
+private:
+  ASTContext &Ctx;
+  llvm::DenseMap<const FunctionDecl *, std::unique_ptr<Function>> Functions;
+};
+
+} // namespace interp
+} // namespace clang
+
+#endif
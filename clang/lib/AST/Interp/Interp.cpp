@@ -0,0 +1,289 @@
+//===--- Interp.cpp - Execution loop of the constant interpreter ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The arithmetic below mirrors the checks of the tree-walking evaluator:
+// every operation it would diagnose as not being a constant expression makes
+// the interpreter give up instead.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Interp.h"
+#include "ByteCode.h"
+#include "clang/Basic/LangOptions.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/SmallVector.h"
+#include <algorithm>
+
+using namespace clang;
+using namespace clang::interp;
+
+namespace {
+struct Frame {
+  const Function *F;
+  size_t PC;
+  /// The index of the first local slot of the function.
+  size_t SlotBase;
+};
+} // namespace
+
+static int64_t minSigned(unsigned Width) {
+  return Width == 64 ? INT64_MIN : -(int64_t(1) << (Width - 1));
+}
+
+/// Perform a signed add, subtract or multiply, failing on overflow.
+static bool signedArith(Opcode Op, unsigned Width, int64_t LHS, int64_t RHS,
+                        uint64_t &Result) {
+  if (Op == Opcode::Mul && Width > 32) {
+    llvm::APInt Product =
+        llvm::APInt(128, LHS, /*isSigned=*/true) *
+        llvm::APInt(128, RHS, /*isSigned=*/true);
+    if (!Product.isSignedIntN(Width))
+      return false;
+    Result = static_cast<uint64_t>(Product.getSExtValue());
+    return true;
+  }
+
+  int64_t Value;
+  if (Width == 64) {
+    uint64_t U = Op == Opcode::Add ? uint64_t(LHS) + uint64_t(RHS)
+                                   : uint64_t(LHS) - uint64_t(RHS);
+    Value = static_cast<int64_t>(U);
+    bool Overflow = Op == Opcode::Add ? ((LHS ^ Value) & (RHS ^ Value)) < 0
+                                      : ((LHS ^ RHS) & (LHS ^ Value)) < 0;
+    if (Overflow)
+      return false;
+  } else {
+    // Operands of at most 63 bits cannot overflow 64 bits here, and neither
+    // can the product of operands of at most 32 bits.
+    Value = Op == Opcode::Add ? LHS + RHS
+                              : Op == Opcode::Sub ? LHS - RHS : LHS * RHS;
+    if (!llvm::isIntN(Width, Value))
+      return false;
+  }
+  Result = static_cast<uint64_t>(Value);
+  return true;
+}
+
+static bool binaryOp(const LangOptions &LangOpts, const Instr &I,
+                     uint64_t LHS, uint64_t RHS, uint64_t &Result) {
+  unsigned W = I.Width;
+  bool S = I.Signed;
+  int64_t SLHS = static_cast<int64_t>(LHS), SRHS = static_cast<int64_t>(RHS);
+
+  switch (I.Op) {
+  case Opcode::Add:
+  case Opcode::Sub:
+  case Opcode::Mul:
+    if (S)
+      return signedArith(I.Op, W, SLHS, SRHS, Result);
+    Result = normalize(I.Op == Opcode::Add
+                           ? LHS + RHS
+                           : I.Op == Opcode::Sub ? LHS - RHS : LHS * RHS,
+                       W, S);
+    return true;
+
+  case Opcode::Div:
+  case Opcode::Rem:
+    if (RHS == 0)
+      return false;
+    if (S) {
+      if (SLHS == minSigned(W) && SRHS == -1)
+        return false;
+      Result = static_cast<uint64_t>(I.Op == Opcode::Div ? SLHS / SRHS
+                                                         : SLHS % SRHS);
+    } else {
+      Result = I.Op == Opcode::Div ? LHS / RHS : LHS % RHS;
+    }
+    return true;
+
+  case Opcode::Shl:
+  case Opcode::Shr: {
+    // The shift amount must not be negative, and must be less than the width
+    // of the shifted type.
+    bool AmountSigned = I.Arg;
+    if ((AmountSigned && SRHS < 0) || RHS >= W)
+      return false;
+    unsigned Amount = static_cast<unsigned>(RHS);
+    if (I.Op == Opcode::Shr) {
+      Result = S ? static_cast<uint64_t>(SLHS >> Amount) : LHS >> Amount;
+      return true;
+    }
+    // Before C++2a, a signed left shift must have a non-negative operand and
+    // must not shift out set bits.
+    if (S && !LangOpts.CPlusPlus2a &&
+        (SLHS < 0 || (Amount && (LHS >> (W - Amount)) != 0)))
+      return false;
+    Result = normalize(LHS << Amount, W, S);
+    return true;
+  }
+
+  case Opcode::And: Result = LHS & RHS; return true;
+  case Opcode::Or:  Result = LHS | RHS; return true;
+  case Opcode::Xor: Result = LHS ^ RHS; return true;
+
+  case Opcode::LT: Result = S ? SLHS < SRHS : LHS < RHS; return true;
+  case Opcode::LE: Result = S ? SLHS <= SRHS : LHS <= RHS; return true;
+  case Opcode::GT: Result = S ? SLHS > SRHS : LHS > RHS; return true;
+  case Opcode::GE: Result = S ? SLHS >= SRHS : LHS >= RHS; return true;
+  case Opcode::EQ: Result = LHS == RHS; return true;
+  case Opcode::NE: Result = LHS != RHS; return true;
+
+  default:
+    llvm_unreachable("not a binary operation");
+  }
+}
+
+bool interp::interpret(const LangOptions &LangOpts, const Function &Entry,
+                       ArrayRef<uint64_t> Args, unsigned Depth,
+                       unsigned &StepsLeft, unsigned &MaxDepth,
+                       uint64_t &Result) {
+  SmallVector<Frame, 16> Frames;
+  SmallVector<uint64_t, 64> Stack;
+  SmallVector<uint64_t, 64> Slots;
+  SmallVector<bool, 64> Initialized;
+
+  auto pushFrame = [&](const Function &F) {
+    size_t SlotBase = Slots.size();
+    Slots.resize(SlotBase + F.getNumSlots());
+    Initialized.resize(SlotBase + F.getNumSlots(), false);
+    Frames.push_back({&F, 0, SlotBase});
+  };
+
+  pushFrame(Entry);
+  for (unsigned I = 0, N = Args.size(); I != N; ++I) {
+    Slots[I] = Args[I];
+    Initialized[I] = true;
+  }
+
+  while (true) {
+    Frame &Fr = Frames.back();
+    const Instr &I = Fr.F->getCode()[Fr.PC++];
+
+    switch (I.Op) {
+    case Opcode::Const:
+      Stack.push_back(I.Arg);
+      break;
+
+    case Opcode::Load:
+      if (!Initialized[Fr.SlotBase + I.Arg])
+        return false;
+      Stack.push_back(Slots[Fr.SlotBase + I.Arg]);
+      break;
+
+    case Opcode::Store:
+      Slots[Fr.SlotBase + I.Arg] = Stack.pop_back_val();
+      Initialized[Fr.SlotBase + I.Arg] = true;
+      break;
+
+    case Opcode::Kill:
+      Initialized[Fr.SlotBase + I.Arg] = false;
+      break;
+
+    case Opcode::Pop:
+      Stack.pop_back();
+      break;
+
+    case Opcode::Step:
+      if (!StepsLeft)
+        return false;
+      --StepsLeft;
+      break;
+
+    case Opcode::Jmp:
+      Fr.PC = I.Arg;
+      break;
+
+    case Opcode::Jf:
+      if (!Stack.pop_back_val())
+        Fr.PC = I.Arg;
+      break;
+
+    case Opcode::Jt:
+      if (Stack.pop_back_val())
+        Fr.PC = I.Arg;
+      break;
+
+    case Opcode::Neg: {
+      uint64_t &Value = Stack.back();
+      if (I.Signed && static_cast<int64_t>(Value) == minSigned(I.Width))
+        return false;
+      Value = normalize(0 - Value, I.Width, I.Signed);
+      break;
+    }
+
+    case Opcode::Not:
+      Stack.back() = normalize(~Stack.back(), I.Width, I.Signed);
+      break;
+
+    case Opcode::LNot:
+      Stack.back() = Stack.back() == 0;
+      break;
+
+    case Opcode::Cast:
+      Stack.back() = normalize(Stack.back(), I.Width, I.Signed);
+      break;
+
+    case Opcode::Add:
+    case Opcode::Sub:
+    case Opcode::Mul:
+    case Opcode::Div:
+    case Opcode::Rem:
+    case Opcode::Shl:
+    case Opcode::Shr:
+    case Opcode::And:
+    case Opcode::Or:
+    case Opcode::Xor:
+    case Opcode::LT:
+    case Opcode::LE:
+    case Opcode::GT:
+    case Opcode::GE:
+    case Opcode::EQ:
+    case Opcode::NE: {
+      uint64_t RHS = Stack.pop_back_val();
+      if (!binaryOp(LangOpts, I, Stack.back(), RHS, Stack.back()))
+        return false;
+      break;
+    }
+
+    case Opcode::Call: {
+      const Function *Callee = Fr.F->getCallee(I.Arg);
+      // The call happens at depth Depth + Frames.size(), which is limited
+      // exactly as in the tree-walking evaluator.
+      if (!Callee->isValid() ||
+          Depth + Frames.size() > LangOpts.ConstexprCallDepth)
+        return false;
+      MaxDepth = std::max<unsigned>(MaxDepth, Depth + Frames.size());
+      unsigned NumArgs = Callee->getNumParams();
+      pushFrame(*Callee);
+      size_t SlotBase = Frames.back().SlotBase;
+      for (unsigned A = 0; A != NumArgs; ++A) {
+        Slots[SlotBase + A] = Stack[Stack.size() - NumArgs + A];
+        Initialized[SlotBase + A] = true;
+      }
+      Stack.resize(Stack.size() - NumArgs);
+      break;
+    }
+
+    case Opcode::Ret: {
+      uint64_t Value = Stack.pop_back_val();
+      Slots.resize(Fr.SlotBase);
+      Initialized.resize(Fr.SlotBase);
+      Frames.pop_back();
+      if (Frames.empty()) {
+        Result = Value;
+        return true;
+      }
+      Stack.push_back(Value);
+      break;
+    }
+
+    case Opcode::NoReturn:
+      return false;
+    }
+  }
+}
@@ -0,0 +1,38 @@
+//===--- Interp.h - Execution loop of the constant interpreter --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LIB_AST_INTERP_INTERP_H
+#define LLVM_CLANG_LIB_AST_INTERP_INTERP_H
+
+#include "clang/Basic/LLVM.h"
+#include <cstdint>
+
+namespace clang {
+class LangOptions;
+
+namespace interp {
+class Function;
+
+/// Execute \p F with the given arguments.
+///
+/// \param Depth The depth of the call stack at the point of the call.
+/// \param StepsLeft The number of evaluation steps left, updated as the
+/// function executes.
+/// \param MaxDepth Raised to the deepest call stack depth the function
+/// reaches.
+///
+/// \returns false if the evaluation is not a constant expression or hits one
+/// of the limits, in which case \p Result and \p StepsLeft are meaningless.
+bool interpret(const LangOptions &LangOpts, const Function &F,
+               ArrayRef<uint64_t> Args, unsigned Depth, unsigned &StepsLeft,
+               unsigned &MaxDepth, uint64_t &Result);
+
+} // namespace interp
+} // namespace clang
+
+#endif
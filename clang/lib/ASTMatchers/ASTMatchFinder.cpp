@@ -553,13 +553,30 @@ private:
     const auto &Filter =
         it != MatcherFiltersMap.end() ? it->second : getFilterForKind(Kind);
 
-    if (Filter.empty())
+    if (Filter.AnyName.empty() && Filter.ByName.empty())
       return;
 
+    ArrayRef<unsigned short> Named;
+    if (!Filter.ByName.empty()) {
+      if (const auto *ND = DynNode.get<NamedDecl>()) {
+        llvm::SmallString<128> Scratch;
+        auto NamedIt = Filter.ByName.find(internal::getNodeName(*ND, Scratch));
+        if (NamedIt != Filter.ByName.end())
+          Named = NamedIt->second;
+      }
+    }
+
     const bool EnableCheckProfiling = Options.CheckProfiling.hasValue();
     TimeBucketRegion Timer;
     auto &Matchers = this->Matchers->DeclOrStmt;
-    for (unsigned short I : Filter) {
+    // Both lists are sorted: merge them to run the matchers in the order they
+    // were added.
+    auto AnyI = Filter.AnyName.begin(), AnyE = Filter.AnyName.end();
+    auto NamedI = Named.begin(), NamedE = Named.end();
+    while (AnyI != AnyE || NamedI != NamedE) {
+      unsigned short I = NamedI == NamedE || (AnyI != AnyE && *AnyI < *NamedI)
+                             ? *AnyI++
+                             : *NamedI++;
       auto &MP = Matchers[I];
       if (EnableCheckProfiling)
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
@@ -571,14 +588,33 @@ private:
     }
   }
 
-  const std::vector<unsigned short> &
-  getFilterForKind(ast_type_traits::ASTNodeKind Kind) {
+  /// Matcher indices for one node kind.
+  struct MatcherFilter {
+    /// Matchers that can match nodes with any name.
+    std::vector<unsigned short> AnyName;
+    /// Matchers that only match nodes with one of a few names (e.g. those
+    /// using \c hasName()), indexed by these names.
+    llvm::StringMap<std::vector<unsigned short>> ByName;
+  };
+
+  const MatcherFilter &getFilterForKind(ast_type_traits::ASTNodeKind Kind) {
     auto &Filter = MatcherFiltersMap[Kind];
     auto &Matchers = this->Matchers->DeclOrStmt;
     assert((Matchers.size() < USHRT_MAX) && "Too many matchers.");
+    if (RequiredNames.empty())
+      for (const auto &MP : Matchers)
+        RequiredNames.push_back(MP.first.getRequiredNames());
     for (unsigned I = 0, E = Matchers.size(); I != E; ++I) {
-      if (Matchers[I].first.canMatchNodesOfKind(Kind)) {
-        Filter.push_back(I);
+      if (!Matchers[I].first.canMatchNodesOfKind(Kind))
+        continue;
+      if (!RequiredNames[I]) {
+        Filter.AnyName.push_back(I);
+        continue;
+      }
+      for (const std::string &Name : *RequiredNames[I]) {
+        auto &Indices = Filter.ByName[Name];
+        if (Indices.empty() || Indices.back() != I)
+          Indices.push_back(I);
       }
     }
     return Filter;
@@ -777,9 +813,14 @@ private:
   /// We precalculate a list of matchers that pass the toplevel restrict check.
   /// This also allows us to skip the restrict check at matching time. See
   /// use \c matchesNoKindCheck() above.
-  llvm::DenseMap<ast_type_traits::ASTNodeKind, std::vector<unsigned short>>
+  /// Matchers that require specific names are further indexed by these names,
+  /// so that only the matchers that could match a \c NamedDecl are tried.
+  llvm::DenseMap<ast_type_traits::ASTNodeKind, MatcherFilter>
       MatcherFiltersMap;
 
+  /// The names required by each matcher in \c Matchers->DeclOrStmt.
+  std::vector<llvm::Optional<std::vector<std::string>>> RequiredNames;
+
   const MatchFinder::MatchFinderOptions &Options;
   ASTContext *ActiveASTContext;
 
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -94,6 +95,30 @@ public:
     return Func(DynNode, Finder, Builder, InnerMatchers);
   }
 
+  llvm::Optional<std::vector<std::string>> getRequiredNames() const override {
+    if (Func == NotUnaryOperator)
+      return llvm::None;
+    // allOf() needs the names of any one of its matchers; pick the fewest.
+    if (Func == AllOfVariadicOperator) {
+      llvm::Optional<std::vector<std::string>> Result;
+      for (const DynTypedMatcher &M : InnerMatchers) {
+        auto Names = M.getRequiredNames();
+        if (Names && (!Result || Names->size() < Result->size()))
+          Result = std::move(Names);
+      }
+      return Result;
+    }
+    // anyOf() and eachOf() match a node if any of their matchers does.
+    std::vector<std::string> Result;
+    for (const DynTypedMatcher &M : InnerMatchers) {
+      auto Names = M.getRequiredNames();
+      if (!Names)
+        return llvm::None;
+      std::move(Names->begin(), Names->end(), std::back_inserter(Result));
+    }
+    return std::move(Result);
+  }
+
 private:
   std::vector<DynTypedMatcher> InnerMatchers;
 };
@@ -112,6 +137,10 @@ public:
     return Result;
   }
 
+  llvm::Optional<std::vector<std::string>> getRequiredNames() const override {
+    return InnerMatcher->getRequiredNames();
+  }
+
 private:
   const std::string ID;
   const IntrusiveRefCntPtr<DynMatcherInterface> InnerMatcher;
@@ -367,8 +396,7 @@ static bool consumeNameSuffix(StringRef &FullName, StringRef Suffix) {
   return true;
 }
 
-static StringRef getNodeName(const NamedDecl &Node,
-                             llvm::SmallString<128> &Scratch) {
+StringRef getNodeName(const NamedDecl &Node, llvm::SmallString<128> &Scratch) {
   // Simple name.
   if (Node.getIdentifier())
     return Node.getName();
@@ -536,6 +564,24 @@ bool HasNameMatcher::matchesNodeFullSlow(const NamedDecl &Node) const {
   return false;
 }
 
+llvm::Optional<std::vector<std::string>>
+HasNameMatcher::getRequiredNames() const {
+  // Every match routine first checks that a pattern ends with the node's name,
+  // either whole or after a "::". Names may contain "::" themselves (e.g.
+  // conversion operators), so every such suffix is a candidate.
+  std::vector<std::string> Result;
+  for (StringRef Name : Names) {
+    while (true) {
+      Result.push_back(Name);
+      size_t Separator = Name.find("::");
+      if (Separator == StringRef::npos)
+        break;
+      Name = Name.drop_front(Separator + 2);
+    }
+  }
+  return std::move(Result);
+}
+
 bool HasNameMatcher::matchesNode(const NamedDecl &Node) const {
   assert(matchesNodeFullFast(Node) == matchesNodeFullSlow(Node));
   if (UseUnqualifiedMatch) {
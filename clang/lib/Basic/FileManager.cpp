@@ -50,6 +50,9 @@ FileManager::FileManager(const FileSystemOptions &FSO,
   // file system.
   if (!this->FS)
     this->FS = llvm::vfs::getRealFileSystem();
+
+  if (FileSystemOpts.CacheDirectoryListings)
+    StatCache = llvm::make_unique<DirectoryListingStatCache>();
 }
 
 FileManager::~FileManager() = default;
@@ -376,7 +379,8 @@ void FileManager::fillRealPathName(FileEntry *UFE, llvm::StringRef FileName) {
 
 llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
 FileManager::getBufferForFile(const FileEntry *Entry, bool isVolatile,
-                              bool ShouldCloseOpenFile) {
+                              bool ShouldCloseOpenFile,
+                              bool RequiresNullTerminator) {
   uint64_t FileSize = Entry->getSize();
   // If there's a high enough chance that the file have changed since we
   // got its size, force a stat before opening it.
@@ -388,7 +392,7 @@ FileManager::getBufferForFile(const FileEntry *Entry, bool isVolatile,
   if (Entry->File) {
     auto Result =
         Entry->File->getBuffer(Filename, FileSize,
-                               /*RequiresNullTerminator=*/true, isVolatile);
+                               RequiresNullTerminator, isVolatile);
     // FIXME: we need a set of APIs that can make guarantees about whether a
     // FileEntry is open or not.
     if (ShouldCloseOpenFile)
@@ -400,22 +404,25 @@ FileManager::getBufferForFile(const FileEntry *Entry, bool isVolatile,
 
   if (FileSystemOpts.WorkingDir.empty())
     return FS->getBufferForFile(Filename, FileSize,
-                                /*RequiresNullTerminator=*/true, isVolatile);
+                                RequiresNullTerminator, isVolatile);
 
   SmallString<128> FilePath(Entry->getName());
   FixupRelativePath(FilePath);
   return FS->getBufferForFile(FilePath, FileSize,
-                              /*RequiresNullTerminator=*/true, isVolatile);
+                              RequiresNullTerminator, isVolatile);
 }
 
 llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
-FileManager::getBufferForFile(StringRef Filename, bool isVolatile) {
+FileManager::getBufferForFile(StringRef Filename, bool isVolatile,
+                              bool RequiresNullTerminator) {
   if (FileSystemOpts.WorkingDir.empty())
-    return FS->getBufferForFile(Filename, -1, true, isVolatile);
+    return FS->getBufferForFile(Filename, -1, RequiresNullTerminator,
+                                isVolatile);
 
   SmallString<128> FilePath(Filename);
   FixupRelativePath(FilePath);
-  return FS->getBufferForFile(FilePath.c_str(), -1, true, isVolatile);
+  return FS->getBufferForFile(FilePath.c_str(), -1, RequiresNullTerminator,
+                              isVolatile);
 }
 
 /// getStatValue - Get the 'stat' information for the specified path,
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Basic/FileSystemStatCache.h"
+#include "clang/Basic/CharInfo.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Chrono.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/Path.h"
@@ -118,3 +120,68 @@ MemorizeStatCalls::getStat(StringRef Path, llvm::vfs::Status &Status,
 
   return std::error_code();
 }
+
+std::error_code
+DirectoryListingStatCache::getStat(StringRef Path, llvm::vfs::Status &Status,
+                                   bool isFile,
+                                   std::unique_ptr<llvm::vfs::File> *F,
+                                   llvm::vfs::FileSystem &FS) {
+  if (!mayExist(Path, FS))
+    return std::make_error_code(std::errc::no_such_file_or_directory);
+  return get(Path, Status, isFile, F, nullptr, FS);
+}
+
+bool DirectoryListingStatCache::mayExist(StringRef Path,
+                                         llvm::vfs::FileSystem &FS) {
+  StringRef Name = llvm::sys::path::filename(Path);
+  StringRef Parent = llvm::sys::path::parent_path(Path);
+  if (Parent.empty() || Name.empty() || Name == "." || Name == ".." ||
+      llvm::sys::path::is_separator(Name.back()))
+    return true;
+
+  // File systems may normalize or case fold names outside of ASCII in ways
+  // that a plain comparison can't reproduce, so let them decide.
+  if (llvm::any_of(Name, [](char C) { return !isASCII(C); }))
+    return true;
+
+  const DirectoryListing *Listing = getListing(Parent, FS);
+  if (!Listing)
+    return true;
+  if (Listing->IsMissing)
+    return false;
+  return Listing->Names.count(Name.lower());
+}
+
+const DirectoryListingStatCache::DirectoryListing *
+DirectoryListingStatCache::getListing(StringRef Dir,
+                                      llvm::vfs::FileSystem &FS) {
+  auto Insertion = Listings.try_emplace(Dir);
+  DirectoryListing &Listing = Insertion.first->second;
+  if (!Insertion.second)
+    return Listing.IsComplete ? &Listing : nullptr;
+
+  std::error_code EC;
+  llvm::vfs::directory_iterator It = FS.dir_begin(Dir, EC), End;
+  if (EC) {
+    // Only a directory that doesn't exist proves that it has no entries. Any
+    // other error, e.g. a directory that can be searched but not read,
+    // requires asking the file system about each entry.
+    if (EC == std::errc::no_such_file_or_directory ||
+        EC == std::errc::not_a_directory) {
+      Listing.IsMissing = true;
+      Listing.IsComplete = true;
+      return &Listing;
+    }
+    return nullptr;
+  }
+
+  for (; !EC && It != End; It.increment(EC))
+    Listing.Names.insert(llvm::sys::path::filename(It->path()).lower());
+  if (EC) {
+    Listing.Names.clear();
+    return nullptr;
+  }
+
+  Listing.IsComplete = true;
+  return &Listing;
+}
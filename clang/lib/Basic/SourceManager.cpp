@@ -366,11 +366,14 @@ SourceManager::~SourceManager() {
 void SourceManager::clearIDTables() {
   MainFileID = FileID();
   LocalSLocEntryTable.clear();
+  LocalSLocEntryOffsets.clear();
+  LocalSLocIndexBlocks.clear();
   LoadedSLocEntryTable.clear();
   SLocEntryLoaded.clear();
   LastLineNoFileIDQuery = FileID();
   LastLineNoContentCache = nullptr;
   LastFileIDLookup = FileID();
+  LastExpansionIDLookup = FileID();
 
   if (LineTable)
     LineTable->clear();
@@ -570,9 +573,9 @@ FileID SourceManager::createFileID(const ContentCache *File,
     SLocEntryLoaded[Index] = true;
     return FileID::get(LoadedID);
   }
-  LocalSLocEntryTable.push_back(SLocEntry::get(NextLocalOffset,
-                                               FileInfo::get(IncludePos, File,
-                                                             FileCharacter)));
+  addLocalSLocEntry(SLocEntry::get(NextLocalOffset,
+                                   FileInfo::get(IncludePos, File,
+                                                 FileCharacter)));
   unsigned FileSize = File->getSize();
   assert(NextLocalOffset + FileSize + 1 > NextLocalOffset &&
          NextLocalOffset + FileSize + 1 <= CurrentLoadedOffset &&
@@ -633,7 +636,7 @@ SourceManager::createExpansionLocImpl(const ExpansionInfo &Info,
     SLocEntryLoaded[Index] = true;
     return SourceLocation::getMacroLoc(LoadedOffset);
   }
-  LocalSLocEntryTable.push_back(SLocEntry::get(NextLocalOffset, Info));
+  addLocalSLocEntry(SLocEntry::get(NextLocalOffset, Info));
   assert(NextLocalOffset + TokLength + 1 > NextLocalOffset &&
          NextLocalOffset + TokLength + 1 <= CurrentLoadedOffset &&
          "Ran out of source locations!");
@@ -723,11 +726,18 @@ FileID SourceManager::getFileIDSlow(unsigned SLocOffset) const {
   if (!SLocOffset)
     return FileID::get(0);
 
+  if (LastExpansionIDLookup.ID &&
+      isOffsetInFileID(LastExpansionIDLookup, SLocOffset))
+    return LastExpansionIDLookup;
+
   // Now it is time to search for the correct file. See where the SLocOffset
   // sits in the global view and consult local or loaded buffers for it.
-  if (SLocOffset < NextLocalOffset)
-    return getFileIDLocal(SLocOffset);
-  return getFileIDLoaded(SLocOffset);
+  FileID Res = SLocOffset < NextLocalOffset ? getFileIDLocal(SLocOffset)
+                                            : getFileIDLoaded(SLocOffset);
+  // The searches remember files in LastFileIDLookup; remember expansions here.
+  if (Res.ID && Res != LastFileIDLookup)
+    LastExpansionIDLookup = Res;
+  return Res;
 }
 
 /// Return the FileID for a SourceLocation with a low offset.
@@ -743,33 +753,32 @@ FileID SourceManager::getFileIDLocal(unsigned SLocOffset) const {
   // completely random and may be a very long way away.
   //
   // To handle this, we do a linear search for up to 8 steps to catch #1 quickly
-  // then we fall back to a less cache efficient, but more scalable, binary
-  // search to find the location.
+  // then we fall back to a more scalable search of a two-level index of the
+  // entry offsets to find the location.
 
   // See if this is near the file point - worst case we start scanning from the
   // most newly created FileID.
-  const SrcMgr::SLocEntry *I;
-
+  unsigned I;
   if (LastFileIDLookup.ID < 0 ||
-      LocalSLocEntryTable[LastFileIDLookup.ID].getOffset() < SLocOffset) {
+      LocalSLocEntryOffsets[LastFileIDLookup.ID] < SLocOffset) {
     // Neither loc prunes our search.
-    I = LocalSLocEntryTable.end();
+    I = LocalSLocEntryOffsets.size();
   } else {
     // Perhaps it is near the file point.
-    I = LocalSLocEntryTable.begin()+LastFileIDLookup.ID;
+    I = LastFileIDLookup.ID;
   }
 
-  // Find the FileID that contains this.  "I" is an iterator that points to a
-  // FileID whose offset is known to be larger than SLocOffset.
+  // Find the FileID that contains this.  "I" is the index of a FileID whose
+  // offset is known to be larger than SLocOffset.
   unsigned NumProbes = 0;
   while (true) {
     --I;
-    if (I->getOffset() <= SLocOffset) {
-      FileID Res = FileID::get(int(I - LocalSLocEntryTable.begin()));
+    if (LocalSLocEntryOffsets[I] <= SLocOffset) {
+      FileID Res = FileID::get(I);
 
       // If this isn't an expansion, remember it.  We have good locality across
       // FileID lookups.
-      if (!I->isExpansion())
+      if (!LocalSLocEntryTable[I].isExpansion())
         LastFileIDLookup = Res;
       NumLinearScans += NumProbes+1;
       return Res;
@@ -778,47 +787,29 @@ FileID SourceManager::getFileIDLocal(unsigned SLocOffset) const {
       break;
   }
 
-  // Convert "I" back into an index.  We know that it is an entry whose index is
-  // larger than the offset we are looking for.
-  unsigned GreaterIndex = I - LocalSLocEntryTable.begin();
-  // LessIndex - This is the lower bound of the range that we're searching.
-  // We know that the offset corresponding to the FileID is is less than
-  // SLocOffset.
-  unsigned LessIndex = 0;
-  NumProbes = 0;
-  while (true) {
-    bool Invalid = false;
-    unsigned MiddleIndex = (GreaterIndex-LessIndex)/2+LessIndex;
-    unsigned MidOffset = getLocalSLocEntry(MiddleIndex, &Invalid).getOffset();
-    if (Invalid)
-      return FileID::get(0);
-
-    ++NumProbes;
-
-    // If the offset of the midpoint is too large, chop the high side of the
-    // range to the midpoint.
-    if (MidOffset > SLocOffset) {
-      GreaterIndex = MiddleIndex;
-      continue;
-    }
-
-    // If the middle index contains the value, succeed and return.
-    // FIXME: This could be made faster by using a function that's aware of
-    // being in the local area.
-    if (isOffsetInFileID(FileID::get(MiddleIndex), SLocOffset)) {
-      FileID Res = FileID::get(MiddleIndex);
-
-      // If this isn't a macro expansion, remember it.  We have good locality
-      // across FileID lookups.
-      if (!LocalSLocEntryTable[MiddleIndex].isExpansion())
-        LastFileIDLookup = Res;
-      NumBinaryProbes += NumProbes;
-      return Res;
-    }
-
-    // Otherwise, move the low-side up to the middle index.
-    LessIndex = MiddleIndex;
-  }
+  // The entry that contains the offset is the last one that starts at or
+  // before it, and precedes entry I. Find the block of entries it is in, then
+  // the entry within that block.
+  auto BlocksEnd =
+      LocalSLocIndexBlocks.begin() + (I - 1) / LocalSLocIndexBlockSize + 1;
+  unsigned Block =
+      std::upper_bound(LocalSLocIndexBlocks.begin(), BlocksEnd, SLocOffset) -
+      LocalSLocIndexBlocks.begin() - 1;
+  unsigned BlockBegin = Block * LocalSLocIndexBlockSize;
+  unsigned BlockEnd = std::min(BlockBegin + LocalSLocIndexBlockSize, I);
+  unsigned Index =
+      std::upper_bound(LocalSLocEntryOffsets.begin() + BlockBegin,
+                       LocalSLocEntryOffsets.begin() + BlockEnd, SLocOffset) -
+      LocalSLocEntryOffsets.begin() - 1;
+  NumBinaryProbes += llvm::Log2_32_Ceil(Block + 1) +
+                     llvm::Log2_32_Ceil(BlockEnd - BlockBegin);
+
+  FileID Res = FileID::get(Index);
+  // If this isn't a macro expansion, remember it.  We have good locality
+  // across FileID lookups.
+  if (!LocalSLocEntryTable[Index].isExpansion())
+    LastFileIDLookup = Res;
+  return Res;
 }
 
 /// Return the FileID for a SourceLocation with a high offset.
@@ -2233,6 +2224,8 @@ SourceManager::MemoryBufferSizes SourceManager::getMemoryBufferSizes() const {
 size_t SourceManager::getDataStructureSizes() const {
   size_t size = llvm::capacity_in_bytes(MemBufferInfos)
     + llvm::capacity_in_bytes(LocalSLocEntryTable)
+    + llvm::capacity_in_bytes(LocalSLocEntryOffsets)
+    + llvm::capacity_in_bytes(LocalSLocIndexBlocks)
     + llvm::capacity_in_bytes(LoadedSLocEntryTable)
     + llvm::capacity_in_bytes(SLocEntryLoaded)
     + llvm::capacity_in_bytes(FileInfos);
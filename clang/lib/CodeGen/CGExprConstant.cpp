@@ -2098,6 +2098,23 @@ llvm::Constant *ConstantEmitter::tryEmitPrivate(const APValue &Value,
     const ConstantArrayType *CAT =
         CGM.getContext().getAsConstantArrayType(DestType);
     unsigned NumElements = Value.getArraySize();
+
+    // Emit a packed array of integers directly from its data, if its element
+    // type is an integer type of the same size.
+    if (Value.isPackedArray() && CAT) {
+      auto *AType =
+          dyn_cast<llvm::ArrayType>(CGM.getTypes().ConvertTypeForMem(DestType));
+      auto *EltTy =
+          AType ? dyn_cast<llvm::IntegerType>(AType->getElementType()) : nullptr;
+      if (EltTy && AType->getNumElements() == NumElements &&
+          EltTy->getBitWidth() == Value.getPackedArrayEltBytes() * 8) {
+        StringRef Data = Value.getPackedArrayData();
+        if (llvm::all_of(Data, [](char C) { return C == 0; }))
+          return llvm::ConstantAggregateZero::get(AType);
+        return llvm::ConstantDataArray::getRaw(Data, NumElements, EltTy);
+      }
+    }
+
     unsigned NumInitElts = Value.getArrayInitializedElts();
 
     // Emit array filler, if there is one.
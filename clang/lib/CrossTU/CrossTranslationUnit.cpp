@@ -12,6 +12,7 @@
 #include "clang/CrossTU/CrossTranslationUnit.h"
 #include "clang/AST/ASTImporter.h"
 #include "clang/AST/Decl.h"
+#include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Basic/TargetInfo.h"
 #include "clang/CrossTU/CrossTUDiagnostic.h"
 #include "clang/Frontend/ASTUnit.h"
@@ -166,6 +167,149 @@ createCrossTUIndexString(const llvm::StringMap<std::string> &Index) {
   return Result.str();
 }
 
+namespace {
+/// Collects what the body of a function does to memory outside of its own
+/// frame, and which values it returns.
+class CallSummaryBuilder : public RecursiveASTVisitor<CallSummaryBuilder> {
+public:
+  CallSummaryBuilder(ASTContext &Ctx) : Ctx(Ctx) {}
+
+  bool VisitCallExpr(CallExpr *) { return setSideEffects(); }
+  bool VisitCXXConstructExpr(CXXConstructExpr *) { return setSideEffects(); }
+  bool VisitCXXNewExpr(CXXNewExpr *) { return setSideEffects(); }
+  bool VisitCXXDeleteExpr(CXXDeleteExpr *) { return setSideEffects(); }
+  bool VisitCXXThrowExpr(CXXThrowExpr *) { return setSideEffects(); }
+  bool VisitObjCMessageExpr(ObjCMessageExpr *) { return setSideEffects(); }
+  bool VisitAsmStmt(AsmStmt *) { return setSideEffects(); }
+
+  bool VisitBinaryOperator(BinaryOperator *BO) {
+    if (BO->isAssignmentOp() && !isLocalVariable(BO->getLHS()))
+      return setSideEffects();
+    return true;
+  }
+
+  bool VisitUnaryOperator(UnaryOperator *UO) {
+    if (UO->isIncrementDecrementOp() && !isLocalVariable(UO->getSubExpr()))
+      return setSideEffects();
+    return true;
+  }
+
+  bool VisitVarDecl(VarDecl *VD) {
+    // Static locals keep their value between calls.
+    if (VD->isStaticLocal())
+      return setSideEffects();
+    return true;
+  }
+
+  bool VisitReturnStmt(ReturnStmt *RS) {
+    ++NumReturns;
+    Expr::EvalResult Result;
+    const Expr *RetValue = RS->getRetValue();
+    if (!RetValue || RetValue->isValueDependent() ||
+        !RetValue->EvaluateAsInt(Result, Ctx) ||
+        !Result.Val.getInt().isSignedIntN(64)) {
+      HasUnknownReturn = true;
+      return true;
+    }
+    int64_t Value = Result.Val.getInt().getExtValue();
+    if (ReturnValue && *ReturnValue != Value)
+      HasUnknownReturn = true;
+    ReturnValue = Value;
+    return true;
+  }
+
+  CallSummary getSummary(const FunctionDecl *FD) const {
+    CallSummary Summary;
+    Summary.MayHaveSideEffects = HasSideEffects;
+    if (!HasUnknownReturn && NumReturns > 0 &&
+        FD->getReturnType()->isIntegralOrEnumerationType())
+      Summary.ReturnValue = ReturnValue;
+    return Summary;
+  }
+
+private:
+  bool setSideEffects() {
+    HasSideEffects = true;
+    return true;
+  }
+
+  /// Whether \p E refers to a variable of the function's own frame.
+  static bool isLocalVariable(const Expr *E) {
+    const auto *DRE = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts());
+    if (!DRE)
+      return false;
+    const auto *VD = dyn_cast<VarDecl>(DRE->getDecl());
+    return VD && VD->hasLocalStorage() && !VD->getType()->isReferenceType();
+  }
+
+  ASTContext &Ctx;
+  bool HasSideEffects = false;
+  bool HasUnknownReturn = false;
+  unsigned NumReturns = 0;
+  llvm::Optional<int64_t> ReturnValue;
+};
+} // end anonymous namespace
+
+CallSummary computeCallSummary(const FunctionDecl *FD) {
+  const FunctionDecl *Def;
+  if (!FD->hasBody(Def))
+    return CallSummary();
+  CallSummaryBuilder Builder(Def->getASTContext());
+  Builder.TraverseStmt(Def->getBody());
+  return Builder.getSummary(Def);
+}
+
+llvm::Expected<llvm::StringMap<CallSummary>>
+parseCallSummaries(StringRef SummaryPath) {
+  std::ifstream SummaryFile(SummaryPath);
+  if (!SummaryFile)
+    return llvm::make_error<IndexError>(index_error_code::missing_index_file,
+                                        SummaryPath.str());
+
+  llvm::StringMap<CallSummary> Result;
+  std::string Line;
+  unsigned LineNo = 1;
+  while (std::getline(SummaryFile, Line)) {
+    // The USR may contain spaces, so split the fields off from the end.
+    StringRef LookupName, SideEffects, ReturnValue;
+    std::tie(LookupName, ReturnValue) = StringRef(Line).rsplit(' ');
+    std::tie(LookupName, SideEffects) = LookupName.rsplit(' ');
+    CallSummary Summary;
+    int64_t Value;
+    bool Valid = !LookupName.empty() && (SideEffects == "0" ||
+                                         SideEffects == "1");
+    if (Valid && ReturnValue != "-") {
+      Valid = !ReturnValue.getAsInteger(10, Value);
+      Summary.ReturnValue = Value;
+    }
+    if (!Valid)
+      return llvm::make_error<IndexError>(
+          index_error_code::invalid_index_format, SummaryPath.str(), LineNo);
+    if (Result.count(LookupName))
+      return llvm::make_error<IndexError>(
+          index_error_code::multiple_definitions, SummaryPath.str(), LineNo);
+    Summary.MayHaveSideEffects = SideEffects == "1";
+    Result[LookupName] = Summary;
+    LineNo++;
+  }
+  return Result;
+}
+
+std::string
+createCallSummaryString(const llvm::StringMap<CallSummary> &Summaries) {
+  std::ostringstream Result;
+  for (const auto &E : Summaries) {
+    const CallSummary &Summary = E.getValue();
+    Result << E.getKey().str() << " " << Summary.MayHaveSideEffects << " ";
+    if (Summary.ReturnValue)
+      Result << *Summary.ReturnValue;
+    else
+      Result << "-";
+    Result << '\n';
+  }
+  return Result.str();
+}
+
 bool containsConst(const VarDecl *VD, const ASTContext &ACtx) {
   CanQualType CT = ACtx.getCanonicalType(VD->getType());
   if (!CT.isConstQualified()) {
@@ -317,6 +461,32 @@ CrossTranslationUnitContext::getCrossTUDefinition(const VarDecl *VD,
                                   DisplayCTUProgress);
 }
 
+llvm::Expected<CallSummary>
+CrossTranslationUnitContext::getCallSummary(const FunctionDecl *FD,
+                                            StringRef CrossTUDir,
+                                            StringRef SummaryName) {
+  if (!NameSummaryMap) {
+    SmallString<256> SummaryFile = CrossTUDir;
+    if (llvm::sys::path::is_absolute(SummaryName))
+      SummaryFile = SummaryName;
+    else
+      llvm::sys::path::append(SummaryFile, SummaryName);
+    llvm::Expected<llvm::StringMap<CallSummary>> SummariesOrErr =
+        parseCallSummaries(SummaryFile);
+    if (!SummariesOrErr) {
+      // Report a broken summary file only once.
+      NameSummaryMap.emplace();
+      return SummariesOrErr.takeError();
+    }
+    NameSummaryMap = std::move(*SummariesOrErr);
+  }
+
+  auto It = NameSummaryMap->find(getLookupName(FD));
+  if (It == NameSummaryMap->end())
+    return llvm::make_error<IndexError>(index_error_code::missing_definition);
+  return It->second;
+}
+
 void CrossTranslationUnitContext::emitCrossTUDiagnostics(const IndexError &IE) {
   switch (IE.getCode()) {
   case index_error_code::missing_index_file:
@@ -2246,6 +2246,183 @@ cleanupAroundReplacements(StringRef Code, const tooling::Replacements &Replaces,
   return processReplacements(Cleanup, Code, NewReplaces, Style);
 }
 
+namespace {
+
+// A place where C++ code can be split for formatting: the start of a line
+// that begins a declaration at namespace scope after an empty line. Nothing
+// before such a line influences how the lines after it are formatted, as long
+// as the formatted ranges stay clear of the empty lines.
+struct FormattingBoundary {
+  // Offset of the start of the line.
+  unsigned Offset;
+  // Offset of the end of the last token before the empty lines.
+  unsigned GapBegin;
+  // Offset of the end of the line.
+  unsigned LineEnd;
+  // Offset of the innermost enclosing namespace brace, or UINT_MAX.
+  unsigned Scope;
+};
+
+// Computes the part of \p Code that needs to be lexed and annotated to format
+// \p Ranges. Returns the whole code if it cannot be split safely.
+std::pair<unsigned, unsigned>
+getFormattingWindow(const FormatStyle &Style, StringRef Code,
+                    ArrayRef<tooling::Range> Ranges) {
+  std::pair<unsigned, unsigned> WholeCode(0, Code.size());
+  if (Style.Language != FormatStyle::LK_Cpp || Style.DisableFormat ||
+      Ranges.empty() || isLikelyXml(Code))
+    return WholeCode;
+
+  unsigned RangesBegin = UINT_MAX, RangesEnd = 0;
+  for (const tooling::Range &R : Ranges) {
+    RangesBegin = std::min(RangesBegin, R.getOffset());
+    RangesEnd = std::max(RangesEnd, R.getOffset() + R.getLength());
+  }
+
+  // Braces that are not indented by the style are transparent: declarations
+  // inside them are formatted like declarations at the top level.
+  struct OpenBrace {
+    unsigned Offset;
+    bool Transparent;
+  };
+  typedef SmallVector<OpenBrace, 8> BraceStack;
+  struct Conditional {
+    BraceStack AtIf;
+    Optional<BraceStack> AfterFirstBranch;
+  };
+  BraceStack Braces;
+  SmallVector<Conditional, 4> Conditionals;
+  SmallVector<FormattingBoundary, 64> Boundaries;
+
+  LangOptions LangOpts = getFormattingLangOpts(Style);
+  Lexer Lex(SourceLocation(), LangOpts, Code.begin(), Code.begin(), Code.end());
+  Lex.SetCommentRetentionState(true);
+
+  unsigned PrevEnd = 0;
+  bool AtStart = true;
+  bool InDirective = false;
+  bool ExpectDirectiveName = false;
+  bool PrevEndsDeclaration = false;
+  bool FormattingOff = false;
+  StringRef StmtFirst, StmtSecond;
+  Token Tok;
+  for (;;) {
+    Lex.LexFromRawLexer(Tok);
+    if (Tok.is(tok::eof))
+      break;
+    unsigned End = Lex.getBufferLocation() - Code.begin();
+    unsigned Start = End - Tok.getLength();
+    StringRef Text = Code.slice(Start, End);
+
+    if (Tok.isAtStartOfLine()) {
+      InDirective = false;
+      ExpectDirectiveName = false;
+      StringRef Gap = Code.slice(PrevEnd, Start);
+      bool InTransparentScope = llvm::all_of(
+          Braces, [](const OpenBrace &B) { return B.Transparent; });
+      if (!AtStart && PrevEndsDeclaration && !FormattingOff &&
+          InTransparentScope && Conditionals.empty() &&
+          Gap.count('\n') >= 2 && !Gap.contains('\\')) {
+        size_t LineBegin = Code.rfind('\n', Start);
+        size_t LineEnd = Code.find('\n', Start);
+        Boundaries.push_back(
+            {LineBegin == StringRef::npos ? 0 : unsigned(LineBegin + 1),
+             PrevEnd,
+             LineEnd == StringRef::npos ? unsigned(Code.size())
+                                        : unsigned(LineEnd),
+             Braces.empty() ? UINT_MAX : Braces.back().Offset});
+      }
+      if (Tok.is(tok::hash)) {
+        InDirective = true;
+        ExpectDirectiveName = true;
+        PrevEndsDeclaration = true;
+        StmtFirst = StmtSecond = StringRef();
+      }
+    } else if (ExpectDirectiveName) {
+      ExpectDirectiveName = false;
+      StringRef Name = Tok.is(tok::raw_identifier) ? Tok.getRawIdentifier()
+                                                   : StringRef();
+      if (Name == "if" || Name == "ifdef" || Name == "ifndef") {
+        Conditionals.push_back({Braces, None});
+      } else if (Name == "elif" || Name == "else") {
+        // Like UnwrappedLineParser, follow the first branch of a conditional
+        // for the brace structure.
+        if (Conditionals.empty())
+          return WholeCode;
+        if (!Conditionals.back().AfterFirstBranch)
+          Conditionals.back().AfterFirstBranch = Braces;
+        Braces = Conditionals.back().AtIf;
+      } else if (Name == "endif") {
+        if (Conditionals.empty())
+          return WholeCode;
+        if (Conditionals.back().AfterFirstBranch)
+          Braces = *Conditionals.back().AfterFirstBranch;
+        Conditionals.pop_back();
+      }
+    }
+    AtStart = false;
+    PrevEnd = End;
+
+    if (Tok.is(tok::comment)) {
+      if (Text.contains("clang-format off"))
+        FormattingOff = true;
+      else if (Text.contains("clang-format on"))
+        FormattingOff = false;
+      continue;
+    }
+    if (InDirective)
+      continue;
+
+    PrevEndsDeclaration = Tok.isOneOf(tok::semi, tok::r_brace);
+    if (Tok.is(tok::l_brace)) {
+      bool IsNamespace =
+          StmtFirst == "namespace" ||
+          (StmtFirst == "inline" && StmtSecond == "namespace");
+      bool Transparent =
+          (StmtFirst == "extern" && StmtSecond.startswith("\"")) ||
+          (IsNamespace &&
+           (Style.NamespaceIndentation == FormatStyle::NI_None ||
+            (Style.NamespaceIndentation == FormatStyle::NI_Inner &&
+             Braces.empty())));
+      Braces.push_back({Start, Transparent});
+    } else if (Tok.is(tok::r_brace)) {
+      if (Braces.empty())
+        return WholeCode;
+      Braces.pop_back();
+    }
+    if (Tok.isOneOf(tok::semi, tok::l_brace, tok::r_brace)) {
+      StmtFirst = StmtSecond = StringRef();
+    } else if (StmtFirst.empty()) {
+      StmtFirst = Text;
+    } else if (StmtSecond.empty()) {
+      StmtSecond = Text;
+    }
+  }
+
+  // Start after the last boundary whose first line is not touched by the
+  // ranges, and end before the first boundary in the same scope whose
+  // preceding empty lines are not touched either.
+  std::pair<unsigned, unsigned> Window = WholeCode;
+  unsigned Scope = UINT_MAX;
+  const FormattingBoundary *I = Boundaries.begin(), *E = Boundaries.end();
+  for (; I != E && I->LineEnd < RangesBegin; ++I) {
+    Window.first = I->Offset;
+    Scope = I->Scope;
+  }
+  for (; I != E; ++I) {
+    if (I->Scope == Scope && I->GapBegin > RangesEnd) {
+      Window.second = I->Offset;
+      return Window;
+    }
+  }
+  // The end of the code only closes the top level.
+  if (Scope != UINT_MAX || !Braces.empty() || !Conditionals.empty())
+    return WholeCode;
+  return Window;
+}
+
+} // anonymous namespace
+
 namespace internal {
 std::pair<tooling::Replacements, unsigned>
 reformat(const FormatStyle &Style, StringRef Code,
@@ -2318,11 +2495,39 @@ tooling::Replacements reformat(const FormatStyle &Style, StringRef Code,
                                ArrayRef<tooling::Range> Ranges,
                                StringRef FileName,
                                FormattingAttemptStatus *Status) {
-  return internal::reformat(Style, Code, Ranges,
-                            /*FirstStartColumn=*/0,
-                            /*NextStartColumn=*/0,
-                            /*LastStartColumn=*/0, FileName, Status)
-      .first;
+  // Only lex and annotate the declarations around the ranges; for small edits
+  // to large files this is most of the work.
+  unsigned WindowBegin, WindowEnd;
+  std::tie(WindowBegin, WindowEnd) = getFormattingWindow(Style, Code, Ranges);
+  if (WindowBegin == 0 && WindowEnd == Code.size())
+    return internal::reformat(Style, Code, Ranges,
+                              /*FirstStartColumn=*/0,
+                              /*NextStartColumn=*/0,
+                              /*LastStartColumn=*/0, FileName, Status)
+        .first;
+
+  std::vector<tooling::Range> WindowRanges;
+  for (const tooling::Range &R : Ranges)
+    WindowRanges.push_back(
+        tooling::Range(R.getOffset() - WindowBegin, R.getLength()));
+  tooling::Replacements WindowFixes =
+      internal::reformat(Style, Code.slice(WindowBegin, WindowEnd),
+                         WindowRanges,
+                         /*FirstStartColumn=*/0,
+                         /*NextStartColumn=*/0,
+                         /*LastStartColumn=*/0, FileName, Status)
+          .first;
+  if (Status && !Status->FormatComplete && Status->Line > 0)
+    Status->Line += Code.take_front(WindowBegin).count('\n');
+
+  tooling::Replacements Fixes;
+  for (const tooling::Replacement &R : WindowFixes)
+    // The replacements are shifted by the same amount, so they cannot
+    // conflict.
+    llvm::consumeError(Fixes.add(tooling::Replacement(
+        R.getFilePath(), R.getOffset() + WindowBegin, R.getLength(),
+        R.getReplacementText())));
+  return Fixes;
 }
 
 tooling::Replacements cleanup(const FormatStyle &Style, StringRef Code,
@@ -32,6 +32,8 @@
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Sema/CodeCompleteConsumer.h"
 #include "clang/Sema/Sema.h"
+#include "clang/Sema/SemaCostRemarks.h"
+#include "clang/Sema/SemaDiagnostic.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/GlobalModuleIndex.h"
 #include "clang/Serialization/InMemoryModuleCache.h"
@@ -48,6 +50,7 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
+#include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
 #include <sys/stat.h>
 #include <system_error>
@@ -618,6 +621,29 @@ void CompilerInstance::createSema(TranslationUnitKind TUKind,
     TheSema->addExternalSource(ExternalSemaSrc.get());
     ExternalSemaSrc->InitializeSema(*TheSema);
   }
+
+  // Report expensive semantic analysis work if requested.
+  bool EmitCostRemarks =
+      !getDiagnostics().isIgnored(diag::remark_sema_cost, SourceLocation());
+  StringRef CostRecordFile = getFrontendOpts().SemaCostRecordFile;
+  if (EmitCostRemarks || !CostRecordFile.empty()) {
+    std::unique_ptr<llvm::ToolOutputFile> RecordFile;
+    if (!CostRecordFile.empty()) {
+      std::error_code EC;
+      RecordFile = llvm::make_unique<llvm::ToolOutputFile>(
+          CostRecordFile, EC, llvm::sys::fs::F_None);
+      if (EC) {
+        getDiagnostics().Report(diag::err_fe_unable_to_open_output)
+            << CostRecordFile << EC.message();
+        RecordFile.reset();
+      }
+    }
+    auto CostRemarks = llvm::make_unique<SemaCostRemarks>(
+        getFrontendOpts().SemaCostThreshold, EmitCostRemarks,
+        std::move(RecordFile));
+    TheSema->CostRemarks = CostRemarks.get();
+    TheSema->TemplateInstCallbacks.push_back(std::move(CostRemarks));
+  }
 }
 
 // Output Files
@@ -11,6 +11,7 @@
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/DeclVisitor.h"
 #include "clang/Lex/PreprocessingRecord.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -1079,6 +1080,25 @@ bool clang::index::generateUSRForDecl(const Decl *D,
   return UG.ignoreResults();
 }
 
+llvm::Optional<StringRef>
+clang::index::USRCache::getUSRForDecl(const Decl *D) {
+  auto It = USRs.try_emplace(D);
+  if (It.second) {
+    SmallString<128> Buf;
+    if (!generateUSRForDecl(D, Buf))
+      It.first->second = StringRef(Buf).copy(Alloc);
+  }
+  StringRef USR = It.first->second;
+  if (USR.empty())
+    return None;
+  return USR;
+}
+
+void clang::index::USRCache::clear() {
+  USRs.clear();
+  Alloc.Reset();
+}
+
 bool clang::index::generateUSRForMacro(const MacroDefinitionRecord *MD,
                                        const SourceManager &SM,
                                        SmallVectorImpl<char> &Buf) {
@@ -0,0 +1,157 @@
+//===--- HeaderGuardCache.cpp - Include guards shared between runs --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the HeaderGuardCache interface.
+//
+// The cache file is a text file with one entry per line:
+//
+//   <size> <modification time> <controlling macro> <real path of the header>
+//
+// The path comes last, so that it may contain spaces.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/HeaderGuardCache.h"
+#include "clang/Basic/FileManager.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <vector>
+
+using namespace clang;
+
+/// Returns the key of \p File in the cache, or an empty string if the file
+/// can't be identified independently of the current working directory.
+static StringRef getKey(const FileEntry *File) {
+  StringRef Key = File->tryGetRealPathName();
+  if (Key.empty())
+    Key = File->getName();
+  if (!llvm::sys::path::is_absolute(Key))
+    return StringRef();
+  return Key;
+}
+
+HeaderGuardCache::HeaderGuardCache(StringRef Path) : Path(Path) {
+  read(Path, Entries);
+}
+
+void HeaderGuardCache::read(StringRef Path, llvm::StringMap<Entry> &Entries) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+      llvm::MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!Buffer)
+    return;
+
+  StringRef Rest = (*Buffer)->getBuffer();
+  while (!Rest.empty()) {
+    StringRef Line;
+    std::tie(Line, Rest) = Rest.split('\n');
+
+    StringRef SizeStr, ModTimeStr, Macro, Key;
+    std::tie(SizeStr, Line) = Line.split(' ');
+    std::tie(ModTimeStr, Line) = Line.split(' ');
+    std::tie(Macro, Key) = Line.split(' ');
+
+    Entry E;
+    // Ignore malformed lines, e.g. the tail of a truncated file.
+    if (SizeStr.getAsInteger(10, E.Size) ||
+        ModTimeStr.getAsInteger(10, E.ModTime) || Macro.empty() ||
+        Key.empty())
+      continue;
+    E.Macro = Macro;
+    Entries[Key] = std::move(E);
+  }
+}
+
+StringRef HeaderGuardCache::getControllingMacro(const FileEntry *File) const {
+  StringRef Key = getKey(File);
+  if (Key.empty())
+    return StringRef();
+
+  auto It = Entries.find(Key);
+  if (It == Entries.end())
+    return StringRef();
+
+  const Entry &E = It->second;
+  if (E.Size != static_cast<uint64_t>(File->getSize()) ||
+      E.ModTime != static_cast<int64_t>(File->getModificationTime()))
+    return StringRef();
+  return E.Macro;
+}
+
+void HeaderGuardCache::setControllingMacro(const FileEntry *File,
+                                           StringRef Macro) {
+  StringRef Key = getKey(File);
+  if (Key.empty())
+    return;
+
+  Entry &E = Entries[Key];
+  uint64_t Size = File->getSize();
+  int64_t ModTime = File->getModificationTime();
+  if (E.Size == Size && E.ModTime == ModTime && E.Macro == Macro)
+    return;
+
+  E.Size = Size;
+  E.ModTime = ModTime;
+  E.Macro = Macro;
+  E.IsNew = true;
+  HasNewEntries = true;
+}
+
+bool HeaderGuardCache::write() {
+  if (!HasNewEntries)
+    return false;
+
+  // Other compilations might have updated the cache since it was read, so
+  // merge our entries into its current contents.
+  llvm::StringMap<Entry> Merged;
+  read(Path, Merged);
+  for (const auto &KV : Entries)
+    if (KV.second.IsNew)
+      Merged[KV.first()] = KV.second;
+
+  // Write to a temporary file first, so readers never see a partially written
+  // cache.
+  int FD;
+  SmallString<128> TempPath;
+  if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%", FD, TempPath))
+    return true;
+
+  std::vector<StringRef> Keys;
+  Keys.reserve(Merged.size());
+  for (const auto &KV : Merged)
+    Keys.push_back(KV.first());
+  llvm::sort(Keys);
+
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    for (StringRef Key : Keys) {
+      const Entry &E = Merged.find(Key)->second;
+      OS << E.Size << ' ' << E.ModTime << ' ' << E.Macro << ' ' << Key << '\n';
+    }
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return true;
+    }
+  }
+
+  if (llvm::sys::fs::rename(TempPath, Path)) {
+    llvm::sys::fs::remove(TempPath);
+    return true;
+  }
+
+  for (auto &KV : Entries)
+    KV.second.IsNew = false;
+  HasNewEntries = false;
+  return false;
+}
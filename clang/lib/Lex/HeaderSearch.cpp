@@ -32,6 +32,8 @@
 #include "llvm/Support/Capacity.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include <algorithm>
@@ -91,6 +93,8 @@ void HeaderSearch::PrintStats() {
   fprintf(stderr, "  %d #include/#include_next/#import.\n", NumIncluded);
   fprintf(stderr, "    %d #includes skipped due to"
           " the multi-include optimization.\n", NumMultiIncludeFileOptzn);
+  fprintf(stderr, "    %d #includes skipped due to"
+          " the header guard cache.\n", NumGuardCacheOptzn);
 
   fprintf(stderr, "%d framework lookups.\n", NumFrameworkLookups);
   fprintf(stderr, "%d subframework lookups.\n", NumSubFrameworkLookups);
@@ -152,6 +156,51 @@ std::string HeaderSearch::getPrebuiltModuleFileName(StringRef ModuleName,
   return {};
 }
 
+/// Hash the contents of \p File.
+///
+/// \returns true if the file could not be read.
+static bool hashFileContents(FileManager &FileMgr, const FileEntry *File,
+                             llvm::MD5 &Hasher) {
+  auto Buffer = FileMgr.getBufferForFile(File, /*isVolatile=*/false,
+                                         /*ShouldCloseOpenFile=*/true,
+                                         /*RequiresNullTerminator=*/false);
+  if (!Buffer)
+    return true;
+  Hasher.update((*Buffer)->getBuffer());
+  return false;
+}
+
+/// Hash the contents of all of the headers that belong to \p M and its
+/// submodules.
+///
+/// Headers found through umbrella directories are only known once the module
+/// has been built, so only the name of the directory contributes.
+///
+/// \returns true if one of the files could not be read.
+static bool hashModuleContents(FileManager &FileMgr, const Module &M,
+                               llvm::MD5 &Hasher) {
+  auto HashFile = [&](StringRef Name, const FileEntry *File) {
+    Hasher.update(Name);
+    return !File || hashFileContents(FileMgr, File, Hasher);
+  };
+
+  Hasher.update(M.Name);
+  if (Module::Header Umbrella = M.getUmbrellaHeader()) {
+    if (HashFile(Umbrella.NameAsWritten, Umbrella.Entry))
+      return true;
+  } else if (Module::DirectoryName Dir = M.getUmbrellaDir()) {
+    Hasher.update(Dir.NameAsWritten);
+  }
+  for (const auto &Headers : M.Headers)
+    for (const Module::Header &H : Headers)
+      if (HashFile(H.NameAsWritten, H.Entry))
+        return true;
+  for (const Module *Sub : M.submodules())
+    if (hashModuleContents(FileMgr, *Sub, Hasher))
+      return true;
+  return false;
+}
+
 std::string HeaderSearch::getCachedModuleFileName(StringRef ModuleName,
                                                   StringRef ModuleMapPath) {
   // If we don't have a module cache path or aren't supposed to use one, we
@@ -181,11 +230,26 @@ std::string HeaderSearch::getCachedModuleFileName(StringRef ModuleName,
     auto DirName = FileMgr.getCanonicalName(Dir);
     auto FileName = llvm::sys::path::filename(ModuleMapPath);
 
-    llvm::hash_code Hash =
-      llvm::hash_combine(DirName.lower(), FileName.lower());
+    uint64_t Hash = llvm::hash_combine(DirName.lower(), FileName.lower());
+
+    // In a content-addressed cache, the name is instead derived from what
+    // the module is built from, so a module file with this name is known to
+    // be up to date and can be shared by every build of the same sources.
+    if (HSOpts->ModulesContentAddressedCache) {
+      Module *Mod = ModMap.findModule(ModuleName);
+      const FileEntry *ModuleMap =
+          Mod ? ModMap.getModuleMapFileForUniquing(Mod) : nullptr;
+      llvm::MD5 Hasher;
+      if (ModuleMap && !hashFileContents(FileMgr, ModuleMap, Hasher) &&
+          !hashModuleContents(FileMgr, *Mod, Hasher)) {
+        llvm::MD5::MD5Result Digest;
+        Hasher.final(Digest);
+        Hash = Digest.low();
+      }
+    }
 
     SmallString<128> HashStr;
-    llvm::APInt(64, size_t(Hash)).toStringUnsigned(HashStr, /*Radix*/36);
+    llvm::APInt(64, Hash).toStringUnsigned(HashStr, /*Radix*/36);
     llvm::sys::path::append(Result, ModuleName + "-" + HashStr + ".pcm");
   }
   return Result.str().str();
@@ -1260,14 +1324,33 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
 
   // Next, check to see if the file is wrapped with #ifndef guards.  If so, and
   // if the macro that guards it is defined, we know the #include has no effect.
-  if (const IdentifierInfo *ControllingMacro
-      = FileInfo.getControllingMacro(ExternalLookup)) {
+  const IdentifierInfo *ControllingMacro =
+      FileInfo.getControllingMacro(ExternalLookup);
+
+  // If the file hasn't been entered yet, an earlier compilation might have
+  // found its guard, which lets us skip it without ever reading it. Module
+  // builds rely on the visibility of the macros in each module, so don't
+  // guess there.
+  bool FromGuardCache = false;
+  if (!ControllingMacro && !FileInfo.NumIncludes && !ModulesEnabled) {
+    if (HeaderGuardCache *Cache = getHeaderGuardCache()) {
+      StringRef Macro = Cache->getControllingMacro(File);
+      if (!Macro.empty()) {
+        ControllingMacro = PP.getIdentifierInfo(Macro);
+        FromGuardCache = true;
+      }
+    }
+  }
+
+  if (ControllingMacro) {
     // If the header corresponds to a module, check whether the macro is already
     // defined in that module rather than checking in the current set of visible
     // modules.
     if (M ? PP.isMacroDefinedInLocalModule(ControllingMacro, M)
           : PP.isMacroDefined(ControllingMacro)) {
       ++NumMultiIncludeFileOptzn;
+      if (FromGuardCache)
+        ++NumGuardCacheOptzn;
       return false;
     }
   }
@@ -1278,6 +1361,30 @@ bool HeaderSearch::ShouldEnterIncludeFile(Preprocessor &PP,
   return true;
 }
 
+void HeaderSearch::SetFileControllingMacro(
+    const FileEntry *File, const IdentifierInfo *ControllingMacro) {
+  getFileInfo(File).ControllingMacro = ControllingMacro;
+  if (HeaderGuardCache *Cache = getHeaderGuardCache())
+    Cache->setControllingMacro(File, ControllingMacro->getName());
+}
+
+HeaderGuardCache *HeaderSearch::getHeaderGuardCache() {
+  if (!GuardCacheLoaded) {
+    GuardCacheLoaded = true;
+    if (!HSOpts->HeaderGuardCachePath.empty())
+      GuardCache =
+          llvm::make_unique<HeaderGuardCache>(HSOpts->HeaderGuardCachePath);
+  }
+  return GuardCache.get();
+}
+
+void HeaderSearch::writeHeaderGuardCache() {
+  // The cache is only an optimization, so failing to update it is not an
+  // error.
+  if (GuardCache)
+    GuardCache->write();
+}
+
 size_t HeaderSearch::getTotalMemory() const {
   return SearchDirs.capacity()
     + llvm::capacity_in_bytes(FileInfo)
@@ -1616,6 +1723,7 @@ void HeaderSearch::collectAllModules(SmallVectorImpl<Module *> &Modules) {
   }
 
   // Populate the list of modules.
+  ModMap.resolveLazyModuleDecls();
   for (ModuleMap::module_iterator M = ModMap.module_begin(),
                                MEnd = ModMap.module_end();
        M != MEnd; ++M) {
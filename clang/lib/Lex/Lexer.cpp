@@ -47,6 +47,19 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#elif defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define CLANG_LEXER_USE_NEON
+#endif
+
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -1625,14 +1638,152 @@ bool Lexer::tryConsumeIdentifierUTF8Char(const char *&CurPtr) {
   return true;
 }
 
+//===----------------------------------------------------------------------===//
+// Vectorized scanning of common character runs
+//===----------------------------------------------------------------------===//
+//
+// The buffers we lex are null terminated, so each of these helpers stops at
+// the terminator. The vector loops only look at 16-byte blocks that lie
+// entirely before BufferEnd; the remainder is scanned one byte at a time.
+
+#ifdef CLANG_LEXER_USE_NEON
+/// Reduce a vector of 0x00/0xFF bytes to a 64-bit mask with four bits per
+/// byte, since NEON has no movemask instruction.
+static inline uint64_t getNibbleMask(uint8x16_t Bytes) {
+  return vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Bytes), 4)), 0);
+}
+#endif
+
+/// Return a pointer to the first character at or after \p CurPtr that is not
+/// in [_A-Za-z0-9].
+static const char *skipIdentifierBody(const char *CurPtr,
+                                      const char *BufferEnd) {
+#if defined(__SSE4_2__)
+  const __m128i Ranges = _mm_setr_epi8('0', '9', 'A', 'Z', '_', '_', 'a', 'z',
+                                       0, 0, 0, 0, 0, 0, 0, 0);
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(CurPtr));
+    int Idx = _mm_cmpestri(Ranges, 8, Chars, 16,
+                           _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+                               _SIDD_NEGATIVE_POLARITY);
+    if (Idx != 16)
+      return CurPtr + Idx;
+    CurPtr += 16;
+  }
+#elif defined(__SSE2__)
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(CurPtr));
+    // ASCII letters only differ in case by bit 5. Bytes with the high bit set
+    // compare as negative and so are never in range.
+    __m128i Upper = _mm_and_si128(Chars, _mm_set1_epi8((char)0xDF));
+    __m128i IsAlpha =
+        _mm_and_si128(_mm_cmpgt_epi8(Upper, _mm_set1_epi8('A' - 1)),
+                      _mm_cmplt_epi8(Upper, _mm_set1_epi8('Z' + 1)));
+    __m128i IsDigit =
+        _mm_and_si128(_mm_cmpgt_epi8(Chars, _mm_set1_epi8('0' - 1)),
+                      _mm_cmplt_epi8(Chars, _mm_set1_epi8('9' + 1)));
+    __m128i IsUnderscore = _mm_cmpeq_epi8(Chars, _mm_set1_epi8('_'));
+    unsigned Mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(IsAlpha, IsDigit), IsUnderscore));
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#elif defined(CLANG_LEXER_USE_NEON)
+  while (CurPtr + 16 <= BufferEnd) {
+    uint8x16_t Chars = vld1q_u8(reinterpret_cast<const uint8_t *>(CurPtr));
+    uint8x16_t Upper = vandq_u8(Chars, vdupq_n_u8(0xDF));
+    uint8x16_t IsAlpha =
+        vcleq_u8(vsubq_u8(Upper, vdupq_n_u8('A')), vdupq_n_u8('Z' - 'A'));
+    uint8x16_t IsDigit =
+        vcleq_u8(vsubq_u8(Chars, vdupq_n_u8('0')), vdupq_n_u8('9' - '0'));
+    uint8x16_t IsUnderscore = vceqq_u8(Chars, vdupq_n_u8('_'));
+    uint64_t Mask = getNibbleMask(
+        vmvnq_u8(vorrq_u8(vorrq_u8(IsAlpha, IsDigit), IsUnderscore)));
+    if (Mask)
+      return CurPtr + llvm::countTrailingZeros(Mask) / 4;
+    CurPtr += 16;
+  }
+#endif
+  while (isIdentifierBody(*CurPtr))
+    ++CurPtr;
+  return CurPtr;
+}
+
+/// Return a pointer to the first character at or after \p CurPtr that is not
+/// horizontal whitespace.
+static const char *skipHorizontalWhitespace(const char *CurPtr,
+                                            const char *BufferEnd) {
+#if defined(__SSE2__)
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(CurPtr));
+    __m128i IsSpace =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\t'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('\f')),
+                                  _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\v'))));
+    unsigned Mask = _mm_movemask_epi8(IsSpace);
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countTrailingOnes(Mask);
+    CurPtr += 16;
+  }
+#elif defined(CLANG_LEXER_USE_NEON)
+  while (CurPtr + 16 <= BufferEnd) {
+    uint8x16_t Chars = vld1q_u8(reinterpret_cast<const uint8_t *>(CurPtr));
+    uint8x16_t IsSpace =
+        vorrq_u8(vorrq_u8(vceqq_u8(Chars, vdupq_n_u8(' ')),
+                          vceqq_u8(Chars, vdupq_n_u8('\t'))),
+                 vorrq_u8(vceqq_u8(Chars, vdupq_n_u8('\f')),
+                          vceqq_u8(Chars, vdupq_n_u8('\v'))));
+    uint64_t Mask = getNibbleMask(vmvnq_u8(IsSpace));
+    if (Mask)
+      return CurPtr + llvm::countTrailingZeros(Mask) / 4;
+    CurPtr += 16;
+  }
+#endif
+  while (isHorizontalWhitespace(*CurPtr))
+    ++CurPtr;
+  return CurPtr;
+}
+
+/// Return a pointer to the first '\n', '\r' or null character at or after
+/// \p CurPtr.
+static const char *findLineEnd(const char *CurPtr, const char *BufferEnd) {
+#if defined(__SSE2__)
+  while (CurPtr + 16 <= BufferEnd) {
+    __m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(CurPtr));
+    __m128i IsEnd =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('\n')),
+                                  _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\r'))),
+                     _mm_cmpeq_epi8(Chars, _mm_setzero_si128()));
+    unsigned Mask = _mm_movemask_epi8(IsEnd);
+    if (Mask)
+      return CurPtr + llvm::countTrailingZeros(Mask);
+    CurPtr += 16;
+  }
+#elif defined(CLANG_LEXER_USE_NEON)
+  while (CurPtr + 16 <= BufferEnd) {
+    uint8x16_t Chars = vld1q_u8(reinterpret_cast<const uint8_t *>(CurPtr));
+    uint8x16_t IsEnd = vorrq_u8(vorrq_u8(vceqq_u8(Chars, vdupq_n_u8('\n')),
+                                         vceqq_u8(Chars, vdupq_n_u8('\r'))),
+                                vceqq_u8(Chars, vdupq_n_u8(0)));
+    uint64_t Mask = getNibbleMask(IsEnd);
+    if (Mask)
+      return CurPtr + llvm::countTrailingZeros(Mask) / 4;
+    CurPtr += 16;
+  }
+#endif
+  while (*CurPtr != 0 && *CurPtr != '\n' && *CurPtr != '\r')
+    ++CurPtr;
+  return CurPtr;
+}
+
 bool Lexer::LexIdentifier(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched [_A-Za-z$]
   unsigned Size;
-  unsigned char C = *CurPtr++;
-  while (isIdentifierBody(C))
-    C = *CurPtr++;
-
-  --CurPtr;   // Back up over the skipped character.
+  CurPtr = skipIdentifierBody(CurPtr, BufferEnd);
+  unsigned char C = *CurPtr;
 
   // Fast path, no $,\,? in identifier found.  '\' might be an escaped newline
   // or UCN, and ? might be a trigraph for '\', an escaped newline or UCN.
@@ -2183,8 +2334,10 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
   // Skip consecutive spaces efficiently.
   while (true) {
     // Skip horizontal whitespace very aggressively.
-    while (isHorizontalWhitespace(Char))
-      Char = *++CurPtr;
+    if (isHorizontalWhitespace(Char)) {
+      CurPtr = skipHorizontalWhitespace(CurPtr, BufferEnd);
+      Char = *CurPtr;
+    }
 
     // Otherwise if we have something other than whitespace, we're done.
     if (!isVerticalWhitespace(Char))
@@ -2252,11 +2405,10 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
   // character that ends the line comment.
   char C;
   while (true) {
+    // Skip over characters in the fast loop, stopping at a potential EOF, a
+    // newline or a DOS-style newline.
+    CurPtr = findLineEnd(CurPtr, BufferEnd);
     C = *CurPtr;
-    // Skip over characters in the fast loop.
-    while (C != 0 &&                // Potentially EOF.
-           C != '\n' && C != '\r')  // Newline or DOS-style newline.
-      C = *++CurPtr;
 
     const char *NextLine = CurPtr;
     if (C != 0) {
@@ -2459,13 +2611,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
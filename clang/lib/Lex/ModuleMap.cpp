@@ -39,6 +39,8 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
@@ -762,6 +764,9 @@ ModuleMap::isHeaderUnavailableInModule(const FileEntry *Header,
 }
 
 Module *ModuleMap::findModule(StringRef Name) const {
+  if (!LazyModuleDeclsByName.empty())
+    parseLazyModuleDecls(Name);
+
   llvm::StringMap<Module *>::const_iterator Known = Modules.find(Name);
   if (Known != Modules.end())
     return Known->getValue();
@@ -1148,6 +1153,26 @@ void ModuleMap::addUnresolvedHeader(Module *Mod,
 }
 
 void ModuleMap::resolveHeaderDirectives(const FileEntry *File) const {
+  // Any lazy module declaration with an umbrella may cover this header; the
+  // others can only name it explicitly. Parse all declarations of the modules
+  // involved, so that each module is completed in declaration order.
+  if (!LazyUmbrellaModuleDecls.empty() || !LazyModuleDeclsByHeader.empty()) {
+    SmallVector<unsigned, 4> Indices;
+    Indices.swap(LazyUmbrellaModuleDecls);
+    auto ByHeader = LazyModuleDeclsByHeader.find(
+        llvm::sys::path::filename(File->getName()));
+    if (ByHeader != LazyModuleDeclsByHeader.end()) {
+      Indices.append(ByHeader->second.begin(), ByHeader->second.end());
+      LazyModuleDeclsByHeader.erase(ByHeader);
+    }
+    llvm::StringSet<> Names;
+    for (unsigned Index : Indices)
+      if (!LazyModuleDecls[Index].Parsed)
+        Names.insert(LazyModuleDecls[Index].Name);
+    for (const auto &Name : Names)
+      parseLazyModuleDecls(Name.getKey());
+  }
+
   auto BySize = LazyHeadersBySize.find(File->getSize());
   if (BySize != LazyHeadersBySize.end()) {
     for (auto *M : BySize->second)
@@ -1172,6 +1197,16 @@ void ModuleMap::resolveHeaderDirectives(Module *Mod) const {
   Mod->UnresolvedHeaders.clear();
 }
 
+void ModuleMap::resolveLazyModuleDecls() const {
+  // Parsing can index more module map files, so don't cache the size.
+  for (unsigned I = 0; I != LazyModuleDecls.size(); ++I)
+    if (!LazyModuleDecls[I].Parsed)
+      parseLazyModuleDecls(StringRef(LazyModuleDecls[I].Name));
+  LazyModuleDeclsByName.clear();
+  LazyModuleDeclsByHeader.clear();
+  LazyUmbrellaModuleDecls.clear();
+}
+
 void ModuleMap::addHeader(Module *Mod, Module::Header Header,
                           ModuleHeaderRole Role, bool Imported) {
   KnownHeader KH(Mod, Role);
@@ -1302,6 +1337,26 @@ bool ModuleMap::resolveConflicts(Module *Mod, bool Complain) {
 
 namespace clang {
 
+  /// A top-level module declaration found when indexing a module map file.
+  struct IndexedModuleDecl {
+    /// The offset of the declaration within the module map file.
+    unsigned Offset = 0;
+
+    /// Whether the declaration has to be parsed when the file is loaded:
+    /// 'extern module' declarations, inferred modules, and declarations we
+    /// could not index.
+    bool Eager = false;
+
+    /// Whether the declaration has an umbrella header or directory.
+    bool HasUmbrella = false;
+
+    /// The first component of the module name.
+    std::string Name;
+
+    /// The file names of the headers named anywhere within the declaration.
+    std::vector<std::string> HeaderNames;
+  };
+
   /// A token in a module map file.
   struct MMToken {
     enum TokenKind {
@@ -1437,6 +1492,7 @@ namespace clang {
     void parseConfigMacros();
     void parseConflict();
     void parseInferredModuleDecl(bool Framework, bool Explicit);
+    void indexModuleDecl(IndexedModuleDecl &Decl);
 
     /// Private modules are canonicalized as Foo_Private. Clang provides extra
     /// module map search logic to find the appropriate private module when PCH
@@ -1463,6 +1519,16 @@ namespace clang {
 
     bool parseModuleMapFile();
 
+    /// Parse the top-level module declaration at the current position.
+    ///
+    /// \returns true if an error occurred, false otherwise.
+    bool parseTopLevelModuleDecl() {
+      parseModuleDecl();
+      return HadError;
+    }
+
+    bool indexModuleMapFile(std::vector<IndexedModuleDecl> &Decls);
+
     bool terminatedByDirective() { return false; }
     SourceLocation getLocation() { return Tok.getLocation(); }
   };
@@ -2950,6 +3016,306 @@ bool ModuleMapParser::parseModuleMapFile() {
   } while (true);
 }
 
+/// Skip over a top-level module declaration, recording its name and the
+/// headers it names.
+void ModuleMapParser::indexModuleDecl(IndexedModuleDecl &Decl) {
+  Decl.Offset = SourceMgr.getDecomposedLoc(Tok.getLocation()).second;
+
+  bool Extern = false;
+  while (Tok.is(MMToken::ExplicitKeyword) ||
+         Tok.is(MMToken::FrameworkKeyword) || Tok.is(MMToken::ExternKeyword)) {
+    Extern |= Tok.is(MMToken::ExternKeyword);
+    consumeToken();
+  }
+  if (Tok.is(MMToken::ModuleKeyword))
+    consumeToken();
+
+  if (!Extern &&
+      (Tok.is(MMToken::Identifier) || Tok.is(MMToken::StringLiteral)))
+    Decl.Name = Tok.getString();
+  else
+    Decl.Eager = true;
+
+  unsigned BraceDepth = 0;
+  do {
+    switch (Tok.Kind) {
+    case MMToken::EndOfFile:
+      Decl.Eager = true;
+      return;
+
+    case MMToken::ExplicitKeyword:
+    case MMToken::ExternKeyword:
+    case MMToken::FrameworkKeyword:
+    case MMToken::ModuleKeyword:
+      // The next declaration starts here; this one has no body.
+      if (BraceDepth == 0) {
+        Decl.Eager = true;
+        return;
+      }
+      break;
+
+    case MMToken::LBrace:
+      ++BraceDepth;
+      break;
+
+    case MMToken::RBrace:
+      if (BraceDepth <= 1) {
+        Decl.Eager |= BraceDepth == 0;
+        consumeToken();
+        return;
+      }
+      --BraceDepth;
+      break;
+
+    case MMToken::UmbrellaKeyword:
+      Decl.HasUmbrella = true;
+      break;
+
+    case MMToken::HeaderKeyword:
+      consumeToken();
+      if (Tok.is(MMToken::StringLiteral))
+        Decl.HeaderNames.push_back(llvm::sys::path::filename(Tok.getString()));
+      continue;
+
+    default:
+      break;
+    }
+    consumeToken();
+  } while (true);
+}
+
+/// Index the top-level module declarations of a module map file, without
+/// acting on them.
+///
+/// \returns true if an error occurred, false otherwise.
+bool ModuleMapParser::indexModuleMapFile(
+    std::vector<IndexedModuleDecl> &Decls) {
+  do {
+    switch (Tok.Kind) {
+    case MMToken::EndOfFile:
+      return HadError;
+
+    case MMToken::ExplicitKeyword:
+    case MMToken::ExternKeyword:
+    case MMToken::ModuleKeyword:
+    case MMToken::FrameworkKeyword:
+      Decls.emplace_back();
+      indexModuleDecl(Decls.back());
+      break;
+
+    default:
+      Diags.Report(Tok.getLocation(), diag::err_mmap_expected_module);
+      HadError = true;
+      consumeToken();
+      break;
+    }
+  } while (true);
+}
+
+/// Get the path of the cached index of the given module map file, or an
+/// empty path if there is no module cache to keep it in.
+static SmallString<128> getModuleMapIndexPath(FileManager &FileMgr,
+                                              StringRef ModuleCachePath,
+                                              const FileEntry *File) {
+  SmallString<128> IndexPath;
+  if (ModuleCachePath.empty())
+    return IndexPath;
+
+  llvm::MD5 Hasher;
+  Hasher.update(FileMgr.getCanonicalName(File->getDir()));
+  Hasher.update(llvm::sys::path::filename(File->getName()));
+  llvm::MD5::MD5Result Hash;
+  Hasher.final(Hash);
+
+  IndexPath = ModuleCachePath;
+  llvm::sys::path::append(IndexPath, "modulemap-index", Hash.digest());
+  return IndexPath;
+}
+
+/// Get the first line of the cached index of a module map file, which
+/// identifies the version of the file it was built from.
+static std::string getModuleMapIndexStamp(const FileEntry *File) {
+  return "1 " + std::to_string(File->getSize()) + " " +
+         std::to_string(File->getModificationTime());
+}
+
+/// Read the cached index of a module map file.
+///
+/// \returns true if the index was read, false if it is missing or stale.
+static bool readModuleMapIndex(StringRef IndexPath, const FileEntry *File,
+                               std::vector<IndexedModuleDecl> &Decls) {
+  auto Buffer = llvm::MemoryBuffer::getFile(IndexPath);
+  if (!Buffer)
+    return false;
+
+  SmallVector<StringRef, 64> Lines;
+  (*Buffer)->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                                /*KeepEmpty=*/false);
+  if (Lines.empty() || Lines.front() != getModuleMapIndexStamp(File))
+    return false;
+
+  for (StringRef Line : llvm::makeArrayRef(Lines).drop_front()) {
+    SmallVector<StringRef, 8> Fields;
+    Line.split(Fields, '\t');
+    IndexedModuleDecl Decl;
+    if (Fields.size() < 3 || Fields[0].getAsInteger(10, Decl.Offset) ||
+        static_cast<off_t>(Decl.Offset) >= File->getSize())
+      return false;
+    Decl.Eager = Fields[1] == "e";
+    Decl.HasUmbrella = Fields[1] == "u";
+    Decl.Name = Fields[2];
+    for (StringRef Header : llvm::makeArrayRef(Fields).drop_front(3))
+      Decl.HeaderNames.push_back(Header);
+    Decls.push_back(std::move(Decl));
+  }
+  return true;
+}
+
+/// Write the cached index of a module map file. Failures are ignored; the
+/// file will simply be indexed again.
+static void writeModuleMapIndex(StringRef IndexPath, const FileEntry *File,
+                                ArrayRef<IndexedModuleDecl> Decls) {
+  auto IsRepresentable = [](StringRef Field) {
+    return Field.find_first_of("\t\n") == StringRef::npos;
+  };
+  for (const IndexedModuleDecl &Decl : Decls) {
+    if (!IsRepresentable(Decl.Name) ||
+        !llvm::all_of(Decl.HeaderNames, IsRepresentable))
+      return;
+  }
+
+  if (llvm::sys::fs::create_directories(
+          llvm::sys::path::parent_path(IndexPath)))
+    return;
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // compilations never see a partial index.
+  int FD;
+  SmallString<128> TempPath;
+  if (llvm::sys::fs::createUniqueFile(IndexPath + "-%%%%%%%%", FD, TempPath))
+    return;
+
+  bool HadError;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << getModuleMapIndexStamp(File) << '\n';
+    for (const IndexedModuleDecl &Decl : Decls) {
+      OS << Decl.Offset << '\t'
+         << (Decl.Eager ? 'e' : Decl.HasUmbrella ? 'u' : '-') << '\t'
+         << Decl.Name;
+      for (const std::string &Header : Decl.HeaderNames)
+        OS << '\t' << Header;
+      OS << '\n';
+    }
+    OS.close();
+    HadError = OS.has_error();
+    OS.clear_error();
+  }
+
+  if (HadError || llvm::sys::fs::rename(TempPath, IndexPath))
+    llvm::sys::fs::remove(TempPath);
+}
+
+bool ModuleMap::parseModuleMapFileLazily(const FileEntry *File, bool IsSystem,
+                                         const DirectoryEntry *Dir, FileID ID,
+                                         bool &HadError) {
+  const llvm::MemoryBuffer *Buffer = SourceMgr.getBuffer(ID);
+
+  // The cached index describes the file on disk, which an overridden buffer
+  // need not match.
+  SmallString<128> IndexPath;
+  if (!SourceMgr.isFileOverridden(File) &&
+      Buffer->getBufferSize() == static_cast<size_t>(File->getSize()))
+    IndexPath = getModuleMapIndexPath(SourceMgr.getFileManager(),
+                                      HeaderInfo.getModuleCachePath(), File);
+
+  std::vector<IndexedModuleDecl> Decls;
+  if (IndexPath.empty() || !readModuleMapIndex(IndexPath, File, Decls)) {
+    Decls.clear();
+
+    // Don't diagnose anything while indexing. If the file has errors, it is
+    // parsed in full instead, and that diagnoses them.
+    bool WasSuppressed = Diags.getSuppressAllDiagnostics();
+    Diags.setSuppressAllDiagnostics(true);
+    Lexer L(SourceMgr.getLocForStartOfFile(ID), MMapLangOpts,
+            Buffer->getBufferStart(), Buffer->getBufferStart(),
+            Buffer->getBufferEnd());
+    ModuleMapParser Parser(L, SourceMgr, Target, Diags, *this, File, Dir,
+                           IsSystem);
+    bool IndexError = Parser.indexModuleMapFile(Decls);
+    Diags.setSuppressAllDiagnostics(WasSuppressed);
+    if (IndexError)
+      return false;
+
+    if (!IndexPath.empty())
+      writeModuleMapIndex(IndexPath, File, Decls);
+  }
+
+  SmallVector<unsigned, 4> EagerIndices;
+  for (const IndexedModuleDecl &Decl : Decls) {
+    unsigned Index = LazyModuleDecls.size();
+    LazyModuleDecls.push_back({File, Dir, ID, Decl.Name, Decl.Offset,
+                               CurrentModuleScopeID, IsSystem,
+                               /*Parsed=*/false});
+    if (Decl.Eager) {
+      EagerIndices.push_back(Index);
+      continue;
+    }
+
+    LazyModuleDeclsByName[Decl.Name].push_back(Index);
+    if (Decl.HasUmbrella)
+      LazyUmbrellaModuleDecls.push_back(Index);
+    for (const std::string &Header : Decl.HeaderNames)
+      LazyModuleDeclsByHeader[Header].push_back(Index);
+  }
+
+  HadError = parseLazyModuleDecls(EagerIndices);
+  return true;
+}
+
+void ModuleMap::parseLazyModuleDecls(StringRef Name) const {
+  auto Lazy = LazyModuleDeclsByName.find(Name);
+  if (Lazy == LazyModuleDeclsByName.end())
+    return;
+
+  // Remove the entry first: parsing looks the module up by name again.
+  SmallVector<unsigned, 1> Indices = std::move(Lazy->second);
+  LazyModuleDeclsByName.erase(Lazy);
+  parseLazyModuleDecls(Indices);
+}
+
+bool ModuleMap::parseLazyModuleDecls(ArrayRef<unsigned> Indices) const {
+  bool HadError = false;
+  for (unsigned Index : Indices) {
+    if (LazyModuleDecls[Index].Parsed)
+      continue;
+    LazyModuleDecls[Index].Parsed = true;
+
+    // Parsing can index more module map files and grow LazyModuleDecls.
+    LazyModuleDecl Decl = LazyModuleDecls[Index];
+    const llvm::MemoryBuffer *Buffer = SourceMgr.getBuffer(Decl.ID);
+    Lexer L(SourceMgr.getLocForStartOfFile(Decl.ID), MMapLangOpts,
+            Buffer->getBufferStart(), Buffer->getBufferStart() + Decl.Offset,
+            Buffer->getBufferEnd());
+
+    // This operation is logically const; the module was already declared when
+    // its module map file was loaded, we just hadn't looked at it yet. Parse it
+    // in the scope it was declared in, so that shadowing works as if the whole
+    // file had been parsed then.
+    auto *Self = const_cast<ModuleMap *>(this);
+    ModuleMapParser Parser(L, SourceMgr, Target, Diags, *Self,
+                           Decl.ModuleMapFile, Decl.Directory, Decl.IsSystem);
+    unsigned SavedScopeID = Self->CurrentModuleScopeID;
+    Self->CurrentModuleScopeID = Decl.ScopeID;
+    if (Parser.parseTopLevelModuleDecl()) {
+      Self->ParsedModuleMap[Decl.ModuleMapFile] = true;
+      HadError = true;
+    }
+    Self->CurrentModuleScopeID = SavedScopeID;
+  }
+  return HadError;
+}
+
 bool ModuleMap::parseModuleMapFile(const FileEntry *File, bool IsSystem,
                                    const DirectoryEntry *Dir, FileID ID,
                                    unsigned *Offset,
@@ -2974,6 +3340,17 @@ bool ModuleMap::parseModuleMapFile(const FileEntry *File, bool IsSystem,
   assert((!Offset || *Offset <= Buffer->getBufferSize()) &&
          "invalid buffer offset");
 
+  // Only index the module declarations if we can, and parse them on demand.
+  bool Result;
+  if (!Offset && HeaderInfo.getHeaderSearchOpts().LazyModuleMapParsing &&
+      parseModuleMapFileLazily(File, IsSystem, Dir, ID, Result)) {
+    ParsedModuleMap[File] |= Result;
+    for (const auto &Cb : Callbacks)
+      Cb->moduleMapFileRead(SourceMgr.getLocForStartOfFile(ID), *File,
+                            IsSystem);
+    return Result;
+  }
+
   // Parse this module map file.
   Lexer L(SourceMgr.getLocForStartOfFile(ID), MMapLangOpts,
           Buffer->getBufferStart(),
@@ -2982,7 +3359,7 @@ bool ModuleMap::parseModuleMapFile(const FileEntry *File, bool IsSystem,
   SourceLocation Start = L.getSourceLocation();
   ModuleMapParser Parser(L, SourceMgr, Target, Diags, *this, File, Dir,
                          IsSystem);
-  bool Result = Parser.parseModuleMapFile();
+  Result = Parser.parseModuleMapFile();
   ParsedModuleMap[File] = Result;
 
   if (Offset) {
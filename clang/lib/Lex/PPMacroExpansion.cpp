@@ -58,6 +58,8 @@ using namespace clang;
 
 MacroDirective *
 Preprocessor::getLocalMacroDirectiveHistory(const IdentifierInfo *II) const {
+  if (II->isOutOfDate())
+    updateOutOfDateIdentifier(const_cast<IdentifierInfo&>(*II));
   if (!II->hadMacroDefinition())
     return nullptr;
   auto Pos = CurSubmoduleState->Macros.find(II);
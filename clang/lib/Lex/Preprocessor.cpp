@@ -158,6 +158,9 @@ Preprocessor::Preprocessor(std::shared_ptr<PreprocessorOptions> PPOpts,
 
   if (this->PPOpts->GeneratePreamble)
     PreambleConditionalStack.startRecording();
+
+  ExcludedConditionalDirectiveSkipMappings =
+      this->PPOpts->ExcludedConditionalDirectiveSkipMappings;
 }
 
 Preprocessor::~Preprocessor() {
@@ -680,6 +683,9 @@ void Preprocessor::EndSourceFile() {
   // Notify the client that we reached the end of the source file.
   if (Callbacks)
     Callbacks->EndOfMainFile();
+
+  // Let later compilations benefit from the include guards found by this one.
+  HeaderInfo.writeHeaderGuardCache();
 }
 
 //===----------------------------------------------------------------------===//
@@ -273,6 +273,12 @@ void MultiplexExternalSemaSource::ReadExtVectorDecls(
     Sources[i]->ReadExtVectorDecls(Decls);
 }
 
+void MultiplexExternalSemaSource::ReadSatisfiedConstraints(
+    SmallVectorImpl<ExternalSatisfiedConstraint> &Constraints) {
+  for(size_t i = 0; i < Sources.size(); ++i)
+    Sources[i]->ReadSatisfiedConstraints(Constraints);
+}
+
 void MultiplexExternalSemaSource::ReadUnusedLocalTypedefNameCandidates(
     llvm::SmallSetVector<const TypedefNameDecl *, 4> &Decls) {
   for(size_t i = 0; i < Sources.size(); ++i)
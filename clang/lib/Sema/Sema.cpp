@@ -163,7 +163,12 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
       ValueWithBytesObjCTypeMethod(nullptr), NSArrayDecl(nullptr),
       ArrayWithObjectsMethod(nullptr), NSDictionaryDecl(nullptr),
       DictionaryWithObjectsMethod(nullptr), GlobalNewDeleteDeclared(false),
-      TUKind(TUKind), NumSFINAEErrors(0),
+      TUKind(TUKind), NumSFINAEErrors(0), NumAtomicConstraintsEvaluated(0),
+      NumAtomicConstraintsSkipped(0), NumSatisfactionCacheHits(0),
+      NumStandardConceptsDecidedDirectly(0),
+      NumRequirementSubstitutionCacheHits(0),
+      NumTemplateCandidatesRejectedEarly(0),
+      NumDeferredTrailingRequiresClauses(0), NumMemberConstraintChecks(0),
       FullyCheckedComparisonCategories(
           static_cast<unsigned>(ComparisonCategoryType::Last) + 1),
       SatisfactionCache(Context), AccessCheckingSFINAE(false),
@@ -378,6 +383,13 @@ Sema::~Sema() {
     delete First;
   }
 
+  // Delete cached requirement substitutions.
+  while (!RequirementSubstitutionCache.empty()) {
+    SubstitutedRequirement *First = &*RequirementSubstitutionCache.begin();
+    RequirementSubstitutionCache.RemoveNode(First);
+    delete First;
+  }
+
   // Tell the SemaConsumer to forget about us; we're going out of scope.
   if (SemaConsumer *SC = dyn_cast<SemaConsumer>(&Consumer))
     SC->ForgetSema();
@@ -457,6 +469,23 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumAtomicConstraintsEvaluated
+               << " atomic constraints evaluated.\n"
+               << "  " << NumAtomicConstraintsSkipped
+               << " atomic constraints skipped by short-circuiting.\n"
+               << "  " << NumSatisfactionCacheHits
+               << " constraint satisfaction cache hits.\n"
+               << "  " << NumStandardConceptsDecidedDirectly
+               << " standard concepts decided without substitution.\n"
+               << "  " << NumRequirementSubstitutionCacheHits
+               << " requirement substitution cache hits.\n";
+  llvm::errs() << NumTemplateCandidatesRejectedEarly
+               << " function template candidates rejected before deduction.\n";
+  llvm::errs() << NumDeferredTrailingRequiresClauses
+               << " trailing requires-clauses of instantiated functions left"
+                  " unsubstituted.\n"
+               << "  " << NumMemberConstraintChecks
+               << " constraint checks of class template members on use.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
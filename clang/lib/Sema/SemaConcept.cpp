@@ -24,6 +24,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/PointerUnion.h"
+#include "llvm/Support/TimeProfiler.h"
 using namespace clang;
 using namespace sema;
 
@@ -54,6 +55,20 @@ bool Sema::CheckConstraintExpression(Expr *ConstraintExpression,
   return true;
 }
 
+/// \brief Count the atomic constraints calculateConstraintSatisfaction would
+/// break the given constraint expression down to.
+static unsigned countAtomicConstraints(const Expr *ConstraintExpr) {
+  if (auto *BO = dyn_cast<BinaryOperator>(ConstraintExpr)) {
+    if (BO->getOpcode() == BO_LAnd || BO->getOpcode() == BO_LOr)
+      return countAtomicConstraints(BO->getLHS()) +
+             countAtomicConstraints(BO->getRHS());
+  } else if (auto *PO = dyn_cast<ParenExpr>(ConstraintExpr))
+    return countAtomicConstraints(PO->getSubExpr());
+  else if (auto *C = dyn_cast<ExprWithCleanups>(ConstraintExpr))
+    return countAtomicConstraints(C->getSubExpr());
+  return 1;
+}
+
 template <typename AtomicEvaluator>
 static bool
 calculateConstraintSatisfaction(Sema &S, const Expr *ConstraintExpr,
@@ -67,23 +82,24 @@ calculateConstraintSatisfaction(Sema &S, const Expr *ConstraintExpr,
 
       bool IsLHSSatisfied = Satisfaction.IsSatisfied;
 
-      if (BO->getOpcode() == BO_LOr && IsLHSSatisfied)
+      if ((BO->getOpcode() == BO_LOr && IsLHSSatisfied) ||
+          (BO->getOpcode() == BO_LAnd && !IsLHSSatisfied)) {
         // [temp.constr.op] p3
         //    A disjunction is a constraint taking two operands. To determine if
         //    a disjunction is satisfied, the satisfaction of the first operand
         //    is checked. If that is satisfied, the disjunction is satisfied.
         //    Otherwise, the disjunction is satisfied if and only if the second
         //    operand is satisfied.
-        return false;
-
-      if (BO->getOpcode() == BO_LAnd && !IsLHSSatisfied)
+        //
         // [temp.constr.op] p2
         //    A conjunction is a constraint taking two operands. To determine if
         //    a conjunction is satisfied, the satisfaction of the first operand
         //    is checked. If that is not satisfied, the conjunction is not
         //    satisfied. Otherwise, the conjunction is satisfied if and only if
         //    the second operand is satisfied.
+        S.NumAtomicConstraintsSkipped += countAtomicConstraints(BO->getRHS());
         return false;
+      }
 
       return calculateConstraintSatisfaction(S, BO->getRHS(), Satisfaction,
           std::forward<AtomicEvaluator>(Evaluator));
@@ -96,6 +112,7 @@ calculateConstraintSatisfaction(Sema &S, const Expr *ConstraintExpr,
         std::forward<AtomicEvaluator>(Evaluator));
 
   // An atomic constraint expression
+  ++S.NumAtomicConstraintsEvaluated;
   ExprResult SubstitutedAtomicExpr = Evaluator(ConstraintExpr);
 
   if (SubstitutedAtomicExpr.isInvalid())
@@ -122,7 +139,7 @@ calculateConstraintSatisfaction(Sema &S, const Expr *ConstraintExpr,
   }
 
   Satisfaction.IsSatisfied = EvalResult.Val.getInt().getBoolValue();
-  if (!Satisfaction.IsSatisfied)
+  if (!Satisfaction.IsSatisfied && !Satisfaction.IsProbe)
     Satisfaction.Details.emplace_back(ConstraintExpr,
                                       SubstitutedAtomicExpr.get());
 
@@ -164,12 +181,17 @@ static bool calculateConstraintSatisfaction(Sema &S,
               // substitution.
               return ExprError();
 
+            Satisfaction.IsSatisfied = false;
+            if (Satisfaction.IsProbe)
+              // Nobody is going to diagnose this - do not bother keeping the
+              // substitution diagnostic around.
+              return ExprEmpty();
+
             auto *SubstDiag =
                 new PartialDiagnosticAt{SourceLocation(),
                                         PartialDiagnostic::NullDiagnostic()};
             Info.takeSFINAEDiagnostic(*SubstDiag);
             Satisfaction.Details.emplace_back(AtomicExpr, SubstDiag);
-            Satisfaction.IsSatisfied = false;
             return ExprEmpty();
           }
         }
@@ -218,47 +240,130 @@ CheckConstraintSatisfaction(Sema &S, ArrayRef<const Expr *> ConstraintExprs,
                             ConstraintSatisfaction &Satisfaction,
                             bool *ContainsUnexpandedParameterPack = nullptr,
                             bool *IsDependent = nullptr) {
-  for (const Expr *ConstraintExpr : ConstraintExprs) {
+  for (unsigned I = 0, N = ConstraintExprs.size(); I != N; ++I) {
     if (calculateConstraintSatisfaction(S, Creator, TemplateArgs,
                                         TemplateIDRange.getBegin(),
-                                        ConstraintExpr, Satisfaction,
+                                        ConstraintExprs[I], Satisfaction,
                                         ContainsUnexpandedParameterPack,
                                         IsDependent))
       return true;
-    if (!Satisfaction.IsSatisfied)
+    if (!Satisfaction.IsSatisfied) {
       // [temp.constr.op] p2
       //   [...] To determine if a conjunction is satisfied, the satisfaction
       //   of the first operand is checked. If that is not satisfied, the
       //   conjunction is not satisfied. [...]
+      for (const Expr *Skipped : ConstraintExprs.drop_front(I + 1))
+        S.NumAtomicConstraintsSkipped += countAtomicConstraints(Skipped);
       return false;
+    }
   }
   return false;
 }
 
+/// Decide the satisfaction of a standard library concept that is equivalent
+/// to a type trait directly from its template arguments, without substituting
+/// them into the concept's definition and instantiating the traits it uses.
+///
+/// \returns None if \p ConstraintOwner is not such a concept, or if the
+/// arguments are not handled here.
+static Optional<bool>
+decideStandardConcept(ASTContext &Context, const NamedDecl *ConstraintOwner,
+                      ArrayRef<TemplateArgument> Args) {
+  const auto *Concept = dyn_cast<ConceptDecl>(ConstraintOwner);
+  if (!Concept || !Concept->getIdentifier() || !Concept->isInStdNamespace())
+    return None;
+  for (const TemplateArgument &Arg : Args)
+    if (Arg.getKind() != TemplateArgument::Type || Arg.isDependent())
+      return None;
+
+  StringRef Name = Concept->getName();
+  if (Name == "same_as") {
+    if (Args.size() != 2)
+      return None;
+    return Context.hasSameType(Args[0].getAsType(), Args[1].getAsType());
+  }
+
+  if ((Name != "integral" && Name != "signed_integral" &&
+       Name != "unsigned_integral") ||
+      Args.size() != 1)
+    return None;
+  const auto *BT = Args[0].getAsType()->getAs<BuiltinType>();
+  // Whether the 128-bit integers satisfy std::integral depends on the library
+  // and its configuration.
+  if (BT && (BT->getKind() == BuiltinType::Int128 ||
+             BT->getKind() == BuiltinType::UInt128))
+    return None;
+  if (!BT || !BT->isInteger())
+    return false;
+  if (Name == "signed_integral")
+    return BT->isSignedInteger();
+  if (Name == "unsigned_integral")
+    return BT->isUnsignedInteger();
+  return true;
+}
+
 bool Sema::CheckConstraintSatisfaction(NamedDecl *ConstraintOwner,
     NamedDecl *Template, ArrayRef<const Expr *> ConstraintExprs,
     const MultiLevelTemplateArgumentList &TemplateArgs,
-    SourceRange TemplateIDRange, ConstraintSatisfaction &Satisfaction) {
+    SourceRange TemplateIDRange, ConstraintSatisfaction &Satisfaction,
+    bool Probe) {
   if (ConstraintExprs.empty()) {
     Satisfaction.IsSatisfied = true;
     return false;
   }
 
+  // An unsatisfied concept is still checked by substitution unless this is a
+  // probe, as diagnosing it needs the Details recorded along the way.
+  if (Optional<bool> IsSatisfied = decideStandardConcept(
+          Context, ConstraintOwner, TemplateArgs.getInnermost())) {
+    if (*IsSatisfied || Probe) {
+      ++NumStandardConceptsDecidedDirectly;
+      Satisfaction.IsSatisfied = *IsSatisfied;
+      Satisfaction.IsProbe = Probe;
+      return false;
+    }
+  }
+
   llvm::FoldingSetNodeID ID;
   void *InsertPos;
   ConstraintSatisfaction::Profile(ID, Context, ConstraintOwner,
                                   TemplateArgs.getInnermost());
   ConstraintSatisfaction *Cached =
       SatisfactionCache.FindNodeOrInsertPos(ID, InsertPos);
-  if (!Cached) {
+  if (!Cached && ExternalSource) {
+    LoadExternalSatisfiedConstraints();
+    Cached = SatisfactionCache.FindNodeOrInsertPos(ID, InsertPos);
+  }
+  if (Cached && Cached->IsProbe && !Cached->IsSatisfied && !Probe) {
+    // The details needed to diagnose the unsatisfied constraints were not
+    // recorded - check them again.
+    SatisfactionCache.RemoveNode(Cached);
+    delete Cached;
+    Cached = nullptr;
+  }
+  if (Cached) {
+    ++NumSatisfactionCacheHits;
+  } else {
+    llvm::TimeTraceScope TimeScope("CheckConstraintSatisfaction", [&]() {
+      std::string Name;
+      llvm::raw_string_ostream OS(Name);
+      ConstraintOwner->getNameForDiagnostic(OS, getPrintingPolicy(),
+                                            /*Qualified=*/true);
+      if (isa<TemplateDecl>(ConstraintOwner))
+        printTemplateArgumentList(OS, TemplateArgs.getInnermost(),
+                                  getPrintingPolicy());
+      return OS.str();
+    });
+
     InstantiatingTemplate Inst(*this, TemplateIDRange.getBegin(),
         InstantiatingTemplate::ConstraintsCheck{}, Template,
         TemplateArgs.getInnermost(), TemplateIDRange);
     if (Inst.isInvalid())
       return true;
 
-    Cached = new ConstraintSatisfaction(ConstraintOwner,
+    Cached = new ConstraintSatisfaction(Context, ConstraintOwner,
                                         TemplateArgs.getInnermost());
+    Cached->IsProbe = Probe;
 
     if (::CheckConstraintSatisfaction(*this, ConstraintExprs,
         TemplateArgs, TemplateIDRange,
@@ -280,6 +385,23 @@ bool Sema::CheckConstraintSatisfaction(NamedDecl *ConstraintOwner,
   return false;
 }
 
+void Sema::LoadExternalSatisfiedConstraints() {
+  SmallVector<ExternalSatisfiedConstraint, 16> Satisfied;
+  ExternalSource->ReadSatisfiedConstraints(Satisfied);
+  for (const ExternalSatisfiedConstraint &Constraint : Satisfied) {
+    llvm::FoldingSetNodeID ID;
+    void *InsertPos;
+    ConstraintSatisfaction::Profile(ID, Context, Constraint.ConstraintOwner,
+                                    Constraint.TemplateArgs);
+    if (SatisfactionCache.FindNodeOrInsertPos(ID, InsertPos))
+      continue;
+    auto *Satisfaction = new ConstraintSatisfaction(
+        Context, Constraint.ConstraintOwner, Constraint.TemplateArgs);
+    Satisfaction->IsSatisfied = true;
+    SatisfactionCache.InsertNode(Satisfaction, InsertPos);
+  }
+}
+
 bool Sema::CheckConstraintSatisfaction(NestedRequirement *Req,
     const Expr *ConstraintExpr,
     const MultiLevelTemplateArgumentList &TemplateArgs,
@@ -471,9 +593,6 @@ void Sema::DiagnoseUnsatisfiedConstraint(
   }
 }
 
-using NormalForm =
-    llvm::SmallVector<llvm::SmallVector<AtomicConstraint *, 2>, 4>;
-
 static NormalForm makeCNF(const NormalizedConstraint &Normalized) {
   if (Normalized.isAtomic())
     return {{Normalized.getAtomicConstraint()}};
@@ -533,18 +652,31 @@ static NormalForm makeDNF(const NormalizedConstraint &Normalized) {
   return Res;
 }
 
+const NormalForm &
+Sema::getDisjunctiveNormalForm(const NormalizedConstraint *N) {
+  std::unique_ptr<NormalForm> &Entry = DNFCache[N];
+  if (!Entry)
+    Entry = llvm::make_unique<NormalForm>(makeDNF(*N));
+  return *Entry;
+}
+
+const NormalForm &
+Sema::getConjunctiveNormalForm(const NormalizedConstraint *N) {
+  std::unique_ptr<NormalForm> &Entry = CNFCache[N];
+  if (!Entry)
+    Entry = llvm::make_unique<NormalForm>(makeCNF(*N));
+  return *Entry;
+}
+
+/// \brief Check whether P subsumes Q, given the disjunctive normal form of P
+/// and the conjunctive normal form of Q.
 template<typename AtomicSubsumptionEvaluator>
-static bool subsumes(Sema &S, NormalizedConstraint &PNormalized,
-                     NormalizedConstraint &QNormalized, bool &DoesSubsume,
-                     AtomicSubsumptionEvaluator E) {
+static bool subsumes(const NormalForm &PDNF, const NormalForm &QCNF,
+                     bool &DoesSubsume, AtomicSubsumptionEvaluator E) {
   // C++ [temp.constr.order] p2
   //   In order to determine if a constraint P subsumes a constraint Q, P is
   //   transformed into disjunctive normal form, and Q is transformed into
   //   conjunctive normal form. [...]
-  const NormalForm PDNF = makeDNF(PNormalized);
-  const NormalForm QCNF = makeCNF(QNormalized);
-
-  // C++ [temp.constr.order] p2
   //   Then, P subsumes Q if and only if, for every disjunctive clause Pi in the
   //   disjunctive normal form of P, Pi subsumes every conjunctive clause Qj in
   //   the conjuctive normal form of Q, where [...]
@@ -576,6 +708,20 @@ static bool subsumes(Sema &S, NormalizedConstraint &PNormalized,
   return false;
 }
 
+static bool isAtLeastAsConstrained(Sema &S, const NormalForm &PDNF,
+                                   const NormalForm &QCNF, bool *Invalid) {
+  bool Subsumes;
+  if (subsumes(PDNF, QCNF, Subsumes,
+        [&S] (const AtomicConstraint &A, const AtomicConstraint &B) {
+          return A.subsumes(S.Context, B);
+        })) {
+    if (Invalid)
+      *Invalid = true;
+    return false;
+  }
+  return Subsumes;
+}
+
 bool Sema::IsAtLeastAsConstrained(NamedDecl *D1, ArrayRef<const Expr *> AC1,
                                   NamedDecl *D2, ArrayRef<const Expr *> AC2,
                                   bool *Invalid) {
@@ -592,12 +738,27 @@ bool Sema::IsAtLeastAsConstrained(NamedDecl *D1, ArrayRef<const Expr *> AC1,
   if (CacheEntry != SubsumptionCache.end())
     return CacheEntry->second;
 
-  MultiLevelTemplateArgumentList MLTAL1 =
-      getTemplateInstantiationArgs(cast<Decl>(D1->getDeclContext()));
-  MultiLevelTemplateArgumentList MLTAL2 =
-      getTemplateInstantiationArgs(cast<Decl>(D2->getDeclContext()));
-  bool Subsumes = IsAtLeastAsConstrained(D1, AC1, MLTAL1, D2, AC2, MLTAL2,
-                                         Invalid);
+  llvm::TimeTraceScope TimeScope("CheckConstraintSubsumption", [&]() {
+    std::string Name;
+    llvm::raw_string_ostream OS(Name);
+    D1->getNameForDiagnostic(OS, getPrintingPolicy(), /*Qualified=*/true);
+    OS << ", ";
+    D2->getNameForDiagnostic(OS, getPrintingPolicy(), /*Qualified=*/true);
+    return OS.str();
+  });
+
+  bool Subsumes = false;
+  const NormalizedConstraint *Normalized1 =
+      getNormalizedAssociatedConstraints(D1, AC1);
+  const NormalizedConstraint *Normalized2 =
+      getNormalizedAssociatedConstraints(D2, AC2);
+  if (Normalized1 && Normalized2)
+    Subsumes = isAtLeastAsConstrained(*this,
+                                      getDisjunctiveNormalForm(Normalized1),
+                                      getConjunctiveNormalForm(Normalized2),
+                                      Invalid);
+  else if (Invalid)
+    *Invalid = true;
   SubsumptionCache.try_emplace(Key, Subsumes);
   return Subsumes;
 }
@@ -617,43 +778,28 @@ Sema::IsAtLeastAsConstrained(NamedDecl *D1, ArrayRef<const Expr *> AC1,
     // TD1 has associated constraints and TD2 does not.
     return true;
 
+  // The template arguments were provided explicitly and may differ from the
+  // ones the cached normal forms were built with - normalize from scratch.
   auto Normalized1 = NormalizedConstraint::fromConstraintExprs(*this, D1, AC1,
                                                                MLTAL1);
-  if (!Normalized1) {
-    if (Invalid)
-      *Invalid = true;
-    return false;
-  }
-
   auto Normalized2 = NormalizedConstraint::fromConstraintExprs(*this, D2, AC2,
                                                                MLTAL2);
-  if (!Normalized2) {
-    if (Invalid)
-      *Invalid = true;
-    return false;
-  }
-
-  bool Subsumes;
-  if (subsumes(*this, *Normalized1, *Normalized2, Subsumes,
-        [this] (const AtomicConstraint &A, const AtomicConstraint &B) {
-          return A.subsumes(Context, B);
-        })) {
+  if (!Normalized1 || !Normalized2) {
     if (Invalid)
       *Invalid = true;
     return false;
   }
-  return Subsumes;
+  return isAtLeastAsConstrained(*this, makeDNF(*Normalized1),
+                                makeCNF(*Normalized2), Invalid);
 }
 
-bool Sema::MaybeEmitAmbiguousAtomicConstraintsDiagnostic(NamedDecl *D1,
-    ArrayRef<const Expr *> AC1, const MultiLevelTemplateArgumentList &MLTAL1,
-    NamedDecl *D2, ArrayRef<const Expr *> AC2,
-    const MultiLevelTemplateArgumentList &MLTAL2) {
-  if (AC1.empty() || AC2.empty())
-    return false;
-
+static bool
+maybeEmitAmbiguousAtomicConstraintsDiagnostic(Sema &S,
+    const NormalForm &DNF1, const NormalForm &CNF1,
+    const NormalForm &DNF2, const NormalForm &CNF2) {
+  ASTContext &Context = S.Context;
   auto NormalExprEvaluator =
-      [this] (const AtomicConstraint &A, const AtomicConstraint &B) {
+      [&Context] (const AtomicConstraint &A, const AtomicConstraint &B) {
         return A.subsumes(Context, B);
       };
 
@@ -681,33 +827,17 @@ bool Sema::MaybeEmitAmbiguousAtomicConstraintsDiagnostic(NamedDecl *D1,
 
   {
     // The subsumption checks might cause diagnostics
-    SFINAETrap Trap(*this);
-
-    auto Normalized1 = NormalizedConstraint::fromConstraintExprs(*this, D1, AC1,
-                                                                 MLTAL1);
-    if (!Normalized1)
-      // Program is ill-formed at this point.
-      return false;
-
-    auto Normalized2 = NormalizedConstraint::fromConstraintExprs(*this, D2, AC2,
-                                                                 MLTAL2);
-    if (!Normalized2)
-      // Program is ill-formed at this point.
-      return false;
+    Sema::SFINAETrap Trap(S);
 
     bool Is1AtLeastAs2Normally, Is2AtLeastAs1Normally;
-    if (subsumes(*this, *Normalized1, *Normalized2, Is1AtLeastAs2Normally,
-                 NormalExprEvaluator))
+    if (subsumes(DNF1, CNF2, Is1AtLeastAs2Normally, NormalExprEvaluator))
       return false;
-    if (subsumes(*this, *Normalized2, *Normalized1, Is2AtLeastAs1Normally,
-                 NormalExprEvaluator))
+    if (subsumes(DNF2, CNF1, Is2AtLeastAs1Normally, NormalExprEvaluator))
       return false;
     bool Is1AtLeastAs2, Is2AtLeastAs1;
-    if (subsumes(*this, *Normalized1, *Normalized2, Is1AtLeastAs2,
-                 IdenticalExprEvaluator))
+    if (subsumes(DNF1, CNF2, Is1AtLeastAs2, IdenticalExprEvaluator))
       return false;
-    if (subsumes(*this, *Normalized2, *Normalized1, Is2AtLeastAs1,
-                 IdenticalExprEvaluator))
+    if (subsumes(DNF2, CNF1, Is2AtLeastAs1, IdenticalExprEvaluator))
       return false;
     if (Is1AtLeastAs2 == Is1AtLeastAs2Normally &&
         Is2AtLeastAs1 == Is2AtLeastAs1Normally)
@@ -718,25 +848,60 @@ bool Sema::MaybeEmitAmbiguousAtomicConstraintsDiagnostic(NamedDecl *D1,
   // A different result! Some ambiguous atomic constraint(s) caused a difference
   assert(AmbiguousAtomic1 && AmbiguousAtomic2);
 
-  Diag(AmbiguousAtomic1->getBeginLoc(), diag::note_ambiguous_atomic_constraints)
+  S.Diag(AmbiguousAtomic1->getBeginLoc(),
+         diag::note_ambiguous_atomic_constraints)
       << const_cast<Expr *>(AmbiguousAtomic1)
       << AmbiguousAtomic1->getSourceRange();
-  Diag(AmbiguousAtomic2->getBeginLoc(),
-       diag::note_ambiguous_atomic_constraints_second)
+  S.Diag(AmbiguousAtomic2->getBeginLoc(),
+         diag::note_ambiguous_atomic_constraints_second)
       << AmbiguousAtomic2->getSourceRange();
   return true;
 }
 
+bool Sema::MaybeEmitAmbiguousAtomicConstraintsDiagnostic(NamedDecl *D1,
+    ArrayRef<const Expr *> AC1, const MultiLevelTemplateArgumentList &MLTAL1,
+    NamedDecl *D2, ArrayRef<const Expr *> AC2,
+    const MultiLevelTemplateArgumentList &MLTAL2) {
+  if (AC1.empty() || AC2.empty())
+    return false;
+
+  llvm::Optional<NormalizedConstraint> Normalized1, Normalized2;
+  {
+    // Normalization might cause diagnostics
+    SFINAETrap Trap(*this);
+    Normalized1 = NormalizedConstraint::fromConstraintExprs(*this, D1, AC1,
+                                                            MLTAL1);
+    Normalized2 = NormalizedConstraint::fromConstraintExprs(*this, D2, AC2,
+                                                            MLTAL2);
+  }
+  if (!Normalized1 || !Normalized2)
+    // Program is ill-formed at this point.
+    return false;
+  return ::maybeEmitAmbiguousAtomicConstraintsDiagnostic(*this,
+      makeDNF(*Normalized1), makeCNF(*Normalized1), makeDNF(*Normalized2),
+      makeCNF(*Normalized2));
+}
+
 bool Sema::MaybeEmitAmbiguousAtomicConstraintsDiagnostic(NamedDecl *D1,
     ArrayRef<const Expr *> AC1, NamedDecl *D2, ArrayRef<const Expr *> AC2) {
   if (AC1.empty() || AC2.empty())
     return false;
-  MultiLevelTemplateArgumentList MLTAL1 =
-      getTemplateInstantiationArgs(cast<Decl>(D1->getDeclContext()));
-  MultiLevelTemplateArgumentList MLTAL2 =
-      getTemplateInstantiationArgs(cast<Decl>(D2->getDeclContext()));
-  return MaybeEmitAmbiguousAtomicConstraintsDiagnostic(D1, AC1, MLTAL1, D2, AC2,
-                                                       MLTAL2);
+
+  const NormalizedConstraint *Normalized1, *Normalized2;
+  {
+    // Normalization might cause diagnostics
+    SFINAETrap Trap(*this);
+    Normalized1 = getNormalizedAssociatedConstraints(D1, AC1);
+    Normalized2 = getNormalizedAssociatedConstraints(D2, AC2);
+  }
+  if (!Normalized1 || !Normalized2)
+    // Program is ill-formed at this point.
+    return false;
+  return ::maybeEmitAmbiguousAtomicConstraintsDiagnostic(*this,
+      getDisjunctiveNormalForm(Normalized1),
+      getConjunctiveNormalForm(Normalized1),
+      getDisjunctiveNormalForm(Normalized2),
+      getConjunctiveNormalForm(Normalized2));
 }
 
 
@@ -1010,8 +1175,8 @@ ConstraintSatisfaction::Profile(llvm::FoldingSetNodeID &ID, const ASTContext &C,
                                 NamedDecl *ConstraintOwner,
                                 ArrayRef<TemplateArgument> TemplateArgs) {
   ID.AddPointer(ConstraintOwner->getCanonicalDecl());
-  for (const TemplateArgument &Arg : TemplateArgs)
-    Arg.Profile(ID, C);
+  TemplateArgumentList(TemplateArgumentList::OnStack, TemplateArgs)
+      .Profile(ID, C);
 }
 
 ConstraintSatisfaction::ConstraintSatisfaction(ConstraintSatisfaction &Other):
@@ -1029,7 +1194,7 @@ ConstraintSatisfaction::~ConstraintSatisfaction() {
   //    delete Diag;
 }
 
-llvm::Optional<NormalizedConstraint>
+const NormalizedConstraint *
 Sema::getNormalizedAssociatedConstraints(NamedDecl *TemplateLike) {
   assert(isa<TemplateDecl>(TemplateLike) ||
          isa<VarTemplatePartialSpecializationDecl>(TemplateLike) ||
@@ -1043,11 +1208,35 @@ Sema::getNormalizedAssociatedConstraints(NamedDecl *TemplateLike) {
   else
     cast<VarTemplatePartialSpecializationDecl>(TemplateLike)
         ->getAssociatedConstraints(AssociatedConstraints);
+  return getNormalizedAssociatedConstraints(TemplateLike,
+                                            AssociatedConstraints);
+}
+
+const NormalizedConstraint *
+Sema::getNormalizedAssociatedConstraints(NamedDecl *ConstrainedDecl,
+    ArrayRef<const Expr *> AssociatedConstraints) {
+  auto CacheEntry = NormalizationCache.find(ConstrainedDecl);
+  if (CacheEntry != NormalizationCache.end())
+    return CacheEntry->second;
+
+  llvm::TimeTraceScope TimeScope("NormalizeConstraints", [&]() {
+    std::string Name;
+    llvm::raw_string_ostream OS(Name);
+    ConstrainedDecl->getNameForDiagnostic(OS, getPrintingPolicy(),
+                                          /*Qualified=*/true);
+    return OS.str();
+  });
+
   MultiLevelTemplateArgumentList TemplateArgs =
-      getTemplateInstantiationArgs(cast<Decl>(TemplateLike->getDeclContext()));
-  return NormalizedConstraint::fromConstraintExprs(*this, TemplateLike,
-                                                   AssociatedConstraints,
-                                                   TemplateArgs);
+      getTemplateInstantiationArgs(
+          cast<Decl>(ConstrainedDecl->getDeclContext()));
+  auto Normalized = NormalizedConstraint::fromConstraintExprs(*this,
+      ConstrainedDecl, AssociatedConstraints, TemplateArgs);
+  NormalizedConstraint *Result =
+      Normalized ? new (Context) NormalizedConstraint(std::move(*Normalized))
+                 : nullptr;
+  NormalizationCache.try_emplace(ConstrainedDecl, Result);
+  return Result;
 }
 
 llvm::Optional<NormalizedConstraint>
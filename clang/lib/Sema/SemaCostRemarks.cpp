@@ -0,0 +1,142 @@
+//===--- SemaCostRemarks.cpp - Remarks for expensive Sema work ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the reporting of expensive semantic analysis work.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Sema/SemaCostRemarks.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/Type.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+SemaCostRemarks::SemaCostRemarks(
+    unsigned ThresholdMicros, bool EmitRemarks,
+    std::unique_ptr<llvm::ToolOutputFile> RecordFile)
+    : ThresholdMicros(ThresholdMicros), EmitRemarks(EmitRemarks),
+      RecordFile(std::move(RecordFile)) {
+  if (this->RecordFile)
+    Serializer = llvm::make_unique<llvm::remarks::YAMLSerializer>(
+        this->RecordFile->os());
+}
+
+SemaCostRemarks::~SemaCostRemarks() {}
+
+void SemaCostRemarks::finalize(const Sema &S) {
+  if (!RecordFile)
+    return;
+  // Sema may never be destroyed (-disable-free), so finish the file here.
+  Serializer.reset();
+  RecordFile->keep();
+  RecordFile->os().flush();
+}
+
+void SemaCostRemarks::atTemplateBegin(const Sema &S,
+                                      const Sema::CodeSynthesisContext &Inst) {
+  Starts.push_back(Clock::now());
+}
+
+void SemaCostRemarks::atTemplateEnd(const Sema &S,
+                                    const Sema::CodeSynthesisContext &Inst) {
+  assert(!Starts.empty() && "unbalanced code synthesis contexts");
+  Clock::time_point Start = Starts.pop_back_val();
+
+  WorkKind Kind;
+  switch (Inst.Kind) {
+  case Sema::CodeSynthesisContext::TemplateInstantiation:
+  case Sema::CodeSynthesisContext::DefaultFunctionArgumentInstantiation:
+  case Sema::CodeSynthesisContext::ExceptionSpecInstantiation:
+    Kind = WK_Instantiation;
+    break;
+  case Sema::CodeSynthesisContext::ExplicitTemplateArgumentSubstitution:
+  case Sema::CodeSynthesisContext::DeducedTemplateArgumentSubstitution:
+    Kind = WK_Deduction;
+    break;
+  case Sema::CodeSynthesisContext::ConstraintsCheck:
+    Kind = WK_ConstraintsCheck;
+    break;
+  default:
+    return;
+  }
+
+  auto *Entity = dyn_cast_or_null<NamedDecl>(Inst.Entity);
+  if (!Entity)
+    return;
+
+  report(S, Kind, Inst.PointOfInstantiation, [&](raw_ostream &OS) {
+    Entity->getNameForDiagnostic(OS, S.getPrintingPolicy(),
+                                 /*Qualified=*/true);
+    // A deduction or constraint check names the template, not the
+    // specialization, so print the arguments separately.
+    if (Kind != WK_Instantiation && isa<TemplateDecl>(Entity))
+      printTemplateArgumentList(OS, Inst.template_arguments(),
+                                S.getPrintingPolicy());
+  }, Start);
+}
+
+void SemaCostRemarks::report(
+    const Sema &S, WorkKind Kind, SourceLocation Loc,
+    llvm::function_ref<void(raw_ostream &)> PrintEntity,
+    Clock::time_point Start) {
+  uint64_t Micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - Start)
+                        .count();
+  if (Micros < ThresholdMicros)
+    return;
+
+  std::string Entity;
+  llvm::raw_string_ostream OS(Entity);
+  PrintEntity(OS);
+  OS.flush();
+
+  if (EmitRemarks)
+    S.getDiagnostics().Report(Loc, diag::remark_sema_cost)
+        << Kind << Entity << static_cast<unsigned>(Micros);
+
+  if (!Serializer)
+    return;
+
+  static const char *const RemarkNames[] = {
+      "Instantiation", "Deduction", "ConstraintsCheck", "OverloadResolution"};
+  std::string MicrosStr = llvm::utostr(Micros);
+
+  llvm::remarks::Remark R;
+  R.RemarkType = llvm::remarks::Type::Analysis;
+  R.PassName = "sema-cost";
+  R.RemarkName = RemarkNames[Kind];
+  R.FunctionName = Entity;
+  SourceManager &SM = S.getSourceManager();
+  PresumedLoc PLoc = SM.getPresumedLoc(SM.getExpansionLoc(Loc));
+  if (PLoc.isValid())
+    R.Loc = llvm::remarks::RemarkLocation{PLoc.getFilename(), PLoc.getLine(),
+                                          PLoc.getColumn()};
+  R.Args.push_back({"Entity", Entity, None});
+  R.Args.push_back({"Microseconds", MicrosStr, None});
+  Serializer->emit(R);
+}
+
+SemaCostRemarks::OverloadResolutionScope::OverloadResolutionScope(
+    Sema &S, SourceLocation Loc, DeclarationName Name)
+    : S(S), Loc(Loc), Name(Name) {
+  if (S.CostRemarks)
+    Start = Clock::now();
+}
+
+SemaCostRemarks::OverloadResolutionScope::~OverloadResolutionScope() {
+  if (S.CostRemarks)
+    S.CostRemarks->report(S, WK_OverloadResolution, Loc,
+                          [&](raw_ostream &OS) { OS << Name; }, Start);
+}
@@ -2227,12 +2227,34 @@ bool Sema::LookupQualifiedName(LookupResult &R, DeclContext *LookupCtx,
   }
 
   DeclarationName Name = R.getLookupName();
-  if (!LookupRec->lookupInBases(
-          [=](const CXXBaseSpecifier *Specifier, CXXBasePath &Path) {
-            return BaseCallback(Specifier, Path, Name);
-          },
-          Paths))
-    return false;
+
+  // Reuse the paths found by an earlier lookup of this name in the bases of
+  // this class. The bases of a class being defined may not all be known yet,
+  // and an external source may add members to a base without declaring them,
+  // so such lookups are not cached.
+  CXXBaseLookupCache *Cache = nullptr;
+  if (!LookupRec->isBeingDefined() && !LookupRec->isDependentContext() &&
+      !Context.getExternalSource())
+    Cache = &Context.getBaseLookupCache();
+  unsigned CacheKind = R.getLookupKind();
+
+  if (const CXXBasePaths *Cached =
+          Cache ? Cache->find(LookupRec, Name, CacheKind) : nullptr) {
+    if (Cached->begin() == Cached->end())
+      return false;
+    CXXBasePaths CachedPaths(*Cached);
+    Paths.swap(CachedPaths);
+  } else {
+    bool Found = LookupRec->lookupInBases(
+        [=](const CXXBaseSpecifier *Specifier, CXXBasePath &Path) {
+          return BaseCallback(Specifier, Path, Name);
+        },
+        Paths);
+    if (Cache)
+      Cache->insert(LookupRec, Name, CacheKind, Paths);
+    if (!Found)
+      return false;
+  }
 
   R.setNamingClass(LookupRec);
 
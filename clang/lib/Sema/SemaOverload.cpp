@@ -24,6 +24,7 @@
 #include "clang/Basic/TargetInfo.h"
 #include "clang/Sema/Initialization.h"
 #include "clang/Sema/Lookup.h"
+#include "clang/Sema/SemaCostRemarks.h"
 #include "clang/Sema/SemaInternal.h"
 #include "clang/Sema/Template.h"
 #include "clang/Sema/TemplateDeduction.h"
@@ -590,7 +591,7 @@ namespace {
 /// Convert from Sema's representation of template deduction information
 /// to the form used in overload-candidate information.
 DeductionFailureInfo
-clang::MakeDeductionFailureInfo(ASTContext &Context,
+clang::MakeDeductionFailureInfo(llvm::BumpPtrAllocator &Allocator,
                                 Sema::TemplateDeductionResult TDK,
                                 TemplateDeductionInfo &Info) {
   DeductionFailureInfo Result;
@@ -613,8 +614,7 @@ clang::MakeDeductionFailureInfo(ASTContext &Context,
 
   case Sema::TDK_DeducedMismatch:
   case Sema::TDK_DeducedMismatchNested: {
-    // FIXME: Should allocate from normal heap so that we can free this later.
-    auto *Saved = new (Context) DFIDeducedMismatchArgs;
+    auto *Saved = new (Allocator) DFIDeducedMismatchArgs;
     Saved->FirstArg = Info.FirstArg;
     Saved->SecondArg = Info.SecondArg;
     Saved->TemplateArgs = Info.take();
@@ -624,8 +624,7 @@ clang::MakeDeductionFailureInfo(ASTContext &Context,
   }
 
   case Sema::TDK_NonDeducedMismatch: {
-    // FIXME: Should allocate from normal heap so that we can free this later.
-    DFIArguments *Saved = new (Context) DFIArguments;
+    DFIArguments *Saved = new (Allocator) DFIArguments;
     Saved->FirstArg = Info.FirstArg;
     Saved->SecondArg = Info.SecondArg;
     Result.Data = Saved;
@@ -636,8 +635,7 @@ clang::MakeDeductionFailureInfo(ASTContext &Context,
     // FIXME: It's slightly wasteful to allocate two TemplateArguments for this.
   case Sema::TDK_Inconsistent:
   case Sema::TDK_Underqualified: {
-    // FIXME: Should allocate from normal heap so that we can free this later.
-    DFIParamWithArguments *Saved = new (Context) DFIParamWithArguments;
+    DFIParamWithArguments *Saved = new (Allocator) DFIParamWithArguments;
     Saved->Param = Info.Param;
     Saved->FirstArg = Info.FirstArg;
     Saved->SecondArg = Info.SecondArg;
@@ -656,7 +654,7 @@ clang::MakeDeductionFailureInfo(ASTContext &Context,
     break;
 
   case Sema::TDK_ConstraintsNotSatisfied: {
-    CNSInfo *Saved = new (Context) CNSInfo;
+    CNSInfo *Saved = new (Allocator) CNSInfo;
     Saved->TemplateArgs = Info.take();
     Saved->Satisfaction = Info.AssociatedConstraintsSatisfaction;
     Result.Data = Saved;
@@ -705,6 +703,8 @@ void DeductionFailureInfo::Destroy() {
 
   case Sema::TDK_ConstraintsNotSatisfied:
     // FIXME: Destroy the template argument list?
+    // The storage itself belongs to the candidate set.
+    static_cast<CNSInfo *>(Data)->~CNSInfo();
     Data = nullptr;
     if (PartialDiagnosticAt *Diag = getSFINAEDiagnostic()) {
       Diag->~PartialDiagnosticAt();
@@ -6201,7 +6201,7 @@ void Sema::AddOverloadCandidate(
 
   if (LangOpts.ConceptsTS) {
     ConstraintSatisfaction Satisfaction;
-    if (CheckFunctionConstraints(Function, Satisfaction) ||
+    if (CheckFunctionConstraints(Function, Satisfaction, /*Probe=*/true) ||
         !Satisfaction.IsSatisfied) {
       Candidate.Viable = false;
       Candidate.FailureKind = ovl_fail_constraints_not_satisfied;
@@ -6720,7 +6720,7 @@ Sema::AddMethodCandidate(CXXMethodDecl *Method, DeclAccessPair FoundDecl,
 
   if (LangOpts.ConceptsTS) {
     ConstraintSatisfaction Satisfaction;
-    if (CheckFunctionConstraints(Method, Satisfaction) ||
+    if (CheckFunctionConstraints(Method, Satisfaction, /*Probe=*/true) ||
         !Satisfaction.IsSatisfied) {
       Candidate.Viable = false;
       Candidate.FailureKind = ovl_fail_constraints_not_satisfied;
@@ -6824,8 +6824,8 @@ Sema::AddMethodTemplateCandidate(FunctionTemplateDecl *MethodTmpl,
       Candidate.FailureKind = ovl_fail_bad_conversion;
     else {
       Candidate.FailureKind = ovl_fail_bad_deduction;
-      Candidate.DeductionFailure = MakeDeductionFailureInfo(Context, Result,
-                                                            Info);
+      Candidate.DeductionFailure = MakeDeductionFailureInfo(
+          CandidateSet.getAllocator(), Result, Info);
     }
     return;
   }
@@ -6844,6 +6844,86 @@ Sema::AddMethodTemplateCandidate(FunctionTemplateDecl *MethodTmpl,
 /// Add a C++ function template specialization as a candidate
 /// in the candidate set, using template argument deduction to produce
 /// an appropriate function template specialization.
+/// Retrieve the parameters of \p FunctionTemplate whose type is a (reference
+/// to a) dependent specialization of a class template. Deduction from such a
+/// parameter fails unless the argument type is, or is derived from, a
+/// specialization of that class template.
+///
+/// Collection stops at the first dependent parameter of any other form, so that
+/// deducing from the preceding parameters cannot have side effects such as
+/// instantiating a class template specialization.
+static const Sema::TemplateIdParamList &
+getTemplateIdParams(Sema &S, FunctionTemplateDecl *FunctionTemplate) {
+  auto Known = S.TemplateIdParamCache.find(FunctionTemplate);
+  if (Known != S.TemplateIdParamCache.end())
+    return Known->second;
+
+  Sema::TemplateIdParamList &Params = S.TemplateIdParamCache[FunctionTemplate];
+  FunctionDecl *Function = FunctionTemplate->getTemplatedDecl();
+  for (unsigned I = 0, N = Function->getNumParams(); I != N; ++I) {
+    ParmVarDecl *Param = Function->getParamDecl(I);
+    if (Param->isParameterPack())
+      break;
+
+    QualType ParamType = S.Context.getCanonicalType(Param->getType());
+    if (!ParamType->isDependentType())
+      continue;
+    ParamType = ParamType.getNonReferenceType().getUnqualifiedType();
+    if (isa<TemplateTypeParmType>(ParamType))
+      continue;
+
+    auto *Spec = dyn_cast<TemplateSpecializationType>(ParamType);
+    auto *Template = Spec ? dyn_cast_or_null<ClassTemplateDecl>(
+                                Spec->getTemplateName().getAsTemplateDecl())
+                          : nullptr;
+    if (!Template)
+      break;
+    Params.push_back({I, Template->getCanonicalDecl()});
+  }
+  return Params;
+}
+
+/// Determine whether template argument deduction for a call to
+/// \p FunctionTemplate with arguments \p Args is known to fail, because some
+/// argument cannot match the template-id its parameter is declared with.
+static bool
+isTemplateCandidateRejectable(Sema &S, FunctionTemplateDecl *FunctionTemplate,
+                              ArrayRef<Expr *> Args) {
+  for (const auto &Param : getTemplateIdParams(S, FunctionTemplate)) {
+    if (Param.first >= Args.size())
+      return false;
+
+    // Initializer lists and overload sets are deduced from differently.
+    Expr *Arg = Args[Param.first];
+    if (isa<InitListExpr>(Arg) || Arg->isTypeDependent() ||
+        Arg->getType()->isPlaceholderType())
+      return false;
+
+    // An argument of non-class type never matches. An argument of class type
+    // matches if it is or derives from a specialization of the class template.
+    // Only look at classes that are already complete, because deduction would
+    // instantiate the definition of an incomplete one.
+    const CXXRecordDecl *Record = Arg->getType()->getAsCXXRecordDecl();
+    if (!Record)
+      return !Arg->getType()->isRecordType();
+    Record = Record->getDefinition();
+    if (!Record || Record->isBeingDefined())
+      return false;
+
+    auto IsSpecialization = [&](const CXXRecordDecl *RD) {
+      auto *Spec = dyn_cast<ClassTemplateSpecializationDecl>(RD);
+      return Spec && Spec->getSpecializedTemplate()->getCanonicalDecl() ==
+                         Param.second;
+    };
+    if (!IsSpecialization(Record) &&
+        Record->forallBases([&](const CXXRecordDecl *Base) {
+          return !IsSpecialization(Base);
+        }))
+      return true;
+  }
+  return false;
+}
+
 void Sema::AddTemplateOverloadCandidate(
     FunctionTemplateDecl *FunctionTemplate, DeclAccessPair FoundDecl,
     TemplateArgumentListInfo *ExplicitTemplateArgs, ArrayRef<Expr *> Args,
@@ -6861,6 +6941,32 @@ void Sema::AddTemplateOverloadCandidate(
   //   functions. In such a case, the candidate functions generated from each
   //   function template are combined with the set of non-template candidate
   //   functions.
+  //
+  // In large overload sets most candidates usually fail deduction because an
+  // argument does not match a template-id parameter. Reject those without
+  // performing deduction; why deduction fails is only determined if the
+  // candidate is diagnosed.
+  if (!ExplicitTemplateArgs && !PartialOverloading &&
+      isTemplateCandidateRejectable(*this, FunctionTemplate, Args)) {
+    ++NumTemplateCandidatesRejectedEarly;
+    OverloadCandidate &Candidate = CandidateSet.addCandidate();
+    Candidate.FoundDecl = FoundDecl;
+    Candidate.Function = FunctionTemplate->getTemplatedDecl();
+    Candidate.Viable = false;
+    Candidate.IsSurrogate = false;
+    Candidate.IsADLCandidate = IsADLCandidate;
+    Candidate.IgnoreObjectArgument =
+        isa<CXXMethodDecl>(Candidate.Function) &&
+        !isa<CXXConstructorDecl>(Candidate.Function);
+    Candidate.ExplicitCallArguments = Args.size();
+    Candidate.FailureKind = ovl_fail_bad_deduction;
+    Candidate.DeductionDeferred = true;
+    Candidate.DeductionFailure.Result = TDK_MiscellaneousDeductionFailure;
+    Candidate.DeductionFailure.HasDiagnostic = false;
+    Candidate.DeductionFailure.Data = nullptr;
+    return;
+  }
+
   TemplateDeductionInfo Info(CandidateSet.getLocation());
   FunctionDecl *Specialization = nullptr;
   ConversionSequenceList Conversions;
@@ -6888,8 +6994,8 @@ void Sema::AddTemplateOverloadCandidate(
       Candidate.FailureKind = ovl_fail_bad_conversion;
     else {
       Candidate.FailureKind = ovl_fail_bad_deduction;
-      Candidate.DeductionFailure = MakeDeductionFailureInfo(Context, Result,
-                                                            Info);
+      Candidate.DeductionFailure = MakeDeductionFailureInfo(
+          CandidateSet.getAllocator(), Result, Info);
     }
     return;
   }
@@ -7079,7 +7185,7 @@ void Sema::AddConversionCandidate(
 
   if (LangOpts.ConceptsTS) {
     ConstraintSatisfaction Satisfaction;
-    if (CheckFunctionConstraints(Conversion, Satisfaction) ||
+    if (CheckFunctionConstraints(Conversion, Satisfaction, /*Probe=*/true) ||
         !Satisfaction.IsSatisfied) {
       Candidate.Viable = false;
       Candidate.FailureKind = ovl_fail_constraints_not_satisfied;
@@ -7228,8 +7334,8 @@ void Sema::AddTemplateConversionCandidate(
     Candidate.IsSurrogate = false;
     Candidate.IgnoreObjectArgument = false;
     Candidate.ExplicitCallArguments = 1;
-    Candidate.DeductionFailure = MakeDeductionFailureInfo(Context, Result,
-                                                          Info);
+    Candidate.DeductionFailure =
+        MakeDeductionFailureInfo(CandidateSet.getAllocator(), Result, Info);
     return;
   }
 
@@ -11026,6 +11132,33 @@ static void CompleteNonViableCandidate(Sema &S, OverloadCandidate *Cand,
   }
 }
 
+/// Determine why template argument deduction fails for a function template
+/// candidate that was rejected before deduction was performed.
+static void CompleteDeferredDeduction(Sema &S,
+                                      OverloadCandidateSet &CandidateSet,
+                                      OverloadCandidate *Cand,
+                                      ArrayRef<Expr *> Args) {
+  assert(Cand->DeductionDeferred && "deduction was already performed");
+  Cand->DeductionDeferred = false;
+
+  FunctionTemplateDecl *FunctionTemplate =
+      Cand->Function->getDescribedFunctionTemplate();
+  TemplateDeductionInfo Info(CandidateSet.getLocation());
+  FunctionDecl *Specialization = nullptr;
+  // Deduction is known to fail before the non-dependent parameters are
+  // checked; never go on to substitute into the function type.
+  Sema::TemplateDeductionResult Result = S.DeduceTemplateArguments(
+      FunctionTemplate, /*ExplicitTemplateArgs=*/nullptr, Args, Specialization,
+      Info, /*PartialOverloading=*/false,
+      [](ArrayRef<QualType>) { return true; });
+  assert(Result != Sema::TDK_NonDependentConversionFailure &&
+         "candidate should not have been rejected before deduction");
+  if (Result == Sema::TDK_NonDependentConversionFailure)
+    Result = Sema::TDK_MiscellaneousDeductionFailure;
+  Cand->DeductionFailure =
+      MakeDeductionFailureInfo(CandidateSet.getAllocator(), Result, Info);
+}
+
 SmallVector<OverloadCandidate *, 32> OverloadCandidateSet::CompleteCandidates(
     Sema &S, OverloadCandidateDisplayKind OCD, ArrayRef<Expr *> Args,
     SourceLocation OpLoc,
@@ -11040,6 +11173,8 @@ SmallVector<OverloadCandidate *, 32> OverloadCandidateSet::CompleteCandidates(
     if (Cand->Viable)
       Cands.push_back(Cand);
     else if (OCD == OCD_AllCandidates) {
+      if (Cand->DeductionDeferred)
+        CompleteDeferredDeduction(S, *this, Cand, Args);
       CompleteNonViableCandidate(S, Cand, Args);
       if (Cand->Function || Cand->IsSurrogate)
         Cands.push_back(Cand);
@@ -11183,6 +11318,7 @@ void TemplateSpecCandidateSet::destroyCandidates() {
 
 void TemplateSpecCandidateSet::clear() {
   destroyCandidates();
+  Allocator.Reset();
   Candidates.clear();
 }
 
@@ -11451,7 +11587,8 @@ private:
       // Make a note of the failed deduction for diagnostics.
       FailedCandidates.addCandidate()
           .set(CurAccessFunPair, FunctionTemplate->getTemplatedDecl(),
-               MakeDeductionFailureInfo(Context, Result, Info));
+               MakeDeductionFailureInfo(FailedCandidates.getAllocator(),
+                                        Result, Info));
       return false;
     }
 
@@ -11880,7 +12017,8 @@ Sema::ResolveSingleFunctionTemplateSpecialization(OverloadExpr *ovl,
       // TODO: Actually use the failed-deduction info?
       FailedCandidates.addCandidate()
           .set(I.getPair(), FunctionTemplate->getTemplatedDecl(),
-               MakeDeductionFailureInfo(Context, Result, Info));
+               MakeDeductionFailureInfo(FailedCandidates.getAllocator(),
+                                        Result, Info));
       continue;
     }
 
@@ -12503,6 +12641,8 @@ ExprResult Sema::BuildOverloadedCallExpr(Scope *S, Expr *Fn,
                                          Expr *ExecConfig,
                                          bool AllowTypoCorrection,
                                          bool CalleesAddressIsTaken) {
+  SemaCostRemarks::OverloadResolutionScope CostScope(*this, Fn->getExprLoc(),
+                                                     ULE->getName());
   OverloadCandidateSet CandidateSet(Fn->getExprLoc(),
                                     OverloadCandidateSet::CSK_Normal);
   ExprResult result;
@@ -12554,6 +12694,7 @@ Sema::CreateOverloadedUnaryOp(SourceLocation OpLoc, UnaryOperatorKind Opc,
   DeclarationName OpName = Context.DeclarationNames.getCXXOperatorName(Op);
   // TODO: provide better source location info.
   DeclarationNameInfo OpNameInfo(OpName, OpLoc);
+  SemaCostRemarks::OverloadResolutionScope CostScope(*this, OpLoc, OpName);
 
   if (checkPlaceholderForOverload(*this, Input))
     return ExprError();
@@ -12746,6 +12887,7 @@ Sema::CreateOverloadedBinOp(SourceLocation OpLoc,
 
   OverloadedOperatorKind Op = BinaryOperator::getOverloadedOperator(Opc);
   DeclarationName OpName = Context.DeclarationNames.getCXXOperatorName(Op);
+  SemaCostRemarks::OverloadResolutionScope CostScope(*this, OpLoc, OpName);
 
   // If either side is type-dependent, create an appropriate dependent
   // expression.
@@ -4302,7 +4302,8 @@ Sema::CheckVarTemplateId(VarTemplateDecl *Template, SourceLocation TemplateLoc,
         // TODO: Actually use the failed-deduction info?
         FailedCandidates.addCandidate().set(
             DeclAccessPair::make(Template, AS_public), Partial,
-            MakeDeductionFailureInfo(Context, Result, Info));
+            MakeDeductionFailureInfo(FailedCandidates.getAllocator(), Result,
+                                     Info));
         (void)Result;
       } else {
         Matched.push_back(PartialSpecMatchResult());
@@ -8762,7 +8763,8 @@ bool Sema::CheckFunctionTemplateSpecialization(
         // that we can provide nifty diagnostics.
         FailedCandidates.addCandidate().set(
             I.getPair(), FunTmpl->getTemplatedDecl(),
-            MakeDeductionFailureInfo(Context, TDK, Info));
+            MakeDeductionFailureInfo(FailedCandidates.getAllocator(), TDK,
+                                     Info));
         (void)TDK;
         continue;
       }
@@ -8778,7 +8780,8 @@ bool Sema::CheckFunctionTemplateSpecialization(
               IdentifyCUDATarget(FD, /* IgnoreImplicitHDAttr = */ true)) {
         FailedCandidates.addCandidate().set(
             I.getPair(), FunTmpl->getTemplatedDecl(),
-            MakeDeductionFailureInfo(Context, TDK_CUDATargetMismatch, Info));
+            MakeDeductionFailureInfo(FailedCandidates.getAllocator(),
+                                     TDK_CUDATargetMismatch, Info));
         continue;
       }
 
@@ -9930,7 +9933,8 @@ DeclResult Sema::ActOnExplicitInstantiation(Scope *S,
       // Keep track of almost-matches.
       FailedCandidates.addCandidate()
           .set(P.getPair(), FunTmpl->getTemplatedDecl(),
-               MakeDeductionFailureInfo(Context, TDK, Info));
+               MakeDeductionFailureInfo(FailedCandidates.getAllocator(), TDK,
+                                        Info));
       (void)TDK;
       continue;
     }
@@ -9946,7 +9950,8 @@ DeclResult Sema::ActOnExplicitInstantiation(Scope *S,
             IdentifyCUDATarget(D.getDeclSpec().getAttributes())) {
       FailedCandidates.addCandidate().set(
           P.getPair(), FunTmpl->getTemplatedDecl(),
-          MakeDeductionFailureInfo(Context, TDK_CUDATargetMismatch, Info));
+          MakeDeductionFailureInfo(FailedCandidates.getAllocator(),
+                                   TDK_CUDATargetMismatch, Info));
       continue;
     }
 
@@ -2647,7 +2647,7 @@ static Sema::TemplateDeductionResult ConvertDeducedTemplateArguments(
                                          IsDeduced, Builder)) {
         Info.Param = makeTemplateParameter(Param);
         // FIXME: These template arguments are temporary. Free them!
-        Info.reset(TemplateArgumentList::CreateCopy(S.Context, Builder));
+        Info.reset(S.Context.getUniquedTemplateArgumentList(Builder));
         return Sema::TDK_SubstitutionFailure;
       }
 
@@ -2671,7 +2671,7 @@ static Sema::TemplateDeductionResult ConvertDeducedTemplateArguments(
     if (DefArg.getArgument().isNull()) {
       Info.Param = makeTemplateParameter(
           const_cast<NamedDecl *>(TemplateParams->getParam(I)));
-      Info.reset(TemplateArgumentList::CreateCopy(S.Context, Builder));
+      Info.reset(S.Context.getUniquedTemplateArgumentList(Builder));
       if (PartialOverloading) break;
 
       return HasDefaultArg ? Sema::TDK_SubstitutionFailure
@@ -2685,7 +2685,7 @@ static Sema::TemplateDeductionResult ConvertDeducedTemplateArguments(
       Info.Param = makeTemplateParameter(
                          const_cast<NamedDecl *>(TemplateParams->getParam(I)));
       // FIXME: These template arguments are temporary. Free them!
-      Info.reset(TemplateArgumentList::CreateCopy(S.Context, Builder));
+      Info.reset(S.Context.getUniquedTemplateArgumentList(Builder));
       return Sema::TDK_SubstitutionFailure;
     }
 
@@ -2731,7 +2731,7 @@ CheckDeducedArgumentConstraints(Sema& S, TemplateDeclT *Template,
                                     MLTAL, Info.getLocation(),
                                     Info.AssociatedConstraintsSatisfaction)
       || !Info.AssociatedConstraintsSatisfaction.IsSatisfied) {
-    Info.reset(TemplateArgumentList::CreateCopy(S.Context, DeducedArgs));
+    Info.reset(S.Context.getUniquedTemplateArgumentList(DeducedArgs));
     return Sema::TDK_ConstraintsNotSatisfied;
   }
   return Sema::TDK_Success;
@@ -2763,7 +2763,7 @@ FinishTemplateArgumentDeduction(
 
   // Form the template argument list from the deduced template arguments.
   TemplateArgumentList *DeducedArgumentList
-    = TemplateArgumentList::CreateCopy(S.Context, Builder);
+    = S.Context.getUniquedTemplateArgumentList(Builder);
 
   Info.reset(DeducedArgumentList);
 
@@ -3052,7 +3052,7 @@ Sema::SubstituteExplicitTemplateArguments(
   // Form the template argument list from the explicitly-specified
   // template arguments.
   TemplateArgumentList *ExplicitArgumentList
-    = TemplateArgumentList::CreateCopy(Context, Builder);
+    = Context.getUniquedTemplateArgumentList(Builder);
   Info.setExplicitArgs(ExplicitArgumentList);
 
   // Template argument deduction and the final substitution should be
@@ -3381,7 +3381,7 @@ Sema::TemplateDeductionResult Sema::FinishTemplateArgumentDeduction(
 
   // Form the template argument list from the deduced template arguments.
   TemplateArgumentList *DeducedArgumentList
-    = TemplateArgumentList::CreateCopy(Context, Builder);
+    = Context.getUniquedTemplateArgumentList(Builder);
   Info.reset(DeducedArgumentList);
 
   // Substitute the deduced template arguments into the function template
@@ -3425,7 +3425,7 @@ Sema::TemplateDeductionResult Sema::FinishTemplateArgumentDeduction(
     return TDK_MiscellaneousDeductionFailure;
 
   if (!Info.AssociatedConstraintsSatisfaction.IsSatisfied) {
-    Info.reset(TemplateArgumentList::CreateCopy(Context, Builder));
+    Info.reset(Context.getUniquedTemplateArgumentList(Builder));
     return TDK_ConstraintsNotSatisfied;
   }
 
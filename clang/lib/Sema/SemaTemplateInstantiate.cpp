@@ -18,6 +18,7 @@
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/PrettyDeclStackTrace.h"
+#include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Basic/LangOptions.h"
 #include "clang/Sema/DeclSpec.h"
 #include "clang/Sema/Initialization.h"
@@ -1074,6 +1075,9 @@ namespace {
     }
 
     ExprResult TransformRequiresExpr(RequiresExpr *E) {
+      llvm::TimeTraceScope TimeScope("InstantiateRequiresExpr", [&]() {
+        return E->getRequiresKWLoc().printToString(SemaRef.getSourceManager());
+      });
       LocalInstantiationScope Scope(SemaRef, /*CombineWithOuterScope=*/true);
       return TreeTransform<TemplateInstantiator>::TransformRequiresExpr(E);
     }
@@ -1084,12 +1088,7 @@ namespace {
       for (Requirement *Req : Reqs) {
         Requirement *TransReq = nullptr;
         if (!SatisfcationDetermined) {
-          if (auto *TypeReq = dyn_cast<TypeRequirement>(Req))
-            TransReq = TransformTypeRequirement(TypeReq);
-          else if (auto *ExprReq = dyn_cast<ExprRequirement>(Req))
-            TransReq = TransformExprRequirement(ExprReq);
-          else
-            TransReq = TransformNestedRequirement(cast<NestedRequirement>(Req));
+          TransReq = TransformRequirement(Req);
           if (!TransReq)
             return true;
           if (!TransReq->isDependent() && !TransReq->isSatisfied())
@@ -1116,6 +1115,7 @@ namespace {
       return DeclInstantiator.SubstTemplateParams(OrigTPL);
     }
 
+    Requirement *TransformRequirement(Requirement *Req);
     TypeRequirement *TransformTypeRequirement(TypeRequirement *Req);
     ExprRequirement *TransformExprRequirement(ExprRequirement *Req);
     NestedRequirement *TransformNestedRequirement(NestedRequirement *Req);
@@ -1721,6 +1721,166 @@ TemplateInstantiator::TransformSubstTemplateTypeParmPackType(
   return Result;
 }
 
+namespace {
+/// Collects the template parameters a requirement refers to, and whether it
+/// refers to an entity whose substitution depends on more than those
+/// parameters (a parameter of the requires-expression or of an enclosing
+/// function, or a member of an enclosing template), in which case the result
+/// of substituting into it cannot be reused in another context.
+class RequirementReferenceCollector
+    : public RecursiveASTVisitor<RequirementReferenceCollector> {
+public:
+  SmallVector<std::pair<unsigned, unsigned>, 4> Params;
+  bool Uncacheable = false;
+
+  bool VisitTemplateTypeParmType(TemplateTypeParmType *T) {
+    Params.push_back({T->getDepth(), T->getIndex()});
+    return true;
+  }
+
+  bool VisitSubstTemplateTypeParmPackType(SubstTemplateTypeParmPackType *T) {
+    return VisitTemplateTypeParmType(
+        const_cast<TemplateTypeParmType *>(T->getReplacedParameter()));
+  }
+
+  bool VisitTagType(TagType *T) { return checkDecl(T->getDecl()); }
+  bool VisitTypedefType(TypedefType *T) { return checkDecl(T->getDecl()); }
+  bool VisitInjectedClassNameType(InjectedClassNameType *) {
+    return markUncacheable();
+  }
+
+  bool TraverseTemplateName(TemplateName Name) {
+    if (TemplateDecl *TD = Name.getAsTemplateDecl())
+      if (!checkDecl(TD))
+        return false;
+    return RecursiveASTVisitor::TraverseTemplateName(Name);
+  }
+
+  bool VisitDeclRefExpr(DeclRefExpr *E) { return checkDecl(E->getDecl()); }
+  bool VisitMemberExpr(MemberExpr *E) {
+    return checkDecl(E->getMemberDecl());
+  }
+  bool VisitUnresolvedLookupExpr(UnresolvedLookupExpr *E) {
+    for (NamedDecl *D : E->decls())
+      if (!checkDecl(D))
+        return false;
+    return true;
+  }
+  bool VisitSizeOfPackExpr(SizeOfPackExpr *E) { return checkDecl(E->getPack()); }
+  bool VisitSubstNonTypeTemplateParmPackExpr(
+      SubstNonTypeTemplateParmPackExpr *E) {
+    return checkDecl(E->getParameterPack());
+  }
+
+  bool VisitCXXThisExpr(CXXThisExpr *) { return markUncacheable(); }
+  bool VisitLambdaExpr(LambdaExpr *) { return markUncacheable(); }
+  bool VisitFunctionParmPackExpr(FunctionParmPackExpr *) {
+    return markUncacheable();
+  }
+  bool VisitCXXDependentScopeMemberExpr(CXXDependentScopeMemberExpr *E) {
+    return !E->isImplicitAccess() || markUncacheable();
+  }
+  bool VisitUnresolvedMemberExpr(UnresolvedMemberExpr *E) {
+    return !E->isImplicitAccess() || markUncacheable();
+  }
+
+private:
+  /// Always returns false, to stop the traversal.
+  bool markUncacheable() {
+    Uncacheable = true;
+    return false;
+  }
+
+  bool checkDecl(const NamedDecl *D) {
+    if (const auto *TTP = dyn_cast<TemplateTypeParmDecl>(D))
+      Params.push_back({TTP->getDepth(), TTP->getIndex()});
+    else if (const auto *NTTP = dyn_cast<NonTypeTemplateParmDecl>(D))
+      Params.push_back({NTTP->getDepth(), NTTP->getIndex()});
+    else if (const auto *TTP = dyn_cast<TemplateTemplateParmDecl>(D))
+      Params.push_back({TTP->getDepth(), TTP->getIndex()});
+    else {
+      const DeclContext *DC = D->getDeclContext();
+      if (DC->isFunctionOrMethod() || isa<RequiresExprBodyDecl>(DC) ||
+          DC->isDependentContext())
+        return markUncacheable();
+    }
+    return true;
+  }
+};
+} // end anonymous namespace
+
+Requirement *TemplateInstantiator::TransformRequirement(Requirement *Req) {
+  auto Transform = [&]() -> Requirement * {
+    if (auto *TypeReq = dyn_cast<TypeRequirement>(Req))
+      return TransformTypeRequirement(TypeReq);
+    if (auto *ExprReq = dyn_cast<ExprRequirement>(Req))
+      return TransformExprRequirement(ExprReq);
+    return TransformNestedRequirement(cast<NestedRequirement>(Req));
+  };
+  if (!Req->isDependent())
+    return Transform();
+
+  // Find the template parameters the requirement refers to. Substituting the
+  // same arguments for them always produces the same result, regardless of
+  // the other template arguments, unless the requirement refers to a local
+  // entity.
+  RequirementReferenceCollector Collector;
+  if (auto *TypeReq = dyn_cast<TypeRequirement>(Req)) {
+    if (!TypeReq->isSubstitutionFailure())
+      Collector.TraverseTypeLoc(TypeReq->getType()->getTypeLoc());
+  } else if (auto *ExprReq = dyn_cast<ExprRequirement>(Req)) {
+    if (!ExprReq->isExprSubstitutionFailure())
+      Collector.TraverseStmt(ExprReq->getExpr());
+    const auto &RetReq = ExprReq->getReturnTypeRequirement();
+    if (RetReq.isTrailingReturnType())
+      Collector.TraverseTypeLoc(
+          RetReq.getTrailingReturnTypeExpectedType()->getTypeLoc());
+    else if (RetReq.isTypeConstraint())
+      Collector.TraverseStmt(
+          RetReq.getTypeConstraint()->getImmediatelyDeclaredConstraint());
+  } else {
+    Collector.TraverseStmt(
+        cast<NestedRequirement>(Req)->getConstraintExpr());
+  }
+  if (Collector.Uncacheable)
+    return Transform();
+
+  llvm::FoldingSetNodeID ID;
+  ID.AddPointer(Req);
+  ID.AddInteger(TemplateArgs.getNumLevels());
+  ID.AddInteger(TemplateArgs.getNumSubstitutedLevels());
+  ID.AddInteger(SemaRef.ArgumentPackSubstitutionIndex);
+  llvm::sort(Collector.Params);
+  Collector.Params.erase(
+      std::unique(Collector.Params.begin(), Collector.Params.end()),
+      Collector.Params.end());
+  for (const auto &Param : Collector.Params) {
+    if (Param.first >= TemplateArgs.getNumLevels() ||
+        !TemplateArgs.hasTemplateArgument(Param.first, Param.second))
+      continue;
+    ID.AddInteger(Param.first);
+    ID.AddInteger(Param.second);
+    TemplateArgs(Param.first, Param.second).Profile(ID, SemaRef.Context);
+  }
+
+  void *InsertPos;
+  if (Sema::SubstitutedRequirement *Cached =
+          SemaRef.RequirementSubstitutionCache.FindNodeOrInsertPos(ID,
+                                                                   InsertPos)) {
+    ++SemaRef.NumRequirementSubstitutionCacheHits;
+    return Cached->getRequirement();
+  }
+
+  Requirement *TransReq = Transform();
+  // Dependent results still need the remaining levels of arguments. The
+  // transformation may have added entries, so look up the position again.
+  if (TransReq && !TransReq->isDependent() &&
+      !SemaRef.RequirementSubstitutionCache.FindNodeOrInsertPos(ID, InsertPos))
+    SemaRef.RequirementSubstitutionCache.InsertNode(
+        new Sema::SubstitutedRequirement(ID, TransReq), InsertPos);
+  return TransReq;
+}
+
 template<typename EntityPrinter>
 static Requirement::SubstitutionDiagnostic *
 createSubstDiag(Sema &S, TemplateDeductionInfo &Info, EntityPrinter Printer) {
@@ -2797,7 +2957,8 @@ getPatternForClassTemplateSpecialization(
         // TODO: Actually use the failed-deduction info?
         FailedCandidates.addCandidate().set(
             DeclAccessPair::make(Template, AS_public), Partial,
-            MakeDeductionFailureInfo(S.Context, Result, Info));
+            MakeDeductionFailureInfo(FailedCandidates.getAllocator(), Result,
+                                     Info));
         (void)Result;
       } else {
         Matched.push_back(PartialSpecMatchResult());
@@ -1807,8 +1807,12 @@ Decl *TemplateDeclInstantiator::VisitFunctionDecl(FunctionDecl *D,
       Params[P]->setOwningFunction(Function);
   Function->setParams(Params);
 
-  if (Expr *TrailingRequiresClause = D->getTrailingRequiresClause())
+  // The requires-clause is substituted only when the constraints are checked,
+  // see CheckFunctionConstraints.
+  if (Expr *TrailingRequiresClause = D->getTrailingRequiresClause()) {
     Function->setTrailingRequiresClause(TrailingRequiresClause);
+    ++SemaRef.NumDeferredTrailingRequiresClauses;
+  }
 
   if (TemplateParams) {
     // Our resulting instantiation is actually a function template, since we
@@ -1840,10 +1844,10 @@ Decl *TemplateDeclInstantiator::VisitFunctionDecl(FunctionDecl *D,
   } else if (FunctionTemplate) {
     // Record this function template specialization.
     ArrayRef<TemplateArgument> Innermost = TemplateArgs.getInnermost();
-    Function->setFunctionTemplateSpecialization(FunctionTemplate,
-                            TemplateArgumentList::CreateCopy(SemaRef.Context,
-                                                             Innermost),
-                                                /*InsertPos=*/nullptr);
+    Function->setFunctionTemplateSpecialization(
+        FunctionTemplate,
+        SemaRef.Context.getUniquedTemplateArgumentList(Innermost),
+        /*InsertPos=*/nullptr);
   } else if (isFriend && D->isThisDeclarationADefinition()) {
     // Do not connect the friend to the template unless it's actually a
     // definition. We don't want non-template functions to be marked as being
@@ -2063,7 +2067,11 @@ Decl *TemplateDeclInstantiator::VisitCXXMethodDecl(
       return nullptr;
   }
 
+  // The requires-clause is substituted only when the constraints are checked,
+  // see CheckFunctionConstraints.
   Expr *TrailingRequiresClause = D->getTrailingRequiresClause();
+  if (TrailingRequiresClause)
+    ++SemaRef.NumDeferredTrailingRequiresClauses;
 
   DeclContext *DC = Owner;
   if (isFriend) {
@@ -2149,10 +2157,10 @@ Decl *TemplateDeclInstantiator::VisitCXXMethodDecl(
   } else if (FunctionTemplate) {
     // Record this function template specialization.
     ArrayRef<TemplateArgument> Innermost = TemplateArgs.getInnermost();
-    Method->setFunctionTemplateSpecialization(FunctionTemplate,
-                         TemplateArgumentList::CreateCopy(SemaRef.Context,
-                                                          Innermost),
-                                              /*InsertPos=*/nullptr);
+    Method->setFunctionTemplateSpecialization(
+        FunctionTemplate,
+        SemaRef.Context.getUniquedTemplateArgumentList(Innermost),
+        /*InsertPos=*/nullptr);
   } else if (!isFriend) {
     // Record that this is an instantiation of a member function.
     Method->setInstantiationOfMemberFunction(D, TSK_ImplicitInstantiation);
@@ -4013,7 +4021,7 @@ void Sema::InstantiateExceptionSpec(SourceLocation PointOfInstantiation,
 }
 
 bool Sema::CheckFunctionConstraints(FunctionDecl *Decl,
-    ConstraintSatisfaction &Satisfaction) {
+    ConstraintSatisfaction &Satisfaction, bool Probe) {
   NamedDecl *Template = Decl->getPrimaryTemplate();
   llvm::SmallVector<const Expr *, 3> AssociatedConstraints;
   if (Template) {
@@ -4057,8 +4065,10 @@ bool Sema::CheckFunctionConstraints(FunctionDecl *Decl,
   if (!Template) {
     // This is a non-template function which is also not a method of a template
     // class.
-    if (Expr *RC = Decl->getTrailingRequiresClause())
+    if (Expr *RC = Decl->getTrailingRequiresClause()) {
+      Satisfaction.IsProbe = Probe;
       return CheckConstraintSatisfaction(RC, Satisfaction);
+    }
 
     Satisfaction.IsSatisfied = true;
     return false;
@@ -4066,6 +4076,8 @@ bool Sema::CheckFunctionConstraints(FunctionDecl *Decl,
 
   // This is either an instantiated function template or a non-template method
   // of a class template.
+  if (!Decl->getPrimaryTemplate())
+    ++NumMemberConstraintChecks;
 
   // Enter the scope of this instantiation. We don't use
   // PushDeclContext because we don't have a scope.
@@ -4097,15 +4109,15 @@ bool Sema::CheckFunctionConstraints(FunctionDecl *Decl,
   if (auto *TD = dyn_cast<TemplateDecl>(Template))
     return CheckConstraintSatisfaction(Decl, TD, AssociatedConstraints, MLTAL,
                                        Decl->getPointOfInstantiation(),
-                                       Satisfaction);
+                                       Satisfaction, Probe);
   if (auto *Var = dyn_cast<VarTemplatePartialSpecializationDecl>(Template))
     return CheckConstraintSatisfaction(Decl, Var, AssociatedConstraints, MLTAL,
                                        Decl->getPointOfInstantiation(),
-                                       Satisfaction);
+                                       Satisfaction, Probe);
   return CheckConstraintSatisfaction(Decl,
       cast<ClassTemplatePartialSpecializationDecl>(Template),
       AssociatedConstraints, MLTAL, Decl->getPointOfInstantiation(),
-      Satisfaction);
+      Satisfaction, Probe);
 }
 
 /// Initializes the common fields of an instantiation function
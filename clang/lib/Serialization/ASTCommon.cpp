@@ -13,6 +13,7 @@
 #include "ASTCommon.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
+#include "clang/AST/DeclTemplate.h"
 #include "clang/Basic/IdentifierTable.h"
 #include "clang/Serialization/ASTDeserializationListener.h"
 #include "llvm/Support/DJB.h"
@@ -446,3 +447,16 @@ bool serialization::needsAnonymousDeclarationNumber(const NamedDecl *D) {
     return false;
   return isa<TagDecl>(D) || isa<FieldDecl>(D);
 }
+
+unsigned serialization::getSpecializationODRHash(const Decl *D) {
+  if (auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(D))
+    return TemplateArgumentList::ComputeODRHash(
+        CTSD->getTemplateArgs().asArray());
+  if (auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(D))
+    return TemplateArgumentList::ComputeODRHash(
+        VTSD->getTemplateArgs().asArray());
+  if (auto *FD = dyn_cast<FunctionDecl>(D))
+    if (const TemplateArgumentList *Args = FD->getTemplateSpecializationArgs())
+      return TemplateArgumentList::ComputeODRHash(Args->asArray());
+  return ~0U;
+}
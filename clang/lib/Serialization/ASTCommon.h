@@ -91,6 +91,11 @@ bool isRedeclarableDeclKind(unsigned Kind);
 /// declaration number.
 bool needsAnonymousDeclarationNumber(const NamedDecl *D);
 
+/// Compute the ODR hash of the template arguments of the given class,
+/// variable or function template specialization, which importers use to
+/// load only the specializations a lookup might find.
+unsigned getSpecializationODRHash(const Decl *D);
+
 /// Visit each declaration within \c DC that needs an anonymous
 /// declaration number and call \p Visit with the declaration and its number.
 template<typename Fn> void numberAnonymousDeclsWithin(const DeclContext *DC,
@@ -1926,6 +1926,10 @@ void ASTReader::ReadDefinedMacros() {
   // Note that we are loading defined macros.
   Deserializing Macros(this);
 
+  // The preprocessor is about to walk every macro, so there is nothing to be
+  // gained by deferring macro histories from here on.
+  ResolveAllMacroHistories = true;
+
   for (ModuleFile &I : llvm::reverse(ModuleMgr)) {
     BitstreamCursor &MacroCursor = I.MacroCursor;
 
@@ -1985,6 +1989,9 @@ void ASTReader::ReadDefinedMacros() {
     }
     NextCursor:  ;
   }
+
+  while (!LazyMacroHistories.empty())
+    resolveLazyMacroHistory(*LazyMacroHistories.begin()->first);
 }
 
 namespace {
@@ -2041,6 +2048,11 @@ namespace {
 } // namespace
 
 void ASTReader::updateOutOfDateIdentifier(IdentifierInfo &II) {
+  // If the identifier was only marked out of date because its macro history
+  // was deferred, resolving that history brings it up to date.
+  if (resolveLazyMacroHistory(II))
+    return;
+
   // Note that we are loading an identifier.
   Deserializing AnIdentifier(this);
 
@@ -2076,6 +2088,25 @@ void ASTReader::markIdentifierUpToDate(IdentifierInfo *II) {
     IdentifierGeneration[II] = getGeneration();
 }
 
+bool ASTReader::resolveLazyMacroHistory(IdentifierInfo &II) {
+  auto Pos = LazyMacroHistories.find(&II);
+  if (Pos == LazyMacroHistories.end())
+    return false;
+
+  // Note that we are loading a macro history.
+  Deserializing AMacroHistory(this);
+
+  SmallVector<PendingMacroInfo, 2> GlobalIDs;
+  GlobalIDs.swap(Pos->second);
+  LazyMacroHistories.erase(Pos);
+  markIdentifierUpToDate(&II);
+
+  for (const PendingMacroInfo &Info : GlobalIDs)
+    resolvePendingMacro(&II, Info);
+  ++NumLazyMacroHistoriesResolved;
+  return true;
+}
+
 void ASTReader::resolvePendingMacro(IdentifierInfo *II,
                                     const PendingMacroInfo &PMInfo) {
   ModuleFile &M = *PMInfo.M;
@@ -2548,9 +2579,13 @@ ASTReader::ReadControlBlock(ModuleFile &F,
 
       // All user input files reside at the index range [0, NumUserInputs), and
       // system input files reside at [NumUserInputs, NumInputs). For explicitly
-      // loaded module files, ignore missing inputs.
+      // loaded module files, ignore missing inputs. Implicit modules from a
+      // content-addressed cache are named after their inputs' contents, so
+      // there is nothing to verify.
       if (!DisableValidation && F.Kind != MK_ExplicitModule &&
-          F.Kind != MK_PrebuiltModule) {
+          F.Kind != MK_PrebuiltModule &&
+          !(F.Kind == MK_ImplicitModule &&
+            HSOpts.ModulesContentAddressedCache)) {
         bool Complain = (ClientLoadCapabilities & ARR_OutOfDate) == 0;
 
         // If we are reading a module, we will create a verification timestamp,
@@ -3584,6 +3619,10 @@ ASTReader::ReadASTBlock(ModuleFile &F, unsigned ClientLoadCapabilities) {
       }
       break;
 
+    case SATISFIED_CONSTRAINTS:
+      SatisfiedConstraints.push_back(std::make_pair(&F, Record));
+      break;
+
     case DELETE_EXPRS_TO_ANALYZE:
       for (unsigned I = 0, N = Record.size(); I != N;) {
         DelayedDeleteExprs.push_back(getGlobalDeclID(F, Record[I++]));
@@ -4921,7 +4960,8 @@ std::string ASTReader::getOriginalSourceFile(
     const std::string &ASTFileName, FileManager &FileMgr,
     const PCHContainerReader &PCHContainerRdr, DiagnosticsEngine &Diags) {
   // Open the AST file.
-  auto Buffer = FileMgr.getBufferForFile(ASTFileName);
+  auto Buffer = FileMgr.getBufferForFile(ASTFileName, /*isVolatile=*/false,
+                                         /*RequiresNullTerminator=*/false);
   if (!Buffer) {
     Diags.Report(diag::err_fe_unable_to_read_pch_file)
         << ASTFileName << Buffer.getError().message();
@@ -5035,7 +5075,8 @@ bool ASTReader::readASTFileControlBlock(
   // Open the AST file.
   // FIXME: This allows use of the VFS; we do not allow use of the
   // VFS when actually loading a module.
-  auto Buffer = FileMgr.getBufferForFile(Filename);
+  auto Buffer = FileMgr.getBufferForFile(Filename, /*isVolatile=*/false,
+                                         /*RequiresNullTerminator=*/false);
   if (!Buffer) {
     return true;
   }
@@ -7587,13 +7628,29 @@ void ASTReader::CompleteRedeclChain(const Decl *D) {
     }
   }
 
-  if (auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(D))
-    CTSD->getSpecializedTemplate()->LoadLazySpecializations();
-  if (auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(D))
-    VTSD->getSpecializedTemplate()->LoadLazySpecializations();
+  // Only the specializations with matching template arguments can be
+  // redeclarations of D.
+  if (auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(D)) {
+    if (isa<ClassTemplatePartialSpecializationDecl>(CTSD))
+      CTSD->getSpecializedTemplate()->LoadLazySpecializations();
+    else
+      CTSD->getSpecializedTemplate()->loadLazySpecializationsImpl(
+          CTSD->getTemplateArgs().asArray());
+  }
+  if (auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(D)) {
+    if (isa<VarTemplatePartialSpecializationDecl>(VTSD))
+      VTSD->getSpecializedTemplate()->LoadLazySpecializations();
+    else
+      VTSD->getSpecializedTemplate()->loadLazySpecializationsImpl(
+          VTSD->getTemplateArgs().asArray());
+  }
   if (auto *FD = dyn_cast<FunctionDecl>(D)) {
-    if (auto *Template = FD->getPrimaryTemplate())
-      Template->LoadLazySpecializations();
+    if (auto *Template = FD->getPrimaryTemplate()) {
+      if (const TemplateArgumentList *Args = FD->getTemplateSpecializationArgs())
+        Template->loadLazySpecializationsImpl(Args->asArray());
+      else
+        Template->LoadLazySpecializations();
+    }
   }
 }
 
@@ -8133,6 +8190,11 @@ void ASTReader::PrintStats() {
     std::fprintf(stderr, "  %u/%u macros read (%f%%)\n",
                  NumMacrosRead, TotalNumMacros,
                  ((float)NumMacrosRead/TotalNumMacros * 100));
+  if (NumLazyMacroHistories)
+    std::fprintf(stderr, "  %u/%u deferred macro histories resolved (%f%%)\n",
+                 NumLazyMacroHistoriesResolved, NumLazyMacroHistories,
+                 ((float)NumLazyMacroHistoriesResolved/NumLazyMacroHistories
+                  * 100));
   if (TotalLexicalDeclContexts)
     std::fprintf(stderr, "  %u/%u lexical declcontexts read (%f%%)\n",
                  NumLexicalDeclContextsRead, TotalLexicalDeclContexts,
@@ -8656,6 +8718,22 @@ void ASTReader::ReadExtVectorDecls(SmallVectorImpl<TypedefNameDecl *> &Decls) {
   ExtVectorDecls.clear();
 }
 
+void ASTReader::ReadSatisfiedConstraints(
+    SmallVectorImpl<ExternalSatisfiedConstraint> &Constraints) {
+  for (auto &ModuleRecord : SatisfiedConstraints) {
+    ModuleFile &F = *ModuleRecord.first;
+    const RecordData &Record = ModuleRecord.second;
+    for (unsigned Idx = 0, N = Record.size(); Idx != N; /* in loop */) {
+      ExternalSatisfiedConstraint Constraint;
+      Constraint.ConstraintOwner = ReadDeclAs<NamedDecl>(F, Record, Idx);
+      ReadTemplateArgumentList(Constraint.TemplateArgs, F, Record, Idx);
+      if (Constraint.ConstraintOwner)
+        Constraints.push_back(std::move(Constraint));
+    }
+  }
+  SatisfiedConstraints.clear();
+}
+
 void ASTReader::ReadUnusedLocalTypedefNameCandidates(
     llvm::SmallSetVector<const TypedefNameDecl *, 4> &Decls) {
   for (unsigned I = 0, N = UnusedLocalTypedefNameCandidates.size(); I != N;
@@ -9852,6 +9930,20 @@ void ASTReader::finishPendingActions() {
       IdentifierInfo *II = PendingMacroIDs.begin()[I].first;
       SmallVector<PendingMacroInfo, 2> GlobalIDs;
       GlobalIDs.swap(PendingMacroIDs.begin()[I].second);
+      // Without modules, a macro history from a PCH is only needed once the
+      // preprocessor sees the identifier. Defer it until then; marking the
+      // identifier out of date makes the preprocessor ask for it.
+      if (!PP.getLangOpts().Modules && !ResolveAllMacroHistories &&
+          llvm::none_of(GlobalIDs, [](const PendingMacroInfo &Info) {
+            return Info.M->isModule();
+          })) {
+        auto &Lazy = LazyMacroHistories[II];
+        if (Lazy.empty())
+          ++NumLazyMacroHistories;
+        Lazy.append(GlobalIDs.begin(), GlobalIDs.end());
+        II->setOutOfDate(true);
+        continue;
+      }
       // Initialize the macro history from chained-PCHs ahead of module imports.
       for (unsigned IDIdx = 0, NumIDs = GlobalIDs.size(); IDIdx != NumIDs;
            ++IDIdx) {
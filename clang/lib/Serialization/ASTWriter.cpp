@@ -1164,6 +1164,7 @@ void ASTWriter::WriteBlockInfoBlock() {
   RECORD(MACRO_OFFSET);
   RECORD(INTERESTING_IDENTIFIERS);
   RECORD(UNDEFINED_BUT_USED);
+  RECORD(SATISFIED_CONSTRAINTS);
   RECORD(LATE_PARSED_TEMPLATE);
   RECORD(OPTIMIZE_PRAGMA_OPTIONS);
   RECORD(MSSTRUCT_PRAGMA_OPTIONS);
@@ -4707,6 +4708,34 @@ static void AddLazyVectorDecls(ASTWriter &Writer, Vector &Vec,
   }
 }
 
+/// Determine whether the given template argument can be stored in a
+/// SATISFIED_CONSTRAINTS record, which holds no expressions.
+static bool isSerializableSatisfactionArgument(const TemplateArgument &Arg) {
+  if (Arg.isDependent())
+    return false;
+  switch (Arg.getKind()) {
+  case TemplateArgument::Expression:
+    return false;
+  case TemplateArgument::Pack:
+    for (const TemplateArgument &P : Arg.pack_elements())
+      if (!isSerializableSatisfactionArgument(P))
+        return false;
+    return true;
+  default:
+    return true;
+  }
+}
+
+static bool
+isSerializableSatisfiedConstraint(const ConstraintSatisfaction &Satisfaction) {
+  if (!Satisfaction.getConstraintOwner())
+    return false;
+  for (const TemplateArgument &Arg : Satisfaction.getTemplateArgs())
+    if (!isSerializableSatisfactionArgument(Arg))
+      return false;
+  return true;
+}
+
 ASTFileSignature ASTWriter::WriteASTCore(Sema &SemaRef, StringRef isysroot,
                                          const std::string &OutputFile,
                                          Module *WritingModule) {
@@ -4842,6 +4871,26 @@ ASTFileSignature ASTWriter::WriteASTCore(Sema &SemaRef, StringRef isysroot,
     AddSourceLocation(I.second, UndefinedButUsed);
   }
 
+  // Build a record of the constraint satisfaction checks found to be satisfied
+  // for non-dependent template arguments, so that importers need not redo
+  // them. Unsatisfied results are not recorded, as diagnosing them requires
+  // the substituted constraint expressions.
+  RecordData SatisfiedConstraints;
+  {
+    ASTRecordWriter Writer(*this, SatisfiedConstraints);
+    for (const ConstraintSatisfaction &Satisfaction :
+         SemaRef.SatisfactionCache) {
+      if (!Satisfaction.IsSatisfied ||
+          !isSerializableSatisfiedConstraint(Satisfaction))
+        continue;
+      Writer.AddDeclRef(Satisfaction.getConstraintOwner());
+      ArrayRef<TemplateArgument> Args = Satisfaction.getTemplateArgs();
+      Writer.push_back(Args.size());
+      for (const TemplateArgument &Arg : Args)
+        Writer.AddTemplateArgument(Arg);
+    }
+  }
+
   // Build a record containing all delete-expressions that we would like to
   // analyze later in AST.
   RecordData DeleteExprsToAnalyze;
@@ -5155,6 +5204,10 @@ ASTFileSignature ASTWriter::WriteASTCore(Sema &SemaRef, StringRef isysroot,
   if (!DeleteExprsToAnalyze.empty())
     Stream.EmitRecord(DELETE_EXPRS_TO_ANALYZE, DeleteExprsToAnalyze);
 
+  // Write the satisfied constraint checks.
+  if (!SatisfiedConstraints.empty())
+    Stream.EmitRecord(SATISFIED_CONSTRAINTS, SatisfiedConstraints);
+
   // Write the visible updates to DeclContexts.
   for (auto *DC : UpdatedDeclContexts)
     WriteDeclContextVisibleUpdate(DC);
@@ -5246,6 +5299,11 @@ void ASTWriter::WriteDeclUpdatesBlocks(RecordDataImpl &OffsetsRecord) {
       switch (Kind) {
       case UPD_CXX_ADDED_IMPLICIT_MEMBER:
       case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION:
+        assert(Update.getDecl() && "no decl to add?");
+        Record.push_back(GetDeclRef(Update.getDecl()));
+        Record.push_back(getSpecializationODRHash(Update.getDecl()));
+        break;
+
       case UPD_CXX_ADDED_ANONYMOUS_NAMESPACE:
         assert(Update.getDecl() && "no decl to add?");
         Record.push_back(GetDeclRef(Update.getDecl()));
@@ -171,7 +171,9 @@ namespace clang {
     /// Add to the record the first declaration from each module file that
     /// provides a declaration of D. The intent is to provide a sufficient
     /// set such that reloading this set will load all current redeclarations.
-    void AddFirstDeclFromEachModule(const Decl *D, bool IncludeLocal) {
+    /// If \p ODRHash is provided, it is written after each declaration.
+    void AddFirstDeclFromEachModule(const Decl *D, bool IncludeLocal,
+                                    Optional<unsigned> ODRHash = None) {
       llvm::MapVector<ModuleFile*, const Decl*> Firsts;
       // FIXME: We can skip entries that we know are implied by others.
       for (const Decl *R = D->getMostRecentDecl(); R; R = R->getPreviousDecl()) {
@@ -180,8 +182,11 @@ namespace clang {
         else if (IncludeLocal)
           Firsts[nullptr] = R;
       }
-      for (const auto &F : Firsts)
+      for (const auto &F : Firsts) {
         Record.AddDeclRef(F.second);
+        if (ODRHash)
+          Record.push_back(*ODRHash);
+      }
     }
 
     /// Get the specialization decl from an entry in the specialization list.
@@ -213,9 +218,10 @@ namespace clang {
         assert(!Common->LazySpecializations);
       }
 
-      ArrayRef<DeclID> LazySpecializations;
+      ArrayRef<RedeclarableTemplateDecl::LazySpecializationInfo>
+          LazySpecializations;
       if (auto *LS = Common->LazySpecializations)
-        LazySpecializations = llvm::makeArrayRef(LS + 1, LS[0]);
+        LazySpecializations = llvm::makeArrayRef(LS + 1, LS[0].DeclID);
 
       // Add a slot to the record for the number of specializations.
       unsigned I = Record.size();
@@ -229,14 +235,20 @@ namespace clang {
       for (auto &Entry : getPartialSpecializations(Common))
         Specs.push_back(getSpecializationDecl(Entry));
 
+      // Each specialization is written as a decl ID followed by the ODR hash
+      // of its template arguments.
       for (auto *D : Specs) {
         assert(D->isCanonicalDecl() && "non-canonical decl in set");
-        AddFirstDeclFromEachModule(D, /*IncludeLocal*/true);
+        AddFirstDeclFromEachModule(D, /*IncludeLocal*/true,
+                                   getSpecializationODRHash(D));
+      }
+      for (const auto &LS : LazySpecializations) {
+        Record.push_back(LS.DeclID);
+        Record.push_back(LS.ODRHash);
       }
-      Record.append(LazySpecializations.begin(), LazySpecializations.end());
 
       // Update the size entry we added earlier.
-      Record[I] = Record.size() - I - 1;
+      Record[I] = (Record.size() - I - 1) / 2;
     }
 
     /// Ensure that this template specialization is associated with the specified
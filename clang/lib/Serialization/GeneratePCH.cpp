@@ -17,6 +17,9 @@
 #include "clang/Sema/SemaConsumer.h"
 #include "clang/Serialization/ASTWriter.h"
 #include "llvm/Bitstream/BitstreamWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include <algorithm>
+#include <limits>
 
 using namespace clang;
 
@@ -57,6 +60,17 @@ void PCHGenerator::HandleTranslationUnit(ASTContext &Ctx) {
     }
   }
 
+  // Growing the buffer while a large AST is written copies everything that
+  // has been serialized so far each time. When an existing file is being
+  // rebuilt, its size is a good estimate of what we are about to write, so
+  // reserve a little more than that up front.
+  uint64_t PreviousSize;
+  if (Buffer->Data.empty() &&
+      !llvm::sys::fs::file_size(OutputFile, PreviousSize))
+    Buffer->Data.reserve(
+        std::min<uint64_t>(PreviousSize + PreviousSize / 8,
+                           std::numeric_limits<unsigned>::max()));
+
   // Emit the PCH file to the Buffer.
   assert(SemaPtr && "No Sema?");
   Buffer->Signature =
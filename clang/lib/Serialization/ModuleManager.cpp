@@ -183,9 +183,14 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
       Buf = llvm::MemoryBuffer::getSTDIN();
     } else {
       // Get a buffer of the file and close the file descriptor when done.
+      // The bitstream reader does not need a null terminator, so let the
+      // file be mapped read-only; the pages are then shared with every other
+      // compiler process that imports the same module file, and records and
+      // blobs are read in place.
       Buf = FileMgr.getBufferForFile(NewModule->File,
                                      /*isVolatile=*/false,
-                                     /*ShouldClose=*/true);
+                                     /*ShouldClose=*/true,
+                                     /*RequiresNullTerminator=*/false);
     }
 
     if (!Buf) {
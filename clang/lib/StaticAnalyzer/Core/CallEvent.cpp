@@ -567,6 +567,11 @@ RuntimeDefinition AnyFunctionCall::getRuntimeDefinition() const {
   if (!Opts.IsNaiveCTUEnabled)
     return {};
 
+  // In summary mode the call is evaluated with the summary of the function
+  // instead of importing and inlining its definition.
+  if (!Opts.CTUSummaryName.empty())
+    return {};
+
   cross_tu::CrossTranslationUnitContext &CTUCtx =
       *Engine.getCrossTranslationUnitContext();
   llvm::Expected<const FunctionDecl *> CTUDeclOrError =
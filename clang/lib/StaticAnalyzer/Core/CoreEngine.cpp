@@ -47,6 +47,9 @@ STATISTIC(NumReachedMaxSteps,
             "The # of times we reached the max number of steps.");
 STATISTIC(NumPathsExplored,
             "The # of paths explored by the analyzer.");
+STATISTIC(MaxGraphMemoryKB,
+            "The maximum memory used by the nodes and states of an exploded "
+            "graph, in KB.");
 
 //===----------------------------------------------------------------------===//
 // Core analysis engine.
@@ -147,6 +150,9 @@ bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
 
     dispatchWorkItem(Node, Node->getLocation(), WU);
   }
+  // The program states and their maps are allocated with the graph's
+  // allocator as well.
+  MaxGraphMemoryKB.updateMax(G.getAllocator().getTotalMemory() / 1024);
   SubEng.processEndWorklist();
   return WList->hasWork();
 }
@@ -27,6 +27,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Casting.h"
 #include <cassert>
 #include <memory>
@@ -34,6 +35,11 @@
 using namespace clang;
 using namespace ento;
 
+#define DEBUG_TYPE "ExplodedGraph"
+
+STATISTIC(NumReclaimedNodes,
+          "The # of nodes reclaimed from the exploded graph");
+
 //===----------------------------------------------------------------------===//
 // Cleanup.
 //===----------------------------------------------------------------------===//
@@ -164,6 +170,7 @@ void ExplodedGraph::collectNode(ExplodedNode *node) {
   FreeNodes.push_back(node);
   Nodes.RemoveNode(node);
   --NumNodes;
+  ++NumReclaimedNodes;
   node->~ExplodedNode();
 }
 
@@ -179,10 +186,19 @@ void ExplodedGraph::reclaimRecentlyAllocatedNodes() {
     return;
   ReclaimCounter = ReclaimNodeInterval;
 
-  for (const auto node : ChangedNodes)
+  // The nodes created last are usually still waiting for their successor on
+  // the worklist. Give them one more chance at the next reclamation instead of
+  // keeping them forever. Sinks never get a successor.
+  NodeVector CarriedOverNodes;
+  for (unsigned I = 0, E = ChangedNodes.size(); I != E; ++I) {
+    ExplodedNode *node = ChangedNodes[I];
     if (shouldCollect(node))
       collectNode(node);
-  ChangedNodes.clear();
+    else if (I >= NumCarriedOverNodes && node->succ_empty() && !node->isSink())
+      CarriedOverNodes.push_back(node);
+  }
+  ChangedNodes = std::move(CarriedOverNodes);
+  NumCarriedOverNodes = ChangedNodes.size();
 }
 
 //===----------------------------------------------------------------------===//
@@ -16,6 +16,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/Analysis/Analyses/LiveVariables.h"
 #include "clang/Analysis/ConstructionContext.h"
+#include "clang/CrossTU/CrossTranslationUnit.h"
 #include "clang/StaticAnalyzer/Core/CheckerManager.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/CallEvent.h"
 #include "llvm/ADT/SmallSet.h"
@@ -680,6 +681,43 @@ void ExprEngine::conservativeEvalCall(const CallEvent &Call, NodeBuilder &Bldr,
   Bldr.generateNode(Call.getProgramPoint(), State, Pred);
 }
 
+bool ExprEngine::evalCallWithCTUSummary(const CallEvent &Call,
+                                        NodeBuilder &Bldr, ExplodedNode *Pred,
+                                        ProgramStateRef State) {
+  AnalyzerOptions &Opts = getAnalysisManager().options;
+  if (!Opts.IsNaiveCTUEnabled || Opts.CTUSummaryName.empty())
+    return false;
+
+  const auto *FD = dyn_cast_or_null<FunctionDecl>(Call.getDecl());
+  if (!FD || !isa<SimpleFunctionCall>(Call) || FD->hasBody())
+    return false;
+
+  llvm::Expected<cross_tu::CallSummary> SummaryOrErr =
+      CTU.getCallSummary(FD, Opts.CTUDir, Opts.CTUSummaryName);
+  if (!SummaryOrErr) {
+    handleAllErrors(SummaryOrErr.takeError(),
+                    [&](const cross_tu::IndexError &IE) {
+                      CTU.emitCrossTUDiagnostics(IE);
+                    });
+    return false;
+  }
+
+  const LocationContext *LCtx = Pred->getLocationContext();
+  if (SummaryOrErr->MayHaveSideEffects)
+    State = Call.invalidateRegions(currBldrCtx->blockCount(), State);
+
+  QualType ResultTy = Call.getResultType();
+  if (SummaryOrErr->ReturnValue && ResultTy->isIntegralOrEnumerationType()) {
+    SVal V = svalBuilder.makeIntVal(*SummaryOrErr->ReturnValue, ResultTy);
+    State = State->BindExpr(Call.getOriginExpr(), LCtx, V);
+  } else {
+    State = bindReturnValue(Call, LCtx, State);
+  }
+
+  Bldr.generateNode(Call.getProgramPoint(), State, Pred);
+  return true;
+}
+
 ExprEngine::CallInlinePolicy
 ExprEngine::mayInlineCallKind(const CallEvent &Call, const ExplodedNode *Pred,
                               AnalyzerOptions &Opts,
@@ -1048,6 +1086,10 @@ void ExprEngine::defaultEvalCall(NodeBuilder &Bldr, ExplodedNode *Pred,
     }
   }
 
+  // A function defined in another translation unit may have a summary.
+  if (evalCallWithCTUSummary(*Call, Bldr, Pred, State))
+    return;
+
   // If we can't inline it, handle the return value and invalidate the regions.
   conservativeEvalCall(*Call, Bldr, Pred, State);
 }
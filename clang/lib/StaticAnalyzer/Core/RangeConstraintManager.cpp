@@ -17,16 +17,44 @@
 #include "clang/StaticAnalyzer/Core/PathSensitive/ProgramStateTrait.h"
 #include "clang/StaticAnalyzer/Core/PathSensitive/RangedConstraintManager.h"
 #include "llvm/ADT/FoldingSet.h"
-#include "llvm/ADT/ImmutableSet.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace clang;
 using namespace ento;
 
-void RangeSet::IntersectInRange(BasicValueFactory &BV, Factory &F,
-                      const llvm::APSInt &Lower, const llvm::APSInt &Upper,
-                      PrimRangeSet &newRanges, PrimRangeSet::iterator &i,
-                      PrimRangeSet::iterator &e) const {
+RangeSet RangeSet::Factory::getRangeSet(ArrayRef<Range> Ranges) {
+  if (Ranges.empty())
+    return getEmptySet();
+
+  llvm::FoldingSetNodeID ID;
+  Storage::Profile(ID, Ranges);
+  void *InsertPos;
+  if (Storage *S = Cache.FindNodeOrInsertPos(ID, InsertPos))
+    return RangeSet(S);
+
+  Range *Copy = Arena.Allocate<Range>(Ranges.size());
+  std::uninitialized_copy(Ranges.begin(), Ranges.end(), Copy);
+  auto *S = new (Arena.Allocate<Storage>()) Storage(Copy, Ranges.size());
+  Cache.InsertNode(S, InsertPos);
+  return RangeSet(S);
+}
+
+RangeSet RangeSet::addRange(Factory &F, const RangeSet &RS) const {
+  SmallVector<Range, 8> newRanges;
+  std::merge(begin(), end(), RS.begin(), RS.end(),
+             std::back_inserter(newRanges),
+             [](const Range &LHS, const Range &RHS) {
+               return LHS.From() < RHS.From();
+             });
+  return F.getRangeSet(newRanges);
+}
+
+void RangeSet::IntersectInRange(BasicValueFactory &BV,
+                                const llvm::APSInt &Lower,
+                                const llvm::APSInt &Upper,
+                                SmallVectorImpl<Range> &newRanges, iterator &i,
+                                iterator &e) const {
   // There are six cases for each range R in the set:
   //   1. R is entirely before the intersection range.
   //   2. R is entirely after the intersection range.
@@ -45,24 +73,28 @@ void RangeSet::IntersectInRange(BasicValueFactory &BV, Factory &F,
 
     if (i->Includes(Lower)) {
       if (i->Includes(Upper)) {
-        newRanges =
-            F.add(newRanges, Range(BV.getValue(Lower), BV.getValue(Upper)));
+        newRanges.emplace_back(BV.getValue(Lower), BV.getValue(Upper));
         break;
       } else
-        newRanges = F.add(newRanges, Range(BV.getValue(Lower), i->To()));
+        newRanges.emplace_back(BV.getValue(Lower), i->To());
     } else {
       if (i->Includes(Upper)) {
-        newRanges = F.add(newRanges, Range(i->From(), BV.getValue(Upper)));
+        newRanges.emplace_back(i->From(), BV.getValue(Upper));
         break;
       } else
-        newRanges = F.add(newRanges, *i);
+        newRanges.push_back(*i);
     }
   }
 }
 
 const llvm::APSInt &RangeSet::getMinValue() const {
   assert(!isEmpty());
-  return ranges.begin()->From();
+  return begin()->From();
+}
+
+const llvm::APSInt &RangeSet::getMaxValue() const {
+  assert(!isEmpty());
+  return std::prev(end())->To();
 }
 
 bool RangeSet::pin(llvm::APSInt &Lower, llvm::APSInt &Upper) const {
@@ -158,68 +190,101 @@ RangeSet RangeSet::Intersect(BasicValueFactory &BV, Factory &F,
   if (!pin(Lower, Upper))
     return F.getEmptySet();
 
-  PrimRangeSet newRanges = F.getEmptySet();
+  // Share the storage of this set if the range does not remove anything.
+  if (Lower <= Upper && Lower <= getMinValue() && getMaxValue() <= Upper)
+    return *this;
+
+  SmallVector<Range, 8> newRanges;
 
-  PrimRangeSet::iterator i = begin(), e = end();
+  iterator i = begin(), e = end();
   if (Lower <= Upper)
-    IntersectInRange(BV, F, Lower, Upper, newRanges, i, e);
+    IntersectInRange(BV, Lower, Upper, newRanges, i, e);
   else {
     // The order of the next two statements is important!
     // IntersectInRange() does not reset the iteration state for i and e.
     // Therefore, the lower range most be handled first.
-    IntersectInRange(BV, F, BV.getMinValue(Upper), Upper, newRanges, i, e);
-    IntersectInRange(BV, F, Lower, BV.getMaxValue(Lower), newRanges, i, e);
+    IntersectInRange(BV, BV.getMinValue(Upper), Upper, newRanges, i, e);
+    IntersectInRange(BV, Lower, BV.getMaxValue(Lower), newRanges, i, e);
   }
 
-  return newRanges;
+  return F.getRangeSet(newRanges);
 }
 
 // Returns a set containing the values in the receiving set, intersected with
 // the range set passed as parameter.
 RangeSet RangeSet::Intersect(BasicValueFactory &BV, Factory &F,
                              const RangeSet &Other) const {
-  PrimRangeSet newRanges = F.getEmptySet();
-
-  for (iterator i = Other.begin(), e = Other.end(); i != e; ++i) {
-    RangeSet newPiece = Intersect(BV, F, i->From(), i->To());
-    for (iterator j = newPiece.begin(), ee = newPiece.end(); j != ee; ++j) {
-      newRanges = F.add(newRanges, *j);
+  if (*this == Other || isEmpty())
+    return *this;
+  if (Other.isEmpty())
+    return Other;
+
+  // The ranges of the other set have to be pinned to the type of this one
+  // first if the types differ.
+  if (!(APSIntType(getMinValue()) == APSIntType(Other.getMinValue()))) {
+    SmallVector<Range, 8> newRanges;
+    for (iterator i = Other.begin(), e = Other.end(); i != e; ++i) {
+      RangeSet newPiece = Intersect(BV, F, i->From(), i->To());
+      newRanges.append(newPiece.begin(), newPiece.end());
     }
+    llvm::sort(newRanges, [](const Range &LHS, const Range &RHS) {
+      return LHS.From() < RHS.From();
+    });
+    newRanges.erase(std::unique(newRanges.begin(), newRanges.end()),
+                    newRanges.end());
+    return F.getRangeSet(newRanges);
+  }
+
+  // Both sets are sorted, so walk them side by side.
+  SmallVector<Range, 8> newRanges;
+  iterator i = begin(), ie = end(), j = Other.begin(), je = Other.end();
+  while (i != ie && j != je) {
+    const llvm::APSInt &From = std::max(i->From(), j->From());
+    const llvm::APSInt &To = std::min(i->To(), j->To());
+    if (From <= To)
+      newRanges.emplace_back(From, To);
+    if (i->To() < j->To())
+      ++i;
+    else
+      ++j;
   }
 
-  return newRanges;
+  return F.getRangeSet(newRanges);
 }
 
 // Turn all [A, B] ranges to [-B, -A]. Ranges [MIN, B] are turned to range set
 // [MIN, MIN] U [-B, MAX], when MIN and MAX are the minimal and the maximal
 // signed values of the type.
 RangeSet RangeSet::Negate(BasicValueFactory &BV, Factory &F) const {
-  PrimRangeSet newRanges = F.getEmptySet();
+  SmallVector<Range, 8> newRanges;
+  // The index of the range starting at MIN in newRanges, if there is one.
+  Optional<unsigned> MinIdx;
 
   for (iterator i = begin(), e = end(); i != e; ++i) {
     const llvm::APSInt &from = i->From(), &to = i->To();
     const llvm::APSInt &newTo = (from.isMinSignedValue() ?
                                  BV.getMaxValue(from) :
                                  BV.getValue(- from));
-    if (to.isMaxSignedValue() && !newRanges.isEmpty() &&
-        newRanges.begin()->From().isMinSignedValue()) {
-      assert(newRanges.begin()->To().isMinSignedValue() &&
-             "Ranges should not overlap");
+    if (to.isMaxSignedValue() && MinIdx) {
+      Range &MinRange = newRanges[*MinIdx];
+      assert(MinRange.To().isMinSignedValue() && "Ranges should not overlap");
       assert(!from.isMinSignedValue() && "Ranges should not overlap");
-      const llvm::APSInt &newFrom = newRanges.begin()->From();
-      newRanges =
-        F.add(F.remove(newRanges, *newRanges.begin()), Range(newFrom, newTo));
+      MinRange = Range(MinRange.From(), newTo);
     } else if (!to.isMinSignedValue()) {
       const llvm::APSInt &newFrom = BV.getValue(- to);
-      newRanges = F.add(newRanges, Range(newFrom, newTo));
+      newRanges.emplace_back(newFrom, newTo);
     }
     if (from.isMinSignedValue()) {
-      newRanges = F.add(newRanges, Range(BV.getMinValue(from),
-                                         BV.getMinValue(from)));
+      MinIdx = newRanges.size();
+      newRanges.emplace_back(BV.getMinValue(from), BV.getMinValue(from));
     }
   }
 
-  return newRanges;
+  // Negation reverses the order of the ranges.
+  llvm::sort(newRanges, [](const Range &LHS, const Range &RHS) {
+    return LHS.From() < RHS.From();
+  });
+  return F.getRangeSet(newRanges);
 }
 
 void RangeSet::print(raw_ostream &os) const {
@@ -578,11 +578,15 @@ static bool isBisonFile(ASTContext &C) {
 void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
   BugReporter BR(*Mgr);
   TranslationUnitDecl *TU = C.getTranslationUnitDecl();
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->startTimer();
-  checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
-  if (SyntaxCheckTimer)
-    SyntaxCheckTimer->stopTimer();
+  // The checks on the whole translation unit only run in the first shard.
+  const bool RunTUChecks = Opts->ShardCount <= 1 || Opts->ShardIndex == 0;
+  if (RunTUChecks) {
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->startTimer();
+    checkerMgr->runCheckersOnASTDecl(TU, *Mgr, BR);
+    if (SyntaxCheckTimer)
+      SyntaxCheckTimer->stopTimer();
+  }
 
   // Run the AST-only checks using the order in which functions are defined.
   // If inlining is not turned on, use the simplest function order for path
@@ -607,7 +611,8 @@ void AnalysisConsumer::runAnalysisOnTranslationUnit(ASTContext &C) {
     HandleDeclsCallGraph(LocalTUDeclsSize);
 
   // After all decls handled, run checkers on the entire TranslationUnit.
-  checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
+  if (RunTUChecks)
+    checkerMgr->runCheckersOnEndOfTranslationUnit(TU, *Mgr, BR);
 
   RecVisitorBR = nullptr;
 }
@@ -731,7 +736,18 @@ AnalysisConsumer::getModeForDecl(Decl *D, AnalysisMode Mode) {
   if (!Opts->AnalyzeAll && !Mgr->isInCodeFile(SL)) {
     if (SL.isInvalid() || SM.isInSystemHeader(SL))
       return AM_None;
-    return Mode & ~AM_Path;
+    Mode &= ~AM_Path;
+  }
+
+  // When the translation unit is split into shards, each function is analyzed
+  // path-sensitively by exactly one of them, picked by where its body is. The
+  // other checks only run in the first shard, so that every report is emitted
+  // by one of the analyzer processes only.
+  if (Opts->ShardCount > 1) {
+    if (Opts->ShardIndex != 0)
+      Mode &= ~AM_Syntax;
+    if (SL.getRawEncoding() % Opts->ShardCount != Opts->ShardIndex)
+      Mode &= ~AM_Path;
   }
 
   return Mode;
@@ -8,6 +8,7 @@
 
 #include "clang/Tooling/AllTUsExecution.h"
 #include "clang/Tooling/ToolExecutorPluginRegistry.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
@@ -51,6 +52,113 @@ private:
   std::mutex Mutex;
 };
 
+/// The statuses and contents of the files read by the TUs, shared between all
+/// of them so that common headers are only stat'ed and read once, rather than
+/// once per TU. Files are assumed not to change while the executor runs.
+class SharedFileCache {
+public:
+  llvm::ErrorOr<llvm::vfs::Status> status(StringRef AbsPath,
+                                          llvm::vfs::FileSystem &FS) {
+    {
+      std::unique_lock<std::mutex> LockGuard(Mutex);
+      auto It = Statuses.find(AbsPath);
+      if (It != Statuses.end())
+        return It->second;
+    }
+    llvm::ErrorOr<llvm::vfs::Status> Status = FS.status(AbsPath);
+    std::unique_lock<std::mutex> LockGuard(Mutex);
+    return Statuses.try_emplace(AbsPath, std::move(Status)).first->second;
+  }
+
+  /// Returns nullptr if the file can't be read.
+  const llvm::MemoryBuffer *contents(StringRef AbsPath,
+                                     llvm::vfs::FileSystem &FS) {
+    {
+      std::unique_lock<std::mutex> LockGuard(Mutex);
+      auto It = Contents.find(AbsPath);
+      if (It != Contents.end())
+        return It->second.get();
+    }
+    std::unique_ptr<llvm::MemoryBuffer> Buffer;
+    if (auto BufferOrErr = FS.getBufferForFile(AbsPath))
+      Buffer = std::move(*BufferOrErr);
+    std::unique_lock<std::mutex> LockGuard(Mutex);
+    return Contents.try_emplace(AbsPath, std::move(Buffer))
+        .first->second.get();
+  }
+
+private:
+  std::mutex Mutex;
+  llvm::StringMap<llvm::ErrorOr<llvm::vfs::Status>> Statuses;
+  llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> Contents;
+};
+
+/// A file whose contents are owned by a SharedFileCache.
+class CachedFile : public llvm::vfs::File {
+public:
+  CachedFile(llvm::vfs::Status Status, const llvm::MemoryBuffer &Contents)
+      : Status(std::move(Status)), Contents(Contents) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status() override { return Status; }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
+  getBuffer(const Twine &Name, int64_t FileSize, bool RequiresNullTerminator,
+            bool IsVolatile) override {
+    return llvm::MemoryBuffer::getMemBuffer(Contents.getBuffer(), Name.str(),
+                                            RequiresNullTerminator);
+  }
+
+  std::error_code close() override { return {}; }
+
+private:
+  llvm::vfs::Status Status;
+  const llvm::MemoryBuffer &Contents;
+};
+
+/// Serves the statuses and contents of files from a SharedFileCache. Each TU
+/// gets its own instance, so that they can have different working directories.
+class SharedCacheFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+  SharedCacheFileSystem(IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS,
+                        SharedFileCache &Cache)
+      : ProxyFileSystem(std::move(FS)), Cache(Cache) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override {
+    SmallString<256> AbsPath;
+    Path.toVector(AbsPath);
+    if (makeAbsolute(AbsPath))
+      return ProxyFileSystem::status(Path);
+    llvm::ErrorOr<llvm::vfs::Status> Status =
+        Cache.status(AbsPath, getUnderlyingFS());
+    if (!Status)
+      return Status;
+    return llvm::vfs::Status::copyWithNewName(*Status, Path.str());
+  }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    SmallString<256> AbsPath;
+    Path.toVector(AbsPath);
+    if (makeAbsolute(AbsPath))
+      return ProxyFileSystem::openFileForRead(Path);
+    llvm::ErrorOr<llvm::vfs::Status> Status =
+        Cache.status(AbsPath, getUnderlyingFS());
+    if (!Status)
+      return Status.getError();
+    // Let the underlying file system report errors, e.g. for directories.
+    const llvm::MemoryBuffer *Contents =
+        Status->isRegularFile() ? Cache.contents(AbsPath, getUnderlyingFS())
+                                : nullptr;
+    if (!Contents)
+      return ProxyFileSystem::openFileForRead(Path);
+    return std::unique_ptr<llvm::vfs::File>(new CachedFile(
+        llvm::vfs::Status::copyWithNewName(*Status, Path.str()), *Contents));
+  }
+
+private:
+  SharedFileCache &Cache;
+};
+
 } // namespace
 
 llvm::cl::opt<std::string>
@@ -59,6 +167,13 @@ llvm::cl::opt<std::string>
                           "This flag only applies to all-TUs."),
            llvm::cl::init(".*"));
 
+static llvm::cl::opt<bool> ShareFileCache(
+    "share-file-cache",
+    llvm::cl::desc("Stat and read each file only once, and share the results "
+                   "between all TUs. Files must not change while the tool "
+                   "runs. This flag only applies to all-TUs."),
+    llvm::cl::init(false));
+
 AllTUsToolExecutor::AllTUsToolExecutor(
     const CompilationDatabase &Compilations, unsigned ThreadCount,
     std::shared_ptr<PCHContainerOperations> PCHContainerOps)
@@ -111,6 +226,7 @@ llvm::Error AllTUsToolExecutor::execute(
   };
 
   auto &Action = Actions.front();
+  SharedFileCache FileCache;
 
   {
     llvm::ThreadPool Pool(ThreadCount == 0 ? llvm::hardware_concurrency()
@@ -124,6 +240,8 @@ llvm::Error AllTUsToolExecutor::execute(
             // concurrent working directories.
             IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS =
                 llvm::vfs::createPhysicalFileSystem().release();
+            if (ShareFileCache)
+              FS = new SharedCacheFileSystem(std::move(FS), FileCache);
             ClangTool Tool(Compilations, {Path},
                            std::make_shared<PCHContainerOperations>(), FS);
             Tool.appendArgumentsAdjuster(Action.second);
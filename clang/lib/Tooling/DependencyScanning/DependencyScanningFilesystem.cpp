@@ -0,0 +1,237 @@
+//===- DependencyScanningFilesystem.cpp - clang-scan-deps fs --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "clang/Lex/DependencyDirectivesSourceMinimizer.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Threading.h"
+
+using namespace clang;
+using namespace tooling;
+using namespace dependencies;
+
+CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
+    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize) {
+  // Load the file and its content from the file system.
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> MaybeFile =
+      FS.openFileForRead(Filename);
+  if (!MaybeFile)
+    return MaybeFile.getError();
+  llvm::ErrorOr<llvm::vfs::Status> Stat = (*MaybeFile)->status();
+  if (!Stat)
+    return Stat.getError();
+
+  llvm::vfs::File &F = **MaybeFile;
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> MaybeBuffer =
+      F.getBuffer(Stat->getName());
+  if (!MaybeBuffer)
+    return MaybeBuffer.getError();
+  const auto &Buffer = *MaybeBuffer;
+
+  CachedFileSystemEntry Result;
+  // Minimize the file down to directives that might affect the dependencies.
+  // The minimizer null terminates its output, which is what Clang's lexer
+  // expects from the buffers that are handed to it.
+  SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
+  if (!Minimize || minimizeSourceToDependencyDirectives(
+                       Buffer->getBuffer(), Result.Contents, Tokens)) {
+    // Use the original file unless requested otherwise, or if the minimization
+    // failed.
+    // FIXME: Propagate the diagnostic if desired by the client.
+    Result.Contents.clear();
+    Result.Contents.reserve(Buffer->getBufferSize() + 1);
+    Result.Contents.append(Buffer->getBufferStart(), Buffer->getBufferEnd());
+    // Implicitly null terminate the contents for Clang's lexer.
+    Result.Contents.push_back('\0');
+    Result.Contents.pop_back();
+  } else {
+    // Compute the skipped PP ranges that speed up skipping over inactive
+    // preprocessor blocks. The ranges are only valid for the minimized
+    // contents, and are dropped if the conditionals are unbalanced.
+    SmallVector<minimize_source_to_dependency_directives::SkippedRange, 32>
+        SkippedRanges;
+    if (!minimize_source_to_dependency_directives::computeSkippedRanges(
+            Tokens, SkippedRanges)) {
+      for (const auto &Range : SkippedRanges) {
+        // Ignore small ranges, as the lexer gets through them quickly.
+        if (Range.Length < 16)
+          continue;
+        Result.PPSkippedRangeMapping[Range.Offset] = Range.Length;
+      }
+    }
+  }
+
+  // The size of the entry has to match the size of the contents that are
+  // served from the cache, as the file manager relies on it when reading the
+  // file.
+  Result.MaybeStat = llvm::vfs::Status(
+      Stat->getName(), Stat->getUniqueID(), Stat->getLastModificationTime(),
+      Stat->getUser(), Stat->getGroup(), Result.Contents.size(),
+      Stat->getType(), Stat->getPermissions());
+  return Result;
+}
+
+CachedFileSystemEntry
+CachedFileSystemEntry::createDirectoryEntry(llvm::vfs::Status &&Stat) {
+  assert(Stat.isDirectory() && "not a directory!");
+  auto Result = CachedFileSystemEntry();
+  Result.MaybeStat = std::move(Stat);
+  return Result;
+}
+
+DependencyScanningFilesystemSharedCache::
+    DependencyScanningFilesystemSharedCache() {
+  // The cache is sharded to reduce the lock contention between the workers,
+  // so the number of shards grows with the number of hardware threads.
+  // FIXME: A better heuristic might also consider the OS to account for
+  // the different cost of lock contention on different OSes.
+  NumShards = std::max(2u, llvm::hardware_concurrency() / 4);
+  CacheShards = llvm::make_unique<CacheShard[]>(NumShards);
+}
+
+DependencyScanningFilesystemSharedCache::SharedFileSystemEntry &
+DependencyScanningFilesystemSharedCache::get(StringRef Key) {
+  CacheShard &Shard = CacheShards[llvm::hash_value(Key) % NumShards];
+  std::unique_lock<std::mutex> LockGuard(Shard.CacheLock);
+  auto It = Shard.Cache.try_emplace(Key);
+  return It.first->getValue();
+}
+
+namespace {
+
+/// The VFS that is used by clang consumes the \c CachedFileSystemEntry using
+/// this subclass.
+class MinimizedVFSFile final : public llvm::vfs::File {
+public:
+  MinimizedVFSFile(StringRef Contents, llvm::vfs::Status Stat)
+      : Contents(Contents), Stat(std::move(Stat)) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status() override { return Stat; }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
+  getBuffer(const Twine &Name, int64_t FileSize, bool RequiresNullTerminator,
+            bool IsVolatile) override {
+    // The contents are owned by the shared cache and are always null
+    // terminated.
+    return llvm::MemoryBuffer::getMemBuffer(Contents, Stat.getName(),
+                                            /*RequiresNullTerminator=*/true);
+  }
+
+  std::error_code close() override { return {}; }
+
+private:
+  StringRef Contents;
+  llvm::vfs::Status Stat;
+};
+
+} // end anonymous namespace
+
+/// Returns true if the contents of \p Filename can be minimized. Module maps
+/// aren't C-family sources, so they have to be read as they are.
+static bool shouldMinimize(StringRef Filename) {
+  StringRef Name = llvm::sys::path::filename(Filename);
+  return !llvm::sys::path::extension(Name).equals_lower(".modulemap") &&
+         Name != "module.map" && Name != "module_private.map";
+}
+
+/// Returns true if \p Filename must not be cached. Module files, and the lock
+/// and timestamp files next to them, are written while the scanner runs when
+/// the modules are built implicitly.
+static bool shouldBypassCache(StringRef Filename) {
+  StringRef Ext = llvm::sys::path::extension(Filename);
+  return Ext == ".pcm" || Ext == ".lock" || Ext == ".timestamp";
+}
+
+std::error_code DependencyScanningWorkerFilesystem::getCacheKey(
+    const Twine &Path, SmallVectorImpl<char> &Key) const {
+  Path.toVector(Key);
+  if (std::error_code EC = makeAbsolute(Key))
+    return EC;
+  // Don't remove '..' components, as that's not correct in the presence of
+  // symlinks.
+  llvm::sys::path::remove_dots(Key, /*remove_dot_dot=*/false);
+  return {};
+}
+
+const CachedFileSystemEntry *
+DependencyScanningWorkerFilesystem::getOrCreateFileSystemEntry(
+    StringRef Filename) {
+  auto It = Cache.find(Filename);
+  if (It != Cache.end())
+    return It->second;
+
+  DependencyScanningFilesystemSharedCache::SharedFileSystemEntry
+      &SharedCacheEntry = SharedCache.get(Filename);
+  const CachedFileSystemEntry *Result;
+  {
+    // The first worker that requests the entry populates it, while the other
+    // workers wait for it here instead of hitting the file system too.
+    std::unique_lock<std::mutex> LockGuard(SharedCacheEntry.ValueLock);
+    CachedFileSystemEntry &CacheEntry = SharedCacheEntry.Value;
+
+    if (!CacheEntry.isValid()) {
+      llvm::vfs::FileSystem &FS = getUnderlyingFS();
+      llvm::ErrorOr<llvm::vfs::Status> MaybeStatus = FS.status(Filename);
+      if (!MaybeStatus)
+        CacheEntry = CachedFileSystemEntry(MaybeStatus.getError());
+      else if (MaybeStatus->isDirectory())
+        CacheEntry = CachedFileSystemEntry::createDirectoryEntry(
+            std::move(*MaybeStatus));
+      else
+        CacheEntry = CachedFileSystemEntry::createFileEntry(
+            Filename, FS, shouldMinimize(Filename));
+    }
+
+    Result = &CacheEntry;
+  }
+
+  // Store the result in the local cache.
+  Cache[Filename] = Result;
+  return Result;
+}
+
+llvm::ErrorOr<llvm::vfs::Status>
+DependencyScanningWorkerFilesystem::status(const Twine &Path) {
+  SmallString<256> Key;
+  if (std::error_code EC = getCacheKey(Path, Key))
+    return EC;
+  if (shouldBypassCache(Key))
+    return getUnderlyingFS().status(Path);
+
+  const CachedFileSystemEntry *Entry = getOrCreateFileSystemEntry(Key);
+  llvm::ErrorOr<llvm::vfs::Status> Stat = Entry->getStatus();
+  if (!Stat)
+    return Stat.getError();
+  return llvm::vfs::Status::copyWithNewName(*Stat, Path);
+}
+
+llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+DependencyScanningWorkerFilesystem::openFileForRead(const Twine &Path) {
+  SmallString<256> Key;
+  if (std::error_code EC = getCacheKey(Path, Key))
+    return EC;
+  if (shouldBypassCache(Key))
+    return getUnderlyingFS().openFileForRead(Path);
+
+  const CachedFileSystemEntry *Entry = getOrCreateFileSystemEntry(Key);
+  if (Entry->isDirectory())
+    return std::make_error_code(std::errc::is_a_directory);
+  llvm::ErrorOr<StringRef> Contents = Entry->getContents();
+  if (!Contents)
+    return Contents.getError();
+  // The buffer handed out for this file points at the cached contents, so its
+  // start identifies the mapping for the preprocessor.
+  const PreprocessorSkippedRangeMapping &Mapping =
+      Entry->getPPSkippedRangeMapping();
+  if (PPSkipMappings && !Mapping.empty())
+    (*PPSkipMappings)[Contents->data()] = &Mapping;
+  return llvm::make_unique<MinimizedVFSFile>(
+      *Contents,
+      llvm::vfs::Status::copyWithNewName(*Entry->getStatus(), Path));
+}
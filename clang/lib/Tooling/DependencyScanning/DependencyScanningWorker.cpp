@@ -7,11 +7,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
+#include "clang/Basic/Module.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Frontend/Utils.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/Serialization/ASTReader.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/JSON.h"
 
 using namespace clang;
 using namespace tooling;
@@ -19,21 +26,229 @@ using namespace dependencies;
 
 namespace {
 
+/// Records the top-level modules that are imported by the translation unit.
+///
+/// Modules are built by separate compiler instances, so only the imports of
+/// the main file and the headers it includes textually are seen here.
+class ModuleImportCallbacks : public PPCallbacks {
+public:
+  ModuleImportCallbacks(llvm::SetVector<const Module *> &DirectModuleDeps)
+      : DirectModuleDeps(DirectModuleDeps) {}
+
+  void InclusionDirective(SourceLocation HashLoc, const Token &IncludeTok,
+                          StringRef FileName, bool IsAngled,
+                          CharSourceRange FilenameRange, const FileEntry *File,
+                          StringRef SearchPath, StringRef RelativePath,
+                          const Module *Imported,
+                          SrcMgr::CharacteristicKind FileType) override {
+    if (Imported)
+      DirectModuleDeps.insert(Imported->getTopLevelModule());
+  }
+
+  void moduleImport(SourceLocation ImportLoc, ModuleIdPath Path,
+                    const Module *Imported) override {
+    if (Imported)
+      DirectModuleDeps.insert(Imported->getTopLevelModule());
+  }
+
+private:
+  llvm::SetVector<const Module *> &DirectModuleDeps;
+};
+
 /// Prints out all of the gathered dependencies into a string.
 class DependencyPrinter : public DependencyFileGenerator {
 public:
   DependencyPrinter(std::unique_ptr<DependencyOutputOptions> Opts,
-                    std::string &S)
-      : DependencyFileGenerator(*Opts), Opts(std::move(Opts)), S(S) {}
+                    std::string &S, ScanningOutputFormat Format,
+                    StringRef Input, StringRef WorkingDirectory,
+                    CompilerInstance &Instance)
+      : DependencyFileGenerator(*Opts), Opts(std::move(Opts)), S(S),
+        Format(Format), Input(Input), WorkingDirectory(WorkingDirectory),
+        Instance(Instance) {}
+
+  void attachToPreprocessor(Preprocessor &PP) override {
+    DependencyFileGenerator::attachToPreprocessor(PP);
+    if (Format == ScanningOutputFormat::Full)
+      PP.addPPCallbacks(
+          llvm::make_unique<ModuleImportCallbacks>(DirectModuleDeps));
+  }
 
   void finishedMainFile(DiagnosticsEngine &Diags) override {
     llvm::raw_string_ostream OS(S);
-    outputDependencyFile(OS);
+    switch (Format) {
+    case ScanningOutputFormat::Make:
+      outputDependencyFile(OS);
+      break;
+    case ScanningOutputFormat::JSON:
+      outputJSON(OS);
+      break;
+    case ScanningOutputFormat::Full:
+      outputFull(OS);
+      break;
+    }
   }
 
 private:
+  /// A Clang module that the translation unit depends on.
+  struct ModuleDeps {
+    std::string Name;
+    std::string ModuleMapFile;
+    /// The names of the modules that this module imports directly.
+    std::vector<std::string> ClangModuleDeps;
+    /// The module maps of the modules that this module imports directly.
+    std::vector<std::string> ClangModuleMapDeps;
+    std::vector<std::string> FileDeps;
+  };
+
+  /// Adds the module that is stored in \p MF to \p Modules after the modules
+  /// that it imports, so that every module follows its dependencies.
+  void addModuleDeps(serialization::ModuleFile &MF, ASTReader &Reader,
+                     llvm::DenseSet<serialization::ModuleFile *> &Visited,
+                     std::vector<ModuleDeps> &Modules) {
+    if (!Visited.insert(&MF).second)
+      return;
+
+    ModuleDeps MD;
+    MD.Name = MF.ModuleName;
+    MD.ModuleMapFile = MF.ModuleMapPath;
+    for (serialization::ModuleFile *Import : MF.Imports) {
+      if (!Import->isModule())
+        continue;
+      addModuleDeps(*Import, Reader, Visited, Modules);
+      MD.ClangModuleDeps.push_back(Import->ModuleName);
+      MD.ClangModuleMapDeps.push_back(Import->ModuleMapPath);
+    }
+    Reader.visitInputFiles(
+        MF, /*IncludeSystem=*/true, /*Complain=*/false,
+        [&](const serialization::InputFile &IF, bool /*IsSystem*/) {
+          if (const FileEntry *File = IF.getFile())
+            MD.FileDeps.push_back(File->getName());
+        });
+    Modules.push_back(std::move(MD));
+  }
+
+  /// Returns the argument to -x that compiles a module for the language of
+  /// the translation unit.
+  StringRef getModuleLanguage() const {
+    const FrontendOptions &FEOpts = Instance.getFrontendOpts();
+    if (FEOpts.Inputs.empty())
+      return "c++";
+    switch (FEOpts.Inputs.front().getKind().getLanguage()) {
+    case InputKind::C:
+      return "c";
+    case InputKind::ObjC:
+      return "objective-c";
+    case InputKind::ObjCXX:
+      return "objective-c++";
+    default:
+      return "c++";
+    }
+  }
+
+  /// Writes the dependencies and the required modules as a single line JSON
+  /// object.
+  ///
+  /// The "command-line" arguments are added to the command of the translation
+  /// unit, after its inputs and outputs are removed. The build system adds a
+  /// -fmodule-file= for each module in "clang-module-deps", and the output
+  /// file when building a module.
+  void outputFull(raw_ostream &OS) {
+    std::string ContextHash = Instance.getInvocation().getModuleHash();
+
+    std::vector<ModuleDeps> Modules;
+    std::vector<serialization::ModuleFile *> DirectDeps;
+    if (IntrusiveRefCntPtr<ASTReader> Reader = Instance.getModuleManager()) {
+      llvm::DenseSet<serialization::ModuleFile *> Visited;
+      for (const Module *M : DirectModuleDeps) {
+        const FileEntry *ASTFile = M->getASTFile();
+        if (!ASTFile)
+          continue;
+        if (serialization::ModuleFile *MF =
+                Reader->getModuleManager().lookup(ASTFile)) {
+          addModuleDeps(*MF, *Reader, Visited, Modules);
+          DirectDeps.push_back(MF);
+        }
+      }
+    }
+
+    StringRef Language = getModuleLanguage();
+    llvm::json::OStream J(OS);
+    auto WriteExplicitModuleArgs = [&](ArrayRef<std::string> ModuleMaps) {
+      J.value("-fno-implicit-modules");
+      J.value("-fno-implicit-module-maps");
+      for (const std::string &ModuleMap : ModuleMaps)
+        J.value("-fmodule-map-file=" + ModuleMap);
+    };
+
+    J.object([&] {
+      J.attribute("input", Input);
+      J.attribute("directory", WorkingDirectory);
+      J.attribute("context-hash", ContextHash);
+      J.attributeArray("dependencies", [&] {
+        for (StringRef Dependency : getDependencies())
+          J.value(Dependency);
+      });
+      J.attributeArray("clang-module-deps", [&] {
+        for (serialization::ModuleFile *MF : DirectDeps)
+          J.value(MF->ModuleName);
+      });
+      J.attributeArray("command-line", [&] {
+        std::vector<std::string> ModuleMaps;
+        for (serialization::ModuleFile *MF : DirectDeps)
+          ModuleMaps.push_back(MF->ModuleMapPath);
+        WriteExplicitModuleArgs(ModuleMaps);
+      });
+      J.attributeArray("modules", [&] {
+        for (const ModuleDeps &MD : Modules)
+          J.object([&] {
+            J.attribute("name", MD.Name);
+            J.attribute("context-hash", ContextHash);
+            J.attribute("module-map-file", MD.ModuleMapFile);
+            J.attributeArray("clang-module-deps", [&] {
+              for (const std::string &Dep : MD.ClangModuleDeps)
+                J.value(Dep);
+            });
+            J.attributeArray("file-deps", [&] {
+              for (const std::string &Dep : MD.FileDeps)
+                J.value(Dep);
+            });
+            J.attributeArray("command-line", [&] {
+              WriteExplicitModuleArgs(MD.ClangModuleMapDeps);
+              J.value("-Xclang");
+              J.value("-emit-module");
+              J.value("-fmodule-name=" + MD.Name);
+              J.value("-x");
+              J.value(Language);
+              J.value(MD.ModuleMapFile);
+            });
+          });
+      });
+    });
+    OS << "\n";
+  }
+
+  /// Writes the dependencies as a single line JSON object.
+  void outputJSON(raw_ostream &OS) {
+    llvm::json::OStream J(OS);
+    J.object([&] {
+      J.attribute("input", Input);
+      J.attribute("directory", WorkingDirectory);
+      J.attributeArray("dependencies", [&] {
+        for (StringRef Dependency : getDependencies())
+          J.value(Dependency);
+      });
+    });
+    OS << "\n";
+  }
+
   std::unique_ptr<DependencyOutputOptions> Opts;
   std::string &S;
+  ScanningOutputFormat Format;
+  StringRef Input;
+  StringRef WorkingDirectory;
+  CompilerInstance &Instance;
+  /// The top-level modules that are imported by the translation unit.
+  llvm::SetVector<const Module *> DirectModuleDeps;
 };
 
 /// A proxy file system that doesn't call `chdir` when changing the working
@@ -62,10 +277,13 @@ private:
 /// dependency scanning for the given compiler invocation.
 class DependencyScanningAction : public tooling::ToolAction {
 public:
-  DependencyScanningAction(StringRef WorkingDirectory,
-                           std::string &DependencyFileContents)
-      : WorkingDirectory(WorkingDirectory),
-        DependencyFileContents(DependencyFileContents) {}
+  DependencyScanningAction(
+      StringRef Input, StringRef WorkingDirectory,
+      std::string &DependencyFileContents, ScanningOutputFormat Format,
+      ExcludedPreprocessorDirectiveSkipMapping *PPSkipMappings)
+      : Input(Input), WorkingDirectory(WorkingDirectory),
+        DependencyFileContents(DependencyFileContents), Format(Format),
+        PPSkipMappings(PPSkipMappings) {}
 
   bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
                      FileManager *FileMgr,
@@ -86,6 +304,12 @@ public:
 
     Compiler.createSourceManager(*FileMgr);
 
+    // Let the preprocessor skip over the excluded conditional blocks of the
+    // minimized sources without lexing them.
+    if (PPSkipMappings)
+      Compiler.getPreprocessorOpts().ExcludedConditionalDirectiveSkipMappings =
+          PPSkipMappings;
+
     // Create the dependency collector that will collect the produced
     // dependencies.
     //
@@ -99,7 +323,8 @@ public:
     if (Opts->Targets.empty())
       Opts->Targets = {"clang-scan-deps dependency"};
     Compiler.addDependencyCollector(std::make_shared<DependencyPrinter>(
-        std::move(Opts), DependencyFileContents));
+        std::move(Opts), DependencyFileContents, Format, Input,
+        WorkingDirectory, Compiler));
 
     auto Action = llvm::make_unique<PreprocessOnlyAction>();
     const bool Result = Compiler.ExecuteAction(*Action);
@@ -108,19 +333,28 @@ public:
   }
 
 private:
+  StringRef Input;
   StringRef WorkingDirectory;
   /// The dependency file will be written to this string.
   std::string &DependencyFileContents;
+  ScanningOutputFormat Format;
+  ExcludedPreprocessorDirectiveSkipMapping *PPSkipMappings;
 };
 
 } // end anonymous namespace
 
-DependencyScanningWorker::DependencyScanningWorker() {
+DependencyScanningWorker::DependencyScanningWorker(
+    DependencyScanningService &Service) {
   DiagOpts = new DiagnosticOptions();
   PCHContainerOps = std::make_shared<PCHContainerOperations>();
-  /// FIXME: Use the shared file system from the service for fast scanning
-  /// mode.
-  WorkerFS = new ProxyFileSystemWithoutChdir(llvm::vfs::getRealFileSystem());
+  Format = Service.getFormat();
+  RealFS = new ProxyFileSystemWithoutChdir(llvm::vfs::getRealFileSystem());
+  if (Service.getMode() == ScanningMode::MinimizedSourcePreprocessing) {
+    PPSkipMappings =
+        llvm::make_unique<ExcludedPreprocessorDirectiveSkipMapping>();
+    DepFS = new DependencyScanningWorkerFilesystem(
+        Service.getSharedCache(), RealFS, PPSkipMappings.get());
+  }
 }
 
 llvm::Expected<std::string>
@@ -133,14 +367,20 @@ DependencyScanningWorker::getDependencyFile(const std::string &Input,
   llvm::raw_string_ostream DiagnosticsOS(DiagnosticOutput);
   TextDiagnosticPrinter DiagPrinter(DiagnosticsOS, DiagOpts.get());
 
-  WorkerFS->setCurrentWorkingDirectory(WorkingDirectory);
-  tooling::ClangTool Tool(CDB, Input, PCHContainerOps, WorkerFS);
+  RealFS->setCurrentWorkingDirectory(WorkingDirectory);
+  // The caching file system shares the working directory of the real file
+  // system that it wraps.
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = RealFS;
+  if (DepFS)
+    FS = DepFS;
+  tooling::ClangTool Tool(CDB, Input, PCHContainerOps, FS);
   Tool.clearArgumentsAdjusters();
   Tool.setRestoreWorkingDir(false);
   Tool.setPrintErrorMessage(false);
   Tool.setDiagnosticConsumer(&DiagPrinter);
   std::string Output;
-  DependencyScanningAction Action(WorkingDirectory, Output);
+  DependencyScanningAction Action(Input, WorkingDirectory, Output, Format,
+                                  PPSkipMappings.get());
   if (Tool.run(&Action)) {
     return llvm::make_error<llvm::StringError>(DiagnosticsOS.str(),
                                                llvm::inconvertibleErrorCode());
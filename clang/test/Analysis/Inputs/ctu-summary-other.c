@@ -0,0 +1,21 @@
+int g;
+
+int getConstant(void) {
+  return 42;
+}
+
+int getConstantOnEveryPath(int x) {
+  int y = x;
+  if (y > 0)
+    return 7;
+  return 7;
+}
+
+int getParameter(int x) {
+  return x;
+}
+
+int writeGlobal(void) {
+  g = 1;
+  return 0;
+}
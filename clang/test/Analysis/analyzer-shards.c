@@ -0,0 +1,32 @@
+// Every report is emitted by exactly one shard of the translation unit.
+//
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores %s \
+// RUN:   -analyzer-config shard-count=2 -analyzer-config shard-index=0 \
+// RUN:   2> %t.0
+// RUN: %clang_analyze_cc1 -analyzer-checker=core,deadcode.DeadStores %s \
+// RUN:   -analyzer-config shard-count=2 -analyzer-config shard-index=1 \
+// RUN:   2> %t.1
+// RUN: cat %t.0 %t.1 | FileCheck %s
+// RUN: cat %t.0 %t.1 | grep warning: | count 4
+// RUN: FileCheck %s --input-file=%t.0 --check-prefix=SHARD0
+
+int first(int *p) {
+  p = 0;
+  return *p; // CHECK-DAG: analyzer-shards.c:[[@LINE]]:{{[0-9]+}}: warning: Dereference of null pointer
+}
+
+int second(int *p) {
+  if (p)
+    return 0;
+  return *p; // CHECK-DAG: analyzer-shards.c:[[@LINE]]:{{[0-9]+}}: warning: Dereference of null pointer
+}
+
+int third(int a) {
+  int z = 0;
+  return a / z; // CHECK-DAG: analyzer-shards.c:[[@LINE]]:{{[0-9]+}}: warning: Division by zero
+}
+
+void fourth() {
+  int x;
+  x = 1; // SHARD0: analyzer-shards.c:[[@LINE]]:{{[0-9]+}}: warning: Value stored to 'x' is never read
+}
@@ -0,0 +1,50 @@
+// RUN: rm -rf %t && mkdir -p %t/ctudir
+// RUN: %clang_extdef_map -summaries %S/Inputs/ctu-summary-other.c -- \
+// RUN:   > %t/ctudir/summaries.txt
+// RUN: FileCheck --input-file=%t/ctudir/summaries.txt \
+// RUN:   --check-prefix=SUMMARY %s
+// RUN: %clang_cc1 -triple x86_64-pc-linux-gnu -fsyntax-only -analyze \
+// RUN:   -analyzer-checker=core,debug.ExprInspection \
+// RUN:   -analyzer-config experimental-enable-naive-ctu-analysis=true \
+// RUN:   -analyzer-config ctu-dir=%t/ctudir \
+// RUN:   -analyzer-config ctu-summary-name=summaries.txt \
+// RUN:   -verify %s
+
+// SUMMARY-DAG: c:@F@getConstant 0 42
+// SUMMARY-DAG: c:@F@getConstantOnEveryPath 0 7
+// SUMMARY-DAG: c:@F@getParameter 0 -
+// SUMMARY-DAG: c:@F@writeGlobal 1 0
+
+void clang_analyzer_eval(int);
+
+extern int g;
+int getConstant(void);
+int getConstantOnEveryPath(int);
+int getParameter(int);
+int writeGlobal(void);
+int notSummarized(void);
+
+void testConstantReturn() {
+  clang_analyzer_eval(getConstant() == 42); // expected-warning{{TRUE}}
+  clang_analyzer_eval(getConstantOnEveryPath(3) == 7);
+  // expected-warning@-1{{TRUE}}
+  clang_analyzer_eval(getParameter(3) == 3); // expected-warning{{UNKNOWN}}
+}
+
+void testNoSideEffects() {
+  g = 5;
+  getParameter(1);
+  clang_analyzer_eval(g == 5); // expected-warning{{TRUE}}
+}
+
+void testSideEffects() {
+  g = 5;
+  writeGlobal();
+  clang_analyzer_eval(g == 5); // expected-warning{{UNKNOWN}}
+}
+
+void testNoSummary() {
+  g = 5;
+  notSummarized();
+  clang_analyzer_eval(g == 5); // expected-warning{{UNKNOWN}}
+}
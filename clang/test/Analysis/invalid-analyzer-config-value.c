@@ -42,6 +42,21 @@
 // RUN:   -analyzer-config ctu-dir=0123012301230123
 
 
+// RUN: not %clang_analyze_cc1 -verify %s \
+// RUN:   -analyzer-checker=core \
+// RUN:   -analyzer-config shard-count=2 -analyzer-config shard-index=2 \
+// RUN:   2>&1 | FileCheck %s -check-prefix=CHECK-SHARD-INPUT
+
+// CHECK-SHARD-INPUT: (frontend): invalid input for analyzer-config option
+// CHECK-SHARD-INPUT-SAME:        'shard-index', that expects a less than
+// CHECK-SHARD-INPUT-SAME:        'shard-count' value
+
+// RUN: %clang_analyze_cc1 -verify %s \
+// RUN:   -analyzer-checker=core \
+// RUN:   -analyzer-config-compatibility-mode=true \
+// RUN:   -analyzer-config shard-count=2 -analyzer-config shard-index=2
+
+
 // RUN: not %clang_analyze_cc1 -verify %s \
 // RUN:   -analyzer-checker=core \
 // RUN:   -analyzer-config no-false-positives=true \
@@ -0,0 +1,6 @@
+#ifdef INCLUDE_HEADER2
+#include "header2.h"
+#endif
+
+// The body of the header is dropped by the minimizer.
+void foo();
@@ -0,0 +1,37 @@
+// RUN: rm -rf %t.dir
+// RUN: rm -rf %t.cdb
+// RUN: mkdir -p %t.dir
+// RUN: cp %s %t.dir/minimized_cdb.cpp
+// RUN: cp %s %t.dir/minimized_cdb2.cpp
+// RUN: mkdir %t.dir/Inputs
+// RUN: cp %S/Inputs/header.h %t.dir/Inputs/header.h
+// RUN: cp %S/Inputs/header2.h %t.dir/Inputs/header2.h
+// RUN: sed -e "s|DIR|%/t.dir|g" %S/Inputs/minimized_cdb.json > %t.cdb
+//
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 | \
+// RUN:   FileCheck --check-prefixes=CHECK1,CHECK2,CHECK2NO %s
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 2 | \
+// RUN:   FileCheck --check-prefix=CHECK1 %s
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 2 | \
+// RUN:   FileCheck --check-prefix=CHECK2 %s
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 -mode=preprocess | \
+// RUN:   FileCheck --check-prefixes=CHECK1,CHECK2,CHECK2NO %s
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 -format=json | \
+// RUN:   FileCheck --check-prefix=JSON %s
+
+// Both inputs share the minimized contents of 'header.h', but only the
+// second one includes 'header2.h' from it.
+
+#include "header.h"
+
+// CHECK1: minimized_cdb.cpp
+// CHECK1-NEXT: Inputs{{/|\\}}header.h
+// CHECK2NO-NOT: header2
+
+// CHECK2: minimized_cdb2.cpp
+// CHECK2-NEXT: Inputs{{/|\\}}header.h
+// CHECK2-NEXT: Inputs{{/|\\}}header2.h
+
+// JSON-NOT: Running clang-scan-deps
+// JSON: {"input":"{{.*}}minimized_cdb.cpp","directory":"{{.*}}","dependencies":["{{.*}}minimized_cdb.cpp","{{.*}}header.h"]}
+// JSON-NEXT: {"input":"{{.*}}minimized_cdb2.cpp","directory":"{{.*}}","dependencies":["{{.*}}minimized_cdb2.cpp","{{.*}}header.h","{{.*}}header2.h"]}
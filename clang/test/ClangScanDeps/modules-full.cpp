@@ -0,0 +1,33 @@
+// RUN: rm -rf %t.dir
+// RUN: rm -rf %t.cdb
+// RUN: mkdir -p %t.dir
+// RUN: cp %s %t.dir/modules_cdb_input.cpp
+// RUN: mkdir %t.dir/Inputs
+// RUN: cp %S/Inputs/header.h %t.dir/Inputs/header.h
+// RUN: cp %S/Inputs/header2.h %t.dir/Inputs/header2.h
+// RUN: cp %S/Inputs/module.modulemap %t.dir/Inputs/module.modulemap
+// RUN: sed -e "s|DIR|%/t.dir|g" %S/Inputs/modules_cdb.json > %t.cdb
+//
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 \
+// RUN:   -format=experimental-full | FileCheck %s
+// RUN: rm -rf %t.dir/module-cache
+// RUN: clang-scan-deps -compilation-database %t.cdb -j 1 -mode=preprocess \
+// RUN:   -format=experimental-full | FileCheck %s
+
+// The translation unit imports 'header1', which imports 'header2'. The
+// modules are listed after their dependencies.
+
+#include "header.h"
+
+// CHECK-NOT: Running clang-scan-deps
+// CHECK: {"input":"{{.*}}modules_cdb_input.cpp","directory":"{{.*}}","context-hash":"[[HASH:[A-Z0-9]+]]",
+// CHECK-SAME: "clang-module-deps":["header1"],
+// CHECK-SAME: "command-line":["-fno-implicit-modules","-fno-implicit-module-maps","-fmodule-map-file={{.*}}module.modulemap"],
+// CHECK-SAME: "modules":[
+// CHECK-SAME: {"name":"header2","context-hash":"[[HASH]]","module-map-file":"{{.*}}module.modulemap","clang-module-deps":[],
+// CHECK-SAME: "file-deps":[{{.*}}header2.h{{.*}}],
+// CHECK-SAME: "command-line":["-fno-implicit-modules","-fno-implicit-module-maps","-Xclang","-emit-module","-fmodule-name=header2","-x","c++","{{.*}}module.modulemap"]},
+// CHECK-SAME: {"name":"header1","context-hash":"[[HASH]]","module-map-file":"{{.*}}module.modulemap","clang-module-deps":["header2"],
+// CHECK-SAME: "file-deps":[{{.*}}header.h{{.*}}],
+// CHECK-SAME: "command-line":["-fno-implicit-modules","-fno-implicit-module-maps","-fmodule-map-file={{.*}}module.modulemap","-Xclang","-emit-module","-fmodule-name=header1","-x","c++","{{.*}}module.modulemap"]}
+// CHECK-SAME: ]}
@@ -0,0 +1,34 @@
+// RUN: %clang_cc1 -std=c++2a -triple x86_64-linux-gnu -emit-llvm -o - %s | FileCheck %s
+
+// Arrays of integers computed by the constant evaluator are emitted directly
+// from their compact representation.
+
+template<typename T, unsigned N> struct Array { T Elts[N]; };
+
+template<typename T, unsigned N> constexpr Array<T, N> iota() {
+  Array<T, N> A = {};
+  for (unsigned I = 0; I != N; ++I)
+    A.Elts[I] = I;
+  return A;
+}
+
+// CHECK: @Bytes = {{.*}}constant %struct.{{.*}} { [4 x i8] c"\00\01\02\03" }
+constexpr Array<char, 4> Bytes = iota<char, 4>();
+const Array<char, 4> *getBytes() { return &Bytes; }
+
+// CHECK: @Ints = {{.*}}constant %struct.{{.*}} { [3 x i32] [i32 0, i32 1, i32 2] }
+constexpr Array<int, 3> Ints = iota<int, 3>();
+const Array<int, 3> *getInts() { return &Ints; }
+
+// CHECK: @Bools = {{.*}}constant %struct.{{.*}} { [2 x i8] c"\00\01" }
+constexpr Array<bool, 2> Bools = iota<bool, 2>();
+const Array<bool, 2> *getBools() { return &Bools; }
+
+constexpr Array<short, 8> zeros() {
+  Array<short, 8> A = {};
+  A.Elts[3] = 0;
+  return A;
+}
+// CHECK: @Zeros = {{.*}}constant %struct.{{.*}} zeroinitializer
+constexpr Array<short, 8> Zeros = zeros();
+const Array<short, 8> *getZeros() { return &Zeros; }
@@ -0,0 +1,14 @@
+// RUN: %clang -fintegrated-cc1 -c -### %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=IN-PROCESS
+// RUN: %clang -fintegrated-cc1 -fno-integrated-cc1 -c -### %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=SPAWN
+// RUN: %clang -c -### %s 2>&1 | FileCheck %s --check-prefix=SPAWN
+
+// IN-PROCESS: (in-process)
+// IN-PROCESS-NEXT: "-cc1"
+// SPAWN-NOT: (in-process)
+
+// RUN: %clang -fintegrated-cc1 -c %s -o %t.o
+// RUN: test -f %t.o
+
+int f(void) { return 0; }
@@ -0,0 +1,24 @@
+// REQUIRES: shell
+// RUN: %clangxx -S -std=c++2a -Xclang -fconcepts-ts -ftime-trace -mllvm --time-trace-granularity=0 -o %T/check-time-trace-concepts %s
+// RUN: cat %T/check-time-trace-concepts.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   | FileCheck %s
+
+// CHECK: "traceEvents": [
+// CHECK-DAG: "name": "Total CheckConstraintSatisfaction"
+// CHECK-DAG: "name": "Total NormalizeConstraints"
+// CHECK-DAG: "name": "Total CheckConstraintSubsumption"
+// CHECK-DAG: "name": "Total InstantiateRequiresExpr"
+
+template <typename T>
+concept Small = sizeof(T) <= 4;
+
+template <typename T>
+concept SmallAndAddable = Small<T> && requires(T t) { t + t; };
+
+template <Small T> int f(T) { return 1; }
+template <SmallAndAddable T> int f(T) { return 2; }
+
+int main() {
+  return f(1);
+}
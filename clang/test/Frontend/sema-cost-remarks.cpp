@@ -0,0 +1,34 @@
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -Rsema-cost=0 %s 2>&1 | FileCheck %s --check-prefix=REMARK
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -fsema-cost-record-file=%t.yaml %s 2>&1 | count 0
+// RUN: FileCheck %s --check-prefix=YAML --input-file=%t.yaml
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -Rsema-cost=1000000000 %s 2>&1 | count 0
+// RUN: %clang -std=c++2a -fsyntax-only -Rsema-cost=100 -fsema-cost-record-file=%t.yaml %s -### 2>&1 | FileCheck %s --check-prefix=DRIVER
+
+template<typename T> struct Box { T Value; };
+Box<int> B;
+// REMARK-DAG: sema-cost-remarks.cpp:[[@LINE-1]]:{{[0-9]+}}: remark: instantiation of 'Box<int>' took {{[0-9]+}}us [-Rsema-cost]
+
+template<typename T> concept Small = sizeof(T) <= 4;
+template<Small T> void take(T);
+void callTake() { take(1); }
+// REMARK-DAG: sema-cost-remarks.cpp:[[@LINE-1]]:{{[0-9]+}}: remark: constraint satisfaction check for 'take<int>' took {{[0-9]+}}us [-Rsema-cost]
+// REMARK-DAG: sema-cost-remarks.cpp:[[@LINE-2]]:{{[0-9]+}}: remark: overload resolution for 'take' took {{[0-9]+}}us [-Rsema-cost]
+
+struct Stream {};
+Stream &operator<<(Stream &, int);
+void print(Stream &S) { S << 1; }
+// REMARK-DAG: sema-cost-remarks.cpp:[[@LINE-1]]:{{[0-9]+}}: remark: overload resolution for 'operator<<' took {{[0-9]+}}us [-Rsema-cost]
+
+// YAML: --- !Analysis
+// YAML-NEXT: Pass:{{ +}}sema-cost
+// YAML-NEXT: Name:{{ +}}Instantiation
+// YAML-NEXT: DebugLoc:{{.*}}sema-cost-remarks.cpp
+// YAML: Line: 8
+// YAML: Function:{{ +}}{{'?}}Box<int>{{'?}}
+// YAML-NEXT: Args:
+// YAML-NEXT: - Entity:{{ +}}{{'?}}Box<int>{{'?}}
+// YAML-NEXT: - Microseconds:{{ +}}'{{[0-9]+}}'
+// YAML: Name:{{ +}}OverloadResolution
+
+// DRIVER: "-Rsema-cost=100"
+// DRIVER: "-fsema-cost-record-file={{.*}}.yaml"
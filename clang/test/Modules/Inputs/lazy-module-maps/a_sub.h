@@ -0,0 +1 @@
+void a_sub(void);
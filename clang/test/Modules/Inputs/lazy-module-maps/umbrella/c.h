@@ -0,0 +1 @@
+void c(void);
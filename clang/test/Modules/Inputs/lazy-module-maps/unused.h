@@ -0,0 +1 @@
+#error "module Unused should not be built"
@@ -0,0 +1,20 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/include
+// RUN: echo 'module Foo { header "foo.h" }' > %t/include/module.modulemap
+// RUN: echo 'int foo(void);' > %t/include/foo.h
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/cache \
+// RUN:   -fmodules-content-addressed-cache -I %t/include -fsyntax-only %s
+// RUN: find %t/cache -name 'Foo-*.pcm' | count 1
+
+// Building again from the same sources reuses the module file.
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/cache \
+// RUN:   -fmodules-content-addressed-cache -I %t/include -fsyntax-only %s
+// RUN: find %t/cache -name 'Foo-*.pcm' | count 1
+
+// Changing a header of the module changes the name of its module file.
+// RUN: echo 'int foo(int);' > %t/include/foo.h
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-cache-path=%t/cache \
+// RUN:   -fmodules-content-addressed-cache -I %t/include -fsyntax-only %s
+// RUN: find %t/cache -name 'Foo-*.pcm' | count 2
+
+#include <foo.h>
@@ -0,0 +1,20 @@
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-lazy-module-maps \
+// RUN:   -fmodules-cache-path=%t -I %S/Inputs/lazy-module-maps \
+// RUN:   -fsyntax-only -verify %s
+// Check again with the index of the module map cached on disk.
+// RUN: %clang_cc1 -fmodules -fimplicit-module-maps -fmodules-lazy-module-maps \
+// RUN:   -fmodules-cache-path=%t -I %S/Inputs/lazy-module-maps \
+// RUN:   -fsyntax-only -verify %s
+// expected-no-diagnostics
+
+@import A.Sub;
+#include "b.h"
+#include "umbrella/c.h"
+
+void test() {
+  a();
+  a_sub();
+  b();
+  c();
+}
@@ -0,0 +1,4 @@
+int f(int lazy_param);
+
+#define lazy_param 42
+#define used_macro 1
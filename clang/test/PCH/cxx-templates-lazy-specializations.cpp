@@ -0,0 +1,57 @@
+// Test that specializations stored in a PCH are found when looking up a
+// single specialization, without loading all of them first.
+
+// RUN: %clang_cc1 -std=c++14 -include %s -include %s -verify %s
+//
+// RUN: %clang_cc1 -std=c++14 -emit-pch %s -o %t.1
+// RUN: %clang_cc1 -std=c++14 -include-pch %t.1 -emit-pch %s -o %t.2
+// RUN: %clang_cc1 -std=c++14 -include-pch %t.2 -verify %s
+
+#if !defined(HEADER1)
+#define HEADER1
+
+template<typename T> struct S { static constexpr int value = 1; };
+template<> struct S<char> { static constexpr int value = 2; };
+template<typename T> struct S<T*> { static constexpr int value = 3; };
+
+template<typename T> constexpr int f() { return sizeof(T); }
+template<> constexpr int f<char>() { return 42; }
+
+template<typename T> constexpr int v = 10;
+template<> constexpr int v<char> = 20;
+
+template struct S<int>;
+static_assert(S<long>::value == 1, "");
+static_assert(f<short>() == sizeof(short), "");
+static_assert(v<long> == 10, "");
+
+#elif !defined(HEADER2)
+#define HEADER2
+
+template<> struct S<unsigned> { static constexpr int value = 4; };
+template<> constexpr int f<unsigned>() { return 43; }
+template<> constexpr int v<unsigned> = 30;
+
+static_assert(S<short>::value == 1, "");
+
+#else
+
+// expected-no-diagnostics
+
+static_assert(S<char>::value == 2, "");
+static_assert(S<int>::value == 1, "");
+static_assert(S<long>::value == 1, "");
+static_assert(S<short>::value == 1, "");
+static_assert(S<unsigned>::value == 4, "");
+static_assert(S<int*>::value == 3, "");
+static_assert(S<double>::value == 1, "");
+
+static_assert(f<char>() == 42, "");
+static_assert(f<unsigned>() == 43, "");
+static_assert(f<short>() == sizeof(short), "");
+
+static_assert(v<char> == 20, "");
+static_assert(v<unsigned> == 30, "");
+static_assert(v<long> == 10, "");
+
+#endif
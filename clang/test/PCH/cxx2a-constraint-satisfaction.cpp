@@ -0,0 +1,34 @@
+// No PCH:
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -include %s -verify %s
+//
+// With PCH:
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -emit-pch %s -o %t
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -include-pch %t -verify %s
+
+#ifndef HEADER
+#define HEADER
+
+template<typename T> constexpr bool is_int = false;
+template<> constexpr bool is_int<int> = true;
+
+template<typename T> concept Integral = is_int<T>;
+
+template<Integral T> struct S { static constexpr int value = sizeof(T); };
+
+// Satisfied while building the PCH - recorded in it.
+static_assert(S<int>::value == sizeof(int));
+static_assert(Integral<int>);
+static_assert(!Integral<float>);
+
+#else /*included pch*/
+
+static_assert(S<int>::value == sizeof(int));
+static_assert(Integral<int>);
+static_assert(!Integral<float>);
+
+// Unsatisfied results are not recorded and must still be diagnosed.
+S<float> s1; // expected-error{{constraints not satisfied for class template 'S' [with T = float]}}
+// expected-note@* {{because 'float' does not satisfy 'Integral'}}
+// expected-note@* {{because 'is_int<float>' evaluated to false}}
+
+#endif // HEADER
@@ -0,0 +1,43 @@
+// Test that names declared in a large namespace are found after it is
+// extended with local declarations, and that the lookup table statistics are
+// reported.
+
+// RUN: %clang_cc1 -x c++-header -emit-pch -o %t %s
+// RUN: %clang_cc1 -include-pch %t -fsyntax-only -verify %s -print-stats 2>&1 \
+// RUN:   | FileCheck %s
+
+// expected-no-diagnostics
+
+#ifndef HEADER
+#define HEADER
+
+#define DECL4(N) int N##0, N##1, N##2, N##3;
+#define DECL16(N) DECL4(N##0) DECL4(N##1) DECL4(N##2) DECL4(N##3)
+#define DECL64(N) DECL16(N##0) DECL16(N##1) DECL16(N##2) DECL16(N##3)
+
+namespace wide {
+DECL64(a)
+DECL64(b)
+inline namespace in {
+DECL64(c)
+}
+}
+
+#else
+
+namespace wide {
+DECL64(d)
+int local;
+}
+
+int *uses[] = {&wide::a000, &wide::b333, &wide::c123, &wide::d321,
+               &wide::local};
+
+namespace wide {
+int later;
+}
+int *later = &wide::later;
+
+#endif
+
+// CHECK: {{[0-9]+}} lookup table builds, {{[0-9]+}} of them incremental, walking {{[0-9]+}} decls
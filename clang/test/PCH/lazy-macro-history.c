@@ -0,0 +1,17 @@
+// Test that macro histories of identifiers that are only read through
+// declarations are resolved when the preprocessor first needs them.
+
+// RUN: %clang_cc1 -emit-pch -o %t %S/Inputs/lazy-macro-history.h
+// RUN: %clang_cc1 -include-pch %t -fsyntax-only -verify %s -print-stats 2>&1 \
+// RUN:   | FileCheck %s
+// RUN: %clang_cc1 -include-pch %t -fsyntax-only -verify -DUSE_LAZY_PARAM %s
+
+// expected-no-diagnostics
+
+int g(void) { return f(used_macro); }
+
+#ifdef USE_LAZY_PARAM
+_Static_assert(lazy_param == 42, "deferred macro history was not resolved");
+#endif
+
+// CHECK: {{[0-9]+}}/{{[0-9]+}} deferred macro histories resolved
@@ -0,0 +1,29 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: cp %S/Inputs/header-guard-cache.h %t/guarded.h
+//
+// The first compilation records the include guard of the header.
+// RUN: %clang_cc1 -fsyntax-only -I %t -fheader-guard-cache=%t/guards %s
+// RUN: FileCheck --check-prefix=CACHE %s < %t/guards
+// CACHE: GUARDED_H {{.*}}guarded.h
+//
+// A later compilation that already defines the guard doesn't enter the header.
+// RUN: %clang_cc1 -fsyntax-only -I %t -fheader-guard-cache=%t/guards \
+// RUN:   -DGUARDED_H -print-stats %s 2>&1 | FileCheck --check-prefix=SKIP %s
+// SKIP: 1 #includes skipped due to the header guard cache.
+//
+// Without the cache, the header has to be entered to find its guard.
+// RUN: %clang_cc1 -fsyntax-only -I %t -DGUARDED_H -print-stats %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=ENTER %s
+// ENTER: 0 #includes skipped due to the header guard cache.
+//
+// Changing the header invalidates its entry.
+// RUN: echo "// changed" >> %t/guarded.h
+// RUN: %clang_cc1 -fsyntax-only -I %t -fheader-guard-cache=%t/guards \
+// RUN:   -DGUARDED_H -print-stats %s 2>&1 | FileCheck --check-prefix=ENTER %s
+//
+// RUN: %clang -### -fheader-guard-cache=%t/guards -c %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=DRIVER %s
+// DRIVER: "-fheader-guard-cache={{.*}}guards"
+
+#include "guarded.h"
@@ -0,0 +1,46 @@
+// RUN: %clang_cc1 -std=c++17 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++17 -fsyntax-only %s -print-stats -DSTATS 2>&1 | FileCheck %s
+
+// Lookups of member names in base classes are cached; check that repeated
+// lookups give the same results, including ambiguities, and that members
+// declared after a lookup are found.
+
+template<int N> struct Mixin : Mixin<N - 1> {
+  static constexpr int depth() { return N; }
+};
+template<> struct Mixin<0> {
+  int base_member = 0;
+  static constexpr int root() { return 0; }
+};
+
+struct Deep : Mixin<30> {};
+
+static_assert(Deep::depth() == 30);
+static_assert(Deep::depth() == 30);
+static_assert(Deep::root() == 0);
+
+int useDeep(Deep &D) { return D.base_member + D.base_member; }
+
+struct A { int x; }; // expected-note 2{{member found by ambiguous name lookup}}
+struct B { int x; }; // expected-note 2{{member found by ambiguous name lookup}}
+struct C : A, B {};
+
+#ifndef STATS
+int ambiguous1(C &c) { return c.x; } // expected-error {{member 'x' found in multiple base classes of different types}}
+int ambiguous2(C &c) { return c.x; } // expected-error {{member 'x' found in multiple base classes of different types}}
+#endif
+
+// The copy assignment operator of a base is declared lazily, after lookups
+// into the derived class may have been cached.
+struct Base {};
+struct Derived : Base {
+  void f(Derived &Other) { Base::operator=(Other); }
+};
+void assign(Derived &L, Derived &R) {
+  L.Base::operator=(R);
+  L = R;
+  L.operator=(R);
+}
+
+// CHECK: *** Base Class Lookup Cache Stats:
+// CHECK: {{[0-9]+}}/{{[0-9]+}} lookups found in the cache
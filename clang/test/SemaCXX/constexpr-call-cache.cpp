@@ -0,0 +1,41 @@
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -verify %s -fconstexpr-steps 100
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -verify %s -fconstexpr-steps 100 -fconstexpr-cache-limit 0
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -print-stats %s -fconstexpr-steps 100 -DSTATS 2>&1 | FileCheck %s
+
+constexpr int loop(int n) {
+  int k = 0;
+  for (int i = 0; i != n; ++i)
+    ++k; // expected-note {{step limit}}
+  return k;
+}
+
+// The second call to loop() reuses the result of the first one, but still
+// consumes as many steps.
+constexpr int twice(int n) { return loop(n) + loop(n); } // expected-note {{in call to 'loop(45)'}}
+static_assert(twice(40) == 80, "");
+#ifndef STATS
+static_assert(twice(45) == 90, ""); // expected-error {{constant expression}} expected-note {{in call to 'twice(45)'}}
+#endif
+
+// Calls whose result depends on the evaluation context are not confused.
+constexpr int context() { return __builtin_is_constant_evaluated() ? 1 : 2; }
+static_assert(context() == 1, "");
+int runtime = context();
+constexpr int viaParam(int n) { return n + context(); }
+static_assert(viaParam(1) == viaParam(1), "");
+
+// Calls that access objects from outside the call are not cached.
+struct Pair { int a, b; };
+constexpr int first(const Pair &p) { return p.a; }
+constexpr int sumFirsts() {
+  Pair p = {1, 2};
+  int n = first(p);
+  p.a = 3;
+  return n + first(p);
+}
+static_assert(sumFirsts() == 4, "");
+
+// CHECK: *** Constexpr Call Cache Stats:
+// CHECK-NEXT: {{[1-9][0-9]*}} calls cached, using about {{[0-9]+}} of 16777216 bytes
+// CHECK-NEXT: {{[1-9][0-9]*}}/{{[1-9][0-9]*}} lookups found a cached call
+// CHECK-NEXT: 0 calls not cached because of the memory limit
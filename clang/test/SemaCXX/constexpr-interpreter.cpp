@@ -0,0 +1,66 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s -fexperimental-new-constant-interpreter
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s
+
+constexpr int fib(int n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+static_assert(fib(20) == 6765, "");
+
+constexpr unsigned collatz(unsigned n) {
+  unsigned steps = 0;
+  while (n != 1) {
+    if (n % 2)
+      n = 3 * n + 1;
+    else
+      n /= 2;
+    ++steps;
+  }
+  return steps;
+}
+static_assert(collatz(27) == 111, "");
+
+constexpr long long sumSquares(int n) {
+  long long sum = 0;
+  for (int i = 1; i <= n; ++i) {
+    if (i % 10 == 0)
+      continue;
+    if (i > 1000)
+      break;
+    sum += (long long)i * i;
+  }
+  return sum;
+}
+static_assert(sumSquares(20) == 2870 - 100 - 400, "");
+static_assert(sumSquares(2000) == sumSquares(1000), "");
+
+constexpr unsigned char wrap(unsigned char c) {
+  do
+    c += 100;
+  while (c > 50);
+  return c;
+}
+static_assert(wrap(0) == 44, "");
+
+constexpr unsigned umax() { return 0u - 1; }
+static_assert(umax() == 4294967295u, "");
+
+constexpr int shl(int a, int b) { return a << b; } // expected-note {{shift count 32 >= width of type 'int'}} \
+                                                   // expected-note {{left shift of negative value -1}}
+static_assert(shl(1, 30) == 1 << 30, "");
+static_assert(shl(1, 32), ""); // expected-error {{constant expression}} expected-note {{in call to 'shl(1, 32)'}}
+static_assert(shl(-1, 1), ""); // expected-error {{constant expression}} expected-note {{in call to 'shl(-1, 1)'}}
+
+constexpr int add(int a, int b) { return a + b; } // expected-note {{value 2147483648 is outside the range of representable values of type 'int'}}
+static_assert(add(2147483646, 1) == 2147483647, "");
+static_assert(add(2147483647, 1), ""); // expected-error {{constant expression}} expected-note {{in call to 'add(2147483647, 1)'}}
+
+constexpr int divide(int a, int b) { return a / b; } // expected-note {{division by zero}}
+static_assert(divide(7, -2) == -3, "");
+static_assert(divide(1, 0), ""); // expected-error {{constant expression}} expected-note {{in call to 'divide(1, 0)'}}
+
+enum E { A = 3, B = 5 };
+constexpr E pick(bool b) { return b ? A : B; }
+static_assert(pick(false) == B, "");
+
+// Calls the interpreter does not support are evaluated as before.
+struct S { int n; constexpr int get() const { return n; } };
+constexpr int member(int n) { return S{n}.get() * 2; }
+static_assert(member(21) == 42, "");
@@ -0,0 +1,90 @@
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++2a -fsyntax-only -verify %s -fexperimental-new-constant-interpreter
+
+// Arrays of integers are stored compactly by the constant evaluator once they
+// have been modified. Check that their elements still behave as usual.
+
+template<typename T, unsigned N> struct Array {
+  T Elts[N];
+  constexpr T &operator[](unsigned I) { return Elts[I]; }
+  constexpr const T &operator[](unsigned I) const { return Elts[I]; }
+};
+
+constexpr Array<unsigned char, 4096> fillBytes() {
+  Array<unsigned char, 4096> A = {};
+  for (unsigned I = 0; I != 4096; ++I)
+    A[I] = I * 7;
+  return A;
+}
+constexpr auto Bytes = fillBytes();
+static_assert(Bytes[0] == 0);
+static_assert(Bytes[1] == 7);
+static_assert(Bytes[4095] == (unsigned char)(4095 * 7));
+
+constexpr int sumWithUpdates() {
+  int A[100] = {1, 2, 3};
+  A[50] = -5;
+  A[51] += 10;
+  ++A[52];
+  A[53]--;
+  int *P = &A[60];
+  *P = 100;
+  P[1] = *P * 2;
+  int Sum = 0;
+  for (int X : A)
+    Sum += X;
+  return Sum;
+}
+static_assert(sumWithUpdates() == 1 + 2 + 3 - 5 + 10 + 1 - 1 + 100 + 200);
+
+constexpr bool flags() {
+  bool B[64] = {};
+  B[10] = true;
+  B[20] = B[10];
+  return B[10] && B[20] && !B[30];
+}
+static_assert(flags());
+
+constexpr long long wide() {
+  long long A[10] = {-1};
+  A[9] = 0x7fffffffffffffffLL;
+  return A[0] + A[9] + A[1];
+}
+static_assert(wide() == 0x7ffffffffffffffeLL);
+
+constexpr unsigned copy() {
+  Array<unsigned, 32> A = {5};
+  A[31] = 9;
+  Array<unsigned, 32> B = A;
+  B[0] = 1;
+  return A[0] * 100 + B[0] * 10 + B[31];
+}
+static_assert(copy() == 519);
+
+constexpr int nested() {
+  int A[4][8] = {};
+  A[2][3] = 4;
+  A[3][7] = A[2][3] + 1;
+  return A[2][3] * 10 + A[3][7];
+}
+static_assert(nested() == 45);
+
+constexpr char StringLit[] = "hello";
+static_assert(StringLit[0] == 'h' && StringLit[4] == 'o' && StringLit[5] == 0);
+static_assert(u"\u1234x"[0] == 0x1234);
+static_assert(U"\U00012345"[0] == 0x12345);
+
+constexpr unsigned length(const char *S) {
+  unsigned N = 0;
+  while (S[N])
+    ++N;
+  return N;
+}
+static_assert(length("a string literal") == 16);
+
+constexpr int outOfBounds() {
+  int A[10] = {};
+  A[2] = 1;
+  return A[10]; // expected-note {{read of dereferenced one-past-the-end pointer}}
+}
+static_assert(outOfBounds()); // expected-error {{constant expression}} expected-note {{in call}}
@@ -0,0 +1,25 @@
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+template<typename T> constexpr bool is_int = false;
+template<> constexpr bool is_int<int> = true;
+
+template<typename T> concept C = is_int<T> || sizeof(T) == 1;
+
+template<C T> struct S { };
+
+S<int> s1;
+S<int> s2;
+S<char> s3;
+
+template<typename T> void f(T) requires is_int<T> && (sizeof(T) > 1) { }
+template<typename T> void f(T) { }
+
+void g() {
+  f(1.0);
+  f(1.0);
+}
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: {{[1-9][0-9]*}} atomic constraints evaluated.
+// CHECK-NEXT: {{[1-9][0-9]*}} atomic constraints skipped by short-circuiting.
+// CHECK-NEXT: {{[1-9][0-9]*}} constraint satisfaction cache hits.
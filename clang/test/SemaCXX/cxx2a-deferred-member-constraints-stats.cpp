@@ -0,0 +1,20 @@
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+template<typename T> concept Small = sizeof(T) <= 4;
+
+// Instantiating the class only declares its members; their requires-clauses
+// are substituted when a member is used.
+template<typename T> struct Adaptor {
+  void a() requires Small<T> { }
+  void b() requires (!Small<T>) { }
+  void c() requires Small<T*> { }
+};
+
+void use() {
+  Adaptor<int> A;
+  A.a();
+}
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: 3 trailing requires-clauses of instantiated functions left unsubstituted.
+// CHECK-NEXT: {{[1-9][0-9]*}} constraint checks of class template members on use.
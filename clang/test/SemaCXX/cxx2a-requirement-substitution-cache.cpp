@@ -0,0 +1,57 @@
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -verify %s
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+struct A { using type = int; int x; };
+struct B { };
+
+// The requirements only refer to T, so substituting into them is shared by
+// all specializations with the same T.
+template<typename T, typename U>
+  requires requires { typename T::type; sizeof(T) > 0; }
+constexpr int f(T, U) { return 1; }
+template<typename T, typename U>
+constexpr int f(T, U) { return 2; }
+
+static_assert(f(A{}, 1) == 1);
+static_assert(f(A{}, 1.0) == 1);
+static_assert(f(A{}, 'a') == 1);
+static_assert(f(B{}, 1) == 2);
+static_assert(f(B{}, 1.0) == 2);
+
+// Members of an enclosing template depend on its arguments even when they
+// are not named; these must not be shared.
+template<typename T> struct Outer {
+  template<typename U> static constexpr bool g() { return sizeof(T) > 1; }
+  template<typename U>
+    requires requires { requires g<U>(); }
+  static constexpr int h() { return 1; }
+  template<typename U>
+  static constexpr int h() { return 2; }
+};
+
+static_assert(Outer<char>::h<int>() == 2);
+static_assert(Outer<int>::h<int>() == 1);
+
+// Requirements referring to local parameters are not shared either.
+template<typename T, typename U>
+  requires requires (T t) { t.x; }
+constexpr int k(T, U) { return 1; }
+template<typename T, typename U>
+constexpr int k(T, U) { return 2; }
+
+static_assert(k(A{}, 1) == 1);
+static_assert(k(A{}, 1.0) == 1);
+static_assert(k(B{}, 1) == 2);
+
+template<typename T, typename U>
+  requires requires { typename T::type; }
+void unsatisfied(T, U); // expected-note 2{{candidate template ignored: constraints not satisfied [with T = B, U = }}
+// expected-note@-2 2{{because 'typename T::type' would be invalid: no type named 'type' in 'B'}}
+
+void test() {
+  unsatisfied(B{}, 1); // expected-error{{no matching function for call to 'unsatisfied'}}
+  unsatisfied(B{}, 2.0); // expected-error{{no matching function for call to 'unsatisfied'}}
+}
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: {{[1-9][0-9]*}} requirement substitution cache hits.
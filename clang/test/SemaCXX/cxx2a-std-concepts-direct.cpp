@@ -0,0 +1,44 @@
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++2a -fconcepts-ts -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+namespace std {
+template<typename T, typename U> constexpr bool is_same_v = false;
+template<typename T> constexpr bool is_same_v<T, T> = true;
+
+template<typename T> constexpr bool is_integral_v = __is_integral(T);
+template<typename T> constexpr bool is_signed_v = __is_signed(T);
+
+template<typename T, typename U>
+concept same_as = is_same_v<T, U> && is_same_v<U, T>;
+template<typename T> concept integral = is_integral_v<T>;
+template<typename T> concept signed_integral = integral<T> && is_signed_v<T>;
+template<typename T>
+concept unsigned_integral = integral<T> && !signed_integral<T>;
+} // namespace std
+
+using Int = int;
+static_assert(std::same_as<int, Int>);
+static_assert(!std::same_as<int, const int>);
+static_assert(std::integral<const bool>);
+static_assert(std::integral<wchar_t>);
+static_assert(!std::integral<int &>);
+static_assert(!std::integral<float>);
+static_assert(std::signed_integral<long>);
+static_assert(!std::signed_integral<unsigned>);
+static_assert(std::unsigned_integral<bool>);
+static_assert(!std::unsigned_integral<short>);
+
+enum E { e };
+static_assert(!std::integral<E>);
+
+template<std::integral T> void f(T) { }
+void g() {
+  f(1);
+  f(1.0); // expected-error {{no matching function for call to 'f'}}
+  // expected-note@-4 {{candidate template ignored: constraints not satisfied [with T = double]}}
+  // expected-note@-5 {{because 'double' does not satisfy 'integral'}}
+  // expected-note@13 {{because 'is_integral_v<double>' evaluated to false}}
+}
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: {{[1-9][0-9]*}} standard concepts decided without substitution.
@@ -0,0 +1,39 @@
+// RUN: %clang_cc1 -std=c++17 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++17 -fsyntax-only %s -print-stats -DSTATS 2>&1 | FileCheck %s
+
+// Function template candidates with an argument that cannot match the
+// template-id of its parameter are rejected without performing deduction;
+// check that arguments that might match are still deduced from, and that
+// rejected candidates are diagnosed as if deduction had been performed.
+
+struct Stream {};
+struct Other {};
+template<typename T> struct Box {};
+template<typename T> struct Pair {};
+template<typename T> struct Derived : Box<T> {};
+
+template<typename T> int put(Stream &, const Box<T> &); // #box
+template<typename T> long put(Stream &, Pair<T> &&); // #pair
+template<typename T> void put(Stream &, const Pair<T> &, int); // #pair3
+
+void good(Stream &S, Box<int> B, Derived<int> D) {
+  int A = put(S, B);
+  int C = put(S, D);
+  long E = put(S, Pair<char>());
+}
+
+#ifndef STATS
+void incomplete(Stream &S, Derived<long> &D) {
+  // Derived<long> is only instantiated by deduction.
+  int A = put(S, D);
+}
+
+void bad(Stream &S, Other O) {
+  put(S, O); // expected-error {{no matching function for call to 'put'}}
+  // expected-note-re@#box {{candidate template ignored: could not match 'Box<{{.*}}>' against 'Other'}}
+  // expected-note-re@#pair {{candidate template ignored: could not match 'Pair<{{.*}}>' against 'Other'}}
+  // expected-note@#pair3 {{requires 3 arguments, but 2 were provided}}
+}
+#endif
+
+// CHECK: 5 function template candidates rejected before deduction.
@@ -31,6 +31,12 @@ using namespace clang::tooling;
 
 static cl::OptionCategory ClangExtDefMapGenCategory("clang-extdefmapgen options");
 
+static cl::opt<bool>
+    PrintSummaries("summaries",
+                   cl::desc("Print the summaries of the defined functions "
+                            "instead of their locations"),
+                   cl::init(false), cl::cat(ClangExtDefMapGenCategory));
+
 class MapExtDefNamesConsumer : public ASTConsumer {
 public:
   MapExtDefNamesConsumer(ASTContext &Context)
@@ -38,7 +44,10 @@ public:
 
   ~MapExtDefNamesConsumer() {
     // Flush results to standard output.
-    llvm::outs() << createCrossTUIndexString(Index);
+    if (PrintSummaries)
+      llvm::outs() << createCallSummaryString(Summaries);
+    else
+      llvm::outs() << createCrossTUIndexString(Index);
   }
 
   void HandleTranslationUnit(ASTContext &Context) override {
@@ -52,6 +61,7 @@ private:
   ASTContext &Ctx;
   SourceManager &SM;
   llvm::StringMap<std::string> Index;
+  llvm::StringMap<CallSummary> Summaries;
   std::string CurrentFileName;
 };
 
@@ -88,8 +98,11 @@ void MapExtDefNamesConsumer::addIfInMain(const DeclaratorDecl *DD,
   case ExternalLinkage:
   case VisibleNoLinkage:
   case UniqueExternalLinkage:
-    if (SM.isInMainFile(defStart))
+    if (SM.isInMainFile(defStart)) {
       Index[LookupName] = CurrentFileName;
+      if (const auto *FD = dyn_cast<FunctionDecl>(DD))
+        Summaries[LookupName] = computeCallSummary(FD);
+    }
     break;
   default:
     break;
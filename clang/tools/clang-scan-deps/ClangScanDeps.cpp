@@ -10,11 +10,15 @@
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
 #include "clang/Tooling/JSONCompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Options.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Threading.h"
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <thread>
 
@@ -43,11 +47,15 @@ class DependencyScanningTool {
 public:
   /// Construct a dependency scanning tool.
   ///
+  /// \param Service         The shared state of the dependency scanner, e.g.
+  /// the cache of the minimized sources, that is used by all workers.
+  ///
   /// \param Compilations     The reference to the compilation database that's
   /// used by the clang tool.
-  DependencyScanningTool(const tooling::CompilationDatabase &Compilations,
+  DependencyScanningTool(DependencyScanningService &Service,
+                         const tooling::CompilationDatabase &Compilations,
                          SharedStream &OS, SharedStream &Errs)
-      : Compilations(Compilations), OS(OS), Errs(Errs) {}
+      : Worker(Service), Compilations(Compilations), OS(OS), Errs(Errs) {}
 
   /// Computes the dependencies for the given file and prints them out.
   ///
@@ -80,6 +88,37 @@ llvm::cl::opt<bool> Help("h", llvm::cl::desc("Alias for -help"),
 
 llvm::cl::OptionCategory DependencyScannerCategory("Tool options");
 
+llvm::cl::opt<ScanningMode> ScanMode(
+    "mode",
+    llvm::cl::desc("The preprocessing mode used to compute the dependencies"),
+    llvm::cl::values(
+        clEnumValN(ScanningMode::MinimizedSourcePreprocessing,
+                   "preprocess-minimized-sources",
+                   "The set of dependencies is computed by preprocessing the "
+                   "source files that were minimized to only include the "
+                   "contents that might affect the dependencies"),
+        clEnumValN(ScanningMode::CanonicalPreprocessing, "preprocess",
+                   "The set of dependencies is computed by preprocessing the "
+                   "unmodified source files")),
+    llvm::cl::init(ScanningMode::MinimizedSourcePreprocessing),
+    llvm::cl::cat(DependencyScannerCategory));
+
+llvm::cl::opt<ScanningOutputFormat> Format(
+    "format", llvm::cl::desc("The output format for the dependencies"),
+    llvm::cl::values(clEnumValN(ScanningOutputFormat::Make, "make",
+                                "Makefile compatible dep file"),
+                     clEnumValN(ScanningOutputFormat::JSON, "json",
+                                "One JSON object per line for each "
+                                "translation unit, emitted as soon as it "
+                                "is scanned"),
+                     clEnumValN(ScanningOutputFormat::Full,
+                                "experimental-full",
+                                "The JSON format, with the Clang modules "
+                                "that each translation unit needs and the "
+                                "arguments that build them")),
+    llvm::cl::init(ScanningOutputFormat::Make),
+    llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<unsigned>
     NumThreads("j", llvm::cl::Optional,
                llvm::cl::desc("Number of worker threads to use (default: use "
@@ -91,6 +130,18 @@ llvm::cl::opt<std::string>
                   llvm::cl::desc("Compilation database"), llvm::cl::Required,
                   llvm::cl::cat(DependencyScannerCategory));
 
+/// Returns the predicted cost of scanning the given input, which is the size
+/// of the main file. Inputs that can't be found are scanned last, as they
+/// usually fail quickly.
+uint64_t getPredictedCost(StringRef Input, StringRef CWD) {
+  SmallString<256> Path(Input);
+  llvm::sys::fs::make_absolute(CWD, Path);
+  uint64_t Size = 0;
+  if (llvm::sys::fs::file_size(Path, Size))
+    return 0;
+  return Size;
+}
+
 } // end anonymous namespace
 
 int main(int argc, const char **argv) {
@@ -138,38 +189,58 @@ int main(int argc, const char **argv) {
   SharedStream DependencyOS(llvm::outs());
   unsigned NumWorkers =
       NumThreads == 0 ? llvm::hardware_concurrency() : NumThreads;
+  // The service is shared by all workers, so each file is read and minimized
+  // at most once per process.
+  DependencyScanningService Service(ScanMode, Format);
   std::vector<std::unique_ptr<DependencyScanningTool>> WorkerTools;
   for (unsigned I = 0; I < NumWorkers; ++I)
     WorkerTools.push_back(llvm::make_unique<DependencyScanningTool>(
-        *AdjustingCompilations, DependencyOS, Errs));
+        Service, *AdjustingCompilations, DependencyOS, Errs));
+
+  // Schedule the most expensive inputs first, so that a large translation
+  // unit that is picked up last doesn't leave the other workers idle at the
+  // end of the run.
+  if (NumWorkers > 1) {
+    std::vector<uint64_t> Costs;
+    Costs.reserve(Inputs.size());
+    for (const auto &Input : Inputs)
+      Costs.push_back(getPredictedCost(Input.first, Input.second));
+    std::vector<size_t> Order(Inputs.size());
+    for (size_t I = 0, E = Order.size(); I != E; ++I)
+      Order[I] = I;
+    std::stable_sort(Order.begin(), Order.end(), [&](size_t LHS, size_t RHS) {
+      return Costs[LHS] > Costs[RHS];
+    });
+    std::vector<std::pair<std::string, std::string>> SortedInputs;
+    SortedInputs.reserve(Inputs.size());
+    for (size_t I : Order)
+      SortedInputs.push_back(std::move(Inputs[I]));
+    Inputs = std::move(SortedInputs);
+  }
 
   std::vector<std::thread> WorkerThreads;
   std::atomic<bool> HadErrors(false);
-  std::mutex Lock;
-  size_t Index = 0;
+  // Each worker takes the next unclaimed input when it becomes idle. The
+  // results are written out as soon as each input has been scanned.
+  std::atomic<size_t> Index(0);
 
-  llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
-               << " files using " << NumWorkers << " workers\n";
+  if (Format == ScanningOutputFormat::Make)
+    llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
+                 << " files using " << NumWorkers << " workers\n";
   for (unsigned I = 0; I < NumWorkers; ++I) {
-    WorkerThreads.emplace_back(
-        [I, &Lock, &Index, &Inputs, &HadErrors, &WorkerTools]() {
-          while (true) {
-            std::string Input;
-            StringRef CWD;
-            // Take the next input.
-            {
-              std::unique_lock<std::mutex> LockGuard(Lock);
-              if (Index >= Inputs.size())
-                return;
-              const auto &Compilation = Inputs[Index++];
-              Input = Compilation.first;
-              CWD = Compilation.second;
-            }
-            // Run the tool on it.
-            if (WorkerTools[I]->runOnFile(Input, CWD))
-              HadErrors = true;
-          }
-        });
+    WorkerThreads.emplace_back([I, &Index, &Inputs, &HadErrors,
+                                &WorkerTools]() {
+      while (true) {
+        // Take the next input.
+        size_t Next = Index++;
+        if (Next >= Inputs.size())
+          return;
+        const auto &Compilation = Inputs[Next];
+        // Run the tool on it.
+        if (WorkerTools[I]->runOnFile(Compilation.first, Compilation.second))
+          HadErrors = true;
+      }
+    });
   }
   for (auto &W : WorkerThreads)
     W.join();
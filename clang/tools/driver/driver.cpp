@@ -318,6 +318,13 @@ static int ExecuteCC1Tool(ArrayRef<const char *> argv, StringRef Tool) {
   return 1;
 }
 
+static int ExecuteCC1ToolInProcess(SmallVectorImpl<const char *> &ArgV) {
+  // The options are global and might have been used by the driver or by a
+  // previous cc1 job of the same compilation.
+  llvm::cl::ResetAllOptionOccurrences();
+  return ExecuteCC1Tool(ArgV, ArgV[1] + 4);
+}
+
 int main(int argc_, const char **argv_) {
   llvm::InitLLVM X(argc_, argv_);
   SmallVector<const char *, 256> argv(argv_, argv_ + argc_);
@@ -452,6 +459,20 @@ int main(int argc_, const char **argv_) {
 
   insertTargetAndModeArgs(TargetAndMode, argv, SavedStrings);
 
+  // Run the cc1 jobs in this process if requested, which saves starting a
+  // new process and initializing it for every job.
+  bool InProcessCC1 = false;
+  for (const char *A : argv) {
+    if (!A)
+      continue;
+    if (StringRef(A) == "-fintegrated-cc1")
+      InProcessCC1 = true;
+    else if (StringRef(A) == "-fno-integrated-cc1")
+      InProcessCC1 = false;
+  }
+  if (InProcessCC1)
+    TheDriver.CC1Main = &ExecuteCC1ToolInProcess;
+
   SetBackdoorDriverOutputsFromEnvVars(TheDriver);
 
   std::unique_ptr<Compilation> C(TheDriver.BuildCompilation(argv));
@@ -10,10 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclTemplate.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include "clang/Frontend/ASTUnit.h"
 #include "clang/Tooling/Tooling.h"
 #include "gtest/gtest.h"
 
+using namespace clang;
 using namespace clang::ast_matchers;
 using namespace clang::tooling;
 
@@ -56,3 +61,36 @@ TEST(Decl, CleansUpAPValues) {
       "constexpr _Complex __uint128_t c = 0xffffffffffffffff;",
       Args));
 }
+
+TEST(Decl, UniquesCanonicalTemplateArgumentLists) {
+  std::unique_ptr<ASTUnit> AST = buildASTFromCodeWithArgs(
+      "typedef int Int;"
+      "template<typename T> struct S {};"
+      "S<int> a; S<Int> b;",
+      {"-std=c++11"});
+  ASSERT_TRUE(AST.get());
+  ASTContext &Ctx = AST->getASTContext();
+
+  TemplateArgument IntArg(Ctx.IntTy);
+  const TemplateArgumentList *List = Ctx.getUniquedTemplateArgumentList(IntArg);
+  EXPECT_TRUE(List->isUniqued());
+  EXPECT_EQ(List, Ctx.getUniquedTemplateArgumentList(IntArg));
+
+  // The specialization S<int>, spelled either way, shares the list.
+  auto Specs = match(classTemplateSpecializationDecl().bind("S"), Ctx);
+  ASSERT_EQ(Specs.size(), 1u);
+  EXPECT_EQ(&Specs[0]
+                 .getNodeAs<ClassTemplateSpecializationDecl>("S")
+                 ->getTemplateArgs(),
+            List);
+
+  // Lists of arguments that are not canonical are copied.
+  auto Typedefs = match(typedefDecl().bind("T"), Ctx);
+  ASSERT_EQ(Typedefs.size(), 1u);
+  TemplateArgument TypedefArg(
+      Ctx.getTypedefType(Typedefs[0].getNodeAs<TypedefDecl>("T")));
+  const TemplateArgumentList *Copy =
+      Ctx.getUniquedTemplateArgumentList(TypedefArg);
+  EXPECT_FALSE(Copy->isUniqued());
+  EXPECT_NE(Copy, Ctx.getUniquedTemplateArgumentList(TypedefArg));
+}
@@ -118,6 +118,43 @@ TEST(MatchFinder, CheckProfiling) {
   EXPECT_EQ("MyID", Records.begin()->getKey());
 }
 
+TEST(MatchFinder, RunsNameIndexedMatchersInOrder) {
+  struct RecordingCallback : public MatchFinder::MatchCallback {
+    RecordingCallback(std::vector<std::string> &Matches, StringRef ID)
+        : Matches(Matches), ID(ID) {}
+    void run(const MatchFinder::MatchResult &Result) override {
+      Matches.push_back(
+          (ID + ":" +
+           Result.Nodes.getNodeAs<NamedDecl>("n")->getNameAsString())
+              .str());
+    }
+    std::vector<std::string> &Matches;
+    StringRef ID;
+  };
+  std::vector<std::string> Matches;
+  RecordingCallback A(Matches, "A"), B(Matches, "B"), C(Matches, "C"),
+      D(Matches, "D"), E(Matches, "E");
+  MatchFinder Finder;
+  Finder.addMatcher(functionDecl(hasName("::ns::f")).bind("n"), &A);
+  Finder.addMatcher(functionDecl(hasAnyName("g", "f")).bind("n"), &B);
+  Finder.addMatcher(decl(anyOf(namedDecl(hasName("g")),
+                               functionDecl(hasName("operator+"))))
+                        .bind("n"),
+                    &C);
+  Finder.addMatcher(functionDecl().bind("n"), &D);
+  Finder.addMatcher(functionDecl(hasName("operator+")).bind("n"), &E);
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  ASSERT_TRUE(tooling::runToolOnCode(
+      Factory->create(),
+      "namespace ns { void f(); } void g(); struct S {}; "
+      "bool operator+(S, S);"));
+  std::vector<std::string> Expected = {
+      "A:f", "B:f", "D:f", "B:g", "C:g", "D:g",
+      "C:operator+", "D:operator+", "E:operator+"};
+  EXPECT_EQ(Expected, Matches);
+}
+
 class VerifyStartOfTranslationUnit : public MatchFinder::MatchCallback {
 public:
   VerifyStartOfTranslationUnit() : Called(false) {}
@@ -10,6 +10,7 @@
 #include "clang/Basic/FileSystemOptions.h"
 #include "clang/Basic/FileSystemStatCache.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "gtest/gtest.h"
@@ -379,4 +380,56 @@ TEST_F(FileManagerTest, getFileDontOpenRealPath) {
   EXPECT_EQ(file->tryGetRealPathName(), ExpectedResult);
 }
 
+// A file system that records the paths that are looked up in it.
+class RecordingFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+  RecordingFileSystem(IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override {
+    LookedUp.push_back(Path.str());
+    return ProxyFileSystem::status(Path);
+  }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    LookedUp.push_back(Path.str());
+    return ProxyFileSystem::openFileForRead(Path);
+  }
+
+  bool wasLookedUp(StringRef Path) const {
+    return llvm::is_contained(LookedUp, Path);
+  }
+
+private:
+  std::vector<std::string> LookedUp;
+};
+
+TEST_F(FileManagerTest, cacheDirectoryListingsAnswersMissingEntries) {
+  auto InMemoryFS = IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem>(
+      new llvm::vfs::InMemoryFileSystem);
+  InMemoryFS->addFile("/include/a.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("int a;"));
+  auto FS = IntrusiveRefCntPtr<RecordingFileSystem>(
+      new RecordingFileSystem(InMemoryFS));
+
+  FileSystemOptions Opts;
+  Opts.CacheDirectoryListings = true;
+  FileManager Manager(Opts, FS);
+
+  // Missing entries are answered from the listing of their directory.
+  EXPECT_EQ(nullptr, Manager.getFile("/include/b.h"));
+  EXPECT_FALSE(FS->wasLookedUp("/include/b.h"));
+  EXPECT_EQ(nullptr, Manager.getDirectory("/include/sys"));
+  EXPECT_FALSE(FS->wasLookedUp("/include/sys"));
+  EXPECT_EQ(nullptr, Manager.getFile("/missing/c.h"));
+  EXPECT_FALSE(FS->wasLookedUp("/missing/c.h"));
+
+  // Entries that do exist are still looked up in the file system.
+  const FileEntry *File = Manager.getFile("/include/a.h");
+  ASSERT_TRUE(File != nullptr);
+  EXPECT_EQ(6, File->getSize());
+  EXPECT_TRUE(FS->wasLookedUp("/include/a.h"));
+}
+
 } // anonymous namespace
@@ -152,6 +152,37 @@ TEST_F(SourceManagerTest, getColumnNumber) {
   EXPECT_EQ(1U, SourceMgr.getColumnNumber(MainFileID, 0, nullptr));
 }
 
+TEST_F(SourceManagerTest, getFileIDWithManyExpansions) {
+  const char *Source =
+    "int x;\n"
+    "int y;";
+
+  std::unique_ptr<llvm::MemoryBuffer> Buf =
+      llvm::MemoryBuffer::getMemBuffer(Source);
+  FileID MainFileID = SourceMgr.createFileID(std::move(Buf));
+  SourceMgr.setMainFileID(MainFileID);
+  SourceLocation MainLoc = SourceMgr.getLocForStartOfFile(MainFileID);
+
+  // Create enough entries to span several blocks of the lookup index.
+  std::vector<SourceLocation> Expansions;
+  for (unsigned I = 0; I != 300; ++I)
+    Expansions.push_back(SourceMgr.createExpansionLoc(
+        MainLoc.getLocWithOffset(I % 6), MainLoc, MainLoc, 3));
+
+  // Look the entries up in an order that defeats the linear scans.
+  for (unsigned I = 0; I != 300; ++I) {
+    unsigned J = (I * 97) % 300;
+    SourceLocation Loc = Expansions[J].getLocWithOffset(J % 3);
+    std::pair<FileID, unsigned> Decomposed = SourceMgr.getDecomposedLoc(Loc);
+    EXPECT_EQ(SourceMgr.getFileID(Expansions[J]), Decomposed.first);
+    EXPECT_EQ(J % 3, Decomposed.second);
+    EXPECT_EQ(MainLoc.getLocWithOffset(J % 6),
+              SourceMgr.getSpellingLoc(Expansions[J]));
+    EXPECT_EQ(MainFileID,
+              SourceMgr.getFileID(MainLoc.getLocWithOffset(J % 13)));
+  }
+}
+
 TEST_F(SourceManagerTest, locationPrintTest) {
   const char *header = "#define IDENTITY(x) x\n";
 
@@ -166,5 +166,34 @@ TEST(CrossTranslationUnit, CTUDirIsHandledCorrectly) {
   EXPECT_EQ(ParsedIndex["a"], "/ctudir/b/c/d");
 }
 
+TEST(CrossTranslationUnit, CallSummaryFormatCanBeParsed) {
+  llvm::StringMap<CallSummary> Summaries;
+  Summaries["a"].MayHaveSideEffects = false;
+  Summaries["a"].ReturnValue = -42;
+  Summaries["b c"].MayHaveSideEffects = true;
+  Summaries["d"].MayHaveSideEffects = false;
+  std::string SummaryText = createCallSummaryString(Summaries);
+
+  int SummaryFD;
+  llvm::SmallString<256> SummaryFileName;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("summary", "txt", SummaryFD,
+                                                  SummaryFileName));
+  llvm::ToolOutputFile SummaryFile(SummaryFileName, SummaryFD);
+  SummaryFile.os() << SummaryText;
+  SummaryFile.os().flush();
+  EXPECT_TRUE(llvm::sys::fs::exists(SummaryFileName));
+  llvm::Expected<llvm::StringMap<CallSummary>> SummariesOrErr =
+      parseCallSummaries(SummaryFileName);
+  EXPECT_TRUE((bool)SummariesOrErr);
+  llvm::StringMap<CallSummary> ParsedSummaries = SummariesOrErr.get();
+  EXPECT_EQ(ParsedSummaries.size(), Summaries.size());
+  for (const auto &E : Summaries) {
+    ASSERT_TRUE(ParsedSummaries.count(E.getKey()));
+    const CallSummary &Parsed = ParsedSummaries[E.getKey()];
+    EXPECT_EQ(Parsed.MayHaveSideEffects, E.getValue().MayHaveSideEffects);
+    EXPECT_EQ(Parsed.ReturnValue, E.getValue().ReturnValue);
+  }
+}
+
 } // end namespace cross_tu
 } // end namespace clang
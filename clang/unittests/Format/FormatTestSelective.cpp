@@ -603,6 +603,54 @@ TEST_F(FormatTestSelective, KeepsIndentAfterCommentSectionImport) {
   EXPECT_EQ(Code, format(Code, 47, 1));
 }
 
+TEST_F(FormatTestSelective, FormatsOnlyDeclarationsAroundRanges) {
+  std::string Code = "namespace n {\n"
+                     "int  a;\n"
+                     "\n"
+                     "int  b;\n"
+                     "int  c;\n"
+                     "\n"
+                     "int  d;\n"
+                     "} // namespace n\n";
+  EXPECT_EQ("namespace n {\n"
+            "int  a;\n"
+            "\n"
+            "int  b;\n"
+            "int c;\n"
+            "\n"
+            "int  d;\n"
+            "} // namespace n\n",
+            format(Code, 33, 0));
+
+  Style.AlignConsecutiveDeclarations = true;
+  EXPECT_EQ("int a;\n"
+            "\n"
+            "int  b;\n"
+            "long c;\n"
+            "\n"
+            "int d;",
+            format("int a;\n"
+                   "\n"
+                   "int b;\n"
+                   "long   c;\n"
+                   "\n"
+                   "int d;",
+                   8, 10));
+
+  // Code in disabled regions stays untouched.
+  EXPECT_EQ("// clang-format off\n"
+            "int  a;\n"
+            "\n"
+            "int  b;\n"
+            "// clang-format on\n",
+            format("// clang-format off\n"
+                   "int  a;\n"
+                   "\n"
+                   "int  b;\n"
+                   "// clang-format on\n",
+                   29, 0));
+}
+
 } // end namespace
 } // end namespace format
 } // end namespace clang
@@ -11,13 +11,16 @@
 #include "clang/AST/Decl.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/ASTUnit.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Index/IndexDataConsumer.h"
 #include "clang/Index/IndexSymbol.h"
 #include "clang/Index/IndexingAction.h"
+#include "clang/Index/USRGeneration.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/VirtualFileSystem.h"
 #include "gmock/gmock.h"
@@ -292,6 +295,30 @@ TEST(IndexTest, Constructors) {
                 WrittenAt(Position(4, 8)))));
 }
 
+TEST(USRCacheTest, MatchesGeneratedUSRs) {
+  std::unique_ptr<ASTUnit> AST = tooling::buildASTFromCode(R"cpp(
+    namespace ns { struct S { void method(); }; }
+    static void internal();
+    static void internal() {}
+  )cpp");
+  ASSERT_TRUE(AST);
+  ASTContext &Ctx = AST->getASTContext();
+
+  USRCache Cache;
+  for (const Decl *D : Ctx.getTranslationUnitDecl()->decls()) {
+    SmallString<128> Expected;
+    bool Ignored = generateUSRForDecl(D, Expected);
+    Optional<StringRef> USR = Cache.getUSRForDecl(D);
+    EXPECT_EQ(Ignored, !USR.hasValue());
+    if (USR) {
+      EXPECT_EQ(Expected, *USR);
+      // The second lookup returns the cached string.
+      EXPECT_EQ(USR->data(), Cache.getUSRForDecl(D)->data());
+    }
+  }
+  EXPECT_FALSE(Cache.getUSRForDecl(nullptr));
+}
+
 } // namespace
 } // namespace index
 } // namespace clang
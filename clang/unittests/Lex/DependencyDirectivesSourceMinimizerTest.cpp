@@ -568,4 +568,55 @@ TEST(MinimizeSourceToDependencyDirectivesTest, PragmaOnce) {
   EXPECT_STREQ("#pragma once\n#include <test.h>\n", Out.data());
 }
 
+TEST(MinimizeSourceToDependencyDirectivesTest, SkippedPPRangesBasic) {
+  SmallString<128> Out;
+  SmallVector<Token, 32> Toks;
+  StringRef Source = "#ifndef GUARD\n"
+                     "#define GUARD\n"
+                     "void foo();\n"
+                     "#endif // GUARD\n";
+  ASSERT_FALSE(minimizeSourceToDependencyDirectives(Source, Out, Toks));
+  SmallVector<SkippedRange, 4> Ranges;
+  ASSERT_FALSE(computeSkippedRanges(Toks, Ranges));
+  EXPECT_EQ(Ranges.size(), 1u);
+  EXPECT_EQ(Ranges[0].Offset, 0);
+  EXPECT_EQ(Ranges[0].Length, (int)Out.find("#endif"));
+}
+
+TEST(MinimizeSourceToDependencyDirectivesTest, SkippedPPRangesNested) {
+  SmallString<128> Out;
+  SmallVector<Token, 32> Toks;
+  StringRef Source = "#if A\n"
+                     "#if B\n"
+                     "#define X\n"
+                     "#endif\n"
+                     "#else\n"
+                     "#define Y\n"
+                     "#endif\n";
+  ASSERT_FALSE(minimizeSourceToDependencyDirectives(Source, Out, Toks));
+  EXPECT_STREQ(Source.data(), Out.data());
+  SmallVector<SkippedRange, 4> Ranges;
+  ASSERT_FALSE(computeSkippedRanges(Toks, Ranges));
+  ASSERT_EQ(Ranges.size(), 3u);
+  // #if B ... #endif
+  EXPECT_EQ(Ranges[0].Offset, 6);
+  EXPECT_EQ(Ranges[0].Length, 16);
+  // #if A ... #else
+  EXPECT_EQ(Ranges[1].Offset, 0);
+  EXPECT_EQ(Ranges[1].Length, 29);
+  // #else ... #endif
+  EXPECT_EQ(Ranges[2].Offset, 29);
+  EXPECT_EQ(Ranges[2].Length, 16);
+}
+
+TEST(MinimizeSourceToDependencyDirectivesTest, SkippedPPRangesUnbalanced) {
+  SmallString<128> Out;
+  SmallVector<Token, 32> Toks;
+  StringRef Source = "#define X\n"
+                     "#endif\n";
+  ASSERT_FALSE(minimizeSourceToDependencyDirectives(Source, Out, Toks));
+  SmallVector<SkippedRange, 4> Ranges;
+  EXPECT_TRUE(computeSkippedRanges(Toks, Ranges));
+}
+
 } // end anonymous namespace
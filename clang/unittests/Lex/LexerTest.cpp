@@ -532,4 +532,44 @@ TEST_F(LexerTest, CharRangeOffByOne) {
   EXPECT_EQ(Lexer::getSourceText(CR, SourceMgr, LangOpts), "MOO"); // Was "MO".
 }
 
+TEST_F(LexerTest, LongCharacterRuns) {
+  // Identifiers, whitespace and line comments of lengths around the widths
+  // the lexer scans at once, including ones that run up to the end of the
+  // buffer.
+  std::string Source;
+  std::vector<std::string> Names;
+  for (unsigned Len = 1; Len != 40; ++Len) {
+    std::string Name(Len, 'a');
+    for (unsigned I = 0; I != Len; ++I)
+      Name[I] = "_abyzABYZ0189"[(I + Len) % 13];
+    Name[0] = Len % 2 ? 'x' : '_';
+    Names.push_back(Name);
+    Source += Name;
+    Source += std::string(1 + Len % 19, Len % 3 ? ' ' : '\t');
+    if (Len % 4 == 0)
+      Source += "//" + std::string(Len, '*') + "\n";
+    else if (Len % 4 == 1)
+      Source += "\f\v\n";
+  }
+  Names.push_back(std::string(33, 'z'));
+  Source += Names.back();
+
+  std::vector<Token> Toks = Lex(Source);
+  ASSERT_EQ(Names.size(), Toks.size());
+  for (unsigned I = 0, E = Toks.size(); I != E; ++I) {
+    ASSERT_TRUE(Toks[I].is(tok::identifier));
+    EXPECT_EQ(Names[I], Toks[I].getIdentifierInfo()->getName());
+    unsigned Len = I;
+    if (I != 0) {
+      bool AfterNewline = Len % 4 == 0 || Len % 4 == 1;
+      EXPECT_EQ(AfterNewline, Toks[I].isAtStartOfLine());
+      EXPECT_EQ(!AfterNewline, Toks[I].hasLeadingSpace());
+    }
+  }
+
+  Toks = Lex("int x; // " + std::string(100, 'c'));
+  ASSERT_EQ(3u, Toks.size());
+  EXPECT_TRUE(Toks[2].is(tok::semi));
+}
+
 } // anonymous namespace
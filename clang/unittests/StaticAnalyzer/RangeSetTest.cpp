@@ -0,0 +1,79 @@
+//===- unittests/StaticAnalyzer/RangeSetTest.cpp --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/StaticAnalyzer/Core/PathSensitive/RangedConstraintManager.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Tooling/Tooling.h"
+#include "gtest/gtest.h"
+
+namespace clang {
+namespace ento {
+namespace {
+
+class RangeSetTest : public testing::Test {
+protected:
+  std::unique_ptr<ASTUnit> AST = tooling::buildASTFromCode("");
+  llvm::BumpPtrAllocator Arena;
+  BasicValueFactory BVF{AST->getASTContext(), Arena};
+  RangeSet::Factory F;
+
+  const llvm::APSInt &from(int64_t X) {
+    return BVF.getValue(llvm::APSInt(llvm::APInt(8, X, /*isSigned=*/true),
+                                     /*isUnsigned=*/false));
+  }
+
+  RangeSet range(int64_t From, int64_t To) {
+    return RangeSet(F, from(From), from(To));
+  }
+
+  void checkRanges(const RangeSet &RS,
+                   ArrayRef<std::pair<int64_t, int64_t>> Expected) {
+    ASSERT_EQ(static_cast<size_t>(RS.end() - RS.begin()), Expected.size());
+    for (unsigned I = 0; I < Expected.size(); ++I) {
+      EXPECT_EQ(RS.begin()[I].From(), Expected[I].first);
+      EXPECT_EQ(RS.begin()[I].To(), Expected[I].second);
+    }
+  }
+};
+
+TEST_F(RangeSetTest, EqualSetsShareStorage) {
+  RangeSet A = range(1, 5).addRange(F, range(10, 20));
+  RangeSet B = range(10, 20).addRange(F, range(1, 5));
+  EXPECT_TRUE(A == B);
+  EXPECT_FALSE(A == range(1, 5));
+  EXPECT_TRUE(F.getEmptySet().isEmpty());
+}
+
+TEST_F(RangeSetTest, IntersectRange) {
+  RangeSet RS = range(-100, -50).addRange(F, range(0, 10));
+  checkRanges(RS.Intersect(BVF, F, from(-60), from(5)), {{-60, -50}, {0, 5}});
+  // A wrapped range removes the values between its bounds.
+  checkRanges(RS.Intersect(BVF, F, from(5), from(-60)),
+              {{-100, -60}, {5, 10}});
+  EXPECT_TRUE(RS.Intersect(BVF, F, from(-128), from(127)) == RS);
+  EXPECT_TRUE(RS.Intersect(BVF, F, from(20), from(30)).isEmpty());
+}
+
+TEST_F(RangeSetTest, IntersectRangeSet) {
+  RangeSet LHS = range(-100, -50).addRange(F, range(0, 10));
+  RangeSet RHS = range(-70, 5).addRange(F, range(8, 100));
+  checkRanges(LHS.Intersect(BVF, F, RHS), {{-70, -50}, {0, 5}, {8, 10}});
+  EXPECT_TRUE(LHS.Intersect(BVF, F, RHS) == RHS.Intersect(BVF, F, LHS));
+  EXPECT_TRUE(LHS.Intersect(BVF, F, F.getEmptySet()).isEmpty());
+}
+
+TEST_F(RangeSetTest, Negate) {
+  checkRanges(range(-128, -100).addRange(F, range(1, 127)).Negate(BVF, F),
+              {{-128, -1}, {100, 127}});
+  checkRanges(range(-128, 10).Negate(BVF, F), {{-128, -128}, {-10, 127}});
+  checkRanges(range(3, 5).Negate(BVF, F), {{-5, -3}});
+}
+
+} // namespace
+} // namespace ento
+} // namespace clang
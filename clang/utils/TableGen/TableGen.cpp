@@ -312,7 +312,7 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &ClangTableGenMain);
+  return TableGenMain(argv[0], &ClangTableGenMain, makeArrayRef(argv, argc));
 }
 
 #ifdef __has_feature
@@ -109,6 +109,8 @@ void AppendToErrorMessageBuffer(const char *buffer);
 void *AsanDlSymNext(const char *sym);
 
 void ReserveShadowMemoryRange(uptr beg, uptr end, const char *name);
+// Returns the shadow of the application memory that is not mapped to the OS.
+void ReleaseShadowOfUnmappedMemory();
 
 // Returns `true` iff most of ASan init process should be skipped due to the
 // ASan library being loaded via `dlopen()`. Platforms may perform any
@@ -37,6 +37,41 @@ void AsanOnDeadlySignal(int signo, void *siginfo, void *context) {
   ReportDeadlySignal(sig);
 }
 
+// ---------------------- Shadow release ---------------- {{{1
+
+// Releases the shadow pages that only cover [beg, end] within the
+// application memory range [mem_beg, mem_end].
+static void ReleaseShadowOfRange(uptr beg, uptr end, uptr mem_beg,
+                                 uptr mem_end) {
+  beg = Max(beg, mem_beg);
+  end = Min(end, mem_end);
+  if (beg > end) return;
+  // ReleaseMemoryPagesToOS keeps the pages shared with the shadow of the
+  // mapped neighbours.
+  ReleaseMemoryPagesToOS(MEM_TO_SHADOW(beg), MEM_TO_SHADOW(end) + 1);
+}
+
+static void ReleaseShadowOfHole(uptr beg, uptr end) {
+  ReleaseShadowOfRange(beg, end, kLowMemBeg, kLowMemEnd);
+  if (kMidMemBeg) ReleaseShadowOfRange(beg, end, kMidMemBeg, kMidMemEnd);
+  if (kHighMemBeg) ReleaseShadowOfRange(beg, end, kHighMemBeg, kHighMemEnd);
+}
+
+void ReleaseShadowOfUnmappedMemory() {
+  // The shadow of the memory unmapped by the application keeps whatever it
+  // was poisoned with, so its pages stay resident until released here.
+  MemoryMappingLayout proc_maps(/*cache_enabled*/false);
+  MemoryMappedSegment segment;
+  uptr hole_beg = 0;
+  while (proc_maps.Next(&segment)) {
+    if (segment.start > hole_beg)
+      ReleaseShadowOfHole(hole_beg, segment.start - 1);
+    hole_beg = Max(hole_beg, segment.end);
+  }
+  if (hole_beg <= kHighMemEnd)
+    ReleaseShadowOfHole(hole_beg, kHighMemEnd);
+}
+
 // ---------------------- TSD ---------------- {{{1
 
 #if SANITIZER_NETBSD || SANITIZER_FREEBSD
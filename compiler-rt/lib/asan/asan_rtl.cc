@@ -386,8 +386,17 @@ void PrintAddressSpaceLayout() {
 #define START_BACKGROUND_THREAD_IN_ASAN_INTERNAL
 #endif
 
+static void MaybeReleaseShadowInBackground() {
+#if SANITIZER_POSIX
+  if (flags()->release_unmapped_shadow_interval_ms >= 0)
+    SetReleaseShadowCallback(ReleaseShadowOfUnmappedMemory,
+                             flags()->release_unmapped_shadow_interval_ms);
+#endif
+}
+
 #ifndef START_BACKGROUND_THREAD_IN_ASAN_INTERNAL
 static bool UNUSED __local_asan_dyninit = [] {
+  MaybeReleaseShadowInBackground();
   MaybeStartBackgroudThread();
   SetSoftRssLimitExceededCallback(AsanSoftRssLimitExceededCallback);
 
@@ -470,6 +479,7 @@ static void AsanInitInternal() {
   InitializeAllocator(allocator_options);
 
 #ifdef START_BACKGROUND_THREAD_IN_ASAN_INTERNAL
+  MaybeReleaseShadowInBackground();
   MaybeStartBackgroudThread();
   SetSoftRssLimitExceededCallback(AsanSoftRssLimitExceededCallback);
 #endif
@@ -17,6 +17,7 @@
 // InitializeShadowMemory implementation.
 #if !SANITIZER_FUCHSIA && !SANITIZER_RTEMS
 
+#include "asan_allocator.h"
 #include "asan_internal.h"
 #include "asan_mapping.h"
 
@@ -80,6 +81,22 @@ static void ProtectGap(uptr addr, uptr size) {
   Die();
 }
 
+// The shadow of the heap is the hottest part of the shadow, let it use huge
+// pages to spare the TLB. The rest of the shadow keeps small pages, so that
+// releasing parts of it does not split huge pages.
+static void MaybeUseHugePagesForHeapShadow() {
+  if (!flags()->huge_pages_for_heap_shadow) return;
+#if SANITIZER_CAN_USE_ALLOCATOR64
+  if (kAllocatorSpace == ~(uptr)0) return;  // Placed by the allocator later.
+  uptr page_size = GetPageSizeCached();
+  uptr beg = RoundDownTo(MEM_TO_SHADOW(kAllocatorSpace), page_size);
+  uptr end = RoundUpTo(MEM_TO_SHADOW(kAllocatorSpace + kAllocatorSize - 1) + 1,
+                       page_size);
+  if (!HugePagesInRegion(beg, end - beg))
+    VReport(1, "Failed to enable huge pages for the heap shadow\n");
+#endif
+}
+
 static void MaybeReportLinuxPIEBug() {
 #if SANITIZER_LINUX && (defined(__x86_64__) || defined(__aarch64__))
   Report("This might be related to ELF_ET_DYN_BASE change in Linux 4.12.\n");
@@ -157,6 +174,7 @@ void InitializeShadowMemory() {
     DumpProcessMap();
     Die();
   }
+  MaybeUseHugePagesForHeapShadow();
 }
 
 }  // namespace __asan
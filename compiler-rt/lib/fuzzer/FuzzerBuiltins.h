@@ -27,6 +27,7 @@ inline uint64_t Bswap(uint64_t x) { return __builtin_bswap64(x); }
 
 inline uint32_t Clzll(unsigned long long X) { return __builtin_clzll(X); }
 inline uint32_t Clz(unsigned long long X) { return __builtin_clz(X); }
+inline uint32_t Ctzll(unsigned long long X) { return __builtin_ctzll(X); }
 inline int Popcountll(unsigned long long X) { return __builtin_popcountll(X); }
 
 }  // namespace fuzzer
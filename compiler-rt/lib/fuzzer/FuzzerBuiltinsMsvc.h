@@ -50,6 +50,12 @@ inline uint32_t Clz(uint32_t X) {
   return 32;
 }
 
+inline uint32_t Ctzll(uint64_t X) {
+  unsigned long TrailZeroIdx = 0;
+  if (_BitScanForward64(&TrailZeroIdx, X)) return TrailZeroIdx;
+  return 64;
+}
+
 inline int Popcountll(unsigned long long X) { return __popcnt64(X); }
 
 }  // namespace fuzzer
@@ -652,6 +652,9 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
   Options.IgnoreTimeouts = Flags.ignore_timeouts;
   Options.IgnoreOOMs = Flags.ignore_ooms;
   Options.IgnoreCrashes = Flags.ignore_crashes;
+  Options.ForkMergeJobs = Flags.fork_merge_jobs;
+  if (Flags.fork_sync_dir)
+    Options.ForkSyncDir = Flags.fork_sync_dir;
   Options.MaxTotalTimeSec = Flags.max_total_time;
   Options.DoCrossOver = Flags.cross_over;
   Options.MutateDepth = Flags.mutate_depth;
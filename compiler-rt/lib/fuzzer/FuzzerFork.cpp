@@ -21,6 +21,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -61,6 +62,86 @@ static Stats ParseFinalStatsFromLog(const std::string &LogPath) {
   return Res;
 }
 
+// An input published by a peer, with the features it had when it was found.
+// An empty feature set means the features are not known.
+struct SyncedInput {
+  SizedFile File;
+  Vector<uint32_t> Features;
+};
+
+// Shares the corpus of a fork-mode run with other fork-mode runs (peers), e.g.
+// on other machines. Inputs are published along with their features so that
+// the peers only merge the inputs that may bring features they do not have.
+class CorpusSync {
+public:
+  virtual ~CorpusSync() = default;
+  // Makes an input of the local corpus available to the peers.
+  virtual void Publish(const Unit &U, const Vector<uint32_t> &Features) = 0;
+  // Appends to New the inputs published by the peers since the last call.
+  virtual void Fetch(Vector<SyncedInput> *New) = 0;
+};
+
+// Shares the corpus through a directory that all the peers can access:
+//   Dir/corpus/<sha1>    the inputs;
+//   Dir/features/<sha1>  their features;
+//   Dir/index/<peer>     the names of the inputs a peer published, in order.
+// Every peer only appends to its own index, after the input and its features
+// have been written, and remembers how far it has read the index of the
+// others, so that a fetch only reads what was published since the last one.
+class DirCorpusSync : public CorpusSync {
+public:
+  DirCorpusSync(const std::string &Dir, const std::string &PeerId)
+      : CorpusDir(DirPlusFile(Dir, "corpus")),
+        FeaturesDir(DirPlusFile(Dir, "features")),
+        IndexDir(DirPlusFile(Dir, "index")),
+        IndexPath(DirPlusFile(IndexDir, PeerId)) {
+    for (auto &D : {Dir, CorpusDir, FeaturesDir, IndexDir})
+      MkDir(D);
+  }
+
+  void Publish(const Unit &U, const Vector<uint32_t> &Features) override {
+    auto Name = Hash(U);
+    auto Path = DirPlusFile(CorpusDir, Name);
+    if (IsFile(Path)) return;  // A peer got there first.
+    WriteToFile(U, Path);
+    WriteToFile(reinterpret_cast<const uint8_t *>(Features.data()),
+                Features.size() * sizeof(Features[0]),
+                DirPlusFile(FeaturesDir, Name));
+    std::ofstream Index(IndexPath, std::ios::app);
+    Index << Name << "\n";
+  }
+
+  void Fetch(Vector<SyncedInput> *New) override {
+    Vector<std::string> Indexes;
+    ListFilesInDirRecursive(IndexDir, nullptr, &Indexes, /*TopDir*/true);
+    for (auto &IndexFile : Indexes) {
+      if (IndexFile == IndexPath) continue;
+      auto &Offset = Offsets[IndexFile];
+      std::ifstream In(IndexFile);
+      In.seekg(Offset);
+      std::string Name;
+      // A line without its newline is still being written.
+      while (std::getline(In, Name, '\n') && !In.eof()) {
+        Offset += Name.size() + 1;
+        if (Name.empty()) continue;
+        SyncedInput SI;
+        SI.File.File = DirPlusFile(CorpusDir, Name);
+        SI.File.Size = FileSize(SI.File.File);
+        auto FeatureBytes =
+            FileToVector(DirPlusFile(FeaturesDir, Name), 0, false);
+        SI.Features.resize(FeatureBytes.size() / sizeof(uint32_t));
+        memcpy(SI.Features.data(), FeatureBytes.data(),
+               SI.Features.size() * sizeof(uint32_t));
+        New->push_back(SI);
+      }
+    }
+  }
+
+private:
+  std::string CorpusDir, FeaturesDir, IndexDir, IndexPath;
+  std::map<std::string, std::streamoff> Offsets;
+};
+
 struct FuzzJob {
   // Inputs.
   Command Cmd;
@@ -106,6 +187,13 @@ struct GlobalEnv {
 
   size_t NumRuns = 0;
 
+  // Guards the corpus, the features and the counters above once the merges
+  // run in parallel.
+  std::mutex Mu;
+  std::unique_ptr<CorpusSync> Sync;
+  std::mutex SyncMu;
+  size_t LastSyncTime = 0;
+
   std::string StopFile() { return DirPlusFile(TempDir, "STOP"); }
 
   size_t secondsSinceProcessStartUp() const {
@@ -133,6 +221,7 @@ struct GlobalEnv {
     }
     auto Job = new FuzzJob;
     std::string Seeds;
+    std::unique_lock<std::mutex> Lock(Mu);
     if (size_t CorpusSubsetSize =
             std::min(Files.size(), (size_t)sqrt(Files.size() + 2))) {
       auto Time1 = std::chrono::system_clock::now();
@@ -144,6 +233,7 @@ struct GlobalEnv {
       auto Time2 = std::chrono::system_clock::now();
       Job->DftTimeInSeconds = duration_cast<seconds>(Time2 - Time1).count();
     }
+    Lock.unlock();
     if (!Seeds.empty()) {
       Job->SeedListPath =
           DirPlusFile(TempDir, std::to_string(JobId) + ".seeds");
@@ -179,17 +269,16 @@ struct GlobalEnv {
 
   void RunOneMergeJob(FuzzJob *Job) {
     auto Stats = ParseFinalStatsFromLog(Job->LogPath);
-    NumRuns += Stats.number_of_executed_units;
 
     Vector<SizedFile> TempFiles, MergeCandidates;
     // Read all newly created inputs and their feature sets.
     // Choose only those inputs that have new features.
     GetSizedFilesFromDir(Job->CorpusDir, &TempFiles);
     std::sort(TempFiles.begin(), TempFiles.end());
+    std::unique_lock<std::mutex> Lock(Mu);
+    NumRuns += Stats.number_of_executed_units;
     for (auto &F : TempFiles) {
-      auto FeatureFile = F.File;
-      FeatureFile.replace(0, Job->CorpusDir.size(), Job->FeaturesDir);
-      auto FeatureBytes = FileToVector(FeatureFile, 0, false);
+      auto FeatureBytes = FileToVector(FeatureFile(Job, F.File), 0, false);
       assert((FeatureBytes.size() % sizeof(uint32_t)) == 0);
       Vector<uint32_t> NewFeatures(FeatureBytes.size() / sizeof(uint32_t));
       memcpy(NewFeatures.data(), FeatureBytes.data(), FeatureBytes.size());
@@ -206,13 +295,42 @@ struct GlobalEnv {
            NumRuns, Cov.size(), Features.size(), Files.size(),
            Stats.average_exec_per_sec, NumOOMs, NumTimeouts, NumCrashes,
            secondsSinceProcessStartUp(), Job->JobId, Job->DftTimeInSeconds);
+    Lock.unlock();
+
+    auto FilesToAdd = Merge(MergeCandidates, Job->CFPath);
+    if (Sync) {
+      for (auto &Path : FilesToAdd) {
+        auto FeatureBytes = FileToVector(FeatureFile(Job, Path), 0, false);
+        Vector<uint32_t> Fts(FeatureBytes.size() / sizeof(uint32_t));
+        memcpy(Fts.data(), FeatureBytes.data(), Fts.size() * sizeof(Fts[0]));
+        Sync->Publish(FileToVector(Path), Fts);
+      }
+    }
+  }
 
-    if (MergeCandidates.empty()) return;
+  // Returns the path of the features of an input found by a job.
+  static std::string FeatureFile(FuzzJob *Job, const std::string &Path) {
+    auto FeatureFile = Path;
+    FeatureFile.replace(0, Job->CorpusDir.size(), Job->FeaturesDir);
+    return FeatureFile;
+  }
 
+  // Merges Candidates into the main corpus and returns the paths of the inputs
+  // that were added. Runs without the lock, against a copy of the features,
+  // so that several merges can run at once; two merges may then add inputs
+  // for the same new features, which only makes the corpus a bit larger.
+  Vector<std::string> Merge(const Vector<SizedFile> &Candidates,
+                            const std::string &CFPath) {
     Vector<std::string> FilesToAdd;
+    if (Candidates.empty()) return FilesToAdd;
+    std::unique_lock<std::mutex> Lock(Mu);
+    Set<uint32_t> InitialFeatures(Features), InitialCov(Cov);
+    Lock.unlock();
+
     Set<uint32_t> NewFeatures, NewCov;
-    CrashResistantMerge(Args, {}, MergeCandidates, &FilesToAdd, Features,
-                        &NewFeatures, Cov, &NewCov, Job->CFPath, false);
+    CrashResistantMerge(Args, {}, Candidates, &FilesToAdd, InitialFeatures,
+                        &NewFeatures, InitialCov, &NewCov, CFPath, false);
+    Lock.lock();
     for (auto &Path : FilesToAdd) {
       auto U = FileToVector(Path);
       auto NewPath = DirPlusFile(MainCorpusDir, Hash(U));
@@ -226,9 +344,41 @@ struct GlobalEnv {
         if (TPC.PcIsFuncEntry(TE))
           PrintPC("  NEW_FUNC: %p %F %L\n", "",
                   TPC.GetNextInstructionPc(TE->PC));
-
+    return FilesToAdd;
   }
 
+  // Merges the inputs the peers published since the last sync, at most once
+  // every IntervalSec seconds, and by one merge thread at a time.
+  void MaybeSyncWithPeers(size_t IntervalSec) {
+    if (!Sync) return;
+    std::unique_lock<std::mutex> SyncLock(SyncMu, std::try_to_lock);
+    if (!SyncLock.owns_lock()) return;
+    auto Now = secondsSinceProcessStartUp();
+    if (LastSyncTime && Now < LastSyncTime + IntervalSec) return;
+    LastSyncTime = Now;
+
+    Vector<SyncedInput> Synced;
+    Sync->Fetch(&Synced);
+    if (Synced.empty()) return;
+    Vector<SizedFile> MergeCandidates;
+    std::unique_lock<std::mutex> Lock(Mu);
+    for (auto &SI : Synced) {
+      bool HasNewFeatures = SI.Features.empty();
+      for (auto Ft : SI.Features)
+        if (!Features.count(Ft)) {
+          HasNewFeatures = true;
+          break;
+        }
+      if (HasNewFeatures)
+        MergeCandidates.push_back(SI.File);
+    }
+    Lock.unlock();
+    std::sort(MergeCandidates.begin(), MergeCandidates.end());
+    auto FilesToAdd = Merge(MergeCandidates, DirPlusFile(TempDir, "sync.txt"));
+    Printf("INFO: -fork sync: %zd inputs from peers, %zd candidates, "
+           "%zd added\n", Synced.size(), MergeCandidates.size(),
+           FilesToAdd.size());
+  }
 
   void CollectDFT(const std::string &InputPath) {
     if (DataFlowBinary.empty()) return;
@@ -279,6 +429,17 @@ void WorkerThread(JobQueue *FuzzQ, JobQueue *MergeQ) {
   }
 }
 
+// How often the inputs published by the peers are merged.
+static const size_t kSyncIntervalSec = 10;
+
+void MergeThread(GlobalEnv *Env, JobQueue *MergeQ) {
+  while (auto Job = MergeQ->Pop()) {
+    Env->RunOneMergeJob(Job);
+    delete Job;
+    Env->MaybeSyncWithPeers(kSyncIntervalSec);
+  }
+}
+
 // This is just a skeleton of an experimental -fork=1 feature.
 void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
                   const Vector<std::string> &Args,
@@ -317,9 +478,23 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
   Printf("INFO: -fork=%d: %zd seed inputs, starting to fuzz in %s\n", NumJobs,
          Env.Files.size(), Env.TempDir.c_str());
 
+  if (!Options.ForkSyncDir.empty()) {
+    auto PeerId = std::to_string(GetPid()) + "-" + std::to_string(Rand());
+    Env.Sync.reset(new DirCorpusSync(Options.ForkSyncDir, PeerId));
+    // The features of the seeds are not known one by one.
+    for (auto &Path : Env.Files)
+      Env.Sync->Publish(FileToVector(Path), {});
+    Env.MaybeSyncWithPeers(0);
+    Printf("INFO: -fork=%d: sharing the corpus as %s in %s\n", NumJobs,
+           PeerId.c_str(), Options.ForkSyncDir.c_str());
+  }
+
   int ExitCode = 0;
 
-  JobQueue FuzzQ, MergeQ;
+  // Fuzzing jobs go from FuzzQ to the workers, their results to MergeQ. Once
+  // the main loop is done with them, the merge threads take them from
+  // MergePoolQ.
+  JobQueue FuzzQ, MergeQ, MergePoolQ;
 
   auto StopJobs = [&]() {
     for (int i = 0; i < NumJobs; i++)
@@ -329,11 +504,14 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
   };
 
   size_t JobId = 1;
-  Vector<std::thread> Threads;
+  Vector<std::thread> Threads, MergeThreads;
   for (int t = 0; t < NumJobs; t++) {
     Threads.push_back(std::thread(WorkerThread, &FuzzQ, &MergeQ));
     FuzzQ.Push(Env.CreateNewJob(JobId++));
   }
+  const int NumMergeJobs = std::max(1, Options.ForkMergeJobs);
+  for (int t = 0; t < NumMergeJobs; t++)
+    MergeThreads.push_back(std::thread(MergeThread, &Env, &MergePoolQ));
 
   while (true) {
     std::unique_ptr<FuzzJob> Job(MergeQ.Pop());
@@ -347,9 +525,9 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
     }
     Fuzzer::MaybeExitGracefully();
 
-    Env.RunOneMergeJob(Job.get());
-
     // Continue if our crash is one of the ignorred ones.
+    bool Crashed = false;
+    std::unique_lock<std::mutex> Lock(Env.Mu);
     if (Options.IgnoreTimeouts && ExitCode == Options.TimeoutExitCode)
       Env.NumTimeouts++;
     else if (Options.IgnoreOOMs && ExitCode == Options.OOMExitCode)
@@ -367,10 +545,18 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
         // And exit if we don't ignore this crash.
         Printf("INFO: log from the inner process:\n%s",
                FileToString(Job->LogPath).c_str());
-        StopJobs();
-        break;
+        Crashed = true;
       }
     }
+    const size_t NumRuns = Env.NumRuns;
+    Lock.unlock();
+
+    // The inputs of the job are merged even if it crashed.
+    MergePoolQ.Push(Job.release());
+    if (Crashed) {
+      StopJobs();
+      break;
+    }
 
     // Stop if we are over the time budget.
     // This is not precise, since other threads are still running
@@ -383,9 +569,8 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
       StopJobs();
       break;
     }
-    if (Env.NumRuns >= Options.MaxNumberOfRuns) {
-      Printf("INFO: fuzzed for %zd iterations, wrapping up soon\n",
-             Env.NumRuns);
+    if (NumRuns >= Options.MaxNumberOfRuns) {
+      Printf("INFO: fuzzed for %zd iterations, wrapping up soon\n", NumRuns);
       StopJobs();
       break;
     }
@@ -393,6 +578,11 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
     FuzzQ.Push(Env.CreateNewJob(JobId++));
   }
 
+  // Let the merge threads finish the jobs they have been given.
+  for (int t = 0; t < NumMergeJobs; t++)
+    MergePoolQ.Push(nullptr);
+  for (auto &T : MergeThreads)
+    T.join();
   for (auto &T : Threads)
     T.join();
 
@@ -189,6 +189,8 @@ size_t ForEachNonZeroByte(const uint8_t *Begin, const uint8_t *End,
   typedef uintptr_t LargeType;
   const size_t Step = sizeof(LargeType) / sizeof(uint8_t);
   const size_t StepMask = Step - 1;
+  const size_t Block = 64;  // One cache line.
+  const size_t BlockMask = Block - 1;
   auto P = Begin;
   // Iterate by 1 byte until either the alignment boundary or the end.
   for (; reinterpret_cast<uintptr_t>(P) & StepMask && P < End; P++)
@@ -196,11 +198,31 @@ size_t ForEachNonZeroByte(const uint8_t *Begin, const uint8_t *End,
       Handle8bitCounter(FirstFeature, P - Begin, V);
 
   // Iterate by Step bytes at a time.
-  for (; P < End; P += Step)
-    if (LargeType Bundle = *reinterpret_cast<const LargeType *>(P))
+  auto HandleBundle = [&](const uint8_t *Q) {
+    if (LargeType Bundle = *reinterpret_cast<const LargeType *>(Q))
       for (size_t I = 0; I < Step; I++, Bundle >>= 8)
         if (uint8_t V = Bundle & 0xff)
-          Handle8bitCounter(FirstFeature, P - Begin + I, V);
+          Handle8bitCounter(FirstFeature, Q - Begin + I, V);
+  };
+  for (; reinterpret_cast<uintptr_t>(P) & BlockMask && P + Step <= End;
+       P += Step)
+    HandleBundle(P);
+
+  // Iterate by Block bytes at a time. Most of the counters are zero after a
+  // typical run, so an all-zero block is skipped with one OR of its bundles,
+  // which the compiler turns into a few vector loads.
+  for (; P + Block <= End; P += Block) {
+    const LargeType *B = reinterpret_cast<const LargeType *>(P);
+    LargeType Any = 0;
+    for (size_t I = 0; I < Block / Step; I++)
+      Any |= B[I];
+    if (Any)
+      for (size_t I = 0; I < Block; I += Step)
+        HandleBundle(P + I);
+  }
+
+  for (; P + Step <= End; P += Step)
+    HandleBundle(P);
 
   // Iterate by 1 byte until the end.
   for (; P < End; P++)
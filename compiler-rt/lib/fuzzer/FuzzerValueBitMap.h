@@ -11,6 +11,8 @@
 #ifndef LLVM_FUZZER_VALUE_BIT_MAP_H
 #define LLVM_FUZZER_VALUE_BIT_MAP_H
 
+#include "FuzzerBuiltins.h"
+#include "FuzzerBuiltinsMsvc.h"
 #include "FuzzerDefs.h"
 
 namespace fuzzer {
@@ -57,10 +59,8 @@ struct ValueBitMap {
   ATTRIBUTE_NO_SANITIZE_ALL
   void ForEach(Callback CB) const {
     for (size_t i = 0; i < kMapSizeInWords; i++)
-      if (uintptr_t M = Map[i])
-        for (size_t j = 0; j < sizeof(M) * 8; j++)
-          if (M & ((uintptr_t)1 << j))
-            CB(i * sizeof(M) * 8 + j);
+      for (uintptr_t M = Map[i]; M; M &= M - 1)
+        CB(i * kBitsInWord + Ctzll(M));
   }
 
  private:
@@ -890,6 +890,41 @@ TEST(Fuzzer, ForEachNonZeroByte) {
   EXPECT_EQ(Res, Expected);
 }
 
+TEST(Fuzzer, ForEachNonZeroByteLarge) {
+  // Sparse counters spread over many cache lines, scanned from every
+  // alignment, must match a byte by byte scan.
+  const size_t N = 4096;
+  alignas(64) uint8_t Ar[N] = {};
+  for (size_t I = 3; I < N; I += 331)
+    Ar[I] = I % 255 + 1;
+  Ar[N - 1] = 1;
+  typedef Vector<std::pair<size_t, uint8_t> > Vec;
+  for (size_t B = 0; B < 80; B++) {
+    for (size_t E = N - 80; E <= N; E += 7) {
+      Vec Res, Expected;
+      ForEachNonZeroByte(Ar + B, Ar + E, B,
+                         [&](size_t FirstFeature, size_t Idx, uint8_t V) {
+                           Res.push_back({FirstFeature + Idx, V});
+                         });
+      for (size_t I = B; I < E; I++)
+        if (Ar[I])
+          Expected.push_back({I, Ar[I]});
+      EXPECT_EQ(Res, Expected);
+    }
+  }
+}
+
+TEST(Fuzzer, ValueBitMapForEach) {
+  ValueBitMap M;
+  M.Reset();
+  Vector<size_t> Bits = {0, 1, 63, 64, 65, 1000, 65535};
+  for (auto B : Bits)
+    M.AddValue(B);
+  Vector<size_t> Res;
+  M.ForEach([&](size_t Idx) { Res.push_back(Idx); });
+  EXPECT_EQ(Res, Bits);
+}
+
 // FuzzerCommand unit tests. The arguments in the two helper methods below must
 // match.
 static void makeCommandArgs(Vector<std::string> *ArgsToAdd) {
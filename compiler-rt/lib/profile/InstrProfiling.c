@@ -26,6 +26,15 @@ COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
 }
 
 static unsigned ProfileDumped = 0;
+static int ContinuousModeEnabled = 0;
+
+COMPILER_RT_VISIBILITY int __llvm_profile_is_continuous_mode_enabled(void) {
+  return ContinuousModeEnabled;
+}
+
+COMPILER_RT_VISIBILITY void __llvm_profile_set_continuous_mode(int Enabled) {
+  ContinuousModeEnabled = Enabled;
+}
 
 COMPILER_RT_VISIBILITY unsigned lprofProfileDumped() {
   return ProfileDumped;
@@ -49,6 +49,30 @@ uint8_t __llvm_profile_get_num_padding_bytes(uint64_t SizeInBytes);
  */
 uint64_t __llvm_profile_get_size_for_buffer(void);
 
+/*!
+ * \brief Return 1 if the profile is in continuous mode, 0 otherwise.
+ *
+ * In continuous mode, enabled with the \c %c specifier in the profile file
+ * name, the counters in memory are mapped onto the profile file at startup,
+ * so the file is up to date at any time without being written at exit.
+ */
+int __llvm_profile_is_continuous_mode_enabled(void);
+
+/*! \brief Enable or disable continuous mode. */
+void __llvm_profile_set_continuous_mode(int Enabled);
+
+/*!
+ * \brief Get the number of padding bytes around the counters.
+ *
+ * In continuous mode, the counters start and end at a page boundary of the
+ * profile, so that they can be mapped onto it. Otherwise only the names are
+ * padded, to an eight byte boundary.
+ */
+void __llvm_profile_get_padding_sizes_for_counters(
+    uint64_t DataSize, uint64_t CountersSize, uint64_t NamesSize,
+    uint64_t *PaddingBytesBeforeCounters, uint64_t *PaddingBytesAfterCounters,
+    uint64_t *PaddingBytesAfterNames);
+
 /*!
  * \brief Write instrumentation data to the given buffer.
  *
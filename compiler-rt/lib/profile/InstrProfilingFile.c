@@ -83,11 +83,13 @@ typedef struct lprofFilename {
    * 2 profile data files. %1m is equivalent to %m. Also %m specifier
    * can only appear once at the end of the name pattern. */
   unsigned MergePoolSize;
+  /* Set if the %c specifier, which enables continuous mode, is present. */
+  unsigned ContinuousMode;
   ProfileNameSpecifier PNS;
 } lprofFilename;
 
-COMPILER_RT_WEAK lprofFilename lprofCurFilename = {0,   0, 0, 0, {0},
-                                                   {0}, 0, 0, 0, PNS_unknown};
+COMPILER_RT_WEAK lprofFilename lprofCurFilename = {
+    0, 0, 0, 0, {0}, {0}, 0, 0, 0, 0, PNS_unknown};
 
 static int ProfileMergeRequested = 0;
 static int isProfileMergeRequested() { return ProfileMergeRequested; }
@@ -101,6 +103,11 @@ static void setProfileFile(FILE *File) { ProfileFile = File; }
 
 COMPILER_RT_VISIBILITY void __llvm_profile_set_file_object(FILE *File,
                                                            int EnableMerge) {
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    PROF_WARN("__llvm_profile_set_file_object is not supported in continuous "
+              "mode: %s\n", "the counters are already mapped onto a file");
+    return;
+  }
   setProfileFile(File);
   setProfileMergeRequested(EnableMerge);
 }
@@ -422,6 +429,8 @@ static int parseFilenamePattern(const char *FilenamePat,
                       FilenamePat);
             return -1;
           }
+      } else if (FilenamePat[I] == 'c') {
+        lprofCurFilename.ContinuousMode = 1;
       } else if (containsMergeSpecifier(FilenamePat, I)) {
         if (MergingEnabled) {
           PROF_WARN("%%m specifier can only be specified once in %s.\n",
@@ -490,7 +499,7 @@ static int getCurFilenameLength() {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize))
+        lprofCurFilename.MergePoolSize || lprofCurFilename.ContinuousMode))
     return strlen(lprofCurFilename.FilenamePat);
 
   Len = strlen(lprofCurFilename.FilenamePat) +
@@ -514,7 +523,7 @@ static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf) {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize)) {
+        lprofCurFilename.MergePoolSize || lprofCurFilename.ContinuousMode)) {
     if (!ForceUseBuf)
       return lprofCurFilename.FilenamePat;
 
@@ -556,6 +565,132 @@ static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf) {
   return FilenameBuf;
 }
 
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) ||      \
+    (defined(__sun__) && defined(__svr4__))
+/* Write the profile to \c Filename and map the counters onto it. Other
+ * instrumented images of the process may have mapped their own counters onto
+ * the same file, so the profile is appended at the next page boundary, which
+ * makes its counters page-aligned in the file. Returns 0 on success. */
+static int mmapCountersOntoFile(const char *Filename) {
+  const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
+  const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t *CountersEnd = __llvm_profile_end_counters();
+  const uint64_t DataSize = __llvm_profile_get_data_size(DataBegin, DataEnd);
+  const uint64_t CountersSize = CountersEnd - CountersBegin;
+  const uint64_t NamesSize =
+      __llvm_profile_end_names() - __llvm_profile_begin_names();
+  const size_t PageSize = lprofGetPageSize();
+  uint64_t PaddingBytesBeforeCounters, PaddingBytesAfterCounters,
+      PaddingBytesAfterNames;
+  uint64_t CountersOffset;
+  long ProfileOffset;
+  ProfDataWriter FileWriter;
+  FILE *File;
+  void *Counters;
+
+  /* Nothing is written nor mapped for an image without counters. */
+  if (!DataSize || !CountersSize)
+    return 0;
+
+  if ((uintptr_t)CountersBegin % PageSize ||
+      (uintptr_t)CountersEnd % PageSize) {
+    PROF_ERR("Continuous mode: %s\n",
+             "the counters section is not page-aligned");
+    return -1;
+  }
+
+  createProfileDir(Filename);
+  File = lprofOpenFileEx(Filename);
+  if (!File) {
+    PROF_ERR("Continuous mode: unable to open %s: %s\n", Filename,
+             strerror(errno));
+    return -1;
+  }
+
+  if (fseek(File, 0L, SEEK_END) == -1 || (ProfileOffset = ftell(File)) == -1) {
+    PROF_ERR("Continuous mode: unable to get the size of %s: %s\n", Filename,
+             strerror(errno));
+    fclose(File);
+    return -1;
+  }
+  ProfileOffset = (ProfileOffset + PageSize - 1) / PageSize * PageSize;
+
+  /* Write the profile with the current counters, then replace the counters
+   * in memory with their copy in the file. */
+  initFileWriter(&FileWriter, File);
+  if (fseek(File, ProfileOffset, SEEK_SET) == -1 ||
+      lprofWriteData(&FileWriter, 0, 0) || fflush(File)) {
+    PROF_ERR("Continuous mode: unable to write %s: %s\n", Filename,
+             strerror(errno));
+    COMPILER_RT_FTRUNCATE(File, ProfileOffset);
+    fclose(File);
+    return -1;
+  }
+
+  __llvm_profile_get_padding_sizes_for_counters(
+      DataSize, CountersSize, NamesSize, &PaddingBytesBeforeCounters,
+      &PaddingBytesAfterCounters, &PaddingBytesAfterNames);
+  CountersOffset = ProfileOffset + sizeof(__llvm_profile_header) +
+                   DataSize * sizeof(__llvm_profile_data) +
+                   PaddingBytesBeforeCounters;
+  Counters = mmap(CountersBegin, CountersSize * sizeof(uint64_t),
+                  PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED,
+                  fileno(File), CountersOffset);
+  if (Counters == MAP_FAILED) {
+    PROF_ERR("Continuous mode: unable to map the counters onto %s: %s\n",
+             Filename, strerror(errno));
+    /* The profile is written again at exit. */
+    COMPILER_RT_FTRUNCATE(File, ProfileOffset);
+    fclose(File);
+    return -1;
+  }
+
+  /* The mapping outlives the file object, which releases the lock. */
+  fclose(File);
+  return 0;
+}
+#else
+static int mmapCountersOntoFile(const char *Filename) {
+  PROF_ERR("Continuous mode: %s\n", "not supported on this platform");
+  return -1;
+}
+#endif
+
+/* Enable continuous mode if the profile file name requests it. Otherwise, or
+ * if the counters cannot be mapped, the profile is written at exit. */
+static void initializeProfileForContinuousMode(void) {
+  const char *Filename;
+  char *FilenameBuf;
+
+  if (!lprofCurFilename.ContinuousMode ||
+      __llvm_profile_is_continuous_mode_enabled())
+    return;
+
+  if (doMerging()) {
+    PROF_WARN("%%c specifier cannot be combined with %%m in %s: continuous "
+              "mode is disabled.\n",
+              lprofCurFilename.FilenamePat);
+    return;
+  }
+
+  /* A mismatch is diagnosed by __llvm_profile_write_file. */
+  if (GET_VERSION(__llvm_profile_get_version()) != INSTR_PROF_RAW_VERSION)
+    return;
+
+  FilenameBuf = (char *)COMPILER_RT_ALLOCA(getCurFilenameLength() + 1);
+  Filename = getCurFilename(FilenameBuf, 0);
+  if (!Filename)
+    return;
+
+  /* The padding of the profile depends on the mode. */
+  __llvm_profile_set_continuous_mode(1);
+  if (mmapCountersOntoFile(Filename)) {
+    __llvm_profile_set_continuous_mode(0);
+    PROF_WARN("Continuous mode: %s\n", "the profile will be written at exit");
+  }
+}
+
 /* Returns the pointer to the environment variable
  * string. Returns null if the env var is not set. */
 static const char *getFilenamePatFromEnv(void) {
@@ -635,6 +770,7 @@ void __llvm_profile_initialize_file(void) {
     /* Pass CopyFilenamePat = 1, to ensure that the filename would be valid
        at the  moment when __llvm_profile_write_file() gets executed. */
     parseAndSetFilename(EnvFilenamePat, PNS_environment, 1);
+    initializeProfileForContinuousMode();
     return;
   } else if (hasCommandLineOverrider) {
     SelectedPat = INSTR_PROF_PROFILE_NAME_VAR;
@@ -645,6 +781,7 @@ void __llvm_profile_initialize_file(void) {
   }
 
   parseAndSetFilename(SelectedPat, PNS, 0);
+  initializeProfileForContinuousMode();
 }
 
 /* This API is directly called by the user application code. It has the
@@ -653,7 +790,15 @@ void __llvm_profile_initialize_file(void) {
  */
 COMPILER_RT_VISIBILITY
 void __llvm_profile_set_filename(const char *FilenamePat) {
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    PROF_WARN("__llvm_profile_set_filename(\"%s\") is not supported in "
+              "continuous mode: the counters are already mapped onto a "
+              "file.\n",
+              FilenamePat ? FilenamePat : DefaultProfileName);
+    return;
+  }
   parseAndSetFilename(FilenamePat, PNS_runtime_api, 1);
+  initializeProfileForContinuousMode();
 }
 
 /* The public API for writing profile data into the file with name
@@ -672,6 +817,10 @@ int __llvm_profile_write_file(void) {
     return 0;
   }
 
+  /* The counters in the file are updated as the program runs. */
+  if (__llvm_profile_is_continuous_mode_enabled())
+    return 0;
+
   Length = getCurFilenameLength();
   FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
   Filename = getCurFilename(FilenameBuf, 0);
@@ -708,7 +857,7 @@ int __llvm_profile_write_file(void) {
 
 COMPILER_RT_VISIBILITY
 int __llvm_profile_dump(void) {
-  if (!doMerging())
+  if (!doMerging() && !__llvm_profile_is_continuous_mode_enabled())
     PROF_WARN("Later invocation of __llvm_profile_dump can lead to clobbering "
               " of previously dumped profile data : %s. Either use %%m "
               "in profile name or change profile name before dumping.\n",
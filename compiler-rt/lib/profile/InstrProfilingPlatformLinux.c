@@ -36,11 +36,22 @@ extern char PROF_NAME_STOP COMPILER_RT_VISIBILITY;
 extern ValueProfNode PROF_VNODES_START COMPILER_RT_VISIBILITY;
 extern ValueProfNode PROF_VNODES_STOP COMPILER_RT_VISIBILITY;
 
+/* Continuous mode maps the counters onto the profile file, so the counters
+ * section must start and end at a page boundary. Aligning the dummy counters
+ * below to a page aligns the start of the section, and also its end if the
+ * runtime comes last in the link, as it usually does. Fuchsia does not
+ * support continuous mode. */
+#if defined(__Fuchsia__)
+#define PROF_CNTS_SECT_ALIGN sizeof(uint64_t)
+#else
+#define PROF_CNTS_SECT_ALIGN 4096
+#endif
+
 /* Add dummy data to ensure the section is always created. */
 __llvm_profile_data
     __prof_data_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_DATA_SECT_NAME);
-uint64_t
-    __prof_cnts_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_CNTS_SECT_NAME);
+uint64_t __prof_cnts_sect_data[0] COMPILER_RT_ALIGNAS(PROF_CNTS_SECT_ALIGN)
+    COMPILER_RT_SECTION(INSTR_PROF_CNTS_SECT_NAME);
 uint32_t
     __prof_orderfile_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_ORDERFILE_SECT_NAME);
 char __prof_nms_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_NAME_SECT_NAME);
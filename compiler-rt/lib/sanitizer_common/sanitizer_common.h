@@ -132,6 +132,8 @@ void IncreaseTotalMmap(uptr size);
 void DecreaseTotalMmap(uptr size);
 uptr GetRSS();
 bool NoHugePagesInRegion(uptr addr, uptr length);
+// Asks for the region to be backed by transparent huge pages where available.
+bool HugePagesInRegion(uptr addr, uptr length);
 bool DontDumpShadowMemory(uptr addr, uptr length);
 // Check if the built VMA size matches the runtime one.
 void CheckVMASize();
@@ -290,6 +292,12 @@ void SetCheckFailedCallback(CheckFailedCallbackType callback);
 // The callback should be registered once at the tool init time.
 void SetSoftRssLimitExceededCallback(void (*Callback)(bool exceeded));
 
+// Callback will be called from the background thread about every interval_ms
+// milliseconds to return the shadow of unmapped memory to the OS. Registering
+// it starts the background thread, so it has to be registered before
+// MaybeStartBackgroudThread() is called.
+void SetReleaseShadowCallback(void (*Callback)(), s32 interval_ms);
+
 // Functions related to signal handling.
 typedef void (*SignalHandlerType)(int, void *, void *);
 HandleSignalMode GetHandleSignalMode(int signum);
@@ -24,6 +24,15 @@ void SetSoftRssLimitExceededCallback(void (*Callback)(bool exceeded)) {
   SoftRssLimitExceededCallback = Callback;
 }
 
+static void (*ReleaseShadowCallback)();
+static s32 release_shadow_interval_ms;
+void SetReleaseShadowCallback(void (*Callback)(), s32 interval_ms) {
+  CHECK_EQ(ReleaseShadowCallback, nullptr);
+  CHECK_GE(interval_ms, 0);
+  ReleaseShadowCallback = Callback;
+  release_shadow_interval_ms = interval_ms;
+}
+
 #if (SANITIZER_LINUX || SANITIZER_NETBSD) && !SANITIZER_GO
 // Weak default implementation for when sanitizer_stackdepot is not linked in.
 SANITIZER_WEAK_ATTRIBUTE StackDepotStats *StackDepotGetStats() {
@@ -38,8 +47,18 @@ void BackgroundThread(void *arg) {
   uptr prev_reported_stack_depot_size = 0;
   bool reached_soft_rss_limit = false;
   uptr rss_during_last_reported_profile = 0;
+  u64 next_shadow_release_ns = 0;
   while (true) {
     SleepForMillis(100);
+    if (ReleaseShadowCallback) {
+      // Intervals shorter than the 100ms tick release on every tick.
+      u64 now_ns = MonotonicNanoTime();
+      if (now_ns >= next_shadow_release_ns) {
+        ReleaseShadowCallback();
+        next_shadow_release_ns =
+            now_ns + (u64)release_shadow_interval_ms * 1000000;
+      }
+    }
     const uptr current_rss_mb = GetRSS() >> 20;
     if (Verbosity()) {
       // If RSS has grown 10% since last time, print some information.
@@ -115,10 +134,11 @@ void WriteToSyslog(const char *msg) {
 void MaybeStartBackgroudThread() {
 #if (SANITIZER_LINUX || SANITIZER_NETBSD) && \
     !SANITIZER_GO  // Need to implement/test on other platforms.
-  // Start the background thread if one of the rss limits is given.
+  // Start the background thread if one of the rss limits is given or the
+  // shadow has to be released periodically.
   if (!common_flags()->hard_rss_limit_mb &&
       !common_flags()->soft_rss_limit_mb &&
-      !common_flags()->heap_profile) return;
+      !common_flags()->heap_profile && !ReleaseShadowCallback) return;
   if (!&real_pthread_create) return;  // Can't spawn the thread anyway.
   internal_start_thread(BackgroundThread, nullptr);
 #endif
@@ -76,6 +76,14 @@ bool NoHugePagesInRegion(uptr addr, uptr size) {
 #endif  // MADV_NOHUGEPAGE
 }
 
+bool HugePagesInRegion(uptr addr, uptr size) {
+#ifdef MADV_HUGEPAGE  // May not be defined on old systems.
+  return madvise((char *)addr, size, MADV_HUGEPAGE) == 0;
+#else
+  return true;
+#endif  // MADV_HUGEPAGE
+}
+
 bool DontDumpShadowMemory(uptr addr, uptr length) {
 #if defined(MADV_DONTDUMP)
   return madvise((char *)addr, length, MADV_DONTDUMP) == 0;
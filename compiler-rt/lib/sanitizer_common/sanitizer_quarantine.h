@@ -9,13 +9,15 @@
 // Memory quarantine for AddressSanitizer and potentially other tools.
 // Quarantine caches some specified amount of memory in per-thread caches,
 // then evicts to global FIFO queue. When the queue reaches specified threshold,
-// oldest memory is recycled.
+// oldest memory is recycled. The global queue is split into a few shards to
+// keep the threads that evict at the same time from serializing on it.
 //
 //===----------------------------------------------------------------------===//
 
 #ifndef SANITIZER_QUARANTINE_H
 #define SANITIZER_QUARANTINE_H
 
+#include "sanitizer_common.h"
 #include "sanitizer_internal_defs.h"
 #include "sanitizer_mutex.h"
 #include "sanitizer_list.h"
@@ -68,6 +70,32 @@ struct QuarantineBatch {
 
 COMPILER_CHECK(sizeof(QuarantineBatch) <= (1 << 13));  // 8Kb.
 
+struct QuarantineStats {
+  uptr batch_count;
+  uptr total_overhead_bytes;
+  uptr total_bytes;
+  uptr total_quarantine_chunks;
+
+  QuarantineStats()
+      : batch_count(0), total_overhead_bytes(0), total_bytes(0),
+        total_quarantine_chunks(0) {}
+
+  void Print() const {
+    uptr quarantine_chunks_capacity = batch_count * QuarantineBatch::kSize;
+    int chunks_usage_percent = quarantine_chunks_capacity == 0 ?
+        0 : total_quarantine_chunks * 100 / quarantine_chunks_capacity;
+    uptr total_quarantined_bytes = total_bytes - total_overhead_bytes;
+    int memory_overhead_percent = total_quarantined_bytes == 0 ?
+        0 : total_overhead_bytes * 100 / total_quarantined_bytes;
+    Printf("Global quarantine stats: batches: %zd; bytes: %zd (user: %zd); "
+           "chunks: %zd (capacity: %zd); %d%% chunks used; %d%% memory overhead"
+           "\n",
+           batch_count, total_bytes, total_quarantined_bytes,
+           total_quarantine_chunks, quarantine_chunks_capacity,
+           chunks_usage_percent, memory_overhead_percent);
+  }
+};
+
 // The callback interface is:
 // void Callback::Recycle(Node *ptr);
 // void *cb.Allocate(uptr size);
@@ -77,8 +105,14 @@ class Quarantine {
  public:
   typedef QuarantineCache<Callback> Cache;
 
-  explicit Quarantine(LinkerInitialized)
-      : cache_(LINKER_INITIALIZED) {
+  // The global queue is split into shards with their own locks, so that
+  // threads draining their caches at the same time do not contend. Small
+  // quarantines get fewer shards, each shard has to hold a useful amount of
+  // memory on its own.
+  static const uptr kMaxShards = 32;
+  static const uptr kMinShardSize = 1 << 24;  // 16Mb.
+
+  explicit Quarantine(LinkerInitialized) {
   }
 
   void Init(uptr size, uptr cache_size) {
@@ -86,12 +120,27 @@ class Quarantine {
     // is zero (it allows us to perform just one atomic read per Put() call).
     CHECK((size == 0 && cache_size == 0) || cache_size != 0);
 
+    uptr num_shards = Min<uptr>(GetNumberOfCPUsCached(), kMaxShards);
+    num_shards = Max<uptr>(Min(num_shards, size / kMinShardSize), 1);
     atomic_store_relaxed(&max_size_, size);
-    atomic_store_relaxed(&min_size_, size / 10 * 9);  // 90% of max size.
+    atomic_store_relaxed(&max_shard_size_, size / num_shards);
+    // 90% of max size.
+    atomic_store_relaxed(&min_shard_size_, size / num_shards / 10 * 9);
     atomic_store_relaxed(&max_cache_size_, cache_size);
 
-    cache_mutex_.Init();
-    recycle_mutex_.Init();
+    uptr old_num_shards = atomic_load_relaxed(&num_shards_);
+    for (uptr i = old_num_shards; i < num_shards; i++) {
+      shards_[i].cache_mutex.Init();
+      shards_[i].recycle_mutex.Init();
+    }
+    atomic_store_relaxed(&num_shards_, num_shards);
+    // When re-initialized with fewer shards (e.g. on activation), move the
+    // chunks of the dropped shards to the first one.
+    for (uptr i = num_shards; i < old_num_shards; i++) {
+      SpinMutexLock l0(&shards_[0].cache_mutex);
+      SpinMutexLock l(&shards_[i].cache_mutex);
+      shards_[0].cache.Transfer(&shards_[i].cache);
+    }
   }
 
   uptr GetSize() const { return atomic_load_relaxed(&max_size_); }
@@ -113,53 +162,87 @@ class Quarantine {
   }
 
   void NOINLINE Drain(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
-    }
-    if (cache_.Size() > GetSize() && recycle_mutex_.TryLock())
-      Recycle(atomic_load_relaxed(&min_size_), cb);
+    Shard *s = LockShard();
+    s->cache.Transfer(c);
+    s->cache_mutex.Unlock();
+    if (s->cache.Size() > atomic_load_relaxed(&max_shard_size_) &&
+        s->recycle_mutex.TryLock())
+      Recycle(s, atomic_load_relaxed(&min_shard_size_), cb);
   }
 
   void NOINLINE DrainAndRecycle(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
+    Shard *s = LockShard();
+    s->cache.Transfer(c);
+    s->cache_mutex.Unlock();
+    for (uptr i = 0; i < kMaxShards; i++) {
+      shards_[i].recycle_mutex.Lock();
+      Recycle(&shards_[i], 0, cb);
     }
-    recycle_mutex_.Lock();
-    Recycle(0, cb);
   }
 
   void PrintStats() const {
     // It assumes that the world is stopped, just as the allocator's PrintStats.
-    Printf("Quarantine limits: global: %zdMb; thread local: %zdKb\n",
-           GetSize() >> 20, GetCacheSize() >> 10);
-    cache_.PrintStats();
+    Printf("Quarantine limits: global: %zdMb; thread local: %zdKb; "
+           "shards: %zd\n",
+           GetSize() >> 20, GetCacheSize() >> 10,
+           atomic_load_relaxed(&num_shards_));
+    QuarantineStats stats;
+    for (uptr i = 0; i < kMaxShards; i++)
+      shards_[i].cache.AddStats(&stats);
+    stats.Print();
   }
 
  private:
+  struct Shard {
+    StaticSpinMutex cache_mutex;
+    StaticSpinMutex recycle_mutex;
+    Cache cache;
+    char pad[kCacheLineSize];
+
+    Shard() : cache(LINKER_INITIALIZED) {}
+  };
+
   // Read-only data.
   char pad0_[kCacheLineSize];
   atomic_uintptr_t max_size_;
-  atomic_uintptr_t min_size_;
+  atomic_uintptr_t max_shard_size_;
+  atomic_uintptr_t min_shard_size_;
   atomic_uintptr_t max_cache_size_;
+  atomic_uintptr_t num_shards_;
   char pad1_[kCacheLineSize];
-  StaticSpinMutex cache_mutex_;
-  StaticSpinMutex recycle_mutex_;
-  Cache cache_;
+  atomic_uint32_t next_shard_;
   char pad2_[kCacheLineSize];
+  Shard shards_[kMaxShards];
+
+  // Takes the shards in turns, so that the shards fill up evenly and the
+  // quarantine as a whole stays close to FIFO order, and skips the shards
+  // other threads are draining into.
+  Shard *LockShard() {
+    uptr num_shards = atomic_load_relaxed(&num_shards_);
+    uptr first =
+        atomic_fetch_add(&next_shard_, 1, memory_order_relaxed) % num_shards;
+    for (uptr i = 0; i < num_shards; i++) {
+      Shard *s = &shards_[(first + i) % num_shards];
+      if (s->cache_mutex.TryLock())
+        return s;
+    }
+    Shard *s = &shards_[first];
+    s->cache_mutex.Lock();
+    return s;
+  }
 
-  void NOINLINE Recycle(uptr min_size, Callback cb) {
+  void NOINLINE Recycle(Shard *s, uptr min_size, Callback cb) {
     Cache tmp;
     {
-      SpinMutexLock l(&cache_mutex_);
+      SpinMutexLock l(&s->cache_mutex);
+      Cache &cache = s->cache;
       // Go over the batches and merge partially filled ones to
       // save some memory, otherwise batches themselves (since the memory used
       // by them is counted against quarantine limit) can overcome the actual
       // user's quarantined chunks, which diminishes the purpose of the
       // quarantine.
-      uptr cache_size = cache_.Size();
-      uptr overhead_size = cache_.OverheadSize();
+      uptr cache_size = cache.Size();
+      uptr overhead_size = cache.OverheadSize();
       CHECK_GE(cache_size, overhead_size);
       // Do the merge only when overhead exceeds this predefined limit (might
       // require some tuning). It saves us merge attempt when the batch list
@@ -168,15 +251,15 @@ class Quarantine {
       if (cache_size > overhead_size &&
           overhead_size * (100 + kOverheadThresholdPercents) >
               cache_size * kOverheadThresholdPercents) {
-        cache_.MergeBatches(&tmp);
+        cache.MergeBatches(&tmp);
       }
       // Extract enough chunks from the quarantine to get below the max
       // quarantine size and leave some leeway for the newly quarantined chunks.
-      while (cache_.Size() > min_size) {
-        tmp.EnqueueBatch(cache_.DequeueBatch());
+      while (cache.Size() > min_size) {
+        tmp.EnqueueBatch(cache.DequeueBatch());
       }
     }
-    recycle_mutex_.Unlock();
+    s->recycle_mutex.Unlock();
     DoRecycle(&tmp, cb);
   }
 
@@ -273,29 +356,19 @@ class QuarantineCache {
     SizeSub(extracted_size);
   }
 
-  void PrintStats() const {
-    uptr batch_count = 0;
-    uptr total_overhead_bytes = 0;
-    uptr total_bytes = 0;
-    uptr total_quarantine_chunks = 0;
+  void AddStats(QuarantineStats *stats) const {
     for (List::ConstIterator it = list_.begin(); it != list_.end(); ++it) {
-      batch_count++;
-      total_bytes += (*it).size;
-      total_overhead_bytes += (*it).size - (*it).quarantined_size();
-      total_quarantine_chunks += (*it).count;
+      stats->batch_count++;
+      stats->total_bytes += (*it).size;
+      stats->total_overhead_bytes += (*it).size - (*it).quarantined_size();
+      stats->total_quarantine_chunks += (*it).count;
     }
-    uptr quarantine_chunks_capacity = batch_count * QuarantineBatch::kSize;
-    int chunks_usage_percent = quarantine_chunks_capacity == 0 ?
-        0 : total_quarantine_chunks * 100 / quarantine_chunks_capacity;
-    uptr total_quarantined_bytes = total_bytes - total_overhead_bytes;
-    int memory_overhead_percent = total_quarantined_bytes == 0 ?
-        0 : total_overhead_bytes * 100 / total_quarantined_bytes;
-    Printf("Global quarantine stats: batches: %zd; bytes: %zd (user: %zd); "
-           "chunks: %zd (capacity: %zd); %d%% chunks used; %d%% memory overhead"
-           "\n",
-           batch_count, total_bytes, total_quarantined_bytes,
-           total_quarantine_chunks, quarantine_chunks_capacity,
-           chunks_usage_percent, memory_overhead_percent);
+  }
+
+  void PrintStats() const {
+    QuarantineStats stats;
+    AddStats(&stats);
+    stats.Print();
   }
 
  private:
@@ -332,8 +332,22 @@ void ThreadRegistry::QuarantinePush(ThreadContextBase *tctx) {
 ThreadContextBase *ThreadRegistry::QuarantinePop() {
   if (invalid_threads_.size() == 0)
     return 0;
+  // Hand out the lowest free tid, so that after a burst of threads the tids
+  // of the live ones stay dense. Tools that size per-thread state (e.g. vector
+  // clocks) by the highest tid then pay for the threads that are alive rather
+  // than for the most that ever were.
+  ThreadContextBase *prev = 0, *best_prev = 0;
   ThreadContextBase *tctx = invalid_threads_.front();
-  invalid_threads_.pop_front();
+  for (ThreadContextBase *t = tctx; t; prev = t, t = t->next) {
+    if (t->tid < tctx->tid) {
+      tctx = t;
+      best_prev = prev;
+    }
+  }
+  if (best_prev)
+    invalid_threads_.extract(best_prev, tctx);
+  else
+    invalid_threads_.pop_front();
   return tctx;
 }
 
@@ -334,6 +334,11 @@ bool NoHugePagesInRegion(uptr addr, uptr size) {
   return true;
 }
 
+bool HugePagesInRegion(uptr addr, uptr size) {
+  // FIXME: large pages have to be committed up front on Windows.
+  return true;
+}
+
 bool DontDumpShadowMemory(uptr addr, uptr length) {
   // This is almost useless on 32-bits.
   // FIXME: add madvise-analog when we move to 64-bits.
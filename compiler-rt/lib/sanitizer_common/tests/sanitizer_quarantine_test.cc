@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #include "sanitizer_common/sanitizer_common.h"
 #include "sanitizer_common/sanitizer_quarantine.h"
+#include "sanitizer_pthread_wrappers.h"
 #include "gtest/gtest.h"
 
 #include <stdlib.h>
@@ -176,4 +177,60 @@ TEST(SanitizerCommon, QuarantineCacheMergeBatchesALotOfBatches) {
   DeallocateCache(&to_deallocate);
 }
 
+struct CountingQuarantineCallback {
+  void Recycle(void *m) {
+    atomic_fetch_add(&recycled, 1, memory_order_relaxed);
+  }
+  void *Allocate(uptr size) {
+    return malloc(size);
+  }
+  void Deallocate(void *p) {
+    free(p);
+  }
+
+  static atomic_uintptr_t recycled;
+};
+
+atomic_uintptr_t CountingQuarantineCallback::recycled;
+
+typedef Quarantine<CountingQuarantineCallback, void> ShardedQuarantine;
+
+static ShardedQuarantine sharded_quarantine(LINKER_INITIALIZED);
+static const uptr kShardedQuarantineSize = 1 << 26;  // 64Mb.
+static const uptr kShardedCacheSize = 1 << 16;       // 64Kb.
+static const uptr kShardedChunkSize = 1 << 10;
+static const uptr kShardedChunksPerThread = 1 << 16;
+
+static void *ShardedQuarantineWorker(void *unused) {
+  ShardedQuarantine::Cache cache;
+  CountingQuarantineCallback counting_cb;
+  for (uptr i = 0; i < kShardedChunksPerThread; ++i)
+    sharded_quarantine.Put(&cache, counting_cb, kFakePtr, kShardedChunkSize);
+  sharded_quarantine.Drain(&cache, counting_cb);
+  return nullptr;
+}
+
+TEST(SanitizerCommon, QuarantineShardsRecycle) {
+  const uptr kNumThreads = 4;
+  sharded_quarantine.Init(kShardedQuarantineSize, kShardedCacheSize);
+  pthread_t threads[kNumThreads];
+  for (uptr i = 0; i < kNumThreads; ++i)
+    PTHREAD_CREATE(&threads[i], 0, ShardedQuarantineWorker, 0);
+  for (uptr i = 0; i < kNumThreads; ++i)
+    PTHREAD_JOIN(threads[i], 0);
+
+  // Whatever the number of shards, the quarantine as a whole keeps about its
+  // limit and recycles the rest. A shard may overflow by what is drained into
+  // it while another thread recycles it.
+  const uptr kPut = kNumThreads * kShardedChunksPerThread;
+  uptr kept = kPut - atomic_load_relaxed(&CountingQuarantineCallback::recycled);
+  EXPECT_GE(kept * kShardedChunkSize, kShardedQuarantineSize / 2);
+  EXPECT_LE(kept * kShardedChunkSize,
+            kShardedQuarantineSize + kNumThreads * 2 * kShardedCacheSize);
+
+  ShardedQuarantine::Cache cache;
+  sharded_quarantine.DrainAndRecycle(&cache, CountingQuarantineCallback());
+  EXPECT_EQ(kPut, atomic_load_relaxed(&CountingQuarantineCallback::recycled));
+}
+
 }  // namespace __sanitizer
@@ -148,6 +148,28 @@ TEST(SanitizerCommon, ThreadRegistryTest) {
   TestRegistry(&no_quarantine_registry, false);
 }
 
+TEST(SanitizerCommon, ThreadRegistryReusesLowestTid) {
+  ThreadRegistry registry(GetThreadContext<ThreadContextBase>,
+                          kMaxRegistryThreads, 0);
+  EXPECT_EQ(0U, registry.CreateThread(get_uid(0), true, -1, 0));
+  registry.StartThread(0, 0, ThreadType::Regular, 0);
+  // A burst of threads, of which a few in the middle stay alive.
+  for (u32 i = 1; i <= 20; i++) {
+    EXPECT_EQ(i, registry.CreateThread(get_uid(i), true, 0, 0));
+    registry.StartThread(i, 0, ThreadType::Regular, 0);
+  }
+  // Let them die from the top, so that the last freed tid is the highest.
+  for (u32 i = 20; i >= 1; i--) {
+    if (i != 5 && i != 6)
+      registry.FinishThread(i);
+  }
+  // New threads fill the holes from the bottom.
+  const u32 expected[] = {1, 2, 3, 4, 7, 8};
+  for (u32 i = 0; i < ARRAY_SIZE(expected); i++)
+    EXPECT_EQ(expected[i], registry.CreateThread(get_uid(100 + i), true, 0,
+                                                 0));
+}
+
 static const int kThreadsPerShard = 20;
 static const int kNumShards = 25;
 
@@ -365,6 +365,30 @@ public:
 
   void releaseToOS() { Primary.releaseToOS(); }
 
+  void setReleaseToOsIntervalMs(s32 Interval) {
+    initThreadMaybe();
+    Primary.setReleaseToOsIntervalMs(Interval);
+  }
+
+  // Fill up to Size entries of S with the stats of the size classes of the
+  // Primary, and return the number of size classes.
+  uptr getClassStats(__scudo_class_stats *S, uptr Size) {
+    initThreadMaybe();
+    const uptr NumClasses = SizeClassMap::NumClasses;
+    for (uptr I = 0; I < Min(Size, NumClasses); I++) {
+      ClassStats CS;
+      Primary.getStats(I, &CS);
+      S[I].class_id = CS.ClassId;
+      S[I].block_size = CS.BlockSize;
+      S[I].mapped_bytes = CS.MappedBytes;
+      S[I].allocated_bytes = CS.AllocatedBytes;
+      S[I].in_use_blocks = CS.InUseBlocks;
+      S[I].ranges_released = CS.RangesReleased;
+      S[I].last_released_bytes = CS.LastReleasedBytes;
+    }
+    return NumClasses;
+  }
+
   // Iterate over all chunks and call a callback for all busy chunks located
   // within the provided memory range. Said callback must not use this allocator
   // or a deadlock can ensue. This fits Android's malloc_iterate() needs.
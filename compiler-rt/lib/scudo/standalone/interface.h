@@ -11,6 +11,8 @@
 
 #include "internal_defs.h"
 
+#include <stddef.h>
+
 extern "C" {
 
 WEAK INTERFACE const char *__scudo_default_options();
@@ -22,6 +24,23 @@ WEAK INTERFACE void __scudo_deallocate_hook(void *ptr);
 
 WEAK INTERFACE void __scudo_print_stats(void);
 
+// Snapshot of a size class of the Primary. The free bytes of a class are
+// allocated_bytes - in_use_blocks * block_size.
+struct __scudo_class_stats {
+  size_t class_id;
+  size_t block_size;
+  size_t mapped_bytes;        // Bytes mapped for the class.
+  size_t allocated_bytes;     // Bytes of the mapping carved into blocks.
+  size_t in_use_blocks;       // Blocks held by the user or the thread caches.
+  size_t ranges_released;     // Page ranges returned to the OS so far.
+  size_t last_released_bytes; // Bytes returned to the OS by the last release.
+};
+
+// Fills up to n entries of stats, one per size class, and returns the number
+// of size classes. Each class is only locked while it is being read.
+WEAK INTERFACE size_t __scudo_get_class_stats(struct __scudo_class_stats *stats,
+                                              size_t n);
+
 typedef void (*iterate_callback)(uintptr_t base, size_t size, void *arg);
 
 } // extern "C"
@@ -72,11 +72,10 @@ public:
       SizeClassInfo *Sci = getSizeClassInfo(I);
       Sci->RandState = getRandomU32(&Seed);
       // See comment in the 64-bit primary about releasing smaller size classes.
-      Sci->CanRelease = (ReleaseToOsInterval > 0) &&
-                        (I != SizeClassMap::BatchClassId) &&
+      Sci->CanRelease = (I != SizeClassMap::BatchClassId) &&
                         (getSizeByClassId(I) >= (PageSize / 32));
     }
-    ReleaseToOsIntervalMs = ReleaseToOsInterval;
+    setReleaseToOsIntervalMs(ReleaseToOsInterval);
   }
   void init(s32 ReleaseToOsInterval) {
     memset(this, 0, sizeof(*this));
@@ -171,6 +170,23 @@ public:
     }
   }
 
+  void setReleaseToOsIntervalMs(s32 Interval) {
+    atomic_store_relaxed(&ReleaseToOsIntervalMs, Interval);
+  }
+
+  void getStats(uptr ClassId, ClassStats *S) {
+    SizeClassInfo *Sci = getSizeClassInfo(ClassId);
+    ScopedLock L(Sci->Mutex);
+    S->ClassId = ClassId;
+    S->BlockSize = getSizeByClassId(ClassId);
+    // The regions of a class are carved entirely when they are mapped.
+    S->MappedBytes = Sci->AllocatedUser;
+    S->AllocatedBytes = Sci->AllocatedUser;
+    S->InUseBlocks = Sci->Stats.PoppedBlocks - Sci->Stats.PushedBlocks;
+    S->RangesReleased = Sci->ReleaseInfo.RangesReleased;
+    S->LastReleasedBytes = Sci->ReleaseInfo.LastReleasedBytes;
+  }
+
 private:
   static const uptr NumClasses = SizeClassMap::NumClasses;
   static const uptr RegionSize = 1UL << RegionSizeLog;
@@ -343,8 +359,9 @@ private:
     const uptr PageSize = getPageSizeCached();
 
     CHECK_GE(Sci->Stats.PoppedBlocks, Sci->Stats.PushedBlocks);
-    const uptr N = Sci->Stats.PoppedBlocks - Sci->Stats.PushedBlocks;
-    if (N * BlockSize < PageSize)
+    const uptr InUseBytes =
+        (Sci->Stats.PoppedBlocks - Sci->Stats.PushedBlocks) * BlockSize;
+    if (Sci->AllocatedUser - InUseBytes < PageSize)
       return; // No chance to release anything.
     if ((Sci->Stats.PushedBlocks - Sci->ReleaseInfo.PushedBlocksAtLastRelease) *
             BlockSize <
@@ -353,7 +370,9 @@ private:
     }
 
     if (!Force) {
-      const s32 IntervalMs = ReleaseToOsIntervalMs;
+      const s32 IntervalMs =
+          getReleaseIntervalMs(atomic_load_relaxed(&ReleaseToOsIntervalMs),
+                               Sci->AllocatedUser, InUseBytes);
       if (IntervalMs < 0)
         return;
       if (Sci->ReleaseInfo.LastReleaseAtNs + IntervalMs * 1000000ULL >
@@ -387,7 +406,7 @@ private:
   // through the whole NumRegions.
   uptr MinRegionIndex;
   uptr MaxRegionIndex;
-  s32 ReleaseToOsIntervalMs;
+  atomic_s32 ReleaseToOsIntervalMs;
   // Unless several threads request regions simultaneously from different size
   // classes, the stash rarely contains more than 1 entry.
   static constexpr uptr MaxStashedRegions = 4;
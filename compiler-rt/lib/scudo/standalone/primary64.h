@@ -79,12 +79,11 @@ public:
       // memory accesses which ends up being fairly costly. The current lower
       // limit is mostly arbitrary and based on empirical observations.
       // TODO(kostyak): make the lower limit a runtime option
-      Region->CanRelease = (ReleaseToOsInterval > 0) &&
-                           (I != SizeClassMap::BatchClassId) &&
+      Region->CanRelease = (I != SizeClassMap::BatchClassId) &&
                            (getSizeByClassId(I) >= (PageSize / 32));
       Region->RandState = getRandomU32(&Seed);
     }
-    ReleaseToOsIntervalMs = ReleaseToOsInterval;
+    setReleaseToOsIntervalMs(ReleaseToOsInterval);
   }
   void init(s32 ReleaseToOsInterval) {
     memset(this, 0, sizeof(*this));
@@ -175,6 +174,22 @@ public:
     }
   }
 
+  void setReleaseToOsIntervalMs(s32 Interval) {
+    atomic_store_relaxed(&ReleaseToOsIntervalMs, Interval);
+  }
+
+  void getStats(uptr ClassId, ClassStats *S) const {
+    RegionInfo *Region = getRegionInfo(ClassId);
+    ScopedLock L(Region->Mutex);
+    S->ClassId = ClassId;
+    S->BlockSize = getSizeByClassId(ClassId);
+    S->MappedBytes = Region->MappedUser;
+    S->AllocatedBytes = Region->AllocatedUser;
+    S->InUseBlocks = Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks;
+    S->RangesReleased = Region->ReleaseInfo.RangesReleased;
+    S->LastReleasedBytes = Region->ReleaseInfo.LastReleasedBytes;
+  }
+
 private:
   static const uptr RegionSize = 1UL << RegionSizeLog;
   static const uptr NumClasses = SizeClassMap::NumClasses;
@@ -213,7 +228,7 @@ private:
   uptr PrimaryBase;
   RegionInfo *RegionInfoArray;
   MapPlatformData Data;
-  s32 ReleaseToOsIntervalMs;
+  atomic_s32 ReleaseToOsIntervalMs;
 
   RegionInfo *getRegionInfo(uptr ClassId) const {
     DCHECK_LT(ClassId, NumClasses);
@@ -341,8 +356,9 @@ private:
     const uptr PageSize = getPageSizeCached();
 
     CHECK_GE(Region->Stats.PoppedBlocks, Region->Stats.PushedBlocks);
-    const uptr N = Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks;
-    if (N * BlockSize < PageSize)
+    const uptr InUseBytes =
+        (Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks) * BlockSize;
+    if (Region->AllocatedUser - InUseBytes < PageSize)
       return; // No chance to release anything.
     if ((Region->Stats.PushedBlocks -
          Region->ReleaseInfo.PushedBlocksAtLastRelease) *
@@ -352,7 +368,9 @@ private:
     }
 
     if (!Force) {
-      const s32 IntervalMs = ReleaseToOsIntervalMs;
+      const s32 IntervalMs =
+          getReleaseIntervalMs(atomic_load_relaxed(&ReleaseToOsIntervalMs),
+                               Region->AllocatedUser, InUseBytes);
       if (IntervalMs < 0)
         return;
       if (Region->ReleaseInfo.LastReleaseAtNs + IntervalMs * 1000000ULL >
@@ -14,6 +14,20 @@
 
 namespace scudo {
 
+// Returns the interval to wait between two releases of a size class. The
+// interval shrinks with the share of the class memory that sits in the free
+// lists, down to an eighth of the configured one: a class that went idle after
+// a spike gives its pages back sooner than one busy recycling its blocks.
+inline s32 getReleaseIntervalMs(s32 IntervalMs, uptr AllocatedBytes,
+                                uptr InUseBytes) {
+  if (IntervalMs <= 0 || AllocatedBytes == 0)
+    return IntervalMs;
+  const u64 ScaledMs =
+      static_cast<u64>(IntervalMs) * Min(InUseBytes, AllocatedBytes) /
+      AllocatedBytes;
+  return Max(static_cast<s32>(ScaledMs), IntervalMs / 8);
+}
+
 class ReleaseRecorder {
 public:
   ReleaseRecorder(uptr BaseAddress, MapPlatformData *Data = nullptr)
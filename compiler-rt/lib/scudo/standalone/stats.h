@@ -21,6 +21,18 @@ enum StatType { StatAllocated, StatMapped, StatCount };
 
 typedef uptr StatCounters[StatCount];
 
+// Snapshot of a size class of the Primary. The free bytes of a class, and with
+// them its fragmentation, are AllocatedBytes - InUseBlocks * BlockSize.
+struct ClassStats {
+  uptr ClassId;
+  uptr BlockSize;
+  uptr MappedBytes;       // Bytes mapped for the class.
+  uptr AllocatedBytes;    // Bytes of the mapping carved into blocks.
+  uptr InUseBlocks;       // Blocks held by the user or the thread caches.
+  uptr RangesReleased;    // Page ranges returned to the OS so far.
+  uptr LastReleasedBytes; // Bytes returned to the OS by the last release.
+};
+
 // Per-thread stats, live in per-thread cache. We use atomics so that the
 // numbers themselves are consistent. But we don't use atomic_{add|sub} or a
 // lock, because those are expensive operations , and we only care for the stats
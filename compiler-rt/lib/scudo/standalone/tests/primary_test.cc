@@ -188,3 +188,45 @@ TEST(ScudoPrimaryTest, PrimaryThreaded) {
   testPrimaryThreaded<scudo::SizeClassAllocator32<SizeClassMap, 18U>>();
   testPrimaryThreaded<scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
 }
+
+template <typename Primary> static void testPrimaryStats() {
+  auto Deleter = [](Primary *P) {
+    P->unmapTestOnly();
+    delete P;
+  };
+  std::unique_ptr<Primary, decltype(Deleter)> Allocator(new Primary, Deleter);
+  Allocator->init(/*ReleaseToOsInterval=*/-1);
+  typename Primary::CacheT Cache;
+  Cache.init(nullptr, Allocator.get());
+  const scudo::uptr Size = 4096U;
+  const scudo::uptr ClassId = Primary::SizeClassMap::getClassIdBySize(Size);
+  std::vector<void *> V;
+  for (scudo::uptr I = 0; I < 256U; I++)
+    V.push_back(Cache.allocate(ClassId));
+  scudo::ClassStats S;
+  Allocator->getStats(ClassId, &S);
+  EXPECT_EQ(S.ClassId, ClassId);
+  EXPECT_EQ(S.BlockSize, Primary::getSizeByClassId(ClassId));
+  EXPECT_GE(S.InUseBlocks, V.size());
+  EXPECT_GE(S.AllocatedBytes, S.InUseBlocks * S.BlockSize);
+  EXPECT_GE(S.MappedBytes, S.AllocatedBytes);
+  EXPECT_EQ(S.RangesReleased, 0U);
+  while (!V.empty()) {
+    Cache.deallocate(ClassId, V.back());
+    V.pop_back();
+  }
+  Cache.destroy(nullptr);
+  Allocator->getStats(ClassId, &S);
+  EXPECT_EQ(S.InUseBlocks, 0U);
+  // The interval is negative, only an explicit release gives the pages back.
+  Allocator->releaseToOS();
+  Allocator->getStats(ClassId, &S);
+  EXPECT_GT(S.RangesReleased, 0U);
+  EXPECT_GT(S.LastReleasedBytes, 0U);
+}
+
+TEST(ScudoPrimaryTest, PrimaryStats) {
+  using SizeClassMap = scudo::DefaultSizeClassMap;
+  testPrimaryStats<scudo::SizeClassAllocator32<SizeClassMap, 18U>>();
+  testPrimaryStats<scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
+}
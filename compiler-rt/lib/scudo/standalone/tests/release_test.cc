@@ -77,6 +77,20 @@ private:
   scudo::uptr LastPageReported = 0;
 };
 
+TEST(ScudoReleaseTest, ReleaseInterval) {
+  // Negative and zero intervals are left alone.
+  EXPECT_EQ(scudo::getReleaseIntervalMs(-1, 1U << 20, 0), -1);
+  EXPECT_EQ(scudo::getReleaseIntervalMs(0, 1U << 20, 0), 0);
+  // Nothing carved yet: the configured interval.
+  EXPECT_EQ(scudo::getReleaseIntervalMs(1000, 0, 0), 1000);
+  // The interval follows the share of the memory that is still in use...
+  EXPECT_EQ(scudo::getReleaseIntervalMs(1000, 1U << 20, 1U << 20), 1000);
+  EXPECT_EQ(scudo::getReleaseIntervalMs(1000, 1U << 20, 1U << 19), 500);
+  // ...down to an eighth of the configured one.
+  EXPECT_EQ(scudo::getReleaseIntervalMs(1000, 1U << 20, 1U << 10), 125);
+  EXPECT_EQ(scudo::getReleaseIntervalMs(1000, 1U << 20, 0), 125);
+}
+
 TEST(ScudoReleaseTest, FreePagesRangeTracker) {
   // 'x' denotes a page to be released, '.' denotes a page to be kept around.
   const char *TestCases[] = {
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "interface.h"
 #include "platform.h"
 
 #include "gtest/gtest.h"
@@ -14,6 +15,8 @@
 #include <malloc.h>
 #include <unistd.h>
 
+#include <vector>
+
 // Note that every C allocation function in the test binary will be fulfilled
 // by Scudo (this includes the gtest APIs, etc.), which is a test by itself.
 // But this might also lead to unexpected side-effects, since the allocation and
@@ -205,6 +208,25 @@ TEST(ScudoWrappersCTest, Mallopt) {
   EXPECT_EQ(mallopt(M_DECAY_TIME, 0), 1);
 }
 
+TEST(ScudoWrappersCTest, ClassStats) {
+  const size_t NumClasses = __scudo_get_class_stats(nullptr, 0);
+  EXPECT_GT(NumClasses, 0U);
+  std::vector<__scudo_class_stats> Stats(NumClasses);
+  void *P = malloc(Size);
+  EXPECT_NE(P, nullptr);
+  EXPECT_EQ(__scudo_get_class_stats(Stats.data(), NumClasses), NumClasses);
+  size_t InUse = 0;
+  for (size_t I = 0; I < NumClasses; I++) {
+    EXPECT_EQ(Stats[I].class_id, I);
+    EXPECT_LE(Stats[I].in_use_blocks * Stats[I].block_size,
+              Stats[I].allocated_bytes);
+    EXPECT_LE(Stats[I].allocated_bytes, Stats[I].mapped_bytes);
+    InUse += Stats[I].in_use_blocks;
+  }
+  EXPECT_GT(InUse, 0U);
+  free(P);
+}
+
 TEST(ScudoWrappersCTest, OtherAlloc) {
   const size_t PageSize = sysconf(_SC_PAGESIZE);
 
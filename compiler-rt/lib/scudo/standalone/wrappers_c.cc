@@ -34,6 +34,11 @@ extern "C" {
 
 INTERFACE void __scudo_print_stats(void) { Allocator.printStats(); }
 
+INTERFACE size_t __scudo_get_class_stats(struct __scudo_class_stats *stats,
+                                         size_t n) {
+  return Allocator.getClassStats(stats, n);
+}
+
 } // extern "C"
 
 #endif // !SCUDO_ANDROID || !_BIONIC
@@ -44,6 +44,12 @@ INTERFACE void __scudo_print_stats(void) {
   SvelteAllocator.printStats();
 }
 
+// Only the regular allocator is reported, so as not to initialize the other.
+INTERFACE size_t __scudo_get_class_stats(struct __scudo_class_stats *stats,
+                                         size_t n) {
+  return Allocator.getClassStats(stats, n);
+}
+
 } // extern "C"
 
 #endif // SCUDO_ANDROID && _BIONIC
@@ -62,7 +62,10 @@ class SyncClock {
  private:
   friend class ThreadClock;
   friend class Iter;
-  static const uptr kDirtyTids = 2;
+  // Number of threads that can release to the clock without touching the
+  // table. Mutexes handed around by a few threads keep both their release and
+  // acquire O(1); beyond that every release resets all the 'acquired' flags.
+  static const uptr kDirtyTids = 4;
 
   struct Dirty {
     u64 epoch  : kClkBits;
@@ -108,6 +108,37 @@ TEST(Clock, RepeatedAcquire) {
   sync.Reset(&cache);
 }
 
+TEST(Clock, RoundRobinRelease) {
+  // A mutex passed around by several threads, each of which acquires it and
+  // releases it again, as lock/unlock do.
+  const unsigned kThreads = 4;
+  ThreadClock *thr[kThreads];
+  for (unsigned i = 0; i < kThreads; i++)
+    thr[i] = new ThreadClock(i + 1);
+  SyncClock sync;
+  for (unsigned iter = 0; iter < 10; iter++) {
+    for (unsigned i = 0; i < kThreads; i++) {
+      thr[i]->acquire(&cache, &sync);
+      thr[i]->tick();
+      thr[i]->release(&cache, &sync);
+    }
+  }
+  for (unsigned i = 0; i < kThreads; i++)
+    ASSERT_EQ(10U, sync.get(i + 1));
+  // Each thread has seen the others up to its own last release.
+  for (unsigned i = 0; i < kThreads; i++) {
+    for (unsigned j = 0; j < kThreads; j++)
+      ASSERT_EQ(j <= i ? 10U : 9U, thr[i]->get(j + 1));
+  }
+  ThreadClock observer(0);
+  observer.acquire(&cache, &sync);
+  for (unsigned i = 0; i < kThreads; i++)
+    ASSERT_EQ(10U, observer.get(i + 1));
+  for (unsigned i = 0; i < kThreads; i++)
+    delete thr[i];
+  sync.Reset(&cache);
+}
+
 TEST(Clock, ManyThreads) {
   SyncClock chunked;
   for (unsigned i = 0; i < 200; i++) {
@@ -17,6 +17,7 @@
 #include <future>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 namespace __xray {
 namespace {
@@ -230,5 +231,43 @@ TEST(BufferQueueTest, GenerationalSupportAcrossThreads) {
   ASSERT_EQ(Counter.load(std::memory_order_acquire), 0);
 }
 
+TEST(BufferQueueTest, ExclusiveAcrossThreads) {
+  constexpr size_t kBuffers = 4;
+  constexpr int kThreads = 8;
+  constexpr int kIterations = 10000;
+  bool Success = false;
+  BufferQueue Buffers(kSize, kBuffers, Success);
+  ASSERT_TRUE(Success);
+
+  // Each thread stamps the buffers it gets, and checks that no other thread
+  // wrote to them before it releases them.
+  auto Process = [&](int Id) {
+    for (int I = 0; I < kIterations; ++I) {
+      BufferQueue::Buffer B;
+      if (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok)
+        continue;
+      auto *Stamp = reinterpret_cast<std::atomic<int> *>(B.Data);
+      Stamp->store(Id, std::memory_order_relaxed);
+      std::this_thread::yield();
+      EXPECT_EQ(Stamp->load(std::memory_order_relaxed), Id);
+      EXPECT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+    }
+  };
+  std::vector<std::thread> Threads;
+  for (int I = 0; I < kThreads; ++I)
+    Threads.emplace_back(Process, I);
+  for (auto &T : Threads)
+    T.join();
+
+  // All the buffers have been returned.
+  BufferQueue::Buffer Bufs[kBuffers + 1];
+  for (size_t I = 0; I < kBuffers; ++I)
+    ASSERT_EQ(Buffers.getBuffer(Bufs[I]), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.getBuffer(Bufs[kBuffers]),
+            BufferQueue::ErrorCode::NotEnoughMemory);
+  for (size_t I = 0; I < kBuffers; ++I)
+    ASSERT_EQ(Buffers.releaseBuffer(Bufs[I]), BufferQueue::ErrorCode::Ok);
+}
+
 } // namespace
 } // namespace __xray
@@ -73,6 +73,16 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (!finalizing())
     return BufferQueue::ErrorCode::AlreadyInitialized;
 
+  // We start the new generation before freeing the current buffers, so that
+  // buffers released from now on are dropped instead of being put back into
+  // the ring. Then we wait for the calls that may still be using the ring.
+  // This pairs with the check of Finalizing in getBuffer, and of Generation
+  // in releaseBuffer, which are made after incrementing ActiveCalls.
+  atomic_store(&Finalizing, 1, memory_order_seq_cst);
+  atomic_fetch_add(&Generation, 1, memory_order_seq_cst);
+  while (atomic_load(&ActiveCalls.Value, memory_order_seq_cst) != 0)
+    internal_sched_yield();
+
   cleanupBuffers();
 
   bool Success = false;
@@ -106,9 +116,16 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (Buffers == nullptr)
     return BufferQueue::ErrorCode::NotEnoughMemory;
 
-  // At this point we increment the generation number to associate the buffers
-  // to the new generation.
-  atomic_fetch_add(&Generation, 1, memory_order_acq_rel);
+  auto CleanupBuffers = at_scope_exit([&, this] {
+    if (Success)
+      return;
+    deallocateBuffer(Buffers, BufferCount);
+    Buffers = nullptr;
+  });
+
+  Cells = initArray<Cell>(BufferCount);
+  if (Cells == nullptr)
+    return BufferQueue::ErrorCode::NotEnoughMemory;
 
   // First, we initialize the refcount in the ControlBlock, which we treat as
   // being at the start of the BackingStore pointer.
@@ -117,7 +134,8 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
 
   // Then we initialise the individual buffers that sub-divide the whole backing
   // store. Each buffer will start at the `Data` member of the ControlBlock, and
-  // will be offsets from these locations.
+  // will be offsets from these locations. Every cell of the ring starts out
+  // holding the buffer at the same index, ready to be handed out.
   for (size_t i = 0; i < BufferCount; ++i) {
     auto &T = Buffers[i];
     auto &Buf = T.Buff;
@@ -131,12 +149,14 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     Buf.BackingStore = BackingStore;
     Buf.ExtentsBackingStore = ExtentsBackingStore;
     Buf.Count = BufferCount;
-    T.Used = false;
+    atomic_store(&T.Used, 0, memory_order_relaxed);
+
+    atomic_store(&Cells[i].Index, i, memory_order_relaxed);
+    atomic_store(&Cells[i].Sequence, i + 1, memory_order_relaxed);
   }
 
-  Next = Buffers;
-  First = Buffers;
-  LiveBuffers = 0;
+  atomic_store(&Head.Value, 0, memory_order_relaxed);
+  atomic_store(&Tail.Value, BufferCount, memory_order_relaxed);
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
@@ -151,9 +171,10 @@ BufferQueue::BufferQueue(size_t B, size_t N,
       BackingStore(nullptr),
       ExtentsBackingStore(nullptr),
       Buffers(nullptr),
-      Next(Buffers),
-      First(Buffers),
-      LiveBuffers(0),
+      Cells(nullptr),
+      Head(),
+      Tail(),
+      ActiveCalls(),
       Generation{0} {
   Success = init(B, N) == BufferQueue::ErrorCode::Ok;
 }
@@ -162,55 +183,103 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   if (atomic_load(&Finalizing, memory_order_acquire))
     return ErrorCode::QueueFinalizing;
 
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
+  atomic_fetch_add(&ActiveCalls.Value, 1, memory_order_seq_cst);
+  auto EndCall = at_scope_exit([this] {
+    atomic_fetch_sub(&ActiveCalls.Value, 1, memory_order_release);
+  });
+
+  // Check again, as init() may have started freeing the buffers since.
+  if (atomic_load(&Finalizing, memory_order_seq_cst))
+    return ErrorCode::QueueFinalizing;
+
+  // Claim the cell at the head of the ring, once it holds a buffer.
+  atomic_uint64_t::Type Pos = atomic_load(&Head.Value, memory_order_relaxed);
+  Cell *C = nullptr;
+  while (true) {
+    C = &Cells[Pos % BufferCount];
+    uint64_t Seq = atomic_load(&C->Sequence, memory_order_acquire);
+    auto Diff = static_cast<int64_t>(Seq - (Pos + 1));
+    if (Diff == 0) {
+      if (atomic_compare_exchange_weak(&Head.Value, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+      continue;
+    }
+
+    // The cell is empty. Unless another thread is in the middle of releasing
+    // a buffer into it, all the buffers have been handed out.
+    if (Diff < 0 && atomic_load(&Tail.Value, memory_order_acquire) <= Pos)
       return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
+    Pos = atomic_load(&Head.Value, memory_order_relaxed);
   }
 
+  BufferRep *B = &Buffers[atomic_load(&C->Index, memory_order_relaxed)];
+  atomic_store(&C->Sequence, Pos + BufferCount, memory_order_release);
+
   incRefCount(BackingStore);
   incRefCount(ExtentsBackingStore);
   Buf = B->Buff;
   Buf.Generation = generation();
-  B->Used = true;
+  atomic_store(&B->Used, 1, memory_order_release);
   return ErrorCode::Ok;
 }
 
 BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
+  atomic_fetch_add(&ActiveCalls.Value, 1, memory_order_seq_cst);
+  auto EndCall = at_scope_exit([this] {
+    atomic_fetch_sub(&ActiveCalls.Value, 1, memory_order_release);
+  });
+
+  // A buffer from an earlier generation only drops its references to the
+  // backing store it came from.
+  if (Buf.Generation != atomic_load(&Generation, memory_order_seq_cst)) {
+    Buffer Old = Buf;
+    Buf = {};
+    decRefCount(Old.BackingStore, Old.Size, Old.Count);
+    decRefCount(Old.ExtentsBackingStore, kExtentsSize, Old.Count);
+    return BufferQueue::ErrorCode::Ok;
+  }
+
   // Check whether the buffer being referred to is within the bounds of the
   // backing store's range.
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (Buf.Generation != generation() || LiveBuffers == 0) {
+  if (Buf.Data < &BackingStore->Data ||
+      Buf.Data >= &BackingStore->Data + (BufferCount * BufferSize))
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
+  uint64_t Index =
+      (static_cast<char *>(Buf.Data) - BackingStore->Data) / BufferSize;
+
+  // Claim the cell at the tail of the ring, once it has been emptied.
+  atomic_uint64_t::Type Pos = atomic_load(&Tail.Value, memory_order_relaxed);
+  Cell *C = nullptr;
+  while (true) {
+    C = &Cells[Pos % BufferCount];
+    uint64_t Seq = atomic_load(&C->Sequence, memory_order_acquire);
+    auto Diff = static_cast<int64_t>(Seq - Pos);
+    if (Diff == 0) {
+      if (atomic_compare_exchange_weak(&Tail.Value, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+      continue;
+    }
+
+    // The cell is still full. Unless another thread is in the middle of
+    // getting the buffer out of it, no buffer has been handed out, so this one
+    // can't be put back.
+    if (Diff < 0 &&
+        Pos - atomic_load(&Head.Value, memory_order_acquire) >= BufferCount) {
       Buf = {};
-      decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-      decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
       return BufferQueue::ErrorCode::Ok;
     }
-
-    if (Buf.Data < &BackingStore->Data ||
-        Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
-      return BufferQueue::ErrorCode::UnrecognizedBuffer;
-
-    --LiveBuffers;
-    B = First++;
-    if (First == (Buffers + BufferCount))
-      First = Buffers;
+    Pos = atomic_load(&Tail.Value, memory_order_relaxed);
   }
 
-  // Now that the buffer has been released, we mark it as "used".
-  B->Buff = Buf;
-  B->Used = true;
+  // The buffer keeps its place in Buffers, and its extents are written in
+  // place, so we only need to put its index back into the ring.
+  atomic_store(&C->Index, Index, memory_order_relaxed);
+  atomic_store(&C->Sequence, Pos + 1, memory_order_release);
+
   decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
   decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-  atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
-               memory_order_release);
   Buf = {};
   return ErrorCode::Ok;
 }
@@ -225,11 +294,13 @@ void BufferQueue::cleanupBuffers() {
   for (auto B = Buffers, E = Buffers + BufferCount; B != E; ++B)
     B->~BufferRep();
   deallocateBuffer(Buffers, BufferCount);
+  deallocateBuffer(Cells, BufferCount);
   decRefCount(BackingStore, BufferSize, BufferCount);
   decRefCount(ExtentsBackingStore, kExtentsSize, BufferCount);
   BackingStore = nullptr;
   ExtentsBackingStore = nullptr;
   Buffers = nullptr;
+  Cells = nullptr;
   BufferCount = 0;
   BufferSize = 0;
 }
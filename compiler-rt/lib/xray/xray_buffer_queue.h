@@ -28,6 +28,12 @@ namespace __xray {
 /// get from or return buffers to the queue. This is one key component of the
 /// "flight data recorder" (FDR) mode to support ongoing XRay function call
 /// trace collection.
+///
+/// Getting and releasing buffers doesn't take a lock, so that it stays cheap
+/// when many threads are tracing. The queue is a bounded ring of buffer
+/// indices, where each cell carries a sequence number that tells whether it
+/// holds a buffer to hand out or is waiting for one to be released, so
+/// threads only contend on the two counters that pick cells.
 class BufferQueue {
 public:
   /// ControlBlock represents the memory layout of how we interpret the backing
@@ -68,9 +74,9 @@ public:
     // The managed buffer.
     Buffer Buff;
 
-    // This is true if the buffer has been returned to the available queue, and
-    // is considered "used" by another thread.
-    bool Used = false;
+    // This is true if the buffer has been handed out, and so holds data that
+    // apply() and the iterators should see.
+    atomic_uint8_t Used;
   };
 
 private:
@@ -87,7 +93,7 @@ private:
       DCHECK_NE(Offset, Max);
       do {
         ++Offset;
-      } while (!Buffers[Offset].Used && Offset != Max);
+      } while (Offset != Max && !isUsed());
       return *this;
     }
 
@@ -107,11 +113,15 @@ private:
           Max(M) {
       // We want to advance to the first Offset where the 'Used' property is
       // true, or to the end of the list/queue.
-      while (!Buffers[Offset].Used && Offset != Max) {
+      while (Offset != Max && !isUsed()) {
         ++Offset;
       }
     }
 
+    bool isUsed() const {
+      return atomic_load(&Buffers[Offset].Used, memory_order_acquire);
+    }
+
     Iterator() = default;
     Iterator(const Iterator &) = default;
     Iterator(Iterator &&) = default;
@@ -137,6 +147,22 @@ private:
   // Amount of pre-allocated buffers.
   size_t BufferCount;
 
+  // A cell in the ring of available buffers. With Pos the position of the
+  // next operation that uses the cell, Sequence is Pos + 1 when the cell holds
+  // the index of a buffer that getBuffer can hand out, and Pos when the cell
+  // is waiting for releaseBuffer to fill it.
+  struct Cell {
+    atomic_uint64_t Sequence;
+    atomic_uint64_t Index;
+  };
+
+  // A counter on its own cache line, as it is updated by all threads.
+  union PaddedCounter {
+    atomic_uint64_t Value;
+    char Padding[kCacheLineSize];
+  };
+
+  // Serializes init() and apply().
   SpinMutex Mutex;
   atomic_uint8_t Finalizing;
 
@@ -146,18 +172,21 @@ private:
   // The collocated ControlBlock and extents storage.
   ControlBlock *ExtentsBackingStore;
 
-  // A dynamically allocated array of BufferRep instances.
+  // A dynamically allocated array of BufferRep instances. A buffer always
+  // stays at the same index; only its index moves through the ring.
   BufferRep *Buffers;
 
-  // Pointer to the next buffer to be handed out.
-  BufferRep *Next;
+  // The ring of BufferCount cells.
+  Cell *Cells;
 
-  // Pointer to the entry in the array where the next released buffer will be
-  // placed.
-  BufferRep *First;
+  // The positions of the next getBuffer and releaseBuffer operations. A
+  // position maps to the cell at Position % BufferCount.
+  PaddedCounter Head;
+  PaddedCounter Tail;
 
-  // Count of buffers that have been handed out through 'getBuffer'.
-  size_t LiveBuffers;
+  // The number of getBuffer and releaseBuffer calls that may be using the
+  // current buffers, which init() waits for before it frees them.
+  PaddedCounter ActiveCalls;
 
   // We use a generation number to identify buffers and which generation they're
   // associated with.
@@ -0,0 +1,55 @@
+// Tests ASAN_OPTIONS=release_unmapped_shadow_interval_ms=N
+//
+// RUN: %clangxx_asan %s -o %t
+// RUN: %env_asan_opts=release_unmapped_shadow_interval_ms=0 %run %t 2>&1 | FileCheck %s --check-prefix=RELEASE
+// RUN: %env_asan_opts=release_unmapped_shadow_interval_ms=-1 %run %t 2>&1 | FileCheck %s --check-prefix=NO_RELEASE
+// RUN: %env_asan_opts=release_unmapped_shadow_interval_ms=0:huge_pages_for_heap_shadow=1 %run %t 2>&1 | FileCheck %s --check-prefix=RELEASE
+//
+// REQUIRES: x86_64-target-arch, shadow-scale-3
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <sanitizer/asan_interface.h>
+
+const size_t kAllocSize = 1 << 28;  // 256Mb
+const uintptr_t kShadowOffset = 0x7fff8000;
+
+// Number of resident pages in the shadow of [p, p + size).
+size_t ResidentShadowPages(char *p, size_t size) {
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t beg = (((uintptr_t)p >> 3) + kShadowOffset) & ~(page_size - 1);
+  uintptr_t end = (((uintptr_t)p + size) >> 3) + kShadowOffset;
+  size_t npages = (end - beg) / page_size;
+  unsigned char *vec = (unsigned char *)malloc(npages);
+  assert(mincore((void *)beg, npages * page_size, vec) == 0);
+  size_t resident = 0;
+  for (size_t i = 0; i < npages; i++)
+    resident += vec[i] & 1;
+  free(vec);
+  return resident;
+}
+
+int main() {
+  // Use mmap directly so that only the poisoning below touches the shadow.
+  char *x = (char *)mmap(0, kAllocSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANON, -1, 0);
+  assert(x != MAP_FAILED);
+  __asan_poison_memory_region(x, kAllocSize);
+  size_t before = ResidentShadowPages(x, kAllocSize);
+  fprintf(stderr, "poisoned: %zd shadow pages\n", before);
+  assert(before > 0);
+
+  munmap(x, kAllocSize);
+  // Give the background thread a few ticks.
+  usleep(500000);
+  size_t after = ResidentShadowPages(x, kAllocSize);
+  fprintf(stderr, "unmapped: %s\n", after < before / 10 ? "RELEASED" : "KEPT");
+  // RELEASE: unmapped: RELEASED
+  // NO_RELEASE: unmapped: KEPT
+  return 0;
+}
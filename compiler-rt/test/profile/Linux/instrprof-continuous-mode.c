@@ -0,0 +1,22 @@
+// RUN: %clang_profgen -o %t.exe %s
+// RUN: rm -f %t.profraw
+// RUN: env LLVM_PROFILE_FILE="%c%t.profraw" %run %t.exe
+// RUN: llvm-profdata show --all-functions --counts %t.profraw | FileCheck %s
+
+// The process exits without writing the profile; the counters were updated in
+// the file while the program was running.
+
+#include <unistd.h>
+
+void foo(int i) {}
+
+// CHECK-LABEL: foo:
+// CHECK: Function count: 3
+// CHECK-LABEL: main:
+// CHECK: Function count: 1
+int main() {
+  foo(0);
+  foo(1);
+  foo(2);
+  _exit(0);
+}
@@ -20,6 +20,20 @@ void BM_ConstructIterIter(benchmark::State& st, Container, GenInputs gen) {
     }
 }
 
+// Grows the container one element at a time, without reserving.
+template <class Container, class GenInputs>
+void BM_PushBack(benchmark::State& st, Container, GenInputs gen) {
+    auto in = gen(st.range(0));
+    const auto end = in.end();
+    benchmark::DoNotOptimize(&in);
+    while (st.KeepRunning()) {
+        Container c;
+        for (auto it = in.begin(); it != end; ++it)
+            c.push_back(*it);
+        benchmark::DoNotOptimize(c.data());
+    }
+}
+
 template <class Container, class GenInputs>
 void BM_InsertValue(benchmark::State& st, Container c, GenInputs gen) {
     auto in = gen(st.range(0));
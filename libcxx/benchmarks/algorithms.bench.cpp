@@ -1,7 +1,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <execution>
 #include <map>
+#include <numeric>
 #include <random>
 #include <string>
 #include <utility>
@@ -19,6 +21,20 @@ struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 2> {
   static constexpr const char* Names[] = {"uint32", "string"};
 };
 
+enum class Policy { Seq, Par };
+struct AllPolicies : EnumValuesAsTuple<AllPolicies, Policy, 2> {
+  static constexpr const char* Names[] = {"Seq", "Par"};
+};
+
+// Calls F with the execution policy object for P.
+template <class P, class F>
+TEST_ALWAYS_INLINE void withPolicy(F f) {
+  if (P() == Policy::Seq)
+    f(std::execution::seq);
+  else
+    f(std::execution::par);
+}
+
 template <class V>
 using Value =
     std::conditional_t<V() == ValueType::Uint32, uint32_t, std::string>;
@@ -145,6 +161,87 @@ struct Sort {
   };
 };
 
+template <class ValueType, class Order, class P>
+struct ParallelSort {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    runOpOnCopies<ValueType>(state, Quantity, Order(), false, [](auto& Copy) {
+      withPolicy<P>([&](const auto& Exec) {
+        std::sort(Exec, Copy.begin(), Copy.end());
+      });
+    });
+  }
+
+  bool skip() const { return Order() == ::Order::Heap; }
+
+  std::string name() const {
+    return "BM_ParallelSort" + ValueType::name() + Order::name() + P::name() +
+           "_" + std::to_string(Quantity);
+  };
+};
+
+template <class P>
+struct ParallelReduce {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<uint64_t> V(Quantity);
+    std::iota(V.begin(), V.end(), 0);
+    while (state.KeepRunningBatch(Quantity)) {
+      withPolicy<P>([&](const auto& Exec) {
+        benchmark::DoNotOptimize(std::reduce(Exec, V.begin(), V.end()));
+      });
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelReduce" + P::name() + "_" + std::to_string(Quantity);
+  };
+};
+
+template <class P>
+struct ParallelTransform {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<uint64_t> V(Quantity), Out(Quantity);
+    std::iota(V.begin(), V.end(), 0);
+    while (state.KeepRunningBatch(Quantity)) {
+      withPolicy<P>([&](const auto& Exec) {
+        std::transform(Exec, V.begin(), V.end(), Out.begin(),
+                       [](uint64_t X) { return X * X + 1; });
+      });
+      benchmark::DoNotOptimize(Out.data());
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelTransform" + P::name() + "_" + std::to_string(Quantity);
+  };
+};
+
+template <class P>
+struct ParallelInclusiveScan {
+  size_t Quantity;
+
+  void run(benchmark::State& state) const {
+    std::vector<uint64_t> V(Quantity), Out(Quantity);
+    std::iota(V.begin(), V.end(), 0);
+    while (state.KeepRunningBatch(Quantity)) {
+      withPolicy<P>([&](const auto& Exec) {
+        std::inclusive_scan(Exec, V.begin(), V.end(), Out.begin());
+      });
+      benchmark::DoNotOptimize(Out.data());
+    }
+  }
+
+  std::string name() const {
+    return "BM_ParallelInclusiveScan" + P::name() + "_" +
+           std::to_string(Quantity);
+  };
+};
+
 template <class ValueType, class Order>
 struct StableSort {
   size_t Quantity;
@@ -266,5 +363,16 @@ int main(int argc, char** argv) {
       Quantities);
   makeCartesianProductBenchmark<PushHeap, AllValueTypes, AllOrders>(Quantities);
   makeCartesianProductBenchmark<PopHeap, AllValueTypes>(Quantities);
+
+  const std::vector<size_t> ParallelQuantities = {1 << 10, 1 << 14, 1 << 18,
+                                                  1 << 22};
+  makeCartesianProductBenchmark<ParallelSort, AllValueTypes, AllOrders,
+                                AllPolicies>(Quantities);
+  makeCartesianProductBenchmark<ParallelReduce, AllPolicies>(
+      ParallelQuantities);
+  makeCartesianProductBenchmark<ParallelTransform, AllPolicies>(
+      ParallelQuantities);
+  makeCartesianProductBenchmark<ParallelInclusiveScan, AllPolicies>(
+      ParallelQuantities);
   benchmark::RunSpecifiedBenchmarks();
 }
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Doubles with random bits, which mostly need all 17 digits, and doubles with
+// few digits, as they often appear in JSON.
+enum class Digits { Random, Short };
+
+std::vector<double> makeDoubles(Digits D) {
+  std::mt19937_64 Gen(42);
+  std::vector<double> V;
+  while (V.size() != 1024) {
+    double X;
+    if (D == Digits::Random) {
+      uint64_t Bits = Gen();
+      std::memcpy(&X, &Bits, sizeof(X));
+      if (X != X || X - X != 0)
+        continue;
+    } else {
+      X = static_cast<double>(Gen() % 100000) / 100;
+    }
+    V.push_back(X);
+  }
+  return V;
+}
+
+std::vector<std::string> makeStrings(Digits D) {
+  std::vector<std::string> V;
+  for (double X : makeDoubles(D)) {
+    char Buf[64];
+    V.emplace_back(Buf, std::to_chars(Buf, Buf + sizeof(Buf), X).ptr);
+  }
+  return V;
+}
+
+void BM_ToChars(benchmark::State& St, Digits D) {
+  const std::vector<double> V = makeDoubles(D);
+  char Buf[64];
+  while (St.KeepRunningBatch(V.size()))
+    for (double X : V) {
+      benchmark::DoNotOptimize(std::to_chars(Buf, Buf + sizeof(Buf), X));
+      benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_CAPTURE(BM_ToChars, Random, Digits::Random);
+BENCHMARK_CAPTURE(BM_ToChars, Short, Digits::Short);
+
+// What round-tripping formatting code uses without to_chars.
+void BM_Snprintf(benchmark::State& St, Digits D) {
+  const std::vector<double> V = makeDoubles(D);
+  char Buf[64];
+  while (St.KeepRunningBatch(V.size()))
+    for (double X : V) {
+      benchmark::DoNotOptimize(std::snprintf(Buf, sizeof(Buf), "%.17g", X));
+      benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_CAPTURE(BM_Snprintf, Random, Digits::Random);
+BENCHMARK_CAPTURE(BM_Snprintf, Short, Digits::Short);
+
+void BM_FromChars(benchmark::State& St, Digits D) {
+  const std::vector<std::string> V = makeStrings(D);
+  while (St.KeepRunningBatch(V.size()))
+    for (const std::string& S : V) {
+      double X;
+      benchmark::DoNotOptimize(
+          std::from_chars(S.data(), S.data() + S.size(), X));
+      benchmark::DoNotOptimize(X);
+    }
+}
+BENCHMARK_CAPTURE(BM_FromChars, Random, Digits::Random);
+BENCHMARK_CAPTURE(BM_FromChars, Short, Digits::Short);
+
+void BM_Strtod(benchmark::State& St, Digits D) {
+  const std::vector<std::string> V = makeStrings(D);
+  while (St.KeepRunningBatch(V.size()))
+    for (const std::string& S : V)
+      benchmark::DoNotOptimize(std::strtod(S.c_str(), nullptr));
+}
+BENCHMARK_CAPTURE(BM_Strtod, Random, Digits::Random);
+BENCHMARK_CAPTURE(BM_Strtod, Short, Digits::Short);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <stdexcept>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+struct Base {
+  virtual ~Base() {}
+};
+struct Derived : Base {};
+
+struct Cleanup {
+  int* Counter;
+  ~Cleanup() { benchmark::DoNotOptimize(++*Counter); }
+};
+
+__attribute__((noinline)) void throwInt(int Value) { throw Value; }
+
+__attribute__((noinline)) void throwDerived() { throw Derived(); }
+
+// Unwind through Depth frames, each of which runs a cleanup and has a handler
+// which doesn't match the thrown exception.
+__attribute__((noinline)) void throwThroughFrames(int Depth, int* Counter) {
+  Cleanup C = {Counter};
+  if (Depth == 0)
+    throwInt(Depth);
+  try {
+    throwThroughFrames(Depth - 1, Counter);
+  } catch (const std::logic_error&) {
+    benchmark::DoNotOptimize(Counter);
+  }
+}
+
+} // namespace
+
+static void BM_ThrowCatchInt(benchmark::State& st) {
+  int Caught = 0;
+  for (auto _ : st) {
+    try {
+      throwInt(42);
+    } catch (int I) {
+      Caught += I;
+    }
+  }
+  benchmark::DoNotOptimize(Caught);
+}
+BENCHMARK(BM_ThrowCatchInt);
+
+static void BM_ThrowCatchDerivedAsBase(benchmark::State& st) {
+  int Caught = 0;
+  for (auto _ : st) {
+    try {
+      throwDerived();
+    } catch (const std::exception&) {
+      Caught -= 1;
+    } catch (const Base&) {
+      Caught += 1;
+    }
+  }
+  benchmark::DoNotOptimize(Caught);
+}
+BENCHMARK(BM_ThrowCatchDerivedAsBase);
+
+static void BM_ThrowThroughFrames(benchmark::State& st) {
+  int Counter = 0;
+  for (auto _ : st) {
+    try {
+      throwThroughFrames(st.range(0), &Counter);
+    } catch (int) {
+      benchmark::DoNotOptimize(Counter);
+    }
+  }
+}
+BENCHMARK(BM_ThrowThroughFrames)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_ThrowCatchMultiThreaded(benchmark::State& st) {
+  int Caught = 0;
+  for (auto _ : st) {
+    try {
+      throwInt(1);
+    } catch (int I) {
+      Caught += I;
+    }
+  }
+  benchmark::DoNotOptimize(Caught);
+}
+BENCHMARK(BM_ThrowCatchMultiThreaded)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -3,6 +3,9 @@
 #include "test_iterators.h"
 #include "filesystem_include.hpp"
 
+#include <fstream>
+#include <string>
+
 static const size_t TestNumInputs = 1024;
 
 
@@ -160,4 +163,67 @@ BENCHMARK_CAPTURE(BM_LexicallyNormal, small_path,
 BENCHMARK_CAPTURE(BM_LexicallyNormal, large_path,
   getRandomPaths, /*PathLen*/32)->RangeMultiplier(2)->Range(2, 256)->Complexity();
 
+// A directory tree of Width subdirectories per level, Depth levels deep,
+// with Files regular files in every directory. Removed on destruction.
+struct BenchmarkTree {
+  fs::path Root;
+
+  BenchmarkTree(int Depth, int Width, int Files)
+      : Root(fs::temp_directory_path() /
+             ("libcxx-bench-" + getRandomString(12))) {
+    fs::create_directory(Root);
+    populate(Root, Depth, Width, Files);
+  }
+  ~BenchmarkTree() { fs::remove_all(Root); }
+
+  BenchmarkTree(const BenchmarkTree&) = delete;
+  BenchmarkTree& operator=(const BenchmarkTree&) = delete;
+
+private:
+  static void populate(const fs::path& Dir, int Depth, int Width,
+                       int Files) {
+    for (int I = 0; I < Files; ++I)
+      std::ofstream(Dir / ("file" + std::to_string(I)));
+    if (Depth == 0)
+      return;
+    for (int I = 0; I < Width; ++I) {
+      const fs::path Sub = Dir / ("dir" + std::to_string(I));
+      fs::create_directory(Sub);
+      populate(Sub, Depth - 1, Width, Files);
+    }
+  }
+};
+
+void BM_DirectoryIterate(benchmark::State &st) {
+  const BenchmarkTree Tree(0, 0, st.range(0));
+  while (st.KeepRunning()) {
+    size_t Count = 0;
+    for (auto& Ent : fs::directory_iterator(Tree.Root)) {
+      benchmark::DoNotOptimize(Ent.path().native().data());
+      ++Count;
+    }
+    benchmark::DoNotOptimize(Count);
+  }
+  st.SetComplexityN(st.range(0));
+}
+BENCHMARK(BM_DirectoryIterate)->RangeMultiplier(4)->Range(16, 4096)
+  ->Complexity();
+
+template <bool QueryType>
+void BM_RecursiveIterate(benchmark::State &st) {
+  const BenchmarkTree Tree(st.range(0), /*Width*/4, /*Files*/8);
+  while (st.KeepRunning()) {
+    size_t Count = 0;
+    for (auto& Ent : fs::recursive_directory_iterator(Tree.Root)) {
+      benchmark::DoNotOptimize(Ent.path().native().data());
+      // The type comes from the directory read, so this should not stat.
+      if (QueryType && Ent.is_directory())
+        ++Count;
+    }
+    benchmark::DoNotOptimize(Count);
+  }
+}
+BENCHMARK_TEMPLATE(BM_RecursiveIterate, false)->DenseRange(1, 4);
+BENCHMARK_TEMPLATE(BM_RecursiveIterate, true)->DenseRange(1, 4);
+
 BENCHMARK_MAIN();
@@ -10,6 +10,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "CartesianBenchmarks.hpp"
 #include "benchmark/benchmark.h"
@@ -24,17 +25,19 @@ enum class FunctionType {
   MemberPointer,
   SmallTrivialFunctor,
   SmallNonTrivialFunctor,
+  SmallMovableFunctor,
   LargeTrivialFunctor,
   LargeNonTrivialFunctor
 };
 
-struct AllFunctionTypes : EnumValuesAsTuple<AllFunctionTypes, FunctionType, 8> {
+struct AllFunctionTypes : EnumValuesAsTuple<AllFunctionTypes, FunctionType, 9> {
   static constexpr const char* Names[] = {"Null",
                                           "FuncPtr",
                                           "MemFuncPtr",
                                           "MemPtr",
                                           "SmallTrivialFunctor",
                                           "SmallNonTrivialFunctor",
+                                          "SmallMovableFunctor",
                                           "LargeTrivialFunctor",
                                           "LargeNonTrivialFunctor"};
 };
@@ -61,6 +64,13 @@ struct SmallNonTrivialFunctor {
   ~SmallNonTrivialFunctor() {}
   int operator()(const S*) const { return 0; }
 };
+struct SmallMovableFunctor {
+  SmallMovableFunctor() {}
+  SmallMovableFunctor(const SmallMovableFunctor&) {}
+  SmallMovableFunctor(SmallMovableFunctor&&) noexcept {}
+  ~SmallMovableFunctor() {}
+  int operator()(const S*) const { return 0; }
+};
 struct LargeTrivialFunctor {
   LargeTrivialFunctor() {
       // Do not spend time initializing the padding.
@@ -95,6 +105,8 @@ inline Function MakeFunction(FunctionType type, bool opaque = false) {
       return maybeOpaque(SmallTrivialFunctor{}, opaque);
     case FunctionType::SmallNonTrivialFunctor:
       return maybeOpaque(SmallNonTrivialFunctor{}, opaque);
+    case FunctionType::SmallMovableFunctor:
+      return maybeOpaque(SmallMovableFunctor{}, opaque);
     case FunctionType::LargeTrivialFunctor:
       return maybeOpaque(LargeTrivialFunctor{}, opaque);
     case FunctionType::LargeNonTrivialFunctor:
@@ -212,6 +224,28 @@ struct InvokeInlined {
   }
 };
 
+// Queues up callbacks and then runs them all, as an event loop does.
+template <class FunctionType>
+struct QueueAndDrain {
+  static void run(benchmark::State& state) {
+    S s;
+    std::vector<Function> queue;
+    for (auto _ : state) {
+      for (int i = 0; i != 64; ++i)
+        queue.push_back(MakeFunction(FunctionType()));
+      for (const Function& f : queue)
+        benchmark::DoNotOptimize(f(&s));
+      queue.clear();
+    }
+  }
+
+  static bool skip() { return FunctionType() == ::FunctionType::Null; }
+
+  static std::string name() {
+    return "BM_QueueAndDrain" + FunctionType::name();
+  }
+};
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -227,5 +261,6 @@ int main(int argc, char** argv) {
   makeCartesianProductBenchmark<OperatorBool, AllFunctionTypes>();
   makeCartesianProductBenchmark<Invoke, AllFunctionTypes>();
   makeCartesianProductBenchmark<InvokeInlined, AllFunctionTypes>();
+  makeCartesianProductBenchmark<QueueAndDrain, AllFunctionTypes>();
   benchmark::RunSpecifiedBenchmarks();
 }
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Handling one request: build up some strings and a map, then drop them.
+void handleRequest(std::pmr::memory_resource* R, int Size) {
+  std::pmr::vector<std::pmr::string> Fields(R);
+  std::pmr::unordered_map<int, std::pmr::string> Headers(R);
+  for (int I = 0; I != Size; ++I) {
+    Fields.emplace_back(40 + I % 32, 'x');
+    Headers.emplace(I, Fields.back());
+  }
+  benchmark::DoNotOptimize(Fields.data());
+  benchmark::DoNotOptimize(Headers.size());
+}
+
+void BM_NewDelete(benchmark::State& St) {
+  for (auto _ : St)
+    handleRequest(std::pmr::new_delete_resource(), St.range(0));
+}
+BENCHMARK(BM_NewDelete)->Range(8, 1024);
+
+void BM_Monotonic(benchmark::State& St) {
+  char Buffer[16384];
+  for (auto _ : St) {
+    std::pmr::monotonic_buffer_resource R(Buffer, sizeof(Buffer));
+    handleRequest(&R, St.range(0));
+  }
+}
+BENCHMARK(BM_Monotonic)->Range(8, 1024);
+
+// The pool outlives the requests, as in a server that keeps one per thread.
+void BM_UnsynchronizedPool(benchmark::State& St) {
+  std::pmr::unsynchronized_pool_resource R;
+  for (auto _ : St)
+    handleRequest(&R, St.range(0));
+}
+BENCHMARK(BM_UnsynchronizedPool)->Range(8, 1024);
+
+void BM_SynchronizedPool(benchmark::State& St) {
+  std::pmr::synchronized_pool_resource R;
+  for (auto _ : St)
+    handleRequest(&R, St.range(0));
+}
+BENCHMARK(BM_SynchronizedPool)->Range(8, 1024);
+
+} // namespace
+
+BENCHMARK_MAIN();
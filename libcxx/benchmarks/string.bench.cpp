@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <cstdint>
 #include <new>
 #include <vector>
@@ -49,6 +50,47 @@ static void BM_StringFindMatch2(benchmark::State &state) {
 }
 BENCHMARK(BM_StringFindMatch2)->Range(1, MAX_STRING_LEN / 4);
 
+// Benchmark when the string matches at the start and the pattern's first char
+// occurs everywhere else, which defeats searching for it alone.
+static void BM_StringFindFirstCharEverywhere(benchmark::State &state) {
+  std::string s1(MAX_STRING_LEN, '*');
+  std::string s2(state.range(0), '-');
+  s2[0] = '*';
+  for (auto _ : state)
+    benchmark::DoNotOptimize(s1.find(s2));
+}
+BENCHMARK(BM_StringFindFirstCharEverywhere)->Range(2, MAX_STRING_LEN / 4);
+
+// Benchmark when the string matches only at the start, searching backwards.
+static void BM_StringRFindMatchFirst(benchmark::State &state) {
+  std::string s1(state.range(0), '-');
+  s1 += std::string(MAX_STRING_LEN / 2, '*');
+  std::string s2(state.range(0), '-');
+  for (auto _ : state)
+    benchmark::DoNotOptimize(s1.rfind(s2));
+}
+BENCHMARK(BM_StringRFindMatchFirst)->Range(2, MAX_STRING_LEN / 4);
+
+// Benchmark when none of the chars to look for occurs.
+static void BM_StringFindFirstOfNoMatch(benchmark::State &state) {
+  std::string s1(MAX_STRING_LEN, '-');
+  std::string s2 = std::string("\r\n\t\"{}[],:;=<>&|\\/").substr(0, state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(s1.find_first_of(s2));
+}
+BENCHMARK(BM_StringFindFirstOfNoMatch)->DenseRange(2, 18, 4);
+
+// Benchmark std::search on char arrays when there is no match.
+static void BM_SearchCharNoMatch(benchmark::State &state) {
+  std::vector<char> s1(state.range(0), '-');
+  std::string s2(8, '*');
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        std::search(s1.data(), s1.data() + s1.size(), s2.data(),
+                    s2.data() + s2.size()));
+}
+BENCHMARK(BM_SearchCharNoMatch)->Range(10, MAX_STRING_LEN);
+
 static void BM_StringCtorDefault(benchmark::State &state) {
   for (auto _ : state) {
     std::string Default;
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <memory>
 
 #include "benchmark/benchmark.h"
@@ -38,4 +39,38 @@ static void BM_WeakPtrIncDecRef(benchmark::State& st) {
 }
 BENCHMARK(BM_WeakPtrIncDecRef);
 
+// A value that every thread reads and that is rarely replaced, as in a
+// configuration that is reloaded.
+static void BM_SharedPtrAtomicLoad(benchmark::State& st) {
+  static std::shared_ptr<int> config = std::make_shared<int>(42);
+  for (auto _ : st) {
+    std::shared_ptr<int> sp = std::atomic_load(&config);
+    benchmark::DoNotOptimize(sp.get());
+  }
+}
+BENCHMARK(BM_SharedPtrAtomicLoad)->ThreadRange(1, 16)->UseRealTime();
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+static void BM_AtomicSharedPtrLoad(benchmark::State& st) {
+  static std::atomic<std::shared_ptr<int>> config(std::make_shared<int>(42));
+  for (auto _ : st) {
+    std::shared_ptr<int> sp = config.load();
+    benchmark::DoNotOptimize(sp.get());
+  }
+}
+BENCHMARK(BM_AtomicSharedPtrLoad)->ThreadRange(1, 16)->UseRealTime();
+
+// Thread 0 keeps replacing the value that the others read.
+static void BM_AtomicSharedPtrLoadWhileStoring(benchmark::State& st) {
+  static std::atomic<std::shared_ptr<int>> config(std::make_shared<int>(42));
+  for (auto _ : st) {
+    if (st.thread_index == 0)
+      config.store(std::make_shared<int>(43));
+    std::shared_ptr<int> sp = config.load();
+    benchmark::DoNotOptimize(sp.get());
+  }
+}
+BENCHMARK(BM_AtomicSharedPtrLoadWhileStoring)->ThreadRange(2, 16)->UseRealTime();
+#endif
+
 BENCHMARK_MAIN();
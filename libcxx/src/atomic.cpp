@@ -0,0 +1,188 @@
+//===------------------------- atomic.cpp ---------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "__config"
+#ifndef _LIBCPP_HAS_NO_THREADS
+
+#include "atomic"
+#include "climits"
+#include "__threading_support"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__unix__) &&  defined(__ELF__) && defined(_LIBCPP_HAS_COMMENT_LIB_PRAGMA)
+#pragma comment(lib, "pthread")
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace {
+
+// Atomics that are waited on share the entries of a table, picked by
+// address. __waiters_ counts the threads blocked on the entry, so that a
+// notification without waiters doesn't enter the kernel. __platform_state_
+// is bumped by every notification of an atomic that is not waited on
+// directly, and is what waits on such atomics block on.
+struct alignas(64) __contention_entry
+{
+    __cxx_atomic_contention_t __waiters_{__cxx_contention_t(0)};
+    __cxx_atomic_contention_t __platform_state_{__cxx_contention_t(0)};
+#ifndef __linux__
+    __libcpp_mutex_t __mut_ = _LIBCPP_MUTEX_INITIALIZER;
+    __libcpp_condvar_t __cv_ = _LIBCPP_CONDVAR_INITIALIZER;
+#endif
+};
+
+const size_t __contention_table_size = 256;
+
+__contention_entry __contention_table[__contention_table_size];
+
+__contention_entry& __entry_for(void const volatile* __p)
+{
+    uintptr_t __h = reinterpret_cast<uintptr_t>(__p);
+    // Atomics are at least 4 byte aligned, and often are at the start of a
+    // cache line.
+    __h = (__h >> 2) ^ (__h >> 8) ^ (__h >> 16);
+    return __contention_table[__h % __contention_table_size];
+}
+
+#ifdef __linux__
+
+// Blocks while *__ptr is __val, or until woken.
+void __platform_wait(__contention_entry&,
+                     __cxx_atomic_contention_t const volatile* __ptr,
+                     __cxx_contention_t __val)
+{
+    syscall(SYS_futex, __ptr, FUTEX_WAIT_PRIVATE, __val, 0, 0, 0);
+}
+
+void __platform_wake(__contention_entry&,
+                     __cxx_atomic_contention_t const volatile* __ptr,
+                     bool __notify_one)
+{
+    syscall(SYS_futex, __ptr, FUTEX_WAKE_PRIVATE, __notify_one ? 1 : INT_MAX, 0, 0, 0);
+}
+
+#else
+
+// Without an address wait, the threads block on a condition variable of the
+// entry, and every wake up wakes all of them.
+void __platform_wait(__contention_entry& __e,
+                     __cxx_atomic_contention_t const volatile* __ptr,
+                     __cxx_contention_t __val)
+{
+    __libcpp_mutex_lock(&__e.__mut_);
+    while (__cxx_atomic_load(__ptr, memory_order_relaxed) == __val)
+        __libcpp_condvar_wait(&__e.__cv_, &__e.__mut_);
+    __libcpp_mutex_unlock(&__e.__mut_);
+}
+
+void __platform_wake(__contention_entry& __e,
+                     __cxx_atomic_contention_t const volatile*,
+                     bool)
+{
+    // The change the waiters wait for happened before, so taking the mutex
+    // makes sure that they either see it or are in __libcpp_condvar_wait.
+    __libcpp_mutex_lock(&__e.__mut_);
+    __libcpp_mutex_unlock(&__e.__mut_);
+    __libcpp_condvar_broadcast(&__e.__cv_);
+}
+
+#endif
+
+void __contention_wait(__contention_entry& __e,
+                       __cxx_atomic_contention_t const volatile* __ptr,
+                       __cxx_contention_t __val)
+{
+    __cxx_atomic_fetch_add(&__e.__waiters_, __cxx_contention_t(1), memory_order_seq_cst);
+    __platform_wait(__e, __ptr, __val);
+    __cxx_atomic_fetch_sub(&__e.__waiters_, __cxx_contention_t(1), memory_order_release);
+}
+
+void __contention_notify(__contention_entry& __e,
+                         __cxx_atomic_contention_t const volatile* __ptr,
+                         bool __notify_one)
+{
+    // Orders the change of the value, which may have been relaxed, before
+    // the check for waiters. A waiter either is counted here or sees the
+    // change when it blocks.
+    __cxx_atomic_thread_fence(memory_order_seq_cst);
+    if (__cxx_atomic_load(&__e.__waiters_, memory_order_relaxed) != 0)
+        __platform_wake(__e, __ptr, __notify_one);
+}
+
+} // namespace
+
+// Atomics of the contention type are their own monitor.
+
+__cxx_contention_t
+__libcpp_atomic_monitor(__cxx_atomic_contention_t const volatile* __location)
+{
+    return __cxx_atomic_load(__location, memory_order_acquire);
+}
+
+void
+__libcpp_atomic_wait(__cxx_atomic_contention_t const volatile* __location,
+                     __cxx_contention_t __old_value)
+{
+    __contention_wait(__entry_for(__location), __location, __old_value);
+}
+
+void
+__cxx_atomic_notify_one(__cxx_atomic_contention_t const volatile* __location)
+{
+    __contention_notify(__entry_for(__location), __location, true);
+}
+
+void
+__cxx_atomic_notify_all(__cxx_atomic_contention_t const volatile* __location)
+{
+    __contention_notify(__entry_for(__location), __location, false);
+}
+
+// Other atomics are monitored through their entry.
+
+__cxx_contention_t
+__libcpp_atomic_monitor(void const volatile* __location)
+{
+    return __cxx_atomic_load(&__entry_for(__location).__platform_state_,
+                             memory_order_acquire);
+}
+
+void
+__libcpp_atomic_wait(void const volatile* __location,
+                     __cxx_contention_t __old_value)
+{
+    __contention_entry& __e = __entry_for(__location);
+    __contention_wait(__e, &__e.__platform_state_, __old_value);
+}
+
+void
+__cxx_atomic_notify_one(void const volatile* __location)
+{
+    // Other atomics may wait on the same entry, so all waiters have to
+    // check their values.
+    __cxx_atomic_notify_all(__location);
+}
+
+void
+__cxx_atomic_notify_all(void const volatile* __location)
+{
+    __contention_entry& __e = __entry_for(__location);
+    __cxx_atomic_fetch_add(&__e.__platform_state_, __cxx_contention_t(1),
+                           memory_order_release);
+    __contention_notify(__e, &__e.__platform_state_, false);
+}
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_HAS_NO_THREADS
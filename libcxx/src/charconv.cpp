@@ -7,6 +7,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "charconv"
+#include "bit"
+#include "cmath"
+#include "limits"
+#include "locale"
+#include "string"
+#include "include/ryu/ryu.h"
 #include <string.h>
 
 _LIBCPP_BEGIN_NAMESPACE_STD
@@ -157,4 +163,609 @@ __u64toa(uint64_t value, char* buffer)
 
 }  // namespace __itoa
 
+namespace
+{
+
+template <class _To, class _From>
+inline _To
+bit_cast(const _From& from)
+{
+    static_assert(sizeof(_To) == sizeof(_From), "");
+    _To to;
+    memcpy(&to, &from, sizeof(to));
+    return to;
+}
+
+inline bool
+has_format(chars_format fmt, chars_format flag)
+{
+    return (static_cast<unsigned>(fmt) & static_cast<unsigned>(flag)) != 0;
+}
+
+// The shortest decimal representation of a floating-point value.
+struct decimal
+{
+    uint64_t mantissa;
+    int32_t exponent;
+    int32_t digits;  // The number of decimal digits in mantissa.
+};
+
+inline int32_t
+decimal_length(uint64_t v)
+{
+    int32_t n = 1;
+    while (n < 20 && v >= __itoa::__pow10_64[n])
+        ++n;
+    return n;
+}
+
+template <class _Tp>
+struct float_traits;
+
+template <>
+struct float_traits<double>
+{
+    typedef uint64_t bits_type;
+    static constexpr int mantissa_bits = __ryu::__DOUBLE_MANTISSA_BITS;
+    static constexpr int exponent_bits = __ryu::__DOUBLE_EXPONENT_BITS;
+    static constexpr int bias = __ryu::__DOUBLE_BIAS;
+    static constexpr int max_parse_digits = __ryu::__DOUBLE_MAX_PARSE_DIGITS;
+
+    static decimal shortest(bits_type mantissa, uint32_t exponent)
+    {
+        __ryu::__floating_decimal_64 d = __ryu::__d2d(mantissa, exponent);
+        return {d.__mantissa, d.__exponent, decimal_length(d.__mantissa)};
+    }
+
+    static double parse(uint64_t m10, int32_t digits, int32_t e10)
+    {
+        return __ryu::__s2d(m10, digits, e10);
+    }
+};
+
+template <>
+struct float_traits<float>
+{
+    typedef uint32_t bits_type;
+    static constexpr int mantissa_bits = __ryu::__FLOAT_MANTISSA_BITS;
+    static constexpr int exponent_bits = __ryu::__FLOAT_EXPONENT_BITS;
+    static constexpr int bias = __ryu::__FLOAT_BIAS;
+    static constexpr int max_parse_digits = __ryu::__FLOAT_MAX_PARSE_DIGITS;
+
+    static decimal shortest(bits_type mantissa, uint32_t exponent)
+    {
+        __ryu::__floating_decimal_32 d = __ryu::__f2d(mantissa, exponent);
+        return {d.__mantissa, d.__exponent, decimal_length(d.__mantissa)};
+    }
+
+    static float parse(uint64_t m10, int32_t digits, int32_t e10)
+    {
+        return __ryu::__s2f(static_cast<uint32_t>(m10), digits, e10);
+    }
+};
+
+inline to_chars_result
+write_string(char* first, char* last, const char* str, size_t len)
+{
+    if (static_cast<size_t>(last - first) < len)
+        return {last, errc::value_too_large};
+    memcpy(first, str, len);
+    return {first + len, errc()};
+}
+
+// Writes d in the style of printf's %e, with as many digits as needed.
+to_chars_result
+write_scientific(char* first, char* last, const decimal& d)
+{
+    const int32_t x = d.exponent + d.digits - 1;
+    uint32_t abs_x = x < 0 ? -x : x;
+    const ptrdiff_t length = d.digits + (d.digits > 1) + 2 + (abs_x >= 100 ? 3 : 2);
+    if (last - first < length)
+        return {last, errc::value_too_large};
+
+    char buffer[20];
+    __itoa::__u64toa(d.mantissa, buffer);
+    *first++ = buffer[0];
+    if (d.digits > 1)
+    {
+        *first++ = '.';
+        memcpy(first, buffer + 1, d.digits - 1);
+        first += d.digits - 1;
+    }
+    *first++ = 'e';
+    *first++ = x < 0 ? '-' : '+';
+    if (abs_x >= 100)
+    {
+        *first++ = static_cast<char>('0' + abs_x / 100);
+        abs_x %= 100;
+    }
+    *first++ = static_cast<char>('0' + abs_x / 10);
+    *first++ = static_cast<char>('0' + abs_x % 10);
+    return {first, errc()};
+}
+
+// Writes the decimal digits of the integer m2 * 2^e2, which has at most 309
+// of them, and returns their end.
+char*
+write_integer(char* buffer, uint64_t m2, int32_t e2)
+{
+    if (e2 <= 0)
+        return __itoa::__u64toa(m2 >> -e2, buffer);
+    if (__libcpp_clz(static_cast<unsigned long long>(m2)) >= e2)
+        return __itoa::__u64toa(m2 << e2, buffer);
+
+    // Multiply by 2^e2 in base 10^9, 28 bits at a time so that a limb times
+    // the factor plus the carry fits in 64 bits.
+    const uint32_t base = 1000000000;
+    uint32_t limbs[36];
+    int n = 0;
+    for (; m2 != 0; m2 /= base)
+        limbs[n++] = static_cast<uint32_t>(m2 % base);
+    for (; e2 > 0; e2 -= 28)
+    {
+        const int shift = e2 < 28 ? e2 : 28;
+        uint64_t carry = 0;
+        for (int i = 0; i != n; ++i)
+        {
+            const uint64_t t = (static_cast<uint64_t>(limbs[i]) << shift) + carry;
+            limbs[i] = static_cast<uint32_t>(t % base);
+            carry = t / base;
+        }
+        for (; carry != 0; carry /= base)
+            limbs[n++] = static_cast<uint32_t>(carry % base);
+    }
+
+    buffer = __itoa::__u32toa(limbs[n - 1], buffer);
+    for (int i = n - 2; i >= 0; --i)
+    {
+        uint32_t v = limbs[i];
+        for (int k = 8; k >= 0; --k, v /= 10)
+            buffer[k] = static_cast<char>('0' + v % 10);
+        buffer += 9;
+    }
+    return buffer;
+}
+
+// Writes d in the style of printf's %f. If d has trailing zeros, the value is
+// an integer, and its exact digits are written instead: They are as short
+// as d, and closer to the value.
+template <class _Tp>
+to_chars_result
+write_fixed(char* first, char* last, const decimal& d,
+            typename float_traits<_Tp>::bits_type mantissa, uint32_t exponent)
+{
+    typedef float_traits<_Tp> traits;
+    if (d.exponent > 0)
+    {
+        uint64_t m2 = mantissa;
+        if (exponent != 0)
+            m2 |= uint64_t(1) << traits::mantissa_bits;
+        const int32_t e2 = (exponent == 0 ? 1 : static_cast<int32_t>(exponent)) -
+                           traits::bias - traits::mantissa_bits;
+        char buffer[310];
+        char* end = write_integer(buffer, m2, e2);
+        return write_string(first, last, buffer, end - buffer);
+    }
+
+    char buffer[20];
+    __itoa::__u64toa(d.mantissa, buffer);
+    const int32_t int_digits = d.digits + d.exponent;
+    if (d.exponent == 0)
+        return write_string(first, last, buffer, d.digits);
+    if (int_digits > 0)
+    {
+        if (last - first < d.digits + 1)
+            return {last, errc::value_too_large};
+        memcpy(first, buffer, int_digits);
+        first[int_digits] = '.';
+        memcpy(first + int_digits + 1, buffer + int_digits, d.digits - int_digits);
+        return {first + d.digits + 1, errc()};
+    }
+    if (last - first < 2 - d.exponent)
+        return {last, errc::value_too_large};
+    *first++ = '0';
+    *first++ = '.';
+    memset(first, '0', -int_digits);
+    first += -int_digits;
+    memcpy(first, buffer, d.digits);
+    return {first + d.digits, errc()};
+}
+
+// Writes the value in the style of printf's %a, without the 0x prefix and
+// with as many digits as needed.
+template <class _Tp>
+to_chars_result
+write_hex(char* first, char* last,
+          typename float_traits<_Tp>::bits_type mantissa, uint32_t exponent)
+{
+    typedef float_traits<_Tp> traits;
+    if (exponent == 0 && mantissa == 0)
+        return write_string(first, last, "0p+0", 4);
+
+    // Align the mantissa to whole hex digits and drop the trailing zeros.
+    const int hex_digits = (traits::mantissa_bits + 3) / 4;
+    uint64_t m = static_cast<uint64_t>(mantissa)
+                 << (hex_digits * 4 - traits::mantissa_bits);
+    int n = hex_digits;
+    for (; n != 0 && (m & 0xf) == 0; --n)
+        m >>= 4;
+
+    const int32_t e = (exponent == 0 ? 1 : static_cast<int32_t>(exponent)) - traits::bias;
+    char exp_buffer[10];
+    char* exp_end = __itoa::__u32toa(e < 0 ? -e : e, exp_buffer);
+    const ptrdiff_t length = 1 + (n != 0 ? n + 1 : 0) + 2 + (exp_end - exp_buffer);
+    if (last - first < length)
+        return {last, errc::value_too_large};
+
+    *first++ = exponent == 0 ? '0' : '1';
+    if (n != 0)
+    {
+        *first++ = '.';
+        for (int i = n - 1; i >= 0; --i, m >>= 4)
+            first[i] = "0123456789abcdef"[m & 0xf];
+        first += n;
+    }
+    *first++ = 'p';
+    *first++ = e < 0 ? '-' : '+';
+    memcpy(first, exp_buffer, exp_end - exp_buffer);
+    return {first + (exp_end - exp_buffer), errc()};
+}
+
+// With plain set, uses whichever of fixed and scientific notation is shorter,
+// as the overloads without a format do. Otherwise, fmt picks the notation.
+template <class _Tp>
+to_chars_result
+floating_to_chars(char* first, char* last, _Tp value, chars_format fmt,
+                  bool plain)
+{
+    typedef float_traits<_Tp> traits;
+    typedef typename traits::bits_type bits_type;
+    const bits_type bits = bit_cast<bits_type>(value);
+    const bits_type mantissa = bits & ((bits_type(1) << traits::mantissa_bits) - 1);
+    const uint32_t exponent = static_cast<uint32_t>(
+        (bits >> traits::mantissa_bits) & ((1u << traits::exponent_bits) - 1));
+
+    if (bits >> (traits::mantissa_bits + traits::exponent_bits))
+    {
+        if (first == last)
+            return {last, errc::value_too_large};
+        *first++ = '-';
+    }
+    if (exponent == (1u << traits::exponent_bits) - 1)
+        return write_string(first, last, mantissa != 0 ? "nan" : "inf", 3);
+    if (!plain && fmt == chars_format::hex)
+        return write_hex<_Tp>(first, last, mantissa, exponent);
+    if (exponent == 0 && mantissa == 0)
+    {
+        if (!plain && fmt == chars_format::scientific)
+            return write_string(first, last, "0e+00", 5);
+        return write_string(first, last, "0", 1);
+    }
+
+    const decimal d = traits::shortest(mantissa, exponent);
+    const int32_t x = d.exponent + d.digits - 1;
+    bool use_fixed;
+    if (plain)
+    {
+        const int32_t scientific_length =
+            d.digits + (d.digits > 1) + 2 + (x <= -100 || x >= 100 ? 3 : 2);
+        int32_t fixed_length;
+        if (d.exponent >= 0)
+            fixed_length = d.digits + d.exponent;
+        else if (x >= 0)
+            fixed_length = d.digits + 1;
+        else
+            fixed_length = 2 - d.exponent;
+        use_fixed = fixed_length <= scientific_length;
+    }
+    else if (fmt == chars_format::scientific)
+        use_fixed = false;
+    else if (fmt == chars_format::fixed)
+        use_fixed = true;
+    else
+        // Like %g with the default precision of 6.
+        use_fixed = -4 <= x && x < 6;
+
+    if (use_fixed)
+        return write_fixed<_Tp>(first, last, d, mantissa, exponent);
+    return write_scientific(first, last, d);
+}
+
+inline bool
+is_digit(char c)
+{
+    return static_cast<unsigned>(c - '0') < 10;
+}
+
+inline int
+hex_digit_value(char c)
+{
+    if (is_digit(c))
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Returns whether [first, last) starts with lower, ignoring case.
+bool
+starts_with_nocase(const char* first, const char* last, const char* lower)
+{
+    for (; *lower != '\0'; ++first, ++lower)
+        if (first == last || (*first | 0x20) != *lower)
+            return false;
+    return true;
+}
+
+// Parses an exponent of [+-]digits, saturating at a value large enough to
+// make any mantissa overflow or underflow. Returns first if there is none.
+const char*
+parse_exponent(const char* first, const char* last, int32_t& exp)
+{
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '+' || *p == '-'))
+        negative = *p++ == '-';
+    if (p == last || !is_digit(*p))
+        return first;
+    int32_t e = 0;
+    for (; p != last && is_digit(*p); ++p)
+        if (e < 100000)
+            e = e * 10 + (*p - '0');
+    exp = negative ? -e : e;
+    return p;
+}
+
+inline int32_t
+clamp_exponent(int64_t e)
+{
+    return e < -1000000 ? -1000000 : e > 1000000 ? 1000000 : static_cast<int32_t>(e);
+}
+
+// Rounds m * 2^e2, plus a bit less than 2^e2 if sticky is set, to the nearest
+// value of type _Tp, ties to even.
+template <class _Tp>
+_Tp
+round_binary(uint64_t m, bool sticky, int32_t e2)
+{
+    typedef float_traits<_Tp> traits;
+    const int shift = __libcpp_clz(static_cast<unsigned long long>(m));
+    m <<= shift;
+    e2 -= shift;
+
+    // The value is in [2^e, 2^(e + 1)). Subnormals have fewer bits.
+    const int32_t e = e2 + 63;
+    if (e > traits::bias)
+        return numeric_limits<_Tp>::infinity();
+    int32_t keep = traits::mantissa_bits + 1;
+    if (e < 1 - traits::bias)
+        keep -= 1 - traits::bias - e;
+    if (keep < 0)
+        return 0;
+
+    const int drop = 64 - keep;
+    const uint64_t kept = drop == 64 ? 0 : m >> drop;
+    const uint64_t rest = drop == 64 ? m : m & ((uint64_t(1) << drop) - 1);
+    const uint64_t half = uint64_t(1) << (drop - 1);
+    const bool round_up =
+        rest > half || (rest == half && (sticky || (kept & 1) != 0));
+    // The result is exact, or overflows to infinity.
+    return ldexp(static_cast<_Tp>(kept + round_up), e2 + drop);
+}
+
+// Parses hex digits with an optional binary exponent, like strtod does after
+// a 0x prefix.
+template <class _Tp>
+from_chars_result
+parse_hex(const char* first, const char* last, bool negative, _Tp& value,
+          const char* start)
+{
+    const char* p = first;
+    while (p != last && hex_digit_value(*p) >= 0)
+        ++p;
+    const ptrdiff_t int_digits = p - first;
+    if (p != last && *p == '.')
+        for (++p; p != last && hex_digit_value(*p) >= 0; ++p)
+            ;
+    const char* mantissa_end = p;
+    if (int_digits == 0 && mantissa_end - first <= 1)
+        return {start, errc::invalid_argument};
+
+    int32_t exp = 0;
+    if (p != last && (*p == 'p' || *p == 'P'))
+    {
+        const char* exp_end = parse_exponent(p + 1, last, exp);
+        if (exp_end != p + 1)
+            p = exp_end;
+    }
+
+    // Keep the first 16 significant digits, and whether any later one is
+    // non-zero.
+    uint64_t m = 0;
+    int used = 0;
+    bool sticky = false;
+    ptrdiff_t digit_index = 0, end_index = 0;
+    for (const char* q = first; q != mantissa_end; ++q)
+    {
+        if (*q == '.')
+            continue;
+        const int v = hex_digit_value(*q);
+        ++digit_index;
+        if (used == 0 && v == 0)
+            continue;
+        if (used < 16)
+        {
+            m = m * 16 + v;
+            ++used;
+            end_index = digit_index;
+        }
+        else
+            sticky |= v != 0;
+    }
+
+    _Tp r = 0;
+    if (m != 0)
+    {
+        r = round_binary<_Tp>(
+            m, sticky, clamp_exponent(4 * static_cast<int64_t>(int_digits - end_index) + exp));
+        if (r == 0 || r == numeric_limits<_Tp>::infinity())
+            return {p, errc::result_out_of_range};
+    }
+    value = negative ? -r : r;
+    return {p, errc()};
+}
+
+// Parses a decimal number, with the exponent fmt allows or requires.
+// Numbers with few enough significant digits are rounded by Ryu, others by
+// strtod in the C locale.
+template <class _Tp>
+from_chars_result
+parse_decimal(const char* first, const char* last, bool negative, _Tp& value,
+              chars_format fmt, const char* start)
+{
+    typedef float_traits<_Tp> traits;
+    const char* p = first;
+    while (p != last && is_digit(*p))
+        ++p;
+    const ptrdiff_t int_digits = p - first;
+    if (p != last && *p == '.')
+        for (++p; p != last && is_digit(*p); ++p)
+            ;
+    const char* mantissa_end = p;
+    if (int_digits == 0 && mantissa_end - first <= 1)
+        return {start, errc::invalid_argument};
+
+    int32_t exp = 0;
+    if (has_format(fmt, chars_format::scientific) && p != last &&
+        (*p == 'e' || *p == 'E'))
+    {
+        const char* exp_end = parse_exponent(p + 1, last, exp);
+        if (exp_end != p + 1)
+            p = exp_end;
+    }
+    if (fmt == chars_format::scientific && p == mantissa_end)
+        return {start, errc::invalid_argument};
+
+    // Find the significant digits, between the leading and trailing zeros.
+    const char* sig_begin = first;
+    while (sig_begin != mantissa_end && (*sig_begin == '0' || *sig_begin == '.'))
+        ++sig_begin;
+    if (sig_begin == mantissa_end)
+    {
+        value = negative ? -_Tp(0) : _Tp(0);
+        return {p, errc()};
+    }
+    const char* sig_end = mantissa_end;
+    while (sig_end[-1] == '0' || sig_end[-1] == '.')
+        --sig_end;
+    const char* point = first + int_digits;
+    const ptrdiff_t digits =
+        (sig_end - sig_begin) - (sig_begin < point && point < sig_end);
+
+    _Tp r;
+    if (digits <= traits::max_parse_digits)
+    {
+        uint64_t m10 = 0;
+        for (const char* q = sig_begin; q != sig_end; ++q)
+            if (*q != '.')
+                m10 = m10 * 10 + (*q - '0');
+        // The place of the last significant digit.
+        const ptrdiff_t place = sig_end <= point ? point - sig_end
+                                                 : -(sig_end - point - 1);
+        r = traits::parse(m10, static_cast<int32_t>(digits),
+                          clamp_exponent(static_cast<int64_t>(place) + exp));
+    }
+    else
+    {
+        const string str(first, p);
+        r = __do_strtod<_Tp>(str.c_str(), nullptr);
+    }
+    if (r == 0 || r == numeric_limits<_Tp>::infinity())
+        return {p, errc::result_out_of_range};
+    value = negative ? -r : r;
+    return {p, errc()};
+}
+
+template <class _Tp>
+from_chars_result
+floating_from_chars(const char* first, const char* last, _Tp& value,
+                    chars_format fmt)
+{
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative)
+        ++p;
+
+    if (starts_with_nocase(p, last, "inf"))
+    {
+        p += 3;
+        if (starts_with_nocase(p, last, "inity"))
+            p += 5;
+        value = negative ? -numeric_limits<_Tp>::infinity()
+                         : numeric_limits<_Tp>::infinity();
+        return {p, errc()};
+    }
+    if (starts_with_nocase(p, last, "nan"))
+    {
+        p += 3;
+        // An optional (n-char-sequence).
+        if (p != last && *p == '(')
+        {
+            const char* q = p + 1;
+            while (q != last && (is_digit(*q) || *q == '_' ||
+                                 ((*q | 0x20) >= 'a' && (*q | 0x20) <= 'z')))
+                ++q;
+            if (q != last && *q == ')')
+                p = q + 1;
+        }
+        value = negative ? -numeric_limits<_Tp>::quiet_NaN()
+                         : numeric_limits<_Tp>::quiet_NaN();
+        return {p, errc()};
+    }
+
+    if (fmt == chars_format::hex)
+        return parse_hex(p, last, negative, value, first);
+    return parse_decimal(p, last, negative, value, fmt, first);
+}
+
+}  // namespace
+
+to_chars_result
+to_chars(char* first, char* last, float value)
+{
+    return floating_to_chars(first, last, value, chars_format::general, true);
+}
+
+to_chars_result
+to_chars(char* first, char* last, double value)
+{
+    return floating_to_chars(first, last, value, chars_format::general, true);
+}
+
+to_chars_result
+to_chars(char* first, char* last, float value, chars_format fmt)
+{
+    return floating_to_chars(first, last, value, fmt, false);
+}
+
+to_chars_result
+to_chars(char* first, char* last, double value, chars_format fmt)
+{
+    return floating_to_chars(first, last, value, fmt, false);
+}
+
+from_chars_result
+from_chars(const char* first, const char* last, float& value, chars_format fmt)
+{
+    return floating_from_chars(first, last, value, fmt);
+}
+
+from_chars_result
+from_chars(const char* first, const char* last, double& value, chars_format fmt)
+{
+    return floating_from_chars(first, last, value, fmt);
+}
+
 _LIBCPP_END_NAMESPACE_STD
@@ -13,11 +13,21 @@
 #include <Windows.h>
 #else
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 #include <errno.h>
 
 #include "filesystem_common.h"
 
+// Open the directories that recursion enters relative to their parent's
+// descriptor, rather than resolving the whole path again for every
+// directory of a deep tree.
+#if defined(AT_FDCWD) && defined(O_DIRECTORY) && defined(O_CLOEXEC) &&        \
+    !defined(__APPLE__)
+#define _LIBCPP_USE_OPENAT
+#endif
+
 _LIBCPP_BEGIN_NAMESPACE_FILESYSTEM
 
 namespace detail {
@@ -121,6 +131,10 @@ public:
     }
   }
 
+  __dir_stream(const __dir_stream& parent, directory_options opts,
+               error_code& ec)
+      : __dir_stream(parent.__entry_.path(), opts, ec) {}
+
   ~__dir_stream() noexcept {
     if (__stream_ == INVALID_HANDLE_VALUE)
       return;
@@ -171,6 +185,7 @@ public:
   __dir_stream& operator=(const __dir_stream&) = delete;
 
   __dir_stream(__dir_stream&& other) noexcept : __stream_(other.__stream_),
+                                                __name_(other.__name_),
                                                 __root_(move(other.__root_)),
                                                 __entry_(move(other.__entry_)) {
     other.__stream_ = nullptr;
@@ -178,15 +193,27 @@ public:
 
   __dir_stream(const path& root, directory_options opts, error_code& ec)
       : __stream_(nullptr), __root_(root) {
-    if ((__stream_ = ::opendir(root.c_str())) == nullptr) {
-      ec = detail::capture_errno();
-      const bool allow_eacess =
-          bool(opts & directory_options::skip_permission_denied);
-      if (allow_eacess && ec.value() == EACCES)
-        ec.clear();
-      return;
+    __stream_ = ::opendir(root.c_str());
+    init(opts, ec);
+  }
+
+  // Opens the directory of the current entry of parent.
+  __dir_stream(const __dir_stream& parent, directory_options opts,
+               error_code& ec)
+      : __stream_(nullptr), __root_(parent.__entry_.path()) {
+#if defined(_LIBCPP_USE_OPENAT)
+    // The name is the one readdir returned, which ends in a null.
+    int fd = ::openat(::dirfd(parent.__stream_), parent.__name_.data(),
+                      O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd != -1 && (__stream_ = ::fdopendir(fd)) == nullptr) {
+      int err = errno;
+      ::close(fd);
+      errno = err;
     }
-    advance(ec);
+#else
+    __stream_ = ::opendir(__root_.c_str());
+#endif
+    init(opts, ec);
   }
 
   ~__dir_stream() noexcept {
@@ -206,15 +233,30 @@ public:
         close();
         return false;
       } else {
-        __entry_.__assign_iter_entry(
-            __root_ / str,
-            directory_entry::__create_iter_result(str_type_pair.second));
+        // Build the path in the storage of the previous entry's path.
+        __name_ = str;
+        __entry_.__p_ = __root_;
+        __entry_.__p_ /= str;
+        __entry_.__data_ =
+            directory_entry::__create_iter_result(str_type_pair.second);
         return true;
       }
     }
   }
 
 private:
+  void init(directory_options opts, error_code& ec) {
+    if (__stream_ == nullptr) {
+      ec = detail::capture_errno();
+      const bool allow_eacess =
+          bool(opts & directory_options::skip_permission_denied);
+      if (allow_eacess && ec.value() == EACCES)
+        ec.clear();
+      return;
+    }
+    advance(ec);
+  }
+
   error_code close() noexcept {
     error_code m_ec;
     if (::closedir(__stream_) == -1)
@@ -224,6 +266,8 @@ private:
   }
 
   DIR* __stream_{nullptr};
+  // The name of the current entry, valid until the next readdir.
+  string_view __name_;
 
 public:
   path __root_;
@@ -374,7 +418,7 @@ bool recursive_directory_iterator::__try_recursion(error_code* ec) {
   }
 
   if (!skip_rec) {
-    __dir_stream new_it(curr_it.__entry_.path(), __imp_->__options_, m_ec);
+    __dir_stream new_it(curr_it, __imp_->__options_, m_ec);
     if (new_it.good()) {
       __imp_->__stack_.push(move(new_it));
       return true;
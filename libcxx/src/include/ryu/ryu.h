@@ -0,0 +1,73 @@
+//===--------------------------- ryu/ryu.h --------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The Ryu algorithms of Ulf Adams, which convert between binary floating-point
+// values and the decimal representations that <charconv> reads and writes:
+//
+//   Ulf Adams. 2018. Ryu: fast float-to-string conversion. PLDI 2018.
+//   Ulf Adams. 2019. Ryu revisited: printf floating point conversion.
+//                    OOPSLA 2019.
+//
+// __d2d and __f2d find the decimal number with the fewest digits that parses
+// back to the given value, picking the closest one if there are several.
+// __s2d and __s2f round a decimal number with few enough digits to the
+// nearest double or float, ties to even.
+
+#ifndef _LIBCPP_SRC_INCLUDE_RYU_RYU_H
+#define _LIBCPP_SRC_INCLUDE_RYU_RYU_H
+
+#include <__config>
+#include <stdint.h>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace __ryu {
+
+static constexpr int __DOUBLE_MANTISSA_BITS = 52;
+static constexpr int __DOUBLE_EXPONENT_BITS = 11;
+static constexpr int __DOUBLE_BIAS = 1023;
+
+static constexpr int __FLOAT_MANTISSA_BITS = 23;
+static constexpr int __FLOAT_EXPONENT_BITS = 8;
+static constexpr int __FLOAT_BIAS = 127;
+
+// The number of significant decimal digits __s2d and __s2f handle.
+static constexpr int __DOUBLE_MAX_PARSE_DIGITS = 17;
+static constexpr int __FLOAT_MAX_PARSE_DIGITS = 9;
+
+// The value __mantissa * 10^__exponent.
+struct __floating_decimal_64 {
+  uint64_t __mantissa;
+  int32_t __exponent;
+};
+
+struct __floating_decimal_32 {
+  uint32_t __mantissa;
+  int32_t __exponent;
+};
+
+// Returns the shortest decimal representation of the finite, non-zero value
+// with the given IEEE mantissa and (biased) exponent fields.
+_LIBCPP_HIDDEN __floating_decimal_64 __d2d(uint64_t __ieee_mantissa,
+                                           uint32_t __ieee_exponent);
+_LIBCPP_HIDDEN __floating_decimal_32 __f2d(uint32_t __ieee_mantissa,
+                                           uint32_t __ieee_exponent);
+
+// Returns __m10 * 10^__e10 rounded to the nearest double or float, which may
+// be zero or infinity. __m10 is non-zero and has __m10_digits decimal digits,
+// at most __DOUBLE_MAX_PARSE_DIGITS and __FLOAT_MAX_PARSE_DIGITS respectively.
+_LIBCPP_HIDDEN double __s2d(uint64_t __m10, int32_t __m10_digits,
+                            int32_t __e10);
+_LIBCPP_HIDDEN float __s2f(uint32_t __m10, int32_t __m10_digits,
+                           int32_t __e10);
+
+} // namespace __ryu
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_SRC_INCLUDE_RYU_RYU_H
@@ -0,0 +1,448 @@
+//===------------------------ memory_resource.cpp -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "memory_resource"
+
+#ifndef _LIBCPP_HAS_NO_ATOMIC_HEADER
+#include "atomic"
+#elif !defined(_LIBCPP_HAS_NO_THREADS)
+#include "mutex"
+#if defined(__unix__) &&  defined(__ELF__) && defined(_LIBCPP_HAS_COMMENT_LIB_PRAGMA)
+#pragma comment(lib, "pthread")
+#endif
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace pmr
+{
+
+// memory_resource
+
+memory_resource::~memory_resource() {}
+
+// new_delete_resource()
+
+namespace {
+
+// The library is built without -faligned-new, so __libcpp_allocate would
+// drop the alignment. Call the aligned operator new directly instead.
+class __new_delete_memory_resource_imp : public memory_resource
+{
+    void* do_allocate(size_t __bytes, size_t __align) override
+    {
+#ifndef _LIBCPP_HAS_NO_LIBRARY_ALIGNED_ALLOCATION
+        if (__is_overaligned_for_new(__align))
+            return ::operator new(__bytes, static_cast<align_val_t>(__align));
+#endif
+        return ::operator new(__bytes);
+    }
+
+    void do_deallocate(void* __p, size_t, size_t __align) override
+    {
+#ifndef _LIBCPP_HAS_NO_LIBRARY_ALIGNED_ALLOCATION
+        if (__is_overaligned_for_new(__align))
+            return ::operator delete(__p, static_cast<align_val_t>(__align));
+#endif
+        ::operator delete(__p);
+    }
+
+    bool do_is_equal(const memory_resource& __other) const _NOEXCEPT override
+        { return &__other == this; }
+};
+
+// null_memory_resource()
+
+class __null_memory_resource_imp : public memory_resource
+{
+    void* do_allocate(size_t, size_t) override
+        { __throw_bad_alloc(); }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& __other) const _NOEXCEPT override
+        { return &__other == this; }
+};
+
+// The global resources are never destroyed, so that objects destroyed at
+// exit can still deallocate through them.
+template <class _Resource>
+union __global_resource
+{
+    _LIBCPP_CONSTEXPR __global_resource() : __res() {}
+    ~__global_resource() {}
+
+    _Resource __res;
+};
+
+_LIBCPP_SAFE_STATIC __global_resource<__new_delete_memory_resource_imp> __new_delete_res;
+_LIBCPP_SAFE_STATIC __global_resource<__null_memory_resource_imp> __null_res;
+
+} // end namespace
+
+memory_resource* new_delete_resource() _NOEXCEPT
+{
+    return &__new_delete_res.__res;
+}
+
+memory_resource* null_memory_resource() _NOEXCEPT
+{
+    return &__null_res.__res;
+}
+
+// default_memory_resource()
+
+static memory_resource* __default_memory_resource(bool __set = false,
+                                                  memory_resource* __new_res = nullptr) _NOEXCEPT
+{
+#ifndef _LIBCPP_HAS_NO_ATOMIC_HEADER
+    _LIBCPP_SAFE_STATIC static atomic<memory_resource*> __res(&__new_delete_res.__res);
+    if (__set)
+    {
+        __new_res = __new_res ? __new_res : new_delete_resource();
+        return __res.exchange(__new_res, memory_order_acq_rel);
+    }
+    return __res.load(memory_order_acquire);
+#elif !defined(_LIBCPP_HAS_NO_THREADS)
+    _LIBCPP_SAFE_STATIC static memory_resource* __res = &__new_delete_res.__res;
+    static mutex __res_lock;
+    lock_guard<mutex> __guard(__res_lock);
+    if (__set)
+    {
+        __new_res = __new_res ? __new_res : new_delete_resource();
+        memory_resource* __old_res = __res;
+        __res = __new_res;
+        return __old_res;
+    }
+    return __res;
+#else
+    _LIBCPP_SAFE_STATIC static memory_resource* __res = &__new_delete_res.__res;
+    if (__set)
+    {
+        __new_res = __new_res ? __new_res : new_delete_resource();
+        memory_resource* __old_res = __res;
+        __res = __new_res;
+        return __old_res;
+    }
+    return __res;
+#endif
+}
+
+memory_resource* get_default_resource() _NOEXCEPT
+{
+    return __default_memory_resource();
+}
+
+memory_resource* set_default_resource(memory_resource* __new_res) _NOEXCEPT
+{
+    return __default_memory_resource(true, __new_res);
+}
+
+// 23.12.5, mem.res.pool
+
+static const size_t __max_chunk_align = alignof(max_align_t);
+
+static size_t __round_up(size_t __n, size_t __align) _NOEXCEPT
+{
+    return (__n + __align - 1) & ~(__align - 1);
+}
+
+static int __log2_ceil(size_t __n) _NOEXCEPT
+{
+    int __log2 = 0;
+    while ((size_t(1) << __log2) < __n)
+        ++__log2;
+    return __log2;
+}
+
+static const int __log2_smallest_block_size = 3;
+static const size_t __default_largest_block_size = size_t(1) << 20;
+static const size_t __max_largest_block_size = size_t(1) << 30;
+static const size_t __default_max_blocks_per_chunk = size_t(1) << 20;
+static const size_t __initial_chunk_bytes = 1024;
+
+// A pool of blocks of one size. Freed blocks are kept in a free list, and
+// new blocks are carved from the most recent chunk as they are needed.
+class unsynchronized_pool_resource::__fixed_pool
+{
+    struct __chunk_header
+    {
+        __chunk_header* __next_;
+        size_t __bytes_;
+    };
+
+    struct __free_block
+    {
+        __free_block* __next_;
+    };
+
+    static const size_t __header_size =
+        (sizeof(__chunk_header) + __max_chunk_align - 1) & ~(__max_chunk_align - 1);
+
+public:
+    explicit __fixed_pool(size_t __block_size) _NOEXCEPT
+      : __chunks_(nullptr), __free_(nullptr), __cur_(nullptr), __end_(nullptr),
+        __block_size_(__block_size),
+        __next_blocks_(__initial_chunk_bytes > __block_size
+                           ? __initial_chunk_bytes / __block_size : 1)
+    {}
+
+    void* __allocate(memory_resource* __upstream, size_t __max_blocks)
+    {
+        if (__free_ != nullptr)
+        {
+            __free_block* __b = __free_;
+            __free_ = __b->__next_;
+            return __b;
+        }
+        if (static_cast<size_t>(__end_ - __cur_) < __block_size_)
+            __allocate_chunk(__upstream, __max_blocks);
+        void* __p = __cur_;
+        __cur_ += __block_size_;
+        return __p;
+    }
+
+    void __deallocate(void* __p) _NOEXCEPT
+    {
+        __free_block* __b = static_cast<__free_block*>(__p);
+        __b->__next_ = __free_;
+        __free_ = __b;
+    }
+
+    void __release(memory_resource* __upstream) _NOEXCEPT
+    {
+        while (__chunks_ != nullptr)
+        {
+            __chunk_header* __next = __chunks_->__next_;
+            __upstream->deallocate(__chunks_, __chunks_->__bytes_, __max_chunk_align);
+            __chunks_ = __next;
+        }
+        __free_ = nullptr;
+        __cur_ = __end_ = nullptr;
+    }
+
+private:
+    void __allocate_chunk(memory_resource* __upstream, size_t __max_blocks)
+    {
+        size_t __blocks = __next_blocks_ < __max_blocks ? __next_blocks_ : __max_blocks;
+        const size_t __limit =
+            (numeric_limits<size_t>::max() - __header_size) / __block_size_;
+        if (__blocks > __limit)
+            __blocks = __limit;
+        const size_t __bytes = __header_size + __blocks * __block_size_;
+        char* __mem = static_cast<char*>(__upstream->allocate(__bytes, __max_chunk_align));
+
+        __chunk_header* __h = reinterpret_cast<__chunk_header*>(__mem);
+        __h->__next_ = __chunks_;
+        __h->__bytes_ = __bytes;
+        __chunks_ = __h;
+        __cur_ = __mem + __header_size;
+        __end_ = __cur_ + __blocks * __block_size_;
+        if (__blocks < __max_blocks)
+            __next_blocks_ = __blocks <= __max_blocks / 2 ? 2 * __blocks : __max_blocks;
+    }
+
+    __chunk_header* __chunks_;
+    __free_block* __free_;
+    char* __cur_;
+    char* __end_;
+    size_t __block_size_;
+    size_t __next_blocks_;
+};
+
+// The requests that no pool serves, in a list so that release() can free
+// them. The header follows the block so that it doesn't disturb the
+// alignment of the block.
+struct unsynchronized_pool_resource::__adhoc_header
+{
+    __adhoc_header* __next_;
+    __adhoc_header* __prev_;
+    void* __start_;
+    size_t __bytes_;
+    size_t __align_;
+
+    static size_t __offset(size_t __bytes) _NOEXCEPT
+        { return __round_up(__bytes, alignof(__adhoc_header)); }
+};
+
+unsynchronized_pool_resource::unsynchronized_pool_resource(
+    const pool_options& __opts, memory_resource* __upstream)
+  : __res_(__upstream), __adhoc_(nullptr), __fixed_pools_(nullptr),
+    __num_fixed_pools_(0), __max_blocks_per_chunk_(__opts.max_blocks_per_chunk)
+{
+    if (__max_blocks_per_chunk_ == 0 ||
+        __max_blocks_per_chunk_ > __default_max_blocks_per_chunk)
+        __max_blocks_per_chunk_ = __default_max_blocks_per_chunk;
+
+    size_t __largest = __opts.largest_required_pool_block;
+    if (__largest == 0)
+        __largest = __default_largest_block_size;
+    else if (__largest > __max_largest_block_size)
+        __largest = __max_largest_block_size;
+    __num_fixed_pools_ = 1;
+    if (__largest > (size_t(1) << __log2_smallest_block_size))
+        __num_fixed_pools_ = __log2_ceil(__largest) - __log2_smallest_block_size + 1;
+}
+
+unsynchronized_pool_resource::~unsynchronized_pool_resource()
+{
+    release();
+}
+
+void unsynchronized_pool_resource::release()
+{
+    while (__adhoc_ != nullptr)
+    {
+        __adhoc_header* __next = __adhoc_->__next_;
+        __res_->deallocate(__adhoc_->__start_, __adhoc_->__bytes_, __adhoc_->__align_);
+        __adhoc_ = __next;
+    }
+    if (__fixed_pools_ != nullptr)
+    {
+        for (int __i = 0; __i != __num_fixed_pools_; ++__i)
+        {
+            __fixed_pools_[__i].__release(__res_);
+            __fixed_pools_[__i].~__fixed_pool();
+        }
+        __res_->deallocate(__fixed_pools_, __num_fixed_pools_ * sizeof(__fixed_pool),
+                           alignof(__fixed_pool));
+        __fixed_pools_ = nullptr;
+    }
+}
+
+pool_options unsynchronized_pool_resource::options() const
+{
+    pool_options __opts;
+    __opts.max_blocks_per_chunk = __max_blocks_per_chunk_;
+    __opts.largest_required_pool_block =
+        size_t(1) << (__num_fixed_pools_ - 1 + __log2_smallest_block_size);
+    return __opts;
+}
+
+// Returns the pool that serves the request, or -1 for an ad hoc request.
+int unsynchronized_pool_resource::__pool_index(size_t __bytes, size_t __align) const
+{
+    if (__align > __max_chunk_align)
+        return -1;
+    const size_t __size = __bytes > __align ? __bytes : __align;
+    const int __log2 = __log2_ceil(__size);
+    const int __i = __log2 > __log2_smallest_block_size
+                        ? __log2 - __log2_smallest_block_size : 0;
+    return __i < __num_fixed_pools_ ? __i : -1;
+}
+
+void* unsynchronized_pool_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    const int __i = __pool_index(__bytes, __align);
+    if (__i == -1)
+    {
+        const size_t __offset = __adhoc_header::__offset(__bytes);
+        if (__offset < __bytes ||
+            __offset > numeric_limits<size_t>::max() - sizeof(__adhoc_header))
+            __throw_bad_alloc();
+        const size_t __total = __offset + sizeof(__adhoc_header);
+        const size_t __total_align =
+            __align > alignof(__adhoc_header) ? __align : alignof(__adhoc_header);
+        char* __p = static_cast<char*>(__res_->allocate(__total, __total_align));
+
+        __adhoc_header* __h = reinterpret_cast<__adhoc_header*>(__p + __offset);
+        __h->__next_ = __adhoc_;
+        __h->__prev_ = nullptr;
+        __h->__start_ = __p;
+        __h->__bytes_ = __total;
+        __h->__align_ = __total_align;
+        if (__adhoc_ != nullptr)
+            __adhoc_->__prev_ = __h;
+        __adhoc_ = __h;
+        return __p;
+    }
+
+    if (__fixed_pools_ == nullptr)
+    {
+        __fixed_pools_ = static_cast<__fixed_pool*>(__res_->allocate(
+            __num_fixed_pools_ * sizeof(__fixed_pool), alignof(__fixed_pool)));
+        for (int __j = 0; __j != __num_fixed_pools_; ++__j)
+            ::new ((void*)(__fixed_pools_ + __j))
+                __fixed_pool(size_t(1) << (__j + __log2_smallest_block_size));
+    }
+    return __fixed_pools_[__i].__allocate(__res_, __max_blocks_per_chunk_);
+}
+
+void unsynchronized_pool_resource::do_deallocate(void* __p, size_t __bytes, size_t __align)
+{
+    const int __i = __pool_index(__bytes, __align);
+    if (__i == -1)
+    {
+        __adhoc_header* __h = reinterpret_cast<__adhoc_header*>(
+            static_cast<char*>(__p) + __adhoc_header::__offset(__bytes));
+        if (__h->__prev_ != nullptr)
+            __h->__prev_->__next_ = __h->__next_;
+        else
+            __adhoc_ = __h->__next_;
+        if (__h->__next_ != nullptr)
+            __h->__next_->__prev_ = __h->__prev_;
+        __res_->deallocate(__h->__start_, __h->__bytes_, __h->__align_);
+        return;
+    }
+    _LIBCPP_ASSERT(__fixed_pools_ != nullptr, "deallocating a block that was not allocated");
+    __fixed_pools_[__i].__deallocate(__p);
+}
+
+// 23.12.6, mem.res.monotonic.buffer
+
+struct monotonic_buffer_resource::__chunk_header
+{
+    __chunk_header* __next_;
+    size_t __bytes_;
+    size_t __align_;
+};
+
+monotonic_buffer_resource::~monotonic_buffer_resource()
+{
+    release();
+}
+
+void monotonic_buffer_resource::release()
+{
+    while (__chunks_ != nullptr)
+    {
+        __chunk_header* __next = __chunks_->__next_;
+        __res_->deallocate(__chunks_, __chunks_->__bytes_, __chunks_->__align_);
+        __chunks_ = __next;
+    }
+    __cur_ = __initial_buffer_;
+    __end_ = __initial_buffer_ + __initial_size_;
+}
+
+void* monotonic_buffer_resource::__allocate_from_new_chunk(size_t __bytes, size_t __align)
+{
+    const size_t __chunk_align = __align > __max_chunk_align ? __align : __max_chunk_align;
+    const size_t __header_size = __round_up(sizeof(__chunk_header), __chunk_align);
+    if (__bytes > numeric_limits<size_t>::max() - __header_size)
+        __throw_bad_alloc();
+    size_t __size = __header_size + __bytes;
+    if (__size < __next_size_)
+        __size = __next_size_;
+    char* __mem = static_cast<char*>(__res_->allocate(__size, __chunk_align));
+
+    __chunk_header* __h = reinterpret_cast<__chunk_header*>(__mem);
+    __h->__next_ = __chunks_;
+    __h->__bytes_ = __size;
+    __h->__align_ = __chunk_align;
+    __chunks_ = __h;
+    __next_size_ = __growth(__size);
+
+    char* __p = __mem + __header_size;
+    __cur_ = __p + __bytes;
+    __end_ = __mem + __size;
+    return __p;
+}
+
+} // namespace pmr
+
+_LIBCPP_END_NAMESPACE_STD
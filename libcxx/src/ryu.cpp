@@ -0,0 +1,524 @@
+//===---------------------------- ryu.cpp ---------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/ryu/ryu.h"
+#include "include/ryu/d2s_full_table.h"
+#include "bit"
+#include <string.h>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace __ryu {
+
+namespace {
+
+static constexpr int DOUBLE_POW5_INV_BITCOUNT = 125;
+static constexpr int DOUBLE_POW5_BITCOUNT = 125;
+static constexpr int FLOAT_POW5_INV_BITCOUNT = DOUBLE_POW5_INV_BITCOUNT - 64;
+static constexpr int FLOAT_POW5_BITCOUNT = DOUBLE_POW5_BITCOUNT - 64;
+
+// Returns e == 0 ? 1 : ceil(log_2(5^e)); requires 0 <= e <= 3528.
+inline int32_t pow5bits(const int32_t e) {
+    return static_cast<int32_t>(((static_cast<uint32_t>(e) * 1217359) >> 19) + 1);
+}
+
+// Returns floor(log_2(5^e)); requires 0 <= e <= 3528.
+inline int32_t log2pow5(const int32_t e) {
+    return static_cast<int32_t>((static_cast<uint32_t>(e) * 1217359) >> 19);
+}
+
+// Returns floor(log_10(2^e)); requires 0 <= e <= 1650.
+inline uint32_t log10Pow2(const int32_t e) {
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
+
+// Returns floor(log_10(5^e)); requires 0 <= e <= 2620.
+inline uint32_t log10Pow5(const int32_t e) {
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
+}
+
+inline int32_t floorLog2(const uint64_t v) {
+    return 63 - __libcpp_clz(static_cast<unsigned long long>(v));
+}
+
+inline uint32_t pow5Factor(uint64_t value) {
+    uint32_t count = 0;
+    for (; value % 5 == 0; value /= 5)
+        ++count;
+    return count;
+}
+
+// Returns true if value is divisible by 5^p.
+inline bool multipleOfPowerOf5(const uint64_t value, const uint32_t p) {
+    return pow5Factor(value) >= p;
+}
+
+// Returns true if value is divisible by 2^p; requires p < 64.
+inline bool multipleOfPowerOf2(const uint64_t value, const uint32_t p) {
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+// Returns floor(m * mul / 2^j), where mul is a 128-bit {low, high} pair;
+// requires 64 < j < 128.
+inline uint64_t mulShift64(const uint64_t m, const uint64_t* const mul,
+                           const int32_t j) {
+#ifndef _LIBCPP_HAS_NO_INT128
+    const __uint128_t b0 = static_cast<__uint128_t>(m) * mul[0];
+    const __uint128_t b2 = static_cast<__uint128_t>(m) * mul[1];
+    return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+    // Multiplies the two halves of each factor separately.
+    auto umul128 = [](uint64_t a, uint64_t b, uint64_t* hi) {
+        const uint64_t aLo = static_cast<uint32_t>(a), aHi = a >> 32;
+        const uint64_t bLo = static_cast<uint32_t>(b), bHi = b >> 32;
+        const uint64_t b00 = aLo * bLo, b01 = aLo * bHi;
+        const uint64_t b10 = aHi * bLo, b11 = aHi * bHi;
+        const uint64_t mid1 = b10 + (b00 >> 32);
+        const uint64_t mid2 = b01 + static_cast<uint32_t>(mid1);
+        *hi = b11 + (mid1 >> 32) + (mid2 >> 32);
+        return (mid2 << 32) | static_cast<uint32_t>(b00);
+    };
+    uint64_t high1;
+    const uint64_t low1 = umul128(m, mul[1], &high1);
+    uint64_t high0;
+    umul128(m, mul[0], &high0);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    const int32_t dist = j - 64;
+    return (high1 << (64 - dist)) | (sum >> dist);
+#endif
+}
+
+// Returns floor(m * factor / 2^shift); requires 32 < shift < 96.
+inline uint32_t mulShift32(const uint32_t m, const uint64_t factor,
+                           const int32_t shift) {
+    const uint64_t bits0 = static_cast<uint64_t>(m) * static_cast<uint32_t>(factor);
+    const uint64_t bits1 = static_cast<uint64_t>(m) * (factor >> 32);
+    const uint64_t sum = (bits0 >> 32) + bits1;
+    return static_cast<uint32_t>(sum >> (shift - 32));
+}
+
+inline uint32_t mulPow5InvDivPow2(const uint32_t m, const uint32_t q,
+                                  const int32_t j) {
+    return mulShift32(m, __DOUBLE_POW5_INV_SPLIT[q][1] + 1, j);
+}
+
+inline uint32_t mulPow5divPow2(const uint32_t m, const uint32_t i,
+                               const int32_t j) {
+    return mulShift32(m, __DOUBLE_POW5_SPLIT[i][1], j);
+}
+
+template <class _To, class _From>
+inline _To bitCast(const _From from) {
+    static_assert(sizeof(_To) == sizeof(_From), "");
+    _To to;
+    memcpy(&to, &from, sizeof(to));
+    return to;
+}
+
+} // namespace
+
+// Finds the shortest decimal in the interval of values that round to the
+// double, in four steps:
+//
+//   1. Decode the double into m2 * 2^e2.
+//   2. Determine the interval [mm, mp] of values that round to it, scaled by
+//      four so that the bounds are integers.
+//   3. Convert the interval and the value to a decimal power base,
+//      vm * 10^e10, vr * 10^e10 and vp * 10^e10, keeping track of whether the
+//      conversion was exact.
+//   4. Drop the digits that vm and vp have in common with vr, rounding vr
+//      to the nearest.
+__floating_decimal_64 __d2d(const uint64_t ieeeMantissa,
+                            const uint32_t ieeeExponent) {
+    int32_t e2;
+    uint64_t m2;
+    if (ieeeExponent == 0) {
+        // The -2 makes room for the interval bounds.
+        e2 = 1 - __DOUBLE_BIAS - __DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieeeMantissa;
+    } else {
+        e2 = static_cast<int32_t>(ieeeExponent) - __DOUBLE_BIAS -
+             __DOUBLE_MANTISSA_BITS - 2;
+        m2 = (uint64_t(1) << __DOUBLE_MANTISSA_BITS) | ieeeMantissa;
+    }
+    const bool even = (m2 & 1) == 0;
+    const bool acceptBounds = even;
+
+    // Step 2. The lower bound is closer if m2 is a power of two, except for
+    // the smallest normal exponent.
+    const uint64_t mv = 4 * m2;
+    const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+    const uint64_t mp = 4 * m2 + 2;
+    const uint64_t mm = 4 * m2 - 1 - mmShift;
+
+    // Step 3.
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    if (e2 >= 0) {
+        // This is max(0, log10Pow2(e2) - 1), one digit more than needed so
+        // that the last removed digit is known.
+        const uint32_t q = log10Pow2(e2) - (e2 > 3);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = DOUBLE_POW5_INV_BITCOUNT + pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mulShift64(mv, __DOUBLE_POW5_INV_SPLIT[q], i);
+        vp = mulShift64(mp, __DOUBLE_POW5_INV_SPLIT[q], i);
+        vm = mulShift64(mm, __DOUBLE_POW5_INV_SPLIT[q], i);
+        if (q <= 21) {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            } else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+            } else {
+                vp -= multipleOfPowerOf5(mp, q);
+            }
+        }
+    } else {
+        // This is max(0, log10Pow5(-e2) - 1).
+        const uint32_t q = log10Pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - DOUBLE_POW5_BITCOUNT;
+        const int32_t j = static_cast<int32_t>(q) - k;
+        vr = mulShift64(mv, __DOUBLE_POW5_SPLIT[i], j);
+        vp = mulShift64(mp, __DOUBLE_POW5_SPLIT[i], j);
+        vm = mulShift64(mm, __DOUBLE_POW5_SPLIT[i], j);
+        if (q <= 1) {
+            // {vr,vp,vm} is trailing zeros if {mv,mp,mm} has at least q
+            // trailing 0 bits. mv = 4 * m2, so it always has at least two.
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                // mm = mv - 1 - mmShift has 1 trailing 0 bit iff mmShift == 1.
+                vmIsTrailingZeros = mmShift == 1;
+            } else {
+                // mp = mv + 2 always has at least one trailing 0 bit.
+                --vp;
+            }
+        } else if (q < 63) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // Step 4.
+    int32_t removed = 0;
+    uint8_t lastRemovedDigit = 0;
+    uint64_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        // The general case, which happens rarely (~0.7%).
+        for (;;) {
+            const uint64_t vpDiv10 = vp / 10;
+            const uint64_t vmDiv10 = vm / 10;
+            if (vpDiv10 <= vmDiv10)
+                break;
+            const uint32_t vmMod10 = static_cast<uint32_t>(vm - 10 * vmDiv10);
+            const uint64_t vrDiv10 = vr / 10;
+            const uint32_t vrMod10 = static_cast<uint32_t>(vr - 10 * vrDiv10);
+            vmIsTrailingZeros &= vmMod10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = static_cast<uint8_t>(vrMod10);
+            vr = vrDiv10;
+            vp = vpDiv10;
+            vm = vmDiv10;
+            ++removed;
+        }
+        if (vmIsTrailingZeros) {
+            for (;;) {
+                const uint64_t vmDiv10 = vm / 10;
+                const uint32_t vmMod10 = static_cast<uint32_t>(vm - 10 * vmDiv10);
+                if (vmMod10 != 0)
+                    break;
+                const uint64_t vpDiv10 = vp / 10;
+                const uint64_t vrDiv10 = vr / 10;
+                const uint32_t vrMod10 = static_cast<uint32_t>(vr - 10 * vrDiv10);
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint8_t>(vrMod10);
+                vr = vrDiv10;
+                vp = vpDiv10;
+                vm = vmDiv10;
+                ++removed;
+            }
+        }
+        // Round to even if the exact number is .....50..0.
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+            lastRemovedDigit = 4;
+        // Take vr + 1 if vr is outside the bounds or needs to be rounded up.
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                       lastRemovedDigit >= 5);
+    } else {
+        // The common case (~99.3%), which removes two digits at a time while
+        // it can.
+        bool roundUp = false;
+        const uint64_t vpDiv100 = vp / 100;
+        const uint64_t vmDiv100 = vm / 100;
+        if (vpDiv100 > vmDiv100) {
+            const uint64_t vrDiv100 = vr / 100;
+            const uint32_t vrMod100 = static_cast<uint32_t>(vr - 100 * vrDiv100);
+            roundUp = vrMod100 >= 50;
+            vr = vrDiv100;
+            vp = vpDiv100;
+            vm = vmDiv100;
+            removed += 2;
+        }
+        for (;;) {
+            const uint64_t vpDiv10 = vp / 10;
+            const uint64_t vmDiv10 = vm / 10;
+            if (vpDiv10 <= vmDiv10)
+                break;
+            const uint64_t vrDiv10 = vr / 10;
+            const uint32_t vrMod10 = static_cast<uint32_t>(vr - 10 * vrDiv10);
+            roundUp = vrMod10 >= 5;
+            vr = vrDiv10;
+            vp = vpDiv10;
+            vm = vmDiv10;
+            ++removed;
+        }
+        output = vr + (vr == vm || roundUp);
+    }
+
+    __floating_decimal_64 fd;
+    fd.__exponent = e10 + removed;
+    fd.__mantissa = output;
+    return fd;
+}
+
+// The same steps as __d2d, in 32-bit arithmetic.
+__floating_decimal_32 __f2d(const uint32_t ieeeMantissa,
+                            const uint32_t ieeeExponent) {
+    int32_t e2;
+    uint32_t m2;
+    if (ieeeExponent == 0) {
+        e2 = 1 - __FLOAT_BIAS - __FLOAT_MANTISSA_BITS - 2;
+        m2 = ieeeMantissa;
+    } else {
+        e2 = static_cast<int32_t>(ieeeExponent) - __FLOAT_BIAS -
+             __FLOAT_MANTISSA_BITS - 2;
+        m2 = (uint32_t(1) << __FLOAT_MANTISSA_BITS) | ieeeMantissa;
+    }
+    const bool even = (m2 & 1) == 0;
+    const bool acceptBounds = even;
+
+    // Step 2.
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = 4 * m2 + 2;
+    const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+    const uint32_t mm = 4 * m2 - 1 - mmShift;
+
+    // Step 3.
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    uint8_t lastRemovedDigit = 0;
+    if (e2 >= 0) {
+        const uint32_t q = log10Pow2(e2);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = FLOAT_POW5_INV_BITCOUNT + pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mulPow5InvDivPow2(mv, q, i);
+        vp = mulPow5InvDivPow2(mp, q, i);
+        vm = mulPow5InvDivPow2(mm, q, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // One removed digit is needed even if the loop below removes
+            // none. Using q - 1 above would instead need 33 bits for vp.
+            const int32_t l = FLOAT_POW5_INV_BITCOUNT + pow5bits(static_cast<int32_t>(q - 1)) - 1;
+            lastRemovedDigit = static_cast<uint8_t>(
+                mulPow5InvDivPow2(mv, q - 1, -e2 + static_cast<int32_t>(q) - 1 + l) % 10);
+        }
+        if (q <= 9) {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            } else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+            } else {
+                vp -= multipleOfPowerOf5(mp, q);
+            }
+        }
+    } else {
+        const uint32_t q = log10Pow5(-e2);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - FLOAT_POW5_BITCOUNT;
+        int32_t j = static_cast<int32_t>(q) - k;
+        vr = mulPow5divPow2(mv, static_cast<uint32_t>(i), j);
+        vp = mulPow5divPow2(mp, static_cast<uint32_t>(i), j);
+        vm = mulPow5divPow2(mm, static_cast<uint32_t>(i), j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = static_cast<int32_t>(q) - 1 - (pow5bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            lastRemovedDigit = static_cast<uint8_t>(
+                mulPow5divPow2(mv, static_cast<uint32_t>(i + 1), j) % 10);
+        }
+        if (q <= 1) {
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                vmIsTrailingZeros = mmShift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 31) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+        }
+    }
+
+    // Step 4.
+    int32_t removed = 0;
+    uint32_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+            lastRemovedDigit = 4;
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                       lastRemovedDigit >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || lastRemovedDigit >= 5);
+    }
+
+    __floating_decimal_32 fd;
+    fd.__exponent = e10 + removed;
+    fd.__mantissa = output;
+    return fd;
+}
+
+// Computes the DOUBLE_MANTISSA_BITS + 1 or + 2 most significant bits of
+// m10 * 10^e10 and whether the bits below them are all zero, then rounds
+// them to the precision of the result.
+double __s2d(const uint64_t m10, const int32_t m10digits, const int32_t e10) {
+    // The number is less than 1e-324, which rounds to zero, or larger than
+    // 1e+309, which rounds to infinity.
+    if (m10digits + e10 <= -324)
+        return 0.0;
+    if (m10digits + e10 >= 310)
+        return bitCast<double>(uint64_t(0x7ff) << __DOUBLE_MANTISSA_BITS);
+
+    int32_t e2;
+    uint64_t m2;
+    bool trailingZeros;
+    if (e10 >= 0) {
+        // Choose e2 so that m2 gets at least DOUBLE_MANTISSA_BITS + 1 bits,
+        // using floor(log2(5^e10)) to rather get one bit too many.
+        e2 = floorLog2(m10) + e10 + log2pow5(e10) - (__DOUBLE_MANTISSA_BITS + 1);
+        // m2 = floor(m10 * 5^e10 / 2^(e2 - e10)).
+        const int32_t j = e2 - e10 - pow5bits(e10) + DOUBLE_POW5_BITCOUNT;
+        m2 = mulShift64(m10, __DOUBLE_POW5_SPLIT[e10], j);
+        // The division is exact only if 2^e2 divides m10 * 10^e10.
+        trailingZeros = e2 < e10 ||
+                        (e2 - e10 < 64 && multipleOfPowerOf2(m10, e2 - e10));
+    } else {
+        e2 = floorLog2(m10) + e10 - pow5bits(-e10) - (__DOUBLE_MANTISSA_BITS + 1);
+        const int32_t j = e2 - e10 + pow5bits(-e10) - 1 + DOUBLE_POW5_INV_BITCOUNT;
+        m2 = mulShift64(m10, __DOUBLE_POW5_INV_SPLIT[-e10], j);
+        trailingZeros = multipleOfPowerOf5(m10, static_cast<uint32_t>(-e10));
+    }
+
+    // The final biased exponent, 0 for subnormals.
+    int32_t ieeeE2 = e2 + __DOUBLE_BIAS + floorLog2(m2);
+    if (ieeeE2 < 0)
+        ieeeE2 = 0;
+    if (ieeeE2 > 0x7fe)
+        return bitCast<double>(uint64_t(0x7ff) << __DOUBLE_MANTISSA_BITS);
+
+    // Shift m2 to the precision of the result, rounding to nearest, ties to
+    // even. The bits below the last removed one are only zero if they were
+    // zero in the exact product as well.
+    const int32_t shift = (ieeeE2 == 0 ? 1 : ieeeE2) - e2 - __DOUBLE_BIAS -
+                          __DOUBLE_MANTISSA_BITS;
+    if (shift > 63)
+        return 0.0;
+    trailingZeros &= (m2 & ((uint64_t(1) << (shift - 1)) - 1)) == 0;
+    const uint64_t lastRemovedBit = (m2 >> (shift - 1)) & 1;
+    const bool roundUp =
+        lastRemovedBit != 0 && (!trailingZeros || ((m2 >> shift) & 1) != 0);
+
+    uint64_t ieeeM2 = (m2 >> shift) + roundUp;
+    ieeeM2 &= (uint64_t(1) << __DOUBLE_MANTISSA_BITS) - 1;
+    // Rounding up may carry into the exponent, up to infinity.
+    if (ieeeM2 == 0 && roundUp)
+        ++ieeeE2;
+    return bitCast<double>(
+        (static_cast<uint64_t>(ieeeE2) << __DOUBLE_MANTISSA_BITS) | ieeeM2);
+}
+
+// The same steps as __s2d, in 32-bit arithmetic.
+float __s2f(const uint32_t m10, const int32_t m10digits, const int32_t e10) {
+    if (m10digits + e10 <= -46)
+        return 0.0f;
+    if (m10digits + e10 >= 40)
+        return bitCast<float>(uint32_t(0xff) << __FLOAT_MANTISSA_BITS);
+
+    int32_t e2;
+    uint32_t m2;
+    bool trailingZeros;
+    if (e10 >= 0) {
+        e2 = floorLog2(m10) + e10 + log2pow5(e10) - (__FLOAT_MANTISSA_BITS + 1);
+        const int32_t j = e2 - e10 - pow5bits(e10) + FLOAT_POW5_BITCOUNT;
+        m2 = mulPow5divPow2(m10, static_cast<uint32_t>(e10), j);
+        trailingZeros = e2 < e10 ||
+                        (e2 - e10 < 32 && multipleOfPowerOf2(m10, e2 - e10));
+    } else {
+        e2 = floorLog2(m10) + e10 - pow5bits(-e10) - (__FLOAT_MANTISSA_BITS + 1);
+        const int32_t j = e2 - e10 + pow5bits(-e10) - 1 + FLOAT_POW5_INV_BITCOUNT;
+        m2 = mulPow5InvDivPow2(m10, static_cast<uint32_t>(-e10), j);
+        trailingZeros = multipleOfPowerOf5(m10, static_cast<uint32_t>(-e10));
+    }
+
+    int32_t ieeeE2 = e2 + __FLOAT_BIAS + floorLog2(m2);
+    if (ieeeE2 < 0)
+        ieeeE2 = 0;
+    if (ieeeE2 > 0xfe)
+        return bitCast<float>(uint32_t(0xff) << __FLOAT_MANTISSA_BITS);
+
+    const int32_t shift = (ieeeE2 == 0 ? 1 : ieeeE2) - e2 - __FLOAT_BIAS -
+                          __FLOAT_MANTISSA_BITS;
+    if (shift > 31)
+        return 0.0f;
+    trailingZeros &= (m2 & ((uint32_t(1) << (shift - 1)) - 1)) == 0;
+    const uint32_t lastRemovedBit = (m2 >> (shift - 1)) & 1;
+    const bool roundUp =
+        lastRemovedBit != 0 && (!trailingZeros || ((m2 >> shift) & 1) != 0);
+
+    uint32_t ieeeM2 = (m2 >> shift) + roundUp;
+    ieeeM2 &= (uint32_t(1) << __FLOAT_MANTISSA_BITS) - 1;
+    if (ieeeM2 == 0 && roundUp)
+        ++ieeeE2;
+    return bitCast<float>(
+        (static_cast<uint32_t>(ieeeE2) << __FLOAT_MANTISSA_BITS) | ieeeM2);
+}
+
+} // namespace __ryu
+
+_LIBCPP_END_NAMESPACE_STD
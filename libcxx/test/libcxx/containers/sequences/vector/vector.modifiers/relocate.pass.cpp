@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// <vector>
+
+// Growing a vector of trivially relocatable elements copies their bytes
+// instead of moving and destroying them, unless the allocator customizes
+// construct or destroy.
+
+#include <vector>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+#include "test_macros.h"
+
+struct Counted {
+  typedef Counted __trivially_relocatable;
+
+  static int moves;
+  static int alive;
+
+  int* value;
+
+  explicit Counted(int v) : value(new int(v)) { ++alive; }
+  Counted(Counted&& other) : value(other.value) {
+    other.value = nullptr;
+    ++moves;
+    ++alive;
+  }
+  Counted& operator=(Counted&& other) {
+    std::swap(value, other.value);
+    ++moves;
+    return *this;
+  }
+  ~Counted() {
+    delete value;
+    --alive;
+  }
+};
+
+int Counted::moves = 0;
+int Counted::alive = 0;
+
+template <class T>
+struct ConstructingAllocator : std::allocator<T> {
+  template <class U>
+  struct rebind { typedef ConstructingAllocator<U> other; };
+
+  ConstructingAllocator() = default;
+  template <class U>
+  ConstructingAllocator(const ConstructingAllocator<U>&) {}
+
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) {
+    ::new ((void*)p) U(std::forward<Args>(args)...);
+  }
+};
+
+template <class Vector>
+void fill_and_check(Vector& v) {
+  for (int i = 0; i != 100; ++i)
+    v.emplace_back(i);
+  v.reserve(1000);
+  v.shrink_to_fit();
+  assert(v.capacity() == 100);
+  v.emplace(v.begin() + 50, -1);
+  assert(v.size() == 101);
+  assert(Counted::alive == 101);
+  for (int i = 0; i != 101; ++i)
+    assert(*v[i].value == (i < 50 ? i : i == 50 ? -1 : i - 1));
+}
+
+int main(int, char**) {
+  {
+    std::vector<Counted> v;
+    fill_and_check(v);
+    assert(Counted::moves == 0);
+  }
+  assert(Counted::alive == 0);
+  Counted::moves = 0;
+  {
+    std::vector<Counted, ConstructingAllocator<Counted> > v;
+    fill_and_check(v);
+    assert(Counted::moves > 0);
+  }
+  assert(Counted::alive == 0);
+
+  return 0;
+}
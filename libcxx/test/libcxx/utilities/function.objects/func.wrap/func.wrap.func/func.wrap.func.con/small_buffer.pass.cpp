@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// <functional>
+
+// class function<R(ArgTypes...)>
+
+// With _LIBCPP_ABI_OPTIMIZED_FUNCTION, small callables that are nothrow move
+// constructible are stored in the function object, even if they are not
+// trivial.
+
+#define _LIBCPP_ABI_OPTIMIZED_FUNCTION
+#include <functional>
+#include <cassert>
+#include <utility>
+
+#include "test_macros.h"
+#include "count_new.hpp"
+
+struct Movable
+{
+  static int count;
+
+  int* value;
+
+  explicit Movable(int* v) : value(v) { ++count; }
+  Movable(const Movable& other) : value(other.value) { ++count; }
+  Movable(Movable&& other) noexcept : value(other.value) {
+    other.value = nullptr;
+    ++count;
+  }
+  ~Movable() { --count; }
+
+  int operator()() const { return *value; }
+};
+
+int Movable::count = 0;
+
+struct ThrowingMove
+{
+  static int count;
+
+  int* value;
+
+  explicit ThrowingMove(int* v) : value(v) { ++count; }
+  ThrowingMove(const ThrowingMove& other) : value(other.value) { ++count; }
+  ~ThrowingMove() { --count; }
+
+  int operator()() const { return *value; }
+};
+
+int ThrowingMove::count = 0;
+
+struct Large
+{
+  int* value;
+  void* padding[8];
+
+  explicit Large(int* v) : value(v) {}
+
+  int operator()() const { return *value; }
+};
+
+int main(int, char**)
+{
+  int one = 1;
+  int two = 2;
+  {
+    globalMemCounter.reset();
+    std::function<int()> f = Movable(&one);
+    assert(globalMemCounter.checkOutstandingNewEq(0));
+    assert(Movable::count == 1);
+    assert(f.target<Movable>());
+    assert(f() == 1);
+
+    std::function<int()> g = f;
+    assert(globalMemCounter.checkOutstandingNewEq(0));
+    assert(Movable::count == 2);
+    assert(g() == 1);
+
+    std::function<int()> h = std::move(f);
+    assert(globalMemCounter.checkOutstandingNewEq(0));
+    assert(Movable::count == 2);
+    assert(!f);
+    assert(h() == 1);
+
+    f = std::move(h);
+    assert(Movable::count == 2);
+    assert(!h);
+    assert(f() == 1);
+  }
+  assert(Movable::count == 0);
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+  {
+    std::function<int()> f = ThrowingMove(&one);
+    assert(globalMemCounter.checkOutstandingNewEq(1));
+    assert(ThrowingMove::count == 1);
+    assert(f() == 1);
+  }
+  assert(ThrowingMove::count == 0);
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+  {
+    // Swapping must move the inline callables rather than their bytes.
+    std::function<int()> f = Movable(&one);
+    std::function<int()> g = Large(&two);
+    assert(globalMemCounter.checkOutstandingNewEq(1));
+    f.swap(g);
+    assert(Movable::count == 1);
+    assert(f.target<Large>());
+    assert(g.target<Movable>());
+    assert(f() == 2);
+    assert(g() == 1);
+
+    std::function<int()> h = Movable(&two);
+    g.swap(h);
+    assert(Movable::count == 2);
+    assert(g() == 2);
+    assert(h() == 1);
+    assert(globalMemCounter.checkOutstandingNewEq(1));
+  }
+  assert(Movable::count == 0);
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// __libcpp_is_trivially_relocatable<Tp>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+struct Trivial { int i; };
+
+struct NonTrivial {
+  NonTrivial(const NonTrivial&);
+  ~NonTrivial();
+};
+
+struct OptIn {
+  typedef OptIn __trivially_relocatable;
+  OptIn(const OptIn&);
+  ~OptIn();
+};
+
+struct DerivedOptIn : OptIn {};
+
+template <class T>
+struct Relocatable : std::__libcpp_is_trivially_relocatable<T> {};
+
+static_assert(( Relocatable<int>::value), "");
+static_assert(( Relocatable<int*>::value), "");
+static_assert(( Relocatable<Trivial>::value), "");
+static_assert((!Relocatable<NonTrivial>::value), "");
+static_assert(( Relocatable<OptIn>::value), "");
+static_assert(( Relocatable<const OptIn>::value), "");
+static_assert((!Relocatable<DerivedOptIn>::value), "");
+
+static_assert(( Relocatable<std::unique_ptr<int> >::value), "");
+static_assert(( Relocatable<std::unique_ptr<int[]> >::value), "");
+static_assert(( Relocatable<std::shared_ptr<int> >::value), "");
+static_assert(( Relocatable<std::weak_ptr<int> >::value), "");
+static_assert(( Relocatable<std::string>::value), "");
+static_assert(( Relocatable<std::vector<NonTrivial> >::value), "");
+static_assert(( Relocatable<std::deque<NonTrivial> >::value), "");
+static_assert(( Relocatable<std::pair<std::string, int> >::value), "");
+static_assert((!Relocatable<std::pair<std::string, NonTrivial> >::value), "");
+
+int main(int, char**) {
+  return 0;
+}
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <execution>
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2,
+//          class UnaryOperation>
+//   ForwardIterator2
+//     transform(ExecutionPolicy&& exec,
+//               ForwardIterator1 first, ForwardIterator1 last,
+//               ForwardIterator2 result, UnaryOperation op);
+// template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2,
+//          class ForwardIterator, class BinaryOperation>
+//   ForwardIterator
+//     transform(ExecutionPolicy&& exec,
+//               ForwardIterator1 first1, ForwardIterator1 last1,
+//               ForwardIterator2 first2, ForwardIterator result,
+//               BinaryOperation binary_op);
+
+#include <execution>
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class InIter, class OutIter, class Policy>
+void test(const Policy& policy, unsigned size)
+{
+    std::vector<int> a(size), b(size);
+    std::iota(a.begin(), a.end(), 0);
+    std::iota(b.begin(), b.end(), 7);
+
+    std::vector<int> out(size);
+    OutIter r = std::transform(policy, InIter(a.data()), InIter(a.data() + size),
+                               OutIter(out.data()), [](int x) { return x * 2; });
+    assert(base(r) == out.data() + size);
+    for (unsigned i = 0; i != size; ++i)
+        assert(out[i] == a[i] * 2);
+
+    out.assign(size, 0);
+    r = std::transform(policy, InIter(a.data()), InIter(a.data() + size),
+                       InIter(b.data()), OutIter(out.data()),
+                       [](int x, int y) { return x * y; });
+    assert(base(r) == out.data() + size);
+    for (unsigned i = 0; i != size; ++i)
+        assert(out[i] == a[i] * b[i]);
+}
+
+template <class InIter, class OutIter, class Policy>
+void test(const Policy& policy)
+{
+    const unsigned sizes[] = {0, 1, 2, 1000, 100000, 100003};
+    for (unsigned size : sizes)
+        test<InIter, OutIter>(policy, size);
+}
+
+template <class Policy>
+void test(const Policy& policy)
+{
+    test<forward_iterator<const int*>, forward_iterator<int*>>(policy);
+    test<random_access_iterator<const int*>, random_access_iterator<int*>>(policy);
+    test<const int*, int*>(policy);
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
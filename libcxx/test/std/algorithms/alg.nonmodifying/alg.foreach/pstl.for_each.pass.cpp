@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <execution>
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// template<class ExecutionPolicy, class ForwardIterator, class Function>
+//   void for_each(ExecutionPolicy&& exec,
+//                 ForwardIterator first, ForwardIterator last, Function f);
+
+#include <execution>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class Iter, class Policy>
+void test(const Policy& policy)
+{
+    const unsigned sizes[] = {0, 1, 2, 1000, 100000, 100003};
+    for (unsigned size : sizes)
+    {
+        std::vector<int> v(size, 1);
+        std::atomic<unsigned> calls(0);
+        std::for_each(policy, Iter(v.data()), Iter(v.data() + size),
+                      [&](int& x) { x += 2; ++calls; });
+        assert(calls == size);
+        assert(std::count(v.begin(), v.end(), 3) == static_cast<long>(size));
+    }
+}
+
+template <class Policy>
+void test(const Policy& policy)
+{
+    test<forward_iterator<int*>>(policy);
+    test<random_access_iterator<int*>>(policy);
+    test<int*>(policy);
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <execution>
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// template<class ExecutionPolicy, class RandomAccessIterator>
+//   void sort(ExecutionPolicy&& exec,
+//             RandomAccessIterator first, RandomAccessIterator last);
+// template<class ExecutionPolicy, class RandomAccessIterator, class Compare>
+//   void sort(ExecutionPolicy&& exec,
+//             RandomAccessIterator first, RandomAccessIterator last,
+//             Compare comp);
+
+#include <execution>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class Policy>
+void test(const Policy& policy, unsigned size)
+{
+    std::mt19937 gen(size);
+    std::vector<int> v(size);
+    for (int& x : v)
+        x = gen() % 1000;
+    std::vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<int> u = v;
+    std::sort(policy, u.begin(), u.end());
+    assert(u == expected);
+
+    u = v;
+    std::sort(policy, u.begin(), u.end(), std::greater<int>());
+    assert(std::equal(u.begin(), u.end(), expected.rbegin()));
+}
+
+template <class Policy>
+void test(const Policy& policy)
+{
+    // Sizes both below and well above the point where the work is split up.
+    const unsigned sizes[] = {0, 1, 2, 17, 1000, 10000, 100000, 100003};
+    for (unsigned size : sizes)
+        test(policy, size);
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <atomic>
+
+// struct atomic_flag
+
+// bool test(memory_order = memory_order_seq_cst) const;
+// void wait(bool, memory_order = memory_order_seq_cst) const;
+// void notify_one();
+// void notify_all();
+//
+// bool atomic_flag_test(const atomic_flag*);
+// void atomic_flag_wait(const atomic_flag*, bool);
+// void atomic_flag_notify_all(atomic_flag*);
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    {
+        std::atomic_flag f = ATOMIC_FLAG_INIT;
+        assert(!f.test());
+        f.wait(true);
+        std::thread t([&](){
+            f.test_and_set();
+            f.notify_one();
+        });
+        f.wait(false);
+        assert(f.test(std::memory_order_acquire));
+        t.join();
+    }
+    {
+        volatile std::atomic_flag f = ATOMIC_FLAG_INIT;
+        f.test_and_set();
+        assert(std::atomic_flag_test(&f));
+        std::thread t([&](){
+            std::atomic_flag_clear(&f);
+            std::atomic_flag_notify_all(&f);
+        });
+        std::atomic_flag_wait_explicit(&f, true, std::memory_order_acquire);
+        assert(!std::atomic_flag_test_explicit(&f, std::memory_order_relaxed));
+        t.join();
+    }
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <atomic>
+
+// template <class T>
+//     void
+//     atomic_wait(const volatile atomic<T>* obj, T old);
+//
+// template <class T>
+//     void
+//     atomic_wait(const atomic<T>* obj, T old);
+//
+// template <class T>
+//     void
+//     atomic_notify_one(volatile atomic<T>* obj);
+//
+// template <class T>
+//     void
+//     atomic_notify_all(atomic<T>* obj);
+
+#include <atomic>
+#include <type_traits>
+#include <cassert>
+#include <thread>
+
+#include "test_macros.h"
+#include "../atomics.types.operations.req/atomic_helpers.h"
+
+template <class T>
+struct TestFn {
+  void operator()() const {
+    typedef std::atomic<T> A;
+    {
+      A t(T(1));
+      t.wait(T(0));
+      std::thread t1([&](){
+        t.store(T(3));
+        t.notify_one();
+      });
+      t.wait(T(1));
+      assert(t.load() == T(3));
+      t1.join();
+    }
+    {
+      volatile A vt(T(2));
+      std::atomic_wait(&vt, T(0));
+      std::thread t2([&](){
+        std::atomic_store(&vt, T(4));
+        std::atomic_notify_all(&vt);
+      });
+      std::atomic_wait_explicit(&vt, T(2), std::memory_order_acquire);
+      assert(std::atomic_load(&vt) == T(4));
+      t2.join();
+    }
+    {
+      // Several threads wait for the same change.
+      A t(T(1));
+      std::thread waiters[4];
+      for (std::thread& w : waiters)
+        w = std::thread([&](){
+          std::atomic_wait(&t, T(1));
+          assert(t.load() == T(5));
+        });
+      t.store(T(5));
+      std::atomic_notify_one(&t);
+      t.notify_all();
+      for (std::thread& w : waiters)
+        w.join();
+    }
+  }
+};
+
+int main(int, char**)
+{
+    TestEachAtomicType<TestFn>()();
+
+  return 0;
+}
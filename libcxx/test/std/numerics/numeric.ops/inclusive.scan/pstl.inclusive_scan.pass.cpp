@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <execution>
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2>
+//   ForwardIterator2
+//     inclusive_scan(ExecutionPolicy&& exec,
+//                    ForwardIterator1 first, ForwardIterator1 last,
+//                    ForwardIterator2 result);
+// template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2,
+//          class BinaryOperation>
+//   ForwardIterator2
+//     inclusive_scan(ExecutionPolicy&& exec,
+//                    ForwardIterator1 first, ForwardIterator1 last,
+//                    ForwardIterator2 result, BinaryOperation binary_op);
+// template<class ExecutionPolicy, class ForwardIterator1, class ForwardIterator2,
+//          class BinaryOperation, class T>
+//   ForwardIterator2
+//     inclusive_scan(ExecutionPolicy&& exec,
+//                    ForwardIterator1 first, ForwardIterator1 last,
+//                    ForwardIterator2 result, BinaryOperation binary_op, T init);
+
+#include <execution>
+#include <numeric>
+#include <cassert>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class InIter, class OutIter, class Policy>
+void test(const Policy& policy, unsigned size)
+{
+    std::vector<long long> v(size);
+    std::iota(v.begin(), v.end(), 1);
+    std::vector<long long> expected(size);
+    std::partial_sum(v.begin(), v.end(), expected.begin());
+
+    InIter first(v.data());
+    InIter last(v.data() + v.size());
+
+    std::vector<long long> out(size);
+    OutIter r = std::inclusive_scan(policy, first, last, OutIter(out.data()));
+    assert(base(r) == out.data() + out.size());
+    assert(out == expected);
+
+    out.assign(size, 0);
+    r = std::inclusive_scan(policy, first, last, OutIter(out.data()),
+                            std::plus<>());
+    assert(base(r) == out.data() + out.size());
+    assert(out == expected);
+
+    out.assign(size, 0);
+    r = std::inclusive_scan(policy, first, last, OutIter(out.data()),
+                            std::plus<>(), 10LL);
+    assert(base(r) == out.data() + out.size());
+    for (unsigned i = 0; i != size; ++i)
+        assert(out[i] == expected[i] + 10);
+}
+
+template <class InIter, class OutIter, class Policy>
+void test(const Policy& policy)
+{
+    const unsigned sizes[] = {0, 1, 2, 1000, 100000, 100003};
+    for (unsigned size : sizes)
+        test<InIter, OutIter>(policy, size);
+}
+
+// The operation is only associative, so the partial results must be combined
+// in order.
+template <class Policy>
+void test_non_commutative(const Policy& policy)
+{
+    std::vector<std::string> v(20000);
+    for (unsigned i = 0; i != v.size(); ++i)
+        v[i] = std::string(1, static_cast<char>('a' + i % 26));
+    std::vector<std::string> out(v.size());
+    std::inclusive_scan(policy, v.begin(), v.end(), out.begin());
+    std::string expected;
+    for (unsigned i = 0; i != v.size(); ++i)
+    {
+        expected += v[i];
+        assert(out[i] == expected);
+    }
+}
+
+template <class Policy>
+void test(const Policy& policy)
+{
+    test<forward_iterator<const long long*>, forward_iterator<long long*>>(policy);
+    test<random_access_iterator<const long long*>, random_access_iterator<long long*>>(policy);
+    test<const long long*, long long*>(policy);
+    test_non_commutative(policy);
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
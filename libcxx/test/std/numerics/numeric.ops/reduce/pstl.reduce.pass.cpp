@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <execution>
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// template<class ExecutionPolicy, class ForwardIterator>
+//   typename iterator_traits<ForwardIterator>::value_type
+//     reduce(ExecutionPolicy&& exec,
+//            ForwardIterator first, ForwardIterator last);
+// template<class ExecutionPolicy, class ForwardIterator, class T>
+//   T reduce(ExecutionPolicy&& exec,
+//            ForwardIterator first, ForwardIterator last, T init);
+// template<class ExecutionPolicy, class ForwardIterator, class T,
+//          class BinaryOperation>
+//   T reduce(ExecutionPolicy&& exec,
+//            ForwardIterator first, ForwardIterator last, T init,
+//            BinaryOperation binary_op);
+
+#include <execution>
+#include <numeric>
+#include <cassert>
+#include <functional>
+#include <vector>
+
+#include "test_macros.h"
+#include "test_iterators.h"
+
+template <class Iter, class Policy>
+void test(const Policy& policy, Iter first, Iter last, long long sum)
+{
+    static_assert(std::is_same_v<int, decltype(std::reduce(policy, first, last))>, "");
+    static_assert(std::is_same_v<long long,
+                  decltype(std::reduce(policy, first, last, 0LL))>, "");
+    assert(std::reduce(policy, first, last) == static_cast<int>(sum));
+    assert(std::reduce(policy, first, last, 5LL) == sum + 5);
+    assert(std::reduce(policy, first, last, 0LL, std::plus<>()) == sum);
+}
+
+template <class Iter, class Policy>
+void test(const Policy& policy)
+{
+    const unsigned sizes[] = {0, 1, 5, 1000, 100000, 100003};
+    for (unsigned size : sizes)
+    {
+        std::vector<int> v(size);
+        std::iota(v.begin(), v.end(), 1);
+        long long sum = static_cast<long long>(size) * (size + 1) / 2;
+        test(policy, Iter(v.data()), Iter(v.data() + v.size()), sum);
+    }
+
+    // An operation that is associative and commutative, but not a sum.
+    std::vector<int> v(50000, 1);
+    v[31337] = 42;
+    assert(std::reduce(policy, Iter(v.data()), Iter(v.data() + v.size()), 0,
+                       [](int x, int y) { return std::max(x, y); }) == 42);
+}
+
+template <class Policy>
+void test(const Policy& policy)
+{
+    test<forward_iterator<const int*>>(policy);
+    test<random_access_iterator<const int*>>(policy);
+    test<const int*>(policy);
+}
+
+int main(int, char**)
+{
+    test(std::execution::seq);
+    test(std::execution::par);
+    test(std::execution::par_unseq);
+
+    return 0;
+}
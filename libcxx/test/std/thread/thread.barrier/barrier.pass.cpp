@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <barrier>
+
+// template<class CompletionFunction = see below>
+// class barrier;
+
+#include <barrier>
+#include <cassert>
+#include <thread>
+#include <utility>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    static_assert(std::barrier<>::max() > 0, "");
+    {
+        std::barrier<> b(1);
+        b.arrive_and_wait();
+        b.wait(b.arrive());
+    }
+    {
+        // Every thread sees the work of the others in the previous phase.
+        const int N = 4;
+        const int Phases = 100;
+        int values[N] = {};
+        int phases = 0;
+        auto completion = [&]() noexcept { ++phases; };
+        std::barrier<decltype(completion)> b(N, completion);
+        std::thread threads[N];
+        for (int i = 0; i != N; ++i)
+            threads[i] = std::thread([&, i](){
+                for (int p = 0; p != Phases; ++p) {
+                    values[i] = p;
+                    b.arrive_and_wait();
+                    assert(phases == 2 * p + 1);
+                    for (int j = 0; j != N; ++j)
+                        assert(values[j] == p);
+                    b.arrive_and_wait();
+                }
+            });
+        for (std::thread& t : threads)
+            t.join();
+        assert(phases == 2 * Phases);
+    }
+    {
+        // A thread that drops out is not waited for in the later phases.
+        int phases = 0;
+        auto completion = [&]() noexcept { ++phases; };
+        std::barrier<decltype(completion)> b(2, completion);
+        std::thread t([&](){ b.arrive_and_drop(); });
+        b.arrive_and_wait();
+        t.join();
+        assert(phases == 1);
+        b.arrive_and_wait();
+        assert(phases == 2);
+    }
+    {
+        // Arrivals can be waited for later, or not at all.
+        std::barrier<> b(2);
+        int value = 0;
+        std::thread t([&](){
+            for (int p = 0; p != 10; ++p) {
+                std::barrier<>::arrival_token token = b.arrive();
+                b.wait(std::move(token));
+            }
+            (void)b.arrive();
+        });
+        for (int p = 0; p != 10; ++p) {
+            ++value;
+            b.arrive_and_wait();
+        }
+        b.arrive_and_wait();
+        t.join();
+        assert(value == 10);
+    }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <latch>
+
+// class latch;
+
+#include <latch>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    static_assert(std::latch::max() > 0, "");
+    {
+        std::latch l(0);
+        assert(l.try_wait());
+        l.wait();
+    }
+    {
+        std::latch l(2);
+        assert(!l.try_wait());
+        l.count_down();
+        assert(!l.try_wait());
+        l.count_down();
+        assert(l.try_wait());
+    }
+    {
+        const int N = 4;
+        std::latch l(N + 1);
+        std::atomic<int> done(0);
+        std::thread threads[N];
+        for (std::thread& t : threads)
+            t = std::thread([&](){
+                ++done;
+                l.arrive_and_wait();
+                assert(done == N);
+            });
+        while (done != N)
+            std::this_thread::yield();
+        l.count_down();
+        l.wait();
+        for (std::thread& t : threads)
+            t.join();
+    }
+    {
+        std::latch l(3);
+        std::thread t([&](){ l.count_down(2); });
+        l.arrive_and_wait(1);
+        assert(l.try_wait());
+        t.join();
+    }
+
+  return 0;
+}
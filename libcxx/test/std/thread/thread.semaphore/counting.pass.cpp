@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <semaphore>
+
+// template<ptrdiff_t least_max_value = implementation-defined>
+// class counting_semaphore;
+//
+// using binary_semaphore = counting_semaphore<1>;
+
+#include <semaphore>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    static_assert(std::binary_semaphore::max() >= 1, "");
+    static_assert(std::counting_semaphore<5>::max() >= 5, "");
+    {
+        std::counting_semaphore<> s(2);
+        assert(s.try_acquire());
+        s.acquire();
+        assert(!s.try_acquire());
+        s.release(2);
+        assert(s.try_acquire());
+        assert(s.try_acquire());
+        assert(!s.try_acquire());
+    }
+    {
+        // Releases wake waiting threads, including ones woken one at a time.
+        const int N = 4;
+        std::counting_semaphore<> s(0);
+        std::atomic<int> acquired(0);
+        std::thread threads[N];
+        for (std::thread& t : threads)
+            t = std::thread([&](){
+                s.acquire();
+                ++acquired;
+            });
+        s.release();
+        s.release(N - 2);
+        s.release();
+        for (std::thread& t : threads)
+            t.join();
+        assert(acquired == N);
+        assert(!s.try_acquire());
+    }
+    {
+        // A binary semaphore used as a lock.
+        std::binary_semaphore s(1);
+        int count = 0;
+        std::thread threads[4];
+        for (std::thread& t : threads)
+            t = std::thread([&](){
+                for (int i = 0; i != 1000; ++i) {
+                    s.acquire();
+                    ++count;
+                    s.release();
+                }
+            });
+        for (std::thread& t : threads)
+            t.join();
+        assert(count == 4000);
+    }
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <semaphore>
+
+// template<class Rep, class Period>
+//     bool try_acquire_for(const chrono::duration<Rep, Period>& rel_time);
+// template<class Clock, class Duration>
+//     bool try_acquire_until(const chrono::time_point<Clock, Duration>& abs_time);
+
+#include <semaphore>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    typedef std::chrono::steady_clock Clock;
+    {
+        std::binary_semaphore s(0);
+        Clock::time_point const start = Clock::now();
+        assert(!s.try_acquire_for(std::chrono::milliseconds(20)));
+        assert(Clock::now() - start >= std::chrono::milliseconds(20));
+        assert(!s.try_acquire_until(Clock::now() - std::chrono::seconds(1)));
+    }
+    {
+        std::binary_semaphore s(1);
+        assert(s.try_acquire_for(std::chrono::seconds(0)));
+        assert(!s.try_acquire_until(Clock::now()));
+    }
+    {
+        std::counting_semaphore<> s(0);
+        std::thread t([&](){
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            s.release();
+        });
+        assert(s.try_acquire_until(Clock::now() + std::chrono::seconds(100)));
+        t.join();
+    }
+
+  return 0;
+}
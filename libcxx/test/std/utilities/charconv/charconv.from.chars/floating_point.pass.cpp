@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// The floating-point overloads are not in any shipped system dylib yet.
+// XFAIL: with_system_cxx_lib=macosx10.15
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// from_chars_result from_chars(const char* first, const char* last,
+//                              float& value,
+//                              chars_format fmt = chars_format::general);
+// from_chars_result from_chars(const char* first, const char* last,
+//                              double& value,
+//                              chars_format fmt = chars_format::general);
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "test_macros.h"
+
+template <class T>
+void test(const char* str, std::chars_format fmt, T expected, size_t used)
+{
+    T value = 12345;
+    std::from_chars_result r =
+        std::from_chars(str, str + strlen(str), value, fmt);
+    assert(r.ec == std::errc());
+    assert(r.ptr == str + used);
+    if (std::isnan(expected))
+    {
+        assert(std::isnan(value));
+        assert(std::signbit(value) == std::signbit(expected));
+    }
+    else
+    {
+        assert(value == expected);
+        assert(std::signbit(value) == std::signbit(expected));
+    }
+}
+
+template <class T>
+void test(const char* str, T expected)
+{
+    test(str, std::chars_format::general, expected, strlen(str));
+}
+
+template <class T>
+void test_error(const char* str, std::chars_format fmt, std::errc ec,
+                size_t used)
+{
+    T value = 12345;
+    std::from_chars_result r =
+        std::from_chars(str, str + strlen(str), value, fmt);
+    assert(r.ec == ec);
+    assert(r.ptr == str + used);
+    assert(value == 12345);
+}
+
+void test_double()
+{
+    typedef std::numeric_limits<double> lim;
+    const std::chars_format general = std::chars_format::general;
+    const std::chars_format fixed = std::chars_format::fixed;
+    const std::chars_format scientific = std::chars_format::scientific;
+    const std::chars_format hex = std::chars_format::hex;
+
+    test("0", 0.0);
+    test("-0", -0.0);
+    test("1", 1.0);
+    test("0.1", 0.1);
+    test("-.5", -0.5);
+    test("5.", 5.0);
+    test("1e10", 1e10);
+    test("1E+10", 1e10);
+    test("12.5e-3", 12.5e-3);
+    test("000123.4500", 123.45);
+    test("1.7976931348623157e308", lim::max());
+    test("2.2250738585072014e-308", lim::min());
+    test("4.9406564584124654e-324", lim::denorm_min());
+    test("3e-324", lim::denorm_min());
+    test("9007199254740993", 9007199254740992.0);
+    test("9007199254740995", 9007199254740996.0);
+    test("0.1000000000000000055511151231257827021181583404541015625", 0.1);
+    test("123456789012345678901234567890", 123456789012345678901234567890.0);
+    test("0e999999999999", 0.0);
+    test("inf", lim::infinity());
+    test("-INFINITY", -lim::infinity());
+    test("nan", lim::quiet_NaN());
+    test("-NaN(123_abc)", -lim::quiet_NaN());
+
+    // Only a prefix of the string is a number.
+    test("1.5x", general, 1.5, 3);
+    test("1e", general, 1.0, 1);
+    test("1e+", general, 1.0, 1);
+    test("infinit", general, lim::infinity(), 3);
+    test("nan(", general, lim::quiet_NaN(), 3);
+    test("2.5e3", fixed, 2.5, 3);
+    test("2.5e3", scientific, 2500.0, 5);
+    test("1.8p1", hex, 3.0, 5);
+    test("-1p-1", hex, -0.5, 5);
+    test("a.8", hex, 10.5, 3);
+    test("0x1p0", general, 0.0, 1);
+    test("0x1p0", hex, 0.0, 1);
+    test("0.0000000000001p-1022", hex, lim::denorm_min(), 21);
+    test("1.fffffffffffff8p0", hex, 2.0, 18);
+    test("1.fffffffffffff7ffp0", hex, 2.0 - lim::epsilon(), 20);
+
+    test_error<double>("", general, std::errc::invalid_argument, 0);
+    test_error<double>("-", general, std::errc::invalid_argument, 0);
+    test_error<double>(".", general, std::errc::invalid_argument, 0);
+    test_error<double>("+1", general, std::errc::invalid_argument, 0);
+    test_error<double>(" 1", general, std::errc::invalid_argument, 0);
+    test_error<double>("1.5", scientific, std::errc::invalid_argument, 0);
+    test_error<double>("p1", hex, std::errc::invalid_argument, 0);
+    test_error<double>("1e309", general, std::errc::result_out_of_range, 5);
+    test_error<double>("-1e-400", general, std::errc::result_out_of_range, 7);
+    test_error<double>("1p1024", hex, std::errc::result_out_of_range, 6);
+
+    std::string long_zeros = "1." + std::string(1000, '0') + "1";
+    test(long_zeros.c_str(), 1.0);
+}
+
+void test_float()
+{
+    typedef std::numeric_limits<float> lim;
+    const std::chars_format hex = std::chars_format::hex;
+
+    test("0", 0.0f);
+    test("0.1", 0.1f);
+    test("3.4028235e38", lim::max());
+    test("1e-45", lim::denorm_min());
+    test("16777217", 16777216.0f);
+    test("16777219", 16777220.0f);
+    test("1.00000005960464477539062500001", 1.0000001f);
+    test("1.99999ap-4", hex, 0.1f, 11);
+    test("-inf", -lim::infinity());
+
+    test_error<float>("3.5e38", std::chars_format::general,
+                      std::errc::result_out_of_range, 6);
+    test_error<float>("1e-46", std::chars_format::general,
+                      std::errc::result_out_of_range, 5);
+}
+
+int main(int, char**)
+{
+    test_double();
+    test_float();
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// The floating-point overloads are not in any shipped system dylib yet.
+// XFAIL: with_system_cxx_lib=macosx10.15
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// to_chars_result to_chars(char* first, char* last, float value);
+// to_chars_result to_chars(char* first, char* last, double value);
+// to_chars_result to_chars(char* first, char* last, float value,
+//                          chars_format fmt);
+// to_chars_result to_chars(char* first, char* last, double value,
+//                          chars_format fmt);
+
+#include <charconv>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "test_macros.h"
+
+template <class T>
+void test(T value, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+    assert(r.ec == std::errc());
+    assert(std::string(buf, r.ptr) == expected);
+}
+
+template <class T>
+void test(T value, std::chars_format fmt, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+    assert(r.ec == std::errc());
+    assert(std::string(buf, r.ptr) == expected);
+
+    // The output is exactly as long as needed.
+    const size_t len = strlen(expected);
+    r = std::to_chars(buf, buf + len, value, fmt);
+    assert(r.ec == std::errc() && r.ptr == buf + len);
+    r = std::to_chars(buf, buf + len - 1, value, fmt);
+    assert(r.ec == std::errc::value_too_large && r.ptr == buf + len - 1);
+}
+
+void test_double()
+{
+    typedef std::numeric_limits<double> lim;
+
+    // The shortest of fixed and scientific notation, preferring fixed.
+    test(0.0, "0");
+    test(-0.0, "-0");
+    test(1.0, "1");
+    test(0.1, "0.1");
+    test(0.3, "0.3");
+    test(1.0 / 3, "0.3333333333333333");
+    test(123456.0, "123456");
+    test(1e21, "1e+21");
+    test(123e20, "1.23e+22");
+    test(1e-5, "1e-05");
+    test(0.001, "0.001");
+    test(0.0001234, "0.0001234");
+    test(1e300, "1e+300");
+    test(lim::max(), "1.7976931348623157e+308");
+    test(lim::min(), "2.2250738585072014e-308");
+    test(lim::denorm_min(), "5e-324");
+    test(lim::infinity(), "inf");
+    test(-lim::infinity(), "-inf");
+    test(lim::quiet_NaN(), "nan");
+    test(-lim::quiet_NaN(), "-nan");
+    // Integers are written exactly, which can be shorter than 1e+17.
+    test(9007199254740993.0, "9007199254740992");
+    test(1152921504606846976.0, "1152921504606846976");
+
+    test(0.0, std::chars_format::scientific, "0e+00");
+    test(1.0, std::chars_format::scientific, "1e+00");
+    test(-123.5, std::chars_format::scientific, "-1.235e+02");
+    test(1e100, std::chars_format::scientific, "1e+100");
+    test(lim::denorm_min(), std::chars_format::scientific, "5e-324");
+    test(0.1, std::chars_format::scientific, "1e-01");
+
+    test(0.0, std::chars_format::fixed, "0");
+    test(123.25, std::chars_format::fixed, "123.25");
+    test(0.000125, std::chars_format::fixed, "0.000125");
+    test(1e23, std::chars_format::fixed, "99999999999999991611392");
+    test(1e22, std::chars_format::fixed, "10000000000000000000000");
+    test(-1e-10, std::chars_format::fixed, "-0.0000000001");
+    test(lim::max(), std::chars_format::fixed,
+         "17976931348623157081452742373170435679807056752584499659891747680315"
+         "72607800285387605895586327668781715404589535143824642343213268894641"
+         "82768467546703537516986049910576551282076245490090389328944075868508"
+         "45513394230458323690322294816580855933212334827479782620414472316873"
+         "8177180919299881250404026184124858368");
+
+    test(0.0, std::chars_format::general, "0");
+    test(123456.0, std::chars_format::general, "123456");
+    test(1234567.0, std::chars_format::general, "1.234567e+06");
+    test(0.0001, std::chars_format::general, "0.0001");
+    test(0.00001, std::chars_format::general, "1e-05");
+    test(lim::infinity(), std::chars_format::general, "inf");
+
+    test(0.0, std::chars_format::hex, "0p+0");
+    test(1.0, std::chars_format::hex, "1p+0");
+    test(-0.5, std::chars_format::hex, "-1p-1");
+    test(3.0, std::chars_format::hex, "1.8p+1");
+    test(0.1, std::chars_format::hex, "1.999999999999ap-4");
+    test(lim::max(), std::chars_format::hex, "1.fffffffffffffp+1023");
+    test(lim::denorm_min(), std::chars_format::hex, "0.0000000000001p-1022");
+}
+
+void test_float()
+{
+    typedef std::numeric_limits<float> lim;
+
+    test(0.0f, "0");
+    test(1.0f, "1");
+    test(0.1f, "0.1");
+    test(1.0f / 3, "0.33333334");
+    test(16777216.0f, "16777216");
+    test(1e10f, "1e+10");
+    test(lim::max(), "3.4028235e+38");
+    test(lim::min(), "1.1754944e-38");
+    test(lim::denorm_min(), "1e-45");
+    test(-lim::infinity(), "-inf");
+
+    test(1.5f, std::chars_format::scientific, "1.5e+00");
+    test(lim::max(), std::chars_format::fixed,
+         "340282346638528859811704183484516925440");
+    test(1e-3f, std::chars_format::fixed, "0.001");
+    test(1e6f, std::chars_format::general, "1e+06");
+    test(1.0f, std::chars_format::hex, "1p+0");
+    test(0.1f, std::chars_format::hex, "1.99999ap-4");
+    test(lim::denorm_min(), std::chars_format::hex, "0.000002p-126");
+}
+
+int main(int, char**)
+{
+    test_double();
+    test_float();
+
+    return 0;
+}
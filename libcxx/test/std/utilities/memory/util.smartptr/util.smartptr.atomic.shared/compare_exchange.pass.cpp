@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <memory>
+
+// template <class T> struct atomic<shared_ptr<T>>;
+
+// bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired,
+//                            memory_order success, memory_order failure) noexcept;
+// bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired,
+//                              memory_order success, memory_order failure) noexcept;
+// bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired,
+//                            memory_order order = memory_order::seq_cst) noexcept;
+// bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired,
+//                              memory_order order = memory_order::seq_cst) noexcept;
+
+#include <memory>
+#include <atomic>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    {
+        std::shared_ptr<int> p = std::make_shared<int>(1);
+        std::shared_ptr<int> q = std::make_shared<int>(2);
+        std::atomic<std::shared_ptr<int> > a(p);
+        std::shared_ptr<int> e = q;
+        assert(!a.compare_exchange_strong(e, q));
+        assert(e == p);
+        assert(a.load() == p);
+        assert(a.compare_exchange_strong(e, q));
+        assert(e == p);
+        assert(a.load() == q);
+        assert(p.use_count() == 2);
+    }
+    {
+        std::shared_ptr<int> p = std::make_shared<int>(1);
+        std::shared_ptr<int> q = std::make_shared<int>(2);
+        std::atomic<std::shared_ptr<int> > a(p);
+        std::shared_ptr<int> e = p;
+        while (!a.compare_exchange_weak(e, q))
+            assert(e == p);
+        assert(a.load() == q);
+        assert(!a.compare_exchange_weak(e, p, std::memory_order_acq_rel,
+                                        std::memory_order_acquire));
+        assert(e == q);
+        assert(a.compare_exchange_strong(e, nullptr, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed));
+        assert(a.load() == nullptr);
+    }
+    {
+        // Equal pointers with different owners are not equivalent.
+        int i = 0;
+        std::shared_ptr<int> owner = std::make_shared<int>(3);
+        std::shared_ptr<int> p(owner, &i);
+        std::shared_ptr<int> q(std::make_shared<int>(4), &i);
+        std::atomic<std::shared_ptr<int> > a(p);
+        std::shared_ptr<int> e = q;
+        assert(!a.compare_exchange_strong(e, nullptr));
+        assert(e.get() == &i);
+        assert(e.use_count() == owner.use_count());
+        assert(a.compare_exchange_strong(e, nullptr));
+        assert(a.load() == nullptr);
+    }
+
+  return 0;
+}
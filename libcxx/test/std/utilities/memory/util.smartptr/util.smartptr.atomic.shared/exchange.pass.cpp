@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <memory>
+
+// template <class T> struct atomic<shared_ptr<T>>;
+
+// shared_ptr<T> exchange(shared_ptr<T> desired,
+//                        memory_order order = memory_order::seq_cst) noexcept;
+
+#include <memory>
+#include <atomic>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    std::shared_ptr<int> p = std::make_shared<int>(1);
+    std::shared_ptr<int> q = std::make_shared<int>(2);
+    std::atomic<std::shared_ptr<int> > a(p);
+    std::shared_ptr<int> r = a.exchange(q);
+    assert(r == p);
+    assert(a.load() == q);
+    assert(p.use_count() == 2);
+    assert(q.use_count() == 2);
+    r = a.exchange(nullptr, std::memory_order_acq_rel);
+    assert(r == q);
+    assert(a.load() == nullptr);
+    assert(a.exchange(p) == nullptr);
+
+  return 0;
+}
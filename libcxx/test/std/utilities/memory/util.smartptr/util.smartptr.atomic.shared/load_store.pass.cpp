@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <memory>
+
+// template <class T> struct atomic<shared_ptr<T>>;
+
+// constexpr atomic() noexcept;
+// atomic(shared_ptr<T> desired) noexcept;
+// shared_ptr<T> load(memory_order order = memory_order::seq_cst) const noexcept;
+// operator shared_ptr<T>() const noexcept;
+// void store(shared_ptr<T> desired, memory_order order = memory_order::seq_cst) noexcept;
+// void operator=(shared_ptr<T> desired) noexcept;
+
+#include <memory>
+#include <atomic>
+#include <cassert>
+#include <type_traits>
+
+#include "test_macros.h"
+
+struct Counted
+{
+    static int count;
+    int value;
+
+    explicit Counted(int v) : value(v) { ++count; }
+    ~Counted() { --count; }
+};
+
+int Counted::count = 0;
+
+int main(int, char**)
+{
+    typedef std::atomic<std::shared_ptr<Counted> > A;
+    static_assert(std::is_same<A::value_type, std::shared_ptr<Counted> >::value, "");
+    static_assert(!std::is_copy_constructible<A>::value, "");
+    static_assert(!std::is_copy_assignable<A>::value, "");
+    static_assert(std::is_nothrow_default_constructible<A>::value, "");
+    {
+        A a;
+        assert(!a.is_lock_free());
+        assert(a.load() == nullptr);
+        A n(nullptr);
+        assert(n.load() == nullptr);
+    }
+    {
+        std::shared_ptr<Counted> p = std::make_shared<Counted>(1);
+        A a(p);
+        assert(p.use_count() == 2);
+        std::shared_ptr<Counted> q = a.load();
+        assert(q == p);
+        assert(p.use_count() == 3);
+        q = a;
+        assert(q == p);
+
+        a.store(std::make_shared<Counted>(2));
+        assert(p.use_count() == 2);
+        assert(Counted::count == 2);
+        assert(a.load(std::memory_order_acquire)->value == 2);
+
+        // Replaced values are released right away.
+        a = p;
+        assert(Counted::count == 1);
+        a.store(nullptr, std::memory_order_release);
+        assert(a.load(std::memory_order_relaxed) == nullptr);
+        assert(p.use_count() == 2);
+    }
+    assert(Counted::count == 0);
+    {
+        // Values that alias the same owner are kept apart.
+        std::shared_ptr<Counted> p = std::make_shared<Counted>(3);
+        std::shared_ptr<int> value(p, &p->value);
+        std::shared_ptr<int> nothing(p, nullptr);
+        std::atomic<std::shared_ptr<int> > a(value);
+        assert(a.load() == value);
+        a = nothing;
+        assert(a.load() == nullptr);
+        assert(a.load().use_count() == p.use_count());
+    }
+    assert(Counted::count == 0);
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <memory>
+
+// template <class T> struct atomic<shared_ptr<T>>;
+
+// Readers see whole values while they are replaced, and every replaced value
+// is released.
+
+#include <memory>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "test_macros.h"
+
+struct Config
+{
+    static std::atomic<int> count;
+    int version;
+    int check;
+
+    explicit Config(int v) : version(v), check(-v) { ++count; }
+    ~Config() { --count; }
+};
+
+std::atomic<int> Config::count(0);
+
+int main(int, char**)
+{
+    const int Readers = 4;
+    const int Writers = 2;
+    const int Stores = 2000;
+    {
+        std::atomic<std::shared_ptr<Config> > a(std::make_shared<Config>(0));
+        std::atomic<bool> done(false);
+        std::thread readers[Readers];
+        for (std::thread& r : readers)
+            r = std::thread([&]() {
+                while (!done) {
+                    std::shared_ptr<Config> c = a.load();
+                    assert(c->check == -c->version);
+                }
+            });
+        std::thread writers[Writers];
+        for (int w = 0; w != Writers; ++w)
+            writers[w] = std::thread([&, w]() {
+                for (int i = 0; i != Stores; ++i) {
+                    if (i % 2)
+                        a.store(std::make_shared<Config>(i));
+                    else {
+                        std::shared_ptr<Config> e = a.load();
+                        a.compare_exchange_strong(e, std::make_shared<Config>(w));
+                    }
+                }
+            });
+        for (std::thread& w : writers)
+            w.join();
+        done = true;
+        for (std::thread& r : readers)
+            r.join();
+        assert(Config::count == 1);
+        assert(a.load().use_count() == 2);
+    }
+    assert(Config::count == 0);
+
+  return 0;
+}
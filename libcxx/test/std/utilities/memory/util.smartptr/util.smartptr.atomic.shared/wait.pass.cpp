@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <memory>
+
+// template <class T> struct atomic<shared_ptr<T>>;
+
+// void wait(shared_ptr<T> old, memory_order order = memory_order::seq_cst) const noexcept;
+// void notify_one() noexcept;
+// void notify_all() noexcept;
+
+#include <memory>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    std::shared_ptr<int> p = std::make_shared<int>(1);
+    std::shared_ptr<int> q = std::make_shared<int>(2);
+    std::atomic<std::shared_ptr<int> > a(p);
+    a.wait(q);
+    std::thread t([&]() {
+        a.store(q);
+        a.notify_one();
+    });
+    a.wait(p);
+    assert(a.load() == q);
+    t.join();
+
+    std::thread waiters[4];
+    for (std::thread& w : waiters)
+        w = std::thread([&]() {
+            a.wait(q, std::memory_order_acquire);
+            assert(a.load() == p);
+        });
+    a.store(p);
+    a.notify_all();
+    for (std::thread& w : waiters)
+        w.join();
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// template <class T> class polymorphic_allocator
+
+// Elements that use allocators are constructed with the allocator of the
+// container, including both halves of a pair.
+
+#include <memory_resource>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+struct ArgFirst {
+    using allocator_type = pmr::polymorphic_allocator<char>;
+    ArgFirst(std::allocator_arg_t, const allocator_type& a, int v)
+        : res(a.resource()), value(v) {}
+    pmr::memory_resource* res;
+    int value;
+};
+
+struct ArgLast {
+    using allocator_type = pmr::polymorphic_allocator<char>;
+    ArgLast(int v, const allocator_type& a) : res(a.resource()), value(v) {}
+    pmr::memory_resource* res;
+    int value;
+};
+
+int main(int, char**)
+{
+    pmr::monotonic_buffer_resource mono;
+    pmr::memory_resource* r = &mono;
+
+    {
+        pmr::polymorphic_allocator<int> a(r);
+        pmr::polymorphic_allocator<char> b(a);
+        assert(a.resource() == r && b.resource() == r);
+        assert(a == b);
+        assert(a != pmr::polymorphic_allocator<int>());
+        assert(a.select_on_container_copy_construction().resource() ==
+               pmr::get_default_resource());
+
+        int* p = a.allocate(3);
+        assert(reinterpret_cast<std::uintptr_t>(p) % alignof(int) == 0);
+        a.deallocate(p, 3);
+    }
+    {
+        pmr::polymorphic_allocator<ArgFirst> a(r);
+        ArgFirst* p = a.allocate(1);
+        a.construct(p, 1);
+        assert(p->res == r && p->value == 1);
+        a.destroy(p);
+
+        pmr::polymorphic_allocator<ArgLast> b(r);
+        ArgLast* q = b.allocate(1);
+        b.construct(q, 2);
+        assert(q->res == r && q->value == 2);
+        b.destroy(q);
+    }
+    {
+        typedef std::pair<ArgFirst, ArgLast> P;
+        pmr::polymorphic_allocator<P> a(r);
+        P* p = a.allocate(1);
+        a.construct(p, 3, 4);
+        assert(p->first.res == r && p->first.value == 3);
+        assert(p->second.res == r && p->second.value == 4);
+        a.destroy(p);
+
+        a.construct(p, std::piecewise_construct, std::make_tuple(5),
+                    std::make_tuple(6));
+        assert(p->first.res == r && p->second.res == r);
+        assert(p->first.value == 5 && p->second.value == 6);
+        a.destroy(p);
+
+        a.construct(p, std::make_pair(7, 8));
+        assert(p->first.res == r && p->second.value == 8);
+        a.destroy(p);
+    }
+    {
+        pmr::vector<pmr::string> v(r);
+        v.emplace_back("a string that is too long for the small buffer");
+        v.push_back(pmr::string("another string that is too long to be small"));
+        assert(v[0].get_allocator().resource() == r);
+        assert(v[1].get_allocator().resource() == r);
+
+        pmr::map<pmr::string, pmr::vector<int>> m(r);
+        m["key"].push_back(1);
+        assert(m.begin()->first.get_allocator().resource() == r);
+        assert(m.begin()->second.get_allocator().resource() == r);
+    }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// The std::pmr aliases of the containers, strings and match_results are
+// declared by their own headers.
+
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <regex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <type_traits>
+#include <cassert>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+template <class T>
+using A = pmr::polymorphic_allocator<T>;
+
+static_assert(std::is_same<pmr::vector<int>, std::vector<int, A<int>>>::value, "");
+static_assert(std::is_same<pmr::deque<int>, std::deque<int, A<int>>>::value, "");
+static_assert(std::is_same<pmr::list<int>, std::list<int, A<int>>>::value, "");
+static_assert(std::is_same<pmr::forward_list<int>,
+                           std::forward_list<int, A<int>>>::value, "");
+
+static_assert(std::is_same<pmr::map<int, long>,
+                           std::map<int, long, std::less<int>,
+                                    A<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<pmr::multimap<int, long, std::greater<int>>,
+                           std::multimap<int, long, std::greater<int>,
+                                         A<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<pmr::set<int>,
+                           std::set<int, std::less<int>, A<int>>>::value, "");
+static_assert(std::is_same<pmr::multiset<int>,
+                           std::multiset<int, std::less<int>, A<int>>>::value, "");
+
+static_assert(std::is_same<pmr::unordered_map<int, long>,
+                           std::unordered_map<int, long, std::hash<int>,
+                                              std::equal_to<int>,
+                                              A<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<pmr::unordered_multimap<int, long>,
+                           std::unordered_multimap<int, long, std::hash<int>,
+                                                   std::equal_to<int>,
+                                                   A<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<pmr::unordered_set<int>,
+                           std::unordered_set<int, std::hash<int>, std::equal_to<int>,
+                                              A<int>>>::value, "");
+static_assert(std::is_same<pmr::unordered_multiset<int>,
+                           std::unordered_multiset<int, std::hash<int>, std::equal_to<int>,
+                                                   A<int>>>::value, "");
+
+static_assert(std::is_same<pmr::string,
+                           std::basic_string<char, std::char_traits<char>, A<char>>>::value, "");
+static_assert(std::is_same<pmr::wstring,
+                           std::basic_string<wchar_t, std::char_traits<wchar_t>,
+                                             A<wchar_t>>>::value, "");
+static_assert(std::is_same<pmr::u16string,
+                           std::basic_string<char16_t, std::char_traits<char16_t>,
+                                             A<char16_t>>>::value, "");
+static_assert(std::is_same<pmr::u32string,
+                           std::basic_string<char32_t, std::char_traits<char32_t>,
+                                             A<char32_t>>>::value, "");
+
+static_assert(std::is_same<pmr::cmatch,
+                           std::match_results<const char*,
+                                              A<std::sub_match<const char*>>>>::value, "");
+static_assert(std::is_same<pmr::smatch,
+                           std::match_results<std::string::const_iterator,
+                                              A<std::sub_match<std::string::const_iterator>>>>::value, "");
+
+int main(int, char**)
+{
+    pmr::vector<int> v;
+    assert(v.get_allocator().resource() == pmr::get_default_resource());
+    pmr::unordered_map<int, pmr::string> m;
+    m[1] = "one";
+    assert(m[1].get_allocator().resource() == pmr::get_default_resource());
+
+  return 0;
+}
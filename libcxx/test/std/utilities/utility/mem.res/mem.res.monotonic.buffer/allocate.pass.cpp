@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class monotonic_buffer_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+// Forwards to new_delete_resource() and counts the calls.
+class CountingResource : public pmr::memory_resource {
+public:
+    int allocations = 0;
+    int outstanding = 0;
+    std::size_t last_bytes = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocations;
+        ++outstanding;
+        last_bytes = bytes;
+        return pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        --outstanding;
+        pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+bool is_aligned(void* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+int main(int, char**)
+{
+    {
+        // Allocations come out of the initial buffer until it is used up.
+        CountingResource up;
+        alignas(16) char buffer[256];
+        pmr::monotonic_buffer_resource mono(buffer, sizeof(buffer), &up);
+        assert(mono.upstream_resource() == &up);
+
+        void* p = mono.allocate(1, 1);
+        void* q = mono.allocate(8, 8);
+        assert(p == buffer);
+        assert(q == buffer + 8);
+        mono.deallocate(q, 8, 8);
+        void* r = mono.allocate(32, 16);
+        assert(r == buffer + 16);
+        assert(up.allocations == 0);
+
+        // The next chunk is at least twice the initial buffer.
+        void* s = mono.allocate(300, 1);
+        assert(up.allocations == 1);
+        assert(up.last_bytes >= 2 * sizeof(buffer));
+        assert(s < (void*)buffer || s >= (void*)(buffer + sizeof(buffer)));
+
+        // release() returns the chunks and restarts at the buffer.
+        mono.release();
+        assert(up.outstanding == 0);
+        assert(mono.allocate(1, 1) == buffer);
+    }
+    {
+        // Chunks grow geometrically, and large requests get a chunk of
+        // their own size.
+        CountingResource up;
+        {
+            pmr::monotonic_buffer_resource mono(64, &up);
+            std::size_t last = 0;
+            for (int i = 0; i != 8; ++i) {
+                (void)mono.allocate(60, 1);
+                assert(up.last_bytes >= last);
+                last = up.last_bytes;
+            }
+            assert(up.allocations < 8);
+            (void)mono.allocate(100000, 8);
+            assert(up.last_bytes >= 100000);
+        }
+        assert(up.outstanding == 0);
+    }
+    {
+        // Any alignment is honored, from the buffer and from the chunks.
+        CountingResource up;
+        char buffer[100];
+        pmr::monotonic_buffer_resource mono(buffer, sizeof(buffer), &up);
+        for (std::size_t align = 1; align <= 4096; align *= 2) {
+            void* p = mono.allocate(1, align);
+            assert(is_aligned(p, align));
+            *static_cast<char*>(p) = 'x';
+        }
+    }
+    {
+        // A zero sized buffer or initial size still works.
+        CountingResource up;
+        pmr::monotonic_buffer_resource a(nullptr, 0, &up);
+        pmr::monotonic_buffer_resource b(std::size_t(0), &up);
+        assert(a.allocate(10) != nullptr);
+        assert(b.allocate(10) != nullptr);
+        assert(a != b);
+        assert(a == a);
+    }
+    {
+        // The default upstream is the default resource.
+        CountingResource up;
+        pmr::set_default_resource(&up);
+        pmr::monotonic_buffer_resource mono;
+        assert(mono.upstream_resource() == &up);
+        pmr::set_default_resource(nullptr);
+    }
+
+  return 0;
+}
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class synchronized_pool_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+int main(int, char**)
+{
+    pmr::synchronized_pool_resource pool;
+    assert(pool.upstream_resource() == pmr::get_default_resource());
+    assert(pool.options().largest_required_pool_block > 0);
+
+    // Each thread checks that no other thread writes to its blocks.
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 4; ++t)
+        threads.emplace_back([&pool, t] {
+            std::vector<unsigned char*> blocks;
+            for (int round = 0; round != 20; ++round) {
+                for (std::size_t i = 0; i != 200; ++i) {
+                    std::size_t size = 1 + (i * 13) % 300;
+                    unsigned char* b =
+                        static_cast<unsigned char*>(pool.allocate(size));
+                    std::memset(b, t, size);
+                    blocks.push_back(b);
+                }
+                for (std::size_t i = 0; i != blocks.size(); ++i) {
+                    std::size_t size = 1 + (i * 13) % 300;
+                    for (std::size_t j = 0; j != size; ++j)
+                        assert(blocks[i][j] == t);
+                    pool.deallocate(blocks[i], size);
+                }
+                blocks.clear();
+            }
+        });
+    for (std::thread& t : threads)
+        t.join();
+    pool.release();
+
+  return 0;
+}
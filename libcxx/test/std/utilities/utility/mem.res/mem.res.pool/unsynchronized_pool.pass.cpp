@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class unsynchronized_pool_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "test_macros.h"
+
+namespace pmr = std::pmr;
+
+// Forwards to new_delete_resource() and counts the calls.
+class CountingResource : public pmr::memory_resource {
+public:
+    int allocations = 0;
+    int outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocations;
+        ++outstanding;
+        return pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        --outstanding;
+        pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+bool is_aligned(void* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+int main(int, char**)
+{
+    {
+        pmr::pool_options opts;
+        opts.max_blocks_per_chunk = 32;
+        opts.largest_required_pool_block = 200;
+        CountingResource up;
+        pmr::unsynchronized_pool_resource pool(opts, &up);
+        assert(pool.upstream_resource() == &up);
+        assert(pool.options().max_blocks_per_chunk <= 32);
+        assert(pool.options().largest_required_pool_block >= 200);
+        assert(pool == pool);
+
+        // A freed block is handed out again.
+        void* p = pool.allocate(24, 8);
+        pool.deallocate(p, 24, 8);
+        assert(pool.allocate(24, 8) == p);
+
+        // Blocks of a size class come from a few chunks.
+        int before = up.allocations;
+        std::vector<void*> blocks;
+        for (int i = 0; i != 1000; ++i) {
+            void* b = pool.allocate(40, 8);
+            assert(is_aligned(b, 8));
+            std::memset(b, i, 40);
+            blocks.push_back(b);
+        }
+        assert(up.allocations - before < 1000 / 32 + 8);
+        for (void* b : blocks)
+            pool.deallocate(b, 40, 8);
+
+        // Large and overaligned requests go upstream.
+        before = up.allocations;
+        void* big = pool.allocate(100000, 8);
+        assert(up.allocations == before + 1);
+        void* over = pool.allocate(16, 256);
+        assert(is_aligned(over, 256));
+        int outstanding = up.outstanding;
+        pool.deallocate(big, 100000, 8);
+        pool.deallocate(over, 16, 256);
+        assert(up.outstanding == outstanding - 2);
+
+        // Every size and alignment the pools serve.
+        for (std::size_t size = 1; size <= 256; size += 7)
+            for (std::size_t align = 1; align <= alignof(std::max_align_t); align *= 2) {
+                void* b = pool.allocate(size, align);
+                assert(is_aligned(b, align));
+                std::memset(b, 0, size);
+                pool.deallocate(b, size, align);
+            }
+
+        (void)pool.allocate(100000, 8);
+        pool.release();
+        assert(up.outstanding == 0);
+        (void)pool.allocate(8);
+    }
+    {
+        // The destructor returns everything.
+        CountingResource up;
+        {
+            pmr::unsynchronized_pool_resource pool(&up);
+            for (int i = 0; i != 100; ++i)
+                (void)pool.allocate(i * 16 + 1);
+            (void)pool.allocate(1 << 22);
+        }
+        assert(up.outstanding == 0);
+    }
+    {
+        // With the pmr containers.
+        CountingResource up;
+        {
+            pmr::unsynchronized_pool_resource pool(&up);
+            pmr::vector<pmr::string> v(&pool);
+            for (int i = 0; i != 100; ++i)
+                v.emplace_back(50, 'a' + i % 26);
+            v.clear();
+            v.shrink_to_fit();
+        }
+        assert(up.outstanding == 0);
+    }
+
+  return 0;
+}
@@ -100,12 +100,29 @@ struct _LIBCXXABI_HIDDEN __cxa_dependent_exception {
     _Unwind_Exception unwindHeader;
 };
 
+// A call site found in an LSDA by the personality routine.
+struct _LIBCXXABI_HIDDEN __cxa_call_site_info {
+    const uint8_t* lsda;
+    uintptr_t ip;
+    const uint8_t* classInfo;
+    const uint8_t* actionTableStart;
+    uintptr_t landingPad;
+    uintptr_t actionEntry;
+    uint8_t ttypeEncoding;
+};
+
+static const size_t __cxa_call_site_cache_size = 16;
+
 struct _LIBCXXABI_HIDDEN __cxa_eh_globals {
     __cxa_exception *   caughtExceptions;
     unsigned int        uncaughtExceptions;
 #if defined(_LIBCXXABI_ARM_EHABI)
     __cxa_exception* propagatingExceptions;
 #endif
+#if !defined(__USING_SJLJ_EXCEPTIONS__)
+    // The call sites most recently found by the personality routine.
+    __cxa_call_site_info callSiteCache[__cxa_call_site_cache_size];
+#endif
 };
 
 extern "C" _LIBCXXABI_FUNC_VIS __cxa_eh_globals * __cxa_get_globals      ();
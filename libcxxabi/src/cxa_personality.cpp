@@ -560,6 +560,114 @@ set_registers(_Unwind_Exception* unwind_exception, _Unwind_Context* context,
         _UA_CLEANUP_PHASE && !_UA_HANDLER_FRAME
 */
 
+/// The parts of the LSDA needed to run the actions of one call site.
+typedef __cxa_call_site_info call_site_info;
+
+/// Parse the LSDA header and find the call site containing ip.
+/// Return false if there is no such call site.
+static bool find_call_site_in_lsda(const uint8_t* lsda, uintptr_t ip,
+                                   uintptr_t funcStart, call_site_info& site)
+{
+#ifndef __USING_SJLJ_EXCEPTIONS__
+    uintptr_t ipOffset = ip - funcStart;
+#endif  // !__USING_SJLJ_EXCEPTIONS__
+    site.classInfo = NULL;
+    // Note: See JITDwarfEmitter::EmitExceptionTable(...) for corresponding
+    //       dwarf emission
+    // Parse LSDA header.
+    uint8_t lpStartEncoding = *lsda++;
+    const uint8_t* lpStart = (const uint8_t*)readEncodedPointer(&lsda, lpStartEncoding);
+    if (lpStart == 0)
+        lpStart = (const uint8_t*)funcStart;
+    site.ttypeEncoding = *lsda++;
+    if (site.ttypeEncoding != DW_EH_PE_omit)
+    {
+        // Calculate type info locations in emitted dwarf code which
+        // were flagged by type info arguments to llvm.eh.selector
+        // intrinsic
+        uintptr_t classInfoOffset = readULEB128(&lsda);
+        site.classInfo = lsda + classInfoOffset;
+    }
+    // Walk call-site table looking for range that 
+    // includes current PC. 
+    uint8_t callSiteEncoding = *lsda++;
+#ifdef __USING_SJLJ_EXCEPTIONS__
+    (void)callSiteEncoding;  // When using SjLj exceptions, callSiteEncoding is never used
+#endif
+    uint32_t callSiteTableLength = static_cast<uint32_t>(readULEB128(&lsda));
+    const uint8_t* callSiteTableStart = lsda;
+    const uint8_t* callSiteTableEnd = callSiteTableStart + callSiteTableLength;
+    site.actionTableStart = callSiteTableEnd;
+    const uint8_t* callSitePtr = callSiteTableStart;
+    while (callSitePtr < callSiteTableEnd)
+    {
+        // There is one entry per call site.
+#ifndef __USING_SJLJ_EXCEPTIONS__
+        // The call sites are non-overlapping in [start, start+length)
+        // The call sites are ordered in increasing value of start
+        uintptr_t start = readEncodedPointer(&callSitePtr, callSiteEncoding);
+        uintptr_t length = readEncodedPointer(&callSitePtr, callSiteEncoding);
+        uintptr_t landingPad = readEncodedPointer(&callSitePtr, callSiteEncoding);
+        uintptr_t actionEntry = readULEB128(&callSitePtr);
+        if ((start <= ipOffset) && (ipOffset < (start + length)))
+        {
+            // Found the call site containing ip.
+            // A zero landing pad means there is no handler here.
+            site.landingPad = landingPad == 0 ? 0 : (uintptr_t)lpStart + landingPad;
+            site.actionEntry = actionEntry;
+            return true;
+        }
+        else if (ipOffset < start)
+            return false;
+#else  // __USING_SJLJ_EXCEPTIONS__
+        // ip is 1-based index into this table
+        uintptr_t landingPad = readULEB128(&callSitePtr);
+        uintptr_t actionEntry = readULEB128(&callSitePtr);
+        if (--ip == 0)
+        {
+            // Found the call site containing ip.
+            site.landingPad = landingPad + 1;
+            site.actionEntry = actionEntry;
+            return true;
+        }
+#endif  // __USING_SJLJ_EXCEPTIONS__
+    }
+    // It is possible that no eh table entry specify how to handle
+    // this exception. By spec, the caller terminates it immediately.
+    return false;
+}
+
+/// Find the call site containing ip, going through the per-thread cache of
+/// recently used call sites first.  Code which throws repeatedly unwinds
+/// through the same few frames, and the call-site tables only need to be
+/// decoded once for each of them.
+static bool find_call_site(const uint8_t* lsda, uintptr_t ip,
+                           uintptr_t funcStart, call_site_info& site)
+{
+#ifndef __USING_SJLJ_EXCEPTIONS__
+    // Only use the cache if this thread already has its globals: a foreign
+    // exception shouldn't allocate them.
+    __cxa_eh_globals* globals = __cxa_get_globals_fast();
+    if (globals != NULL)
+    {
+        call_site_info& entry =
+            globals->callSiteCache[(ip ^ (ip >> 7)) % __cxa_call_site_cache_size];
+        if (entry.lsda == lsda && entry.ip == ip)
+        {
+            site = entry;
+            return true;
+        }
+        if (!find_call_site_in_lsda(lsda, ip, funcStart, site))
+            return false;
+        site.lsda = lsda;
+        site.ip = ip;
+        entry = site;
+        return true;
+    }
+#endif  // !__USING_SJLJ_EXCEPTIONS__
+    return find_call_site_in_lsda(lsda, ip, funcStart, site);
+}
+
 static void scan_eh_tab(scan_results &results, _Unwind_Action actions,
                         bool native_exception,
                         _Unwind_Exception *unwind_exception,
@@ -626,272 +734,218 @@ static void scan_eh_tab(scan_results &results, _Unwind_Action actions,
     else if (ip == 0)
         call_terminate(native_exception, unwind_exception);
     // ip is 1-based index into call site table
-#else  // !__USING_SJLJ_EXCEPTIONS__
-    uintptr_t ipOffset = ip - funcStart;
-#endif  // !defined(_USING_SLJL_EXCEPTIONS__)
-    const uint8_t* classInfo = NULL;
-    // Note: See JITDwarfEmitter::EmitExceptionTable(...) for corresponding
-    //       dwarf emission
-    // Parse LSDA header.
-    uint8_t lpStartEncoding = *lsda++;
-    const uint8_t* lpStart = (const uint8_t*)readEncodedPointer(&lsda, lpStartEncoding);
-    if (lpStart == 0)
-        lpStart = (const uint8_t*)funcStart;
-    uint8_t ttypeEncoding = *lsda++;
-    if (ttypeEncoding != DW_EH_PE_omit)
+#endif  // __USING_SJLJ_EXCEPTIONS__
+    call_site_info site;
+    if (!find_call_site(lsda, ip, funcStart, site))
     {
-        // Calculate type info locations in emitted dwarf code which
-        // were flagged by type info arguments to llvm.eh.selector
-        // intrinsic
-        uintptr_t classInfoOffset = readULEB128(&lsda);
-        classInfo = lsda + classInfoOffset;
+        // There is no call site for this ip
+        // Something bad has happened.  We should never get here.
+        // Possible stack corruption.
+        call_terminate(native_exception, unwind_exception);
     }
-    // Walk call-site table looking for range that 
-    // includes current PC. 
-    uint8_t callSiteEncoding = *lsda++;
-#ifdef __USING_SJLJ_EXCEPTIONS__
-    (void)callSiteEncoding;  // When using SjLj exceptions, callSiteEncoding is never used
-#endif
-    uint32_t callSiteTableLength = static_cast<uint32_t>(readULEB128(&lsda));
-    const uint8_t* callSiteTableStart = lsda;
-    const uint8_t* callSiteTableEnd = callSiteTableStart + callSiteTableLength;
-    const uint8_t* actionTableStart = callSiteTableEnd;
-    const uint8_t* callSitePtr = callSiteTableStart;
-    while (callSitePtr < callSiteTableEnd)
-    {
-        // There is one entry per call site.
 #ifndef __USING_SJLJ_EXCEPTIONS__
-        // The call sites are non-overlapping in [start, start+length)
-        // The call sites are ordered in increasing value of start
-        uintptr_t start = readEncodedPointer(&callSitePtr, callSiteEncoding);
-        uintptr_t length = readEncodedPointer(&callSitePtr, callSiteEncoding);
-        uintptr_t landingPad = readEncodedPointer(&callSitePtr, callSiteEncoding);
-        uintptr_t actionEntry = readULEB128(&callSitePtr);
-        if ((start <= ipOffset) && (ipOffset < (start + length)))
-#else  // __USING_SJLJ_EXCEPTIONS__
-        // ip is 1-based index into this table
-        uintptr_t landingPad = readULEB128(&callSitePtr);
-        uintptr_t actionEntry = readULEB128(&callSitePtr);
-        if (--ip == 0)
-#endif  // __USING_SJLJ_EXCEPTIONS__
+    if (site.landingPad == 0)
+    {
+        // No handler here
+        results.reason = _URC_CONTINUE_UNWIND;
+        return;
+    }
+#endif  // !__USING_SJLJ_EXCEPTIONS__
+    uintptr_t landingPad = site.landingPad;
+    uintptr_t actionEntry = site.actionEntry;
+    const uint8_t* classInfo = site.classInfo;
+    uint8_t ttypeEncoding = site.ttypeEncoding;
+    const uint8_t* actionTableStart = site.actionTableStart;
+    if (actionEntry == 0)
+    {
+        // Found a cleanup
+        // If this is a type 1 or type 2 search, there are no handlers
+        // If this is a type 3 search, you want to install the cleanup.
+        if ((actions & _UA_CLEANUP_PHASE) && !(actions & _UA_HANDLER_FRAME))
         {
-            // Found the call site containing ip.
-#ifndef __USING_SJLJ_EXCEPTIONS__
-            if (landingPad == 0)
-            {
-                // No handler here
-                results.reason = _URC_CONTINUE_UNWIND;
-                return;
-            }
-            landingPad = (uintptr_t)lpStart + landingPad;
-#else  // __USING_SJLJ_EXCEPTIONS__
-            ++landingPad;
-#endif  // __USING_SJLJ_EXCEPTIONS__
-            if (actionEntry == 0)
+            results.ttypeIndex = 0;  // Redundant but clarifying
+            results.landingPad = landingPad;
+            results.reason = _URC_HANDLER_FOUND;
+            return;
+        }
+        // No handler here
+        results.reason = _URC_CONTINUE_UNWIND;
+        return;
+    }
+    // Convert 1-based byte offset into
+    const uint8_t* action = actionTableStart + (actionEntry - 1);
+    // Scan action entries until you find a matching handler, cleanup, or the end of action list
+    while (true)
+    {
+        const uint8_t* actionRecord = action;
+        int64_t ttypeIndex = readSLEB128(&action);
+        if (ttypeIndex > 0)
+        {
+            // Found a catch, does it actually catch?
+            // First check for catch (...)
+            const __shim_type_info* catchType =
+                get_shim_type_info(static_cast<uint64_t>(ttypeIndex),
+                                   classInfo, ttypeEncoding,
+                                   native_exception, unwind_exception);
+            if (catchType == 0)
             {
-                // Found a cleanup
-                // If this is a type 1 or type 2 search, there are no handlers
-                // If this is a type 3 search, you want to install the cleanup.
-                if ((actions & _UA_CLEANUP_PHASE) && !(actions & _UA_HANDLER_FRAME))
+                // Found catch (...) catches everything, including foreign exceptions
+                // If this is a type 1 search save state and return _URC_HANDLER_FOUND
+                // If this is a type 2 search save state and return _URC_HANDLER_FOUND
+                // If this is a type 3 search !_UA_FORCE_UNWIND, we should have found this in phase 1!
+                // If this is a type 3 search _UA_FORCE_UNWIND, ignore handler and continue scan
+                if ((actions & _UA_SEARCH_PHASE) || (actions & _UA_HANDLER_FRAME))
                 {
-                    results.ttypeIndex = 0;  // Redundant but clarifying
+                    // Save state and return _URC_HANDLER_FOUND
+                    results.ttypeIndex = ttypeIndex;
+                    results.actionRecord = actionRecord;
                     results.landingPad = landingPad;
+                    results.adjustedPtr = get_thrown_object_ptr(unwind_exception);
                     results.reason = _URC_HANDLER_FOUND;
                     return;
                 }
-                // No handler here
-                results.reason = _URC_CONTINUE_UNWIND;
-                return;
+                else if (!(actions & _UA_FORCE_UNWIND))
+                {
+                    // It looks like the exception table has changed
+                    //    on us.  Likely stack corruption!
+                    call_terminate(native_exception, unwind_exception);
+                }
             }
-            // Convert 1-based byte offset into
-            const uint8_t* action = actionTableStart + (actionEntry - 1);
-            // Scan action entries until you find a matching handler, cleanup, or the end of action list
-            while (true)
+            // Else this is a catch (T) clause and will never
+            //    catch a foreign exception
+            else if (native_exception)
             {
-                const uint8_t* actionRecord = action;
-                int64_t ttypeIndex = readSLEB128(&action);
-                if (ttypeIndex > 0)
+                __cxa_exception* exception_header = (__cxa_exception*)(unwind_exception+1) - 1;
+                void* adjustedPtr = get_thrown_object_ptr(unwind_exception);
+                const __shim_type_info* excpType =
+                    static_cast<const __shim_type_info*>(exception_header->exceptionType);
+                if (adjustedPtr == 0 || excpType == 0)
                 {
-                    // Found a catch, does it actually catch?
-                    // First check for catch (...)
-                    const __shim_type_info* catchType =
-                        get_shim_type_info(static_cast<uint64_t>(ttypeIndex),
-                                           classInfo, ttypeEncoding,
-                                           native_exception, unwind_exception);
-                    if (catchType == 0)
-                    {
-                        // Found catch (...) catches everything, including foreign exceptions
-                        // If this is a type 1 search save state and return _URC_HANDLER_FOUND
-                        // If this is a type 2 search save state and return _URC_HANDLER_FOUND
-                        // If this is a type 3 search !_UA_FORCE_UNWIND, we should have found this in phase 1!
-                        // If this is a type 3 search _UA_FORCE_UNWIND, ignore handler and continue scan
-                        if ((actions & _UA_SEARCH_PHASE) || (actions & _UA_HANDLER_FRAME))
-                        {
-                            // Save state and return _URC_HANDLER_FOUND
-                            results.ttypeIndex = ttypeIndex;
-                            results.actionRecord = actionRecord;
-                            results.landingPad = landingPad;
-                            results.adjustedPtr = get_thrown_object_ptr(unwind_exception);
-                            results.reason = _URC_HANDLER_FOUND;
-                            return;
-                        }
-                        else if (!(actions & _UA_FORCE_UNWIND))
-                        {
-                            // It looks like the exception table has changed
-                            //    on us.  Likely stack corruption!
-                            call_terminate(native_exception, unwind_exception);
-                        }
-                    }
-                    // Else this is a catch (T) clause and will never
-                    //    catch a foreign exception
-                    else if (native_exception)
-                    {
-                        __cxa_exception* exception_header = (__cxa_exception*)(unwind_exception+1) - 1;
-                        void* adjustedPtr = get_thrown_object_ptr(unwind_exception);
-                        const __shim_type_info* excpType =
-                            static_cast<const __shim_type_info*>(exception_header->exceptionType);
-                        if (adjustedPtr == 0 || excpType == 0)
-                        {
-                            // Something very bad happened
-                            call_terminate(native_exception, unwind_exception);
-                        }
-                        if (catchType->can_catch(excpType, adjustedPtr))
-                        {
-                            // Found a matching handler
-                            // If this is a type 1 search save state and return _URC_HANDLER_FOUND
-                            // If this is a type 3 search and !_UA_FORCE_UNWIND, we should have found this in phase 1!
-                            // If this is a type 3 search and _UA_FORCE_UNWIND, ignore handler and continue scan
-                            if (actions & _UA_SEARCH_PHASE)
-                            {
-                                // Save state and return _URC_HANDLER_FOUND
-                                results.ttypeIndex = ttypeIndex;
-                                results.actionRecord = actionRecord;
-                                results.landingPad = landingPad;
-                                results.adjustedPtr = adjustedPtr;
-                                results.reason = _URC_HANDLER_FOUND;
-                                return;
-                            }
-                            else if (!(actions & _UA_FORCE_UNWIND))
-                            {
-                                // It looks like the exception table has changed
-                                //    on us.  Likely stack corruption!
-                                call_terminate(native_exception, unwind_exception);
-                            }
-                        }
-                    }
-                    // Scan next action ...
+                    // Something very bad happened
+                    call_terminate(native_exception, unwind_exception);
                 }
-                else if (ttypeIndex < 0)
+                if (catchType->can_catch(excpType, adjustedPtr))
                 {
-                    // Found an exception spec.  If this is a foreign exception,
-                    //   it is always caught.
-                    if (native_exception)
+                    // Found a matching handler
+                    // If this is a type 1 search save state and return _URC_HANDLER_FOUND
+                    // If this is a type 3 search and !_UA_FORCE_UNWIND, we should have found this in phase 1!
+                    // If this is a type 3 search and _UA_FORCE_UNWIND, ignore handler and continue scan
+                    if (actions & _UA_SEARCH_PHASE)
                     {
-                        // Does the exception spec catch this native exception?
-                        __cxa_exception* exception_header = (__cxa_exception*)(unwind_exception+1) - 1;
-                        void* adjustedPtr = get_thrown_object_ptr(unwind_exception);
-                        const __shim_type_info* excpType =
-                            static_cast<const __shim_type_info*>(exception_header->exceptionType);
-                        if (adjustedPtr == 0 || excpType == 0)
-                        {
-                            // Something very bad happened
-                            call_terminate(native_exception, unwind_exception);
-                        }
-                        if (exception_spec_can_catch(ttypeIndex, classInfo,
-                                                     ttypeEncoding, excpType,
-                                                     adjustedPtr, unwind_exception))
-                        {
-                            // native exception caught by exception spec
-                            // If this is a type 1 search, save state and return _URC_HANDLER_FOUND
-                            // If this is a type 3 search !_UA_FORCE_UNWIND, we should have found this in phase 1!
-                            // If this is a type 3 search _UA_FORCE_UNWIND, ignore handler and continue scan
-                            if (actions & _UA_SEARCH_PHASE)
-                            {
-                                // Save state and return _URC_HANDLER_FOUND
-                                results.ttypeIndex = ttypeIndex;
-                                results.actionRecord = actionRecord;
-                                results.landingPad = landingPad;
-                                results.adjustedPtr = adjustedPtr;
-                                results.reason = _URC_HANDLER_FOUND;
-                                return;
-                            }
-                            else if (!(actions & _UA_FORCE_UNWIND))
-                            {
-                                // It looks like the exception table has changed
-                                //    on us.  Likely stack corruption!
-                                call_terminate(native_exception, unwind_exception);
-                            }
-                        }
+                        // Save state and return _URC_HANDLER_FOUND
+                        results.ttypeIndex = ttypeIndex;
+                        results.actionRecord = actionRecord;
+                        results.landingPad = landingPad;
+                        results.adjustedPtr = adjustedPtr;
+                        results.reason = _URC_HANDLER_FOUND;
+                        return;
                     }
-                    else
+                    else if (!(actions & _UA_FORCE_UNWIND))
                     {
-                        // foreign exception caught by exception spec
-                        // If this is a type 1 search, save state and return _URC_HANDLER_FOUND
-                        // If this is a type 2 search, save state and return _URC_HANDLER_FOUND
-                        // If this is a type 3 search !_UA_FORCE_UNWIND, we should have found this in phase 1!
-                        // If this is a type 3 search _UA_FORCE_UNWIND, ignore handler and continue scan
-                        if ((actions & _UA_SEARCH_PHASE) || (actions & _UA_HANDLER_FRAME))
-                        {
-                            // Save state and return _URC_HANDLER_FOUND
-                            results.ttypeIndex = ttypeIndex;
-                            results.actionRecord = actionRecord;
-                            results.landingPad = landingPad;
-                            results.adjustedPtr = get_thrown_object_ptr(unwind_exception);
-                            results.reason = _URC_HANDLER_FOUND;
-                            return;
-                        }
-                        else if (!(actions & _UA_FORCE_UNWIND))
-                        {
-                            // It looks like the exception table has changed
-                            //    on us.  Likely stack corruption!
-                            call_terminate(native_exception, unwind_exception);
-                        }
+                        // It looks like the exception table has changed
+                        //    on us.  Likely stack corruption!
+                        call_terminate(native_exception, unwind_exception);
                     }
-                    // Scan next action ...
                 }
-                else  // ttypeIndex == 0
+            }
+            // Scan next action ...
+        }
+        else if (ttypeIndex < 0)
+        {
+            // Found an exception spec.  If this is a foreign exception,
+            //   it is always caught.
+            if (native_exception)
+            {
+                // Does the exception spec catch this native exception?
+                __cxa_exception* exception_header = (__cxa_exception*)(unwind_exception+1) - 1;
+                void* adjustedPtr = get_thrown_object_ptr(unwind_exception);
+                const __shim_type_info* excpType =
+                    static_cast<const __shim_type_info*>(exception_header->exceptionType);
+                if (adjustedPtr == 0 || excpType == 0)
                 {
-                    // Found a cleanup
-                    // If this is a type 1 search, ignore it and continue scan
-                    // If this is a type 2 search, ignore it and continue scan
-                    // If this is a type 3 search, save state and return _URC_HANDLER_FOUND
-                    if ((actions & _UA_CLEANUP_PHASE) && !(actions & _UA_HANDLER_FRAME))
+                    // Something very bad happened
+                    call_terminate(native_exception, unwind_exception);
+                }
+                if (exception_spec_can_catch(ttypeIndex, classInfo,
+                                             ttypeEncoding, excpType,
+                                             adjustedPtr, unwind_exception))
+                {
+                    // native exception caught by exception spec
+                    // If this is a type 1 search, save state and return _URC_HANDLER_FOUND
+                    // If this is a type 3 search !_UA_FORCE_UNWIND, we should have found this in phase 1!
+                    // If this is a type 3 search _UA_FORCE_UNWIND, ignore handler and continue scan
+                    if (actions & _UA_SEARCH_PHASE)
                     {
                         // Save state and return _URC_HANDLER_FOUND
                         results.ttypeIndex = ttypeIndex;
                         results.actionRecord = actionRecord;
                         results.landingPad = landingPad;
-                        results.adjustedPtr = get_thrown_object_ptr(unwind_exception);
+                        results.adjustedPtr = adjustedPtr;
                         results.reason = _URC_HANDLER_FOUND;
                         return;
                     }
+                    else if (!(actions & _UA_FORCE_UNWIND))
+                    {
+                        // It looks like the exception table has changed
+                        //    on us.  Likely stack corruption!
+                        call_terminate(native_exception, unwind_exception);
+                    }
                 }
-                const uint8_t* temp = action;
-                int64_t actionOffset = readSLEB128(&temp);
-                if (actionOffset == 0)
+            }
+            else
+            {
+                // foreign exception caught by exception spec
+                // If this is a type 1 search, save state and return _URC_HANDLER_FOUND
+                // If this is a type 2 search, save state and return _URC_HANDLER_FOUND
+                // If this is a type 3 search !_UA_FORCE_UNWIND, we should have found this in phase 1!
+                // If this is a type 3 search _UA_FORCE_UNWIND, ignore handler and continue scan
+                if ((actions & _UA_SEARCH_PHASE) || (actions & _UA_HANDLER_FRAME))
                 {
-                    // End of action list, no matching handler or cleanup found
-                    results.reason = _URC_CONTINUE_UNWIND;
+                    // Save state and return _URC_HANDLER_FOUND
+                    results.ttypeIndex = ttypeIndex;
+                    results.actionRecord = actionRecord;
+                    results.landingPad = landingPad;
+                    results.adjustedPtr = get_thrown_object_ptr(unwind_exception);
+                    results.reason = _URC_HANDLER_FOUND;
                     return;
                 }
-                // Go to next action
-                action += actionOffset;
-            }  // there is no break out of this loop, only return
+                else if (!(actions & _UA_FORCE_UNWIND))
+                {
+                    // It looks like the exception table has changed
+                    //    on us.  Likely stack corruption!
+                    call_terminate(native_exception, unwind_exception);
+                }
+            }
+            // Scan next action ...
         }
-#ifndef __USING_SJLJ_EXCEPTIONS__
-        else if (ipOffset < start)
+        else  // ttypeIndex == 0
         {
-            // There is no call site for this ip
-            // Something bad has happened.  We should never get here.
-            // Possible stack corruption.
-            call_terminate(native_exception, unwind_exception);
+            // Found a cleanup
+            // If this is a type 1 search, ignore it and continue scan
+            // If this is a type 2 search, ignore it and continue scan
+            // If this is a type 3 search, save state and return _URC_HANDLER_FOUND
+            if ((actions & _UA_CLEANUP_PHASE) && !(actions & _UA_HANDLER_FRAME))
+            {
+                // Save state and return _URC_HANDLER_FOUND
+                results.ttypeIndex = ttypeIndex;
+                results.actionRecord = actionRecord;
+                results.landingPad = landingPad;
+                results.adjustedPtr = get_thrown_object_ptr(unwind_exception);
+                results.reason = _URC_HANDLER_FOUND;
+                return;
+            }
         }
-#endif  // !__USING_SJLJ_EXCEPTIONS__
-    }  // there might be some tricky cases which break out of this loop
-
-    // It is possible that no eh table entry specify how to handle
-    // this exception. By spec, terminate it immediately.
-    call_terminate(native_exception, unwind_exception);
+        const uint8_t* temp = action;
+        int64_t actionOffset = readSLEB128(&temp);
+        if (actionOffset == 0)
+        {
+            // End of action list, no matching handler or cleanup found
+            results.reason = _URC_CONTINUE_UNWIND;
+            return;
+        }
+        // Go to next action
+        action += actionOffset;
+    }  // there is no break out of this loop, only return
 }
 
 // public API
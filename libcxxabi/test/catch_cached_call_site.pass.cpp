@@ -0,0 +1,90 @@
+//===---------------------- catch_cached_call_site.cpp --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The personality routine caches the call sites it finds in the LSDA of each
+// frame. Check that throwing repeatedly through the same call sites, with
+// exceptions of different types, still reaches the right handlers.
+
+// UNSUPPORTED: libcxxabi-no-exceptions
+
+#include <assert.h>
+
+struct A {};
+struct B {};
+
+static int cleanups = 0;
+
+struct Cleanup {
+    ~Cleanup() { ++cleanups; }
+};
+
+__attribute__((noinline)) void thrower(int kind)
+{
+    switch (kind)
+    {
+    case 0:
+        throw A();
+    case 1:
+        throw B();
+    default:
+        throw kind;
+    }
+}
+
+__attribute__((noinline)) int catch_a(int kind)
+{
+    Cleanup c;
+    try {
+        thrower(kind);
+    } catch (A&) {
+        return 0;
+    }
+    return -1;
+}
+
+__attribute__((noinline)) int catch_b(int kind)
+{
+    try {
+        return catch_a(kind);
+    } catch (B&) {
+        return 1;
+    }
+}
+
+// Many distinct call sites, so that the cache has to evict entries.
+template <int N>
+__attribute__((noinline)) int nest(int kind)
+{
+    try {
+        return nest<N - 1>(kind);
+    } catch (double) {
+        assert(false);
+    }
+    return -1;
+}
+
+template <>
+__attribute__((noinline)) int nest<0>(int kind)
+{
+    return catch_b(kind);
+}
+
+int main()
+{
+    for (int i = 0; i < 300; ++i)
+    {
+        int kind = i % 3;
+        try {
+            int result = i % 2 ? nest<40>(kind) : catch_b(kind);
+            assert(result == kind);
+        } catch (int n) {
+            assert(kind == 2 && n == 2);
+        }
+    }
+    assert(cleanups == 300);
+}
@@ -77,6 +77,12 @@ namespace libunwind {
 
 #if defined(_LIBUNWIND_SUPPORT_DWARF_UNWIND)
 /// Cache of recently found FDEs.
+///
+/// The process-wide cache is kept sorted by ip_start so that lookups are a
+/// binary search. In front of it, each thread keeps a few of the entries it
+/// hit most recently, which lets throw/catch loops find their FDEs without
+/// touching the shared lock at all. Removing entries from the process-wide
+/// cache bumps a generation counter which invalidates the per-thread caches.
 template <typename A>
 class _LIBUNWIND_HIDDEN DwarfFDECache {
   typedef typename A::pint_t pint_t;
@@ -97,6 +103,14 @@ private:
     pint_t fde;
   };
 
+  static bool matches(const entry *p, pint_t mh, pint_t pc) {
+    return ((mh == p->mh) || (mh == 0)) && (p->ip_start <= pc) &&
+           (pc < p->ip_end);
+  }
+
+  static pint_t findFDEInThreadCache(pint_t mh, pint_t pc);
+  static void addToThreadCache(const entry &e);
+
   // These fields are all static to avoid needing an initializer.
   // There is only one instance of this class per process.
   static RWMutex _lock;
@@ -108,6 +122,17 @@ private:
   static entry *_bufferUsed;
   static entry *_bufferEnd;
   static entry _initialBuffer[64];
+
+  // Incremented whenever entries are removed from the cache.
+  static unsigned _generation;
+
+  enum { kThreadCacheSize = 4 };
+  struct thread_cache {
+    unsigned generation;
+    unsigned next;
+    entry entries[kThreadCacheSize];
+  };
+  static _LIBUNWIND_THREAD_LOCAL thread_cache _threadCache;
 };
 
 template <typename A>
@@ -128,22 +153,73 @@ typename DwarfFDECache<A>::entry DwarfFDECache<A>::_initialBuffer[64];
 template <typename A>
 RWMutex DwarfFDECache<A>::_lock;
 
+template <typename A>
+unsigned DwarfFDECache<A>::_generation = 0;
+
+template <typename A>
+_LIBUNWIND_THREAD_LOCAL typename DwarfFDECache<A>::thread_cache
+    DwarfFDECache<A>::_threadCache;
+
 #ifdef __APPLE__
 template <typename A>
 bool DwarfFDECache<A>::_registeredForDyldUnloads = false;
 #endif
 
+template <typename A>
+typename A::pint_t DwarfFDECache<A>::findFDEInThreadCache(pint_t mh,
+                                                         pint_t pc) {
+  thread_cache &cache = _threadCache;
+  unsigned generation = __atomic_load_n(&_generation, __ATOMIC_ACQUIRE);
+  if (cache.generation != generation) {
+    // Some entries were removed since this thread last looked: start over.
+    memset(cache.entries, 0, sizeof(cache.entries));
+    cache.generation = generation;
+    return 0;
+  }
+  for (const entry *p = cache.entries; p < &cache.entries[kThreadCacheSize];
+       ++p) {
+    if (matches(p, mh, pc))
+      return p->fde;
+  }
+  return 0;
+}
+
+template <typename A>
+void DwarfFDECache<A>::addToThreadCache(const entry &e) {
+  thread_cache &cache = _threadCache;
+  cache.entries[cache.next] = e;
+  cache.next = (cache.next + 1) % kThreadCacheSize;
+}
+
 template <typename A>
 typename A::pint_t DwarfFDECache<A>::findFDE(pint_t mh, pint_t pc) {
-  pint_t result = 0;
+  pint_t result = findFDEInThreadCache(mh, pc);
+  if (result != 0)
+    return result;
+
   _LIBUNWIND_LOG_IF_FALSE(_lock.lock_shared());
-  for (entry *p = _buffer; p < _bufferUsed; ++p) {
-    if ((mh == p->mh) || (mh == 0)) {
-      if ((p->ip_start <= pc) && (pc < p->ip_end)) {
-        result = p->fde;
-        break;
-      }
+  // Find the last entry starting at or before pc. FDEs don't overlap, so only
+  // the entries sharing its ip_start (registered by different images) can
+  // contain pc.
+  entry *low = _buffer;
+  for (size_t len = (size_t)(_bufferUsed - _buffer); len > 0;) {
+    size_t half = len / 2;
+    if (low[half].ip_start <= pc) {
+      low += half + 1;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  for (entry *p = low; p > _buffer && p[-1].ip_start <= pc;) {
+    --p;
+    if (matches(p, mh, pc)) {
+      result = p->fde;
+      addToThreadCache(*p);
+      break;
     }
+    if (p > _buffer && p[-1].ip_start != p->ip_start)
+      break;
   }
   _LIBUNWIND_LOG_IF_FALSE(_lock.unlock_shared());
   return result;
@@ -166,11 +242,18 @@ void DwarfFDECache<A>::add(pint_t mh, pint_t ip_start, pint_t ip_end,
     _bufferUsed = &newBuffer[oldSize];
     _bufferEnd = &newBuffer[newSize];
   }
-  _bufferUsed->mh = mh;
-  _bufferUsed->ip_start = ip_start;
-  _bufferUsed->ip_end = ip_end;
-  _bufferUsed->fde = fde;
+  // Keep the buffer sorted by ip_start. Entries are only added once per FDE,
+  // so the cost of shifting the tail is paid rarely.
+  entry *pos = _bufferUsed;
+  while (pos > _buffer && pos[-1].ip_start > ip_start)
+    --pos;
+  memmove(pos + 1, pos, (size_t)(_bufferUsed - pos) * sizeof(entry));
+  pos->mh = mh;
+  pos->ip_start = ip_start;
+  pos->ip_end = ip_end;
+  pos->fde = fde;
   ++_bufferUsed;
+  addToThreadCache(*pos);
 #ifdef __APPLE__
   if (!_registeredForDyldUnloads) {
     _dyld_register_func_for_remove_image(&dyldUnloadHook);
@@ -193,6 +276,7 @@ void DwarfFDECache<A>::removeAllIn(pint_t mh) {
     }
   }
   _bufferUsed = d;
+  __atomic_add_fetch(&_generation, 1, __ATOMIC_RELEASE);
   _LIBUNWIND_LOG_IF_FALSE(_lock.unlock());
 }
 
@@ -91,6 +91,7 @@ struct Configuration {
   bool noEntry = false;
   std::string outputFile;
   std::string importName;
+  std::string timeTraceFile;
   bool demangle = true;
   bool doGC = true;
   bool doICF = true;
@@ -105,6 +106,7 @@ struct Configuration {
   bool debugSymtab = false;
   bool showTiming = false;
   bool showSummary = false;
+  bool timeTraceEnabled = false;
   unsigned debugTypes = static_cast<unsigned>(DebugType::None);
   std::vector<std::string> natvisFiles;
   llvm::SmallString<128> pdbAltPath;
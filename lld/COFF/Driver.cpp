@@ -40,6 +40,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/ToolDrivers/llvm-lib/LibDriver.h"
 #include <algorithm>
@@ -74,6 +75,12 @@ bool link(ArrayRef<const char *> args, bool canExitEarly, raw_ostream &diag) {
   driver = make<LinkerDriver>();
   driver->link(args);
 
+  // Write the time trace once all time sections are closed.
+  if (config->timeTraceEnabled)
+    writeTimeTrace(config->timeTraceFile.empty()
+                       ? config->outputFile + ".time-trace"
+                       : config->timeTraceFile);
+
   // Call exit() if we can to avoid calling destructors.
   if (canExitEarly)
     exitLld(errorCount() ? 1 : 0);
@@ -845,6 +852,7 @@ void LinkerDriver::enqueueTask(std::function<void()> task) {
 
 bool LinkerDriver::run() {
   ScopedTimer t(inputFileTimer);
+  llvm::TimeTraceScope timeScope("Parse input files");
 
   bool didWork = !taskQueue.empty();
   while (!taskQueue.empty()) {
@@ -1099,6 +1107,11 @@ void LinkerDriver::link(ArrayRef<const char *> argsArr) {
 
   config->showSummary = args.hasArg(OPT_summary);
 
+  config->timeTraceEnabled = args.hasArg(OPT_time_trace);
+  config->timeTraceFile = args.getLastArgValue(OPT_time_trace_file);
+  if (config->timeTraceEnabled)
+    timeTraceProfilerInitialize(errorHandler().logName);
+
   ScopedTimer t(Timer::root());
   // Handle --version, which is an lld extension. This option is a bit odd
   // because it doesn't start with "/", but we deliberately chose "--" to
@@ -26,6 +26,7 @@
 #include "llvm/ADT/Hashing.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Parallel.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/xxhash.h"
 #include <algorithm>
@@ -242,6 +243,7 @@ void ICF::forEachClass(std::function<void(size_t, size_t)> fn) {
 // contents and relocations are all the same.
 void ICF::run(ArrayRef<Chunk *> vec) {
   ScopedTimer t(icfTimer);
+  llvm::TimeTraceScope timeScope("ICF");
 
   // Collect only mergeable sections and group by hash value.
   uint32_t nextId = 1;
@@ -83,6 +83,10 @@ static lto::Config createConfig() {
   c.MAttrs = getMAttrs();
   c.CGOptLevel = args::getCGOptLevel(config->ltoo);
 
+  // The combined module is not used after code generation, and freeing it
+  // can take seconds. Leak it if the process exits without cleaning up.
+  c.DisableFree = errorHandler().exitEarly;
+
   if (config->saveTemps)
     checkError(c.addSaveTemps(std::string(config->outputFile) + ".",
                               /*UseInputModulePath*/ true));
@@ -10,6 +10,7 @@
 #include "Symbols.h"
 #include "lld/Common/Timer.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <vector>
 
 namespace lld {
@@ -22,6 +23,7 @@ static Timer gctimer("GC", Timer::root());
 // from the final output.
 void markLive(ArrayRef<Chunk *> chunks) {
   ScopedTimer t(gctimer);
+  llvm::TimeTraceScope timeScope("GC");
 
   // We build up a worklist of sections which have been marked as live. We only
   // push into the worklist when we discover an unmarked section, and we mark
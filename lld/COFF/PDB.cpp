@@ -57,6 +57,7 @@
 #include "llvm/Support/JamCRC.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <memory>
 
 using namespace lld;
@@ -101,6 +102,10 @@ public:
   /// Link CodeView from each object file in the symbol table into the PDB.
   void addObjectsToPDB();
 
+  /// Compute the global type hashes of all object files that do not have
+  /// usable .debug$H sections, in parallel.
+  void computeGHashes();
+
   /// Link info for each import file in the symbol table into the PDB.
   void addImportFilesToPDB(ArrayRef<OutputSection *> outputSections);
 
@@ -184,6 +189,10 @@ private:
   /// far.
   std::map<uint32_t, CVIndexMap> precompTypeIndexMappings;
 
+  /// Global type hashes computed by computeGHashes(), freed once the types of
+  /// the file are merged.
+  DenseMap<ObjFile *, std::vector<GloballyHashedType>> ownedGHashes;
+
   // For statistics
   uint64_t globalSymbols = 0;
   uint64_t moduleSymbols = 0;
@@ -393,9 +402,14 @@ PDBLinker::mergeDebugT(ObjFile *file, CVIndexMap *objectIndexMap) {
   if (config->debugGHashes) {
     ArrayRef<GloballyHashedType> hashes;
     std::vector<GloballyHashedType> ownedHashes;
-    if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file))
+    auto it = ownedGHashes.find(file);
+    if (it != ownedGHashes.end()) {
+      ownedHashes = std::move(it->second);
+      ownedGHashes.erase(it);
+      hashes = ownedHashes;
+    } else if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file)) {
       hashes = getHashesFromDebugH(*debugH);
-    else {
+    } else {
       ownedHashes = GloballyHashedType::hashTypes(types);
       hashes = ownedHashes;
     }
@@ -1275,6 +1289,34 @@ static PublicSym32 createPublic(Defined *def) {
   return pub;
 }
 
+// Hashing the type records is the most expensive part of merging types with
+// /DEBUG:GHASH when the objects do not come with .debug$H sections, and it
+// only depends on each object's own type stream, so it is done for all files
+// up front in parallel. The hashes are then inserted into the global type table
+// serially in command line order, which decides the type indices in the PDB.
+void PDBLinker::computeGHashes() {
+  std::vector<ObjFile *> files;
+  for (ObjFile *file : ObjFile::instances)
+    if (file->debugTypesObj &&
+        file->debugTypesObj->kind != TpiSource::UsingPDB && !getDebugH(file))
+      files.push_back(file);
+
+  std::vector<std::vector<GloballyHashedType>> hashes(files.size());
+  parallelForEachN(0, files.size(), [&](size_t i) {
+    ObjFile *file = files[i];
+    CVTypeArray types = *file->debugTypes;
+
+    // The LF_PRECOMP record is dropped before the types are merged.
+    if (file->debugTypesObj->kind == TpiSource::UsingPCH)
+      types.setUnderlyingStream(types.getUnderlyingStream().drop_front(
+          types.begin()->RecordData.size()));
+    hashes[i] = GloballyHashedType::hashTypes(types);
+  });
+
+  for (size_t i = 0, e = files.size(); i != e; ++i)
+    ownedGHashes[files[i]] = std::move(hashes[i]);
+}
+
 // Add all object files to the PDB. Merge .debug$T sections into IpiData and
 // TpiData.
 void PDBLinker::addObjectsToPDB() {
@@ -1282,6 +1324,9 @@ void PDBLinker::addObjectsToPDB() {
 
   createModuleDBI(builder);
 
+  if (config->debugGHashes)
+    computeGHashes();
+
   for (ObjFile *file : ObjFile::instances)
     addObjFile(file);
 
@@ -1604,6 +1649,7 @@ void coff::createPDB(SymbolTable *symtab,
                      ArrayRef<uint8_t> sectionTable,
                      llvm::codeview::DebugInfo *buildId) {
   ScopedTimer t1(totalPdbLinkTimer);
+  llvm::TimeTraceScope timeScope("Create PDB");
   PDBLinker pdb(symtab);
 
   pdb.initialize(buildId);
@@ -18,6 +18,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Object/WindowsMachineFlag.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <utility>
 
@@ -592,6 +593,7 @@ void SymbolTable::addCombinedLTOObjects() {
     return;
 
   ScopedTimer t(ltoTimer);
+  llvm::TimeTraceScope timeScope("LTO");
   for (StringRef object : compileBitcodeFiles()) {
     auto *obj = make<ObjFile>(MemoryBufferRef(object, "lto.tmp"));
     obj->parse();
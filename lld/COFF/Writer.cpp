@@ -28,6 +28,7 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/RandomNumberGenerator.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <cstdio>
@@ -589,6 +590,7 @@ void Writer::finalizeAddresses() {
 // The main function of the writer.
 void Writer::run() {
   ScopedTimer t1(codeLayoutTimer);
+  llvm::TimeTraceScope timeScope("Write output file");
 
   createImportTables();
   createSections();
@@ -627,6 +629,7 @@ void Writer::run() {
   writeMapFile(outputSections);
 
   ScopedTimer t2(diskCommitTimer);
+  llvm::TimeTraceScope commitScope("Commit output file");
   if (auto e = buffer->commit())
     fatal("failed to write the output file: " + toString(std::move(e)));
 }
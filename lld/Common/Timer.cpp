@@ -8,11 +8,23 @@
 
 #include "lld/Common/Timer.h"
 #include "lld/Common/ErrorHandler.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/TimeProfiler.h"
 
 using namespace lld;
 using namespace llvm;
 
+void lld::writeTimeTrace(StringRef path) {
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_Text);
+  if (ec)
+    error("cannot open " + path + ": " + ec.message());
+  else
+    timeTraceProfilerWrite(os);
+  timeTraceProfilerCleanup();
+}
+
 ScopedTimer::ScopedTimer(Timer &t) : t(&t) { t.start(); }
 
 void ScopedTimer::stop() {
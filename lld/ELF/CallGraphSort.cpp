@@ -41,9 +41,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "CallGraphSort.h"
+#include "LinkerScript.h"
 #include "OutputSections.h"
 #include "SymbolTable.h"
 #include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
+#include "llvm/ADT/DenseSet.h"
 
 using namespace llvm;
 using namespace lld;
@@ -214,6 +217,68 @@ void CallGraphSort::groupClusters() {
   });
 }
 
+// Returns the number of pages touched by the sections for which IsHot is true
+// if Sections are laid out in the given order.
+static uint64_t
+countPages(ArrayRef<InputSection *> sections,
+           function_ref<bool(const InputSection *)> isHot) {
+  uint64_t pageSize = config->commonPageSize;
+  uint64_t off = 0;
+  uint64_t numPages = 0;
+  uint64_t nextPage = 0;
+  for (InputSection *isec : sections) {
+    off = alignTo(off, isec->alignment);
+    uint64_t size = isec->getSize();
+    if (size && isHot(isec)) {
+      uint64_t first = std::max(off / pageSize, nextPage);
+      uint64_t last = (off + size - 1) / pageSize;
+      if (first <= last) {
+        numPages += last - first + 1;
+        nextPage = last + 1;
+      }
+    }
+    off += size;
+  }
+  return numPages;
+}
+
+// Logs the number of pages spanned by the sections in the call graph, that is,
+// by the code that is expected to run, in input order and in the new order.
+// The difference approximates the reduction in page faults and iTLB misses at
+// startup.
+static void
+logPageCounts(const DenseMap<const InputSectionBase *, int> &orderMap) {
+  uint64_t hotSize = 0;
+  uint64_t before = 0;
+  uint64_t after = 0;
+  for (BaseCommand *base : script->sectionCommands) {
+    auto *os = dyn_cast<OutputSection>(base);
+    if (!os)
+      continue;
+    std::vector<InputSection *> inputOrder = getInputSections(os);
+    std::vector<InputSection *> hot;
+    for (InputSection *isec : inputOrder)
+      if (orderMap.count(isec))
+        hot.push_back(isec);
+    if (hot.empty())
+      continue;
+
+    llvm::sort(hot, [&](const InputSection *a, const InputSection *b) {
+      return orderMap.lookup(a) < orderMap.lookup(b);
+    });
+    for (InputSection *isec : hot)
+      hotSize += isec->getSize();
+    before += countPages(inputOrder, [&](const InputSection *isec) {
+      return orderMap.count(isec);
+    });
+    after += countPages(hot, [](const InputSection *) { return true; });
+  }
+
+  log("call graph: " + Twine(orderMap.size()) + " hot sections (" +
+      Twine(hotSize) + " bytes) span " + Twine(before) +
+      " pages in input order and " + Twine(after) + " pages after sorting");
+}
+
 DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
   groupClusters();
 
@@ -225,6 +290,9 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
     for (int secIndex : c.sections)
       orderMap[sections[secIndex]] = curOrder++;
 
+  if (errorHandler().verbose)
+    logPageCounts(orderMap);
+
   if (!config->printSymbolOrder.empty()) {
     std::error_code ec;
     raw_fd_ostream os(config->printSymbolOrder, ec, sys::fs::F_None);
@@ -25,6 +25,7 @@
 #include "Driver.h"
 #include "Config.h"
 #include "ICF.h"
+#include "Incremental.h"
 #include "InputFiles.h"
 #include "InputSection.h"
 #include "LinkerScript.h"
@@ -44,10 +45,14 @@
 #include "lld/Common/Strings.h"
 #include "lld/Common/TargetOptionsCommandFlags.h"
 #include "lld/Common/Threads.h"
+#include "lld/Common/Timer.h"
 #include "lld/Common/Version.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/GlobPattern.h"
@@ -55,6 +60,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdlib>
 #include <utility>
@@ -107,6 +113,14 @@ bool elf::link(ArrayRef<const char *> args, bool canExitEarly,
 
   driver->main(args);
 
+  // Write the time trace once all time sections are closed.
+  if (config->timeTraceEnabled) {
+    std::string path = config->timeTraceFile;
+    if (path.empty())
+      path = (config->outputFile + ".time-trace").str();
+    writeTimeTrace(path);
+  }
+
   // Exit immediately if we don't need to return to the caller.
   // This saves time because the overhead of calling destructors
   // for all globally-allocated objects is not negligible.
@@ -330,6 +344,20 @@ static void checkOptions() {
       error("-r and -pie may not be used together");
   }
 
+  if (config->incremental) {
+    if (config->relocatable)
+      error("-r and --incremental may not be used together");
+    if (config->emitRelocs)
+      error("--emit-relocs and --incremental may not be used together");
+    if (config->compressDebugSections)
+      error("--compress-debug-sections and --incremental may not be used "
+            "together");
+    if (config->oFormatBinary)
+      error("--oformat=binary and --incremental may not be used together");
+    if (config->emachine == EM_MIPS)
+      error("--incremental is not supported on MIPS targets");
+  }
+
   if (config->executeOnly) {
     if (config->emachine != EM_AARCH64)
       error("-execute-only is only supported on AArch64 targets");
@@ -441,6 +469,10 @@ void LinkerDriver::main(ArrayRef<const char *> argsArr) {
   }
 
   readConfigs(args);
+  if (config->incremental)
+    hashIncrementalArgs(args);
+  if (config->timeTraceEnabled)
+    timeTraceProfilerInitialize(errorHandler().logName);
 
   // The behavior of -v or --version is a bit strange, but this is
   // needed for compatibility with GNU linkers.
@@ -718,6 +750,78 @@ static void readCallGraph(MemoryBufferRef mb) {
   }
 }
 
+// Adds the calls sampled in FS, including those in the functions inlined into
+// it, as edges from Caller, whose code FS describes.
+static void
+addSampledCalls(const sampleprof::FunctionSamples &fs, InputSectionBase *caller,
+                function_ref<InputSectionBase *(StringRef)> findSection,
+                DenseSet<const InputSectionBase *> &called) {
+  for (const auto &body : fs.getBodySamples()) {
+    for (const auto &target : body.second.getCallTargets()) {
+      if (InputSectionBase *callee = findSection(target.first())) {
+        config->callGraphProfile[{caller, callee}] += target.second;
+        called.insert(callee);
+      }
+    }
+  }
+  for (const auto &callsite : fs.getCallsiteSamples())
+    for (const auto &inlined : callsite.second)
+      addSampledCalls(inlined.second, caller, findSection, called);
+}
+
+// Reads a sample profile, such as one converted from perf data by
+// create_llvm_prof, and adds the sampled calls to the call graph. A function
+// that has samples but is not called by any sampled function gets an edge to
+// itself, so that it is still placed with the hot code.
+static void readCallGraphFromSampleProfile(StringRef path) {
+  LLVMContext ctx;
+  ErrorOr<std::unique_ptr<sampleprof::SampleProfileReader>> readerOrErr =
+      sampleprof::SampleProfileReader::create(path, ctx);
+  if (!readerOrErr) {
+    error("cannot open " + path + ": " + readerOrErr.getError().message());
+    return;
+  }
+  sampleprof::SampleProfileReader &reader = **readerOrErr;
+  if (std::error_code ec = reader.read()) {
+    error(path + ": " + ec.message());
+    return;
+  }
+
+  // Profiles name functions without the suffixes added to local symbols, such
+  // as ".llvm.<hash>", so also map the names with the suffix removed.
+  DenseMap<StringRef, Symbol *> map;
+  for (InputFile *file : objectFiles)
+    for (Symbol *sym : file->getSymbols())
+      map[sym->getName()] = sym;
+  for (InputFile *file : objectFiles)
+    for (Symbol *sym : file->getSymbols())
+      map.insert({sym->getName().split('.').first, sym});
+
+  // Most functions in a profile of a whole system are not in this output, so
+  // unknown names are silently ignored.
+  auto findSection = [&](StringRef name) -> InputSectionBase * {
+    if (Defined *d = dyn_cast_or_null<Defined>(map.lookup(name)))
+      return dyn_cast_or_null<InputSectionBase>(d->section);
+    return nullptr;
+  };
+
+  std::vector<std::pair<InputSectionBase *, uint64_t>> sampled;
+  DenseSet<const InputSectionBase *> called;
+  for (const StringMapEntry<sampleprof::FunctionSamples> &e :
+       reader.getProfiles()) {
+    const sampleprof::FunctionSamples &fs = e.second;
+    if (InputSectionBase *sec = findSection(e.first())) {
+      addSampledCalls(fs, sec, findSection, called);
+      uint64_t weight = fs.getHeadSamples();
+      sampled.push_back({sec, weight ? weight : fs.getTotalSamples()});
+    }
+  }
+
+  for (std::pair<InputSectionBase *, uint64_t> &p : sampled)
+    if (p.second && !called.count(p.first))
+      config->callGraphProfile[{p.first, p.first}] += p.second;
+}
+
 template <class ELFT> static void readCallGraphsFromObjectFiles() {
   for (auto file : objectFiles) {
     auto *obj = cast<ObjFile<ELFT>>(file);
@@ -736,15 +840,20 @@ template <class ELFT> static void readCallGraphsFromObjectFiles() {
   }
 }
 
-static bool getCompressDebugSections(opt::InputArgList &args) {
+static Optional<compression::Format>
+getCompressDebugSections(opt::InputArgList &args) {
   StringRef s = args.getLastArgValue(OPT_compress_debug_sections, "none");
   if (s == "none")
-    return false;
-  if (s != "zlib")
+    return None;
+  compression::Format format = compression::Format::Zlib;
+  if (s == "zstd")
+    format = compression::Format::Zstd;
+  else if (s != "zlib")
     error("unknown --compress-debug-sections value: " + s);
-  if (!zlib::isAvailable())
-    error("--compress-debug-sections: zlib is not available");
-  return true;
+  if (!compression::isAvailable(format))
+    error("--compress-debug-sections: " + compression::getName(format) +
+          " is not available");
+  return format;
 }
 
 static std::pair<StringRef, StringRef> getOldNewOptions(opt::InputArgList &args,
@@ -839,6 +948,8 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   config->init = args.getLastArgValue(OPT_init, "_init");
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
@@ -870,6 +981,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->pie = args.hasFlag(OPT_pie, OPT_no_pie, false);
   config->printIcfSections =
       args.hasFlag(OPT_print_icf_sections, OPT_no_print_icf_sections, false);
+  config->printIcfStats =
+      args.hasFlag(OPT_print_icf_stats, OPT_no_print_icf_stats, false);
   config->printGcSections =
       args.hasFlag(OPT_print_gc_sections, OPT_no_print_gc_sections, false);
   config->printSymbolOrder =
@@ -884,6 +997,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->soName = args.getLastArgValue(OPT_soname);
   config->sortSection = getSortSection(args);
   config->splitStackAdjustSize = args::getInteger(args, OPT_split_stack_adjust_size, 16384);
+  config->streamOutput =
+      args.hasFlag(OPT_stream_output, OPT_no_stream_output, false);
   config->strip = getStrip(args);
   config->sysroot = args.getLastArgValue(OPT_sysroot);
   config->target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
@@ -903,6 +1018,8 @@ static void readConfigs(opt::InputArgList &args) {
       getOldNewOptions(args, OPT_plugin_opt_thinlto_object_suffix_replace_eq);
   config->thinLTOPrefixReplace =
       getOldNewOptions(args, OPT_plugin_opt_thinlto_prefix_replace_eq);
+  config->timeTraceEnabled = args.hasArg(OPT_time_trace);
+  config->timeTraceFile = args.getLastArgValue(OPT_time_trace_file);
   config->trace = args.hasArg(OPT_trace);
   config->undefined = args::getStrings(args, OPT_undefined);
   config->undefinedVersion =
@@ -1110,6 +1227,8 @@ static bool isFormatBinary(StringRef s) {
 }
 
 void LinkerDriver::createFiles(opt::InputArgList &args) {
+  llvm::TimeTraceScope timeScope("Load input files");
+
   // For --{push,pop}-state.
   std::vector<std::tuple<bool, bool, bool>> stack;
 
@@ -1535,6 +1654,7 @@ static Symbol *addUndefined(StringRef name) {
 // Because all bitcode files that the program consists of are passed to
 // the compiler at once, it can do a whole-program optimization.
 template <class ELFT> void LinkerDriver::compileBitcodeFiles() {
+  llvm::TimeTraceScope timeScope("LTO");
   // Compile bitcode files and replace bitcode symbols.
   lto.reset(new BitcodeCompiler);
   for (BitcodeFile *file : bitcodeFiles)
@@ -1706,8 +1826,15 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   // symbols that we need to the symbol table. This process might
   // add files to the link, via autolinking, these files are always
   // appended to the Files vector.
-  for (size_t i = 0; i < files.size(); ++i)
-    parseFile(files[i]);
+  // Symbols are resolved serially in command line order, which decides
+  // which definition and which archive member wins, but their names can be
+  // hashed ahead of time in parallel.
+  {
+    llvm::TimeTraceScope timeScope("Parse input files");
+    hashSymbolNames(files);
+    for (size_t i = 0; i < files.size(); ++i)
+      parseFile(files[i]);
+  }
 
   // Now that we have every file, we can decide if we will need a
   // dynamic symbol table.
@@ -1903,6 +2030,8 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
     if (auto *arg = args.getLastArg(OPT_call_graph_ordering_file))
       if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue()))
         readCallGraph(*buffer);
+    if (auto *arg = args.getLastArg(OPT_call_graph_sample_profile))
+      readCallGraphFromSampleProfile(arg->getValue());
     readCallGraphsFromObjectFiles<ELFT>();
   }
 
@@ -82,9 +82,11 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/ELF.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 
 using namespace lld;
 using namespace lld::elf;
@@ -100,6 +102,13 @@ public:
 private:
   void segregate(size_t begin, size_t end, bool constant);
 
+  bool isChanged(uint32_t eqClass) const;
+
+  template <class RelTy>
+  bool targetsChanged(const InputSection *s, ArrayRef<RelTy> rels);
+
+  bool mayBeSplit(size_t begin, size_t end);
+
   template <class RelTy>
   bool constantEq(const InputSection *a, ArrayRef<RelTy> relsA,
                   const InputSection *b, ArrayRef<RelTy> relsB);
@@ -152,6 +161,21 @@ private:
   // faster because it uses results of the same iteration earlier.
   int current = 0;
   int next = 0;
+
+  // nextChanged[c] is set if the class with ID c was created by splitting a
+  // class in this iteration of the main loop, and prevChanged[c] if it was
+  // in the previous one. A class whose members were all equal in an
+  // iteration stays intact in the next one unless the class of one of the
+  // sections it refers to has changed, so only such classes are compared
+  // again. The vectors are indexed by class ID, which is the index in
+  // Sections of the end of the class.
+  std::vector<uint8_t> prevChanged;
+  std::vector<uint8_t> nextChanged;
+
+  // The number of classes skipped and compared in the main loop, for
+  // --print-icf-stats.
+  std::atomic<size_t> numSkipped{0};
+  std::atomic<size_t> numCompared{0};
 };
 }
 
@@ -202,6 +226,18 @@ void ICF<ELFT>::segregate(size_t begin, size_t end, bool constant) {
   // issue in practice because the number of the distinct sections in
   // each range is usually very small.
 
+  if (!constant) {
+    bool skip = !mayBeSplit(begin, end);
+    if (config->printIcfStats && end - begin > 1)
+      ++(skip ? numSkipped : numCompared);
+    if (skip) {
+      for (size_t i = begin; i < end; ++i)
+        sections[i]->eqClass[next] = end;
+      return;
+    }
+  }
+
+  bool split = false;
   while (begin < end) {
     // Divide [Begin, End) into two. Let Mid be the start index of the
     // second group.
@@ -221,13 +257,55 @@ void ICF<ELFT>::segregate(size_t begin, size_t end, bool constant) {
       sections[i]->eqClass[next] = mid;
 
     // If we created a group, we need to iterate the main loop again.
-    if (mid != end)
+    if (mid != end) {
       repeat = true;
+      split = true;
+    }
+
+    // All groups of a split class are new classes. Note that the last one
+    // keeps the ID of the class it was split from.
+    if (split && !constant)
+      nextChanged[mid] = 1;
 
     begin = mid;
   }
 }
 
+template <class ELFT> bool ICF<ELFT>::isChanged(uint32_t eqClass) const {
+  // Without threads, classes are updated in place, so a class may also have
+  // changed earlier in this iteration.
+  return prevChanged[eqClass] || (current == next && nextChanged[eqClass]);
+}
+
+// Returns true if the class of any section referred to by Rels has changed.
+template <class ELFT>
+template <class RelTy>
+bool ICF<ELFT>::targetsChanged(const InputSection *sec, ArrayRef<RelTy> rels) {
+  for (const RelTy &rel : rels) {
+    Symbol &s = sec->template getFile<ELFT>()->getRelocTargetSym(rel);
+    if (auto *d = dyn_cast<Defined>(&s))
+      if (auto *isec = dyn_cast_or_null<InputSection>(d->section))
+        if (isec->eqClass[current] != 0 && isChanged(isec->eqClass[current]))
+          return true;
+  }
+  return false;
+}
+
+// Returns true if the class [Begin, End) may be split in this iteration of
+// the main loop. All members of a class that was compared and kept intact
+// in the previous iteration refer to sections of the same classes, so it is
+// enough to look at the relocations of the first one.
+template <class ELFT> bool ICF<ELFT>::mayBeSplit(size_t begin, size_t end) {
+  if (end - begin == 1)
+    return false;
+  if (isChanged(end))
+    return true;
+  const InputSection *s = sections[begin];
+  if (s->areRelocsRela)
+    return targetsChanged(s, s->template relas<ELFT>());
+  return targetsChanged(s, s->template rels<ELFT>());
+}
+
 // Compare two lists of relocations.
 template <class ELFT>
 template <class RelTy>
@@ -443,8 +521,22 @@ static void print(const Twine &s) {
     message(s);
 }
 
+using Clock = std::chrono::steady_clock;
+
+// Returns the milliseconds elapsed since Start, and resets Start to now.
+static int64_t lap(Clock::time_point &start) {
+  Clock::time_point now = Clock::now();
+  int64_t ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now - start)
+          .count();
+  start = now;
+  return ms;
+}
+
 // The main function of ICF.
 template <class ELFT> void ICF<ELFT>::run() {
+  Clock::time_point start = Clock::now();
+
   // Collect sections to merge.
   for (InputSectionBase *sec : inputSections)
     if (auto *s = dyn_cast<InputSection>(sec))
@@ -464,26 +556,36 @@ template <class ELFT> void ICF<ELFT>::run() {
         combineRelocHashes<ELFT>(cnt, s, s->template rels<ELFT>());
     });
   }
+  int64_t hashTime = lap(start);
 
   // From now on, sections in Sections vector are ordered so that sections
   // in the same equivalence class are consecutive in the vector.
   llvm::stable_sort(sections, [](const InputSection *a, const InputSection *b) {
     return a->eqClass[0] < b->eqClass[0];
   });
+  int64_t sortTime = lap(start);
 
   // Compare static contents and assign unique IDs for each static content.
   forEachClass([&](size_t begin, size_t end) { segregate(begin, end, true); });
+  int64_t constantTime = lap(start);
 
   // Split groups by comparing relocations until convergence is obtained.
+  // Every class is compared in the first iteration.
+  prevChanged.assign(sections.size() + 1, 1);
+  nextChanged.assign(sections.size() + 1, 0);
   do {
     repeat = false;
     forEachClass(
         [&](size_t begin, size_t end) { segregate(begin, end, false); });
+    prevChanged.swap(nextChanged);
+    std::fill(nextChanged.begin(), nextChanged.end(), 0);
   } while (repeat);
+  int64_t variableTime = lap(start);
 
   log("ICF needed " + Twine(cnt) + " iterations");
 
   // Merge sections by the equivalence class.
+  size_t numFolded = 0;
   forEachClassRange(0, sections.size(), [&](size_t begin, size_t end) {
     if (end - begin == 1)
       return;
@@ -498,11 +600,27 @@ template <class ELFT> void ICF<ELFT>::run() {
       for (InputSection *isec : sections[i]->dependentSections)
         isec->markDead();
     }
+    numFolded += end - begin - 1;
   });
+
+  if (config->printIcfStats) {
+    message("ICF: " + Twine(sections.size()) + " eligible sections, " +
+            Twine(numFolded) + " folded");
+    message("ICF: hashing " + Twine(hashTime) + " ms, sorting " +
+            Twine(sortTime) + " ms, comparing contents " +
+            Twine(constantTime) + " ms");
+    message("ICF: " + Twine(cnt - 1) + " iterations comparing relocations " +
+            Twine(variableTime) + " ms (" + Twine(numCompared.load()) +
+            " classes compared, " + Twine(numSkipped.load()) + " skipped)");
+    message("ICF: folding " + Twine(lap(start)) + " ms");
+  }
 }
 
 // ICF entry point function.
-template <class ELFT> void elf::doIcf() { ICF<ELFT>().run(); }
+template <class ELFT> void elf::doIcf() {
+  llvm::TimeTraceScope timeScope("ICF");
+  ICF<ELFT>().run();
+}
 
 template void elf::doIcf<ELF32LE>();
 template void elf::doIcf<ELF32BE>();
@@ -0,0 +1,382 @@
+//===- Incremental.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements --incremental. Normally, the output file is written
+// from scratch. With --incremental, we also save a small state file next to
+// the output, and the next link reuses the existing output in place if its
+// command line and output layout are the same. Only the input sections that
+// may have changed, and all synthetic sections, are written again. For a
+// large program in which a few object files change between links, this
+// avoids writing the bulk of the output.
+//
+// Symbol resolution, garbage collection and layout still run as usual. What
+// this saves is the cost of copying and relocating section contents and of
+// faulting in every page of a new output file.
+//
+// The state records, for each input file, a hash of its contents and a hash
+// of everything that determines the bytes of its sections in the output:
+// where the sections are placed, the targets of their relocations (which may
+// have been redirected to thunks) and the addresses of all symbols the file
+// refers to, including their GOT and PLT entries. If both are unchanged, the
+// file's sections in the existing output are already correct. Everything
+// else, including the gaps between sections, is rewritten.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Incremental.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "OutputSections.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Threads.h"
+#include "lld/Common/Version.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Option/ArgList.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::support::endian;
+
+using namespace lld;
+using namespace lld::elf;
+
+namespace {
+struct FileState {
+  uint64_t nameHash;
+  uint64_t contentHash;
+  uint64_t layoutHash;
+};
+
+struct LinkState {
+  uint64_t argsHash = 0;
+  uint64_t layoutHash = 0;
+  uint64_t outputSize = 0;
+  uint64_t outputTime = 0;
+  std::vector<FileState> files;
+};
+
+// Hashes a sequence of values.
+class Hasher {
+public:
+  void add(uint64_t v) {
+    uint8_t b[8];
+    write64le(b, v);
+    buf.append(b, b + 8);
+  }
+
+  void addString(StringRef s) {
+    add(s.size());
+    buf.append(s.bytes_begin(), s.bytes_end());
+  }
+
+  uint64_t hash() const { return xxHash64(toStringRef(buf)); }
+
+private:
+  SmallVector<uint8_t, 0> buf;
+};
+
+// A FileOutputBuffer that modifies an existing output file in place. Once
+// modified, the file is only consistent when all of it has been written, so
+// it is removed if the link fails.
+class IncrementalBuffer : public FileOutputBuffer {
+public:
+  IncrementalBuffer(StringRef path,
+                    std::unique_ptr<sys::fs::mapped_file_region> buf)
+      : FileOutputBuffer(path), buffer(std::move(buf)) {}
+
+  uint8_t *getBufferStart() const override { return (uint8_t *)buffer->data(); }
+
+  uint8_t *getBufferEnd() const override {
+    return (uint8_t *)buffer->data() + buffer->size();
+  }
+
+  size_t getBufferSize() const override { return buffer->size(); }
+
+  Error commit() override {
+    // Unmap buffer, letting OS flush dirty pages to file on disk.
+    buffer.reset();
+    committed = true;
+    return Error::success();
+  }
+
+  ~IncrementalBuffer() override {
+    buffer.reset();
+    discard();
+  }
+
+  void discard() override {
+    if (!committed)
+      sys::fs::remove(FinalPath);
+    committed = true;
+  }
+
+private:
+  std::unique_ptr<sys::fs::mapped_file_region> buffer;
+  bool committed = false;
+};
+} // namespace
+
+static const char magic[] = "LLDINC01";
+static const size_t headerSize = 8 + 5 * 8;
+
+static uint64_t argsHash;
+static LinkState current;
+static DenseSet<const InputFile *> unchangedFiles;
+static bool patching = false;
+
+static std::string getStatePath() {
+  return (config->outputFile + ".incremental").str();
+}
+
+void elf::hashIncrementalArgs(const opt::InputArgList &args) {
+  Hasher h;
+  h.addString(getLLDVersion());
+  for (const opt::Arg *arg : args)
+    h.addString(arg->getAsString(args));
+  argsHash = h.hash();
+}
+
+// Returns a hash of the output section layout, which must be the same as in
+// the previous link for the output to be patched.
+static uint64_t hashOutputLayout(uint64_t fileSize) {
+  Hasher h;
+  h.add(fileSize);
+  for (OutputSection *os : outputSections) {
+    h.addString(os->name);
+    h.add(os->type);
+    h.add(os->flags);
+    h.add(os->addr);
+    h.add(os->offset);
+    h.add(os->size);
+    for (InputSection *isec : getInputSections(os)) {
+      if (!isa<SyntheticSection>(isec))
+        continue;
+      h.addString(isec->name);
+      h.add(isec->outSecOff);
+      h.add(isec->getSize());
+    }
+  }
+  return h.hash();
+}
+
+// Adds everything about Sym that a relocation referring to it may depend on.
+static void addSymbol(Hasher &h, const Symbol *sym) {
+  if (!sym) {
+    h.add(0);
+    return;
+  }
+  h.add(sym->kind());
+  h.add(sym->isPreemptible);
+  h.add(sym->needsPltAddr);
+  h.add(sym->gotIndex);
+  h.add(sym->pltIndex);
+  h.add(sym->globalDynIndex);
+  h.add(sym->ppc64BranchltIndex);
+
+  // A symbol in a section that is not part of the output has no address.
+  if (auto *d = dyn_cast<Defined>(sym))
+    if (d->section && !d->section->repl->getOutputSection()) {
+      h.add(-1);
+      return;
+    }
+  h.add(sym->getVA());
+}
+
+// Returns a hash of everything that determines the output contents of the
+// sections of File, other than File's own contents.
+static uint64_t hashFileLayout(InputFile *file) {
+  Hasher h;
+  ArrayRef<InputSectionBase *> sections = file->getSections();
+  for (size_t i = 0, e = sections.size(); i != e; ++i) {
+    InputSectionBase *s = sections[i];
+    if (!s || s == &InputSection::discarded || !s->getOutputSection())
+      continue;
+    h.add(i);
+
+    // Pieces of mergeable sections are written by their synthetic section,
+    // but this file may refer to them through its section symbols.
+    if (auto *ms = dyn_cast<MergeInputSection>(s)) {
+      uint64_t va = ms->getParent()->getVA();
+      for (const SectionPiece &piece : ms->pieces)
+        h.add(piece.live ? va + piece.outputOff : -1);
+      continue;
+    }
+
+    auto *isec = dyn_cast<InputSection>(s);
+    if (!isec)
+      continue;
+    h.add(isec->getVA());
+    h.add(isec->getParent()->offset + isec->outSecOff);
+    h.add(isec->getSize());
+    for (const Relocation &rel : isec->relocations) {
+      h.add(rel.expr);
+      h.add(rel.type);
+      h.add(rel.offset);
+      h.add(rel.addend);
+      addSymbol(h, rel.sym);
+    }
+  }
+
+  // Sections that are not allocated are relocated against the symbols of
+  // the file.
+  for (Symbol *sym : file->getSymbols())
+    addSymbol(h, sym);
+  return h.hash();
+}
+
+static Optional<LinkState> readState(StringRef path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr = MemoryBuffer::getFile(path);
+  if (!mbOrErr)
+    return None;
+  StringRef data = (*mbOrErr)->getBuffer();
+  if (data.size() < headerSize || !data.startswith(magic))
+    return None;
+
+  const uint8_t *p = data.bytes_begin() + 8;
+  auto next = [&] {
+    uint64_t v = read64le(p);
+    p += 8;
+    return v;
+  };
+
+  LinkState state;
+  state.argsHash = next();
+  state.layoutHash = next();
+  state.outputSize = next();
+  state.outputTime = next();
+  uint64_t numFiles = next();
+  if (data.size() != headerSize + numFiles * 3 * 8)
+    return None;
+  state.files.resize(numFiles);
+  for (FileState &f : state.files)
+    f = {next(), next(), next()};
+  return state;
+}
+
+std::unique_ptr<FileOutputBuffer> elf::openIncrementalOutput(uint64_t size) {
+  if (config->outputFile == "-")
+    return nullptr;
+
+  current.argsHash = argsHash;
+  current.layoutHash = hashOutputLayout(size);
+  current.files.resize(objectFiles.size());
+  parallelForEachN(0, objectFiles.size(), [&](size_t i) {
+    InputFile *file = objectFiles[i];
+    Hasher name;
+    name.addString(file->archiveName);
+    name.addString(file->getName());
+    current.files[i] = {name.hash(), xxHash64(file->mb.getBuffer()),
+                        hashFileLayout(file)};
+  });
+
+  // The output can be patched only if it is the one written by the
+  // previous link, and the output sections are laid out the same way.
+  Optional<LinkState> prev = readState(getStatePath());
+  if (!prev || prev->argsHash != current.argsHash ||
+      prev->layoutHash != current.layoutHash || prev->outputSize != size ||
+      prev->files.size() != current.files.size())
+    return nullptr;
+
+  sys::fs::file_status st;
+  if (sys::fs::status(config->outputFile, st) || st.getSize() != size ||
+      uint64_t(st.getLastModificationTime().time_since_epoch().count()) !=
+          prev->outputTime)
+    return nullptr;
+
+  DenseSet<const InputFile *> unchanged;
+  for (size_t i = 0, e = current.files.size(); i != e; ++i) {
+    const FileState &cur = current.files[i];
+    const FileState &old = prev->files[i];
+    if (cur.nameHash != old.nameHash)
+      return nullptr;
+    if (cur.contentHash == old.contentHash && cur.layoutHash == old.layoutHash)
+      unchanged.insert(objectFiles[i]);
+  }
+
+  // Opening the file fails if it is a running executable, in which case
+  // the output is written from scratch.
+  int fd;
+  if (sys::fs::openFileForReadWrite(config->outputFile, fd,
+                                    sys::fs::CD_OpenExisting,
+                                    sys::fs::OF_None))
+    return nullptr;
+  std::error_code ec;
+  auto region = llvm::make_unique<sys::fs::mapped_file_region>(
+      sys::fs::convertFDToNativeFile(fd),
+      sys::fs::mapped_file_region::readwrite, size, 0, ec);
+  sys::Process::SafelyCloseFileDescriptor(fd);
+  if (ec)
+    return nullptr;
+
+  // The state no longer describes the output once we start modifying it.
+  sys::fs::remove(getStatePath());
+  log("--incremental: rewriting " +
+      Twine(current.files.size() - unchanged.size()) + " of " +
+      Twine(current.files.size()) + " input files");
+
+  unchangedFiles = std::move(unchanged);
+  patching = true;
+  return llvm::make_unique<IncrementalBuffer>(config->outputFile,
+                                              std::move(region));
+}
+
+bool elf::isPatchingOutput() { return patching; }
+
+bool elf::isUnchangedSection(const InputSectionBase *sec) {
+  return patching && !isa<SyntheticSection>(sec) &&
+         unchangedFiles.count(sec->file);
+}
+
+void elf::writeIncrementalState() {
+  if (config->outputFile == "-")
+    return;
+
+  sys::fs::file_status st;
+  if (std::error_code ec = sys::fs::status(config->outputFile, st)) {
+    warn("--incremental: cannot stat " + config->outputFile + ": " +
+         ec.message());
+    return;
+  }
+  current.outputSize = st.getSize();
+  current.outputTime = st.getLastModificationTime().time_since_epoch().count();
+
+  std::string data = magic;
+  auto add = [&](uint64_t v) {
+    char b[8];
+    write64le(b, v);
+    data.append(b, 8);
+  };
+  add(current.argsHash);
+  add(current.layoutHash);
+  add(current.outputSize);
+  add(current.outputTime);
+  add(current.files.size());
+  for (const FileState &f : current.files) {
+    add(f.nameHash);
+    add(f.contentHash);
+    add(f.layoutHash);
+  }
+
+  std::string path = getStatePath();
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_None);
+  if (ec) {
+    warn("--incremental: cannot write " + path + ": " + ec.message());
+    return;
+  }
+  os << data;
+}
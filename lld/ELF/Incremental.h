@@ -0,0 +1,46 @@
+//===- Incremental.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_INCREMENTAL_H
+#define LLD_ELF_INCREMENTAL_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include <memory>
+
+namespace llvm {
+namespace opt {
+class InputArgList;
+}
+} // namespace llvm
+
+namespace lld {
+namespace elf {
+class InputSectionBase;
+
+// Records the command line, which must not change between incremental links.
+void hashIncrementalArgs(const llvm::opt::InputArgList &args);
+
+// Returns the existing output file, mapped for writing in place, if the
+// previous link's state shows that it only needs to be patched. Returns null
+// if the output has to be written from scratch. Must be called after the
+// output layout is fixed.
+std::unique_ptr<llvm::FileOutputBuffer> openIncrementalOutput(uint64_t size);
+
+// True if the output returned by openIncrementalOutput() is being patched.
+bool isPatchingOutput();
+
+// True if the output is being patched and already holds Sec's contents.
+bool isUnchangedSection(const InputSectionBase *sec);
+
+// Saves the state of this link for the next one, once the output is written.
+void writeIncrementalState();
+} // namespace elf
+} // namespace lld
+
+#endif
@@ -15,6 +15,7 @@
 #include "SyntheticSections.h"
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/CodeGen/Analysis.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -207,6 +208,33 @@ void elf::parseFile(InputFile *file) {
   }
 }
 
+template <class ELFT> static void doHashSymbolNames(InputFile *file) {
+  if (auto *f = dyn_cast<ObjFile<ELFT>>(file))
+    if (f->ekind == config->ekind)
+      f->hashSymbolNames();
+}
+
+void elf::hashSymbolNames(ArrayRef<InputFile *> files) {
+  parallelForEach(files, [](InputFile *file) {
+    switch (config->ekind) {
+    case ELF32LEKind:
+      doHashSymbolNames<ELF32LE>(file);
+      return;
+    case ELF32BEKind:
+      doHashSymbolNames<ELF32BE>(file);
+      return;
+    case ELF64LEKind:
+      doHashSymbolNames<ELF64LE>(file);
+      return;
+    case ELF64BEKind:
+      doHashSymbolNames<ELF64BE>(file);
+      return;
+    default:
+      llvm_unreachable("unknown ELFT");
+    }
+  });
+}
+
 // Concatenates arguments to construct a string representing an error location.
 static std::string createFileLineMsg(StringRef path, unsigned line) {
   std::string filename = path::filename(path);
@@ -460,6 +488,23 @@ template <class ELFT> void ObjFile<ELFT>::parse(bool ignoreComdats) {
   initializeSymbols();
 }
 
+template <class ELFT> void ObjFile<ELFT>::hashSymbolNames() {
+  ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
+  symbolKeys.resize(eSyms.size(), CachedHashStringRef(""));
+  for (size_t i = this->firstGlobal, end = eSyms.size(); i != end; ++i) {
+    if (eSyms[i].getBinding() == STB_LOCAL)
+      continue;
+    // Leave errors to initializeSymbols(), which reports them.
+    Expected<StringRef> name = eSyms[i].getName(this->stringTable);
+    if (!name) {
+      consumeError(name.takeError());
+      symbolKeys.clear();
+      return;
+    }
+    symbolKeys[i] = SymbolTable::getKey(*name);
+  }
+}
+
 // Sections with SHT_GROUP and comdat bits define comdat section groups.
 // They are identified and deduplicated by group name. This function
 // returns a group name.
@@ -1052,10 +1097,16 @@ template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
 
   // Our symbol table may have already been partially initialized
   // because of LazyObjFile.
-  for (size_t i = 0, end = eSyms.size(); i != end; ++i)
-    if (!this->symbols[i] && eSyms[i].getBinding() != STB_LOCAL)
+  for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
+    if (this->symbols[i] || eSyms[i].getBinding() == STB_LOCAL)
+      continue;
+    if (i < symbolKeys.size() && i >= this->firstGlobal)
+      this->symbols[i] = symtab->insert(symbolKeys[i]);
+    else
       this->symbols[i] =
           symtab->insert(CHECK(eSyms[i].getName(this->stringTable), this));
+  }
+  symbolKeys = {};
 
   // Fill this->Symbols. A symbol is either local or global.
   for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
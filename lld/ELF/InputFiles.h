@@ -57,6 +57,10 @@ llvm::Optional<MemoryBufferRef> readFile(StringRef path);
 // Add symbols in File to the symbol table.
 void parseFile(InputFile *file);
 
+// Computes the symbol table keys of the global symbols of the object files
+// in Files in parallel, so that parseFile doesn't have to hash their names.
+void hashSymbolNames(ArrayRef<InputFile *> files);
+
 // The root class of input files.
 class InputFile {
 public:
@@ -207,6 +211,9 @@ public:
 
   void parse(bool ignoreComdats = false);
 
+  // Fills symbolKeys. Thread-safe, as it only reads this file.
+  void hashSymbolNames();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -253,6 +260,10 @@ public:
   ArrayRef<Elf_CGProfile> cgProfile;
 
 private:
+  // Symbol table keys of the global symbols, indexed like the ELF symbol
+  // table, if hashSymbolNames() was called. Freed by initializeSymbols().
+  std::vector<llvm::CachedHashStringRef> symbolKeys;
+
   void initializeSections(bool ignoreComdats);
   void initializeSymbols();
   void initializeJustSymbols();
@@ -71,6 +71,7 @@ InputSectionBase::InputSectionBase(InputFile *file, uint64_t flags,
 
   numRelocations = 0;
   areRelocsRela = false;
+  compressedWithZstd = false;
 
   // The ELF spec states that a value of 0 means the section has
   // no alignment constraits.
@@ -84,10 +85,13 @@ InputSectionBase::InputSectionBase(InputFile *file, uint64_t flags,
   // If that's the case, demangle section name so that we can handle a
   // section as if it weren't compressed.
   if ((flags & SHF_COMPRESSED) || name.startswith(".zdebug")) {
-    if (!zlib::isAvailable())
-      error(toString(file) + ": contains a compressed section, " +
-            "but zlib is not available");
     parseCompressedHeader();
+    compression::Format format = compressedWithZstd
+                                     ? compression::Format::Zstd
+                                     : compression::Format::Zlib;
+    if (!compression::isAvailable(format))
+      error(toString(file) + ": contains a compressed section, but " +
+            compression::getName(format).str() + " is not available");
   }
 }
 
@@ -151,7 +155,10 @@ void InputSectionBase::uncompress() const {
     uncompressedBuf = bAlloc.Allocate<char>(size);
   }
 
-  if (Error e = zlib::uncompress(toStringRef(rawData), uncompressedBuf, size))
+  Error e = compressedWithZstd
+                ? zstd::uncompress(toStringRef(rawData), uncompressedBuf, size)
+                : zlib::uncompress(toStringRef(rawData), uncompressedBuf, size);
+  if (e)
     fatal(toString(this) +
           ": uncompress failed: " + llvm::toString(std::move(e)));
   rawData = makeArrayRef((uint8_t *)uncompressedBuf, size);
@@ -246,12 +253,13 @@ void InputSectionBase::parseCompressedHeader() {
     }
 
     auto *hdr = reinterpret_cast<const Chdr64 *>(rawData.data());
-    if (hdr->ch_type != ELFCOMPRESS_ZLIB) {
+    if (hdr->ch_type != ELFCOMPRESS_ZLIB && hdr->ch_type != ELFCOMPRESS_ZSTD) {
       error(toString(this) + ": unsupported compression type");
       return;
     }
 
     uncompressedSize = hdr->ch_size;
+    compressedWithZstd = hdr->ch_type == ELFCOMPRESS_ZSTD;
     alignment = std::max<uint32_t>(hdr->ch_addralign, 1);
     rawData = rawData.slice(sizeof(*hdr));
     return;
@@ -264,12 +272,13 @@ void InputSectionBase::parseCompressedHeader() {
   }
 
   auto *hdr = reinterpret_cast<const Chdr32 *>(rawData.data());
-  if (hdr->ch_type != ELFCOMPRESS_ZLIB) {
+  if (hdr->ch_type != ELFCOMPRESS_ZLIB && hdr->ch_type != ELFCOMPRESS_ZSTD) {
     error(toString(this) + ": unsupported compression type");
     return;
   }
 
   uncompressedSize = hdr->ch_size;
+  compressedWithZstd = hdr->ch_type == ELFCOMPRESS_ZSTD;
   alignment = std::max<uint32_t>(hdr->ch_addralign, 1);
   rawData = rawData.slice(sizeof(*hdr));
 }
@@ -1111,8 +1120,12 @@ template <class ELFT> void InputSection::writeTo(uint8_t *buf) {
   // to the buffer.
   if (uncompressedSize >= 0) {
     size_t size = uncompressedSize;
-    if (Error e = zlib::uncompress(toStringRef(rawData),
-                                   (char *)(buf + outSecOff), size))
+    char *uncompressedBuf = (char *)(buf + outSecOff);
+    Error e =
+        compressedWithZstd
+            ? zstd::uncompress(toStringRef(rawData), uncompressedBuf, size)
+            : zlib::uncompress(toStringRef(rawData), uncompressedBuf, size);
+    if (e)
       fatal(toString(this) +
             ": uncompress failed: " + llvm::toString(std::move(e)));
     uint8_t *bufEnd = buf + outSecOff + size;
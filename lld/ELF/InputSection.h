@@ -128,8 +128,12 @@ public:
   static bool classof(const SectionBase *s) { return s->kind() != Output; }
 
   // Relocations that refer to this section.
-  unsigned numRelocations : 31;
+  unsigned numRelocations : 30;
   unsigned areRelocsRela : 1;
+
+  // True if rawData is compressed with zstd rather than zlib. Only meaningful
+  // while uncompressedSize is not -1.
+  mutable unsigned compressedWithZstd : 1;
   const void *firstRelocation = nullptr;
 
   // The file which contains this section. Its dynamic type is always
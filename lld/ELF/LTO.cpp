@@ -108,6 +108,10 @@ static lto::Config createConfig() {
   c.DebugPassManager = config->ltoDebugPassManager;
   c.DwoDir = config->dwoDir;
 
+  // The combined module is not used after code generation, and freeing it
+  // can take seconds. Leak it if the process exits without cleaning up.
+  c.DisableFree = errorHandler().exitEarly;
+
   c.CSIRProfile = config->ltoCSProfileFile;
   c.RunCSIRInstr = config->ltoCSProfileGenerate;
 
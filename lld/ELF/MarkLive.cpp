@@ -29,8 +29,10 @@
 #include "Target.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Object/ELF.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <functional>
 #include <vector>
 
@@ -57,6 +59,12 @@ private:
 
   template <class RelTy>
   void resolveReloc(InputSectionBase &sec, RelTy &rel, bool isLSDA);
+  void resolveTarget(Symbol &sym, uint64_t offset, bool isLSDA);
+  bool isResolved(Symbol &sym) const;
+
+  template <class RelTy>
+  void collectRefs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                   std::vector<std::pair<Symbol *, uint64_t>> &refs) const;
 
   template <class RelTy>
   void scanEhFrameSection(EhInputSection &eh, ArrayRef<RelTy> rels);
@@ -86,12 +94,30 @@ static uint64_t getAddend(InputSectionBase &sec,
   return rel.r_addend;
 }
 
+// Returns the offset in its section that a relocation refers to.
+template <class ELFT, class RelTy>
+static uint64_t getTargetOffset(InputSectionBase &sec, Symbol &sym,
+                                const RelTy &rel) {
+  auto *d = dyn_cast<Defined>(&sym);
+  if (!d)
+    return 0;
+  uint64_t offset = d->value;
+  if (d->isSection())
+    offset += getAddend<ELFT>(sec, rel);
+  return offset;
+}
+
 template <class ELFT>
 template <class RelTy>
 void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
                                   bool isLSDA) {
   Symbol &sym = sec.getFile<ELFT>()->getRelocTargetSym(rel);
+  resolveTarget(sym, getTargetOffset<ELFT>(sec, sym, rel), isLSDA);
+}
 
+template <class ELFT>
+void MarkLive<ELFT>::resolveTarget(Symbol &sym, uint64_t offset,
+                                   bool isLSDA) {
   // If a symbol is referenced in a live section, it is used.
   sym.used = true;
 
@@ -100,10 +126,6 @@ void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
     if (!relSec)
       return;
 
-    uint64_t offset = d->value;
-    if (d->isSection())
-      offset += getAddend<ELFT>(sec, rel);
-
     if (!isLSDA || !(relSec->flags & SHF_EXECINSTR))
       enqueue(relSec, offset);
     return;
@@ -117,6 +139,35 @@ void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
     enqueue(sec, 0);
 }
 
+// Returns true if resolveTarget() wouldn't change anything for a reference to
+// sym, because it resolved another reference to the same section before.
+template <class ELFT> bool MarkLive<ELFT>::isResolved(Symbol &sym) const {
+  auto *d = dyn_cast<Defined>(&sym);
+  if (!d || !sym.used)
+    return false;
+  auto *relSec = dyn_cast_or_null<InputSectionBase>(d->section);
+  if (!relSec || relSec == &InputSection::discarded)
+    return true;
+  // Each piece of a mergeable section has its own liveness bit.
+  return !isa<MergeInputSection>(relSec) &&
+         (relSec->partition == 1 || relSec->partition == partition);
+}
+
+// Collects the targets of the relocations of a live section that are not
+// known to be marked yet. This only reads the state of the garbage collector,
+// so it can run on many sections in parallel.
+template <class ELFT>
+template <class RelTy>
+void MarkLive<ELFT>::collectRefs(
+    InputSectionBase &sec, ArrayRef<RelTy> rels,
+    std::vector<std::pair<Symbol *, uint64_t>> &refs) const {
+  for (const RelTy &rel : rels) {
+    Symbol &sym = sec.getFile<ELFT>()->getRelocTargetSym(rel);
+    if (!isResolved(sym))
+      refs.emplace_back(&sym, getTargetOffset<ELFT>(sec, sym, rel));
+  }
+}
+
 // The .eh_frame section is an unfortunate special case.
 // The section is divided in CIEs and FDEs and the relocations it can have are
 // * CIEs can refer to a personality function.
@@ -269,20 +320,34 @@ template <class ELFT> void MarkLive<ELFT>::run() {
 }
 
 template <class ELFT> void MarkLive<ELFT>::mark() {
-  // Mark all reachable sections.
+  // Mark all reachable sections. Live sections are taken from the queue in
+  // batches. The relocations of a batch are read in parallel, and their
+  // targets are then marked serially, so that the result doesn't depend on
+  // the number of threads.
+  const size_t maxBatchSize = 1024;
+  std::vector<InputSection *> batch;
+  std::vector<std::vector<std::pair<Symbol *, uint64_t>>> refs;
   while (!queue.empty()) {
-    InputSectionBase &sec = *queue.pop_back_val();
-
-    if (sec.areRelocsRela) {
-      for (const typename ELFT::Rela &rel : sec.template relas<ELFT>())
-        resolveReloc(sec, rel, false);
-    } else {
-      for (const typename ELFT::Rel &rel : sec.template rels<ELFT>())
-        resolveReloc(sec, rel, false);
-    }
+    size_t n = std::min(queue.size(), maxBatchSize);
+    batch.assign(queue.end() - n, queue.end());
+    queue.resize(queue.size() - n);
+
+    refs.clear();
+    refs.resize(n);
+    parallelForEachN(0, n, [&](size_t i) {
+      InputSectionBase &sec = *batch[i];
+      if (sec.areRelocsRela)
+        collectRefs(sec, sec.template relas<ELFT>(), refs[i]);
+      else
+        collectRefs(sec, sec.template rels<ELFT>(), refs[i]);
+    });
 
-    for (InputSectionBase *isec : sec.dependentSections)
-      enqueue(isec, 0);
+    for (size_t i = 0; i != n; ++i) {
+      for (const std::pair<Symbol *, uint64_t> &ref : refs[i])
+        resolveTarget(*ref.first, ref.second, false);
+      for (InputSectionBase *isec : batch[i]->dependentSections)
+        enqueue(isec, 0);
+    }
   }
 }
 
@@ -306,6 +371,8 @@ template <class ELFT> void MarkLive<ELFT>::moveToMain() {
 // input sections. This function make some or all of them on
 // so that they are emitted to the output file.
 template <class ELFT> void elf::markLive() {
+  llvm::TimeTraceScope timeScope("GC");
+
   // If -gc-sections is not given, no sections are removed.
   if (!config->gcSections) {
     for (InputSectionBase *sec : inputSections)
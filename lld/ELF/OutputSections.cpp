@@ -8,6 +8,7 @@
 
 #include "OutputSections.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "SymbolTable.h"
 #include "SyntheticSections.h"
@@ -185,17 +186,55 @@ template <class ELFT> void OutputSection::maybeCompress() {
     return;
 
   // Create a section header.
+  bool isZstd = *config->compressDebugSections == compression::Format::Zstd;
   zDebugHeader.resize(sizeof(Elf_Chdr));
   auto *hdr = reinterpret_cast<Elf_Chdr *>(zDebugHeader.data());
-  hdr->ch_type = ELFCOMPRESS_ZLIB;
+  hdr->ch_type = isZstd ? ELFCOMPRESS_ZSTD : ELFCOMPRESS_ZLIB;
   hdr->ch_size = size;
   hdr->ch_addralign = alignment;
 
   // Write section contents to a temporary buffer and compress it.
   std::vector<uint8_t> buf(size);
   writeTo<ELFT>(buf.data());
-  if (Error e = zlib::compress(toStringRef(buf), compressedData))
-    fatal("compress failed: " + llvm::toString(std::move(e)));
+
+  // zstd uses its own worker threads for large inputs and produces a single
+  // frame, so there is no need to shard the input here.
+  if (isZstd) {
+    if (Error e = zstd::compress(toStringRef(buf), compressedData))
+      fatal("compress failed: " + llvm::toString(std::move(e)));
+    size = sizeof(Elf_Chdr) + compressedData.size();
+    flags |= SHF_COMPRESSED;
+    return;
+  }
+
+  // Compress the buffer in 1 MiB shards in parallel. Each shard is a raw
+  // deflate stream that ends on a byte boundary, so the shards concatenated
+  // form a single stream, to which we add a zlib header and trailer.
+  const size_t shardSize = 1 << 20;
+  size_t numShards = (buf.size() + shardSize - 1) / shardSize;
+  if (numShards == 0)
+    numShards = 1;
+  std::vector<SmallVector<char, 0>> shards(numShards);
+  std::vector<uint32_t> adlers(numShards);
+  parallelForEachN(0, numShards, [&](size_t i) {
+    StringRef shard = toStringRef(buf).substr(i * shardSize, shardSize);
+    if (Error e = zlib::compressRaw(shard, shards[i], i == numShards - 1))
+      fatal("compress failed: " + llvm::toString(std::move(e)));
+    adlers[i] = zlib::adler32(shard);
+  });
+
+  // CMF 0x78 is deflate with a 32 KiB window. FLG 0x01 makes the header a
+  // multiple of 31 as required.
+  compressedData.assign({'\x78', '\x01'});
+  uint32_t adler = adlers[0];
+  for (size_t i = 0; i < numShards; ++i) {
+    compressedData.append(shards[i].begin(), shards[i].end());
+    if (i > 0)
+      adler = zlib::adler32Combine(
+          adler, adlers[i], std::min(shardSize, buf.size() - i * shardSize));
+  }
+  compressedData.resize(compressedData.size() + 4);
+  write32be(compressedData.end() - 4, adler);
 
   // Update section headers.
   size = sizeof(Elf_Chdr) + compressedData.size();
@@ -233,15 +272,23 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
   std::vector<InputSection *> sections = getInputSections(this);
   std::array<uint8_t, 4> filler = getFiller();
   bool nonZeroFiller = read32(filler.data()) != 0;
-  if (nonZeroFiller)
+
+  // If we are patching the previous output, the buffer is not zero-filled,
+  // so everything that we do not skip has to be written, gaps included.
+  bool patching = isPatchingOutput();
+  if (nonZeroFiller || patching)
     fill(buf, sections.empty() ? size : sections[0]->outSecOff, filler);
 
   parallelForEachN(0, sections.size(), [&](size_t i) {
     InputSection *isec = sections[i];
-    isec->writeTo<ELFT>(buf);
+    if (!isUnchangedSection(isec)) {
+      if (patching)
+        memset(buf + isec->outSecOff, 0, isec->getSize());
+      isec->writeTo<ELFT>(buf);
+    }
 
     // Fill gaps between sections.
-    if (nonZeroFiller) {
+    if (nonZeroFiller || patching) {
       uint8_t *start = buf + isec->outSecOff + isec->getSize();
       uint8_t *end;
       if (i + 1 == sections.size())
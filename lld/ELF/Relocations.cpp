@@ -52,6 +52,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/raw_ostream.h"
@@ -1102,38 +1103,80 @@ struct IRelativeReloc {
 
 static std::vector<IRelativeReloc> iRelativeRelocs;
 
-template <class ELFT, class RelTy>
-static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
-                      RelTy *end) {
-  const RelTy &rel = *i;
-  uint32_t symIndex = rel.getSymbol(config->isMips64EL);
-  Symbol &sym = sec.getFile<ELFT>()->getSymbol(symIndex);
+namespace {
+// The parts of a relocation that depend only on the input files, and not on
+// the GOT, PLT and symbol state that scanning changes. scanRelocations()
+// computes them for many sections in parallel.
+struct DecodedReloc {
+  // Index of the relocation in its section, and of the relocation after it.
+  // MIPS N32 combines consecutive relocations into one.
+  uint32_t index;
+  uint32_t next;
   RelType type;
+  RelExpr expr;
+  uint64_t offset;
+  int64_t addend;
+  Symbol *sym;
+};
+} // namespace
 
-  // Deal with MIPS oddity.
-  if (config->mipsN32Abi) {
-    type = getMipsN32RelType(i, end);
-  } else {
-    type = rel.getType(config->isMips64EL);
-    ++i;
+template <class ELFT, class RelTy>
+static std::vector<DecodedReloc> decodeRelocs(InputSectionBase &sec,
+                                              ArrayRef<RelTy> rels) {
+  OffsetGetter getOffset(sec);
+  std::vector<DecodedReloc> ret;
+  ret.reserve(rels.size());
+
+  for (auto i = rels.begin(), end = rels.end(); i != end;) {
+    const RelTy &rel = *i;
+    uint32_t symIndex = rel.getSymbol(config->isMips64EL);
+    Symbol &sym = sec.getFile<ELFT>()->getSymbol(symIndex);
+    RelType type;
+
+    // Deal with MIPS oddity.
+    if (config->mipsN32Abi) {
+      type = getMipsN32RelType(i, end);
+    } else {
+      type = rel.getType(config->isMips64EL);
+      ++i;
+    }
+
+    // Get an offset in an output section this relocation is applied to.
+    uint64_t offset = getOffset.get(rel.r_offset);
+    if (offset == uint64_t(-1))
+      continue;
+
+    const uint8_t *relocatedAddr = sec.data().begin() + rel.r_offset;
+    RelExpr expr = target->getRelExpr(type, sym, relocatedAddr);
+    int64_t addend = computeAddend<ELFT>(rel, end, sec, expr, sym.isLocal());
+    ret.push_back({uint32_t(&rel - rels.begin()), uint32_t(i - rels.begin()),
+                   type, expr, offset, addend, &sym});
   }
+  return ret;
+}
 
-  // Get an offset in an output section this relocation is applied to.
-  uint64_t offset = getOffset.get(rel.r_offset);
-  if (offset == uint64_t(-1))
-    return;
+// Returns the number of relocations following \p rel that were processed
+// with it.
+template <class ELFT, class RelTy>
+static unsigned scanReloc(InputSectionBase &sec, const RelTy &rel,
+                          const DecodedReloc &r) {
+  uint32_t symIndex = rel.getSymbol(config->isMips64EL);
+  Symbol &sym = *r.sym;
+  RelType type = r.type;
+  uint64_t offset = r.offset;
+  RelExpr expr = r.expr;
+  int64_t addend = r.addend;
 
   // Error if the target symbol is undefined. Symbol index 0 may be used by
   // marker relocations, e.g. R_*_NONE and R_ARM_V4BX. Don't error on them.
   if (symIndex != 0 && maybeReportUndefined<ELFT>(sym, sec, rel.r_offset))
-    return;
+    return 0;
 
   const uint8_t *relocatedAddr = sec.data().begin() + rel.r_offset;
-  RelExpr expr = target->getRelExpr(type, sym, relocatedAddr);
 
   // Ignore "hint" relocations because they are only markers for relaxation.
   if (oneof<R_HINT, R_NONE>(expr))
-    return;
+    return 0;
 
   // We can separate the small code model relocations into 2 categories:
   // 1) Those that access the compiler generated .toc sections.
@@ -1156,9 +1199,6 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
          getLocation(sec, sym, offset));
   }
 
-  // Read an addend.
-  int64_t addend = computeAddend<ELFT>(rel, end, sec, expr, sym.isLocal());
-
   // Relax relocations.
   //
   // If we know that a PLT entry will be resolved within the same ELF module, we
@@ -1193,17 +1233,15 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
   // Process some TLS relocations, including relaxing TLS relocations.
   // Note that this function does not handle all TLS relocations.
   if (unsigned processed =
-          handleTlsRelocation<ELFT>(type, sym, sec, offset, addend, expr)) {
-    i += (processed - 1);
-    return;
-  }
+          handleTlsRelocation<ELFT>(type, sym, sec, offset, addend, expr))
+    return processed - 1;
 
   // We were asked not to generate PLT entries for ifuncs. Instead, pass the
   // direct relocation on through.
   if (sym.isGnuIFunc() && config->zIfuncNoplt) {
     sym.exportDynamic = true;
     mainPart->relaDyn->addReloc(type, &sec, offset, &sym, addend, R_ADDEND, type);
-    return;
+    return 0;
   }
 
   // Non-preemptible ifuncs require special handling. First, handle the usual
@@ -1300,7 +1338,7 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
       // called on all relocations, the relocation is resolved by
       // addIRelativeRelocs().
       iRelativeRelocs.push_back({type, &sec, offset, &sym});
-      return;
+      return 0;
     }
     if (needsGot(expr)) {
       // Redirect GOT accesses to point to the Igot.
@@ -1340,17 +1378,19 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
   }
 
   processRelocAux<ELFT>(sec, expr, type, offset, sym, rel, addend);
+  return 0;
 }
 
 template <class ELFT, class RelTy>
-static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
-  OffsetGetter getOffset(sec);
-
+static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                       ArrayRef<DecodedReloc> decoded) {
   // Not all relocations end up in Sec.Relocations, but a lot do.
   sec.relocations.reserve(rels.size());
 
-  for (auto i = rels.begin(), end = rels.end(); i != end;)
-    scanReloc<ELFT>(sec, getOffset, i, end);
+  uint32_t next = 0;
+  for (const DecodedReloc &r : decoded)
+    if (r.index >= next)
+      next = r.next + scanReloc<ELFT>(sec, rels[r.index], r);
 
   // Sort relocations by offset for more efficient searching for
   // R_RISCV_PCREL_HI20 and R_PPC64_ADDR64.
@@ -1362,11 +1402,37 @@ static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
                       });
 }
 
-template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
-  if (s.areRelocsRela)
-    scanRelocs<ELFT>(s, s.relas<ELFT>());
-  else
-    scanRelocs<ELFT>(s, s.rels<ELFT>());
+// Relocations are decoded in parallel, a batch of sections at a time. The
+// GOT, PLT and dynamic relocations are then allocated serially, in section
+// order, so the output doesn't depend on the number of threads.
+template <class ELFT>
+void elf::scanRelocations(ArrayRef<InputSectionBase *> sections) {
+  // Bounds the memory used by the decoded relocations of a batch.
+  const size_t maxBatchRelocs = 1 << 20;
+
+  for (size_t begin = 0, end; begin != sections.size(); begin = end) {
+    size_t numRelocs = 0;
+    for (end = begin; end != sections.size() && numRelocs < maxBatchRelocs;
+         ++end)
+      numRelocs += sections[end]->numRelocations;
+
+    std::vector<std::vector<DecodedReloc>> decoded(end - begin);
+    parallelForEachN(begin, end, [&](size_t i) {
+      InputSectionBase &sec = *sections[i];
+      if (sec.areRelocsRela)
+        decoded[i - begin] = decodeRelocs<ELFT>(sec, sec.relas<ELFT>());
+      else
+        decoded[i - begin] = decodeRelocs<ELFT>(sec, sec.rels<ELFT>());
+    });
+
+    for (size_t i = begin; i != end; ++i) {
+      InputSectionBase &sec = *sections[i];
+      if (sec.areRelocsRela)
+        scanRelocs<ELFT>(sec, sec.relas<ELFT>(), decoded[i - begin]);
+      else
+        scanRelocs<ELFT>(sec, sec.rels<ELFT>(), decoded[i - begin]);
+    }
+  }
 }
 
 // Figure out which representation to use for any absolute relocs to
@@ -1809,10 +1875,14 @@ bool ThunkCreator::createThunks(ArrayRef<OutputSection *> outputSections) {
   return addressesChanged;
 }
 
-template void elf::scanRelocations<ELF32LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF32BE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64BE>(InputSectionBase &);
+template void
+elf::scanRelocations<ELF32LE>(ArrayRef<InputSectionBase *>);
+template void
+elf::scanRelocations<ELF32BE>(ArrayRef<InputSectionBase *>);
+template void
+elf::scanRelocations<ELF64LE>(ArrayRef<InputSectionBase *>);
+template void
+elf::scanRelocations<ELF64BE>(ArrayRef<InputSectionBase *>);
 template void elf::reportUndefinedSymbols<ELF32LE>();
 template void elf::reportUndefinedSymbols<ELF32BE>();
 template void elf::reportUndefinedSymbols<ELF64LE>();
@@ -112,7 +112,8 @@ struct Relocation {
 // This function writes undefined symbol diagnostics to an internal buffer.
 // Call reportUndefinedSymbols() after calling scanRelocations() to emit
 // the diagnostics.
-template <class ELFT> void scanRelocations(InputSectionBase &);
+template <class ELFT>
+void scanRelocations(ArrayRef<InputSectionBase *> sections);
 
 template <class ELFT> void reportUndefinedSymbols();
 
@@ -0,0 +1,125 @@
+//===- StreamingOutput.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements --stream-output. By default, the output file is mapped
+// into memory and written in place, so that the kernel faults in every page of
+// it, which is costly if the file is on a network file system. With this
+// option, the output is built in anonymous memory. The writer reports each
+// output section as soon as it is written, and the 1 MiB chunks that it fully
+// covers are written to the file with large pwrites in the background while
+// the next section is being relocated. The chunks that are shared by several
+// sections, or that hold the build ID, are written at the end.
+//
+//===----------------------------------------------------------------------===//
+
+#include "StreamingOutput.h"
+#include "lld/Common/Threads.h"
+#include "llvm/Support/MathExtras.h"
+
+using namespace llvm;
+using namespace llvm::sys;
+
+using namespace lld;
+using namespace lld::elf;
+
+static const size_t chunkSize = 1024 * 1024;
+
+std::unique_ptr<StreamingBuffer>
+StreamingBuffer::create(StringRef path, size_t size, unsigned mode) {
+  // Special files such as /dev/null are written by the default buffer.
+  fs::file_status st;
+  fs::status(path, st);
+  if (path == "-" || (st.type() != fs::file_type::regular_file &&
+                      st.type() != fs::file_type::file_not_found))
+    return nullptr;
+
+  Expected<fs::TempFile> fileOrErr = fs::TempFile::create(path + ".tmp%%%%%%%",
+                                                         mode);
+  if (!fileOrErr) {
+    consumeError(fileOrErr.takeError());
+    return nullptr;
+  }
+
+  std::error_code ec;
+  MemoryBlock mb = Memory::allocateMappedMemory(
+      size, nullptr, Memory::MF_READ | Memory::MF_WRITE, ec);
+  if (ec) {
+    consumeError(fileOrErr->discard());
+    return nullptr;
+  }
+  return llvm::make_unique<StreamingBuffer>(path, std::move(*fileOrErr),
+                                            OwningMemoryBlock(mb), size);
+}
+
+StreamingBuffer::StreamingBuffer(StringRef path, fs::TempFile file,
+                                 OwningMemoryBlock mem, size_t size)
+    : FileOutputBuffer(path), mem(std::move(mem)), size(size),
+      temp(std::move(file)), os(temp.FD, /*shouldClose=*/false,
+                                /*unbuffered=*/true),
+      written(divideCeil(size, chunkSize)) {}
+
+StreamingBuffer::~StreamingBuffer() {
+  wait();
+  os.clear_error();
+  consumeError(temp.discard());
+}
+
+void StreamingBuffer::wait() {
+  if (pending.valid())
+    pending.get();
+}
+
+// Writes chunks [Begin, End) to the file.
+void StreamingBuffer::writeChunks(size_t begin, size_t end) {
+  uint64_t off = begin * chunkSize;
+  os.seek(off);
+  os.write((const char *)getBufferStart() + off,
+           std::min<uint64_t>(end * chunkSize, size) - off);
+}
+
+void StreamingBuffer::flush(uint64_t begin, uint64_t end) {
+  size_t first = divideCeil(begin, chunkSize);
+  size_t last = end == size ? written.size() : end / chunkSize;
+  if (first >= last)
+    return;
+
+  // Only one write is in flight at a time, as they share the file offset.
+  wait();
+  std::fill(written.begin() + first, written.begin() + last, true);
+  if (threadsEnabled)
+    pending = std::async(std::launch::async,
+                         [=] { writeChunks(first, last); });
+  else
+    writeChunks(first, last);
+}
+
+Error StreamingBuffer::commit() {
+  wait();
+  for (size_t i = 0, e = written.size(); i != e;) {
+    if (written[i]) {
+      ++i;
+      continue;
+    }
+    size_t j = i + 1;
+    while (j != e && !written[j])
+      ++j;
+    writeChunks(i, j);
+    i = j;
+  }
+
+  if (std::error_code ec = os.error()) {
+    os.clear_error();
+    return errorCodeToError(ec);
+  }
+  return temp.keep(FinalPath);
+}
+
+void StreamingBuffer::discard() {
+  wait();
+  consumeError(temp.discard());
+}
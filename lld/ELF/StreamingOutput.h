@@ -0,0 +1,72 @@
+//===- StreamingOutput.h ----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_STREAMING_OUTPUT_H
+#define LLD_ELF_STREAMING_OUTPUT_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Memory.h"
+#include "llvm/Support/raw_ostream.h"
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace lld {
+namespace elf {
+
+// A FileOutputBuffer for --stream-output. The output is built in anonymous
+// memory instead of in a mapping of the output file, and each part of it is
+// written to the file with pwrite as soon as it is complete, while the next
+// output section is being written. This avoids page-faulting in the whole
+// output file, which is slow if it is on a network file system.
+class StreamingBuffer : public llvm::FileOutputBuffer {
+public:
+  // Returns null if the output cannot be streamed, e.g. because it is not a
+  // regular file.
+  static std::unique_ptr<StreamingBuffer> create(StringRef path, size_t size,
+                                                 unsigned mode);
+
+  StreamingBuffer(StringRef path, llvm::sys::fs::TempFile temp,
+                  llvm::sys::OwningMemoryBlock mem, size_t size);
+  ~StreamingBuffer() override;
+
+  uint8_t *getBufferStart() const override { return (uint8_t *)mem.base(); }
+
+  uint8_t *getBufferEnd() const override {
+    return (uint8_t *)mem.base() + size;
+  }
+
+  size_t getBufferSize() const override { return size; }
+
+  // Tells that bytes [Begin, End) of the output are final. The chunks that
+  // lie entirely in the range are written in the background.
+  void flush(uint64_t begin, uint64_t end);
+
+  llvm::Error commit() override;
+  void discard() override;
+
+private:
+  void wait();
+  void writeChunks(size_t begin, size_t end);
+
+  llvm::sys::OwningMemoryBlock mem;
+  size_t size;
+  llvm::sys::fs::TempFile temp;
+  llvm::raw_fd_ostream os;
+
+  // True for each chunk that has been (or is being) written to the file.
+  std::vector<bool> written;
+  std::future<void> pending;
+};
+
+} // namespace elf
+} // namespace lld
+
+#endif
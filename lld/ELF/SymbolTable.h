@@ -42,6 +42,11 @@ public:
   }
 
   Symbol *insert(StringRef name);
+  Symbol *insert(llvm::CachedHashStringRef key);
+
+  // Returns the key under which a symbol named Name is stored. This only
+  // reads Name, so it can be computed ahead of time on any thread.
+  static llvm::CachedHashStringRef getKey(StringRef name);
 
   Symbol *addSymbol(const Symbol &New);
 
@@ -36,6 +36,8 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/TimeProfiler.h"
+#include <array>
 #include <cstdlib>
 #include <thread>
 
@@ -2507,45 +2509,41 @@ readPubNamesAndTypes(const LLDDwarfObj<ELFT> &obj,
   return ret;
 }
 
-// Create a list of symbols from a given list of symbol names and types
-// by uniquifying them by name.
-static std::vector<GdbIndexSection::GdbSymbol>
-createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
-              const std::vector<GdbIndexSection::GdbChunk> &chunks) {
+namespace {
+// Builds the symbol table of .gdb_index from the name tables of the input
+// files, uniquifying symbols by name. The table is sharded by name hash so
+// that the shards can be built in parallel.
+class GdbSymbolTableBuilder {
+public:
   using GdbSymbol = GdbIndexSection::GdbSymbol;
   using NameAttrEntry = GdbIndexSection::NameAttrEntry;
 
-  // For each chunk, compute the number of compilation units preceding it.
-  uint32_t cuIdx = 0;
-  std::vector<uint32_t> cuIdxs(chunks.size());
-  for (uint32_t i = 0, e = chunks.size(); i != e; ++i) {
-    cuIdxs[i] = cuIdx;
-    cuIdx += chunks[i].compilationUnits.size();
-  }
-
-  // The number of symbols we will handle in this function is of the order
-  // of millions for very large executables, so we use multi-threading to
-  // speed it up.
-  size_t numShards = 32;
-  size_t concurrency = 1;
-  if (threadsEnabled)
-    concurrency =
-        std::min<size_t>(PowerOf2Floor(hardware_concurrency()), numShards);
-
-  // A sharded map to uniquify symbols by name.
-  std::vector<DenseMap<CachedHashStringRef, size_t>> map(numShards);
-  size_t shift = 32 - countTrailingZeros(numShards);
-
-  // Instantiate GdbSymbols while uniqufying them by name.
-  std::vector<std::vector<GdbSymbol>> symbols(numShards);
-  parallelForEachN(0, concurrency, [&](size_t threadId) {
-    uint32_t i = 0;
-    for (ArrayRef<NameAttrEntry> entries : nameAttrs) {
-      for (const NameAttrEntry &ent : entries) {
-        size_t shardId = ent.name.hash() >> shift;
-        if ((shardId & (concurrency - 1)) != threadId)
-          continue;
+  static constexpr size_t numShards = 32;
+  using ShardedEntries = std::array<std::vector<NameAttrEntry>, numShards>;
+
+  static size_t getShardId(uint32_t hash) {
+    return hash >> (32 - llvm::countTrailingZeros(numShards));
+  }
+
+  // Adds the name tables of consecutive files. CuIdxs[I] is the number of
+  // compilation units preceding the I'th file. The entries are freed as
+  // they are added.
+  void add(MutableArrayRef<ShardedEntries> nameAttrs,
+           ArrayRef<uint32_t> cuIdxs);
+
+  std::vector<GdbSymbol> finalize();
 
+private:
+  std::array<DenseMap<CachedHashStringRef, size_t>, numShards> map;
+  std::array<std::vector<GdbSymbol>, numShards> symbols;
+};
+} // namespace
+
+void GdbSymbolTableBuilder::add(MutableArrayRef<ShardedEntries> nameAttrs,
+                                ArrayRef<uint32_t> cuIdxs) {
+  parallelForEachN(0, numShards, [&](size_t shardId) {
+    for (size_t i = 0, e = nameAttrs.size(); i != e; ++i) {
+      for (const NameAttrEntry &ent : nameAttrs[i][shardId]) {
         uint32_t v = ent.cuIndexAndAttrs + cuIdxs[i];
         size_t &idx = map[shardId][ent.name];
         if (idx) {
@@ -2556,39 +2554,69 @@ createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
         idx = symbols[shardId].size() + 1;
         symbols[shardId].push_back({ent.name, {v}, 0, 0});
       }
-      ++i;
+      std::vector<NameAttrEntry>().swap(nameAttrs[i][shardId]);
+    }
+  });
+}
+
+std::vector<GdbIndexSection::GdbSymbol> GdbSymbolTableBuilder::finalize() {
+  // The maps are no longer needed.
+  for (DenseMap<CachedHashStringRef, size_t> &m : map)
+    DenseMap<CachedHashStringRef, size_t>().swap(m);
+
+  // CU vectors and symbol names are adjacent in the output file. Compute
+  // the sizes of both for each shard, so that the offsets of each shard's
+  // symbols can be computed in parallel.
+  size_t cuVectorSize[numShards];
+  size_t nameSize[numShards];
+  parallelForEachN(0, numShards, [&](size_t i) {
+    cuVectorSize[i] = nameSize[i] = 0;
+    for (const GdbSymbol &sym : symbols[i]) {
+      cuVectorSize[i] += (sym.cuVector.size() + 1) * 4;
+      nameSize[i] += sym.name.size() + 1;
     }
   });
 
+  size_t cuVectorOff[numShards];
+  size_t nameOff[numShards];
+  size_t off = 0;
+  for (size_t i = 0; i < numShards; ++i) {
+    cuVectorOff[i] = off;
+    off += cuVectorSize[i];
+  }
+  for (size_t i = 0; i < numShards; ++i) {
+    nameOff[i] = off;
+    off += nameSize[i];
+  }
+
+  parallelForEachN(0, numShards, [&](size_t i) {
+    for (GdbSymbol &sym : symbols[i]) {
+      sym.cuVectorOff = cuVectorOff[i];
+      sym.nameOff = nameOff[i];
+      cuVectorOff[i] += (sym.cuVector.size() + 1) * 4;
+      nameOff[i] += sym.name.size() + 1;
+    }
+  });
+
+  // The return type is a flattened vector, so we'll move each shard's
+  // contents to Ret.
   size_t numSymbols = 0;
   for (ArrayRef<GdbSymbol> v : symbols)
     numSymbols += v.size();
 
-  // The return type is a flattened vector, so we'll copy each vector
-  // contents to Ret.
   std::vector<GdbSymbol> ret;
   ret.reserve(numSymbols);
-  for (std::vector<GdbSymbol> &vec : symbols)
+  for (std::vector<GdbSymbol> &vec : symbols) {
     for (GdbSymbol &sym : vec)
       ret.push_back(std::move(sym));
-
-  // CU vectors and symbol names are adjacent in the output file.
-  // We can compute their offsets in the output file now.
-  size_t off = 0;
-  for (GdbSymbol &sym : ret) {
-    sym.cuVectorOff = off;
-    off += (sym.cuVector.size() + 1) * 4;
-  }
-  for (GdbSymbol &sym : ret) {
-    sym.nameOff = off;
-    off += sym.name.size() + 1;
+    std::vector<GdbSymbol>().swap(vec);
   }
-
   return ret;
 }
 
 // Returns a newly-created .gdb_index section.
 template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
+  llvm::TimeTraceScope timeScope("Create .gdb_index");
   std::vector<InputSection *> sections = getDebugInfoSections();
 
   // .debug_gnu_pub{names,types} are useless in executables.
@@ -2599,23 +2627,51 @@ template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
       s->markDead();
 
   std::vector<GdbChunk> chunks(sections.size());
-  std::vector<std::vector<NameAttrEntry>> nameAttrs(sections.size());
-
-  parallelForEachN(0, sections.size(), [&](size_t i) {
-    ObjFile<ELFT> *file = sections[i]->getFile<ELFT>();
-    DWARFContext dwarf(make_unique<LLDDwarfObj<ELFT>>(file));
-
-    chunks[i].sec = sections[i];
-    chunks[i].compilationUnits = readCuList(dwarf);
-    chunks[i].addressAreas = readAddressAreas(dwarf, sections[i]);
-    nameAttrs[i] = readPubNamesAndTypes<ELFT>(
-        static_cast<const LLDDwarfObj<ELFT> &>(dwarf.getDWARFObj()),
-        chunks[i].compilationUnits);
-  });
+  GdbSymbolTableBuilder builder;
+  using ShardedEntries = GdbSymbolTableBuilder::ShardedEntries;
+
+  // Name tables contain the same names many times over, so reading them all
+  // before uniquifying them takes a lot of memory. Instead, we read files in
+  // batches and add each batch's names to the symbol table before reading
+  // the next. A batch is large enough to keep all threads busy.
+  size_t batchSize = threadsEnabled ? hardware_concurrency() * 8 : 1;
+  std::vector<ShardedEntries> nameAttrs;
+  std::vector<uint32_t> cuIdxs;
+  uint32_t cuIdx = 0;
+
+  for (size_t begin = 0; begin < sections.size(); begin += batchSize) {
+    size_t end = std::min(begin + batchSize, sections.size());
+    nameAttrs.resize(end - begin);
+
+    parallelForEachN(begin, end, [&](size_t i) {
+      ObjFile<ELFT> *file = sections[i]->getFile<ELFT>();
+      llvm::TimeTraceScope fileScope("Read debug info", file->getName());
+      DWARFContext dwarf(make_unique<LLDDwarfObj<ELFT>>(file));
+
+      chunks[i].sec = sections[i];
+      chunks[i].compilationUnits = readCuList(dwarf);
+      chunks[i].addressAreas = readAddressAreas(dwarf, sections[i]);
+      std::vector<NameAttrEntry> entries = readPubNamesAndTypes<ELFT>(
+          static_cast<const LLDDwarfObj<ELFT> &>(dwarf.getDWARFObj()),
+          chunks[i].compilationUnits);
+
+      ShardedEntries &out = nameAttrs[i - begin];
+      for (const NameAttrEntry &ent : entries)
+        out[GdbSymbolTableBuilder::getShardId(ent.name.hash())].push_back(ent);
+    });
+
+    // For each chunk, compute the number of compilation units preceding it.
+    cuIdxs.resize(end - begin);
+    for (size_t i = begin; i != end; ++i) {
+      cuIdxs[i - begin] = cuIdx;
+      cuIdx += chunks[i].compilationUnits.size();
+    }
+    builder.add(nameAttrs, cuIdxs);
+  }
 
   auto *ret = make<GdbIndexSection>();
   ret->chunks = std::move(chunks);
-  ret->symbols = createSymbols(nameAttrs, ret->chunks);
+  ret->symbols = builder.finalize();
   ret->initOutputSize();
   return ret;
 }
@@ -2968,25 +3024,50 @@ void MergeNoTailSection::finalizeContents() {
   for (size_t i = 0; i < numShards; ++i)
     shards.emplace_back(StringTableBuilder::RAW, alignment);
 
-  // Concurrency level. Must be a power of 2 to avoid expensive modulo
-  // operations in the following tight loop.
-  size_t concurrency = 1;
-  if (threadsEnabled)
-    concurrency =
-        std::min<size_t>(PowerOf2Floor(hardware_concurrency()), numShards);
-
   // Add section pieces to the builders.
-  parallelForEachN(0, concurrency, [&](size_t threadId) {
-    for (MergeInputSection *sec : sections) {
-      for (size_t i = 0, e = sec->pieces.size(); i != e; ++i) {
-        if (!sec->pieces[i].live)
-          continue;
-        size_t shardId = getShardId(sec->pieces[i].hash);
-        if ((shardId & (concurrency - 1)) == threadId)
-          sec->pieces[i].outputOff = shards[shardId].add(sec->getData(i));
+  if (!threadsEnabled) {
+    for (MergeInputSection *sec : sections)
+      for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
+        if (sec->pieces[i].live)
+          sec->pieces[i].outputOff =
+              shards[getShardId(sec->pieces[i].hash)].add(sec->getData(i));
+  } else {
+    // First, split the input sections into chunks and sort the live pieces
+    // of each chunk by shard. This reads every piece once, instead of once
+    // per thread.
+    struct PieceRef {
+      uint32_t sec;
+      uint32_t piece;
+    };
+    size_t numChunks =
+        std::min<size_t>(sections.size(), hardware_concurrency() * 4);
+    std::vector<std::array<std::vector<PieceRef>, numShards>> chunks(
+        numChunks);
+
+    parallelForEachN(0, numChunks, [&](size_t chunkId) {
+      size_t begin = chunkId * sections.size() / numChunks;
+      size_t end = (chunkId + 1) * sections.size() / numChunks;
+      for (size_t s = begin; s != end; ++s) {
+        MergeInputSection *sec = sections[s];
+        for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
+          if (sec->pieces[i].live)
+            chunks[chunkId][getShardId(sec->pieces[i].hash)].push_back(
+                {(uint32_t)s, (uint32_t)i});
       }
-    }
-  });
+    });
+
+    // Then add the pieces of each shard in the order they appear in the
+    // input, so that the output does not depend on the number of threads.
+    parallelForEachN(0, numShards, [&](size_t shardId) {
+      for (const auto &chunk : chunks) {
+        for (PieceRef ref : chunk[shardId]) {
+          MergeInputSection *sec = sections[ref.sec];
+          sec->pieces[ref.piece].outputOff =
+              shards[shardId].add(sec->getData(ref.piece));
+        }
+      }
+    });
+  }
 
   // Compute an in-section offset for each shard.
   size_t off = 0;
@@ -3020,6 +3101,7 @@ static MergeSyntheticSection *createMergeSynthetic(StringRef name,
 }
 
 template <class ELFT> void elf::splitSections() {
+  llvm::TimeTraceScope timeScope("Split sections");
   // splitIntoPieces needs to be called on each MergeInputSection
   // before calling finalizeContents().
   parallelForEach(inputSections, [](InputSectionBase *sec) {
@@ -3038,6 +3120,7 @@ template <class ELFT> void elf::splitSections() {
 // that it replaces. It then finalizes each synthetic section in order
 // to compute an output offset for each piece of each input section.
 void elf::mergeSections() {
+  llvm::TimeTraceScope timeScope("Merge sections");
   std::vector<MergeSyntheticSection *> mergeSections;
   for (InputSectionBase *&s : inputSections) {
     MergeInputSection *ms = dyn_cast<MergeInputSection>(s);
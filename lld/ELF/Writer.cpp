@@ -10,10 +10,12 @@
 #include "AArch64ErrataFix.h"
 #include "CallGraphSort.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "MapFile.h"
 #include "OutputSections.h"
 #include "Relocations.h"
+#include "StreamingOutput.h"
 #include "SymbolTable.h"
 #include "Symbols.h"
 #include "SyntheticSections.h"
@@ -26,6 +28,7 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/RandomNumberGenerator.h"
 #include "llvm/Support/SHA1.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <climits>
 
@@ -75,9 +78,11 @@ private:
   void writeHeader();
   void writeSections();
   void writeSectionsBinary();
+  void flushSection(OutputSection *sec);
   void writeBuildId();
 
   std::unique_ptr<FileOutputBuffer> &buffer;
+  StreamingBuffer *streamingBuffer = nullptr;
 
   void addRelIpltSymbols();
   void addStartEndSymbols();
@@ -641,8 +646,16 @@ template <class ELFT> void Writer<ELFT>::run() {
   if (errorCount())
     return;
 
-  if (auto e = buffer->commit())
-    error("failed to write to the output file: " + toString(std::move(e)));
+  {
+    llvm::TimeTraceScope timeScope("Commit output file");
+    if (auto e = buffer->commit()) {
+      error("failed to write to the output file: " + toString(std::move(e)));
+      return;
+    }
+  }
+
+  if (config->incremental)
+    writeIncrementalState();
 }
 
 static bool shouldKeepInSymtab(const Defined &sym) {
@@ -1670,6 +1683,8 @@ static bool computeIsPreemptible(const Symbol &b) {
 
 // Create output section objects and add them to OutputSections.
 template <class ELFT> void Writer<ELFT>::finalizeSections() {
+  llvm::TimeTraceScope timeScope("Finalize sections");
+
   Out::preinitArray = findSection(".preinit_array");
   Out::initArray = findSection(".init_array");
   Out::finiArray = findSection(".fini_array");
@@ -1738,7 +1753,10 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
   // Scan relocations. This must be done after every symbol is declared so that
   // we can correctly decide if a dynamic relocation is needed.
   if (!config->relocatable) {
-    forEachRelSec(scanRelocations<ELFT>);
+    llvm::TimeTraceScope timeScope("Scan relocations");
+    std::vector<InputSectionBase *> relSecs;
+    forEachRelSec([&](InputSectionBase &sec) { relSecs.push_back(&sec); });
+    scanRelocations<ELFT>(relSecs);
     reportUndefinedSymbols<ELFT>();
   }
 
@@ -2534,10 +2552,32 @@ template <class ELFT> void Writer<ELFT>::openFile() {
     return;
   }
 
+  if (config->incremental) {
+    buffer = openIncrementalOutput(fileSize);
+    if (buffer) {
+      Out::bufferStart = buffer->getBufferStart();
+      return;
+    }
+  }
+
   unlinkAsync(config->outputFile);
   unsigned flags = 0;
   if (!config->relocatable)
     flags = FileOutputBuffer::F_executable;
+
+  if (config->streamOutput) {
+    unsigned mode = sys::fs::all_read | sys::fs::all_write;
+    if (flags & FileOutputBuffer::F_executable)
+      mode |= sys::fs::all_exe;
+    if (std::unique_ptr<StreamingBuffer> buf =
+            StreamingBuffer::create(config->outputFile, fileSize, mode)) {
+      streamingBuffer = buf.get();
+      buffer = std::move(buf);
+      Out::bufferStart = buffer->getBufferStart();
+      return;
+    }
+  }
+
   Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
       FileOutputBuffer::create(config->outputFile, fileSize, flags);
 
@@ -2551,9 +2591,24 @@ template <class ELFT> void Writer<ELFT>::openFile() {
 }
 
 template <class ELFT> void Writer<ELFT>::writeSectionsBinary() {
-  for (OutputSection *sec : outputSections)
-    if (sec->flags & SHF_ALLOC)
+  for (OutputSection *sec : outputSections) {
+    if (sec->flags & SHF_ALLOC) {
       sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      flushSection(sec);
+    }
+  }
+}
+
+// With --stream-output, starts writing Sec's contents to the output file.
+// Sections holding a build ID are written last, as the build ID is computed
+// after all other contents are written.
+template <class ELFT> void Writer<ELFT>::flushSection(OutputSection *sec) {
+  if (!streamingBuffer || sec->type == SHT_NOBITS)
+    return;
+  for (Partition &part : partitions)
+    if (part.buildId && part.buildId->getParent() == sec)
+      return;
+  streamingBuffer->flush(sec->offset, sec->offset + sec->size);
 }
 
 static void fillTrap(uint8_t *i, uint8_t *end) {
@@ -2596,16 +2651,24 @@ template <class ELFT> void Writer<ELFT>::writeTrapInstr() {
 
 // Write section contents to a mmap'ed file.
 template <class ELFT> void Writer<ELFT>::writeSections() {
+  llvm::TimeTraceScope timeScope("Write sections");
+
   // In -r or -emit-relocs mode, write the relocation sections first as in
   // ELf_Rel targets we might find out that we need to modify the relocated
   // section while doing it.
-  for (OutputSection *sec : outputSections)
-    if (sec->type == SHT_REL || sec->type == SHT_RELA)
+  for (OutputSection *sec : outputSections) {
+    if (sec->type == SHT_REL || sec->type == SHT_RELA) {
       sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      flushSection(sec);
+    }
+  }
 
-  for (OutputSection *sec : outputSections)
-    if (sec->type != SHT_REL && sec->type != SHT_RELA)
+  for (OutputSection *sec : outputSections) {
+    if (sec->type != SHT_REL && sec->type != SHT_RELA) {
       sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      flushSection(sec);
+    }
+  }
 }
 
 // Split one uint8 array into small pieces of uint8 arrays.
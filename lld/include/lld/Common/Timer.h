@@ -18,6 +18,10 @@
 
 namespace lld {
 
+// Writes the events recorded since llvm::timeTraceProfilerInitialize() to
+// Path as a Chrome trace, and stops recording.
+void writeTimeTrace(llvm::StringRef path);
+
 class Timer;
 
 struct ScopedTimer {
@@ -45,6 +45,7 @@ struct Configuration {
   bool stripAll;
   bool stripDebug;
   bool stackFirst;
+  bool timeTraceEnabled;
   bool trace;
   uint32_t globalBase;
   uint32_t initialMemory;
@@ -58,6 +59,7 @@ struct Configuration {
   llvm::StringRef entry;
   llvm::StringRef outputFile;
   llvm::StringRef thinLTOCacheDir;
+  llvm::StringRef timeTraceFile;
 
   llvm::StringSet<> allowUndefinedSymbols;
   llvm::StringSet<> exportedSymbols;
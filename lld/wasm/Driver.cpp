@@ -19,6 +19,7 @@
 #include "lld/Common/Reproduce.h"
 #include "lld/Common/Strings.h"
 #include "lld/Common/Threads.h"
+#include "lld/Common/Timer.h"
 #include "lld/Common/Version.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Object/Wasm.h"
@@ -29,6 +30,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #define DEBUG_TYPE "lld"
 
@@ -94,6 +96,14 @@ bool lld::wasm::link(ArrayRef<const char *> args, bool canExitEarly,
   initLLVM();
   LinkerDriver().link(args);
 
+  // Write the time trace once all time sections are closed.
+  if (config->timeTraceEnabled) {
+    std::string path = config->timeTraceFile;
+    if (path.empty())
+      path = (config->outputFile + ".time-trace").str();
+    writeTimeTrace(path);
+  }
+
   // Exit immediately if we don't need to return to the caller.
   // This saves time because the overhead of calling destructors
   // for all globally-allocated objects is not negligible.
@@ -270,6 +280,8 @@ void LinkerDriver::addLibrary(StringRef name) {
 }
 
 void LinkerDriver::createFiles(opt::InputArgList &args) {
+  llvm::TimeTraceScope timeScope("Load input files");
+
   for (auto *arg : args) {
     switch (arg->getOption().getID()) {
     case OPT_l:
@@ -342,6 +354,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->stripAll = args.hasArg(OPT_strip_all);
   config->stripDebug = args.hasArg(OPT_strip_debug);
   config->stackFirst = args.hasArg(OPT_stack_first);
+  config->timeTraceEnabled = args.hasArg(OPT_time_trace);
+  config->timeTraceFile = args.getLastArgValue(OPT_time_trace_file);
   config->trace = args.hasArg(OPT_trace);
   config->thinLTOCacheDir = args.getLastArgValue(OPT_thinlto_cache_dir);
   config->thinLTOCachePolicy = CHECK(
@@ -689,6 +703,8 @@ void LinkerDriver::link(ArrayRef<const char *> argsArr) {
   readConfigs(args);
   setConfigs();
   checkOptions(args);
+  if (config->timeTraceEnabled)
+    timeTraceProfilerInitialize(errorHandler().logName);
 
   if (auto *arg = args.getLastArg(OPT_allow_undefined_file))
     readImportFile(arg->getValue());
@@ -714,8 +730,11 @@ void LinkerDriver::link(ArrayRef<const char *> argsArr) {
 
   // Add all files to the symbol table. This will add almost all
   // symbols that we need to the symbol table.
-  for (InputFile *f : files)
-    symtab->addFile(f);
+  {
+    llvm::TimeTraceScope timeScope("Parse input files");
+    for (InputFile *f : files)
+      symtab->addFile(f);
+  }
   if (errorCount())
     return;
 
@@ -15,6 +15,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #define DEBUG_TYPE "lld"
 
@@ -68,6 +69,8 @@ void SymbolTable::addCombinedLTOObject() {
   if (bitcodeFiles.empty())
     return;
 
+  llvm::TimeTraceScope timeScope("LTO");
+
   // Compile bitcode files and replace bitcode symbols.
   lto.reset(new BitcodeCompiler);
   for (BitcodeFile *f : bitcodeFiles)
@@ -31,6 +31,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include <cstdarg>
 #include <map>
@@ -182,10 +183,12 @@ void Writer::writeHeader() {
 
 void Writer::writeSections() {
   uint8_t *buf = buffer->getBufferStart();
-  parallelForEach(outputSections, [buf](OutputSection *s) {
+  // The sections write their input chunks in parallel, so write the sections
+  // themselves one after another rather than nesting parallel loops.
+  for (OutputSection *s : outputSections) {
     assert(s->isNeeded());
     s->writeTo(buf);
-  });
+  }
 }
 
 // Fix the memory layout of the output binary.  This assigns memory offsets
@@ -973,4 +976,7 @@ void Writer::createHeader() {
   fileSize += header.size();
 }
 
-void lld::wasm::writeResult() { Writer().run(); }
+void lld::wasm::writeResult() {
+  llvm::TimeTraceScope timeScope("Write output file");
+  Writer().run();
+}
@@ -15,7 +15,9 @@
 #include "lldb/Utility/Scalar.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/lldb-private.h"
+#include "llvm/ADT/Optional.h"
 #include <functional>
+#include <vector>
 
 class DWARFUnit;
 
@@ -297,6 +299,24 @@ private:
   bool GetOpAndEndOffsets(StackFrame &frame, lldb::offset_t &op_offset,
                           lldb::offset_t &end_offset);
 
+  /// A decoded location list entry. The addresses are the ones found in the
+  /// location list, before the base address and slide are applied.
+  struct LocationListEntry {
+    lldb::addr_t low_pc;
+    lldb::addr_t high_pc;
+    /// The offset of the entry's expression in m_data.
+    lldb::offset_t offset;
+    /// The byte length of the entry's expression.
+    lldb::offset_t length;
+  };
+
+  /// Return the entries of the location list, decoding it on first use.
+  const std::vector<LocationListEntry> &GetLocationListEntries() const;
+
+  /// Find the location list entry whose expression applies at  pc, if any.
+  const LocationListEntry *FindLocationListEntry(lldb::addr_t base_addr,
+                                                 lldb::addr_t pc) const;
+
   /// Module which defined this expression.
   lldb::ModuleWP m_module_wp;
 
@@ -315,6 +335,11 @@ private:
   /// relative to the object that owns the location list (the function for
   /// frame base and variable location lists)
   lldb::addr_t m_loclist_slide;
+
+  /// The decoded entries of the location list. Decoding an entry may have to
+  /// read .debug_addr, so this avoids doing it again each time a variable is
+  /// fetched.
+  mutable llvm::Optional<std::vector<LocationListEntry>> m_loclist_entries;
 };
 
 } // namespace lldb_private
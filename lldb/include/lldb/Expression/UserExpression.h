@@ -296,6 +296,7 @@ protected:
                            lldb::StackFrameSP &frame_sp);
 
   Address m_address;       ///< The address the process is stopped in.
+  Block *m_block = nullptr; ///< The innermost lexical block of m_address.
   std::string m_expr_text; ///< The text of the expression, as typed by the user
   std::string m_expr_prefix; ///< The text of the translation-level definitions,
                              ///as provided by the user
@@ -12,6 +12,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -88,6 +89,14 @@ public:
 
   void SetPreloadSymbols(bool b);
 
+  bool GetCacheExpressions() const;
+
+  void SetCacheExpressions(bool b);
+
+  bool GetParallelModuleLoad() const;
+
+  void SetParallelModuleLoad(bool b);
+
   bool GetDisableASLR() const;
 
   void SetDisableASLR(bool b);
@@ -529,6 +538,19 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Find or create the modules for a batch of binaries on multiple threads
+  /// and preload their symbols if target.preload-symbols is set.
+  ///
+  /// The modules are only added to the shared module cache, not to this
+  /// target, so that the GetOrCreateModule calls for them that follow find
+  /// them there with their symbols already parsed, and the order of the
+  /// target's images stays the same. Does nothing unless
+  /// target.parallel-module-load is set.
+  ///
+  /// \param[in] module_specs
+  ///     The criteria for each of the binaries about to be loaded.
+  void PrefetchModules(llvm::ArrayRef<ModuleSpec> module_specs);
+
   // Settings accessors
 
   static const lldb::TargetPropertiesSP &GetGlobalProperties();
@@ -1040,6 +1062,17 @@ public:
                                const EvaluateExpressionOptions &options,
                                ValueObject *ctx_obj, Status &error);
 
+  /// Return the expression cached under \a key if it can run again in
+  /// \a exe_ctx without being parsed again, or else an empty pointer.
+  lldb::UserExpressionSP GetCachedUserExpression(const std::string &key,
+                                                 ExecutionContext &exe_ctx);
+
+  /// Keep a parsed expression under \a key for GetCachedUserExpression.
+  void CacheUserExpression(const std::string &key,
+                           const lldb::UserExpressionSP &expr_sp);
+
+  void ClearUserExpressionCache();
+
   // Creates a FunctionCaller for the given language, the rest of the
   // parameters have the same meaning as for the FunctionCaller constructor.
   // Since a FunctionCaller can't be
@@ -1314,6 +1347,10 @@ protected:
 
   typedef std::map<lldb::user_id_t, StopHookSP> StopHookCollection;
   StopHookCollection m_stop_hooks;
+  /// Parsed expressions by their text and options, see
+  /// GetCachedUserExpression.
+  std::map<std::string, lldb::UserExpressionSP> m_user_expression_cache;
+  std::mutex m_user_expression_cache_mutex;
   lldb::user_id_t m_stop_hook_next_id;
   bool m_valid;
   bool m_suppress_stop_hooks;
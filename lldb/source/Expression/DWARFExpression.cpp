@@ -84,6 +84,7 @@ void DWARFExpression::UpdateValue(uint64_t const_value,
       DataBufferSP(new DataBufferHeap(&const_value, const_value_byte_size)));
   m_data.SetByteOrder(endian::InlHostByteOrder());
   m_data.SetAddressByteSize(addr_byte_size);
+  m_loclist_entries.reset();
 }
 
 void DWARFExpression::DumpLocation(Stream *s, lldb::offset_t offset,
@@ -475,6 +476,7 @@ void DWARFExpression::DumpLocation(Stream *s, lldb::offset_t offset,
 
 void DWARFExpression::SetLocationListSlide(addr_t slide) {
   m_loclist_slide = slide;
+  m_loclist_entries.reset();
 }
 
 int DWARFExpression::GetRegisterKind() { return m_reg_kind; }
@@ -991,34 +993,63 @@ bool DWARFExpression::LocationListContainsAddress(
     return false;
 
   if (IsLocationList()) {
-    lldb::offset_t offset = 0;
-
     if (loclist_base_addr == LLDB_INVALID_ADDRESS)
       return false;
 
-    while (m_data.ValidOffset(offset)) {
-      // We need to figure out what the value is for the location.
-      addr_t lo_pc = LLDB_INVALID_ADDRESS;
-      addr_t hi_pc = LLDB_INVALID_ADDRESS;
-      if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc,
-                                            hi_pc))
-        break;
-
-      if (lo_pc == 0 && hi_pc == 0)
-        break;
-
-      lo_pc += loclist_base_addr - m_loclist_slide;
-      hi_pc += loclist_base_addr - m_loclist_slide;
+    for (const LocationListEntry &entry : GetLocationListEntries()) {
+      addr_t lo_pc = entry.low_pc + loclist_base_addr - m_loclist_slide;
+      addr_t hi_pc = entry.high_pc + loclist_base_addr - m_loclist_slide;
 
       if (lo_pc <= addr && addr < hi_pc)
         return true;
-
-      offset += m_data.GetU16(&offset);
     }
   }
   return false;
 }
 
+const std::vector<DWARFExpression::LocationListEntry> &
+DWARFExpression::GetLocationListEntries() const {
+  if (m_loclist_entries)
+    return *m_loclist_entries;
+
+  m_loclist_entries.emplace();
+  if (!IsLocationList())
+    return *m_loclist_entries;
+
+  lldb::offset_t offset = 0;
+  while (m_data.ValidOffset(offset)) {
+    // We need to figure out what the value is for the location.
+    addr_t lo_pc = LLDB_INVALID_ADDRESS;
+    addr_t hi_pc = LLDB_INVALID_ADDRESS;
+    if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc,
+                                          hi_pc))
+      break;
+
+    if (lo_pc == 0 && hi_pc == 0)
+      break;
+
+    lldb::offset_t length = m_data.GetU16(&offset);
+    m_loclist_entries->push_back({lo_pc, hi_pc, offset, length});
+    offset += length;
+  }
+  return *m_loclist_entries;
+}
+
+const DWARFExpression::LocationListEntry *
+DWARFExpression::FindLocationListEntry(addr_t base_addr, addr_t pc) const {
+  if (base_addr == LLDB_INVALID_ADDRESS || pc == LLDB_INVALID_ADDRESS)
+    return nullptr;
+
+  for (const LocationListEntry &entry : GetLocationListEntries()) {
+    addr_t lo_pc = entry.low_pc + base_addr - m_loclist_slide;
+    addr_t hi_pc = entry.high_pc + base_addr - m_loclist_slide;
+
+    if (entry.length > 0 && lo_pc <= pc && pc < hi_pc)
+      return &entry;
+  }
+  return nullptr;
+}
+
 bool DWARFExpression::GetLocation(addr_t base_addr, addr_t pc,
                                   lldb::offset_t &offset,
                                   lldb::offset_t &length) {
@@ -1028,30 +1059,10 @@ bool DWARFExpression::GetLocation(addr_t base_addr, addr_t pc,
     return true;
   }
 
-  if (base_addr != LLDB_INVALID_ADDRESS && pc != LLDB_INVALID_ADDRESS) {
-    addr_t curr_base_addr = base_addr;
-
-    while (m_data.ValidOffset(offset)) {
-      // We need to figure out what the value is for the location.
-      addr_t lo_pc = LLDB_INVALID_ADDRESS;
-      addr_t hi_pc = LLDB_INVALID_ADDRESS;
-      if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc,
-                                            hi_pc))
-        break;
-
-      if (lo_pc == 0 && hi_pc == 0)
-        break;
-
-      lo_pc += curr_base_addr - m_loclist_slide;
-      hi_pc += curr_base_addr - m_loclist_slide;
-
-      length = m_data.GetU16(&offset);
-
-      if (length > 0 && lo_pc <= pc && pc < hi_pc)
-        return true;
-
-      offset += length;
-    }
+  if (const LocationListEntry *entry = FindLocationListEntry(base_addr, pc)) {
+    offset = entry->offset;
+    length = entry->length;
+    return true;
   }
   offset = LLDB_INVALID_OFFSET;
   length = 0;
@@ -1093,7 +1104,6 @@ bool DWARFExpression::Evaluate(ExecutionContext *exe_ctx,
   ModuleSP module_sp = m_module_wp.lock();
 
   if (IsLocationList()) {
-    lldb::offset_t offset = 0;
     addr_t pc;
     StackFrame *frame = nullptr;
     if (reg_ctx)
@@ -1115,31 +1125,12 @@ bool DWARFExpression::Evaluate(ExecutionContext *exe_ctx,
         return false;
       }
 
-      addr_t curr_loclist_base_load_addr = loclist_base_load_addr;
-
-      while (m_data.ValidOffset(offset)) {
-        // We need to figure out what the value is for the location.
-        addr_t lo_pc = LLDB_INVALID_ADDRESS;
-        addr_t hi_pc = LLDB_INVALID_ADDRESS;
-        if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset,
-                                              lo_pc, hi_pc))
-          break;
-
-        if (lo_pc == 0 && hi_pc == 0)
-          break;
-
-        lo_pc += curr_loclist_base_load_addr - m_loclist_slide;
-        hi_pc += curr_loclist_base_load_addr - m_loclist_slide;
-
-        uint16_t length = m_data.GetU16(&offset);
-
-        if (length > 0 && lo_pc <= pc && pc < hi_pc) {
-          return DWARFExpression::Evaluate(
-              exe_ctx, reg_ctx, module_sp, m_data, m_dwarf_cu, offset, length,
-              m_reg_kind, initial_value_ptr, object_address_ptr, result,
-              error_ptr);
-        }
-        offset += length;
+      if (const LocationListEntry *entry =
+              FindLocationListEntry(loclist_base_load_addr, pc)) {
+        return DWARFExpression::Evaluate(
+            exe_ctx, reg_ctx, module_sp, m_data, m_dwarf_cu, entry->offset,
+            entry->length, m_reg_kind, initial_value_ptr, object_address_ptr,
+            result, error_ptr);
       }
     }
     if (error_ptr)
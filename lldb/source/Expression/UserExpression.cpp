@@ -41,6 +41,7 @@
 #include "lldb/Utility/ConstString.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 
@@ -60,8 +61,10 @@ void UserExpression::InstallContext(ExecutionContext &exe_ctx) {
 
   lldb::StackFrameSP frame_sp = exe_ctx.GetFrameSP();
 
-  if (frame_sp)
+  if (frame_sp) {
     m_address = frame_sp->GetFrameCodeAddress();
+    m_block = frame_sp->GetSymbolContext(lldb::eSymbolContextBlock).block;
+  }
 }
 
 bool UserExpression::LockAndCheckContext(ExecutionContext &exe_ctx,
@@ -81,10 +84,15 @@ bool UserExpression::LockAndCheckContext(ExecutionContext &exe_ctx,
   if (m_address.IsValid()) {
     if (!frame_sp)
       return false;
-    else
-      return (0 == Address::CompareLoadAddress(m_address,
-                                               frame_sp->GetFrameCodeAddress(),
-                                               target_sp.get()));
+    if (0 == Address::CompareLoadAddress(m_address,
+                                         frame_sp->GetFrameCodeAddress(),
+                                         target_sp.get()))
+      return true;
+    // Anywhere else in the same lexical block the expression sees the same
+    // variables, so it can run there too.
+    return m_block &&
+           frame_sp->GetSymbolContext(lldb::eSymbolContextBlock).block ==
+               m_block;
   }
 
   return true;
@@ -136,6 +144,20 @@ lldb::addr_t UserExpression::GetObjectPointer(lldb::StackFrameSP frame_sp,
   return ret;
 }
 
+// Everything an expression is parsed with, except for its context.
+static std::string GetExpressionCacheKey(
+    llvm::StringRef expr, llvm::StringRef prefix, lldb::LanguageType language,
+    UserExpression::ResultType desired_type, ExecutionPolicy execution_policy,
+    const EvaluateExpressionOptions &options) {
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << language << ' ' << desired_type << ' ' << execution_policy << ' '
+     << options.GetGenerateDebugInfo() << ' ' << options.GetDebug() << ' '
+     << options.GetUseDynamic() << '\n'
+     << prefix << '\0' << expr;
+  return os.str();
+}
+
 lldb::ExpressionResults UserExpression::Evaluate(
     ExecutionContext &exe_ctx, const EvaluateExpressionOptions &options,
     llvm::StringRef expr, llvm::StringRef prefix,
@@ -218,20 +240,36 @@ lldb::ExpressionResults UserExpression::Evaluate(
       language = frame->GetLanguage();
   }
 
-  lldb::UserExpressionSP user_expression_sp(
-      target->GetUserExpressionForLanguage(expr, full_prefix, language,
-                                           desired_type, options, ctx_obj,
-                                           error));
-  if (error.Fail()) {
-    if (log)
-      log->Printf("== [UserExpression::Evaluate] Getting expression: %s ==",
-                  error.AsCString());
-    return lldb::eExpressionSetupError;
+  // An expression that neither defines nor uses persistent names can run
+  // again without being parsed again while its context still matches.
+  std::string cache_key;
+  if (target->GetCacheExpressions() && !ctx_obj &&
+      execution_policy != eExecutionPolicyTopLevel &&
+      !options.GetREPLEnabled() && !options.IsForUtilityExpr() &&
+      !options.GetPoundLineFilePath() && !expr.contains('$') &&
+      !full_prefix.contains('$'))
+    cache_key = GetExpressionCacheKey(expr, full_prefix, language,
+                                      desired_type, execution_policy, options);
+
+  lldb::UserExpressionSP user_expression_sp;
+  if (!cache_key.empty())
+    user_expression_sp = target->GetCachedUserExpression(cache_key, exe_ctx);
+  const bool is_cached = bool(user_expression_sp);
+
+  if (!is_cached) {
+    user_expression_sp.reset(target->GetUserExpressionForLanguage(
+        expr, full_prefix, language, desired_type, options, ctx_obj, error));
+    if (error.Fail()) {
+      if (log)
+        log->Printf("== [UserExpression::Evaluate] Getting expression: %s ==",
+                    error.AsCString());
+      return lldb::eExpressionSetupError;
+    }
   }
 
   if (log)
-    log->Printf("== [UserExpression::Evaluate] Parsing expression %s ==",
-                expr.str().c_str());
+    log->Printf("== [UserExpression::Evaluate] %s expression %s ==",
+                is_cached ? "Reusing parsed" : "Parsing", expr.str().c_str());
 
   const bool keep_expression_in_memory = true;
   const bool generate_debug_info = options.GetGenerateDebugInfo();
@@ -246,8 +284,11 @@ lldb::ExpressionResults UserExpression::Evaluate(
   DiagnosticManager diagnostic_manager;
 
   bool parse_success =
+      is_cached ||
       user_expression_sp->Parse(diagnostic_manager, exe_ctx, execution_policy,
                                 keep_expression_in_memory, generate_debug_info);
+  if (parse_success && !is_cached && !cache_key.empty())
+    target->CacheUserExpression(cache_key, user_expression_sp);
 
   // Calculate the fixed expression always, since we need it for errors.
   std::string tmp_fixed_expression;
@@ -424,8 +424,14 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
 
   if (m_rendezvous.ModulesDidLoad()) {
     ModuleList new_modules;
+    Target &target = m_process->GetTarget();
 
+    std::vector<ModuleSpec> module_specs;
     E = m_rendezvous.loaded_end();
+    for (I = m_rendezvous.loaded_begin(); I != E; ++I)
+      module_specs.emplace_back(I->file_spec, target.GetArchitecture());
+    target.PrefetchModules(module_specs);
+
     for (I = m_rendezvous.loaded_begin(); I != E; ++I) {
       ModuleSP module_sp =
           LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -580,6 +586,12 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
+  std::vector<ModuleSpec> module_specs;
+  for (const FileSpec &module_name : module_names)
+    module_specs.emplace_back(module_name,
+                              m_process->GetTarget().GetArchitecture());
+  m_process->GetTarget().PrefetchModules(module_specs);
+
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
         LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -12,6 +12,7 @@
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
 #include "lldb/Utility/Endian.h"
@@ -22,152 +23,116 @@ using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
-class MapEntry {
-public:
-  MapEntry() = default;
-  explicit MapEntry(ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-  MapEntry(const MapEntry &rhs) = default;
-  explicit MapEntry(ValueObject *entry)
-      : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-
-  ValueObjectSP left() const {
-    static ConstString g_left("__left_");
-    if (!m_entry_sp)
-      return m_entry_sp;
-    return m_entry_sp->GetSyntheticChildAtOffset(
-        0, m_entry_sp->GetCompilerType(), true);
-  }
-
-  ValueObjectSP right() const {
-    static ConstString g_right("__right_");
-    if (!m_entry_sp)
-      return m_entry_sp;
-    return m_entry_sp->GetSyntheticChildAtOffset(
-        m_entry_sp->GetProcessSP()->GetAddressByteSize(),
-        m_entry_sp->GetCompilerType(), true);
-  }
-
-  ValueObjectSP parent() const {
-    static ConstString g_parent("__parent_");
-    if (!m_entry_sp)
-      return m_entry_sp;
-    return m_entry_sp->GetSyntheticChildAtOffset(
-        2 * m_entry_sp->GetProcessSP()->GetAddressByteSize(),
-        m_entry_sp->GetCompilerType(), true);
-  }
-
-  uint64_t value() const {
-    if (!m_entry_sp)
-      return 0;
-    return m_entry_sp->GetValueAsUnsigned(0);
-  }
-
-  bool error() const {
-    if (!m_entry_sp)
-      return true;
-    return m_entry_sp->GetError().Fail();
-  }
-
-  bool null() const { return (value() == 0); }
-
-  ValueObjectSP GetEntry() const { return m_entry_sp; }
-
-  void SetEntry(ValueObjectSP entry) { m_entry_sp = entry; }
-
-  bool operator==(const MapEntry &rhs) const {
-    return (rhs.m_entry_sp.get() == m_entry_sp.get());
-  }
-
-private:
-  ValueObjectSP m_entry_sp;
-};
-
+// Walks the nodes of a libc++ red-black tree in order. The tree is walked by
+// reading the node pointers straight from process memory, so skipping over
+// nodes does not create a ValueObject for each of them.
 class MapIterator {
 public:
   MapIterator() = default;
-  MapIterator(MapEntry entry, size_t depth = 0)
-      : m_entry(entry), m_max_depth(depth), m_error(false) {}
-  MapIterator(ValueObjectSP entry, size_t depth = 0)
-      : m_entry(entry), m_max_depth(depth), m_error(false) {}
-  MapIterator(const MapIterator &rhs)
-      : m_entry(rhs.m_entry), m_max_depth(rhs.m_max_depth), m_error(false) {}
-  MapIterator(ValueObject *entry, size_t depth = 0)
-      : m_entry(entry), m_max_depth(depth), m_error(false) {}
-
-  ValueObjectSP value() { return m_entry.GetEntry(); }
-
-  ValueObjectSP advance(size_t count) {
-    ValueObjectSP fail;
+  MapIterator(lldb::addr_t node, size_t depth = 0)
+      : m_node(node), m_max_depth(depth), m_error(false) {}
+
+  lldb::addr_t value() const { return m_node; }
+
+  bool advance(Process &process, size_t count) {
     if (m_error)
-      return fail;
-    size_t steps = 0;
+      return false;
     while (count > 0) {
-      next();
-      count--, steps++;
-      if (m_error || m_entry.null() || (steps > m_max_depth))
-        return fail;
+      next(process);
+      count--;
+      if (m_error || m_node == 0)
+        return false;
     }
-    return m_entry.GetEntry();
+    return true;
   }
 
 protected:
-  void next() {
-    if (m_entry.null())
+  void next(Process &process) {
+    if (m_node == 0)
       return;
-    MapEntry right(m_entry.right());
-    if (!right.null()) {
-      m_entry = tree_min(std::move(right));
+    lldb::addr_t right = Right(process, m_node);
+    if (m_error)
+      return;
+    if (right != 0) {
+      m_node = tree_min(process, right);
       return;
     }
     size_t steps = 0;
-    while (!is_left_child(m_entry)) {
-      if (m_entry.error()) {
-        m_error = true;
+    while (!is_left_child(process, m_node)) {
+      if (m_error)
         return;
-      }
-      m_entry.SetEntry(m_entry.parent());
+      m_node = Parent(process, m_node);
       steps++;
       if (steps > m_max_depth) {
-        m_entry = MapEntry();
+        m_node = 0;
         return;
       }
     }
-    m_entry = MapEntry(m_entry.parent());
+    m_node = Parent(process, m_node);
   }
 
 private:
-  MapEntry tree_min(MapEntry &&x) {
-    if (x.null())
-      return MapEntry();
-    MapEntry left(x.left());
+  // The __left_, __right_ and __parent_ pointers are the first three members
+  // of every node.
+  lldb::addr_t ReadNodePointer(Process &process, lldb::addr_t node,
+                               uint32_t index) {
+    if (m_error)
+      return 0;
+    Status error;
+    lldb::addr_t ptr = process.ReadPointerFromMemory(
+        node + index * process.GetAddressByteSize(), error);
+    if (error.Fail()) {
+      m_error = true;
+      return 0;
+    }
+    return ptr;
+  }
+
+  lldb::addr_t Left(Process &process, lldb::addr_t node) {
+    return ReadNodePointer(process, node, 0);
+  }
+  lldb::addr_t Right(Process &process, lldb::addr_t node) {
+    return ReadNodePointer(process, node, 1);
+  }
+  lldb::addr_t Parent(Process &process, lldb::addr_t node) {
+    return ReadNodePointer(process, node, 2);
+  }
+
+  lldb::addr_t tree_min(Process &process, lldb::addr_t x) {
     size_t steps = 0;
-    while (!left.null()) {
-      if (left.error()) {
-        m_error = true;
-        return MapEntry();
-      }
+    for (lldb::addr_t left = Left(process, x); left != 0;
+         left = Left(process, x)) {
       x = left;
-      left.SetEntry(x.left());
       steps++;
       if (steps > m_max_depth)
-        return MapEntry();
+        return 0;
     }
-    return x;
+    return m_error ? 0 : x;
   }
 
-  bool is_left_child(const MapEntry &x) {
-    if (x.null())
+  bool is_left_child(Process &process, lldb::addr_t x) {
+    if (x == 0) {
+      m_error = true;
       return false;
-    MapEntry rhs(x.parent());
-    rhs.SetEntry(rhs.left());
-    return x.value() == rhs.value();
+    }
+    lldb::addr_t parent = Parent(process, x);
+    if (parent == 0) {
+      m_error = true;
+      return false;
+    }
+    return Left(process, parent) == x;
   }
 
-  MapEntry m_entry;
-  size_t m_max_depth;
-  bool m_error;
+  lldb::addr_t m_node = 0;
+  size_t m_max_depth = 0;
+  bool m_error = false;
 };
 
+// Only every g_iterator_stride-th position of the tree is remembered, which
+// bounds both the memory used for large maps and the number of nodes walked
+// to reach an arbitrary child once the map has been enumerated.
+static const size_t g_iterator_stride = 1024;
+
 namespace lldb_private {
 namespace formatters {
 class LibcxxStdMapSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
@@ -191,12 +156,16 @@ private:
 
   void GetValueOffset(const lldb::ValueObjectSP &node);
 
+  lldb::addr_t GetNodeAtIndex(size_t idx);
+
   ValueObject *m_tree;
   ValueObject *m_root_node;
   CompilerType m_element_type;
   uint32_t m_skip_size;
   size_t m_count;
-  std::map<size_t, MapIterator> m_iterators;
+  std::vector<MapIterator> m_iterators;
+  MapIterator m_cursor;
+  size_t m_cursor_idx;
 };
 } // namespace formatters
 } // namespace lldb_private
@@ -205,7 +174,8 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::
     LibcxxStdMapSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp)
     : SyntheticChildrenFrontEnd(*valobj_sp), m_tree(nullptr),
       m_root_node(nullptr), m_element_type(), m_skip_size(UINT32_MAX),
-      m_count(UINT32_MAX), m_iterators() {
+      m_count(UINT32_MAX), m_iterators(), m_cursor(),
+      m_cursor_idx(UINT32_MAX) {
   if (valobj_sp)
     Update();
 }
@@ -338,29 +308,18 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex(
   if (m_tree == nullptr || m_root_node == nullptr)
     return lldb::ValueObjectSP();
 
-  MapIterator iterator(m_root_node, CalculateNumChildren());
-
-  const bool need_to_skip = (idx > 0);
-  size_t actual_advancde = idx;
-  if (need_to_skip) {
-    auto cached_iterator = m_iterators.find(idx - 1);
-    if (cached_iterator != m_iterators.end()) {
-      iterator = cached_iterator->second;
-      actual_advancde = 1;
-    }
-  }
-
-  ValueObjectSP iterated_sp(iterator.advance(actual_advancde));
-  if (!iterated_sp) {
+  lldb::addr_t node = GetNodeAtIndex(idx);
+  if (node == 0) {
     // this tree is garbage - stop
     m_tree =
         nullptr; // this will stop all future searches until an Update() happens
-    return iterated_sp;
+    return lldb::ValueObjectSP();
   }
+  ValueObjectSP iterated_sp;
   if (GetDataType()) {
-    if (!need_to_skip) {
+    if (idx == 0) {
       Status error;
-      iterated_sp = iterated_sp->Dereference(error);
+      iterated_sp = m_root_node->Dereference(error);
       if (!iterated_sp || error.Fail()) {
         m_tree = nullptr;
         return lldb::ValueObjectSP();
@@ -385,8 +344,11 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex(
         m_tree = nullptr;
         return lldb::ValueObjectSP();
       }
-      iterated_sp = iterated_sp->GetSyntheticChildAtOffset(
-          m_skip_size, m_element_type, true);
+      ExecutionContext exe_ctx(
+          m_backend.GetExecutionContextRef().Lock(true));
+      iterated_sp = CreateValueObjectFromAddress(llvm::StringRef(),
+                                                 node + m_skip_size, exe_ctx,
+                                                 m_element_type);
       if (!iterated_sp) {
         m_tree = nullptr;
         return lldb::ValueObjectSP();
@@ -429,16 +391,51 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex(
     }
     }
   }
-  m_iterators[idx] = iterator;
   return potential_child_sp;
 }
 
+lldb::addr_t
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetNodeAtIndex(
+    size_t idx) {
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp)
+    return 0;
+  if (m_iterators.empty())
+    m_iterators.push_back(MapIterator(m_root_node->GetValueAsUnsigned(0),
+                                      CalculateNumChildren()));
+
+  // Start from the closest remembered position before idx, which is the last
+  // child handed out when the children are enumerated in order.
+  size_t pos =
+      std::min(idx / g_iterator_stride, m_iterators.size() - 1) *
+      g_iterator_stride;
+  MapIterator iterator = m_iterators[pos / g_iterator_stride];
+  if (m_cursor_idx <= idx && m_cursor_idx > pos) {
+    iterator = m_cursor;
+    pos = m_cursor_idx;
+  }
+
+  while (pos < idx) {
+    if (!iterator.advance(*process_sp, 1))
+      return 0;
+    pos++;
+    if (pos % g_iterator_stride == 0 &&
+        pos / g_iterator_stride == m_iterators.size())
+      m_iterators.push_back(iterator);
+  }
+  m_cursor = iterator;
+  m_cursor_idx = pos;
+  return iterator.value();
+}
+
 bool lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::Update() {
   static ConstString g___tree_("__tree_");
   static ConstString g___begin_node_("__begin_node_");
   m_count = UINT32_MAX;
   m_tree = m_root_node = nullptr;
   m_iterators.clear();
+  m_cursor = MapIterator();
+  m_cursor_idx = UINT32_MAX;
   m_tree = m_backend.GetChildMemberWithName(g___tree_, true).get();
   if (!m_tree)
     return false;
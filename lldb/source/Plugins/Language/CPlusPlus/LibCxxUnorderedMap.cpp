@@ -12,6 +12,7 @@
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
 #include "lldb/Utility/Endian.h"
@@ -42,12 +43,20 @@ public:
   size_t GetIndexOfChildWithName(ConstString name) override;
 
 private:
+  bool GetNodeType();
+
+  lldb::addr_t GetNodeAtIndex(size_t idx);
+
   CompilerType m_element_type;
   CompilerType m_node_type;
   ValueObject *m_tree;
   size_t m_num_elements;
   ValueObject *m_next_element;
-  std::vector<std::pair<ValueObject *, uint64_t>> m_elements_cache;
+  // The address of every g_node_stride-th node of the list, and of the node
+  // that was handed out last.
+  std::vector<lldb::addr_t> m_nodes;
+  lldb::addr_t m_cursor_node;
+  size_t m_cursor_idx;
 };
 } // namespace formatters
 } // namespace lldb_private
@@ -55,7 +64,8 @@ private:
 lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
     LibcxxStdUnorderedMapSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp)
     : SyntheticChildrenFrontEnd(*valobj_sp), m_element_type(), m_tree(nullptr),
-      m_num_elements(0), m_next_element(nullptr), m_elements_cache() {
+      m_num_elements(0), m_next_element(nullptr), m_nodes(),
+      m_cursor_node(LLDB_INVALID_ADDRESS), m_cursor_idx(UINT32_MAX) {
   if (valobj_sp)
     Update();
 }
@@ -67,102 +77,162 @@ size_t lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
   return 0;
 }
 
+// Only every g_node_stride-th node of the list is remembered, which bounds
+// both the memory used for large containers and the number of nodes walked to
+// reach an arbitrary child once the container has been enumerated.
+static const size_t g_node_stride = 1024;
+
+bool lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
+    GetNodeType() {
+  if (m_node_type)
+    return true;
+  if (m_next_element == nullptr)
+    return false;
+
+  Status error;
+  ValueObjectSP node_sp = m_next_element->Dereference(error);
+  if (!node_sp || error.Fail())
+    return false;
+
+  ValueObjectSP value_sp =
+      node_sp->GetChildMemberWithName(ConstString("__value_"), true);
+  ValueObjectSP hash_sp =
+      node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
+  if (value_sp && hash_sp) {
+    m_node_type = node_sp->GetCompilerType();
+    return true;
+  }
+
+  if (!m_element_type) {
+    auto p1_sp = m_backend.GetChildAtNamePath({ConstString("__table_"),
+                                               ConstString("__p1_")});
+    if (!p1_sp)
+      return false;
+
+    ValueObjectSP first_sp = nullptr;
+    switch (p1_sp->GetCompilerType().GetNumDirectBaseClasses()) {
+    case 1:
+      // Assume a pre llvm r300140 __compressed_pair implementation:
+      first_sp = p1_sp->GetChildMemberWithName(ConstString("__first_"),
+                                               true);
+      break;
+    case 2: {
+      // Assume a post llvm r300140 __compressed_pair implementation:
+      ValueObjectSP first_elem_parent_sp =
+        p1_sp->GetChildAtIndex(0, true);
+      first_sp = p1_sp->GetChildMemberWithName(ConstString("__value_"),
+                                               true);
+      break;
+    }
+    default:
+      return false;
+    }
+
+    if (!first_sp)
+      return false;
+    m_element_type = first_sp->GetCompilerType();
+    m_element_type = m_element_type.GetTypeTemplateArgument(0);
+    m_element_type = m_element_type.GetPointeeType();
+    m_node_type = m_element_type;
+    m_element_type = m_element_type.GetTypeTemplateArgument(0);
+    std::string name;
+    m_element_type =
+        m_element_type.GetFieldAtIndex(0, name, nullptr, nullptr, nullptr);
+    m_element_type = m_element_type.GetTypedefedType();
+  }
+  if (!m_node_type)
+    return false;
+  node_sp = node_sp->Cast(m_node_type);
+  value_sp = node_sp->GetChildMemberWithName(ConstString("__value_"), true);
+  hash_sp = node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
+  if (!value_sp || !hash_sp) {
+    m_node_type.Clear();
+    return false;
+  }
+  return true;
+}
+
+lldb::addr_t lldb_private::formatters::
+    LibcxxStdUnorderedMapSyntheticFrontEnd::GetNodeAtIndex(size_t idx) {
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp)
+    return LLDB_INVALID_ADDRESS;
+  if (m_nodes.empty()) {
+    lldb::addr_t first = m_next_element->GetValueAsUnsigned(0);
+    if (first == 0)
+      return LLDB_INVALID_ADDRESS;
+    m_nodes.push_back(first);
+  }
+
+  // Start from the closest remembered node before idx, which is the last
+  // child handed out when the children are enumerated in order.
+  size_t pos =
+      std::min(idx / g_node_stride, m_nodes.size() - 1) * g_node_stride;
+  lldb::addr_t node = m_nodes[pos / g_node_stride];
+  if (m_cursor_idx <= idx && m_cursor_idx > pos) {
+    node = m_cursor_node;
+    pos = m_cursor_idx;
+  }
+
+  // __next_ is the first member of every node, so follow the list by reading
+  // the pointers straight from memory rather than through ValueObjects.
+  while (pos < idx) {
+    Status error;
+    node = process_sp->ReadPointerFromMemory(node, error);
+    if (error.Fail() || node == 0)
+      return LLDB_INVALID_ADDRESS;
+    pos++;
+    if (pos % g_node_stride == 0 && pos / g_node_stride == m_nodes.size())
+      m_nodes.push_back(node);
+  }
+  m_cursor_node = node;
+  m_cursor_idx = pos;
+  return node;
+}
+
 lldb::ValueObjectSP lldb_private::formatters::
     LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
   if (idx >= CalculateNumChildren())
     return lldb::ValueObjectSP();
-  if (m_tree == nullptr)
+  if (m_tree == nullptr || m_next_element == nullptr)
+    return lldb::ValueObjectSP();
+  if (!GetNodeType())
     return lldb::ValueObjectSP();
 
-  while (idx >= m_elements_cache.size()) {
-    if (m_next_element == nullptr)
-      return lldb::ValueObjectSP();
-
-    Status error;
-    ValueObjectSP node_sp = m_next_element->Dereference(error);
-    if (!node_sp || error.Fail())
-      return lldb::ValueObjectSP();
-
-    ValueObjectSP value_sp =
-        node_sp->GetChildMemberWithName(ConstString("__value_"), true);
-    ValueObjectSP hash_sp =
-        node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
-    if (!hash_sp || !value_sp) {
-      if (!m_element_type) {
-        auto p1_sp = m_backend.GetChildAtNamePath({ConstString("__table_"),
-                                                   ConstString("__p1_")});
-        if (!p1_sp)
-          return nullptr;
-
-        ValueObjectSP first_sp = nullptr;
-        switch (p1_sp->GetCompilerType().GetNumDirectBaseClasses()) {
-        case 1:
-          // Assume a pre llvm r300140 __compressed_pair implementation:
-          first_sp = p1_sp->GetChildMemberWithName(ConstString("__first_"),
-                                                   true);
-          break;
-        case 2: {
-          // Assume a post llvm r300140 __compressed_pair implementation:
-          ValueObjectSP first_elem_parent_sp =
-            p1_sp->GetChildAtIndex(0, true);
-          first_sp = p1_sp->GetChildMemberWithName(ConstString("__value_"),
-                                                   true);
-          break;
-        }
-        default:
-          return nullptr;
-        }
-
-        if (!first_sp)
-          return nullptr;
-        m_element_type = first_sp->GetCompilerType();
-        m_element_type = m_element_type.GetTypeTemplateArgument(0);
-        m_element_type = m_element_type.GetPointeeType();
-        m_node_type = m_element_type;
-        m_element_type = m_element_type.GetTypeTemplateArgument(0);
-        std::string name;
-        m_element_type =
-            m_element_type.GetFieldAtIndex(0, name, nullptr, nullptr, nullptr);
-        m_element_type = m_element_type.GetTypedefedType();
-      }
-      if (!m_node_type)
-        return nullptr;
-      node_sp = node_sp->Cast(m_node_type);
-      value_sp = node_sp->GetChildMemberWithName(ConstString("__value_"), true);
-      hash_sp = node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
-      if (!value_sp || !hash_sp)
-        return nullptr;
-    }
-    m_elements_cache.push_back(
-        {value_sp.get(), hash_sp->GetValueAsUnsigned(0)});
-    m_next_element =
-        node_sp->GetChildMemberWithName(ConstString("__next_"), true).get();
-    if (!m_next_element || m_next_element->GetValueAsUnsigned(0) == 0)
-      m_next_element = nullptr;
-  }
+  lldb::addr_t node = GetNodeAtIndex(idx);
+  if (node == LLDB_INVALID_ADDRESS)
+    return lldb::ValueObjectSP();
 
-  std::pair<ValueObject *, uint64_t> val_hash = m_elements_cache[idx];
-  if (!val_hash.first)
+  const bool thread_and_frame_only_if_stopped = true;
+  ExecutionContext exe_ctx = m_backend.GetExecutionContextRef().Lock(
+      thread_and_frame_only_if_stopped);
+  ValueObjectSP node_sp = CreateValueObjectFromAddress(
+      llvm::StringRef(), node, exe_ctx, m_node_type);
+  if (!node_sp)
+    return lldb::ValueObjectSP();
+  ValueObjectSP value_sp =
+      node_sp->GetChildMemberWithName(ConstString("__value_"), true);
+  if (!value_sp)
     return lldb::ValueObjectSP();
   StreamString stream;
   stream.Printf("[%" PRIu64 "]", (uint64_t)idx);
   DataExtractor data;
   Status error;
-  val_hash.first->GetData(data, error);
+  value_sp->GetData(data, error);
   if (error.Fail())
     return lldb::ValueObjectSP();
-  const bool thread_and_frame_only_if_stopped = true;
-  ExecutionContext exe_ctx = val_hash.first->GetExecutionContextRef().Lock(
-      thread_and_frame_only_if_stopped);
   return CreateValueObjectFromData(stream.GetString(), data, exe_ctx,
-                                   val_hash.first->GetCompilerType());
+                                   value_sp->GetCompilerType());
 }
 
 bool lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
     Update() {
   m_num_elements = UINT32_MAX;
   m_next_element = nullptr;
-  m_elements_cache.clear();
+  m_node_type.Clear();
+  m_nodes.clear();
+  m_cursor_node = LLDB_INVALID_ADDRESS;
+  m_cursor_idx = UINT32_MAX;
   ValueObjectSP table_sp =
       m_backend.GetChildMemberWithName(ConstString("__table_"), true);
   if (!table_sp)
@@ -172,6 +172,64 @@ GDBRemoteClientBase::SendPacketAndWaitForResponse(
   return SendPacketAndWaitForResponseNoLock(payload, response);
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponses(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses, bool send_async,
+    size_t max_in_flight) {
+  responses.clear();
+  Lock lock(*this, send_async);
+  if (!lock) {
+    if (Log *log =
+            ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS))
+      log->Printf("GDBRemoteClientBase::%s failed to get mutex, not sending "
+                  "%zu packets (send_async=%d)",
+                  __FUNCTION__, payloads.size(), send_async);
+    return PacketResult::ErrorSendFailed;
+  }
+
+  // Every packet has to be acknowledged before the next one can be sent.
+  if (GetSendAcks() || max_in_flight < 2) {
+    for (llvm::StringRef payload : payloads) {
+      StringExtractorGDBRemote response;
+      PacketResult packet_result =
+          SendPacketAndWaitForResponseNoLock(payload, response);
+      if (packet_result != PacketResult::Success)
+        return packet_result;
+      responses.push_back(std::move(response));
+    }
+    return PacketResult::Success;
+  }
+
+  PacketResult result = PacketResult::Success;
+  size_t num_sent = 0;
+  size_t num_to_send = payloads.size();
+  responses.resize(num_to_send);
+  for (size_t i = 0; i < num_to_send; ++i) {
+    for (; num_sent < num_to_send && num_sent < i + max_in_flight;
+         ++num_sent) {
+      PacketResult packet_result = SendPacketNoLock(payloads[num_sent]);
+      if (packet_result != PacketResult::Success) {
+        // Still read the responses of the packets that went out, so that
+        // the next exchange doesn't see them.
+        result = packet_result;
+        num_to_send = num_sent;
+        break;
+      }
+    }
+    if (i == num_to_send)
+      break;
+    PacketResult packet_result =
+        ReadPacket(responses[i], GetPacketTimeout(), true);
+    if (packet_result != PacketResult::Success) {
+      responses.resize(i);
+      return packet_result;
+    }
+  }
+  responses.resize(num_to_send);
+  return result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::SendPacketAndReceiveResponseWithOutputSupport(
     llvm::StringRef payload, StringExtractorGDBRemote &response,
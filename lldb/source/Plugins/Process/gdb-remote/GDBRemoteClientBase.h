@@ -11,6 +11,8 @@
 
 #include "GDBRemoteCommunication.h"
 
+#include "llvm/ADT/ArrayRef.h"
+
 #include <condition_variable>
 
 namespace lldb_private {
@@ -47,6 +49,16 @@ public:
                                             StringExtractorGDBRemote &response,
                                             bool send_async);
 
+  // Send all of the payloads before waiting for their responses, with at
+  // most max_in_flight packets outstanding at any time, so that a batch of
+  // requests costs about one round trip. The responses are returned in the
+  // order of the payloads, and only for the packets that were sent. Without
+  // no-ack mode the packets are sent one by one.
+  PacketResult SendPacketsAndWaitForResponses(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses, bool send_async,
+      size_t max_in_flight);
+
   PacketResult SendPacketAndReceiveResponseWithOutputSupport(
       llvm::StringRef payload, StringExtractorGDBRemote &response,
       bool send_async,
@@ -2789,62 +2789,100 @@ void ProcessGDBRemote::WillPublicStop() {
 }
 
 // Process Memory
+// The number of memory read packets sent before waiting for the first reply.
+static const size_t kMaxPipelinedMemoryReads = 8;
+
+// Copy the data of a response to an m or x packet to BUF and return the
+// number of bytes copied.
+static size_t ExtractMemoryReadResponse(StringExtractorGDBRemote &response,
+                                        llvm::StringRef packet, addr_t addr,
+                                        void *buf, size_t size,
+                                        bool binary_memory_read,
+                                        Status &error) {
+  if (response.IsNormalResponse()) {
+    error.Clear();
+    if (binary_memory_read) {
+      // The lower level GDBRemoteCommunication packet receive layer has
+      // already de-quoted any 0x7d character escaping that was present in
+      // the packet
+
+      size_t data_received_size = response.GetBytesLeft();
+      if (data_received_size > size) {
+        // Don't write past the end of BUF if the remote debug server gave us
+        // too much data for some reason.
+        data_received_size = size;
+      }
+      memcpy(buf, response.GetStringRef().data(), data_received_size);
+      return data_received_size;
+    } else {
+      return response.GetHexBytes(
+          llvm::MutableArrayRef<uint8_t>((uint8_t *)buf, size), '\xdd');
+    }
+  } else if (response.IsErrorResponse())
+    error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
+  else if (response.IsUnsupportedResponse())
+    error.SetErrorStringWithFormat(
+        "GDB server does not support reading memory");
+  else
+    error.SetErrorStringWithFormat(
+        "unexpected response to GDB server memory read packet '%s': '%s'",
+        packet.str().c_str(), response.GetStringRef().c_str());
+  return 0;
+}
+
 size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
                                       Status &error) {
+  if (size == 0)
+    return 0;
   GetMaxMemorySize();
   bool binary_memory_read = m_gdb_comm.GetxPacketSupported();
   // M and m packets take 2 bytes for 1 byte of memory
   size_t max_memory_size =
       binary_memory_read ? m_max_memory_size : m_max_memory_size / 2;
   if (size > max_memory_size) {
-    // Keep memory read sizes down to a sane limit. This function will be
-    // called multiple times in order to complete the task by
-    // lldb_private::Process so it is ok to do this.
-    size = max_memory_size;
+    // Keep memory read sizes down to a sane limit. Without acks several
+    // packets can be in flight, so read a few of them at once to save round
+    // trips. This function will be called multiple times in order to
+    // complete the task by lldb_private::Process so it is ok to do this.
+    size_t max_packets =
+        m_gdb_comm.GetSendAcks() ? 1 : kMaxPipelinedMemoryReads;
+    size = std::min(size, max_packets * max_memory_size);
   }
 
-  char packet[64];
-  int packet_len;
-  packet_len = ::snprintf(packet, sizeof(packet), "%c%" PRIx64 ",%" PRIx64,
-                          binary_memory_read ? 'x' : 'm', (uint64_t)addr,
-                          (uint64_t)size);
-  assert(packet_len + 1 < (int)sizeof(packet));
-  UNUSED_IF_ASSERT_DISABLED(packet_len);
-  StringExtractorGDBRemote response;
-  if (m_gdb_comm.SendPacketAndWaitForResponse(packet, response, true) ==
-      GDBRemoteCommunication::PacketResult::Success) {
-    if (response.IsNormalResponse()) {
-      error.Clear();
-      if (binary_memory_read) {
-        // The lower level GDBRemoteCommunication packet receive layer has
-        // already de-quoted any 0x7d character escaping that was present in
-        // the packet
-
-        size_t data_received_size = response.GetBytesLeft();
-        if (data_received_size > size) {
-          // Don't write past the end of BUF if the remote debug server gave us
-          // too much data for some reason.
-          data_received_size = size;
-        }
-        memcpy(buf, response.GetStringRef().data(), data_received_size);
-        return data_received_size;
-      } else {
-        return response.GetHexBytes(
-            llvm::MutableArrayRef<uint8_t>((uint8_t *)buf, size), '\xdd');
-      }
-    } else if (response.IsErrorResponse())
-      error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
-    else if (response.IsUnsupportedResponse())
-      error.SetErrorStringWithFormat(
-          "GDB server does not support reading memory");
-    else
-      error.SetErrorStringWithFormat(
-          "unexpected response to GDB server memory read packet '%s': '%s'",
-          packet, response.GetStringRef().c_str());
-  } else {
-    error.SetErrorStringWithFormat("failed to send packet: '%s'", packet);
+  std::vector<std::string> packets;
+  for (size_t offset = 0; offset < size; offset += max_memory_size) {
+    char packet[64];
+    int packet_len;
+    packet_len = ::snprintf(
+        packet, sizeof(packet), "%c%" PRIx64 ",%" PRIx64,
+        binary_memory_read ? 'x' : 'm', (uint64_t)(addr + offset),
+        (uint64_t)std::min(max_memory_size, size - offset));
+    assert(packet_len + 1 < (int)sizeof(packet));
+    UNUSED_IF_ASSERT_DISABLED(packet_len);
+    packets.push_back(packet);
   }
-  return 0;
+
+  std::vector<StringExtractorGDBRemote> responses;
+  m_gdb_comm.SendPacketsAndWaitForResponses(packets, responses, true,
+                                            kMaxPipelinedMemoryReads);
+  if (responses.empty()) {
+    error.SetErrorStringWithFormat("failed to send packet: '%s'",
+                                   packets.front().c_str());
+    return 0;
+  }
+
+  // Stop at the first chunk that wasn't read completely.
+  size_t bytes_read = 0;
+  for (size_t i = 0; i < responses.size(); ++i) {
+    size_t chunk_size = std::min(max_memory_size, size - bytes_read);
+    size_t chunk_read = ExtractMemoryReadResponse(
+        responses[i], packets[i], addr + bytes_read,
+        (uint8_t *)buf + bytes_read, chunk_size, binary_memory_read, error);
+    bytes_read += chunk_read;
+    if (chunk_read != chunk_size)
+      break;
+  }
+  return bytes_read;
 }
 
 Status ProcessGDBRemote::WriteObjectFile(
@@ -15,8 +15,13 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 using namespace lldb;
@@ -31,6 +36,9 @@ void ManualDWARFIndex::Index() {
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, "%p", static_cast<void *>(&debug_info));
 
+  if (LoadFromCache())
+    return;
+
   std::vector<DWARFUnit *> units_to_index;
   units_to_index.reserve(debug_info.GetNumUnits());
   for (size_t U = 0; U < debug_info.GetNumUnits(); ++U) {
@@ -85,6 +93,8 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  SaveToCache();
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
@@ -347,6 +357,151 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
   }
 }
 
+// The cache file starts with a header identifying the module it was built
+// for, followed by a table of all names and then by the maps of the index set,
+// which refer to the names by their position in that table. All values are
+// little endian.
+static const uint32_t kIndexCacheMagic = 0x58444c4c; // "LLDX"
+static const uint32_t kIndexCacheVersion = 1;
+
+static uint64_t GetModificationTimeNs(Module &module) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             module.GetModificationTime().time_since_epoch())
+      .count();
+}
+
+FileSpec ManualDWARFIndex::GetCacheFile() {
+  // Units indexed by another index are left out of this one, so its contents
+  // depend on more than the module.
+  if (!m_index_cache_dir || !m_units_to_avoid.empty())
+    return FileSpec();
+  const UUID &uuid = m_module.GetUUID();
+  if (!uuid.IsValid())
+    return FileSpec();
+  FileSpec file = m_index_cache_dir;
+  file.AppendPathComponent(uuid.GetAsString("") + ".dwarf-index");
+  return file;
+}
+
+bool ManualDWARFIndex::LoadFromCache() {
+  FileSpec file = GetCacheFile();
+  if (!file)
+    return false;
+
+  // Large files are mapped rather than read.
+  auto buffer_or_error =
+      llvm::MemoryBuffer::getFile(file.GetPath(), /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer_or_error)
+    return false;
+  llvm::MemoryBuffer &buffer = **buffer_or_error;
+  DataExtractor data(buffer.getBufferStart(), buffer.getBufferSize(),
+                     eByteOrderLittle, sizeof(uint64_t));
+
+  lldb::offset_t offset = 0;
+  if (data.GetU32(&offset) != kIndexCacheMagic ||
+      data.GetU32(&offset) != kIndexCacheVersion)
+    return false;
+  llvm::ArrayRef<uint8_t> uuid = m_module.GetUUID().GetBytes();
+  const uint32_t uuid_size = data.GetU32(&offset);
+  const void *uuid_bytes = data.GetData(&offset, uuid_size);
+  if (uuid_size != uuid.size() || !uuid_bytes ||
+      memcmp(uuid_bytes, uuid.data(), uuid_size) != 0)
+    return false;
+  if (data.GetU64(&offset) != GetModificationTimeNs(m_module))
+    return false;
+
+  std::vector<ConstString> names(data.GetU32(&offset));
+  for (ConstString &name : names) {
+    const uint32_t size = data.GetU32(&offset);
+    const char *str = static_cast<const char *>(data.GetData(&offset, size));
+    if (!str)
+      return false;
+    name.SetString(llvm::StringRef(str, size));
+  }
+
+  for (NameToDIE *map : m_set.GetMaps()) {
+    if (!map->Decode(data, &offset, names)) {
+      m_set = IndexSet();
+      return false;
+    }
+    map->Finalize();
+  }
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  if (log)
+    m_module.LogMessage(log, "ManualDWARFIndex loaded from %s",
+                        file.GetPath().c_str());
+  return true;
+}
+
+void ManualDWARFIndex::SaveToCache() {
+  FileSpec file = GetCacheFile();
+  if (!file)
+    return;
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  std::string path = file.GetPath();
+  if (std::error_code ec =
+          llvm::sys::fs::create_directories(m_index_cache_dir.GetPath())) {
+    LLDB_LOG(log, "Unable to create {0}: {1}", m_index_cache_dir,
+             ec.message());
+    return;
+  }
+
+  // Write to a temporary file and rename it, so that a concurrent session
+  // never maps a partially written index.
+  int fd;
+  llvm::SmallString<128> temp_path;
+  if (std::error_code ec =
+          llvm::sys::fs::createUniqueFile(path + "-%%%%%%", fd, temp_path)) {
+    LLDB_LOG(log, "Unable to create a file next to {0}: {1}", path,
+             ec.message());
+    return;
+  }
+
+  llvm::DenseMap<const char *, uint32_t> name_ids;
+  std::vector<ConstString> names;
+  for (NameToDIE *map : m_set.GetMaps()) {
+    map->ForEach([&](ConstString name, const DIERef &) {
+      if (name_ids.try_emplace(name.GetCString(), names.size()).second)
+        names.push_back(name);
+      return true;
+    });
+  }
+
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    llvm::support::endian::Writer writer(os, llvm::support::little);
+    llvm::ArrayRef<uint8_t> uuid = m_module.GetUUID().GetBytes();
+    writer.write<uint32_t>(kIndexCacheMagic);
+    writer.write<uint32_t>(kIndexCacheVersion);
+    writer.write<uint32_t>(uuid.size());
+    os.write(reinterpret_cast<const char *>(uuid.data()), uuid.size());
+    writer.write<uint64_t>(GetModificationTimeNs(m_module));
+    writer.write<uint32_t>(names.size());
+    for (ConstString name : names) {
+      writer.write<uint32_t>(name.GetLength());
+      os << name.GetStringRef();
+    }
+    for (NameToDIE *map : m_set.GetMaps())
+      map->Encode(os, name_ids);
+    os.close();
+    if (os.has_error()) {
+      LLDB_LOG(log, "Unable to write {0}", temp_path);
+      os.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      return;
+    }
+  }
+
+  if (std::error_code ec = llvm::sys::fs::rename(temp_path, path)) {
+    LLDB_LOG(log, "Unable to rename {0} to {1}: {2}", temp_path, path,
+             ec.message());
+    llvm::sys::fs::remove(temp_path);
+  }
+}
+
 void ManualDWARFIndex::GetGlobalVariables(ConstString basename, DIEArray &offsets) {
   Index();
   m_set.globals.Find(basename, offsets);
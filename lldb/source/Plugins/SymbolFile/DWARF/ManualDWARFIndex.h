@@ -11,17 +11,24 @@
 
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+#include "lldb/Utility/FileSpec.h"
 #include "llvm/ADT/DenseSet.h"
+#include <array>
 
 class DWARFDebugInfo;
 
 namespace lldb_private {
 class ManualDWARFIndex : public DWARFIndex {
 public:
+  /// If \a index_cache_dir is set, the index is loaded from a file in that
+  /// directory when it was saved there for the same module UUID and
+  /// modification time, and saved there after it is built otherwise.
   ManualDWARFIndex(Module &module, DWARFDebugInfo *debug_info,
-                   llvm::DenseSet<dw_offset_t> units_to_avoid = {})
+                   llvm::DenseSet<dw_offset_t> units_to_avoid = {},
+                   FileSpec index_cache_dir = {})
       : DWARFIndex(module), m_debug_info(debug_info),
-        m_units_to_avoid(std::move(units_to_avoid)) {}
+        m_units_to_avoid(std::move(units_to_avoid)),
+        m_index_cache_dir(std::move(index_cache_dir)) {}
 
   void Preload() override { Index(); }
 
@@ -54,6 +61,13 @@ private:
     NameToDIE globals;
     NameToDIE types;
     NameToDIE namespaces;
+
+    /// All maps of the set, in the order in which they are cached.
+    std::array<NameToDIE *, 8> GetMaps() {
+      return {{&function_basenames, &function_fullnames, &function_methods,
+               &function_selectors, &objc_class_selectors, &globals, &types,
+               &namespaces}};
+    }
   };
   void Index();
   void IndexUnit(DWARFUnit &unit, IndexSet &set);
@@ -62,10 +76,18 @@ private:
                             const lldb::LanguageType cu_language,
                             IndexSet &set);
 
+  /// Return the cache file of this module, or an invalid FileSpec if the
+  /// index should not be cached.
+  FileSpec GetCacheFile();
+  bool LoadFromCache();
+  void SaveToCache();
+
   /// Non-null value means we haven't built the index yet.
   DWARFDebugInfo *m_debug_info;
   /// Which dwarf units should we skip while building the index.
   llvm::DenseSet<dw_offset_t> m_units_to_avoid;
+  /// Where to persist the index, empty if it should not be persisted.
+  FileSpec m_index_cache_dir;
 
   IndexSet m_set;
 };
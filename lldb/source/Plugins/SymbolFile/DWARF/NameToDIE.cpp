@@ -10,9 +10,11 @@
 #include "DWARFUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/Support/EndianStream.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -76,3 +78,51 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+// A DIERef is encoded as a word holding its dwo number, whether that is valid
+// and its section, followed by the DIE offset.
+static const uint32_t kDwoNumValid = 1u << 31;
+static const uint32_t kDebugTypes = 1u << 30;
+
+void NameToDIE::Encode(
+    llvm::raw_ostream &os,
+    const llvm::DenseMap<const char *, uint32_t> &name_ids) const {
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  const uint32_t size = m_map.GetSize();
+  writer.write<uint32_t>(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const DIERef &die_ref = m_map.GetValueAtIndexUnchecked(i);
+    auto pos = name_ids.find(m_map.GetCStringAtIndexUnchecked(i).GetCString());
+    assert(pos != name_ids.end() && "name missing from the string table");
+    uint32_t unit = die_ref.dwo_num().getValueOr(0);
+    if (die_ref.dwo_num())
+      unit |= kDwoNumValid;
+    if (die_ref.section() == DIERef::DebugTypes)
+      unit |= kDebugTypes;
+    writer.write<uint32_t>(pos->second);
+    writer.write<uint32_t>(unit);
+    writer.write<uint32_t>(die_ref.die_offset());
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                       llvm::ArrayRef<ConstString> names) {
+  const uint32_t size = data.GetU32(offset_ptr);
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, size * 12ull))
+    return false;
+  m_map.Reserve(m_map.GetSize() + size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const uint32_t name_id = data.GetU32(offset_ptr);
+    const uint32_t unit = data.GetU32(offset_ptr);
+    const dw_offset_t die_offset = data.GetU32(offset_ptr);
+    if (name_id >= names.size())
+      return false;
+    llvm::Optional<uint32_t> dwo_num;
+    if (unit & kDwoNumValid)
+      dwo_num = unit & ~(kDwoNumValid | kDebugTypes);
+    DIERef::Section section =
+        unit & kDebugTypes ? DIERef::DebugTypes : DIERef::DebugInfo;
+    m_map.Append(names[name_id], DIERef(dwo_num, section, die_offset));
+  }
+  return true;
+}
@@ -15,6 +15,17 @@
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/dwarf.h"
 #include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+
+namespace lldb_private {
+class DataExtractor;
+}
+
+namespace llvm {
+class raw_ostream;
+}
 
 class DWARFUnit;
 
@@ -41,6 +52,17 @@ public:
   size_t FindAllEntriesForUnit(const DWARFUnit &unit,
                                DIEArray &info_array) const;
 
+  /// Write the entries of this map to \a os. Each name is written as its
+  /// index in \a name_ids, which must contain all names of this map.
+  void Encode(llvm::raw_ostream &os,
+              const llvm::DenseMap<const char *, uint32_t> &name_ids) const;
+
+  /// Append the entries written by Encode(), looking their names up in
+  /// \a names. Returns false if the data is truncated or malformed.
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr,
+              llvm::ArrayRef<lldb_private::ConstString> names);
+
   void
   ForEach(std::function<bool(lldb_private::ConstString name,
                              const DIERef &die_ref)> const
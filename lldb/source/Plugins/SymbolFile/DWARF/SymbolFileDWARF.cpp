@@ -120,11 +120,15 @@ static constexpr PropertyDefinition g_properties[] = {
      "links will be resolved at DWARF parse time."},
     {"ignore-file-indexes", OptionValue::eTypeBoolean, true, 0, nullptr, {},
      "Ignore indexes present in the object files and always index DWARF "
-     "manually."}};
+     "manually."},
+    {"index-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr, {},
+     "If set, save the DWARF indexes built manually to this directory and "
+     "load them from there for later sessions with an unchanged module."}};
 
 enum {
   ePropertySymLinkPaths,
   ePropertyIgnoreIndexes,
+  ePropertyIndexCachePath,
 };
 
 class PluginProperties : public Properties {
@@ -150,6 +154,11 @@ public:
     return m_collection_sp->GetPropertyAtIndexAsBoolean(
         nullptr, ePropertyIgnoreIndexes, false);
   }
+
+  FileSpec GetIndexCachePath() const {
+    return m_collection_sp->GetPropertyAtIndexAsFileSpec(
+        nullptr, ePropertyIndexCachePath);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -420,8 +429,10 @@ void SymbolFileDWARF::InitializeObject() {
     }
   }
 
-  m_index = llvm::make_unique<ManualDWARFIndex>(*GetObjectFile()->GetModule(),
-                                                DebugInfo());
+  m_index = llvm::make_unique<ManualDWARFIndex>(
+      *GetObjectFile()->GetModule(), DebugInfo(),
+      llvm::DenseSet<dw_offset_t>(),
+      GetGlobalPluginProperties()->GetIndexCachePath());
 }
 
 bool SymbolFileDWARF::SupportedVersion(uint16_t version) {
@@ -182,7 +182,11 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
       BlockMap::const_iterator end = m_L2_cache.end();
 
       if (pos != end) {
-        size_t curr_read_size = cache_line_byte_size - cache_offset;
+        // A line that was only read partially ends the readable memory.
+        const size_t line_size = pos->second->GetByteSize();
+        if (cache_offset >= line_size)
+          return dst_len - bytes_left;
+        size_t curr_read_size = line_size - cache_offset;
         if (curr_read_size > bytes_left)
           curr_read_size = bytes_left;
 
@@ -190,6 +194,8 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
                pos->second->GetBytes() + cache_offset, curr_read_size);
 
         bytes_left -= curr_read_size;
+        if (line_size != cache_line_byte_size)
+          return dst_len - bytes_left;
         curr_addr += curr_read_size + cache_offset;
         cache_offset = 0;
 
@@ -224,17 +230,28 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
+        // Fetch all of the following lines that miss the cache with a single
+        // read, as a read that straddles two lines would otherwise cost two
+        // round trips to a remote process.
+        addr_t end_addr = curr_addr + cache_line_byte_size;
+        while (end_addr < curr_addr + cache_offset + bytes_left &&
+               m_L2_cache.find(end_addr) == m_L2_cache.end() &&
+               !m_invalid_ranges.FindEntryThatContains(end_addr))
+          end_addr += cache_line_byte_size;
+        DataBufferHeap data_buffer(end_addr - curr_addr, 0);
         size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
+            curr_addr, data_buffer.GetBytes(), data_buffer.GetByteSize(),
+            error);
         if (process_bytes_read == 0)
           return dst_len - bytes_left;
 
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
+        for (size_t offset = 0; offset < process_bytes_read;
+             offset += cache_line_byte_size) {
+          size_t line_size = std::min<size_t>(cache_line_byte_size,
+                                              process_bytes_read - offset);
+          m_L2_cache[curr_addr + offset] = std::make_shared<DataBufferHeap>(
+              data_buffer.GetBytes() + offset, line_size);
+        }
         // We have read data and put it into the cache, continue through the
         // loop again to get the data out of the cache...
       }
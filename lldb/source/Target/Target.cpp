@@ -58,6 +58,7 @@
 #include "lldb/Utility/Timer.h"
 
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/ThreadPool.h"
 
 #include <memory>
 #include <mutex>
@@ -187,6 +188,7 @@ void Target::DeleteCurrentProcess() {
     m_process_sp->Finalize();
 
     CleanupProcess();
+    ClearUserExpressionCache();
 
     m_process_sp.reset();
   }
@@ -1631,6 +1633,7 @@ void Target::NotifyModulesRemoved(lldb_private::ModuleList &module_list) {
 void Target::ModulesDidLoad(ModuleList &module_list) {
   const size_t num_images = module_list.GetSize();
   if (m_valid && num_images) {
+    ClearUserExpressionCache();
     for (size_t idx = 0; idx < num_images; ++idx) {
       ModuleSP module_sp(module_list.GetModuleAtIndex(idx));
       LoadScriptingResourceForModule(module_sp, this);
@@ -1662,6 +1665,7 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
+    ClearUserExpressionCache();
     UnloadModuleSections(module_list);
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
@@ -2118,6 +2122,34 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
   return module_sp;
 }
 
+void Target::PrefetchModules(llvm::ArrayRef<ModuleSpec> module_specs) {
+  if (!GetParallelModuleLoad() || module_specs.size() < 2 || !m_platform_sp)
+    return;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "Target::PrefetchModules (%zu modules)",
+                     module_specs.size());
+
+  FileSpecList search_paths = GetExecutableSearchPaths();
+  const bool preload_symbols = GetPreloadSymbols();
+  // Preloading the symbols uses the TaskPool, so these tasks can't run on it
+  // without waiting for themselves.
+  llvm::ThreadPool pool;
+  for (const ModuleSpec &module_spec : module_specs) {
+    if (m_images.FindFirstModule(module_spec))
+      continue;
+    pool.async([this, &module_spec, &search_paths, preload_symbols]() {
+      ModuleSP module_sp;
+      m_platform_sp->GetSharedModule(module_spec, m_process_sp.get(),
+                                     module_sp, &search_paths, nullptr,
+                                     nullptr);
+      if (module_sp && preload_symbols)
+        module_sp->PreloadSymbols();
+    });
+  }
+  pool.wait();
+}
+
 TargetSP Target::CalculateTarget() { return shared_from_this(); }
 
 ProcessSP Target::CalculateProcess() { return m_process_sp; }
@@ -2219,6 +2251,36 @@ UserExpression *Target::GetUserExpressionForLanguage(
   return user_expr;
 }
 
+lldb::UserExpressionSP
+Target::GetCachedUserExpression(const std::string &key,
+                                ExecutionContext &exe_ctx) {
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  auto pos = m_user_expression_cache.find(key);
+  if (pos == m_user_expression_cache.end())
+    return lldb::UserExpressionSP();
+  if (!pos->second->MatchesContext(exe_ctx)) {
+    m_user_expression_cache.erase(pos);
+    return lldb::UserExpressionSP();
+  }
+  return pos->second;
+}
+
+void Target::CacheUserExpression(const std::string &key,
+                                 const lldb::UserExpressionSP &expr_sp) {
+  // Each expression keeps its code and memory in the process, so don't let
+  // the cache grow without bounds.
+  static const size_t g_max_cached_expressions = 64;
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  if (m_user_expression_cache.size() >= g_max_cached_expressions)
+    m_user_expression_cache.clear();
+  m_user_expression_cache[key] = expr_sp;
+}
+
+void Target::ClearUserExpressionCache() {
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  m_user_expression_cache.clear();
+}
+
 FunctionCaller *Target::GetFunctionCallerForLanguage(
     lldb::LanguageType language, const CompilerType &return_type,
     const Address &function_address, const ValueList &arg_value_list,
@@ -3390,6 +3452,14 @@ static constexpr PropertyDefinition g_properties[] = {
               "loses connection with lldb."},
     {"preload-symbols", OptionValue::eTypeBoolean, false, true, nullptr, {},
      "Enable loading of symbol tables before they are needed."},
+    {"cache-expressions", OptionValue::eTypeBoolean, false, true, nullptr, {},
+     "Keep expressions that parsed successfully and run their code again "
+     "when the same expression is evaluated in the same lexical block of the "
+     "same process, until modules are loaded or unloaded."},
+    {"parallel-module-load", OptionValue::eTypeBoolean, false, false, nullptr,
+     {},
+     "Enable creating the modules of a batch of newly loaded shared "
+     "libraries, and preloading their symbol tables, on multiple threads."},
     {"disable-aslr", OptionValue::eTypeBoolean, false, true, nullptr, {},
      "Disable Address Space Layout Randomization (ASLR)"},
     {"disable-stdio", OptionValue::eTypeBoolean, false, false, nullptr, {},
@@ -3502,6 +3572,8 @@ enum {
   ePropertyErrorPath,
   ePropertyDetachOnError,
   ePropertyPreloadSymbols,
+  ePropertyCacheExpressions,
+  ePropertyParallelModuleLoad,
   ePropertyDisableASLR,
   ePropertyDisableSTDIO,
   ePropertyInlineStrategy,
@@ -3777,6 +3849,28 @@ void TargetProperties::SetPreloadSymbols(bool b) {
   m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
 }
 
+bool TargetProperties::GetCacheExpressions() const {
+  const uint32_t idx = ePropertyCacheExpressions;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+void TargetProperties::SetCacheExpressions(bool b) {
+  const uint32_t idx = ePropertyCacheExpressions;
+  m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
+}
+
+bool TargetProperties::GetParallelModuleLoad() const {
+  const uint32_t idx = ePropertyParallelModuleLoad;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+void TargetProperties::SetParallelModuleLoad(bool b) {
+  const uint32_t idx = ePropertyParallelModuleLoad;
+  m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
+}
+
 bool TargetProperties::GetDisableASLR() const {
   const uint32_t idx = ePropertyDisableASLR;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
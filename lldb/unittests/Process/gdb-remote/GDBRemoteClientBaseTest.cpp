@@ -359,3 +359,33 @@ TEST_F(GDBRemoteClientBaseTest, SendPacketAndReceiveResponseWithOutputSupport) {
   ASSERT_EQ("OK", response.GetStringRef());
   ASSERT_EQ("Hello, world", command_output.GetString().str());
 }
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsAndWaitForResponses) {
+  StringExtractorGDBRemote response;
+  std::vector<StringExtractorGDBRemote> responses;
+  std::vector<std::string> payloads = {"x1000,10", "x1010,10", "x1020,10",
+                                       "x1030,10"};
+
+  std::future<PacketResult> result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(payloads, responses, true, 3);
+  });
+
+  // The first three packets are sent before any response arrives.
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(response));
+    ASSERT_EQ(payloads[i], response.GetStringRef());
+  }
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("a"));
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(response));
+  ASSERT_EQ(payloads[3], response.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("b"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("E01"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("d"));
+
+  ASSERT_EQ(PacketResult::Success, result.get());
+  ASSERT_EQ(4u, responses.size());
+  EXPECT_EQ("a", responses[0].GetStringRef());
+  EXPECT_EQ("b", responses[1].GetStringRef());
+  EXPECT_EQ("E01", responses[2].GetStringRef());
+  EXPECT_EQ("d", responses[3].GetStringRef());
+}
@@ -13,11 +13,13 @@
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
 #include "Plugins/SymbolFile/DWARF/DWARFAbbreviationDeclaration.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDataExtractor.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDebugAbbrev.h"
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
 #include "TestingSupport/TestUtilities.h"
@@ -329,3 +331,51 @@ TEST_F(SymbolFileDWARFTests, TestAbbrevMissingTerminator) {
   EXPECT_EQ("abbreviation declaration attribute list not terminated with a "
             "null entry", llvm::toString(std::move(error)));
 }
+
+TEST_F(SymbolFileDWARFTests, TestNameToDIEEncodeDecode) {
+  // Test that a NameToDIE map survives being written to and read back from
+  // the index cache format.
+  ConstString foo("foo"), bar("bar");
+  NameToDIE map;
+  map.Insert(foo, DIERef(llvm::None, DIERef::DebugInfo, 0x10));
+  map.Insert(bar, DIERef(7, DIERef::DebugTypes, 0x20));
+  map.Insert(foo, DIERef(llvm::None, DIERef::DebugTypes, 0x30));
+  map.Finalize();
+
+  llvm::DenseMap<const char *, uint32_t> name_ids;
+  name_ids[foo.GetCString()] = 1;
+  name_ids[bar.GetCString()] = 0;
+  std::string buffer;
+  llvm::raw_string_ostream os(buffer);
+  map.Encode(os, name_ids);
+  os.flush();
+
+  DataExtractor data(buffer.data(), buffer.size(), eByteOrderLittle, 8);
+  std::vector<ConstString> names = {bar, foo};
+  lldb::offset_t offset = 0;
+  NameToDIE decoded;
+  ASSERT_TRUE(decoded.Decode(data, &offset, names));
+  EXPECT_EQ(buffer.size(), offset);
+  decoded.Finalize();
+
+  DIEArray dies;
+  EXPECT_EQ(2u, decoded.Find(foo, dies));
+  llvm::sort(dies, [](const DIERef &a, const DIERef &b) {
+    return a.die_offset() < b.die_offset();
+  });
+  EXPECT_EQ(0x10u, dies[0].die_offset());
+  EXPECT_EQ(llvm::None, dies[0].dwo_num());
+  EXPECT_EQ(DIERef::DebugInfo, dies[0].section());
+  EXPECT_EQ(0x30u, dies[1].die_offset());
+  EXPECT_EQ(DIERef::DebugTypes, dies[1].section());
+  dies.clear();
+  EXPECT_EQ(1u, decoded.Find(bar, dies));
+  EXPECT_EQ(llvm::Optional<uint32_t>(7), dies[0].dwo_num());
+  EXPECT_EQ(DIERef::DebugTypes, dies[0].section());
+  EXPECT_EQ(0x20u, dies[0].die_offset());
+
+  // A name that is not in the table is rejected.
+  offset = 0;
+  NameToDIE truncated;
+  EXPECT_FALSE(truncated.Decode(data, &offset, {bar}));
+}
@@ -58,7 +58,7 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &LLDBTableGenMain);
+  return TableGenMain(argv[0], &LLDBTableGenMain, makeArrayRef(argv, argc));
 }
 
 #ifdef __has_feature
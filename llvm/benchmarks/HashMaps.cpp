@@ -0,0 +1,116 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/SwissMap.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Pointer keys spaced like heap allocations, as used by most DenseMaps.
+static std::vector<void *> getPointerKeys(int64_t N) {
+  std::vector<void *> Keys;
+  for (int64_t I = 0; I != N; ++I)
+    Keys.push_back(reinterpret_cast<void *>(0x100000 + I * 48));
+  return Keys;
+}
+
+static std::vector<std::string> getStringKeys(int64_t N) {
+  std::vector<std::string> Keys;
+  for (int64_t I = 0; I != N; ++I)
+    Keys.push_back("symbol_name_" + std::to_string(I * 7919));
+  return Keys;
+}
+
+template <typename MapT> static void BM_PointerInsert(benchmark::State &state) {
+  std::vector<void *> Keys = getPointerKeys(state.range(0));
+  for (auto _ : state) {
+    MapT M;
+    for (void *K : Keys)
+      M[K] = 1;
+    benchmark::DoNotOptimize(M.size());
+  }
+  state.SetItemsProcessed(state.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_PointerLookup(benchmark::State &state) {
+  std::vector<void *> Keys = getPointerKeys(state.range(0));
+  MapT M;
+  for (void *K : Keys)
+    M[K] = 1;
+  // Look up as many keys that are present as keys that are not.
+  std::vector<void *> Missing = getPointerKeys(2 * state.range(0));
+  for (auto _ : state) {
+    unsigned Found = 0;
+    for (void *K : Missing)
+      Found += M.count(K);
+    benchmark::DoNotOptimize(Found);
+  }
+  state.SetItemsProcessed(state.iterations() * Missing.size());
+}
+
+template <typename MapT> static void BM_PointerChurn(benchmark::State &state) {
+  std::vector<void *> Keys = getPointerKeys(state.range(0));
+  for (auto _ : state) {
+    MapT M;
+    for (size_t I = 0; I != Keys.size(); ++I) {
+      M[Keys[I]] = 1;
+      if (I % 2)
+        M.erase(Keys[I / 2]);
+    }
+    benchmark::DoNotOptimize(M.size());
+  }
+  state.SetItemsProcessed(state.iterations() * Keys.size());
+}
+
+// The StringRef keyed maps refer to the strings in Keys, which outlive them.
+template <typename MapT> static void BM_StringInsert(benchmark::State &state) {
+  std::vector<std::string> Keys = getStringKeys(state.range(0));
+  for (auto _ : state) {
+    MapT M;
+    for (const std::string &K : Keys)
+      M[K] = 1;
+    benchmark::DoNotOptimize(M.size());
+  }
+  state.SetItemsProcessed(state.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_StringLookup(benchmark::State &state) {
+  std::vector<std::string> Keys = getStringKeys(state.range(0));
+  MapT M;
+  for (const std::string &K : Keys)
+    M[K] = 1;
+  std::vector<std::string> Missing = getStringKeys(2 * state.range(0));
+  for (auto _ : state) {
+    unsigned Found = 0;
+    for (const std::string &K : Missing)
+      Found += M.count(K);
+    benchmark::DoNotOptimize(Found);
+  }
+  state.SetItemsProcessed(state.iterations() * Missing.size());
+}
+
+BENCHMARK_TEMPLATE(BM_PointerInsert, DenseMap<void *, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PointerInsert, SwissMap<void *, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PointerLookup, DenseMap<void *, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PointerLookup, SwissMap<void *, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PointerChurn, DenseMap<void *, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_PointerChurn, SwissMap<void *, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringInsert, StringMap<unsigned>)->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringInsert, DenseMap<StringRef, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringInsert, SwissMap<StringRef, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringLookup, StringMap<unsigned>)->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringLookup, DenseMap<StringRef, unsigned>)
+    ->Range(16, 1 << 16);
+BENCHMARK_TEMPLATE(BM_StringLookup, SwissMap<StringRef, unsigned>)
+    ->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,748 @@
+//===- llvm/ADT/SwissMap.h - Group probed hash table ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the SwissMap class, an open addressing hash table in the
+// style of Abseil's "Swiss tables".
+//
+// Next to the buckets, the table keeps one control byte per bucket, which
+// records whether the bucket is empty, deleted, or full, and for full buckets
+// seven bits of the key's hash. A lookup loads a group of control bytes at
+// once and compares them all against the hash bits of the key it is looking
+// for, using SSE2 or NEON where available, so that it usually touches a key
+// only when it is the one being looked for. Unlike DenseMap, this needs no
+// reserved empty and tombstone keys, and the table can be filled up to 7/8
+// without long probe sequences.
+//
+// SwissMap provides the commonly used part of DenseMap's interface and uses
+// the same DenseMapInfo traits, so switching a DenseMap over is a matter of
+// changing its type.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_SWISSMAP_H
+#define LLVM_ADT_SWISSMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemAlloc.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LLVM_SWISSMAP_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__) &&                          \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <arm_neon.h>
+#define LLVM_SWISSMAP_NEON 1
+#endif
+
+namespace llvm {
+
+namespace detail {
+namespace swiss {
+
+/// Control byte values. A full bucket has the low seven bits of its key's
+/// hash as control byte, so that the sign bit tells full buckets apart.
+enum : int8_t { CtrlEmpty = -128, CtrlDeleted = -2 };
+
+inline bool isFull(int8_t Ctrl) { return Ctrl >= 0; }
+
+/// The set of lanes of a group that matched a query. Each lane is represented
+/// by 1 << Shift bits of Mask, of which only the lowest is ever set.
+template <typename T, unsigned Width, unsigned Shift> class BitMask {
+  T Mask;
+
+public:
+  explicit BitMask(T Mask) : Mask(Mask) {}
+
+  explicit operator bool() const { return Mask != 0; }
+
+  /// Returns the index of the lowest matching lane.
+  unsigned lowest() const {
+    return countTrailingZeros(Mask, ZB_Undefined) >> Shift;
+  }
+  void clearLowest() { Mask &= Mask - 1; }
+
+  /// Returns the number of lanes below the lowest matching one.
+  unsigned trailingZeros() const {
+    return Mask ? lowest() : Width;
+  }
+  /// Returns the number of lanes above the highest matching one.
+  unsigned leadingZeros() const {
+    constexpr unsigned ExtraBits = sizeof(T) * 8 - (Width << Shift);
+    return (countLeadingZeros(Mask) - ExtraBits) >> Shift;
+  }
+};
+
+#if defined(LLVM_SWISSMAP_SSE2)
+/// A group of 16 control bytes, probed with SSE2.
+class Group {
+  __m128i Ctrl;
+
+  using Mask = BitMask<uint32_t, 16, 0>;
+
+  static Mask toMask(__m128i V) {
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(V)));
+  }
+
+public:
+  static constexpr unsigned Width = 16;
+
+  explicit Group(const int8_t *Pos)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Pos))) {}
+
+  /// Returns the lanes that may hold a key with the given hash bits.
+  Mask match(int8_t H2) const {
+    return toMask(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl));
+  }
+  Mask matchEmpty() const {
+    return toMask(_mm_cmpeq_epi8(_mm_set1_epi8(CtrlEmpty), Ctrl));
+  }
+  Mask matchEmptyOrDeleted() const { return toMask(Ctrl); }
+};
+#elif defined(LLVM_SWISSMAP_NEON)
+/// A group of 8 control bytes, probed with NEON.
+class Group {
+  int8x8_t Ctrl;
+
+  using Mask = BitMask<uint64_t, 8, 3>;
+
+  static Mask toMask(uint8x8_t V) {
+    return Mask(vget_lane_u64(vreinterpret_u64_u8(V), 0) &
+                0x8080808080808080ULL);
+  }
+
+public:
+  static constexpr unsigned Width = 8;
+
+  explicit Group(const int8_t *Pos) : Ctrl(vld1_s8(Pos)) {}
+
+  /// Returns the lanes that may hold a key with the given hash bits.
+  Mask match(int8_t H2) const { return toMask(vceq_s8(Ctrl, vdup_n_s8(H2))); }
+  Mask matchEmpty() const {
+    return toMask(vceq_s8(Ctrl, vdup_n_s8(CtrlEmpty)));
+  }
+  Mask matchEmptyOrDeleted() const {
+    return toMask(vclt_s8(Ctrl, vdup_n_s8(0)));
+  }
+};
+#else
+/// A group of 8 control bytes, probed with plain 64-bit arithmetic.
+class Group {
+  uint64_t Ctrl;
+
+  using Mask = BitMask<uint64_t, 8, 3>;
+
+  static constexpr uint64_t LSBs = 0x0101010101010101ULL;
+  static constexpr uint64_t MSBs = 0x8080808080808080ULL;
+
+public:
+  static constexpr unsigned Width = 8;
+
+  explicit Group(const int8_t *Pos) : Ctrl(support::endian::read64le(Pos)) {}
+
+  /// Returns the lanes that may hold a key with the given hash bits. This can
+  /// report a full lane that does not match, but never an empty or deleted
+  /// one, which is harmless as the caller compares the keys anyway.
+  Mask match(int8_t H2) const {
+    uint64_t X = Ctrl ^ (LSBs * static_cast<uint8_t>(H2));
+    return Mask((X - LSBs) & ~X & MSBs);
+  }
+  Mask matchEmpty() const { return Mask(Ctrl & (~Ctrl << 6) & MSBs); }
+  Mask matchEmptyOrDeleted() const { return Mask(Ctrl & MSBs); }
+};
+#endif
+
+/// Spreads the entropy of a DenseMapInfo hash, which is often weak in the
+/// low bits, over a 64-bit value.
+inline uint64_t mixHash(unsigned Hash) {
+  uint64_t X = static_cast<uint64_t>(Hash) * 0x9E3779B97F4A7C15ULL;
+  return X ^ (X >> 32);
+}
+
+} // end namespace swiss
+} // end namespace detail
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>,
+          typename Bucket = llvm::detail::DenseMapPair<KeyT, ValueT>,
+          bool IsConst = false>
+class SwissMapIterator;
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>,
+          typename BucketT = llvm::detail::DenseMapPair<KeyT, ValueT>>
+class SwissMap : public DebugEpochBase {
+  using Group = detail::swiss::Group;
+
+  template <typename T>
+  using const_arg_type_t = typename const_pointer_or_const_ref<T>::type;
+
+  /// The control bytes, followed by a copy of the first Group::Width of them
+  /// so that a group can be loaded at any bucket without wrapping around.
+  int8_t *Ctrl = nullptr;
+  BucketT *Buckets = nullptr;
+  unsigned NumBuckets = 0;
+  unsigned NumEntries = 0;
+  /// The number of entries that can be added before the table must grow.
+  /// Deleted buckets count against it until the table is rehashed.
+  unsigned GrowthLeft = 0;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = BucketT;
+
+  using iterator = SwissMapIterator<KeyT, ValueT, KeyInfoT, BucketT>;
+  using const_iterator =
+      SwissMapIterator<KeyT, ValueT, KeyInfoT, BucketT, true>;
+
+  /// Create a SwissMap that can hold at least \p InitialReserve entries
+  /// without growing.
+  explicit SwissMap(unsigned InitialReserve = 0) { reserve(InitialReserve); }
+
+  SwissMap(const SwissMap &Other) : DebugEpochBase() { copyFrom(Other); }
+
+  SwissMap(SwissMap &&Other) : DebugEpochBase() { swap(Other); }
+
+  template <typename InputIt> SwissMap(const InputIt &I, const InputIt &E) {
+    reserve(std::distance(I, E));
+    insert(I, E);
+  }
+
+  SwissMap(std::initializer_list<typename SwissMap::value_type> Vals) {
+    reserve(Vals.size());
+    insert(Vals.begin(), Vals.end());
+  }
+
+  ~SwissMap() {
+    destroyAll();
+    deallocate();
+  }
+
+  SwissMap &operator=(const SwissMap &Other) {
+    if (&Other != this) {
+      destroyAll();
+      deallocate();
+      copyFrom(Other);
+    }
+    return *this;
+  }
+
+  SwissMap &operator=(SwissMap &&Other) {
+    destroyAll();
+    deallocate();
+    Ctrl = nullptr;
+    Buckets = nullptr;
+    NumBuckets = NumEntries = GrowthLeft = 0;
+    swap(Other);
+    return *this;
+  }
+
+  void swap(SwissMap &RHS) {
+    incrementEpoch();
+    RHS.incrementEpoch();
+    std::swap(Ctrl, RHS.Ctrl);
+    std::swap(Buckets, RHS.Buckets);
+    std::swap(NumBuckets, RHS.NumBuckets);
+    std::swap(NumEntries, RHS.NumEntries);
+    std::swap(GrowthLeft, RHS.GrowthLeft);
+  }
+
+  inline iterator begin() {
+    if (empty())
+      return end();
+    return iterator(Buckets, Buckets + NumBuckets, Ctrl, *this);
+  }
+  inline iterator end() {
+    return iterator(Buckets + NumBuckets, Buckets + NumBuckets, nullptr, *this);
+  }
+  inline const_iterator begin() const {
+    if (empty())
+      return end();
+    return const_iterator(Buckets, Buckets + NumBuckets, Ctrl, *this);
+  }
+  inline const_iterator end() const {
+    return const_iterator(Buckets + NumBuckets, Buckets + NumBuckets, nullptr,
+                          *this);
+  }
+
+  LLVM_NODISCARD bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the map so that it can contain at least \p NumEntries items
+  /// before resizing again.
+  void reserve(size_type NumEntries) {
+    unsigned Needed = getMinBucketToReserveForEntries(NumEntries);
+    incrementEpoch();
+    if (Needed > NumBuckets)
+      rehash(Needed);
+  }
+
+  void clear() {
+    incrementEpoch();
+    if (NumEntries == 0 && GrowthLeft == capacityToGrowth(NumBuckets))
+      return;
+
+    // Like DenseMap, give the memory back if the table is mostly unused.
+    if (NumEntries * 4 < NumBuckets && NumBuckets > 64) {
+      shrink_and_clear();
+      return;
+    }
+
+    destroyAll();
+    resetCtrl();
+    NumEntries = 0;
+    GrowthLeft = capacityToGrowth(NumBuckets);
+  }
+
+  void shrink_and_clear() {
+    unsigned OldNumEntries = NumEntries;
+    destroyAll();
+    deallocate();
+    Ctrl = nullptr;
+    Buckets = nullptr;
+    NumBuckets = NumEntries = GrowthLeft = 0;
+    if (OldNumEntries)
+      rehash(getMinBucketToReserveForEntries(OldNumEntries));
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const_arg_type_t<KeyT> Val) const {
+    return findBucket(Val) != NotFound ? 1 : 0;
+  }
+
+  iterator find(const_arg_type_t<KeyT> Val) { return find_as(Val); }
+  const_iterator find(const_arg_type_t<KeyT> Val) const {
+    return find_as(Val);
+  }
+
+  /// Alternate version of find() which allows a different, and possibly
+  /// less expensive, key type.
+  /// The DenseMapInfo is responsible for supplying methods
+  /// getHashValue(LookupKeyT) and isEqual(LookupKeyT, KeyT) for each key
+  /// type used.
+  template <class LookupKeyT> iterator find_as(const LookupKeyT &Val) {
+    unsigned I = findBucket(Val);
+    if (I == NotFound)
+      return end();
+    return iterator(Buckets + I, Buckets + NumBuckets, Ctrl + I, *this, true);
+  }
+  template <class LookupKeyT>
+  const_iterator find_as(const LookupKeyT &Val) const {
+    unsigned I = findBucket(Val);
+    if (I == NotFound)
+      return end();
+    return const_iterator(Buckets + I, Buckets + NumBuckets, Ctrl + I, *this,
+                          true);
+  }
+
+  /// lookup - Return the entry for the specified key, or a default
+  /// constructed value if no such entry exists.
+  ValueT lookup(const_arg_type_t<KeyT> Val) const {
+    unsigned I = findBucket(Val);
+    if (I == NotFound)
+      return ValueT();
+    return Buckets[I].getSecond();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyT &&Key, Ts &&... Args) {
+    return tryEmplaceImpl(std::move(Key), std::forward<Ts>(Args)...);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(const KeyT &Key, Ts &&... Args) {
+    return tryEmplaceImpl(Key, std::forward<Ts>(Args)...);
+  }
+
+  /// insert - Range insertion of pairs.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  bool erase(const KeyT &Val) {
+    unsigned I = findBucket(Val);
+    if (I == NotFound)
+      return false;
+    eraseBucket(I);
+    return true;
+  }
+  void erase(iterator I) {
+    assert(I != end() && "erasing end()");
+    eraseBucket(&*I - Buckets);
+  }
+
+  value_type &FindAndConstruct(const KeyT &Key) {
+    return *try_emplace(Key).first;
+  }
+
+  ValueT &operator[](const KeyT &Key) { return FindAndConstruct(Key).second; }
+
+  value_type &FindAndConstruct(KeyT &&Key) {
+    return *try_emplace(std::move(Key)).first;
+  }
+
+  ValueT &operator[](KeyT &&Key) {
+    return FindAndConstruct(std::move(Key)).second;
+  }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  /// This is just the raw memory used by SwissMap.
+  /// If entries are pointers to objects, the size of the referenced objects
+  /// are not included.
+  size_t getMemorySize() const {
+    return NumBuckets ? getCtrlSize(NumBuckets) + NumBuckets * sizeof(BucketT)
+                      : 0;
+  }
+
+  unsigned getNumBuckets() const { return NumBuckets; }
+
+private:
+  static constexpr unsigned NotFound = ~0U;
+  static constexpr unsigned MinBuckets = Group::Width < 16 ? 16 : Group::Width;
+
+  static uint64_t getHash(unsigned Hash) {
+    return detail::swiss::mixHash(Hash);
+  }
+  static uint64_t getH1(uint64_t Hash) { return Hash >> 7; }
+  static int8_t getH2(uint64_t Hash) {
+    return static_cast<int8_t>(Hash & 0x7F);
+  }
+
+  static unsigned capacityToGrowth(unsigned NumBuckets) {
+    return NumBuckets - NumBuckets / 8;
+  }
+
+  static unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
+    if (NumEntries == 0)
+      return 0;
+    unsigned N = MinBuckets;
+    while (capacityToGrowth(N) < NumEntries)
+      N *= 2;
+    return N;
+  }
+
+  static size_t getCtrlSize(unsigned NumBuckets) {
+    return alignTo(NumBuckets + Group::Width, alignof(BucketT));
+  }
+
+  /// Set the control byte of bucket I, and its copy past the end.
+  void setCtrl(unsigned I, int8_t C) {
+    Ctrl[I] = C;
+    Ctrl[((I - Group::Width) & (NumBuckets - 1)) + Group::Width] = C;
+  }
+
+  void resetCtrl() {
+    std::memset(Ctrl, static_cast<uint8_t>(detail::swiss::CtrlEmpty),
+                NumBuckets + Group::Width);
+  }
+
+  /// Visits the groups of the probe sequence for Hash until Fn returns true,
+  /// and returns the index of the bucket Fn picked. The groups start at
+  /// triangular offsets, which visits every bucket of a power of two sized
+  /// table.
+  template <typename FnT> unsigned probe(uint64_t Hash, FnT Fn) const {
+    unsigned Mask = NumBuckets - 1;
+    unsigned Pos = getH1(Hash) & Mask;
+    unsigned Step = 0;
+    while (true) {
+      unsigned Lane;
+      if (Fn(Group(Ctrl + Pos), Pos, Lane))
+        return Lane == NotFound ? NotFound : (Pos + Lane) & Mask;
+      Step += Group::Width;
+      Pos = (Pos + Step) & Mask;
+    }
+  }
+
+  template <typename LookupKeyT>
+  unsigned findBucket(const LookupKeyT &Val) const {
+    if (NumEntries == 0)
+      return NotFound;
+    uint64_t Hash = getHash(KeyInfoT::getHashValue(Val));
+    int8_t H2 = getH2(Hash);
+    unsigned Mask = NumBuckets - 1;
+    return probe(Hash, [&](const Group &G, unsigned Pos, unsigned &Lane) {
+      for (auto M = G.match(H2); M; M.clearLowest()) {
+        unsigned I = (Pos + M.lowest()) & Mask;
+        if (KeyInfoT::isEqual(Val, Buckets[I].getFirst())) {
+          Lane = M.lowest();
+          return true;
+        }
+      }
+      // The key would have been placed in the first empty bucket.
+      Lane = NotFound;
+      return static_cast<bool>(G.matchEmpty());
+    });
+  }
+
+  /// Returns the first empty or deleted bucket of the probe sequence.
+  unsigned findFirstNonFull(uint64_t Hash) const {
+    return probe(Hash, [](const Group &G, unsigned, unsigned &Lane) {
+      auto M = G.matchEmptyOrDeleted();
+      if (!M)
+        return false;
+      Lane = M.lowest();
+      return true;
+    });
+  }
+
+  template <typename KeyArg, typename... ValueArgs>
+  std::pair<iterator, bool> tryEmplaceImpl(KeyArg &&Key,
+                                           ValueArgs &&... Values) {
+    unsigned I = findBucket(Key);
+    if (I != NotFound)
+      return std::make_pair(
+          iterator(Buckets + I, Buckets + NumBuckets, Ctrl + I, *this, true),
+          false);
+
+    incrementEpoch();
+    uint64_t Hash = getHash(KeyInfoT::getHashValue(Key));
+    if (NumBuckets == 0)
+      rehash(MinBuckets);
+    I = findFirstNonFull(Hash);
+    // Reusing a deleted bucket never makes a probe sequence longer.
+    if (GrowthLeft == 0 && Ctrl[I] != detail::swiss::CtrlDeleted) {
+      // Drop the deleted buckets if they make up a large part of the table,
+      // otherwise grow it.
+      if (NumEntries < capacityToGrowth(NumBuckets) / 2)
+        rehash(NumBuckets);
+      else
+        rehash(NumBuckets * 2);
+      I = findFirstNonFull(Hash);
+    }
+
+    if (Ctrl[I] == detail::swiss::CtrlEmpty)
+      --GrowthLeft;
+    setCtrl(I, getH2(Hash));
+    ::new (&Buckets[I].getFirst()) KeyT(std::forward<KeyArg>(Key));
+    ::new (&Buckets[I].getSecond()) ValueT(std::forward<ValueArgs>(Values)...);
+    ++NumEntries;
+    return std::make_pair(
+        iterator(Buckets + I, Buckets + NumBuckets, Ctrl + I, *this, true),
+        true);
+  }
+
+  void eraseBucket(unsigned I) {
+    Buckets[I].getSecond().~ValueT();
+    Buckets[I].getFirst().~KeyT();
+    --NumEntries;
+
+    // A probe sequence only continues past a group without empty buckets. If
+    // every group containing this bucket has one either way, no lookup can
+    // have passed this bucket and it can go back to being empty.
+    unsigned Before = (I - Group::Width) & (NumBuckets - 1);
+    auto EmptyAfter = Group(Ctrl + I).matchEmpty();
+    auto EmptyBefore = Group(Ctrl + Before).matchEmpty();
+    bool WasNeverFull =
+        EmptyBefore && EmptyAfter &&
+        EmptyAfter.trailingZeros() + EmptyBefore.leadingZeros() < Group::Width;
+    setCtrl(I, WasNeverFull ? detail::swiss::CtrlEmpty
+                            : detail::swiss::CtrlDeleted);
+    if (WasNeverFull)
+      ++GrowthLeft;
+  }
+
+  void allocate(unsigned Num) {
+    assert(isPowerOf2_32(Num) && Num >= MinBuckets && "Invalid bucket count");
+    size_t CtrlSize = getCtrlSize(Num);
+    char *Mem = static_cast<char *>(
+        operator new(CtrlSize + sizeof(BucketT) * size_t(Num)));
+    Ctrl = reinterpret_cast<int8_t *>(Mem);
+    Buckets = reinterpret_cast<BucketT *>(Mem + CtrlSize);
+    NumBuckets = Num;
+    resetCtrl();
+  }
+
+  void deallocate() {
+    if (Ctrl)
+      operator delete(Ctrl);
+  }
+
+  void destroyAll() {
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (!detail::swiss::isFull(Ctrl[I]))
+        continue;
+      Buckets[I].getSecond().~ValueT();
+      Buckets[I].getFirst().~KeyT();
+    }
+  }
+
+  /// Move all entries into a new table of Num buckets, which also drops the
+  /// deleted buckets.
+  void rehash(unsigned Num) {
+    int8_t *OldCtrl = Ctrl;
+    BucketT *OldBuckets = Buckets;
+    unsigned OldNumBuckets = NumBuckets;
+
+    allocate(Num);
+    GrowthLeft = capacityToGrowth(Num) - NumEntries;
+    for (unsigned I = 0; I != OldNumBuckets; ++I) {
+      if (!detail::swiss::isFull(OldCtrl[I]))
+        continue;
+      BucketT &B = OldBuckets[I];
+      uint64_t Hash = getHash(KeyInfoT::getHashValue(B.getFirst()));
+      unsigned J = findFirstNonFull(Hash);
+      setCtrl(J, getH2(Hash));
+      ::new (&Buckets[J].getFirst()) KeyT(std::move(B.getFirst()));
+      ::new (&Buckets[J].getSecond()) ValueT(std::move(B.getSecond()));
+      B.getSecond().~ValueT();
+      B.getFirst().~KeyT();
+    }
+
+    if (OldCtrl)
+      operator delete(OldCtrl);
+  }
+
+  void copyFrom(const SwissMap &Other) {
+    Ctrl = nullptr;
+    Buckets = nullptr;
+    NumBuckets = NumEntries = GrowthLeft = 0;
+    if (Other.NumBuckets == 0)
+      return;
+
+    allocate(Other.NumBuckets);
+    std::memcpy(Ctrl, Other.Ctrl, NumBuckets + Group::Width);
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (!detail::swiss::isFull(Ctrl[I]))
+        continue;
+      ::new (&Buckets[I].getFirst()) KeyT(Other.Buckets[I].getFirst());
+      ::new (&Buckets[I].getSecond()) ValueT(Other.Buckets[I].getSecond());
+    }
+    NumEntries = Other.NumEntries;
+    GrowthLeft = Other.GrowthLeft;
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename Bucket,
+          bool IsConst>
+class SwissMapIterator : DebugEpochBase::HandleBase {
+  friend class SwissMapIterator<KeyT, ValueT, KeyInfoT, Bucket, true>;
+  friend class SwissMapIterator<KeyT, ValueT, KeyInfoT, Bucket, false>;
+
+  using ConstIterator = SwissMapIterator<KeyT, ValueT, KeyInfoT, Bucket, true>;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type =
+      typename std::conditional<IsConst, const Bucket, Bucket>::type;
+  using pointer = value_type *;
+  using reference = value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+private:
+  pointer Ptr = nullptr;
+  pointer End = nullptr;
+  const int8_t *Ctrl = nullptr;
+
+  void AdvancePastEmptyBuckets() {
+    while (Ptr != End && !detail::swiss::isFull(*Ctrl)) {
+      ++Ptr;
+      ++Ctrl;
+    }
+  }
+
+public:
+  SwissMapIterator() = default;
+
+  SwissMapIterator(pointer Pos, pointer E, const int8_t *C,
+                   const DebugEpochBase &Epoch, bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Ptr(Pos), End(E), Ctrl(C) {
+    assert(isHandleInSync() && "invalid construction!");
+    if (!NoAdvance)
+      AdvancePastEmptyBuckets();
+  }
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined copy
+  // constructor.
+  template <bool IsConstSrc,
+            typename = typename std::enable_if<!IsConstSrc && IsConst>::type>
+  SwissMapIterator(
+      const SwissMapIterator<KeyT, ValueT, KeyInfoT, Bucket, IsConstSrc> &I)
+      : DebugEpochBase::HandleBase(I), Ptr(I.Ptr), End(I.End), Ctrl(I.Ctrl) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    return *Ptr;
+  }
+  pointer operator->() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    return Ptr;
+  }
+
+  bool operator==(const ConstIterator &RHS) const {
+    assert((!Ptr || isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Ptr || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return Ptr == RHS.Ptr;
+  }
+  bool operator!=(const ConstIterator &RHS) const {
+    return !(*this == RHS);
+  }
+
+  inline SwissMapIterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    ++Ptr;
+    ++Ctrl;
+    AdvancePastEmptyBuckets();
+    return *this;
+  }
+  SwissMapIterator operator++(int) { // Postincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    SwissMapIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, typename BucketT>
+inline size_t capacity_in_bytes(
+    const SwissMap<KeyT, ValueT, KeyInfoT, BucketT> &X) {
+  return X.getMemorySize();
+}
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_SWISSMAP_H
@@ -14,6 +14,7 @@
 #ifndef LLVM_CODEGEN_SELECTIONDAGISEL_H
 #define LLVM_CODEGEN_SELECTIONDAGISEL_H
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/SelectionDAG.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
@@ -337,6 +338,10 @@ private:
 
   void CodeGenAndEmitDAG();
 
+  /// Structural hashes of the selection DAGs seen so far, for
+  /// -isel-count-repeated-dags.
+  DenseSet<size_t> SeenDAGHashes;
+
   /// Generate instructions for lowering the incoming arguments of the
   /// given function.
   void LowerArguments(const Function &F);
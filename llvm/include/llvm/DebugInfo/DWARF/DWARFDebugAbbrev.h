@@ -11,6 +11,7 @@
 
 #include "llvm/DebugInfo/DWARF/DWARFAbbreviationDeclaration.h"
 #include "llvm/Support/DataExtractor.h"
+#include <cassert>
 #include <cstdint>
 #include <map>
 #include <vector>
@@ -39,6 +40,19 @@ public:
   const DWARFAbbreviationDeclaration *
   getAbbreviationDeclaration(uint32_t AbbrCode) const;
 
+  /// Returns the declaration at the given position in the set.
+  const DWARFAbbreviationDeclaration *
+  getAbbreviationDeclarationAtIndex(uint32_t Index) const {
+    assert(Index < Decls.size() && "abbreviation index out of range");
+    return &Decls[Index];
+  }
+
+  /// Returns the position of the given declaration of this set.
+  uint32_t getIndex(const DWARFAbbreviationDeclaration *Decl) const {
+    assert(Decl >= Decls.data() && Decl < Decls.data() + Decls.size());
+    return Decl - Decls.data();
+  }
+
   const_iterator begin() const {
     return Decls.begin();
   }
@@ -12,6 +12,7 @@
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/DebugInfo/DWARF/DWARFAbbreviationDeclaration.h"
 #include "llvm/DebugInfo/DWARF/DWARFDataExtractor.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugAbbrev.h"
 #include <cstdint>
 
 namespace llvm {
@@ -20,18 +21,35 @@ class DataExtractor;
 class DWARFUnit;
 
 /// DWARFDebugInfoEntry - A DIE with only the minimum required data.
+///
+/// A fully parsed unit keeps one of these per DIE, so they are packed into
+/// eight bytes. Instead of a pointer to its abbreviation declaration, an entry
+/// stores the index of the declaration in the unit's abbreviation set, which
+/// is resolved only when the declaration is needed.
 class DWARFDebugInfoEntry {
+public:
+  /// The deepest nesting and the largest abbreviation set that can be
+  /// represented. Units that exceed them are treated as malformed.
+  static constexpr uint32_t MaxDepth = (1U << 11) - 1;
+  static constexpr uint32_t MaxAbbrevIndex = (1U << 20) - 2;
+
+private:
   /// Offset within the .debug_info of the start of this entry.
   uint32_t Offset = 0;
 
   /// The integer depth of this DIE within the compile unit DIEs where the
   /// compile/type unit DIE has a depth of zero.
-  uint32_t Depth = 0;
+  uint32_t Depth : 11;
 
-  const DWARFAbbreviationDeclaration *AbbrevDecl = nullptr;
+  /// Cached from the abbreviation declaration for tree walks.
+  uint32_t HasChildren : 1;
+
+  /// One more than the index of the abbreviation declaration in the unit's
+  /// abbreviation set, or zero for a NULL DIE.
+  uint32_t AbbrevIndex : 20;
 
 public:
-  DWARFDebugInfoEntry() = default;
+  DWARFDebugInfoEntry() : Depth(0), HasChildren(0), AbbrevIndex(0) {}
 
   /// Extracts a debug info entry, which is a child of a given unit,
   /// starting at a given offset. If DIE can't be extracted, returns false and
@@ -46,14 +64,18 @@ public:
   uint32_t getOffset() const { return Offset; }
   uint32_t getDepth() const { return Depth; }
 
-  dwarf::Tag getTag() const {
-    return AbbrevDecl ? AbbrevDecl->getTag() : dwarf::DW_TAG_null;
-  }
+  /// Returns true for a DIE that terminates a sibling chain.
+  bool isNULL() const { return AbbrevIndex == 0; }
 
-  bool hasChildren() const { return AbbrevDecl && AbbrevDecl->hasChildren(); }
+  bool hasChildren() const { return HasChildren; }
 
-  const DWARFAbbreviationDeclaration *getAbbreviationDeclarationPtr() const {
-    return AbbrevDecl;
+  /// Returns the abbreviation declaration of this DIE, or null for a NULL
+  /// DIE, given the abbreviation set of the unit that contains it.
+  const DWARFAbbreviationDeclaration *getAbbreviationDeclarationPtr(
+      const DWARFAbbreviationDeclarationSet *Abbrevs) const {
+    if (isNULL())
+      return nullptr;
+    return Abbrevs->getAbbreviationDeclarationAtIndex(AbbrevIndex - 1);
   }
 };
 
@@ -55,10 +55,7 @@ public:
   /// Get the abbreviation declaration for this DIE.
   ///
   /// \returns the abbreviation declaration or NULL for null tags.
-  const DWARFAbbreviationDeclaration *getAbbreviationDeclarationPtr() const {
-    assert(isValid() && "must check validity prior to calling");
-    return Die->getAbbreviationDeclarationPtr();
-  }
+  const DWARFAbbreviationDeclaration *getAbbreviationDeclarationPtr() const;
 
   /// Get the absolute offset into the debug info or types section.
   ///
@@ -81,7 +78,10 @@ public:
   }
 
   /// Returns true for a valid DIE that terminates a sibling chain.
-  bool isNULL() const { return getAbbreviationDeclarationPtr() == nullptr; }
+  bool isNULL() const {
+    assert(isValid() && "must check validity prior to calling");
+    return Die->isNULL();
+  }
 
   /// Returns true if DIE represents a subprogram (not inlined).
   bool isSubprogramDIE() const;
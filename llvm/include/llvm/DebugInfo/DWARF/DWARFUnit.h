@@ -225,10 +225,19 @@ class DWARFUnit {
   /// The compile unit debug information entry items.
   std::vector<DWARFDebugInfoEntry> DieArray;
 
-  /// Map from range's start address to end address and corresponding DIE.
-  /// IntervalMap does not support range removal, as a result, we use the
-  /// std::map::upper_bound for address range lookup.
-  std::map<uint64_t, std::pair<uint64_t, DWARFDie>> AddrDieMap;
+  /// A range of addresses that belong to the innermost subroutine DIE at
+  /// DieIndex in DieArray.
+  struct AddrDieRange {
+    uint64_t LowPC;
+    uint64_t HighPC;
+    uint32_t DieIndex;
+  };
+
+  /// The disjoint address ranges of the unit's subroutines, sorted by
+  /// address. This is built from the DIE tree on the first address lookup
+  /// and searched with a binary search afterwards.
+  std::vector<AddrDieRange> AddrDieIndex;
+  bool AddrDieIndexBuilt = false;
 
   using die_iterator_range =
       iterator_range<std::vector<DWARFDebugInfoEntry>::iterator>;
@@ -300,8 +309,13 @@ public:
     AddrOffsetSectionBase = Base;
   }
 
+  /// Map from range's start address to end address and corresponding DIE.
+  /// IntervalMap does not support range removal, as a result, we use the
+  /// std::map::upper_bound for address range lookup.
+  using AddrDieMapTy = std::map<uint64_t, std::pair<uint64_t, DWARFDie>>;
+
   /// Recursively update address to Die map.
-  void updateAddressDieMap(DWARFDie Die);
+  void updateAddressDieMap(DWARFDie Die, AddrDieMapTy &AddrDieMap);
 
   void setRangesSection(const DWARFSection *RS, uint32_t Base) {
     RangeSection = RS;
@@ -495,6 +509,11 @@ public:
   }
 
   virtual void dump(raw_ostream &OS, DIDumpOptions DumpOpts) = 0;
+
+  /// clearDIEs - Clear parsed DIEs to keep memory usage low. They are parsed
+  /// again if needed.
+  void clearDIEs(bool KeepCUDie);
+
 private:
   /// Size in bytes of the .debug_info data associated with this compile unit.
   size_t getDebugInfoSize() const {
@@ -509,9 +528,6 @@ private:
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
 
-  /// clearDIEs - Clear parsed DIEs to keep memory usage low.
-  void clearDIEs(bool KeepCUDie);
-
   /// parseDWO - Parses .dwo file for current compile unit. Returns true if
   /// it was actually constructed.
   bool parseDWO();
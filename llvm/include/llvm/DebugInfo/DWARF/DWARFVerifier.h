@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <map>
+#include <mutex>
 #include <set>
 
 namespace llvm {
@@ -99,6 +100,11 @@ private:
   // Used to relax some checks that do not currently work portably
   bool IsObjectFile;
   bool IsMachOObject;
+  /// Serializes the dumping of DIEs while units are verified in parallel, as
+  /// it lazily parses shared parts of the context such as line tables.
+  std::mutex *DumpMutex = nullptr;
+
+  std::unique_lock<std::mutex> lockDump() const;
 
   raw_ostream &error() const;
   raw_ostream &warn() const;
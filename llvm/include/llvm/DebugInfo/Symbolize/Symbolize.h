@@ -13,12 +13,17 @@
 #ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 #define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/ilist_node.h"
+#include "llvm/ADT/simple_ilist.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -32,6 +37,31 @@ using namespace object;
 
 using FunctionNameKind = DILineInfoSpecifier::FunctionNameKind;
 
+/// A binary opened by the symbolizer, along with the cache entries that
+/// depend on it and must be dropped when it is closed.
+class CachedBinary : public ilist_node<CachedBinary> {
+public:
+  CachedBinary() = default;
+  CachedBinary(OwningBinary<Binary> Bin) : Bin(std::move(Bin)) {}
+
+  OwningBinary<Binary> &operator*() { return Bin; }
+  OwningBinary<Binary> *operator->() { return &Bin; }
+
+  /// Registers an action to run when the binary is evicted. Actions run in
+  /// the reverse of the order in which they were added.
+  void pushEvictor(std::function<void()> Evictor);
+
+  /// Runs the registered evictors, which destroy this object.
+  void evict();
+
+  /// The size of the binary's contents, used to bound the cache.
+  size_t size() const;
+
+private:
+  OwningBinary<Binary> Bin;
+  std::function<void()> Evictor;
+};
+
 class LLVMSymbolizer {
 public:
   struct Options {
@@ -43,6 +73,8 @@ public:
     std::vector<std::string> DsymHints;
     std::string FallbackDebugPath;
     std::string DWPName;
+    /// The total size of the binaries that pruneCache() keeps open.
+    uint64_t MaxCacheSize = std::numeric_limits<uint64_t>::max();
   };
 
   LLVMSymbolizer() = default;
@@ -66,6 +98,11 @@ public:
                  object::SectionedAddress ModuleOffset);
   void flush();
 
+  /// Closes the least recently used binaries, and drops the modules that use
+  /// them, until the binaries that remain open fit in Options::MaxCacheSize.
+  /// The most recently used binary is always kept.
+  void pruneCache();
+
   static std::string
   DemangleName(const std::string &Name,
                const SymbolizableModule *DbiModuleDescriptor);
@@ -108,14 +145,28 @@ private:
   Expected<ObjectFile *> getOrCreateObject(const std::string &Path,
                                           const std::string &ArchName);
 
+  /// Marks the binary as the most recently used one.
+  void recordAccess(CachedBinary &Bin);
+
+  /// Marks the binaries that a module was created from as recently used.
+  void recordModuleAccess(const std::string &ModuleName);
+
   std::map<std::string, std::unique_ptr<SymbolizableModule>> Modules;
 
+  /// The binaries that each module in Modules was created from.
+  std::map<std::string, SmallVector<CachedBinary *, 2>> ModuleBinaries;
+
   /// Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
       ObjectPairForPathArch;
 
   /// Contains parsed binary for each path, or parsing error.
-  std::map<std::string, OwningBinary<Binary>> BinaryForPath;
+  std::map<std::string, CachedBinary> BinaryForPath;
+
+  /// The binaries in BinaryForPath that are open, from the least to the most
+  /// recently used, and the sum of their sizes.
+  simple_ilist<CachedBinary> LRUBinaries;
+  uint64_t CacheSize = 0;
 
   /// Parsed object file for path/architecture pair, where "path" refers
   /// to Mach-O universal binary.
@@ -46,6 +46,10 @@ std::string demangle(const std::string &MangledName);
 /// "Partial" demangler. This supports demangling a string into an AST
 /// (typically an intermediate stage in itaniumDemangle) and querying certain
 /// properties or partially printing the demangled name.
+///
+/// A demangler can be reused for any number of names. Doing so, and passing
+/// the buffer returned by the printing functions back in, avoids allocating a
+/// parser and an output buffer for every name.
 struct ItaniumPartialDemangler {
   ItaniumPartialDemangler();
 
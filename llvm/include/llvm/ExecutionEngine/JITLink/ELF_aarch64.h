@@ -0,0 +1,59 @@
+//===--- ELF_aarch64.h - JIT link functions for ELF/AArch64 -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// jit-link functions for ELF/AArch64.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_JITLINK_ELF_AARCH64_H
+#define LLVM_EXECUTIONENGINE_JITLINK_ELF_AARCH64_H
+
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+
+namespace llvm {
+namespace jitlink {
+
+namespace ELF_aarch64_Edges {
+
+/// ELF/AArch64 edge kinds. PC-relative kinds compute Target + Addend -
+/// FixupAddress, and the page kinds use 4Kb pages, as the relocations they
+/// are built from do.
+enum ELFAArch64RelocationKind : Edge::Kind {
+  Branch26 = Edge::FirstRelocation,
+  Pointer64,
+  Pointer32,
+  PCRel32,
+  Delta64,
+  NegDelta32,
+  Page21,
+  PageOffset12,
+  GOTPage21,
+  GOTPageOffset12,
+};
+
+} // namespace ELF_aarch64_Edges
+
+/// jit-link the given object buffer, which must be an ELF AArch64
+/// (little-endian) relocatable object file.
+///
+/// If PrePrunePasses is empty then a default mark-live pass will be inserted
+/// that will mark all exported atoms live. If PrePrunePasses is not empty, the
+/// caller is responsible for including a pass to mark atoms as live.
+///
+/// If PostPrunePasses is empty then a default GOT-and-stubs insertion pass will
+/// be inserted. If PostPrunePasses is not empty then the caller is responsible
+/// for including a pass to insert GOT and stub edges.
+void jitLink_ELF_aarch64(std::unique_ptr<JITLinkContext> Ctx);
+
+/// Return the string name of the given ELF AArch64 edge kind.
+StringRef getELFAArch64RelocationKindName(Edge::Kind R);
+
+} // end namespace jitlink
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_JITLINK_ELF_AARCH64_H
@@ -0,0 +1,65 @@
+//===---- ELF_x86_64.h - JIT link functions for ELF/x86-64 ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// jit-link functions for ELF/x86-64.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_JITLINK_ELF_X86_64_H
+#define LLVM_EXECUTIONENGINE_JITLINK_ELF_X86_64_H
+
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+
+namespace llvm {
+namespace jitlink {
+
+namespace ELF_x86_64_Edges {
+
+/// ELF/x86-64 edge kinds. Unlike the MachO kinds, all PC-relative kinds
+/// compute Target + Addend - FixupAddress, as ELF relocations do: The addend
+/// already accounts for the distance from the fixup to the end of the
+/// instruction.
+enum ELFX86RelocationKind : Edge::Kind {
+  Branch32 = Edge::FirstRelocation,
+  Branch32ToStub,
+  Pointer64,
+  Pointer32,
+  Pointer32Signed,
+  PCRel32,
+  PCRel32GOT,
+  PCRel32GOTLoad,
+  PCRel32GOTLoadRelaxable,
+  Delta64,
+  NegDelta32,
+};
+
+} // namespace ELF_x86_64_Edges
+
+/// jit-link the given object buffer, which must be an ELF x86-64 relocatable
+/// object file.
+///
+/// If PrePrunePasses is empty then a default mark-live pass will be inserted
+/// that will mark all exported atoms live. If PrePrunePasses is not empty, the
+/// caller is responsible for including a pass to mark atoms as live.
+///
+/// If PostPrunePasses is empty then a default GOT-and-stubs insertion pass will
+/// be inserted. If PostPrunePasses is not empty then the caller is responsible
+/// for including a pass to insert GOT and stub edges.
+///
+/// GOT loads through R_X86_64_GOTPCRELX and R_X86_64_REX_GOTPCRELX relocations,
+/// and calls through stubs, are relaxed to direct references when fixing up
+/// if the final target is within range.
+void jitLink_ELF_x86_64(std::unique_ptr<JITLinkContext> Ctx);
+
+/// Return the string name of the given ELF x86-64 edge kind.
+StringRef getELFX86RelocationKindName(Edge::Kind R);
+
+} // end namespace jitlink
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_JITLINK_ELF_X86_64_H
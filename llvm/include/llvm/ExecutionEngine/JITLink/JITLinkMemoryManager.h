@@ -18,6 +18,9 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Memory.h"
 #include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace llvm {
 namespace jitlink {
@@ -93,6 +96,52 @@ public:
   allocate(const SegmentsRequestMap &Request) override;
 };
 
+/// A JITLinkMemoryManager that allocates in-process memory from large slabs.
+///
+/// Each segment protection has its own pool of slabs, and segments are
+/// carved from the lowest free address in their pool, so that the code of
+/// many small allocations is packed into a few slabs rather than spread over
+/// one mapping per allocation. Deallocated segments are returned to their
+/// pool and reused. Segments still occupy whole pages, so that they can be
+/// protected independently, and segments larger than a slab get a mapping of
+/// their own.
+///
+/// If UseHugePages is true, slabs are requested with MF_HUGE_HINT. Pages of a
+/// slab whose protections differ are mapped separately, so a slab will
+/// typically be backed by huge pages again once it is full and all of its
+/// segments have been finalized.
+///
+/// The manager must outlive all allocations made from it.
+class InProcessSlabMemoryManager : public JITLinkMemoryManager {
+public:
+  InProcessSlabMemoryManager(uint64_t SlabSize = 16 * 1024 * 1024,
+                             bool UseHugePages = false);
+  ~InProcessSlabMemoryManager() override;
+
+  Expected<std::unique_ptr<Allocation>>
+  allocate(const SegmentsRequestMap &Request) override;
+
+private:
+  class SlabAllocation;
+
+  struct Pool {
+    std::vector<sys::MemoryBlock> Slabs;
+
+    // Free page ranges, by start address.
+    std::map<char *, uint64_t> FreeRanges;
+  };
+
+  Expected<sys::MemoryBlock> allocateSegment(unsigned Prot, uint64_t Size);
+  Error releaseSegment(unsigned Prot, sys::MemoryBlock Block);
+
+  uint64_t SlabSize;
+  bool UseHugePages;
+
+  std::mutex PoolsMutex;
+  DenseMap<unsigned, Pool> Pools;
+  sys::MemoryBlock LastSlab;
+};
+
 } // end namespace jitlink
 } // end namespace llvm
 
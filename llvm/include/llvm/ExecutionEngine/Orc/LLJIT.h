@@ -20,6 +20,7 @@
 #include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/Speculation.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/Support/ThreadPool.h"
 
@@ -152,6 +153,9 @@ class LLLazyJIT : public LLJIT {
 
 public:
 
+  /// Waits for any speculative compiles to finish.
+  ~LLLazyJIT();
+
   /// Set an IR transform (e.g. pass manager pipeline) to run on each function
   /// when it is compiled.
   void setLazyCompileTransform(IRTransformLayer::TransformFunction Transform) {
@@ -172,13 +176,19 @@ public:
     return addLazyIRModule(Main, std::move(M));
   }
 
+  /// Returns the Speculator, or null if speculative compilation was not
+  /// enabled.
+  Speculator *getSpeculator() { return Spec.get(); }
+
 private:
 
   // Create a single-threaded LLLazyJIT instance.
   LLLazyJIT(LLLazyJITBuilderState &S, Error &Err);
 
+  std::unique_ptr<Speculator> Spec;
   std::unique_ptr<LazyCallThroughManager> LCTMgr;
   std::unique_ptr<IRTransformLayer> TransformLayer;
+  std::unique_ptr<IRSpeculationLayer> SpeculationLayer;
   std::unique_ptr<CompileOnDemandLayer> CODLayer;
 };
 
@@ -286,6 +296,7 @@ public:
   JITTargetAddress LazyCompileFailureAddr = 0;
   std::unique_ptr<LazyCallThroughManager> LCTMgr;
   IndirectStubsManagerBuilderFunction ISMBuilder;
+  bool SpeculativeCompilation = false;
 
   Error prepareForConstruction();
 };
@@ -321,6 +332,16 @@ public:
     this->impl().ISMBuilder = std::move(ISMBuilder);
     return this->impl();
   }
+
+  /// Enable speculative compilation.
+  ///
+  /// If enabled, the functions that each lazily compiled function is likely
+  /// to call are compiled on the compile threads ahead of their first call.
+  /// This requires a non-zero number of compile threads.
+  SetterImpl &setSpeculativeCompilation(bool SpeculativeCompilation) {
+    this->impl().SpeculativeCompilation = SpeculativeCompilation;
+    return this->impl();
+  }
 };
 
 /// Constructs LLLazyJIT instances.
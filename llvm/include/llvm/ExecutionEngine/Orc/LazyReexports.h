@@ -74,12 +74,23 @@ public:
         std::move(NotifyResolved));
   }
 
+  /// Called with the target of a call-through before the target is looked
+  /// up, e.g. to record that it is being called.
+  using NotifyCallThroughFunction = std::function<void(
+      JITDylib &SourceJD, const SymbolStringPtr &SymbolName)>;
+
   // Return a free call-through trampoline and bind it to look up and call
   // through to the given symbol.
   Expected<JITTargetAddress> getCallThroughTrampoline(
       JITDylib &SourceJD, SymbolStringPtr SymbolName,
       std::shared_ptr<NotifyResolvedFunction> NotifyResolved);
 
+  /// Set the function to call on each call-through. This must be done before
+  /// any trampoline is used.
+  void setNotifyCallThrough(NotifyCallThroughFunction NotifyCallThrough) {
+    this->NotifyCallThrough = std::move(NotifyCallThrough);
+  }
+
 protected:
   LazyCallThroughManager(ExecutionSession &ES,
                          JITTargetAddress ErrorHandlerAddr,
@@ -104,6 +115,7 @@ private:
   std::unique_ptr<TrampolinePool> TP;
   ReexportsMap Reexports;
   NotifiersMap Notifiers;
+  NotifyCallThroughFunction NotifyCallThrough;
 };
 
 /// A lazy call-through manager that builds trampolines in the current process.
@@ -0,0 +1,122 @@
+//===- Speculation.h - Speculative compilation of callees -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Contains a Speculator and an IRSpeculationLayer that compile the functions a
+// lazily compiled function is likely to call before they are called, so that
+// the calling thread doesn't stall on their compilation when it gets to them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_SPECULATION_H
+#define LLVM_EXECUTIONENGINE_ORC_SPECULATION_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include <mutex>
+
+namespace llvm {
+
+class Function;
+class raw_ostream;
+
+namespace orc {
+
+/// Issues lookups for the likely callees of functions as the functions are
+/// compiled, which starts the compilation of the callees ahead of their first
+/// call.
+///
+/// The lookups are asynchronous, so the callees are compiled wherever the
+/// ExecutionSession dispatches materialization. This is only useful if it
+/// dispatches to a pool of compile threads, as LLJIT does when it is given a
+/// non-zero number of them.
+///
+/// The speculator also counts how many lazily compiled functions were already
+/// speculated when they were first called, if it is told about first calls
+/// through recordCall, e.g. from LazyCallThroughManager::setNotifyCallThrough.
+class Speculator {
+public:
+  struct Statistics {
+    /// The number of functions looked up speculatively.
+    uint64_t Speculated = 0;
+
+    /// The number of first calls to functions that had been speculated.
+    uint64_t Hits = 0;
+
+    /// The number of first calls to functions that had not been speculated.
+    uint64_t Misses = 0;
+  };
+
+  /// Create a Speculator. Callees are only speculated for functions that were
+  /// called, or that were speculated less than MaxDepth levels away from a
+  /// called function.
+  Speculator(ExecutionSession &ES, unsigned MaxDepth = 2)
+      : ES(ES), MaxDepth(MaxDepth) {}
+
+  /// Speculatively look up Callees, which are likely to be called by Caller,
+  /// in JD. Callees that are not defined in JD, or that have been called or
+  /// speculated already, are skipped.
+  void speculateCallees(JITDylib &JD, const SymbolStringPtr &Caller,
+                        SymbolNameSet Callees);
+
+  /// Record that Name, defined in JD, is about to be called for the first
+  /// time.
+  void recordCall(JITDylib &JD, const SymbolStringPtr &Name);
+
+  /// Returns the counts of speculated functions and of first calls.
+  Statistics getStatistics() const;
+
+  /// Prints the statistics, including the hit rate.
+  void printStatistics(raw_ostream &OS) const;
+
+private:
+  struct DylibState {
+    // The symbols that have been called or speculated. Called symbols have
+    // depth 0, and a speculated symbol is one deeper than its caller.
+    DenseMap<SymbolStringPtr, unsigned> Depths;
+
+    // The symbols that have been called.
+    SymbolNameSet Called;
+  };
+
+  ExecutionSession &ES;
+  unsigned MaxDepth;
+
+  mutable std::mutex SpeculatorMutex;
+  DenseMap<JITDylib *, DylibState> Dylibs;
+  Statistics Stats;
+};
+
+/// An IR layer that tells a Speculator which functions each function it emits
+/// is likely to call, and then passes the module on to the base layer.
+///
+/// A callee is likely to be called if it is directly called from a block whose
+/// estimated frequency is at least MinLikelihood times the frequency of the
+/// function's entry block. Placed under a CompileOnDemandLayer, this layer sees
+/// each function when it is about to be compiled for its first call.
+class IRSpeculationLayer : public IRLayer {
+public:
+  IRSpeculationLayer(ExecutionSession &ES, IRLayer &BaseLayer, Speculator &S,
+                     double MinLikelihood = 0.5)
+      : IRLayer(ES), BaseLayer(BaseLayer), S(S), MinLikelihood(MinLikelihood) {
+  }
+
+  void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
+
+private:
+  SymbolNameSet getLikelyCallees(Function &F, MangleAndInterner &Mangle);
+
+  IRLayer &BaseLayer;
+  Speculator &S;
+  double MinLikelihood;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_SPECULATION_H
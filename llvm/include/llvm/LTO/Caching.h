@@ -15,6 +15,7 @@
 #define LLVM_LTO_CACHING_H
 
 #include "llvm/LTO/LTO.h"
+#include <memory>
 #include <string>
 
 namespace llvm {
@@ -33,6 +34,36 @@ using AddBufferFn =
 Expected<NativeObjectCache> localCache(StringRef CacheDirectoryPath,
                                        AddBufferFn AddBuffer);
 
+/// A cache of native objects that is shared between machines, such as a
+/// content-addressable store on a build farm. Implementations must be thread
+/// safe. Errors are not fatal: a failed fetch is handled as a miss, and the
+/// object is built locally.
+class RemoteCache {
+public:
+  virtual ~RemoteCache() = default;
+
+  /// Returns the object for \p Key, or null if the cache does not have it.
+  virtual Expected<std::unique_ptr<MemoryBuffer>> fetch(StringRef Key) = 0;
+
+  /// Adds \p Object to the cache as the object for \p Key.
+  virtual Error publish(StringRef Key, MemoryBufferRef Object) = 0;
+};
+
+/// Create a remote cache that runs \p Program to access the objects.
+/// "Program get <key> <file>" must write the object for the key to the file
+/// and exit with 0, or exit with a nonzero code if it does not have it.
+/// "Program put <key> <file>" publishes the object in the file. This lets the
+/// objects be stored, for example, over HTTP by a script around curl.
+Expected<std::unique_ptr<RemoteCache>> commandRemoteCache(StringRef Program);
+
+/// Create a cache that looks up objects in the local cache directory and, if
+/// they are not there, in \p Remote. Objects fetched from \p Remote are added
+/// to the local cache, and objects that are built are added to both.
+Expected<NativeObjectCache>
+localCacheWithRemote(StringRef CacheDirectoryPath,
+                     std::shared_ptr<RemoteCache> Remote,
+                     AddBufferFn AddBuffer);
+
 } // namespace lto
 } // namespace llvm
 
@@ -117,6 +117,11 @@ struct Config {
   /// Statistics output file path.
   std::string StatsFile;
 
+  /// Do not free the regular LTO module and the modules split from it after
+  /// code generation. Tearing down a large module can take seconds, which is
+  /// wasted if the process exits soon after, as linkers usually do.
+  bool DisableFree = false;
+
   bool ShouldDiscardValueNames = true;
   DiagnosticHandlerFunction DiagHandler;
 
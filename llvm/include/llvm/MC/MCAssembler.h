@@ -140,6 +140,7 @@ private:
   bool RelaxAll : 1;
   bool SubsectionsViaSymbols : 1;
   bool IncrementalLinkerCompatible : 1;
+  bool ParallelLayout : 1;
 
   /// ELF specific e_header flags
   // It would be good if there were an MCELFAssembler class to hold this.
@@ -183,8 +184,14 @@ private:
                                const MCAsmLayout &Layout) const;
 
   /// Perform one layout iteration and return true if any offsets
-  /// were adjusted.
-  bool layoutOnce(MCAsmLayout &Layout);
+  /// were adjusted. The IndependentSections are relaxed concurrently.
+  bool layoutOnce(MCAsmLayout &Layout,
+                  ArrayRef<MCSection *> IndependentSections);
+
+  /// Check whether relaxing the given section only reads the layout of the
+  /// section itself, so that it can be relaxed concurrently with other such
+  /// sections.
+  bool isLayoutIndependent(const MCSection &Sec) const;
 
   /// Perform one layout iteration of the given section and return true
   /// if any offsets were adjusted.
@@ -209,6 +216,11 @@ private:
   std::tuple<MCValue, uint64_t, bool>
   handleFixup(const MCAsmLayout &Layout, MCFragment &F, const MCFixup &Fixup);
 
+  /// Inform the object writer of the relocation for an unresolved fixup.
+  void recordFixupRelocation(const MCAsmLayout &Layout, MCFragment &F,
+                             const MCFixup &Fixup, MCValue Target,
+                             uint64_t &FixedValue);
+
 public:
   std::vector<std::pair<StringRef, const MCSymbol *>> Symvers;
 
@@ -320,6 +332,11 @@ public:
   bool getRelaxAll() const { return RelaxAll; }
   void setRelaxAll(bool Value) { RelaxAll = Value; }
 
+  /// Whether layout relaxes independent sections, and evaluates fixups, on
+  /// multiple threads. The resulting object file is the same either way.
+  bool getParallelLayout() const { return ParallelLayout; }
+  void setParallelLayout(bool Value) { ParallelLayout = Value; }
+
   bool isBundlingEnabled() const { return BundleAlignSize != 0; }
 
   unsigned getBundleAlignSize() const { return BundleAlignSize; }
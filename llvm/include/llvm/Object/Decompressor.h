@@ -12,6 +12,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Compression.h"
 
 namespace llvm {
 namespace object {
@@ -58,6 +59,9 @@ private:
 
   StringRef SectionData;
   uint64_t DecompressedSize;
+  /// The algorithm the section data was compressed with. GNU style sections
+  /// are always zlib compressed.
+  compression::Format Type = compression::Format::Zlib;
 };
 
 } // end namespace object
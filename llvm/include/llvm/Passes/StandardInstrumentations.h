@@ -15,16 +15,20 @@
 #ifndef LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 #define LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/PassInstrumentation.h"
 #include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Support/Timer.h"
 
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace llvm {
 
 class Module;
+class raw_ostream;
 
 /// Instrumentation to print IR before/after passes.
 ///
@@ -53,11 +57,71 @@ private:
   bool StoreModuleDesc = false;
 };
 
+/// Instrumentation to record statistics of every pass run (-pass-stats-json).
+///
+/// For each run of a pass on an IR unit it records the execution time and the
+/// change in the instruction count of that unit and in heap usage, and writes
+/// the records out as JSON. Independently of that, each pass run is reported
+/// as a time-trace event when the time-trace profiler is enabled.
+class PassStatsInstrumentation {
+  /// The statistics of a single run of a pass.
+  struct PassRunRecord {
+    std::string PassID;
+    std::string IRName;
+    TimeRecord Time;
+    unsigned InstructionsBefore;
+    /// None if the pass invalidated the IR unit it ran on.
+    Optional<unsigned> InstructionsAfter;
+  };
+
+  /// A pass run that has started but not finished yet.
+  struct ActivePassRun {
+    StringRef PassID;
+    std::string IRName;
+    TimeRecord Start;
+    unsigned InstructionsBefore;
+    bool TimeTraced;
+  };
+
+  SmallVector<ActivePassRun, 4> ActiveRuns;
+  std::vector<PassRunRecord> Records;
+
+  /// Custom output stream to write the records into. By default (== nullptr)
+  /// they are written into the file named by -pass-stats-json.
+  raw_ostream *OutStream = nullptr;
+
+  bool Enabled;
+
+public:
+  /// Records pass statistics if -pass-stats-json was specified.
+  PassStatsInstrumentation();
+  explicit PassStatsInstrumentation(bool Enabled) : Enabled(Enabled) {}
+
+  /// Destructor writes out the records if it has not been done before.
+  ~PassStatsInstrumentation() { print(); }
+
+  PassStatsInstrumentation(const PassStatsInstrumentation &) = delete;
+  void operator=(const PassStatsInstrumentation &) = delete;
+
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+
+  /// Writes out the records collected so far as JSON and then clears them.
+  void print();
+
+  /// Set a custom output stream for subsequent reporting.
+  void setOutStream(raw_ostream &OS) { OutStream = &OS; }
+
+private:
+  bool runBeforePass(StringRef PassID, Any IR);
+  void runAfterPass(StringRef PassID, Optional<Any> IR);
+};
+
 /// This class provides an interface to register all the standard pass
 /// instrumentations and manages their state (if any).
 class StandardInstrumentations {
   PrintIRInstrumentation PrintIR;
   TimePassesHandler TimePasses;
+  PassStatsInstrumentation PassStats;
 
 public:
   StandardInstrumentations() = default;
@@ -65,6 +129,7 @@ public:
   void registerCallbacks(PassInstrumentationCallbacks &PIC);
 
   TimePassesHandler &getTimePasses() { return TimePasses; }
+  PassStatsInstrumentation &getPassStats() { return PassStats; }
 };
 } // namespace llvm
 
@@ -0,0 +1,63 @@
+//===-- BitstreamRemarkContainer.h - Bitstream remark layout ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the layout of the bitstream remark format, shared by the
+// serializer and the parser.
+//
+// A bitstream remark file starts with the magic number followed by a block
+// info block holding the abbreviations used by the remark blocks, and a meta
+// block holding the version of the format. Each remark is then emitted as a
+// self-contained remark block. Strings are defined through string records the
+// first time they are used and are later referenced by their index, in the
+// order of definition.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BITSTREAM_REMARK_CONTAINER_H
+#define LLVM_REMARKS_BITSTREAM_REMARK_CONTAINER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Bitstream/BitCodes.h"
+#include <cstdint>
+
+namespace llvm {
+namespace remarks {
+
+/// The magic number identifying a bitstream remark file.
+constexpr StringRef BitstreamMagic("RMRK", 4);
+
+/// The current version of the bitstream remark format.
+constexpr uint64_t CurrentBitstreamRemarkVersion = 0;
+
+/// The block IDs used in a bitstream remark file.
+enum BlockIDs {
+  /// Holds the version of the format.
+  META_BLOCK_ID = bitc::FIRST_APPLICATION_BLOCKID,
+  /// Holds one remark and the strings it introduces.
+  REMARK_BLOCK_ID
+};
+
+/// The records in the meta block.
+enum MetaRecordIDs {
+  RECORD_META_VERSION = 1 // [version]
+};
+
+/// The records in a remark block.
+enum RemarkRecordIDs {
+  RECORD_REMARK_STRING = 1,   // [] blob
+  RECORD_REMARK_HEADER,       // [type, pass, name, function]
+  RECORD_REMARK_LOCATION,     // [file, line, column]
+  RECORD_REMARK_HOTNESS,      // [hotness]
+  RECORD_REMARK_ARG,          // [key, value]
+  RECORD_REMARK_ARG_WITH_LOC, // [key, value, file, line, column]
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif /* LLVM_REMARKS_BITSTREAM_REMARK_CONTAINER_H */
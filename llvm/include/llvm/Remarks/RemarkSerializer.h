@@ -13,6 +13,8 @@
 #ifndef LLVM_REMARKS_REMARK_SERIALIZER_H
 #define LLVM_REMARKS_REMARK_SERIALIZER_H
 
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitstream/BitstreamWriter.h"
 #include "llvm/Remarks/Remark.h"
 #include "llvm/Remarks/RemarkStringTable.h"
 #include "llvm/Support/YAMLTraits.h"
@@ -62,6 +64,44 @@ struct YAMLSerializer : public Serializer {
   void emit(const Remark &Remark) override;
 };
 
+/// Serialize the remarks to a compact bitstream. Each remark is emitted as a
+/// self-contained block and flushed to the stream right away, so the output
+/// can be consumed while it is being produced.
+/// The strings are uniqued through a string table: a string is only emitted
+/// the first time it is used, and is referenced by its ID afterwards. Unlike
+/// YAMLSerializer, the table is part of the stream itself, so StrTab is left
+/// empty and nothing needs to be serialized separately.
+struct BitstreamSerializer : public Serializer {
+  /// Buffer used to encode the bitstream before it is flushed to OS.
+  SmallVector<char, 1024> Encoded;
+  /// The bitstream writer, writing to Encoded.
+  BitstreamWriter Bitstream;
+  /// The strings that have already been emitted to the stream.
+  StringTable Strings;
+
+  BitstreamSerializer(raw_ostream &OS);
+
+  /// Emit a remark to the stream.
+  void emit(const Remark &Remark) override;
+
+private:
+  /// Abbreviations used for the records of the remark blocks.
+  unsigned StringAbbrevID = 0;
+  unsigned HeaderAbbrevID = 0;
+  unsigned LocationAbbrevID = 0;
+  unsigned HotnessAbbrevID = 0;
+  unsigned ArgAbbrevID = 0;
+  unsigned ArgWithLocAbbrevID = 0;
+
+  /// Emit the magic number, the block info block and the meta block.
+  void emitPreamble();
+  /// Return the ID of \p Str, emitting a string record if it's the first time
+  /// the string is used.
+  unsigned useString(StringRef Str);
+  /// Write the encoded bitstream to OS.
+  void flush();
+};
+
 } // end namespace remarks
 } // end namespace llvm
 
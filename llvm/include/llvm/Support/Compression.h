@@ -41,8 +41,74 @@ Error uncompress(StringRef InputBuffer,
 
 uint32_t crc32(StringRef Buffer);
 
+/// Compresses \p InputBuffer into a raw deflate stream (one with no zlib
+/// header or trailer). Unless \p Last is true the stream is flushed to a
+/// byte boundary instead of being finished, so that the results for
+/// consecutive pieces of a buffer, compressed independently, can be
+/// concatenated into a single deflate stream.
+Error compressRaw(StringRef InputBuffer,
+                  SmallVectorImpl<char> &CompressedBuffer, bool Last,
+                  int Level = DefaultCompression);
+
+uint32_t adler32(StringRef Buffer);
+
+/// Returns the Adler-32 checksum of the concatenation of two buffers from
+/// their checksums \p Adler1 and \p Adler2 and the size \p Len2 of the
+/// second buffer.
+uint32_t adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Len2);
+
 }  // End of namespace zlib
 
+namespace zstd {
+
+static constexpr int BestSpeedCompression = 1;
+static constexpr int DefaultCompression = 5;
+static constexpr int BestSizeCompression = 12;
+
+bool isAvailable();
+
+/// Compresses \p InputBuffer into a single zstd frame. Large inputs are
+/// compressed by several threads when the zstd library was built with
+/// multithreading support; the output does not depend on the number of
+/// threads used.
+Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
+               int Level = DefaultCompression);
+
+Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+}  // End of namespace zstd
+
+namespace compression {
+
+/// The compression algorithms supported by LLVM.
+enum class Format { Zlib, Zstd };
+
+/// Returns the name of \p F, as used in diagnostics.
+StringRef getName(Format F);
+
+/// Returns nullptr if \p F is available in this build, and a reason why it is
+/// not otherwise.
+const char *getReasonIfUnsupported(Format F);
+
+inline bool isAvailable(Format F) { return !getReasonIfUnsupported(F); }
+
+/// Compresses \p InputBuffer with \p F at its default compression level.
+Error compress(Format F, StringRef InputBuffer,
+               SmallVectorImpl<char> &CompressedBuffer);
+
+/// Uncompresses \p InputBuffer, which was compressed with \p F, into a buffer
+/// of \p UncompressedSize bytes.
+Error uncompress(Format F, StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+}  // End of namespace compression
+
 } // End of namespace llvm
 
 #endif
@@ -0,0 +1,106 @@
+//===- ConcurrentStringPool.h - Thread-safe string interning ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares ConcurrentStringPool, a string interning table that can
+// be used from many threads at once without a global lock.
+//
+// To intern a string:
+//
+//   ConcurrentStringPool Pool;
+//   StringRef Str = Pool.intern("wakka wakka");
+//
+// Interning equal strings yields the same StringRef, so interned strings can
+// be compared by their data pointer. The strings live as long as the pool.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_CONCURRENTSTRINGPOOL_H
+#define LLVM_SUPPORT_CONCURRENTSTRINGPOOL_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/Allocator.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+/// ConcurrentStringPool - A thread-safe interned string pool.
+///
+/// The pool is split into shards by the hash of the strings, each with its
+/// own hash table, allocator and lock. Looking up a string that is already
+/// in the pool takes no lock at all: Tables are only ever replaced by larger
+/// copies, which are published atomically, and the old ones are kept until
+/// the pool is destroyed. Adding a string only locks the shard it goes to,
+/// so threads interning different strings rarely wait for each other.
+///
+/// Compared to UniqueStringSaver, it can be shared between threads without
+/// external locking. Compared to StringPool, it doesn't support
+/// refcounting/deletion.
+class ConcurrentStringPool {
+  struct Entry {
+    size_t Length;
+    uint32_t Hash;
+
+    StringRef getKey() const {
+      return StringRef(reinterpret_cast<const char *>(this + 1), Length);
+    }
+  };
+
+  struct Table {
+    explicit Table(unsigned NumBuckets);
+
+    unsigned Mask;
+    std::unique_ptr<std::atomic<const Entry *>[]> Buckets;
+  };
+
+  struct Shard {
+    std::atomic<Table *> Current{nullptr};
+    std::atomic<size_t> NumEntries{0};
+    std::mutex Mutex;
+    BumpPtrAllocator Alloc;
+    /// All tables of the shard, including the current one.
+    std::vector<std::unique_ptr<Table>> Tables;
+  };
+
+  static constexpr unsigned NumShards = 64;
+
+  std::unique_ptr<Shard[]> Shards;
+
+  static const Entry *find(const Table *T, StringRef S, uint64_t Hash);
+  static void insert(Table &T, const Entry *E);
+
+public:
+  ConcurrentStringPool();
+  ~ConcurrentStringPool();
+
+  ConcurrentStringPool(const ConcurrentStringPool &) = delete;
+  ConcurrentStringPool &operator=(const ConcurrentStringPool &) = delete;
+
+  /// Returns the pool's copy of S, adding it if it is not in the pool yet.
+  /// This may be called from several threads at once.
+  // All returned strings are null-terminated: *intern(S).end() == 0.
+  StringRef intern(StringRef S);
+  StringRef intern(const char *S) { return intern(StringRef(S)); }
+  StringRef intern(const Twine &S) { return intern(StringRef(S.str())); }
+  StringRef intern(const std::string &S) { return intern(StringRef(S)); }
+
+  /// Returns the pool's copy of S, or a null StringRef if S was never
+  /// interned.
+  StringRef lookup(StringRef S) const;
+
+  /// Returns the number of distinct strings in the pool.
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_CONCURRENTSTRINGPOOL_H
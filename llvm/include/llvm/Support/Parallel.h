@@ -9,14 +9,18 @@
 #ifndef LLVM_SUPPORT_PARALLEL_H
 #define LLVM_SUPPORT_PARALLEL_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/MathExtras.h"
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #if defined(_MSC_VER) && LLVM_ENABLE_THREADS
 #pragma warning(push)
@@ -59,10 +63,18 @@ public:
     ++Count;
   }
 
-  void dec() {
+  /// Returns true if the count dropped to zero.
+  bool dec() {
     std::lock_guard<std::mutex> lock(Mutex);
-    if (--Count == 0)
-      Cond.notify_all();
+    if (--Count != 0)
+      return false;
+    Cond.notify_all();
+    return true;
+  }
+
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
   }
 
   void sync() const {
@@ -81,7 +93,8 @@ public:
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  /// Waits for all spawned tasks, running other tasks in the meantime.
+  void sync() const;
 };
 
 #if defined(_MSC_VER)
@@ -244,6 +257,48 @@ void for_each_n(parallel_execution_policy policy, IndexTy Begin, IndexTy End,
 }
 #endif
 
+/// A set of tasks with dependencies between them. A task starts once all of
+/// its predecessors have finished, so that the phases of a pipeline can
+/// overlap, e.g. the symbols of one file can be resolved while the next file
+/// is being parsed. Predecessors must be added before their successors, which
+/// makes the insertion order a valid sequential order.
+class TaskGraph {
+public:
+  using TaskId = unsigned;
+
+  /// Adds a task that runs \p F after the tasks in \p Preds have finished.
+  TaskId add(std::function<void()> F, ArrayRef<TaskId> Preds = None);
+
+  /// Makes the tasks that have not started yet do nothing. May be called from
+  /// a running task.
+  void cancel() { Cancelled = true; }
+  bool isCancelled() const { return Cancelled; }
+
+  /// Runs all tasks and waits for them to finish.
+  template <class Policy> void run(Policy policy) {
+    static_assert(is_execution_policy<Policy>::value,
+                  "Invalid execution policy!");
+    runSequential();
+  }
+#if LLVM_ENABLE_THREADS
+  void run(parallel_execution_policy policy) { runParallel(); }
+#endif
+
+private:
+  struct Node {
+    std::function<void()> F;
+    std::vector<TaskId> Succs;
+    unsigned NumPreds = 0;
+    std::atomic<unsigned> PendingPreds{0};
+  };
+
+  void runSequential();
+  void runParallel();
+
+  std::vector<std::unique_ptr<Node>> Nodes;
+  std::atomic<bool> Cancelled{false};
+};
+
 } // namespace parallel
 } // namespace llvm
 
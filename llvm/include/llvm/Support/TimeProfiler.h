@@ -9,22 +9,43 @@
 #ifndef LLVM_SUPPORT_TIME_PROFILER_H
 #define LLVM_SUPPORT_TIME_PROFILER_H
 
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
 
 struct TimeTraceProfiler;
-extern TimeTraceProfiler *TimeTraceProfilerInstance;
+extern LLVM_THREAD_LOCAL TimeTraceProfiler *TimeTraceProfilerInstance;
 
 /// Initialize the time trace profiler.
-/// This sets up the global \p TimeTraceProfilerInstance
-/// variable to be the profiler instance.
-void timeTraceProfilerInitialize();
+/// This sets up the thread-local \p TimeTraceProfilerInstance
+/// variable to be the profiler instance of the calling thread. Each thread
+/// that should record events must call this; worker threads must call
+/// \p timeTraceProfilerFinishThread once they are done. \p ProcName names
+/// the process in the written profile.
+void timeTraceProfilerInitialize(StringRef ProcName = "clang");
 
 /// Cleanup the time trace profiler, if it was initialized.
+/// This deletes the calling thread's profiler instance along with the
+/// instances of all finished worker threads. Must be called from the thread
+/// that writes the profile.
 void timeTraceProfilerCleanup();
 
-/// Is the time trace profiler enabled, i.e. initialized?
+/// Finish the time trace profiler of a worker thread. Its events are kept and
+/// merged into the profile written by \p timeTraceProfilerWrite, and tracing
+/// is disabled on the calling thread.
+void timeTraceProfilerFinishThread();
+
+/// Start recording the events of the calling thread if a profile is being
+/// recorded on another thread and this thread has no profiler yet. Unlike
+/// \p timeTraceProfilerInitialize, the thread does not need to finish: its
+/// events are written with the others until \p timeTraceProfilerCleanup.
+/// This is for the threads of a pool, which run tasks for whoever records
+/// the profile and never exit; they call this before each task.
+void timeTraceProfilerAttachThread();
+
+/// Is the time trace profiler enabled, i.e. initialized on the calling
+/// thread?
 inline bool timeTraceProfilerEnabled() {
   return TimeTraceProfilerInstance != nullptr;
 }
@@ -32,6 +53,8 @@ inline bool timeTraceProfilerEnabled() {
 /// Write profiling data to output file.
 /// Data produced is JSON, in Chrome "Trace Event" format, see
 /// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+/// The events of the calling thread and of all finished worker threads are
+/// written, each with the id of the thread that recorded it.
 void timeTraceProfilerWrite(raw_pwrite_stream &OS);
 
 /// Manually begin a time section, with the given \p Name and \p Detail.
@@ -57,6 +80,10 @@ struct TimeTraceScope {
   TimeTraceScope(TimeTraceScope &&) = delete;
   TimeTraceScope &operator=(TimeTraceScope &&) = delete;
 
+  TimeTraceScope(StringRef Name) {
+    if (TimeTraceProfilerInstance != nullptr)
+      timeTraceProfilerBegin(Name, StringRef(""));
+  }
   TimeTraceScope(StringRef Name, StringRef Detail) {
     if (TimeTraceProfilerInstance != nullptr)
       timeTraceProfilerBegin(Name, Detail);
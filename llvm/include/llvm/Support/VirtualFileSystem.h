@@ -18,6 +18,7 @@
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Chrono.h"
@@ -589,25 +590,43 @@ public:
 
   class RedirectingDirectoryEntry : public Entry {
     std::vector<std::unique_ptr<Entry>> Contents;
+    /// Contents indexed by their lowercased name, so that finding a child is a
+    /// hash lookup rather than a scan of the whole directory. The index is
+    /// only used while no two children have the same name ignoring case.
+    StringMap<Entry *> ContentsIndex;
+    bool HasUniqueContentNames = true;
     Status S;
 
+    void addToIndex(Entry *Content);
+
   public:
     RedirectingDirectoryEntry(StringRef Name,
                               std::vector<std::unique_ptr<Entry>> Contents,
                               Status S)
         : Entry(EK_Directory, Name), Contents(std::move(Contents)),
-          S(std::move(S)) {}
+          S(std::move(S)) {
+      for (const std::unique_ptr<Entry> &Content : this->Contents)
+        addToIndex(Content.get());
+    }
     RedirectingDirectoryEntry(StringRef Name, Status S)
         : Entry(EK_Directory, Name), S(std::move(S)) {}
 
     Status getStatus() { return S; }
 
     void addContent(std::unique_ptr<Entry> Content) {
+      addToIndex(Content.get());
       Contents.push_back(std::move(Content));
     }
 
     Entry *getLastContent() const { return Contents.back().get(); }
 
+    /// Whether lookupContent() can be used instead of visiting each child.
+    bool hasUniqueContentNames() const { return HasUniqueContentNames; }
+
+    /// Returns the child named \p Name, or nullptr if there is none. Requires
+    /// hasUniqueContentNames().
+    Entry *lookupContent(StringRef Name, bool CaseSensitive) const;
+
     using iterator = decltype(Contents)::iterator;
 
     iterator contents_begin() { return Contents.begin(); }
@@ -13,6 +13,8 @@
 #ifndef LLVM_TABLEGEN_MAIN_H
 #define LLVM_TABLEGEN_MAIN_H
 
+#include "llvm/ADT/ArrayRef.h"
+
 namespace llvm {
 
 class raw_ostream;
@@ -22,7 +24,11 @@ class RecordKeeper;
 /// Returns true on error, false otherwise.
 using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
-int TableGenMain(char *argv0, TableGenMainFn *MainFn);
+/// Parse the input file and run MainFn on its records. Args is the command
+/// line the tool was invoked with, which keys the output cache of -cache-dir;
+/// without it, the output is not cached.
+int TableGenMain(char *argv0, TableGenMainFn *MainFn,
+                 ArrayRef<const char *> Args = None);
 
 } // end namespace llvm
 
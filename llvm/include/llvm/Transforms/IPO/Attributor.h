@@ -287,7 +287,8 @@ private:
   ///}
 
   /// A map from abstract attributes to the ones that queried them through calls
-  /// to the getAAFor<...>(...) method.
+  /// to the getAAFor<...>(...) method. The entries of an attribute are dropped
+  /// when the attributes depending on it are scheduled for an update.
   ///{
   using QueryMapTy =
       DenseMap<AbstractAttribute *, SetVector<AbstractAttribute *>>;
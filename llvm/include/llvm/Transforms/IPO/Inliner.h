@@ -9,6 +9,7 @@
 #ifndef LLVM_TRANSFORMS_IPO_INLINER_H
 #define LLVM_TRANSFORMS_IPO_INLINER_H
 
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/InlineCost.h"
@@ -16,6 +17,7 @@
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Transforms/Utils/ImportedFunctionsInliningStatistics.h"
+#include <string>
 #include <utility>
 
 namespace llvm {
@@ -24,6 +26,37 @@ class AssumptionCacheTracker;
 class CallGraph;
 class ProfileSummaryInfo;
 
+/// Tracks how much inlining grows a module, in instructions. It enforces
+/// -inline-module-growth-budget, and with -inline-growth-report, prints the
+/// inlined callees ranked by the growth they caused.
+class InlineGrowthTracker {
+public:
+  /// Records the size of \p M before inlining, the first time it is called.
+  void setModuleInfo(Module &M);
+
+  /// Returns true if inlining a callee of \p Size instructions stays within
+  /// the budget.
+  bool isWithinBudget(unsigned Size) const;
+
+  /// Records that \p Callee, of \p Size instructions, was inlined.
+  void recordInline(const Function &Callee, unsigned Size);
+
+  /// Prints the inlined callees if -inline-growth-report is set.
+  void dump() const;
+
+private:
+  struct CalleeGrowth {
+    unsigned NumInlines = 0;
+    uint64_t Growth = 0;
+  };
+
+  bool HasModule = false;
+  std::string ModuleName;
+  uint64_t ModuleSize = 0;
+  uint64_t Growth = 0;
+  StringMap<CalleeGrowth> Callees;
+};
+
 /// This class contains all of the helper code which is used to perform the
 /// inlining operations that do not depend on the policy. It contains the core
 /// bottom-up inlining infrastructure that specific inliner passes use.
@@ -75,6 +108,7 @@ protected:
   AssumptionCacheTracker *ACT;
   ProfileSummaryInfo *PSI;
   ImportedFunctionsInliningStatistics ImportedFunctionsStats;
+  InlineGrowthTracker GrowthTracker;
 };
 
 /// The inliner pass for the new pass manager.
@@ -98,7 +132,8 @@ public:
   ~InlinerPass();
   InlinerPass(InlinerPass &&Arg)
       : Params(std::move(Arg.Params)),
-        ImportedFunctionsStats(std::move(Arg.ImportedFunctionsStats)) {}
+        ImportedFunctionsStats(std::move(Arg.ImportedFunctionsStats)),
+        GrowthTracker(std::move(Arg.GrowthTracker)) {}
 
   PreservedAnalyses run(LazyCallGraph::SCC &C, CGSCCAnalysisManager &AM,
                         LazyCallGraph &CG, CGSCCUpdateResult &UR);
@@ -106,6 +141,7 @@ public:
 private:
   InlineParams Params;
   std::unique_ptr<ImportedFunctionsInliningStatistics> ImportedFunctionsStats;
+  InlineGrowthTracker GrowthTracker;
 };
 
 } // end namespace llvm
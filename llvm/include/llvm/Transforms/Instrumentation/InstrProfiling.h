@@ -67,6 +67,9 @@ private:
   // vector of counter load/store pairs to be register promoted.
   std::vector<LoadStorePair> PromotionCandidates;
 
+  // The first and last instructions of each counter update to be sampled.
+  std::vector<std::pair<Instruction *, Instruction *>> SampledUpdates;
+
   // The start value of precise value profile range for memory intrinsic sizes.
   int64_t MemOPSizeRangeStart;
   // The end value of precise value profile range for memory intrinsic sizes.
@@ -84,6 +87,16 @@ private:
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
+  /// Returns true if the counter updates are sampled.
+  bool isSamplingEnabled() const;
+
+  /// Get the thread-local sampling state, creating it if necessary.
+  GlobalVariable *getOrCreateSamplingVar();
+
+  /// Make the counter updates of the current function conditional on the
+  /// thread being in a sampling burst.
+  void sampleCounterUpdates();
+
   /// Count the number of instrumented value sites for the function.
   void computeNumValueSiteCounts(InstrProfValueProfileInst *Ins);
 
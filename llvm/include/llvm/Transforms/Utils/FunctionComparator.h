@@ -69,7 +69,11 @@ public:
   GlobalNumberState() = default;
 
   uint64_t getNumber(GlobalValue* Global) {
-    ValueNumberMap::iterator MapIter;
+    // Look the global up first: inserting creates a callback value handle for
+    // the key even if the global has already been numbered.
+    ValueNumberMap::iterator MapIter = GlobalNumbers.find(Global);
+    if (MapIter != GlobalNumbers.end())
+      return MapIter->second;
     bool Inserted;
     std::tie(MapIter, Inserted) = GlobalNumbers.insert({Global, NextNumber});
     if (Inserted)
@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
@@ -74,6 +75,32 @@ Expected<Trace> loadTraceFile(StringRef Filename, bool Sort = false);
 /// DataExtractor.
 Expected<Trace> loadTrace(const DataExtractor &Extractor, bool Sort = false);
 
+/// The callback through which streamTrace() hands out records. |Worker| is the
+/// index of the worker that reads the record, which is below the number of
+/// threads given to streamTrace().
+using TraceRecordCallback =
+    function_ref<Error(unsigned Worker, const XRayRecord &Record)>;
+
+/// This function calls |Callback| with each of the XRay trace records in the
+/// provided |Filename|, without loading them all into memory when the trace is
+/// in FDR mode format. |Header| is set before the first call.
+Error streamTraceFile(StringRef Filename, XRayFileHeader &Header,
+                      TraceRecordCallback Callback, unsigned Threads = 1);
+
+/// This function calls |Callback| with each of the XRay trace records in the
+/// provided DataExtractor. Each worker gets its records in the order that
+/// loadTrace() returns them without sorting.
+///
+/// An FDR mode trace is read twice: first to find the blocks of each thread,
+/// and then to expand the blocks of one thread at a time, so that only one
+/// block's records are in memory at once for each worker. The threads of the
+/// trace are divided among |Threads| workers that run in parallel, so
+/// |Callback| may be called concurrently, but never for the same worker, and
+/// all records of a thread are read by the same worker. Other trace formats
+/// are loaded whole and read by worker 0.
+Error streamTrace(const DataExtractor &Extractor, XRayFileHeader &Header,
+                  TraceRecordCallback Callback, unsigned Threads = 1);
+
 } // namespace xray
 } // namespace llvm
 
@@ -5195,6 +5195,13 @@ SyncScope::ID BitcodeReader::getDecodedSyncScopeID(unsigned Val) {
 //===----------------------------------------------------------------------===//
 
 Error BitcodeReader::materialize(GlobalValue *GV) {
+  // The attachments of global variables and function declarations are loaded
+  // on demand when importing.
+  if (auto *GO = dyn_cast<GlobalObject>(GV))
+    if (isa<GlobalVariable>(GO) || GO->isDeclaration())
+      if (Error Err = MDLoader->parseGlobalAttachments(*GO))
+        return Err;
+
   Function *F = dyn_cast<Function>(GV);
   // If it's not a function or is already material, ignore the request.
   if (!F || !F->isMaterializable())
@@ -5263,6 +5270,8 @@ Error BitcodeReader::materialize(GlobalValue *GV) {
 Error BitcodeReader::materializeModule() {
   if (Error Err = materializeMetadata())
     return Err;
+  if (Error Err = MDLoader->parseAllGlobalAttachments())
+    return Err;
 
   // Promise to materialize all forward references.
   WillMaterializeAllForwardRefs = true;
@@ -5614,8 +5623,15 @@ std::vector<FunctionSummary::EdgeTy>
 ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
                                               bool IsOldProfileFormat,
                                               bool HasProfile, bool HasRelBF) {
+  // Each edge takes one field per piece of profile information that it holds,
+  // and the list is kept for the whole thin link, so reserve it exactly.
+  unsigned FieldsPerEdge = 1;
+  if (IsOldProfileFormat)
+    FieldsPerEdge += HasProfile ? 2 : 1;
+  else if (HasProfile || HasRelBF)
+    FieldsPerEdge += 1;
   std::vector<FunctionSummary::EdgeTy> Ret;
-  Ret.reserve(Record.size());
+  Ret.reserve(Record.size() / FieldsPerEdge);
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     uint64_t RelBF = 0;
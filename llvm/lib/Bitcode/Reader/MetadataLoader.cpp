@@ -469,6 +469,10 @@ class MetadataLoader::MetadataLoaderImpl {
   /// True if metadata is being parsed for a module being ThinLTO imported.
   bool IsImporting = false;
 
+  /// Attachment records of global variables and function declarations, which
+  /// are parsed on demand when lazy-loading.
+  DenseMap<GlobalObject *, SmallVector<uint64_t, 4>> DeferredGlobalAttachments;
+
   Error parseOneMetadata(SmallVectorImpl<uint64_t> &Record, unsigned Code,
                          PlaceholderQueue &Placeholders, StringRef Blob,
                          unsigned &NextMetadataNo);
@@ -510,18 +514,22 @@ class MetadataLoader::MetadataLoaderImpl {
       }
 
     // Upgrade variables attached to globals.
-    for (auto &GV : TheModule.globals()) {
-      SmallVector<MDNode *, 1> MDs;
-      GV.getMetadata(LLVMContext::MD_dbg, MDs);
-      GV.eraseMetadata(LLVMContext::MD_dbg);
-      for (auto *MD : MDs)
-        if (auto *DGV = dyn_cast_or_null<DIGlobalVariable>(MD)) {
-          auto *DGVE = DIGlobalVariableExpression::getDistinct(
-              Context, DGV, DIExpression::get(Context, {}));
-          GV.addMetadata(LLVMContext::MD_dbg, *DGVE);
-        } else
-          GV.addMetadata(LLVMContext::MD_dbg, *MD);
-    }
+    for (auto &GV : TheModule.globals())
+      upgradeGlobalVariableAttachments(GV);
+  }
+
+  /// Upgrade old-style bare DIGlobalVariables attached to \p GV.
+  void upgradeGlobalVariableAttachments(GlobalVariable &GV) {
+    SmallVector<MDNode *, 1> MDs;
+    GV.getMetadata(LLVMContext::MD_dbg, MDs);
+    GV.eraseMetadata(LLVMContext::MD_dbg);
+    for (auto *MD : MDs)
+      if (auto *DGV = dyn_cast_or_null<DIGlobalVariable>(MD)) {
+        auto *DGVE = DIGlobalVariableExpression::getDistinct(
+            Context, DGV, DIExpression::get(Context, {}));
+        GV.addMetadata(LLVMContext::MD_dbg, *DGVE);
+      } else
+        GV.addMetadata(LLVMContext::MD_dbg, *MD);
   }
 
   /// Remove a leading DW_OP_deref from DIExpressions in a dbg.declare that
@@ -670,6 +678,9 @@ public:
   Error parseMetadataAttachment(
       Function &F, const SmallVectorImpl<Instruction *> &InstructionList);
 
+  Error parseGlobalAttachments(GlobalObject &GO);
+  Error parseAllGlobalAttachments();
+
   Error parseMetadataKinds();
 
   void setStripTBAA(bool Value) { StripTBAA = Value; }
@@ -835,10 +846,12 @@ MetadataLoader::MetadataLoaderImpl::lazyLoadModuleMetadataBlock() {
         unsigned ValueID = Record[0];
         if (ValueID >= ValueList.size())
           return error("Invalid record");
+        // Parsing the attachments of all the globals would load most of the
+        // debug info of the module, while only a few globals are imported.
+        // They are parsed when the global is materialized instead.
         if (auto *GO = dyn_cast<GlobalObject>(ValueList[ValueID]))
-          if (Error Err = parseGlobalObjectAttachment(
-                  *GO, ArrayRef<uint64_t>(Record).slice(1)))
-            return std::move(Err);
+          DeferredGlobalAttachments[GO].append(std::next(Record.begin()),
+                                               Record.end());
         break;
       }
       case bitc::METADATA_KIND:
@@ -2063,6 +2076,34 @@ Error MetadataLoader::MetadataLoaderImpl::parseMetadataAttachment(
   }
 }
 
+/// Parse the attachments of a global variable or function declaration that
+/// were skipped by lazyLoadModuleMetadataBlock().
+Error MetadataLoader::MetadataLoaderImpl::parseGlobalAttachments(
+    GlobalObject &GO) {
+  auto I = DeferredGlobalAttachments.find(&GO);
+  if (I == DeferredGlobalAttachments.end())
+    return Error::success();
+  SmallVector<uint64_t, 4> Record = std::move(I->second);
+  DeferredGlobalAttachments.erase(I);
+
+  PlaceholderQueue Placeholders;
+  if (Error Err = parseGlobalObjectAttachment(GO, Record))
+    return Err;
+  resolveForwardRefsAndPlaceholders(Placeholders);
+  if (NeedUpgradeToDIGlobalVariableExpression)
+    if (auto *GV = dyn_cast<GlobalVariable>(&GO))
+      upgradeGlobalVariableAttachments(*GV);
+  return Error::success();
+}
+
+Error MetadataLoader::MetadataLoaderImpl::parseAllGlobalAttachments() {
+  while (!DeferredGlobalAttachments.empty())
+    if (Error Err =
+            parseGlobalAttachments(*DeferredGlobalAttachments.begin()->first))
+      return Err;
+  return Error::success();
+}
+
 /// Parse a single METADATA_KIND record, inserting result in MDKindMap.
 Error MetadataLoader::MetadataLoaderImpl::parseMetadataKindRecord(
     SmallVectorImpl<uint64_t> &Record) {
@@ -2157,6 +2198,14 @@ Error MetadataLoader::parseMetadataAttachment(
   return Pimpl->parseMetadataAttachment(F, InstructionList);
 }
 
+Error MetadataLoader::parseGlobalAttachments(GlobalObject &GO) {
+  return Pimpl->parseGlobalAttachments(GO);
+}
+
+Error MetadataLoader::parseAllGlobalAttachments() {
+  return Pimpl->parseAllGlobalAttachments();
+}
+
 Error MetadataLoader::parseMetadataKinds() {
   return Pimpl->parseMetadataKinds();
 }
@@ -25,6 +25,7 @@ class BitstreamCursor;
 class DISubprogram;
 class Error;
 class Function;
+class GlobalObject;
 class Instruction;
 class Metadata;
 class MDNode;
@@ -71,6 +72,13 @@ public:
   Error parseMetadataAttachment(
       Function &F, const SmallVectorImpl<Instruction *> &InstructionList);
 
+  /// Parse the attachments of a global variable or function declaration,
+  /// which are deferred when lazy-loading the module's metadata.
+  Error parseGlobalAttachments(GlobalObject &GO);
+
+  /// Parse the attachments of all the globals that have not been parsed yet.
+  Error parseAllGlobalAttachments();
+
   /// Parse a `METADATA_KIND` block for the current module.
   Error parseMetadataKinds();
 
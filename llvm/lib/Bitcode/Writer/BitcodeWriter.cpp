@@ -4258,6 +4258,9 @@ void ModuleBitcodeWriter::write() {
 
   // Emit function bodies.
   DenseMap<const Function *, uint64_t> FunctionToBitcodeIndex;
+  // Size the offset map up front so modules with many bodies don't rehash it
+  // repeatedly while the function blocks are streamed out.
+  FunctionToBitcodeIndex.reserve(M.size());
   for (Module::const_iterator F = M.begin(), E = M.end(); F != E; ++F)
     if (!F->isDeclaration())
       writeFunction(*F, FunctionToBitcodeIndex);
@@ -9,6 +9,7 @@
 #include "llvm/Bitstream/BitstreamReader.h"
 #include "llvm/ADT/StringRef.h"
 #include <cassert>
+#include <climits>
 #include <string>
 
 using namespace llvm;
@@ -88,6 +89,32 @@ static Expected<uint64_t> readAbbreviatedField(BitstreamCursor &Cursor,
   llvm_unreachable("invalid abbreviation encoding");
 }
 
+/// Read an array of \p NumElts fixed-width or char6 elements into \p Vals.
+///
+/// The whole array is bounds-checked once up front, so the elements can be
+/// read without checking for the end of the stream each time, and \p Vals
+/// only grows once.
+static Error readFixedArray(BitstreamCursor &Cursor, unsigned NumElts,
+                            unsigned EltWidth, bool IsChar6,
+                            SmallVectorImpl<uint64_t> &Vals) {
+  assert(EltWidth && EltWidth <= Cursor.MaxChunkSize);
+  uint64_t EndBit = Cursor.GetCurrentBitNo() + uint64_t(NumElts) * EltWidth;
+  if (!Cursor.canSkipToPos((EndBit + CHAR_BIT - 1) / CHAR_BIT))
+    return createStringError(std::errc::illegal_byte_sequence,
+                             "Array of %u elements extends past the end of "
+                             "the stream",
+                             NumElts);
+
+  size_t Start = Vals.size();
+  Vals.resize(Start + NumElts);
+  uint64_t *Out = Vals.data() + Start;
+  for (unsigned i = 0; i != NumElts; ++i) {
+    uint64_t Val = cantFail(Cursor.Read(EltWidth));
+    Out[i] = IsChar6 ? BitCodeAbbrevOp::DecodeChar6(Val) : Val;
+  }
+  return Error::success();
+}
+
 static Error skipAbbreviatedField(BitstreamCursor &Cursor,
                                   const BitCodeAbbrevOp &Op) {
   assert(!Op.isLiteral() && "Not to be used with literals!");
@@ -255,6 +282,10 @@ Expected<unsigned> BitstreamCursor::readRecord(unsigned AbbrevID,
 
   const BitCodeAbbrev *Abbv = getAbbrev(AbbrevID);
 
+  // Every operand but the record code produces at least one value, so grow
+  // Vals once for the scalar operands.
+  Vals.reserve(Vals.size() + Abbv->getNumOperandInfos() - 1);
+
   // Read the record code first.
   assert(Abbv->getNumOperandInfos() != 0 && "no record code in abbreviation?");
   const BitCodeAbbrevOp &CodeOp = Abbv->getOperandInfo(0);
@@ -307,12 +338,10 @@ Expected<unsigned> BitstreamCursor::readRecord(unsigned AbbrevID,
       default:
         report_fatal_error("Array element type can't be an Array or a Blob");
       case BitCodeAbbrevOp::Fixed:
-        for (; NumElts; --NumElts)
-          if (Expected<SimpleBitstreamCursor::word_t> MaybeVal =
-                  Read((unsigned)EltEnc.getEncodingData()))
-            Vals.push_back(MaybeVal.get());
-          else
-            return MaybeVal.takeError();
+        if (Error Err = readFixedArray(*this, NumElts,
+                                       (unsigned)EltEnc.getEncodingData(),
+                                       /*IsChar6=*/false, Vals))
+          return std::move(Err);
         break;
       case BitCodeAbbrevOp::VBR:
         for (; NumElts; --NumElts)
@@ -323,11 +352,10 @@ Expected<unsigned> BitstreamCursor::readRecord(unsigned AbbrevID,
             return MaybeVal.takeError();
         break;
       case BitCodeAbbrevOp::Char6:
-        for (; NumElts; --NumElts)
-          if (Expected<SimpleBitstreamCursor::word_t> MaybeVal = Read(6))
-            Vals.push_back(BitCodeAbbrevOp::DecodeChar6(MaybeVal.get()));
-          else
-            return MaybeVal.takeError();
+        if (Error Err =
+                readFixedArray(*this, NumElts, 6, /*IsChar6=*/true, Vals))
+          return std::move(Err);
+        break;
       }
       continue;
     }
@@ -364,8 +392,8 @@ Expected<unsigned> BitstreamCursor::readRecord(unsigned AbbrevID,
       *Blob = StringRef(Ptr, NumElts);
     } else {
       // Otherwise, unpack into Vals with zero extension.
-      for (; NumElts; --NumElts)
-        Vals.push_back((unsigned char)*Ptr++);
+      const unsigned char *UPtr = (const unsigned char *)Ptr;
+      Vals.append(UPtr, UPtr + NumElts);
     }
   }
 
@@ -84,6 +84,8 @@ using namespace outliner;
 
 STATISTIC(NumOutlined, "Number of candidates outlined");
 STATISTIC(FunctionsCreated, "Number of functions created");
+STATISTIC(NumOutliningRounds, "Number of outlining rounds run");
+STATISTIC(NumBytesSaved, "Estimated number of bytes saved by outlining");
 
 // Set to true if the user wants the outliner to run on linkonceodr linkage
 // functions. This is false by default because the linker can dedupe linkonceodr
@@ -96,6 +98,15 @@ static cl::opt<bool> EnableLinkOnceODROutlining(
     cl::desc("Enable the machine outliner on linkonceodr functions"),
     cl::init(false));
 
+// Set the number of times to repeat outlining after the first round. Outlined
+// functions may themselves contain repeated sequences, and outlining can
+// expose new ones in the functions it was applied to. Each round rebuilds the
+// suffix tree, so this bounds the compile time spent in the outliner.
+static cl::opt<unsigned> OutlinerReruns(
+    "machine-outliner-reruns", cl::init(0), cl::Hidden,
+    cl::desc(
+        "Number of times to rerun the outliner after the initial outline"));
+
 namespace {
 
 /// Represents an undefined index in the suffix tree.
@@ -837,6 +848,9 @@ struct MachineOutliner : public ModulePass {
   /// linkonceodr linkage.
   bool OutlineFromLinkOnceODRs = false;
 
+  /// The current repeat number of machine outlining.
+  unsigned OutlineRepeatedNum = 0;
+
   /// Set to true if the outliner should run on all functions in the module
   /// considered safe for outlining.
   /// Set to true by default for compatibility with llc's -run-pass option.
@@ -887,8 +901,10 @@ struct MachineOutliner : public ModulePass {
   /// \param M The module we are outlining from.
   /// \param FunctionList A list of functions to be inserted into the module.
   /// \param Mapper Contains the instruction mappings for the module.
+  /// \param[in,out] OutlinedFunctionNum The number to use for the name of the
+  /// next outlined function.
   bool outline(Module &M, std::vector<OutlinedFunction> &FunctionList,
-               InstructionMapper &Mapper);
+               InstructionMapper &Mapper, unsigned &OutlinedFunctionNum);
 
   /// Creates a function for \p OF and inserts it into the module.
   MachineFunction *createOutlinedFunction(Module &M, OutlinedFunction &OF,
@@ -899,6 +915,11 @@ struct MachineOutliner : public ModulePass {
   /// strings from that tree.
   bool runOnModule(Module &M) override;
 
+  /// Run a single round of outlining on \p M: map its instructions, find the
+  /// beneficial candidates and outline them. Return true if anything was
+  /// outlined.
+  bool doOutline(Module &M, unsigned &OutlinedFunctionNum);
+
   /// Return a DISubprogram for OF if one exists, and null otherwise. Helper
   /// function for remark emission.
   DISubprogram *getSubprogramOrNull(const OutlinedFunction &OF) {
@@ -1016,6 +1037,10 @@ MachineOutliner::findCandidates(InstructionMapper &Mapper,
     CandidatesForRepeatedSeq.clear();
     SuffixTree::RepeatedSubstring RS = *It;
     unsigned StringLen = RS.Length;
+
+    // Visit the occurrences in program order, so that a new candidate can only
+    // overlap with the last one we kept.
+    llvm::sort(RS.StartIndices);
     for (const unsigned &StartIdx : RS.StartIndices) {
       unsigned EndIdx = StartIdx + StringLen - 1;
       // Trick: Discard some candidates that would be incompatible with the
@@ -1039,11 +1064,11 @@ MachineOutliner::findCandidates(InstructionMapper &Mapper,
       // That is, one must either
       // * End before the other starts
       // * Start after the other ends
-      if (std::all_of(
-              CandidatesForRepeatedSeq.begin(), CandidatesForRepeatedSeq.end(),
-              [&StartIdx, &EndIdx](const Candidate &C) {
-                return (EndIdx < C.getStartIdx() || StartIdx > C.getEndIdx());
-              })) {
+      //
+      // The candidates are found in order of their start index, so it's
+      // enough to check that this one starts after the last one ends.
+      if (CandidatesForRepeatedSeq.empty() ||
+          StartIdx > CandidatesForRepeatedSeq.back().getEndIdx()) {
         // It doesn't overlap with anything, so we can outline it.
         // Each sequence is over [StartIt, EndIt].
         // Save the candidate and its location.
@@ -1095,7 +1120,10 @@ MachineOutliner::createOutlinedFunction(Module &M, OutlinedFunction &OF,
   // Create the function name. This should be unique.
   // FIXME: We should have a better naming scheme. This should be stable,
   // regardless of changes to the outliner's cost model/traversal order.
-  std::string FunctionName = ("OUTLINED_FUNCTION_" + Twine(Name)).str();
+  std::string FunctionName = "OUTLINED_FUNCTION_";
+  if (OutlineRepeatedNum > 0)
+    FunctionName += std::to_string(OutlineRepeatedNum + 1) + "_";
+  FunctionName += std::to_string(Name);
 
   // Create the function using an IR-level function.
   LLVMContext &C = M.getContext();
@@ -1190,12 +1218,13 @@ MachineOutliner::createOutlinedFunction(Module &M, OutlinedFunction &OF,
 
 bool MachineOutliner::outline(Module &M,
                               std::vector<OutlinedFunction> &FunctionList,
-                              InstructionMapper &Mapper) {
+                              InstructionMapper &Mapper,
+                              unsigned &OutlinedFunctionNum) {
 
   bool OutlinedSomething = false;
 
-  // Number to append to the current outlined function.
-  unsigned OutlinedFunctionNum = 0;
+  // Estimated number of bytes saved in this round.
+  unsigned BytesSaved = 0;
 
   // Sort by benefit. The most beneficial functions should be outlined first.
   llvm::stable_sort(FunctionList, [](const OutlinedFunction &LHS,
@@ -1224,6 +1253,7 @@ bool MachineOutliner::outline(Module &M,
     OF.MF = createOutlinedFunction(M, OF, Mapper, OutlinedFunctionNum);
     emitOutlinedFunctionRemark(OF);
     FunctionsCreated++;
+    BytesSaved += OF.getBenefit();
     OutlinedFunctionNum++; // Created a function, move to the next name.
     MachineFunction *MF = OF.MF;
     const TargetSubtargetInfo &STI = MF->getSubtarget();
@@ -1287,7 +1317,10 @@ bool MachineOutliner::outline(Module &M,
     }
   }
 
+  NumBytesSaved += BytesSaved;
   LLVM_DEBUG(dbgs() << "OutlinedSomething = " << OutlinedSomething << "\n";);
+  LLVM_DEBUG(dbgs() << "Outlining round " << OutlineRepeatedNum + 1
+                    << ": estimated " << BytesSaved << " bytes saved\n";);
 
   return OutlinedSomething;
 }
@@ -1421,7 +1454,31 @@ bool MachineOutliner::runOnModule(Module &M) {
   if (M.empty())
     return false;
 
+  // Number to append to the current outlined function.
+  unsigned OutlinedFunctionNum = 0;
+
+  OutlineRepeatedNum = 0;
+  if (!doOutline(M, OutlinedFunctionNum))
+    return false;
+
+  for (unsigned I = 0; I < OutlinerReruns; ++I) {
+    OutlinedFunctionNum = 0;
+    OutlineRepeatedNum++;
+    if (!doOutline(M, OutlinedFunctionNum)) {
+      LLVM_DEBUG({
+        dbgs() << "Did not outline on iteration " << I + 2 << " out of "
+               << OutlinerReruns + 1 << "\n";
+      });
+      break;
+    }
+  }
+
+  return true;
+}
+
+bool MachineOutliner::doOutline(Module &M, unsigned &OutlinedFunctionNum) {
   MachineModuleInfo &MMI = getAnalysis<MachineModuleInfo>();
+  ++NumOutliningRounds;
 
   // If the user passed -enable-machine-outliner=always or
   // -enable-machine-outliner, the pass will run on all functions in the module.
@@ -1464,7 +1521,8 @@ bool MachineOutliner::runOnModule(Module &M) {
     initSizeRemarkInfo(M, MMI, FunctionToInstrCount);
 
   // Outline each of the candidates and return true if something was outlined.
-  bool OutlinedSomething = outline(M, FunctionList, Mapper);
+  bool OutlinedSomething =
+      outline(M, FunctionList, Mapper, OutlinedFunctionNum);
 
   // If we outlined something, we definitely changed the MI count of the
   // module. If we've asked for size remarks, then output them.
@@ -15,7 +15,9 @@
 #include "SelectionDAGBuilder.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/None.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
@@ -114,6 +116,9 @@ STATISTIC(NumDAGIselRetries,"Number of times dag isel has to try another path");
 STATISTIC(NumEntryBlocks, "Number of entry blocks encountered");
 STATISTIC(NumFastIselFailLowerArguments,
           "Number of entry blocks where fast isel failed to lower arguments");
+STATISTIC(NumHashedDAGs, "Number of selection DAGs hashed");
+STATISTIC(NumRepeatedDAGs,
+          "Number of selection DAGs identical to an earlier one");
 
 static cl::opt<int> EnableFastISelAbort(
     "fast-isel-abort", cl::Hidden,
@@ -128,6 +133,12 @@ static cl::opt<bool> EnableFastISelFallbackReport(
     cl::desc("Emit a diagnostic when \"fast\" instruction selection "
              "falls back to SelectionDAG."));
 
+static cl::opt<bool> CountRepeatedDAGs(
+    "isel-count-repeated-dags", cl::Hidden,
+    cl::desc("Count the selection DAGs that are structurally identical to "
+             "the DAG of an earlier block, to measure how much a cache of "
+             "selected instructions could save"));
+
 static cl::opt<bool>
 UseMBPI("use-mbpi",
         cl::desc("use Machine Branch Probability Info"),
@@ -775,6 +786,85 @@ void SelectionDAGISel::ComputeLiveOutVRegInfo() {
   } while (!Worklist.empty());
 }
 
+template <typename T>
+static unsigned getNumber(DenseMap<T, unsigned> &Numbers, T Key) {
+  return Numbers.insert({Key, Numbers.size()}).first->second;
+}
+
+/// Hashes the structure of \p DAG. Nodes, virtual registers, frame indices
+/// and basic blocks are numbered in order of appearance, so that the DAGs of
+/// two blocks that only differ in those hash the same way. Returns None if
+/// the DAG has nodes whose payload is not hashed.
+static Optional<size_t> hashDAGStructure(SelectionDAG &DAG) {
+  DenseMap<const void *, unsigned> Nodes;
+  DenseMap<unsigned, unsigned> VRegs;
+  DenseMap<int, unsigned> FrameIndices;
+  auto getNodeNumber = [&](const void *P) { return getNumber(Nodes, P); };
+
+  hash_code Hash(0);
+  for (const SDNode &N : DAG.allnodes()) {
+    const SDNodeFlags &F = N.getFlags();
+    Hash = hash_combine(Hash, getNodeNumber(&N), N.getOpcode(),
+                        N.getNumValues(), N.getNumOperands());
+    Hash = hash_combine(Hash, F.hasNoUnsignedWrap(), F.hasNoSignedWrap(),
+                        F.hasExact(), F.hasNoNaNs(), F.hasNoInfs(),
+                        F.hasNoSignedZeros(), F.hasAllowReciprocal(),
+                        F.hasAllowContract(), F.hasApproximateFuncs(),
+                        F.hasAllowReassociation(), F.hasFPExcept());
+    for (unsigned I = 0, E = N.getNumValues(); I != E; ++I)
+      Hash = hash_combine(Hash, N.getValueType(I).getRawBits());
+    for (const SDValue &Op : N.op_values())
+      Hash = hash_combine(Hash, getNodeNumber(Op.getNode()), Op.getResNo());
+    if (&N == DAG.getRoot().getNode())
+      Hash = hash_combine(Hash, -1);
+
+    if (auto *C = dyn_cast<ConstantSDNode>(&N)) {
+      Hash = hash_combine(Hash, C->getAPIntValue(), C->isOpaque());
+    } else if (auto *C = dyn_cast<ConstantFPSDNode>(&N)) {
+      Hash = hash_combine(Hash, C->getValueAPF());
+    } else if (auto *GA = dyn_cast<GlobalAddressSDNode>(&N)) {
+      Hash = hash_combine(Hash, GA->getGlobal(), GA->getOffset(),
+                          GA->getTargetFlags());
+    } else if (auto *ES = dyn_cast<ExternalSymbolSDNode>(&N)) {
+      Hash = hash_combine(Hash, StringRef(ES->getSymbol()),
+                          ES->getTargetFlags());
+    } else if (auto *FI = dyn_cast<FrameIndexSDNode>(&N)) {
+      Hash = hash_combine(Hash, getNumber(FrameIndices, FI->getIndex()));
+    } else if (auto *R = dyn_cast<RegisterSDNode>(&N)) {
+      unsigned Reg = R->getReg();
+      if (TargetRegisterInfo::isVirtualRegister(Reg))
+        Hash = hash_combine(Hash, getNumber(VRegs, Reg));
+      else
+        Hash = hash_combine(Hash, Reg);
+    } else if (auto *RM = dyn_cast<RegisterMaskSDNode>(&N)) {
+      Hash = hash_combine(Hash, RM->getRegMask());
+    } else if (auto *BB = dyn_cast<BasicBlockSDNode>(&N)) {
+      Hash = hash_combine(Hash, getNodeNumber(BB->getBasicBlock()));
+    } else if (auto *CC = dyn_cast<CondCodeSDNode>(&N)) {
+      Hash = hash_combine(Hash, CC->get());
+    } else if (auto *VT = dyn_cast<VTSDNode>(&N)) {
+      Hash = hash_combine(Hash, VT->getVT().getRawBits());
+    } else if (auto *SV = dyn_cast<ShuffleVectorSDNode>(&N)) {
+      Hash = hash_combine(Hash, hash_combine_range(SV->getMask().begin(),
+                                                   SV->getMask().end()));
+    } else if (auto *ASC = dyn_cast<AddrSpaceCastSDNode>(&N)) {
+      Hash = hash_combine(Hash, ASC->getSrcAddressSpace(),
+                          ASC->getDestAddressSpace());
+    } else if (auto *M = dyn_cast<MemSDNode>(&N)) {
+      Hash = hash_combine(Hash, M->getRawSubclassData(),
+                          M->getMemoryVT().getRawBits(), M->getAlignment(),
+                          M->getAddressSpace(), M->getMemOperand()->getFlags());
+    } else if (isa<JumpTableSDNode>(&N) || isa<ConstantPoolSDNode>(&N) ||
+               isa<TargetIndexSDNode>(&N) || isa<SrcValueSDNode>(&N) ||
+               isa<MDNodeSDNode>(&N) || isa<BlockAddressSDNode>(&N) ||
+               isa<LabelSDNode>(&N) || isa<MCSymbolSDNode>(&N) ||
+               isa<LifetimeSDNode>(&N) || isa<MachineSDNode>(&N)) {
+      return None;
+    }
+  }
+  return size_t(Hash);
+}
+
 void SelectionDAGISel::CodeGenAndEmitDAG() {
   StringRef GroupName = "sdag";
   StringRef GroupDescription = "Instruction Selection and Scheduling";
@@ -807,6 +897,16 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
                     << "'\n";
              CurDAG->dump());
 
+  if (CountRepeatedDAGs) {
+    if (Optional<size_t> Hash = hashDAGStructure(*CurDAG)) {
+      ++NumHashedDAGs;
+      if (!SeenDAGHashes.insert(*Hash).second) {
+        ++NumRepeatedDAGs;
+        LLVM_DEBUG(dbgs() << "Selection DAG is identical to an earlier one\n");
+      }
+    }
+  }
+
   if (ViewDAGCombine1 && MatchFilterBB)
     CurDAG->viewGraph("dag-combine1 input for " + BlockName);
 
@@ -18,6 +18,9 @@
 using namespace llvm;
 using namespace dwarf;
 
+static_assert(sizeof(DWARFDebugInfoEntry) == 8,
+              "DWARFDebugInfoEntry should stay compact");
+
 bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U,
                                              uint32_t *OffsetPtr) {
   DWARFDataExtractor DebugInfoData = U.getDebugInfoExtractor();
@@ -29,21 +32,27 @@ bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U, uint32_t *OffsetPtr,
                                       const DWARFDataExtractor &DebugInfoData,
                                       uint32_t UEndOffset, uint32_t D) {
   Offset = *OffsetPtr;
-  Depth = D;
-  if (Offset >= UEndOffset || !DebugInfoData.isValidOffset(Offset))
+  if (D > MaxDepth || Offset >= UEndOffset ||
+      !DebugInfoData.isValidOffset(Offset))
     return false;
+  Depth = D;
   uint64_t AbbrCode = DebugInfoData.getULEB128(OffsetPtr);
   if (0 == AbbrCode) {
     // NULL debug tag entry.
-    AbbrevDecl = nullptr;
+    HasChildren = false;
+    AbbrevIndex = 0;
     return true;
   }
-  AbbrevDecl = U.getAbbreviations()->getAbbreviationDeclaration(AbbrCode);
-  if (nullptr == AbbrevDecl) {
+  const DWARFAbbreviationDeclarationSet *Abbrevs = U.getAbbreviations();
+  const DWARFAbbreviationDeclaration *AbbrevDecl =
+      Abbrevs->getAbbreviationDeclaration(AbbrCode);
+  if (nullptr == AbbrevDecl || Abbrevs->getIndex(AbbrevDecl) > MaxAbbrevIndex) {
     // Restore the original offset.
     *OffsetPtr = Offset;
     return false;
   }
+  HasChildren = AbbrevDecl->hasChildren();
+  AbbrevIndex = Abbrevs->getIndex(AbbrevDecl) + 1;
   // See if all attributes in this DIE have fixed byte sizes. If so, we can
   // just add this size to the offset to skip to the next DIE.
   if (Optional<size_t> FixedSize = AbbrevDecl->getFixedAttributesByteSize(U)) {
@@ -377,10 +377,9 @@ void DWARFUnit::extractDIEsToVector(
       Dies.push_back(DIE);
     }
 
-    if (const DWARFAbbreviationDeclaration *AbbrDecl =
-            DIE.getAbbreviationDeclarationPtr()) {
+    if (!DIE.isNULL()) {
       // Normal DIE
-      if (AbbrDecl->hasChildren())
+      if (DIE.hasChildren())
         ++Depth;
     } else {
       // NULL DIE.
@@ -391,6 +390,12 @@ void DWARFUnit::extractDIEsToVector(
     }
   }
 
+  // DIEs are stored compactly and cannot represent arbitrarily deep trees.
+  if (Depth > DWARFDebugInfoEntry::MaxDepth)
+    WithColor::warning() << format("DWARF compile unit 0x%8.8x nests DIEs too "
+                                   "deeply at 0x%8.8x\n",
+                                   getOffset(), DIEOffset);
+
   // Give a little bit of info if we encounter corrupt DWARF (our offset
   // should always terminate at or before the start of the next compilation
   // unit header).
@@ -534,6 +539,10 @@ bool DWARFUnit::parseDWO() {
 }
 
 void DWARFUnit::clearDIEs(bool KeepCUDie) {
+  // The address index refers to the DIEs.
+  AddrDieIndex.clear();
+  AddrDieIndex.shrink_to_fit();
+  AddrDieIndexBuilt = false;
   if (DieArray.size() > (unsigned)KeepCUDie) {
     DieArray.resize((unsigned)KeepCUDie);
     DieArray.shrink_to_fit();
@@ -588,7 +597,7 @@ Expected<DWARFAddressRangesVector> DWARFUnit::collectAddressRanges() {
   return *CUDIERangesOrError;
 }
 
-void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
+void DWARFUnit::updateAddressDieMap(DWARFDie Die, AddrDieMapTy &AddrDieMap) {
   if (Die.isSubroutineDIE()) {
     auto DIERangesOrError = Die.getAddressRanges();
     if (DIERangesOrError) {
@@ -616,21 +625,34 @@ void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
   // adding one range into the map, it will at most split a range into 3
   // sub-ranges.
   for (DWARFDie Child = Die.getFirstChild(); Child; Child = Child.getSibling())
-    updateAddressDieMap(Child);
+    updateAddressDieMap(Child, AddrDieMap);
 }
 
 DWARFDie DWARFUnit::getSubroutineForAddress(uint64_t Address) {
   extractDIEsIfNeeded(false);
-  if (AddrDieMap.empty())
-    updateAddressDieMap(getUnitDIE());
-  auto R = AddrDieMap.upper_bound(Address);
-  if (R == AddrDieMap.begin())
+  if (!AddrDieIndexBuilt) {
+    // Build the ranges in a map, which makes it easy to split the range of a
+    // subroutine around the ranges of the subroutines inlined into it, then
+    // flatten it into a vector that is cheaper to keep and to search.
+    AddrDieMapTy AddrDieMap;
+    updateAddressDieMap(getUnitDIE(), AddrDieMap);
+    AddrDieIndex.reserve(AddrDieMap.size());
+    for (const auto &Entry : AddrDieMap)
+      AddrDieIndex.push_back({Entry.first, Entry.second.first,
+                              getDIEIndex(Entry.second.second)});
+    AddrDieIndexBuilt = true;
+  }
+  auto R = llvm::upper_bound(AddrDieIndex, Address,
+                             [](uint64_t Address, const AddrDieRange &Range) {
+                               return Address < Range.LowPC;
+                             });
+  if (R == AddrDieIndex.begin())
     return DWARFDie();
   // upper_bound's previous item contains Address.
   --R;
-  if (Address >= R->second.first)
+  if (Address >= R->HighPC)
     return DWARFDie();
-  return R->second.second;
+  return getDIEAtIndex(R->DieIndex);
 }
 
 void
@@ -690,7 +712,7 @@ DWARFDie DWARFUnit::getSibling(const DWARFDebugInfoEntry *Die) {
   if (Depth == 0)
     return DWARFDie();
   // NULL DIEs don't have siblings.
-  if (Die->getAbbreviationDeclarationPtr() == nullptr)
+  if (Die->isNULL())
     return DWARFDie();
 
   // Find the next DIE whose depth is the same as the Die's depth.
@@ -740,7 +762,7 @@ DWARFDie DWARFUnit::getLastChild(const DWARFDebugInfoEntry *Die) {
   for (size_t I = getDIEIndex(Die) + 1, EndIdx = DieArray.size(); I < EndIdx;
        ++I) {
     if (DieArray[I].getDepth() == Depth + 1 &&
-        DieArray[I].getTag() == dwarf::DW_TAG_null)
+        DieArray[I].isNULL())
       return DWARFDie(this, &DieArray[I]);
     assert(DieArray[I].getDepth() > Depth && "Not processing children?");
   }
@@ -16,6 +16,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFSection.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -210,6 +211,7 @@ unsigned DWARFVerifier::verifyDebugInfoCallSite(const DWARFDie &Die) {
   for (; Curr.isValid() && !Curr.isSubprogramDIE(); Curr = Die.getParent()) {
     if (Curr.getTag() == DW_TAG_inlined_subroutine) {
       error() << "Call site entry nested within inlined subroutine:";
+      auto Lock = lockDump();
       Curr.dump(OS);
       return 1;
     }
@@ -217,6 +219,7 @@ unsigned DWARFVerifier::verifyDebugInfoCallSite(const DWARFDie &Die) {
 
   if (!Curr.isValid()) {
     error() << "Call site entry not nested within a valid subprogram:";
+    auto Lock = lockDump();
     Die.dump(OS);
     return 1;
   }
@@ -226,6 +229,7 @@ unsigned DWARFVerifier::verifyDebugInfoCallSite(const DWARFDie &Die) {
                  DW_AT_call_all_tail_calls});
   if (!CallAttr) {
     error() << "Subprogram with call site entry has no DW_AT_call attribute:";
+    auto Lock = lockDump();
     Curr.dump(OS);
     Die.dump(OS, /*indent*/ 1);
     return 1;
@@ -280,10 +284,24 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   bool hasDIE = DebugInfoData.isValidOffset(Offset);
   DWARFUnitVector TypeUnitVector;
   DWARFUnitVector CompileUnitVector;
+
+  // The headers are verified in order, as each gives the offset of the next
+  // one, and the contents of the units in parallel. Each unit has its own
+  // output, which is printed in order once all units have been verified.
+  struct UnitResult {
+    std::string Output;
+    DWARFUnit *Unit = nullptr;
+    unsigned NumErrors = 0;
+    std::map<uint64_t, std::set<uint32_t>> References;
+  };
+  std::vector<UnitResult> Results;
   while (hasDIE) {
     OffsetStart = Offset;
-    if (!verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
-                          isUnitDWARF64)) {
+    Results.emplace_back();
+    raw_string_ostream HeaderOS(Results.back().Output);
+    DWARFVerifier HeaderVerifier(HeaderOS, DCtx, DumpOpts);
+    if (!HeaderVerifier.verifyUnitHeader(DebugInfoData, &Offset, UnitIdx,
+                                         UnitType, isUnitDWARF64)) {
       isHeaderChainValid = false;
       if (isUnitDWARF64)
         break;
@@ -318,11 +336,46 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
       }
       default: { llvm_unreachable("Invalid UnitType."); }
       }
-      NumDebugInfoErrors += verifyUnitContents(*Unit);
+      // Look up the abbreviations now, as the lookup updates a cache shared
+      // by all units.
+      Unit->getAbbreviations();
+      Results.back().Unit = Unit;
     }
+    HeaderOS.flush();
     hasDIE = DebugInfoData.isValidOffset(Offset);
     ++UnitIdx;
   }
+
+  // The location lists are parsed on first use.
+  DCtx.getDebugLoc();
+
+  // Extract the DIEs of all units before verifying any, as references may
+  // lead into other units.
+  parallel::for_each_n(parallel::par, size_t(0), Results.size(), [&](size_t I) {
+    if (DWARFUnit *Unit = Results[I].Unit)
+      Unit->getNumDIEs();
+  });
+
+  std::mutex UnitDumpMutex;
+  parallel::for_each_n(parallel::par, size_t(0), Results.size(), [&](size_t I) {
+    UnitResult &Result = Results[I];
+    if (!Result.Unit)
+      return;
+    raw_string_ostream UnitOS(Result.Output);
+    DWARFVerifier UnitVerifier(UnitOS, DCtx, DumpOpts);
+    UnitVerifier.DumpMutex = &UnitDumpMutex;
+    Result.NumErrors = UnitVerifier.verifyUnitContents(*Result.Unit);
+    Result.References = std::move(UnitVerifier.ReferenceToDIEOffsets);
+  });
+
+  for (UnitResult &Result : Results) {
+    OS << Result.Output;
+    NumDebugInfoErrors += Result.NumErrors;
+    for (const auto &Ref : Result.References)
+      ReferenceToDIEOffsets[Ref.first].insert(Ref.second.begin(),
+                                              Ref.second.end());
+  }
+
   if (UnitIdx == 0 && !hasDIE) {
     warn() << "Section is empty.\n";
     isHeaderChainValid = true;
@@ -546,7 +599,10 @@ unsigned DWARFVerifier::verifyDebugInfoForm(const DWARFDie &Die,
                 << format("0x%08" PRIx64, CUOffset)
                 << " is invalid (must be less than CU size of "
                 << format("0x%08" PRIx32, CUSize) << "):\n";
-        Die.dump(OS, 0, DumpOpts);
+        {
+          auto Lock = lockDump();
+          Die.dump(OS, 0, DumpOpts);
+        }
         dump(Die) << '\n';
       } else {
         // Valid reference, but we will verify it points to an actual
@@ -1481,7 +1537,14 @@ raw_ostream &DWARFVerifier::warn() const { return WithColor::warning(OS); }
 
 raw_ostream &DWARFVerifier::note() const { return WithColor::note(OS); }
 
+std::unique_lock<std::mutex> DWARFVerifier::lockDump() const {
+  if (!DumpMutex)
+    return std::unique_lock<std::mutex>();
+  return std::unique_lock<std::mutex>(*DumpMutex);
+}
+
 raw_ostream &DWARFVerifier::dump(const DWARFDie &Die, unsigned indent) const {
+  auto Lock = lockDump();
   Die.dump(OS, indent, DumpOpts);
   return OS;
 }
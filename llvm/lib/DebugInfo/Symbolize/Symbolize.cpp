@@ -178,9 +178,62 @@ LLVMSymbolizer::symbolizeFrame(const std::string &ModuleName,
 
 void LLVMSymbolizer::flush() {
   ObjectForUBPathAndArch.clear();
+  LRUBinaries.clear();
+  CacheSize = 0;
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  ModuleBinaries.clear();
+}
+
+void LLVMSymbolizer::pruneCache() {
+  // Keep the most recently used binary, even if it alone is larger than the
+  // limit, so that a large binary isn't reopened for every request.
+  while (CacheSize > Opts.MaxCacheSize && !LRUBinaries.empty() &&
+         std::next(LRUBinaries.begin()) != LRUBinaries.end()) {
+    CachedBinary &Bin = LRUBinaries.front();
+    CacheSize -= Bin.size();
+    LRUBinaries.pop_front();
+    Bin.evict();
+  }
+}
+
+void LLVMSymbolizer::recordAccess(CachedBinary &Bin) {
+  if (!Bin->getBinary())
+    return;
+  LRUBinaries.remove(Bin);
+  LRUBinaries.push_back(Bin);
+}
+
+void LLVMSymbolizer::recordModuleAccess(const std::string &ModuleName) {
+  auto I = ModuleBinaries.find(ModuleName);
+  if (I == ModuleBinaries.end())
+    return;
+  for (CachedBinary *Bin : I->second)
+    recordAccess(*Bin);
+}
+
+void CachedBinary::pushEvictor(std::function<void()> NewEvictor) {
+  if (Evictor) {
+    Evictor = [OldEvictor = std::move(Evictor),
+               NewEvictor = std::move(NewEvictor)]() {
+      NewEvictor();
+      OldEvictor();
+    };
+  } else {
+    Evictor = std::move(NewEvictor);
+  }
+}
+
+void CachedBinary::evict() {
+  // The evictors erase this object, so run them from a local copy.
+  std::function<void()> E = std::move(Evictor);
+  if (E)
+    E();
+}
+
+size_t CachedBinary::size() const {
+  return Bin.getBinary() ? Bin.getBinary()->getData().size() : 0;
 }
 
 namespace {
@@ -369,7 +422,14 @@ LLVMSymbolizer::getOrCreateObjectPair(const std::string &Path,
   if (!DbgObj)
     DbgObj = Obj;
   ObjectPair Res = std::make_pair(Obj, DbgObj);
-  ObjectPairForPathArch.emplace(std::make_pair(Path, ArchName), Res);
+  auto Key = std::make_pair(Path, ArchName);
+  ObjectPairForPathArch.emplace(Key, Res);
+  // The pair goes away with either of its binaries.
+  auto Evictor = [this, Key]() { ObjectPairForPathArch.erase(Key); };
+  BinaryForPath.find(Path)->second.pushEvictor(Evictor);
+  auto DbgIter = BinaryForPath.find(DbgObj->getFileName());
+  if (DbgObj != Obj && DbgIter != BinaryForPath.end())
+    DbgIter->second.pushEvictor(Evictor);
   return Res;
 }
 
@@ -378,14 +438,19 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
                                   const std::string &ArchName) {
   Binary *Bin;
   auto Pair = BinaryForPath.emplace(Path, OwningBinary<Binary>());
+  CachedBinary &CachedBin = Pair.first->second;
   if (!Pair.second) {
-    Bin = Pair.first->second.getBinary();
+    Bin = CachedBin->getBinary();
+    recordAccess(CachedBin);
   } else {
     Expected<OwningBinary<Binary>> BinOrErr = createBinary(Path);
     if (!BinOrErr)
       return BinOrErr.takeError();
-    Pair.first->second = std::move(BinOrErr.get());
-    Bin = Pair.first->second.getBinary();
+    *CachedBin = std::move(BinOrErr.get());
+    CachedBin.pushEvictor([this, Path]() { BinaryForPath.erase(Path); });
+    LRUBinaries.push_back(CachedBin);
+    CacheSize += CachedBin.size();
+    Bin = CachedBin->getBinary();
   }
 
   if (!Bin)
@@ -404,8 +469,9 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
       return ObjOrErr.takeError();
     }
     ObjectFile *Res = ObjOrErr->get();
-    ObjectForUBPathAndArch.emplace(std::make_pair(Path, ArchName),
-                                   std::move(ObjOrErr.get()));
+    auto Key = std::make_pair(Path, ArchName);
+    ObjectForUBPathAndArch.emplace(Key, std::move(ObjOrErr.get()));
+    CachedBin.pushEvictor([this, Key]() { ObjectForUBPathAndArch.erase(Key); });
     return Res;
   }
   if (Bin->isObject()) {
@@ -434,8 +500,10 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
+  if (I != Modules.end()) {
+    recordModuleAccess(ModuleName);
     return I->second.get();
+  }
 
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
@@ -479,6 +547,18 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
     Context =
         DWARFContext::create(*Objects.second, nullptr,
                              DWARFContext::defaultErrorHandler, Opts.DWPName);
+
+  // The module refers to both of its binaries, so it goes away with either.
+  SmallVector<CachedBinary *, 2> &Binaries = ModuleBinaries[ModuleName];
+  Binaries.push_back(&BinaryForPath.find(BinaryName)->second);
+  auto DbgIter = BinaryForPath.find(Objects.second->getFileName());
+  if (Objects.second != Objects.first && DbgIter != BinaryForPath.end())
+    Binaries.push_back(&DbgIter->second);
+  for (CachedBinary *Bin : Binaries)
+    Bin->pushEvictor([this, ModuleName]() {
+      Modules.erase(ModuleName);
+      ModuleBinaries.erase(ModuleName);
+    });
   return createModuleInfo(Objects.first, std::move(Context), ModuleName);
 }
 
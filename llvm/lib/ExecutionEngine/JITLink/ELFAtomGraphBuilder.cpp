@@ -0,0 +1,518 @@
+//=---------- ELFAtomGraphBuilder.cpp - ELF AtomGraph builder -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Generic ELF AtomGraph building code.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ELFAtomGraphBuilder.h"
+
+#include "llvm/BinaryFormat/ELF.h"
+
+#define DEBUG_TYPE "jitlink"
+
+namespace llvm {
+namespace jitlink {
+
+static const char EHFrameTerminator[4] = {0, 0, 0, 0};
+
+ELFAtomGraphBuilder::~ELFAtomGraphBuilder() {}
+
+Expected<std::unique_ptr<AtomGraph>> ELFAtomGraphBuilder::buildGraph() {
+  if (auto Err = parseSections())
+    return std::move(Err);
+
+  if (auto Err = addAtoms())
+    return std::move(Err);
+
+  if (auto Err = processRelocations())
+    return std::move(Err);
+
+  addFDEKeepAliveEdges();
+
+  return std::move(G);
+}
+
+ELFAtomGraphBuilder::ELFAtomGraphBuilder(const object::ELFObjectFileBase &Obj,
+                                         Edge::Kind FDEToCIERelocKind)
+    : Obj(Obj),
+      G(llvm::make_unique<AtomGraph>(Obj.getFileName(), getPointerSize(Obj),
+                                     getEndianness(Obj))),
+      FDEToCIERelocKind(FDEToCIERelocKind) {}
+
+Error ELFAtomGraphBuilder::unsupportedRelocation(uint32_t Type,
+                                                 const DefinedAtom &AtomToFix) {
+  return make_error<JITLinkError>(
+      "Unsupported relocation " +
+      object::getELFRelocationTypeName(Obj.getEMachine(), Type) +
+      " in section " + AtomToFix.getSection().getName());
+}
+
+unsigned
+ELFAtomGraphBuilder::getPointerSize(const object::ELFObjectFileBase &Obj) {
+  return Obj.getBytesInAddress();
+}
+
+support::endianness
+ELFAtomGraphBuilder::getEndianness(const object::ELFObjectFileBase &Obj) {
+  return Obj.isLittleEndian() ? support::little : support::big;
+}
+
+uint64_t ELFAtomGraphBuilder::getSymbolKey(const object::SymbolRef &Sym) {
+  // ELF symbol references hold the symbol table and the symbol index.
+  auto D = Sym.getRawDataRefImpl();
+  return (static_cast<uint64_t>(D.d.a) << 32) | D.d.b;
+}
+
+Section &ELFAtomGraphBuilder::getCommonSection() {
+  if (!CommonSection) {
+    auto Prot = static_cast<sys::Memory::ProtectionFlags>(
+        sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+    CommonSection = &G->createSection("<common>", 1, Prot, true);
+  }
+  return *CommonSection;
+}
+
+Error ELFAtomGraphBuilder::parseSections() {
+  JITTargetAddress NextAddress = 0;
+
+  for (auto &SecRef : Obj.sections()) {
+    object::ELFSectionRef ESecRef(SecRef);
+    uint64_t Flags = ESecRef.getFlags();
+
+    // Only allocated sections are loaded.
+    if (!(Flags & ELF::SHF_ALLOC) || SecRef.getSize() == 0)
+      continue;
+
+    StringRef Name;
+    if (auto EC = SecRef.getName(Name))
+      return errorCodeToError(EC);
+
+    if (Flags & ELF::SHF_TLS)
+      return make_error<JITLinkError>("Thread-local section " + Name +
+                                      " is not supported");
+
+    uint64_t Align = std::max<uint64_t>(SecRef.getAlignment(), 1);
+    if (!isPowerOf2_64(Align) || Align > std::numeric_limits<uint32_t>::max())
+      return make_error<JITLinkError>("Section " + Name +
+                                      " has unsupported alignment");
+
+    unsigned Prot = sys::Memory::MF_READ;
+    if (Flags & ELF::SHF_WRITE)
+      Prot |= sys::Memory::MF_WRITE;
+    if (Flags & ELF::SHF_EXECINSTR)
+      Prot |= sys::Memory::MF_EXEC;
+
+    bool IsZeroFill = ESecRef.getType() == ELF::SHT_NOBITS;
+    auto &GenericSection = G->createSection(
+        Name, Align, static_cast<sys::Memory::ProtectionFlags>(Prot),
+        IsZeroFill);
+
+    // Relocatable objects leave section addresses at zero, so pick an
+    // address range for each section.
+    auto &S = Sections[SecRef.getIndex()];
+    S.GenericSection = &GenericSection;
+    S.Address = alignTo(NextAddress, Align);
+    S.Size = SecRef.getSize();
+    S.Alignment = Align;
+
+    if (!IsZeroFill) {
+      Expected<StringRef> Content = SecRef.getContents();
+      if (!Content)
+        return Content.takeError();
+      if (Content->size() != S.Size)
+        return make_error<JITLinkError>("Section content size does not match "
+                                        "declared size for " +
+                                        Name);
+      S.Content = *Content;
+    }
+
+    LLVM_DEBUG({
+      dbgs() << "Adding section " << Name << ": "
+             << format("0x%016" PRIx64, S.Address) << ", size: " << S.Size
+             << ", align: " << Align << "\n";
+    });
+
+    // Leave room for the terminator appended to the eh-frame section.
+    NextAddress = S.Address + S.Size + (Name == ".eh_frame" ? 4 : 0);
+  }
+
+  // Extra atoms for aliases are placed after all sections, where no fixup
+  // will look for them.
+  NextAliasAddress = NextAddress;
+  return Error::success();
+}
+
+Error ELFAtomGraphBuilder::addAtoms() {
+  DenseMap<uint64_t, std::vector<SymbolDef>> SectionDefs;
+  std::vector<std::pair<uint64_t, uint64_t>> SectionSymbols;
+
+  // The names of all non-local symbols. Local symbols that share a name with
+  // any other symbol get anonymous atoms.
+  DenseSet<StringRef> UsedNames;
+
+  for (auto &Sym : Obj.symbols()) {
+    uint8_t Type = Sym.getELFType();
+    if (Type == ELF::STT_FILE)
+      continue;
+
+    uint64_t Key = getSymbolKey(Sym);
+
+    // Relocations against section symbols are resolved against the first
+    // atom of the section, once the sections have been split up.
+    if (Type == ELF::STT_SECTION) {
+      auto SecI = Sym.getSection();
+      if (!SecI)
+        return SecI.takeError();
+      if (*SecI != Obj.section_end())
+        SectionSymbols.push_back(std::make_pair(Key, (*SecI)->getIndex()));
+      continue;
+    }
+
+    auto Name = Sym.getName();
+    if (!Name)
+      return Name.takeError();
+
+    if (Type == ELF::STT_TLS)
+      return make_error<JITLinkError>("Thread-local symbol " + *Name +
+                                      " is not supported");
+    if (Type == ELF::STT_GNU_IFUNC)
+      return make_error<JITLinkError>("Indirect function " + *Name +
+                                      " is not supported");
+
+    uint32_t Flags = Sym.getFlags();
+    bool IsGlobal = Flags & object::SymbolRef::SF_Global;
+
+    if (Flags & object::SymbolRef::SF_Undefined) {
+      // Compilers declare the GOT symbol in every PIC object, but it is only
+      // used by GOT-relative relocations, which are not supported.
+      if (Name->empty() || *Name == "_GLOBAL_OFFSET_TABLE_")
+        continue;
+      if (!UsedNames.insert(*Name).second)
+        return make_error<JITLinkError>("Duplicate symbol in object: " +
+                                        *Name);
+      LLVM_DEBUG(dbgs() << "Adding undef atom \"" << *Name << "\"\n");
+      SymbolTargets[Key].A = &G->addExternalAtom(*Name);
+      continue;
+    } else if (Flags & object::SymbolRef::SF_Absolute) {
+      if (!UsedNames.insert(*Name).second)
+        return make_error<JITLinkError>("Duplicate symbol in object: " +
+                                        *Name);
+      LLVM_DEBUG(dbgs() << "Adding absolute \"" << *Name << "\" addr: "
+                        << format("0x%016" PRIx64, Sym.getValue()) << "\n");
+      auto &A = G->addAbsoluteAtom(*Name, Sym.getValue());
+      A.setGlobal(IsGlobal);
+      A.setExported(Flags & object::SymbolRef::SF_Exported);
+      A.setWeak(Flags & object::SymbolRef::SF_Weak);
+      SymbolTargets[Key].A = &A;
+      continue;
+    } else if (Flags & object::SymbolRef::SF_Common) {
+      if (!UsedNames.insert(*Name).second)
+        return make_error<JITLinkError>("Duplicate symbol in object: " +
+                                        *Name);
+      LLVM_DEBUG(dbgs() << "Adding common \"" << *Name << "\"\n");
+      auto &A = G->addCommonAtom(getCommonSection(), *Name, 0,
+                                 std::max(Sym.getAlignment(), 1U),
+                                 Sym.getSize());
+      A.setGlobal(IsGlobal);
+      A.setExported(Flags & object::SymbolRef::SF_Exported);
+      SymbolTargets[Key].A = &A;
+      continue;
+    }
+
+    // Symbols in sections that are not loaded, e.g. debug info, are not
+    // represented.
+    auto SecI = Sym.getSection();
+    if (!SecI)
+      return SecI.takeError();
+    if (*SecI == Obj.section_end() || !Sections.count((*SecI)->getIndex()))
+      continue;
+
+    if (IsGlobal && !UsedNames.insert(*Name).second)
+      return make_error<JITLinkError>("Duplicate symbol in object: " + *Name);
+
+    SectionDefs[(*SecI)->getIndex()].push_back(
+        {Sym.getValue(), Key, *Name, Flags, Type == ELF::STT_FUNC});
+  }
+
+  for (auto &KV : Sections) {
+    auto &S = KV.second;
+    if (S.GenericSection->getName() == ".eh_frame") {
+      if (auto Err = addEHFrameAtoms(S))
+        return Err;
+      continue;
+    }
+    if (auto Err = addSectionAtoms(S, SectionDefs[KV.first], UsedNames))
+      return Err;
+  }
+
+  for (auto &KV : SectionSymbols) {
+    auto SI = Sections.find(KV.second);
+    if (SI != Sections.end())
+      SymbolTargets[KV.first].A = SI->second.Head;
+  }
+
+  return Error::success();
+}
+
+static void setSymbolFlags(DefinedAtom &DA, uint32_t Flags, bool IsCallable) {
+  DA.setGlobal(Flags & object::SymbolRef::SF_Global);
+  DA.setExported(Flags & object::SymbolRef::SF_Exported);
+  DA.setWeak(Flags & object::SymbolRef::SF_Weak);
+  DA.setCallable(IsCallable);
+}
+
+Error ELFAtomGraphBuilder::addSectionAtoms(ELFSection &S,
+                                           std::vector<SymbolDef> &Defs,
+                                           DenseSet<StringRef> &UsedNames) {
+  // Sort the symbols by address, with global symbols first so that they name
+  // the atoms.
+  llvm::stable_sort(Defs, [](const SymbolDef &LHS, const SymbolDef &RHS) {
+    if (LHS.Offset != RHS.Offset)
+      return LHS.Offset < RHS.Offset;
+    return (LHS.Flags & object::SymbolRef::SF_Global) >
+           (RHS.Flags & object::SymbolRef::SF_Global);
+  });
+
+  // The atoms of the section in layout order, and the atoms that carry the
+  // section's content with their offsets.
+  std::vector<DefinedAtom *> Chain;
+  std::vector<std::pair<uint64_t, DefinedAtom *>> ContentAtoms;
+
+  auto AddContentAtom = [&](StringRef Name, uint64_t Offset) -> DefinedAtom & {
+    // Atoms other than the first are only as aligned as their offset, so
+    // that laying them out does not insert padding.
+    uint32_t Align = S.Alignment;
+    if (Offset)
+      Align = std::min<uint64_t>(Align, 1ULL << countTrailingZeros(Offset));
+    auto &DA = Name.empty() ? G->addAnonymousAtom(*S.GenericSection,
+                                                  S.Address + Offset, Align)
+                            : G->addDefinedAtom(*S.GenericSection, Name,
+                                                S.Address + Offset, Align);
+    ContentAtoms.push_back(std::make_pair(Offset, &DA));
+    return DA;
+  };
+
+  if (Defs.empty() || Defs.front().Offset != 0)
+    Chain.push_back(&AddContentAtom("", 0));
+
+  for (size_t I = 0, E = Defs.size(); I != E;) {
+    uint64_t Offset = Defs[I].Offset;
+    if (Offset > S.Size)
+      return make_error<JITLinkError>("Symbol " + Defs[I].Name +
+                                      " lies outside its section " +
+                                      S.GenericSection->getName());
+
+    // The first symbol at each offset within the section gets an atom for
+    // the content from there to the next symbol. Other global symbols at the
+    // same offset get zero-size atoms ahead of it.
+    DefinedAtom *ContentAtom = nullptr;
+    std::vector<DefinedAtom *> Aliases;
+    for (; I != E && Defs[I].Offset == Offset; ++I) {
+      auto &Def = Defs[I];
+      bool IsGlobal = Def.Flags & object::SymbolRef::SF_Global;
+      auto &Target = SymbolTargets[Def.Key];
+
+      if (!ContentAtom && Offset != S.Size) {
+        bool IsNamed = IsGlobal || (!Def.Name.empty() &&
+                                    UsedNames.insert(Def.Name).second);
+        ContentAtom = &AddContentAtom(IsNamed ? Def.Name : "", Offset);
+        if (IsNamed)
+          setSymbolFlags(*ContentAtom, Def.Flags, Def.IsCallable);
+        Target.A = ContentAtom;
+      } else if (IsGlobal) {
+        auto &Alias = G->addDefinedAtom(*S.GenericSection, Def.Name,
+                                        NextAliasAddress++, 1);
+        if (S.Content.data())
+          Alias.setContent(StringRef());
+        else
+          Alias.setZeroFill(0);
+        setSymbolFlags(Alias, Def.Flags, Def.IsCallable);
+        Aliases.push_back(&Alias);
+        Target.A = &Alias;
+      } else if (ContentAtom)
+        Target.A = ContentAtom;
+      else {
+        // A local symbol at the end of the section.
+        Target.A = ContentAtoms.back().second;
+        Target.Delta = Offset - ContentAtoms.back().first;
+      }
+
+      LLVM_DEBUG({
+        dbgs() << "  Symbol \"" << Def.Name << "\" in "
+               << S.GenericSection->getName() << " at offset " << Offset
+               << " -> " << *Target.A << "\n";
+      });
+    }
+
+    Chain.insert(Chain.end(), Aliases.begin(), Aliases.end());
+    if (ContentAtom)
+      Chain.push_back(ContentAtom);
+  }
+
+  // Set the atom contents.
+  for (size_t I = 0, E = ContentAtoms.size(); I != E; ++I) {
+    uint64_t Offset = ContentAtoms[I].first;
+    uint64_t End = I + 1 != E ? ContentAtoms[I + 1].first : S.Size;
+    auto &DA = *ContentAtoms[I].second;
+    if (S.Content.data())
+      DA.setContent(S.Content.substr(Offset, End - Offset));
+    else
+      DA.setZeroFill(End - Offset);
+  }
+
+  // Lock the layout of the section, and keep all of it alive if any of it
+  // is.
+  for (size_t I = 1, E = Chain.size(); I != E; ++I) {
+    Chain[I - 1]->setLayoutNext(*Chain[I]);
+    Chain[I]->addEdge(Edge::KeepAlive, 0, *Chain[I - 1], 0);
+  }
+  S.Head = Chain.front();
+
+  return Error::success();
+}
+
+Error ELFAtomGraphBuilder::addEHFrameAtoms(ELFSection &S) {
+  using namespace support;
+
+  LLVM_DEBUG(dbgs() << "Splitting eh-frame section\n");
+
+  DenseMap<uint64_t, DefinedAtom *> CIEs;
+  auto Endianness = G->getEndianness();
+  const char *Data = S.Content.data();
+
+  uint64_t Offset = 0;
+  while (Offset + 4 <= S.Size) {
+    uint64_t Length = endian::read32(Data + Offset, Endianness);
+    uint64_t IDOffset = Offset + 4;
+
+    // A zero length terminates the section.
+    if (Length == 0)
+      break;
+
+    if (Length == 0xffffffff) {
+      if (Offset + 12 > S.Size)
+        return make_error<JITLinkError>("Truncated eh-frame record");
+      Length = endian::read64(Data + Offset + 4, Endianness);
+      IDOffset = Offset + 12;
+    }
+
+    if (Length < 4 || Length > S.Size - IDOffset)
+      return make_error<JITLinkError>(
+          "eh-frame record at offset " + Twine(Offset) +
+          " extends past the end of the section");
+    uint64_t RecordSize = IDOffset + Length - Offset;
+
+    auto &Record =
+        G->addAnonymousAtom(*S.GenericSection, S.Address + Offset, 4);
+    Record.setContent(S.Content.substr(Offset, RecordSize));
+    if (!S.Head)
+      S.Head = &Record;
+
+    // A zero CIE pointer marks a CIE. Otherwise it is the distance back from
+    // the field to the CIE of this FDE.
+    uint32_t CIEPointer = endian::read32(Data + IDOffset, Endianness);
+    if (CIEPointer == 0)
+      CIEs[Offset] = &Record;
+    else {
+      auto CIEI = CIEPointer <= IDOffset ? CIEs.find(IDOffset - CIEPointer)
+                                         : CIEs.end();
+      if (CIEI == CIEs.end())
+        return make_error<JITLinkError>("FDE at offset " + Twine(Offset) +
+                                        " does not point at a CIE");
+      Record.addEdge(FDEToCIERelocKind, IDOffset - Offset, *CIEI->second, 0);
+      FDEAtoms.push_back(&Record);
+    }
+
+    Offset += RecordSize;
+  }
+
+  // The unwinder finds the end of a registered section by its terminator.
+  auto &Terminator =
+      G->addAnonymousAtom(*S.GenericSection, S.Address + S.Size, 4);
+  Terminator.setContent(StringRef(EHFrameTerminator, 4));
+  Terminator.setLive(true);
+  if (!S.Head)
+    S.Head = &Terminator;
+
+  return Error::success();
+}
+
+Error ELFAtomGraphBuilder::processRelocations() {
+  for (auto &SecRef : Obj.sections()) {
+    auto RelocatedSec = SecRef.getRelocatedSection();
+    if (RelocatedSec == Obj.section_end())
+      continue;
+
+    // Skip relocations for sections that are not loaded.
+    auto SI = Sections.find(RelocatedSec->getIndex());
+    if (SI == Sections.end())
+      continue;
+    auto &S = SI->second;
+
+    for (auto &Rel : SecRef.relocations()) {
+      object::ELFRelocationRef ERel(Rel);
+
+      // Type zero is R_<arch>_NONE on all supported targets.
+      uint32_t Type = Rel.getType();
+      if (Type == 0)
+        continue;
+
+      if (!S.Content.data() || Rel.getOffset() >= S.Size)
+        return make_error<JITLinkError>(
+            "Relocation at offset " + Twine(Rel.getOffset()) +
+            " does not fix up the content of " + S.GenericSection->getName());
+
+      JITTargetAddress FixupAddress = S.Address + Rel.getOffset();
+      auto AtomToFix = G->findAtomByAddress(FixupAddress);
+      if (!AtomToFix)
+        return AtomToFix.takeError();
+
+      auto Addend = ERel.getAddend();
+      if (!Addend)
+        return Addend.takeError();
+
+      auto SymI = Rel.getSymbol();
+      auto TI = SymI != Obj.symbol_end()
+                    ? SymbolTargets.find(getSymbolKey(*SymI))
+                    : SymbolTargets.end();
+      if (TI == SymbolTargets.end() || !TI->second.A)
+        return make_error<JITLinkError>(
+            "Relocation at offset " + Twine(Rel.getOffset()) + " in " +
+            S.GenericSection->getName() + " has no loaded target");
+      auto &Target = TI->second;
+
+      if (auto Err = addRelocation(*AtomToFix, FixupAddress, Type, *Target.A,
+                                   *Addend + Target.Delta))
+        return Err;
+    }
+  }
+
+  return Error::success();
+}
+
+void ELFAtomGraphBuilder::addFDEKeepAliveEdges() {
+  // The PC-begin field follows the CIE pointer. Keep each FDE alive for as
+  // long as the function it describes.
+  for (auto *FDE : FDEAtoms) {
+    Edge::OffsetT PCBeginOffset = 0;
+    for (auto &E : FDE->edges())
+      if (E.getKind() == FDEToCIERelocKind)
+        PCBeginOffset = E.getOffset() + 4;
+
+    for (auto &E : FDE->edges())
+      if (E.getOffset() == PCBeginOffset && E.getTarget().isDefined()) {
+        auto &Function = static_cast<DefinedAtom &>(E.getTarget());
+        Function.addEdge(Edge::KeepAlive, 0, *FDE, 0);
+        break;
+      }
+  }
+}
+
+} // end namespace jitlink
+} // end namespace llvm
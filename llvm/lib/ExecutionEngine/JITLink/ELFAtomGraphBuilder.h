@@ -0,0 +1,119 @@
+//===------- ELFAtomGraphBuilder.h - ELF AtomGraph builder ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Generic ELF AtomGraph building code.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIB_EXECUTIONENGINE_JITLINK_ELFATOMGRAPHBUILDER_H
+#define LIB_EXECUTIONENGINE_JITLINK_ELFATOMGRAPHBUILDER_H
+
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+
+#include "JITLinkGeneric.h"
+
+#include "llvm/Object/ELFObjectFile.h"
+
+namespace llvm {
+namespace jitlink {
+
+/// Builds an AtomGraph from an ELF relocatable object.
+///
+/// Sections in a relocatable object have no addresses, so each allocated
+/// section is given a distinct address range in the graph. Each section is
+/// split into atoms at the symbols it defines, but the atoms of a section are
+/// chained together with layout-next constraints and keep each other alive:
+/// The assembler resolves references within a section without relocations,
+/// so a section can only be dead-stripped or moved as a whole. Objects built
+/// with -ffunction-sections and -fdata-sections can be dead-stripped per
+/// symbol. Further global symbols at the address of an atom, such as C++
+/// constructor aliases, get zero-size atoms placed just before it.
+///
+/// The .eh_frame section is split into one atom per CIE and FDE instead, so
+/// that the FDEs of dead-stripped functions are dropped, and a terminator is
+/// appended so that the section can be registered as a whole.
+class ELFAtomGraphBuilder {
+public:
+  virtual ~ELFAtomGraphBuilder();
+  Expected<std::unique_ptr<AtomGraph>> buildGraph();
+
+protected:
+  /// Create a builder for Obj. FDEToCIERelocKind must be an edge kind for a
+  /// 32-bit fixup with the value FixupAddress - Target + Addend.
+  ELFAtomGraphBuilder(const object::ELFObjectFileBase &Obj,
+                      Edge::Kind FDEToCIERelocKind);
+
+  AtomGraph &getGraph() const { return *G; }
+
+  const object::ELFObjectFileBase &getObject() const { return Obj; }
+
+  /// Add an edge for the given relocation, of the target-specific Type, to
+  /// AtomToFix. Target and Addend are the symbol and addend of the
+  /// relocation, with the addend adjusted to be relative to Target.
+  virtual Error addRelocation(DefinedAtom &AtomToFix,
+                              JITTargetAddress FixupAddress, uint32_t Type,
+                              Atom &Target, int64_t Addend) = 0;
+
+  /// Returns an error for a relocation of the given Type, in AtomToFix, that
+  /// addRelocation does not support.
+  Error unsupportedRelocation(uint32_t Type, const DefinedAtom &AtomToFix);
+
+private:
+  struct ELFSection {
+    Section *GenericSection = nullptr;
+    JITTargetAddress Address = 0;
+    uint64_t Size = 0;
+    uint32_t Alignment = 1;
+    StringRef Content;
+    DefinedAtom *Head = nullptr;
+  };
+
+  // The atom representing a symbol, and the offset of the symbol from it.
+  struct SymbolTarget {
+    Atom *A = nullptr;
+    int64_t Delta = 0;
+  };
+
+  // A symbol defined in an allocated section.
+  struct SymbolDef {
+    uint64_t Offset;
+    uint64_t Key;
+    StringRef Name;
+    uint32_t Flags;
+    bool IsCallable;
+  };
+
+  static unsigned getPointerSize(const object::ELFObjectFileBase &Obj);
+  static support::endianness
+  getEndianness(const object::ELFObjectFileBase &Obj);
+  static uint64_t getSymbolKey(const object::SymbolRef &Sym);
+
+  Section &getCommonSection();
+
+  Error parseSections();
+  Error addAtoms();
+  Error addSectionAtoms(ELFSection &S, std::vector<SymbolDef> &Defs,
+                        DenseSet<StringRef> &UsedNames);
+  Error addEHFrameAtoms(ELFSection &S);
+  Error processRelocations();
+  void addFDEKeepAliveEdges();
+
+  const object::ELFObjectFileBase &Obj;
+  std::unique_ptr<AtomGraph> G;
+  Edge::Kind FDEToCIERelocKind;
+  DenseMap<uint64_t, ELFSection> Sections;
+  DenseMap<uint64_t, SymbolTarget> SymbolTargets;
+  std::vector<DefinedAtom *> FDEAtoms;
+  JITTargetAddress NextAliasAddress = 0;
+  Section *CommonSection = nullptr;
+};
+
+} // end namespace jitlink
+} // end namespace llvm
+
+#endif // LIB_EXECUTIONENGINE_JITLINK_ELFATOMGRAPHBUILDER_H
@@ -0,0 +1,395 @@
+//===---- ELF_aarch64.cpp - JIT linker implementation for ELF/AArch64 -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// ELF/AArch64 jit-link implementation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/ELF_aarch64.h"
+
+#include "BasicGOTAndStubsBuilder.h"
+#include "ELFAtomGraphBuilder.h"
+
+#include "llvm/BinaryFormat/ELF.h"
+
+#define DEBUG_TYPE "jitlink"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_aarch64_Edges;
+
+namespace {
+
+class ELFAtomGraphBuilder_aarch64 : public ELFAtomGraphBuilder {
+public:
+  ELFAtomGraphBuilder_aarch64(const object::ELFObjectFileBase &Obj)
+      : ELFAtomGraphBuilder(Obj, NegDelta32) {}
+
+private:
+  Error addRelocation(DefinedAtom &AtomToFix, JITTargetAddress FixupAddress,
+                      uint32_t Type, Atom &Target, int64_t Addend) override {
+    ELFAArch64RelocationKind Kind;
+    uint64_t FixupSize = 4;
+    switch (Type) {
+    case ELF::R_AARCH64_ABS64:
+      Kind = Pointer64;
+      FixupSize = 8;
+      break;
+    case ELF::R_AARCH64_ABS32:
+      Kind = Pointer32;
+      break;
+    case ELF::R_AARCH64_PREL32:
+      Kind = PCRel32;
+      break;
+    case ELF::R_AARCH64_PREL64:
+      Kind = Delta64;
+      FixupSize = 8;
+      break;
+    case ELF::R_AARCH64_CALL26:
+    case ELF::R_AARCH64_JUMP26:
+      Kind = Branch26;
+      break;
+    case ELF::R_AARCH64_ADR_PREL_PG_HI21:
+      Kind = Page21;
+      break;
+    case ELF::R_AARCH64_ADD_ABS_LO12_NC:
+    case ELF::R_AARCH64_LDST8_ABS_LO12_NC:
+    case ELF::R_AARCH64_LDST16_ABS_LO12_NC:
+    case ELF::R_AARCH64_LDST32_ABS_LO12_NC:
+    case ELF::R_AARCH64_LDST64_ABS_LO12_NC:
+    case ELF::R_AARCH64_LDST128_ABS_LO12_NC:
+      Kind = PageOffset12;
+      break;
+    case ELF::R_AARCH64_ADR_GOT_PAGE:
+      Kind = GOTPage21;
+      break;
+    case ELF::R_AARCH64_LD64_GOT_LO12_NC:
+      Kind = GOTPageOffset12;
+      break;
+    default:
+      return unsupportedRelocation(Type, AtomToFix);
+    }
+
+    Edge::OffsetT Offset = FixupAddress - AtomToFix.getAddress();
+    if (Offset + FixupSize > AtomToFix.getSize())
+      return make_error<JITLinkError>(
+          "Relocation content extends past end of fixup atom");
+
+    // GOT entries are shared by name.
+    if ((Kind == GOTPage21 || Kind == GOTPageOffset12) && !Target.hasName())
+      return make_error<JITLinkError>(
+          "GOT relocation against a local symbol in " +
+          AtomToFix.getSection().getName() + " is not supported");
+
+    LLVM_DEBUG({
+      Edge GE(Kind, Offset, Target, Addend);
+      printEdge(dbgs(), AtomToFix, GE, getELFAArch64RelocationKindName(Kind));
+      dbgs() << "\n";
+    });
+    AtomToFix.addEdge(Kind, Offset, Target, Addend);
+    return Error::success();
+  }
+};
+
+class ELF_aarch64_GOTAndStubsBuilder
+    : public BasicGOTAndStubsBuilder<ELF_aarch64_GOTAndStubsBuilder> {
+public:
+  ELF_aarch64_GOTAndStubsBuilder(AtomGraph &G)
+      : BasicGOTAndStubsBuilder<ELF_aarch64_GOTAndStubsBuilder>(G) {}
+
+  bool isGOTEdge(Edge &E) const {
+    return E.getKind() == GOTPage21 || E.getKind() == GOTPageOffset12;
+  }
+
+  DefinedAtom &createGOTEntry(Atom &Target) {
+    auto &GOTEntryAtom = G.addAnonymousAtom(getGOTSection(), 0x0, 8);
+    GOTEntryAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(NullGOTEntryContent), 8));
+    GOTEntryAtom.addEdge(Pointer64, 0, Target, 0);
+    return GOTEntryAtom;
+  }
+
+  void fixGOTEdge(Edge &E, Atom &GOTEntry) {
+    assert((E.getKind() == GOTPage21 || E.getKind() == GOTPageOffset12) &&
+           "Not a GOT edge?");
+    E.setKind(E.getKind() == GOTPage21 ? Page21 : PageOffset12);
+    E.setTarget(GOTEntry);
+    // Leave the edge addend as-is.
+  }
+
+  bool isExternalBranchEdge(Edge &E) {
+    return E.getKind() == Branch26 && !E.getTarget().isDefined();
+  }
+
+  DefinedAtom &createStub(Atom &Target) {
+    auto &StubAtom = G.addAnonymousAtom(getStubsSection(), 0x0, 4);
+    StubAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(StubContent), 12));
+
+    // Re-use GOT entries for stub targets.
+    auto &GOTEntryAtom = getGOTEntryAtom(Target);
+    StubAtom.addEdge(Page21, 0, GOTEntryAtom, 0);
+    StubAtom.addEdge(PageOffset12, 4, GOTEntryAtom, 0);
+
+    return StubAtom;
+  }
+
+  void fixExternalBranchEdge(Edge &E, Atom &Stub) {
+    assert(E.getKind() == Branch26 && "Not a Branch26 edge?");
+    E.setTarget(Stub);
+  }
+
+private:
+  Section &getGOTSection() {
+    if (!GOTSection)
+      GOTSection = &G.createSection("$__GOT", 8, sys::Memory::MF_READ, false);
+    return *GOTSection;
+  }
+
+  Section &getStubsSection() {
+    if (!StubsSection) {
+      auto StubsProt = static_cast<sys::Memory::ProtectionFlags>(
+          sys::Memory::MF_READ | sys::Memory::MF_EXEC);
+      StubsSection = &G.createSection("$__STUBS", 8, StubsProt, false);
+    }
+    return *StubsSection;
+  }
+
+  static const uint8_t NullGOTEntryContent[8];
+  static const uint8_t StubContent[12];
+  Section *GOTSection = nullptr;
+  Section *StubsSection = nullptr;
+};
+
+const uint8_t ELF_aarch64_GOTAndStubsBuilder::NullGOTEntryContent[8] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const uint8_t ELF_aarch64_GOTAndStubsBuilder::StubContent[12] = {
+    0x10, 0x00, 0x00, 0x90, // adrp x16, <GOT entry>@page
+    0x10, 0x02, 0x40, 0xf9, // ldr x16, [x16, <GOT entry>@pageoff]
+    0x00, 0x02, 0x1f, 0xd6  // br x16
+};
+} // namespace
+
+namespace llvm {
+namespace jitlink {
+
+class ELFJITLinker_aarch64 : public JITLinker<ELFJITLinker_aarch64> {
+  friend class JITLinker<ELFJITLinker_aarch64>;
+
+public:
+  ELFJITLinker_aarch64(std::unique_ptr<JITLinkContext> Ctx,
+                       PassConfiguration PassConfig)
+      : JITLinker(std::move(Ctx), std::move(PassConfig)) {}
+
+private:
+  StringRef getEdgeKindName(Edge::Kind R) const override {
+    return getELFAArch64RelocationKindName(R);
+  }
+
+  Expected<std::unique_ptr<AtomGraph>>
+  buildGraph(MemoryBufferRef ObjBuffer) override {
+    auto ELFObj = object::ObjectFile::createELFObjectFile(ObjBuffer);
+    if (!ELFObj)
+      return ELFObj.takeError();
+    return ELFAtomGraphBuilder_aarch64(
+               cast<object::ELFObjectFileBase>(**ELFObj))
+        .buildGraph();
+  }
+
+  static Error targetOutOfRangeError(const Atom &A, const Edge &E) {
+    std::string ErrMsg;
+    {
+      raw_string_ostream ErrStream(ErrMsg);
+      ErrStream << "Relocation target out of range: ";
+      printEdge(ErrStream, A, E, getELFAArch64RelocationKindName(E.getKind()));
+      ErrStream << "\n";
+    }
+    return make_error<JITLinkError>(std::move(ErrMsg));
+  }
+
+  static bool isADRP(uint32_t Instr) {
+    return (Instr & 0x9f000000) == 0x90000000;
+  }
+
+  static bool isLoadStoreImm12(uint32_t Instr) {
+    constexpr uint32_t LoadStoreImm12Mask = 0x3b000000;
+    return (Instr & LoadStoreImm12Mask) == 0x39000000;
+  }
+
+  // Returns the log2 of the access size of a load or store with an unsigned
+  // 12-bit immediate, which scales the immediate.
+  static unsigned getPageOffset12Shift(uint32_t Instr) {
+    constexpr uint32_t Vec128Mask = 0x04800000;
+
+    unsigned ImplicitShift = Instr >> 30;
+    if (ImplicitShift == 0 && (Instr & Vec128Mask) == Vec128Mask)
+      ImplicitShift = 4;
+    return ImplicitShift;
+  }
+
+  Error applyFixup(DefinedAtom &A, const Edge &E, char *AtomWorkingMem) const {
+    using namespace support;
+
+    char *FixupPtr = AtomWorkingMem + E.getOffset();
+    JITTargetAddress FixupAddress = A.getAddress() + E.getOffset();
+
+    switch (E.getKind()) {
+    case Branch26: {
+      assert((FixupAddress & 0x3) == 0 && "Branch26 is not 32-bit aligned");
+
+      uint32_t RawInstr = *(ulittle32_t *)FixupPtr;
+      assert((RawInstr & 0x7c000000) == 0x14000000 &&
+             "RawInstr isn't a B or BL immediate instruction");
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+
+      if (Value & 0x3)
+        return make_error<JITLinkError>("Branch26 target is not 32-bit "
+                                        "aligned");
+
+      if (!isInt<28>(Value))
+        return targetOutOfRangeError(A, E);
+
+      uint32_t Imm = (static_cast<uint32_t>(Value) & ((1 << 28) - 1)) >> 2;
+      uint32_t FixedInstr = (RawInstr & 0xfc000000) | Imm;
+      *(ulittle32_t *)FixupPtr = FixedInstr;
+      break;
+    }
+    case Page21: {
+      assert(isADRP(*(ulittle32_t *)FixupPtr) &&
+             "RawInstr isn't an ADRP instruction");
+      uint64_t TargetPage =
+          (E.getTarget().getAddress() + E.getAddend()) &
+          ~static_cast<uint64_t>(4096 - 1);
+      uint64_t PCPage = FixupAddress & ~static_cast<uint64_t>(4096 - 1);
+
+      int64_t PageDelta = TargetPage - PCPage;
+      if (!isInt<33>(PageDelta))
+        return targetOutOfRangeError(A, E);
+
+      uint32_t RawInstr = *(ulittle32_t *)FixupPtr;
+      uint32_t ImmLo = (static_cast<uint64_t>(PageDelta) >> 12) & 0x3;
+      uint32_t ImmHi = (static_cast<uint64_t>(PageDelta) >> 14) & 0x7ffff;
+      uint32_t FixedInstr = (RawInstr & 0x9f00001f) | (ImmLo << 29) |
+                            (ImmHi << 5);
+      *(ulittle32_t *)FixupPtr = FixedInstr;
+      break;
+    }
+    case PageOffset12: {
+      uint64_t TargetOffset =
+          (E.getTarget().getAddress() + E.getAddend()) & 0xfff;
+
+      uint32_t RawInstr = *(ulittle32_t *)FixupPtr;
+      unsigned ImmShift =
+          isLoadStoreImm12(RawInstr) ? getPageOffset12Shift(RawInstr) : 0;
+
+      if (TargetOffset & ((1 << ImmShift) - 1))
+        return make_error<JITLinkError>("PageOffset12 target is not aligned "
+                                        "to the access size");
+
+      uint32_t EncodedImm = (TargetOffset >> ImmShift) << 10;
+      uint32_t FixedInstr = (RawInstr & 0xffc003ff) | EncodedImm;
+      *(ulittle32_t *)FixupPtr = FixedInstr;
+      break;
+    }
+    case Pointer64: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      *(ulittle64_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (!isUInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(ulittle32_t *)FixupPtr = Value;
+      break;
+    }
+    case PCRel32: {
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case Delta64: {
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      *(little64_t *)FixupPtr = Value;
+      break;
+    }
+    case NegDelta32: {
+      int64_t Value =
+          FixupAddress - E.getTarget().getAddress() + E.getAddend();
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    default:
+      llvm_unreachable("Unrecognized edge kind");
+    }
+
+    return Error::success();
+  }
+};
+
+void jitLink_ELF_aarch64(std::unique_ptr<JITLinkContext> Ctx) {
+  PassConfiguration Config;
+  Triple TT("aarch64-unknown-linux-gnu");
+
+  if (Ctx->shouldAddDefaultTargetPasses(TT)) {
+    // Add a mark-live pass.
+    if (auto MarkLive = Ctx->getMarkLivePass(TT))
+      Config.PrePrunePasses.push_back(std::move(MarkLive));
+    else
+      Config.PrePrunePasses.push_back(markAllAtomsLive);
+
+    // Add an in-place GOT/Stubs pass.
+    Config.PostPrunePasses.push_back([](AtomGraph &G) -> Error {
+      ELF_aarch64_GOTAndStubsBuilder(G).run();
+      return Error::success();
+    });
+  }
+
+  if (auto Err = Ctx->modifyPassConfig(TT, Config))
+    return Ctx->notifyFailed(std::move(Err));
+
+  // Construct a JITLinker and run the link function.
+  ELFJITLinker_aarch64::link(std::move(Ctx), std::move(Config));
+}
+
+StringRef getELFAArch64RelocationKindName(Edge::Kind R) {
+  switch (R) {
+  case Branch26:
+    return "Branch26";
+  case Pointer64:
+    return "Pointer64";
+  case Pointer32:
+    return "Pointer32";
+  case PCRel32:
+    return "PCRel32";
+  case Delta64:
+    return "Delta64";
+  case NegDelta32:
+    return "NegDelta32";
+  case Page21:
+    return "Page21";
+  case PageOffset12:
+    return "PageOffset12";
+  case GOTPage21:
+    return "GOTPage21";
+  case GOTPageOffset12:
+    return "GOTPageOffset12";
+  default:
+    return getGenericEdgeKindName(static_cast<Edge::Kind>(R));
+  }
+}
+
+} // end namespace jitlink
+} // end namespace llvm
@@ -0,0 +1,386 @@
+//===----- ELF_x86_64.cpp - JIT linker implementation for ELF/x86-64 ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// ELF/x86-64 jit-link implementation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/ELF_x86_64.h"
+
+#include "BasicGOTAndStubsBuilder.h"
+#include "ELFAtomGraphBuilder.h"
+
+#include "llvm/BinaryFormat/ELF.h"
+
+#define DEBUG_TYPE "jitlink"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_x86_64_Edges;
+
+namespace {
+
+class ELFAtomGraphBuilder_x86_64 : public ELFAtomGraphBuilder {
+public:
+  ELFAtomGraphBuilder_x86_64(const object::ELFObjectFileBase &Obj)
+      : ELFAtomGraphBuilder(Obj, NegDelta32) {}
+
+private:
+  Error addRelocation(DefinedAtom &AtomToFix, JITTargetAddress FixupAddress,
+                      uint32_t Type, Atom &Target, int64_t Addend) override {
+    ELFX86RelocationKind Kind;
+    uint64_t FixupSize = 4;
+    switch (Type) {
+    case ELF::R_X86_64_64:
+      Kind = Pointer64;
+      FixupSize = 8;
+      break;
+    case ELF::R_X86_64_32:
+      Kind = Pointer32;
+      break;
+    case ELF::R_X86_64_32S:
+      Kind = Pointer32Signed;
+      break;
+    case ELF::R_X86_64_PC32:
+      Kind = PCRel32;
+      break;
+    case ELF::R_X86_64_PC64:
+      Kind = Delta64;
+      FixupSize = 8;
+      break;
+    case ELF::R_X86_64_PLT32:
+      Kind = Branch32;
+      break;
+    case ELF::R_X86_64_GOTPCREL:
+      Kind = PCRel32GOT;
+      break;
+    case ELF::R_X86_64_GOTPCRELX:
+    case ELF::R_X86_64_REX_GOTPCRELX:
+      Kind = PCRel32GOTLoad;
+      break;
+    default:
+      return unsupportedRelocation(Type, AtomToFix);
+    }
+
+    Edge::OffsetT Offset = FixupAddress - AtomToFix.getAddress();
+    if (Offset + FixupSize > AtomToFix.getSize())
+      return make_error<JITLinkError>(
+          "Relocation content extends past end of fixup atom");
+
+    // GOT entries are shared by name.
+    if ((Kind == PCRel32GOT || Kind == PCRel32GOTLoad) && !Target.hasName())
+      return make_error<JITLinkError>(
+          "GOT relocation against a local symbol in " +
+          AtomToFix.getSection().getName() + " is not supported");
+
+    LLVM_DEBUG({
+      Edge GE(Kind, Offset, Target, Addend);
+      printEdge(dbgs(), AtomToFix, GE, getELFX86RelocationKindName(Kind));
+      dbgs() << "\n";
+    });
+    AtomToFix.addEdge(Kind, Offset, Target, Addend);
+    return Error::success();
+  }
+};
+
+class ELF_x86_64_GOTAndStubsBuilder
+    : public BasicGOTAndStubsBuilder<ELF_x86_64_GOTAndStubsBuilder> {
+public:
+  ELF_x86_64_GOTAndStubsBuilder(AtomGraph &G)
+      : BasicGOTAndStubsBuilder<ELF_x86_64_GOTAndStubsBuilder>(G) {}
+
+  bool isGOTEdge(Edge &E) const {
+    return E.getKind() == PCRel32GOT || E.getKind() == PCRel32GOTLoad;
+  }
+
+  DefinedAtom &createGOTEntry(Atom &Target) {
+    auto &GOTEntryAtom = G.addAnonymousAtom(getGOTSection(), 0x0, 8);
+    GOTEntryAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(NullGOTEntryContent), 8));
+    GOTEntryAtom.addEdge(Pointer64, 0, Target, 0);
+    return GOTEntryAtom;
+  }
+
+  void fixGOTEdge(Edge &E, Atom &GOTEntry) {
+    assert((E.getKind() == PCRel32GOT || E.getKind() == PCRel32GOTLoad) &&
+           "Not a GOT edge?");
+    // Loads marked as relaxable may be rewritten into direct references
+    // when fixing up.
+    E.setKind(E.getKind() == PCRel32GOTLoad ? PCRel32GOTLoadRelaxable
+                                            : PCRel32);
+    E.setTarget(GOTEntry);
+    // Leave the edge addend as-is.
+  }
+
+  bool isExternalBranchEdge(Edge &E) {
+    return E.getKind() == Branch32 && !E.getTarget().isDefined();
+  }
+
+  DefinedAtom &createStub(Atom &Target) {
+    auto &StubAtom = G.addAnonymousAtom(getStubsSection(), 0x0, 2);
+    StubAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(StubContent), 6));
+
+    // Re-use GOT entries for stub targets.
+    auto &GOTEntryAtom = getGOTEntryAtom(Target);
+    StubAtom.addEdge(PCRel32, 2, GOTEntryAtom, -4);
+
+    return StubAtom;
+  }
+
+  void fixExternalBranchEdge(Edge &E, Atom &Stub) {
+    assert(E.getKind() == Branch32 && "Not a Branch32 edge?");
+    E.setKind(Branch32ToStub);
+    E.setTarget(Stub);
+  }
+
+private:
+  Section &getGOTSection() {
+    if (!GOTSection)
+      GOTSection = &G.createSection("$__GOT", 8, sys::Memory::MF_READ, false);
+    return *GOTSection;
+  }
+
+  Section &getStubsSection() {
+    if (!StubsSection) {
+      auto StubsProt = static_cast<sys::Memory::ProtectionFlags>(
+          sys::Memory::MF_READ | sys::Memory::MF_EXEC);
+      StubsSection = &G.createSection("$__STUBS", 8, StubsProt, false);
+    }
+    return *StubsSection;
+  }
+
+  static const uint8_t NullGOTEntryContent[8];
+  static const uint8_t StubContent[6];
+  Section *GOTSection = nullptr;
+  Section *StubsSection = nullptr;
+};
+
+const uint8_t ELF_x86_64_GOTAndStubsBuilder::NullGOTEntryContent[8] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const uint8_t ELF_x86_64_GOTAndStubsBuilder::StubContent[6] = {
+    0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+} // namespace
+
+namespace llvm {
+namespace jitlink {
+
+class ELFJITLinker_x86_64 : public JITLinker<ELFJITLinker_x86_64> {
+  friend class JITLinker<ELFJITLinker_x86_64>;
+
+public:
+  ELFJITLinker_x86_64(std::unique_ptr<JITLinkContext> Ctx,
+                      PassConfiguration PassConfig)
+      : JITLinker(std::move(Ctx), std::move(PassConfig)) {}
+
+private:
+  StringRef getEdgeKindName(Edge::Kind R) const override {
+    return getELFX86RelocationKindName(R);
+  }
+
+  Expected<std::unique_ptr<AtomGraph>>
+  buildGraph(MemoryBufferRef ObjBuffer) override {
+    auto ELFObj = object::ObjectFile::createELFObjectFile(ObjBuffer);
+    if (!ELFObj)
+      return ELFObj.takeError();
+    return ELFAtomGraphBuilder_x86_64(
+               cast<object::ELFObjectFileBase>(**ELFObj))
+        .buildGraph();
+  }
+
+  static Error targetOutOfRangeError(const Atom &A, const Edge &E) {
+    std::string ErrMsg;
+    {
+      raw_string_ostream ErrStream(ErrMsg);
+      ErrStream << "Relocation target out of range: ";
+      printEdge(ErrStream, A, E, getELFX86RelocationKindName(E.getKind()));
+      ErrStream << "\n";
+    }
+    return make_error<JITLinkError>(std::move(ErrMsg));
+  }
+
+  // Returns the address that the given GOT entry holds.
+  static JITTargetAddress getGOTEntryTarget(Atom &GOTEntry) {
+    auto &E = *static_cast<DefinedAtom &>(GOTEntry).edges().begin();
+    assert(E.getKind() == Pointer64 && "GOT entry should hold a pointer");
+    return E.getTarget().getAddress() + E.getAddend();
+  }
+
+  // Rewrites a GOT load into an equivalent instruction that refers to the
+  // target directly, as described by the x86-64 psABI. Returns false if the
+  // instruction can not be relaxed.
+  static bool relaxGOTLoad(const Edge &E, char *FixupPtr, int64_t Value) {
+    using namespace support;
+
+    if (E.getOffset() < 2 || E.getAddend() != -4 || !isInt<32>(Value))
+      return false;
+
+    uint8_t Op = FixupPtr[-2];
+    uint8_t ModRM = FixupPtr[-1];
+    if (Op == 0x8b) {
+      // mov foo@GOTPCREL(%rip), %reg -> lea foo(%rip), %reg
+      FixupPtr[-2] = static_cast<char>(0x8d);
+      *(little32_t *)FixupPtr = Value;
+      return true;
+    }
+    if (Op == 0xff && ModRM == 0x15) {
+      // call *foo@GOTPCREL(%rip) -> addr32 call foo
+      FixupPtr[-2] = static_cast<char>(0x67);
+      FixupPtr[-1] = static_cast<char>(0xe8);
+      *(little32_t *)FixupPtr = Value;
+      return true;
+    }
+    if (Op == 0xff && ModRM == 0x25) {
+      // jmp *foo@GOTPCREL(%rip) -> jmp foo; nop
+      // The jump ends one byte before the original instruction does.
+      FixupPtr[-2] = static_cast<char>(0xe9);
+      *(little32_t *)(FixupPtr - 1) = Value + 1;
+      FixupPtr[3] = static_cast<char>(0x90);
+      return true;
+    }
+    return false;
+  }
+
+  Error applyFixup(DefinedAtom &A, const Edge &E, char *AtomWorkingMem) const {
+    using namespace support;
+
+    char *FixupPtr = AtomWorkingMem + E.getOffset();
+    JITTargetAddress FixupAddress = A.getAddress() + E.getOffset();
+
+    switch (E.getKind()) {
+    case Branch32:
+    case PCRel32: {
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case Branch32ToStub: {
+      // Call the final target directly if it is in range, bypassing the
+      // stub.
+      auto &Stub = static_cast<DefinedAtom &>(E.getTarget());
+      int64_t Value = getGOTEntryTarget(Stub.edges().begin()->getTarget()) +
+                      E.getAddend() - FixupAddress;
+      if (!isInt<32>(Value))
+        Value = Stub.getAddress() + E.getAddend() - FixupAddress;
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case PCRel32GOTLoadRelaxable: {
+      int64_t Direct =
+          getGOTEntryTarget(E.getTarget()) + E.getAddend() - FixupAddress;
+      if (relaxGOTLoad(E, FixupPtr, Direct))
+        break;
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer64: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      *(ulittle64_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (!isUInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(ulittle32_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32Signed: {
+      int64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case Delta64: {
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      *(little64_t *)FixupPtr = Value;
+      break;
+    }
+    case NegDelta32: {
+      int64_t Value =
+          FixupAddress - E.getTarget().getAddress() + E.getAddend();
+      if (!isInt<32>(Value))
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    default:
+      llvm_unreachable("Unrecognized edge kind");
+    }
+
+    return Error::success();
+  }
+};
+
+void jitLink_ELF_x86_64(std::unique_ptr<JITLinkContext> Ctx) {
+  PassConfiguration Config;
+  Triple TT("x86_64-unknown-linux-gnu");
+
+  if (Ctx->shouldAddDefaultTargetPasses(TT)) {
+    // Add a mark-live pass.
+    if (auto MarkLive = Ctx->getMarkLivePass(TT))
+      Config.PrePrunePasses.push_back(std::move(MarkLive));
+    else
+      Config.PrePrunePasses.push_back(markAllAtomsLive);
+
+    // Add an in-place GOT/Stubs pass.
+    Config.PostPrunePasses.push_back([](AtomGraph &G) -> Error {
+      ELF_x86_64_GOTAndStubsBuilder(G).run();
+      return Error::success();
+    });
+  }
+
+  if (auto Err = Ctx->modifyPassConfig(TT, Config))
+    return Ctx->notifyFailed(std::move(Err));
+
+  // Construct a JITLinker and run the link function.
+  ELFJITLinker_x86_64::link(std::move(Ctx), std::move(Config));
+}
+
+StringRef getELFX86RelocationKindName(Edge::Kind R) {
+  switch (R) {
+  case Branch32:
+    return "Branch32";
+  case Branch32ToStub:
+    return "Branch32ToStub";
+  case Pointer64:
+    return "Pointer64";
+  case Pointer32:
+    return "Pointer32";
+  case Pointer32Signed:
+    return "Pointer32Signed";
+  case PCRel32:
+    return "PCRel32";
+  case PCRel32GOT:
+    return "PCRel32GOT";
+  case PCRel32GOTLoad:
+    return "PCRel32GOTLoad";
+  case PCRel32GOTLoadRelaxable:
+    return "PCRel32GOTLoadRelaxable";
+  case Delta64:
+    return "Delta64";
+  case NegDelta32:
+    return "NegDelta32";
+  default:
+    return getGenericEdgeKindName(static_cast<Edge::Kind>(R));
+  }
+}
+
+} // end namespace jitlink
+} // end namespace llvm
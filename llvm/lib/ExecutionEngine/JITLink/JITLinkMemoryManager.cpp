@@ -16,11 +16,46 @@ namespace jitlink {
 JITLinkMemoryManager::~JITLinkMemoryManager() = default;
 JITLinkMemoryManager::Allocation::~Allocation() = default;
 
+namespace {
+
+using AllocationMap = DenseMap<unsigned, sys::MemoryBlock>;
+
+const sys::Memory::ProtectionFlags ReadWrite =
+    static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                              sys::Memory::MF_WRITE);
+
+Error checkSegmentAlignment(const JITLinkMemoryManager::SegmentRequest &Seg) {
+  if (Seg.getContentAlignment() > sys::Process::getPageSizeEstimate())
+    return make_error<StringError>("Cannot request higher than page "
+                                   "alignment",
+                                   inconvertibleErrorCode());
+
+  if (sys::Process::getPageSizeEstimate() % Seg.getContentAlignment() != 0)
+    return make_error<StringError>("Page size is not a multiple of "
+                                   "alignment",
+                                   inconvertibleErrorCode());
+
+  return Error::success();
+}
+
+Error applyProtections(AllocationMap &SegBlocks) {
+  for (auto &KV : SegBlocks) {
+    auto &Prot = KV.first;
+    auto &Block = KV.second;
+    if (auto EC = sys::Memory::protectMappedMemory(Block, Prot))
+      return errorCodeToError(EC);
+    if (Prot & sys::Memory::MF_EXEC)
+      sys::Memory::InvalidateInstructionCache(Block.base(),
+                                              Block.allocatedSize());
+  }
+  return Error::success();
+}
+
+} // end anonymous namespace
+
 Expected<std::unique_ptr<JITLinkMemoryManager::Allocation>>
 InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
 
-  using AllocationMap = DenseMap<unsigned, sys::MemoryBlock>;
-
   // Local class for allocation.
   class IPMMAlloc : public Allocation {
   public:
@@ -35,7 +70,7 @@ InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
       return reinterpret_cast<JITTargetAddress>(SegBlocks[Seg].base());
     }
     void finalizeAsync(FinalizeContinuation OnFinalize) override {
-      OnFinalize(applyProtections());
+      OnFinalize(applyProtections(SegBlocks));
     }
     Error deallocate() override {
       for (auto &KV : SegBlocks)
@@ -45,39 +80,16 @@ InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
     }
 
   private:
-    Error applyProtections() {
-      for (auto &KV : SegBlocks) {
-        auto &Prot = KV.first;
-        auto &Block = KV.second;
-        if (auto EC = sys::Memory::protectMappedMemory(Block, Prot))
-          return errorCodeToError(EC);
-        if (Prot & sys::Memory::MF_EXEC)
-          sys::Memory::InvalidateInstructionCache(Block.base(),
-                                                  Block.allocatedSize());
-      }
-      return Error::success();
-    }
-
     AllocationMap SegBlocks;
   };
 
   AllocationMap Blocks;
-  const sys::Memory::ProtectionFlags ReadWrite =
-      static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
-                                                sys::Memory::MF_WRITE);
 
   for (auto &KV : Request) {
     auto &Seg = KV.second;
 
-    if (Seg.getContentAlignment() > sys::Process::getPageSizeEstimate())
-      return make_error<StringError>("Cannot request higher than page "
-                                     "alignment",
-                                     inconvertibleErrorCode());
-
-    if (sys::Process::getPageSizeEstimate() % Seg.getContentAlignment() != 0)
-      return make_error<StringError>("Page size is not a multiple of "
-                                     "alignment",
-                                     inconvertibleErrorCode());
+    if (auto Err = checkSegmentAlignment(Seg))
+      return std::move(Err);
 
     uint64_t ZeroFillStart =
         alignTo(Seg.getContentSize(), Seg.getZeroFillAlignment());
@@ -101,5 +113,169 @@ InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
       new IPMMAlloc(std::move(Blocks)));
 }
 
+class InProcessSlabMemoryManager::SlabAllocation : public Allocation {
+public:
+  SlabAllocation(InProcessSlabMemoryManager &MemMgr, AllocationMap SegBlocks)
+      : MemMgr(MemMgr), SegBlocks(std::move(SegBlocks)) {}
+  MutableArrayRef<char> getWorkingMemory(ProtectionFlags Seg) override {
+    assert(SegBlocks.count(Seg) && "No allocation for segment");
+    return {static_cast<char *>(SegBlocks[Seg].base()),
+            SegBlocks[Seg].allocatedSize()};
+  }
+  JITTargetAddress getTargetMemory(ProtectionFlags Seg) override {
+    assert(SegBlocks.count(Seg) && "No allocation for segment");
+    return reinterpret_cast<JITTargetAddress>(SegBlocks[Seg].base());
+  }
+  void finalizeAsync(FinalizeContinuation OnFinalize) override {
+    OnFinalize(applyProtections(SegBlocks));
+  }
+  Error deallocate() override {
+    Error Err = Error::success();
+    for (auto &KV : SegBlocks)
+      Err = joinErrors(std::move(Err),
+                       MemMgr.releaseSegment(KV.first, KV.second));
+    SegBlocks.clear();
+    return Err;
+  }
+
+private:
+  InProcessSlabMemoryManager &MemMgr;
+  AllocationMap SegBlocks;
+};
+
+InProcessSlabMemoryManager::InProcessSlabMemoryManager(uint64_t SlabSize,
+                                                       bool UseHugePages)
+    : SlabSize(alignTo(SlabSize, sys::Process::getPageSizeEstimate())),
+      UseHugePages(UseHugePages) {}
+
+InProcessSlabMemoryManager::~InProcessSlabMemoryManager() {
+  for (auto &KV : Pools)
+    for (auto &Slab : KV.second.Slabs)
+      sys::Memory::releaseMappedMemory(Slab);
+}
+
+Expected<std::unique_ptr<JITLinkMemoryManager::Allocation>>
+InProcessSlabMemoryManager::allocate(const SegmentsRequestMap &Request) {
+  AllocationMap Blocks;
+  auto ReleaseBlocks = [&]() {
+    for (auto &KV : Blocks)
+      consumeError(releaseSegment(KV.first, KV.second));
+  };
+
+  for (auto &KV : Request) {
+    auto &Seg = KV.second;
+
+    if (auto Err = checkSegmentAlignment(Seg)) {
+      ReleaseBlocks();
+      return std::move(Err);
+    }
+
+    uint64_t ZeroFillStart =
+        alignTo(Seg.getContentSize(), Seg.getZeroFillAlignment());
+    uint64_t SegmentSize = ZeroFillStart + Seg.getZeroFillSize();
+    if (SegmentSize == 0) {
+      Blocks[KV.first] = sys::MemoryBlock();
+      continue;
+    }
+
+    auto SegMem = allocateSegment(KV.first, SegmentSize);
+    if (!SegMem) {
+      ReleaseBlocks();
+      return SegMem.takeError();
+    }
+
+    // Reused memory holds the previous segment's bytes, so clear all of it
+    // rather than just the zero-fill memory.
+    memset(SegMem->base(), 0, SegMem->allocatedSize());
+
+    Blocks[KV.first] = *SegMem;
+  }
+  return std::unique_ptr<InProcessSlabMemoryManager::Allocation>(
+      new SlabAllocation(*this, std::move(Blocks)));
+}
+
+Expected<sys::MemoryBlock>
+InProcessSlabMemoryManager::allocateSegment(unsigned Prot, uint64_t Size) {
+  Size = alignTo(Size, sys::Process::getPageSizeEstimate());
+
+  std::lock_guard<std::mutex> Lock(PoolsMutex);
+  std::error_code EC;
+  const sys::MemoryBlock *NearBlock = LastSlab.base() ? &LastSlab : nullptr;
+
+  // Segments that don't fit in a slab get a mapping of their own.
+  if (Size > SlabSize) {
+    auto Block =
+        sys::Memory::allocateMappedMemory(Size, NearBlock, ReadWrite, EC);
+    if (EC)
+      return errorCodeToError(EC);
+    return Block;
+  }
+
+  auto &P = Pools[Prot];
+  for (auto I = P.FreeRanges.begin(), E = P.FreeRanges.end(); I != E; ++I) {
+    if (I->second < Size)
+      continue;
+    char *Start = I->first;
+    uint64_t Remaining = I->second - Size;
+    P.FreeRanges.erase(I);
+    if (Remaining)
+      P.FreeRanges[Start + Size] = Remaining;
+    return sys::MemoryBlock(Start, Size);
+  }
+
+  // Allocate slabs near each other, so that code and data stay in range of
+  // the PC-relative references between them.
+  unsigned Flags = ReadWrite;
+  if (UseHugePages)
+    Flags |= sys::Memory::MF_HUGE_HINT;
+  auto Slab = sys::Memory::allocateMappedMemory(SlabSize, NearBlock, Flags, EC);
+  if (EC)
+    return errorCodeToError(EC);
+
+  P.Slabs.push_back(Slab);
+  LastSlab = Slab;
+  char *Start = static_cast<char *>(Slab.base());
+  if (Slab.allocatedSize() > Size)
+    P.FreeRanges[Start + Size] = Slab.allocatedSize() - Size;
+  return sys::MemoryBlock(Start, Size);
+}
+
+Error InProcessSlabMemoryManager::releaseSegment(unsigned Prot,
+                                                 sys::MemoryBlock Block) {
+  if (Block.allocatedSize() == 0)
+    return Error::success();
+
+  if (Block.allocatedSize() > SlabSize) {
+    if (auto EC = sys::Memory::releaseMappedMemory(Block))
+      return errorCodeToError(EC);
+    return Error::success();
+  }
+
+  // Free ranges are kept writable for the allocations that reuse them.
+  if (auto EC = sys::Memory::protectMappedMemory(Block, ReadWrite))
+    return errorCodeToError(EC);
+
+  std::lock_guard<std::mutex> Lock(PoolsMutex);
+  auto &FreeRanges = Pools[Prot].FreeRanges;
+  char *Start = static_cast<char *>(Block.base());
+  uint64_t Size = Block.allocatedSize();
+
+  // Merge the range with its free neighbours.
+  auto Next = FreeRanges.lower_bound(Start);
+  if (Next != FreeRanges.end() && Next->first == Start + Size) {
+    Size += Next->second;
+    Next = FreeRanges.erase(Next);
+  }
+  if (Next != FreeRanges.begin()) {
+    auto Prev = std::prev(Next);
+    if (Prev->first + Prev->second == Start) {
+      Prev->second += Size;
+      return Error::success();
+    }
+  }
+  FreeRanges[Start] = Size;
+  return Error::success();
+}
+
 } // end namespace jitlink
 } // end namespace llvm
@@ -160,9 +160,19 @@ Error LLLazyJITBuilderState::prepareForConstruction() {
   if (auto Err = LLJITBuilderState::prepareForConstruction())
     return Err;
   TT = JTMB->getTargetTriple();
+  if (SpeculativeCompilation && NumCompileThreads == 0)
+    return make_error<StringError>(
+        "Speculative compilation requires at least one compile thread",
+        inconvertibleErrorCode());
   return Error::success();
 }
 
+LLLazyJIT::~LLLazyJIT() {
+  // Speculative compiles may still be using the layers.
+  if (CompileThreads)
+    CompileThreads->wait();
+}
+
 Error LLLazyJIT::addLazyIRModule(JITDylib &JD, ThreadSafeModule TSM) {
   assert(TSM && "Can not add null module");
 
@@ -214,9 +224,23 @@ LLLazyJIT::LLLazyJIT(LLLazyJITBuilderState &S, Error &Err) : LLJIT(S, Err) {
   // Create the transform layer.
   TransformLayer = llvm::make_unique<IRTransformLayer>(*ES, *CompileLayer);
 
+  // Create the speculation layer, which sees each function before it is
+  // transformed and compiled.
+  IRLayer *CODBaseLayer = TransformLayer.get();
+  if (S.SpeculativeCompilation) {
+    Spec = llvm::make_unique<Speculator>(*ES);
+    SpeculationLayer = llvm::make_unique<IRSpeculationLayer>(
+        *ES, *TransformLayer, *Spec);
+    CODBaseLayer = SpeculationLayer.get();
+    LCTMgr->setNotifyCallThrough(
+        [this](JITDylib &JD, const SymbolStringPtr &Name) {
+          Spec->recordCall(JD, Name);
+        });
+  }
+
   // Create the COD layer.
   CODLayer = llvm::make_unique<CompileOnDemandLayer>(
-      *ES, *TransformLayer, *LCTMgr, std::move(ISMBuilder));
+      *ES, *CODBaseLayer, *LCTMgr, std::move(ISMBuilder));
 
   if (S.NumCompileThreads > 0)
     CODLayer->setCloneToNewContextOnEmit(true);
@@ -0,0 +1,147 @@
+//===---------- Speculation.cpp - Speculative compilation of callees ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/InstrTypes.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+void Speculator::speculateCallees(JITDylib &JD, const SymbolStringPtr &Caller,
+                                  SymbolNameSet Callees) {
+  // Only look up the callees that JD defines. The others, e.g. functions in
+  // the host process, either need no compilation or will be compiled through
+  // their own JITDylib.
+  auto FlagsOrErr = JD.lookupFlags(Callees);
+  if (!FlagsOrErr) {
+    ES.reportError(FlagsOrErr.takeError());
+    return;
+  }
+
+  SymbolNameSet ToLookup;
+  {
+    std::lock_guard<std::mutex> Lock(SpeculatorMutex);
+    auto &State = Dylibs[&JD];
+    unsigned CallerDepth =
+        State.Depths.insert(std::make_pair(Caller, 0)).first->second;
+    if (CallerDepth >= MaxDepth)
+      return;
+    for (auto &KV : *FlagsOrErr)
+      if (KV.second.isCallable() &&
+          State.Depths.insert(std::make_pair(KV.first, CallerDepth + 1))
+              .second)
+        ToLookup.insert(KV.first);
+    Stats.Speculated += ToLookup.size();
+  }
+  if (ToLookup.empty())
+    return;
+
+  LLVM_DEBUG({
+    dbgs() << "Speculating for " << *Caller << " in " << JD.getName() << ": "
+           << ToLookup << "\n";
+  });
+
+  // We only want the callees to be compiled: Nothing waits for the result,
+  // and a failure will be reported again if the callee is really called.
+  ES.lookup(JITDylibSearchList({{&JD, true}}), std::move(ToLookup),
+            SymbolState::Ready,
+            [](Expected<SymbolMap> Result) {
+              if (!Result)
+                consumeError(Result.takeError());
+            },
+            NoDependenciesToRegister);
+}
+
+void Speculator::recordCall(JITDylib &JD, const SymbolStringPtr &Name) {
+  std::lock_guard<std::mutex> Lock(SpeculatorMutex);
+  auto &State = Dylibs[&JD];
+  if (!State.Called.insert(Name).second)
+    return;
+
+  auto I = State.Depths.find(Name);
+  if (I != State.Depths.end() && I->second != 0)
+    ++Stats.Hits;
+  else
+    ++Stats.Misses;
+  State.Depths[Name] = 0;
+}
+
+Speculator::Statistics Speculator::getStatistics() const {
+  std::lock_guard<std::mutex> Lock(SpeculatorMutex);
+  return Stats;
+}
+
+void Speculator::printStatistics(raw_ostream &OS) const {
+  Statistics S = getStatistics();
+  uint64_t Calls = S.Hits + S.Misses;
+  OS << "Speculated functions: " << S.Speculated << "\n"
+     << "First calls to speculated functions: " << S.Hits << "\n"
+     << "First calls to other functions: " << S.Misses << "\n"
+     << "Hit rate: "
+     << format("%.1f%%", Calls ? 100.0 * S.Hits / Calls : 0.0) << "\n";
+}
+
+void IRSpeculationLayer::emit(MaterializationResponsibility R,
+                              ThreadSafeModule TSM) {
+  assert(TSM.getModule() && "Module must not be null");
+
+  {
+    auto Lock = TSM.getContextLock();
+    Module &M = *TSM.getModule();
+    MangleAndInterner Mangle(getExecutionSession(), M.getDataLayout());
+    for (auto &F : M) {
+      if (F.isDeclaration())
+        continue;
+      SymbolNameSet Callees = getLikelyCallees(F, Mangle);
+      if (!Callees.empty())
+        S.speculateCallees(R.getTargetJITDylib(), Mangle(F.getName()),
+                           std::move(Callees));
+    }
+  }
+
+  BaseLayer.emit(std::move(R), std::move(TSM));
+}
+
+SymbolNameSet IRSpeculationLayer::getLikelyCallees(Function &F,
+                                                   MangleAndInterner &Mangle) {
+  DominatorTree DT(F);
+  LoopInfo LI(DT);
+  BranchProbabilityInfo BPI(F, LI);
+  BlockFrequencyInfo BFI(F, BPI, LI);
+  double MinFreq = BFI.getEntryFreq() * MinLikelihood;
+
+  SymbolNameSet Callees;
+  for (auto &BB : F) {
+    if (BFI.getBlockFreq(&BB).getFrequency() < MinFreq)
+      continue;
+    for (auto &I : BB) {
+      auto *Call = dyn_cast<CallBase>(&I);
+      if (!Call)
+        continue;
+      auto *Callee =
+          dyn_cast<Function>(Call->getCalledValue()->stripPointerCasts());
+      if (!Callee || Callee == &F || Callee->isIntrinsic() ||
+          !Callee->hasName())
+        continue;
+      Callees.insert(Mangle(Callee->getName()));
+    }
+  }
+  return Callees;
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -114,6 +114,8 @@ formatToSerializer(remarks::Format RemarksFormat, raw_ostream &OS) {
     return nullptr;
   case remarks::Format::YAML:
     return llvm::make_unique<remarks::YAMLSerializer>(OS);
+  case remarks::Format::Bitstream:
+    return llvm::make_unique<remarks::BitstreamSerializer>(OS);
   };
 }
 
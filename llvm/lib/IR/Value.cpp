@@ -408,6 +408,21 @@ void Value::doRAUW(Value *New, ReplaceMetadataUses ReplaceMetaUses) {
   if (ReplaceMetaUses == ReplaceMetadataUses::Yes && isUsedByMetadata())
     ValueAsMetadata::handleRAUW(this, New);
 
+  // Instructions and arguments can only be used by instructions, so their
+  // uses can be moved to New without finding each user, which means walking
+  // the waymarks of its operands. Each use is pushed to the front of New's
+  // use list, which keeps the same use-list order as Use::set() would.
+  if (isa<Instruction>(this) || isa<Argument>(this)) {
+    Use *U = UseList;
+    UseList = nullptr;
+    while (U) {
+      Use *Next = U->Next;
+      U->Val = New;
+      U->addToList(&New->UseList);
+      U = Next;
+    }
+  }
+
   while (!materialized_use_empty()) {
     Use &U = *UseList;
     // Must handle Constants specially, we cannot call replaceUsesOfWith on a
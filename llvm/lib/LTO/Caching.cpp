@@ -11,12 +11,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/LTO/Caching.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Errc.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/Program.h"
 #include "llvm/Support/raw_ostream.h"
+#include <mutex>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -148,3 +152,128 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
     };
   };
 }
+
+namespace {
+class CommandRemoteCache : public RemoteCache {
+public:
+  CommandRemoteCache(std::string Program) : Program(std::move(Program)) {}
+
+  Expected<std::unique_ptr<MemoryBuffer>> fetch(StringRef Key) override {
+    SmallString<128> Path;
+    if (std::error_code EC =
+            sys::fs::createTemporaryFile("thinlto-remote", "o", Path))
+      return errorCodeToError(EC);
+    FileRemover Remover(Path);
+    if (!run("get", Key, Path))
+      return nullptr;
+
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                              /*RequiresNullTerminator=*/false);
+    if (!MBOrErr)
+      return errorCodeToError(MBOrErr.getError());
+    if ((*MBOrErr)->getBufferSize() == 0)
+      return nullptr;
+    return std::move(*MBOrErr);
+  }
+
+  Error publish(StringRef Key, MemoryBufferRef Object) override {
+    SmallString<128> Path;
+    int FD;
+    if (std::error_code EC =
+            sys::fs::createTemporaryFile("thinlto-remote", "o", FD, Path))
+      return errorCodeToError(EC);
+    FileRemover Remover(Path);
+    {
+      raw_fd_ostream OS(FD, /*shouldClose=*/true);
+      OS << Object.getBuffer();
+      OS.close();
+      if (OS.has_error()) {
+        std::error_code EC = OS.error();
+        OS.clear_error();
+        return errorCodeToError(EC);
+      }
+    }
+    if (!run("put", Key, Path))
+      return make_error<StringError>(Program + " failed to publish " + Key,
+                                     inconvertibleErrorCode());
+    return Error::success();
+  }
+
+private:
+  bool run(StringRef Command, StringRef Key, StringRef Path) {
+    StringRef Args[] = {Program, Command, Key, Path};
+    return sys::ExecuteAndWait(Program, Args) == 0;
+  }
+
+  std::string Program;
+};
+} // namespace
+
+Expected<std::unique_ptr<RemoteCache>>
+lto::commandRemoteCache(StringRef Program) {
+  ErrorOr<std::string> PathOrErr = sys::findProgramByName(Program);
+  if (!PathOrErr)
+    return make_error<StringError>(
+        "cannot find remote cache program " + Program, PathOrErr.getError());
+  return llvm::make_unique<CommandRemoteCache>(std::move(*PathOrErr));
+}
+
+Expected<NativeObjectCache>
+lto::localCacheWithRemote(StringRef CacheDirectoryPath,
+                          std::shared_ptr<RemoteCache> Remote,
+                          AddBufferFn AddBuffer) {
+  // The keys of the objects that are being built, by task. They are
+  // published when the local cache adds them to the link.
+  struct PendingKeys {
+    std::mutex Mutex;
+    DenseMap<unsigned, std::string> Keys;
+  };
+  auto Pending = std::make_shared<PendingKeys>();
+
+  Expected<NativeObjectCache> LocalOrErr = localCache(
+      CacheDirectoryPath,
+      [=](unsigned Task, std::unique_ptr<MemoryBuffer> MB) {
+        std::string Key;
+        {
+          std::lock_guard<std::mutex> Lock(Pending->Mutex);
+          auto I = Pending->Keys.find(Task);
+          if (I != Pending->Keys.end()) {
+            Key = std::move(I->second);
+            Pending->Keys.erase(I);
+          }
+        }
+        if (!Key.empty())
+          consumeError(Remote->publish(Key, *MB));
+        AddBuffer(Task, std::move(MB));
+      });
+  if (!LocalOrErr)
+    return LocalOrErr.takeError();
+  NativeObjectCache Local = std::move(*LocalOrErr);
+
+  return [=](unsigned Task, StringRef Key) -> AddStreamFn {
+    AddStreamFn AddStream = Local(Task, Key);
+    if (!AddStream)
+      return AddStream;
+
+    // On a remote hit, write the object to the local cache, which also adds
+    // it to the link.
+    Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Remote->fetch(Key);
+    if (!MBOrErr)
+      consumeError(MBOrErr.takeError());
+    else if (*MBOrErr) {
+      std::unique_ptr<NativeObjectStream> Stream = AddStream(Task);
+      *Stream->OS << (*MBOrErr)->getBuffer();
+      return AddStreamFn();
+    }
+
+    std::string KeyStr = Key;
+    return [=](size_t Task) {
+      {
+        std::lock_guard<std::mutex> Lock(Pending->Mutex);
+        Pending->Keys[Task] = KeyStr;
+      }
+      return AddStream(Task);
+    };
+  };
+}
@@ -29,6 +29,7 @@
 #include "llvm/LTO/SummaryBasedOptimizations.h"
 #include "llvm/Linker/IRMover.h"
 #include "llvm/Object/IRObjectFile.h"
+#include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -37,6 +38,7 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/VCSRevision.h"
 #include "llvm/Support/raw_ostream.h"
@@ -1025,6 +1027,10 @@ public:
       const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
       MapVector<StringRef, BitcodeModule> &ModuleMap) = 0;
   virtual Error wait() = 0;
+
+  /// Returns true if the output depends on the order in which the modules
+  /// are started. Otherwise the most expensive ones are started first.
+  virtual bool isSensitiveToInputOrder() { return false; }
 };
 
 namespace {
@@ -1111,6 +1117,8 @@ public:
                 &ResolvedODR,
             const GVSummaryMapTy &DefinedGlobals,
             MapVector<StringRef, BitcodeModule> &ModuleMap) {
+          timeTraceProfilerAttachThread();
+          TimeTraceScope TimeScope("ThinLTO backend", BM.getModuleIdentifier());
           Error E = runThinLTOBackendThread(
               AddStream, Cache, Task, BM, CombinedIndex, ImportList, ExportList,
               ResolvedODR, DefinedGlobals, ModuleMap);
@@ -1222,6 +1230,9 @@ public:
   }
 
   Error wait() override { return Error::success(); }
+
+  // The linked objects file lists the modules in the order they are started.
+  bool isSensitiveToInputOrder() override { return true; }
 };
 } // end anonymous namespace
 
@@ -1237,6 +1248,24 @@ ThinBackend lto::createWriteIndexesThinBackend(
   };
 }
 
+/// Returns an estimate of the time taken by the backend of a module: the size
+/// of the functions it defines and of the functions it imports.
+static uint64_t
+getThinBackendCost(const ModuleSummaryIndex &Index,
+                   const GVSummaryMapTy &DefinedGlobals,
+                   const FunctionImporter::ImportMapTy &ImportList) {
+  uint64_t Cost = 0;
+  for (auto &Def : DefinedGlobals)
+    if (auto *FS = dyn_cast<FunctionSummary>(Def.second))
+      Cost += FS->instCount();
+  for (auto &Src : ImportList)
+    for (GlobalValue::GUID GUID : Src.second)
+      if (GlobalValueSummary *S = Index.findSummaryInModule(GUID, Src.first()))
+        if (auto *FS = dyn_cast<FunctionSummary>(S->getBaseObject()))
+          Cost += FS->instCount();
+  return Cost;
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   if (ThinLTO.ModuleMap.empty())
@@ -1326,15 +1355,37 @@ Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
       ThinLTO.Backend(Conf, ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries,
                       AddStream, Cache);
 
+  // The backends of the largest modules are started first, so that they do
+  // not run alone at the end of the link. Each module keeps the task number
+  // given by its position in the module map.
+  std::vector<std::pair<uint64_t, size_t>> Order;
+  for (size_t I = 0, E = ThinLTO.ModuleMap.size(); I != E; ++I) {
+    StringRef ModuleID = ThinLTO.ModuleMap.begin()[I].first;
+    uint64_t Cost = 0;
+    if (!BackendProc->isSensitiveToInputOrder())
+      Cost = getThinBackendCost(ThinLTO.CombinedIndex,
+                                ModuleToDefinedGVSummaries[ModuleID],
+                                ImportLists[ModuleID]);
+    Order.push_back({Cost, I});
+  }
+  std::stable_sort(Order.begin(), Order.end(),
+                   [](const std::pair<uint64_t, size_t> &A,
+                      const std::pair<uint64_t, size_t> &B) {
+                     return A.first > B.first;
+                   });
+
   // Tasks 0 through ParallelCodeGenParallelismLevel-1 are reserved for combined
   // module and parallel code generation partitions.
-  unsigned Task = RegularLTO.ParallelCodeGenParallelismLevel;
-  for (auto &Mod : ThinLTO.ModuleMap) {
-    if (Error E = BackendProc->start(Task, Mod.second, ImportLists[Mod.first],
+  unsigned FirstTask = RegularLTO.ParallelCodeGenParallelismLevel;
+  for (auto &P : Order) {
+    auto &Mod = ThinLTO.ModuleMap.begin()[P.second];
+    LLVM_DEBUG(dbgs() << "Starting ThinLTO backend for " << Mod.first
+                      << " (estimated cost " << P.first << ")\n");
+    if (Error E = BackendProc->start(FirstTask + P.second, Mod.second,
+                                     ImportLists[Mod.first],
                                      ExportLists[Mod.first],
                                      ResolvedODR[Mod.first], ThinLTO.ModuleMap))
       return E;
-    ++Task;
   }
 
   return BackendProc->wait();
@@ -28,6 +28,7 @@
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Object/ModuleSymbolTable.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/BuryPointer.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -369,10 +370,10 @@ void splitCodeGen(Config &C, TargetMachine *TM, AddStreamFn AddStream,
         // Enqueue the task
         CodegenThreadPool.async(
             [&](const SmallString<0> &BC, unsigned ThreadId) {
-              LTOLLVMContext Ctx(C);
+              auto Ctx = llvm::make_unique<LTOLLVMContext>(C);
               Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
                   MemoryBufferRef(StringRef(BC.data(), BC.size()), "ld-temp.o"),
-                  Ctx);
+                  *Ctx);
               if (!MOrErr)
                 report_fatal_error("Failed to read bitcode");
               std::unique_ptr<Module> MPartInCtx = std::move(MOrErr.get());
@@ -381,6 +382,10 @@ void splitCodeGen(Config &C, TargetMachine *TM, AddStreamFn AddStream,
                   createTargetMachine(C, T, *MPartInCtx);
 
               codegen(C, TM.get(), AddStream, ThreadId, *MPartInCtx);
+              if (C.DisableFree) {
+                BuryPointer(std::move(MPartInCtx));
+                BuryPointer(std::move(Ctx));
+              }
             },
             // Pass BC using std::move to ensure that it get moved rather than
             // copied into the thread's context.
@@ -446,6 +451,8 @@ Error lto::backend(Config &C, AddStreamFn AddStream,
 
   if (ParallelCodeGenParallelismLevel == 1) {
     codegen(C, TM.get(), AddStream, 0, *Mod);
+    if (C.DisableFree)
+      BuryPointer(std::move(Mod));
   } else {
     splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
                  std::move(Mod));
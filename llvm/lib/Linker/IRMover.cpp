@@ -975,6 +975,12 @@ Expected<Constant *> IRLinker::linkGlobalValueProto(GlobalValue *SGV,
     if (DoneLinkingBodies)
       return nullptr;
 
+    // The metadata of global variables and function declarations, which is
+    // copied with the prototype, may be loaded lazily.
+    if (isa<GlobalVariable>(SGV) || SGV->isDeclaration())
+      if (Error Err = SGV->materialize())
+        return std::move(Err);
+
     NewGV = copyGlobalValueProto(SGV, ShouldLink || ForAlias);
     if (ShouldLink || !ForAlias)
       forceRenaming(NewGV, SGV->getName());
@@ -35,6 +35,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <cstdint>
@@ -89,7 +90,8 @@ MCAssembler::MCAssembler(MCContext &Context,
     : Context(Context), Backend(std::move(Backend)),
       Emitter(std::move(Emitter)), Writer(std::move(Writer)),
       BundleAlignSize(0), RelaxAll(false), SubsectionsViaSymbols(false),
-      IncrementalLinkerCompatible(false), ELFHeaderEFlags(0) {
+      IncrementalLinkerCompatible(false), ParallelLayout(false),
+      ELFHeaderEFlags(0) {
   VersionInfo.Major = 0; // Major version == 0 for "none specified"
 }
 
@@ -107,6 +109,7 @@ void MCAssembler::reset() {
   RelaxAll = false;
   SubsectionsViaSymbols = false;
   IncrementalLinkerCompatible = false;
+  ParallelLayout = false;
   ELFHeaderEFlags = 0;
   LOHContainer.reset();
   VersionInfo.Major = 0;
@@ -726,34 +729,125 @@ MCAssembler::handleFixup(const MCAsmLayout &Layout, MCFragment &F,
   bool WasForced;
   bool IsResolved = evaluateFixup(Layout, Fixup, &F, Target, FixedValue,
                                   WasForced);
-  if (!IsResolved) {
-    // The fixup was unresolved, we need a relocation. Inform the object
-    // writer of the relocation, and give it an opportunity to adjust the
-    // fixup value if need be.
-    if (Target.getSymA() && Target.getSymB() &&
-        getBackend().requiresDiffExpressionRelocations()) {
-      // The fixup represents the difference between two symbols, which the
-      // backend has indicated must be resolved at link time. Split up the fixup
-      // into two relocations, one for the add, and one for the sub, and emit
-      // both of these. The constant will be associated with the add half of the
-      // expression.
-      MCFixup FixupAdd = MCFixup::createAddFor(Fixup);
-      MCValue TargetAdd =
-          MCValue::get(Target.getSymA(), nullptr, Target.getConstant());
-      getWriter().recordRelocation(*this, Layout, &F, FixupAdd, TargetAdd,
-                                   FixedValue);
-      MCFixup FixupSub = MCFixup::createSubFor(Fixup);
-      MCValue TargetSub = MCValue::get(Target.getSymB());
-      getWriter().recordRelocation(*this, Layout, &F, FixupSub, TargetSub,
-                                   FixedValue);
-    } else {
-      getWriter().recordRelocation(*this, Layout, &F, Fixup, Target,
-                                   FixedValue);
-    }
-  }
+  if (!IsResolved)
+    recordFixupRelocation(Layout, F, Fixup, Target, FixedValue);
   return std::make_tuple(Target, FixedValue, IsResolved);
 }
 
+void MCAssembler::recordFixupRelocation(const MCAsmLayout &Layout,
+                                        MCFragment &F, const MCFixup &Fixup,
+                                        MCValue Target,
+                                        uint64_t &FixedValue) {
+  // The fixup was unresolved, we need a relocation. Inform the object
+  // writer of the relocation, and give it an opportunity to adjust the
+  // fixup value if need be.
+  if (Target.getSymA() && Target.getSymB() &&
+      getBackend().requiresDiffExpressionRelocations()) {
+    // The fixup represents the difference between two symbols, which the
+    // backend has indicated must be resolved at link time. Split up the fixup
+    // into two relocations, one for the add, and one for the sub, and emit
+    // both of these. The constant will be associated with the add half of the
+    // expression.
+    MCFixup FixupAdd = MCFixup::createAddFor(Fixup);
+    MCValue TargetAdd =
+        MCValue::get(Target.getSymA(), nullptr, Target.getConstant());
+    getWriter().recordRelocation(*this, Layout, &F, FixupAdd, TargetAdd,
+                                 FixedValue);
+    MCFixup FixupSub = MCFixup::createSubFor(Fixup);
+    MCValue TargetSub = MCValue::get(Target.getSymB());
+    getWriter().recordRelocation(*this, Layout, &F, FixupSub, TargetSub,
+                                 FixedValue);
+  } else {
+    getWriter().recordRelocation(*this, Layout, &F, Fixup, Target,
+                                 FixedValue);
+  }
+}
+
+/// Collects the symbols that Expr adds and subtracts, and returns true if
+/// Expr is a sum of constants and at most one added symbol and one
+/// subtracted, unqualified symbol, none of them variables. Evaluating such an
+/// expression can neither fail nor modify any symbol, and only reads the
+/// layout of the sections of its symbols.
+static bool isSimpleRelocatableExpr(const MCExpr &Expr, bool Negated,
+                                    const MCSymbolRefExpr *&Added,
+                                    const MCSymbolRefExpr *&Subtracted) {
+  switch (Expr.getKind()) {
+  case MCExpr::Constant:
+    return true;
+  case MCExpr::SymbolRef: {
+    auto &SRE = cast<MCSymbolRefExpr>(Expr);
+    if (SRE.getSymbol().isVariable())
+      return false;
+    const MCSymbolRefExpr *&Slot = Negated ? Subtracted : Added;
+    if (Slot || (Negated && SRE.getKind() != MCSymbolRefExpr::VK_None))
+      return false;
+    Slot = &SRE;
+    return true;
+  }
+  case MCExpr::Unary: {
+    auto &UE = cast<MCUnaryExpr>(Expr);
+    if (UE.getOpcode() == MCUnaryExpr::Plus)
+      return isSimpleRelocatableExpr(*UE.getSubExpr(), Negated, Added,
+                                     Subtracted);
+    // The other operators only apply to absolute values.
+    const MCSymbolRefExpr *SubAdded = nullptr, *SubSubtracted = nullptr;
+    return isSimpleRelocatableExpr(*UE.getSubExpr(), false, SubAdded,
+                                   SubSubtracted) &&
+           !SubAdded && !SubSubtracted;
+  }
+  case MCExpr::Binary: {
+    auto &BE = cast<MCBinaryExpr>(Expr);
+    if (BE.getOpcode() != MCBinaryExpr::Add &&
+        BE.getOpcode() != MCBinaryExpr::Sub)
+      return false;
+    bool NegateRHS = Negated != (BE.getOpcode() == MCBinaryExpr::Sub);
+    return isSimpleRelocatableExpr(*BE.getLHS(), Negated, Added,
+                                   Subtracted) &&
+           isSimpleRelocatableExpr(*BE.getRHS(), NegateRHS, Added, Subtracted);
+  }
+  case MCExpr::Target:
+    return false;
+  }
+  llvm_unreachable("Invalid expression kind!");
+}
+
+/// Returns the fixups and contents of a fragment, or false if the fragment
+/// has no fixups.
+static bool getFragmentFixups(MCFragment &Frag, ArrayRef<MCFixup> &Fixups,
+                              MutableArrayRef<char> &Contents,
+                              const MCSubtargetInfo *&STI) {
+  // FIXME: Is there a better way to do this?  MCEncodedFragmentWithFixups
+  // being templated makes this tricky.
+  if (isa<MCCompactEncodedInstFragment>(&Frag))
+    return false;
+  if (auto *FragWithFixups = dyn_cast<MCDataFragment>(&Frag)) {
+    Fixups = FragWithFixups->getFixups();
+    Contents = FragWithFixups->getContents();
+    STI = FragWithFixups->getSubtargetInfo();
+    assert(!FragWithFixups->hasInstructions() || STI != nullptr);
+  } else if (auto *FragWithFixups = dyn_cast<MCRelaxableFragment>(&Frag)) {
+    Fixups = FragWithFixups->getFixups();
+    Contents = FragWithFixups->getContents();
+    STI = FragWithFixups->getSubtargetInfo();
+    assert(!FragWithFixups->hasInstructions() || STI != nullptr);
+  } else if (auto *FragWithFixups = dyn_cast<MCCVDefRangeFragment>(&Frag)) {
+    Fixups = FragWithFixups->getFixups();
+    Contents = FragWithFixups->getContents();
+  } else if (auto *FragWithFixups = dyn_cast<MCDwarfLineAddrFragment>(&Frag)) {
+    Fixups = FragWithFixups->getFixups();
+    Contents = FragWithFixups->getContents();
+  } else if (auto *FragWithFixups =
+                 dyn_cast<MCDwarfCallFrameFragment>(&Frag)) {
+    Fixups = FragWithFixups->getFixups();
+    Contents = FragWithFixups->getContents();
+  } else if (isa<MCEncodedFragment>(&Frag)) {
+    llvm_unreachable("Unknown fragment with fixups!");
+  } else {
+    return false;
+  }
+  return true;
+}
+
 void MCAssembler::layout(MCAsmLayout &Layout) {
   assert(getBackendPtr() && "Expected assembler backend");
   DEBUG_WITH_TYPE("mc-dump", {
@@ -781,8 +875,17 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
       Frag.setLayoutOrder(FragmentIndex++);
   }
 
-  // Layout until everything fits.
-  while (layoutOnce(Layout))
+  // Layout until everything fits. With parallel layout, the sections whose
+  // relaxation only reads their own layout are relaxed concurrently.
+  SmallVector<MCSection *, 16> IndependentSections;
+  if (getParallelLayout() && !isBundlingEnabled())
+    for (MCSection &Sec : *this)
+      if (isLayoutIndependent(Sec))
+        IndependentSections.push_back(&Sec);
+  if (IndependentSections.size() < 2)
+    IndependentSections.clear();
+
+  while (layoutOnce(Layout, IndependentSections))
     if (getContext().hadError())
       return;
 
@@ -801,57 +904,82 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
   // example, to set the index fields in the symbol data).
   getWriter().executePostLayoutBinding(*this, Layout);
 
+  // With parallel layout, evaluate the fixups up front on multiple threads,
+  // where evaluating them only reads the final layout. Relocations are still
+  // recorded, and fixups applied, in order below.
+  struct EvaluatedFixup {
+    MCValue Target;
+    uint64_t FixedValue = 0;
+    bool IsResolved = false;
+    bool IsEvaluated = false;
+  };
+  std::vector<EvaluatedFixup> Evaluated;
+  if (getParallelLayout() &&
+      llvm::none_of(*this, [](const MCSection &Sec) {
+        // Code alignment may add fixups below.
+        return Sec.UseCodeAlign();
+      })) {
+    std::vector<std::pair<const MCFragment *, const MCFixup *>> Work;
+    for (MCSection &Sec : *this) {
+      for (MCFragment &Frag : Sec) {
+        ArrayRef<MCFixup> Fixups;
+        MutableArrayRef<char> Contents;
+        const MCSubtargetInfo *STI = nullptr;
+        if (getFragmentFixups(Frag, Fixups, Contents, STI))
+          for (const MCFixup &Fixup : Fixups)
+            Work.push_back({&Frag, &Fixup});
+      }
+    }
+
+    Evaluated.resize(Work.size());
+    parallel::for_each_n(parallel::par, size_t(0), Work.size(), [&](size_t I) {
+      const MCSymbolRefExpr *Added = nullptr, *Subtracted = nullptr;
+      if (!isSimpleRelocatableExpr(*Work[I].second->getValue(), false, Added,
+                                   Subtracted))
+        return;
+      EvaluatedFixup &E = Evaluated[I];
+      bool WasForced;
+      E.IsResolved = evaluateFixup(Layout, *Work[I].second, Work[I].first,
+                                   E.Target, E.FixedValue, WasForced);
+      E.IsEvaluated = true;
+    });
+  }
+
   // Evaluate and apply the fixups, generating relocation entries as necessary.
+  size_t FixupIndex = 0;
   for (MCSection &Sec : *this) {
     for (MCFragment &Frag : Sec) {
-      // Data and relaxable fragments both have fixups.  So only process
-      // those here.
-      // FIXME: Is there a better way to do this?  MCEncodedFragmentWithFixups
-      // being templated makes this tricky.
-      if (isa<MCEncodedFragment>(&Frag) &&
-          isa<MCCompactEncodedInstFragment>(&Frag))
-        continue;
-      if (!isa<MCEncodedFragment>(&Frag) && !isa<MCCVDefRangeFragment>(&Frag) &&
-          !isa<MCAlignFragment>(&Frag))
-        continue;
-      ArrayRef<MCFixup> Fixups;
-      MutableArrayRef<char> Contents;
-      const MCSubtargetInfo *STI = nullptr;
-      if (auto *FragWithFixups = dyn_cast<MCDataFragment>(&Frag)) {
-        Fixups = FragWithFixups->getFixups();
-        Contents = FragWithFixups->getContents();
-        STI = FragWithFixups->getSubtargetInfo();
-        assert(!FragWithFixups->hasInstructions() || STI != nullptr);
-      } else if (auto *FragWithFixups = dyn_cast<MCRelaxableFragment>(&Frag)) {
-        Fixups = FragWithFixups->getFixups();
-        Contents = FragWithFixups->getContents();
-        STI = FragWithFixups->getSubtargetInfo();
-        assert(!FragWithFixups->hasInstructions() || STI != nullptr);
-      } else if (auto *FragWithFixups = dyn_cast<MCCVDefRangeFragment>(&Frag)) {
-        Fixups = FragWithFixups->getFixups();
-        Contents = FragWithFixups->getContents();
-      } else if (auto *FragWithFixups = dyn_cast<MCDwarfLineAddrFragment>(&Frag)) {
-        Fixups = FragWithFixups->getFixups();
-        Contents = FragWithFixups->getContents();
-      } else if (auto *AF = dyn_cast<MCAlignFragment>(&Frag)) {
+      if (auto *AF = dyn_cast<MCAlignFragment>(&Frag)) {
         // Insert fixup type for code alignment if the target define
         // shouldInsertFixupForCodeAlign target hook.
         if (Sec.UseCodeAlign() && AF->hasEmitNops()) {
           getBackend().shouldInsertFixupForCodeAlign(*this, Layout, *AF);
         }
         continue;
-      } else if (auto *FragWithFixups =
-                     dyn_cast<MCDwarfCallFrameFragment>(&Frag)) {
-        Fixups = FragWithFixups->getFixups();
-        Contents = FragWithFixups->getContents();
-      } else
-        llvm_unreachable("Unknown fragment with fixups!");
+      }
+      // Data and relaxable fragments both have fixups.  So only process
+      // those here.
+      ArrayRef<MCFixup> Fixups;
+      MutableArrayRef<char> Contents;
+      const MCSubtargetInfo *STI = nullptr;
+      if (!getFragmentFixups(Frag, Fixups, Contents, STI))
+        continue;
       for (const MCFixup &Fixup : Fixups) {
         uint64_t FixedValue;
         bool IsResolved;
         MCValue Target;
-        std::tie(Target, FixedValue, IsResolved) =
-            handleFixup(Layout, Frag, Fixup);
+        if (!Evaluated.empty() && Evaluated[FixupIndex].IsEvaluated) {
+          EvaluatedFixup &E = Evaluated[FixupIndex];
+          Target = E.Target;
+          FixedValue = E.FixedValue;
+          IsResolved = E.IsResolved;
+          if (!IsResolved)
+            recordFixupRelocation(Layout, Frag, Fixup, Target, FixedValue);
+        } else {
+          std::tie(Target, FixedValue, IsResolved) =
+              handleFixup(Layout, Frag, Fixup);
+        }
+        ++FixupIndex;
         getBackend().applyFixup(*this, Fixup, Target, Contents, FixedValue,
                                 IsResolved, STI);
       }
@@ -1105,12 +1233,73 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
   return false;
 }
 
-bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
+bool MCAssembler::isLayoutIndependent(const MCSection &Sec) const {
+  if (Sec.UseCodeAlign())
+    return false;
+
+  auto IsLocal = [&](const MCSymbolRefExpr *SRE) {
+    if (!SRE)
+      return true;
+    const MCSymbol &Sym = SRE->getSymbol();
+    return Sym.isUndefined(false) ||
+           (Sym.isInSection() && &Sym.getSection() == &Sec);
+  };
+
+  for (const MCFragment &F : Sec) {
+    switch (F.getKind()) {
+    case MCFragment::FT_Data:
+    case MCFragment::FT_CompactEncodedInst:
+    case MCFragment::FT_Align:
+    case MCFragment::FT_SymbolId:
+      break;
+    case MCFragment::FT_Fill:
+      if (!isa<MCConstantExpr>(cast<MCFillFragment>(F).getNumValues()))
+        return false;
+      break;
+    case MCFragment::FT_Relaxable:
+      for (const MCFixup &Fixup : cast<MCRelaxableFragment>(F).getFixups()) {
+        const MCSymbolRefExpr *Added = nullptr, *Subtracted = nullptr;
+        if (!isSimpleRelocatableExpr(*Fixup.getValue(), false, Added,
+                                     Subtracted) ||
+            !IsLocal(Added) || !IsLocal(Subtracted))
+          return false;
+      }
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MCAssembler::layoutOnce(MCAsmLayout &Layout,
+                             ArrayRef<MCSection *> IndependentSections) {
   ++stats::RelaxationSteps;
 
   bool WasRelaxed = false;
+  SmallPtrSet<const MCSection *, 16> Relaxed;
+  if (!IndependentSections.empty()) {
+    // Each thread only updates the layout of its own section, but the layout
+    // must not add bookkeeping for a section concurrently: Make sure that
+    // every section has been laid out at least in part.
+    for (MCSection &Sec : *this)
+      Layout.getFragmentOffset(&*Sec.begin());
+
+    std::vector<char> SectionRelaxed(IndependentSections.size());
+    parallel::for_each_n(parallel::par, size_t(0), IndependentSections.size(),
+                         [&](size_t I) {
+                           while (layoutSectionOnce(Layout,
+                                                    *IndependentSections[I]))
+                             SectionRelaxed[I] = true;
+                         });
+    WasRelaxed = llvm::is_contained(SectionRelaxed, true);
+    Relaxed.insert(IndependentSections.begin(), IndependentSections.end());
+  }
+
   for (iterator it = begin(), ie = end(); it != ie; ++it) {
     MCSection &Sec = *it;
+    if (Relaxed.count(&Sec))
+      continue;
     while (layoutSectionOnce(Layout, Sec))
       WasRelaxed = true;
   }
@@ -12,6 +12,7 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
 #include "llvm/IR/LLVMContext.h"
@@ -22,6 +23,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -452,7 +454,43 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  // Reading the symbol tables of the members dominates the time it takes to
+  // write large archives, so read them concurrently. Their names are added to
+  // SymNames in member order below.
+  struct MemberSymbols {
+    SmallString<0> Names;
+    std::vector<unsigned> Offsets;
+    Optional<Error> Err;
+    bool HasObject = false;
+  };
+  std::vector<MemberSymbols> MemberSyms(NewMembers.size());
+  parallel::for_each_n(
+      parallel::par, size_t(0), NewMembers.size(), [&](size_t I) {
+        MemberSymbols &Syms = MemberSyms[I];
+        raw_svector_ostream Names(Syms.Names);
+        Expected<std::vector<unsigned>> Offsets = getSymbols(
+            NewMembers[I].Buf->getMemBufferRef(), Names, Syms.HasObject);
+        if (Offsets)
+          Syms.Offsets = std::move(*Offsets);
+        else
+          Syms.Err = Offsets.takeError();
+      });
+
+  // Report the error of the first member that failed.
+  Optional<Error> Err;
+  for (MemberSymbols &Syms : MemberSyms) {
+    if (!Syms.Err)
+      continue;
+    if (Err)
+      consumeError(std::move(*Syms.Err));
+    else
+      Err = std::move(*Syms.Err);
+  }
+  if (Err)
+    return std::move(*Err);
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -478,13 +516,15 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Buf.getBufferSize() + MemberPadding);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    MemberSymbols &Syms = MemberSyms[I];
+    unsigned SymNamesOffset = SymNames.tell();
+    for (unsigned &Offset : Syms.Offsets)
+      Offset += SymNamesOffset;
+    SymNames << Syms.Names;
+    HasObject |= Syms.HasObject;
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({std::move(Syms.Offsets), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
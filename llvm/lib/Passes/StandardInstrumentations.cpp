@@ -21,12 +21,22 @@
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassInstrumentation.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 
+static cl::opt<std::string> PassStatsFile(
+    "pass-stats-json", cl::value_desc("filename"),
+    cl::desc("Write the time, instruction count change and heap usage change "
+             "of every pass run to this file as JSON (new pass manager only)"),
+    cl::Hidden);
+
 namespace {
 
 /// Extracting Module out of \p IR unit. Also fills a textual description
@@ -141,6 +151,45 @@ void unwrapAndPrint(Any IR, StringRef Banner, bool ForceModule = false) {
   llvm_unreachable("Unknown wrapped IR type");
 }
 
+/// Returns the name of the IR unit wrapped into \p IR.
+std::string getIRName(Any IR) {
+  if (any_isa<const Module *>(IR))
+    return any_cast<const Module *>(IR)->getName();
+  if (any_isa<const Function *>(IR))
+    return any_cast<const Function *>(IR)->getName();
+  if (any_isa<const LazyCallGraph::SCC *>(IR))
+    return any_cast<const LazyCallGraph::SCC *>(IR)->getName();
+  if (any_isa<const Loop *>(IR))
+    return any_cast<const Loop *>(IR)->getName();
+  llvm_unreachable("Unknown wrapped IR type");
+}
+
+/// Returns the number of instructions in the IR unit wrapped into \p IR. For a
+/// loop this counts its whole function, as loop passes may change code outside
+/// of the loop, e.g. in the preheader.
+unsigned getInstructionCount(Any IR) {
+  unsigned Count = 0;
+  if (any_isa<const Module *>(IR)) {
+    for (const Function &F : *any_cast<const Module *>(IR))
+      Count += F.getInstructionCount();
+    return Count;
+  }
+  if (any_isa<const Function *>(IR))
+    return any_cast<const Function *>(IR)->getInstructionCount();
+  if (any_isa<const LazyCallGraph::SCC *>(IR)) {
+    const LazyCallGraph::SCC *C = any_cast<const LazyCallGraph::SCC *>(IR);
+    for (const LazyCallGraph::Node &N : *C)
+      Count += N.getFunction().getInstructionCount();
+    return Count;
+  }
+  if (any_isa<const Loop *>(IR))
+    return any_cast<const Loop *>(IR)
+        ->getHeader()
+        ->getParent()
+        ->getInstructionCount();
+  llvm_unreachable("Unknown wrapped IR type");
+}
+
 } // namespace
 
 PrintIRInstrumentation::~PrintIRInstrumentation() {
@@ -235,8 +284,112 @@ void PrintIRInstrumentation::registerCallbacks(
   }
 }
 
+PassStatsInstrumentation::PassStatsInstrumentation()
+    : Enabled(!PassStatsFile.empty()) {}
+
+bool PassStatsInstrumentation::runBeforePass(StringRef PassID, Any IR) {
+  // Pass managers and adaptors only run other passes, which are recorded on
+  // their own.
+  if (PassID.startswith("PassManager<") || PassID.contains("PassAdaptor<"))
+    return true;
+
+  ActivePassRun Run;
+  Run.PassID = PassID;
+  Run.TimeTraced = timeTraceProfilerEnabled();
+  if (Run.TimeTraced || Enabled)
+    Run.IRName = getIRName(IR);
+  if (Run.TimeTraced)
+    timeTraceProfilerBegin(PassID, Run.IRName);
+  Run.InstructionsBefore = Enabled ? getInstructionCount(IR) : 0;
+  // Start the clock last so that the counting above isn't attributed to the
+  // pass.
+  Run.Start = TimeRecord::getCurrentTime(/*Start=*/true);
+  ActiveRuns.push_back(std::move(Run));
+  return true;
+}
+
+void PassStatsInstrumentation::runAfterPass(StringRef PassID,
+                                            Optional<Any> IR) {
+  if (PassID.startswith("PassManager<") || PassID.contains("PassAdaptor<"))
+    return;
+
+  TimeRecord Time = TimeRecord::getCurrentTime(/*Start=*/false);
+  assert(!ActiveRuns.empty() && "pass finished without having started");
+  ActivePassRun Run = ActiveRuns.pop_back_val();
+  assert(Run.PassID == PassID && "mismatched pass runs");
+  if (Run.TimeTraced)
+    timeTraceProfilerEnd();
+  if (!Enabled)
+    return;
+
+  Time -= Run.Start;
+  PassRunRecord Record{PassID, std::move(Run.IRName), Time,
+                       Run.InstructionsBefore, None};
+  if (IR)
+    Record.InstructionsAfter = getInstructionCount(*IR);
+  Records.push_back(std::move(Record));
+}
+
+void PassStatsInstrumentation::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (!Enabled && !timeTraceProfilerEnabled())
+    return;
+
+  PIC.registerBeforePassCallback(
+      [this](StringRef P, Any IR) { return this->runBeforePass(P, IR); });
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any IR) { this->runAfterPass(P, IR); });
+  PIC.registerAfterPassInvalidatedCallback(
+      [this](StringRef P) { this->runAfterPass(P, None); });
+}
+
+void PassStatsInstrumentation::print() {
+  if (!Enabled || Records.empty())
+    return;
+
+  std::unique_ptr<raw_fd_ostream> File;
+  raw_ostream *OS = OutStream;
+  if (!OS) {
+    std::error_code EC;
+    File = llvm::make_unique<raw_fd_ostream>(PassStatsFile, EC,
+                                             sys::fs::OF_Text);
+    if (EC) {
+      errs() << "error: could not open pass statistics file '"
+             << PassStatsFile << "': " << EC.message() << "\n";
+      Records.clear();
+      return;
+    }
+    OS = File.get();
+  }
+
+  json::OStream J(*OS, /*IndentSize=*/2);
+  J.object([&] {
+    J.attributeArray("passes", [&] {
+      for (const PassRunRecord &R : Records)
+        J.object([&] {
+          J.attribute("pass", R.PassID);
+          J.attribute("ir", R.IRName);
+          J.attribute("wall_time", R.Time.getWallTime());
+          J.attribute("user_time", R.Time.getUserTime());
+          J.attribute("system_time", R.Time.getSystemTime());
+          J.attribute("instructions", R.InstructionsBefore);
+          if (R.InstructionsAfter)
+            J.attribute("instructions_delta",
+                        int64_t(*R.InstructionsAfter) -
+                            int64_t(R.InstructionsBefore));
+          else
+            J.attribute("invalidated", true);
+          J.attribute("heap_delta", int64_t(R.Time.getMemUsed()));
+        });
+    });
+  });
+  *OS << "\n";
+  Records.clear();
+}
+
 void StandardInstrumentations::registerCallbacks(
     PassInstrumentationCallbacks &PIC) {
   PrintIR.registerCallbacks(PIC);
   TimePasses.registerCallbacks(PIC);
+  PassStats.registerCallbacks(PIC);
 }
@@ -947,10 +947,14 @@ SampleProfileReaderItaniumRemapper::getSamplesFor(StringRef Fname) {
 
 /// Prepare a memory buffer for the contents of \p Filename.
 ///
+/// \param RequiresNullTerminator Whether the contents must be followed by a
+/// null character. Otherwise a large file is always mapped rather than read.
+///
 /// \returns an error code indicating the status of the buffer.
 static ErrorOr<std::unique_ptr<MemoryBuffer>>
-setupMemoryBuffer(const Twine &Filename) {
-  auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(Filename);
+setupMemoryBuffer(const Twine &Filename, bool RequiresNullTerminator = true) {
+  auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(Filename, /*FileSize=*/-1,
+                                                  RequiresNullTerminator);
   if (std::error_code EC = BufferOrErr.getError())
     return EC;
   auto Buffer = std::move(BufferOrErr.get());
@@ -971,7 +975,11 @@ setupMemoryBuffer(const Twine &Filename) {
 /// \returns an error code indicating the status of the created reader.
 ErrorOr<std::unique_ptr<SampleProfileReader>>
 SampleProfileReader::create(const Twine &Filename, LLVMContext &C) {
-  auto BufferOrError = setupMemoryBuffer(Filename);
+  // The binary formats are read in place, and the compact binary format only
+  // reads the functions used by the module, so the file is mapped. The text
+  // reader copies the buffer if needed.
+  auto BufferOrError =
+      setupMemoryBuffer(Filename, /*RequiresNullTerminator=*/false);
   if (std::error_code EC = BufferOrError.getError())
     return EC;
   return create(BufferOrError.get(), C);
@@ -1014,8 +1022,13 @@ SampleProfileReader::create(std::unique_ptr<MemoryBuffer> &B, LLVMContext &C) {
     Reader.reset(new SampleProfileReaderCompactBinary(std::move(B), C));
   else if (SampleProfileReaderGCC::hasFormat(*B))
     Reader.reset(new SampleProfileReaderGCC(std::move(B), C));
-  else if (SampleProfileReaderText::hasFormat(*B))
+  else if (SampleProfileReaderText::hasFormat(*B)) {
+    // line_iterator relies on the null terminator, which a mapped file may
+    // not have.
+    B = MemoryBuffer::getMemBufferCopy(B->getBuffer(),
+                                       B->getBufferIdentifier());
     Reader.reset(new SampleProfileReaderText(std::move(B), C));
+  }
   else
     return sampleprof_error::unrecognized_format;
 
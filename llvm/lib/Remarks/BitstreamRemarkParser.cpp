@@ -0,0 +1,253 @@
+//===- BitstreamRemarkParser.cpp ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides utility methods used by clients that want to use the
+// parser for remark diagnostics in LLVM, in the bitstream format.
+//
+//===----------------------------------------------------------------------===//
+
+#include "BitstreamRemarkParser.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Remarks/BitstreamRemarkContainer.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+static Error malformed(const char *Msg) {
+  return createStringError(
+      std::make_error_code(std::errc::illegal_byte_sequence),
+      "Malformed bitstream remark: %s.", Msg);
+}
+
+BitstreamRemarkParser::BitstreamRemarkParser(StringRef Buf)
+    : Parser{Format::Bitstream}, Stream(Buf) {}
+
+Error BitstreamRemarkParser::parseMagic() {
+  for (char C : BitstreamMagic) {
+    if (Stream.AtEndOfStream())
+      return malformed("unknown magic number");
+    Expected<SimpleBitstreamCursor::word_t> MaybeChar = Stream.Read(8);
+    if (!MaybeChar)
+      return MaybeChar.takeError();
+    if (*MaybeChar != static_cast<unsigned char>(C))
+      return malformed("unknown magic number");
+  }
+  return Error::success();
+}
+
+Error BitstreamRemarkParser::parseMeta() {
+  if (Error E = Stream.EnterSubBlock(META_BLOCK_ID))
+    return E;
+
+  bool HasVersion = false;
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    BitstreamEntry Entry = *MaybeEntry;
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+      return malformed("unexpected end of meta block");
+    case BitstreamEntry::EndBlock:
+      if (!HasVersion)
+        return malformed("missing version");
+      return Error::success();
+    case BitstreamEntry::SubBlock:
+      if (Error E = Stream.SkipBlock())
+        return E;
+      continue;
+    case BitstreamEntry::Record:
+      break;
+    }
+
+    Record.clear();
+    Expected<unsigned> MaybeCode = Stream.readRecord(Entry.ID, Record);
+    if (!MaybeCode)
+      return MaybeCode.takeError();
+    if (*MaybeCode != RECORD_META_VERSION)
+      continue;
+    if (Record.size() != 1)
+      return malformed("invalid version record");
+    if (Record[0] != CurrentBitstreamRemarkVersion)
+      return createStringError(
+          std::make_error_code(std::errc::invalid_argument),
+          "Unsupported bitstream remark version: %u (expected %u).",
+          static_cast<unsigned>(Record[0]),
+          static_cast<unsigned>(CurrentBitstreamRemarkVersion));
+    HasVersion = true;
+  }
+}
+
+Error BitstreamRemarkParser::parseString(uint64_t ID, StringRef &Result) {
+  if (ID >= Strings.size())
+    return createStringError(
+        std::make_error_code(std::errc::invalid_argument),
+        "String with index %u is out of bounds (size = %u).",
+        static_cast<unsigned>(ID), static_cast<unsigned>(Strings.size()));
+  Result = Strings[ID];
+  return Error::success();
+}
+
+Error BitstreamRemarkParser::parseLocation(unsigned Index,
+                                           Optional<RemarkLocation> &Loc) {
+  RemarkLocation Result;
+  if (Error E = parseString(Record[Index], Result.SourceFilePath))
+    return E;
+  Result.SourceLine = Record[Index + 1];
+  Result.SourceColumn = Record[Index + 2];
+  Loc = Result;
+  return Error::success();
+}
+
+Expected<std::unique_ptr<Remark>> BitstreamRemarkParser::parseRemark() {
+  if (Error E = Stream.EnterSubBlock(REMARK_BLOCK_ID))
+    return std::move(E);
+
+  auto Result = llvm::make_unique<Remark>();
+  bool HasHeader = false;
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    BitstreamEntry Entry = *MaybeEntry;
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+      return malformed("unexpected end of remark block");
+    case BitstreamEntry::EndBlock:
+      if (!HasHeader)
+        return malformed("missing remark header");
+      return std::move(Result);
+    case BitstreamEntry::SubBlock:
+      if (Error E = Stream.SkipBlock())
+        return std::move(E);
+      continue;
+    case BitstreamEntry::Record:
+      break;
+    }
+
+    Record.clear();
+    StringRef Blob;
+    Expected<unsigned> MaybeCode = Stream.readRecord(Entry.ID, Record, &Blob);
+    if (!MaybeCode)
+      return MaybeCode.takeError();
+
+    switch (*MaybeCode) {
+    case RECORD_REMARK_STRING:
+      // The blob points into the input buffer: no copy is needed.
+      Strings.push_back(Blob);
+      break;
+    case RECORD_REMARK_HEADER: {
+      if (Record.size() != 4)
+        return malformed("invalid remark header");
+      if (Record[0] == static_cast<uint64_t>(Type::Unknown) ||
+          Record[0] > static_cast<uint64_t>(Type::LastTypeValue))
+        return malformed("unknown remark type");
+      Result->RemarkType = static_cast<Type>(Record[0]);
+      if (Error E = parseString(Record[1], Result->PassName))
+        return std::move(E);
+      if (Error E = parseString(Record[2], Result->RemarkName))
+        return std::move(E);
+      if (Error E = parseString(Record[3], Result->FunctionName))
+        return std::move(E);
+      HasHeader = true;
+      break;
+    }
+    case RECORD_REMARK_LOCATION:
+      if (Record.size() != 3)
+        return malformed("invalid remark location");
+      if (Error E = parseLocation(0, Result->Loc))
+        return std::move(E);
+      break;
+    case RECORD_REMARK_HOTNESS:
+      if (Record.size() != 1)
+        return malformed("invalid remark hotness");
+      Result->Hotness = Record[0];
+      break;
+    case RECORD_REMARK_ARG:
+    case RECORD_REMARK_ARG_WITH_LOC: {
+      bool HasLoc = *MaybeCode == RECORD_REMARK_ARG_WITH_LOC;
+      if (Record.size() != (HasLoc ? 5 : 2))
+        return malformed("invalid remark argument");
+      Argument &Arg = Result->Args.emplace_back();
+      if (Error E = parseString(Record[0], Arg.Key))
+        return std::move(E);
+      if (Error E = parseString(Record[1], Arg.Val))
+        return std::move(E);
+      if (HasLoc)
+        if (Error E = parseLocation(2, Arg.Loc))
+          return std::move(E);
+      break;
+    }
+    default:
+      // Ignore unknown records, for forward compatibility.
+      break;
+    }
+  }
+}
+
+Expected<std::unique_ptr<Remark>> BitstreamRemarkParser::parseBlock() {
+  Expected<BitstreamEntry> MaybeEntry =
+      Stream.advance(BitstreamCursor::AF_DontAutoprocessAbbrevs);
+  if (!MaybeEntry)
+    return MaybeEntry.takeError();
+  BitstreamEntry Entry = *MaybeEntry;
+  if (Entry.Kind != BitstreamEntry::SubBlock)
+    return malformed("expected a top-level block");
+
+  switch (Entry.ID) {
+  case bitc::BLOCKINFO_BLOCK_ID: {
+    Expected<Optional<BitstreamBlockInfo>> MaybeBlockInfo =
+        Stream.ReadBlockInfoBlock();
+    if (!MaybeBlockInfo)
+      return MaybeBlockInfo.takeError();
+    if (!*MaybeBlockInfo)
+      return malformed("invalid block info block");
+    BlockInfo = std::move(**MaybeBlockInfo);
+    Stream.setBlockInfo(BlockInfo.getPointer());
+    return nullptr;
+  }
+  case META_BLOCK_ID:
+    if (Error E = parseMeta())
+      return std::move(E);
+    return nullptr;
+  case REMARK_BLOCK_ID:
+    return parseRemark();
+  default:
+    if (Error E = Stream.SkipBlock())
+      return std::move(E);
+    return nullptr;
+  }
+}
+
+Expected<std::unique_ptr<Remark>> BitstreamRemarkParser::next() {
+  if (Failed)
+    return make_error<EndOfFileError>();
+
+  if (!ParsedMagic) {
+    if (Error E = parseMagic()) {
+      Failed = true;
+      return std::move(E);
+    }
+    ParsedMagic = true;
+  }
+
+  while (!Stream.AtEndOfStream()) {
+    Expected<std::unique_ptr<Remark>> MaybeRemark = parseBlock();
+    if (!MaybeRemark) {
+      // Avoid garbage input, stop parsing.
+      Failed = true;
+      return MaybeRemark.takeError();
+    }
+    if (*MaybeRemark)
+      return std::move(*MaybeRemark);
+  }
+
+  return make_error<EndOfFileError>();
+}
@@ -0,0 +1,71 @@
+//===-- BitstreamRemarkParser.h - Parser for bitstream remarks --*- C++/-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides the impementation of the bitstream remark parser.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BITSTREAM_REMARK_PARSER_H
+#define LLVM_REMARKS_BITSTREAM_REMARK_PARSER_H
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitstream/BitstreamReader.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkParser.h"
+#include "llvm/Support/Error.h"
+#include <vector>
+
+namespace llvm {
+namespace remarks {
+
+/// Streaming bitstream to Remark parser.
+/// The remarks are parsed one block at a time, and all the strings in the
+/// returned remarks point directly into the input buffer, which has to
+/// outlive the remarks.
+struct BitstreamRemarkParser : public Parser {
+  /// The cursor in the input buffer.
+  BitstreamCursor Stream;
+  /// The abbreviations read from the block info block.
+  Optional<BitstreamBlockInfo> BlockInfo;
+  /// The strings defined so far in the stream, indexed by their ID.
+  std::vector<StringRef> Strings;
+  /// Storage for the operands of the record being parsed.
+  SmallVector<uint64_t, 8> Record;
+  /// Whether the magic number has been checked.
+  bool ParsedMagic = false;
+  /// Set after an error, to avoid parsing garbage input.
+  bool Failed = false;
+
+  BitstreamRemarkParser(StringRef Buf);
+
+  Expected<std::unique_ptr<Remark>> next() override;
+
+  static bool classof(const Parser *P) {
+    return P->ParserFormat == Format::Bitstream;
+  }
+
+private:
+  /// Check the magic number at the beginning of the buffer.
+  Error parseMagic();
+  /// Parse the next top-level block, returning a remark if it's a remark
+  /// block, or nullptr otherwise.
+  Expected<std::unique_ptr<Remark>> parseBlock();
+  /// Parse the meta block and check the version of the format.
+  Error parseMeta();
+  /// Parse a remark block to a remarks::Remark object.
+  Expected<std::unique_ptr<Remark>> parseRemark();
+  /// Look up a string previously defined in the stream.
+  Error parseString(uint64_t ID, StringRef &Result);
+  /// Parse a debug location from the record operands starting at \p Index.
+  Error parseLocation(unsigned Index, Optional<RemarkLocation> &Loc);
+};
+} // end namespace remarks
+} // end namespace llvm
+
+#endif /* LLVM_REMARKS_BITSTREAM_REMARK_PARSER_H */
@@ -0,0 +1,143 @@
+//===- BitstreamRemarkSerializer.cpp --------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides the implementation of the bitstream remark serializer
+// using LLVM's bitstream writer.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/BitstreamRemarkContainer.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+BitstreamSerializer::BitstreamSerializer(raw_ostream &OS)
+    : Serializer(OS), Bitstream(Encoded) {
+  emitPreamble();
+}
+
+void BitstreamSerializer::emitPreamble() {
+  for (char C : BitstreamMagic)
+    Bitstream.Emit(static_cast<unsigned>(C), 8);
+
+  Bitstream.EnterBlockInfoBlock();
+
+  auto Abbrev = std::make_shared<BitCodeAbbrev>();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_STRING));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob));
+  StringAbbrevID = Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+
+  Abbrev = std::make_shared<BitCodeAbbrev>();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_HEADER));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Fixed, 3)); // Type
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6));   // Pass
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6));   // Name
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6));   // Function
+  HeaderAbbrevID = Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+
+  Abbrev = std::make_shared<BitCodeAbbrev>();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_LOCATION));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // File
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 8)); // Line
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // Column
+  LocationAbbrevID = Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+
+  Abbrev = std::make_shared<BitCodeAbbrev>();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_HOTNESS));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 8)); // Hotness
+  HotnessAbbrevID = Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+
+  Abbrev = std::make_shared<BitCodeAbbrev>();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_ARG));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // Key
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // Value
+  ArgAbbrevID = Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+
+  Abbrev = std::make_shared<BitCodeAbbrev>();
+  Abbrev->Add(BitCodeAbbrevOp(RECORD_REMARK_ARG_WITH_LOC));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // Key
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // Value
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // File
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 8)); // Line
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 6)); // Column
+  ArgWithLocAbbrevID = Bitstream.EmitBlockInfoAbbrev(REMARK_BLOCK_ID, Abbrev);
+
+  Bitstream.ExitBlock();
+
+  Bitstream.EnterSubblock(META_BLOCK_ID, 3);
+  uint64_t Version[] = {CurrentBitstreamRemarkVersion};
+  Bitstream.EmitRecord(RECORD_META_VERSION, Version);
+  Bitstream.ExitBlock();
+
+  flush();
+}
+
+unsigned BitstreamSerializer::useString(StringRef Str) {
+  size_t NumStrings = Strings.StrTab.size();
+  unsigned ID = Strings.add(Str).first;
+  // Only new strings need to be defined in the stream. Since IDs are handed
+  // out sequentially, the parser can compute the ID of the string from the
+  // number of strings it has seen so far.
+  if (Strings.StrTab.size() != NumStrings) {
+    uint64_t Record[] = {RECORD_REMARK_STRING};
+    Bitstream.EmitRecordWithBlob(StringAbbrevID, Record, Str);
+  }
+  return ID;
+}
+
+void BitstreamSerializer::emit(const Remark &Remark) {
+  // The remark block has 6 abbreviations, starting at
+  // bitc::FIRST_APPLICATION_ABBREV, so 4 bits are enough for the abbrev IDs.
+  Bitstream.EnterSubblock(REMARK_BLOCK_ID, 4);
+
+  uint64_t Header[] = {RECORD_REMARK_HEADER,
+                       static_cast<uint64_t>(Remark.RemarkType),
+                       useString(Remark.PassName), useString(Remark.RemarkName),
+                       useString(Remark.FunctionName)};
+  Bitstream.EmitRecordWithAbbrev(HeaderAbbrevID, Header);
+
+  if (const Optional<RemarkLocation> &Loc = Remark.Loc) {
+    uint64_t Location[] = {RECORD_REMARK_LOCATION,
+                           useString(Loc->SourceFilePath), Loc->SourceLine,
+                           Loc->SourceColumn};
+    Bitstream.EmitRecordWithAbbrev(LocationAbbrevID, Location);
+  }
+
+  if (Optional<uint64_t> Hotness = Remark.Hotness) {
+    uint64_t Record[] = {RECORD_REMARK_HOTNESS, *Hotness};
+    Bitstream.EmitRecordWithAbbrev(HotnessAbbrevID, Record);
+  }
+
+  for (const Argument &Arg : Remark.Args) {
+    unsigned KeyID = useString(Arg.Key);
+    unsigned ValueID = useString(Arg.Val);
+    if (const Optional<RemarkLocation> &Loc = Arg.Loc) {
+      uint64_t Record[] = {RECORD_REMARK_ARG_WITH_LOC,
+                           KeyID,
+                           ValueID,
+                           useString(Loc->SourceFilePath),
+                           Loc->SourceLine,
+                           Loc->SourceColumn};
+      Bitstream.EmitRecordWithAbbrev(ArgWithLocAbbrevID, Record);
+    } else {
+      uint64_t Record[] = {RECORD_REMARK_ARG, KeyID, ValueID};
+      Bitstream.EmitRecordWithAbbrev(ArgAbbrevID, Record);
+    }
+  }
+
+  Bitstream.ExitBlock();
+  flush();
+}
+
+void BitstreamSerializer::flush() {
+  // We're always at the top level here, so the writer doesn't need to refer to
+  // anything that was already encoded.
+  OS.write(Encoded.data(), Encoded.size());
+  Encoded.clear();
+}
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Remarks/RemarkParser.h"
+#include "BitstreamRemarkParser.h"
 #include "YAMLRemarkParser.h"
 #include "llvm-c/Remarks.h"
 #include "llvm/ADT/STLExtras.h"
@@ -53,6 +54,13 @@ llvm::remarks::createRemarkParser(Format ParserFormat, StringRef Buf,
   switch (ParserFormat) {
   case Format::YAML:
     return llvm::make_unique<YAMLRemarkParser>(Buf, StrTab);
+  case Format::Bitstream:
+    // The strings are part of the bitstream itself.
+    if (StrTab)
+      return createStringError(
+          std::make_error_code(std::errc::invalid_argument),
+          "The bitstream remark format does not use an external string table.");
+    return llvm::make_unique<BitstreamRemarkParser>(Buf);
   case Format::Unknown:
     return createStringError(std::make_error_code(std::errc::invalid_argument),
                              "Unknown remark parser format.");
@@ -17,17 +17,21 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Threading.h"
 #if LLVM_ENABLE_ZLIB == 1 && HAVE_ZLIB_H
 #include <zlib.h>
 #endif
+#if LLVM_ENABLE_ZSTD == 1
+#include <zstd.h>
+#endif
 
 using namespace llvm;
 
-#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
 static Error createError(StringRef Err) {
   return make_error<StringError>(Err, inconvertibleErrorCode());
 }
 
+#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
 static StringRef convertZlibCodeToString(int Code) {
   switch (Code) {
   case Z_MEM_ERROR:
@@ -85,6 +89,44 @@ uint32_t zlib::crc32(StringRef Buffer) {
   return ::crc32(0, (const Bytef *)Buffer.data(), Buffer.size());
 }
 
+Error zlib::compressRaw(StringRef InputBuffer,
+                        SmallVectorImpl<char> &CompressedBuffer, bool Last,
+                        int Level) {
+  z_stream Stream = {};
+  // A negative window size asks for a raw deflate stream.
+  int Res = ::deflateInit2(&Stream, Level, Z_DEFLATED, -MAX_WBITS, 8,
+                           Z_DEFAULT_STRATEGY);
+  if (Res != Z_OK)
+    return createError(convertZlibCodeToString(Res));
+  // Leave room for the sync marker written by Z_FULL_FLUSH.
+  unsigned long CompressedSize =
+      ::deflateBound(&Stream, InputBuffer.size()) + 8;
+  CompressedBuffer.resize(CompressedSize);
+  Stream.next_in = (Bytef *)InputBuffer.data();
+  Stream.avail_in = InputBuffer.size();
+  Stream.next_out = (Bytef *)CompressedBuffer.data();
+  Stream.avail_out = CompressedSize;
+  Res = ::deflate(&Stream, Last ? Z_FINISH : Z_FULL_FLUSH);
+  CompressedSize -= Stream.avail_out;
+  ::deflateEnd(&Stream);
+  if (Res != (Last ? Z_STREAM_END : Z_OK))
+    return createError(convertZlibCodeToString(Res == Z_OK ? Z_BUF_ERROR
+                                                           : Res));
+  // Tell MemorySanitizer that zlib output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented ZLib.
+  __msan_unpoison(CompressedBuffer.data(), CompressedSize);
+  CompressedBuffer.resize(CompressedSize);
+  return Error::success();
+}
+
+uint32_t zlib::adler32(StringRef Buffer) {
+  return ::adler32(1, (const Bytef *)Buffer.data(), Buffer.size());
+}
+
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Len2) {
+  return ::adler32_combine(Adler1, Adler2, Len2);
+}
+
 #else
 bool zlib::isAvailable() { return false; }
 Error zlib::compress(StringRef InputBuffer,
@@ -103,4 +145,142 @@ Error zlib::uncompress(StringRef InputBuffer,
 uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
+Error zlib::compressRaw(StringRef InputBuffer,
+                        SmallVectorImpl<char> &CompressedBuffer, bool Last,
+                        int Level) {
+  llvm_unreachable("zlib::compressRaw is unavailable");
+}
+uint32_t zlib::adler32(StringRef Buffer) {
+  llvm_unreachable("zlib::adler32 is unavailable");
+}
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Len2) {
+  llvm_unreachable("zlib::adler32Combine is unavailable");
+}
 #endif
+
+#if LLVM_ENABLE_ZSTD == 1
+// Inputs smaller than this are compressed on the calling thread only: the
+// cost of starting the workers would dominate.
+static constexpr size_t MultithreadedThreshold = 4 << 20;
+
+bool zstd::isAvailable() { return true; }
+
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level) {
+  ZSTD_CCtx *Ctx = ::ZSTD_createCCtx();
+  if (!Ctx)
+    return createError("zstd error: cannot allocate a compression context");
+  ::ZSTD_CCtx_setParameter(Ctx, ZSTD_c_compressionLevel, Level);
+  // Ask for worker threads on large inputs. This fails, and leaves the
+  // context single-threaded, if libzstd was built without ZSTD_MULTITHREAD.
+  if (InputBuffer.size() >= MultithreadedThreshold)
+    ::ZSTD_CCtx_setParameter(Ctx, ZSTD_c_nbWorkers,
+                             llvm::hardware_concurrency());
+
+  size_t CompressedSize = ::ZSTD_compressBound(InputBuffer.size());
+  CompressedBuffer.resize(CompressedSize);
+  size_t Res =
+      ::ZSTD_compress2(Ctx, CompressedBuffer.data(), CompressedSize,
+                       InputBuffer.data(), InputBuffer.size());
+  ::ZSTD_freeCCtx(Ctx);
+  if (::ZSTD_isError(Res))
+    return createError(::ZSTD_getErrorName(Res));
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented zstd.
+  __msan_unpoison(CompressedBuffer.data(), Res);
+  CompressedBuffer.resize(Res);
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  size_t Res = ::ZSTD_decompress(UncompressedBuffer, UncompressedSize,
+                                 InputBuffer.data(), InputBuffer.size());
+  if (::ZSTD_isError(Res))
+    return createError(::ZSTD_getErrorName(Res));
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented zstd.
+  __msan_unpoison(UncompressedBuffer, Res);
+  UncompressedSize = Res;
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  UncompressedBuffer.resize(UncompressedSize);
+  Error E =
+      uncompress(InputBuffer, UncompressedBuffer.data(), UncompressedSize);
+  UncompressedBuffer.resize(UncompressedSize);
+  return E;
+}
+
+#else
+bool zstd::isAvailable() { return false; }
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level) {
+  llvm_unreachable("zstd::compress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+#endif
+
+StringRef compression::getName(Format F) {
+  switch (F) {
+  case Format::Zlib:
+    return "zlib";
+  case Format::Zstd:
+    return "zstd";
+  }
+  llvm_unreachable("unknown compression format");
+}
+
+const char *compression::getReasonIfUnsupported(Format F) {
+  switch (F) {
+  case Format::Zlib:
+    if (zlib::isAvailable())
+      return nullptr;
+    return "LLVM was not built with LLVM_ENABLE_ZLIB or did not find zlib at "
+           "build time";
+  case Format::Zstd:
+    if (zstd::isAvailable())
+      return nullptr;
+    return "LLVM was not built with LLVM_ENABLE_ZSTD or did not find zstd at "
+           "build time";
+  }
+  llvm_unreachable("unknown compression format");
+}
+
+Error compression::compress(Format F, StringRef InputBuffer,
+                            SmallVectorImpl<char> &CompressedBuffer) {
+  if (const char *Reason = getReasonIfUnsupported(F))
+    return createError(Reason);
+  switch (F) {
+  case Format::Zlib:
+    return zlib::compress(InputBuffer, CompressedBuffer);
+  case Format::Zstd:
+    return zstd::compress(InputBuffer, CompressedBuffer);
+  }
+  llvm_unreachable("unknown compression format");
+}
+
+Error compression::uncompress(Format F, StringRef InputBuffer,
+                              SmallVectorImpl<char> &UncompressedBuffer,
+                              size_t UncompressedSize) {
+  if (const char *Reason = getReasonIfUnsupported(F))
+    return createError(Reason);
+  switch (F) {
+  case Format::Zlib:
+    return zlib::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  case Format::Zstd:
+    return zstd::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  }
+  llvm_unreachable("unknown compression format");
+}
@@ -0,0 +1,114 @@
+//===-- ConcurrentStringPool.cpp - Thread-safe string interning -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the ConcurrentStringPool class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/ConcurrentStringPool.h"
+#include "llvm/Support/xxhash.h"
+#include <cstring>
+
+using namespace llvm;
+
+ConcurrentStringPool::Table::Table(unsigned NumBuckets)
+    : Mask(NumBuckets - 1),
+      Buckets(new std::atomic<const Entry *>[NumBuckets]) {
+  for (unsigned I = 0; I != NumBuckets; ++I)
+    Buckets[I].store(nullptr, std::memory_order_relaxed);
+}
+
+ConcurrentStringPool::ConcurrentStringPool() : Shards(new Shard[NumShards]) {}
+
+ConcurrentStringPool::~ConcurrentStringPool() {}
+
+// The low bits of the hash pick the bucket, and the high bits the shard, so
+// that the strings of a shard are spread over all of its buckets.
+static unsigned getShardIndex(uint64_t Hash) { return Hash >> 58; }
+
+const ConcurrentStringPool::Entry *
+ConcurrentStringPool::find(const Table *T, StringRef S, uint64_t Hash) {
+  if (!T)
+    return nullptr;
+  unsigned ProbeAmt = 1;
+  for (unsigned I = Hash & T->Mask;; I = (I + ProbeAmt++) & T->Mask) {
+    // Pairs with the release store in insert(), so that the contents of the
+    // entry are visible once its pointer is.
+    const Entry *E = T->Buckets[I].load(std::memory_order_acquire);
+    if (!E)
+      return nullptr;
+    if (E->Hash == static_cast<uint32_t>(Hash) && E->getKey() == S)
+      return E;
+  }
+}
+
+void ConcurrentStringPool::insert(Table &T, const Entry *E) {
+  unsigned ProbeAmt = 1;
+  unsigned I = E->Hash & T.Mask;
+  while (T.Buckets[I].load(std::memory_order_relaxed))
+    I = (I + ProbeAmt++) & T.Mask;
+  T.Buckets[I].store(E, std::memory_order_release);
+}
+
+StringRef ConcurrentStringPool::intern(StringRef S) {
+  uint64_t Hash = xxHash64(S);
+  Shard &Sh = Shards[getShardIndex(Hash)];
+
+  // Most strings are interned many times, so first look without the lock.
+  if (const Entry *E =
+          find(Sh.Current.load(std::memory_order_acquire), S, Hash))
+    return E->getKey();
+
+  std::lock_guard<std::mutex> Lock(Sh.Mutex);
+  Table *T = Sh.Current.load(std::memory_order_relaxed);
+  if (const Entry *E = find(T, S, Hash))
+    return E->getKey();
+
+  // Keep the table at most 3/4 full. The larger table is filled before it is
+  // published, so a lookup without the lock sees either table complete.
+  size_t NumEntries = Sh.NumEntries.load(std::memory_order_relaxed);
+  if (!T || (NumEntries + 1) * 4 > (T->Mask + 1) * 3) {
+    auto NewTable = llvm::make_unique<Table>(T ? (T->Mask + 1) * 2 : 16);
+    if (T)
+      for (unsigned I = 0; I <= T->Mask; ++I)
+        if (const Entry *E = T->Buckets[I].load(std::memory_order_relaxed))
+          insert(*NewTable, E);
+    T = NewTable.get();
+    Sh.Tables.push_back(std::move(NewTable));
+    Sh.Current.store(T, std::memory_order_release);
+  }
+
+  auto *E = static_cast<Entry *>(Sh.Alloc.Allocate(
+      sizeof(Entry) + S.size() + 1, alignof(Entry)));
+  E->Length = S.size();
+  E->Hash = static_cast<uint32_t>(Hash);
+  char *Data = reinterpret_cast<char *>(E + 1);
+  if (!S.empty())
+    memcpy(Data, S.data(), S.size());
+  Data[S.size()] = '\0';
+
+  insert(*T, E);
+  Sh.NumEntries.store(NumEntries + 1, std::memory_order_relaxed);
+  return E->getKey();
+}
+
+StringRef ConcurrentStringPool::lookup(StringRef S) const {
+  uint64_t Hash = xxHash64(S);
+  const Shard &Sh = Shards[getShardIndex(Hash)];
+  if (const Entry *E =
+          find(Sh.Current.load(std::memory_order_acquire), S, Hash))
+    return E->getKey();
+  return StringRef();
+}
+
+size_t ConcurrentStringPool::size() const {
+  size_t Size = 0;
+  for (unsigned I = 0; I != NumShards; ++I)
+    Size += Shards[I].NumEntries.load(std::memory_order_relaxed);
+  return Size;
+}
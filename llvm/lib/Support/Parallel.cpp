@@ -12,10 +12,13 @@
 #if LLVM_ENABLE_THREADS
 
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include <atomic>
-#include <stack>
+#include <deque>
+#include <memory>
 #include <thread>
+#include <vector>
 
 namespace llvm {
 namespace parallel {
@@ -29,6 +32,12 @@ public:
   virtual ~Executor() = default;
   virtual void add(std::function<void()> func) = 0;
 
+  /// Blocks until \p L is done.
+  virtual void wait(const Latch &L) { L.sync(); }
+
+  /// Wakes up the threads waiting in wait(). Called when a latch is done.
+  virtual void wake(bool All) {}
+
   static Executor *getDefaultExecutor();
 };
 
@@ -42,6 +51,7 @@ class ConcRTExecutor : public Executor {
 
     static void run(void *P) {
       Taskish *Self = static_cast<Taskish *>(P);
+      timeTraceProfilerAttachThread();
       Self->Task();
       concurrency::Free(Self);
     }
@@ -60,19 +70,28 @@ Executor *Executor::getDefaultExecutor() {
 }
 
 #else
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool.
+///
+/// Each worker has its own deque of tasks. A worker pushes the tasks it spawns
+/// to the back of its deque and runs tasks from the back too, so that nested
+/// tasks run in filo order on the thread that created them. A worker whose
+/// deque is empty steals the oldest task from the front of another worker's
+/// deque. Each deque has its own lock, which is only contended when a task is
+/// stolen, instead of all threads sharing a single queue.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(unsigned ThreadCount = hardware_concurrency())
       : Done(ThreadCount) {
+    for (unsigned I = 0; I < ThreadCount; ++I)
+      Workers.push_back(llvm::make_unique<Worker>());
+
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     std::thread([&, ThreadCount] {
-      for (size_t i = 1; i < ThreadCount; ++i) {
-        std::thread([=] { work(); }).detach();
+      for (unsigned I = 1; I < ThreadCount; ++I) {
+        std::thread([=] { work(I); }).detach();
       }
-      work();
+      work(0);
     }).detach();
   }
 
@@ -85,34 +104,113 @@ public:
   }
 
   void add(std::function<void()> F) override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    WorkStack.push(F);
-    Lock.unlock();
-    Cond.notify_one();
+    // Tasks spawned by a worker go to its own deque. The others are
+    // distributed round-robin.
+    size_t I = CurrentWorker >= 0 ? size_t(CurrentWorker)
+                                  : NextWorker++ % Workers.size();
+    {
+      std::lock_guard<std::mutex> Lock(Workers[I]->Mutex);
+      Workers[I]->Tasks.push_back(std::move(F));
+      ++NumPending;
+    }
+    wake(/*All=*/false);
+  }
+
+  void wait(const Latch &L) override {
+    // Run other tasks while waiting, so that a task that waits for the tasks
+    // it has spawned does not deadlock the pool when all workers do the same.
+    while (!L.isDone()) {
+      if (runTask())
+        continue;
+      sleep([&] { return Stop || NumPending > 0 || L.isDone(); });
+      if (Stop)
+        break;
+    }
+    L.sync();
+  }
+
+  void wake(bool All) override {
+    // A thread that is about to sleep checks for work after incrementing
+    // NumSleeping, so it cannot miss the work if we see no sleeping threads.
+    // Otherwise, taking the lock makes sure that it is already waiting.
+    if (NumSleeping == 0)
+      return;
+    { std::lock_guard<std::mutex> Lock(Mutex); }
+    if (All)
+      Cond.notify_all();
+    else
+      Cond.notify_one();
   }
 
 private:
-  void work() {
+  struct Worker {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+  };
+
+  // Pops a task from the back of this thread's deque or steals one from the
+  // front of another's, and runs it. Returns false if there was no task.
+  bool runTask() {
+    std::function<void()> Task;
+    size_t N = Workers.size();
+    size_t Self = CurrentWorker >= 0 ? CurrentWorker : NextWorker % N;
+    for (size_t I = 0; I < N && !Task; ++I) {
+      Worker &W = *Workers[(Self + I) % N];
+      std::lock_guard<std::mutex> Lock(W.Mutex);
+      if (W.Tasks.empty())
+        continue;
+      if (I == 0 && CurrentWorker >= 0) {
+        Task = std::move(W.Tasks.back());
+        W.Tasks.pop_back();
+      } else {
+        Task = std::move(W.Tasks.front());
+        W.Tasks.pop_front();
+      }
+      --NumPending;
+    }
+    if (!Task)
+      return false;
+
+    // Record the task's time trace events, if any, on this thread's track.
+    timeTraceProfilerAttachThread();
+    Task();
+    return true;
+  }
+
+  template <class PredTy> void sleep(PredTy Pred) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    ++NumSleeping;
+    Cond.wait(Lock, Pred);
+    --NumSleeping;
+  }
+
+  void work(unsigned I) {
+    CurrentWorker = I;
     while (true) {
-      std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
+      if (runTask())
+        continue;
+      sleep([&] { return Stop || NumPending > 0; });
       if (Stop)
         break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
     }
     Done.dec();
   }
 
+  // The index of the worker running on this thread, or -1.
+  static LLVM_THREAD_LOCAL int CurrentWorker;
+
+  std::vector<std::unique_ptr<Worker>> Workers;
+  std::atomic<size_t> NextWorker{0};
+  std::atomic<size_t> NumPending{0};
+  std::atomic<unsigned> NumSleeping{0};
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
   std::mutex Mutex;
   std::condition_variable Cond;
   parallel::detail::Latch Done;
 };
 
+LLVM_THREAD_LOCAL int ThreadPoolExecutor::CurrentWorker = -1;
+
 Executor *Executor::getDefaultExecutor() {
   static ThreadPoolExecutor exec;
   return &exec;
@@ -120,6 +218,7 @@ Executor *Executor::getDefaultExecutor() {
 #endif
 }
 
+#if defined(_MSC_VER)
 static std::atomic<int> TaskGroupInstances;
 
 // Latch::sync() called by the dtor may cause one thread to block. If is a dead
@@ -128,20 +227,89 @@ static std::atomic<int> TaskGroupInstances;
 // of nested parallel_for_each(), only the outermost one runs parallelly.
 TaskGroup::TaskGroup() : Parallel(TaskGroupInstances++ == 0) {}
 TaskGroup::~TaskGroup() { --TaskGroupInstances; }
+#else
+// A thread waiting for a TaskGroup runs other tasks in the meantime, so nested
+// TaskGroups run in parallel too.
+TaskGroup::TaskGroup() : Parallel(true) {}
+TaskGroup::~TaskGroup() { sync(); }
+#endif
 
 void TaskGroup::spawn(std::function<void()> F) {
   if (Parallel) {
     L.inc();
     Executor::getDefaultExecutor()->add([&, F] {
       F();
-      L.dec();
+      // L may be destroyed as soon as it is done, so it is not used after
+      // dec().
+      if (L.dec())
+        Executor::getDefaultExecutor()->wake(/*All=*/true);
     });
   } else {
     F();
   }
 }
 
+void TaskGroup::sync() const { Executor::getDefaultExecutor()->wait(L); }
+
 } // namespace detail
 } // namespace parallel
 } // namespace llvm
 #endif // LLVM_ENABLE_THREADS
+
+using namespace llvm;
+using namespace llvm::parallel;
+
+TaskGraph::TaskId TaskGraph::add(std::function<void()> F,
+                                 ArrayRef<TaskId> Preds) {
+  TaskId Id = Nodes.size();
+  auto N = llvm::make_unique<Node>();
+  N->F = std::move(F);
+  N->NumPreds = Preds.size();
+  for (TaskId Pred : Preds) {
+    assert(Pred < Id && "predecessors must be added first");
+    Nodes[Pred]->Succs.push_back(Id);
+  }
+  Nodes.push_back(std::move(N));
+  return Id;
+}
+
+void TaskGraph::runSequential() {
+  for (std::unique_ptr<Node> &N : Nodes)
+    if (!Cancelled)
+      N->F();
+}
+
+#if LLVM_ENABLE_THREADS
+void TaskGraph::runParallel() {
+  for (std::unique_ptr<Node> &N : Nodes)
+    N->PendingPreds = N->NumPreds;
+
+  // A finished task spawns all but one of the successors it has made ready
+  // and continues with the remaining one on the same thread.
+  detail::TaskGroup TG;
+  std::function<void(Node *)> Run = [&](Node *N) {
+    while (N) {
+      if (!Cancelled)
+        N->F();
+      Node *Next = nullptr;
+      for (TaskId Id : N->Succs) {
+        Node *Succ = Nodes[Id].get();
+        if (--Succ->PendingPreds != 0)
+          continue;
+        if (Next)
+          TG.spawn([&Run, Succ] { Run(Succ); });
+        else
+          Next = Succ;
+      }
+      N = Next;
+    }
+  };
+
+  for (std::unique_ptr<Node> &N : Nodes)
+    if (N->NumPreds == 0) {
+      Node *Root = N.get();
+      TG.spawn([&Run, Root] { Run(Root); });
+    }
+  TG.sync();
+}
+#endif
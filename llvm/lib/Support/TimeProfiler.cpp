@@ -15,6 +15,11 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <string>
@@ -30,7 +35,19 @@ static cl::opt<unsigned> TimeTraceGranularity(
         "Minimum time granularity (in microseconds) traced by time profiler"),
     cl::init(500));
 
-TimeTraceProfiler *TimeTraceProfilerInstance = nullptr;
+LLVM_THREAD_LOCAL TimeTraceProfiler *TimeTraceProfilerInstance = nullptr;
+
+/// The profilers of the worker threads that called
+/// timeTraceProfilerFinishThread, waiting to be written.
+static ManagedStatic<std::vector<TimeTraceProfiler *>> FinishedThreadProfilers;
+static ManagedStatic<sys::SmartMutex<true>> FinishedThreadProfilersLock;
+
+// Odd while a profile is being recorded. Threads attached by
+// timeTraceProfilerAttachThread() remember the generation they attached to,
+// so that they drop their profiler once it is deleted by
+// timeTraceProfilerCleanup().
+static std::atomic<unsigned> ProfileGeneration{0};
+static LLVM_THREAD_LOCAL unsigned ThreadGeneration = 0;
 
 typedef duration<steady_clock::rep, steady_clock::period> DurationType;
 typedef std::pair<size_t, DurationType> CountAndDurationType;
@@ -50,7 +67,7 @@ struct Entry {
 };
 
 struct TimeTraceProfiler {
-  TimeTraceProfiler() {
+  TimeTraceProfiler() : Tid(get_threadid()) {
     StartTime = steady_clock::now();
   }
 
@@ -85,6 +102,7 @@ struct TimeTraceProfiler {
   }
 
   void Write(raw_pwrite_stream &OS) {
+    sys::SmartScopedLock<true> Lock(*FinishedThreadProfilersLock);
     assert(Stack.empty() &&
            "All profiler sections should be ended when calling Write");
     json::OStream J(OS);
@@ -92,28 +110,51 @@ struct TimeTraceProfiler {
     J.attributeBegin("traceEvents");
     J.arrayBegin();
 
-    // Emit all events for the main flame graph.
-    for (const auto &E : Entries) {
-      auto StartUs = duration_cast<microseconds>(E.Start - StartTime).count();
-      auto DurUs = duration_cast<microseconds>(E.Duration).count();
+    // Emit all events for the main flame graph, those of this thread followed
+    // by those of the finished worker threads. All are relative to the start
+    // of this profiler.
+    auto WriteEvents = [&](const TimeTraceProfiler &Profiler) {
+      assert(Profiler.Stack.empty() &&
+             "All profiler sections should be ended when calling Write");
+      for (const auto &E : Profiler.Entries) {
+        auto StartUs =
+            duration_cast<microseconds>(E.Start - StartTime).count();
+        auto DurUs = duration_cast<microseconds>(E.Duration).count();
 
-      J.object([&]{
-        J.attribute("pid", 1);
-        J.attribute("tid", 0);
-        J.attribute("ph", "X");
-        J.attribute("ts", StartUs);
-        J.attribute("dur", DurUs);
-        J.attribute("name", E.Name);
-        J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
-      });
+        J.object([&]{
+          J.attribute("pid", 1);
+          J.attribute("tid", int64_t(Profiler.Tid));
+          J.attribute("ph", "X");
+          J.attribute("ts", StartUs);
+          J.attribute("dur", DurUs);
+          J.attribute("name", E.Name);
+          J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
+        });
+      }
+    };
+    WriteEvents(*this);
+    for (const TimeTraceProfiler *Profiler : *FinishedThreadProfilers)
+      WriteEvents(*Profiler);
+
+    // Merge the totals of all threads.
+    StringMap<CountAndDurationType> AllCountAndTotalPerName =
+        CountAndTotalPerName;
+    uint64_t MaxTid = Tid;
+    for (const TimeTraceProfiler *Profiler : *FinishedThreadProfilers) {
+      for (const auto &E : Profiler->CountAndTotalPerName) {
+        auto &CountAndTotal = AllCountAndTotalPerName[E.getKey()];
+        CountAndTotal.first += E.getValue().first;
+        CountAndTotal.second += E.getValue().second;
+      }
+      MaxTid = std::max(MaxTid, Profiler->Tid);
     }
 
     // Emit totals by section name as additional "thread" events, sorted from
-    // longest one.
-    int Tid = 1;
+    // longest one. Their thread ids follow those of the real threads.
+    uint64_t TotalTid = MaxTid + 1;
     std::vector<NameAndCountAndDurationType> SortedTotals;
-    SortedTotals.reserve(CountAndTotalPerName.size());
-    for (const auto &E : CountAndTotalPerName)
+    SortedTotals.reserve(AllCountAndTotalPerName.size());
+    for (const auto &E : AllCountAndTotalPerName)
       SortedTotals.emplace_back(E.getKey(), E.getValue());
 
     llvm::sort(SortedTotals.begin(), SortedTotals.end(),
@@ -123,11 +164,11 @@ struct TimeTraceProfiler {
                });
     for (const auto &E : SortedTotals) {
       auto DurUs = duration_cast<microseconds>(E.second.second).count();
-      auto Count = CountAndTotalPerName[E.first].first;
+      auto Count = E.second.first;
 
       J.object([&]{
         J.attribute("pid", 1);
-        J.attribute("tid", Tid);
+        J.attribute("tid", int64_t(TotalTid));
         J.attribute("ph", "X");
         J.attribute("ts", 0);
         J.attribute("dur", DurUs);
@@ -138,18 +179,18 @@ struct TimeTraceProfiler {
         });
       });
 
-      ++Tid;
+      ++TotalTid;
     }
 
     // Emit metadata event with process name.
     J.object([&] {
       J.attribute("cat", "");
       J.attribute("pid", 1);
-      J.attribute("tid", 0);
+      J.attribute("tid", int64_t(Tid));
       J.attribute("ts", 0);
       J.attribute("ph", "M");
       J.attribute("name", "process_name");
-      J.attributeObject("args", [&] { J.attribute("name", "clang"); });
+      J.attributeObject("args", [&] { J.attribute("name", ProcName); });
     });
 
     J.arrayEnd();
@@ -161,17 +202,63 @@ struct TimeTraceProfiler {
   SmallVector<Entry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
   time_point<steady_clock> StartTime;
+  std::string ProcName;
+
+  /// The id of the thread this profiler records the events of.
+  uint64_t Tid;
 };
 
-void timeTraceProfilerInitialize() {
+void timeTraceProfilerInitialize(StringRef ProcName) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
   TimeTraceProfilerInstance = new TimeTraceProfiler();
+  TimeTraceProfilerInstance->ProcName = ProcName;
+
+  unsigned Gen = ProfileGeneration.load();
+  while (!(Gen & 1) &&
+         !ProfileGeneration.compare_exchange_weak(Gen, Gen + 1))
+    ;
+  ThreadGeneration = ProfileGeneration.load();
 }
 
 void timeTraceProfilerCleanup() {
   delete TimeTraceProfilerInstance;
   TimeTraceProfilerInstance = nullptr;
+
+  unsigned Gen = ProfileGeneration.load();
+  while ((Gen & 1) && !ProfileGeneration.compare_exchange_weak(Gen, Gen + 1))
+    ;
+  ThreadGeneration = ProfileGeneration.load();
+
+  sys::SmartScopedLock<true> Lock(*FinishedThreadProfilersLock);
+  for (TimeTraceProfiler *Profiler : *FinishedThreadProfilers)
+    delete Profiler;
+  FinishedThreadProfilers->clear();
+}
+
+void timeTraceProfilerFinishThread() {
+  if (TimeTraceProfilerInstance == nullptr)
+    return;
+  sys::SmartScopedLock<true> Lock(*FinishedThreadProfilersLock);
+  FinishedThreadProfilers->push_back(TimeTraceProfilerInstance);
+  TimeTraceProfilerInstance = nullptr;
+}
+
+void timeTraceProfilerAttachThread() {
+  unsigned Gen = ProfileGeneration.load(std::memory_order_relaxed);
+  if (ThreadGeneration == Gen)
+    return;
+
+  // A profiler attached to an earlier profile has been deleted.
+  ThreadGeneration = Gen;
+  TimeTraceProfilerInstance = nullptr;
+  if (!(Gen & 1))
+    return;
+
+  auto *Profiler = new TimeTraceProfiler();
+  sys::SmartScopedLock<true> Lock(*FinishedThreadProfilersLock);
+  FinishedThreadProfilers->push_back(Profiler);
+  TimeTraceProfilerInstance = Profiler;
 }
 
 void timeTraceProfilerWrite(raw_pwrite_stream &OS) {
@@ -19,6 +19,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/Twine.h"
@@ -1197,13 +1198,20 @@ class llvm::vfs::RedirectingFileSystemParser {
     } else { // Advance to the next component
       auto *DE = dyn_cast<RedirectingFileSystem::RedirectingDirectoryEntry>(
           ParentEntry);
-      for (std::unique_ptr<RedirectingFileSystem::Entry> &Content :
-           llvm::make_range(DE->contents_begin(), DE->contents_end())) {
-        auto *DirContent =
-            dyn_cast<RedirectingFileSystem::RedirectingDirectoryEntry>(
-                Content.get());
-        if (DirContent && Name.equals(Content->getName()))
+      if (DE->hasUniqueContentNames()) {
+        if (auto *DirContent =
+                dyn_cast_or_null<RedirectingFileSystem::RedirectingDirectoryEntry>(
+                    DE->lookupContent(Name, /*CaseSensitive=*/true)))
           return DirContent;
+      } else {
+        for (std::unique_ptr<RedirectingFileSystem::Entry> &Content :
+             llvm::make_range(DE->contents_begin(), DE->contents_end())) {
+          auto *DirContent =
+              dyn_cast<RedirectingFileSystem::RedirectingDirectoryEntry>(
+                  Content.get());
+          if (DirContent && Name.equals(Content->getName()))
+            return DirContent;
+        }
       }
     }
 
@@ -1597,6 +1605,33 @@ RedirectingFileSystem::create(std::unique_ptr<MemoryBuffer> Buffer,
   return FS.release();
 }
 
+void RedirectingFileSystem::RedirectingDirectoryEntry::addToIndex(
+    Entry *Content) {
+  if (!HasUniqueContentNames)
+    return;
+  StringRef Name = Content->getName();
+  // A child with an empty name forwards the search of any path to its own
+  // contents, so it can't be found by name.
+  if (Name.empty() ||
+      !ContentsIndex.try_emplace(Name.lower(), Content).second) {
+    HasUniqueContentNames = false;
+    ContentsIndex.clear();
+  }
+}
+
+RedirectingFileSystem::Entry *
+RedirectingFileSystem::RedirectingDirectoryEntry::lookupContent(
+    StringRef Name, bool CaseSensitive) const {
+  assert(HasUniqueContentNames && "Index can't be used");
+  SmallString<64> Key;
+  for (char C : Name)
+    Key.push_back(toLower(C));
+  Entry *Content = ContentsIndex.lookup(Key);
+  if (Content && CaseSensitive && !Name.equals(Content->getName()))
+    return nullptr;
+  return Content;
+}
+
 ErrorOr<RedirectingFileSystem::Entry *>
 RedirectingFileSystem::lookupPath(const Twine &Path_) const {
   SmallString<256> Path;
@@ -1664,6 +1699,16 @@ RedirectingFileSystem::lookupPath(sys::path::const_iterator Start,
   if (!DE)
     return make_error_code(llvm::errc::not_a_directory);
 
+  // When the names of the children are unique, the only child which can match
+  // is the one with the name of the next component.
+  if (DE->hasUniqueContentNames() && !Start->equals(".")) {
+    RedirectingFileSystem::Entry *Content =
+        DE->lookupContent(*Start, CaseSensitive);
+    if (!Content)
+      return make_error_code(llvm::errc::no_such_file_or_directory);
+    return lookupPath(Start, End, Content);
+  }
+
   for (const std::unique_ptr<RedirectingFileSystem::Entry> &DirEntry :
        llvm::make_range(DE->contents_begin(), DE->contents_end())) {
     ErrorOr<RedirectingFileSystem::Entry *> Result =
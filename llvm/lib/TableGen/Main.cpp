@@ -19,7 +19,9 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
@@ -49,6 +51,11 @@ static cl::list<std::string>
 MacroNames("D", cl::desc("Name of the macro to be defined"),
             cl::value_desc("macro name"), cl::Prefix);
 
+static cl::opt<std::string>
+CacheDir("cache-dir",
+         cl::desc("Directory caching the output for unchanged inputs"),
+         cl::value_desc("directory"), cl::init(""));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -59,7 +66,8 @@ static int reportError(const char *ProgName, Twine Msg) {
 ///
 /// This functionality is really only for the benefit of the build system.
 /// It is similar to GCC's `-M*` family of options.
-static int createDependencyFile(const TGParser &Parser, const char *argv0) {
+static int createDependencyFile(ArrayRef<std::string> Dependencies,
+                                const char *argv0) {
   if (OutputFilename == "-")
     return reportError(argv0, "the option -d must be used together with -o\n");
 
@@ -69,15 +77,128 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
   DepOut.os() << OutputFilename << ":";
-  for (const auto &Dep : Parser.getDependencies()) {
-    DepOut.os() << ' ' << Dep.first;
+  for (const std::string &Dep : Dependencies) {
+    DepOut.os() << ' ' << Dep;
   }
   DepOut.os() << "\n";
   DepOut.keep();
   return 0;
 }
 
-int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
+static std::string hashContents(StringRef Contents) {
+  MD5 Hash;
+  Hash.update(Contents);
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  return Result.digest().str();
+}
+
+/// Return the path of the -cache-dir entry for the given command line, or an
+/// empty string if the output cannot be cached.
+///
+/// The output of a backend depends on the records, which only depend on the
+/// input files, and on the command line. The key is the command line, the
+/// working directory the input paths are relative to, and the executable, so
+/// that rebuilding TableGen invalidates the cache.
+static std::string getCacheEntryPath(const char *argv0,
+                                     ArrayRef<const char *> Args) {
+  if (CacheDir.empty() || Args.empty() || InputFilename == "-")
+    return "";
+
+  void *P = (void *)(intptr_t)getCacheEntryPath;
+  std::string Executable = sys::fs::getMainExecutable(argv0, P);
+  sys::fs::file_status Status;
+  if (Executable.empty() || sys::fs::status(Executable, Status))
+    return "";
+
+  SmallString<128> CurrentPath;
+  if (sys::fs::current_path(CurrentPath))
+    return "";
+
+  MD5 Hash;
+  Hash.update(CurrentPath);
+  Hash.update(Executable);
+  Hash.update(utostr(Status.getSize()));
+  Hash.update(utostr(sys::toTimeT(Status.getLastModificationTime())));
+  for (const char *Arg : Args) {
+    Hash.update(StringRef(Arg, strlen(Arg) + 1));
+  }
+  MD5::MD5Result Result;
+  Hash.final(Result);
+
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, Result.digest());
+  return Path.str();
+}
+
+/// A cache entry holds a line with the hash and path of each input file,
+/// starting with the main input, then an empty line and the output.
+///
+/// Returns true, and sets Output and the (sorted) included files, if all the
+/// input files are unchanged.
+static bool readCacheEntry(StringRef EntryPath, std::string &Output,
+                           std::vector<std::string> &Dependencies) {
+  auto EntryOrErr = MemoryBuffer::getFile(EntryPath);
+  if (!EntryOrErr)
+    return false;
+
+  StringRef Rest = (*EntryOrErr)->getBuffer();
+  std::vector<std::string> Files;
+  while (true) {
+    StringRef Line;
+    std::tie(Line, Rest) = Rest.split('\n');
+    if (Line.empty())
+      break;
+    StringRef Hash, Path;
+    std::tie(Hash, Path) = Line.split(' ');
+    auto FileOrErr = MemoryBuffer::getFile(Path);
+    if (!FileOrErr || hashContents((*FileOrErr)->getBuffer()) != Hash)
+      return false;
+    Files.push_back(Path);
+  }
+  if (Files.empty())
+    return false;
+
+  Output = Rest;
+  Dependencies.assign(Files.begin() + 1, Files.end());
+  llvm::sort(Dependencies);
+  return true;
+}
+
+/// Store Output in the cache entry, keyed by the files that SrcMgr has read.
+/// The cache is only an optimization, so failures are ignored.
+static void writeCacheEntry(StringRef EntryPath, StringRef Output) {
+  if (sys::fs::create_directories(CacheDir))
+    return;
+  Expected<sys::fs::TempFile> Temp =
+      sys::fs::TempFile::create(EntryPath + ".tmp-%%%%%%%");
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+
+  raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+  for (unsigned I = 1, E = SrcMgr.getNumBuffers(); I <= E; ++I) {
+    const MemoryBuffer *Buf = SrcMgr.getMemoryBuffer(I);
+    OS << hashContents(Buf->getBuffer()) << ' ' << Buf->getBufferIdentifier()
+       << '\n';
+  }
+  OS << '\n' << Output;
+  OS.flush();
+
+  if (OS.has_error()) {
+    OS.clear_error();
+    consumeError(Temp->discard());
+    return;
+  }
+  consumeError(Temp->keep(EntryPath));
+}
+
+/// Parse the input file and run MainFn, writing its output to OutString and
+/// the included files to Dependencies.
+static int runTableGen(const char *argv0, TableGenMainFn *MainFn,
+                       std::string &OutString,
+                       std::vector<std::string> &Dependencies) {
   RecordKeeper Records;
 
   // Parse the input file.
@@ -100,17 +221,36 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
     return 1;
 
   // Write output to memory.
-  std::string OutString;
   raw_string_ostream Out(OutString);
   if (MainFn(Out, Records))
     return 1;
+  Out.flush();
+
+  for (const auto &Dep : Parser.getDependencies())
+    Dependencies.push_back(Dep.first);
+  return 0;
+}
+
+int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn,
+                       ArrayRef<const char *> Args) {
+  std::string OutString;
+  std::vector<std::string> Dependencies;
+  std::string CacheEntryPath = getCacheEntryPath(argv0, Args);
+  if (CacheEntryPath.empty() ||
+      !readCacheEntry(CacheEntryPath, OutString, Dependencies)) {
+    OutString.clear();
+    if (int Ret = runTableGen(argv0, MainFn, OutString, Dependencies))
+      return Ret;
+    if (!CacheEntryPath.empty() && ErrorsPrinted == 0)
+      writeCacheEntry(CacheEntryPath, OutString);
+  }
 
   // Always write the depfile, even if the main output hasn't changed.
   // If it's missing, Ninja considers the output dirty.  If this was below
   // the early exit below and someone deleted the .inc.d file but not the .inc
   // file, tablegen would never write the depfile.
   if (!DependFilename.empty()) {
-    if (int Ret = createDependencyFile(Parser, argv0))
+    if (int Ret = createDependencyFile(Dependencies, argv0))
       return Ret;
   }
 
@@ -118,7 +258,7 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
   // This prevents recompilation of all the files depending on it if there
   // aren't any.
   if (auto ExistingOrErr = MemoryBuffer::getFile(OutputFilename))
-    if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
+    if (std::move(ExistingOrErr.get())->getBuffer() == OutString)
       return 0;
 
   std::error_code EC;
@@ -126,7 +266,7 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
   if (EC)
     return reportError(argv0, "error opening " + OutputFilename + ":" +
                                   EC.message() + "\n");
-  OutFile.os() << Out.str();
+  OutFile.os() << OutString;
 
   if (ErrorsPrinted > 0)
     return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
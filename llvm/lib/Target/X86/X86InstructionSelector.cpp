@@ -90,8 +90,8 @@ private:
                  MachineFunction &MF) const;
   bool selectFCmp(MachineInstr &I, MachineRegisterInfo &MRI,
                   MachineFunction &MF) const;
-  bool selectUadde(MachineInstr &I, MachineRegisterInfo &MRI,
-                   MachineFunction &MF) const;
+  bool selectUAddSub(MachineInstr &I, MachineRegisterInfo &MRI,
+                     MachineFunction &MF) const;
   bool selectCopy(MachineInstr &I, MachineRegisterInfo &MRI) const;
   bool selectUnmergeValues(MachineInstr &I, MachineRegisterInfo &MRI,
                            MachineFunction &MF,
@@ -105,6 +105,8 @@ private:
                      MachineFunction &MF) const;
   bool selectCondBranch(MachineInstr &I, MachineRegisterInfo &MRI,
                         MachineFunction &MF) const;
+  bool selectSelect(MachineInstr &I, MachineRegisterInfo &MRI,
+                    MachineFunction &MF) const;
   bool selectTurnIntoCOPY(MachineInstr &I, MachineRegisterInfo &MRI,
                           const unsigned DstReg,
                           const TargetRegisterClass *DstRC,
@@ -368,7 +370,10 @@ bool X86InstructionSelector::select(MachineInstr &I,
   case TargetOpcode::G_FCMP:
     return selectFCmp(I, MRI, MF);
   case TargetOpcode::G_UADDE:
-    return selectUadde(I, MRI, MF);
+  case TargetOpcode::G_UADDO:
+  case TargetOpcode::G_USUBE:
+  case TargetOpcode::G_USUBO:
+    return selectUAddSub(I, MRI, MF);
   case TargetOpcode::G_UNMERGE_VALUES:
     return selectUnmergeValues(I, MRI, MF, CoverageInfo);
   case TargetOpcode::G_MERGE_VALUES:
@@ -380,6 +385,8 @@ bool X86InstructionSelector::select(MachineInstr &I,
     return selectInsert(I, MRI, MF);
   case TargetOpcode::G_BRCOND:
     return selectCondBranch(I, MRI, MF);
+  case TargetOpcode::G_SELECT:
+    return selectSelect(I, MRI, MF);
   case TargetOpcode::G_IMPLICIT_DEF:
   case TargetOpcode::G_PHI:
     return selectImplicitDefOrPHI(I, MRI);
@@ -1084,59 +1091,79 @@ bool X86InstructionSelector::selectFCmp(MachineInstr &I,
   return true;
 }
 
-bool X86InstructionSelector::selectUadde(MachineInstr &I,
-                                         MachineRegisterInfo &MRI,
-                                         MachineFunction &MF) const {
-  assert((I.getOpcode() == TargetOpcode::G_UADDE) && "unexpected instruction");
+bool X86InstructionSelector::selectUAddSub(MachineInstr &I,
+                                           MachineRegisterInfo &MRI,
+                                           MachineFunction &MF) const {
+  assert((I.getOpcode() == TargetOpcode::G_UADDE ||
+          I.getOpcode() == TargetOpcode::G_UADDO ||
+          I.getOpcode() == TargetOpcode::G_USUBE ||
+          I.getOpcode() == TargetOpcode::G_USUBO) &&
+         "unexpected instruction");
 
   const unsigned DstReg = I.getOperand(0).getReg();
   const unsigned CarryOutReg = I.getOperand(1).getReg();
   const unsigned Op0Reg = I.getOperand(2).getReg();
   const unsigned Op1Reg = I.getOperand(3).getReg();
-  unsigned CarryInReg = I.getOperand(4).getReg();
 
   const LLT DstTy = MRI.getType(DstReg);
+  const bool IsSub = I.getOpcode() == TargetOpcode::G_USUBE ||
+                     I.getOpcode() == TargetOpcode::G_USUBO;
 
-  if (DstTy != LLT::scalar(32))
+  unsigned OpNoCarry, OpCarry;
+  switch (DstTy.getSizeInBits()) {
+  case 8:
+    OpNoCarry = IsSub ? X86::SUB8rr : X86::ADD8rr;
+    OpCarry = IsSub ? X86::SBB8rr : X86::ADC8rr;
+    break;
+  case 16:
+    OpNoCarry = IsSub ? X86::SUB16rr : X86::ADD16rr;
+    OpCarry = IsSub ? X86::SBB16rr : X86::ADC16rr;
+    break;
+  case 32:
+    OpNoCarry = IsSub ? X86::SUB32rr : X86::ADD32rr;
+    OpCarry = IsSub ? X86::SBB32rr : X86::ADC32rr;
+    break;
+  case 64:
+    OpNoCarry = IsSub ? X86::SUB64rr : X86::ADD64rr;
+    OpCarry = IsSub ? X86::SBB64rr : X86::ADC64rr;
+    break;
+  default:
     return false;
-
-  // find CarryIn def instruction.
-  MachineInstr *Def = MRI.getVRegDef(CarryInReg);
-  while (Def->getOpcode() == TargetOpcode::G_TRUNC) {
-    CarryInReg = Def->getOperand(1).getReg();
-    Def = MRI.getVRegDef(CarryInReg);
   }
 
-  unsigned Opcode;
-  if (Def->getOpcode() == TargetOpcode::G_UADDE) {
-    // carry set by prev ADD.
-
-    BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(X86::COPY), X86::EFLAGS)
-        .addReg(CarryInReg);
-
-    if (!RBI.constrainGenericRegister(CarryInReg, X86::GR32RegClass, MRI))
-      return false;
-
-    Opcode = X86::ADC32rr;
-  } else if (auto val = getConstantVRegVal(CarryInReg, MRI)) {
-    // carry is constant, support only 0.
-    if (*val != 0)
-      return false;
-
-    Opcode = X86::ADD32rr;
-  } else
-    return false;
+  unsigned Opcode = OpNoCarry;
+  if (I.getOpcode() == TargetOpcode::G_UADDE ||
+      I.getOpcode() == TargetOpcode::G_USUBE) {
+    unsigned CarryInReg = I.getOperand(4).getReg();
+    if (auto val = getConstantVRegVal(CarryInReg, MRI)) {
+      // carry is constant, support only 0.
+      if (*val != 0)
+        return false;
+    } else {
+      // Set CF from the carry-in: adding 255 to it carries out iff it is 1.
+      unsigned TmpReg = MRI.createVirtualRegister(&X86::GR8RegClass);
+      BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(X86::ADD8ri))
+          .addDef(TmpReg, RegState::Dead)
+          .addReg(CarryInReg)
+          .addImm(-1);
+      if (!RBI.constrainGenericRegister(CarryInReg, X86::GR8RegClass, MRI))
+        return false;
+
+      Opcode = OpCarry;
+    }
+  }
 
   MachineInstr &AddInst =
       *BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(Opcode), DstReg)
            .addReg(Op0Reg)
            .addReg(Op1Reg);
 
-  BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(X86::COPY), CarryOutReg)
-      .addReg(X86::EFLAGS);
+  BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(X86::SETCCr),
+          CarryOutReg)
+      .addImm(X86::COND_B);
 
   if (!constrainSelectedInstRegOperands(AddInst, TII, TRI, RBI) ||
-      !RBI.constrainGenericRegister(CarryOutReg, X86::GR32RegClass, MRI))
+      !RBI.constrainGenericRegister(CarryOutReg, X86::GR8RegClass, MRI))
     return false;
 
   I.eraseFromParent();
@@ -1431,6 +1458,57 @@ bool X86InstructionSelector::selectCondBranch(MachineInstr &I,
   return true;
 }
 
+bool X86InstructionSelector::selectSelect(MachineInstr &I,
+                                          MachineRegisterInfo &MRI,
+                                          MachineFunction &MF) const {
+  assert((I.getOpcode() == TargetOpcode::G_SELECT) && "unexpected instruction");
+
+  const unsigned DstReg = I.getOperand(0).getReg();
+  const unsigned CondReg = I.getOperand(1).getReg();
+  const unsigned TrueReg = I.getOperand(2).getReg();
+  const unsigned FalseReg = I.getOperand(3).getReg();
+
+  const LLT DstTy = MRI.getType(DstReg);
+  const RegisterBank &DstRB = *RBI.getRegBank(DstReg, MRI, TRI);
+
+  if (DstRB.getID() != X86::GPRRegBankID || !STI.hasCMov())
+    return false;
+
+  unsigned OpCmov;
+  switch (DstTy.getSizeInBits()) {
+  case 16:
+    OpCmov = X86::CMOV16rr;
+    break;
+  case 32:
+    OpCmov = X86::CMOV32rr;
+    break;
+  case 64:
+    OpCmov = X86::CMOV64rr;
+    break;
+  default:
+    return false;
+  }
+
+  MachineInstr &TestInst =
+      *BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(X86::TEST8ri))
+           .addReg(CondReg)
+           .addImm(1);
+  // CMOV replaces its first operand, the false value, when the condition
+  // holds.
+  MachineInstr &CmovInst =
+      *BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(OpCmov), DstReg)
+           .addReg(FalseReg)
+           .addReg(TrueReg)
+           .addImm(X86::COND_NE);
+
+  if (!constrainSelectedInstRegOperands(TestInst, TII, TRI, RBI) ||
+      !constrainSelectedInstRegOperands(CmovInst, TII, TRI, RBI))
+    return false;
+
+  I.eraseFromParent();
+  return true;
+}
+
 bool X86InstructionSelector::materializeFP(MachineInstr &I,
                                            MachineRegisterInfo &MRI,
                                            MachineFunction &MF) const {
@@ -80,6 +80,8 @@ X86LegalizerInfo::X86LegalizerInfo(const X86Subtarget &STI,
       G_GEP, 1, widenToLargerTypesUnsupportedOtherwise);
   setLegalizeScalarToDifferentSizeStrategy(
       G_CONSTANT, 0, widenToLargerTypesAndNarrowToLargest);
+  setLegalizeScalarToDifferentSizeStrategy(
+      G_SELECT, 0, widenToLargerTypesUnsupportedOtherwise);
 
   computeTables();
   verify(*STI.getInstrInfo());
@@ -123,8 +125,9 @@ void X86LegalizerInfo::setLegalizerInfo32bit() {
     for (auto Ty : {s8, s16, s32})
       setAction({BinOp, Ty}, Legal);
 
-  for (unsigned Op : {G_UADDE}) {
-    setAction({Op, s32}, Legal);
+  for (unsigned Op : {G_UADDE, G_UADDO, G_USUBE, G_USUBO}) {
+    for (auto Ty : {s8, s16, s32})
+      setAction({Op, Ty}, Legal);
     setAction({Op, 1, s1}, Legal);
   }
 
@@ -166,6 +169,11 @@ void X86LegalizerInfo::setLegalizerInfo32bit() {
   // Control-flow
   setAction({G_BRCOND, s1}, Legal);
 
+  // Select, which needs CMOV.
+  for (auto Ty : {s16, s32, p0})
+    setAction({G_SELECT, Ty}, Legal);
+  setAction({G_SELECT, 1, s1}, Legal);
+
   // Constants
   for (auto Ty : {s8, s16, s32, p0})
     setAction({TargetOpcode::G_CONSTANT, Ty}, Legal);
@@ -218,9 +226,14 @@ void X86LegalizerInfo::setLegalizerInfo64bit() {
   for (unsigned BinOp : {G_ADD, G_SUB, G_MUL, G_AND, G_OR, G_XOR})
     setAction({BinOp, s64}, Legal);
 
+  for (unsigned Op : {G_UADDE, G_UADDO, G_USUBE, G_USUBO})
+    setAction({Op, s64}, Legal);
+
   for (unsigned MemOp : {G_LOAD, G_STORE})
     setAction({MemOp, s64}, Legal);
 
+  setAction({G_SELECT, s64}, Legal);
+
   // Pointer-handling
   setAction({G_GEP, 1, s64}, Legal);
   getActionDefinitionsBuilder(G_PTRTOINT)
@@ -300,6 +313,12 @@ void X86LegalizerInfo::setLegalizerInfoSSE1() {
   // Constants
   setAction({TargetOpcode::G_FCONSTANT, s32}, Legal);
 
+  // Negation is lowered to a subtraction from -0.0.
+  if (Subtarget.hasSSE2())
+    getActionDefinitionsBuilder(G_FNEG).lowerFor({s32, s64});
+  else
+    getActionDefinitionsBuilder(G_FNEG).lowerFor({s32});
+
   // Merge/Unmerge
   for (const auto &Ty : {v4s32, v2s64}) {
     setAction({G_CONCAT_VECTORS, Ty}, Legal);
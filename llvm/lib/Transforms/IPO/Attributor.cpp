@@ -16,10 +16,12 @@
 #include "llvm/Transforms/IPO/Attributor.h"
 
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/SCCIterator.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/CallGraph.h"
 #include "llvm/Analysis/GlobalsModRef.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Argument.h"
@@ -29,6 +31,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 
@@ -40,6 +43,12 @@ STATISTIC(NumFnWithExactDefinition,
           "Number of function with exact definitions");
 STATISTIC(NumFnWithoutExactDefinition,
           "Number of function without exact definitions");
+STATISTIC(NumFixpointIterations, "Number of fixpoint iterations performed");
+STATISTIC(NumFixpointTimeouts,
+          "Number of fixpoint iterations stopped by the iteration limit");
+STATISTIC(NumAttributeUpdates, "Number of abstract attribute updates");
+STATISTIC(NumAttributeUpdatesChanged,
+          "Number of abstract attribute updates that changed the state");
 STATISTIC(NumAttributesTimedOut,
           "Number of abstract attributes timed out before fixpoint");
 STATISTIC(NumAttributesValidFixpoint,
@@ -1353,6 +1362,8 @@ bool Attributor::checkForAllCallSites(Function &F,
 }
 
 ChangeStatus Attributor::run() {
+  TimeTraceScope TimeScope("Attributor");
+
   // Initialize all abstract attributes.
   for (AbstractAttribute *AA : AllAbstractAttributes)
     AA->initialize(*this);
@@ -1375,20 +1386,30 @@ ChangeStatus Attributor::run() {
                       << ", Worklist size: " << Worklist.size() << "\n");
 
     // Add all abstract attributes that are potentially dependent on one that
-    // changed to the work list.
+    // changed to the work list. The dependences are dropped here; the
+    // dependent attributes record them again if they still query the changed
+    // one in their update. This keeps stale dependences from scheduling
+    // updates that cannot change anything.
     for (AbstractAttribute *ChangedAA : ChangedAAs) {
       auto &QuerriedAAs = QueryMap[ChangedAA];
       Worklist.insert(QuerriedAAs.begin(), QuerriedAAs.end());
+      QuerriedAAs.clear();
     }
 
     // Reset the changed set.
     ChangedAAs.clear();
 
     // Update all abstract attribute in the work list and record the ones that
-    // changed.
-    for (AbstractAttribute *AA : Worklist)
-      if (AA->update(*this) == ChangeStatus::CHANGED)
+    // changed. Attributes already at a fixpoint cannot change anymore.
+    for (AbstractAttribute *AA : Worklist) {
+      if (AA->getState().isAtFixpoint())
+        continue;
+      ++NumAttributeUpdates;
+      if (AA->update(*this) == ChangeStatus::CHANGED) {
+        ++NumAttributeUpdatesChanged;
         ChangedAAs.push_back(AA);
+      }
+    }
 
     // Reset the work list and repopulate with the changed abstract attributes.
     // Note that dependent ones are added above.
@@ -1401,7 +1422,10 @@ ChangeStatus Attributor::run() {
                     << IterationCounter << "/" << MaxFixpointIterations
                     << " iterations\n");
 
+  NumFixpointIterations += IterationCounter;
   bool FinishedAtFixpoint = Worklist.empty();
+  if (!FinishedAtFixpoint)
+    ++NumFixpointTimeouts;
 
   // Reset abstract arguments not settled in a sound fixpoint by now. This
   // happens when we stopped the fixpoint iteration early. Note that only the
@@ -1622,7 +1646,24 @@ static bool runAttributorOnModule(Module &M) {
   Attributor A;
   InformationCache InfoCache;
 
-  for (Function &F : M) {
+  // Visit the functions bottom-up in the call graph. The abstract attributes
+  // are updated in the order they are identified, so in each fixpoint
+  // iteration callers see the state their callees reached in that iteration
+  // instead of the one from the iteration before.
+  // Functions not reachable in the call graph are visited last.
+  SmallSetVector<Function *, 64> Functions;
+  CallGraph CG(M);
+  for (scc_iterator<CallGraph *> SCCI = scc_begin(&CG); !SCCI.isAtEnd();
+       ++SCCI)
+    for (CallGraphNode *Node : *SCCI)
+      if (Function *F = Node->getFunction())
+        Functions.insert(F);
+  for (Function &F : M)
+    Functions.insert(&F);
+
+  for (Function *FPtr : Functions) {
+    Function &F = *FPtr;
+
     // TODO: Not all attributes require an exact definition. Find a way to
     //       enable deduction for some but not all attributes in case the
     //       definition might be changed at runtime, see also
@@ -41,6 +41,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -54,6 +55,7 @@
 #include <system_error>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace llvm;
 
@@ -614,6 +616,19 @@ static unsigned numGlobalVarSummaries(const ModuleSummaryIndex &Index,
 }
 #endif
 
+/// Returns true if the imports of the modules must be computed one at a time:
+/// -import-cutoff counts the imports of all modules, and the debug output of
+/// the modules must not be interleaved.
+static bool mustComputeImportsSerially() {
+  if (ImportCutoff >= 0 || PrintImportFailures)
+    return true;
+#ifndef NDEBUG
+  if (DebugFlag)
+    return true;
+#endif
+  return false;
+}
+
 /// Compute all the import and export for every module using the Index.
 void llvm::ComputeCrossModuleImport(
     const ModuleSummaryIndex &Index,
@@ -621,14 +636,35 @@ void llvm::ComputeCrossModuleImport(
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
   // For each module that has function defined, compute the import/export lists.
+  // The index is only read here, so the modules are processed in parallel.
+  // Each module records its exports in lists of its own, which are merged in
+  // module order afterwards so that the result does not depend on the
+  // schedule. The entries of ImportLists are created up front, as a StringMap
+  // cannot be modified concurrently.
+  std::vector<const StringMapEntry<GVSummaryMapTy> *> Modules;
+  std::vector<FunctionImporter::ImportMapTy *> ModuleImportLists;
   for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first()];
-    LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first() << "'\n");
-    ComputeImportForModule(DefinedGVSummaries.second, Index,
-                           DefinedGVSummaries.first(), ImportList,
-                           &ExportLists);
+    Modules.push_back(&DefinedGVSummaries);
+    ModuleImportLists.push_back(&ImportLists[DefinedGVSummaries.first()]);
   }
+  std::vector<StringMap<FunctionImporter::ExportSetTy>> ModuleExportLists(
+      Modules.size());
+  auto ComputeForModule = [&](size_t I) {
+    LLVM_DEBUG(dbgs() << "Computing import for Module '"
+                      << Modules[I]->first() << "'\n");
+    ComputeImportForModule(Modules[I]->second, Index, Modules[I]->first(),
+                           *ModuleImportLists[I], &ModuleExportLists[I]);
+  };
+  if (mustComputeImportsSerially())
+    parallel::for_each_n(parallel::seq, size_t(0), Modules.size(),
+                         ComputeForModule);
+  else
+    parallel::for_each_n(parallel::par, size_t(0), Modules.size(),
+                         ComputeForModule);
+
+  for (auto &Exports : ModuleExportLists)
+    for (auto &ELI : Exports)
+      ExportLists[ELI.first()].insert(ELI.second.begin(), ELI.second.end());
 
   // When computing imports we added all GUIDs referenced by anything
   // imported from the module to its ExportList. Now we prune each ExportList
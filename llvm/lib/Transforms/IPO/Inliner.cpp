@@ -76,6 +76,8 @@ STATISTIC(NumInlined, "Number of functions inlined");
 STATISTIC(NumCallsDeleted, "Number of call sites deleted, not inlined");
 STATISTIC(NumDeleted, "Number of functions deleted because all callers found");
 STATISTIC(NumMergedAllocas, "Number of allocas merged together");
+STATISTIC(NumOverGrowthBudget,
+          "Number of call sites not inlined because of the growth budget");
 
 // This weirdly named statistic tracks the number of times that, when attempting
 // to inline a function A into B, we analyze the callers of B in order to see
@@ -120,6 +122,68 @@ static cl::opt<bool>
                                    " callsites processed by inliner but decided"
                                    " to be not inlined"));
 
+static cl::opt<unsigned> InlineModuleGrowthBudget(
+    "inline-module-growth-budget", cl::init(0), cl::Hidden,
+    cl::desc("Stop inlining, except for always-inline call sites, once the "
+             "inlined callees add up to this percentage of the size of the "
+             "module before inlining (0 means no limit)"));
+
+static cl::opt<bool> InlineGrowthReport(
+    "inline-growth-report", cl::init(false), cl::Hidden,
+    cl::desc("Emit a remark with the growth caused by each inlining, and "
+             "print the inlined callees ranked by the growth they caused"));
+
+void InlineGrowthTracker::setModuleInfo(Module &M) {
+  if (HasModule || (!InlineModuleGrowthBudget && !InlineGrowthReport))
+    return;
+  HasModule = true;
+  ModuleName = M.getName();
+  ModuleSize = M.getInstructionCount();
+}
+
+bool InlineGrowthTracker::isWithinBudget(unsigned Size) const {
+  if (!InlineModuleGrowthBudget)
+    return true;
+  return (Growth + Size) * 100 <= ModuleSize * InlineModuleGrowthBudget;
+}
+
+void InlineGrowthTracker::recordInline(const Function &Callee, unsigned Size) {
+  if (!HasModule)
+    return;
+  Growth += Size;
+  if (InlineGrowthReport) {
+    CalleeGrowth &Entry = Callees[Callee.getName()];
+    ++Entry.NumInlines;
+    Entry.Growth += Size;
+  }
+}
+
+void InlineGrowthTracker::dump() const {
+  if (!InlineGrowthReport || !HasModule)
+    return;
+
+  std::vector<const StringMapEntry<CalleeGrowth> *> Sorted;
+  for (const auto &Entry : Callees)
+    Sorted.push_back(&Entry);
+  llvm::sort(Sorted, [](const StringMapEntry<CalleeGrowth> *L,
+                        const StringMapEntry<CalleeGrowth> *R) {
+    if (L->second.Growth != R->second.Growth)
+      return L->second.Growth > R->second.Growth;
+    return L->first() < R->first();
+  });
+
+  std::string Out;
+  raw_string_ostream OS(Out);
+  OS << "------- Inline growth report for [" << ModuleName << "] -------\n"
+     << "Instructions before inlining: " << ModuleSize << "\n"
+     << "Instructions added by inlining: " << Growth << "\n";
+  for (const StringMapEntry<CalleeGrowth> *Entry : Sorted)
+    OS << "Inlined [" << Entry->first() << "]: #inlines = "
+       << Entry->second.NumInlines
+       << ", #instructions added = " << Entry->second.Growth << "\n";
+  errs() << OS.str();
+}
+
 LegacyInlinerBase::LegacyInlinerBase(char &ID) : CallGraphSCCPass(ID) {}
 
 LegacyInlinerBase::LegacyInlinerBase(char &ID, bool InsertLifetime)
@@ -524,6 +588,44 @@ static void setInlineRemark(CallSite &CS, StringRef message) {
   CS.addAttribute(AttributeList::FunctionIndex, attr);
 }
 
+/// Return true if inlining a callee of \p Size instructions at \p CS, which
+/// has cost \p IC, stays within -inline-module-growth-budget. Otherwise
+/// report why the call site is not inlined.
+static bool isWithinGrowthBudget(CallSite CS, const InlineCost &IC,
+                                 unsigned Size,
+                                 const InlineGrowthTracker &GrowthTracker,
+                                 OptimizationRemarkEmitter &ORE) {
+  if (IC.isAlways() || GrowthTracker.isWithinBudget(Size))
+    return true;
+
+  using namespace ore;
+  ++NumOverGrowthBudget;
+  setInlineRemark(CS, "module growth budget exhausted");
+  Instruction *Call = CS.getInstruction();
+  ORE.emit([&]() {
+    return OptimizationRemarkMissed(DEBUG_TYPE, "GrowthBudgetExhausted", Call)
+           << NV("Callee", CS.getCalledFunction())
+           << " will not be inlined into " << NV("Caller", CS.getCaller())
+           << " because the module growth budget is exhausted";
+  });
+  return false;
+}
+
+static void emitInlineGrowth(OptimizationRemarkEmitter &ORE, DebugLoc &DLoc,
+                             const BasicBlock *Block, const Function &Callee,
+                             const Function &Caller, unsigned Size) {
+  if (!InlineGrowthReport)
+    return;
+
+  using namespace ore;
+  ORE.emit([&]() {
+    return OptimizationRemarkAnalysis(DEBUG_TYPE, "InlineGrowth", DLoc, Block)
+           << "inlining " << NV("Callee", &Callee) << " into "
+           << NV("Caller", &Caller) << " added " << NV("Growth", Size)
+           << " instructions";
+  });
+}
+
 static bool
 inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
                 std::function<AssumptionCache &(Function &)> GetAssumptionCache,
@@ -531,7 +633,8 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
                 bool InsertLifetime,
                 function_ref<InlineCost(CallSite CS)> GetInlineCost,
                 function_ref<AAResults &(Function &)> AARGetter,
-                ImportedFunctionsInliningStatistics &ImportedFunctionsStats) {
+                ImportedFunctionsInliningStatistics &ImportedFunctionsStats,
+                InlineGrowthTracker &GrowthTracker) {
   SmallPtrSet<Function *, 8> SCCFunctions;
   LLVM_DEBUG(dbgs() << "Inliner visiting SCC:");
   for (CallGraphNode *Node : SCC) {
@@ -675,6 +778,10 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
         Instr->eraseFromParent();
         ++NumCallsDeleted;
       } else {
+        unsigned CalleeSize = Callee->getInstructionCount();
+        if (!isWithinGrowthBudget(CS, *OIC, CalleeSize, GrowthTracker, ORE))
+          continue;
+
         // Get DebugLoc to report. CS will be invalid after Inliner.
         DebugLoc DLoc = CS->getDebugLoc();
         BasicBlock *Block = CS.getParent();
@@ -696,8 +803,10 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
           continue;
         }
         ++NumInlined;
+        GrowthTracker.recordInline(*Callee, CalleeSize);
 
         emit_inlined_into(ORE, DLoc, Block, *Callee, *Caller, *OIC);
+        emitInlineGrowth(ORE, DLoc, Block, *Callee, *Caller, CalleeSize);
 
         // If inlining this function gave us any new call sites, throw them
         // onto our worklist to process.  They are useful inline candidates.
@@ -761,9 +870,11 @@ bool LegacyInlinerBase::inlineCalls(CallGraphSCC &SCC) {
   auto GetAssumptionCache = [&](Function &F) -> AssumptionCache & {
     return ACT->getAssumptionCache(F);
   };
+  GrowthTracker.setModuleInfo(CG.getModule());
   return inlineCallsImpl(SCC, CG, GetAssumptionCache, PSI, TLI, InsertLifetime,
                          [this](CallSite CS) { return getInlineCost(CS); },
-                         LegacyAARGetter(*this), ImportedFunctionsStats);
+                         LegacyAARGetter(*this), ImportedFunctionsStats,
+                         GrowthTracker);
 }
 
 /// Remove now-dead linkonce functions at the end of
@@ -772,6 +883,7 @@ bool LegacyInlinerBase::doFinalization(CallGraph &CG) {
   if (InlinerFunctionImportStats != InlinerFunctionImportStatsOpts::No)
     ImportedFunctionsStats.dump(InlinerFunctionImportStats ==
                                 InlinerFunctionImportStatsOpts::Verbose);
+  GrowthTracker.dump();
   return removeDeadFunctions(CG);
 }
 
@@ -863,6 +975,7 @@ InlinerPass::~InlinerPass() {
     ImportedFunctionsStats->dump(InlinerFunctionImportStats ==
                                  InlinerFunctionImportStatsOpts::Verbose);
   }
+  GrowthTracker.dump();
 }
 
 PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
@@ -882,6 +995,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
         llvm::make_unique<ImportedFunctionsInliningStatistics>();
     ImportedFunctionsStats->setModuleInfo(M);
   }
+  GrowthTracker.setModuleInfo(M);
 
   // We use a single common worklist for calls across the entire SCC. We
   // process these in-order and append new calls introduced during inlining to
@@ -1057,6 +1171,10 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
         continue;
       }
 
+      unsigned CalleeSize = Callee.getInstructionCount();
+      if (!isWithinGrowthBudget(CS, *OIC, CalleeSize, GrowthTracker, ORE))
+        continue;
+
       // Setup the data structure used to plumb customization into the
       // `InlineFunction` routine.
       InlineFunctionInfo IFI(
@@ -1084,8 +1202,10 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       InlinedCallees.insert(&Callee);
 
       ++NumInlined;
+      GrowthTracker.recordInline(Callee, CalleeSize);
 
       emit_inlined_into(ORE, DLoc, Block, Callee, F, *OIC);
+      emitInlineGrowth(ORE, DLoc, Block, Callee, F, CalleeSize);
 
       // Add any new callsites to defined functions to the worklist.
       if (!IFI.InlinedCallSites.empty()) {
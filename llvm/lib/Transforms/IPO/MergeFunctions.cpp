@@ -137,6 +137,8 @@ STATISTIC(NumFunctionsMerged, "Number of functions merged");
 STATISTIC(NumThunksWritten, "Number of thunks generated");
 STATISTIC(NumAliasesWritten, "Number of aliases generated");
 STATISTIC(NumDoubleWeak, "Number of new functions created");
+STATISTIC(NumUniqueHashes, "Number of functions skipped for a unique hash");
+STATISTIC(NumFunctionComparisons, "Number of full function comparisons");
 
 static cl::opt<unsigned> NumFunctionsForSanityCheck(
     "mergefunc-sanity",
@@ -219,6 +221,7 @@ private:
       // Order first by hashes, then full function comparison.
       if (LHS.getHash() != RHS.getHash())
         return LHS.getHash() < RHS.getHash();
+      ++NumFunctionComparisons;
       FunctionComparator FCmp(LHS.getFunc(), RHS.getFunc(), GlobalNumbers);
       return FCmp.compare() == -1;
     }
@@ -410,6 +413,8 @@ bool MergeFunctions::runOnModule(Module &M) {
     if ((I != S && std::prev(I)->first == I->first) ||
         (std::next(I) != IE && std::next(I)->first == I->first) ) {
       Deferred.push_back(WeakTrackingVH(I->second));
+    } else {
+      ++NumUniqueHashes;
     }
   }
 
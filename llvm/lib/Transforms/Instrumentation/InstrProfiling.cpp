@@ -102,6 +102,27 @@ cl::opt<bool> AtomicCounterUpdateAll(
     cl::desc("Make all profile counter updates atomic (for testing only)"),
     cl::init(false));
 
+// Sampled instrumentation: each thread updates the profile counters only for
+// the first executions of every period of its counter updates. This divides
+// the number of writes to the shared counters, and so the contention on their
+// cache lines in multithreaded programs, at the cost of an approximate profile
+// whose counts are scaled by about BurstDuration / Period.
+cl::opt<bool> SampledInstr(
+    "sampled-instrumentation", cl::ZeroOrMore,
+    cl::desc("Update the profile counters in bursts of executions only"),
+    cl::init(false));
+
+cl::opt<unsigned> SampledInstrPeriod(
+    "sampled-instr-period", cl::ZeroOrMore,
+    cl::desc("Number of counter updates of a thread per sampling period"),
+    cl::init(65536));
+
+cl::opt<unsigned> SampledInstrBurstDuration(
+    "sampled-instr-burst-duration", cl::ZeroOrMore,
+    cl::desc("Number of counter updates recorded at the start of each "
+             "sampling period"),
+    cl::init(200));
+
 cl::opt<bool> AtomicCounterUpdatePromoted(
     "atomic-counter-update-promoted", cl::ZeroOrMore,
     cl::desc("Do counter update using atomic fetch add "
@@ -419,10 +440,65 @@ bool InstrProfiling::lowerIntrinsics(Function *F) {
   if (!MadeChange)
     return false;
 
+  sampleCounterUpdates();
   promoteCounterLoadStores(F);
   return true;
 }
 
+bool InstrProfiling::isSamplingEnabled() const {
+  return SampledInstr && SampledInstrBurstDuration < SampledInstrPeriod;
+}
+
+GlobalVariable *InstrProfiling::getOrCreateSamplingVar() {
+  const char *Name = "__llvm_profile_sampling";
+  if (GlobalVariable *Var = M->getNamedGlobal(Name))
+    return Var;
+
+  // Each image has one sampling state per thread, shared by all its modules.
+  auto *Int32Ty = Type::getInt32Ty(M->getContext());
+  auto *Var = new GlobalVariable(
+      *M, Int32Ty, false, GlobalValue::LinkOnceODRLinkage,
+      ConstantInt::get(Int32Ty, 0), Name, nullptr,
+      GlobalValue::InitialExecTLSModel);
+  Var->setVisibility(GlobalValue::HiddenVisibility);
+  if (TT.supportsCOMDAT())
+    Var->setComdat(M->getOrInsertComdat(Name));
+  return Var;
+}
+
+void InstrProfiling::sampleCounterUpdates() {
+  if (SampledUpdates.empty())
+    return;
+
+  GlobalVariable *SamplingVar = getOrCreateSamplingVar();
+  for (auto &Update : SampledUpdates) {
+    Instruction *First = Update.first;
+    Instruction *Last = Update.second;
+
+    // Advance the thread's position in the sampling period, and update the
+    // counter only during the burst at the start of the period.
+    IRBuilder<> Builder(First);
+    auto *Int32Ty = Builder.getInt32Ty();
+    Value *Pos = Builder.CreateLoad(Int32Ty, SamplingVar, "pgosampling");
+    Value *Next = Builder.CreateAdd(Pos, Builder.getInt32(1));
+    Next = Builder.CreateSelect(
+        Builder.CreateICmpEQ(Next, Builder.getInt32(SampledInstrPeriod)),
+        Builder.getInt32(0), Next);
+    Builder.CreateStore(Next, SamplingVar);
+    Value *InBurst =
+        Builder.CreateICmpULT(Pos, Builder.getInt32(SampledInstrBurstDuration));
+
+    Instruction *Then = SplitBlockAndInsertIfThen(InBurst, First, false);
+    BasicBlock *ThenBB = Then->getParent();
+    for (Instruction *I = First, *NextI; I; I = NextI) {
+      NextI = I == Last ? nullptr : I->getNextNode();
+      I->moveBefore(Then);
+    }
+    ThenBB->setName("pgosample");
+  }
+  SampledUpdates.clear();
+}
+
 bool InstrProfiling::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -632,14 +708,21 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
                                                    Counters, 0, Index);
 
   if (Options.Atomic || AtomicCounterUpdateAll) {
-    Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, Inc->getStep(),
-                            AtomicOrdering::Monotonic);
+    auto *RMW = Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr,
+                                        Inc->getStep(),
+                                        AtomicOrdering::Monotonic);
+    if (isSamplingEnabled())
+      SampledUpdates.emplace_back(RMW, RMW);
   } else {
     Value *IncStep = Inc->getStep();
     Value *Load = Builder.CreateLoad(IncStep->getType(), Addr, "pgocount");
     auto *Count = Builder.CreateAdd(Load, Inc->getStep());
     auto *Store = Builder.CreateStore(Count, Addr);
-    if (isCounterPromotionEnabled())
+    // Sampled updates are not promoted, as each of them is guarded by its own
+    // sampling check.
+    if (isSamplingEnabled())
+      SampledUpdates.emplace_back(cast<Instruction>(Load), Store);
+    else if (isCounterPromotionEnabled())
       PromotionCandidates.emplace_back(cast<Instruction>(Load), Store);
   }
   Inc->eraseFromParent();
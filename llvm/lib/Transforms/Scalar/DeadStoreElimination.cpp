@@ -593,6 +593,9 @@ static bool memoryIsNotModifiedBetween(Instruction *FirstI,
   BasicBlock *FirstBB = FirstI->getParent();
   BasicBlock *SecondBB = SecondI->getParent();
   MemoryLocation MemLoc = MemoryLocation::get(SecondI);
+  // Nothing is modified while walking the blocks, so the AA state is kept
+  // across the queries.
+  BatchAAResults BatchAA(*AA);
 
   // Start checking the store-block.
   WorkList.push_back(SecondBB);
@@ -619,7 +622,7 @@ static bool memoryIsNotModifiedBetween(Instruction *FirstI,
     for (; BI != EI; ++BI) {
       Instruction *I = &*BI;
       if (I->mayWriteToMemory() && I != SecondI)
-        if (isModSet(AA->getModRefInfo(I, MemLoc)))
+        if (isModSet(BatchAA.getModRefInfo(I, MemLoc)))
           return false;
     }
     if (B != FirstBB) {
@@ -714,7 +717,7 @@ static bool handleFree(CallInst *F, AliasAnalysis *AA,
 /// being loaded.
 static void removeAccessedObjects(const MemoryLocation &LoadedLoc,
                                   SmallSetVector<const Value *, 16> &DeadStackObjects,
-                                  const DataLayout &DL, AliasAnalysis *AA,
+                                  const DataLayout &DL, BatchAAResults &AA,
                                   const TargetLibraryInfo *TLI,
                                   const Function *F) {
   const Value *UnderlyingPointer = GetUnderlyingObject(LoadedLoc.Ptr, DL);
@@ -734,7 +737,7 @@ static void removeAccessedObjects(const MemoryLocation &LoadedLoc,
   DeadStackObjects.remove_if([&](const Value *I) {
     // See if the loaded location could alias the stack location.
     MemoryLocation StackLoc(I, getPointerSize(I, DL, *TLI, F));
-    return !AA->isNoAlias(StackLoc, LoadedLoc);
+    return !AA.isNoAlias(StackLoc, LoadedLoc);
   });
 }
 
@@ -775,6 +778,12 @@ static bool handleEndBlock(BasicBlock &BB, AliasAnalysis *AA,
 
   const DataLayout &DL = BB.getModule()->getDataLayout();
 
+  // The queries against the dead stack objects are batched, which notably
+  // caches whether each object is captured. The batch is restarted whenever
+  // an instruction is deleted.
+  Optional<BatchAAResults> BatchAA;
+  BatchAA.emplace(*AA);
+
   // Scan the basic block backwards
   for (BasicBlock::iterator BBI = BB.end(); BBI != BB.begin(); ){
     --BBI;
@@ -811,6 +820,7 @@ static bool handleEndBlock(BasicBlock &BB, AliasAnalysis *AA,
         // DCE instructions only used to calculate that store.
         deleteDeadInstruction(Dead, &BBI, *MD, *TLI, IOL, OBB,
                               &DeadStackObjects);
+        BatchAA.emplace(*AA);
         ++NumFastStores;
         MadeChange = true;
         continue;
@@ -823,6 +833,7 @@ static bool handleEndBlock(BasicBlock &BB, AliasAnalysis *AA,
                         << *&*BBI << '\n');
       deleteDeadInstruction(&*BBI, &BBI, *MD, *TLI, IOL, OBB,
                             &DeadStackObjects);
+      BatchAA.emplace(*AA);
       ++NumFastOther;
       MadeChange = true;
       continue;
@@ -850,8 +861,9 @@ static bool handleEndBlock(BasicBlock &BB, AliasAnalysis *AA,
       // the call is live.
       DeadStackObjects.remove_if([&](const Value *I) {
         // See if the call site touches the value.
-        return isRefSet(AA->getModRefInfo(
-            Call, I, getPointerSize(I, DL, *TLI, BB.getParent())));
+        return isRefSet(BatchAA->getModRefInfo(
+            Call,
+            MemoryLocation(I, getPointerSize(I, DL, *TLI, BB.getParent()))));
       });
 
       // If all of the allocas were clobbered by the call then we're not going
@@ -890,7 +902,8 @@ static bool handleEndBlock(BasicBlock &BB, AliasAnalysis *AA,
 
     // Remove any allocas from the DeadPointer set that are loaded, as this
     // makes any stores above the access live.
-    removeAccessedObjects(LoadedLoc, DeadStackObjects, DL, AA, TLI, BB.getParent());
+    removeAccessedObjects(LoadedLoc, DeadStackObjects, DL, *BatchAA, TLI,
+                          BB.getParent());
 
     // If all of the allocas were clobbered by the access then we're not going
     // to find anything else to process.
@@ -196,6 +196,19 @@ static cl::opt<bool> EnableMaskedInterleavedMemAccesses(
 /// number.
 static const unsigned TinyTripCountInterleaveThreshold = 128;
 
+/// For a loop with a short trip count, the scalar epilogue may run for a large
+/// part of the iterations. The cost model then also considers folding the tail
+/// into the vector loop by masking, and picks the cheaper strategy.
+static cl::opt<bool> EnableShortLoopTailFolding(
+    "vectorize-short-loops-fold-tail", cl::init(true), cl::Hidden,
+    cl::desc("Consider folding the tail of loops with a short trip count by "
+             "masking instead of running a scalar epilogue"));
+
+static cl::opt<unsigned> ShortLoopTailFoldingMaxTripCount(
+    "vectorize-short-loops-fold-tail-max-trip-count", cl::init(64), cl::Hidden,
+    cl::desc("Maximum known or estimated trip count of a loop for which "
+             "folding the tail by masking is considered"));
+
 static cl::opt<unsigned> ForceTargetNumScalarRegs(
     "force-target-num-scalar-regs", cl::init(0), cl::Hidden,
     cl::desc("A flag that overrides the target's number of scalar registers."));
@@ -866,6 +879,13 @@ public:
   /// possible.
   VectorizationFactor selectVectorizationFactor(unsigned MaxVF);
 
+  /// Decides whether the tail of a loop with a short trip count is folded
+  /// into the vector loop by masking instead of being run by a scalar
+  /// epilogue, by comparing the expected cost of all the iterations of the
+  /// loop with both strategies. The per-VF decisions up to \p MaxVF must have
+  /// been collected; they are collected again if the strategy changes.
+  void selectTailStrategy(unsigned MaxVF);
+
   /// Setup cost-based decisions for user vectorization factor.
   void selectUserVectorizationFactor(unsigned UserVF) {
     collectUniformsAndScalars(UserVF);
@@ -1066,6 +1086,19 @@ public:
   /// the loop.
   void collectInstsToScalarize(unsigned VF);
 
+  /// Collect the cost-based decisions for all VFs up to \p MaxVF.
+  void collectCostModelingDecisions(unsigned MaxVF) {
+    for (unsigned VF = 1; VF <= MaxVF; VF *= 2) {
+      // Collect Uniform and Scalar instructions after vectorization with VF.
+      collectUniformsAndScalars(VF);
+
+      // Collect the instructions (and their associated costs) that will be
+      // more profitable to scalarize.
+      if (VF > 1)
+        collectInstsToScalarize(VF);
+    }
+  }
+
   /// Collect Uniform and Scalar values for the given \p VF.
   /// The sets depend on CM decision for Load/Store instructions
   /// that may be vectorized as interleave, gather-scatter or scalarized.
@@ -1299,6 +1332,21 @@ private:
   /// scalarized.
   DenseMap<unsigned, SmallPtrSet<Instruction *, 4>> ForcedScalars;
 
+  /// Drops the per-VF decisions, which depend on whether the tail is folded.
+  void invalidateCostModelingDecisions() {
+    InstsToScalarize.clear();
+    Uniforms.clear();
+    Scalars.clear();
+    ForcedScalars.clear();
+    WideningDecisions.clear();
+    PredicatedBBsAfterVectorization.clear();
+  }
+
+  /// \return The expected cost of running \p TC iterations of the loop with
+  /// the cheapest VF up to \p MaxVF, given the cost \p ScalarCost of one
+  /// scalar iteration.
+  float getTripCountCost(unsigned MaxVF, unsigned TC, unsigned ScalarCost);
+
   /// Returns the expected difference in cost from scalarizing the expression
   /// feeding a predicated instruction \p PredInst. The instructions to
   /// scalarize and their scalar costs are collected in \p ScalarCosts. A
@@ -4902,6 +4950,85 @@ LoopVectorizationCostModel::selectVectorizationFactor(unsigned MaxVF) {
   return Factor;
 }
 
+float LoopVectorizationCostModel::getTripCountCost(unsigned MaxVF, unsigned TC,
+                                                   unsigned ScalarCost) {
+  float Cost = (float)TC * ScalarCost;
+  for (unsigned VF = 2; VF <= MaxVF; VF *= 2) {
+    VectorizationCostTy C = expectedCost(VF);
+    if (!C.second)
+      continue;
+    float VFCost = FoldTailByMasking
+                       ? (float)divideCeil(TC, VF) * C.first
+                       : (float)(TC / VF) * C.first + (TC % VF) * ScalarCost;
+    Cost = std::min(Cost, VFCost);
+  }
+  return Cost;
+}
+
+void LoopVectorizationCostModel::selectTailStrategy(unsigned MaxVF) {
+  if (!EnableShortLoopTailFolding || MaxVF < 2 || FoldTailByMasking ||
+      !IsScalarEpilogueAllowed)
+    return;
+
+  unsigned TC = PSE.getSE()->getSmallConstantTripCount(TheLoop);
+  if (!TC)
+    if (Optional<unsigned> EstimatedTC = getLoopEstimatedTripCount(TheLoop))
+      TC = *EstimatedTC;
+  // Every VF up to MaxVF divides TC if MaxVF does.
+  if (!TC || TC > ShortLoopTailFoldingMaxTripCount || TC % MaxVF == 0)
+    return;
+
+  // Folding the tail supports neither runtime checks, reductions nor gaps in
+  // interleave groups. Check for them first, as canFoldTailByMasking reports
+  // its failures.
+  if (Legal->getRuntimePointerChecking()->Need ||
+      !PSE.getUnionPredicate().getPredicates().empty() ||
+      !Legal->getLAI()->getSymbolicStrides().empty() ||
+      !Legal->getPrimaryInduction() || !Legal->getReductionVars()->empty() ||
+      requiresScalarEpilogue() ||
+      (!empty(InterleaveInfo.getInterleaveGroups()) &&
+       !useMaskedInterleavedAccesses(TTI)))
+    return;
+  if (!Legal->canFoldTailByMasking())
+    return;
+
+  // The scalar loop cost is taken without predication, as that is how the
+  // iterations that do not fill a vector would run in a scalar epilogue.
+  unsigned ScalarCost = expectedCost(1).first;
+  float EpilogueCost = getTripCountCost(MaxVF, TC, ScalarCost);
+
+  invalidateCostModelingDecisions();
+  FoldTailByMasking = true;
+  collectCostModelingDecisions(MaxVF);
+  float MaskedCost = getTripCountCost(MaxVF, TC, ScalarCost);
+  LLVM_DEBUG(dbgs() << "LV: Expected cost of " << TC << " iterations with a "
+                    << "scalar epilogue: " << (int)EpilogueCost
+                    << ", with a folded tail: " << (int)MaskedCost << ".\n");
+
+  if (MaskedCost < EpilogueCost) {
+    ORE->emit([&]() {
+      return OptimizationRemarkAnalysis(LV_NAME, "TailFoldedByMasking",
+                                        TheLoop->getStartLoc(),
+                                        TheLoop->getHeader())
+             << "the tail of the loop is folded into the vector loop by "
+                "masking (trip count: "
+             << ore::NV("TripCount", TC) << ")";
+    });
+    return;
+  }
+
+  invalidateCostModelingDecisions();
+  FoldTailByMasking = false;
+  collectCostModelingDecisions(MaxVF);
+  ORE->emit([&]() {
+    return OptimizationRemarkAnalysis(LV_NAME, "ScalarEpilogue",
+                                      TheLoop->getStartLoc(),
+                                      TheLoop->getHeader())
+           << "the tail of the loop is run by a scalar epilogue (trip count: "
+           << ore::NV("TripCount", TC) << ")";
+  });
+}
+
 std::pair<unsigned, unsigned>
 LoopVectorizationCostModel::getSmallestAndWidestTypes() {
   unsigned MinWidth = -1U;
@@ -4975,8 +5102,9 @@ unsigned LoopVectorizationCostModel::selectInterleaveCount(bool OptForSize,
   // 3. We don't interleave if we think that we will spill registers to memory
   // due to the increased register pressure.
 
-  // When we optimize for size, we don't interleave.
-  if (OptForSize)
+  // When we optimize for size, we don't interleave. A folded tail is only
+  // chosen for loops with few iterations, which are not interleaved either.
+  if (OptForSize || FoldTailByMasking)
     return 1;
 
   // We used the distance for the interleave count.
@@ -6238,15 +6366,9 @@ Optional<VectorizationFactor> LoopVectorizationPlanner::plan(bool OptForSize,
   unsigned MaxVF = MaybeMaxVF.getValue();
   assert(MaxVF != 0 && "MaxVF is zero.");
 
-  for (unsigned VF = 1; VF <= MaxVF; VF *= 2) {
-    // Collect Uniform and Scalar instructions after vectorization with VF.
-    CM.collectUniformsAndScalars(VF);
-
-    // Collect the instructions (and their associated costs) that will be more
-    // profitable to scalarize.
-    if (VF > 1)
-      CM.collectInstsToScalarize(VF);
-  }
+  CM.collectCostModelingDecisions(MaxVF);
+  if (!OptForSize)
+    CM.selectTailStrategy(MaxVF);
 
   buildVPlansWithVPRecipes(1, MaxVF);
   LLVM_DEBUG(printPlans(dbgs()));
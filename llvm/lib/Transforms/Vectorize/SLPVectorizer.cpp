@@ -82,6 +82,7 @@
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/LoopUtils.h"
 #include "llvm/Transforms/Vectorize.h"
@@ -89,6 +90,7 @@
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -104,6 +106,13 @@ using namespace slpvectorizer;
 #define DEBUG_TYPE "SLP"
 
 STATISTIC(NumVectorInstructions, "Number of vector instructions generated");
+STATISTIC(NumRejectedTreesReused,
+          "Number of trees not rebuilt because they were already rejected");
+STATISTIC(NumBlocksOverTreeBudget,
+          "Number of blocks in which the tree budget was exhausted");
+
+static const char TimerGroupName[] = "slp";
+static const char TimerGroupDescription[] = "SLP Vectorizer";
 
 cl::opt<bool>
     llvm::RunSLPVectorization("vectorize-slp", cl::init(false), cl::Hidden,
@@ -135,6 +144,18 @@ static cl::opt<int>
 ScheduleRegionSizeBudget("slp-schedule-budget", cl::init(100000), cl::Hidden,
     cl::desc("Limit the size of the SLP scheduling region per block"));
 
+/// Limits the number of trees built per block. Every seed of a block builds at
+/// least one tree, so a huge block, e.g. of fully unrolled code, could
+/// otherwise take quadratic time.
+static cl::opt<unsigned> TreeBudgetPerBlock(
+    "slp-max-trees-per-block", cl::init(10000), cl::Hidden,
+    cl::desc("Limit the number of trees the SLP vectorizer builds per block"));
+
+static cl::opt<bool>
+    SLPStats("slp-stats", cl::init(false), cl::Hidden,
+             cl::desc("Report the time spent in each phase of the SLP "
+                      "vectorizer"));
+
 static cl::opt<int> MinVectorRegSizeOption(
     "slp-min-reg-size", cl::init(128), cl::Hidden,
     cl::desc("Attempt to vectorize for this register size in bits"));
@@ -616,6 +637,42 @@ public:
 
   OptimizationRemarkEmitter *getORE() { return ORE; }
 
+  /// Resets the per-block limits and caches before the seeds of a new block
+  /// are vectorized.
+  void startBlock() {
+    NumTreesInBlock = 0;
+    RejectedTrees.clear();
+  }
+
+  /// What is known of the tree built for a list of roots that was not
+  /// vectorized: either it was tiny, or it had cost \p Cost.
+  struct RejectedTree {
+    bool IsTiny;
+    int Cost;
+  };
+
+  /// \returns the tree last built for \p Roots, allowing its roots to be
+  /// reordered if \p AllowReorder, if it was not vectorized and nothing has
+  /// been vectorized since. Rebuilding it would give the same result.
+  const RejectedTree *getRejectedTree(ArrayRef<Value *> Roots,
+                                      bool AllowReorder = false) const {
+    auto It = RejectedTrees.find(
+        std::make_pair(SmallVector<Value *, 8>(Roots.begin(), Roots.end()),
+                       AllowReorder));
+    if (It == RejectedTrees.end())
+      return nullptr;
+    ++NumRejectedTreesReused;
+    return &It->second;
+  }
+
+  /// Records that the tree built for \p Roots is not vectorized.
+  void rememberRejectedTree(ArrayRef<Value *> Roots, bool AllowReorder,
+                            RejectedTree Tree) {
+    RejectedTrees[std::make_pair(
+        SmallVector<Value *, 8>(Roots.begin(), Roots.end()), AllowReorder)] =
+        Tree;
+  }
+
   /// This structure holds any data we need about the edges being traversed
   /// during buildTree_rec(). We keep track of:
   /// (i) the user TreeEntry index, and
@@ -1838,6 +1895,15 @@ private:
   unsigned MaxVecRegSize; // This is set by TTI or overridden by cl::opt.
   unsigned MinVecRegSize; // Set by cl::opt (default: 128).
 
+  /// The number of trees built in the current block.
+  unsigned NumTreesInBlock = 0;
+
+  /// The trees built in the current block that were not vectorized, by roots
+  /// and whether the roots may be reordered. This is cleared whenever a tree
+  /// is vectorized, as that may change the trees of other roots.
+  std::map<std::pair<SmallVector<Value *, 8>, bool>, RejectedTree>
+      RejectedTrees;
+
   /// Instruction builder to construct the vectorized tree.
   IRBuilder<> Builder;
 
@@ -1954,10 +2020,20 @@ void BoUpSLP::buildTree(ArrayRef<Value *> Roots,
 void BoUpSLP::buildTree(ArrayRef<Value *> Roots,
                         ExtraValueToDebugLocsMap &ExternallyUsedValues,
                         ArrayRef<Value *> UserIgnoreLst) {
+  NamedRegionTimer T("build", "Tree building", TimerGroupName,
+                     TimerGroupDescription, SLPStats);
   deleteTree();
   UserIgnoreList = UserIgnoreLst;
   if (!allSameType(Roots))
     return;
+
+  // An empty tree is tiny, and is not vectorized.
+  if (NumTreesInBlock == TreeBudgetPerBlock) {
+    LLVM_DEBUG(dbgs() << "SLP: Exhausted the tree budget of the block.\n");
+    ++NumBlocksOverTreeBudget;
+  }
+  if (NumTreesInBlock++ >= TreeBudgetPerBlock)
+    return;
   buildTree_rec(Roots, 0, EdgeInfo());
 
   // Collect the values that we need to extract from the tree.
@@ -3188,6 +3264,8 @@ int BoUpSLP::getSpillCost() const {
 }
 
 int BoUpSLP::getTreeCost() {
+  NamedRegionTimer T("cost", "Cost modeling", TimerGroupName,
+                     TimerGroupDescription, SLPStats);
   int Cost = 0;
   LLVM_DEBUG(dbgs() << "SLP: Calculating cost for tree of size "
                     << VectorizableTree.size() << ".\n");
@@ -4008,6 +4086,10 @@ Value *BoUpSLP::vectorizeTree() {
 
 Value *
 BoUpSLP::vectorizeTree(ExtraValueToDebugLocsMap &ExternallyUsedValues) {
+  NamedRegionTimer T("vectorize", "Tree vectorization", TimerGroupName,
+                     TimerGroupDescription, SLPStats);
+  RejectedTrees.clear();
+
   // All blocks must be scheduled before any instructions are inserted.
   for (auto &BSIter : BlocksSchedules) {
     scheduleBlock(BSIter.second.get());
@@ -4161,6 +4243,8 @@ BoUpSLP::vectorizeTree(ExtraValueToDebugLocsMap &ExternallyUsedValues) {
 }
 
 void BoUpSLP::optimizeGatherSequence() {
+  NamedRegionTimer T("gather", "Gather sequence optimization", TimerGroupName,
+                     TimerGroupDescription, SLPStats);
   LLVM_DEBUG(dbgs() << "SLP: Optimizing " << GatherSeq.size()
                     << " gather sequences instructions.\n");
   // LICM InsertElementInst sequences.
@@ -5070,7 +5154,12 @@ bool SLPVectorizerPass::runImpl(Function &F, ScalarEvolution *SE_,
 
   // Scan the blocks in the function in post order.
   for (auto BB : post_order(&F.getEntryBlock())) {
-    collectSeedInstructions(BB);
+    R.startBlock();
+    {
+      NamedRegionTimer T("seeds", "Seed collection", TimerGroupName,
+                         TimerGroupDescription, SLPStats);
+      collectSeedInstructions(BB);
+    }
 
     // Vectorize trees that end at stores.
     if (!Stores.empty()) {
@@ -5139,9 +5228,15 @@ bool SLPVectorizerPass::vectorizeStoreChain(ArrayRef<Value *> Chain, BoUpSLP &R,
                       << "\n");
     ArrayRef<Value *> Operands = Chain.slice(i, VF);
 
+    // The same slice is often analyzed again for overlapping chains.
+    if (R.getRejectedTree(Operands))
+      continue;
+
     R.buildTree(Operands);
-    if (R.isTreeTinyAndNotFullyVectorizable())
+    if (R.isTreeTinyAndNotFullyVectorizable()) {
+      R.rememberRejectedTree(Operands, false, {true, 0});
       continue;
+    }
 
     R.computeMinimumValueSizes();
 
@@ -5149,6 +5244,8 @@ bool SLPVectorizerPass::vectorizeStoreChain(ArrayRef<Value *> Chain, BoUpSLP &R,
 
     LLVM_DEBUG(dbgs() << "SLP: Found cost=" << Cost << " for VF=" << VF
                       << "\n");
+    if (Cost >= -SLPCostThreshold)
+      R.rememberRejectedTree(Operands, false, {false, Cost});
     if (Cost < -SLPCostThreshold) {
       LLVM_DEBUG(dbgs() << "SLP: Decided to vectorize cost=" << Cost << "\n");
 
@@ -5360,6 +5457,19 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
                         << "\n");
       ArrayRef<Value *> Ops = VL.slice(I, OpsWidth);
 
+      // Lists, notably pairs of operands, are often tried again from other
+      // seeds of the block. The cost of the tree does not include UserCost,
+      // which may make it profitable this time.
+      if (const BoUpSLP::RejectedTree *Tree =
+              R.getRejectedTree(Ops, AllowReorder)) {
+        if (Tree->IsTiny)
+          continue;
+        CandidateFound = true;
+        MinCost = std::min(MinCost, Tree->Cost - UserCost);
+        if (Tree->Cost - UserCost >= -SLPCostThreshold)
+          continue;
+      }
+
       R.buildTree(Ops);
       Optional<ArrayRef<unsigned>> Order = R.bestOrder();
       // TODO: check if we can allow reordering for more cases.
@@ -5373,13 +5483,18 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
         Value *ReorderedOps[] = {Ops[1], Ops[0]};
         R.buildTree(ReorderedOps, None);
       }
-      if (R.isTreeTinyAndNotFullyVectorizable())
+      if (R.isTreeTinyAndNotFullyVectorizable()) {
+        R.rememberRejectedTree(Ops, AllowReorder, {true, 0});
         continue;
+      }
 
       R.computeMinimumValueSizes();
-      int Cost = R.getTreeCost() - UserCost;
+      int TreeCost = R.getTreeCost();
+      int Cost = TreeCost - UserCost;
       CandidateFound = true;
       MinCost = std::min(MinCost, Cost);
+      if (Cost >= -SLPCostThreshold)
+        R.rememberRejectedTree(Ops, AllowReorder, {false, TreeCost});
 
       if (Cost < -SLPCostThreshold) {
         LLVM_DEBUG(dbgs() << "SLP: Vectorizing list at cost:" << Cost << ".\n");
@@ -10,19 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 #include "llvm/XRay/Trace.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
-#include "llvm/XRay/BlockIndexer.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/XRay/BlockVerifier.h"
-#include "llvm/XRay/FDRRecordConsumer.h"
 #include "llvm/XRay/FDRRecordProducer.h"
 #include "llvm/XRay/FDRRecords.h"
 #include "llvm/XRay/FDRTraceExpander.h"
 #include "llvm/XRay/FileHeaderReader.h"
 #include "llvm/XRay/YAMLXRayRecord.h"
 #include <memory>
+#include <mutex>
 #include <vector>
 
 using namespace llvm;
@@ -257,87 +259,200 @@ Error loadNaiveFormatLog(StringRef Data, bool IsLittleEndian,
 /// what FunctionRecord instances use, and we no longer need to include the CPU
 /// id in the CustomEventRecord.
 ///
-Error loadFDRLog(StringRef Data, bool IsLittleEndian,
-                 XRayFileHeader &FileHeader, std::vector<XRayRecord> &Records) {
+// The location of a block of an FDR mode log, so that its records can be read
+// again when the block is expanded, instead of being kept in memory.
+struct BlockLocation {
+  uint64_t ProcessID;
+  int32_t ThreadID;
+  uint64_t Seconds;
+  uint32_t Nanos;
+
+  // Reading the block starts at Offset with a new record producer. The first
+  // Skip records read are not part of the block, and the next Count records
+  // are, except for BufferExtents records.
+  uint32_t Offset;
+  uint32_t Skip;
+  uint32_t Count;
+};
+
+// This maps the process + thread combination to a sequence of blocks, like
+// BlockIndexer::Index.
+using BlockLocationIndex =
+    DenseMap<std::pair<uint64_t, int32_t>, std::vector<BlockLocation>>;
+
+// Reads all the records of an FDR mode log once, and splits them into blocks
+// the same way BlockIndexer does, keeping only where the blocks are.
+Error indexFDRLog(const XRayFileHeader &FileHeader, DataExtractor &DE,
+                  uint32_t OffsetPtr, BlockLocationIndex &Index) {
+  // In version 3 and later, a record producer has to start at a BufferExtents
+  // record, which tells it how many bytes of records follow. In earlier
+  // versions, it can start at any record.
+  bool HasExtents = FileHeader.Version >= 3;
+  uint32_t ResumeOffset = OffsetPtr;
+  uint32_t ReadSinceResume = 0;
+  BlockLocation Current{0, 0, 0, 0, 0, 0, 0};
+  bool InBlock = false;
+
+  FileBasedRecordProducer P(FileHeader, DE, OffsetPtr);
+  while (DE.isValidOffsetForDataOfSize(OffsetPtr, 1)) {
+    uint32_t PreReadOffset = OffsetPtr;
+    auto R = P.produce();
+    if (!R)
+      return R.takeError();
+    Record *Rec = R->get();
+
+    if (isa<BufferExtents>(Rec)) {
+      if (InBlock)
+        ++Current.Count;
+      if (HasExtents) {
+        ResumeOffset = PreReadOffset;
+        ReadSinceResume = 1;
+      }
+      continue;
+    }
 
-  if (Data.size() < 32)
-    return createStringError(std::make_error_code(std::errc::invalid_argument),
-                             "Not enough bytes for an XRay FDR log.");
-  DataExtractor DE(Data, IsLittleEndian, 8);
+    if (!InBlock || isa<NewBufferRecord>(Rec)) {
+      if (InBlock)
+        Index[{Current.ProcessID, Current.ThreadID}].push_back(Current);
+      if (!HasExtents) {
+        ResumeOffset = PreReadOffset;
+        ReadSinceResume = 0;
+      }
+      Current = {0, 0, 0, 0, ResumeOffset, ReadSinceResume, 0};
+      InBlock = true;
+    }
 
-  uint32_t OffsetPtr = 0;
-  auto FileHeaderOrError = readBinaryFormatHeader(DE, OffsetPtr);
-  if (!FileHeaderOrError)
-    return FileHeaderOrError.takeError();
-  FileHeader = std::move(FileHeaderOrError.get());
+    if (auto *NB = dyn_cast<NewBufferRecord>(Rec)) {
+      Current.ThreadID = NB->tid();
+    } else if (auto *PR = dyn_cast<PIDRecord>(Rec)) {
+      Current.ProcessID = PR->pid();
+    } else if (auto *WR = dyn_cast<WallclockRecord>(Rec)) {
+      Current.Seconds = WR->seconds();
+      Current.Nanos = WR->nanos();
+    }
+    ++Current.Count;
+    ++ReadSinceResume;
+  }
 
-  // First we load the records into memory.
-  std::vector<std::unique_ptr<Record>> FDRRecords;
+  if (InBlock)
+    Index[{Current.ProcessID, Current.ThreadID}].push_back(Current);
+  return Error::success();
+}
 
-  {
+// Reads the blocks of one process + thread combination again, verifies them
+// and reconstitutes `Trace` records from them, one block at a time.
+Error expandFDRBlocks(const XRayFileHeader &FileHeader, DataExtractor &DE,
+                      std::vector<BlockLocation> &Blocks,
+                      function_ref<Error(const XRayRecord &)> Callback) {
+  // We sort the blocks according to the Walltime record in each of them. This
+  // allows us to more consistently recreate the execution trace in temporal
+  // order.
+  llvm::sort(Blocks, [](const BlockLocation &L, const BlockLocation &R) {
+    return L.Seconds < R.Seconds && L.Nanos < R.Nanos;
+  });
+
+  Error CallbackErr = Error::success();
+  auto Adder = [&](const XRayRecord &R) {
+    if (!CallbackErr)
+      CallbackErr = Callback(R);
+  };
+  TraceExpander Expander(Adder, FileHeader.Version);
+
+  std::vector<std::unique_ptr<Record>> Records;
+  for (const auto &B : Blocks) {
+    uint32_t OffsetPtr = B.Offset;
     FileBasedRecordProducer P(FileHeader, DE, OffsetPtr);
-    LogBuilderConsumer C(FDRRecords);
-    while (DE.isValidOffsetForDataOfSize(OffsetPtr, 1)) {
+    Records.clear();
+    for (uint32_t I = 0, N = B.Skip + B.Count; I != N; ++I) {
       auto R = P.produce();
       if (!R)
-        return R.takeError();
-      if (auto E = C.consume(std::move(R.get())))
-        return E;
+        return joinErrors(std::move(CallbackErr), R.takeError());
+      if (I >= B.Skip && !isa<BufferExtents>(R->get()))
+        Records.push_back(std::move(*R));
     }
-  }
 
-  // Next we index the records into blocks.
-  BlockIndexer::Index Index;
-  {
-    BlockIndexer Indexer(Index);
-    for (auto &R : FDRRecords)
-      if (auto E = R->apply(Indexer))
-        return E;
-    if (auto E = Indexer.flush())
-      return E;
+    BlockVerifier Verifier;
+    for (auto &R : Records)
+      if (auto E = R->apply(Verifier))
+        return joinErrors(std::move(CallbackErr), std::move(E));
+    if (auto E = Verifier.verify())
+      return joinErrors(std::move(CallbackErr), std::move(E));
+
+    for (auto &R : Records)
+      if (auto E = R->apply(Expander))
+        return joinErrors(std::move(CallbackErr), std::move(E));
+    if (CallbackErr)
+      return CallbackErr;
   }
 
-  // Then we verify the consistency of the blocks.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      for (auto &B : Blocks) {
-        BlockVerifier Verifier;
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Verifier))
-            return E;
-        if (auto E = Verifier.verify())
-          return E;
-      }
-    }
-  }
+  if (auto E = Expander.flush())
+    return joinErrors(std::move(CallbackErr), std::move(E));
+  return CallbackErr;
+}
 
-  // This is now the meat of the algorithm. Here we sort the blocks according to
-  // the Walltime record in each of the blocks for the same thread. This allows
-  // us to more consistently recreate the execution trace in temporal order.
-  // After the sort, we then reconstitute `Trace` records using a stateful
-  // visitor associated with a single process+thread pair.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      llvm::sort(Blocks, [](const BlockIndexer::Block &L,
-                            const BlockIndexer::Block &R) {
-        return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
-                L.WallclockTime->nanos() < R.WallclockTime->nanos());
-      });
-      auto Adder = [&](const XRayRecord &R) { Records.push_back(R); };
-      TraceExpander Expander(Adder, FileHeader.Version);
-      for (auto &B : Blocks) {
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Expander))
-            return E;
-      }
-      if (auto E = Expander.flush())
+Error streamFDRLog(StringRef Data, bool IsLittleEndian,
+                   XRayFileHeader &FileHeader, TraceRecordCallback Callback,
+                   unsigned Threads) {
+  if (Data.size() < 32)
+    return createStringError(std::make_error_code(std::errc::invalid_argument),
+                             "Not enough bytes for an XRay FDR log.");
+  DataExtractor DE(Data, IsLittleEndian, 8);
+
+  uint32_t OffsetPtr = 0;
+  auto FileHeaderOrError = readBinaryFormatHeader(DE, OffsetPtr);
+  if (!FileHeaderOrError)
+    return FileHeaderOrError.takeError();
+  FileHeader = std::move(FileHeaderOrError.get());
+
+  // First we find the blocks of each process + thread combination, without
+  // keeping their records in memory.
+  BlockLocationIndex Index;
+  if (auto E = indexFDRLog(FileHeader, DE, OffsetPtr, Index))
+    return E;
+
+  // Then we hand the process + thread combinations out to the workers, in
+  // index order. Each worker expands the blocks for one combination at a time.
+  Threads = std::max(Threads, 1u);
+  std::vector<std::vector<std::vector<BlockLocation> *>> Work(Threads);
+  size_t Next = 0;
+  for (auto &PTB : Index)
+    Work[Next++ % Threads].push_back(&PTB.second);
+
+  auto RunWorker = [&](unsigned Worker) -> Error {
+    DataExtractor WorkerDE(Data, IsLittleEndian, 8);
+    auto WorkerCallback = [&](const XRayRecord &R) {
+      return Callback(Worker, R);
+    };
+    for (auto *Blocks : Work[Worker])
+      if (auto E =
+              expandFDRBlocks(FileHeader, WorkerDE, *Blocks, WorkerCallback))
         return E;
-    }
-  }
+    return Error::success();
+  };
+  if (Threads == 1)
+    return RunWorker(0);
+
+  std::mutex ResultMutex;
+  Error Result = Error::success();
+  ThreadPool Pool(Threads);
+  for (unsigned Worker = 0; Worker != Threads; ++Worker)
+    Pool.async([&, Worker] {
+      Error E = RunWorker(Worker);
+      std::lock_guard<std::mutex> Lock(ResultMutex);
+      Result = joinErrors(std::move(Result), std::move(E));
+    });
+  Pool.wait();
+  return Result;
+}
 
-  return Error::success();
+Error loadFDRLog(StringRef Data, bool IsLittleEndian,
+                 XRayFileHeader &FileHeader, std::vector<XRayRecord> &Records) {
+  return streamFDRLog(Data, IsLittleEndian, FileHeader,
+                      [&](unsigned, const XRayRecord &R) {
+                        Records.push_back(R);
+                        return Error::success();
+                      },
+                      1);
 }
 
 Error loadYAMLLog(StringRef Data, XRayFileHeader &FileHeader,
@@ -467,3 +582,59 @@ Expected<Trace> llvm::xray::loadTrace(const DataExtractor &DE, bool Sort) {
 
   return std::move(T);
 }
+
+Error llvm::xray::streamTraceFile(StringRef Filename, XRayFileHeader &Header,
+                                  TraceRecordCallback Callback,
+                                  unsigned Threads) {
+  auto BufferOrErr = MemoryBuffer::getFile(Filename, /*FileSize=*/-1,
+                                           /*RequiresNullTerminator=*/false);
+  if (!BufferOrErr)
+    return make_error<StringError>(
+        Twine("Cannot read log from '") + Filename + "'",
+        BufferOrErr.getError());
+  StringRef Data = (*BufferOrErr)->getBuffer();
+  if (Data.size() < 4)
+    return make_error<StringError>(
+        Twine("File '") + Filename + "' too small for XRay.",
+        std::make_error_code(std::errc::executable_format_error));
+
+  // We can't retry with the other endianness once records have been handed
+  // out, so we pick the one in which the file header makes sense.
+  DataExtractor HeaderExtractor(Data, true, 8);
+  uint32_t OffsetPtr = 0;
+  uint16_t Version = HeaderExtractor.getU16(&OffsetPtr);
+  uint16_t Type = HeaderExtractor.getU16(&OffsetPtr);
+  bool IsLittleEndian = Type <= 1 && Version >= 1 && Version <= 5;
+  if (!IsLittleEndian) {
+    DataExtractor BigEndianExtractor(Data, false, 8);
+    OffsetPtr = 0;
+    Version = BigEndianExtractor.getU16(&OffsetPtr);
+    Type = BigEndianExtractor.getU16(&OffsetPtr);
+    IsLittleEndian = !(Type <= 1 && Version >= 1 && Version <= 5);
+  }
+  return streamTrace(DataExtractor(Data, IsLittleEndian, 8), Header, Callback,
+                     Threads);
+}
+
+Error llvm::xray::streamTrace(const DataExtractor &DE, XRayFileHeader &Header,
+                              TraceRecordCallback Callback, unsigned Threads) {
+  DataExtractor HeaderExtractor(DE.getData(), DE.isLittleEndian(), 8);
+  uint32_t OffsetPtr = 0;
+  uint16_t Version = HeaderExtractor.getU16(&OffsetPtr);
+  uint16_t Type = HeaderExtractor.getU16(&OffsetPtr);
+
+  // Only FDR mode logs are read block by block. The other formats are loaded
+  // whole, and handed to a single worker.
+  if (Type == 1 && Version >= 1 && Version <= 5)
+    return streamFDRLog(DE.getData(), DE.isLittleEndian(), Header, Callback,
+                        Threads);
+
+  auto TraceOrErr = loadTrace(DE);
+  if (!TraceOrErr)
+    return TraceOrErr.takeError();
+  Header = TraceOrErr->getFileHeader();
+  for (const XRayRecord &R : *TraceOrErr)
+    if (auto E = Callback(0, R))
+      return E;
+  return Error::success();
+}
@@ -2685,6 +2685,31 @@ bool DwarfLinker::link(const DebugMap &Map) {
   std::condition_variable ProcessedFilesConditionVariable;
   BitVector ProcessedFiles(NumObjects, false);
 
+  // Extracting the DIEs of an object file doesn't depend on any other object,
+  // so when more than two threads are available it is done on a separate pool
+  // a few objects ahead of the analysis. Everything that depends on the order
+  // of the objects, like ODR uniquing and string offsets, stays in the analyze
+  // and clone threads, which keeps the output independent of the thread count.
+  const unsigned NumLoadThreads = Options.Threads > 2 ? Options.Threads - 2 : 0;
+  const unsigned LoadWindow = 2 * NumLoadThreads;
+  Optional<ThreadPool> LoadPool;
+  if (NumLoadThreads)
+    LoadPool.emplace(NumLoadThreads);
+  std::vector<std::shared_future<void>> LoadedObjects(NumObjects);
+
+  auto LoadLambda = [&](size_t i) {
+    auto &LinkContext = ObjectContexts[i];
+    if (!LinkContext.ObjectFile || !LinkContext.DwarfContext)
+      return;
+    for (const auto &CU : LinkContext.DwarfContext->compile_units())
+      CU->getUnitDIE(false);
+  };
+
+  auto ScheduleLoad = [&](size_t i) {
+    if (LoadPool && i < NumObjects)
+      LoadedObjects[i] = LoadPool->async([&, i] { LoadLambda(i); });
+  };
+
   //  Analyzing the context info is particularly expensive so it is executed in
   //  parallel with emitting the previous compile unit.
   auto AnalyzeLambda = [&](size_t i) {
@@ -2796,7 +2821,13 @@ bool DwarfLinker::link(const DebugMap &Map) {
   };
 
   auto AnalyzeAll = [&]() {
+    for (unsigned i = 0; i != LoadWindow; ++i)
+      ScheduleLoad(i);
+
     for (unsigned i = 0, e = NumObjects; i != e; ++i) {
+      if (LoadedObjects[i].valid())
+        LoadedObjects[i].wait();
+      ScheduleLoad(i + LoadWindow);
       AnalyzeLambda(i);
 
       std::unique_lock<std::mutex> LockGuard(ProcessedFilesMutex);
@@ -21,6 +21,7 @@
 #include "llvm/CodeGen/MIRParser/MIRParser.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/IR/AutoUpgrade.h"
@@ -77,6 +78,11 @@ TimeCompilations("time-compilations", cl::Hidden, cl::init(1u),
                  cl::value_desc("N"),
                  cl::desc("Repeat compilation N times for timing"));
 
+static cl::opt<unsigned> CodeGenThreads(
+    "codegen-threads", cl::init(1u), cl::value_desc("N"),
+    cl::desc("Split the module into N partitions and generate code for them "
+             "in parallel. Partition I > 0 is written to <output>.I"));
+
 static cl::opt<bool>
 NoIntegratedAssembler("no-integrated-as", cl::Hidden,
                       cl::desc("Disable integrated assembler"));
@@ -523,6 +529,47 @@ static int compileModule(char **argv, LLVMContext &Context) {
     WithColor::warning(errs(), argv[0])
         << ": warning: ignoring -mc-relax-all because filetype != obj";
 
+  if (CodeGenThreads > 1) {
+    if (MIR || !RunPassNames->empty() || CompileTwice || DwoOut ||
+        OutputFilename == "-") {
+      WithColor::error(errs(), argv[0])
+          << "-codegen-threads requires IR input and an output file, and "
+             "cannot be used with -run-pass, -compile-twice or "
+             "-split-dwarf-output\n";
+      return 1;
+    }
+
+    // Each partition is compiled in its own LLVMContext by its own
+    // TargetMachine. The object files are meant to be linked together.
+    std::vector<std::unique_ptr<ToolOutputFile>> PartOuts;
+    SmallVector<raw_pwrite_stream *, 8> OSs = {&Out->os()};
+    for (unsigned I = 1; I < CodeGenThreads; ++I) {
+      std::error_code EC;
+      PartOuts.push_back(llvm::make_unique<ToolOutputFile>(
+          (OutputFilename + "." + Twine(I)).str(), EC, sys::fs::F_None));
+      if (EC) {
+        WithColor::error(errs(), argv[0]) << EC.message() << '\n';
+        return 1;
+      }
+      OSs.push_back(&PartOuts.back()->os());
+    }
+
+    cl::PrintOptionValues();
+    splitCodeGen(
+        std::move(M), OSs, {},
+        [&] {
+          return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+              TheTriple.getTriple(), CPUStr, FeaturesStr, Options,
+              getRelocModel(), getCodeModel(), OLvl));
+        },
+        FileType, /*PreserveLocals=*/true);
+
+    Out->keep();
+    for (std::unique_ptr<ToolOutputFile> &PartOut : PartOuts)
+      PartOut->keep();
+    return 0;
+  }
+
   {
     raw_pwrite_stream *OS = &Out->os();
 
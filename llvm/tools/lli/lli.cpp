@@ -110,6 +110,18 @@ namespace {
                "rather than individual functions"),
       cl::init(false));
 
+  cl::opt<bool> Speculate(
+      "speculate",
+      cl::desc("Compile likely callees on the compile threads ahead of their "
+               "first call (jit-kind=orc-lazy only)"),
+      cl::init(false));
+
+  cl::opt<bool> SpeculateStats(
+      "speculate-stats",
+      cl::desc("Print speculative compilation statistics on exit "
+               "(jit-kind=orc-lazy only)"),
+      cl::init(false));
+
   cl::list<std::string>
       JITDylibs("jd",
                 cl::desc("Specifies the JITDylib to be used for any subsequent "
@@ -784,6 +796,7 @@ int runOrcLazyJIT(const char *ProgName) {
   Builder.setLazyCompileFailureAddr(
       pointerToJITTargetAddress(exitOnLazyCallThroughFailure));
   Builder.setNumCompileThreads(LazyJITCompileThreads);
+  Builder.setSpeculativeCompilation(Speculate);
 
   auto J = ExitOnErr(Builder.create());
 
@@ -887,6 +900,13 @@ int runOrcLazyJIT(const char *ProgName) {
   ExitOnErr(J->runDestructors());
   CXXRuntimeOverrides.runDestructors();
 
+  if (SpeculateStats) {
+    if (auto *S = J->getSpeculator())
+      S->printStatistics(errs());
+    else
+      errs() << "-speculate-stats requires -speculate\n";
+  }
+
   return Result;
 }
 
@@ -907,6 +927,11 @@ void disallowOrcOptions() {
     errs() << "-per-module-lazy requires -jit-kind=orc-lazy\n";
     exit(1);
   }
+
+  if (Speculate || SpeculateStats) {
+    errs() << "-speculate and -speculate-stats require -jit-kind=orc-lazy\n";
+    exit(1);
+  }
 }
 
 std::unique_ptr<FDRawChannel> launchRemote() {
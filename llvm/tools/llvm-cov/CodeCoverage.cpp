@@ -26,8 +26,11 @@
 #include "llvm/ProfileData/Coverage/CoverageMapping.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
@@ -112,6 +115,16 @@ private:
   void writeSourceFileView(StringRef SourceFile, CoverageMapping *Coverage,
                            CoveragePrinter *Printer, bool ShowFilenames);
 
+  /// Compute a digest of everything the view of \p SourceFile is rendered
+  /// from: the source, its coverage and the options affecting the output.
+  std::string getSourceFileViewDigest(StringRef SourceFile,
+                                      const CoverageMapping &Coverage);
+
+  /// In -incremental mode, load the view digests saved by the previous run
+  /// into the output directory, and save the digests of this run.
+  void loadViewDigests();
+  void saveViewDigests();
+
   typedef llvm::function_ref<int(int, const char **)> CommandLineParserType;
 
   int doShow(int argc, const char **argv,
@@ -158,9 +171,21 @@ private:
 
   /// Whitelist from -name-whitelist to be used for filtering.
   std::unique_ptr<SpecialCaseList> NameWhitelist;
+
+  /// In -incremental mode, the digests of the views rendered by the previous
+  /// run, and of the views of this run. Only files whose digest changed are
+  /// rendered again.
+  bool Incremental = false;
+  std::string ViewOptionsKey;
+  StringMap<std::string> PreviousViewDigests;
+  std::mutex ViewDigestsLock;
+  StringMap<std::string> ViewDigests;
 };
 }
 
+/// The name of the file which holds the view digests in the output directory.
+static const char *ViewDigestsFilename = ".llvm-cov-incremental";
+
 static std::string getErrorString(const Twine &Message, StringRef Whence,
                                   bool Warning) {
   std::string Str = (Warning ? "warning" : "error");
@@ -512,10 +537,99 @@ void CodeCoverageTool::demangleSymbols(const CoverageMapping &Coverage) {
     DC.DemangledNames[Function.Name] = Symbols[I++].rtrim();
 }
 
+std::string
+CodeCoverageTool::getSourceFileViewDigest(StringRef SourceFile,
+                                          const CoverageMapping &Coverage) {
+  MD5 Hash;
+  auto AddInt = [&](uint64_t V) {
+    uint8_t Bytes[sizeof(V)];
+    support::endian::write64le(Bytes, V);
+    Hash.update(Bytes);
+  };
+  auto AddFunction = [&](const FunctionRecord &Function) {
+    Hash.update(Function.Name);
+    AddInt(Function.ExecutionCount);
+    for (const CountedRegion &CR : Function.CountedRegions) {
+      AddInt(CR.FileID);
+      AddInt(CR.LineStart);
+      AddInt(CR.ColumnStart);
+      AddInt(CR.ExecutionCount);
+    }
+  };
+
+  Hash.update(ViewOptionsKey);
+  auto SourceBuffer = getSourceFile(SourceFile);
+  if (SourceBuffer)
+    Hash.update(SourceBuffer->getBuffer());
+
+  CoverageData FileCoverage = Coverage.getCoverageForFile(SourceFile);
+  for (const CoverageSegment &Segment : FileCoverage) {
+    AddInt(Segment.Line);
+    AddInt(Segment.Col);
+    AddInt(Segment.Count);
+    AddInt(Segment.HasCount | Segment.IsRegionEntry << 1 |
+           Segment.IsGapRegion << 2);
+  }
+  // Expansions are rendered from the regions of the expanded functions.
+  for (const ExpansionRecord &Expansion : FileCoverage.getExpansions()) {
+    AddInt(Expansion.Region.LineStart);
+    AddInt(Expansion.Region.ColumnStart);
+    AddFunction(Expansion.Function);
+  }
+  if (ViewOpts.ShowFunctionInstantiations)
+    for (const auto &Group : Coverage.getInstantiationGroups(SourceFile))
+      for (const FunctionRecord *Function : Group.getInstantiations())
+        AddFunction(*Function);
+
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  return Result.digest().str();
+}
+
+void CodeCoverageTool::loadViewDigests() {
+  SmallString<256> Path(ViewOpts.ShowOutputDirectory);
+  sys::path::append(Path, ViewDigestsFilename);
+  auto BufOrErr = MemoryBuffer::getFile(Path);
+  // This is the first run into this output directory: render everything.
+  if (!BufOrErr)
+    return;
+  for (line_iterator I(**BufOrErr, /*SkipBlanks=*/true); !I.is_at_eof();
+       ++I) {
+    StringRef Digest, SourceFile;
+    std::tie(Digest, SourceFile) = I->split(' ');
+    PreviousViewDigests[SourceFile] = Digest;
+  }
+}
+
+void CodeCoverageTool::saveViewDigests() {
+  SmallString<256> Path(ViewOpts.ShowOutputDirectory);
+  sys::path::append(Path, ViewDigestsFilename);
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::F_Text);
+  if (EC) {
+    warning("Could not save the view digests for -incremental.", EC.message());
+    return;
+  }
+  for (const auto &Entry : ViewDigests)
+    OS << Entry.second << ' ' << Entry.first() << '\n';
+}
+
 void CodeCoverageTool::writeSourceFileView(StringRef SourceFile,
                                            CoverageMapping *Coverage,
                                            CoveragePrinter *Printer,
                                            bool ShowFilenames) {
+  if (Incremental) {
+    std::string Digest = getSourceFileViewDigest(SourceFile, *Coverage);
+    bool Unchanged = PreviousViewDigests.lookup(SourceFile) == Digest;
+    {
+      std::unique_lock<std::mutex> Guard{ViewDigestsLock};
+      ViewDigests[SourceFile] = Digest;
+    }
+    // The view written by the previous run is still up to date.
+    if (Unchanged)
+      return;
+  }
+
   auto View = createSourceFileView(SourceFile, *Coverage);
   if (!View) {
     warning("The file '" + SourceFile + "' isn't covered.");
@@ -836,6 +950,11 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
       "project-title", cl::Optional,
       cl::desc("Set project title for the coverage report"));
 
+  cl::opt<bool> IncrementalOpt(
+      "incremental", cl::Optional, cl::init(false),
+      cl::desc("Only render the files of the output directory whose source, "
+               "coverage or view options changed since the previous run"));
+
   auto Err = commandLineParser(argc, argv);
   if (Err)
     return Err;
@@ -845,6 +964,11 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
     return 1;
   }
 
+  if (IncrementalOpt && ShowOutputDirectory.empty()) {
+    error("-incremental requires -output-dir.");
+    return 1;
+  }
+
   ViewOpts.ShowLineNumbers = true;
   ViewOpts.ShowLineStats = ShowLineExecutionCounts.getNumOccurrences() != 0 ||
                            !ShowRegions || ShowBestLineRegionsCounts;
@@ -939,6 +1063,20 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
       (SourceFiles.size() != 1) || ViewOpts.hasOutputDirectory() ||
       (ViewOpts.Format == CoverageViewOptions::OutputFormat::HTML);
 
+  if (IncrementalOpt) {
+    // The "Created" time stamp is deliberately left out: it changes with every
+    // new profile, even if the coverage of most files didn't.
+    Incremental = true;
+    raw_string_ostream Key(ViewOptionsKey);
+    Key << static_cast<unsigned>(ViewOpts.Format) << ViewOpts.ShowLineNumbers
+        << ViewOpts.ShowLineStats << ViewOpts.ShowRegionMarkers
+        << ViewOpts.ShowExpandedRegions << ViewOpts.ShowFunctionInstantiations
+        << ViewOpts.Debug << ShowFilenames << ' ' << ViewOpts.TabSize << ' '
+        << ViewOpts.ProjectTitle;
+    Key.flush();
+    loadViewDigests();
+  }
+
   auto NumThreads = ViewOpts.NumThreads;
 
   // If NumThreads is not specified, auto-detect a good default.
@@ -960,6 +1098,9 @@ int CodeCoverageTool::doShow(int argc, const char **argv,
     Pool.wait();
   }
 
+  if (Incremental)
+    saveViewDigests();
+
   return 0;
 }
 
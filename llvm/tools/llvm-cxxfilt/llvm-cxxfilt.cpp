@@ -11,6 +11,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -55,8 +56,40 @@ Decorated(cl::Positional, cl::desc("<mangled>"), cl::ZeroOrMore);
 static cl::extrahelp
     HelpResponse("\nPass @FILE as argument to read options from FILE.\n");
 
+namespace {
+/// Demangles Itanium names with one parser and one output buffer, which are
+/// reused for every name instead of being allocated for each one.
+class ReusableDemangler {
+  ItaniumPartialDemangler Demangler;
+  char *Buf = nullptr;
+  size_t Capacity = 0;
+
+public:
+  ReusableDemangler() = default;
+  ReusableDemangler(const ReusableDemangler &) = delete;
+  ReusableDemangler &operator=(const ReusableDemangler &) = delete;
+  ~ReusableDemangler() { free(Buf); }
+
+  /// Demangle \p MangledName. The result is valid until the next call, and
+  /// is null if the name could not be demangled.
+  const char *demangle(const char *MangledName) {
+    if (Demangler.partialDemangle(MangledName))
+      return nullptr;
+    size_t N = Capacity;
+    char *Result = Demangler.finishDemangle(Buf, &N);
+    if (!Result)
+      return nullptr;
+    // The buffer may have been reallocated. It holds at least the N bytes
+    // just written.
+    Buf = Result;
+    Capacity = std::max(Capacity, N);
+    return Result;
+  }
+};
+} // namespace
+
 static std::string demangle(llvm::raw_ostream &OS, const std::string &Mangled) {
-  int Status;
+  static ReusableDemangler Demangler;
 
   const char *DecoratedStr = Mangled.c_str();
   if (StripUnderscore)
@@ -64,22 +97,20 @@ static std::string demangle(llvm::raw_ostream &OS, const std::string &Mangled) {
       ++DecoratedStr;
   size_t DecoratedLength = strlen(DecoratedStr);
 
-  char *Undecorated = nullptr;
+  const char *Undecorated = nullptr;
 
   if (Types ||
       ((DecoratedLength >= 2 && strncmp(DecoratedStr, "_Z", 2) == 0) ||
        (DecoratedLength >= 4 && strncmp(DecoratedStr, "___Z", 4) == 0)))
-    Undecorated = itaniumDemangle(DecoratedStr, nullptr, nullptr, &Status);
+    Undecorated = Demangler.demangle(DecoratedStr);
 
   if (!Undecorated &&
       (DecoratedLength > 6 && strncmp(DecoratedStr, "__imp_", 6) == 0)) {
     OS << "import thunk for ";
-    Undecorated = itaniumDemangle(DecoratedStr + 6, nullptr, nullptr, &Status);
+    Undecorated = Demangler.demangle(DecoratedStr + 6);
   }
 
-  std::string Result(Undecorated ? Undecorated : Mangled);
-  free(Undecorated);
-  return Result;
+  return Undecorated ? Undecorated : Mangled;
 }
 
 // Split 'Source' on any character that fails to pass 'IsLegalChar'.  The
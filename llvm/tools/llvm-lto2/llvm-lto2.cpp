@@ -49,6 +49,12 @@ static cl::opt<std::string> OutputFilename("o", cl::Required,
 static cl::opt<std::string> CacheDir("cache-dir", cl::desc("Cache Directory"),
                                      cl::value_desc("directory"));
 
+static cl::opt<std::string> RemoteCacheCommand(
+    "remote-cache-command",
+    cl::desc("Program used to fetch and publish the objects in the cache "
+             "directory from a remote cache"),
+    cl::value_desc("program"));
+
 static cl::opt<std::string> OptPipeline("opt-pipeline",
                                         cl::desc("Optimizer Pipeline"),
                                         cl::value_desc("pipeline"));
@@ -335,8 +341,15 @@ static int run(int argc, char **argv) {
   };
 
   NativeObjectCache Cache;
-  if (!CacheDir.empty())
+  if (!CacheDir.empty() && !RemoteCacheCommand.empty()) {
+    std::shared_ptr<RemoteCache> Remote =
+        check(commandRemoteCache(RemoteCacheCommand),
+              "failed to create remote cache");
+    Cache = check(localCacheWithRemote(CacheDir, std::move(Remote), AddBuffer),
+                  "failed to create cache");
+  } else if (!CacheDir.empty()) {
     Cache = check(localCache(CacheDir, AddBuffer), "failed to create cache");
+  }
 
   check(Lto.run(AddStream, Cache), "LTO::run failed");
   return 0;
@@ -430,9 +430,16 @@ void ELFSectionWriter<ELFT>::visit(const DecompressedSection &Sec) {
       reinterpret_cast<const char *>(Sec.OriginalData.data()) + DataOffset,
       Sec.OriginalData.size() - DataOffset);
 
+  compression::Format Format = compression::Format::Zlib;
+  if (!isDataGnuCompressed(Sec.OriginalData) &&
+      reinterpret_cast<const Elf_Chdr_Impl<ELFT> *>(Sec.OriginalData.data())
+              ->ch_type == ELF::ELFCOMPRESS_ZSTD)
+    Format = compression::Format::Zstd;
+
   SmallVector<char, 128> DecompressedContent;
-  if (Error E = zlib::uncompress(CompressedContent, DecompressedContent,
-                                 static_cast<size_t>(Sec.Size)))
+  if (Error E = compression::uncompress(Format, CompressedContent,
+                                        DecompressedContent,
+                                        static_cast<size_t>(Sec.Size)))
     reportError(Sec.Name, std::move(E));
 
   uint8_t *Buf = Out.getBufferStart() + Sec.Offset;
@@ -490,7 +497,9 @@ void ELFSectionWriter<ELFT>::visit(const CompressedSection &Sec) {
     Buf += sizeof(DecompressedSize);
   } else {
     Elf_Chdr_Impl<ELFT> Chdr;
-    Chdr.ch_type = ELF::ELFCOMPRESS_ZLIB;
+    Chdr.ch_type = Sec.CompressionType == DebugCompressionType::Zstd
+                       ? ELF::ELFCOMPRESS_ZSTD
+                       : ELF::ELFCOMPRESS_ZLIB;
     Chdr.ch_size = Sec.DecompressedSize;
     Chdr.ch_addralign = Sec.DecompressedAlign;
     memcpy(Buf, &Chdr, sizeof(Chdr));
@@ -504,7 +513,10 @@ CompressedSection::CompressedSection(const SectionBase &Sec,
                                      DebugCompressionType CompressionType)
     : SectionBase(Sec), CompressionType(CompressionType),
       DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
-  if (Error E = zlib::compress(
+  if (Error E = compression::compress(
+          CompressionType == DebugCompressionType::Zstd
+              ? compression::Format::Zstd
+              : compression::Format::Zlib,
           StringRef(reinterpret_cast<const char *>(OriginalData.data()),
                     OriginalData.size()),
           CompressedData))
@@ -13,6 +13,7 @@
 #include "COFF/COFFObjcopy.h"
 #include "MachO/MachOObjcopy.h"
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -34,6 +35,7 @@
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/WithColor.h"
@@ -42,6 +44,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -52,7 +55,11 @@ namespace objcopy {
 // The name this program was invoked as.
 StringRef ToolName;
 
+// Inputs are processed concurrently, and the first fatal error exits.
+static std::mutex FatalErrorMutex;
+
 LLVM_ATTRIBUTE_NORETURN void error(Twine Message) {
+  FatalErrorMutex.lock();
   WithColor::error(errs(), ToolName) << Message << "\n";
   exit(1);
 }
@@ -63,6 +70,7 @@ LLVM_ATTRIBUTE_NORETURN void error(Error E) {
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
+  FatalErrorMutex.lock();
   WithColor::error(errs(), ToolName) << Buf;
   exit(1);
 }
@@ -78,6 +86,7 @@ LLVM_ATTRIBUTE_NORETURN void reportError(StringRef File, Error E) {
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
+  FatalErrorMutex.lock();
   WithColor::error(errs(), ToolName) << "'" << File << "': " << Buf;
   exit(1);
 }
@@ -318,12 +327,22 @@ int main(int argc, char **argv) {
                           WithColor::error(errs(), ToolName));
     return 1;
   }
-  for (const CopyConfig &CopyConfig : DriverConfig->CopyConfigs) {
-    if (Error E = executeObjcopy(CopyConfig)) {
-      logAllUnhandledErrors(std::move(E), WithColor::error(errs(), ToolName));
-      return 1;
+
+  // The inputs are independent of each other, so process them concurrently,
+  // but report their errors in the order of the inputs.
+  ArrayRef<CopyConfig> CopyConfigs = DriverConfig->CopyConfigs;
+  std::vector<Optional<Error>> Errors(CopyConfigs.size());
+  parallel::for_each_n(parallel::par, size_t(0), CopyConfigs.size(),
+                       [&](size_t I) {
+                         Errors[I] = executeObjcopy(CopyConfigs[I]);
+                       });
+
+  int Ret = 0;
+  for (Optional<Error> &E : Errors) {
+    if (*E) {
+      logAllUnhandledErrors(std::move(*E), WithColor::error(errs(), ToolName));
+      Ret = 1;
     }
   }
-
-  return 0;
+  return Ret;
 }
@@ -61,6 +61,10 @@ static cl::opt<bool>
   NoDemangle("no-demangle", cl::desc("Don't demangle function names"),
              cl::init(false), cl::cat(OptReportCategory));
 
+static cl::opt<std::string>
+  InputFormat("format", cl::desc("The format of the remarks (yaml, bitstream)"),
+              cl::init("yaml"), cl::cat(OptReportCategory));
+
 namespace {
 // For each location in the source file, the common per-transformation state
 // collected.
@@ -150,8 +154,16 @@ static bool readLocationInfo(LocationInfoTy &LocationInfo) {
     return false;
   }
 
+  Expected<remarks::Format> Format = remarks::parseFormat(InputFormat);
+  if (!Format) {
+    handleAllErrors(Format.takeError(), [&](const ErrorInfoBase &PE) {
+      PE.log(WithColor::error());
+    });
+    return false;
+  }
+
   Expected<std::unique_ptr<remarks::Parser>> MaybeParser =
-      remarks::createRemarkParser(remarks::Format::YAML, (*Buf)->getBuffer());
+      remarks::createRemarkParser(*Format, (*Buf)->getBuffer());
   if (!MaybeParser) {
     handleAllErrors(MaybeParser.takeError(), [&](const ErrorInfoBase &PE) {
       PE.log(WithColor::error());
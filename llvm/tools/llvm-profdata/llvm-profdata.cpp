@@ -30,6 +30,7 @@
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 
 using namespace llvm;
 
@@ -287,6 +288,16 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   }
 }
 
+/// Load inputs into a writer context until all of them have been claimed.
+/// Each thread takes the next input as soon as it is done with the previous
+/// one, so that a few large inputs do not hold up the inputs behind them.
+static void loadInputs(const WeightedFileVector &Inputs,
+                       std::atomic<size_t> &NextInput,
+                       SymbolRemapper *Remapper, WriterContext *WC) {
+  for (size_t I = NextInput++; I < Inputs.size() && !WC->Err; I = NextInput++)
+    loadInput(Inputs[I], Remapper, WC);
+}
+
 /// Merge the \p Src writer context into \p Dst.
 static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   // If we've already seen a hard error, continuing with the merge would
@@ -337,12 +348,11 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   } else {
     ThreadPool Pool(NumThreads);
 
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Remapper, Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    // Load the inputs in parallel, each thread into its own context.
+    std::atomic<size_t> NextInput(0);
+    for (auto &WC : Contexts)
+      Pool.async(loadInputs, std::cref(Inputs), std::ref(NextInput), Remapper,
+                 WC.get());
     Pool.wait();
 
     // Merge the writer contexts together (~ lg(NumThreads) serial steps).
@@ -14,6 +14,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/DebugInfo/Symbolize/DIPrinter.h"
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
@@ -23,10 +25,12 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
 
 using namespace llvm;
 using namespace symbolize;
@@ -154,14 +158,28 @@ static cl::opt<DIPrinter::OutputStyle>
                              clEnumValN(DIPrinter::OutputStyle::GNU, "GNU",
                                         "GNU addr2line style")));
 
+static cl::opt<uint64_t> ClCacheSize(
+    "cache-size", cl::init(0), cl::value_desc("bytes"),
+    cl::desc("Close the least recently used binaries once the open ones are "
+             "larger than this (0 = no limit)"));
+
+static cl::opt<unsigned> ClBatchSize(
+    "batch-size", cl::init(1),
+    cl::desc("Read up to N lines from stdin and symbolize them together, "
+             "grouped by module and sorted by address"));
+
+static cl::opt<unsigned>
+    ClThreads("threads", cl::init(1),
+              cl::desc("Number of threads that symbolize a batch of lines"));
+
 static cl::extrahelp
     HelpResponse("\nPass @FILE as argument to read options from FILE.\n");
 
 template<typename T>
-static bool error(Expected<T> &ResOrErr) {
+static bool error(Expected<T> &ResOrErr, raw_ostream &ErrOS) {
   if (ResOrErr)
     return false;
-  logAllUnhandledErrors(ResOrErr.takeError(), errs(),
+  logAllUnhandledErrors(ResOrErr.takeError(), ErrOS,
                         "LLVMSymbolizer: error reading file: ");
   return true;
 }
@@ -213,39 +231,42 @@ static bool parseCommand(StringRef InputString, Command &Cmd,
 }
 
 static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
-                           DIPrinter &Printer) {
+                           raw_ostream &OS, raw_ostream &ErrOS) {
+  DIPrinter Printer(OS, ClPrintFunctions != FunctionNameKind::None,
+                    ClPrettyPrint, ClPrintSourceContextLines, ClVerbose,
+                    ClBasenames, ClOutputStyle);
   Command Cmd;
   std::string ModuleName;
   uint64_t Offset = 0;
   if (!parseCommand(StringRef(InputString), Cmd, ModuleName, Offset)) {
-    outs() << InputString;
+    OS << InputString;
     return;
   }
 
   if (ClPrintAddress) {
-    outs() << "0x";
-    outs().write_hex(Offset);
+    OS << "0x";
+    OS.write_hex(Offset);
     StringRef Delimiter = ClPrettyPrint ? ": " : "\n";
-    outs() << Delimiter;
+    OS << Delimiter;
   }
   Offset -= ClAdjustVMA;
   if (Cmd == Command::Data) {
     auto ResOrErr = Symbolizer.symbolizeData(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DIGlobal() : ResOrErr.get());
+    Printer << (error(ResOrErr, ErrOS) ? DIGlobal() : ResOrErr.get());
   } else if (Cmd == Command::Frame) {
     auto ResOrErr = Symbolizer.symbolizeFrame(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    if (!error(ResOrErr)) {
+    if (!error(ResOrErr, ErrOS)) {
       for (DILocal Local : *ResOrErr)
         Printer << Local;
       if (ResOrErr->empty())
-        outs() << "??\n";
+        OS << "??\n";
     }
   } else if (ClPrintInlining) {
     auto ResOrErr = Symbolizer.symbolizeInlinedCode(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DIInliningInfo() : ResOrErr.get());
+    Printer << (error(ResOrErr, ErrOS) ? DIInliningInfo() : ResOrErr.get());
   } else if (ClOutputStyle == DIPrinter::OutputStyle::GNU) {
     // With ClPrintFunctions == FunctionNameKind::LinkageName (default)
     // and ClUseSymbolTable == true (also default), Symbolizer.symbolizeCode()
@@ -255,14 +276,71 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
     // the topmost function, which suits our needs better.
     auto ResOrErr = Symbolizer.symbolizeInlinedCode(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get().getFrame(0));
+    Printer << (error(ResOrErr, ErrOS) ? DILineInfo()
+                                       : ResOrErr.get().getFrame(0));
   } else {
     auto ResOrErr = Symbolizer.symbolizeCode(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
-    Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get());
+    Printer << (error(ResOrErr, ErrOS) ? DILineInfo() : ResOrErr.get());
   }
   if (ClOutputStyle == DIPrinter::OutputStyle::LLVM)
-    outs() << "\n";
+    OS << "\n";
+}
+
+namespace {
+// A line of input read in a batch, and what symbolizing it printed.
+struct Request {
+  std::string Input;
+  std::string ModuleName;
+  uint64_t Offset = 0;
+  std::string Output;
+  std::string Errors;
+};
+} // namespace
+
+// Symbolizes a batch of input lines, then prints the results in input order.
+// Each module is symbolized by a single one of the symbolizers, which are not
+// thread-safe, so with several threads each one is used by only one thread.
+// Its requests are sorted by address so that lookups walk the module's debug
+// info in order.
+static void
+symbolizeBatch(std::vector<Request> &Batch,
+               std::vector<std::unique_ptr<LLVMSymbolizer>> &Symbolizers,
+               ThreadPool *Pool) {
+  std::vector<std::vector<Request *>> Shards(Symbolizers.size());
+  for (Request &R : Batch) {
+    Command Cmd;
+    parseCommand(R.Input, Cmd, R.ModuleName, R.Offset);
+    Shards[hash_value(R.ModuleName) % Shards.size()].push_back(&R);
+  }
+
+  auto SymbolizeShard = [&](size_t I) {
+    std::vector<Request *> &Shard = Shards[I];
+    llvm::stable_sort(Shard, [](const Request *A, const Request *B) {
+      return std::tie(A->ModuleName, A->Offset) <
+             std::tie(B->ModuleName, B->Offset);
+    });
+    for (Request *R : Shard) {
+      raw_string_ostream OS(R->Output);
+      raw_string_ostream ErrOS(R->Errors);
+      symbolizeInput(R->Input, *Symbolizers[I], OS, ErrOS);
+    }
+    Symbolizers[I]->pruneCache();
+  };
+
+  if (Pool) {
+    for (size_t I = 0, E = Shards.size(); I != E; ++I)
+      Pool->async(SymbolizeShard, I);
+    Pool->wait();
+  } else {
+    SymbolizeShard(0);
+  }
+
+  for (const Request &R : Batch) {
+    errs() << R.Errors;
+    outs() << R.Output;
+  }
+  outs().flush();
 }
 
 int main(int argc, char **argv) {
@@ -302,23 +380,52 @@ int main(int argc, char **argv) {
                 "\" (must have the '.dSYM' extension).\n";
     }
   }
-  LLVMSymbolizer Symbolizer(Opts);
 
-  DIPrinter Printer(outs(), ClPrintFunctions != FunctionNameKind::None,
-                    ClPrettyPrint, ClPrintSourceContextLines, ClVerbose,
-                    ClBasenames, ClOutputStyle);
+  // With several threads, each one has its own symbolizer and its share of
+  // the cache.
+  unsigned NumThreads = 1;
+  if (ClBatchSize > 1)
+    NumThreads = std::max(1U, ClThreads.getValue());
+  if (ClCacheSize)
+    Opts.MaxCacheSize = ClCacheSize / NumThreads;
+  std::vector<std::unique_ptr<LLVMSymbolizer>> Symbolizers;
+  for (unsigned I = 0; I != NumThreads; ++I)
+    Symbolizers.push_back(llvm::make_unique<LLVMSymbolizer>(Opts));
+  LLVMSymbolizer &Symbolizer = *Symbolizers.front();
 
   if (ClInputAddresses.empty()) {
     const int kMaxInputStringLength = 1024;
     char InputString[kMaxInputStringLength];
 
+    if (ClBatchSize > 1) {
+      std::unique_ptr<ThreadPool> Pool;
+      if (NumThreads > 1)
+        Pool = llvm::make_unique<ThreadPool>(NumThreads);
+      std::vector<Request> Batch;
+      Batch.reserve(ClBatchSize);
+      while (fgets(InputString, sizeof(InputString), stdin)) {
+        Batch.emplace_back();
+        Batch.back().Input = InputString;
+        if (Batch.size() == ClBatchSize) {
+          symbolizeBatch(Batch, Symbolizers, Pool.get());
+          Batch.clear();
+        }
+      }
+      if (!Batch.empty())
+        symbolizeBatch(Batch, Symbolizers, Pool.get());
+      return 0;
+    }
+
     while (fgets(InputString, sizeof(InputString), stdin)) {
-      symbolizeInput(InputString, Symbolizer, Printer);
+      symbolizeInput(InputString, Symbolizer, outs(), errs());
       outs().flush();
+      Symbolizer.pruneCache();
     }
   } else {
-    for (StringRef Address : ClInputAddresses)
-      symbolizeInput(Address, Symbolizer, Printer);
+    for (StringRef Address : ClInputAddresses) {
+      symbolizeInput(Address, Symbolizer, outs(), errs());
+      Symbolizer.pruneCache();
+    }
   }
 
   return 0;
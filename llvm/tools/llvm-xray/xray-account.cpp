@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <mutex>
 #include <numeric>
 #include <system_error>
 #include <utility>
@@ -120,6 +121,13 @@ static cl::alias AccountInstrMap2("m", cl::aliasopt(AccountInstrMap),
                                   cl::desc("Alias for -instr_map"),
                                   cl::sub(Account));
 
+static cl::opt<unsigned>
+    AccountThreads("threads",
+                   cl::desc("number of threads that read an FDR mode trace "
+                            "in parallel, each accounting the calls of "
+                            "separate threads of the trace"),
+                   cl::value_desc("N"), cl::sub(Account), cl::init(1));
+
 namespace {
 
 template <class T, class U> void setMinMax(std::pair<T, T> &MM, U &&V) {
@@ -218,6 +226,26 @@ bool LatencyAccountant::accountRecord(const XRayRecord &Record) {
   return true;
 }
 
+void LatencyAccountant::merge(const LatencyAccountant &Other) {
+  for (const auto &FL : Other.FunctionLatencies) {
+    auto &Latencies = FunctionLatencies[FL.first];
+    Latencies.insert(Latencies.end(), FL.second.begin(), FL.second.end());
+  }
+  for (const auto &MM : Other.PerThreadMinMaxTSC) {
+    setMinMax(PerThreadMinMaxTSC[MM.first], MM.second.first);
+    setMinMax(PerThreadMinMaxTSC[MM.first], MM.second.second);
+  }
+  for (const auto &MM : Other.PerCPUMinMaxTSC) {
+    setMinMax(PerCPUMinMaxTSC[MM.first], MM.second.first);
+    setMinMax(PerCPUMinMaxTSC[MM.first], MM.second.second);
+  }
+  for (const auto &ThreadStack : Other.PerThreadFunctionStack) {
+    auto &Stack = PerThreadFunctionStack[ThreadStack.first];
+    Stack.insert(Stack.end(), ThreadStack.second.begin(),
+                 ThreadStack.second.end());
+  }
+}
+
 namespace {
 
 // We consolidate the data into a struct which we can output in various forms.
@@ -430,19 +458,22 @@ static CommandRegistration Unused(&Account, []() -> Error {
   symbolize::LLVMSymbolizer Symbolizer;
   llvm::xray::FuncIdConversionHelper FuncIdHelper(AccountInstrMap, Symbolizer,
                                                   FunctionAddresses);
-  xray::LatencyAccountant FCA(FuncIdHelper, AccountDeduceSiblingCalls);
-  auto TraceOrErr = loadTraceFile(AccountInput);
-  if (!TraceOrErr)
-    return joinErrors(
-        make_error<StringError>(
-            Twine("Failed loading input file '") + AccountInput + "'",
-            std::make_error_code(std::errc::executable_format_error)),
-        TraceOrErr.takeError());
 
-  auto &T = *TraceOrErr;
-  for (const auto &Record : T) {
+  // The trace is streamed rather than loaded, and each worker accounts the
+  // calls of the trace threads it reads into its own accountant.
+  unsigned Threads = std::max(AccountThreads.getValue(), 1u);
+  std::vector<xray::LatencyAccountant> Accountants;
+  Accountants.reserve(Threads);
+  for (unsigned I = 0; I != Threads; ++I)
+    Accountants.emplace_back(FuncIdHelper, AccountDeduceSiblingCalls);
+
+  std::mutex ErrorMutex;
+  bool AccountingFailed = false;
+  auto AccountRecord = [&](unsigned Worker, const XRayRecord &Record) -> Error {
+    auto &FCA = Accountants[Worker];
     if (FCA.accountRecord(Record))
-      continue;
+      return Error::success();
+    std::lock_guard<std::mutex> Lock(ErrorMutex);
     errs()
         << "Error processing record: "
         << llvm::formatv(
@@ -461,18 +492,35 @@ static CommandRegistration Unused(&Account, []() -> Error {
         errs() << "  #" << Level-- << "\t"
                << FuncIdHelper.SymbolOrNumber(Entry.first) << '\n';
     }
-    if (!AccountKeepGoing)
-      return make_error<StringError>(
-          Twine("Failed accounting function calls in file '") + AccountInput +
-              "'.",
-          std::make_error_code(std::errc::executable_format_error));
+    if (AccountKeepGoing)
+      return Error::success();
+    AccountingFailed = true;
+    return make_error<StringError>(
+        Twine("Failed accounting function calls in file '") + AccountInput +
+            "'.",
+        std::make_error_code(std::errc::executable_format_error));
+  };
+
+  XRayFileHeader Header;
+  if (auto E = streamTraceFile(AccountInput, Header, AccountRecord, Threads)) {
+    if (AccountingFailed)
+      return E;
+    return joinErrors(
+        make_error<StringError>(
+            Twine("Failed loading input file '") + AccountInput + "'",
+            std::make_error_code(std::errc::executable_format_error)),
+        std::move(E));
   }
+
+  auto &FCA = Accountants.front();
+  for (unsigned I = 1; I != Threads; ++I)
+    FCA.merge(Accountants[I]);
   switch (AccountOutputFormat) {
   case AccountOutputFormats::TEXT:
-    FCA.exportStatsAsText(OS, T.getFileHeader());
+    FCA.exportStatsAsText(OS, Header);
     break;
   case AccountOutputFormats::CSV:
-    FCA.exportStatsAsCSV(OS, T.getFileHeader());
+    FCA.exportStatsAsCSV(OS, Header);
     break;
   }
 
@@ -76,6 +76,10 @@ public:
   ///
   bool accountRecord(const XRayRecord &Record);
 
+  /// Adds the latencies and TSC ranges accounted by |Other|, which accounted
+  /// the records of other threads of the same trace.
+  void merge(const LatencyAccountant &Other);
+
   const PerThreadFunctionStackMap &getPerThreadFunctionStack() const {
     return PerThreadFunctionStack;
   }
@@ -133,7 +133,8 @@ void dumpDebugInfo(DWARFContext &DCtx, DWARFYAML::Data &Y) {
 
       NewEntry.AbbrCode = EntryData.getULEB128(&offset);
 
-      auto AbbrevDecl = DIE.getAbbreviationDeclarationPtr();
+      auto AbbrevDecl =
+          DIE.getAbbreviationDeclarationPtr(CU->getAbbreviations());
       if (AbbrevDecl) {
         for (const auto &AttrSpec : AbbrevDecl->attributes()) {
           DWARFYAML::FormValue NewValue;
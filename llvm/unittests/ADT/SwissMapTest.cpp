@@ -0,0 +1,290 @@
+//===- llvm/unittest/ADT/SwissMapTest.cpp - SwissMap unit tests -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SwissMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <set>
+
+using namespace llvm;
+
+namespace {
+
+/// A test class that tries to check that construction and destruction
+/// occur correctly.
+class CtorTester {
+  static std::set<CtorTester *> Constructed;
+  int Value;
+
+public:
+  explicit CtorTester(int Value = 0) : Value(Value) {
+    EXPECT_TRUE(Constructed.insert(this).second);
+  }
+  CtorTester(const CtorTester &Arg) : Value(Arg.Value) {
+    EXPECT_TRUE(Constructed.insert(this).second);
+  }
+  CtorTester &operator=(const CtorTester &) = default;
+  ~CtorTester() { EXPECT_EQ(1u, Constructed.erase(this)); }
+
+  int getValue() const { return Value; }
+  bool operator==(const CtorTester &RHS) const { return Value == RHS.Value; }
+
+  static size_t getNumConstructed() { return Constructed.size(); }
+};
+
+std::set<CtorTester *> CtorTester::Constructed;
+
+struct CtorTesterMapInfo {
+  static unsigned getHashValue(const CtorTester &Val) {
+    return Val.getValue() * 37u;
+  }
+  static bool isEqual(const CtorTester &LHS, const CtorTester &RHS) {
+    return LHS == RHS;
+  }
+};
+
+TEST(SwissMapTest, EmptyMap) {
+  SwissMap<int, int> M;
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(0u, M.size());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_TRUE(M.find(0) == M.end());
+  EXPECT_EQ(0u, M.count(0));
+  EXPECT_EQ(0, M.lookup(0));
+  EXPECT_FALSE(M.erase(0));
+  EXPECT_EQ(0u, M.getMemorySize());
+
+  const SwissMap<int, int> &CM = M;
+  EXPECT_TRUE(CM.begin() == CM.end());
+  EXPECT_TRUE(CM.find(0) == CM.end());
+}
+
+TEST(SwissMapTest, SingleEntry) {
+  SwissMap<int, int> M;
+  auto R = M.insert(std::make_pair(1, 2));
+  EXPECT_TRUE(R.second);
+  EXPECT_EQ(1, R.first->first);
+  EXPECT_EQ(2, R.first->second);
+
+  EXPECT_FALSE(M.empty());
+  EXPECT_EQ(1u, M.size());
+  EXPECT_EQ(1u, M.count(1));
+  EXPECT_EQ(2, M.lookup(1));
+  EXPECT_EQ(2, M[1]);
+  EXPECT_TRUE(M.find(1) == R.first);
+  EXPECT_TRUE(M.begin() == R.first);
+  EXPECT_TRUE(std::next(M.begin()) == M.end());
+
+  // A second insertion of the key does not replace the value.
+  R = M.insert(std::make_pair(1, 3));
+  EXPECT_FALSE(R.second);
+  EXPECT_EQ(2, R.first->second);
+
+  M[1] = 4;
+  EXPECT_EQ(4, M.lookup(1));
+
+  EXPECT_TRUE(M.erase(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_TRUE(M.empty());
+  EXPECT_TRUE(M.find(1) == M.end());
+}
+
+TEST(SwissMapTest, TryEmplace) {
+  SwissMap<int, std::unique_ptr<int>> M;
+  auto R = M.try_emplace(1, new int(5));
+  EXPECT_TRUE(R.second);
+  EXPECT_EQ(5, *R.first->second);
+
+  // The value is not constructed if the key is present.
+  auto P = llvm::make_unique<int>(6);
+  R = M.try_emplace(1, std::move(P));
+  EXPECT_FALSE(R.second);
+  EXPECT_TRUE(P != nullptr);
+  EXPECT_EQ(5, *M[1]);
+}
+
+// Keys which all land in the same group must still be told apart, and
+// deleting some of them must not hide the others.
+TEST(SwissMapTest, CollidingHashes) {
+  struct SameHashInfo {
+    static unsigned getHashValue(int) { return 42; }
+    static bool isEqual(int LHS, int RHS) { return LHS == RHS; }
+  };
+  SwissMap<int, int, SameHashInfo> M;
+  for (int I = 0; I != 100; ++I)
+    M[I] = I + 1;
+  EXPECT_EQ(100u, M.size());
+  for (int I = 0; I != 100; I += 2)
+    EXPECT_TRUE(M.erase(I));
+  for (int I = 0; I != 100; ++I)
+    EXPECT_EQ(I % 2 ? I + 1 : 0, M.lookup(I));
+  for (int I = 0; I != 100; I += 2)
+    EXPECT_TRUE(M.insert(std::make_pair(I, -I)).second);
+  for (int I = 0; I != 100; ++I)
+    EXPECT_EQ(I % 2 ? I + 1 : -I, M.lookup(I));
+}
+
+// Compare a random sequence of insertions and removals against std::map, so
+// that the map grows, and is rehashed to drop deleted buckets.
+TEST(SwissMapTest, RandomChurn) {
+  SwissMap<unsigned, unsigned> M;
+  std::map<unsigned, unsigned> Expected;
+  uint32_t State = 1;
+  auto Next = [&]() {
+    State = State * 1103515245u + 12345u;
+    return (State >> 8) % 4096;
+  };
+  for (unsigned I = 0; I != 50000; ++I) {
+    unsigned Key = Next();
+    if (Next() % 3 == 0) {
+      EXPECT_EQ(Expected.erase(Key) != 0, M.erase(Key));
+    } else {
+      M[Key] = I;
+      Expected[Key] = I;
+    }
+  }
+
+  EXPECT_EQ(Expected.size(), M.size());
+  for (const auto &KV : Expected)
+    EXPECT_EQ(KV.second, M.lookup(KV.first));
+  size_t Visited = 0;
+  for (const auto &KV : M) {
+    EXPECT_EQ(Expected[KV.first], KV.second);
+    ++Visited;
+  }
+  EXPECT_EQ(Expected.size(), Visited);
+}
+
+TEST(SwissMapTest, Reserve) {
+  SwissMap<int, int> M;
+  M.reserve(1000);
+  unsigned NumBuckets = M.getNumBuckets();
+  EXPECT_LE(1000u, NumBuckets - NumBuckets / 8);
+  for (int I = 0; I != 1000; ++I)
+    M[I] = I;
+  EXPECT_EQ(NumBuckets, M.getNumBuckets());
+}
+
+TEST(SwissMapTest, CopyAndMove) {
+  SwissMap<int, int> M;
+  for (int I = 0; I != 100; ++I)
+    M[I] = I * 2;
+  M.erase(7);
+
+  SwissMap<int, int> Copy(M);
+  EXPECT_EQ(99u, Copy.size());
+  for (int I = 0; I != 100; ++I)
+    EXPECT_EQ(I == 7 ? 0 : I * 2, Copy.lookup(I));
+
+  SwissMap<int, int> Moved(std::move(M));
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(99u, Moved.size());
+
+  M = Moved;
+  EXPECT_EQ(99u, M.size());
+  Copy = std::move(Moved);
+  EXPECT_EQ(99u, Copy.size());
+  EXPECT_EQ(198, Copy.lookup(99));
+
+  M.swap(Copy);
+  M.clear();
+  EXPECT_TRUE(M.empty());
+  EXPECT_TRUE(M.find(1) == M.end());
+  EXPECT_EQ(2, Copy.lookup(1));
+}
+
+TEST(SwissMapTest, CtorDtorBalance) {
+  size_t Before = CtorTester::getNumConstructed();
+  {
+    SwissMap<CtorTester, CtorTester, CtorTesterMapInfo> M;
+    for (int I = 0; I != 200; ++I)
+      M.try_emplace(CtorTester(I), I + 1);
+    for (int I = 0; I < 200; I += 3)
+      M.erase(CtorTester(I));
+    EXPECT_EQ(Before + 2 * M.size(), CtorTester::getNumConstructed());
+
+    SwissMap<CtorTester, CtorTester, CtorTesterMapInfo> Copy(M);
+    EXPECT_EQ(Before + 4 * M.size(), CtorTester::getNumConstructed());
+    Copy.clear();
+    EXPECT_EQ(Before + 2 * M.size(), CtorTester::getNumConstructed());
+  }
+  EXPECT_EQ(Before, CtorTester::getNumConstructed());
+}
+
+TEST(SwissMapTest, EraseWhileIterating) {
+  SwissMap<int, int> M;
+  for (int I = 0; I != 100; ++I)
+    M[I] = I;
+  for (auto I = M.begin(), E = M.end(); I != E;) {
+    auto Cur = I++;
+    if (Cur->first % 2)
+      M.erase(Cur);
+  }
+  EXPECT_EQ(50u, M.size());
+  for (const auto &KV : M)
+    EXPECT_EQ(0, KV.first % 2);
+}
+
+TEST(SwissMapTest, InitializerListAndRange) {
+  SwissMap<int, int> M = {{1, 2}, {3, 4}};
+  EXPECT_EQ(2u, M.size());
+  EXPECT_EQ(4, M.lookup(3));
+
+  SwissMap<int, int> R(M.begin(), M.end());
+  EXPECT_EQ(2u, R.size());
+  EXPECT_EQ(2, R.lookup(1));
+}
+
+TEST(SwissMapTest, StringRefKeys) {
+  SwissMap<StringRef, int> M;
+  M["a"] = 1;
+  M["b"] = 2;
+  // The empty string is an ordinary key, unlike the DenseMapInfo empty key.
+  M[""] = 3;
+  EXPECT_EQ(3u, M.size());
+  std::string B = "b";
+  EXPECT_EQ(2, M.lookup(B));
+  EXPECT_EQ(3, M.lookup(""));
+}
+
+// Keys which are DenseMap's empty and tombstone keys are ordinary keys here.
+TEST(SwissMapTest, ReservedDenseMapKeys) {
+  SwissMap<unsigned, int> M;
+  M[DenseMapInfo<unsigned>::getEmptyKey()] = 1;
+  M[DenseMapInfo<unsigned>::getTombstoneKey()] = 2;
+  EXPECT_EQ(2u, M.size());
+  EXPECT_EQ(1, M.lookup(DenseMapInfo<unsigned>::getEmptyKey()));
+  EXPECT_EQ(2, M.lookup(DenseMapInfo<unsigned>::getTombstoneKey()));
+}
+
+struct A {
+  A(int Value) : Value(Value) {}
+  int Value;
+};
+
+struct AInfo {
+  static unsigned getHashValue(const A &Val) { return Val.Value; }
+  static unsigned getHashValue(int Val) { return Val; }
+  static bool isEqual(const A &LHS, const A &RHS) {
+    return LHS.Value == RHS.Value;
+  }
+  static bool isEqual(int LHS, const A &RHS) { return LHS == RHS.Value; }
+};
+
+TEST(SwissMapTest, FindAs) {
+  SwissMap<A, int, AInfo> M;
+  M[A(1)] = 1;
+  M[A(2)] = 2;
+  EXPECT_EQ(1, M.find_as(1)->second);
+  EXPECT_EQ(2, M.find_as(2)->second);
+  EXPECT_TRUE(M.find_as(3) == M.end());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,208 @@
+//===----------- ELF_x86_64.cpp - Tests for JITLink ELF/x86-64 ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "JITLinkTestCommon.h"
+
+#include "llvm/ExecutionEngine/JITLink/ELF_x86_64.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_x86_64_Edges;
+
+namespace {
+
+class JITLinkTest_ELF_x86_64 : public JITLinkTestCommon,
+                               public testing::Test {
+public:
+  using BasicVerifyGraphFunction =
+      std::function<void(AtomGraph &, const MCDisassembler &)>;
+
+  void runBasicVerifyGraphTest(StringRef AsmSrc, StringRef Triple,
+                               StringMap<JITEvaluatedSymbol> Externals,
+                               bool PIC, bool LargeCodeModel,
+                               MCTargetOptions Options,
+                               BasicVerifyGraphFunction RunGraphTest) {
+    auto TR = getTestResources(AsmSrc, Triple, PIC, LargeCodeModel,
+                               std::move(Options));
+    if (!TR) {
+      dbgs() << "Skipping JITLInk unit test: " << toString(TR.takeError())
+             << "\n";
+      return;
+    }
+
+    auto JTCtx = llvm::make_unique<TestJITLinkContext>(
+        **TR, [&](AtomGraph &G) { RunGraphTest(G, (*TR)->getDisassembler()); });
+
+    JTCtx->externals() = std::move(Externals);
+
+    jitLink_ELF_x86_64(std::move(JTCtx));
+  }
+
+protected:
+  // Atoms of an ELF section are chained together by layout and keep-alive
+  // edges, so the tests look for the relocation edges only.
+  static size_t countRelocationEdges(DefinedAtom &A) {
+    return countEdgesMatching(A,
+                              [](const Edge &E) { return E.isRelocation(); });
+  }
+
+  static Edge &relocationEdge(DefinedAtom &A) {
+    for (auto &E : A.edges())
+      if (E.isRelocation())
+        return E;
+    llvm_unreachable("Atom has no relocation edges");
+  }
+
+  static void verifyIsPointerTo(AtomGraph &G, DefinedAtom &A, Atom &Target) {
+    EXPECT_EQ(countRelocationEdges(A), 1U)
+        << "Incorrect number of edges for pointer";
+    if (countRelocationEdges(A) != 1U)
+      return;
+    auto &E = relocationEdge(A);
+    EXPECT_EQ(E.getKind(), Pointer64)
+        << "Expected pointer to have a pointer64 relocation";
+    EXPECT_EQ(&E.getTarget(), &Target) << "Expected edge to point at target";
+    EXPECT_THAT_EXPECTED(readInt<uint64_t>(G, A), HasValue(Target.getAddress()))
+        << "Pointer does not point to target";
+  }
+
+  // Returns the target of the rel32 displacement at the given edge.
+  static JITTargetAddress readPCRel32Target(AtomGraph &G, DefinedAtom &A,
+                                            Edge &E) {
+    JITTargetAddress FixupAddress = A.getAddress() + E.getOffset();
+    auto Disp = readInt<int32_t>(G, A, E.getOffset());
+    if (!Disp) {
+      ADD_FAILURE() << toString(Disp.takeError());
+      return 0;
+    }
+    return FixupAddress + 4 + *Disp;
+  }
+};
+
+} // end anonymous namespace
+
+TEST_F(JITLinkTest_ELF_x86_64, BasicRelocations) {
+  runBasicVerifyGraphTest(
+      R"(
+            .text
+            .globl  bar
+            .p2align        4, 0x90
+            .type   bar,@function
+    bar:
+            callq   baz@PLT
+
+            .globl  foo
+            .p2align        4, 0x90
+            .type   foo,@function
+    foo:
+            callq   bar@PLT
+    foo.1:
+            movq    y@GOTPCREL(%rip), %rcx
+    foo.2:
+            movq    x@GOTPCREL(%rip), %rdx
+
+            .data
+            .globl  x
+            .p2align        2
+    x:
+            .long   42
+
+            .globl  p
+            .p2align        3
+    p:
+            .quad   x)",
+      "x86_64-unknown-linux",
+      {{"y", JITEvaluatedSymbol(0xdeadbeef, JITSymbolFlags::Exported)},
+       {"baz", JITEvaluatedSymbol(0xcafef00d, JITSymbolFlags::Exported)}},
+      true, false, MCTargetOptions(),
+      [](AtomGraph &G, const MCDisassembler &Dis) {
+        // Name the atoms in the asm above.
+        auto &Baz = atom(G, "baz");
+        auto &Y = atom(G, "y");
+
+        auto &Bar = definedAtom(G, "bar");
+        auto &Foo = definedAtom(G, "foo");
+        auto &Foo_1 = definedAtom(G, "foo.1");
+        auto &Foo_2 = definedAtom(G, "foo.2");
+        auto &X = definedAtom(G, "x");
+        auto &P = definedAtom(G, "p");
+
+        // Check the pointer reloc for p.
+        verifyIsPointerTo(G, P, X);
+
+        // Check that bar calls baz through a stub, or directly if baz is in
+        // range, and that the stub jumps through a GOT entry for baz.
+        {
+          EXPECT_EQ(countRelocationEdges(Bar), 1U)
+              << "Incorrect number of edges for bar";
+          auto &E = relocationEdge(Bar);
+          EXPECT_EQ(E.getKind(), Branch32ToStub)
+              << "Unexpected edge kind for bar";
+          ASSERT_TRUE(E.getTarget().isDefined())
+              << "Edge target is not a stub";
+          auto &Stub = static_cast<DefinedAtom &>(E.getTarget());
+          ASSERT_EQ(Stub.edges_size(), 1U)
+              << "Expected one edge from stub to target";
+          auto &StubEdge = *Stub.edges().begin();
+          EXPECT_EQ(StubEdge.getKind(), PCRel32);
+          ASSERT_TRUE(StubEdge.getTarget().isDefined())
+              << "Stub does not reference a GOT entry";
+          auto &GOTEntry = static_cast<DefinedAtom &>(StubEdge.getTarget());
+          verifyIsPointerTo(G, GOTEntry, Baz);
+
+          JITTargetAddress CallTarget = readPCRel32Target(G, Bar, E);
+          EXPECT_TRUE(CallTarget == Stub.getAddress() ||
+                      CallTarget == Baz.getAddress())
+              << "Call does not reach baz";
+        }
+
+        // Check that foo is a direct call to bar.
+        {
+          EXPECT_EQ(countRelocationEdges(Foo), 1U)
+              << "Incorrect number of edges for foo";
+          auto &E = relocationEdge(Foo);
+          EXPECT_EQ(E.getKind(), Branch32);
+          EXPECT_EQ(&E.getTarget(), &Bar);
+          EXPECT_EQ(readPCRel32Target(G, Foo, E), Bar.getAddress());
+        }
+
+        // Check that the GOT loads in foo.1 and foo.2 are marked relaxable,
+        // and are either relaxed to a lea of their target or still load from
+        // the GOT entry.
+        auto VerifyGOTLoad = [&](DefinedAtom &A, Atom &Target) {
+          EXPECT_EQ(countRelocationEdges(A), 1U)
+              << "Incorrect number of edges for " << A.getName();
+          auto &E = relocationEdge(A);
+          EXPECT_EQ(E.getKind(), PCRel32GOTLoadRelaxable);
+          if (!E.getTarget().isDefined()) {
+            ADD_FAILURE() << "GOT entry should be a defined atom";
+            return;
+          }
+          auto &GOTEntry = static_cast<DefinedAtom &>(E.getTarget());
+          verifyIsPointerTo(G, GOTEntry, Target);
+
+          auto Opcode = readInt<uint8_t>(G, A, E.getOffset() - 2);
+          if (!Opcode) {
+            ADD_FAILURE() << toString(Opcode.takeError());
+            return;
+          }
+          JITTargetAddress LoadTarget = readPCRel32Target(G, A, E);
+          if (*Opcode == 0x8d)
+            EXPECT_EQ(LoadTarget, Target.getAddress())
+                << "Relaxed load does not reference target";
+          else
+            EXPECT_EQ(LoadTarget, GOTEntry.getAddress())
+                << "GOT load does not reference GOT entry";
+        };
+        VerifyGOTLoad(Foo_1, Y);
+        VerifyGOTLoad(Foo_2, X);
+      });
+}
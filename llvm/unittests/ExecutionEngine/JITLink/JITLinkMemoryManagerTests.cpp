@@ -0,0 +1,107 @@
+//===------ JITLinkMemoryManagerTests.cpp - Tests for memory managers -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+
+namespace {
+
+const auto ReadExec = static_cast<sys::Memory::ProtectionFlags>(
+    sys::Memory::MF_READ | sys::Memory::MF_EXEC);
+const auto ReadWrite = static_cast<sys::Memory::ProtectionFlags>(
+    sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+
+std::unique_ptr<JITLinkMemoryManager::Allocation>
+allocateOrFail(JITLinkMemoryManager &MemMgr, size_t CodeSize,
+               size_t DataSize) {
+  JITLinkMemoryManager::SegmentsRequestMap Request;
+  Request[ReadExec] = {CodeSize, 16, 0, 1};
+  Request[ReadWrite] = {DataSize, 8, 64, 8};
+  auto Alloc = MemMgr.allocate(Request);
+  if (!Alloc) {
+    ADD_FAILURE() << toString(Alloc.takeError());
+    return nullptr;
+  }
+  return std::move(*Alloc);
+}
+
+void finalizeOrFail(JITLinkMemoryManager::Allocation &Alloc) {
+  Alloc.finalizeAsync([](Error Err) { EXPECT_THAT_ERROR(std::move(Err),
+                                                        Succeeded()); });
+}
+
+TEST(InProcessSlabMemoryManagerTest, PacksSegmentsIntoSlabs) {
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  InProcessSlabMemoryManager MemMgr(64 * PageSize);
+
+  auto A1 = allocateOrFail(MemMgr, 100, 100);
+  auto A2 = allocateOrFail(MemMgr, 100, 100);
+  ASSERT_TRUE(A1 && A2);
+
+  // Segments of the same protection are adjacent pages of one slab.
+  EXPECT_EQ(A2->getTargetMemory(ReadExec),
+            A1->getTargetMemory(ReadExec) + PageSize);
+  EXPECT_EQ(A2->getTargetMemory(ReadWrite),
+            A1->getTargetMemory(ReadWrite) + PageSize);
+
+  // Working memory is zeroed, including the zero-fill memory.
+  auto Data = A1->getWorkingMemory(ReadWrite);
+  EXPECT_EQ(Data.size(), PageSize);
+  EXPECT_TRUE(std::all_of(Data.begin(), Data.end(),
+                          [](char C) { return C == 0; }));
+
+  A1->getWorkingMemory(ReadExec)[0] = static_cast<char>(0xc3);
+  finalizeOrFail(*A1);
+  finalizeOrFail(*A2);
+  EXPECT_THAT_ERROR(A1->deallocate(), Succeeded());
+  EXPECT_THAT_ERROR(A2->deallocate(), Succeeded());
+}
+
+TEST(InProcessSlabMemoryManagerTest, ReusesDeallocatedSegments) {
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  InProcessSlabMemoryManager MemMgr(64 * PageSize);
+
+  auto A1 = allocateOrFail(MemMgr, 100, 100);
+  auto A2 = allocateOrFail(MemMgr, 100, 100);
+  ASSERT_TRUE(A1 && A2);
+  JITTargetAddress Code1 = A1->getTargetMemory(ReadExec);
+
+  A1->getWorkingMemory(ReadExec)[0] = 1;
+  finalizeOrFail(*A1);
+  EXPECT_THAT_ERROR(A1->deallocate(), Succeeded());
+  EXPECT_THAT_ERROR(A2->deallocate(), Succeeded());
+
+  // The freed pages are merged, so a two-page segment fits where the first
+  // two allocations were.
+  auto A3 = allocateOrFail(MemMgr, 2 * PageSize, 100);
+  ASSERT_TRUE(A3);
+  EXPECT_EQ(A3->getTargetMemory(ReadExec), Code1);
+  auto Code = A3->getWorkingMemory(ReadExec);
+  EXPECT_EQ(Code[0], 0) << "Reused memory was not cleared";
+  Code[0] = 1; // Reused memory is writable again.
+  EXPECT_THAT_ERROR(A3->deallocate(), Succeeded());
+}
+
+TEST(InProcessSlabMemoryManagerTest, MapsLargeSegmentsSeparately) {
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  InProcessSlabMemoryManager MemMgr(4 * PageSize, true);
+
+  auto Large = allocateOrFail(MemMgr, 8 * PageSize, 100);
+  ASSERT_TRUE(Large);
+  EXPECT_EQ(Large->getWorkingMemory(ReadExec).size(), 8 * PageSize);
+  finalizeOrFail(*Large);
+  EXPECT_THAT_ERROR(Large->deallocate(), Succeeded());
+}
+
+} // end anonymous namespace
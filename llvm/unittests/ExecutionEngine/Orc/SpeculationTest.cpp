@@ -0,0 +1,74 @@
+//===---------- SpeculationTest.cpp - Unit tests for the Speculator -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/Speculation.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class SpeculatorTest : public CoreAPIsBasedStandardTest {
+protected:
+  // Defines Name in JD, counting how often it is materialized.
+  void defineCallable(SymbolStringPtr Name, JITTargetAddress Addr,
+                      unsigned &Materialized) {
+    auto Flags = JITSymbolFlags::Exported | JITSymbolFlags::Callable;
+    cantFail(JD.define(llvm::make_unique<SimpleMaterializationUnit>(
+        SymbolFlagsMap({{Name, Flags}}),
+        [=, &Materialized](MaterializationResponsibility R) {
+          ++Materialized;
+          R.notifyResolved({{Name, JITEvaluatedSymbol(Addr, Flags)}});
+          R.notifyEmitted();
+        })));
+  }
+};
+
+TEST_F(SpeculatorTest, SpeculatesDefinedCallees) {
+  unsigned BarMaterialized = 0;
+  defineCallable(Bar, BarAddr, BarMaterialized);
+
+  // Baz is not defined in JD, so it is not speculated.
+  Speculator S(ES);
+  S.speculateCallees(JD, Foo, {Bar, Baz});
+  EXPECT_EQ(BarMaterialized, 1U) << "Callee was not materialized";
+
+  // Bar has been speculated already.
+  S.speculateCallees(JD, Foo, {Bar});
+  EXPECT_EQ(S.getStatistics().Speculated, 1U);
+
+  S.recordCall(JD, Bar);
+  S.recordCall(JD, Bar);
+  S.recordCall(JD, Baz);
+  auto Stats = S.getStatistics();
+  EXPECT_EQ(Stats.Hits, 1U) << "First call to Bar should be a hit";
+  EXPECT_EQ(Stats.Misses, 1U) << "First call to Baz should be a miss";
+}
+
+TEST_F(SpeculatorTest, StopsAtMaxDepth) {
+  unsigned BarMaterialized = 0, BazMaterialized = 0;
+  defineCallable(Bar, BarAddr, BarMaterialized);
+  defineCallable(Baz, BazAddr, BazMaterialized);
+
+  // Bar is one level away from Foo, so with a maximum depth of 1 nothing is
+  // speculated for it until it is called.
+  Speculator S(ES, 1);
+  S.speculateCallees(JD, Foo, {Bar});
+  S.speculateCallees(JD, Bar, {Baz});
+  EXPECT_EQ(BarMaterialized, 1U);
+  EXPECT_EQ(BazMaterialized, 0U);
+
+  S.recordCall(JD, Bar);
+  S.speculateCallees(JD, Bar, {Baz});
+  EXPECT_EQ(BazMaterialized, 1U);
+  EXPECT_EQ(S.getStatistics().Speculated, 2U);
+}
+
+} // namespace
@@ -14,6 +14,7 @@
 #include <llvm/IR/PassInstrumentation.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/IR/PassTimingInfo.h>
+#include <llvm/Passes/StandardInstrumentations.h>
 #include <llvm/Support/raw_ostream.h>
 
 using namespace llvm;
@@ -166,4 +167,43 @@ TEST(TimePassesTest, CustomOut) {
   EXPECT_TRUE(TimePassesStr.str().contains("Pass2"));
 }
 
+TEST(TimePassesTest, PassStatsJSON) {
+  PassInstrumentationCallbacks PIC;
+  PassInstrumentation PI(&PIC);
+
+  LLVMContext Context;
+  Module M("TestModule", Context);
+  MyPass1 Pass1;
+  MyPass2 Pass2;
+
+  std::string StatsStr;
+  raw_string_ostream StatsStream(StatsStr);
+
+  PassStatsInstrumentation PassStats(/*Enabled=*/true);
+  PassStats.setOutStream(StatsStream);
+  PassStats.registerCallbacks(PIC);
+
+  PI.runBeforePass(Pass1, M);
+  PI.runAfterPass(Pass1, M);
+  PI.runBeforePass(Pass2, M);
+  PI.runAfterPassInvalidated<Module>(Pass2);
+
+  PassStats.print();
+  StatsStream.flush();
+
+  // Both pass runs should be recorded on the module, and the second one
+  // should be marked as having invalidated it.
+  EXPECT_TRUE(StringRef(StatsStr).contains("MyPass1"));
+  EXPECT_TRUE(StringRef(StatsStr).contains("MyPass2"));
+  EXPECT_TRUE(StringRef(StatsStr).contains("\"ir\": \"TestModule\""));
+  EXPECT_TRUE(StringRef(StatsStr).contains("\"instructions_delta\": 0"));
+  EXPECT_TRUE(StringRef(StatsStr).contains("\"invalidated\": true"));
+
+  // The records are cleared once written out.
+  StatsStr.clear();
+  PassStats.print();
+  StatsStream.flush();
+  EXPECT_TRUE(StatsStr.empty());
+}
+
 } // end anonymous namespace
@@ -0,0 +1,120 @@
+//===- unittest/Remarks/BitstreamRemarksTest.cpp - Bitstream tests --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkParser.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+static remarks::Remark makeRemark(StringRef Function, bool WithLocs) {
+  remarks::Remark R;
+  R.RemarkType = remarks::Type::Missed;
+  R.PassName = "inline";
+  R.RemarkName = "NoDefinition";
+  R.FunctionName = Function;
+  if (WithLocs)
+    R.Loc = remarks::RemarkLocation{"file.c", 3, 12};
+  R.Hotness = 4;
+  R.Args.emplace_back();
+  R.Args.back().Key = "Callee";
+  R.Args.back().Val = "bar";
+  if (WithLocs)
+    R.Args.back().Loc = remarks::RemarkLocation{"file.c", 2, 0};
+  R.Args.emplace_back();
+  R.Args.back().Key = "String";
+  R.Args.back().Val = " will not be inlined into ";
+  return R;
+}
+
+static void checkRemark(const remarks::Remark &Ref,
+                        const remarks::Remark &Parsed) {
+  EXPECT_EQ(Ref.RemarkType, Parsed.RemarkType);
+  EXPECT_EQ(Ref.PassName, Parsed.PassName);
+  EXPECT_EQ(Ref.RemarkName, Parsed.RemarkName);
+  EXPECT_EQ(Ref.FunctionName, Parsed.FunctionName);
+  EXPECT_EQ(Ref.Loc.hasValue(), Parsed.Loc.hasValue());
+  if (Ref.Loc && Parsed.Loc) {
+    EXPECT_EQ(Ref.Loc->SourceFilePath, Parsed.Loc->SourceFilePath);
+    EXPECT_EQ(Ref.Loc->SourceLine, Parsed.Loc->SourceLine);
+    EXPECT_EQ(Ref.Loc->SourceColumn, Parsed.Loc->SourceColumn);
+  }
+  EXPECT_EQ(Ref.Hotness, Parsed.Hotness);
+  ASSERT_EQ(Ref.Args.size(), Parsed.Args.size());
+  for (unsigned I = 0, E = Ref.Args.size(); I != E; ++I) {
+    EXPECT_EQ(Ref.Args[I].Key, Parsed.Args[I].Key);
+    EXPECT_EQ(Ref.Args[I].Val, Parsed.Args[I].Val);
+    EXPECT_EQ(Ref.Args[I].Loc.hasValue(), Parsed.Args[I].Loc.hasValue());
+  }
+}
+
+TEST(BitstreamRemarks, RoundTrip) {
+  remarks::Remark First = makeRemark("foo", /*WithLocs=*/true);
+  remarks::Remark Second = makeRemark("baz", /*WithLocs=*/false);
+
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  {
+    remarks::BitstreamSerializer S(OS);
+    S.emit(First);
+    S.emit(Second);
+    // The string table is embedded in the stream.
+    EXPECT_FALSE(S.StrTab.hasValue());
+  }
+  OS.flush();
+
+  Expected<std::unique_ptr<remarks::Parser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, Buf);
+  ASSERT_TRUE(static_cast<bool>(MaybeParser));
+  remarks::Parser &Parser = **MaybeParser;
+
+  Expected<std::unique_ptr<remarks::Remark>> Remark = Parser.next();
+  ASSERT_TRUE(static_cast<bool>(Remark));
+  checkRemark(First, **Remark);
+  // The strings are not copied out of the buffer.
+  EXPECT_GE((*Remark)->PassName.data(), Buf.data());
+  EXPECT_LT((*Remark)->PassName.data(), Buf.data() + Buf.size());
+
+  Remark = Parser.next();
+  ASSERT_TRUE(static_cast<bool>(Remark));
+  checkRemark(Second, **Remark);
+
+  Remark = Parser.next();
+  ASSERT_FALSE(static_cast<bool>(Remark));
+  Error E = Remark.takeError();
+  EXPECT_TRUE(E.isA<remarks::EndOfFileError>());
+  consumeError(std::move(E));
+}
+
+TEST(BitstreamRemarks, StringsAreEmittedOnce) {
+  std::string OneBuf, TwoBuf;
+  {
+    raw_string_ostream OS(OneBuf);
+    remarks::BitstreamSerializer S(OS);
+    S.emit(makeRemark("foo", true));
+  }
+  {
+    raw_string_ostream OS(TwoBuf);
+    remarks::BitstreamSerializer S(OS);
+    S.emit(makeRemark("foo", true));
+    S.emit(makeRemark("foo", true));
+  }
+  // The second remark only references strings defined by the first one.
+  EXPECT_LT(TwoBuf.size() - OneBuf.size(), OneBuf.size() / 2);
+}
+
+TEST(BitstreamRemarks, BadMagic) {
+  Expected<std::unique_ptr<remarks::Parser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, "BAD!");
+  ASSERT_TRUE(static_cast<bool>(MaybeParser));
+  Expected<std::unique_ptr<remarks::Remark>> Remark = (*MaybeParser)->next();
+  ASSERT_FALSE(static_cast<bool>(Remark));
+  EXPECT_EQ(toString(Remark.takeError()),
+            "Malformed bitstream remark: unknown magic number.");
+}
@@ -15,6 +15,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -71,6 +72,100 @@ TEST(CompressionTest, ZlibCRC32) {
       zlib::crc32(StringRef("The quick brown fox jumps over the lazy dog")));
 }
 
+TEST(CompressionTest, ZlibRawShards) {
+  std::string Input;
+  for (int I = 0; I < 1000; ++I)
+    Input += "shard " + std::to_string(I % 37) + "; ";
+  StringRef Pieces[] = {StringRef(Input).take_front(1000),
+                        StringRef(Input).drop_front(1000)};
+
+  // Concatenated shards, wrapped in a zlib header and trailer, form a
+  // stream that uncompress() accepts.
+  SmallString<32> Compressed("\x78\x01");
+  uint32_t Adler = 1;
+  for (StringRef Piece : Pieces) {
+    SmallString<32> Shard;
+    EXPECT_THAT_ERROR(zlib::compressRaw(Piece, Shard, Piece == Pieces[1]),
+                      Succeeded());
+    Compressed += Shard;
+    Adler = zlib::adler32Combine(Adler, zlib::adler32(Piece), Piece.size());
+  }
+  EXPECT_EQ(zlib::adler32(Input), Adler);
+  for (int Shift : {24, 16, 8, 0})
+    Compressed.push_back(char(Adler >> Shift));
+
+  SmallString<32> Uncompressed;
+  EXPECT_THAT_ERROR(zlib::uncompress(Compressed, Uncompressed, Input.size()),
+                    Succeeded());
+  EXPECT_EQ(Input, Uncompressed);
+}
+
 #endif
 
+void TestZstdCompression(StringRef Input, int Level) {
+  SmallString<32> Compressed;
+  SmallString<32> Uncompressed;
+
+  EXPECT_THAT_ERROR(zstd::compress(Input, Compressed, Level), Succeeded());
+
+  // Check that uncompressed buffer is the same as original.
+  EXPECT_THAT_ERROR(zstd::uncompress(Compressed, Uncompressed, Input.size()),
+                    Succeeded());
+  EXPECT_EQ(Input, Uncompressed);
+
+  if (Input.size() > 0) {
+    // Uncompression fails if expected length is too short.
+    EXPECT_THAT_ERROR(
+        zstd::uncompress(Compressed, Uncompressed, Input.size() - 1),
+        Failed());
+  }
+}
+
+TEST(CompressionTest, Zstd) {
+  if (!zstd::isAvailable())
+    return;
+
+  TestZstdCompression("", zstd::DefaultCompression);
+
+  TestZstdCompression("hello, world!", zstd::BestSizeCompression);
+  TestZstdCompression("hello, world!", zstd::BestSpeedCompression);
+  TestZstdCompression("hello, world!", zstd::DefaultCompression);
+
+  const size_t kSize = 1024;
+  char BinaryData[kSize];
+  for (size_t i = 0; i < kSize; ++i) {
+    BinaryData[i] = i & 255;
+  }
+  StringRef BinaryDataStr(BinaryData, kSize);
+
+  TestZstdCompression(BinaryDataStr, zstd::BestSizeCompression);
+  TestZstdCompression(BinaryDataStr, zstd::BestSpeedCompression);
+  TestZstdCompression(BinaryDataStr, zstd::DefaultCompression);
+
+  // Large enough to be compressed by several threads.
+  std::string Large;
+  for (int I = 0; Large.size() < (5 << 20); ++I)
+    Large += "line " + std::to_string(I) + "\n";
+  TestZstdCompression(Large, zstd::DefaultCompression);
+}
+
+TEST(CompressionTest, Formats) {
+  for (compression::Format F :
+       {compression::Format::Zlib, compression::Format::Zstd}) {
+    if (!compression::isAvailable(F)) {
+      SmallString<32> Compressed;
+      EXPECT_THAT_ERROR(compression::compress(F, "hello", Compressed),
+                        Failed());
+      continue;
+    }
+    SmallString<32> Compressed;
+    SmallString<32> Uncompressed;
+    EXPECT_THAT_ERROR(compression::compress(F, "hello, world!", Compressed),
+                      Succeeded());
+    EXPECT_THAT_ERROR(compression::uncompress(F, Compressed, Uncompressed, 13),
+                      Succeeded());
+    EXPECT_EQ("hello, world!", Uncompressed);
+  }
+}
+
 }
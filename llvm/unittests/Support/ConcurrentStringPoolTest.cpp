@@ -0,0 +1,94 @@
+//===- llvm/unittest/Support/ConcurrentStringPoolTest.cpp -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/ConcurrentStringPool.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentStringPoolTest, Intern) {
+  ConcurrentStringPool Pool;
+  EXPECT_TRUE(Pool.empty());
+
+  std::string A = "a";
+  StringRef A1 = Pool.intern(A);
+  StringRef A2 = Pool.intern("a");
+  StringRef B = Pool.intern(Twine("b"));
+  EXPECT_EQ("a", A1);
+  EXPECT_EQ(A1.data(), A2.data());
+  EXPECT_NE(A.data(), A1.data());
+  EXPECT_NE(A1.data(), B.data());
+  EXPECT_EQ('\0', *A1.end());
+  EXPECT_EQ(2u, Pool.size());
+
+  StringRef Empty = Pool.intern("");
+  EXPECT_TRUE(Empty.empty());
+  EXPECT_NE(nullptr, Empty.data());
+  EXPECT_EQ(Empty.data(), Pool.intern(StringRef()).data());
+  EXPECT_EQ(3u, Pool.size());
+}
+
+TEST(ConcurrentStringPoolTest, Lookup) {
+  ConcurrentStringPool Pool;
+  EXPECT_EQ(nullptr, Pool.lookup("a").data());
+  StringRef A = Pool.intern("a");
+  EXPECT_EQ(A.data(), Pool.lookup("a").data());
+  EXPECT_EQ(nullptr, Pool.lookup("b").data());
+}
+
+// Enough strings to make every shard grow its table a few times.
+TEST(ConcurrentStringPoolTest, ManyStrings) {
+  ConcurrentStringPool Pool;
+  std::vector<StringRef> Interned;
+  for (unsigned I = 0; I != 20000; ++I)
+    Interned.push_back(Pool.intern("str" + std::to_string(I)));
+  EXPECT_EQ(20000u, Pool.size());
+  for (unsigned I = 0; I != 20000; ++I) {
+    StringRef S = Pool.intern("str" + std::to_string(I));
+    EXPECT_EQ(Interned[I].data(), S.data());
+    EXPECT_EQ("str" + std::to_string(I), S);
+  }
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(ConcurrentStringPoolTest, Threads) {
+  ConcurrentStringPool Pool;
+  const unsigned NumThreads = 4;
+  const unsigned NumStrings = 4096;
+
+  // All threads intern the same strings, in different orders: Multiplying by
+  // an odd number permutes the indices modulo a power of two.
+  std::vector<std::vector<StringRef>> Results(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      Results[T].resize(NumStrings);
+      for (unsigned I = 0; I != NumStrings; ++I) {
+        unsigned N = (I * (2 * T + 1)) % NumStrings;
+        Results[T][N] = Pool.intern("str" + std::to_string(N));
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  EXPECT_EQ(NumStrings, Pool.size());
+  for (unsigned I = 0; I != NumStrings; ++I) {
+    EXPECT_EQ("str" + std::to_string(I), Results[0][I]);
+    for (unsigned T = 1; T != NumThreads; ++T)
+      EXPECT_EQ(Results[0][I].data(), Results[T][I].data());
+  }
+}
+#endif
+
+} // end anonymous namespace
@@ -14,6 +14,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -49,4 +50,44 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, nested_parallel_for) {
+  // Each task of the outer loop waits for an inner loop, which must not
+  // deadlock the executor even when all of its threads are waiting.
+  std::atomic<uint32_t> count(0);
+  for_each_n(parallel::par, 0, 256, [&](size_t) {
+    for_each_n(parallel::par, 0, 256, [&](size_t) { ++count; });
+  });
+  ASSERT_EQ(count, 256u * 256u);
+}
+
+TEST(Parallel, task_graph) {
+  // A diamond of chains: each of the 64 middle tasks runs after the first
+  // task, and the last task runs after all of them.
+  parallel::TaskGraph graph;
+  std::atomic<uint32_t> order(0);
+  uint32_t first = 0, last = 0;
+  std::array<uint32_t, 64> middle;
+  parallel::TaskGraph::TaskId root = graph.add([&] { first = ++order; });
+  std::vector<parallel::TaskGraph::TaskId> preds;
+  for (uint32_t &m : middle)
+    preds.push_back(graph.add([&] { m = ++order; }, root));
+  graph.add([&] { last = ++order; }, preds);
+  graph.run(parallel::par);
+
+  ASSERT_EQ(first, 1u);
+  ASSERT_EQ(last, 66u);
+  for (uint32_t m : middle)
+    ASSERT_TRUE(m > first && m < last);
+}
+
+TEST(Parallel, task_graph_cancel) {
+  parallel::TaskGraph graph;
+  bool ran = false;
+  parallel::TaskGraph::TaskId id = graph.add([&] { graph.cancel(); });
+  graph.add([&] { ran = true; }, id);
+  graph.run(parallel::par);
+  ASSERT_TRUE(graph.isCancelled());
+  ASSERT_FALSE(ran);
+}
+
 #endif
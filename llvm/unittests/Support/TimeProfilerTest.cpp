@@ -0,0 +1,142 @@
+//===- unittests/TimeProfilerTest.cpp - Time profiler tests ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/JSON.h"
+#include "gtest/gtest.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace llvm;
+
+namespace {
+
+// Collect the names and thread ids of the "Total ..." events.
+void collectTotals(StringRef Trace, std::set<std::string> &Names,
+                   std::set<int64_t> &Tids) {
+  Expected<json::Value> Parsed = json::parse(Trace);
+  ASSERT_TRUE(bool(Parsed));
+  json::Array *Events = Parsed->getAsObject()->getArray("traceEvents");
+  ASSERT_TRUE(Events != nullptr);
+  for (const json::Value &Event : *Events) {
+    const json::Object *Obj = Event.getAsObject();
+    Optional<StringRef> Name = Obj->getString("name");
+    if (Name && Name->startswith("Total "))
+      Names.insert(*Name);
+    if (Optional<int64_t> Tid = Obj->getInteger("tid"))
+      Tids.insert(*Tid);
+  }
+}
+
+TEST(TimeProfiler, SingleThread) {
+  timeTraceProfilerInitialize();
+  ASSERT_TRUE(timeTraceProfilerEnabled());
+  {
+    TimeTraceScope Outer("Outer", StringRef("outer"));
+    TimeTraceScope Inner("Inner", StringRef("inner"));
+  }
+
+  SmallString<0> Trace;
+  raw_svector_ostream OS(Trace);
+  timeTraceProfilerWrite(OS);
+  timeTraceProfilerCleanup();
+  EXPECT_FALSE(timeTraceProfilerEnabled());
+
+  std::set<std::string> Names;
+  std::set<int64_t> Tids;
+  collectTotals(OS.str(), Names, Tids);
+  EXPECT_EQ(1u, Names.count("Total Outer"));
+  EXPECT_EQ(1u, Names.count("Total Inner"));
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(TimeProfiler, WorkerThreads) {
+  timeTraceProfilerInitialize();
+  { TimeTraceScope Main("Main", StringRef("")); }
+
+  auto Work = [] {
+    // Each worker records into its own profiler.
+    EXPECT_FALSE(timeTraceProfilerEnabled());
+    timeTraceProfilerInitialize();
+    { TimeTraceScope Worker("Worker", StringRef("")); }
+    timeTraceProfilerFinishThread();
+    EXPECT_FALSE(timeTraceProfilerEnabled());
+  };
+  std::thread T1(Work), T2(Work);
+  T1.join();
+  T2.join();
+
+  SmallString<0> Trace;
+  raw_svector_ostream OS(Trace);
+  timeTraceProfilerWrite(OS);
+  timeTraceProfilerCleanup();
+
+  std::set<std::string> Names;
+  std::set<int64_t> Tids;
+  collectTotals(OS.str(), Names, Tids);
+  EXPECT_EQ(1u, Names.count("Total Main"));
+  EXPECT_EQ(1u, Names.count("Total Worker"));
+  // The main thread, and one row per total.
+  EXPECT_LE(3u, Tids.size());
+}
+
+TEST(TimeProfiler, AttachedThreads) {
+  // A thread of a pool attaches to each profile in turn, and to nothing
+  // while no profile is recorded.
+  std::mutex Mu;
+  std::condition_variable CV;
+  int Step = 0;
+  auto WaitFor = [&](int S) {
+    std::unique_lock<std::mutex> Lock(Mu);
+    CV.wait(Lock, [&] { return Step == S; });
+  };
+  auto Advance = [&] {
+    std::lock_guard<std::mutex> Lock(Mu);
+    ++Step;
+    CV.notify_all();
+  };
+
+  std::thread Pool([&] {
+    WaitFor(1);
+    timeTraceProfilerAttachThread();
+    EXPECT_TRUE(timeTraceProfilerEnabled());
+    { TimeTraceScope Task("Task"); }
+    Advance();
+
+    WaitFor(3);
+    timeTraceProfilerAttachThread();
+    EXPECT_FALSE(timeTraceProfilerEnabled());
+    Advance();
+  });
+
+  timeTraceProfilerInitialize("test");
+  Advance();
+  WaitFor(2);
+
+  SmallString<0> Trace;
+  raw_svector_ostream OS(Trace);
+  timeTraceProfilerWrite(OS);
+  timeTraceProfilerCleanup();
+  Advance();
+  WaitFor(4);
+  Pool.join();
+
+  std::set<std::string> Names;
+  std::set<int64_t> Tids;
+  collectTotals(OS.str(), Names, Tids);
+  EXPECT_EQ(1u, Names.count("Total Task"));
+  EXPECT_NE(std::string::npos, OS.str().find("\"name\":\"test\""));
+}
+#endif
+
+} // end anonymous namespace
@@ -1487,6 +1487,46 @@ TEST_F(VFSFromYAMLTest, CaseSensitive) {
   EXPECT_EQ(0, NumDiagnostics);
 }
 
+TEST_F(VFSFromYAMLTest, ManyEntriesInDirectory) {
+  IntrusiveRefCntPtr<DummyFileSystem> Lower(new DummyFileSystem());
+  Lower->addRegularFile("//root/a");
+  Lower->addRegularFile("//root/b");
+
+  std::string YAML = "{ 'case-sensitive': 'true',\n"
+                     "  'roots': [ { 'type': 'directory', 'name': '//root/',\n"
+                     "               'contents': [\n";
+  for (int I = 0; I < 1000; ++I)
+    YAML += "{ 'type': 'file', 'name': 'file" + std::to_string(I) +
+            "', 'external-contents': '//root/a' },\n";
+  // Names which only differ by case.
+  YAML += "{ 'type': 'file', 'name': 'Same', 'external-contents': '//root/a' },"
+          "{ 'type': 'file', 'name': 'same', 'external-contents': '//root/b' }"
+          "] } ] }";
+  IntrusiveRefCntPtr<vfs::FileSystem> FS = getFromYAMLString(YAML, Lower);
+  ASSERT_TRUE(FS.get() != nullptr);
+
+  ErrorOr<vfs::Status> S = FS->status("//root/file0");
+  ASSERT_FALSE(S.getError());
+  EXPECT_EQ("//root/a", S->getName());
+  S = FS->status("//root/file999");
+  ASSERT_FALSE(S.getError());
+  EXPECT_EQ("//root/a", S->getName());
+  EXPECT_EQ(FS->status("//root/file1000").getError(),
+            llvm::errc::no_such_file_or_directory);
+  EXPECT_EQ(FS->status("//root/FILE1").getError(),
+            llvm::errc::no_such_file_or_directory);
+  EXPECT_EQ(FS->status("//root/file1/x").getError(),
+            llvm::errc::not_a_directory);
+
+  S = FS->status("//root/Same");
+  ASSERT_FALSE(S.getError());
+  EXPECT_EQ("//root/a", S->getName());
+  S = FS->status("//root/same");
+  ASSERT_FALSE(S.getError());
+  EXPECT_EQ("//root/b", S->getName());
+  EXPECT_EQ(0, NumDiagnostics);
+}
+
 TEST_F(VFSFromYAMLTest, IllegalVFSFile) {
   IntrusiveRefCntPtr<DummyFileSystem> Lower(new DummyFileSystem());
 
@@ -0,0 +1,152 @@
+//===- llvm/unittest/XRay/TraceStreamTest.cpp -------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Test that streaming an XRay FDR Mode trace yields the same records as
+// loading it.
+//
+//===----------------------------------------------------------------------===//
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/XRay/FDRLogBuilder.h"
+#include "llvm/XRay/FDRRecords.h"
+#include "llvm/XRay/FDRTraceWriter.h"
+#include "llvm/XRay/Trace.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace xray {
+
+// Must be found through argument-dependent lookup by the matchers.
+static bool operator==(const XRayRecord &L, const XRayRecord &R) {
+  return L.RecordType == R.RecordType && L.CPU == R.CPU && L.Type == R.Type &&
+         L.FuncId == R.FuncId && L.TSC == R.TSC && L.TId == R.TId &&
+         L.PId == R.PId && L.CallArgs == R.CallArgs && L.Data == R.Data;
+}
+
+namespace {
+
+using testing::ElementsAreArray;
+using testing::SizeIs;
+
+// Writes a version 3 log with two buffers for thread 1, and one for thread 2
+// in between.
+std::string writeLog(XRayFileHeader &H) {
+  std::string Data;
+  raw_string_ostream OS(Data);
+  H.Version = 3;
+  H.Type = 1;
+  H.ConstantTSC = true;
+  H.NonstopTSC = true;
+  H.CycleFrequency = 3e9;
+  FDRTraceWriter Writer(OS, H);
+  auto L = LogBuilder()
+               .add<BufferExtents>(80)
+               .add<NewBufferRecord>(1)
+               .add<WallclockRecord>(1, 1)
+               .add<PIDRecord>(1)
+               .add<NewCPUIDRecord>(1, 2)
+               .add<FunctionRecord>(RecordTypes::ENTER, 1, 1)
+               .add<FunctionRecord>(RecordTypes::EXIT, 1, 100)
+               .add<BufferExtents>(80)
+               .add<NewBufferRecord>(2)
+               .add<WallclockRecord>(1, 2)
+               .add<PIDRecord>(1)
+               .add<NewCPUIDRecord>(2, 50)
+               .add<FunctionRecord>(RecordTypes::ENTER, 2, 1)
+               .add<FunctionRecord>(RecordTypes::EXIT, 2, 100)
+               .add<BufferExtents>(80)
+               .add<NewBufferRecord>(1)
+               .add<WallclockRecord>(2, 3)
+               .add<PIDRecord>(1)
+               .add<NewCPUIDRecord>(1, 300)
+               .add<FunctionRecord>(RecordTypes::ENTER, 3, 1)
+               .add<FunctionRecord>(RecordTypes::EXIT, 3, 100)
+               .consume();
+  for (auto &P : L)
+    EXPECT_FALSE(errorToBool(P->apply(Writer)));
+  OS.flush();
+  return Data;
+}
+
+TEST(TraceStreamTest, SameRecordsAsLoadTrace) {
+  XRayFileHeader H;
+  std::string Data = writeLog(H);
+  DataExtractor DE(Data, sys::IsLittleEndianHost, 8);
+  auto TraceOrErr = loadTrace(DE);
+  if (!TraceOrErr)
+    FAIL() << TraceOrErr.takeError();
+  std::vector<XRayRecord> Loaded(TraceOrErr->begin(), TraceOrErr->end());
+  ASSERT_THAT(Loaded, SizeIs(6u));
+
+  XRayFileHeader StreamedHeader;
+  std::vector<XRayRecord> Streamed;
+  auto E = streamTrace(DE, StreamedHeader,
+                       [&](unsigned Worker, const XRayRecord &R) {
+                         EXPECT_EQ(Worker, 0u);
+                         Streamed.push_back(R);
+                         return Error::success();
+                       });
+  if (E)
+    FAIL() << std::move(E);
+  EXPECT_EQ(StreamedHeader.Version, H.Version);
+  EXPECT_THAT(Streamed, ElementsAreArray(Loaded));
+}
+
+TEST(TraceStreamTest, ThreadsStayOnOneWorker) {
+  XRayFileHeader H;
+  std::string Data = writeLog(H);
+  DataExtractor DE(Data, sys::IsLittleEndianHost, 8);
+  auto TraceOrErr = loadTrace(DE);
+  if (!TraceOrErr)
+    FAIL() << TraceOrErr.takeError();
+
+  std::mutex M;
+  std::vector<XRayRecord> PerWorker[2];
+  auto E = streamTrace(DE, H,
+                       [&](unsigned Worker, const XRayRecord &R) {
+                         std::lock_guard<std::mutex> Lock(M);
+                         EXPECT_LT(Worker, 2u);
+                         PerWorker[Worker].push_back(R);
+                         return Error::success();
+                       },
+                       2);
+  if (E)
+    FAIL() << std::move(E);
+
+  // Each worker sees the records of its threads in the loaded order.
+  for (const auto &Records : PerWorker) {
+    std::vector<XRayRecord> Expected;
+    for (const auto &R : *TraceOrErr)
+      if (llvm::any_of(Records, [&](const XRayRecord &S) {
+            return S.TId == R.TId;
+          }))
+        Expected.push_back(R);
+    EXPECT_THAT(Records, ElementsAreArray(Expected));
+  }
+  EXPECT_EQ(PerWorker[0].size() + PerWorker[1].size(), 6u);
+}
+
+TEST(TraceStreamTest, CallbackErrorStopsStreaming) {
+  XRayFileHeader H;
+  std::string Data = writeLog(H);
+  DataExtractor DE(Data, sys::IsLittleEndianHost, 8);
+  unsigned Calls = 0;
+  auto E = streamTrace(DE, H, [&](unsigned, const XRayRecord &) {
+    ++Calls;
+    return createStringError(std::make_error_code(std::errc::invalid_argument),
+                             "stop");
+  });
+  EXPECT_TRUE(errorToBool(std::move(E)));
+  EXPECT_EQ(Calls, 1u);
+}
+
+} // namespace
+} // namespace xray
+} // namespace llvm
@@ -23,6 +23,7 @@
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
 #include <algorithm>
@@ -4571,16 +4572,31 @@ void CodeGenDAGPatterns::GenerateVariants() {
       DepsAndVariants;
   std::map<unsigned, DepsAndVariants> PatternsWithVariants;
 
-  // Collect patterns with more than one variant.
-  for (unsigned i = 0; i != NumOriginalPatterns; ++i) {
-    MultipleUseVarSet DepVars;
-    std::vector<TreePatternNodePtr> Variants;
+  // Generating the variants of a pattern only reads the other patterns, so
+  // generate them concurrently, unless the debug output must stay in order.
+  std::vector<DepsAndVariants> AllVariants(NumOriginalPatterns);
+  auto GenerateAllVariantsOf = [&](unsigned i) {
+    MultipleUseVarSet &DepVars = AllVariants[i].first;
     FindDepVars(PatternsToMatch[i].getSrcPattern(), DepVars);
     LLVM_DEBUG(errs() << "Dependent/multiply used variables: ");
     LLVM_DEBUG(DumpDepVars(DepVars));
     LLVM_DEBUG(errs() << "\n");
-    GenerateVariantsOf(PatternsToMatch[i].getSrcPatternShared(), Variants,
-                       *this, DepVars);
+    GenerateVariantsOf(PatternsToMatch[i].getSrcPatternShared(),
+                       AllVariants[i].second, *this, DepVars);
+  };
+  bool Serial = false;
+  LLVM_DEBUG(Serial = true);
+  if (Serial)
+    for (unsigned i = 0; i != NumOriginalPatterns; ++i)
+      GenerateAllVariantsOf(i);
+  else
+    parallel::for_each_n(parallel::par, 0u, NumOriginalPatterns,
+                         GenerateAllVariantsOf);
+
+  // Collect patterns with more than one variant.
+  for (unsigned i = 0; i != NumOriginalPatterns; ++i) {
+    const MultipleUseVarSet &DepVars = AllVariants[i].first;
+    const std::vector<TreePatternNodePtr> &Variants = AllVariants[i].second;
 
     assert(!Variants.empty() && "Must create at least original variant!");
     if (Variants.size() == 1) // No additional variants for this pattern.
@@ -4589,7 +4605,7 @@ void CodeGenDAGPatterns::GenerateVariants() {
     LLVM_DEBUG(errs() << "FOUND VARIANTS OF: ";
                PatternsToMatch[i].getSrcPattern()->dump(); errs() << "\n");
 
-    PatternsWithVariants[i] = std::make_pair(DepVars, Variants);
+    PatternsWithVariants[i] = std::move(AllVariants[i]);
 
     // Cache matching predicates.
     if (MatchedPatterns[i])
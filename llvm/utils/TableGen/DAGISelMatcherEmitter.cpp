@@ -20,6 +20,7 @@
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
@@ -68,6 +69,23 @@ class MatcherTableEmitter {
   std::vector<std::string> VecIncludeStrings;
   MapVector<std::string, unsigned, StringMap<unsigned> > VecPatterns;
 
+  // The printed source and destination pattern of each pattern to match,
+  // indexed like CGP.ptms(). Printing patterns is slow, and the emitter prints
+  // a scope again whenever its size changes, so they are printed up front, on
+  // multiple threads.
+  struct PrintedPattern {
+    std::string Src;
+    std::string Dst;
+    int Complexity;
+  };
+  std::vector<PrintedPattern> PrintedPatterns;
+
+  void printPatterns();
+
+  const PrintedPattern &getPrintedPattern(const PatternToMatch &P) const {
+    return PrintedPatterns[&P - &*CGP.ptm_begin()];
+  }
+
   unsigned getPatternIdxFromTable(std::string &&P, std::string &&include_loc) {
     const auto It = VecPatterns.find(P);
     if (It == VecPatterns.end()) {
@@ -80,7 +98,10 @@ class MatcherTableEmitter {
 
 public:
   MatcherTableEmitter(const CodeGenDAGPatterns &cgp)
-    : CGP(cgp) {}
+    : CGP(cgp) {
+    if (!OmitComments || InstrumentCoverage)
+      printPatterns();
+  }
 
   unsigned EmitMatcherList(const Matcher *N, unsigned Indent,
                            unsigned StartIdx, raw_ostream &OS);
@@ -165,6 +186,18 @@ static std::string GetPatFromTreePatternNode(const TreePatternNode *N) {
   return str;
 }
 
+void MatcherTableEmitter::printPatterns() {
+  PrintedPatterns.resize(CGP.ptm_end() - CGP.ptm_begin());
+  parallel::for_each_n(parallel::par, size_t(0), PrintedPatterns.size(),
+                       [&](size_t I) {
+                         const PatternToMatch &P = CGP.ptm_begin()[I];
+                         PrintedPattern &PP = PrintedPatterns[I];
+                         PP.Src = GetPatFromTreePatternNode(P.getSrcPattern());
+                         PP.Dst = GetPatFromTreePatternNode(P.getDstPattern());
+                         PP.Complexity = P.getPatternComplexity(CGP);
+                       });
+}
+
 static unsigned GetVBRSize(unsigned Val) {
   if (Val <= 127) return 1;
 
@@ -693,14 +726,11 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
       if (const MorphNodeToMatcher *SNT = dyn_cast<MorphNodeToMatcher>(N)) {
         NumCoveredBytes = 3;
         OS << "OPC_Coverage, ";
-        std::string src =
-            GetPatFromTreePatternNode(SNT->getPattern().getSrcPattern());
-        std::string dst =
-            GetPatFromTreePatternNode(SNT->getPattern().getDstPattern());
+        const PrintedPattern &PP = getPrintedPattern(SNT->getPattern());
         Record *PatRecord = SNT->getPattern().getSrcRecord();
         std::string include_src = getIncludePath(PatRecord);
-        unsigned Offset =
-            getPatternIdxFromTable(src + " -> " + dst, std::move(include_src));
+        unsigned Offset = getPatternIdxFromTable(PP.Src + " -> " + PP.Dst,
+                                                 std::move(include_src));
         OS << "TARGET_VAL(" << Offset << "),\n";
         OS.indent(FullIndexWidth + Indent * 2);
       }
@@ -752,11 +782,11 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
       OS << '\n';
 
       if (const MorphNodeToMatcher *SNT = dyn_cast<MorphNodeToMatcher>(N)) {
+        const PrintedPattern &PP = getPrintedPattern(SNT->getPattern());
         OS.indent(FullIndexWidth + Indent*2) << "// Src: "
-          << *SNT->getPattern().getSrcPattern() << " - Complexity = "
-          << SNT->getPattern().getPatternComplexity(CGP) << '\n';
+          << PP.Src << " - Complexity = " << PP.Complexity << '\n';
         OS.indent(FullIndexWidth + Indent*2) << "// Dst: "
-          << *SNT->getPattern().getDstPattern() << '\n';
+          << PP.Dst << '\n';
       }
     } else
       OS << '\n';
@@ -770,14 +800,11 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
     if (InstrumentCoverage) {
       NumCoveredBytes = 3;
       OS << "OPC_Coverage, ";
-      std::string src =
-          GetPatFromTreePatternNode(CM->getPattern().getSrcPattern());
-      std::string dst =
-          GetPatFromTreePatternNode(CM->getPattern().getDstPattern());
+      const PrintedPattern &PP = getPrintedPattern(CM->getPattern());
       Record *PatRecord = CM->getPattern().getSrcRecord();
       std::string include_src = getIncludePath(PatRecord);
-      unsigned Offset =
-          getPatternIdxFromTable(src + " -> " + dst, std::move(include_src));
+      unsigned Offset = getPatternIdxFromTable(PP.Src + " -> " + PP.Dst,
+                                               std::move(include_src));
       OS << "TARGET_VAL(" << Offset << "),\n";
       OS.indent(FullIndexWidth + Indent * 2);
     }
@@ -787,11 +814,11 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
       NumResultBytes += EmitVBRValue(CM->getResult(i), OS);
     OS << '\n';
     if (!OmitComments) {
+      const PrintedPattern &PP = getPrintedPattern(CM->getPattern());
       OS.indent(FullIndexWidth + Indent*2) << " // Src: "
-        << *CM->getPattern().getSrcPattern() << " - Complexity = "
-        << CM->getPattern().getPatternComplexity(CGP) << '\n';
+        << PP.Src << " - Complexity = " << PP.Complexity << '\n';
       OS.indent(FullIndexWidth + Indent*2) << " // Dst: "
-        << *CM->getPattern().getDstPattern();
+        << PP.Dst;
     }
     OS << '\n';
     return 2 + NumResultBytes + NumCoveredBytes;
@@ -14,6 +14,7 @@
 #include "CodeGenDAGPatterns.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 using namespace llvm;
 
@@ -184,6 +185,23 @@ static Matcher *FindNodeWithKind(Matcher *M, Matcher::KindTy Kind) {
 ///       ABC
 ///       XYZ
 ///
+static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr);
+
+/// FactorNodes - Factor the given matchers, which are independent of each
+/// other, concurrently. This is where most of the time of optimizing large
+/// matcher tables goes, and the result does not depend on the order.
+static void FactorNodes(ArrayRef<std::unique_ptr<Matcher> *> Matchers) {
+  // Keep the debug output in order.
+  bool Serial = Matchers.size() < 2;
+  LLVM_DEBUG(Serial = true);
+  auto Factor = [](std::unique_ptr<Matcher> *M) { FactorNodes(*M); };
+  if (Serial)
+    std::for_each(Matchers.begin(), Matchers.end(), Factor);
+  else
+    parallel::for_each(parallel::par, Matchers.begin(), Matchers.end(),
+                       Factor);
+}
+
 static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
   // Look for a push node. Iterates instead of recurses to reduce stack usage.
   ScopeMatcher *Scope = nullptr;
@@ -203,12 +221,18 @@ static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
   // Okay, pull together the children of the scope node into a vector so we can
   // inspect it more easily.
   SmallVector<Matcher*, 32> OptionsToMatch;
-  
+
+  // Factor the subexpressions.
+  std::vector<std::unique_ptr<Matcher>> Children;
+  SmallVector<std::unique_ptr<Matcher> *, 32> ChildPtrs;
+  Children.reserve(Scope->getNumChildren());
   for (unsigned i = 0, e = Scope->getNumChildren(); i != e; ++i) {
-    // Factor the subexpression.
-    std::unique_ptr<Matcher> Child(Scope->takeChild(i));
-    FactorNodes(Child);
-    
+    Children.emplace_back(Scope->takeChild(i));
+    ChildPtrs.push_back(&Children.back());
+  }
+  FactorNodes(ChildPtrs);
+
+  for (std::unique_ptr<Matcher> &Child : Children) {
     if (Child) {
       // If the child is a ScopeMatcher we can just merge its contents.
       if (auto *SM = dyn_cast<ScopeMatcher>(Child.get())) {
@@ -221,6 +245,9 @@ static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
   }
   
   SmallVector<Matcher*, 32> NewOptionsToMatch;
+
+  // The scopes created for shared matchers, which are factored below.
+  SmallVector<std::unique_ptr<Matcher> *, 8> SharedScopes;
   
   // Loop over options to match, merging neighboring patterns with identical
   // starting nodes into a shared matcher.
@@ -325,12 +352,13 @@ static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
     }
     
     Shared->setNext(new ScopeMatcher(EqualMatchers));
+    SharedScopes.push_back(&Shared->getNextPtr());
 
-    // Recursively factor the newly created node.
-    FactorNodes(Shared->getNextPtr());
-    
     NewOptionsToMatch.push_back(Shared);
   }
+
+  // Recursively factor the newly created nodes.
+  FactorNodes(SharedScopes);
   
   // If we're down to a single pattern to match, then we don't need this scope
   // anymore.
@@ -436,14 +464,22 @@ static void FactorNodes(std::unique_ptr<Matcher> &InputMatcherPtr) {
     }
     
     // Make sure we recursively factor any scopes we may have created.
-    for (auto &M : Cases) {
-      if (ScopeMatcher *SM = dyn_cast<ScopeMatcher>(M.second)) {
-        std::unique_ptr<Matcher> Scope(SM);
-        FactorNodes(Scope);
-        M.second = Scope.release();
-        assert(M.second && "null matcher");
+    std::vector<std::unique_ptr<Matcher>> Scopes;
+    SmallVector<std::unique_ptr<Matcher> *, 8> ScopePtrs;
+    SmallVector<unsigned, 8> ScopeCases;
+    Scopes.reserve(Cases.size());
+    for (unsigned i = 0, e = Cases.size(); i != e; ++i) {
+      if (ScopeMatcher *SM = dyn_cast<ScopeMatcher>(Cases[i].second)) {
+        Scopes.emplace_back(SM);
+        ScopePtrs.push_back(&Scopes.back());
+        ScopeCases.push_back(i);
       }
     }
+    FactorNodes(ScopePtrs);
+    for (unsigned i = 0, e = ScopeCases.size(); i != e; ++i) {
+      Cases[ScopeCases[i]].second = Scopes[i].release();
+      assert(Cases[ScopeCases[i]].second && "null matcher");
+    }
 
     if (Cases.size() != 1) {
       MatcherPtr.reset(new SwitchTypeMatcher(Cases));
@@ -260,7 +260,7 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &LLVMTableGenMain);
+  return TableGenMain(argv[0], &LLVMTableGenMain, makeArrayRef(argv, argc));
 }
 
 #ifdef __has_feature
@@ -944,6 +944,8 @@ typedef struct kmp_allocator_t {
   kmp_allocator_t *fb_data;
   kmp_uint64 pool_size;
   kmp_uint64 pool_used;
+  omp_alloctrait_value_t partition;
+  int numa_partition; // partition is placed through libnuma
 } kmp_allocator_t;
 
 extern omp_allocator_handle_t __kmpc_init_allocator(int gtid,
@@ -958,6 +960,8 @@ extern void __kmpc_free(int gtid, void *ptr, omp_allocator_handle_t al);
 
 extern void __kmp_init_memkind();
 extern void __kmp_fini_memkind();
+extern void __kmp_init_numa();
+extern void __kmp_fini_numa();
 
 /* ------------------------------------------------------------------------ */
 
@@ -1082,6 +1086,15 @@ extern kmp_uint64 __kmp_now_nsec();
 
 #define KMP_MAX_ACTIVE_LEVELS_LIMIT INT_MAX
 
+// Default depth of the nested hot teams, covering the outer region and two
+// levels of nested regions below it.
+#define KMP_HOT_TEAMS_DFLT_MAX_LEVEL 3
+
+// Freed teams are pooled by nesting level so that the small inner teams are
+// not reaped to make room for the outer ones; deeper levels share the last
+// pool.
+#define KMP_TEAM_POOL_LEVELS 4
+
 #define KMP_MAX_DEFAULT_DEVICE_LIMIT INT_MAX
 
 #define KMP_MAX_TASK_PRIORITY_LIMIT INT_MAX
@@ -1791,6 +1804,8 @@ typedef enum kmp_bar_pat { /* Barrier communication patterns */
                                2, /* Hypercube-embedded tree with min branching
                                      factor 2^n */
                            bp_hierarchical_bar = 3, /* Machine hierarchy tree */
+                           bp_auto_bar = 4, /* Chosen from the machine topology
+                                               at initialization */
                            bp_last_bar /* Placeholder to mark the end */
 } kmp_bar_pat_e;
 
@@ -2181,10 +2196,9 @@ struct kmp_dephash_entry {
 typedef struct kmp_dephash {
   kmp_dephash_entry_t **buckets;
   size_t size;
-#ifdef KMP_DEBUG
+  size_t generation; /* index of size in the table of sizes, bumped on growth */
   kmp_uint32 nelements;
   kmp_uint32 nconflicts;
-#endif
 } kmp_dephash_t;
 
 typedef struct kmp_task_affinity_info {
@@ -2312,13 +2326,13 @@ typedef struct kmp_base_thread_data {
   kmp_info_p *td_thr; // Pointer back to thread info
   // Used only in __kmp_execute_tasks_template, maybe not avail until task is
   // queued?
-  kmp_bootstrap_lock_t td_deque_lock; // Lock for accessing deque
+  // Lock for accessing deque, except for the owner pushing and popping tasks
+  kmp_bootstrap_lock_t td_deque_lock;
   kmp_taskdata_t *
       *td_deque; // Deque of tasks encountered by td_thr, dynamically allocated
   kmp_int32 td_deque_size; // Size of deck
-  kmp_uint32 td_deque_head; // Head of deque (will wrap)
-  kmp_uint32 td_deque_tail; // Tail of deque (will wrap)
-  kmp_int32 td_deque_ntasks; // Number of tasks in deque
+  std::atomic<kmp_uint32> td_deque_head; // Head of deque (does not wrap)
+  std::atomic<kmp_uint32> td_deque_tail; // Tail of deque (does not wrap)
   // GEH: shouldn't this be volatile since used in while-spin?
   kmp_int32 td_deque_last_stolen; // Thread number of last successful steal
 #ifdef BUILD_TIED_TASK_STACK
@@ -2332,6 +2346,11 @@ typedef struct kmp_base_thread_data {
 
 #define TASK_DEQUE_SIZE(td) ((td).td_deque_size)
 #define TASK_DEQUE_MASK(td) ((td).td_deque_size - 1)
+#define TASK_DEQUE_HEAD(td) KMP_ATOMIC_LD_RLX(&(td).td_deque_head)
+#define TASK_DEQUE_TAIL(td) KMP_ATOMIC_LD_RLX(&(td).td_deque_tail)
+// Number of tasks in deque, negative while a thief holds it
+#define TASK_DEQUE_NTASKS(td)                                                  \
+  ((kmp_int32)(TASK_DEQUE_TAIL(td) - TASK_DEQUE_HEAD(td)))
 
 typedef union KMP_ALIGN_CACHE kmp_thread_data {
   kmp_base_thread_data_t td;
@@ -2445,6 +2464,7 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
   int th_team_bt_set;
 #else
   kmp_uint64 th_team_bt_intervals;
+  kmp_uint64 th_team_gap; /* predicted time until the next fork, 0: unknown */
 #endif
 
 #if KMP_AFFINITY_SUPPORTED
@@ -2494,6 +2514,10 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
   /* while awaiting queuing lock acquire */
 
   volatile void *th_sleep_loc; // this points at a kmp_flag<T>
+#if KMP_USE_FUTEX
+  struct kmp_wake_word *th_wake_word; // futex word of the team to sleep on
+  struct kmp_wake_word *th_sleep_wake; // futex word the thread sleeps on
+#endif
 
   ident_t *th_ident;
   unsigned th_x; // Random number generator data
@@ -2666,6 +2690,10 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
   int t_last_place; // Restore these values to master after par region.
 #endif // KMP_AFFINITY_SUPPORTED
   int t_display_affinity;
+#if !KMP_USE_MONITOR
+  kmp_uint64 t_join_time; // when the master passed the last join barrier
+  kmp_uint64 t_gap_avg; // running average of the time from join to fork
+#endif
   int t_size_changed; // team size was changed?: 0: no, 1: yes, -1: changed via
   // omp_set_num_threads() call
   omp_allocator_handle_t t_def_allocator; /* default allocator */
@@ -2868,6 +2896,7 @@ extern enum sched_type __kmp_sched; /* default runtime scheduling */
 extern enum sched_type __kmp_static; /* default static scheduling method */
 extern enum sched_type __kmp_guided; /* default guided scheduling method */
 extern enum sched_type __kmp_auto; /* default auto scheduling method */
+extern int __kmp_force_monotonic; /* treat nonmonotonic:dynamic as monotonic */
 extern int __kmp_chunk; /* default runtime chunk size */
 
 extern size_t __kmp_stksize; /* stack size per thread         */
@@ -2921,6 +2950,8 @@ extern int __kmp_tp_cached; /* whether threadprivate cache has been created
                                (__kmpc_threadprivate_cached()) */
 extern int __kmp_dflt_blocktime; /* number of milliseconds to wait before
                                     blocking (env setting) */
+extern int __kmp_adaptive_blocktime; /* shorten the spin before a fork from
+                                        the gaps between regions */
 #if KMP_USE_MONITOR
 extern int
     __kmp_monitor_wakeups; /* number of times monitor wakes up per second */
@@ -3024,10 +3055,16 @@ extern int __kmp_omp_cancellation; /* TRUE or FALSE */
 /* write: lock  read: anytime */
 extern kmp_info_t **__kmp_threads; /* Descriptors for the threads */
 /* read/write: lock */
-extern volatile kmp_team_t *__kmp_team_pool;
+extern volatile kmp_team_t *__kmp_team_pool[KMP_TEAM_POOL_LEVELS];
 extern volatile kmp_info_t *__kmp_thread_pool;
 extern kmp_info_t *__kmp_thread_pool_insert_pt;
 
+// Index of the team pool for teams at nesting level 'level' (1 for the teams
+// of the outermost parallel regions).
+static inline int __kmp_team_pool_index(int level) {
+  return level <= 1 ? 0 : KMP_MIN(level, KMP_TEAM_POOL_LEVELS) - 1;
+}
+
 // total num threads reachable from some root thread including all root threads
 extern volatile int __kmp_nth;
 /* total number of threads reachable from some root thread including all root
@@ -3355,11 +3392,25 @@ extern void __kmp_aux_display_affinity(int gtid, const char *format);
 
 extern void __kmp_cleanup_hierarchy();
 extern void __kmp_get_hierarchy(kmp_uint32 nproc, kmp_bstate_t *thr_bar);
+extern void __kmp_select_barrier_patterns();
 
 #if KMP_USE_FUTEX
 
 extern int __kmp_futex_determine_capable(void);
 
+/* Sleeping threads wait on the futex word of their team, each with its own
+   bit of the futex bitset, so that a single thread can be woken up alone and
+   the whole team with one system call at a fork. The low half of the value
+   counts the wakeups of single threads, the high half those of teams. */
+typedef struct KMP_ALIGN_CACHE kmp_wake_word {
+  std::atomic<kmp_uint32> value;
+  std::atomic<kmp_int32> sleepers;
+} kmp_wake_word_t;
+
+extern int __kmp_futex_sleep; /* sleep on futexes, not condition variables */
+extern kmp_wake_word_t *__kmp_wake_word(int master_gtid);
+extern void __kmp_wake_team(int master_gtid);
+
 #endif // KMP_USE_FUTEX
 
 extern void __kmp_gtid_set_specific(int gtid);
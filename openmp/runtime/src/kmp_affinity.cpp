@@ -22,8 +22,14 @@
 
 // Store the real or imagined machine hierarchy here
 static hierarchy_info machine_hierarchy;
+// Whether the threads of a team are bound in the order of the machine
+// hierarchy, so that its subtrees are the cores and packages they run on
+static bool machine_hierarchy_bound = false;
 
-void __kmp_cleanup_hierarchy() { machine_hierarchy.fini(); }
+void __kmp_cleanup_hierarchy() {
+  machine_hierarchy.fini();
+  machine_hierarchy_bound = false;
+}
 
 void __kmp_get_hierarchy(kmp_uint32 nproc, kmp_bstate_t *thr_bar) {
   kmp_uint32 depth;
@@ -44,6 +50,23 @@ void __kmp_get_hierarchy(kmp_uint32 nproc, kmp_bstate_t *thr_bar) {
   thr_bar->skip_per_level = machine_hierarchy.skipPerLevel;
 }
 
+// Resolve the barrier patterns left to the runtime. The hierarchical barrier
+// gathers and releases each core and package before crossing to the next one,
+// which pays off when the team spans several packages, but only if the threads
+// are bound along the hierarchy; otherwise the hyper barrier does as well.
+void __kmp_select_barrier_patterns() {
+  kmp_bar_pat_e pattern =
+      machine_hierarchy_bound ? bp_hierarchical_bar : bp_hyper_bar;
+  for (int i = bs_plain_barrier; i < bs_last_barrier; i++) {
+    if (__kmp_barrier_gather_pattern[i] == bp_auto_bar)
+      __kmp_barrier_gather_pattern[i] = pattern;
+    if (__kmp_barrier_release_pattern[i] == bp_auto_bar)
+      __kmp_barrier_release_pattern[i] = pattern;
+  }
+  KA_TRACE(10, ("__kmp_select_barrier_patterns: auto barriers are %s\n",
+                __kmp_barrier_pattern_name[pattern]));
+}
+
 #if KMP_AFFINITY_SUPPORTED
 
 bool KMPAffinity::picked_api = false;
@@ -4642,6 +4665,13 @@ static void __kmp_aux_affinity_initialize(void) {
   }
 
   KMP_CPU_FREE_ARRAY(osId2Mask, maxIndex + 1);
+  // Compact binding puts consecutive threads on consecutive leaves of the
+  // hierarchy, as long as the places are not spread or rotated.
+  machine_hierarchy_bound =
+      __kmp_affinity_type == affinity_compact && __kmp_affinity_compact == 0 &&
+      __kmp_affinity_offset == 0 &&
+      __kmp_nested_proc_bind.bind_types[0] != proc_bind_spread &&
+      nPackages > 1;
   machine_hierarchy.init(address2os, __kmp_avail_proc);
 }
 #undef KMP_EXIT_AFF_NONE
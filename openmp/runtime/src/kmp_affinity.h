@@ -735,6 +735,24 @@ public:
     for (kmp_uint32 d = 0; d < depth - 1; ++d) { // optimize hierarchy width
       while (numPerLevel[d] > branch ||
              (d == 0 && numPerLevel[d] > maxLeaves)) { // max 4 on level 0!
+        // Split a wide level of the machine into a new level of its own, so
+        // that no subtree straddles two cores or packages. A level with no
+        // fitting divisor is halved into the level above it instead, except
+        // above the leaves, where a wider fan-in is cheaper than straddling.
+        kmp_uint32 limit = d == 0 && maxLeaves < branch ? maxLeaves : branch;
+        kmp_uint32 width = limit;
+        while (width > 1 && numPerLevel[d] % width)
+          --width;
+        if (adr2os && width > 1 && depth < maxLevels) {
+          for (kmp_uint32 i = depth; i > d + 1; --i)
+            numPerLevel[i] = numPerLevel[i - 1];
+          numPerLevel[d + 1] = numPerLevel[d] / width;
+          numPerLevel[d] = width;
+          depth++;
+          break;
+        }
+        if (adr2os && d > 0)
+          break;
         if (numPerLevel[d] & 1)
           numPerLevel[d]++;
         numPerLevel[d] = numPerLevel[d] >> 1;
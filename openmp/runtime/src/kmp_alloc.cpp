@@ -1239,6 +1239,8 @@ static void **mk_hbw_preferred;
 static void **mk_hugetlb;
 static void **mk_hbw_hugetlb;
 static void **mk_hbw_preferred_hugetlb;
+static void **mk_dax_kmem;
+static void **mk_dax_kmem_all;
 
 #if KMP_OS_UNIX && KMP_DYNAMIC_LIB
 static inline void chk_kind(void ***pkind) {
@@ -1279,6 +1281,10 @@ void __kmp_init_memkind() {
       mk_hbw_preferred_hugetlb =
           (void **)dlsym(h_memkind, "MEMKIND_HBW_PREFERRED_HUGETLB");
       chk_kind(&mk_hbw_preferred_hugetlb);
+      mk_dax_kmem = (void **)dlsym(h_memkind, "MEMKIND_DAX_KMEM");
+      chk_kind(&mk_dax_kmem);
+      mk_dax_kmem_all = (void **)dlsym(h_memkind, "MEMKIND_DAX_KMEM_ALL");
+      chk_kind(&mk_dax_kmem_all);
       KE_TRACE(25, ("__kmp_init_memkind: memkind library initialized\n"));
       return; // success
     }
@@ -1296,6 +1302,8 @@ void __kmp_init_memkind() {
   mk_hugetlb = NULL;
   mk_hbw_hugetlb = NULL;
   mk_hbw_preferred_hugetlb = NULL;
+  mk_dax_kmem = NULL;
+  mk_dax_kmem_all = NULL;
 #else
   kmp_mk_lib_name = "";
   h_memkind = NULL;
@@ -1310,6 +1318,8 @@ void __kmp_init_memkind() {
   mk_hugetlb = NULL;
   mk_hbw_hugetlb = NULL;
   mk_hbw_preferred_hugetlb = NULL;
+  mk_dax_kmem = NULL;
+  mk_dax_kmem_all = NULL;
 #endif
 }
 
@@ -1332,9 +1342,102 @@ void __kmp_fini_memkind() {
   mk_hugetlb = NULL;
   mk_hbw_hugetlb = NULL;
   mk_hbw_preferred_hugetlb = NULL;
+  mk_dax_kmem = NULL;
+  mk_dax_kmem_all = NULL;
 #endif
 }
 
+// libnuma places the memory of allocators with a partition trait that memkind
+// cannot honor. It is loaded at run time like memkind, and maps whole pages for
+// every allocation, so it is only used for allocators asking for a partition.
+static void *h_numa;
+// numa_alloc
+static void *(*kmp_numa_alloc)(size_t sz);
+// numa_alloc_local
+static void *(*kmp_numa_alloc_local)(size_t sz);
+// numa_alloc_interleaved
+static void *(*kmp_numa_alloc_interleaved)(size_t sz);
+// numa_tonode_memory
+static void (*kmp_numa_tonode_memory)(void *start, size_t sz, int node);
+// numa_free
+static void (*kmp_numa_free)(void *start, size_t sz);
+// memory nodes the blocked partition is spread over
+static int kmp_numa_nodes;
+
+void __kmp_init_numa() {
+#if KMP_OS_LINUX && KMP_DYNAMIC_LIB
+  h_numa = dlopen("libnuma.so.1", RTLD_LAZY);
+  if (h_numa) {
+    int (*numa_available)(void) =
+        (int (*)(void))dlsym(h_numa, "numa_available");
+    int (*numa_num_configured_nodes)(void) =
+        (int (*)(void))dlsym(h_numa, "numa_num_configured_nodes");
+    kmp_numa_alloc = (void *(*)(size_t))dlsym(h_numa, "numa_alloc");
+    kmp_numa_alloc_local = (void *(*)(size_t))dlsym(h_numa, "numa_alloc_local");
+    kmp_numa_alloc_interleaved =
+        (void *(*)(size_t))dlsym(h_numa, "numa_alloc_interleaved");
+    kmp_numa_tonode_memory =
+        (void (*)(void *, size_t, int))dlsym(h_numa, "numa_tonode_memory");
+    kmp_numa_free = (void (*)(void *, size_t))dlsym(h_numa, "numa_free");
+    if (numa_available && numa_num_configured_nodes && kmp_numa_alloc &&
+        kmp_numa_alloc_local && kmp_numa_alloc_interleaved &&
+        kmp_numa_tonode_memory && kmp_numa_free && numa_available() != -1) {
+      kmp_numa_nodes = numa_num_configured_nodes();
+      KE_TRACE(25, ("__kmp_init_numa: libnuma initialized, %d nodes\n",
+                    kmp_numa_nodes));
+      return; // success
+    }
+    dlclose(h_numa); // failure
+    h_numa = NULL;
+  }
+#endif
+  __kmp_fini_numa();
+}
+
+void __kmp_fini_numa() {
+#if KMP_OS_LINUX && KMP_DYNAMIC_LIB
+  if (h_numa)
+    dlclose(h_numa);
+#endif
+  h_numa = NULL;
+  kmp_numa_alloc = NULL;
+  kmp_numa_alloc_local = NULL;
+  kmp_numa_alloc_interleaved = NULL;
+  kmp_numa_tonode_memory = NULL;
+  kmp_numa_free = NULL;
+  kmp_numa_nodes = 0;
+}
+
+// Bind consecutive page-aligned blocks of the allocation to consecutive nodes,
+// before any of it is touched
+static void *__kmp_numa_alloc_blocked(size_t size) {
+  void *ptr = kmp_numa_alloc(size);
+  if (ptr == NULL || kmp_numa_nodes < 2)
+    return ptr;
+  size_t page = KMP_GET_PAGE_SIZE();
+  size_t block = (size / kmp_numa_nodes + page - 1) & ~(page - 1);
+  char *start = (char *)ptr;
+  for (int node = 0; node < kmp_numa_nodes && size > 0; ++node) {
+    size_t len = block < size ? block : size;
+    kmp_numa_tonode_memory(start, len, node);
+    start += len;
+    size -= len;
+  }
+  return ptr;
+}
+
+static void *__kmp_numa_partition_alloc(kmp_allocator_t *al, size_t size) {
+  switch (al->partition) {
+  case OMP_ATV_NEAREST:
+    return kmp_numa_alloc_local(size);
+  case OMP_ATV_INTERLEAVED:
+    return kmp_numa_alloc_interleaved(size);
+  default:
+    KMP_DEBUG_ASSERT(al->partition == OMP_ATV_BLOCKED);
+    return __kmp_numa_alloc_blocked(size);
+  }
+}
+
 omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
                                              int ntraits,
                                              omp_alloctrait_t traits[]) {
@@ -1369,7 +1472,11 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       al->fb_data = RCAST(kmp_allocator_t *, traits[i].value);
       break;
     case OMP_ATK_PARTITION:
-      al->memkind = RCAST(void **, traits[i].value);
+      al->partition = (omp_alloctrait_value_t)traits[i].value;
+      KMP_DEBUG_ASSERT(al->partition == OMP_ATV_ENVIRONMENT ||
+                       al->partition == OMP_ATV_NEAREST ||
+                       al->partition == OMP_ATV_BLOCKED ||
+                       al->partition == OMP_ATV_INTERLEAVED);
       break;
     default:
       KMP_ASSERT2(0, "Unexpected allocator trait");
@@ -1387,7 +1494,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
   if (__kmp_memkind_available) {
     // Let's use memkind library if available
     if (ms == omp_high_bw_mem_space) {
-      if (al->memkind == (void *)OMP_ATV_INTERLEAVED && mk_hbw_interleave) {
+      if (al->partition == OMP_ATV_INTERLEAVED && mk_hbw_interleave) {
         al->memkind = mk_hbw_interleave;
       } else if (mk_hbw_preferred) {
         // AC: do not try to use MEMKIND_HBW for now, because memkind library
@@ -1401,12 +1508,16 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
         __kmp_free(al);
         return omp_null_allocator;
       }
+    } else if (ms == omp_large_cap_mem_space && mk_dax_kmem_all) {
+      // persistent memory exposed as memory-only nodes, all nodes are used
+      al->memkind = mk_dax_kmem_all;
+    } else if (ms == omp_large_cap_mem_space && mk_dax_kmem) {
+      // only the closest persistent memory node is used
+      al->memkind = mk_dax_kmem;
+    } else if (al->partition == OMP_ATV_INTERLEAVED && mk_interleave) {
+      al->memkind = mk_interleave;
     } else {
-      if (al->memkind == (void *)OMP_ATV_INTERLEAVED && mk_interleave) {
-        al->memkind = mk_interleave;
-      } else {
-        al->memkind = mk_default;
-      }
+      al->memkind = mk_default;
     }
   } else {
     if (ms == omp_high_bw_mem_space) {
@@ -1415,6 +1526,13 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       return omp_null_allocator;
     }
   }
+  // Regular memory with a partition that memkind does not place is allocated
+  // through libnuma, so that it lands on the nodes asked for rather than on
+  // whichever node first touches it
+  if (h_numa && (al->memkind == NULL || al->memkind == mk_default) &&
+      (al->partition == OMP_ATV_NEAREST || al->partition == OMP_ATV_BLOCKED ||
+       al->partition == OMP_ATV_INTERLEAVED))
+    al->numa_partition = 1;
   return (omp_allocator_handle_t)al;
 }
 
@@ -1462,11 +1580,38 @@ void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
   }
   desc.size_a = size + sz_desc + align;
 
-  if (__kmp_memkind_available) {
+  if (allocator > kmp_max_mem_alloc && al->numa_partition) {
+    // custom allocator with a partition placed by libnuma
+    kmp_uint64 used = 0;
+    if (al->pool_size > 0)
+      used = KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, desc.size_a);
+    if (al->pool_size == 0 || used + desc.size_a <= al->pool_size)
+      ptr = __kmp_numa_partition_alloc(al, desc.size_a);
+    if (ptr == NULL) {
+      // pool exhausted or no memory on the nodes, need to go fallback path
+      if (al->pool_size > 0)
+        KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
+      if (al->fb == OMP_ATV_DEFAULT_MEM_FB) {
+        al = (kmp_allocator_t *)omp_default_mem_alloc;
+        if (__kmp_memkind_available)
+          ptr = kmp_mk_alloc(*mk_default, desc.size_a);
+        else
+          ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+      } else if (al->fb == OMP_ATV_ABORT_FB) {
+        KMP_ASSERT(0); // abort fallback requested
+      } else if (al->fb == OMP_ATV_ALLOCATOR_FB) {
+        KMP_ASSERT(al != al->fb_data);
+        al = al->fb_data;
+        return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
+      } // else ptr == NULL;
+    }
+  } else if (__kmp_memkind_available) {
     if (allocator < kmp_max_mem_alloc) {
       // pre-defined allocator
       if (allocator == omp_high_bw_mem_alloc && mk_hbw_preferred) {
         ptr = kmp_mk_alloc(*mk_hbw_preferred, desc.size_a);
+      } else if (allocator == omp_large_cap_mem_alloc && mk_dax_kmem_all) {
+        ptr = kmp_mk_alloc(*mk_dax_kmem_all, desc.size_a);
       } else {
         ptr = kmp_mk_alloc(*mk_default, desc.size_a);
       }
@@ -1599,11 +1744,21 @@ void __kmpc_free(int gtid, void *ptr, const omp_allocator_handle_t allocator) {
   oal = (omp_allocator_handle_t)al; // cast to void* for comparisons
   KMP_DEBUG_ASSERT(al);
 
-  if (__kmp_memkind_available) {
+  if (oal > kmp_max_mem_alloc && al->numa_partition) {
+    if (al->pool_size > 0) { // custom allocator with pool size requested
+      kmp_uint64 used =
+          KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
+      (void)used; // to suppress compiler warning
+      KMP_DEBUG_ASSERT(used >= desc.size_a);
+    }
+    kmp_numa_free(desc.ptr_alloc, desc.size_a);
+  } else if (__kmp_memkind_available) {
     if (oal < kmp_max_mem_alloc) {
       // pre-defined allocator
       if (oal == omp_high_bw_mem_alloc && mk_hbw_preferred) {
         kmp_mk_free(*mk_hbw_preferred, desc.ptr_alloc);
+      } else if (oal == omp_large_cap_mem_alloc && mk_dax_kmem_all) {
+        kmp_mk_free(*mk_dax_kmem_all, desc.ptr_alloc);
       } else {
         kmp_mk_free(*mk_default, desc.ptr_alloc);
       }
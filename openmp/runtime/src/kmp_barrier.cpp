@@ -1761,6 +1761,9 @@ void __kmp_join_barrier(int gtid) {
         team->t.t_implicit_task_taskdata[tid].td_icvs.bt_set;
 #else
     this_thr->th.th_team_bt_intervals = KMP_BLOCKTIME_INTERVAL(team, tid);
+    // The wait in the following fork barrier spins for the expected gap.
+    if (__kmp_adaptive_blocktime)
+      this_thr->th.th_team_gap = team->t.t_gap_avg;
 #endif
   }
 
@@ -1804,6 +1807,10 @@ void __kmp_join_barrier(int gtid) {
     if (__kmp_display_affinity) {
       KMP_CHECK_UPDATE(team->t.t_display_affinity, 0);
     }
+#if !KMP_USE_MONITOR
+    if (__kmp_adaptive_blocktime)
+      team->t.t_join_time = KMP_NOW();
+#endif
 #if KMP_STATS_ENABLED
     // Have master thread flag the workers to indicate they are now waiting for
     // next parallel region, Also wake them up so they switch their timers to
@@ -1955,6 +1962,19 @@ void __kmp_fork_barrier(int gtid, int tid) {
           team->t.t_implicit_task_taskdata[tid].td_icvs.bt_set;
 #else
       this_thr->th.th_team_bt_intervals = KMP_BLOCKTIME_INTERVAL(team, tid);
+      // Learn how long the team waits between regions.
+      if (__kmp_adaptive_blocktime && team->t.t_join_time) {
+        kmp_uint64 gap = KMP_NOW() - team->t.t_join_time;
+        team->t.t_gap_avg =
+            team->t.t_gap_avg ? (7 * team->t.t_gap_avg + gap) / 8 : gap;
+        team->t.t_join_time = 0;
+      }
+#endif
+#if KMP_USE_FUTEX
+      // Wake up the sleeping workers at once; they spin from here until the
+      // release below reaches them.
+      if (__kmp_futex_sleep)
+        __kmp_wake_team(gtid);
 #endif
     }
   } // master
@@ -68,14 +68,19 @@ void __kmp_dispatch_dxo_error(int *gtid_ref, int *cid_ref, ident_t *loc_ref) {
   }
 }
 
-// Returns either SCHEDULE_MONOTONIC or SCHEDULE_NONMONOTONIC
-static inline int __kmp_get_monotonicity(enum sched_type schedule,
-                                         bool use_hier = false) {
+// Returns either SCHEDULE_MONOTONIC or SCHEDULE_NONMONOTONIC. A schedule
+// without modifiers gets the default monotonicity, which is monotonic for the
+// schedules passed by the compiler, as OpenMP 4.5 requires.
+static inline int
+__kmp_get_monotonicity(enum sched_type schedule, bool use_hier = false,
+                       int default_monotonicity = SCHEDULE_MONOTONIC) {
   // Pick up the nonmonotonic/monotonic bits from the scheduling type
   int monotonicity;
-  // default to monotonic
-  monotonicity = SCHEDULE_MONOTONIC;
-  if (SCHEDULE_HAS_NONMONOTONIC(schedule))
+  monotonicity = default_monotonicity;
+  // Hierarchical scheduling does not steal across its layers
+  if (use_hier || __kmp_force_monotonic)
+    monotonicity = SCHEDULE_MONOTONIC;
+  else if (SCHEDULE_HAS_NONMONOTONIC(schedule))
     monotonicity = SCHEDULE_NONMONOTONIC;
   else if (SCHEDULE_HAS_MONOTONIC(schedule))
     monotonicity = SCHEDULE_MONOTONIC;
@@ -175,10 +180,15 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
   } else {
     if (schedule == kmp_sch_runtime) {
       // Use the scheduling specified by OMP_SCHEDULE (or __kmp_sch_default if
-      // not specified)
+      // not specified). The run-sched-var follows OpenMP 5.0, where a dynamic
+      // schedule without modifiers is nonmonotonic.
       schedule = team->t.t_sched.r_sched_type;
-      monotonicity = __kmp_get_monotonicity(schedule, use_hier);
+      monotonicity =
+          __kmp_get_monotonicity(schedule, use_hier, SCHEDULE_NONMONOTONIC);
       schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+      // Ordered overrides nonmonotonic
+      if (pr->flags.ordered)
+        monotonicity = SCHEDULE_MONOTONIC;
       // Detail the schedule if needed (global controls are differentiated
       // appropriately)
       if (schedule == kmp_sch_guided_chunked) {
@@ -244,8 +254,11 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
     if (schedule == kmp_sch_runtime_simd) {
       // compiler provides simd_width in the chunk parameter
       schedule = team->t.t_sched.r_sched_type;
-      monotonicity = __kmp_get_monotonicity(schedule, use_hier);
+      monotonicity =
+          __kmp_get_monotonicity(schedule, use_hier, SCHEDULE_NONMONOTONIC);
       schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+      if (pr->flags.ordered)
+        monotonicity = SCHEDULE_MONOTONIC;
       // Detail the schedule if needed (global controls are differentiated
       // appropriately)
       if (schedule == kmp_sch_static || schedule == kmp_sch_auto ||
@@ -23,7 +23,7 @@
    Before we release this to a customer, please don't change this value.  After
    it is released and stable, then any new updates to the structures or data
    structure traversal algorithms need to change this value. */
-#define KMP_OMP_VERSION 9
+#define KMP_OMP_VERSION 10
 
 typedef struct {
   kmp_int32 offset;
@@ -222,7 +222,6 @@ typedef struct {
   offset_and_size_t hd_deque_size;
   offset_and_size_t hd_deque_head;
   offset_and_size_t hd_deque_tail;
-  offset_and_size_t hd_deque_ntasks;
   offset_and_size_t hd_deque_last_stolen;
 
   // The last field of stable version.
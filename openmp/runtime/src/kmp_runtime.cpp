@@ -526,8 +526,14 @@ static void __kmp_print_team_storage_map(const char *header, kmp_team_t *team,
                                "%s_%d.t_disp_buffer", header, team_id);
 }
 
-static void __kmp_init_allocator() { __kmp_init_memkind(); }
-static void __kmp_fini_allocator() { __kmp_fini_memkind(); }
+static void __kmp_init_allocator() {
+  __kmp_init_memkind();
+  __kmp_init_numa();
+}
+static void __kmp_fini_allocator() {
+  __kmp_fini_numa();
+  __kmp_fini_memkind();
+}
 
 /* ------------------------------------------------------------------------ */
 
@@ -3346,8 +3352,10 @@ void __kmp_print_structure(void) {
                "--------\n");
   __kmp_print_structure_thread("Thread pool:          ",
                                CCAST(kmp_info_t *, __kmp_thread_pool));
-  __kmp_print_structure_team("Team pool:            ",
-                             CCAST(kmp_team_t *, __kmp_team_pool));
+  for (int i = 0; i < KMP_TEAM_POOL_LEVELS; ++i) {
+    __kmp_printf("Team pool %d:          ", i);
+    __kmp_print_structure_team("", CCAST(kmp_team_t *, __kmp_team_pool[i]));
+  }
   __kmp_printf("\n");
 
   // Free team list.
@@ -4003,6 +4011,9 @@ static void __kmp_initialize_info(kmp_info_t *this_thr, kmp_team_t *team,
   this_thr->th.th_team_master = master;
   this_thr->th.th_team_serialized = team->t.t_serialized;
   TCW_PTR(this_thr->th.th_sleep_loc, NULL);
+#if KMP_USE_FUTEX
+  this_thr->th.th_wake_word = __kmp_wake_word(master->th.th_info.ds.ds_gtid);
+#endif
 
   KMP_DEBUG_ASSERT(team->t.t_implicit_task_taskdata);
 
@@ -5170,14 +5181,19 @@ __kmp_allocate_team(kmp_root_t *root, int new_nproc, int max_nproc,
     return team;
   }
 
-  /* next, let's try to take one from the team pool */
+  /* next, let's try to take one from the team pool of this nesting level */
+  int pool = 0;
+#if KMP_NESTED_HOT_TEAMS
+  if (master)
+    pool = __kmp_team_pool_index(master->th.th_team->t.t_level + 1);
+#endif
   KMP_MB();
-  for (team = CCAST(kmp_team_t *, __kmp_team_pool); (team);) {
+  for (team = CCAST(kmp_team_t *, __kmp_team_pool[pool]); (team);) {
     /* TODO: consider resizing undersized teams instead of reaping them, now
        that we have a resizing mechanism */
     if (team->t.t_max_nproc >= max_nproc) {
       /* take this team from the team pool */
-      __kmp_team_pool = team->t.t_next_pool;
+      __kmp_team_pool[pool] = team->t.t_next_pool;
 
       /* setup the team for fresh use */
       __kmp_initialize_team(team, new_nproc, new_icvs, NULL);
@@ -5208,8 +5224,8 @@ __kmp_allocate_team(kmp_root_t *root, int new_nproc, int max_nproc,
 
       team->t.t_proc_bind = new_proc_bind;
 
-      KA_TRACE(20, ("__kmp_allocate_team: using team from pool %d.\n",
-                    team->t.t_id));
+      KA_TRACE(20, ("__kmp_allocate_team: using team %d from pool %d.\n",
+                    team->t.t_id, pool));
 
 #if OMPT_SUPPORT
       __ompt_team_assign_id(team, ompt_parallel_data);
@@ -5225,7 +5241,7 @@ __kmp_allocate_team(kmp_root_t *root, int new_nproc, int max_nproc,
     // rewrite.
     /* TODO: Use technique to find the right size hot-team, don't reap them */
     team = __kmp_reap_team(team);
-    __kmp_team_pool = team;
+    __kmp_team_pool[pool] = team;
   }
 
   /* nothing available in the pool, no matter, make a new team! */
@@ -5382,10 +5398,20 @@ void __kmp_free_team(kmp_root_t *root,
       }
     }
 
+    int pool = 0;
+#if KMP_NESTED_HOT_TEAMS
+    pool = __kmp_team_pool_index(team->t.t_level);
+#endif
     // Reset pointer to parent team only for non-hot teams.
     team->t.t_parent = NULL;
     team->t.t_level = 0;
     team->t.t_active_level = 0;
+#if !KMP_USE_MONITOR
+    // The gaps between the regions of a pooled team say nothing about the
+    // regions it will run next.
+    team->t.t_join_time = 0;
+    team->t.t_gap_avg = 0;
+#endif
 
     /* free the worker threads */
     for (f = 1; f < team->t.t_nproc; ++f) {
@@ -5396,8 +5422,8 @@ void __kmp_free_team(kmp_root_t *root,
 
     /* put the team back in the team pool */
     /* TODO limit size of team pool, call reap_team if pool too large */
-    team->t.t_next_pool = CCAST(kmp_team_t *, __kmp_team_pool);
-    __kmp_team_pool = (volatile kmp_team_t *)team;
+    team->t.t_next_pool = CCAST(kmp_team_t *, __kmp_team_pool[pool]);
+    __kmp_team_pool[pool] = (volatile kmp_team_t *)team;
   } else { // Check if team was created for the masters in a teams construct
     // See if first worker is a CG root
     KMP_DEBUG_ASSERT(team->t.t_threads[1] &&
@@ -5972,13 +5998,15 @@ static void __kmp_internal_end(void) {
     __kmp_thread_pool_insert_pt = NULL;
 
     // Reap teams.
-    while (__kmp_team_pool != NULL) { // Loop thru all the teams in the pool.
-      // Get the next team from the pool.
-      kmp_team_t *team = CCAST(kmp_team_t *, __kmp_team_pool);
-      __kmp_team_pool = team->t.t_next_pool;
-      // Reap it.
-      team->t.t_next_pool = NULL;
-      __kmp_reap_team(team);
+    for (i = 0; i < KMP_TEAM_POOL_LEVELS; ++i) {
+      while (__kmp_team_pool[i] != NULL) { // Loop thru the teams in the pool.
+        // Get the next team from the pool.
+        kmp_team_t *team = CCAST(kmp_team_t *, __kmp_team_pool[i]);
+        __kmp_team_pool[i] = team->t.t_next_pool;
+        // Reap it.
+        team->t.t_next_pool = NULL;
+        __kmp_reap_team(team);
+      }
     }
 
     __kmp_reap_task_teams();
@@ -6613,10 +6641,12 @@ static void __kmp_do_serial_initialize(void) {
   // work even if pools are not freed.
   KMP_DEBUG_ASSERT(__kmp_thread_pool == NULL);
   KMP_DEBUG_ASSERT(__kmp_thread_pool_insert_pt == NULL);
-  KMP_DEBUG_ASSERT(__kmp_team_pool == NULL);
   __kmp_thread_pool = NULL;
   __kmp_thread_pool_insert_pt = NULL;
-  __kmp_team_pool = NULL;
+  for (i = 0; i < KMP_TEAM_POOL_LEVELS; ++i) {
+    KMP_DEBUG_ASSERT(__kmp_team_pool[i] == NULL);
+    __kmp_team_pool[i] = NULL;
+  }
 
   /* Allocate all of the variable sized records */
   /* NOTE: __kmp_threads_capacity entries are allocated, but the arrays are
@@ -6739,6 +6769,9 @@ static void __kmp_do_middle_initialize(void) {
   }
 #endif /* KMP_AFFINITY_SUPPORTED */
 
+  // The machine topology is known now, pick the barriers left to the runtime.
+  __kmp_select_barrier_patterns();
+
   KMP_ASSERT(__kmp_xproc > 0);
   if (__kmp_avail_proc == 0) {
     __kmp_avail_proc = __kmp_xproc;
@@ -700,6 +700,34 @@ static void __kmp_stg_print_blocktime(kmp_str_buf_t *buffer, char const *name,
   __kmp_stg_print_int(buffer, name, __kmp_dflt_blocktime);
 } // __kmp_stg_print_blocktime
 
+// -----------------------------------------------------------------------------
+// KMP_ADAPTIVE_BLOCKTIME
+
+static void __kmp_stg_parse_adaptive_blocktime(char const *name,
+                                               char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_adaptive_blocktime);
+} // __kmp_stg_parse_adaptive_blocktime
+
+static void __kmp_stg_print_adaptive_blocktime(kmp_str_buf_t *buffer,
+                                               char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_adaptive_blocktime);
+} // __kmp_stg_print_adaptive_blocktime
+
+#if KMP_USE_FUTEX
+// -----------------------------------------------------------------------------
+// KMP_FUTEX_SLEEP
+
+static void __kmp_stg_parse_futex_sleep(char const *name, char const *value,
+                                        void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_futex_sleep);
+} // __kmp_stg_parse_futex_sleep
+
+static void __kmp_stg_print_futex_sleep(kmp_str_buf_t *buffer,
+                                        char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_futex_sleep);
+} // __kmp_stg_print_futex_sleep
+#endif // KMP_USE_FUTEX
+
 // -----------------------------------------------------------------------------
 // KMP_DUPLICATE_LIB_OK
 
@@ -1633,6 +1661,10 @@ static void __kmp_stg_parse_barrier_pattern(char const *name, char const *value,
       }
     }
   }
+  // Settings changed after initialization (kmp_set_defaults) resolve "auto"
+  // right away.
+  if (__kmp_init_middle)
+    __kmp_select_barrier_patterns();
 } // __kmp_stg_parse_barrier_pattern
 
 static void __kmp_stg_print_barrier_pattern(kmp_str_buf_t *buffer,
@@ -3313,10 +3345,8 @@ static void __kmp_stg_parse_allocator(char const *name, char const *value,
       __kmp_def_allocator = omp_default_mem_alloc;
       break;
     case 2:
-      __kmp_msg(kmp_ms_warning,
-                KMP_MSG(OmpNoAllocator, "omp_large_cap_mem_alloc"),
-                __kmp_msg_null);
-      __kmp_def_allocator = omp_default_mem_alloc;
+      // persistent memory through memkind if present, else regular memory
+      __kmp_def_allocator = omp_large_cap_mem_alloc;
       break;
     case 3:
       __kmp_msg(kmp_ms_warning, KMP_MSG(OmpNoAllocator, "omp_const_mem_alloc"),
@@ -3360,10 +3390,7 @@ static void __kmp_stg_parse_allocator(char const *name, char const *value,
   } else if (__kmp_match_str("omp_default_mem_alloc", buf, &next)) {
     __kmp_def_allocator = omp_default_mem_alloc;
   } else if (__kmp_match_str("omp_large_cap_mem_alloc", buf, &next)) {
-    __kmp_msg(kmp_ms_warning,
-              KMP_MSG(OmpNoAllocator, "omp_large_cap_mem_alloc"),
-              __kmp_msg_null);
-    __kmp_def_allocator = omp_default_mem_alloc;
+    __kmp_def_allocator = omp_large_cap_mem_alloc;
   } else if (__kmp_match_str("omp_const_mem_alloc", buf, &next)) {
     __kmp_msg(kmp_ms_warning, KMP_MSG(OmpNoAllocator, "omp_const_mem_alloc"),
               __kmp_msg_null);
@@ -4607,6 +4634,19 @@ static void __kmp_stg_print_forkjoin_frames_mode(kmp_str_buf_t *buffer,
 } // __kmp_stg_print_forkjoin_frames
 #endif /* USE_ITT_BUILD */
 
+// -----------------------------------------------------------------------------
+// KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE
+
+static void __kmp_stg_parse_force_monotonic(char const *name,
+                                            char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_force_monotonic);
+} // __kmp_stg_parse_force_monotonic
+
+static void __kmp_stg_print_force_monotonic(kmp_str_buf_t *buffer,
+                                            char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_force_monotonic);
+} // __kmp_stg_print_force_monotonic
+
 // -----------------------------------------------------------------------------
 // KMP_ENABLE_TASK_THROTTLING
 
@@ -4704,6 +4744,12 @@ static kmp_setting_t __kmp_stg_table[] = {
     {"KMP_ALL_THREADS", __kmp_stg_parse_device_thread_limit, NULL, NULL, 0, 0},
     {"KMP_BLOCKTIME", __kmp_stg_parse_blocktime, __kmp_stg_print_blocktime,
      NULL, 0, 0},
+    {"KMP_ADAPTIVE_BLOCKTIME", __kmp_stg_parse_adaptive_blocktime,
+     __kmp_stg_print_adaptive_blocktime, NULL, 0, 0},
+#if KMP_USE_FUTEX
+    {"KMP_FUTEX_SLEEP", __kmp_stg_parse_futex_sleep,
+     __kmp_stg_print_futex_sleep, NULL, 0, 0},
+#endif
     {"KMP_USE_YIELD", __kmp_stg_parse_use_yield, __kmp_stg_print_use_yield,
      NULL, 0, 0},
     {"KMP_DUPLICATE_LIB_OK", __kmp_stg_parse_duplicate_lib_ok,
@@ -4871,6 +4917,8 @@ static kmp_setting_t __kmp_stg_table[] = {
      0, 0},
     {"OMP_SCHEDULE", __kmp_stg_parse_omp_schedule, __kmp_stg_print_omp_schedule,
      NULL, 0, 0},
+    {"KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE", __kmp_stg_parse_force_monotonic,
+     __kmp_stg_print_force_monotonic, NULL, 0, 0},
 #if KMP_USE_HIER_SCHED
     {"KMP_DISP_HAND_THREAD", __kmp_stg_parse_kmp_hand_thread,
      __kmp_stg_print_kmp_hand_thread, NULL, 0, 0},
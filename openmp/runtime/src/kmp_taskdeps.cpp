@@ -54,22 +54,23 @@ static inline kmp_depnode_t *__kmp_node_ref(kmp_depnode_t *node) {
 
 enum { KMP_DEPHASH_OTHER_SIZE = 97, KMP_DEPHASH_MASTER_SIZE = 997 };
 
+// Sizes the dependence hash goes through as it grows, the first two being the
+// initial sizes for explicit and implicit tasks
+static const size_t kmp_dephash_sizes[] = {
+    KMP_DEPHASH_OTHER_SIZE, KMP_DEPHASH_MASTER_SIZE, 2003, 4001, 8191, 16001,
+    32003, 64007, 131071, 270029};
+static const size_t KMP_DEPHASH_MAX_GEN =
+    sizeof(kmp_dephash_sizes) / sizeof(kmp_dephash_sizes[0]) - 1;
+
 static inline kmp_int32 __kmp_dephash_hash(kmp_intptr_t addr, size_t hsize) {
   // TODO alternate to try: set = (((Addr64)(addrUsefulBits * 9.618)) %
   // m_num_sets );
   return ((addr >> 6) ^ (addr >> 2)) % hsize;
 }
 
-static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
-                                           kmp_taskdata_t *current_task) {
+static kmp_dephash_t *__kmp_dephash_alloc(kmp_info_t *thread, size_t gen) {
   kmp_dephash_t *h;
-
-  size_t h_size;
-
-  if (current_task->td_flags.tasktype == TASK_IMPLICIT)
-    h_size = KMP_DEPHASH_MASTER_SIZE;
-  else
-    h_size = KMP_DEPHASH_OTHER_SIZE;
+  size_t h_size = kmp_dephash_sizes[gen];
 
   kmp_int32 size =
       h_size * sizeof(kmp_dephash_entry_t *) + sizeof(kmp_dephash_t);
@@ -80,11 +81,9 @@ static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
   h = (kmp_dephash_t *)__kmp_thread_malloc(thread, size);
 #endif
   h->size = h_size;
-
-#ifdef KMP_DEBUG
+  h->generation = gen;
   h->nelements = 0;
   h->nconflicts = 0;
-#endif
   h->buckets = (kmp_dephash_entry **)(h + 1);
 
   for (size_t i = 0; i < h_size; i++)
@@ -93,11 +92,60 @@ static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
   return h;
 }
 
+static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
+                                           kmp_taskdata_t *current_task) {
+  return __kmp_dephash_alloc(
+      thread, current_task->td_flags.tasktype == TASK_IMPLICIT ? 1 : 0);
+}
+
+// Move the entries of a hash that has filled up into one of the next size.
+// Only the thread running the task that owns the hash ever touches it, so the
+// entries are relinked without locking.
+static kmp_dephash_t *__kmp_dephash_extend(kmp_info_t *thread,
+                                           kmp_dephash_t *current_dephash) {
+  if (current_dephash->generation >= KMP_DEPHASH_MAX_GEN)
+    return current_dephash;
+
+  kmp_dephash_t *h =
+      __kmp_dephash_alloc(thread, current_dephash->generation + 1);
+  for (size_t i = 0; i < current_dephash->size; i++) {
+    kmp_dephash_entry_t *next;
+    for (kmp_dephash_entry_t *entry = current_dephash->buckets[i]; entry;
+         entry = next) {
+      next = entry->next_in_bucket;
+      kmp_int32 bucket = __kmp_dephash_hash(entry->addr, h->size);
+      entry->next_in_bucket = h->buckets[bucket];
+      h->buckets[bucket] = entry;
+      h->nelements++;
+      if (entry->next_in_bucket)
+        h->nconflicts++;
+    }
+  }
+  KA_TRACE(30, ("__kmp_dephash_extend: T#%d grew dependence hash %p to %p "
+                "with %d buckets for %d entries\n",
+                __kmp_gtid_from_thread(thread), current_dephash, h,
+                (int)h->size, h->nelements));
+#if USE_FAST_MEMORY
+  __kmp_fast_free(thread, current_dephash);
+#else
+  __kmp_thread_free(thread, current_dephash);
+#endif
+  return h;
+}
+
 #define ENTRY_LAST_INS 0
 #define ENTRY_LAST_MTXS 1
 
 static kmp_dephash_entry *
-__kmp_dephash_find(kmp_info_t *thread, kmp_dephash_t *h, kmp_intptr_t addr) {
+__kmp_dephash_find(kmp_info_t *thread, kmp_dephash_t **hash,
+                   kmp_intptr_t addr) {
+  kmp_dephash_t *h = *hash;
+  // Grow the hash once there are as many entries as buckets, so that the
+  // chains stay short for tasks that track many addresses
+  if (h->nelements >= h->size) {
+    h = __kmp_dephash_extend(thread, h);
+    *hash = h;
+  }
   kmp_int32 bucket = __kmp_dephash_hash(addr, h->size);
 
   kmp_dephash_entry_t *entry;
@@ -122,11 +170,9 @@ __kmp_dephash_find(kmp_info_t *thread, kmp_dephash_t *h, kmp_intptr_t addr) {
     entry->mtx_lock = NULL;
     entry->next_in_bucket = h->buckets[bucket];
     h->buckets[bucket] = entry;
-#ifdef KMP_DEBUG
     h->nelements++;
     if (entry->next_in_bucket)
       h->nconflicts++;
-#endif
   }
   return entry;
 }
@@ -190,7 +236,10 @@ __kmp_depnode_link_successor(kmp_int32 gtid, kmp_info_t *thread,
     kmp_depnode_t *dep = p->node;
     if (dep->dn.task) {
       KMP_ACQUIRE_DEPNODE(gtid, dep);
-      if (dep->dn.task) {
+      // Only this thread adds successors to dep, so if node has just been
+      // linked, through another dependence on the same task, it is first
+      if (dep->dn.task &&
+          (!dep->dn.successors || dep->dn.successors->node != node)) {
         __kmp_track_dependence(dep, node, task);
         dep->dn.successors = __kmp_add_node(thread, dep->dn.successors, node);
         KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
@@ -216,7 +265,8 @@ static inline kmp_int32 __kmp_depnode_link_successor(kmp_int32 gtid,
   if (sink->dn.task) {
     // synchronously add source to sink' list of successors
     KMP_ACQUIRE_DEPNODE(gtid, sink);
-    if (sink->dn.task) {
+    if (sink->dn.task &&
+        (!sink->dn.successors || sink->dn.successors->node != source)) {
       __kmp_track_dependence(sink, source, task);
       sink->dn.successors = __kmp_add_node(thread, sink->dn.successors, source);
       KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
@@ -232,7 +282,7 @@ static inline kmp_int32 __kmp_depnode_link_successor(kmp_int32 gtid,
 
 template <bool filter>
 static inline kmp_int32
-__kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t *hash,
+__kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t **hash,
                    bool dep_barrier, kmp_int32 ndeps,
                    kmp_depend_info_t *dep_list, kmp_task_t *task) {
   KA_TRACE(30, ("__kmp_process_deps<%d>: T#%d processing %d dependencies : "
@@ -350,9 +400,18 @@ __kmp_process_deps(kmp_int32 gtid, kmp_depnode_t *node, kmp_dephash_t *hash,
 #define NO_DEP_BARRIER (false)
 #define DEP_BARRIER (true)
 
+// Dependence lists longer than this are sorted to find duplicate addresses
+#define KMP_DEPS_SORT_THRESHOLD 16
+
+static int __kmp_dep_cmp(const void *a, const void *b) {
+  kmp_intptr_t aa = ((const kmp_depend_info_t *)a)->base_addr;
+  kmp_intptr_t bb = ((const kmp_depend_info_t *)b)->base_addr;
+  return aa < bb ? -1 : aa > bb;
+}
+
 // returns true if the task has any outstanding dependence
 static bool __kmp_check_deps(kmp_int32 gtid, kmp_depnode_t *node,
-                             kmp_task_t *task, kmp_dephash_t *hash,
+                             kmp_task_t *task, kmp_dephash_t **hash,
                              bool dep_barrier, kmp_int32 ndeps,
                              kmp_depend_info_t *dep_list,
                              kmp_int32 ndeps_noalias,
@@ -366,11 +425,16 @@ static bool __kmp_check_deps(kmp_int32 gtid, kmp_depnode_t *node,
                 "dep_barrier=%d .\n",
                 gtid, taskdata, ndeps, ndeps_noalias, dep_barrier));
 
-  // Filter deps in dep_list
-  // TODO: Different algorithm for large dep_list ( > 10 ? )
+  // Filter deps in dep_list. Long lists, e.g. from depend(iterator(...)), are
+  // sorted first so that duplicates are adjacent instead of searched for.
+  bool sorted = ndeps > KMP_DEPS_SORT_THRESHOLD;
+  if (sorted)
+    qsort(dep_list, ndeps, sizeof(kmp_depend_info_t), __kmp_dep_cmp);
   for (i = 0; i < ndeps; i++) {
     if (dep_list[i].base_addr != 0) {
       for (int j = i + 1; j < ndeps; j++) {
+        if (sorted && dep_list[i].base_addr != dep_list[j].base_addr)
+          break;
         if (dep_list[i].base_addr == dep_list[j].base_addr) {
           dep_list[i].flags.in |= dep_list[j].flags.in;
           dep_list[i].flags.out |=
@@ -552,7 +616,7 @@ kmp_int32 __kmpc_omp_task_with_deps(ident_t *loc_ref, kmp_int32 gtid,
     __kmp_init_node(node);
     new_taskdata->td_depnode = node;
 
-    if (__kmp_check_deps(gtid, node, new_task, current_task->td_dephash,
+    if (__kmp_check_deps(gtid, node, new_task, &current_task->td_dephash,
                          NO_DEP_BARRIER, ndeps, dep_list, ndeps_noalias,
                          noalias_dep_list)) {
       KA_TRACE(10, ("__kmpc_omp_task_with_deps(exit): T#%d task had blocking "
@@ -633,7 +697,7 @@ void __kmpc_omp_wait_deps(ident_t *loc_ref, kmp_int32 gtid, kmp_int32 ndeps,
   kmp_depnode_t node = {0};
   __kmp_init_node(&node);
 
-  if (!__kmp_check_deps(gtid, &node, NULL, current_task->td_dephash,
+  if (!__kmp_check_deps(gtid, &node, NULL, &current_task->td_dephash,
                         DEP_BARRIER, ndeps, dep_list, ndeps_noalias,
                         noalias_dep_list)) {
     KA_TRACE(10, ("__kmpc_omp_wait_deps(exit): T#%d has no blocking "
@@ -291,10 +291,31 @@ static bool __kmp_task_is_allowed(int gtid, const kmp_int32 is_constrained,
   return true;
 }
 
+// The deque of a thread holds the tasks with indices in [td_deque_head,
+// td_deque_tail). The indices do not wrap, task i is in slot i & mask.
+//
+// The owner pushes and pops tasks at the tail without td_deque_lock, and
+// everyone else takes it, so thieves only race with the owner. They do so as
+// in the THE protocol of Cilk: the owner takes the tail task by decrementing
+// the tail and then reading the head, and a thief takes the head task by
+// incrementing the head and then reading the tail. Both are seq_cst, so when
+// they go for the same task at least one of them sees the other and backs
+// off: the thief gives up and the owner tries again under the lock.
+//
+// A thread that changes more of the deque, to steal a task behind the head
+// or to give one to the owner, first moves the head past any tail. That sends
+// the owner to the lock until the thread is done, but a push that already
+// read the head may still be writing the slot of the tail the thread sees.
+//
+// Since a thief moves the head before it knows whether it can take the task,
+// the owner may see a head one past the real one. It does not push into the
+// last free slot without the lock.
+
 // __kmp_realloc_task_deque:
 // Re-allocates a task deque for a particular thread, copies the content from
 // the old deque and adjusts the necessary data structures relating to the
-// deque. This operation must be done with the deque_lock being held
+// deque. This operation must be done by the owner with the deque_lock being
+// held
 static void __kmp_realloc_task_deque(kmp_info_t *thread,
                                      kmp_thread_data_t *thread_data) {
   kmp_int32 size = TASK_DEQUE_SIZE(thread_data->td);
@@ -307,15 +328,13 @@ static void __kmp_realloc_task_deque(kmp_info_t *thread,
   kmp_taskdata_t **new_deque =
       (kmp_taskdata_t **)__kmp_allocate(new_size * sizeof(kmp_taskdata_t *));
 
-  int i, j;
-  for (i = thread_data->td.td_deque_head, j = 0; j < size;
-       i = (i + 1) & TASK_DEQUE_MASK(thread_data->td), j++)
-    new_deque[j] = thread_data->td.td_deque[i];
+  kmp_uint32 tail = TASK_DEQUE_TAIL(thread_data->td);
+  for (kmp_uint32 i = TASK_DEQUE_HEAD(thread_data->td); i != tail; ++i)
+    new_deque[i & (new_size - 1)] =
+        thread_data->td.td_deque[i & TASK_DEQUE_MASK(thread_data->td)];
 
   __kmp_free(thread_data->td.td_deque);
 
-  thread_data->td.td_deque_head = 0;
-  thread_data->td.td_deque_tail = size;
   thread_data->td.td_deque = new_deque;
   thread_data->td.td_deque_size = new_size;
 }
@@ -368,28 +387,24 @@ static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
   }
 
   int locked = 0;
+  kmp_uint32 tail = TASK_DEQUE_TAIL(thread_data->td);
+  kmp_int32 ntasks = (kmp_int32)(
+      tail - KMP_ATOMIC_LD(&thread_data->td.td_deque_head, seq_cst));
   // Check if deque is full
-  if (TCR_4(thread_data->td.td_deque_ntasks) >=
-      TASK_DEQUE_SIZE(thread_data->td)) {
-    if (__kmp_enable_task_throttling &&
-        __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
-                              thread->th.th_current_task)) {
-      KA_TRACE(20, ("__kmp_push_task: T#%d deque is full; returning "
-                    "TASK_NOT_PUSHED for task %p\n",
-                    gtid, taskdata));
-      return TASK_NOT_PUSHED;
-    } else {
-      __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-      locked = 1;
-      // expand deque to push the task which is not allowed to execute
-      __kmp_realloc_task_deque(thread, thread_data);
-    }
+  if (ntasks >= TASK_DEQUE_SIZE(thread_data->td) &&
+      __kmp_enable_task_throttling &&
+      __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
+                            thread->th.th_current_task)) {
+    KA_TRACE(20, ("__kmp_push_task: T#%d deque is full; returning "
+                  "TASK_NOT_PUSHED for task %p\n",
+                  gtid, taskdata));
+    return TASK_NOT_PUSHED;
   }
-  // Lock the deque for the task push operation
-  if (!locked) {
+  if (ntasks < 0 || ntasks >= TASK_DEQUE_SIZE(thread_data->td) - 1) {
+    // A thief holds the deque or it may be full, check again under the lock
     __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-    // Need to recheck as we can get a proxy task from thread outside of OpenMP
-    if (TCR_4(thread_data->td.td_deque_ntasks) >=
+    locked = 1;
+    if (TASK_DEQUE_NTASKS(thread_data->td) >=
         TASK_DEQUE_SIZE(thread_data->td)) {
       if (__kmp_enable_task_throttling &&
           __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
@@ -405,24 +420,23 @@ static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
       }
     }
   }
-  // Must have room since no thread can add tasks but calling thread
-  KMP_DEBUG_ASSERT(TCR_4(thread_data->td.td_deque_ntasks) <
-                   TASK_DEQUE_SIZE(thread_data->td));
+  // Must have room since no thread can add tasks at the tail but calling
+  // thread
+  KMP_DEBUG_ASSERT(!locked || TASK_DEQUE_NTASKS(thread_data->td) <
+                                  TASK_DEQUE_SIZE(thread_data->td));
 
-  thread_data->td.td_deque[thread_data->td.td_deque_tail] =
+  thread_data->td.td_deque[tail & TASK_DEQUE_MASK(thread_data->td)] =
       taskdata; // Push taskdata
-  // Wrap index.
-  thread_data->td.td_deque_tail =
-      (thread_data->td.td_deque_tail + 1) & TASK_DEQUE_MASK(thread_data->td);
-  TCW_4(thread_data->td.td_deque_ntasks,
-        TCR_4(thread_data->td.td_deque_ntasks) + 1); // Adjust task count
+  KMP_ATOMIC_OP(store, &thread_data->td.td_deque_tail, tail + 1, seq_cst);
 
   KA_TRACE(20, ("__kmp_push_task: T#%d returning TASK_SUCCESSFULLY_PUSHED: "
                 "task=%p ntasks=%d head=%u tail=%u\n",
-                gtid, taskdata, thread_data->td.td_deque_ntasks,
-                thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
+                gtid, taskdata, TASK_DEQUE_NTASKS(thread_data->td),
+                TASK_DEQUE_HEAD(thread_data->td),
+                TASK_DEQUE_TAIL(thread_data->td)));
 
-  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+  if (locked)
+    __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
 
   return TASK_SUCCESSFULLY_PUSHED;
 }
@@ -2584,60 +2598,86 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   thread_data = &task_team->tt.tt_threads_data[__kmp_tid_from_gtid(gtid)];
 
   KA_TRACE(10, ("__kmp_remove_my_task(enter): T#%d ntasks=%d head=%u tail=%u\n",
-                gtid, thread_data->td.td_deque_ntasks,
-                thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
+                gtid, TASK_DEQUE_NTASKS(thread_data->td),
+                TASK_DEQUE_HEAD(thread_data->td),
+                TASK_DEQUE_TAIL(thread_data->td)));
 
-  if (TCR_4(thread_data->td.td_deque_ntasks) == 0) {
+  if (TASK_DEQUE_NTASKS(thread_data->td) <= 0) {
     KA_TRACE(10,
              ("__kmp_remove_my_task(exit #1): T#%d No tasks to remove: "
               "ntasks=%d head=%u tail=%u\n",
-              gtid, thread_data->td.td_deque_ntasks,
-              thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
+              gtid, TASK_DEQUE_NTASKS(thread_data->td),
+              TASK_DEQUE_HEAD(thread_data->td),
+              TASK_DEQUE_TAIL(thread_data->td)));
     return NULL;
   }
 
-  __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-
-  if (TCR_4(thread_data->td.td_deque_ntasks) == 0) {
-    __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
-    KA_TRACE(10,
-             ("__kmp_remove_my_task(exit #2): T#%d No tasks to remove: "
-              "ntasks=%d head=%u tail=%u\n",
-              gtid, thread_data->td.td_deque_ntasks,
-              thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
-    return NULL;
+  // Claim the tail task, then check that no thief claimed it too.
+  tail = TASK_DEQUE_TAIL(thread_data->td) - 1;
+  KMP_ATOMIC_OP(store, &thread_data->td.td_deque_tail, tail, seq_cst);
+  int locked = 0;
+  if ((kmp_int32)(tail - KMP_ATOMIC_LD(&thread_data->td.td_deque_head,
+                                       seq_cst)) < 0) {
+    // Wait for the thief, which leaves the head where it is if it did not
+    // take the task.
+    __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
+    locked = 1;
+    if ((kmp_int32)(tail - TASK_DEQUE_HEAD(thread_data->td)) < 0) {
+      KMP_ATOMIC_ST_REL(&thread_data->td.td_deque_tail, tail + 1);
+      __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+      KA_TRACE(10,
+               ("__kmp_remove_my_task(exit #2): T#%d No tasks to remove: "
+                "ntasks=%d head=%u tail=%u\n",
+                gtid, TASK_DEQUE_NTASKS(thread_data->td),
+                TASK_DEQUE_HEAD(thread_data->td),
+                TASK_DEQUE_TAIL(thread_data->td)));
+      return NULL;
+    }
   }
 
-  tail = (thread_data->td.td_deque_tail - 1) &
-         TASK_DEQUE_MASK(thread_data->td); // Wrap index.
-  taskdata = thread_data->td.td_deque[tail];
+  taskdata = thread_data->td.td_deque[tail & TASK_DEQUE_MASK(thread_data->td)];
 
   if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata,
                              thread->th.th_current_task)) {
     // The TSC does not allow to steal victim task
-    __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+    KMP_ATOMIC_ST_REL(&thread_data->td.td_deque_tail, tail + 1);
+    if (locked)
+      __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
     KA_TRACE(10,
              ("__kmp_remove_my_task(exit #3): T#%d TSC blocks tail task: "
               "ntasks=%d head=%u tail=%u\n",
-              gtid, thread_data->td.td_deque_ntasks,
-              thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
+              gtid, TASK_DEQUE_NTASKS(thread_data->td),
+              TASK_DEQUE_HEAD(thread_data->td),
+              TASK_DEQUE_TAIL(thread_data->td)));
     return NULL;
   }
 
-  thread_data->td.td_deque_tail = tail;
-  TCW_4(thread_data->td.td_deque_ntasks, thread_data->td.td_deque_ntasks - 1);
-
-  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+  if (locked)
+    __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
 
   KA_TRACE(10, ("__kmp_remove_my_task(exit #4): T#%d task %p removed: "
                 "ntasks=%d head=%u tail=%u\n",
-                gtid, taskdata, thread_data->td.td_deque_ntasks,
-                thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
+                gtid, taskdata, TASK_DEQUE_NTASKS(thread_data->td),
+                TASK_DEQUE_HEAD(thread_data->td),
+                TASK_DEQUE_TAIL(thread_data->td)));
 
   task = KMP_TASKDATA_TO_TASK(taskdata);
   return task;
 }
 
+// __kmp_exclude_deque_owner: keep the owner of a deque off it until its head
+// is set again, and return the number of tasks the owner left in it. The
+// caller holds the deque lock.
+static kmp_int32 __kmp_exclude_deque_owner(kmp_thread_data_t *thread_data,
+                                           kmp_uint32 head) {
+  // The owner sees a negative number of tasks with any tail it can have, and
+  // goes to the lock.
+  KMP_ATOMIC_OP(store, &thread_data->td.td_deque_head,
+                head + TASK_DEQUE_SIZE(thread_data->td), seq_cst);
+  return (kmp_int32)(KMP_ATOMIC_LD(&thread_data->td.td_deque_tail, seq_cst) -
+                     head);
+}
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -2650,7 +2690,7 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   kmp_taskdata_t *taskdata;
   kmp_taskdata_t *current;
   kmp_thread_data_t *victim_td, *threads_data;
-  kmp_int32 target;
+  kmp_uint32 head, target;
   kmp_int32 victim_tid;
 
   KMP_DEBUG_ASSERT(__kmp_tasking_mode != tskm_immediate_exec);
@@ -2664,55 +2704,66 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   KA_TRACE(10, ("__kmp_steal_task(enter): T#%d try to steal from T#%d: "
                 "task_team=%p ntasks=%d head=%u tail=%u\n",
                 gtid, __kmp_gtid_from_thread(victim_thr), task_team,
-                victim_td->td.td_deque_ntasks, victim_td->td.td_deque_head,
-                victim_td->td.td_deque_tail));
+                TASK_DEQUE_NTASKS(victim_td->td),
+                TASK_DEQUE_HEAD(victim_td->td),
+                TASK_DEQUE_TAIL(victim_td->td)));
 
-  if (TCR_4(victim_td->td.td_deque_ntasks) == 0) {
+  if (TASK_DEQUE_NTASKS(victim_td->td) <= 0) {
     KA_TRACE(10, ("__kmp_steal_task(exit #1): T#%d could not steal from T#%d: "
                   "task_team=%p ntasks=%d head=%u tail=%u\n",
                   gtid, __kmp_gtid_from_thread(victim_thr), task_team,
-                  victim_td->td.td_deque_ntasks, victim_td->td.td_deque_head,
-                  victim_td->td.td_deque_tail));
+                  TASK_DEQUE_NTASKS(victim_td->td),
+                  TASK_DEQUE_HEAD(victim_td->td),
+                  TASK_DEQUE_TAIL(victim_td->td)));
     return NULL;
   }
 
   __kmp_acquire_bootstrap_lock(&victim_td->td.td_deque_lock);
 
-  int ntasks = TCR_4(victim_td->td.td_deque_ntasks);
+  // Claim the head task, then check that the owner did not claim it too.
+  head = TASK_DEQUE_HEAD(victim_td->td);
+  KMP_ATOMIC_OP(store, &victim_td->td.td_deque_head, head + 1, seq_cst);
+  int ntasks =
+      (kmp_int32)(KMP_ATOMIC_LD(&victim_td->td.td_deque_tail, seq_cst) - head);
   // Check again after we acquire the lock
-  if (ntasks == 0) {
+  if (ntasks <= 0) {
+    KMP_ATOMIC_ST_REL(&victim_td->td.td_deque_head, head);
     __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
     KA_TRACE(10, ("__kmp_steal_task(exit #2): T#%d could not steal from T#%d: "
                   "task_team=%p ntasks=%d head=%u tail=%u\n",
                   gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
-                  victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
+                  TASK_DEQUE_HEAD(victim_td->td),
+                  TASK_DEQUE_TAIL(victim_td->td)));
     return NULL;
   }
 
   KMP_DEBUG_ASSERT(victim_td->td.td_deque != NULL);
   current = __kmp_threads[gtid]->th.th_current_task;
-  taskdata = victim_td->td.td_deque[victim_td->td.td_deque_head];
-  if (__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
-    // Bump head pointer and Wrap.
-    victim_td->td.td_deque_head =
-        (victim_td->td.td_deque_head + 1) & TASK_DEQUE_MASK(victim_td->td);
-  } else {
+  taskdata = victim_td->td.td_deque[head & TASK_DEQUE_MASK(victim_td->td)];
+  if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
     if (!task_team->tt.tt_untied_task_encountered) {
       // The TSC does not allow to steal victim task
+      KMP_ATOMIC_ST_REL(&victim_td->td.td_deque_head, head);
       __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
       KA_TRACE(10, ("__kmp_steal_task(exit #3): T#%d could not steal from "
                     "T#%d: task_team=%p ntasks=%d head=%u tail=%u\n",
                     gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
-                    victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
+                    TASK_DEQUE_HEAD(victim_td->td),
+                    TASK_DEQUE_TAIL(victim_td->td)));
       return NULL;
     }
+    // The head task stays ours, even if the owner waits for the lock to pop
+    // it and leaves none.
+    ntasks = __kmp_exclude_deque_owner(victim_td, head);
+    KMP_DEBUG_ASSERT(ntasks >= 0);
     int i;
     // walk through victim's deque trying to steal any task
-    target = victim_td->td.td_deque_head;
+    target = head;
     taskdata = NULL;
     for (i = 1; i < ntasks; ++i) {
-      target = (target + 1) & TASK_DEQUE_MASK(victim_td->td);
-      taskdata = victim_td->td.td_deque[target];
+      ++target;
+      taskdata =
+          victim_td->td.td_deque[target & TASK_DEQUE_MASK(victim_td->td)];
       if (__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
         break; // found victim task
       } else {
@@ -2721,24 +2772,21 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
     }
     if (taskdata == NULL) {
       // No appropriate candidate to steal found
+      KMP_ATOMIC_ST_REL(&victim_td->td.td_deque_head, head);
       __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
       KA_TRACE(10, ("__kmp_steal_task(exit #4): T#%d could not steal from "
                     "T#%d: task_team=%p ntasks=%d head=%u tail=%u\n",
                     gtid, __kmp_gtid_from_thread(victim_thr), task_team, ntasks,
-                    victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
+                    TASK_DEQUE_HEAD(victim_td->td),
+                    TASK_DEQUE_TAIL(victim_td->td)));
       return NULL;
     }
-    int prev = target;
-    for (i = i + 1; i < ntasks; ++i) {
-      // shift remaining tasks in the deque left by 1
-      target = (target + 1) & TASK_DEQUE_MASK(victim_td->td);
-      victim_td->td.td_deque[prev] = victim_td->td.td_deque[target];
-      prev = target;
-    }
-    KMP_DEBUG_ASSERT(
-        victim_td->td.td_deque_tail ==
-        (kmp_uint32)((target + 1) & TASK_DEQUE_MASK(victim_td->td)));
-    victim_td->td.td_deque_tail = target; // tail -= 1 (wrapped))
+    // shift the tasks before the victim task right by 1, away from the tail
+    // the owner may still be using
+    for (; target != head; --target)
+      victim_td->td.td_deque[target & TASK_DEQUE_MASK(victim_td->td)] =
+          victim_td->td.td_deque[(target - 1) & TASK_DEQUE_MASK(victim_td->td)];
+    KMP_ATOMIC_ST_REL(&victim_td->td.td_deque_head, head + 1);
   }
   if (*thread_finished) {
     // We need to un-mark this victim as a finished victim.  This must be done
@@ -2755,7 +2803,6 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
 
     *thread_finished = FALSE;
   }
-  TCW_4(victim_td->td.td_deque_ntasks, ntasks - 1);
 
   __kmp_release_bootstrap_lock(&victim_td->td.td_deque_lock);
 
@@ -2764,12 +2811,42 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
            ("__kmp_steal_task(exit #5): T#%d stole task %p from T#%d: "
             "task_team=%p ntasks=%d head=%u tail=%u\n",
             gtid, taskdata, __kmp_gtid_from_thread(victim_thr), task_team,
-            ntasks, victim_td->td.td_deque_head, victim_td->td.td_deque_tail));
+            ntasks, TASK_DEQUE_HEAD(victim_td->td),
+            TASK_DEQUE_TAIL(victim_td->td)));
 
   task = KMP_TASKDATA_TO_TASK(taskdata);
   return task;
 }
 
+// __kmp_select_victim: pick a random thread other than tid to steal from.
+// When threads are bound, the one of two random threads that is bound closer
+// to the thief is picked. Places are numbered in topology order, so this
+// prefers victims sharing caches with the thief while reaching all of them.
+static kmp_int32 __kmp_select_victim(kmp_info_t *thread, kmp_int32 tid,
+                                     kmp_int32 nthreads,
+                                     kmp_thread_data_t *threads_data) {
+  kmp_int32 victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+  if (victim_tid >= tid) {
+    ++victim_tid; // Adjusts random distribution to exclude self
+  }
+#if KMP_AFFINITY_SUPPORTED
+  int place = thread->th.th_current_place;
+  if (nthreads > 2 && place >= 0) {
+    kmp_int32 other_tid = __kmp_get_random(thread) % (nthreads - 1);
+    if (other_tid >= tid) {
+      ++other_tid;
+    }
+    int victim_place = threads_data[victim_tid].td.td_thr->th.th_current_place;
+    int other_place = threads_data[other_tid].td.td_thr->th.th_current_place;
+    if (other_place >= 0 &&
+        (victim_place < 0 ||
+         abs(other_place - place) < abs(victim_place - place)))
+      victim_tid = other_tid;
+  }
+#endif // KMP_AFFINITY_SUPPORTED
+  return victim_tid;
+}
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -2837,10 +2914,8 @@ static inline int __kmp_execute_tasks_template(
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
             // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
-            if (victim_tid >= tid) {
-              ++victim_tid; // Adjusts random distribution to exclude self
-            }
+            victim_tid = __kmp_select_victim(thread, tid, nthreads,
+                                             threads_data);
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
             // There is a slight chance that __kmp_enable_tasking() did not wake
@@ -2925,7 +3000,7 @@ static inline int __kmp_execute_tasks_template(
       KMP_YIELD(__kmp_library == library_throughput); // Yield before next task
       // If execution of a stolen task results in more tasks being placed on our
       // run queue, reset use_own_tasks
-      if (!use_own_tasks && TCR_4(threads_data[tid].td.td_deque_ntasks) != 0) {
+      if (!use_own_tasks && TASK_DEQUE_NTASKS(threads_data[tid].td) > 0) {
         KA_TRACE(20, ("__kmp_execute_tasks_template: T#%d stolen task spawned "
                       "other tasks, restart\n",
                       gtid));
@@ -3130,9 +3205,8 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
   // Initialize last stolen task field to "none"
   thread_data->td.td_deque_last_stolen = -1;
 
-  KMP_DEBUG_ASSERT(TCR_4(thread_data->td.td_deque_ntasks) == 0);
-  KMP_DEBUG_ASSERT(thread_data->td.td_deque_head == 0);
-  KMP_DEBUG_ASSERT(thread_data->td.td_deque_tail == 0);
+  KMP_DEBUG_ASSERT(TASK_DEQUE_HEAD(thread_data->td) == 0);
+  KMP_DEBUG_ASSERT(TASK_DEQUE_TAIL(thread_data->td) == 0);
 
   KE_TRACE(
       10,
@@ -3152,7 +3226,8 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
 static void __kmp_free_task_deque(kmp_thread_data_t *thread_data) {
   if (thread_data->td.td_deque != NULL) {
     __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-    TCW_4(thread_data->td.td_deque_ntasks, 0);
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_deque_head, 0);
+    KMP_ATOMIC_ST_RLX(&thread_data->td.td_deque_tail, 0);
     __kmp_free(thread_data->td.td_deque);
     thread_data->td.td_deque = NULL;
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
@@ -3613,10 +3688,9 @@ void __kmp_tasking_barrier(kmp_team_t *team, kmp_info_t *thread, int gtid) {
 // __kmp_give_task puts a task into a given thread queue if:
 //  - the queue for that thread was created
 //  - there's space in that queue
-// Because of this, __kmp_push_task needs to check if there's space after
-// getting the lock
-static bool __kmp_give_task(kmp_info_t *thread, kmp_int32 tid, kmp_task_t *task,
-                            kmp_int32 pass) {
+// The task goes in before the head, as only the owner may push at the tail
+static bool __kmp_give_task(kmp_info_t *thread, kmp_int32 tid,
+                            kmp_task_t *task) {
   kmp_taskdata_t *taskdata = KMP_TASK_TO_TASKDATA(task);
   kmp_task_team_t *task_team = taskdata->td_task_team;
 
@@ -3626,7 +3700,6 @@ static bool __kmp_give_task(kmp_info_t *thread, kmp_int32 tid, kmp_task_t *task,
   // If task_team is NULL something went really bad...
   KMP_DEBUG_ASSERT(task_team != NULL);
 
-  bool result = false;
   kmp_thread_data_t *thread_data = &task_team->tt.tt_threads_data[tid];
 
   if (thread_data->td.td_deque == NULL) {
@@ -3635,60 +3708,43 @@ static bool __kmp_give_task(kmp_info_t *thread, kmp_int32 tid, kmp_task_t *task,
     KA_TRACE(30,
              ("__kmp_give_task: thread %d has no queue while giving task %p.\n",
               tid, taskdata));
-    return result;
+    return false;
   }
 
-  if (TCR_4(thread_data->td.td_deque_ntasks) >=
-      TASK_DEQUE_SIZE(thread_data->td)) {
+  if (TASK_DEQUE_NTASKS(thread_data->td) >=
+      TASK_DEQUE_SIZE(thread_data->td) - 1) {
     KA_TRACE(
         30,
         ("__kmp_give_task: queue is full while giving task %p to thread %d.\n",
          taskdata, tid));
+    return false;
+  }
 
-    // if this deque is bigger than the pass ratio give a chance to another
-    // thread
-    if (TASK_DEQUE_SIZE(thread_data->td) / INITIAL_TASK_DEQUE_SIZE >= pass)
-      return result;
-
-    __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-    __kmp_realloc_task_deque(thread, thread_data);
-
-  } else {
-
-    __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
-
-    if (TCR_4(thread_data->td.td_deque_ntasks) >=
-        TASK_DEQUE_SIZE(thread_data->td)) {
-      KA_TRACE(30, ("__kmp_give_task: queue is full while giving task %p to "
-                    "thread %d.\n",
-                    taskdata, tid));
-
-      // if this deque is bigger than the pass ratio give a chance to another
-      // thread
-      if (TASK_DEQUE_SIZE(thread_data->td) / INITIAL_TASK_DEQUE_SIZE >= pass)
-        goto release_and_exit;
+  __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
 
-      __kmp_realloc_task_deque(thread, thread_data);
-    }
+  kmp_uint32 head = TASK_DEQUE_HEAD(thread_data->td);
+  // Only the owner can grow its deque. Leave the slot a push of the owner may
+  // still be writing.
+  if (__kmp_exclude_deque_owner(thread_data, head) >
+      TASK_DEQUE_SIZE(thread_data->td) - 2) {
+    KMP_ATOMIC_ST_REL(&thread_data->td.td_deque_head, head);
+    __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+    KA_TRACE(30, ("__kmp_give_task: queue is full while giving task %p to "
+                  "thread %d.\n",
+                  taskdata, tid));
+    return false;
   }
 
-  // lock is held here, and there is space in the deque
+  thread_data->td.td_deque[(head - 1) & TASK_DEQUE_MASK(thread_data->td)] =
+      taskdata;
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_deque_head, head - 1);
 
-  thread_data->td.td_deque[thread_data->td.td_deque_tail] = taskdata;
-  // Wrap index.
-  thread_data->td.td_deque_tail =
-      (thread_data->td.td_deque_tail + 1) & TASK_DEQUE_MASK(thread_data->td);
-  TCW_4(thread_data->td.td_deque_ntasks,
-        TCR_4(thread_data->td.td_deque_ntasks) + 1);
+  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
 
-  result = true;
   KA_TRACE(30, ("__kmp_give_task: successfully gave task %p to thread %d.\n",
                 taskdata, tid));
 
-release_and_exit:
-  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
-
-  return result;
+  return true;
 }
 
 /* The finish of the proxy tasks is divided in two pieces:
@@ -3807,7 +3863,6 @@ void __kmpc_proxy_task_completed_ooo(kmp_task_t *ptask) {
   // This should be similar to start_k = __kmp_get_random( thread ) % nthreads
   // but we cannot use __kmp_get_random here
   kmp_int32 start_k = 0;
-  kmp_int32 pass = 1;
   kmp_int32 k = start_k;
 
   do {
@@ -3815,11 +3870,12 @@ void __kmpc_proxy_task_completed_ooo(kmp_task_t *ptask) {
     thread = team->t.t_threads[k];
     k = (k + 1) % nthreads;
 
-    // we did a full pass through all the threads
+    // we did a full pass through all the threads, and their deques were full;
+    // wait for the owners to run some of their tasks
     if (k == start_k)
-      pass = pass << 1;
+      KMP_CPU_PAUSE();
 
-  } while (!__kmp_give_task(thread, k, ptask, pass));
+  } while (!__kmp_give_task(thread, k, ptask));
 
   __kmp_second_top_half_finish_proxy(taskdata);
 
@@ -152,6 +152,22 @@ static void __ompt_implicit_task_end(kmp_info_t *this_thr,
 }
 #endif
 
+#if !KMP_USE_MONITOR
+/* Time to spin in the fork barrier with KMP_ADAPTIVE_BLOCKTIME, given how long
+   the team usually waits between regions. If the next region usually comes
+   within the blocktime, spin for twice the gap and sleep when the region is
+   late. If it usually comes later, spinning only burns the CPU, so sleep right
+   away. */
+static inline kmp_uint64 __kmp_adapt_blocktime(kmp_uint64 bt_intervals,
+                                               kmp_uint64 gap) {
+  if (gap == 0)
+    return bt_intervals;
+  if (gap > bt_intervals)
+    return 0;
+  return KMP_MIN(bt_intervals, 2 * gap);
+}
+#endif
+
 /* Spin wait loop that first does pause/yield, then sleep. A thread that calls
    __kmp_wait_*  must make certain that another thread calls __kmp_release
    to wake it back up to prevent deadlocks!
@@ -307,6 +323,10 @@ final_spin=FALSE)
     if (__kmp_pause_status == kmp_soft_paused) {
       // Force immediate suspend
       hibernate_goal = KMP_NOW();
+    } else if (final_spin && __kmp_adaptive_blocktime) {
+      hibernate_goal =
+          KMP_NOW() + __kmp_adapt_blocktime(this_thr->th.th_team_bt_intervals,
+                                            this_thr->th.th_team_gap);
     } else
       hibernate_goal = KMP_NOW() + this_thr->th.th_team_bt_intervals;
     poll_count = 0;
@@ -424,6 +444,12 @@ final_spin=FALSE)
                this_thr->th.th_reap_state == KMP_SAFE_TO_REAP) {
       this_thr->th.th_reap_state = KMP_NOT_SAFE_TO_REAP;
     }
+#if !KMP_USE_MONITOR
+    // A thread woken up before its flag is released, like the workers of a
+    // team woken up at once for a fork, spins for the whole blocktime again.
+    if (__kmp_pause_status != kmp_soft_paused)
+      hibernate_goal = KMP_NOW() + this_thr->th.th_team_bt_intervals;
+#endif
     // TODO: If thread is done with work and times out, disband/free
   }
 
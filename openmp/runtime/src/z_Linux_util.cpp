@@ -45,6 +45,18 @@
 #ifndef FUTEX_WAKE
 #define FUTEX_WAKE 1
 #endif
+#ifndef FUTEX_WAIT_BITSET
+#define FUTEX_WAIT_BITSET 9
+#endif
+#ifndef FUTEX_WAKE_BITSET
+#define FUTEX_WAKE_BITSET 10
+#endif
+#ifndef FUTEX_PRIVATE_FLAG
+#define FUTEX_PRIVATE_FLAG 128
+#endif
+#ifndef FUTEX_BITSET_MATCH_ANY
+#define FUTEX_BITSET_MATCH_ANY 0xffffffff
+#endif
 #endif
 #elif KMP_OS_DARWIN
 #include <mach/mach.h>
@@ -302,6 +314,43 @@ int __kmp_futex_determine_capable() {
   return retval;
 }
 
+// Threads whose masters share a word only see spurious wakeups.
+#define KMP_WAKE_WORDS 64
+// Wakeups of a team count in the high half of the value, and sleepers tell
+// them from wakeups of single threads by it. After 64K wakeups of single
+// threads the count carries over, which only ends one sleep early.
+#define KMP_WAKE_TEAM (1u << 16)
+#define KMP_WAKE_TEAM_MASK (~(KMP_WAKE_TEAM - 1))
+#define KMP_WAKE_BIT(gtid) (1u << ((gtid) % 32))
+
+static kmp_wake_word_t __kmp_wake_words[KMP_WAKE_WORDS];
+
+kmp_wake_word_t *__kmp_wake_word(int master_gtid) {
+  KMP_DEBUG_ASSERT(master_gtid >= 0);
+  return &__kmp_wake_words[master_gtid % KMP_WAKE_WORDS];
+}
+
+// Bump the value and wake up the sleepers with any of the given bits. The
+// sequentially consistent operations pair with those of the sleeper in
+// __kmp_suspend_template(): either the waker sees the sleeper counted, or the
+// kernel sees the new value and does not put the sleeper to sleep.
+static void __kmp_wake(kmp_wake_word_t *wake, kmp_uint32 count,
+                       kmp_uint32 bits) {
+  wake->value.fetch_add(count);
+  if (wake->sleepers.load() > 0)
+    syscall(__NR_futex, &wake->value, FUTEX_WAKE_BITSET | FUTEX_PRIVATE_FLAG,
+            INT_MAX, NULL, NULL, bits);
+}
+
+/* Wake up all threads sleeping on the futex word of the team of the given
+   master with one system call. They leave __kmp_suspend_template() even
+   though their flags might not be released yet, and spin for them. */
+void __kmp_wake_team(int master_gtid) {
+  KF_TRACE(30, ("__kmp_wake_team: T#%d waking up its team\n", master_gtid));
+  __kmp_wake(__kmp_wake_word(master_gtid), KMP_WAKE_TEAM,
+             FUTEX_BITSET_MATCH_ANY);
+}
+
 #endif // KMP_USE_FUTEX
 
 #if (KMP_ARCH_X86 || KMP_ARCH_X86_64) && (!KMP_ASM_INTRINS)
@@ -1292,7 +1341,8 @@ static void __kmp_atfork_child(void) {
 
   __kmp_thread_pool = NULL;
   __kmp_thread_pool_insert_pt = NULL;
-  __kmp_team_pool = NULL;
+  for (int i = 0; i < KMP_TEAM_POOL_LEVELS; ++i)
+    __kmp_team_pool[i] = NULL;
 
   /* Must actually zero all the *cache arguments passed to __kmpc_threadprivate
      here so threadprivate doesn't use stale data */
@@ -1348,6 +1398,10 @@ void __kmp_suspend_initialize(void) {
   KMP_CHECK_SYSFAIL("pthread_mutexattr_init", status);
   status = pthread_condattr_init(&__kmp_suspend_cond_attr);
   KMP_CHECK_SYSFAIL("pthread_condattr_init", status);
+#if KMP_USE_FUTEX
+  if (__kmp_futex_sleep && !__kmp_futex_determine_capable())
+    __kmp_futex_sleep = FALSE;
+#endif
 }
 
 void __kmp_suspend_initialize_thread(kmp_info_t *th) {
@@ -1458,6 +1512,14 @@ static inline void __kmp_suspend_template(int th_gtid, C *flag) {
        not been signaled or broadcast */
     int deactivated = FALSE;
     TCW_PTR(th->th.th_sleep_loc, (void *)flag);
+#if KMP_USE_FUTEX
+    kmp_wake_word_t *wake = NULL;
+    if (__kmp_futex_sleep) {
+      wake = th->th.th_wake_word ? th->th.th_wake_word
+                                 : __kmp_wake_word(th_gtid);
+      th->th.th_sleep_wake = wake;
+    }
+#endif
 
     while (flag->is_sleeping()) {
 #ifdef DEBUG_SUSPEND
@@ -1479,6 +1541,38 @@ static inline void __kmp_suspend_template(int th_gtid, C *flag) {
         deactivated = TRUE;
       }
 
+#if KMP_USE_FUTEX
+      if (wake) {
+        // Read the value before the sleep bit is checked again, so that a
+        // wakeup in between makes the futex wait return at once.
+        kmp_uint32 value = KMP_ATOMIC_LD_ACQ(&wake->value);
+        status = pthread_mutex_unlock(&th->th.th_suspend_mx.m_mutex);
+        KMP_CHECK_SYSFAIL("pthread_mutex_unlock", status);
+        if (flag->is_sleeping()) {
+          KF_TRACE(15, ("__kmp_suspend_template: T#%d about to perform"
+                        " futex wait\n",
+                        th_gtid));
+          wake->sleepers.fetch_add(1);
+          syscall(__NR_futex, &wake->value,
+                  FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, value, NULL, NULL,
+                  KMP_WAKE_BIT(th_gtid));
+          wake->sleepers.fetch_sub(1);
+        }
+        status = pthread_mutex_lock(&th->th.th_suspend_mx.m_mutex);
+        KMP_CHECK_SYSFAIL("pthread_mutex_lock", status);
+        if (((KMP_ATOMIC_LD_RLX(&wake->value) ^ value) & KMP_WAKE_TEAM_MASK) &&
+            flag->is_sleeping()) {
+          // The team was woken up for a fork; spin until the release.
+          KF_TRACE(15, ("__kmp_suspend_template: T#%d team wakeup\n",
+                        th_gtid));
+          flag->unset_sleeping();
+          TCW_PTR(th->th.th_sleep_loc, NULL);
+          break;
+        }
+        continue;
+      }
+#endif
+
 #if USE_SUSPEND_TIMEOUT
       struct timespec now;
       struct timeval tval;
@@ -1524,6 +1618,9 @@ static inline void __kmp_suspend_template(int th_gtid, C *flag) {
       }
 #endif
     } // while
+#if KMP_USE_FUTEX
+    th->th.th_sleep_wake = NULL;
+#endif
 
     // Mark the thread as active again (if it was previous marked as inactive)
     if (deactivated) {
@@ -1622,8 +1719,15 @@ static inline void __kmp_resume_template(int target_gtid, C *flag) {
                  target_gtid, buffer);
   }
 #endif
-  status = pthread_cond_signal(&th->th.th_suspend_cv.c_cond);
-  KMP_CHECK_SYSFAIL("pthread_cond_signal", status);
+#if KMP_USE_FUTEX
+  if (th->th.th_sleep_wake) {
+    __kmp_wake(th->th.th_sleep_wake, 1, KMP_WAKE_BIT(target_gtid));
+  } else
+#endif
+  {
+    status = pthread_cond_signal(&th->th.th_suspend_cv.c_cond);
+    KMP_CHECK_SYSFAIL("pthread_cond_signal", status);
+  }
   status = pthread_mutex_unlock(&th->th.th_suspend_mx.m_mutex);
   KMP_CHECK_SYSFAIL("pthread_mutex_unlock", status);
   KF_TRACE(30, ("__kmp_resume_template: T#%d exiting after signaling wake up"
@@ -0,0 +1,64 @@
+// RUN: %libomp-compile-and-run
+
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#define SIZE (1024 * 1024)
+
+// Every partition has to give usable memory from any thread, whether or not
+// the runtime can place it on particular nodes, and keep to its pool size.
+int main() {
+  omp_alloctrait_value_t partitions[] = {OMP_ATV_ENVIRONMENT, OMP_ATV_NEAREST,
+                                         OMP_ATV_BLOCKED, OMP_ATV_INTERLEAVED};
+  int i, failed = 0;
+
+  for (i = 0; i < 4; ++i) {
+    omp_alloctrait_t at[3];
+    omp_allocator_handle_t a;
+    void *p[4];
+    at[0].key = OMP_ATK_PARTITION;
+    at[0].value = partitions[i];
+    at[1].key = OMP_ATK_POOL_SIZE;
+    at[1].value = 3 * SIZE + SIZE / 2;
+    at[2].key = OMP_ATK_FALLBACK;
+    at[2].value = OMP_ATV_NULL_FB;
+    a = omp_init_allocator(omp_default_mem_space, 3, at);
+    if (a == omp_null_allocator) {
+      printf("failed: no allocator for partition %d\n", (int)partitions[i]);
+      return 1;
+    }
+    #pragma omp parallel num_threads(2)
+    {
+      int t = omp_get_thread_num();
+      p[t] = omp_alloc(SIZE, a);
+      if (p[t])
+        memset(p[t], t + 1, SIZE);
+      #pragma omp barrier
+      #pragma omp single
+      {
+        // The pool holds three blocks and their small overhead, not four
+        p[2] = omp_alloc(SIZE, a);
+        p[3] = omp_alloc(SIZE, a);
+      }
+      #pragma omp barrier
+      if (p[t] && ((char *)p[t])[SIZE - 1] != t + 1) {
+        printf("failed: memory of thread %d overwritten\n", t);
+        failed = 1;
+      }
+    }
+    if (!p[0] || !p[1] || !p[2] || p[3]) {
+      printf("failed: partition %d gave %p %p %p %p\n", (int)partitions[i],
+             p[0], p[1], p[2], p[3]);
+      failed = 1;
+    }
+    omp_free(p[0], a);
+    omp_free(p[1], a);
+    omp_free(p[2], a);
+    omp_destroy_allocator(a);
+  }
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
@@ -0,0 +1,65 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hyper,hyper %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hierarchical,hierarchical %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=auto,auto %libomp-run
+#include <stdio.h>
+#include <omp.h>
+
+/*
+ * Time the plain barrier of teams of growing size and check that no thread
+ * leaves a barrier before all threads of the team have arrived at it. The
+ * latencies are only reported; the runs above compare the patterns.
+ */
+
+#define ITERS 2000
+
+static int test_barrier(int nthreads) {
+  int count = 0, failed = 0;
+  double start = 0, stop = 0;
+
+  #pragma omp parallel num_threads(nthreads) shared(count, failed)
+  {
+    int i, n = omp_get_num_threads();
+    #pragma omp barrier
+    #pragma omp master
+    start = omp_get_wtime();
+    for (i = 0; i < ITERS; ++i) {
+      int seen;
+      #pragma omp atomic
+      count++;
+      #pragma omp barrier
+      #pragma omp atomic read
+      seen = count;
+      // The others may already be on their way to the next barrier
+      if (seen < (i + 1) * n || seen > (i + 2) * n) {
+        #pragma omp atomic write
+        failed = 1;
+      }
+    }
+    #pragma omp barrier
+    #pragma omp master
+    {
+      stop = omp_get_wtime();
+      nthreads = n;
+    }
+  }
+
+  printf("%3d threads: %8.3f us per barrier\n", nthreads,
+         (stop - start) * 1e6 / ITERS);
+  if (failed)
+    printf("failed: a thread left a barrier early with %d threads\n",
+           nthreads);
+  return failed;
+}
+
+int main() {
+  int n, max = omp_get_max_threads(), failed = 0;
+
+  for (n = 1; n < max; n *= 2)
+    failed |= test_barrier(n);
+  failed |= test_barrier(max);
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
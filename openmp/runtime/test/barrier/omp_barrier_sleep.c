@@ -0,0 +1,59 @@
+// RUN: %libomp-compile && env KMP_BLOCKTIME=1 %libomp-run
+// RUN: env KMP_BLOCKTIME=1 KMP_FUTEX_SLEEP=0 %libomp-run
+// RUN: env KMP_BLOCKTIME=1 KMP_ADAPTIVE_BLOCKTIME=1 %libomp-run
+// RUN: env KMP_BLOCKTIME=0 KMP_ADAPTIVE_BLOCKTIME=1 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+#include "omp_my_sleep.h"
+
+/*
+ * Run parallel regions separated by gaps both shorter and longer than the
+ * blocktime, so that the workers spin into some regions and are woken up
+ * from sleep for others, and let the sleeping threads be woken up for tasks
+ * and in explicit barriers as well. Every thread must take part in every
+ * region and every task must run.
+ */
+
+#define REPS 200
+
+int main() {
+  int r, failed = 0;
+
+  for (r = 0; r < REPS; ++r) {
+    int count = 0, tasks = 0, n = 0;
+    // Mostly short gaps, with a long one now and then
+    if (r % 10 == 0)
+      my_sleep(0.005);
+    #pragma omp parallel shared(count, tasks, n)
+    {
+      #pragma omp atomic
+      count++;
+      #pragma omp single
+      {
+        int i;
+        n = omp_get_num_threads();
+        if (r % 20 == 0)
+          my_sleep(0.003);
+        for (i = 0; i < 8; ++i) {
+          #pragma omp task shared(tasks)
+          {
+            #pragma omp atomic
+            tasks++;
+          }
+        }
+      }
+      if (omp_get_thread_num() == 0 && r % 25 == 0)
+        my_sleep(0.003);
+      #pragma omp barrier
+    }
+    if (count != n || tasks != 8) {
+      printf("failed: round %d, %d of %d threads and %d of 8 tasks\n", r,
+             count, n, tasks);
+      failed = 1;
+    }
+  }
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
@@ -0,0 +1,86 @@
+// RUN: %libomp-compile-and-run
+// RUN: env KMP_HOT_TEAMS_MAX_LEVEL=1 %libomp-run
+// RUN: env KMP_HOT_TEAMS_MAX_LEVEL=3 KMP_HOT_TEAMS_MODE=1 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+
+/*
+ * Time the fork and join of the innermost region of nests two and three
+ * levels deep, as a library called from a parallel region would fork, and
+ * check that every inner region gets a full team at the right level. The
+ * latencies are only reported; the runs above compare keeping the inner
+ * teams hot with releasing their threads after every region.
+ */
+
+#define ITERS 500
+#define NTH 2
+
+static int fork_inner(int level) {
+  int count = 0, failed = 0;
+
+  #pragma omp parallel num_threads(NTH) shared(count, failed)
+  {
+    if (omp_get_level() != level || omp_get_num_threads() != NTH) {
+      #pragma omp atomic write
+      failed = 1;
+    }
+    #pragma omp atomic
+    count++;
+  }
+  return failed || count != NTH;
+}
+
+// Repeat the innermost fork of a nest 'depth' levels deep from every thread
+// of the level above it
+static int repeat_inner(int depth) {
+  int i, failed = 0;
+  for (i = 0; i < ITERS; ++i)
+    failed |= fork_inner(depth);
+  return failed;
+}
+
+static int test_depth(int depth) {
+  int failed = 0;
+  double start, stop;
+
+  // Fork the outer levels once and repeat the innermost fork below them
+  start = omp_get_wtime();
+  #pragma omp parallel num_threads(NTH) shared(failed)
+  {
+    int f = 0;
+    if (depth > 2) {
+      #pragma omp parallel num_threads(NTH) shared(f)
+      {
+        int g = repeat_inner(depth);
+        #pragma omp atomic
+        f |= g;
+      }
+    } else {
+      f = repeat_inner(depth);
+    }
+    #pragma omp atomic
+    failed |= f;
+  }
+  stop = omp_get_wtime();
+
+  printf("depth %d: %8.3f us per inner fork/join\n", depth,
+         (stop - start) * 1e6 / ITERS);
+  if (failed)
+    printf("failed: wrong inner team at depth %d\n", depth);
+  return failed;
+}
+
+int main() {
+  int failed = 0;
+
+  omp_set_max_active_levels(3);
+  failed |= test_depth(2);
+  failed |= test_depth(3);
+  // Once more, now that the inner teams of both depths exist
+  failed |= test_depth(2);
+  failed |= test_depth(3);
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
@@ -0,0 +1,62 @@
+// RUN: %libomp-compile-and-run
+#include <stdio.h>
+#include <omp.h>
+
+/*
+ * Track more addresses than the dependence hash of a task starts with, so
+ * that it has to grow while the dependences are live, and give a task a long
+ * list of dependences with duplicates, as a depend clause with an iterator
+ * would expand to.
+ */
+
+#define N 5000
+#define REPS 4
+
+static int a[N], b[N];
+
+int main() {
+  int i, r, failed = 0;
+
+  for (r = 0; r < REPS; ++r) {
+    int sum = -1, check = 0;
+    #pragma omp parallel
+    #pragma omp single
+    {
+      for (i = 0; i < N; ++i) {
+        #pragma omp task depend(out : a[i]) firstprivate(i)
+        a[i] = i + r;
+      }
+      for (i = 0; i < N; ++i) {
+        #pragma omp task depend(in : a[i]) depend(out : b[i]) firstprivate(i)
+        b[i] = 2 * a[i];
+      }
+      #pragma omp task depend(in : b[0], b[1], b[2], b[3], b[4], b[5], b[6],  \
+                              b[7], b[8], b[9], b[10], b[11], b[12], b[13],    \
+                              b[14], b[15], b[16], b[17], b[18], b[19], b[0],  \
+                              b[5], b[19], b[10]) depend(out : sum)
+      {
+        int k;
+        sum = 0;
+        for (k = 0; k < 20; ++k)
+          sum += b[k];
+      }
+      #pragma omp taskwait
+    }
+    for (i = 0; i < 20; ++i)
+      check += 2 * (i + r);
+    if (sum != check) {
+      printf("failed: sum %d instead of %d\n", sum, check);
+      failed = 1;
+    }
+    for (i = 0; i < N; ++i)
+      if (b[i] != 2 * (i + r)) {
+        printf("failed: b[%d] = %d instead of %d\n", i, b[i], 2 * (i + r));
+        failed = 1;
+        break;
+      }
+  }
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
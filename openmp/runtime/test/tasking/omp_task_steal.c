@@ -0,0 +1,53 @@
+// RUN: %libomp-compile && env OMP_NUM_THREADS=2 %libomp-run
+// RUN: %libomp-compile && env OMP_NUM_THREADS=4 %libomp-run
+// RUN: %libomp-compile && env OMP_NUM_THREADS=4 KMP_ENABLE_TASK_THROTTLING=0 %libomp-run
+#include <stdio.h>
+#include <omp.h>
+
+/*
+ * Stress the task deques with many small tasks spawned recursively, so that
+ * the owners push and pop while the other threads steal from them. Untied
+ * tasks let thieves take tasks from behind the head of a deque as well.
+ * Every leaf must run exactly once.
+ */
+
+#define DEPTH 14
+#define REPS 8
+
+static int count_leaves(int depth, int untied) {
+  int left = 0, right = 0;
+  if (depth == 0)
+    return 1;
+  if (untied) {
+    #pragma omp task untied shared(left)
+    left = count_leaves(depth - 1, untied);
+    #pragma omp task untied shared(right)
+    right = count_leaves(depth - 1, untied);
+  } else {
+    #pragma omp task shared(left)
+    left = count_leaves(depth - 1, untied);
+    #pragma omp task shared(right)
+    right = count_leaves(depth - 1, untied);
+  }
+  #pragma omp taskwait
+  return left + right;
+}
+
+int main() {
+  int i, failed = 0;
+
+  for (i = 0; i < REPS; ++i) {
+    int leaves = 0;
+    #pragma omp parallel
+    #pragma omp single
+    leaves = count_leaves(DEPTH, i & 1);
+    if (leaves != 1 << DEPTH) {
+      printf("failed: %d leaves instead of %d\n", leaves, 1 << DEPTH);
+      failed = 1;
+    }
+  }
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
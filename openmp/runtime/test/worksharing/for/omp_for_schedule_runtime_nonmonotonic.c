@@ -0,0 +1,108 @@
+// RUN: %libomp-compile
+// RUN: env OMP_SCHEDULE=dynamic %libomp-run
+// RUN: env OMP_SCHEDULE=dynamic,3 %libomp-run
+// RUN: env OMP_SCHEDULE=nonmonotonic:dynamic,7 %libomp-run
+// RUN: env OMP_SCHEDULE=monotonic:dynamic,2 %libomp-run monotonic
+// RUN: env OMP_SCHEDULE=dynamic,2 KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE=1 %libomp-run monotonic
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+/*
+ * A dynamic schedule from OMP_SCHEDULE without modifiers is nonmonotonic and
+ * may be run with per-thread ranges that the other threads steal from. Every
+ * iteration must run exactly once, with 32 and 64-bit induction variables,
+ * and the iterations of each thread must still be increasing when the
+ * schedule asks for monotonic or the loop is ordered.
+ */
+
+#define N 20011
+#define MAX_THREADS 256
+
+static int count[N];
+static long long last[MAX_THREADS];
+static long long ordered_last;
+
+// Make the iterations uneven so that the threads steal from each other.
+static void work(int i) {
+  int j;
+  volatile double x = 0;
+  for (j = 0; j < (i % 97) * 10; ++j)
+    x += j;
+}
+
+static int check(const char *name, int check_monotonic, int *not_monotonic) {
+  int i, failed = 0;
+  for (i = 0; i < N; ++i)
+    if (count[i] != 1) {
+      printf("failed: %s: iteration %d ran %d times\n", name, i, count[i]);
+      failed = 1;
+      break;
+    }
+  if (check_monotonic && *not_monotonic) {
+    printf("failed: %s: a thread ran its iterations out of order\n", name);
+    failed = 1;
+  }
+  memset(count, 0, sizeof(count));
+  *not_monotonic = 0;
+  return failed;
+}
+
+int main(int argc, char **argv) {
+  int r, failed = 0, not_monotonic = 0;
+  int monotonic = argc > 1 && !strcmp(argv[1], "monotonic");
+
+  for (r = 0; r < REPETITIONS; ++r) {
+    #pragma omp parallel shared(not_monotonic)
+    {
+      int i, tid = omp_get_thread_num();
+      long long l;
+      last[tid] = -1;
+      #pragma omp for schedule(runtime)
+      for (i = 0; i < N; ++i) {
+        work(i);
+        #pragma omp atomic
+        count[i]++;
+        if (i < last[tid])
+          not_monotonic = 1;
+        last[tid] = i;
+      }
+      #pragma omp single
+      failed |= check("int", monotonic, &not_monotonic);
+
+      last[tid] = -1;
+      #pragma omp for schedule(runtime)
+      for (l = 0; l < N; ++l) {
+        work(l);
+        #pragma omp atomic
+        count[l]++;
+        if (l < last[tid])
+          not_monotonic = 1;
+        last[tid] = l;
+      }
+      #pragma omp single
+      failed |= check("long long", monotonic, &not_monotonic);
+
+      #pragma omp single
+      ordered_last = -1;
+      #pragma omp for schedule(runtime) ordered
+      for (l = 0; l < N; ++l) {
+        work(l);
+        #pragma omp ordered
+        {
+          count[l]++;
+          if (l != ordered_last + 1)
+            not_monotonic = 1;
+          ordered_last = l;
+        }
+      }
+      #pragma omp single
+      failed |= check("ordered", 1, &not_monotonic);
+    }
+  }
+
+  if (!failed)
+    printf("passed\n");
+  return failed;
+}
@@ -0,0 +1,541 @@
+//===-- ompprof.cpp - Low-overhead OMPT profiling tool ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A tool for OMP_TOOL_LIBRARIES that measures where the time of an OpenMP
+// program goes: how long each parallel region takes, how unevenly its work is
+// spread over the team, how long the threads wait in barriers and how many
+// tasks run on another thread than the one that created them. The counters
+// are kept per thread or per region instance, so the callbacks only read the
+// clock and touch memory that is not shared with other threads. At the end of
+// the program a summary goes to stderr (or OMPPROF_OUTPUT), and with
+// OMPPROF_TRACE set the regions, barrier waits and task slices of every
+// thread are written as a Chrome trace (chrome://tracing, Perfetto).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <omp-tools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <mutex>
+#include <string>
+#include <time.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+uint64_t now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Durations of region instances are binned by powers of two microseconds.
+constexpr int NumBuckets = 32;
+
+int bucketOf(uint64_t ns) {
+  uint64_t us = ns / 1000;
+  int b = 0;
+  while (us && b < NumBuckets - 1) {
+    us >>= 1;
+    ++b;
+  }
+  return b;
+}
+
+bool isBarrier(ompt_sync_region_t kind) {
+  return kind != ompt_sync_region_taskwait &&
+         kind != ompt_sync_region_taskgroup &&
+         kind != ompt_sync_region_reduction;
+}
+
+enum EventKind { EvParallel, EvBarrier, EvTask };
+
+// One complete event of the Chrome trace.
+struct TraceEvent {
+  EventKind Kind;
+  uint64_t Begin, End;
+  const void *Where; // The region of EvParallel and EvBarrier events.
+  uint64_t Creator;  // The creating thread of EvTask events.
+};
+
+struct ThreadState {
+  uint64_t Id;
+  uint64_t BarrierNs = 0;
+  uint64_t TasksCreated = 0, TasksRun = 0, TasksStolen = 0;
+  // The barrier the thread waits in, and the time it ran tasks there.
+  uint64_t WaitBegin = 0;
+  uint64_t WaitTaskNs = 0;
+  struct TeamSlot *WaitSlot = nullptr;
+  uint64_t TaskBegin = 0;
+  std::vector<TraceEvent> Trace;
+  // Per thread cache of the region statistics, see regionStats().
+  std::unordered_map<const void *, struct RegionStats *> Regions;
+};
+
+// Totals over all instances of a parallel region, keyed by its return
+// address.
+struct RegionStats {
+  const void *Codeptr;
+  std::mutex Lock;
+  uint64_t Count = 0;
+  uint64_t TotalNs = 0;
+  // Sums of the longest and of the average time a thread of the team spent
+  // busy, that is neither waiting in a barrier nor idle in it, for the
+  // imbalance.
+  uint64_t MaxWorkNs = 0, MeanWorkNs = 0;
+  uint64_t BarrierNs = 0;
+  unsigned MaxThreads = 0;
+  uint64_t Histogram[NumBuckets] = {};
+};
+
+struct ParallelInstance;
+
+// What a thread of the team did in one region instance. Only the thread
+// itself writes its slot. The master reads all of them at the end of the
+// region, after the join barrier has made all the writes visible.
+struct TeamSlot {
+  ParallelInstance *Instance;
+  uint64_t Begin = 0;
+  // Time of the last barrier the thread arrived at, which ends up being the
+  // join barrier, its idle time in barriers before that and the time it has
+  // run tasks since.
+  uint64_t Arrive = 0;
+  uint64_t IdleBeforeArrive = 0;
+  uint64_t WaitTaskNs = 0;
+  uint64_t IdleNs = 0;
+};
+
+struct ParallelInstance {
+  RegionStats *Region;
+  uint64_t Begin;
+  std::atomic<bool> Ended{false};
+  // The encountering thread and every implicit task of the team hold a
+  // reference, since workers only finish their implicit task when they leave
+  // the join barrier, which may be after the end of the region.
+  std::atomic<unsigned> Refs{1};
+  std::vector<TeamSlot> Slots;
+
+  void release() {
+    if (Refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+};
+
+// Tasks created while the tool watches carry this tag, and the creating
+// thread above it, in their task data. Implicit tasks keep a TeamSlot pointer
+// there, which is aligned and so never has the tag bit set.
+constexpr uint64_t ExplicitTag = 1;
+constexpr uint64_t StartedTag = 2;
+
+bool isExplicit(const ompt_data_t *task) {
+  return task && (task->value & ExplicitTag);
+}
+
+struct Config {
+  FILE *Output = stderr;
+  std::string TracePath;
+  size_t MaxEvents = 1 << 20;
+  uint64_t Start = 0;
+};
+
+// The runtime finalizes the tool from its own destructor, which can run after
+// the static destructors of this library, so the global state is never freed.
+std::mutex &GlobalLock = *new std::mutex();
+std::vector<ThreadState *> &Threads = *new std::vector<ThreadState *>();
+std::unordered_map<const void *, RegionStats *> &Regions =
+    *new std::unordered_map<const void *, RegionStats *>();
+Config &Cfg = *new Config();
+std::atomic<uint64_t> NextThreadId{0};
+
+thread_local ThreadState *CurrentThread = nullptr;
+
+// Callbacks can come from a thread whose thread_begin the tool did not see,
+// like the initial thread when the runtime initializes lazily.
+ThreadState *thisThread() {
+  if (CurrentThread)
+    return CurrentThread;
+  ThreadState *ts = new ThreadState();
+  ts->Id = NextThreadId.fetch_add(1, std::memory_order_relaxed);
+  ts->Trace.reserve(std::min<size_t>(Cfg.MaxEvents, 4096));
+  {
+    std::lock_guard<std::mutex> l(GlobalLock);
+    Threads.push_back(ts);
+  }
+  CurrentThread = ts;
+  return ts;
+}
+
+RegionStats *regionStats(ThreadState *ts, const void *codeptr) {
+  auto it = ts->Regions.find(codeptr);
+  if (it != ts->Regions.end())
+    return it->second;
+  std::lock_guard<std::mutex> l(GlobalLock);
+  RegionStats *&global = Regions[codeptr];
+  if (!global) {
+    global = new RegionStats();
+    global->Codeptr = codeptr;
+  }
+  ts->Regions[codeptr] = global;
+  return global;
+}
+
+void record(ThreadState *ts, EventKind kind, uint64_t begin, uint64_t end,
+            const void *where, uint64_t creator) {
+  if (Cfg.TracePath.empty() || ts->Trace.size() >= Cfg.MaxEvents)
+    return;
+  ts->Trace.push_back(TraceEvent{kind, begin, end, where, creator});
+}
+
+void on_thread_begin(ompt_thread_t, ompt_data_t *thread_data) {
+  thread_data->ptr = thisThread();
+}
+
+void on_parallel_begin(ompt_data_t *, const ompt_frame_t *,
+                       ompt_data_t *parallel_data,
+                       unsigned int requested_parallelism, int,
+                       const void *codeptr_ra) {
+  ThreadState *ts = thisThread();
+  ParallelInstance *p = new ParallelInstance();
+  p->Region = regionStats(ts, codeptr_ra);
+  p->Slots.resize(std::max(requested_parallelism, 1u));
+  for (TeamSlot &slot : p->Slots)
+    slot.Instance = p;
+  p->Begin = now();
+  parallel_data->ptr = p;
+}
+
+void on_parallel_end(ompt_data_t *parallel_data, ompt_data_t *, int,
+                     const void *codeptr_ra) {
+  uint64_t end = now();
+  ThreadState *ts = thisThread();
+  ParallelInstance *p = static_cast<ParallelInstance *>(parallel_data->ptr);
+  if (!p)
+    return;
+  p->Ended.store(true, std::memory_order_release);
+
+  uint64_t maxWork = 0, sumWork = 0, barrier = 0;
+  unsigned nthreads = 0;
+  for (const TeamSlot &slot : p->Slots) {
+    if (!slot.Begin)
+      continue;
+    ++nthreads;
+    // A thread of a serialized team never arrives at a barrier.
+    uint64_t arrive = slot.Arrive ? slot.Arrive : end;
+    uint64_t work =
+        arrive - slot.Begin - slot.IdleBeforeArrive + slot.WaitTaskNs;
+    maxWork = std::max(maxWork, work);
+    sumWork += work;
+    barrier += slot.IdleBeforeArrive + (end - arrive - slot.WaitTaskNs);
+  }
+
+  RegionStats *rs = p->Region;
+  {
+    std::lock_guard<std::mutex> l(rs->Lock);
+    ++rs->Count;
+    rs->TotalNs += end - p->Begin;
+    rs->MaxWorkNs += maxWork;
+    rs->MeanWorkNs += nthreads ? sumWork / nthreads : 0;
+    rs->BarrierNs += barrier;
+    rs->MaxThreads = std::max(rs->MaxThreads, nthreads);
+    ++rs->Histogram[bucketOf(end - p->Begin)];
+  }
+  record(ts, EvParallel, p->Begin, end, codeptr_ra, 0);
+  parallel_data->ptr = nullptr;
+  p->release();
+}
+
+void on_implicit_task(ompt_scope_endpoint_t endpoint,
+                      ompt_data_t *parallel_data, ompt_data_t *task_data,
+                      unsigned int, unsigned int index, int flags) {
+  if (flags & ompt_task_initial)
+    return;
+  if (endpoint == ompt_scope_begin) {
+    ParallelInstance *p =
+        parallel_data ? static_cast<ParallelInstance *>(parallel_data->ptr)
+                      : nullptr;
+    if (!p || index >= p->Slots.size()) {
+      task_data->ptr = nullptr;
+      return;
+    }
+    p->Refs.fetch_add(1, std::memory_order_relaxed);
+    TeamSlot *slot = &p->Slots[index];
+    slot->Begin = now();
+    task_data->ptr = slot;
+  } else {
+    TeamSlot *slot = static_cast<TeamSlot *>(task_data->ptr);
+    if (!slot)
+      return;
+    task_data->ptr = nullptr;
+    slot->Instance->release();
+  }
+}
+
+void on_sync_region_wait(ompt_sync_region_t kind,
+                         ompt_scope_endpoint_t endpoint, ompt_data_t *,
+                         ompt_data_t *task_data, const void *codeptr_ra) {
+  if (!isBarrier(kind))
+    return;
+  uint64_t t = now();
+  ThreadState *ts = thisThread();
+  TeamSlot *slot = task_data && !isExplicit(task_data)
+                       ? static_cast<TeamSlot *>(task_data->ptr)
+                       : nullptr;
+  if (endpoint == ompt_scope_begin) {
+    ts->WaitBegin = t;
+    ts->WaitTaskNs = 0;
+    ts->WaitSlot = slot;
+    if (slot) {
+      slot->Arrive = t;
+      slot->IdleBeforeArrive = slot->IdleNs;
+      slot->WaitTaskNs = 0;
+    }
+    return;
+  }
+  if (!ts->WaitBegin)
+    return;
+  // Tasks run while waiting are work, not barrier time.
+  uint64_t idle = t - ts->WaitBegin - ts->WaitTaskNs;
+  ts->BarrierNs += idle;
+  // The wait in the join barrier is accounted for by the master.
+  if (slot && !slot->Instance->Ended.load(std::memory_order_acquire))
+    slot->IdleNs += idle;
+  record(ts, EvBarrier, ts->WaitBegin, t, codeptr_ra, 0);
+  ts->WaitBegin = 0;
+  ts->WaitSlot = nullptr;
+}
+
+void on_task_create(ompt_data_t *, const ompt_frame_t *,
+                    ompt_data_t *new_task_data, int flags, int,
+                    const void *) {
+  if (!(flags & ompt_task_explicit))
+    return;
+  ThreadState *ts = thisThread();
+  ++ts->TasksCreated;
+  new_task_data->value = (ts->Id << 2) | ExplicitTag;
+}
+
+void on_task_schedule(ompt_data_t *prior_task_data, ompt_task_status_t,
+                      ompt_data_t *next_task_data) {
+  uint64_t t = now();
+  ThreadState *ts = thisThread();
+  if (ts->TaskBegin && isExplicit(prior_task_data)) {
+    if (ts->WaitBegin) {
+      ts->WaitTaskNs += t - ts->TaskBegin;
+      if (ts->WaitSlot)
+        ts->WaitSlot->WaitTaskNs += t - ts->TaskBegin;
+    }
+    record(ts, EvTask, ts->TaskBegin, t, nullptr,
+           prior_task_data->value >> 2);
+  }
+  ts->TaskBegin = 0;
+  if (!isExplicit(next_task_data))
+    return;
+  ts->TaskBegin = t;
+  // An untied task may be scheduled several times; count its first start.
+  if (!(next_task_data->value & StartedTag)) {
+    next_task_data->value |= StartedTag;
+    ++ts->TasksRun;
+    if ((next_task_data->value >> 2) != ts->Id)
+      ++ts->TasksStolen;
+  }
+}
+
+std::string regionName(const void *codeptr) {
+  if (!codeptr)
+    return "<unknown>";
+  char buf[64];
+  Dl_info info;
+  if (!dladdr(codeptr, &info)) {
+    snprintf(buf, sizeof(buf), "%p", codeptr);
+    return buf;
+  }
+  if (info.dli_sname) {
+    snprintf(buf, sizeof(buf), "+0x%" PRIxPTR,
+             uintptr_t(codeptr) - uintptr_t(info.dli_saddr));
+    return std::string(info.dli_sname) + buf;
+  }
+  // Without a dynamic symbol, name the module and the offset addr2line takes.
+  const char *module = info.dli_fname ? strrchr(info.dli_fname, '/') : nullptr;
+  snprintf(buf, sizeof(buf), "+0x%" PRIxPTR,
+           uintptr_t(codeptr) - uintptr_t(info.dli_fbase));
+  return std::string(module ? module + 1 : "?") + buf;
+}
+
+double ms(uint64_t ns) { return ns / 1e6; }
+
+void writeReport() {
+  FILE *out = Cfg.Output;
+  std::vector<RegionStats *> regions;
+  for (auto &entry : Regions)
+    regions.push_back(entry.second);
+  std::sort(regions.begin(), regions.end(),
+            [](const RegionStats *a, const RegionStats *b) {
+              return a->TotalNs > b->TotalNs;
+            });
+
+  fprintf(out, "ompprof: %.3f ms run time, %zu parallel regions\n",
+          ms(now() - Cfg.Start), regions.size());
+  fprintf(out, "%-40s %8s %11s %10s %7s %11s %7s\n", "region", "count",
+          "total(ms)", "mean(us)", "imbal%", "barrier(ms)", "threads");
+  for (const RegionStats *rs : regions) {
+    double imbalance =
+        rs->MaxWorkNs ? 100.0 * (rs->MaxWorkNs - rs->MeanWorkNs) /
+                            rs->MaxWorkNs
+                      : 0.0;
+    fprintf(out, "%-40s %8" PRIu64 " %11.3f %10.3f %7.1f %11.3f %7u\n",
+            regionName(rs->Codeptr).c_str(), rs->Count, ms(rs->TotalNs),
+            rs->Count ? rs->TotalNs / 1e3 / rs->Count : 0.0, imbalance,
+            ms(rs->BarrierNs), rs->MaxThreads);
+    fprintf(out, "  duration(us):");
+    for (int b = 0; b < NumBuckets; ++b)
+      if (rs->Histogram[b])
+        fprintf(out, " [%" PRIu64 ",%" PRIu64 "):%" PRIu64,
+                b ? uint64_t(1) << (b - 1) : 0, uint64_t(1) << b,
+                rs->Histogram[b]);
+    fprintf(out, "\n");
+  }
+
+  uint64_t created = 0, run = 0, stolen = 0;
+  std::sort(Threads.begin(), Threads.end(),
+            [](const ThreadState *a, const ThreadState *b) {
+              return a->Id < b->Id;
+            });
+  fprintf(out, "%-8s %12s %12s %12s %13s\n", "thread", "barrier(ms)",
+          "tasks made", "tasks run", "tasks stolen");
+  for (const ThreadState *ts : Threads) {
+    fprintf(out,
+            "%-8" PRIu64 " %12.3f %12" PRIu64 " %12" PRIu64 " %13" PRIu64
+            "\n",
+            ts->Id, ms(ts->BarrierNs), ts->TasksCreated, ts->TasksRun,
+            ts->TasksStolen);
+    created += ts->TasksCreated;
+    run += ts->TasksRun;
+    stolen += ts->TasksStolen;
+  }
+  fprintf(out,
+          "tasks: %" PRIu64 " created, %" PRIu64 " run, %" PRIu64
+          " (%.1f%%) on another thread than their creator\n",
+          created, run, stolen, run ? 100.0 * stolen / run : 0.0);
+}
+
+void writeTrace() {
+  FILE *out = fopen(Cfg.TracePath.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "ompprof: cannot write trace to %s\n",
+            Cfg.TracePath.c_str());
+    return;
+  }
+  // Region names are resolved once, not for every event.
+  std::unordered_map<const void *, std::string> names;
+  auto nameOf = [&](const void *codeptr) -> const std::string & {
+    auto it = names.find(codeptr);
+    if (it == names.end())
+      it = names.emplace(codeptr, regionName(codeptr)).first;
+    return it->second;
+  };
+
+  fprintf(out, "{\"traceEvents\":[\n");
+  bool first = true;
+  bool truncated = false;
+  for (const ThreadState *ts : Threads) {
+    truncated |= ts->Trace.size() >= Cfg.MaxEvents;
+    for (const TraceEvent &ev : ts->Trace) {
+      double begin = (ev.Begin - Cfg.Start) / 1e3;
+      double dur = (ev.End - ev.Begin) / 1e3;
+      fprintf(out, "%s{\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIu64
+                   ",\"ts\":%.3f,\"dur\":%.3f,",
+              first ? "" : ",\n", ts->Id, begin, dur);
+      first = false;
+      switch (ev.Kind) {
+      case EvParallel:
+        fprintf(out, "\"name\":\"parallel\",\"args\":{\"region\":\"%s\"}}",
+                nameOf(ev.Where).c_str());
+        break;
+      case EvBarrier:
+        fprintf(out, "\"name\":\"barrier\",\"args\":{\"region\":\"%s\"}}",
+                nameOf(ev.Where).c_str());
+        break;
+      case EvTask:
+        fprintf(out, "\"name\":\"task\",\"args\":{\"creator\":%" PRIu64 "}}",
+                ev.Creator);
+        break;
+      }
+    }
+  }
+  fprintf(out, "\n]}\n");
+  fclose(out);
+  if (truncated)
+    fprintf(stderr,
+            "ompprof: trace truncated, raise OMPPROF_TRACE_EVENTS above "
+            "%zu\n",
+            Cfg.MaxEvents);
+}
+
+#define register_callback(name)                                                \
+  do {                                                                         \
+    if (ompt_set_callback(ompt_callback_##name,                                \
+                          (ompt_callback_t)&on_##name) == ompt_set_never)      \
+      fprintf(stderr, "ompprof: cannot register ompt_callback_" #name "\n");  \
+  } while (0)
+
+int ompprof_initialize(ompt_function_lookup_t lookup, int, ompt_data_t *) {
+  ompt_set_callback_t ompt_set_callback =
+      (ompt_set_callback_t)lookup("ompt_set_callback");
+  if (!ompt_set_callback)
+    return 0;
+
+  if (const char *path = getenv("OMPPROF_OUTPUT")) {
+    if (FILE *f = fopen(path, "w"))
+      Cfg.Output = f;
+    else
+      fprintf(stderr, "ompprof: cannot open %s, reporting to stderr\n", path);
+  }
+  if (const char *path = getenv("OMPPROF_TRACE"))
+    Cfg.TracePath = path;
+  if (const char *events = getenv("OMPPROF_TRACE_EVENTS"))
+    Cfg.MaxEvents = strtoull(events, nullptr, 0);
+  Cfg.Start = now();
+
+  register_callback(thread_begin);
+  register_callback(parallel_begin);
+  register_callback(parallel_end);
+  register_callback(implicit_task);
+  register_callback(sync_region_wait);
+  register_callback(task_create);
+  register_callback(task_schedule);
+  return 1;
+}
+
+void ompprof_finalize(ompt_data_t *) {
+  std::lock_guard<std::mutex> l(GlobalLock);
+  writeReport();
+  if (!Cfg.TracePath.empty())
+    writeTrace();
+  if (Cfg.Output != stderr)
+    fclose(Cfg.Output);
+}
+
+} // namespace
+
+extern "C" ompt_start_tool_result_t *
+ompt_start_tool(unsigned int omp_version, const char *runtime_version) {
+  static ompt_start_tool_result_t result = {&ompprof_initialize,
+                                            &ompprof_finalize, {0}};
+  return &result;
+}
@@ -103,10 +103,12 @@
 #include "span.h"
 #include "status.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #if defined(__clang__) || defined(__GNUC__)
 #define ACXXEL_WARN_UNUSED_RESULT __attribute__((warn_unused_result))
@@ -140,6 +142,8 @@ template <typename T> class AsyncHostMemorySpan;
 
 template <typename T> class OwnedAsyncHostMemory;
 
+template <typename InputT, typename OutputT> class Pipeline;
+
 /// Function type used to destroy opaque handles given out by the platform.
 using HandleDestructor = void (*)(void *);
 
@@ -578,6 +582,17 @@ public:
 
   /// \}
 
+  /// Creates a Pipeline on the given device that processes batches of
+  /// InputBatchSize input elements into batches of OutputBatchSize output
+  /// elements, with StageCount batches in flight at once.
+  ///
+  /// All the streams and the device and registered host memory used by the
+  /// pipeline are allocated here, and are reused by every run of the pipeline.
+  template <typename InputT, typename OutputT>
+  Expected<Pipeline<InputT, OutputT>>
+  createPipeline(ptrdiff_t InputBatchSize, ptrdiff_t OutputBatchSize,
+                 int StageCount = 2, int DeviceIndex = 0);
+
   virtual Expected<Program> createProgramFromSource(Span<const char> Source,
                                                     int DeviceIndex = 0) = 0;
 
@@ -1377,6 +1392,180 @@ private:
   Span<ElementType> TheSpan;
 };
 
+/// A pipeline for processing host data on a device in batches.
+///
+/// A Pipeline splits its input into batches and, for each batch, copies it to
+/// the device, runs a computation on it, and copies the result back to the
+/// host. Consecutive batches are processed on different streams, so the copies
+/// for one batch overlap with the computation for the others.
+///
+/// The host data does not need to be registered: each stage of the pipeline
+/// stages its batch through its own registered host buffer, which is allocated
+/// once when the pipeline is created.
+///
+/// A Pipeline is created by calling Platform::createPipeline.
+template <typename InputT, typename OutputT> class Pipeline {
+public:
+  /// Function type to enqueue the computation for one batch into a stream.
+  ///
+  /// The spans passed to it are the device copies of the batch input and the
+  /// device memory for the batch output. They are only shorter than the batch
+  /// sizes for the last batch.
+  using ComputeFunction = std::function<void(
+      Stream &, DeviceMemorySpan<InputT>, DeviceMemorySpan<OutputT>)>;
+
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+  Pipeline(Pipeline &&) = default;
+  Pipeline &operator=(Pipeline &&) = default;
+  ~Pipeline() = default;
+
+  /// Gets the number of batches that can be in flight at once.
+  int getStageCount() const { return static_cast<int>(Stages.size()); }
+
+  /// Processes Input into Output batch by batch, and blocks the host until
+  /// all the batches are done.
+  ///
+  /// Input and Output must split into the same number of batches.
+  ///
+  /// Returns the first error emitted by the work on any stage. Output is not
+  /// fully written in that case.
+  Status run(Span<const InputT> Input, Span<OutputT> Output,
+             const ComputeFunction &Compute) ACXXEL_WARN_UNUSED_RESULT;
+
+private:
+  friend class Platform;
+
+  /// The resources to process one batch.
+  struct Stage {
+    Stream TheStream;
+    OwnedAsyncHostMemory<InputT> HostInput;
+    OwnedAsyncHostMemory<OutputT> HostOutput;
+    DeviceMemory<InputT> DeviceInput;
+    DeviceMemory<OutputT> DeviceOutput;
+
+    /// Where in the run output the batch in flight on this stage goes. The
+    /// count is zero when there is no batch in flight.
+    ptrdiff_t OutputOffset;
+    ptrdiff_t OutputCount;
+  };
+
+  Pipeline(ptrdiff_t InputBatchSize, ptrdiff_t OutputBatchSize)
+      : InputBatchSize(InputBatchSize), OutputBatchSize(OutputBatchSize) {}
+
+  /// Waits for the batch in flight on the stage, if any, and copies its
+  /// result into Output.
+  Status retire(Stage &S, Span<OutputT> Output);
+
+  ptrdiff_t InputBatchSize;
+  ptrdiff_t OutputBatchSize;
+  std::vector<Stage> Stages;
+};
+
+template <typename InputT, typename OutputT>
+Expected<Pipeline<InputT, OutputT>>
+Platform::createPipeline(ptrdiff_t InputBatchSize, ptrdiff_t OutputBatchSize,
+                         int StageCount, int DeviceIndex) {
+  if (InputBatchSize <= 0 || OutputBatchSize <= 0)
+    return Status("pipeline batch sizes must be positive, got " +
+                  std::to_string(InputBatchSize) + " and " +
+                  std::to_string(OutputBatchSize));
+  if (StageCount <= 0)
+    return Status("pipeline stage count must be positive, got " +
+                  std::to_string(StageCount));
+
+  Pipeline<InputT, OutputT> ThePipeline(InputBatchSize, OutputBatchSize);
+  ThePipeline.Stages.reserve(StageCount);
+  for (int I = 0; I < StageCount; ++I) {
+    Expected<Stream> MaybeStream = createStream(DeviceIndex);
+    if (MaybeStream.isError())
+      return MaybeStream.getError();
+    Expected<OwnedAsyncHostMemory<InputT>> MaybeHostInput =
+        newAsyncHostMem<InputT>(InputBatchSize);
+    if (MaybeHostInput.isError())
+      return MaybeHostInput.getError();
+    Expected<OwnedAsyncHostMemory<OutputT>> MaybeHostOutput =
+        newAsyncHostMem<OutputT>(OutputBatchSize);
+    if (MaybeHostOutput.isError())
+      return MaybeHostOutput.getError();
+    Expected<DeviceMemory<InputT>> MaybeDeviceInput =
+        mallocD<InputT>(InputBatchSize, DeviceIndex);
+    if (MaybeDeviceInput.isError())
+      return MaybeDeviceInput.getError();
+    Expected<DeviceMemory<OutputT>> MaybeDeviceOutput =
+        mallocD<OutputT>(OutputBatchSize, DeviceIndex);
+    if (MaybeDeviceOutput.isError())
+      return MaybeDeviceOutput.getError();
+    ThePipeline.Stages.push_back(typename Pipeline<InputT, OutputT>::Stage{
+        MaybeStream.takeValue(), MaybeHostInput.takeValue(),
+        MaybeHostOutput.takeValue(), MaybeDeviceInput.takeValue(),
+        MaybeDeviceOutput.takeValue(), 0, 0});
+  }
+  return Expected<Pipeline<InputT, OutputT>>(std::move(ThePipeline));
+}
+
+template <typename InputT, typename OutputT>
+Status Pipeline<InputT, OutputT>::retire(Stage &S, Span<OutputT> Output) {
+  if (S.OutputCount == 0)
+    return Status();
+  ptrdiff_t Count = S.OutputCount;
+  S.OutputCount = 0;
+  Status SyncStatus = S.TheStream.sync();
+  if (SyncStatus.isError())
+    return SyncStatus;
+  std::copy(S.HostOutput.get(), S.HostOutput.get() + Count,
+            Output.data() + S.OutputOffset);
+  return Status();
+}
+
+template <typename InputT, typename OutputT>
+Status Pipeline<InputT, OutputT>::run(Span<const InputT> Input,
+                                      Span<OutputT> Output,
+                                      const ComputeFunction &Compute) {
+  ptrdiff_t BatchCount = (Input.size() + InputBatchSize - 1) / InputBatchSize;
+  ptrdiff_t OutputBatchCount =
+      (Output.size() + OutputBatchSize - 1) / OutputBatchSize;
+  if (BatchCount != OutputBatchCount)
+    return Status("pipeline input batch count " + std::to_string(BatchCount) +
+                  " does not equal output batch count " +
+                  std::to_string(OutputBatchCount));
+
+  Status RunStatus;
+  for (ptrdiff_t Batch = 0; Batch < BatchCount; ++Batch) {
+    Stage &S = Stages[Batch % Stages.size()];
+
+    // The stage's buffers can only be reused once its previous batch is done.
+    RunStatus = retire(S, Output);
+    if (RunStatus.isError())
+      break;
+
+    ptrdiff_t InputOffset = Batch * InputBatchSize;
+    ptrdiff_t InputCount =
+        std::min(InputBatchSize, Input.size() - InputOffset);
+    ptrdiff_t OutputOffset = Batch * OutputBatchSize;
+    ptrdiff_t OutputCount =
+        std::min(OutputBatchSize, Output.size() - OutputOffset);
+
+    std::copy(Input.data() + InputOffset,
+              Input.data() + InputOffset + InputCount, S.HostInput.get());
+    S.TheStream.asyncCopyHToD(S.HostInput, S.DeviceInput, InputCount);
+    Compute(S.TheStream, S.DeviceInput.asSpan().first(InputCount),
+            S.DeviceOutput.asSpan().first(OutputCount));
+    S.TheStream.asyncCopyDToH(S.DeviceOutput, S.HostOutput, OutputCount);
+    S.OutputOffset = OutputOffset;
+    S.OutputCount = OutputCount;
+  }
+
+  // Wait for the batches still in flight, even after an error, so that no
+  // stage is left with work using its buffers.
+  for (Stage &S : Stages) {
+    Status StageStatus = retire(S, Output);
+    if (!RunStatus.isError())
+      RunStatus = StageStatus;
+  }
+  return RunStatus;
+}
+
 } // namespace acxxel
 
 #endif // ACXXEL_ACXXEL_H
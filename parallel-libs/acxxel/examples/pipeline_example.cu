@@ -0,0 +1,77 @@
+//===--- pipeline_example.cu - Pipelined transfers with Acxxel ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// This file is an example of using an Acxxel Pipeline to overlap host-device
+/// copies with kernels, and measures its throughput for different numbers of
+/// pipeline stages.
+///
+//===----------------------------------------------------------------------===//
+
+#include "acxxel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// A kernel with enough arithmetic per element to be comparable to the cost of
+// copying that element.
+__global__ void polynomialKernel(const float *X, float *Y, int N) {
+  int I = (blockDim.x * blockIdx.x) + threadIdx.x;
+  if (I < N) {
+    float Value = X[I];
+    float Result = 0.0f;
+    for (int J = 0; J < 64; ++J)
+      Result = Result * Value + 1.0f;
+    Y[I] = Result;
+  }
+}
+
+void check(const acxxel::Status &Status, const char *What) {
+  if (Status.isError()) {
+    std::fprintf(stderr, "Error %s: %s\n", What, Status.getMessage().c_str());
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+int main() {
+  constexpr ptrdiff_t ElementCount = 1 << 26;
+  constexpr ptrdiff_t BatchSize = 1 << 22;
+  constexpr int BlockSize = 256;
+
+  acxxel::Platform *CUDA = acxxel::getCUDAPlatform().getValue();
+  std::vector<float> X(ElementCount, 0.5f);
+  std::vector<float> Y(ElementCount);
+
+  auto Compute = [](acxxel::Stream &Stream, acxxel::DeviceMemorySpan<float> In,
+                    acxxel::DeviceMemorySpan<float> Out) {
+    int N = In.size();
+    polynomialKernel<<<(N + BlockSize - 1) / BlockSize, BlockSize, 0,
+                       Stream>>>(In, Out, N);
+  };
+
+  for (int StageCount : {1, 2, 4}) {
+    acxxel::Expected<acxxel::Pipeline<float, float>> MaybePipeline =
+        CUDA->createPipeline<float, float>(BatchSize, BatchSize, StageCount);
+    if (MaybePipeline.isError())
+      check(MaybePipeline.getError(), "creating pipeline");
+    acxxel::Pipeline<float, float> Pipeline = MaybePipeline.takeValue();
+
+    // Warm up, so that the timed run doesn't include one-time setup costs.
+    check(Pipeline.run(X, Y, Compute), "running pipeline");
+
+    auto Start = std::chrono::steady_clock::now();
+    check(Pipeline.run(X, Y, Compute), "running pipeline");
+    std::chrono::duration<double> Seconds =
+        std::chrono::steady_clock::now() - Start;
+
+    double GigaBytes = 2.0 * ElementCount * sizeof(float) / 1e9;
+    std::printf("%d stage(s): %.3f s, %.2f GB/s\n", StageCount,
+                Seconds.count(), GigaBytes / Seconds.count());
+  }
+}
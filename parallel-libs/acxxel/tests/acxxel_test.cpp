@@ -14,6 +14,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace {
 
@@ -401,6 +402,38 @@ TEST_P(AcxxelTest, WaitForEventsInAStream) {
   EXPECT_FALSE(Stream1.sync().isError());
 }
 
+TEST_P(AcxxelTest, Pipeline) {
+  acxxel::Platform *Platform = GetParam()().takeValue();
+  acxxel::Pipeline<int, int> Pipeline =
+      Platform->createPipeline<int, int>(4, 4).takeValue();
+  EXPECT_EQ(2, Pipeline.getStageCount());
+
+  // Ten elements split into two full batches and a partial one, so the first
+  // stage is reused.
+  std::vector<int> Input(10);
+  for (size_t I = 0; I < Input.size(); ++I)
+    Input[I] = I;
+  std::vector<int> Output(Input.size());
+  auto Copy = [](acxxel::Stream &Stream, acxxel::DeviceMemorySpan<int> In,
+                 acxxel::DeviceMemorySpan<int> Out) {
+    Stream.asyncCopyDToD(In, Out);
+  };
+  EXPECT_FALSE(Pipeline.run(Input, Output, Copy).isError());
+  EXPECT_EQ(Input, Output);
+
+  std::vector<int> ShortOutput(4);
+  EXPECT_TRUE(Pipeline.run(Input, ShortOutput, Copy).isError());
+}
+
+TEST_P(AcxxelTest, PipelineBadBatchSize) {
+  acxxel::Platform *Platform = GetParam()().takeValue();
+  using IntPipeline = acxxel::Expected<acxxel::Pipeline<int, int>>;
+  IntPipeline NoInput = Platform->createPipeline<int, int>(0, 4);
+  EXPECT_TRUE(NoInput.isError());
+  IntPipeline NoStages = Platform->createPipeline<int, int>(4, 4, 0);
+  EXPECT_TRUE(NoStages.isError());
+}
+
 #if defined(ACXXEL_ENABLE_CUDA) || defined(ACXXEL_ENABLE_OPENCL)
 INSTANTIATE_TEST_CASE_P(BothPlatformTest, AcxxelTest,
                         ::testing::Values(
@@ -31,9 +31,14 @@ enum class OMPGeneralSchedulingType {
   Runtime = 37
 };
 
+/// Thread affinity policies of parallel regions.
+/// Initialization values taken from OpenMP's enum in kmp.h: kmp_proc_bind_t.
+enum class OMPProcBindType { Master = 2, Close = 3, Spread = 4, Default = 6 };
+
 extern int PollyNumThreads;
 extern OMPGeneralSchedulingType PollyScheduling;
 extern int PollyChunkSize;
+extern OMPProcBindType PollyProcBind;
 
 /// Create a scalar do/for-style loop.
 ///
@@ -90,6 +90,13 @@ public:
   /// @param NumThreads       The number of threads to use.
   void createCallPushNumThreads(Value *GlobalThreadID, Value *NumThreads);
 
+  /// Create a runtime library call to request a thread affinity policy.
+  /// Which will be used in the next OpenMP section (by the next fork).
+  ///
+  /// @param GlobalThreadID   The global thread ID.
+  /// @param ProcBind         The OMPProcBindType to use.
+  void createCallPushProcBind(Value *GlobalThreadID, Value *ProcBind);
+
   /// Create a runtime library call to prepare the OpenMP runtime.
   /// For dynamically scheduled loops, saving the loop arguments.
   ///
@@ -75,6 +75,12 @@ static cl::opt<bool> PollyParallelForce(
         "Force generation of thread parallel code ignoring any cost model"),
     cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+static cl::opt<int> AstComputeOut(
+    "polly-ast-computeout",
+    cl::desc("Bound the AST generation by a maximal amount of computational "
+             "steps (0 means no bound)"),
+    cl::Hidden, cl::init(1000000), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 static cl::opt<bool> UseContext("polly-ast-use-context",
                                 cl::desc("Use context"), cl::Hidden,
                                 cl::init(true), cl::ZeroOrMore,
@@ -89,6 +95,8 @@ STATISTIC(ScopsProcessed, "Number of SCoPs processed");
 STATISTIC(ScopsBeneficial, "Number of beneficial SCoPs");
 STATISTIC(BeneficialAffineLoops, "Number of beneficial affine loops");
 STATISTIC(BeneficialBoxedLoops, "Number of beneficial boxed loops");
+STATISTIC(ScopsComputedOut,
+          "Number of SCoPs whose AST generation exceeded max_operations");
 
 STATISTIC(NumForLoops, "Number of for-loops");
 STATISTIC(NumParallel, "Number of parallel for-loops");
@@ -563,10 +571,23 @@ void IslAst::init(const Dependences &D) {
                                               &BuildInfo);
   }
 
-  RunCondition = buildRunCondition(S, Build);
+  {
+    IslMaxOperationsGuard MaxOpGuard(Ctx.get(), AstComputeOut);
+
+    RunCondition = buildRunCondition(S, Build);
+    Root =
+        isl_ast_build_node_from_schedule(Build, S.getScheduleTree().release());
 
-  Root = isl_ast_build_node_from_schedule(Build, S.getScheduleTree().release());
-  walkAstForStatistics(Root);
+    // Without an AST, the code generator leaves the SCoP unchanged.
+    if (MaxOpGuard.hasQuotaExceeded()) {
+      LLVM_DEBUG(dbgs() << "AST generation exceeded max_operations\n");
+      ScopsComputedOut++;
+      Root = isl_ast_node_free(Root);
+      RunCondition = isl_ast_expr_free(RunCondition);
+    }
+  }
+  if (Root)
+    walkAstForStatistics(Root);
 
   isl_ast_build_free(Build);
 }
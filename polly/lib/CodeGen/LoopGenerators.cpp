@@ -27,6 +27,7 @@ using namespace polly;
 int polly::PollyNumThreads;
 OMPGeneralSchedulingType polly::PollyScheduling;
 int polly::PollyChunkSize;
+OMPProcBindType polly::PollyProcBind;
 
 static cl::opt<int, true>
     XPollyNumThreads("polly-num-threads",
@@ -55,6 +56,20 @@ static cl::opt<int, true>
                     cl::Hidden, cl::location(polly::PollyChunkSize),
                     cl::init(0), cl::Optional, cl::cat(PollyCategory));
 
+static cl::opt<OMPProcBindType, true> XPollyProcBind(
+    "polly-proc-bind",
+    cl::desc("Thread affinity of parallel OpenMP for loops (LLVM OpenMP only)"),
+    cl::values(clEnumValN(OMPProcBindType::Default, "default",
+                          "Runtime determined (OMP_PROC_BIND)"),
+               clEnumValN(OMPProcBindType::Master, "master",
+                          "Place threads on the master's place"),
+               clEnumValN(OMPProcBindType::Close, "close",
+                          "Place threads close to the master's place"),
+               clEnumValN(OMPProcBindType::Spread, "spread",
+                          "Spread threads evenly over the places")),
+    cl::Hidden, cl::location(polly::PollyProcBind),
+    cl::init(OMPProcBindType::Default), cl::Optional, cl::cat(PollyCategory));
+
 // We generate a loop of either of the following structures:
 //
 //              BeforeBB                      BeforeBB
@@ -63,12 +63,22 @@ void ParallelLoopGeneratorKMP::deployParallelExecution(Value *SubFn,
                                                        Value *SubFnParam,
                                                        Value *LB, Value *UB,
                                                        Value *Stride) {
+  Value *GlobalThreadID = nullptr;
+
   // Inform OpenMP runtime about the number of threads if greater than zero
   if (PollyNumThreads > 0) {
-    Value *GlobalThreadID = createCallGlobalThreadNum();
+    GlobalThreadID = createCallGlobalThreadNum();
     createCallPushNumThreads(GlobalThreadID, Builder.getInt32(PollyNumThreads));
   }
 
+  // Inform OpenMP runtime about the thread affinity, if one was requested
+  if (PollyProcBind != OMPProcBindType::Default) {
+    if (!GlobalThreadID)
+      GlobalThreadID = createCallGlobalThreadNum();
+    createCallPushProcBind(GlobalThreadID,
+                           Builder.getInt32(static_cast<int>(PollyProcBind)));
+  }
+
   // Tell the runtime we start a parallel loop
   createCallSpawnThreads(SubFn, SubFnParam, LB, UB, Stride);
 }
@@ -309,6 +319,28 @@ void ParallelLoopGeneratorKMP::createCallPushNumThreads(Value *GlobalThreadID,
   Builder.CreateCall(F, Args);
 }
 
+void ParallelLoopGeneratorKMP::createCallPushProcBind(Value *GlobalThreadID,
+                                                      Value *ProcBind) {
+  const std::string Name = "__kmpc_push_proc_bind";
+  Function *F = M->getFunction(Name);
+
+  // If F is not available, declare it.
+  if (!F) {
+    StructType *IdentTy = M->getTypeByName("struct.ident_t");
+
+    GlobalValue::LinkageTypes Linkage = Function::ExternalLinkage;
+    Type *Params[] = {IdentTy->getPointerTo(), Builder.getInt32Ty(),
+                      Builder.getInt32Ty()};
+
+    FunctionType *Ty = FunctionType::get(Builder.getVoidTy(), Params, false);
+    F = Function::Create(Ty, Linkage, Name, M);
+  }
+
+  Value *Args[] = {SourceLocationInfo, GlobalThreadID, ProcBind};
+
+  Builder.CreateCall(F, Args);
+}
+
 void ParallelLoopGeneratorKMP::createCallStaticInit(Value *GlobalThreadID,
                                                     Value *IsLastPtr,
                                                     Value *LBPtr, Value *UBPtr,